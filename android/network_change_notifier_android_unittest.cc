@@ -409,6 +409,17 @@ TEST_F(NetworkChangeNotifierDelegateAndroidTest, MaxBandwidthCallbackNotifier) {
   EXPECT_EQ(3, max_bandwidth_observer_.notifications_count());
 }
 
+// Tests that the subtype is cached from the bandwidth notifications.
+TEST_F(NetworkChangeNotifierDelegateAndroidTest, ConnectionSubtypeCached) {
+  FakeConnectionSubtypeChange(ConnectionSubtype::SUBTYPE_CDMA);
+  EXPECT_EQ(ConnectionSubtype::SUBTYPE_CDMA,
+            delegate_.GetCurrentConnectionSubtype());
+
+  FakeConnectionSubtypeChange(ConnectionSubtype::SUBTYPE_LTE);
+  EXPECT_EQ(ConnectionSubtype::SUBTYPE_LTE,
+            delegate_.GetCurrentConnectionSubtype());
+}
+
 TEST_F(NetworkChangeNotifierDelegateAndroidTest,
        MaxBandwidthNotifiedOnConnectionChange) {
   EXPECT_EQ(0, delegate_observer_.bandwidth_notifications_count());
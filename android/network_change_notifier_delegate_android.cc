@@ -77,9 +77,9 @@ NetworkChangeNotifierDelegateAndroid::NetworkChangeNotifierDelegateAndroid()
   SetCurrentConnectionType(
       ConvertConnectionType(Java_NetworkChangeNotifier_getCurrentConnectionType(
           env, java_network_change_notifier_)));
-  SetCurrentMaxBandwidth(
-      NetworkChangeNotifierAndroid::GetMaxBandwidthMbpsForConnectionSubtype(
-          GetCurrentConnectionSubtype()));
+  SetCurrentConnectionSubtype(ConvertConnectionSubtype(
+      Java_NetworkChangeNotifier_getCurrentConnectionSubtype(
+          env, java_network_change_notifier_)));
   SetCurrentDefaultNetwork(Java_NetworkChangeNotifier_getCurrentDefaultNetId(
       env, java_network_change_notifier_));
   NetworkMap network_map;
@@ -106,10 +106,8 @@ NetworkChangeNotifierDelegateAndroid::GetCurrentConnectionType() const {
 
 NetworkChangeNotifier::ConnectionSubtype
 NetworkChangeNotifierDelegateAndroid::GetCurrentConnectionSubtype() const {
-  DCHECK(thread_checker_.CalledOnValidThread());
-  return ConvertConnectionSubtype(
-      Java_NetworkChangeNotifier_getCurrentConnectionSubtype(
-          base::android::AttachCurrentThread(), java_network_change_notifier_));
+  base::AutoLock auto_lock(connection_lock_);
+  return connection_subtype_;
 }
 
 void NetworkChangeNotifierDelegateAndroid::
@@ -189,12 +187,13 @@ void NetworkChangeNotifierDelegateAndroid::NotifyMaxBandwidthChanged(
     const JavaParamRef<jobject>& obj,
     jint subtype) {
   DCHECK(thread_checker_.CalledOnValidThread());
-  double new_max_bandwidth =
-      NetworkChangeNotifierAndroid::GetMaxBandwidthMbpsForConnectionSubtype(
-          ConvertConnectionSubtype(subtype));
-  SetCurrentMaxBandwidth(new_max_bandwidth);
+  SetCurrentConnectionSubtype(ConvertConnectionSubtype(subtype));
+  double new_max_bandwidth;
+  ConnectionType connection_type;
+  GetCurrentMaxBandwidthAndConnectionType(&new_max_bandwidth,
+                                          &connection_type);
   observers_->Notify(FROM_HERE, &Observer::OnMaxBandwidthChanged,
-                     new_max_bandwidth, GetCurrentConnectionType());
+                     new_max_bandwidth, connection_type);
 }
 
 void NetworkChangeNotifierDelegateAndroid::NotifyOfNetworkConnect(
@@ -295,9 +294,13 @@ void NetworkChangeNotifierDelegateAndroid::SetCurrentConnectionType(
   connection_type_ = new_connection_type;
 }
 
-void NetworkChangeNotifierDelegateAndroid::SetCurrentMaxBandwidth(
-    double max_bandwidth) {
+void NetworkChangeNotifierDelegateAndroid::SetCurrentConnectionSubtype(
+    ConnectionSubtype connection_subtype) {
+  double max_bandwidth =
+      NetworkChangeNotifierAndroid::GetMaxBandwidthMbpsForConnectionSubtype(
+          connection_subtype);
   base::AutoLock auto_lock(connection_lock_);
+  connection_subtype_ = connection_subtype;
   connection_max_bandwidth_ = max_bandwidth;
 }
 
@@ -69,9 +69,10 @@ class NET_EXPORT_PRIVATE NetworkChangeNotifierDelegateAndroid {
   jint GetConnectionType(JNIEnv* env, jobject obj) const;
 
   // Called from NetworkChangeNotifier.java on the JNI thread whenever
-  // the maximum bandwidth of the connection changes. This updates the current
-  // max bandwidth seen by this class and forwards the notification to the
-  // observers that subscribed through AddObserver().
+  // the connection subtype, and so the maximum bandwidth of the connection,
+  // changes. This updates the current subtype and max bandwidth seen by this
+  // class and forwards the notification to the observers that subscribed
+  // through AddObserver().
   void NotifyMaxBandwidthChanged(
       JNIEnv* env,
       const base::android::JavaParamRef<jobject>& obj,
@@ -117,8 +118,8 @@ class NET_EXPORT_PRIVATE NetworkChangeNotifierDelegateAndroid {
   ConnectionType GetNetworkConnectionType(NetworkHandle network) const;
   NetworkHandle GetCurrentDefaultNetwork() const;
   void GetCurrentlyConnectedNetworks(NetworkList* network_list) const;
-
-  // Can only be called from the main (Java) thread.
+  // Returns the subtype last pushed by NotifyMaxBandwidthChanged(), so
+  // callers don't pay for a JNI call.
   NetworkChangeNotifier::ConnectionSubtype GetCurrentConnectionSubtype() const;
 
   // Is the current process bound to a specific network?
@@ -144,7 +145,8 @@ class NET_EXPORT_PRIVATE NetworkChangeNotifierDelegateAndroid {
 
   // Setters that grab appropriate lock.
   void SetCurrentConnectionType(ConnectionType connection_type);
-  void SetCurrentMaxBandwidth(double max_bandwidth);
+  // Also updates the max bandwidth, which is derived from the subtype.
+  void SetCurrentConnectionSubtype(ConnectionSubtype connection_subtype);
   void SetCurrentDefaultNetwork(NetworkHandle default_network);
   void SetCurrentNetworksAndTypes(NetworkMap network_map);
 
@@ -168,6 +170,7 @@ class NET_EXPORT_PRIVATE NetworkChangeNotifierDelegateAndroid {
 
   mutable base::Lock connection_lock_;  // Protects the state below.
   ConnectionType connection_type_;
+  ConnectionSubtype connection_subtype_;
   double connection_max_bandwidth_;
   NetworkHandle default_network_;
   NetworkMap network_map_;
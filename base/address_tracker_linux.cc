@@ -9,6 +9,8 @@
 #include <stdint.h>
 #include <sys/ioctl.h>
 
+#include <vector>
+
 #include "base/files/scoped_file.h"
 #include "base/logging.h"
 #include "base/posix/eintr_wrapper.h"
@@ -20,6 +22,12 @@ namespace internal {
 
 namespace {
 
+// The size of the buffer netlink messages are received into. The kernel
+// sizes the batches of a dump after the largest buffer it has been given, so
+// a large buffer lets a dump of many addresses or links be read in a few
+// recv() calls instead of one per page.
+const size_t kReadBufferSize = 32 * 1024;
+
 // Some kernel functions such as wireless_send_event and rtnetlink_ifinfo_prep
 // may send spurious messages over rtnetlink. RTM_NEWLINK messages where
 // ifi_change == 0 and rta_type == IFLA_WIRELESS should be ignored.
@@ -34,6 +42,12 @@ bool IgnoreWirelessChange(const struct nlmsghdr* header,
   return false;
 }
 
+// Returns true if |address| is an IPv6 link-local address, in fe80::/10.
+bool IsIPv6LinkLocal(const IPAddress& address) {
+  return address.IsIPv6() && address.bytes()[0] == 0xfe &&
+         (address.bytes()[1] & 0xc0) == 0x80;
+}
+
 // Retrieves address from NETLINK address message.
 // Sets |really_deprecated| for IPv6 addresses with preferred lifetimes of 0.
 bool GetAddress(const struct nlmsghdr* header,
@@ -286,12 +300,12 @@ void AddressTrackerLinux::ReadMessages(bool* address_changed,
   *address_changed = false;
   *link_changed = false;
   *tunnel_changed = false;
-  char buffer[4096];
+  std::vector<char> buffer(kReadBufferSize);
   bool first_loop = true;
   for (;;) {
     int rv = HANDLE_EINTR(recv(netlink_fd_,
-                               buffer,
-                               sizeof(buffer),
+                               buffer.data(),
+                               buffer.size(),
                                // Block the first time through loop.
                                first_loop ? 0 : MSG_DONTWAIT));
     first_loop = false;
@@ -305,7 +319,8 @@ void AddressTrackerLinux::ReadMessages(bool* address_changed,
       PLOG(ERROR) << "Failed to recv from netlink socket";
       return;
     }
-    HandleMessage(buffer, rv, address_changed, link_changed, tunnel_changed);
+    HandleMessage(buffer.data(), rv, address_changed, link_changed,
+                  tunnel_changed);
   }
   if (*link_changed || *address_changed)
     UpdateCurrentConnectionType();
@@ -348,13 +363,15 @@ void AddressTrackerLinux::HandleMessage(char* buffer,
             msg->ifa_flags |= IFA_F_DEPRECATED;
           // Only indicate change if the address is new or ifaddrmsg info has
           // changed.
+          bool* changed =
+              IsIPv6LinkLocal(address) ? link_changed : address_changed;
           AddressMap::iterator it = address_map_.find(address);
           if (it == address_map_.end()) {
             address_map_.insert(it, std::make_pair(address, *msg));
-            *address_changed = true;
+            *changed = true;
           } else if (memcmp(&it->second, msg, sizeof(*msg))) {
             it->second = *msg;
-            *address_changed = true;
+            *changed = true;
           }
         }
       } break;
@@ -366,8 +383,12 @@ void AddressTrackerLinux::HandleMessage(char* buffer,
           break;
         if (GetAddress(header, &address, NULL)) {
           AddressTrackerAutoLock lock(*this, address_map_lock_);
-          if (address_map_.erase(address))
-            *address_changed = true;
+          if (address_map_.erase(address)) {
+            if (IsIPv6LinkLocal(address))
+              *link_changed = true;
+            else
+              *address_changed = true;
+          }
         }
       } break;
       case RTM_NEWLINK: {
@@ -420,6 +441,22 @@ void AddressTrackerLinux::OnFileCanReadWithoutBlocking(int fd) {
   bool link_changed;
   bool tunnel_changed;
   ReadMessages(&address_changed, &link_changed, &tunnel_changed);
+  RunCallbacks(address_changed, link_changed, tunnel_changed);
+}
+
+void AddressTrackerLinux::HandleMessagesForTesting(char* buffer,
+                                                   size_t length) {
+  bool address_changed = false;
+  bool link_changed = false;
+  bool tunnel_changed = false;
+  HandleMessage(buffer, length, &address_changed, &link_changed,
+                &tunnel_changed);
+  RunCallbacks(address_changed, link_changed, tunnel_changed);
+}
+
+void AddressTrackerLinux::RunCallbacks(bool address_changed,
+                                       bool link_changed,
+                                       bool tunnel_changed) {
   if (address_changed)
     address_callback_.Run();
   if (link_changed)
@@ -443,7 +480,10 @@ bool AddressTrackerLinux::IsTunnelInterface(int interface_index) const {
 }
 
 void AddressTrackerLinux::UpdateCurrentConnectionType() {
-  AddressTrackerLinux::AddressMap address_map = GetAddressMap();
+  // This runs on the thread which reads netlink messages, which is the only
+  // one to modify |address_map_|, so it can be read without the lock or a
+  // copy. Other threads only ever read it.
+  const AddressMap& address_map = address_map_;
   std::unordered_set<int> online_links = GetOnlineLinks();
 
   // Strip out tunnel interfaces from online_links
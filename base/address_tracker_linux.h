@@ -45,7 +45,10 @@ class NET_EXPORT_PRIVATE AddressTrackerLinux :
   // Tracking version constructor: it will run |address_callback| when
   // the AddressMap changes, |link_callback| when the list of online
   // links changes, and |tunnel_callback| when the list of online
-  // tunnels changes.
+  // tunnels changes. Changes to IPv6 link-local addresses, which every
+  // interface gets when it comes up, run |link_callback| rather than
+  // |address_callback|: connections do not use them, but they may still
+  // change the connection type.
   // |ignored_interfaces| is the list of interfaces to ignore.  Changes to an
   // ignored interface will not cause any callback to be run. An ignored
   // interface will not have entries in GetAddressMap() and GetOnlineLinks().
@@ -82,6 +85,11 @@ class NET_EXPORT_PRIVATE AddressTrackerLinux :
   // with exclusively talking to the kernel and not the C library.
   static char* GetInterfaceName(int interface_index, char* buf);
 
+  // Handles the netlink messages in |buffer| as if they had been read from the
+  // netlink socket, running the callbacks for the changes they make. Must be
+  // called on the thread the tracker was initialized on.
+  void HandleMessagesForTesting(char* buffer, size_t length);
+
  private:
   friend class AddressTrackerLinuxTest;
 
@@ -115,13 +123,20 @@ class NET_EXPORT_PRIVATE AddressTrackerLinux :
   // Sets |*address_changed| to true if |address_map_| changed, sets
   // |*link_changed| to true if |online_links_| changed, sets |*tunnel_changed|
   // to true if |online_links_| changed with regards to a tunnel interface while
-  // reading the message from |buffer|.
+  // reading the message from |buffer|. A change to |address_map_| which only
+  // concerns IPv6 link-local addresses sets |*link_changed| instead of
+  // |*address_changed|.
   void HandleMessage(char* buffer,
                      size_t length,
                      bool* address_changed,
                      bool* link_changed,
                      bool* tunnel_changed);
 
+  // Runs the callbacks of the changes flagged by HandleMessage().
+  void RunCallbacks(bool address_changed,
+                    bool link_changed,
+                    bool tunnel_changed);
+
   // Call when some part of initialization failed; forces online and unblocks.
   void AbortAndForceOnline();
 
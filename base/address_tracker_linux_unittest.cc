@@ -11,12 +11,18 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/run_loop.h"
 #include "base/synchronization/spin_wait.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/threading/simple_thread.h"
+#include "build/build_config.h"
 #include "net/base/ip_address.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#if !defined(OS_ANDROID)
+#include "net/base/network_change_notifier_linux.h"
+#endif
+
 #ifndef IFA_F_HOMEADDRESS
 #define IFA_F_HOMEADDRESS 0x10
 #endif
@@ -245,6 +251,8 @@ const unsigned char kAddress1[] = { 10, 0, 0, 1 };
 const unsigned char kAddress2[] = { 192, 168, 0, 1 };
 const unsigned char kAddress3[] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                     0, 0, 0, 1 };
+const unsigned char kAddress4[] = { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                    0, 0, 0, 1 };
 
 TEST_F(AddressTrackerLinuxTest, NewAddress) {
   InitializeAddressTracker(true);
@@ -424,6 +432,29 @@ TEST_F(AddressTrackerLinuxTest, DeprecatedLifetime) {
   EXPECT_EQ(IFA_F_DEPRECATED, map[kAddr3].ifa_flags);
 }
 
+TEST_F(AddressTrackerLinuxTest, LinkLocalAddress) {
+  InitializeAddressTracker(true);
+
+  const IPAddress kEmpty;
+  const IPAddress kAddr4(kAddress4);
+
+  // Adding and removing an IPv6 link-local address is reported as a link
+  // change rather than an address change.
+  Buffer buffer;
+  MakeAddrMessage(RTM_NEWADDR, 0, AF_INET6, kTestInterfaceEth, kEmpty, kAddr4,
+                  &buffer);
+  EXPECT_TRUE(HandleLinkMessage(buffer));
+  AddressTrackerLinux::AddressMap map = GetAddressMap();
+  EXPECT_EQ(1u, map.size());
+  EXPECT_EQ(1u, map.count(kAddr4));
+
+  buffer.clear();
+  MakeAddrMessage(RTM_DELADDR, 0, AF_INET6, kTestInterfaceEth, kEmpty, kAddr4,
+                  &buffer);
+  EXPECT_TRUE(HandleLinkMessage(buffer));
+  EXPECT_TRUE(GetAddressMap().empty());
+}
+
 TEST_F(AddressTrackerLinuxTest, IgnoredMessage) {
   InitializeAddressTracker(true);
 
@@ -736,6 +767,57 @@ TEST_F(AddressTrackerLinuxTest, BroadcastInit) {
   runner2.VerifyCompletes();
 }
 
+#if !defined(OS_ANDROID)
+class CountingIPAddressObserver
+    : public NetworkChangeNotifier::IPAddressObserver {
+ public:
+  CountingIPAddressObserver() : count_(0) {}
+
+  void OnIPAddressChanged() override { ++count_; }
+
+  int count() const { return count_; }
+
+ private:
+  int count_;
+};
+
+// Tests that IP address observers are not told about IPv6 link-local
+// addresses coming and going, but are told about other addresses.
+TEST(NetworkChangeNotifierLinuxTest, IgnoresLinkLocalAddresses) {
+  NetworkChangeNotifier::DisableForTest disable_for_test;
+  NetworkChangeNotifierLinux* notifier_linux =
+      new NetworkChangeNotifierLinux(std::unordered_set<std::string>());
+  std::unique_ptr<NetworkChangeNotifier> notifier(notifier_linux);
+  CountingIPAddressObserver observer;
+  NetworkChangeNotifier::AddIPAddressObserver(&observer);
+
+  const IPAddress kEmpty;
+  const IPAddress kLinkLocal(kAddress4);
+  Buffer buffer;
+  MakeAddrMessage(RTM_NEWADDR, 0, AF_INET6, kTestInterfaceEth, kEmpty,
+                  kLinkLocal, &buffer);
+  notifier_linux->HandleNetlinkMessagesForTesting(buffer);
+  buffer.clear();
+  MakeAddrMessage(RTM_DELADDR, 0, AF_INET6, kTestInterfaceEth, kEmpty,
+                  kLinkLocal, &buffer);
+  notifier_linux->HandleNetlinkMessagesForTesting(buffer);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(0, observer.count());
+
+  // 2001:db8::1, from the documentation prefix.
+  const IPAddress kGlobal(0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                          0, 1);
+  buffer.clear();
+  MakeAddrMessage(RTM_NEWADDR, 0, AF_INET6, kTestInterfaceEth, kEmpty, kGlobal,
+                  &buffer);
+  notifier_linux->HandleNetlinkMessagesForTesting(buffer);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, observer.count());
+
+  NetworkChangeNotifier::RemoveIPAddressObserver(&observer);
+}
+#endif  // !defined(OS_ANDROID)
+
 }  // namespace
 
 }  // namespace internal
@@ -4,8 +4,14 @@
 
 #include "net/base/chunked_upload_data_stream.h"
 
+#include <utility>
+
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ptr_util.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
@@ -22,6 +28,14 @@ bool ChunkedUploadDataStream::Writer::AppendData(const char* data,
   return true;
 }
 
+bool ChunkedUploadDataStream::Writer::AppendData(std::vector<char> data,
+                                                 bool is_done) {
+  if (!upload_data_stream_)
+    return false;
+  upload_data_stream_->AppendData(std::move(data), is_done);
+  return true;
+}
+
 ChunkedUploadDataStream::Writer::Writer(
     base::WeakPtr<ChunkedUploadDataStream> upload_data_stream)
     : upload_data_stream_(upload_data_stream) {}
@@ -31,6 +45,10 @@ ChunkedUploadDataStream::ChunkedUploadDataStream(int64_t identifier)
       read_index_(0),
       read_offset_(0),
       all_data_appended_(false),
+      bytes_appended_(0),
+      bytes_read_(0),
+      high_water_mark_(0),
+      drained_callback_pending_(false),
       read_buffer_len_(0),
       weak_factory_(this) {}
 
@@ -43,12 +61,19 @@ ChunkedUploadDataStream::CreateWriter() {
 
 void ChunkedUploadDataStream::AppendData(
     const char* data, int data_len, bool is_done) {
-  DCHECK(!all_data_appended_);
   DCHECK(data_len > 0 || is_done);
-  if (data_len > 0) {
-    DCHECK(data);
+  DCHECK(data || data_len == 0);
+  AppendData(std::vector<char>(data, data + data_len), is_done);
+}
+
+void ChunkedUploadDataStream::AppendData(std::vector<char> data,
+                                         bool is_done) {
+  DCHECK(!all_data_appended_);
+  DCHECK(!data.empty() || is_done);
+  if (!data.empty()) {
+    bytes_appended_ += data.size();
     upload_data_.push_back(
-        std::make_unique<std::vector<char>>(data, data + data_len));
+        std::make_unique<std::vector<char>>(std::move(data)));
   }
   all_data_appended_ = is_done;
 
@@ -63,6 +88,18 @@ void ChunkedUploadDataStream::AppendData(
   OnReadCompleted(result);
 }
 
+void ChunkedUploadDataStream::SetHighWaterMark(
+    size_t high_water_mark,
+    const base::RepeatingClosure& drained_callback) {
+  DCHECK(!high_water_mark || drained_callback);
+  high_water_mark_ = high_water_mark;
+  drained_callback_ = drained_callback;
+}
+
+bool ChunkedUploadDataStream::IsAboveHighWaterMark() const {
+  return high_water_mark_ && bytes_appended_ - bytes_read_ > high_water_mark_;
+}
+
 int ChunkedUploadDataStream::InitInternal(const NetLogWithSource& net_log) {
   // ResetInternal should already have been called.
   DCHECK(!read_buffer_.get());
@@ -88,9 +125,12 @@ void ChunkedUploadDataStream::ResetInternal() {
   read_buffer_len_ = 0;
   read_index_ = 0;
   read_offset_ = 0;
+  bytes_read_ = 0;
 }
 
 int ChunkedUploadDataStream::ReadChunk(IOBuffer* buf, int buf_len) {
+  bool was_above_high_water_mark = IsAboveHighWaterMark();
+
   // Copy as much data as possible from |upload_data_| to |buf|.
   int bytes_read = 0;
   while (read_index_ < upload_data_.size() && bytes_read < buf_len) {
@@ -108,6 +148,17 @@ int ChunkedUploadDataStream::ReadChunk(IOBuffer* buf, int buf_len) {
     }
   }
   DCHECK_LE(bytes_read, buf_len);
+  bytes_read_ += bytes_read;
+
+  // The callback is posted, as producers may append data from it, while this
+  // may be called from AppendData().
+  if (was_above_high_water_mark && !IsAboveHighWaterMark() &&
+      !drained_callback_pending_) {
+    drained_callback_pending_ = true;
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&ChunkedUploadDataStream::OnDrained,
+                                  weak_factory_.GetWeakPtr()));
+  }
 
   // If no data was written, and not all data has been appended, return
   // ERR_IO_PENDING. The read will be completed in the next call to AppendData.
@@ -119,4 +170,10 @@ int ChunkedUploadDataStream::ReadChunk(IOBuffer* buf, int buf_len) {
   return bytes_read;
 }
 
+void ChunkedUploadDataStream::OnDrained() {
+  drained_callback_pending_ = false;
+  if (!IsAboveHighWaterMark() && drained_callback_)
+    drained_callback_.Run();
+}
+
 }  // namespace net
@@ -11,6 +11,7 @@
 #include <memory>
 #include <vector>
 
+#include "base/callback.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
@@ -48,6 +49,9 @@ class NET_EXPORT ChunkedUploadDataStream : public UploadDataStream {
     // underlying ChunkedUploadDataStream was destroyed.
     bool AppendData(const char* data, int data_len, bool is_done);
 
+    // Same as above, but takes ownership of |data| instead of copying it.
+    bool AppendData(std::vector<char> data, bool is_done);
+
    private:
     friend class ChunkedUploadDataStream;
 
@@ -72,11 +76,24 @@ class NET_EXPORT ChunkedUploadDataStream : public UploadDataStream {
   // Adds data to the stream. |is_done| should be true if this is the last
   // data to be appended. |data_len| must not be 0 unless |is_done| is true.
   // Once called with |is_done| being true, must never be called again.
-  // TODO(mmenke):  Consider using IOBuffers instead, to reduce data copies.
   // TODO(mmenke):  Consider making private, and having all consumers use
   //     Writers.
   void AppendData(const char* data, int data_len, bool is_done);
 
+  // Same as above, but takes ownership of |data| instead of copying it.
+  void AppendData(std::vector<char> data, bool is_done);
+
+  // Sets the number of appended bytes which have not been read yet above which
+  // producers should stop appending data, so that a fast producer doesn't
+  // buffer arbitrary amounts of data ahead of the network. Once that many
+  // bytes or less are left unread, |drained_callback| is run asynchronously.
+  // A high water mark of 0, the default, disables this.
+  void SetHighWaterMark(size_t high_water_mark,
+                        const base::RepeatingClosure& drained_callback);
+
+  // Returns true if more bytes than the high water mark are left unread.
+  bool IsAboveHighWaterMark() const;
+
  private:
   // UploadDataStream implementation.
   int InitInternal(const NetLogWithSource& net_log) override;
@@ -85,6 +102,8 @@ class NET_EXPORT ChunkedUploadDataStream : public UploadDataStream {
 
   int ReadChunk(IOBuffer* buf, int buf_len);
 
+  void OnDrained();
+
   // Index and offset of next element of |upload_data_| to be read.
   size_t read_index_;
   size_t read_offset_;
@@ -94,6 +113,16 @@ class NET_EXPORT ChunkedUploadDataStream : public UploadDataStream {
 
   std::vector<std::unique_ptr<std::vector<char>>> upload_data_;
 
+  // Number of bytes appended to |upload_data_|, and number of them read since
+  // the last rewind.
+  size_t bytes_appended_;
+  size_t bytes_read_;
+
+  size_t high_water_mark_;
+  base::RepeatingClosure drained_callback_;
+  // True while a task to run |drained_callback_| is posted.
+  bool drained_callback_pending_;
+
   // Buffer to write the next read's data to. Only set when a call to
   // ReadInternal reads no data.
   scoped_refptr<IOBuffer> read_buffer_;
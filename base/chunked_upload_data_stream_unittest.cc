@@ -6,7 +6,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "base/bind.h"
+#include "base/run_loop.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
@@ -337,6 +340,59 @@ TEST(ChunkedUploadDataStreamTest, RewindWhileReading) {
   EXPECT_FALSE(callback.have_result());
 }
 
+TEST(ChunkedUploadDataStreamTest, AppendOwnedData) {
+  ChunkedUploadDataStream stream(0);
+  ASSERT_THAT(
+      stream.Init(TestCompletionCallback().callback(), NetLogWithSource()),
+      IsOk());
+
+  stream.AppendData(std::vector<char>(kTestData, kTestData + kTestDataSize),
+                    false);
+  stream.AppendData(std::vector<char>(kTestData, kTestData + kTestDataSize),
+                    true);
+  std::string data = ReadSync(&stream, kTestBufferSize);
+  EXPECT_EQ(std::string(kTestData) + kTestData, data);
+  EXPECT_TRUE(stream.IsEOF());
+}
+
+TEST(ChunkedUploadDataStreamTest, HighWaterMark) {
+  ChunkedUploadDataStream stream(0);
+  int drained_count = 0;
+  stream.SetHighWaterMark(
+      kTestDataSize,
+      base::BindRepeating([](int* drained_count) { ++*drained_count; },
+                          &drained_count));
+  ASSERT_THAT(
+      stream.Init(TestCompletionCallback().callback(), NetLogWithSource()),
+      IsOk());
+
+  stream.AppendData(kTestData, kTestDataSize, false);
+  EXPECT_FALSE(stream.IsAboveHighWaterMark());
+  stream.AppendData(kTestData, 1, false);
+  EXPECT_TRUE(stream.IsAboveHighWaterMark());
+
+  // Reading a single byte gets back to the high water mark.
+  EXPECT_EQ(std::string(kTestData, 1), ReadSync(&stream, 1));
+  EXPECT_FALSE(stream.IsAboveHighWaterMark());
+  EXPECT_EQ(0, drained_count);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, drained_count);
+
+  // The callback isn't run again while the stream stays below the mark.
+  ReadSync(&stream, kTestBufferSize);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(1, drained_count);
+
+  // Rewinding makes all the data unread again.
+  ASSERT_THAT(
+      stream.Init(TestCompletionCallback().callback(), NetLogWithSource()),
+      IsOk());
+  EXPECT_TRUE(stream.IsAboveHighWaterMark());
+  ReadSync(&stream, kTestBufferSize);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(2, drained_count);
+}
+
 // Check the behavior of ChunkedUploadDataStream::Writer.
 TEST(ChunkedUploadDataStreamTest, ChunkedUploadDataStreamWriter) {
   std::unique_ptr<ChunkedUploadDataStream> stream(
@@ -40,23 +40,36 @@ std::string Escape(base::StringPiece text,
                    const Charmap& charmap,
                    bool use_plus,
                    bool keep_escaped = false) {
+  // Runs of characters which are kept as they are are appended at once, and
+  // text which needs no escaping is copied without reserving space for
+  // escapes.
   std::string escaped;
-  escaped.reserve(text.length() * 3);
-  for (unsigned int i = 0; i < text.length(); ++i) {
+  size_t run_start = 0;
+  for (size_t i = 0; i < text.length(); ++i) {
     unsigned char c = static_cast<unsigned char>(text[i]);
-    if (use_plus && ' ' == c) {
+    bool plus = use_plus && ' ' == c;
+    if (!plus &&
+        (!charmap.Contains(c) ||
+         (keep_escaped && '%' == c && i + 2 < text.length() &&
+          base::IsHexDigit(text[i + 1]) && base::IsHexDigit(text[i + 2])))) {
+      continue;
+    }
+
+    // Every escape appends at least one character, so |escaped| is only empty
+    // before the first one.
+    if (escaped.empty())
+      escaped.reserve(text.length() * 3);
+    escaped.append(text.data() + run_start, i - run_start);
+    if (plus) {
       escaped.push_back('+');
-    } else if (keep_escaped && '%' == c && i + 2 < text.length() &&
-               base::IsHexDigit(text[i + 1]) && base::IsHexDigit(text[i + 2])) {
-      escaped.push_back('%');
-    } else if (charmap.Contains(c)) {
+    } else {
       escaped.push_back('%');
       escaped.push_back(IntToHex(c >> 4));
       escaped.push_back(IntToHex(c & 0xf));
-    } else {
-      escaped.push_back(c);
     }
+    run_start = i + 1;
   }
+  escaped.append(text.data() + run_start, text.length() - run_start);
   return escaped;
 }
 
@@ -207,6 +220,13 @@ STR UnescapeURLWithAdjustmentsImpl(
   if (rules == UnescapeRule::NONE)
     return escaped_text.as_string();
 
+  // Text without escapes, and without pluses to replace, is returned as it is.
+  if (escaped_text.find('%') == base::BasicStringPiece<STR>::npos &&
+      (!(rules & UnescapeRule::REPLACE_PLUS_WITH_SPACE) ||
+       escaped_text.find('+') == base::BasicStringPiece<STR>::npos)) {
+    return escaped_text.as_string();
+  }
+
   // The output of the unescaping is always smaller than the input, so we can
   // reserve the input size to make sure we have enough buffer and don't have
   // to allocate in the loop below.
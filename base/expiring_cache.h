@@ -143,14 +143,19 @@ class ExpiringCache {
            const ValueType& value,
            const ExpirationType& now,
            const ExpirationType& expiration) {
-    typename EntryMap::iterator it = entries_.find(key);
-    if (it == entries_.end()) {
-      // Compact the cache if it grew beyond the limit.
-      if (entries_.size() == max_entries_ )
+    // Look up |key| once, and use the result as the insertion hint if there
+    // is no existing entry.
+    typename EntryMap::iterator it = entries_.lower_bound(key);
+    if (it == entries_.end() || entries_.key_comp()(key, it->first)) {
+      // Compact the cache if it grew beyond the limit. This may erase the
+      // hint.
+      if (entries_.size() == max_entries_) {
         Compact(now);
+        it = entries_.lower_bound(key);
+      }
 
       // No existing entry. Creating a new one.
-      entries_.insert(std::make_pair(key, Entry(value, expiration)));
+      entries_.insert(it, std::make_pair(key, Entry(value, expiration)));
     } else {
       // Update an existing cache entry.
       it->second.first = value;
@@ -55,6 +55,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <iterator>
 #include <ostream>
 #include <set>
 #include <string>
@@ -357,6 +358,23 @@ template <typename T>
 void IntervalSet<T>::Add(const Interval<T>& interval) {
   if (interval.Empty())
     return;
+  // Fast path for intervals which start within or after the last interval,
+  // which is what data arriving in order looks like. It does without the
+  // lookups, and without the node allocations of Compact().
+  if (!intervals_.empty()) {
+    const typename Set::iterator last = std::prev(intervals_.end());
+    if (interval.min() > last->max()) {
+      intervals_.insert(intervals_.end(), interval);
+      return;
+    }
+    if (interval.min() >= last->min()) {
+      // The last interval stays after all others when its max grows, so it
+      // can be updated in place without breaking the order of the set.
+      if (interval.max() > last->max())
+        const_cast<Interval<T>&>(*last).SetMax(interval.max());
+      return;
+    }
+  }
   std::pair<typename Set::iterator, bool> ins = intervals_.insert(interval);
   if (!ins.second) {
     // This interval already exists.
@@ -275,6 +275,32 @@ TEST_F(IntervalSetTest, IntervalSetBasic) {
   EXPECT_FALSE(iset.Contains(IntervalSet<int>()));
 }
 
+TEST_F(IntervalSetTest, AddAtEnd) {
+  IntervalSet<int> iset;
+  iset.Add(0, 10);
+  iset.Add(10, 20);
+  EXPECT_TRUE(Check(iset, 1, 0, 20));
+  iset.Add(15, 18);
+  EXPECT_TRUE(Check(iset, 1, 0, 20));
+  iset.Add(0, 20);
+  EXPECT_TRUE(Check(iset, 1, 0, 20));
+  iset.Add(30, 40);
+  EXPECT_TRUE(Check(iset, 2, 0, 20, 30, 40));
+  iset.Add(35, 50);
+  EXPECT_TRUE(Check(iset, 2, 0, 20, 30, 50));
+  iset.Add(50, 60);
+  EXPECT_TRUE(Check(iset, 2, 0, 20, 30, 60));
+  iset.Add(60, 61);
+  iset.Add(70, 80);
+  EXPECT_TRUE(Check(iset, 3, 0, 20, 30, 61, 70, 80));
+  EXPECT_TRUE(iset.Contains(75));
+  EXPECT_FALSE(iset.Contains(65));
+
+  // An interval starting before the last one takes the general path.
+  iset.Add(5, 75);
+  EXPECT_TRUE(Check(iset, 1, 0, 80));
+}
+
 TEST_F(IntervalSetTest, IntervalSetContainsEmpty) {
   const IntervalSet<int> empty;
   const IntervalSet<int> other_empty;
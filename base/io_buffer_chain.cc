@@ -0,0 +1,114 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_chain.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace net {
+
+IOBufferChain::Slice::Slice(scoped_refptr<IOBuffer> buffer,
+                            size_t offset,
+                            size_t size)
+    : buffer(std::move(buffer)), offset(offset), size(size) {}
+
+IOBufferChain::Slice::Slice(const Slice& other) = default;
+
+IOBufferChain::Slice::Slice(Slice&& other) = default;
+
+IOBufferChain::Slice& IOBufferChain::Slice::operator=(const Slice& other) =
+    default;
+
+IOBufferChain::Slice& IOBufferChain::Slice::operator=(Slice&& other) = default;
+
+IOBufferChain::Slice::~Slice() = default;
+
+IOBufferChain::IOBufferChain() : size_(0) {}
+
+IOBufferChain::IOBufferChain(IOBufferChain&& other)
+    : slices_(std::move(other.slices_)), size_(other.size_) {
+  other.slices_.clear();
+  other.size_ = 0;
+}
+
+IOBufferChain& IOBufferChain::operator=(IOBufferChain&& other) {
+  slices_ = std::move(other.slices_);
+  size_ = other.size_;
+  other.slices_.clear();
+  other.size_ = 0;
+  return *this;
+}
+
+IOBufferChain::~IOBufferChain() = default;
+
+void IOBufferChain::Append(scoped_refptr<IOBuffer> buffer,
+                           size_t offset,
+                           size_t size) {
+  DCHECK(buffer);
+  if (size == 0)
+    return;
+  slices_.emplace_back(std::move(buffer), offset, size);
+  size_ += size;
+}
+
+void IOBufferChain::Append(IOBufferChain other) {
+  for (Slice& slice : other.slices_)
+    slices_.push_back(std::move(slice));
+  size_ += other.size_;
+  other.slices_.clear();
+  other.size_ = 0;
+}
+
+void IOBufferChain::Consume(size_t size) {
+  DCHECK_LE(size, size_);
+  size_ -= size;
+  while (size > 0) {
+    Slice& front = slices_.front();
+    if (size < front.size) {
+      front.offset += size;
+      front.size -= size;
+      return;
+    }
+    size -= front.size;
+    slices_.pop_front();
+  }
+}
+
+IOBufferChain IOBufferChain::Split(size_t size) {
+  DCHECK_LE(size, size_);
+  IOBufferChain prefix;
+  while (size > 0) {
+    Slice& front = slices_.front();
+    if (size < front.size) {
+      prefix.Append(front.buffer, front.offset, size);
+      Consume(size);
+      break;
+    }
+    size -= front.size;
+    size_ -= front.size;
+    prefix.size_ += front.size;
+    prefix.slices_.push_back(std::move(front));
+    slices_.pop_front();
+  }
+  return prefix;
+}
+
+void IOBufferChain::CopyTo(char* dest, size_t size) const {
+  DCHECK_LE(size, size_);
+  for (const Slice& slice : slices_) {
+    if (size == 0)
+      break;
+    size_t bytes_to_copy = std::min(size, slice.size);
+    memcpy(dest, slice.data(), bytes_to_copy);
+    dest += bytes_to_copy;
+    size -= bytes_to_copy;
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,80 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_IO_BUFFER_CHAIN_H_
+#define NET_BASE_IO_BUFFER_CHAIN_H_
+
+#include <stddef.h>
+
+#include "base/containers/circular_deque.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// A sequence of bytes made of slices of IOBuffers, which are referenced rather
+// than copied. Appending, consuming from the front and splitting off a prefix
+// only copy references to the slices, so that data can be passed between
+// layers which combine or cut it without copying it.
+//
+// The slices are exposed for vectored I/O, e.g. to build an array of iovecs.
+class NET_EXPORT IOBufferChain {
+ public:
+  // |size| bytes of |buffer|, starting at |offset|.
+  struct NET_EXPORT Slice {
+    Slice(scoped_refptr<IOBuffer> buffer, size_t offset, size_t size);
+    Slice(const Slice& other);
+    Slice(Slice&& other);
+    Slice& operator=(const Slice& other);
+    Slice& operator=(Slice&& other);
+    ~Slice();
+
+    const char* data() const { return buffer->data() + offset; }
+
+    scoped_refptr<IOBuffer> buffer;
+    size_t offset;
+    size_t size;
+  };
+
+  IOBufferChain();
+  IOBufferChain(IOBufferChain&& other);
+  IOBufferChain& operator=(IOBufferChain&& other);
+  ~IOBufferChain();
+
+  // Appends |size| bytes of |buffer| starting at |offset|. Does nothing if
+  // |size| is 0.
+  void Append(scoped_refptr<IOBuffer> buffer, size_t offset, size_t size);
+
+  // Appends all the slices of |other|, leaving it empty.
+  void Append(IOBufferChain other);
+
+  // Removes the first |size| bytes, which must not be more than size().
+  void Consume(size_t size);
+
+  // Removes the first |size| bytes, which must not be more than size(), and
+  // returns them as a new chain. A slice which straddles the split point is
+  // shared by both chains.
+  IOBufferChain Split(size_t size);
+
+  // Copies the first |size| bytes, which must not be more than size(), to
+  // |dest|. Does not consume them.
+  void CopyTo(char* dest, size_t size) const;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const base::circular_deque<Slice>& slices() const { return slices_; }
+
+ private:
+  base::circular_deque<Slice> slices_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOBufferChain);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_IO_BUFFER_CHAIN_H_
@@ -0,0 +1,108 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_chain.h"
+
+#include <string>
+#include <utility>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+scoped_refptr<IOBuffer> MakeBuffer(const std::string& data) {
+  return base::MakeRefCounted<StringIOBuffer>(data);
+}
+
+std::string ToString(const IOBufferChain& chain) {
+  std::string result(chain.size(), '\0');
+  chain.CopyTo(&result[0], chain.size());
+  return result;
+}
+
+TEST(IOBufferChainTest, AppendAndConsume) {
+  IOBufferChain chain;
+  EXPECT_TRUE(chain.empty());
+
+  chain.Append(MakeBuffer("xxhello"), 2, 5);
+  chain.Append(MakeBuffer("unused"), 0, 0);
+  chain.Append(MakeBuffer(", world"), 0, 7);
+  EXPECT_EQ(12u, chain.size());
+  EXPECT_EQ(2u, chain.slices().size());
+  EXPECT_EQ("hello, world", ToString(chain));
+
+  chain.Consume(3);
+  EXPECT_EQ("lo, world", ToString(chain));
+  EXPECT_EQ(2u, chain.slices().size());
+
+  // Consuming the rest of a slice drops it.
+  chain.Consume(2);
+  EXPECT_EQ(", world", ToString(chain));
+  EXPECT_EQ(1u, chain.slices().size());
+
+  chain.Consume(7);
+  EXPECT_TRUE(chain.empty());
+  EXPECT_TRUE(chain.slices().empty());
+}
+
+TEST(IOBufferChainTest, Split) {
+  scoped_refptr<IOBuffer> buffer = MakeBuffer("headerbody");
+  IOBufferChain chain;
+  chain.Append(buffer, 0, 10);
+  chain.Append(MakeBuffer(" more"), 0, 5);
+
+  // The slice which straddles the split point is shared, not copied.
+  IOBufferChain header = chain.Split(6);
+  EXPECT_EQ("header", ToString(header));
+  EXPECT_EQ("body more", ToString(chain));
+  ASSERT_EQ(1u, header.slices().size());
+  EXPECT_EQ(buffer, header.slices().front().buffer);
+  EXPECT_EQ(buffer, chain.slices().front().buffer);
+  EXPECT_EQ(buffer->data() + 6, chain.slices().front().data());
+
+  // Splitting at a slice boundary moves whole slices.
+  IOBufferChain body = chain.Split(4);
+  EXPECT_EQ("body", ToString(body));
+  EXPECT_EQ(" more", ToString(chain));
+  EXPECT_EQ(1u, chain.slices().size());
+
+  header.Append(std::move(body));
+  header.Append(std::move(chain));
+  EXPECT_EQ("headerbody more", ToString(header));
+  EXPECT_EQ(3u, header.slices().size());
+  EXPECT_TRUE(chain.empty());
+}
+
+TEST(IOBufferChainTest, CopyToPrefix) {
+  IOBufferChain chain;
+  chain.Append(MakeBuffer("abc"), 0, 3);
+  chain.Append(MakeBuffer("def"), 0, 3);
+  char data[4];
+  chain.CopyTo(data, 4);
+  EXPECT_EQ("abcd", std::string(data, 4));
+  EXPECT_EQ(6u, chain.size());
+}
+
+TEST(IOBufferChainTest, MoveSlice) {
+  scoped_refptr<IOBuffer> buffer = MakeBuffer("hello");
+  IOBufferChain::Slice slice(buffer, 1, 3);
+  EXPECT_FALSE(buffer->HasOneRef());
+
+  // Moving a slice takes its reference rather than adding one.
+  IOBufferChain::Slice moved(std::move(slice));
+  EXPECT_FALSE(slice.buffer);
+  EXPECT_EQ(buffer, moved.buffer);
+  EXPECT_EQ("ell", std::string(moved.data(), moved.size));
+
+  IOBufferChain::Slice assigned(MakeBuffer("other"), 0, 5);
+  assigned = std::move(moved);
+  EXPECT_FALSE(moved.buffer);
+  EXPECT_EQ(buffer, assigned.buffer);
+}
+
+}  // namespace
+
+}  // namespace net
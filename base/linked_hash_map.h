@@ -208,22 +208,21 @@ class linked_hash_map {
 
   // Inserts an element into the map
   std::pair<iterator, bool> insert(const std::pair<Key, Value>& pair) {
-    // First make sure the map doesn't have a key with this value.  If it does,
-    // return a pair with an iterator to it, and false indicating that we
-    // didn't insert anything.
-    typename MapType::iterator found = map_.find(pair.first);
-    if (found != map_.end()) return std::make_pair(found->second, false);
+    // Insert the key into the map first, so that it is only hashed once.  If
+    // the map already has a key with this value, return a pair with an
+    // iterator to it, and false indicating that we didn't insert anything.
+    std::pair<typename MapType::iterator, bool> ins =
+        map_.insert(std::make_pair(pair.first, list_.end()));
+    if (!ins.second)
+      return std::make_pair(ins.first->second, false);
 
-    // Otherwise, insert into the list first.
+    // Otherwise, insert into the list and point the map at the newly added
+    // element.  We do -- instead of - since list::iterator doesn't implement
+    // operator-().
     list_.push_back(pair);
-
-    // Obtain an iterator to the newly added element.  We do -- instead of -
-    // since list::iterator doesn't implement operator-().
     typename ListType::iterator last = list_.end();
     --last;
-
-    CHECK(map_.insert(std::make_pair(pair.first, last)).second)
-        << "Map and list are inconsistent";
+    ins.first->second = last;
 
     return std::make_pair(last, true);
   }
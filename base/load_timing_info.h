@@ -129,6 +129,11 @@ struct NET_EXPORT LoadTimingInfo {
 
   base::TimeTicks request_start;
 
+  // The time spent blocked by the NetworkThrottleManager before the request
+  // could be sent to the network.  Null when the request was not throttled.
+  base::TimeTicks throttle_start;
+  base::TimeTicks throttle_end;
+
   // The time spent determing which proxy to use.  Null when there is no PAC.
   base::TimeTicks proxy_resolve_start;
   base::TimeTicks proxy_resolve_end;
@@ -195,4 +195,33 @@ int LookupStringInFixedSet(const unsigned char* graph,
   return lookup.GetResultForCurrentSequence();
 }
 
+int LookupSuffixInReversedSet(const unsigned char* graph,
+                              size_t length,
+                              bool include_private,
+                              const char* host,
+                              size_t host_length,
+                              size_t* suffix_length) {
+  FixedSetIncrementalLookup lookup(graph, length);
+  *suffix_length = 0;
+  int result = kDafsaNotFound;
+  size_t pos = host_length;
+  // Look up |host| from right to left, until either the end of the graph is
+  // reached or every character is consumed.
+  while (pos > 0 && lookup.Advance(host[pos - 1])) {
+    --pos;
+    // Only |host| itself or a part which follows a dot can match.
+    if (pos > 0 && host[pos - 1] != '.')
+      continue;
+    int value = lookup.GetResultForCurrentSequence();
+    if (value == kDafsaNotFound)
+      continue;
+    if ((value & kDafsaPrivateRule) && !include_private)
+      continue;
+    // Since |host| is read from right to left, the last match is the longest.
+    *suffix_length = host_length - pos;
+    result = value;
+  }
+  return result;
+}
+
 }  // namespace net
@@ -142,6 +142,23 @@ class NET_EXPORT FixedSetIncrementalLookup {
   bool pos_is_label_character_;
 };
 
+// Looks up the longest suffix of |host| with length |host_length| in a DAFSA
+// generated by make_dafsa.py with --reverse, reading |host| backwards. Only
+// suffixes which are |host| itself or which start right after a '.' are
+// matched. Matches of kDafsaPrivateRule entries are skipped unless
+// |include_private| is true.
+//
+// Returns the result code of the longest match and sets |*suffix_length| to
+// its length, or returns kDafsaNotFound and sets |*suffix_length| to 0 if no
+// suffix was matched. This reads each character of |host| at most once,
+// rather than looking up each suffix separately.
+NET_EXPORT int LookupSuffixInReversedSet(const unsigned char* graph,
+                                         size_t length,
+                                         bool include_private,
+                                         const char* host,
+                                         size_t host_length,
+                                         size_t* suffix_length);
+
 }  // namespace net
 
 #endif  // NET_BASE_LOOKUP_STRING_IN_FIXED_SET_H_
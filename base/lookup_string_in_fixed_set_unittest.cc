@@ -25,6 +25,9 @@ namespace {
 namespace test1 {
 #include "net/base/registry_controlled_domains/effective_tld_names_unittest1-inc.cc"
 }
+namespace test1_reversed {
+#include "net/base/registry_controlled_domains/effective_tld_names_unittest1-reversed-inc.cc"
+}
 namespace test3 {
 #include "net/base/registry_controlled_domains/effective_tld_names_unittest3-inc.cc"
 }
@@ -247,5 +250,38 @@ TEST(LookupStringInFixedSetTest, Dafsa6EnumerateLanguage) {
   EXPECT_EQ(expected_language, language);
 }
 
+// Tests suffix lookups in the reversed DAFSA built from
+// effective_tld_names_unittest1.gperf.
+TEST(LookupStringInFixedSetTest, LookupSuffixInReversedSet) {
+  struct {
+    const char* host;
+    bool include_private;
+    int value;
+    size_t suffix_length;
+  } kTestCases[] = {
+      // The longest match wins.
+      {"foo.bar.jp", false, 2, 6},
+      {"baz.bar.jp", false, 2, 10},
+      {"jp", false, 0, 2},
+      // Matches must start at the beginning of a component.
+      {"xbar.jp", false, 0, 2},
+      // Private rules only match if they're included.
+      {"a.priv.no", false, 0, 2},
+      {"a.priv.no", true, 4, 7},
+      {"foo.com", true, kDafsaNotFound, 0},
+  };
+
+  for (const auto& test_case : kTestCases) {
+    SCOPED_TRACE(test_case.host);
+    size_t suffix_length = 1;
+    EXPECT_EQ(test_case.value,
+              LookupSuffixInReversedSet(
+                  test1_reversed::kDafsa, sizeof(test1_reversed::kDafsa),
+                  test_case.include_private, test_case.host,
+                  strlen(test_case.host), &suffix_length));
+    EXPECT_EQ(test_case.suffix_length, suffix_length);
+  }
+}
+
 }  // namespace
 }  // namespace net
@@ -106,7 +106,11 @@ class NET_EXPORT NetworkChangeNotifier {
   class NET_EXPORT IPAddressObserver {
    public:
     // Will be called when the IP address of the primary interface changes.
-    // This includes when the primary interface itself changes.
+    // This includes when the primary interface itself changes. On Linux,
+    // IPv6 link-local addresses coming and going are not reported: every
+    // interface gets one when it comes up, including container and VPN
+    // interfaces, and connections are not made from them. They can still
+    // cause a connection type change.
     virtual void OnIPAddressChanged() = 0;
 
    protected:
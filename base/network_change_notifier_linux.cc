@@ -29,6 +29,10 @@ class NetworkChangeNotifierLinux::Thread : public base::Thread {
     return address_tracker_.get();
   }
 
+  void HandleNetlinkMessagesForTesting(std::vector<char> buffer) {
+    address_tracker_->HandleMessagesForTesting(buffer.data(), buffer.size());
+  }
+
  protected:
   // base::Thread
   void Init() override;
@@ -112,6 +116,14 @@ NetworkChangeNotifierLinux::~NetworkChangeNotifierLinux() {
   notifier_thread_->Stop();
 }
 
+void NetworkChangeNotifierLinux::HandleNetlinkMessagesForTesting(
+    const std::vector<char>& buffer) {
+  notifier_thread_->task_runner()->PostTask(
+      FROM_HERE, base::Bind(&Thread::HandleNetlinkMessagesForTesting,
+                            base::Unretained(notifier_thread_.get()), buffer));
+  notifier_thread_->FlushForTesting();
+}
+
 // static
 NetworkChangeNotifier::NetworkChangeCalculatorParams
 NetworkChangeNotifierLinux::NetworkChangeCalculatorParamsLinux() {
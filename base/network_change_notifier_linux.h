@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -27,6 +28,10 @@ class NET_EXPORT_PRIVATE NetworkChangeNotifierLinux
   explicit NetworkChangeNotifierLinux(
       const std::unordered_set<std::string>& ignored_interfaces);
 
+  // Handles the netlink messages in |buffer| on the notifier thread as if they
+  // had been read from the netlink socket, and waits until they are handled.
+  void HandleNetlinkMessagesForTesting(const std::vector<char>& buffer);
+
  private:
   class Thread;
 
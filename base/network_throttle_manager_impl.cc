@@ -8,10 +8,13 @@
 #include "base/stl_util.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/default_tick_clock.h"
+#include "net/nqe/network_quality_provider.h"
 
 namespace net {
 
 const size_t NetworkThrottleManagerImpl::kActiveRequestThrottlingLimit = 2;
+const size_t
+    NetworkThrottleManagerImpl::kFastConnectionActiveRequestThrottlingLimit = 6;
 const int NetworkThrottleManagerImpl::kMedianLifetimeMultiple = 5;
 
 // Initial estimate based on the median in the
@@ -151,7 +154,12 @@ void NetworkThrottleManagerImpl::ThrottleImpl::NotifyUnblocked() {
 }
 
 NetworkThrottleManagerImpl::NetworkThrottleManagerImpl()
-    : lifetime_median_estimate_(PercentileEstimator::kMedianPercentile,
+    : NetworkThrottleManagerImpl(nullptr) {}
+
+NetworkThrottleManagerImpl::NetworkThrottleManagerImpl(
+    NetworkQualityProvider* network_quality_provider)
+    : network_quality_provider_(network_quality_provider),
+      lifetime_median_estimate_(PercentileEstimator::kMedianPercentile,
                                 kInitialMedianInMs),
       outstanding_recomputation_timer_(
           std::make_unique<base::Timer>(false /* retain_user_task */,
@@ -168,7 +176,7 @@ NetworkThrottleManagerImpl::CreateThrottle(
     bool ignore_limits) {
   bool blocked =
       (!ignore_limits && priority == THROTTLED &&
-       outstanding_throttles_.size() >= kActiveRequestThrottlingLimit);
+       outstanding_throttles_.size() >= GetActiveRequestThrottlingLimit());
 
   std::unique_ptr<NetworkThrottleManagerImpl::ThrottleImpl> throttle(
       new ThrottleImpl(blocked, priority, delegate, this,
@@ -246,7 +254,7 @@ void NetworkThrottleManagerImpl::OnThrottleDestroyed(ThrottleImpl* throttle) {
 
   // Unblock the throttles if there's some chance there's a throttle to
   // unblock.
-  if (outstanding_throttles_.size() < kActiveRequestThrottlingLimit &&
+  if (outstanding_throttles_.size() < GetActiveRequestThrottlingLimit() &&
       !blocked_throttles_.empty()) {
     // Via PostTask so there aren't upcalls from within destructors.
     base::ThreadTaskRunnerHandle::Get()->PostTask(
@@ -256,6 +264,15 @@ void NetworkThrottleManagerImpl::OnThrottleDestroyed(ThrottleImpl* throttle) {
   }
 }
 
+size_t NetworkThrottleManagerImpl::GetActiveRequestThrottlingLimit() const {
+  if (network_quality_provider_ &&
+      network_quality_provider_->GetEffectiveConnectionType() ==
+          EFFECTIVE_CONNECTION_TYPE_4G) {
+    return kFastConnectionActiveRequestThrottlingLimit;
+  }
+  return kActiveRequestThrottlingLimit;
+}
+
 void NetworkThrottleManagerImpl::RecomputeOutstanding() {
   // Remove all throttles that have aged out of the outstanding set.
   base::TimeTicks now(tick_clock_->NowTicks());
@@ -314,7 +331,7 @@ void NetworkThrottleManagerImpl::UnblockThrottle(ThrottleImpl* throttle) {
 void NetworkThrottleManagerImpl::MaybeUnblockThrottles() {
   RecomputeOutstanding();
 
-  while (outstanding_throttles_.size() < kActiveRequestThrottlingLimit &&
+  while (outstanding_throttles_.size() < GetActiveRequestThrottlingLimit() &&
          !blocked_throttles_.empty()) {
     // NOTE: This call may result in reentrant calls into
     // NetworkThrottleManagerImpl; no state should be assumed to be
@@ -18,6 +18,8 @@
 
 namespace net {
 
+class NetworkQualityProvider;
+
 // The NetworkThrottleManagerImpl implements the following semantics:
 // * All throttles of priority above THROTTLED are created unblocked.
 // * Throttles of priority THROTTLED are created unblocked, unless
@@ -28,6 +30,9 @@ namespace net {
 // * Throttles that have been alive for more than |kMedianLifetimeMultiple|
 //   times the current estimate of the throttle median lifetime do
 //   not count against the |kActiveRequestThrottlingLimit| limit.
+// * If the network quality estimator reports a 4G effective connection
+//   type, |kFastConnectionActiveRequestThrottlingLimit| is used instead,
+//   since THROTTLED requests then take little bandwidth from the others.
 class NET_EXPORT NetworkThrottleManagerImpl : public NetworkThrottleManager {
  public:
   // Maximum number of active requests before new THROTTLED throttles
@@ -35,6 +40,10 @@ class NET_EXPORT NetworkThrottleManagerImpl : public NetworkThrottleManager {
   // fall below this limit.
   static const size_t kActiveRequestThrottlingLimit;
 
+  // The limit used instead of |kActiveRequestThrottlingLimit| on fast
+  // connections.
+  static const size_t kFastConnectionActiveRequestThrottlingLimit;
+
   // Note that the following constants are implementation details exposed in the
   // header file only for testing, and should not be relied on by consumers.
 
@@ -64,6 +73,10 @@ class NET_EXPORT NetworkThrottleManagerImpl : public NetworkThrottleManager {
   static const int kInitialMedianInMs;
 
   NetworkThrottleManagerImpl();
+  // |network_quality_provider| may be null, in which case the connection is
+  // never considered fast. Otherwise it must outlive this object.
+  explicit NetworkThrottleManagerImpl(
+      NetworkQualityProvider* network_quality_provider);
   ~NetworkThrottleManagerImpl() override;
 
   // NetworkThrottleManager:
@@ -101,6 +114,10 @@ class NET_EXPORT NetworkThrottleManagerImpl : public NetworkThrottleManager {
                                  RequestPriority new_priority);
   void OnThrottleDestroyed(ThrottleImpl* throttle);
 
+  // Returns the number of active requests beyond which THROTTLED throttles
+  // are blocked, given the current effective connection type.
+  size_t GetActiveRequestThrottlingLimit() const;
+
   // Recompute how many requests count as outstanding (i.e.
   // are not older than kMedianLifetimeMultiple * MedianThrottleLifetime()).
   // If outstanding_recomputation_timer_ is not set, it will be set
@@ -118,6 +135,8 @@ class NET_EXPORT NetworkThrottleManagerImpl : public NetworkThrottleManager {
   // should be made across this call.
   void MaybeUnblockThrottles();
 
+  NetworkQualityProvider* const network_quality_provider_;
+
   PercentileEstimator lifetime_median_estimate_;
 
   // base::Timer controlling outstanding request recomputation.
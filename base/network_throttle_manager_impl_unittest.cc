@@ -14,6 +14,7 @@
 #include "base/test/simple_test_tick_clock.h"
 #include "base/test/test_message_loop.h"
 #include "net/base/request_priority.h"
+#include "net/nqe/network_quality_provider.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -63,6 +64,15 @@ class NetworkThrottleManagerTest : public testing::Test,
     return throttle_manager_.get();
   }
 
+  // Replaces the throttle manager with one which uses
+  // |network_quality_provider|.
+  void UseNetworkQualityProvider(
+      NetworkQualityProvider* network_quality_provider) {
+    throttle_manager_ =
+        std::make_unique<NetworkThrottleManagerImpl>(network_quality_provider);
+    throttle_manager_->SetTickClockForTesting(&clock_);
+  }
+
   // Set the offset of the test clock from now_.
   void SetClockDelta(base::TimeDelta time_delta) {
     clock_.SetNowTicks(now_ + time_delta);
@@ -116,6 +126,27 @@ class NetworkThrottleManagerTest : public testing::Test,
   DISALLOW_COPY_AND_ASSIGN(NetworkThrottleManagerTest);
 };
 
+class TestNetworkQualityProvider : public NetworkQualityProvider {
+ public:
+  TestNetworkQualityProvider()
+      : effective_connection_type_(EFFECTIVE_CONNECTION_TYPE_UNKNOWN) {}
+  ~TestNetworkQualityProvider() override = default;
+
+  void set_effective_connection_type(EffectiveConnectionType type) {
+    effective_connection_type_ = type;
+  }
+
+  // NetworkQualityProvider:
+  EffectiveConnectionType GetEffectiveConnectionType() const override {
+    return effective_connection_type_;
+  }
+
+ private:
+  EffectiveConnectionType effective_connection_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestNetworkQualityProvider);
+};
+
 // Check to confirm that all created throttles at priorities other than
 // THROTTLED start unblocked.
 TEST_F(NetworkThrottleManagerTest, AllUnthrottled) {
@@ -559,6 +590,36 @@ TEST_F(NetworkThrottleManagerTest, IgnoreLimits) {
       CreateThrottleIgnoringLimits(THROTTLED));
 }
 
+// Check that more THROTTLED requests run at once on fast connections.
+TEST_F(NetworkThrottleManagerTest, FastConnectionLimit) {
+  TestNetworkQualityProvider network_quality_provider;
+  network_quality_provider.set_effective_connection_type(
+      EFFECTIVE_CONNECTION_TYPE_4G);
+  UseNetworkQualityProvider(&network_quality_provider);
+
+  const size_t kLimit =
+      NetworkThrottleManagerImpl::kFastConnectionActiveRequestThrottlingLimit;
+  std::vector<std::unique_ptr<NetworkThrottleManager::Throttle>> throttles;
+  for (size_t i = 0; i < kLimit; ++i)
+    throttles.push_back(CreateThrottle(THROTTLED, UNBLOCKED));
+  std::unique_ptr<NetworkThrottleManager::Throttle> blocked_throttle(
+      CreateThrottle(THROTTLED, BLOCKED));
+
+  // Once the connection gets slower, the lower limit applies again.
+  network_quality_provider.set_effective_connection_type(
+      EFFECTIVE_CONNECTION_TYPE_3G);
+  throttles.pop_back();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(blocked_throttle->IsBlocked());
+  EXPECT_EQ(0, throttle_state_change_count());
+
+  throttles.resize(NetworkThrottleManagerImpl::kActiveRequestThrottlingLimit -
+                   1);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(blocked_throttle->IsBlocked());
+  EXPECT_EQ(1, throttle_state_change_count());
+}
+
 }  // namespace
 
 }  // namespace net
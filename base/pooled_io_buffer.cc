@@ -0,0 +1,142 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/pooled_io_buffer.h"
+
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/synchronization/lock.h"
+
+namespace net {
+
+namespace {
+
+// The size classes are the powers of two from kMinPooledSize to
+// kMaxPooledSize.
+const size_t kNumSizeClasses = 5;
+static_assert(PooledIOBuffer::kMinPooledSize << (kNumSizeClasses - 1) ==
+                  PooledIOBuffer::kMaxPooledSize,
+              "kNumSizeClasses must match the pooled sizes");
+
+// Returns the size of the memory allocated for a buffer of |size| bytes, or 0
+// if it is too large to be pooled.
+size_t GetAllocatedSize(size_t size) {
+  if (size > PooledIOBuffer::kMaxPooledSize)
+    return 0;
+  size_t allocated_size = PooledIOBuffer::kMinPooledSize;
+  while (allocated_size < size)
+    allocated_size *= 2;
+  return allocated_size;
+}
+
+size_t GetSizeClass(size_t allocated_size) {
+  size_t size_class = 0;
+  while ((PooledIOBuffer::kMinPooledSize << size_class) < allocated_size)
+    ++size_class;
+  DCHECK_LT(size_class, kNumSizeClasses);
+  return size_class;
+}
+
+class BufferPool {
+ public:
+  BufferPool() : num_allocations_(0), num_hits_(0) {}
+
+  char* Allocate(size_t allocated_size) {
+    char* data = nullptr;
+    int hit_rate = -1;
+    {
+      base::AutoLock lock(lock_);
+      std::vector<char*>& free_list =
+          free_lists_[GetSizeClass(allocated_size)];
+      if (!free_list.empty()) {
+        data = free_list.back();
+        free_list.pop_back();
+        ++num_hits_;
+      }
+      if (++num_allocations_ == PooledIOBuffer::kAllocationsPerHitRateSample) {
+        hit_rate = num_hits_ * 100 / num_allocations_;
+        num_allocations_ = 0;
+        num_hits_ = 0;
+      }
+    }
+    // Allocations are too frequent to be recorded one by one.
+    if (hit_rate >= 0)
+      UMA_HISTOGRAM_PERCENTAGE("Net.PooledIOBuffer.PoolHitRate", hit_rate);
+    return data ? data : new char[allocated_size];
+  }
+
+  void Release(char* data, size_t allocated_size) {
+    {
+      base::AutoLock lock(lock_);
+      std::vector<char*>& free_list =
+          free_lists_[GetSizeClass(allocated_size)];
+      if (free_list.size() < PooledIOBuffer::kMaxFreeBuffersPerSizeClass) {
+        free_list.push_back(data);
+        return;
+      }
+    }
+    delete[] data;
+  }
+
+  void Clear() {
+    base::AutoLock lock(lock_);
+    for (std::vector<char*>& free_list : free_lists_) {
+      for (char* data : free_list)
+        delete[] data;
+      free_list.clear();
+    }
+    num_allocations_ = 0;
+    num_hits_ = 0;
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<char*> free_lists_[kNumSizeClasses];
+  // Allocations, and those which reused pooled memory, since the hit rate was
+  // last recorded.
+  int num_allocations_;
+  int num_hits_;
+
+  DISALLOW_COPY_AND_ASSIGN(BufferPool);
+};
+
+base::LazyInstance<BufferPool>::Leaky g_buffer_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+char* AllocateData(size_t size) {
+  size_t allocated_size = GetAllocatedSize(size);
+  if (!allocated_size)
+    return new char[size];
+  return g_buffer_pool.Get().Allocate(allocated_size);
+}
+
+}  // namespace
+
+const size_t PooledIOBuffer::kMinPooledSize;
+const size_t PooledIOBuffer::kMaxPooledSize;
+const size_t PooledIOBuffer::kMaxFreeBuffersPerSizeClass;
+const int PooledIOBuffer::kAllocationsPerHitRateSample;
+
+PooledIOBuffer::PooledIOBuffer(size_t size)
+    : IOBufferWithSize(AllocateData(size), size),
+      allocated_size_(GetAllocatedSize(size)) {}
+
+// static
+void PooledIOBuffer::ClearPoolForTesting() {
+  g_buffer_pool.Get().Clear();
+}
+
+PooledIOBuffer::~PooledIOBuffer() {
+  if (allocated_size_)
+    g_buffer_pool.Get().Release(data_, allocated_size_);
+  else
+    delete[] data_;
+  // Keeps ~IOBuffer() from freeing the memory again.
+  data_ = nullptr;
+}
+
+}  // namespace net
@@ -0,0 +1,54 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_POOLED_IO_BUFFER_H_
+#define NET_BASE_POOLED_IO_BUFFER_H_
+
+#include <stddef.h>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// An IOBufferWithSize whose memory comes from a process-wide pool, and goes
+// back to it when the buffer is destroyed. Meant for the buffers of socket
+// reads, which are allocated and freed at a high rate with a few sizes.
+//
+// Sizes are rounded up to a power of two between kMinPooledSize and
+// kMaxPooledSize, and each of these size classes keeps a bounded free list.
+// Larger buffers are not pooled. The percentage of allocations which reused
+// pooled memory is recorded in the Net.PooledIOBuffer.PoolHitRate histogram,
+// once every kAllocationsPerHitRateSample pooled allocations.
+class NET_EXPORT PooledIOBuffer : public IOBufferWithSize {
+ public:
+  static const size_t kMinPooledSize = 4 * 1024;
+  static const size_t kMaxPooledSize = 64 * 1024;
+
+  // The largest number of free buffers kept per size class.
+  static const size_t kMaxFreeBuffersPerSizeClass = 32;
+
+  // The number of pooled allocations each hit rate sample covers.
+  static const int kAllocationsPerHitRateSample = 100;
+
+  explicit PooledIOBuffer(size_t size);
+
+  // Frees the memory of all the pooled buffers not in use, and restarts the
+  // current hit rate sample.
+  static void ClearPoolForTesting();
+
+ private:
+  ~PooledIOBuffer() override;
+
+  // The size of the memory of the buffer, or 0 if it is not pooled.
+  const size_t allocated_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledIOBuffer);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_POOLED_IO_BUFFER_H_
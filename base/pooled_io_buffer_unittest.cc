@@ -0,0 +1,106 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/pooled_io_buffer.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "base/test/histogram_tester.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const char kPoolHitRateHistogram[] = "Net.PooledIOBuffer.PoolHitRate";
+
+class PooledIOBufferTest : public testing::Test {
+ protected:
+  PooledIOBufferTest() { PooledIOBuffer::ClearPoolForTesting(); }
+  ~PooledIOBufferTest() override { PooledIOBuffer::ClearPoolForTesting(); }
+};
+
+TEST_F(PooledIOBufferTest, ReusesMemoryOfSameSizeClass) {
+  scoped_refptr<PooledIOBuffer> buffer =
+      base::MakeRefCounted<PooledIOBuffer>(8 * 1024);
+  EXPECT_EQ(8 * 1024, buffer->size());
+  memset(buffer->data(), 'a', buffer->size());
+  char* data = buffer->data();
+  buffer = nullptr;
+
+  // A buffer of a size which rounds up to the same size class gets the same
+  // memory back.
+  buffer = base::MakeRefCounted<PooledIOBuffer>(6 * 1024);
+  EXPECT_EQ(6 * 1024, buffer->size());
+  EXPECT_EQ(data, buffer->data());
+
+  // Another size class does not.
+  scoped_refptr<PooledIOBuffer> other_buffer =
+      base::MakeRefCounted<PooledIOBuffer>(16 * 1024);
+  EXPECT_NE(data, other_buffer->data());
+}
+
+TEST_F(PooledIOBufferTest, SmallAndLargeBuffers) {
+  // Small buffers use the smallest size class.
+  scoped_refptr<PooledIOBuffer> buffer =
+      base::MakeRefCounted<PooledIOBuffer>(1);
+  EXPECT_EQ(1, buffer->size());
+  char* data = buffer->data();
+  buffer = nullptr;
+  buffer = base::MakeRefCounted<PooledIOBuffer>(PooledIOBuffer::kMinPooledSize);
+  EXPECT_EQ(data, buffer->data());
+
+  // Buffers larger than the largest size class are not pooled.
+  buffer = base::MakeRefCounted<PooledIOBuffer>(PooledIOBuffer::kMaxPooledSize +
+                                                1);
+  memset(buffer->data(), 'a', buffer->size());
+  buffer = nullptr;
+}
+
+TEST_F(PooledIOBufferTest, HitRateIsSampled) {
+  base::HistogramTester histograms;
+
+  // Only the first allocation misses the pool.
+  for (int i = 0; i < PooledIOBuffer::kAllocationsPerHitRateSample - 1; ++i)
+    base::MakeRefCounted<PooledIOBuffer>(4 * 1024);
+  histograms.ExpectTotalCount(kPoolHitRateHistogram, 0);
+
+  base::MakeRefCounted<PooledIOBuffer>(4 * 1024);
+  histograms.ExpectUniqueSample(
+      kPoolHitRateHistogram,
+      100 - 100 / PooledIOBuffer::kAllocationsPerHitRateSample, 1);
+
+  // Buffers larger than the largest size class are not counted.
+  base::MakeRefCounted<PooledIOBuffer>(PooledIOBuffer::kMaxPooledSize + 1);
+  for (int i = 0; i < PooledIOBuffer::kAllocationsPerHitRateSample - 1; ++i)
+    base::MakeRefCounted<PooledIOBuffer>(4 * 1024);
+  histograms.ExpectTotalCount(kPoolHitRateHistogram, 1);
+}
+
+TEST_F(PooledIOBufferTest, FreeListIsBounded) {
+  base::HistogramTester histograms;
+
+  std::vector<scoped_refptr<PooledIOBuffer>> buffers;
+  for (size_t i = 0; i < PooledIOBuffer::kMaxFreeBuffersPerSizeClass + 1; ++i)
+    buffers.push_back(base::MakeRefCounted<PooledIOBuffer>(4 * 1024));
+  buffers.clear();
+
+  // Only kMaxFreeBuffersPerSizeClass of the released buffers were kept, and
+  // the allocations filling up the rest of the sample all miss the pool.
+  while (buffers.size() < PooledIOBuffer::kAllocationsPerHitRateSample -
+                              PooledIOBuffer::kMaxFreeBuffersPerSizeClass - 1) {
+    buffers.push_back(base::MakeRefCounted<PooledIOBuffer>(4 * 1024));
+  }
+  histograms.ExpectUniqueSample(
+      kPoolHitRateHistogram,
+      PooledIOBuffer::kMaxFreeBuffersPerSizeClass * 100 /
+          PooledIOBuffer::kAllocationsPerHitRateSample,
+      1);
+}
+
+}  // namespace
+
+}  // namespace net
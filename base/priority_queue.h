@@ -24,6 +24,8 @@ namespace net {
 // A simple priority queue. The order of values is by priority and then FIFO.
 // Unlike the std::priority_queue, this implementation allows erasing elements
 // from the queue, and all operations are O(p) time for p priority levels.
+// The list nodes of erased values are kept for reuse, up to a limit, so that
+// a queue whose size stays bounded stops allocating.
 // The queue is agnostic to priority ordering (whether 0 precedes 1).
 // If the highest priority is 0, FirstMin() returns the first in order.
 //
@@ -150,10 +152,10 @@ class PriorityQueue {
     unsigned id = next_id_;
     valid_ids_.insert(id);
     ++next_id_;
-    return Pointer(priority, list.insert(list.end(),
-                                         std::make_pair(id, value)));
+    return Pointer(priority,
+                   InsertNode(&list, list.end(), std::make_pair(id, value)));
 #else
-    return Pointer(priority, list.insert(list.end(), value));
+    return Pointer(priority, InsertNode(&list, list.end(), value));
 #endif
   }
 
@@ -168,10 +170,10 @@ class PriorityQueue {
     unsigned id = next_id_;
     valid_ids_.insert(id);
     ++next_id_;
-    return Pointer(priority, list.insert(list.begin(),
-                                         std::make_pair(id, value)));
+    return Pointer(priority,
+                   InsertNode(&list, list.begin(), std::make_pair(id, value)));
 #else
-    return Pointer(priority, list.insert(list.begin(), value));
+    return Pointer(priority, InsertNode(&list, list.begin(), value));
 #endif
   }
 
@@ -188,7 +190,14 @@ class PriorityQueue {
 #endif
 
     --size_;
-    lists_[pointer.priority_].erase(pointer.iterator_);
+    List& list = lists_[pointer.priority_];
+    if (free_nodes_.size() < kMaxFreeNodes) {
+      // Keep the node for a later insertion, without the value.
+      *pointer.iterator_ = typename List::value_type();
+      free_nodes_.splice(free_nodes_.end(), list, pointer.iterator_);
+    } else {
+      list.erase(pointer.iterator_);
+    }
   }
 
   // Returns a pointer to the first value of minimum priority or a null-pointer
@@ -273,6 +282,7 @@ class PriorityQueue {
     for (size_t i = 0; i < lists_.size(); ++i) {
       lists_[i].clear();
     }
+    free_nodes_.clear();
 #if !defined(NDEBUG)
     valid_ids_.clear();
 #endif
@@ -299,6 +309,22 @@ class PriorityQueue {
  private:
   typedef std::vector<List> ListVector;
 
+  // Maximum number of nodes kept in |free_nodes_|.
+  static const size_t kMaxFreeNodes = 256;
+
+  // Inserts |value| in |list| before |position|, reusing a node from
+  // |free_nodes_| if there is one, and returns an iterator to it.
+  typename List::iterator InsertNode(List* list,
+                                     typename List::iterator position,
+                                     const typename List::value_type& value) {
+    if (free_nodes_.empty())
+      return list->insert(position, value);
+    typename List::iterator node = free_nodes_.begin();
+    *node = value;
+    list->splice(position, free_nodes_, node);
+    return node;
+  }
+
 #if !defined(NDEBUG)
   unsigned next_id_;
   std::unordered_set<unsigned> valid_ids_;
@@ -307,6 +333,9 @@ class PriorityQueue {
   ListVector lists_;
   size_t size_;
 
+  // Nodes of erased values, which hold default-constructed values.
+  List free_nodes_;
+
   THREAD_CHECKER(thread_checker_);
 
   DISALLOW_COPY_AND_ASSIGN(PriorityQueue);
@@ -68,6 +68,26 @@ TEST_F(PriorityQueueTest, FirstMinOrder) {
   CheckEmpty();
 }
 
+// Values inserted after others were erased, which reuses their nodes, keep the
+// queue's order.
+TEST_F(PriorityQueueTest, InsertAfterErase) {
+  for (size_t i = 0; i < kNumElements; ++i)
+    queue_.Erase(pointers_[i]);
+  CheckEmpty();
+
+  for (size_t i = 0; i < kNumElements; ++i)
+    pointers_[i] = queue_.Insert(static_cast<int>(i), kPriorities[i]);
+  for (size_t i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(kPriorities[i], pointers_[i].priority());
+    EXPECT_EQ(static_cast<int>(i), pointers_[i].value());
+  }
+  for (size_t i = 0; i < kNumElements; ++i) {
+    EXPECT_EQ(kFirstMinOrder[i], queue_.FirstMin().value());
+    queue_.Erase(queue_.FirstMin());
+  }
+  CheckEmpty();
+}
+
 TEST_F(PriorityQueueTest, LastMinOrder) {
   for (size_t i = 0; i < kNumElements; ++i) {
     EXPECT_EQ(kLastMinOrder[i], queue_.LastMin().value());
@@ -60,7 +60,7 @@ namespace net {
 namespace registry_controlled_domains {
 
 namespace {
-#include "net/base/registry_controlled_domains/effective_tld_names-inc.cc"
+#include "net/base/registry_controlled_domains/effective_tld_names-reversed-inc.cc"
 
 // See make_dafsa.py for documentation of the generated dafsa byte array.
 
@@ -97,65 +97,58 @@ size_t GetRegistryLengthImpl(base::StringPiece host,
       return 0;  // Multiple trailing dots.
   }
 
-  // Walk up the domain tree, most specific to least specific,
-  // looking for matches at each level.
-  size_t prev_start = std::string::npos;
-  size_t curr_start = host_check_begin;
-  size_t next_dot = host.find('.', curr_start);
-  if (next_dot >= host_check_len)  // Catches std::string::npos as well.
+  if (host.find('.', host_check_begin) >= host_check_len)
     return 0;  // This can't have a registry + domain.
-  while (1) {
-    const char* domain_str = host.data() + curr_start;
-    size_t domain_length = host_check_len - curr_start;
-    int type = LookupStringInFixedSet(g_graph, g_graph_length, domain_str,
-                                      domain_length);
-    bool do_check = type != kDafsaNotFound &&
-                    (!(type & kDafsaPrivateRule) ||
-                     private_filter == INCLUDE_PRIVATE_REGISTRIES);
-
-    // If the apparent match is a private registry and we're not including
-    // those, it can't be an actual match.
-    if (do_check) {
-      // Exception rules override wildcard rules when the domain is an exact
-      // match, but wildcards take precedence when there's a subdomain.
-      if (type & kDafsaWildcardRule && (prev_start != std::string::npos)) {
-        // If prev_start == host_check_begin, then the host is the registry
-        // itself, so return 0.
-        return (prev_start == host_check_begin) ? 0
-                                                : (host.length() - prev_start);
-      }
-
-      if (type & kDafsaExceptionRule) {
-        if (next_dot == std::string::npos) {
-          // If we get here, we had an exception rule with no dots (e.g.
-          // "!foo").  This would only be valid if we had a corresponding
-          // wildcard rule, which would have to be "*".  But we explicitly
-          // disallow that case, so this kind of rule is invalid.
-          NOTREACHED() << "Invalid exception rule";
-          return 0;
-        }
-        return host.length() - next_dot - 1;
-      }
-
-      // If curr_start == host_check_begin, then the host is the registry
-      // itself, so return 0.
-      return (curr_start == host_check_begin) ? 0
-                                              : (host.length() - curr_start);
-    }
 
-    if (next_dot >= host_check_len)  // Catches std::string::npos as well.
-      break;
+  // Look up the longest suffix of the host which matches a rule, i.e. the
+  // most specific rule. Private rules can't be actual matches if we're not
+  // including those.
+  size_t match_length;
+  int type = LookupSuffixInReversedSet(
+      g_graph, g_graph_length, private_filter == INCLUDE_PRIVATE_REGISTRIES,
+      host.data() + host_check_begin, host_check_len - host_check_begin,
+      &match_length);
+
+  if (type == kDafsaNotFound) {
+    // No rule found in the registry. If we allow unknown registries, return
+    // the length of the last subcomponent of the host.
+    if (unknown_filter != INCLUDE_UNKNOWN_REGISTRIES)
+      return 0;
+    return host.length() - host.rfind('.', host_check_len - 1) - 1;
+  }
 
-    prev_start = curr_start;
-    curr_start = next_dot + 1;
-    next_dot = host.find('.', curr_start);
+  const size_t curr_start = host_check_len - match_length;
+
+  // Exception rules override wildcard rules when the domain is an exact
+  // match, but wildcards take precedence when there's a subdomain.
+  if (type & kDafsaWildcardRule && curr_start != host_check_begin) {
+    // The registry also includes the subcomponent before the match, which
+    // starts after the previous dot. The leading dots are all before
+    // |host_check_begin|.
+    const size_t prev_dot = host.rfind('.', curr_start - 2);
+    const size_t prev_start =
+        prev_dot == std::string::npos ? host_check_begin : prev_dot + 1;
+    // If prev_start == host_check_begin, then the host is the registry
+    // itself, so return 0.
+    return (prev_start == host_check_begin) ? 0 : (host.length() - prev_start);
+  }
+
+  if (type & kDafsaExceptionRule) {
+    const size_t next_dot = host.find('.', curr_start);
+    if (next_dot == std::string::npos) {
+      // If we get here, we had an exception rule with no dots (e.g.
+      // "!foo").  This would only be valid if we had a corresponding
+      // wildcard rule, which would have to be "*".  But we explicitly
+      // disallow that case, so this kind of rule is invalid.
+      NOTREACHED() << "Invalid exception rule";
+      return 0;
+    }
+    return host.length() - next_dot - 1;
   }
 
-  // No rule found in the registry.  curr_start now points to the first
-  // character of the last subcomponent of the host, so if we allow unknown
-  // registries, return the length of this subcomponent.
-  return unknown_filter == INCLUDE_UNKNOWN_REGISTRIES ?
-      (host.length() - curr_start) : 0;
+  // If curr_start == host_check_begin, then the host is the registry
+  // itself, so return 0.
+  return (curr_start == host_check_begin) ? 0 : (host.length() - curr_start);
 }
 
 base::StringPiece GetDomainAndRegistryImpl(
@@ -293,7 +293,8 @@ typedef const struct DomainRule* (*FindDomainPtr)(const char *, unsigned int);
 // Used for unit tests. Use default domains.
 NET_EXPORT_PRIVATE void SetFindDomainGraph();
 
-// Used for unit tests, so that a frozen list of domains is used.
+// Used for unit tests, so that a frozen list of domains is used. |domains|
+// must be generated by make_dafsa.py with --reverse.
 NET_EXPORT_PRIVATE void SetFindDomainGraph(const unsigned char* domains,
                                            size_t length);
 
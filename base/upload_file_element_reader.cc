@@ -4,6 +4,10 @@
 
 #include "net/base/upload_file_element_reader.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/files/file_util.h"
 #include "base/location.h"
@@ -39,6 +43,11 @@ UploadFileElementReader::UploadFileElementReader(
       bytes_remaining_(0),
       next_state_(State::IDLE),
       init_called_while_operation_pending_(false),
+      read_ahead_offset_(0),
+      read_ahead_size_(0),
+      read_ahead_error_(OK),
+      read_ahead_length_(0),
+      pending_read_buf_length_(0),
       weak_ptr_factory_(this) {
   DCHECK(file.IsValid());
   DCHECK(task_runner_.get());
@@ -60,6 +69,11 @@ UploadFileElementReader::UploadFileElementReader(
       bytes_remaining_(0),
       next_state_(State::IDLE),
       init_called_while_operation_pending_(false),
+      read_ahead_offset_(0),
+      read_ahead_size_(0),
+      read_ahead_error_(OK),
+      read_ahead_length_(0),
+      pending_read_buf_length_(0),
       weak_ptr_factory_(this) {
   DCHECK(task_runner_.get());
 }
@@ -76,6 +90,8 @@ int UploadFileElementReader::Init(const CompletionCallback& callback) {
   bytes_remaining_ = 0;
   content_length_ = 0;
   pending_callback_.Reset();
+  // A pending read-ahead is treated like any other pending operation below.
+  ResetReadAhead();
 
   // If the file is being opened, just update the callback, and continue
   // waiting.
@@ -122,13 +138,30 @@ int UploadFileElementReader::Read(IOBuffer* buf,
                                   int buf_length,
                                   const CompletionCallback& callback) {
   DCHECK(!callback.is_null());
-  DCHECK_EQ(next_state_, State::IDLE);
+  DCHECK(next_state_ == State::IDLE ||
+         next_state_ == State::READ_AHEAD_COMPLETE);
+  DCHECK(!pending_read_buf_);
   DCHECK(file_stream_);
 
   int num_bytes_to_read = static_cast<int>(
       std::min(BytesRemaining(), static_cast<uint64_t>(buf_length)));
   if (num_bytes_to_read == 0)
     return 0;
+  read_ahead_length_ = buf_length;
+
+  if (next_state_ == State::READ_AHEAD_COMPLETE) {
+    pending_read_buf_ = buf;
+    pending_read_buf_length_ = num_bytes_to_read;
+    pending_callback_ = callback;
+    return ERR_IO_PENDING;
+  }
+
+  if (HasReadAheadResult()) {
+    int result = ConsumeReadAhead(buf, num_bytes_to_read);
+    if (result > 0)
+      MaybeStartReadAhead();
+    return result;
+  }
 
   next_state_ = State::READ_COMPLETE;
   int result = file_stream_->Read(
@@ -141,6 +174,8 @@ int UploadFileElementReader::Read(IOBuffer* buf,
 
   if (result == ERR_IO_PENDING)
     pending_callback_ = callback;
+  else if (result > 0)
+    MaybeStartReadAhead();
 
   return result;
 }
@@ -186,6 +221,9 @@ int UploadFileElementReader::DoLoop(int result) {
       case State::READ_COMPLETE:
         result = DoReadComplete(result);
         break;
+      case State::READ_AHEAD_COMPLETE:
+        result = DoReadAheadComplete(result);
+        break;
     }
   }
 
@@ -305,15 +343,103 @@ int UploadFileElementReader::DoReadComplete(int result) {
   return result;
 }
 
+int UploadFileElementReader::DoReadAheadComplete(int result) {
+  DCHECK(pending_read_buf_);
+  SetReadAheadResult(result);
+  result = ConsumeReadAhead(pending_read_buf_.get(), pending_read_buf_length_);
+  pending_read_buf_ = nullptr;
+  return result;
+}
+
 void UploadFileElementReader::OnIOComplete(int result) {
   DCHECK(pending_callback_);
 
   result = DoLoop(result);
 
+  // Reads are completed with the number of bytes read, while Init() is
+  // completed with OK.
+  if (result > 0)
+    MaybeStartReadAhead();
+
   if (result != ERR_IO_PENDING)
     std::move(pending_callback_).Run(result);
 }
 
+void UploadFileElementReader::MaybeStartReadAhead() {
+  if (next_state_ != State::IDLE || HasReadAheadResult() ||
+      bytes_remaining_ == 0) {
+    return;
+  }
+
+  int length = static_cast<int>(
+      std::min(bytes_remaining_, static_cast<uint64_t>(read_ahead_length_)));
+  if (!read_ahead_buffer_ || read_ahead_buffer_->size() < length)
+    read_ahead_buffer_ = base::MakeRefCounted<IOBufferWithSize>(length);
+
+  next_state_ = State::READ_AHEAD_COMPLETE;
+  int result = file_stream_->Read(
+      read_ahead_buffer_.get(), length,
+      base::Bind(&UploadFileElementReader::OnReadAheadComplete,
+                 weak_ptr_factory_.GetWeakPtr()));
+  if (result != ERR_IO_PENDING) {
+    next_state_ = State::IDLE;
+    SetReadAheadResult(result);
+  }
+}
+
+void UploadFileElementReader::OnReadAheadComplete(int result) {
+  DCHECK_EQ(State::READ_AHEAD_COMPLETE, next_state_);
+
+  // Unless Read() or Init() was called meanwhile, keep the result for the
+  // next Read().
+  if (!pending_callback_) {
+    next_state_ = State::IDLE;
+    SetReadAheadResult(result);
+    return;
+  }
+
+  OnIOComplete(result);
+}
+
+void UploadFileElementReader::SetReadAheadResult(int result) {
+  DCHECK(!HasReadAheadResult());
+  if (result == 0)  // Reached end-of-file earlier than expected.
+    result = ERR_UPLOAD_FILE_CHANGED;
+
+  if (result < 0) {
+    read_ahead_error_ = result;
+    return;
+  }
+  read_ahead_offset_ = 0;
+  read_ahead_size_ = result;
+}
+
+bool UploadFileElementReader::HasReadAheadResult() const {
+  return read_ahead_error_ != OK || read_ahead_offset_ < read_ahead_size_;
+}
+
+int UploadFileElementReader::ConsumeReadAhead(IOBuffer* buf, int buf_length) {
+  if (read_ahead_error_ != OK) {
+    int result = read_ahead_error_;
+    read_ahead_error_ = OK;
+    return result;
+  }
+
+  int result = std::min(buf_length, read_ahead_size_ - read_ahead_offset_);
+  memcpy(buf->data(), read_ahead_buffer_->data() + read_ahead_offset_, result);
+  read_ahead_offset_ += result;
+  DCHECK_GE(bytes_remaining_, static_cast<uint64_t>(result));
+  bytes_remaining_ -= result;
+  return result;
+}
+
+void UploadFileElementReader::ResetReadAhead() {
+  read_ahead_offset_ = 0;
+  read_ahead_size_ = 0;
+  read_ahead_error_ = OK;
+  pending_read_buf_ = nullptr;
+}
+
 UploadFileElementReader::ScopedOverridingContentLengthForTests::
     ScopedOverridingContentLengthForTests(uint64_t value) {
   overriding_content_length = value;
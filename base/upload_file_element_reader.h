@@ -27,6 +27,7 @@ class TaskRunner;
 namespace net {
 
 class FileStream;
+class IOBufferWithSize;
 
 // An UploadElementReader implementation for file.
 class NET_EXPORT UploadFileElementReader : public UploadElementReader {
@@ -89,6 +90,9 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
 
     // There is no READ state as reads are always started immediately on Read().
     READ_COMPLETE,
+
+    // A read-ahead is in progress. A Read() called meanwhile waits for it.
+    READ_AHEAD_COMPLETE,
   };
   FRIEND_TEST_ALL_PREFIXES(ElementsUploadDataStreamTest, FileSmallerThanLength);
   FRIEND_TEST_ALL_PREFIXES(HttpNetworkTransactionTest,
@@ -102,9 +106,23 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   int DoGetFileInfo(int result);
   int DoGetFileInfoComplete(int result);
   int DoReadComplete(int result);
+  int DoReadAheadComplete(int result);
 
   void OnIOComplete(int result);
 
+  // Once a read has completed, the file is read ahead into
+  // |read_ahead_buffer_| while the caller writes the data out, so that reading
+  // the file and sending it overlap. The next Read() then copies the data
+  // which was read ahead, without waiting on the file.
+  void MaybeStartReadAhead();
+  void OnReadAheadComplete(int result);
+  void SetReadAheadResult(int result);
+  bool HasReadAheadResult() const;
+  // Returns the result of the read-ahead, copying up to |buf_length| of the
+  // bytes which were read ahead to |buf|.
+  int ConsumeReadAhead(IOBuffer* buf, int buf_length);
+  void ResetReadAhead();
+
   // Sets an value to override the result for GetContentLength().
   // Used for tests.
   struct NET_EXPORT_PRIVATE ScopedOverridingContentLengthForTests {
@@ -129,6 +147,19 @@ class NET_EXPORT UploadFileElementReader : public UploadElementReader {
   // True if Init() was called while an async operation was in progress.
   bool init_called_while_operation_pending_;
 
+  scoped_refptr<IOBufferWithSize> read_ahead_buffer_;
+  // The bytes of |read_ahead_buffer_| from |read_ahead_offset_| up to
+  // |read_ahead_size_| were read ahead and not returned by Read() yet.
+  int read_ahead_offset_;
+  int read_ahead_size_;
+  // The error of the last read-ahead, returned by the next Read(), or OK.
+  int read_ahead_error_;
+  // The size of reads ahead, which is that of the last Read().
+  int read_ahead_length_;
+  // The buffer of a Read() which waits for a read-ahead to complete.
+  scoped_refptr<IOBuffer> pending_read_buf_;
+  int pending_read_buf_length_;
+
   base::WeakPtrFactory<UploadFileElementReader> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(UploadFileElementReader);
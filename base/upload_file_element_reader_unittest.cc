@@ -125,6 +125,40 @@ TEST_P(UploadFileElementReaderTest, ReadPartially) {
   EXPECT_EQ(std::vector<char>(bytes_.begin() + kHalfSize, bytes_.end()), buf);
 }
 
+TEST_P(UploadFileElementReaderTest, ReadAhead) {
+  const size_t kQuarterSize = bytes_.size() / 4;
+  std::vector<char> buf(kQuarterSize);
+  scoped_refptr<IOBuffer> wrapped_buffer = new WrappedIOBuffer(&buf[0]);
+  TestCompletionCallback read_callback1;
+  ASSERT_EQ(ERR_IO_PENDING,
+            reader_->Read(
+                wrapped_buffer.get(), buf.size(), read_callback1.callback()));
+  EXPECT_EQ(static_cast<int>(buf.size()), read_callback1.WaitForResult());
+
+  // Once the next quarter has been read ahead, it's returned synchronously.
+  base::RunLoop().RunUntilIdle();
+  TestCompletionCallback read_callback2;
+  EXPECT_EQ(static_cast<int>(buf.size()),
+            reader_->Read(
+                wrapped_buffer.get(), buf.size(), read_callback2.callback()));
+  EXPECT_EQ(bytes_.size() - 2 * kQuarterSize, reader_->BytesRemaining());
+  EXPECT_EQ(std::vector<char>(bytes_.begin() + kQuarterSize,
+                              bytes_.begin() + 2 * kQuarterSize),
+            buf);
+
+  // Init() drops the data read ahead.
+  TestCompletionCallback init_callback;
+  ASSERT_THAT(reader_->Init(init_callback.callback()), IsError(ERR_IO_PENDING));
+  EXPECT_THAT(init_callback.WaitForResult(), IsOk());
+  EXPECT_EQ(bytes_.size(), reader_->BytesRemaining());
+  TestCompletionCallback read_callback3;
+  int result = reader_->Read(wrapped_buffer.get(), buf.size(),
+                             read_callback3.callback());
+  EXPECT_EQ(static_cast<int>(buf.size()), read_callback3.GetResult(result));
+  EXPECT_EQ(std::vector<char>(bytes_.begin(), bytes_.begin() + kQuarterSize),
+            buf);
+}
+
 TEST_P(UploadFileElementReaderTest, ReadAll) {
   std::vector<char> buf(bytes_.size());
   scoped_refptr<IOBuffer> wrapped_buffer = new WrappedIOBuffer(&buf[0]);
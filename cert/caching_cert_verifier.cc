@@ -41,6 +41,8 @@ int CachingCertVerifier::Verify(const CertVerifier::RequestParams& params,
 
   requests_++;
 
+  UpdateCRLSet(crl_set);
+
   const CertVerificationCache::value_type* cached_entry =
       cache_.Get(params, CacheValidityPeriod(base::Time::Now()));
   if (cached_entry) {
@@ -52,7 +54,7 @@ int CachingCertVerifier::Verify(const CertVerifier::RequestParams& params,
   base::Time start_time = base::Time::Now();
   CompletionCallback caching_callback = base::Bind(
       &CachingCertVerifier::OnRequestFinished, base::Unretained(this), params,
-      start_time, callback, verify_result);
+      start_time, base::WrapRefCounted(crl_set), callback, verify_result);
   int result = verifier_->Verify(params, crl_set, verify_result,
                                  caching_callback, out_req, net_log);
   if (result != ERR_IO_PENDING) {
@@ -133,12 +135,15 @@ bool CachingCertVerifier::CacheExpirationFunctor::operator()(
          now.verification_time < expiration.expiration_time;
 };
 
-void CachingCertVerifier::OnRequestFinished(const RequestParams& params,
-                                            base::Time start_time,
-                                            const CompletionCallback& callback,
-                                            CertVerifyResult* verify_result,
-                                            int error) {
-  AddResultToCache(params, start_time, *verify_result, error);
+void CachingCertVerifier::OnRequestFinished(
+    const RequestParams& params,
+    base::Time start_time,
+    const scoped_refptr<CRLSet>& crl_set,
+    const CompletionCallback& callback,
+    CertVerifyResult* verify_result,
+    int error) {
+  if (crl_set == crl_set_)
+    AddResultToCache(params, start_time, *verify_result, error);
 
   // Now chain to the user's callback, which may delete |this|.
   callback.Run(error);
@@ -198,6 +203,13 @@ void CachingCertVerifier::VisitEntries(CacheVisitor* visitor) const {
   }
 }
 
+void CachingCertVerifier::UpdateCRLSet(CRLSet* crl_set) {
+  if (crl_set == crl_set_.get())
+    return;
+  ClearCache();
+  crl_set_ = crl_set;
+}
+
 void CachingCertVerifier::OnCertDBChanged() {
   ClearCache();
 }
@@ -7,11 +7,13 @@
 
 #include <memory>
 
+#include "base/memory/ref_counted.h"
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 #include "net/cert/cert_database.h"
 #include "net/cert/cert_verifier.h"
 #include "net/cert/cert_verify_result.h"
+#include "net/cert/crl_set.h"
 
 namespace net {
 
@@ -31,6 +33,11 @@ namespace net {
 // tries to balance the implementation complexity of needing to monitor the
 // above for meaningful changes and the practical utility of being able to
 // cache results when they're not expected to change.
+//
+// Results are also dropped whenever the trust settings change, through
+// CertDatabase::Observer, and whenever Verify is called with a different
+// CRLSet than the cached results were verified with, so that a newly revoked
+// certificate is not served from the cache.
 class NET_EXPORT CachingCertVerifier : public CertVerifier,
                                        public CertDatabase::Observer {
  public:
@@ -89,6 +96,7 @@ class NET_EXPORT CachingCertVerifier : public CertVerifier,
   FRIEND_TEST_ALL_PREFIXES(CachingCertVerifierTest, Visitor);
   FRIEND_TEST_ALL_PREFIXES(CachingCertVerifierTest, AddsEntries);
   FRIEND_TEST_ALL_PREFIXES(CachingCertVerifierTest, DifferentCACerts);
+  FRIEND_TEST_ALL_PREFIXES(CachingCertVerifierTest, CRLSetChangeClearsCache);
 
   // CachedResult contains the result of a certificate verification.
   struct NET_EXPORT_PRIVATE CachedResult {
@@ -127,10 +135,12 @@ class NET_EXPORT CachingCertVerifier : public CertVerifier,
                                               CacheExpirationFunctor>;
 
   // Handles completion of the request matching |params|, which started at
-  // |start_time|, completing. |verify_result| and |result| are added to the
-  // cache, and then |callback| (the original caller's callback) is invoked.
+  // |start_time| with |crl_set|, completing. |verify_result| and |result| are
+  // added to the cache unless the CRLSet changed in the meantime, and then
+  // |callback| (the original caller's callback) is invoked.
   void OnRequestFinished(const RequestParams& params,
                          base::Time start_time,
+                         const scoped_refptr<CRLSet>& crl_set,
                          const CompletionCallback& callback,
                          CertVerifyResult* verify_result,
                          int error);
@@ -143,6 +153,10 @@ class NET_EXPORT CachingCertVerifier : public CertVerifier,
                         const CertVerifyResult& verify_result,
                         int error);
 
+  // Clears the cache if |crl_set| is not the CRLSet the cached results were
+  // verified with.
+  void UpdateCRLSet(CRLSet* crl_set);
+
   // CertDatabase::Observer methods:
   void OnCertDBChanged() override;
 
@@ -156,6 +170,10 @@ class NET_EXPORT CachingCertVerifier : public CertVerifier,
 
   CertVerificationCache cache_;
 
+  // The CRLSet the results in |cache_| were verified with. A reference is kept
+  // so that a new CRLSet cannot be mistaken for it by address.
+  scoped_refptr<CRLSet> crl_set_;
+
   uint64_t requests_;
   uint64_t cache_hits_;
 
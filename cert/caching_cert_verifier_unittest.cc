@@ -10,6 +10,7 @@
 #include "net/base/test_completion_callback.h"
 #include "net/cert/cert_verifier.h"
 #include "net/cert/cert_verify_result.h"
+#include "net/cert/crl_set.h"
 #include "net/cert/mock_cert_verifier.h"
 #include "net/cert/x509_certificate.h"
 #include "net/cert/x509_util.h"
@@ -217,6 +218,44 @@ TEST_F(CachingCertVerifierTest, AddsEntries) {
   ASSERT_EQ(1u, verifier_.GetCacheSize());
 }
 
+// Tests that results verified with one CRLSet are not served once Verify is
+// called with another.
+TEST_F(CachingCertVerifierTest, CRLSetChangeClearsCache) {
+  base::FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_TRUE(test_cert.get());
+
+  scoped_refptr<CRLSet> crl_set1(CRLSet::EmptyCRLSetForTesting());
+  scoped_refptr<CRLSet> crl_set2(CRLSet::EmptyCRLSetForTesting());
+  CertVerifier::RequestParams params(test_cert, "www.example.com", 0,
+                                     std::string(), CertificateList());
+
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  std::unique_ptr<CertVerifier::Request> request;
+
+  int error = callback.GetResult(verifier_.Verify(
+      params, crl_set1.get(), &verify_result, callback.callback(), &request,
+      NetLogWithSource()));
+  ASSERT_TRUE(IsCertificateError(error));
+  error = callback.GetResult(verifier_.Verify(
+      params, crl_set1.get(), &verify_result, callback.callback(), &request,
+      NetLogWithSource()));
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(2u, verifier_.requests());
+  ASSERT_EQ(1u, verifier_.cache_hits());
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+
+  error = callback.GetResult(verifier_.Verify(
+      params, crl_set2.get(), &verify_result, callback.callback(), &request,
+      NetLogWithSource()));
+  ASSERT_TRUE(IsCertificateError(error));
+  ASSERT_EQ(3u, verifier_.requests());
+  ASSERT_EQ(1u, verifier_.cache_hits());
+  ASSERT_EQ(1u, verifier_.GetCacheSize());
+}
+
 // Tests the same server certificate with different intermediate CA
 // certificates.  These should be treated as different certificate chains even
 // though the two X509Certificate objects contain the same server certificate.
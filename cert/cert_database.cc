@@ -26,7 +26,12 @@ void CertDatabase::RemoveObserver(Observer* observer) {
 }
 
 void CertDatabase::NotifyObserversCertDBChanged() {
+  base::subtle::Barrier_AtomicIncrement(&change_count_, 1);
   observer_list_->Notify(FROM_HERE, &Observer::OnCertDBChanged);
 }
 
+uint32_t CertDatabase::change_count() const {
+  return static_cast<uint32_t>(base::subtle::Acquire_Load(&change_count_));
+}
+
 }  // namespace net
@@ -5,8 +5,11 @@
 #ifndef NET_CERT_CERT_DATABASE_H_
 #define NET_CERT_CERT_DATABASE_H_
 
+#include <stdint.h>
+
 #include <memory>
 
+#include "base/atomicops.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/net_export.h"
@@ -88,6 +91,11 @@ class NET_EXPORT CertDatabase {
   // notifcations from other DB interfaces.
   void NotifyObserversCertDBChanged();
 
+  // Returns the number of times observers were notified of a change. It may be
+  // called on any thread, so that caches of the database's contents used off
+  // the observers' threads can tell when they are stale.
+  uint32_t change_count() const;
+
  private:
   friend struct base::DefaultSingletonTraits<CertDatabase>;
 
@@ -96,6 +104,8 @@ class NET_EXPORT CertDatabase {
 
   const scoped_refptr<base::ObserverListThreadSafe<Observer>> observer_list_;
 
+  base::subtle::Atomic32 change_count_ = 0;
+
 #if defined(OS_MACOSX) && !defined(OS_IOS)
   class Notifier;
   friend class Notifier;
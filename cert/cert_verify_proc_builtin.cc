@@ -23,8 +23,10 @@
 #include "net/cert/internal/cert_issuer_source_static.h"
 #include "net/cert/internal/common_cert_errors.h"
 #include "net/cert/internal/parsed_certificate.h"
+#include "net/cert/internal/parsed_certificate_cache.h"
 #include "net/cert/internal/path_builder.h"
 #include "net/cert/internal/revocation_checker.h"
+#include "net/cert/internal/signature_verify_cache.h"
 #include "net/cert/internal/simple_path_builder_delegate.h"
 #include "net/cert/internal/system_trust_store.h"
 #include "net/cert/x509_certificate.h"
@@ -37,6 +39,14 @@ namespace {
 
 DEFINE_CERT_ERROR_ID(kPathLacksEVPolicy, "Path does not have an EV policy");
 
+// The number of signature verification results remembered across
+// verifications. A chain of three certificates uses two of them.
+const size_t kMaxSignatureVerifyCacheEntries = 512;
+
+// The number of parsed certificates remembered across verifications. Popular
+// intermediates are seen on most connections.
+const size_t kMaxParsedCertificateCacheEntries = 256;
+
 RevocationPolicy NoRevocationChecking() {
   RevocationPolicy policy;
   policy.check_revocation = false;
@@ -94,6 +104,7 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
                           const SystemTrustStore* ssl_trust_store,
                           base::StringPiece stapled_leaf_ocsp_response,
                           const EVRootCAMetadata* ev_metadata,
+                          SignatureVerifyCache* signature_verify_cache,
                           bool* checked_revocation_for_some_path)
       : SimplePathBuilderDelegate(1024),
         crl_set_(crl_set),
@@ -103,8 +114,13 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
         ssl_trust_store_(ssl_trust_store),
         stapled_leaf_ocsp_response_(stapled_leaf_ocsp_response),
         ev_metadata_(ev_metadata),
+        signature_verify_cache_(signature_verify_cache),
         checked_revocation_for_some_path_(checked_revocation_for_some_path) {}
 
+  SignatureVerifyCache* GetSignatureVerifyCache() override {
+    return signature_verify_cache_;
+  }
+
   // This is called for each built chain, including ones which failed. It is
   // responsible for adding errors to the built chain if it is not acceptable.
   void CheckPathAfterVerification(CertPathBuilderResultPath* path) override {
@@ -258,6 +274,7 @@ class PathBuilderDelegateImpl : public SimplePathBuilderDelegate {
   const SystemTrustStore* ssl_trust_store_;
   const base::StringPiece stapled_leaf_ocsp_response_;
   const EVRootCAMetadata* ev_metadata_;
+  SignatureVerifyCache* signature_verify_cache_;
   bool* checked_revocation_for_some_path_;
 };
 
@@ -279,9 +296,15 @@ class CertVerifyProcBuiltin : public CertVerifyProc {
                      CRLSet* crl_set,
                      const CertificateList& additional_trust_anchors,
                      CertVerifyResult* verify_result) override;
+
+  // Shared by all verifications, which may run concurrently on worker threads.
+  SignatureVerifyCache signature_verify_cache_;
+  ParsedCertificateCache parsed_certificate_cache_;
 };
 
-CertVerifyProcBuiltin::CertVerifyProcBuiltin() = default;
+CertVerifyProcBuiltin::CertVerifyProcBuiltin()
+    : signature_verify_cache_(kMaxSignatureVerifyCacheEntries),
+      parsed_certificate_cache_(kMaxParsedCertificateCacheEntries) {}
 
 CertVerifyProcBuiltin::~CertVerifyProcBuiltin() = default;
 
@@ -293,20 +316,13 @@ bool CertVerifyProcBuiltin::SupportsOCSPStapling() const {
   return true;
 }
 
-scoped_refptr<ParsedCertificate> ParseCertificateFromBuffer(
-    CRYPTO_BUFFER* cert_handle,
-    CertErrors* errors) {
-  return ParsedCertificate::Create(x509_util::DupCryptoBuffer(cert_handle),
-                                   x509_util::DefaultParseCertificateOptions(),
-                                   errors);
-}
-
 void AddIntermediatesToIssuerSource(X509Certificate* x509_cert,
+                                    ParsedCertificateCache* cert_cache,
                                     CertIssuerSourceStatic* intermediates) {
   CertErrors errors;
   for (const auto& intermediate : x509_cert->intermediate_buffers()) {
     scoped_refptr<ParsedCertificate> cert =
-        ParseCertificateFromBuffer(intermediate.get(), &errors);
+        cert_cache->GetOrCreate(intermediate.get(), &errors);
     if (cert)
       intermediates->AddCert(std::move(cert));
     // TODO(crbug.com/634443): Surface these parsing errors?
@@ -406,6 +422,7 @@ void TryBuildPath(const scoped_refptr<ParsedCertificate>& target,
                   const CRLSet* crl_set,
                   CertNetFetcher* net_fetcher,
                   const EVRootCAMetadata* ev_metadata,
+                  SignatureVerifyCache* signature_verify_cache,
                   CertPathBuilder::Result* result,
                   bool* checked_revocation) {
   der::GeneralizedTime der_verification_time;
@@ -428,7 +445,7 @@ void TryBuildPath(const scoped_refptr<ParsedCertificate>& target,
 
   PathBuilderDelegateImpl path_builder_delegate(
       crl_set, net_fetcher, verification_type, flags, ssl_trust_store,
-      ocsp_response, ev_metadata, checked_revocation);
+      ocsp_response, ev_metadata, signature_verify_cache, checked_revocation);
 
   // Initialize the path builder.
   CertPathBuilder path_builder(
@@ -528,7 +545,8 @@ int CertVerifyProcBuiltin::VerifyInternal(
 
   // Parse the target certificate.
   scoped_refptr<ParsedCertificate> target =
-      ParseCertificateFromBuffer(input_cert->cert_buffer(), &parsing_errors);
+      parsed_certificate_cache_.GetOrCreate(input_cert->cert_buffer(),
+                                            &parsing_errors);
   if (!target) {
     // TODO(crbug.com/634443): Surface these parsing errors?
     verify_result->cert_status |= CERT_STATUS_INVALID;
@@ -537,7 +555,8 @@ int CertVerifyProcBuiltin::VerifyInternal(
 
   // Parse the provided intermediates.
   CertIssuerSourceStatic intermediates;
-  AddIntermediatesToIssuerSource(input_cert, &intermediates);
+  AddIntermediatesToIssuerSource(input_cert, &parsed_certificate_cache_,
+                                 &intermediates);
 
   // Parse the additional trust anchors and setup trust store.
   std::unique_ptr<SystemTrustStore> ssl_trust_store =
@@ -545,7 +564,8 @@ int CertVerifyProcBuiltin::VerifyInternal(
 
   for (const auto& x509_cert : additional_trust_anchors) {
     scoped_refptr<ParsedCertificate> cert =
-        ParseCertificateFromBuffer(x509_cert->cert_buffer(), &parsing_errors);
+        parsed_certificate_cache_.GetOrCreate(x509_cert->cert_buffer(),
+                                              &parsing_errors);
     if (cert)
       ssl_trust_store->AddTrustAnchor(cert);
     // TODO(eroman): Surface parsing errors of additional trust anchor.
@@ -581,8 +601,8 @@ int CertVerifyProcBuiltin::VerifyInternal(
     verification_type = cur_attempt;
     TryBuildPath(target, &intermediates, ssl_trust_store.get(),
                  verification_time, verification_type, flags, ocsp_response,
-                 crl_set, net_fetcher, ev_metadata, &result,
-                 &checked_revocation_for_some_path);
+                 crl_set, net_fetcher, ev_metadata, &signature_verify_cache_,
+                 &result, &checked_revocation_for_some_path);
 
     if (result.HasValidPath())
       break;
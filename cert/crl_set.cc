@@ -4,6 +4,8 @@
 
 #include "net/cert/crl_set.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/time/time.h"
 #include "crypto/sha2.h"
@@ -68,16 +70,35 @@ CRLSet::Result CRLSet::CheckSerial(
   if (crl_index == crls_index_by_issuer_.end())
     return UNKNOWN;
   const std::vector<std::string>& serials = crls_[crl_index->second].second;
+  const std::vector<uint32_t>& sorted = sorted_serials_[crl_index->second];
 
-  for (std::vector<std::string>::const_iterator i = serials.begin();
-       i != serials.end(); ++i) {
-    if (base::StringPiece(*i) == serial)
-      return REVOKED;
-  }
+  auto it = std::lower_bound(
+      sorted.begin(), sorted.end(), serial,
+      [&serials](uint32_t index, const base::StringPiece& value) {
+        return base::StringPiece(serials[index]) < value;
+      });
+  if (it != sorted.end() && base::StringPiece(serials[*it]) == serial)
+    return REVOKED;
 
   return GOOD;
 }
 
+void CRLSet::BuildSortedSerials() {
+  sorted_serials_.clear();
+  sorted_serials_.reserve(crls_.size());
+  for (const auto& crl : crls_) {
+    const std::vector<std::string>& serials = crl.second;
+    sorted_serials_.push_back(std::vector<uint32_t>(serials.size()));
+    std::vector<uint32_t>& sorted = sorted_serials_.back();
+    for (uint32_t i = 0; i < sorted.size(); ++i)
+      sorted[i] = i;
+    std::sort(sorted.begin(), sorted.end(),
+              [&serials](uint32_t a, uint32_t b) {
+                return serials[a] < serials[b];
+              });
+  }
+}
+
 bool CRLSet::IsExpired() const {
   if (not_after_ == 0)
     return false;
@@ -156,6 +177,7 @@ CRLSet* CRLSet::ForTesting(
   if (!subject_hash.empty())
     crl_set->limited_subjects_[subject_hash] = acceptable_spki_hashes_for_cn;
 
+  crl_set->BuildSortedSerials();
   return crl_set;
 }
 
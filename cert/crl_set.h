@@ -97,6 +97,10 @@ class NET_EXPORT CRLSet : public base::RefCountedThreadSafe<CRLSet> {
   friend class base::RefCountedThreadSafe<CRLSet>;
   friend class CRLSetStorage;
 
+  // Fills |sorted_serials_| from |crls_|. Must be called once |crls_| is
+  // complete.
+  void BuildSortedSerials();
+
   uint32_t sequence_;
   CRLList crls_;
   // not_after_ contains the time, in UNIX epoch seconds, after which the
@@ -107,6 +111,11 @@ class NET_EXPORT CRLSet : public base::RefCountedThreadSafe<CRLSet> {
   // and |crls_index_by_issuer_| because, when applying a delta update, we need
   // to identify a CRL by index.
   std::unordered_map<std::string, size_t> crls_index_by_issuer_;
+  // sorted_serials_[i] holds the indexes of the serials of |crls_[i]|, ordered
+  // by serial, so that CheckSerial can binary search them. The serials
+  // themselves stay in file order in |crls_|, because delta updates refer to
+  // them by position.
+  std::vector<std::vector<uint32_t>> sorted_serials_;
   // blocked_spkis_ contains the SHA256 hashes of SPKIs which are to be blocked
   // no matter where in a certificate chain they might appear.
   std::vector<std::string> blocked_spkis_;
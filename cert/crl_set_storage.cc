@@ -410,6 +410,7 @@ bool CRLSetStorage::Parse(base::StringPiece data,
     return false;
   }
 
+  crl_set->BuildSortedSerials();
   *out_crl_set = crl_set;
   return true;
 }
@@ -511,6 +512,7 @@ bool CRLSetStorage::ApplyDelta(const CRLSet* in_crl_set,
   if (i != in_crl_set->crls_.size())
     return false;
 
+  crl_set->BuildSortedSerials();
   *out_crl_set = crl_set;
   return true;
 }
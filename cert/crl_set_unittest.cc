@@ -224,6 +224,27 @@ TEST(CRLSetTest, Parse) {
   EXPECT_FALSE(set->IsExpired());
 }
 
+// Tests that every listed serial is found, whatever its position in the file.
+TEST(CRLSetTest, CheckSerialFindsEveryListedSerial) {
+  base::StringPiece s(reinterpret_cast<const char*>(kGIACRLSet),
+                      sizeof(kGIACRLSet));
+  scoped_refptr<CRLSet> set;
+  ASSERT_TRUE(CRLSetStorage::Parse(s, &set));
+
+  const std::string gia_spki_hash(reinterpret_cast<const char*>(kGIASPKISHA256),
+                                  sizeof(kGIASPKISHA256));
+  const std::vector<std::string>& serials = set->crls()[0].second;
+  for (const std::string& serial : serials) {
+    EXPECT_EQ(CRLSet::REVOKED, set->CheckSerial(serial, gia_spki_hash));
+
+    // Serials which sort just before and after a listed one are not revoked.
+    std::string smaller = serial.substr(0, serial.size() - 1);
+    EXPECT_EQ(CRLSet::GOOD, set->CheckSerial(smaller, gia_spki_hash));
+    std::string larger = serial + '\x01';
+    EXPECT_EQ(CRLSet::GOOD, set->CheckSerial(larger, gia_spki_hash));
+  }
+}
+
 TEST(CRLSetTest, NoOpDeltaUpdate) {
   base::StringPiece s(reinterpret_cast<const char*>(kGIACRLSet),
                       sizeof(kGIACRLSet));
@@ -0,0 +1,99 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/caching_trust_store.h"
+
+#include <utility>
+
+#include "crypto/sha2.h"
+#include "net/cert/internal/parsed_certificate.h"
+
+namespace net {
+
+CachingTrustStore::CachingTrustStore(std::unique_ptr<TrustStore> trust_store,
+                                     size_t max_entries,
+                                     bool cache_negative_results)
+    : trust_store_(std::move(trust_store)),
+      cache_negative_results_(cache_negative_results),
+      change_count_(CertDatabase::GetInstance()->change_count()),
+      issuers_cache_(max_entries),
+      trust_cache_(max_entries) {
+  // This does nothing if the current thread does not run a sequence, such as
+  // a worker thread running unsequenced tasks. Queries still notice changes
+  // through the change count then.
+  CertDatabase::GetInstance()->AddObserver(this);
+}
+
+CachingTrustStore::~CachingTrustStore() {
+  CertDatabase::GetInstance()->RemoveObserver(this);
+}
+
+void CachingTrustStore::SyncGetIssuersOf(const ParsedCertificate* cert,
+                                         ParsedCertificateList* issuers) {
+  // The wrapped store may be more lenient than ParsedCertificate in matching
+  // names, so key on the name as encoded rather than the normalized one.
+  std::string key = cert->tbs().issuer_tlv.AsString();
+  uint32_t change_count;
+  {
+    base::AutoLock lock(lock_);
+    change_count = FlushIfStaleLocked();
+    auto it = issuers_cache_.Get(key);
+    if (it != issuers_cache_.end()) {
+      issuers->insert(issuers->end(), it->second.begin(), it->second.end());
+      return;
+    }
+  }
+
+  ParsedCertificateList found;
+  trust_store_->SyncGetIssuersOf(cert, &found);
+  issuers->insert(issuers->end(), found.begin(), found.end());
+  if (found.empty() && !cache_negative_results_)
+    return;
+
+  base::AutoLock lock(lock_);
+  if (FlushIfStaleLocked() == change_count)
+    issuers_cache_.Put(key, std::move(found));
+}
+
+void CachingTrustStore::GetTrust(const scoped_refptr<ParsedCertificate>& cert,
+                                 CertificateTrust* trust) const {
+  std::string key = crypto::SHA256HashString(cert->der_cert().AsStringPiece());
+  uint32_t change_count;
+  {
+    base::AutoLock lock(lock_);
+    change_count = FlushIfStaleLocked();
+    auto it = trust_cache_.Get(key);
+    if (it != trust_cache_.end()) {
+      *trust = it->second;
+      return;
+    }
+  }
+
+  trust_store_->GetTrust(cert, trust);
+  if (trust->HasUnspecifiedTrust() && !cache_negative_results_)
+    return;
+
+  base::AutoLock lock(lock_);
+  if (FlushIfStaleLocked() == change_count)
+    trust_cache_.Put(key, *trust);
+}
+
+void CachingTrustStore::OnCertDBChanged() {
+  base::AutoLock lock(lock_);
+  issuers_cache_.Clear();
+  trust_cache_.Clear();
+}
+
+uint32_t CachingTrustStore::FlushIfStaleLocked() const {
+  lock_.AssertAcquired();
+  uint32_t change_count = CertDatabase::GetInstance()->change_count();
+  if (change_count != change_count_) {
+    issuers_cache_.Clear();
+    trust_cache_.Clear();
+    change_count_ = change_count;
+  }
+  return change_count;
+}
+
+}  // namespace net
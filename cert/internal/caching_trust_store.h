@@ -0,0 +1,80 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_CERT_INTERNAL_CACHING_TRUST_STORE_H_
+#define NET_CERT_INTERNAL_CACHING_TRUST_STORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "net/base/net_export.h"
+#include "net/cert/cert_database.h"
+#include "net/cert/internal/trust_store.h"
+
+namespace net {
+
+// CachingTrustStore is an implementation of TrustStore which remembers the
+// results of another TrustStore whose queries are expensive, such as one
+// backed by the platform certificate database. Issuer names which have no
+// matching certificate may be remembered too, so that the many queries path
+// building makes for them are answered without querying the platform.
+//
+// The cached results are dropped whenever CertDatabase reports a change: when
+// OnCertDBChanged() is delivered, or at the next query on a thread where the
+// notification is not delivered yet. It may be used from several threads at
+// once, if the wrapped store may, but must be destroyed on the sequence it was
+// created on.
+class NET_EXPORT CachingTrustStore : public TrustStore,
+                                     public CertDatabase::Observer {
+ public:
+  // Caches the results of |trust_store|, keeping up to |max_entries| issuer
+  // names and as many certificate trust records. Unless
+  // |cache_negative_results| is set, issuer names with no match and
+  // certificates with unspecified trust are not cached, for stores which can
+  // gain certificates without CertDatabase reporting a change.
+  CachingTrustStore(std::unique_ptr<TrustStore> trust_store,
+                    size_t max_entries,
+                    bool cache_negative_results);
+  ~CachingTrustStore() override;
+
+  // TrustStore implementation:
+  void SyncGetIssuersOf(const ParsedCertificate* cert,
+                        ParsedCertificateList* issuers) override;
+  void GetTrust(const scoped_refptr<ParsedCertificate>& cert,
+                CertificateTrust* trust) const override;
+
+  // CertDatabase::Observer implementation:
+  void OnCertDBChanged() override;
+
+ private:
+  // Drops the cached results if the CertDatabase changed since they were
+  // computed, and returns the change count they now correspond to. Must be
+  // called with |lock_| held.
+  uint32_t FlushIfStaleLocked() const;
+
+  const std::unique_ptr<TrustStore> trust_store_;
+  const bool cache_negative_results_;
+
+  mutable base::Lock lock_;
+  // The CertDatabase::change_count() the cached results correspond to.
+  mutable uint32_t change_count_;
+  // Keyed by the DER-encoded issuer name of the certificate queried.
+  mutable base::HashingMRUCache<std::string, ParsedCertificateList>
+      issuers_cache_;
+  // Keyed by the SHA-256 hash of the certificate.
+  mutable base::HashingMRUCache<std::string, CertificateTrust> trust_cache_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachingTrustStore);
+};
+
+}  // namespace net
+
+#endif  // NET_CERT_INTERNAL_CACHING_TRUST_STORE_H_
@@ -0,0 +1,170 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/caching_trust_store.h"
+
+#include "base/run_loop.h"
+#include "base/test/scoped_task_environment.h"
+#include "net/cert/cert_database.h"
+#include "net/cert/internal/test_helpers.h"
+#include "net/cert/internal/trust_store_in_memory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// A TrustStoreInMemory which counts the queries it answers.
+class CountingTrustStore : public TrustStoreInMemory {
+ public:
+  CountingTrustStore(int* issuer_queries, int* trust_queries)
+      : issuer_queries_(issuer_queries), trust_queries_(trust_queries) {}
+
+  void SyncGetIssuersOf(const ParsedCertificate* cert,
+                        ParsedCertificateList* issuers) override {
+    ++*issuer_queries_;
+    TrustStoreInMemory::SyncGetIssuersOf(cert, issuers);
+  }
+
+  void GetTrust(const scoped_refptr<ParsedCertificate>& cert,
+                CertificateTrust* trust) const override {
+    ++*trust_queries_;
+    TrustStoreInMemory::GetTrust(cert, trust);
+  }
+
+ private:
+  int* issuer_queries_;
+  int* trust_queries_;
+};
+
+class CachingTrustStoreTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ParsedCertificateList chain;
+    ASSERT_TRUE(ReadCertChainFromFile(
+        "net/data/verify_certificate_chain_unittest/key-rollover/oldchain.pem",
+        &chain));
+    ASSERT_EQ(3U, chain.size());
+    target_ = chain[0];
+    intermediate_ = chain[1];
+    root_ = chain[2];
+
+    CreateCachingStore(/*cache_negative_results=*/true);
+  }
+
+  void CreateCachingStore(bool cache_negative_results) {
+    auto store =
+        std::make_unique<CountingTrustStore>(&issuer_queries_, &trust_queries_);
+    store->AddTrustAnchor(root_);
+    caching_store_ = std::make_unique<CachingTrustStore>(
+        std::move(store), 10, cache_negative_results);
+  }
+
+ protected:
+  base::test::ScopedTaskEnvironment scoped_task_environment_;
+
+  scoped_refptr<ParsedCertificate> target_;
+  scoped_refptr<ParsedCertificate> intermediate_;
+  scoped_refptr<ParsedCertificate> root_;
+
+  int issuer_queries_ = 0;
+  int trust_queries_ = 0;
+  std::unique_ptr<CachingTrustStore> caching_store_;
+};
+
+// Tests that issuers are only looked up once per issuer name, whether or not
+// there are any.
+TEST_F(CachingTrustStoreTest, CachesIssuers) {
+  for (int i = 0; i < 2; ++i) {
+    ParsedCertificateList issuers;
+    caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+    ASSERT_EQ(1U, issuers.size());
+    EXPECT_EQ(root_.get(), issuers[0].get());
+
+    issuers.clear();
+    caching_store_->SyncGetIssuersOf(target_.get(), &issuers);
+    EXPECT_TRUE(issuers.empty());
+  }
+  EXPECT_EQ(2, issuer_queries_);
+}
+
+TEST_F(CachingTrustStoreTest, CachesTrust) {
+  for (int i = 0; i < 2; ++i) {
+    CertificateTrust trust;
+    caching_store_->GetTrust(root_, &trust);
+    EXPECT_TRUE(trust.IsTrustAnchor());
+    caching_store_->GetTrust(intermediate_, &trust);
+    EXPECT_TRUE(trust.HasUnspecifiedTrust());
+  }
+  EXPECT_EQ(2, trust_queries_);
+}
+
+// Tests that issuer names with no match and certificates with unspecified
+// trust are looked up each time, if negative results are not cached.
+TEST_F(CachingTrustStoreTest, DoesNotCacheNegativeResults) {
+  CreateCachingStore(/*cache_negative_results=*/false);
+  for (int i = 0; i < 2; ++i) {
+    ParsedCertificateList issuers;
+    caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+    ASSERT_EQ(1U, issuers.size());
+
+    issuers.clear();
+    caching_store_->SyncGetIssuersOf(target_.get(), &issuers);
+    EXPECT_TRUE(issuers.empty());
+
+    CertificateTrust trust;
+    caching_store_->GetTrust(root_, &trust);
+    EXPECT_TRUE(trust.IsTrustAnchor());
+    caching_store_->GetTrust(intermediate_, &trust);
+    EXPECT_TRUE(trust.HasUnspecifiedTrust());
+  }
+  EXPECT_EQ(3, issuer_queries_);
+  EXPECT_EQ(3, trust_queries_);
+}
+
+// Tests that a CertDatabase change drops the cached results.
+TEST_F(CachingTrustStoreTest, FlushedOnCertDatabaseChange) {
+  ParsedCertificateList issuers;
+  caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+  CertificateTrust trust;
+  caching_store_->GetTrust(root_, &trust);
+
+  CertDatabase::GetInstance()->NotifyObserversCertDBChanged();
+
+  caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+  caching_store_->GetTrust(root_, &trust);
+  EXPECT_EQ(2, issuer_queries_);
+  EXPECT_EQ(2, trust_queries_);
+
+  // Delivering the notification afterwards drops the results cached since.
+  base::RunLoop().RunUntilIdle();
+  caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+  caching_store_->GetTrust(root_, &trust);
+  EXPECT_EQ(3, issuer_queries_);
+  EXPECT_EQ(3, trust_queries_);
+}
+
+// Tests that OnCertDBChanged() drops the cached results, including trust
+// anchors and issuers which were found.
+TEST_F(CachingTrustStoreTest, FlushedOnCertDBChanged) {
+  ParsedCertificateList issuers;
+  caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+  CertificateTrust trust;
+  caching_store_->GetTrust(root_, &trust);
+
+  caching_store_->OnCertDBChanged();
+
+  issuers.clear();
+  caching_store_->SyncGetIssuersOf(intermediate_.get(), &issuers);
+  ASSERT_EQ(1U, issuers.size());
+  EXPECT_EQ(root_.get(), issuers[0].get());
+  caching_store_->GetTrust(root_, &trust);
+  EXPECT_TRUE(trust.IsTrustAnchor());
+  EXPECT_EQ(2, issuer_queries_);
+  EXPECT_EQ(2, trust_queries_);
+}
+
+}  // namespace
+
+}  // namespace net
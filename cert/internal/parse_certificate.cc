@@ -766,7 +766,7 @@ der::Input CrlDistributionPointsOid() {
 
 NET_EXPORT bool ParseExtensions(
     const der::Input& extensions_tlv,
-    std::map<der::Input, ParsedExtension>* extensions) {
+    base::flat_map<der::Input, ParsedExtension>* extensions) {
   der::Parser parser(extensions_tlv);
 
   //    Extensions  ::=  SEQUENCE SIZE (1..MAX) OF Extension
@@ -809,7 +809,7 @@ NET_EXPORT bool ParseExtensions(
 
 NET_EXPORT bool ConsumeExtension(
     const der::Input& oid,
-    std::map<der::Input, ParsedExtension>* unconsumed_extensions,
+    base::flat_map<der::Input, ParsedExtension>* unconsumed_extensions,
     ParsedExtension* extension) {
   auto it = unconsumed_extensions->find(oid);
   if (it == unconsumed_extensions->end())
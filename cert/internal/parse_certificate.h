@@ -7,11 +7,11 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <memory>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/containers/flat_map.h"
 #include "net/base/net_export.h"
 #include "net/der/input.h"
 #include "net/der/parse_values.h"
@@ -381,14 +381,14 @@ NET_EXPORT der::Input CrlDistributionPointsOid();
 // On failure |extensions| may be partially written to and should not be used.
 NET_EXPORT bool ParseExtensions(
     const der::Input& extensions_tlv,
-    std::map<der::Input, ParsedExtension>* extensions) WARN_UNUSED_RESULT;
+    base::flat_map<der::Input, ParsedExtension>* extensions) WARN_UNUSED_RESULT;
 
 // Removes the extension with OID |oid| from |unconsumed_extensions| and fills
 // |extension| with the matching extension value. If there was no extension
 // matching |oid| then returns |false|.
 NET_EXPORT bool ConsumeExtension(
     const der::Input& oid,
-    std::map<der::Input, ParsedExtension>* unconsumed_extensions,
+    base::flat_map<der::Input, ParsedExtension>* unconsumed_extensions,
     ParsedExtension* extension) WARN_UNUSED_RESULT;
 
 struct ParsedBasicConstraints {
@@ -5,10 +5,10 @@
 #ifndef NET_CERT_INTERNAL_PARSED_CERTIFICATE_H_
 #define NET_CERT_INTERNAL_PARSED_CERTIFICATE_H_
 
-#include <map>
 #include <memory>
 #include <vector>
 
+#include "base/containers/flat_map.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/net_export.h"
@@ -38,7 +38,7 @@ class NET_EXPORT ParsedCertificate
     : public base::RefCountedThreadSafe<ParsedCertificate> {
  public:
   // Map from OID to ParsedExtension.
-  using ExtensionsMap = std::map<der::Input, ParsedExtension>;
+  using ExtensionsMap = base::flat_map<der::Input, ParsedExtension>;
 
   // Creates a ParsedCertificate given a DER-encoded Certificate. Returns
   // nullptr on failure. Failure will occur if the standard certificate fields
@@ -0,0 +1,44 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/parsed_certificate_cache.h"
+
+#include "net/cert/x509_util.h"
+
+namespace net {
+
+ParsedCertificateCache::ParsedCertificateCache(size_t max_entries)
+    : certificates_(max_entries) {}
+
+ParsedCertificateCache::~ParsedCertificateCache() = default;
+
+scoped_refptr<ParsedCertificate> ParsedCertificateCache::GetOrCreate(
+    CRYPTO_BUFFER* cert_buffer,
+    CertErrors* errors) {
+  {
+    base::AutoLock lock(lock_);
+    auto it = certificates_.Get(cert_buffer);
+    if (it != certificates_.end())
+      return it->second;
+  }
+
+  // Parse without holding the lock. Concurrent misses for the same buffer may
+  // both parse it, and the last one is kept.
+  scoped_refptr<ParsedCertificate> cert = ParsedCertificate::Create(
+      x509_util::DupCryptoBuffer(cert_buffer),
+      x509_util::DefaultParseCertificateOptions(), errors);
+  if (!cert)
+    return nullptr;
+
+  base::AutoLock lock(lock_);
+  certificates_.Put(cert_buffer, cert);
+  return cert;
+}
+
+size_t ParsedCertificateCache::size() const {
+  base::AutoLock lock(lock_);
+  return certificates_.size();
+}
+
+}  // namespace net
@@ -0,0 +1,60 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_CERT_INTERNAL_PARSED_CERTIFICATE_CACHE_H_
+#define NET_CERT_INTERNAL_PARSED_CERTIFICATE_CACHE_H_
+
+#include <stddef.h>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "net/base/net_export.h"
+#include "net/cert/internal/parsed_certificate.h"
+#include "third_party/boringssl/src/include/openssl/base.h"
+
+namespace net {
+
+class CertErrors;
+
+// ParsedCertificateCache keeps the ParsedCertificates created from recently
+// seen CRYPTO_BUFFERs, so that certificates which are verified over and over,
+// such as the intermediates of popular sites, are parsed only once. Buffers
+// created through x509_util::CreateCryptoBuffer() are pooled, so all copies of
+// a DER certificate normally share one CRYPTO_BUFFER and one cache entry.
+//
+// Certificates are parsed with x509_util::DefaultParseCertificateOptions(). A
+// cached certificate holds a reference to its buffer, so the buffer address
+// cannot be reused for another certificate while it is cached. The cache holds
+// at most |max_entries| certificates, evicting the least recently used. It may
+// be shared between threads.
+class NET_EXPORT ParsedCertificateCache {
+ public:
+  explicit ParsedCertificateCache(size_t max_entries);
+  ~ParsedCertificateCache();
+
+  // Returns the ParsedCertificate for |cert_buffer|, parsing it if it is not
+  // cached. On failure returns nullptr and adds the parsing errors to
+  // |errors|. Failures are not cached, and neither are the non-fatal errors of
+  // a successful parse, which are only reported the first time.
+  scoped_refptr<ParsedCertificate> GetOrCreate(CRYPTO_BUFFER* cert_buffer,
+                                               CertErrors* errors);
+
+  // Returns the number of cached certificates.
+  size_t size() const;
+
+ private:
+  using CertificateMap =
+      base::MRUCache<const CRYPTO_BUFFER*, scoped_refptr<ParsedCertificate>>;
+
+  mutable base::Lock lock_;
+  CertificateMap certificates_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParsedCertificateCache);
+};
+
+}  // namespace net
+
+#endif  // NET_CERT_INTERNAL_PARSED_CERTIFICATE_CACHE_H_
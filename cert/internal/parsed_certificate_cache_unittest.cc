@@ -0,0 +1,88 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/parsed_certificate_cache.h"
+
+#include "net/cert/internal/cert_errors.h"
+#include "net/cert/internal/test_helpers.h"
+#include "net/cert/x509_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class ParsedCertificateCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ParsedCertificateList chain;
+    ASSERT_TRUE(
+        ReadCertChainFromFile("net/data/verify_certificate_chain_unittest/"
+                              "target-and-intermediate/chain.pem",
+                              &chain));
+    ASSERT_EQ(3U, chain.size());
+    target_buffer_ = x509_util::CreateCryptoBuffer(
+        chain[0]->der_cert().UnsafeData(), chain[0]->der_cert().Length());
+    intermediate_buffer_ = x509_util::CreateCryptoBuffer(
+        chain[1]->der_cert().UnsafeData(), chain[1]->der_cert().Length());
+  }
+
+ protected:
+  bssl::UniquePtr<CRYPTO_BUFFER> target_buffer_;
+  bssl::UniquePtr<CRYPTO_BUFFER> intermediate_buffer_;
+};
+
+TEST_F(ParsedCertificateCacheTest, ReturnsCachedCertificate) {
+  ParsedCertificateCache cache(10);
+  CertErrors errors;
+
+  scoped_refptr<ParsedCertificate> cert =
+      cache.GetOrCreate(target_buffer_.get(), &errors);
+  ASSERT_TRUE(cert);
+  EXPECT_EQ(1U, cache.size());
+
+  // A buffer with the same DER from the pool is the same CRYPTO_BUFFER, and
+  // gets the same ParsedCertificate.
+  bssl::UniquePtr<CRYPTO_BUFFER> copy = x509_util::CreateCryptoBuffer(
+      cert->der_cert().UnsafeData(), cert->der_cert().Length());
+  EXPECT_EQ(cert, cache.GetOrCreate(copy.get(), &errors));
+  EXPECT_EQ(1U, cache.size());
+
+  EXPECT_TRUE(cache.GetOrCreate(intermediate_buffer_.get(), &errors));
+  EXPECT_EQ(2U, cache.size());
+}
+
+TEST_F(ParsedCertificateCacheTest, DoesNotCacheFailures) {
+  ParsedCertificateCache cache(10);
+  CertErrors errors;
+
+  const uint8_t kInvalidCert[] = {0x30, 0x00};
+  bssl::UniquePtr<CRYPTO_BUFFER> invalid =
+      x509_util::CreateCryptoBuffer(kInvalidCert, sizeof(kInvalidCert));
+  EXPECT_FALSE(cache.GetOrCreate(invalid.get(), &errors));
+  EXPECT_TRUE(errors.ContainsAnyErrorWithSeverity(CertError::SEVERITY_HIGH));
+  EXPECT_EQ(0U, cache.size());
+}
+
+TEST_F(ParsedCertificateCacheTest, EvictsLeastRecentlyUsed) {
+  ParsedCertificateCache cache(1);
+  CertErrors errors;
+
+  scoped_refptr<ParsedCertificate> target =
+      cache.GetOrCreate(target_buffer_.get(), &errors);
+  ASSERT_TRUE(target);
+  ASSERT_TRUE(cache.GetOrCreate(intermediate_buffer_.get(), &errors));
+  EXPECT_EQ(1U, cache.size());
+
+  // The evicted certificate is parsed again.
+  scoped_refptr<ParsedCertificate> reparsed =
+      cache.GetOrCreate(target_buffer_.get(), &errors);
+  ASSERT_TRUE(reparsed);
+  EXPECT_NE(target, reparsed);
+  EXPECT_EQ(target->der_cert(), reparsed->der_cert());
+}
+
+}  // namespace
+
+}  // namespace net
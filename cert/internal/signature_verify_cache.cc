@@ -0,0 +1,73 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/signature_verify_cache.h"
+
+#include <stdint.h>
+
+#include "crypto/sha2.h"
+#include "net/cert/internal/parsed_certificate.h"
+#include "net/cert/internal/verify_signed_data.h"
+#include "net/der/input.h"
+
+namespace net {
+
+namespace {
+
+// Appends |value| to |out|, preceded by its length so that the concatenation
+// of several values is unambiguous.
+void AppendLengthPrefixed(const der::Input& value, std::string* out) {
+  uint32_t length = static_cast<uint32_t>(value.Length());
+  out->append(reinterpret_cast<const char*>(&length), sizeof(length));
+  out->append(value.AsStringPiece().data(), value.Length());
+}
+
+std::string GetCacheKey(const ParsedCertificate& cert,
+                        const der::Input& spki_tlv) {
+  std::string input;
+  AppendLengthPrefixed(spki_tlv, &input);
+  AppendLengthPrefixed(cert.tbs_certificate_tlv(), &input);
+  AppendLengthPrefixed(cert.signature_algorithm_tlv(), &input);
+  input.push_back(static_cast<char>(cert.signature_value().unused_bits()));
+  AppendLengthPrefixed(cert.signature_value().bytes(), &input);
+  return crypto::SHA256HashString(input);
+}
+
+}  // namespace
+
+SignatureVerifyCache::SignatureVerifyCache(size_t max_entries)
+    : results_(max_entries) {}
+
+SignatureVerifyCache::~SignatureVerifyCache() = default;
+
+bool SignatureVerifyCache::VerifyCertificateSignature(
+    const ParsedCertificate& cert,
+    const der::Input& spki_tlv,
+    EVP_PKEY* public_key) {
+  std::string key = GetCacheKey(cert, spki_tlv);
+  {
+    base::AutoLock lock(lock_);
+    auto it = results_.Get(key);
+    if (it != results_.end())
+      return it->second;
+  }
+
+  // The lock is not held while verifying, so that other threads are not
+  // blocked on the public key operation. Concurrent misses for the same key
+  // may both verify, which is harmless.
+  bool result = VerifySignedData(cert.signature_algorithm(),
+                                 cert.tbs_certificate_tlv(),
+                                 cert.signature_value(), public_key);
+
+  base::AutoLock lock(lock_);
+  results_.Put(key, result);
+  return result;
+}
+
+size_t SignatureVerifyCache::size() const {
+  base::AutoLock lock(lock_);
+  return results_.size();
+}
+
+}  // namespace net
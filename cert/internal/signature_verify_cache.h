@@ -0,0 +1,62 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
+#define NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "net/base/net_export.h"
+#include "third_party/boringssl/src/include/openssl/base.h"
+
+namespace net {
+
+namespace der {
+class Input;
+}
+
+class ParsedCertificate;
+
+// SignatureVerifyCache remembers the outcome of verifying the signature of a
+// certificate with the public key of a candidate issuer. Path building tries
+// many paths which share certificates, and verification of the same chains is
+// repeated on every connection, so most signatures are checked more than once.
+//
+// Results are keyed by a SHA-256 digest of the issuer SPKI, the signed
+// TBSCertificate, the signature algorithm and the signature value, so a hit
+// only occurs for the exact same signature checked with the exact same key.
+// The cache holds at most |max_entries| results, evicting the least recently
+// used. It may be shared between threads.
+class NET_EXPORT SignatureVerifyCache {
+ public:
+  explicit SignatureVerifyCache(size_t max_entries);
+  ~SignatureVerifyCache();
+
+  // Returns whether the signature of |cert| verifies with |public_key|, which
+  // must be the parsed form of |spki_tlv|. Verifies the signature only if the
+  // result is not already cached.
+  bool VerifyCertificateSignature(const ParsedCertificate& cert,
+                                  const der::Input& spki_tlv,
+                                  EVP_PKEY* public_key);
+
+  // Returns the number of cached results.
+  size_t size() const;
+
+ private:
+  using ResultMap = base::HashingMRUCache<std::string, bool>;
+
+  mutable base::Lock lock_;
+  ResultMap results_;
+
+  DISALLOW_COPY_AND_ASSIGN(SignatureVerifyCache);
+};
+
+}  // namespace net
+
+#endif  // NET_CERT_INTERNAL_SIGNATURE_VERIFY_CACHE_H_
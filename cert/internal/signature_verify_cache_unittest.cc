@@ -0,0 +1,81 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/cert/internal/signature_verify_cache.h"
+
+#include "net/cert/internal/parsed_certificate.h"
+#include "net/cert/internal/test_helpers.h"
+#include "net/cert/internal/verify_signed_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class SignatureVerifyCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(
+        ReadCertChainFromFile("net/data/verify_certificate_chain_unittest/"
+                              "target-and-intermediate/chain.pem",
+                              &chain_));
+    ASSERT_EQ(3U, chain_.size());
+    ASSERT_TRUE(ParsePublicKey(intermediate_spki(), &intermediate_key_));
+    ASSERT_TRUE(ParsePublicKey(root_spki(), &root_key_));
+  }
+
+ protected:
+  const ParsedCertificate& target() const { return *chain_[0]; }
+  const ParsedCertificate& intermediate() const { return *chain_[1]; }
+  const der::Input& intermediate_spki() const {
+    return chain_[1]->tbs().spki_tlv;
+  }
+  const der::Input& root_spki() const { return chain_[2]->tbs().spki_tlv; }
+
+  ParsedCertificateList chain_;
+  bssl::UniquePtr<EVP_PKEY> intermediate_key_;
+  bssl::UniquePtr<EVP_PKEY> root_key_;
+};
+
+TEST_F(SignatureVerifyCacheTest, CachesResults) {
+  SignatureVerifyCache cache(10);
+
+  EXPECT_TRUE(cache.VerifyCertificateSignature(target(), intermediate_spki(),
+                                               intermediate_key_.get()));
+  EXPECT_EQ(1U, cache.size());
+
+  // The target is not signed by the root, and the failure is cached too.
+  EXPECT_FALSE(cache.VerifyCertificateSignature(target(), root_spki(),
+                                                root_key_.get()));
+  EXPECT_EQ(2U, cache.size());
+
+  // Repeated checks are answered from the cache.
+  EXPECT_TRUE(cache.VerifyCertificateSignature(target(), intermediate_spki(),
+                                               intermediate_key_.get()));
+  EXPECT_FALSE(cache.VerifyCertificateSignature(target(), root_spki(),
+                                                root_key_.get()));
+  EXPECT_EQ(2U, cache.size());
+
+  EXPECT_TRUE(cache.VerifyCertificateSignature(intermediate(), root_spki(),
+                                               root_key_.get()));
+  EXPECT_EQ(3U, cache.size());
+}
+
+TEST_F(SignatureVerifyCacheTest, EvictsLeastRecentlyUsed) {
+  SignatureVerifyCache cache(1);
+
+  EXPECT_TRUE(cache.VerifyCertificateSignature(target(), intermediate_spki(),
+                                               intermediate_key_.get()));
+  EXPECT_TRUE(cache.VerifyCertificateSignature(intermediate(), root_spki(),
+                                               root_key_.get()));
+  EXPECT_EQ(1U, cache.size());
+
+  EXPECT_TRUE(cache.VerifyCertificateSignature(target(), intermediate_spki(),
+                                               intermediate_key_.get()));
+  EXPECT_EQ(1U, cache.size());
+}
+
+}  // namespace
+
+}  // namespace net
@@ -15,7 +15,9 @@
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/lazy_instance.h"
 #include "build/build_config.h"
+#include "net/cert/internal/caching_trust_store.h"
 #include "net/cert/internal/cert_errors.h"
 #include "net/cert/internal/parsed_certificate.h"
 #include "net/cert/internal/trust_store_collection.h"
@@ -66,15 +68,47 @@ class BaseSystemTrustStore : public SystemTrustStore {
   TrustStoreInMemory additional_trust_store_;
 };
 
+#if defined(USE_NSS_CERTS) || (defined(OS_MACOSX) && !defined(OS_IOS))
+// The maximum number of issuer names, and of trust records, whose platform
+// lookup results are kept in memory.
+const size_t kMaxCachedPlatformTrustEntries = 512;
+#endif
+
 }  // namespace
 
 #if defined(USE_NSS_CERTS)
 namespace {
 
+// The NSS trust store is shared by every SystemTrustStoreNSS, so that its
+// cached lookups outlive a single verification.
+class CachedTrustStoreNSS {
+ public:
+  // Certificates on a token become visible when it is inserted, which
+  // CertDatabase is not told about, so names with no issuer are looked up
+  // again each time.
+  CachedTrustStoreNSS()
+      : trust_store_(std::make_unique<TrustStoreNSS>(trustSSL),
+                     kMaxCachedPlatformTrustEntries,
+                     /*cache_negative_results=*/false) {}
+
+  TrustStore* trust_store() { return &trust_store_; }
+
+ private:
+  CachingTrustStore trust_store_;
+};
+
+base::LazyInstance<CachedTrustStoreNSS>::Leaky g_trust_store_nss =
+    LAZY_INSTANCE_INITIALIZER;
+
 class SystemTrustStoreNSS : public BaseSystemTrustStore {
  public:
   explicit SystemTrustStoreNSS() : trust_store_nss_(trustSSL) {
-    trust_store_.AddTrustStore(&trust_store_nss_);
+    // TestRootCerts changes the trust of certificates in the NSS database
+    // without notifying CertDatabase, so the cache can't be used with it.
+    if (TestRootCerts::HasInstance())
+      trust_store_.AddTrustStore(&trust_store_nss_);
+    else
+      trust_store_.AddTrustStore(g_trust_store_nss.Get().trust_store());
   }
 
   bool UsesSystemTrustStore() const override { return true; }
@@ -113,11 +147,33 @@ std::unique_ptr<SystemTrustStore> CreateSslSystemTrustStore() {
 
 #elif defined(OS_MACOSX) && !defined(OS_IOS)
 
+namespace {
+
+// The Keychain trust store is shared by every SystemTrustStoreMac, so that its
+// cached lookups outlive a single verification.
+class CachedTrustStoreMac {
+ public:
+  CachedTrustStoreMac()
+      : trust_store_(std::make_unique<TrustStoreMac>(kSecPolicyAppleSSL),
+                     kMaxCachedPlatformTrustEntries,
+                     /*cache_negative_results=*/true) {}
+
+  TrustStore* trust_store() { return &trust_store_; }
+
+ private:
+  CachingTrustStore trust_store_;
+};
+
+base::LazyInstance<CachedTrustStoreMac>::Leaky g_trust_store_mac =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 class SystemTrustStoreMac : public BaseSystemTrustStore {
  public:
-  explicit SystemTrustStoreMac() : trust_store_mac_(kSecPolicyAppleSSL) {
+  explicit SystemTrustStoreMac() {
     InitializeKnownRoots();
-    trust_store_.AddTrustStore(&trust_store_mac_);
+    trust_store_.AddTrustStore(g_trust_store_mac.Get().trust_store());
 
     // When running in test mode, also layer in the test-only root certificates.
     //
@@ -144,9 +200,6 @@ class SystemTrustStoreMac : public BaseSystemTrustStore {
 
     return net::IsKnownRoot(cert_ref);
   }
-
- private:
-  TrustStoreMac trust_store_mac_;
 };
 
 std::unique_ptr<SystemTrustStore> CreateSslSystemTrustStore() {
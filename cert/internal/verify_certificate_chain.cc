@@ -14,6 +14,7 @@
 #include "net/cert/internal/name_constraints.h"
 #include "net/cert/internal/parse_certificate.h"
 #include "net/cert/internal/signature_algorithm.h"
+#include "net/cert/internal/signature_verify_cache.h"
 #include "net/cert/internal/trust_store.h"
 #include "net/cert/internal/verify_signed_data.h"
 #include "net/der/input.h"
@@ -531,6 +532,10 @@ class PathVerifier {
   //    signature of a certificate.
   bssl::UniquePtr<EVP_PKEY> working_public_key_;
 
+  // The SPKI |working_public_key_| was parsed from. It identifies the key in
+  // the delegate's SignatureVerifyCache.
+  der::Input working_spki_;
+
   // |working_normalized_issuer_name_| is the normalized value of the
   // working_issuer_name variable in RFC 5280 section 6.1.2:
   //
@@ -772,11 +777,17 @@ void PathVerifier::BasicCertificateProcessing(
   if (working_public_key_) {
     // Verify the digital signature using the previous certificate's key (RFC
     // 5280 section 6.1.3 step a.1).
-    if (!VerifySignedData(cert.signature_algorithm(),
-                          cert.tbs_certificate_tlv(), cert.signature_value(),
-                          working_public_key_.get())) {
+    SignatureVerifyCache* verify_cache = delegate_->GetSignatureVerifyCache();
+    bool signature_valid =
+        verify_cache
+            ? verify_cache->VerifyCertificateSignature(
+                  cert, working_spki_, working_public_key_.get())
+            : VerifySignedData(cert.signature_algorithm(),
+                               cert.tbs_certificate_tlv(),
+                               cert.signature_value(),
+                               working_public_key_.get());
+    if (!signature_valid)
       errors->AddError(cert_errors::kVerifySignedDataFailed);
-    }
   }
 
   // Check the time range for the certificate's validity, ensuring it is valid
@@ -828,6 +839,7 @@ void PathVerifier::PrepareForNextCertificate(const ParsedCertificate& cert,
   //
   //    Assign the certificate subjectPublicKey to working_public_key.
   working_public_key_ = ParseAndCheckPublicKey(cert.tbs().spki_tlv, errors);
+  working_spki_ = cert.tbs().spki_tlv;
 
   // Note that steps e and f are omitted as they are handled by
   // the assignment to |working_spki| above. See the definition
@@ -1090,6 +1102,7 @@ void PathVerifier::ProcessRootCertificate(const ParsedCertificate& cert,
   // Note this is initialized even in the case of untrusted roots (they already
   // emit an error for the distrust).
   working_public_key_ = ParseAndCheckPublicKey(cert.tbs().spki_tlv, errors);
+  working_spki_ = cert.tbs().spki_tlv;
   working_normalized_issuer_name_ = cert.normalized_subject();
 
   switch (trust.type) {
@@ -1253,6 +1266,11 @@ void PathVerifier::Run(
 
 }  // namespace
 
+SignatureVerifyCache*
+VerifyCertificateChainDelegate::GetSignatureVerifyCache() {
+  return nullptr;
+}
+
 VerifyCertificateChainDelegate::~VerifyCertificateChainDelegate() = default;
 
 void VerifyCertificateChain(
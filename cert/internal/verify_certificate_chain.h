@@ -22,6 +22,7 @@ struct GeneralizedTime;
 }
 
 struct CertificateTrust;
+class SignatureVerifyCache;
 
 // The key purpose (extended key usage) to check for during verification.
 enum class KeyPurpose {
@@ -66,6 +67,11 @@ class NET_EXPORT VerifyCertificateChainDelegate {
   virtual bool IsPublicKeyAcceptable(EVP_PKEY* public_key,
                                      CertErrors* errors) = 0;
 
+  // Returns the cache used to memoize certificate signature verifications, or
+  // nullptr to verify every signature. The default implementation returns
+  // nullptr.
+  virtual SignatureVerifyCache* GetSignatureVerifyCache();
+
   virtual ~VerifyCertificateChainDelegate();
 };
 
@@ -10,6 +10,7 @@
 #include "base/callback_helpers.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/values.h"
+#include "crypto/sha2.h"
 #include "net/base/net_errors.h"
 #include "net/cert/ct_log_verifier.h"
 #include "net/cert/ct_objects_extractor.h"
@@ -26,6 +27,18 @@ namespace net {
 
 namespace {
 
+// The number of SCT signature verification results to remember.
+const size_t kMaxVerifiedSCTs = 256;
+
+// Returns the SHA-256 of |entry| as encoded for signing, or an empty string
+// if it cannot be encoded.
+std::string HashSignedEntry(const ct::SignedEntryData& entry) {
+  std::string encoded_entry;
+  if (!ct::EncodeSignedEntry(entry, &encoded_entry))
+    return std::string();
+  return crypto::SHA256HashString(encoded_entry);
+}
+
 // Record SCT verification status. This metric would help detecting presence
 // of unknown CT logs as well as bad deployments (invalid SCTs).
 void LogSCTStatusToUMA(ct::SCTVerifyStatus status) {
@@ -64,8 +77,8 @@ void AddSCTAndLogStatus(scoped_refptr<ct::SignedCertificateTimestamp> sct,
 
 }  // namespace
 
-MultiLogCTVerifier::MultiLogCTVerifier() : observer_(nullptr) {
-}
+MultiLogCTVerifier::MultiLogCTVerifier()
+    : verified_scts_(kMaxVerifiedSCTs), observer_(nullptr) {}
 
 MultiLogCTVerifier::~MultiLogCTVerifier() = default;
 
@@ -100,7 +113,7 @@ void MultiLogCTVerifier::Verify(
     if (ct::GetPrecertSignedEntry(cert->cert_buffer(),
                                   cert->intermediate_buffers().front().get(),
                                   &precert_entry)) {
-      VerifySCTs(embedded_scts, precert_entry,
+      VerifySCTs(embedded_scts, precert_entry, HashSignedEntry(precert_entry),
                  ct::SignedCertificateTimestamp::SCT_EMBEDDED, cert,
                  output_scts);
     }
@@ -124,11 +137,16 @@ void MultiLogCTVerifier::Verify(
 
   ct::SignedEntryData x509_entry;
   if (ct::GetX509SignedEntry(cert->cert_buffer(), &x509_entry)) {
-    VerifySCTs(sct_list_from_ocsp, x509_entry,
+    // The entry is hashed once for both sources of SCTs over it.
+    std::string x509_entry_hash;
+    if (!sct_list_from_ocsp.empty() || !sct_list_from_tls_extension.empty())
+      x509_entry_hash = HashSignedEntry(x509_entry);
+
+    VerifySCTs(sct_list_from_ocsp, x509_entry, x509_entry_hash,
                ct::SignedCertificateTimestamp::SCT_FROM_OCSP_RESPONSE, cert,
                output_scts);
 
-    VerifySCTs(sct_list_from_tls_extension, x509_entry,
+    VerifySCTs(sct_list_from_tls_extension, x509_entry, x509_entry_hash,
                ct::SignedCertificateTimestamp::SCT_FROM_TLS_EXTENSION, cert,
                output_scts);
   }
@@ -145,6 +163,7 @@ void MultiLogCTVerifier::Verify(
 void MultiLogCTVerifier::VerifySCTs(
     base::StringPiece encoded_sct_list,
     const ct::SignedEntryData& expected_entry,
+    const std::string& entry_hash,
     ct::SignedCertificateTimestamp::Origin origin,
     X509Certificate* cert,
     SignedCertificateTimestampAndStatusList* output_scts) {
@@ -168,13 +187,17 @@ void MultiLogCTVerifier::VerifySCTs(
     }
     decoded_sct->origin = origin;
 
-    VerifySingleSCT(decoded_sct, expected_entry, cert, output_scts);
+    std::string cache_key;
+    if (!entry_hash.empty())
+      cache_key = crypto::SHA256HashString(entry_hash + it->as_string());
+    VerifySingleSCT(decoded_sct, expected_entry, cache_key, cert, output_scts);
   }
 }
 
 bool MultiLogCTVerifier::VerifySingleSCT(
     scoped_refptr<ct::SignedCertificateTimestamp> sct,
     const ct::SignedEntryData& expected_entry,
+    const std::string& cache_key,
     X509Certificate* cert,
     SignedCertificateTimestampAndStatusList* output_scts) {
   // Assume this SCT is untrusted until proven otherwise.
@@ -187,7 +210,7 @@ bool MultiLogCTVerifier::VerifySingleSCT(
 
   sct->log_description = it->second->description();
 
-  if (!it->second->Verify(expected_entry, *sct.get())) {
+  if (!VerifySCTSignature(*it->second, *sct, expected_entry, cache_key)) {
     DVLOG(1) << "Unable to verify SCT signature.";
     AddSCTAndLogStatus(sct, ct::SCT_STATUS_INVALID_SIGNATURE, output_scts);
     return false;
@@ -206,4 +229,21 @@ bool MultiLogCTVerifier::VerifySingleSCT(
   return true;
 }
 
+bool MultiLogCTVerifier::VerifySCTSignature(
+    const CTLogVerifier& log,
+    const ct::SignedCertificateTimestamp& sct,
+    const ct::SignedEntryData& expected_entry,
+    const std::string& cache_key) {
+  if (cache_key.empty())
+    return log.Verify(expected_entry, sct);
+
+  auto cached = verified_scts_.Get(cache_key);
+  if (cached != verified_scts_.end())
+    return cached->second;
+
+  bool verified = log.Verify(expected_entry, sct);
+  verified_scts_.Put(cache_key, verified);
+  return verified;
+}
+
 } // namespace net
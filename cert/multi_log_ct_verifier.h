@@ -8,6 +8,7 @@
 #include <map>
 #include <string>
 
+#include "base/containers/mru_cache.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/strings/string_piece.h"
@@ -47,23 +48,42 @@ class NET_EXPORT MultiLogCTVerifier : public CTVerifier {
   // Verify a list of SCTs from |encoded_sct_list| over |expected_entry|,
   // placing the verification results in |output_scts|. The SCTs in the list
   // come from |origin| (as will be indicated in the origin field of each SCT).
+  // |entry_hash| is the SHA-256 of the encoded |expected_entry|, or empty if
+  // it could not be encoded.
   void VerifySCTs(base::StringPiece encoded_sct_list,
                   const ct::SignedEntryData& expected_entry,
+                  const std::string& entry_hash,
                   ct::SignedCertificateTimestamp::Origin origin,
                   X509Certificate* cert,
                   SignedCertificateTimestampAndStatusList* output_scts);
 
-  // Verifies a single, parsed SCT against all logs.
+  // Verifies a single, parsed SCT against all logs. |cache_key| identifies
+  // the SCT and |expected_entry| in |verified_scts_|, or is empty if the
+  // result must not be cached.
   bool VerifySingleSCT(scoped_refptr<ct::SignedCertificateTimestamp> sct,
                        const ct::SignedEntryData& expected_entry,
+                       const std::string& cache_key,
                        X509Certificate* cert,
                        SignedCertificateTimestampAndStatusList* output_scts);
 
+  // Returns whether the signature of |sct| over |expected_entry| verifies with
+  // |log|, consulting |verified_scts_| first.
+  bool VerifySCTSignature(const CTLogVerifier& log,
+                          const ct::SignedCertificateTimestamp& sct,
+                          const ct::SignedEntryData& expected_entry,
+                          const std::string& cache_key);
+
   // Mapping from a log's ID to the verifier for this log.
   // A log's ID is the SHA-256 of the log's key, as defined in section 3.2.
   // of RFC6962.
   std::map<std::string, scoped_refptr<const CTLogVerifier>> logs_;
 
+  // The outcome of recent SCT signature verifications, keyed by a SHA-256 of
+  // the signed entry hash and the encoded SCT, which includes the log ID. The
+  // same SCTs are presented on every connection to a site, and each check is
+  // a public key operation.
+  base::HashingMRUCache<std::string, bool> verified_scts_;
+
   Observer* observer_;
 
   DISALLOW_COPY_AND_ASSIGN(MultiLogCTVerifier);
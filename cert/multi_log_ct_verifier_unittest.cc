@@ -214,6 +214,28 @@ TEST_F(MultiLogCTVerifierTest, VerifiesSCTOverX509Cert) {
       scts, ct::SignedCertificateTimestamp::SCT_FROM_TLS_EXTENSION));
 }
 
+// Tests that a repeated SCT is verified again over a different certificate,
+// rather than reusing the result for the certificate it was issued for.
+TEST_F(MultiLogCTVerifierTest, RepeatedSCTOverDifferentCert) {
+  std::string sct_list = ct::GetSCTListForTesting();
+
+  for (int i = 0; i < 2; ++i) {
+    SignedCertificateTimestampAndStatusList scts;
+    verifier_->Verify(chain_.get(), base::StringPiece(), sct_list, &scts,
+                      NetLogWithSource());
+    EXPECT_TRUE(ct::CheckForSingleVerifiedSCTInResult(scts, kLogDescription));
+  }
+
+  SignedCertificateTimestampAndStatusList scts;
+  verifier_->Verify(embedded_sct_chain_.get(), base::StringPiece(), sct_list,
+                    &scts, NetLogWithSource());
+  ASSERT_EQ(2U, scts.size());
+  EXPECT_EQ(ct::SCT_STATUS_OK, scts[0].status);
+  EXPECT_EQ(ct::SignedCertificateTimestamp::SCT_EMBEDDED,
+            scts[0].sct->origin);
+  EXPECT_EQ(ct::SCT_STATUS_INVALID_SIGNATURE, scts[1].status);
+}
+
 TEST_F(MultiLogCTVerifierTest, IdentifiesSCTFromUnknownLog) {
   std::string sct_list = ct::GetSCTListWithInvalidSCT();
   SignedCertificateTimestampAndStatusList scts;
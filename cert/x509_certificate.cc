@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/base64.h"
+#include "base/containers/flat_map.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/numerics/safe_conversions.h"
@@ -389,7 +390,7 @@ bool X509Certificate::GetSubjectAltName(
   if (!tbs.has_extensions)
     return false;
 
-  std::map<der::Input, ParsedExtension> extensions;
+  base::flat_map<der::Input, ParsedExtension> extensions;
   if (!ParseExtensions(tbs.extensions_tlv, &extensions))
     return false;
 
@@ -310,7 +310,7 @@ bool CanonicalCookie::IsEquivalentForSecureCookieMatching(
           ecc.IsOnPath(Path()));
 }
 
-bool CanonicalCookie::IsOnPath(const std::string& url_path) const {
+bool CanonicalCookie::IsOnPath(base::StringPiece url_path) const {
 
   // A zero length would be unsafe for our trailing '/' checks, and
   // would also make no sense for our prefix match.  The code that
@@ -345,7 +345,7 @@ bool CanonicalCookie::IsOnPath(const std::string& url_path) const {
   return true;
 }
 
-bool CanonicalCookie::IsDomainMatch(const std::string& host) const {
+bool CanonicalCookie::IsDomainMatch(base::StringPiece host) const {
   // Can domain match in two ways; as a domain cookie (where the cookie
   // domain begins with ".") or as a host cookie (where it doesn't).
 
@@ -368,14 +368,13 @@ bool CanonicalCookie::IsDomainMatch(const std::string& host) const {
     return false;
 
   // The host with a "." prefixed.
-  if (domain_.compare(1, std::string::npos, host) == 0)
+  if (base::StringPiece(domain_).substr(1) == host)
     return true;
 
   // A pure suffix of the host (ok since we know the domain already
   // starts with a ".")
   return (host.length() > domain_.length() &&
-          host.compare(host.length() - domain_.length(),
-                       domain_.length(), domain_) == 0);
+          host.substr(host.length() - domain_.length()) == domain_);
 }
 
 bool CanonicalCookie::IncludeForRequestURL(const GURL& url,
@@ -388,11 +387,13 @@ bool CanonicalCookie::IncludeForRequestURL(const GURL& url,
   if (IsSecure() && !url.SchemeIsCryptographic())
     return false;
   // Don't include cookies for requests that don't apply to the cookie domain.
-  if (!IsDomainMatch(url.host()))
+  // The pieces of |url| are used rather than copies, since this is called for
+  // every cookie of the registrable domain on each request.
+  if (!IsDomainMatch(url.host_piece()))
     return false;
   // Don't include cookies for requests with a url path that does not path
   // match the cookie-path.
-  if (!IsOnPath(url.path()))
+  if (!IsOnPath(url.path_piece()))
     return false;
   // Don't include same-site cookies for cross-site requests.
   switch (SameSite()) {
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/cookies/cookie_constants.h"
@@ -128,11 +129,11 @@ class NET_EXPORT CanonicalCookie {
 
   // Returns true if the given |url_path| path-matches the cookie-path as
   // described in section 5.1.4 in RFC 6265.
-  bool IsOnPath(const std::string& url_path) const;
+  bool IsOnPath(base::StringPiece url_path) const;
 
   // Returns true if the cookie domain matches the given |host| as described in
   // section 5.1.3 of RFC 6265.
-  bool IsDomainMatch(const std::string& host) const;
+  bool IsDomainMatch(base::StringPiece host) const;
 
   // Returns true if the cookie should be included for the given request |url|.
   // HTTP only cookies can be filter by using appropriate cookie |options|.
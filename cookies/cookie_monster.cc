@@ -44,6 +44,7 @@
 
 #include "net/cookies/cookie_monster.h"
 
+#include <algorithm>
 #include <functional>
 #include <set>
 
@@ -201,6 +202,20 @@ typedef std::vector<CanonicalCookie*> CanonicalCookieVector;
 // will update it again.
 const int kDefaultAccessUpdateThresholdSeconds = 60;
 
+// The number of cookie lines GetCookiesWithOptions() keeps for reuse.
+const size_t kMaxCachedCookieLines = 64;
+
+// Returns the key of the cookie line cache for |url| and |options|. The URL's
+// scheme only matters through its security, and is otherwise left out.
+std::string GetCookieLineCacheKey(const GURL& url,
+                                  const CookieOptions& options) {
+  return base::StringPrintf(
+      "%d%d%d%d %s %s", url.SchemeIsCryptographic(),
+      options.exclude_httponly(),
+      static_cast<int>(options.same_site_cookie_mode()),
+      options.update_access_time(), url.host().c_str(), url.path().c_str());
+}
+
 // Comparator to sort cookies from highest creation date to lowest
 // creation date.
 struct OrderByCreationTimeDesc {
@@ -411,7 +426,9 @@ CookieMonster::CookieMonster(PersistentCookieStore* store,
 CookieMonster::CookieMonster(PersistentCookieStore* store,
                              ChannelIDService* channel_id_service,
                              base::TimeDelta last_access_threshold)
-    : initialized_(false),
+    : last_key_version_(0),
+      cookie_line_cache_(kMaxCachedCookieLines),
+      initialized_(false),
       started_fetching_all_cookies_(false),
       finished_fetching_all_cookies_(false),
       fetch_strategy_(kUnknownFetch),
@@ -808,13 +825,42 @@ void CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   std::string cookie_line;
   if (HasCookieableScheme(url)) {
+    const Time current_time(CurrentTime());
+    RecordPeriodicStats(current_time);
+
+    // Reuse the line built for an earlier request with the same URL and
+    // options, unless the cookies of its domain key changed since.
+    const std::string key(GetKey(url.host()));
+    const std::string cache_key(GetCookieLineCacheKey(url, options));
+    auto cached = cookie_line_cache_.Get(cache_key);
+    if (cached != cookie_line_cache_.end() &&
+        cached->second.key_version == GetKeyVersion(key) &&
+        current_time < cached->second.expiry) {
+      MaybeRunCookieCallback(std::move(callback), cached->second.cookie_line);
+      return;
+    }
+
     std::vector<CanonicalCookie*> cookies;
-    FindCookiesForHostAndDomain(url, options, &cookies);
+    FindCookiesForKey(key, url, options, current_time, &cookies);
     std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
     cookie_line = BuildCookieLine(cookies);
 
     VLOG(kVlogGetCookies) << "GetCookies() result: " << cookie_line;
+
+    CachedCookieLine entry;
+    entry.cookie_line = cookie_line;
+    entry.key_version = GetKeyVersion(key);
+    entry.expiry = Time::Max();
+    for (const CanonicalCookie* cookie : cookies) {
+      if (cookie->IsPersistent())
+        entry.expiry = std::min(entry.expiry, cookie->ExpiryDate());
+      if (options.update_access_time()) {
+        entry.expiry = std::min(
+            entry.expiry, cookie->LastAccessDate() + last_access_threshold_);
+      }
+    }
+    cookie_line_cache_.Put(cache_key, std::move(entry));
   }
   MaybeRunCookieCallback(std::move(callback), cookie_line);
 }
@@ -842,7 +888,7 @@ void CookieMonster::DeleteCookie(const GURL& url,
   for (auto* cookie : cookies) {
     if (cookie->Name() != cookie_name)
       continue;
-    if (!cookie->IsOnPath(url.path()))
+    if (!cookie->IsOnPath(url.path_piece()))
       continue;
     matching_cookies.insert(cookie);
   }
@@ -1319,6 +1365,7 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
     store_->AddCookie(*cc_ptr);
   CookieMap::iterator inserted =
       cookies_.insert(CookieMap::value_type(key, std::move(cc)));
+  key_versions_[key] = ++last_key_version_;
 
   // See InitializeHistograms() for details.
   int32_t type_sample = cc_ptr->SameSite() != CookieSameSite::NO_RESTRICTION
@@ -1521,7 +1568,12 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     store_->DeleteCookie(*cc);
   ChangeCausePair mapping = kChangeCauseMapping[deletion_cause];
   RunCookieChangedCallbacks(*cc, mapping.notify, mapping.cause);
+  const std::string key = it->first;
   cookies_.erase(it);
+  if (cookies_.find(key) == cookies_.end())
+    key_versions_.erase(key);
+  else
+    key_versions_[key] = ++last_key_version_;
 }
 
 // Domain expiry behavior is unchanged by key/expiry scheme (the
@@ -1834,6 +1886,12 @@ std::string CookieMonster::GetKey(const std::string& domain) const {
   return effective_domain;
 }
 
+// Keys without cookies aren't in |key_versions_|, and have version 0.
+uint64_t CookieMonster::GetKeyVersion(const std::string& key) const {
+  auto it = key_versions_.find(key);
+  return it == key_versions_.end() ? 0 : it->second;
+}
+
 bool CookieMonster::HasCookieableScheme(const GURL& url) {
   DCHECK(thread_checker_.CalledOnValidThread());
 
@@ -19,6 +19,7 @@
 
 #include "base/callback_forward.h"
 #include "base/containers/circular_deque.h"
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -602,6 +603,10 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // See comment on keys before the CookieMap typedef.
   std::string GetKey(const std::string& domain) const;
 
+  // Returns the version of the cookies stored under |key|, which changes
+  // whenever one of them is inserted or deleted.
+  uint64_t GetKeyVersion(const std::string& key) const;
+
   bool HasCookieableScheme(const GURL& url);
 
   // Statistics support
@@ -644,6 +649,25 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // The version of each key with cookies in |cookies_|. A key without cookies
+  // has version 0.
+  std::map<std::string, uint64_t> key_versions_;
+  uint64_t last_key_version_;
+
+  // A cookie line built by GetCookiesWithOptions().
+  struct CachedCookieLine {
+    std::string cookie_line;
+    // The GetKeyVersion() of the URL's key when the line was built.
+    uint64_t key_version;
+    // The line is rebuilt from this time on, when one of its cookies expires
+    // or is due for an access time update.
+    base::Time expiry;
+  };
+
+  // The cookie lines most recently returned by GetCookiesWithOptions(), keyed
+  // by the host, path and security of the URL, and the options.
+  base::MRUCache<std::string, CachedCookieLine> cookie_line_cache_;
+
   // Indicates whether the cookie store has been initialized.
   bool initialized_;
 
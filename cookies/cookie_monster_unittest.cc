@@ -1549,6 +1549,35 @@ TEST_F(CookieMonsterTest, TestLastAccess) {
   EXPECT_FALSE(last_access_date == GetFirstCookieAccessDate(cm.get()));
 }
 
+// Tests that the cookie lines reused across requests for the same URL follow
+// every change to the cookies of its domain.
+TEST_F(CookieMonsterTest, ReusedCookieLineFollowsChanges) {
+  std::unique_ptr<CookieMonster> cm(new CookieMonster(nullptr));
+  const GURL url = http_www_foo_.url();
+  const GURL other_url(http_www_foo_.Format("http://other.%D/"));
+
+  EXPECT_TRUE(SetCookie(cm.get(), url, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url));
+  EXPECT_EQ("", GetCookies(cm.get(), other_url));
+
+  // A domain cookie set from another host of the same domain.
+  EXPECT_TRUE(SetCookie(cm.get(), other_url,
+                        http_www_foo_.Format("C=D; domain=.%D")));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url));
+  EXPECT_EQ("C=D", GetCookies(cm.get(), other_url));
+
+  DeleteCookie(cm.get(), url, "A");
+  EXPECT_EQ("C=D", GetCookies(cm.get(), url));
+
+  DeleteCookie(cm.get(), other_url, "C");
+  EXPECT_EQ("", GetCookies(cm.get(), url));
+  EXPECT_EQ("", GetCookies(cm.get(), other_url));
+
+  EXPECT_TRUE(SetCookie(cm.get(), url, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url));
+}
+
 TEST_F(CookieMonsterTest, TestHostGarbageCollection) {
   TestHostGarbageCollectHelper();
 }
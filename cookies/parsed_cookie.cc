@@ -44,6 +44,10 @@
 
 #include "net/cookies/parsed_cookie.h"
 
+#include <string.h>
+
+#include <utility>
+
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/strings/string_util.h"
@@ -63,7 +67,7 @@ const char kPriorityTokenName[] = "priority";
 const char kTerminator[] = "\n\r\0";
 const int kTerminatorLen = sizeof(kTerminator) - 1;
 const char kWhitespace[] = " \t";
-const char kValueSeparator[] = ";";
+const char kValueSeparator = ';';
 const char kTokenSeparator[] = ";=";
 
 // Returns true if |c| occurs in |chars|
@@ -89,6 +93,18 @@ inline bool SeekPast(std::string::const_iterator* it,
   }
   return *it == end;
 }
+// Seek the iterator to the first occurrence of |c|, or to |end|. Uses memchr,
+// which scans several characters at a time, as values are the longest part
+// of most cookie lines.
+inline void SeekToChar(std::string::const_iterator* it,
+                       const std::string::const_iterator& end,
+                       char c) {
+  if (*it == end)
+    return;
+  const char* start = &**it;
+  const void* found = memchr(start, c, end - *it);
+  *it = found ? *it + (static_cast<const char*>(found) - start) : end;
+}
 inline bool SeekBackPast(std::string::const_iterator* it,
                          const std::string::const_iterator& end,
                          const char* chars) {
@@ -233,7 +249,7 @@ std::string ParsedCookie::ToCookieLine() const {
 std::string::const_iterator ParsedCookie::FindFirstTerminator(
     const std::string& s) {
   std::string::const_iterator end = s.end();
-  size_t term_pos = s.find_first_of(std::string(kTerminator, kTerminatorLen));
+  size_t term_pos = s.find_first_of(kTerminator, 0, kTerminatorLen);
   if (term_pos != std::string::npos) {
     // We found a character we should treat as an end of string.
     end = s.begin() + term_pos;
@@ -292,7 +308,7 @@ void ParsedCookie::ParseValue(std::string::const_iterator* it,
 
   // Just look for ';' to terminate ('=' allowed).
   // We can hit the end, maybe they didn't terminate.
-  SeekTo(it, end, kValueSeparator);
+  SeekToChar(it, end, kValueSeparator);
 
   // Will be pointed at the ; seperator or the end.
   *value_end = *it;
@@ -402,8 +418,10 @@ void ParsedCookie::ParseTokenValuePairs(const std::string& cookie_line) {
     pair.second = std::string(value_start, value_end);
 
     // From RFC2109: "Attributes (names) (attr) are case-insensitive."
-    if (pair_num != 0)
-      pair.first = base::ToLowerASCII(pair.first);
+    if (pair_num != 0) {
+      for (char& c : pair.first)
+        c = base::ToLowerASCII(c);
+    }
     // Ignore Set-Cookie directives contaning control characters. See
     // http://crbug.com/238041.
     if (!IsValidCookieAttributeValue(pair.first) ||
@@ -412,7 +430,7 @@ void ParsedCookie::ParseTokenValuePairs(const std::string& cookie_line) {
       break;
     }
 
-    pairs_.push_back(pair);
+    pairs_.push_back(std::move(pair));
 
     // We've processed a token/value pair, we're either at the end of
     // the string or a ValueSeparator like ';', which we want to skip.
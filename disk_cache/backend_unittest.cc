@@ -1036,6 +1036,42 @@ TEST_F(DiskCacheBackendTest, MemoryOnlySetSize) {
   BackendSetSize();
 }
 
+// Tests that a backend created without kNoRandom trims the cache from a posted
+// task, rather than inline, once an entry over the limit is closed.
+TEST_F(DiskCacheBackendTest, TrimOnCloseIsPosted) {
+  const int cache_size = 0x10000;  // 64 kB
+  SetMaxSize(cache_size);
+  ASSERT_TRUE(CleanupCacheDir());
+  UseCurrentThread();
+  CreateBackend(disk_cache::kNoBuffering);
+
+  // Entries closed early in the life of the backend don't trim the cache.
+  // Run the stats timer past that delay of ten ticks.
+  ASSERT_TRUE(cache_impl_->GetTimerForTest());
+  for (int i = 0; i < 11; ++i)
+    cache_impl_->GetTimerForTest()->user_task().Run();
+
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(cache_size));
+  memset(buffer->data(), 0, cache_size);
+  for (int i = 0; i < 12; ++i) {
+    disk_cache::Entry* entry;
+    ASSERT_THAT(CreateEntry(base::StringPrintf("key %d", i), &entry), IsOk());
+    EXPECT_EQ(cache_size / 10,
+              WriteData(entry, 0, 0, buffer.get(), cache_size / 10, false));
+    entry->Close();
+  }
+
+  // Running the posted trim brings the cache back under its limit, evicting
+  // the oldest entry.
+  FlushQueueForTest();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_LE(CalculateSizeOfAllEntries(), cache_size);
+  disk_cache::Entry* entry;
+  EXPECT_NE(net::OK, OpenEntry("key 0", &entry));
+  ASSERT_THAT(OpenEntry("key 11", &entry), IsOk());
+  entry->Close();
+}
+
 void DiskCacheBackendTest::BackendLoad() {
   InitCache();
   int seed = static_cast<int>(Time::Now().ToInternalValue());
@@ -2061,6 +2097,41 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyCalculateSizeOfAllEntries) {
   BackendCalculateSizeOfAllEntries();
 }
 
+// Tests that the size of an entry appended to across reopens only counts its
+// data, whether or not closing it released the spare capacity of its streams.
+TEST_F(DiskCacheBackendTest, MemoryOnlySizeOfReopenedEntry) {
+  SetMemoryOnlyMode();
+  InitCache();
+
+  const int kChunkSize = 1000;
+  const int kNumChunks = 10;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kChunkSize));
+  CacheTestFillBuffer(buffer->data(), kChunkSize, false);
+  const std::string key("the first key");
+  disk_cache::Entry* entry;
+  ASSERT_THAT(CreateEntry(key, &entry), IsOk());
+  for (int i = 0; i < kNumChunks; ++i) {
+    ASSERT_EQ(kChunkSize, WriteData(entry, 1, i * kChunkSize, buffer.get(),
+                                    kChunkSize, false));
+    entry->Close();
+    EXPECT_EQ((i + 1) * kChunkSize + GetEntryMetadataSize(key),
+              CalculateSizeOfAllEntries());
+
+    ASSERT_THAT(OpenEntry(key, &entry), IsOk());
+    EXPECT_EQ((i + 1) * kChunkSize, entry->GetDataSize(1));
+  }
+
+  // The last chunk survived the shrinks.
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kChunkSize));
+  EXPECT_EQ(kChunkSize, ReadData(entry, 1, (kNumChunks - 1) * kChunkSize,
+                                 read_buffer.get(), kChunkSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), kChunkSize));
+  entry->Close();
+
+  ASSERT_THAT(DoomAllEntries(), IsOk());
+  EXPECT_EQ(0, CalculateSizeOfAllEntries());
+}
+
 TEST_F(DiskCacheBackendTest, SimpleCacheCalculateSizeOfAllEntries) {
   // Use net::APP_CACHE to make size estimations deterministic via
   // non-optimistic writes.
@@ -914,8 +914,15 @@ void BackendImpl::OnEntryDestroyBegin(Addr address) {
 void BackendImpl::OnEntryDestroyEnd() {
   DecreaseNumRefs();
   if (data_->header.num_bytes > max_size_ && !read_only_ &&
-      (up_ticks_ > kTrimDelay || user_flags_ & kNoRandom))
-    eviction_.TrimCache(false);
+      (up_ticks_ > kTrimDelay || user_flags_ & kNoRandom)) {
+    // The entry may be released while serving a request, which should not
+    // wait for a burst of evictions. Tests expect to see the cache trimmed as
+    // soon as the entry is closed.
+    if (user_flags_ & kNoRandom)
+      eviction_.TrimCache(false);
+    else
+      eviction_.TrimCacheSoon();
+  }
 }
 
 EntryImpl* BackendImpl::GetOpenEntry(CacheRankingsBlock* rankings) const {
@@ -99,6 +99,7 @@ void Eviction::Init(BackendImpl* backend) {
   first_trim_ = true;
   trimming_ = false;
   delay_trim_ = false;
+  pending_trim_ = false;
   trim_delays_ = 0;
   init_ = true;
   test_mode_ = false;
@@ -172,6 +173,16 @@ void Eviction::TrimCache(bool empty) {
   return;
 }
 
+void Eviction::TrimCacheSoon() {
+  // Prevent posting multiple tasks.
+  if (pending_trim_)
+    return;
+  pending_trim_ = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&Eviction::PendingTrim, ptr_factory_.GetWeakPtr()));
+}
+
 void Eviction::UpdateRank(EntryImpl* entry, bool modified) {
   if (new_eviction_)
     return UpdateRankV2(entry, modified);
@@ -234,6 +245,11 @@ void Eviction::DelayedTrim() {
   TrimCache(false);
 }
 
+void Eviction::PendingTrim() {
+  pending_trim_ = false;
+  TrimCache(false);
+}
+
 bool Eviction::ShouldTrim() {
   if (!FallingBehind(header_->num_bytes, max_size_) &&
       trim_delays_ < kMaxDelayedTrims && backend_->IsLoaded()) {
@@ -30,6 +30,10 @@ class Eviction {
   // use.
   void TrimCache(bool empty);
 
+  // Posts a task to TrimCache(false), so that the caller does not wait for the
+  // evictions.
+  void TrimCacheSoon();
+
   // Updates the ranking information for an entry.
   void UpdateRank(EntryImpl* entry, bool modified);
 
@@ -46,6 +50,7 @@ class Eviction {
  private:
   void PostDelayedTrim();
   void DelayedTrim();
+  void PendingTrim();
   bool ShouldTrim();
   bool ShouldTrimDeleted();
   void ReportTrimTimes(EntryImpl* entry);
@@ -79,6 +84,7 @@ class Eviction {
   bool first_trim_;
   bool trimming_;
   bool delay_trim_;
+  bool pending_trim_;
   bool init_;
   bool test_mode_;
   base::WeakPtrFactory<Eviction> ptr_factory_;
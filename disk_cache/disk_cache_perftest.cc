@@ -2,24 +2,34 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/barrier_closure.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/command_line.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
+#include "base/files/file_util.h"
 #include "base/hash.h"
+#include "base/logging.h"
 #include "base/process/process_metrics.h"
 #include "base/rand_util.h"
 #include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/test/perf_time_logger.h"
 #include "base/test/scoped_task_environment.h"
 #include "base/test/test_file_util.h"
 #include "base/threading/thread.h"
+#include "base/timer/elapsed_timer.h"
 #include "net/base/cache_type.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
@@ -51,6 +61,121 @@ struct TestEntry {
   int data_len;
 };
 
+// The command line switch naming a trace file for the TraceReplay tests.
+const char kTraceFileSwitch[] = "disk-cache-trace";
+
+// One operation of a recorded workload. Traces are text files with one
+// operation per line:
+//   open|create|close|doom <key>
+//   read|write <key> <stream> <offset> <length>
+struct TraceOperation {
+  enum Type { OPEN, CREATE, CLOSE, DOOM, READ, WRITE, NUM_TYPES };
+
+  Type type;
+  std::string key;
+  int stream;
+  int offset;
+  int length;
+};
+
+const char* const kTraceOperationNames[TraceOperation::NUM_TYPES] = {
+    "open", "create", "close", "doom", "read", "write"};
+
+bool ParseTraceOperation(const std::string& line, TraceOperation* operation) {
+  std::vector<std::string> tokens = base::SplitString(
+      line, " ", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (tokens.size() != 2 && tokens.size() != 5)
+    return false;
+  const char* const* name =
+      std::find(std::begin(kTraceOperationNames),
+                std::end(kTraceOperationNames), tokens[0]);
+  if (name == std::end(kTraceOperationNames))
+    return false;
+  operation->type = static_cast<TraceOperation::Type>(
+      name - std::begin(kTraceOperationNames));
+  operation->key = tokens[1];
+  operation->stream = operation->offset = operation->length = 0;
+
+  bool has_data = operation->type == TraceOperation::READ ||
+                  operation->type == TraceOperation::WRITE;
+  if (tokens.size() == 2)
+    return !has_data;
+  return has_data && base::StringToInt(tokens[2], &operation->stream) &&
+         operation->stream >= 0 && operation->stream < 3 &&
+         base::StringToInt(tokens[3], &operation->offset) &&
+         operation->offset >= 0 &&
+         base::StringToInt(tokens[4], &operation->length) &&
+         operation->length >= 0;
+}
+
+// Builds a workload of entries created, read back with a skewed popularity,
+// and sometimes doomed, for when no trace file is given.
+std::vector<TraceOperation> GenerateTrace(int num_keys, int num_entry_uses) {
+  const int kHeadersSize = 800;
+  const int kMaxBodySize = 64 * 1024;
+
+  std::vector<TraceOperation> trace;
+  std::map<std::string, int> body_sizes;
+  for (int i = 0; i < num_entry_uses; ++i) {
+    // The product of two uniform picks favors the low-numbered keys.
+    int key_index =
+        base::RandInt(0, num_keys - 1) * base::RandInt(0, num_keys - 1) /
+        num_keys;
+    std::string key = "key" + base::IntToString(key_index);
+    auto body_size = body_sizes.find(key);
+    if (body_size == body_sizes.end()) {
+      int size = base::RandInt(0, kMaxBodySize);
+      body_sizes[key] = size;
+      trace.push_back({TraceOperation::CREATE, key, 0, 0, 0});
+      trace.push_back({TraceOperation::WRITE, key, 0, 0, kHeadersSize});
+      trace.push_back({TraceOperation::WRITE, key, 1, 0, size});
+      trace.push_back({TraceOperation::CLOSE, key, 0, 0, 0});
+    } else if (base::RandInt(0, 19) == 0) {
+      body_sizes.erase(body_size);
+      trace.push_back({TraceOperation::DOOM, key, 0, 0, 0});
+    } else {
+      trace.push_back({TraceOperation::OPEN, key, 0, 0, 0});
+      trace.push_back({TraceOperation::READ, key, 0, 0, kHeadersSize});
+      trace.push_back({TraceOperation::READ, key, 1, 0, body_size->second});
+      trace.push_back({TraceOperation::CLOSE, key, 0, 0, 0});
+    }
+  }
+  return trace;
+}
+
+// Reads the trace named on the command line, or generates one.
+bool GetTrace(std::vector<TraceOperation>* trace) {
+  base::FilePath trace_path =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          kTraceFileSwitch);
+  if (trace_path.empty()) {
+    *trace = GenerateTrace(2000, 20000);
+    return true;
+  }
+
+  std::string contents;
+  if (!base::ReadFileToString(trace_path, &contents))
+    return false;
+  for (const std::string& line : base::SplitString(
+           contents, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    TraceOperation operation;
+    if (!ParseTraceOperation(line, &operation)) {
+      LOG(ERROR) << "Invalid trace line: " << line;
+      return false;
+    }
+    trace->push_back(operation);
+  }
+  return true;
+}
+
+// Returns the |percentile|th percentile of the sorted |values|.
+double Percentile(const std::vector<double>& values, int percentile) {
+  if (values.empty())
+    return 0;
+  size_t index = (values.size() - 1) * percentile / 100;
+  return values[index];
+}
+
 class DiskCachePerfTest : public DiskCacheTestWithCache {
  public:
   DiskCachePerfTest()
@@ -78,6 +203,7 @@ class DiskCachePerfTest : public DiskCacheTestWithCache {
 
   // Complete perf tests.
   void CacheBackendPerformance();
+  void TraceReplay(const char* backend_name);
 
   const size_t kFdLimitForCacheTests = 8192;
 
@@ -258,6 +384,127 @@ void DiskCachePerfTest::CacheBackendPerformance() {
   base::RunLoop().RunUntilIdle();
 }
 
+// Replays a trace against the backend, timing each operation until its
+// completion. Reads and writes of entries which the trace did not open or
+// create, for example because a create failed, are skipped.
+void DiskCachePerfTest::TraceReplay(const char* backend_name) {
+  std::vector<TraceOperation> trace;
+  ASSERT_TRUE(GetTrace(&trace));
+
+  int max_length = 1;
+  for (const TraceOperation& operation : trace)
+    max_length = std::max(max_length, operation.length);
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(max_length));
+  CacheTestFillBuffer(buffer->data(), max_length, false);
+
+  InitCache();
+  std::unique_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateCurrentProcessMetrics());
+  base::IoCounters io_counters_before;
+  bool has_io_counters = metrics->GetIOCounters(&io_counters_before);
+
+  std::map<std::string, disk_cache::Entry*> open_entries;
+  std::vector<double> latencies_us[TraceOperation::NUM_TYPES];
+  int failures = 0;
+  int skipped = 0;
+  base::ElapsedTimer replay_timer;
+  for (const TraceOperation& operation : trace) {
+    auto open_entry = open_entries.find(operation.key);
+    disk_cache::Entry* entry =
+        open_entry != open_entries.end() ? open_entry->second : nullptr;
+    bool opens_entry = operation.type == TraceOperation::OPEN ||
+                       operation.type == TraceOperation::CREATE;
+    bool needs_entry = !opens_entry && operation.type != TraceOperation::DOOM;
+    if ((opens_entry && entry) || (needs_entry && !entry)) {
+      ++skipped;
+      continue;
+    }
+
+    net::TestCompletionCallback cb;
+    base::ElapsedTimer timer;
+    int rv = net::OK;
+    int expected_rv = net::OK;
+    switch (operation.type) {
+      case TraceOperation::OPEN:
+        rv = cb.GetResult(
+            cache_->OpenEntry(operation.key, &entry, cb.callback()));
+        break;
+      case TraceOperation::CREATE:
+        rv = cb.GetResult(
+            cache_->CreateEntry(operation.key, &entry, cb.callback()));
+        break;
+      case TraceOperation::CLOSE:
+        entry->Close();
+        open_entries.erase(open_entry);
+        break;
+      case TraceOperation::DOOM:
+        rv = cb.GetResult(cache_->DoomEntry(operation.key, cb.callback()));
+        break;
+      case TraceOperation::READ:
+        rv = cb.GetResult(entry->ReadData(operation.stream, operation.offset,
+                                          buffer.get(), operation.length,
+                                          cb.callback()));
+        expected_rv = operation.length;
+        break;
+      case TraceOperation::WRITE:
+        rv = cb.GetResult(entry->WriteData(operation.stream, operation.offset,
+                                           buffer.get(), operation.length,
+                                           cb.callback(), false));
+        expected_rv = operation.length;
+        break;
+      case TraceOperation::NUM_TYPES:
+        NOTREACHED();
+        break;
+    }
+    latencies_us[operation.type].push_back(timer.Elapsed().InMicrosecondsF());
+    if (rv != expected_rv)
+      ++failures;
+    if (opens_entry && rv == net::OK)
+      open_entries[operation.key] = entry;
+  }
+  for (const auto& open_entry : open_entries)
+    open_entry.second->Close();
+  disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+  base::RunLoop().RunUntilIdle();
+  double replay_seconds = replay_timer.Elapsed().InSecondsF();
+
+  LOG(ERROR) << backend_name << ": replayed " << trace.size()
+             << " operations in " << replay_seconds << " s ("
+             << trace.size() / std::max(replay_seconds, 1e-6)
+             << " operations/s), " << failures << " failed, " << skipped
+             << " skipped";
+  for (int type = 0; type < TraceOperation::NUM_TYPES; ++type) {
+    std::vector<double>& latencies = latencies_us[type];
+    if (latencies.empty())
+      continue;
+    std::sort(latencies.begin(), latencies.end());
+    LOG(ERROR) << "\t" << kTraceOperationNames[type] << " x"
+               << latencies.size() << ": p50 " << Percentile(latencies, 50)
+               << " us, p90 " << Percentile(latencies, 90) << " us, p99 "
+               << Percentile(latencies, 99) << " us";
+  }
+  base::IoCounters io_counters_after;
+  if (has_io_counters && metrics->GetIOCounters(&io_counters_after)) {
+    LOG(ERROR) << "\tBytes written: "
+               << io_counters_after.WriteTransferCount -
+                      io_counters_before.WriteTransferCount;
+  }
+}
+
+TEST_F(DiskCachePerfTest, TraceReplayBlockfile) {
+  TraceReplay("Blockfile");
+}
+
+TEST_F(DiskCachePerfTest, TraceReplaySimple) {
+  SetSimpleCacheMode();
+  TraceReplay("Simple");
+}
+
+TEST_F(DiskCachePerfTest, TraceReplayMemory) {
+  SetMemoryOnlyMode();
+  TraceReplay("Memory");
+}
+
 TEST_F(DiskCachePerfTest, CacheBackendPerformance) {
   CacheBackendPerformance();
 }
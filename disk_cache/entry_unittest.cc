@@ -4677,6 +4677,52 @@ TEST_F(DiskCacheSimplePrefetchTest, YesPrefetch) {
       "SimpleCache.Http.ReadStream1FromPrefetched", true, 1);
 }
 
+// Small entries are prefetched without the experiment.
+TEST_F(DiskCacheSimplePrefetchTest, DefaultPrefetch) {
+  base::HistogramTester histogram_tester;
+  ASSERT_GE(disk_cache::kDefaultSimpleCachePrefetchSize, 2 * kEntrySize);
+
+  const char kKey[] = "a key";
+  InitCacheAndCreateEntry(kKey);
+  TryRead(kKey);
+
+  histogram_tester.ExpectUniqueSample("SimpleCache.Http.SyncOpenDidPrefetch",
+                                      true, 1);
+  histogram_tester.ExpectUniqueSample(
+      "SimpleCache.Http.ReadStream1FromPrefetched", true, 1);
+}
+
+// Entries too large to be prefetched have their end prefetched instead, which
+// holds stream 0 unless it is large as well.
+TEST_F(DiskCacheSimplePrefetchTest, TrailerPrefetch) {
+  base::HistogramTester histogram_tester;
+  SetupPrefetch(kEntrySize / 2);
+
+  const char kKey[] = "a key";
+  const char kLargeKey[] = "a key with a large stream 0";
+  InitCacheAndCreateEntry(kKey);
+
+  disk_cache::Entry* entry = nullptr;
+  ASSERT_THAT(CreateEntry(kLargeKey, &entry), IsOk());
+  ASSERT_EQ(kEntrySize,
+            WriteData(entry, 0, 0, payload_.get(), kEntrySize, false));
+  ASSERT_EQ(kEntrySize,
+            WriteData(entry, 1, 0, payload_.get(), kEntrySize, false));
+  entry->Close();
+
+  TryRead(kKey);
+  TryRead(kLargeKey);
+
+  ASSERT_THAT(OpenEntry(kLargeKey, &entry), IsOk());
+  scoped_refptr<net::IOBuffer> read_buf(new net::IOBuffer(kEntrySize));
+  EXPECT_EQ(kEntrySize, ReadData(entry, 0, 0, read_buf.get(), kEntrySize));
+  EXPECT_EQ(0, memcmp(read_buf->data(), payload_->data(), kEntrySize));
+  entry->Close();
+
+  histogram_tester.ExpectUniqueSample("SimpleCache.Http.SyncOpenDidPrefetch",
+                                      false, 3);
+}
+
 TEST_F(DiskCacheSimplePrefetchTest, YesPrefetchNoRead) {
   base::HistogramTester histogram_tester;
   SetupPrefetch(2 * kEntrySize);
@@ -157,8 +157,15 @@ void MemEntryImpl::Close() {
   DCHECK_EQ(PARENT_ENTRY, type());
   --ref_count_;
   DCHECK_GE(ref_count_, 0);
-  if (!ref_count_ && doomed_)
+  if (ref_count_)
+    return;
+  if (doomed_) {
     delete this;
+    return;
+  }
+  // Streams grow geometrically as they are appended to, but are usually not
+  // written again once the entry is closed.
+  ShrinkData();
 }
 
 std::string MemEntryImpl::GetKey() const {
@@ -621,4 +628,20 @@ int MemEntryImpl::FindNextChild(int64_t offset, int len, MemEntryImpl** child) {
   return scanned_len;
 }
 
+void MemEntryImpl::ShrinkData() {
+  // Shrinking copies the stream, and an entry appended to again after it's
+  // reopened grows back. Only shrink streams that waste more than they hold,
+  // so that repeated append and close cycles stay linear.
+  for (auto& stream : data_) {
+    if (stream.capacity() > 2 * stream.size())
+      stream.shrink_to_fit();
+  }
+  if (!children_)
+    return;
+  for (const auto& child : *children_) {
+    if (child.second != this)
+      child.second->ShrinkData();
+  }
+}
+
 }  // namespace disk_cache
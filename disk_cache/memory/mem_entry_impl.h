@@ -170,6 +170,11 @@ class NET_EXPORT_PRIVATE MemEntryImpl final
   // bytes in the entry. The first child found is output to |child|.
   int FindNextChild(int64_t offset, int len, MemEntryImpl** child);
 
+  // Releases the capacity of the streams of this entry and of its children
+  // beyond their sizes, which is not accounted for in the storage size, when
+  // it is more than their sizes.
+  void ShrinkData();
+
   std::string key_;
   std::vector<char> data_[kNumStreams];  // User data.
   int ref_count_;
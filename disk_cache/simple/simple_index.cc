@@ -51,6 +51,9 @@ const uint32_t kEvictionMarginDivisor = 20;
 
 const uint32_t kBytesInKb = 1024;
 
+// The smallest number of slots of a non-empty SimpleIndexEntrySet.
+const size_t kMinEntrySetSlots = 16;
+
 // This is added to the size of each entry before using the size
 // to determine which entries to evict first. It's basically an
 // estimate of the filesystem overhead, but it also serves to flatten
@@ -142,6 +145,133 @@ bool EntryMetadata::Deserialize(base::PickleIterator* it,
   return true;
 }
 
+SimpleIndexEntrySet::SimpleIndexEntrySet()
+    : size_(0), zero_hash_entry_(), has_zero_hash_entry_(false) {}
+
+SimpleIndexEntrySet::SimpleIndexEntrySet(const SimpleIndexEntrySet& other) =
+    default;
+
+SimpleIndexEntrySet::~SimpleIndexEntrySet() = default;
+
+SimpleIndexEntrySet& SimpleIndexEntrySet::operator=(
+    const SimpleIndexEntrySet& other) = default;
+
+std::pair<SimpleIndexEntrySet::iterator, bool> SimpleIndexEntrySet::insert(
+    const value_type& value) {
+  if (value.first == 0) {
+    bool inserted = !has_zero_hash_entry_;
+    if (inserted) {
+      zero_hash_entry_ = value;
+      has_zero_hash_entry_ = true;
+      ++size_;
+    }
+    return std::make_pair(iterator(this, zero_hash_index()), inserted);
+  }
+
+  reserve(size_ + 1);
+  const size_t mask = slots_.size() - 1;
+  size_t index = value.first & mask;
+  while (slots_[index].first != 0) {
+    if (slots_[index].first == value.first)
+      return std::make_pair(iterator(this, index), false);
+    index = (index + 1) & mask;
+  }
+  slots_[index] = value;
+  ++size_;
+  return std::make_pair(iterator(this, index), true);
+}
+
+void SimpleIndexEntrySet::erase(iterator it) {
+  DCHECK_EQ(this, it.set_);
+  DCHECK(IsOccupied(it.index_));
+  --size_;
+  if (it.index_ == zero_hash_index()) {
+    has_zero_hash_entry_ = false;
+    zero_hash_entry_ = value_type();
+    return;
+  }
+
+  // Moves back the entries following the erased one, so that no entry is
+  // separated from its home slot by an empty slot.
+  const size_t mask = slots_.size() - 1;
+  size_t hole = it.index_;
+  for (size_t next = (hole + 1) & mask; slots_[next].first != 0;
+       next = (next + 1) & mask) {
+    size_t home = slots_[next].first & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      slots_[hole] = slots_[next];
+      hole = next;
+    }
+  }
+  slots_[hole] = value_type();
+}
+
+size_t SimpleIndexEntrySet::erase(uint64_t hash) {
+  iterator it = find(hash);
+  if (it == end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+void SimpleIndexEntrySet::clear() {
+  std::vector<value_type>().swap(slots_);
+  size_ = 0;
+  zero_hash_entry_ = value_type();
+  has_zero_hash_entry_ = false;
+}
+
+void SimpleIndexEntrySet::reserve(size_t count) {
+  if (count * 4 <= slots_.size() * 3)
+    return;
+  size_t slot_count = std::max(kMinEntrySetSlots, slots_.size());
+  while (count * 4 > slot_count * 3)
+    slot_count *= 2;
+  Rehash(slot_count);
+}
+
+void SimpleIndexEntrySet::swap(SimpleIndexEntrySet& other) {
+  slots_.swap(other.slots_);
+  std::swap(size_, other.size_);
+  std::swap(zero_hash_entry_, other.zero_hash_entry_);
+  std::swap(has_zero_hash_entry_, other.has_zero_hash_entry_);
+}
+
+size_t SimpleIndexEntrySet::EstimateMemoryUsage() const {
+  return slots_.capacity() * sizeof(value_type);
+}
+
+size_t SimpleIndexEntrySet::FindIndex(uint64_t hash) const {
+  if (hash == 0)
+    return has_zero_hash_entry_ ? zero_hash_index() : end_index();
+  if (slots_.empty())
+    return end_index();
+
+  const size_t mask = slots_.size() - 1;
+  for (size_t index = hash & mask; slots_[index].first != 0;
+       index = (index + 1) & mask) {
+    if (slots_[index].first == hash)
+      return index;
+  }
+  return end_index();
+}
+
+void SimpleIndexEntrySet::Rehash(size_t slot_count) {
+  DCHECK_EQ(0u, slot_count & (slot_count - 1));
+  std::vector<value_type> old_slots(slot_count);
+  old_slots.swap(slots_);
+
+  const size_t mask = slot_count - 1;
+  for (const value_type& value : old_slots) {
+    if (value.first == 0)
+      continue;
+    size_t index = value.first & mask;
+    while (slots_[index].first != 0)
+      index = (index + 1) & mask;
+    slots_[index] = value;
+  }
+}
+
 SimpleIndex::SimpleIndex(
     const scoped_refptr<base::SingleThreadTaskRunner>& io_thread,
     scoped_refptr<BackendCleanupTracker> cleanup_tracker,
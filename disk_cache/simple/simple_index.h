@@ -5,12 +5,13 @@
 #ifndef NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_H_
 #define NET_DISK_CACHE_SIMPLE_SIMPLE_INDEX_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <list>
 #include <memory>
-#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
@@ -91,6 +92,135 @@ class NET_EXPORT_PRIVATE EntryMetadata {
 };
 static_assert(sizeof(EntryMetadata) == 8, "incorrect metadata size");
 
+// The set of entries of a SimpleIndex, mapping entry hashes to their metadata.
+// Entries are kept in a single open-addressing table with linear probing, so
+// that each of them only takes the 16 bytes of its hash and metadata, without
+// the node and bucket allocations of std::unordered_map. Entry hashes are
+// already uniformly distributed, so their low bits are used as the slot index.
+//
+// The hash 0 marks empty slots; an entry with that hash is kept aside. As with
+// std::unordered_map, insertions invalidate all iterators; erasing an entry
+// invalidates the iterators to other entries as well, since the entries after
+// it may be moved back to fill its slot.
+class NET_EXPORT_PRIVATE SimpleIndexEntrySet {
+ public:
+  using key_type = uint64_t;
+  using mapped_type = EntryMetadata;
+  // Unlike std::unordered_map, the hash of an entry is not const, so that
+  // entries can be moved between slots. It must not be modified in place.
+  using value_type = std::pair<uint64_t, EntryMetadata>;
+
+  template <typename SetType, typename ValueType>
+  class IteratorImpl {
+   public:
+    IteratorImpl(SetType* set, size_t index) : set_(set), index_(index) {
+      SkipEmptySlots();
+    }
+    // Allows converting an iterator to a const_iterator.
+    template <typename OtherSetType, typename OtherValueType>
+    IteratorImpl(const IteratorImpl<OtherSetType, OtherValueType>& other)
+        : set_(other.set_), index_(other.index_) {}
+
+    ValueType& operator*() const { return set_->slot(index_); }
+    ValueType* operator->() const { return &set_->slot(index_); }
+
+    IteratorImpl& operator++() {
+      ++index_;
+      SkipEmptySlots();
+      return *this;
+    }
+
+    bool operator==(const IteratorImpl& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const IteratorImpl& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    friend class SimpleIndexEntrySet;
+    template <typename, typename>
+    friend class IteratorImpl;
+
+    void SkipEmptySlots() {
+      while (index_ < set_->end_index() && !set_->IsOccupied(index_))
+        ++index_;
+    }
+
+    SetType* set_;
+    size_t index_;
+  };
+
+  using iterator = IteratorImpl<SimpleIndexEntrySet, value_type>;
+  using const_iterator =
+      IteratorImpl<const SimpleIndexEntrySet, const value_type>;
+
+  SimpleIndexEntrySet();
+  SimpleIndexEntrySet(const SimpleIndexEntrySet& other);
+  ~SimpleIndexEntrySet();
+
+  SimpleIndexEntrySet& operator=(const SimpleIndexEntrySet& other);
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, end_index()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, end_index()); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator find(uint64_t hash) { return iterator(this, FindIndex(hash)); }
+  const_iterator find(uint64_t hash) const {
+    return const_iterator(this, FindIndex(hash));
+  }
+  size_t count(uint64_t hash) const {
+    return FindIndex(hash) != end_index() ? 1 : 0;
+  }
+
+  // Inserts |value| unless there already is an entry for its hash. Returns an
+  // iterator to the entry for the hash, and whether |value| was inserted.
+  std::pair<iterator, bool> insert(const value_type& value);
+
+  void erase(iterator it);
+  size_t erase(uint64_t hash);
+
+  void clear();
+  // Makes room for |count| entries without rehashing.
+  void reserve(size_t count);
+  void swap(SimpleIndexEntrySet& other);
+
+  size_t EstimateMemoryUsage() const;
+
+ private:
+  // The index past the last slot, at which the entry with hash 0 is kept.
+  size_t zero_hash_index() const { return slots_.size(); }
+  size_t end_index() const { return slots_.size() + 1; }
+
+  bool IsOccupied(size_t index) const {
+    return index < slots_.size() ? slots_[index].first != 0
+                                 : has_zero_hash_entry_;
+  }
+  value_type& slot(size_t index) {
+    return index < slots_.size() ? slots_[index] : zero_hash_entry_;
+  }
+  const value_type& slot(size_t index) const {
+    return index < slots_.size() ? slots_[index] : zero_hash_entry_;
+  }
+
+  // Returns the index of the entry for |hash|, or end_index().
+  size_t FindIndex(uint64_t hash) const;
+
+  // Moves the entries to a table of |slot_count| slots, a power of two.
+  void Rehash(size_t slot_count);
+
+  // Either empty or a power of two slots, at most three quarters of which are
+  // occupied.
+  std::vector<value_type> slots_;
+  size_t size_;
+  value_type zero_hash_entry_;
+  bool has_zero_hash_entry_;
+};
+
 // This class is not Thread-safe.
 class NET_EXPORT_PRIVATE SimpleIndex
     : public base::SupportsWeakPtr<SimpleIndex> {
@@ -147,7 +277,7 @@ class NET_EXPORT_PRIVATE SimpleIndex
   bool UpdateEntrySize(uint64_t entry_hash,
                        base::StrictNumeric<uint32_t> entry_size);
 
-  using EntrySet = std::unordered_map<uint64_t, EntryMetadata>;
+  using EntrySet = SimpleIndexEntrySet;
 
   static void InsertInEntrySet(uint64_t entry_hash,
                                const EntryMetadata& entry_metadata,
@@ -455,42 +455,60 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 }
 
 // static
-void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
-                                       base::Time* out_last_cache_seen_by_index,
-                                       SimpleIndexLoadResult* out_result) {
+bool SimpleIndexFile::ReadIndexFile(const base::FilePath& index_filename,
+                                    base::Time* out_last_cache_seen_by_index,
+                                    SimpleIndexLoadResult* out_result) {
   out_result->Reset();
 
   File file(index_filename, File::FLAG_OPEN | File::FLAG_READ |
                                 File::FLAG_SHARE_DELETE |
                                 File::FLAG_SEQUENTIAL_SCAN);
   if (!file.IsValid())
-    return;
+    return true;
 
   // Sanity-check the length. We don't want to crash trying to read some corrupt
   // 10GiB file or such.
   int64_t file_length = file.GetLength();
-  if (file_length < 0 || file_length > kMaxIndexFileSizeBytes) {
-    simple_util::SimpleCacheDeleteFile(index_filename);
-    return;
-  }
+  if (file_length < 0 || file_length > kMaxIndexFileSizeBytes)
+    return false;
 
   // Make sure to preallocate in one chunk, so we don't induce fragmentation
   // reallocating a growing buffer.
   auto buffer = std::make_unique<char[]>(file_length);
 
   int read = file.Read(0, buffer.get(), file_length);
-  if (read < file_length) {
-    simple_util::SimpleCacheDeleteFile(index_filename);
-    return;
-  }
+  if (read < file_length)
+    return false;
 
   SimpleIndexFile::Deserialize(buffer.get(), read, out_last_cache_seen_by_index,
                                out_result);
+  return out_result->did_load;
+}
 
-  if (!out_result->did_load)
+// static
+void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
+                                       base::Time* out_last_cache_seen_by_index,
+                                       SimpleIndexLoadResult* out_result) {
+  if (!ReadIndexFile(index_filename, out_last_cache_seen_by_index, out_result))
     simple_util::SimpleCacheDeleteFile(index_filename);
 }
 
+// static
+void SimpleIndexFile::SyncLoadIndexEntriesReadOnly(
+    const base::FilePath& cache_directory,
+    SimpleIndexLoadResult* out_result) {
+  base::Time last_cache_seen_by_index;
+  ReadIndexFile(
+      cache_directory.AppendASCII(kIndexDirectory).AppendASCII(kIndexFileName),
+      &last_cache_seen_by_index, out_result);
+  if (out_result->did_load)
+    return;
+
+  out_result->Reset();
+  out_result->did_load = TraverseCacheDirectory(
+      cache_directory, base::Bind(&ProcessEntryFile, &out_result->entries));
+}
+
 // static
 std::unique_ptr<base::Pickle> SimpleIndexFile::Serialize(
     const SimpleIndexFile::IndexMetadata& index_metadata,
@@ -97,6 +97,15 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                 const base::Closure& callback,
                                 SimpleIndexLoadResult* out_result);
 
+  // Loads the entries of the cache in |cache_directory| into |out_result|
+  // without modifying anything on disk: they are read from the index file if
+  // it is valid, and found by traversing |cache_directory| otherwise. Unlike
+  // LoadIndexEntries(), doesn't check whether the index is stale, and never
+  // deletes or rewrites it. Performs blocking IO.
+  static void SyncLoadIndexEntriesReadOnly(
+      const base::FilePath& cache_directory,
+      SimpleIndexLoadResult* out_result);
+
   // Writes the specified set of entries to disk.
   virtual void WriteToDisk(SimpleIndex::IndexWriteToDiskReason reason,
                            const SimpleIndex::EntrySet& entry_set,
@@ -125,6 +134,12 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                    const base::FilePath& index_file_path,
                                    SimpleIndexLoadResult* out_result);
 
+  // Reads the index file into |out_result|. Returns false if the file exists
+  // but is too large, can't be read in full or can't be deserialized.
+  static bool ReadIndexFile(const base::FilePath& index_filename,
+                            base::Time* out_last_cache_seen_by_index,
+                            SimpleIndexLoadResult* out_result);
+
   // Load the index file from disk returning an EntrySet.
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
                                base::Time* out_last_cache_seen_by_index,
@@ -6,6 +6,7 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -13,8 +14,8 @@
 #include <memory>
 #include <string>
 
-#include "base/files/file_util.h"
 #include "base/logging.h"
+#include "base/time/time.h"
 
 namespace disk_cache {
 namespace {
@@ -56,14 +57,19 @@ bool SimpleIndexFile::TraverseCacheDirectory(
       continue;
     const base::FilePath file_path = cache_path.Append(
         base::FilePath(file_name));
-    base::File::Info file_info;
-    if (!base::GetFileInfo(file_path, &file_info)) {
-      LOG(ERROR) << "Could not get file info for " << file_path.value();
+    // Stat relative to the directory being read, so that the cache path is
+    // not resolved again for each of the possibly many thousands of files.
+    // The index keeps times with a one second precision only.
+    struct stat file_info;
+    if (fstatat(dirfd(dir.get()), entry->d_name, &file_info, 0) != 0) {
+      PLOG(ERROR) << "Could not get file info for " << file_path.value();
       continue;
     }
 
-    entry_file_callback.Run(file_path, file_info.last_accessed,
-                            file_info.last_modified, file_info.size);
+    entry_file_callback.Run(file_path,
+                            base::Time::FromTimeT(file_info.st_atime),
+                            base::Time::FromTimeT(file_info.st_mtime),
+                            file_info.st_size);
   }
 
   return true;
@@ -4,8 +4,10 @@
 
 #include "net/disk_cache/simple/simple_index_file.h"
 
+#include <map>
 #include <memory>
 
+#include "base/bind.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
@@ -52,6 +54,19 @@ uint32_t RoundSize(uint32_t in) {
   return (in + 0xFFu) & 0xFFFFFF00u;
 }
 
+struct TraversedFile {
+  base::Time last_modified;
+  int64_t size;
+};
+
+void RecordTraversedFile(std::map<base::FilePath, TraversedFile>* files,
+                         const base::FilePath& file_path,
+                         base::Time last_accessed,
+                         base::Time last_modified,
+                         int64_t size) {
+  (*files)[file_path] = {last_modified, size};
+}
+
 }  // namespace
 
 TEST(IndexMetadataTest, Basics) {
@@ -149,6 +164,7 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
   using SimpleIndexFile::LegacyIsIndexFileStale;
   using SimpleIndexFile::Serialize;
   using SimpleIndexFile::SerializeFinalData;
+  using SimpleIndexFile::TraverseCacheDirectory;
 
   explicit WrappedSimpleIndexFile(const base::FilePath& index_file_directory)
       : SimpleIndexFile(base::ThreadTaskRunnerHandle::Get(),
@@ -339,6 +355,34 @@ TEST_F(SimpleIndexFileTest, WriteThenLoadIndex) {
     EXPECT_EQ(1U, load_index_result.entries.count(kHashes[i]));
 }
 
+TEST_F(SimpleIndexFileTest, TraverseCacheDirectory) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  // The index keeps times with a one second precision only.
+  const base::Time kModified = base::Time::FromTimeT(1000000000);
+  const base::FilePath small_path = cache_dir.GetPath().AppendASCII("small");
+  const base::FilePath large_path = cache_dir.GetPath().AppendASCII("large");
+  ASSERT_EQ(3, base::WriteFile(small_path, "abc", 3));
+  ASSERT_EQ(10, base::WriteFile(large_path, "0123456789", 10));
+  ASSERT_TRUE(base::TouchFile(small_path, kModified, kModified));
+
+  std::map<base::FilePath, TraversedFile> files;
+  EXPECT_TRUE(WrappedSimpleIndexFile::TraverseCacheDirectory(
+      cache_dir.GetPath(), base::Bind(&RecordTraversedFile, &files)));
+
+  ASSERT_EQ(2u, files.size());
+  ASSERT_EQ(1u, files.count(small_path));
+  EXPECT_EQ(kModified, files[small_path].last_modified);
+  EXPECT_EQ(3, files[small_path].size);
+  ASSERT_EQ(1u, files.count(large_path));
+  EXPECT_EQ(10, files[large_path].size);
+
+  EXPECT_FALSE(WrappedSimpleIndexFile::TraverseCacheDirectory(
+      cache_dir.GetPath().AppendASCII("missing"),
+      base::Bind(&RecordTraversedFile, &files)));
+}
+
 TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   base::ScopedTempDir cache_dir;
   ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
@@ -365,6 +409,29 @@ TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   EXPECT_TRUE(load_index_result.flush_required);
 }
 
+// Tests that loading a corrupt index read-only traverses the cache directory
+// and leaves the index file in place.
+TEST_F(SimpleIndexFileTest, LoadCorruptIndexReadOnly) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.GetPath());
+  ASSERT_TRUE(simple_index_file.CreateIndexFileDirectory());
+  const base::FilePath& index_path = simple_index_file.GetIndexFilePath();
+  const std::string kDummyData = "nothing to be seen here";
+  EXPECT_EQ(static_cast<int>(kDummyData.size()),
+            base::WriteFile(index_path, kDummyData.data(), kDummyData.size()));
+
+  SimpleIndexLoadResult load_index_result;
+  SimpleIndexFile::SyncLoadIndexEntriesReadOnly(cache_dir.GetPath(),
+                                                &load_index_result);
+
+  EXPECT_TRUE(base::PathExists(index_path));
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_TRUE(load_index_result.entries.empty());
+}
+
 // Tests that after an upgrade the backend has the index file put in place.
 TEST_F(SimpleIndexFileTest, SimpleCacheUpgrade) {
   base::ScopedTempDir cache_dir;
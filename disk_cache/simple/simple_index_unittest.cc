@@ -247,6 +247,52 @@ TEST_F(EntryMetadataTest, Serialize) {
   EXPECT_EQ(0, new_entry_metadata2.GetInMemoryData());
 }
 
+TEST(SimpleIndexEntrySetTest, InsertFindErase) {
+  SimpleIndex::EntrySet entry_set;
+  EXPECT_TRUE(entry_set.empty());
+  EXPECT_TRUE(entry_set.begin() == entry_set.end());
+
+  // Enough colliding and distinct hashes to grow the table a few times. The
+  // hash 0 is kept outside of the table.
+  const uint64_t kCount = 1000;
+  for (uint64_t i = 0; i < kCount; ++i) {
+    uint64_t hash = (i % 2) ? i << 40 : i;
+    auto result = entry_set.insert(
+        std::make_pair(hash, EntryMetadata(base::Time(), i * 256)));
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(hash, result.first->first);
+  }
+  EXPECT_EQ(kCount, entry_set.size());
+  EXPECT_FALSE(entry_set.insert(std::make_pair(0, EntryMetadata())).second);
+
+  size_t iterated = 0;
+  for (const auto& entry : entry_set) {
+    uint64_t i =
+        (entry.first & 0xFFFFFFFFFF) ? entry.first : entry.first >> 40;
+    EXPECT_EQ(i * 256, entry.second.GetEntrySize());
+    ++iterated;
+  }
+  EXPECT_EQ(kCount, iterated);
+
+  // Erasing every other entry must leave the others reachable.
+  for (uint64_t i = 0; i < kCount; i += 2)
+    EXPECT_EQ(1u, entry_set.erase(i));
+  EXPECT_EQ(0u, entry_set.erase(0));
+  EXPECT_EQ(kCount / 2, entry_set.size());
+  for (uint64_t i = 0; i < kCount; ++i) {
+    uint64_t hash = (i % 2) ? i << 40 : i;
+    EXPECT_EQ(i % 2, entry_set.count(hash));
+  }
+
+  SimpleIndex::EntrySet copy = entry_set;
+  entry_set.clear();
+  EXPECT_EQ(0u, entry_set.size());
+  EXPECT_EQ(kCount / 2, copy.size());
+  SimpleIndex::EntrySet::const_iterator it = copy.find(1ull << 40);
+  ASSERT_TRUE(it != copy.end());
+  EXPECT_EQ(256u, it->second.GetEntrySize());
+}
+
 TEST_F(SimpleIndexTest, IndexSizeCorrectOnMerge) {
   const unsigned int kSizeResolution = 256u;
   index()->SetMaxSize(100 * kSizeResolution);
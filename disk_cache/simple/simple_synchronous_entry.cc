@@ -126,10 +126,12 @@ using simple_util::GetFileIndexFromStreamIndex;
 const base::Feature kSimpleCachePrefetchExperiment = {
     "SimpleCachePrefetchExperiment", base::FEATURE_DISABLED_BY_DEFAULT};
 const char kSimplePrefetchBytesParam[] = "Bytes";
+const int kDefaultSimpleCachePrefetchSize = 8 * 1024;
 
 int GetSimpleCachePrefetchSize() {
-  return base::GetFieldTrialParamByFeatureAsInt(kSimpleCachePrefetchExperiment,
-                                                kSimplePrefetchBytesParam, 0);
+  return base::GetFieldTrialParamByFeatureAsInt(
+      kSimpleCachePrefetchExperiment, kSimplePrefetchBytesParam,
+      kDefaultSimpleCachePrefetchSize);
 }
 
 SimpleEntryStat::SimpleEntryStat(base::Time last_used,
@@ -719,7 +721,7 @@ int SimpleSynchronousEntry::CheckEOFRecord(base::File* file,
   SimpleFileEOF eof_record;
   int file_offset = entry_stat.GetEOFOffsetInFile(key_.size(), stream_index);
   int file_index = GetFileIndexFromStreamIndex(stream_index);
-  int rv = GetEOFRecordData(file, base::StringPiece(), file_index, file_offset,
+  int rv = GetEOFRecordData(file, PrefetchedRange(), file_index, file_offset,
                             &eof_record);
 
   if (rv != net::OK) {
@@ -739,7 +741,7 @@ int SimpleSynchronousEntry::CheckEOFRecord(base::File* file,
 
 int SimpleSynchronousEntry::PreReadStreamPayload(
     base::File* file,
-    base::StringPiece file_0_prefetch,
+    const PrefetchedRange& file_0_prefetch,
     int stream_index,
     int extra_size,
     const SimpleEntryStat& entry_stat,
@@ -1302,20 +1304,26 @@ int SimpleSynchronousEntry::ReadAndValidateStream0AndMaybe1(
   if (!file.IsOK())
     return net::ERR_FAILED;
 
-  // If the file is sufficiently small, we will prefetch everything --
-  // in which case |prefetch_buf| will be non-null, and we should look at it
-  // rather than call ::Read for the bits.
-  std::unique_ptr<char[]> prefetch_buf;
-  base::StringPiece file_0_prefetch;
+  // If the file is sufficiently small, we will prefetch everything.
+  // Otherwise, we prefetch as much of its end, which holds the stream 0 EOF
+  // record, stream 0 itself and the key SHA256, so that these are usually
+  // read with one ::Read rather than one for each of them.
+  const int prefetch_size = GetSimpleCachePrefetchSize();
+  const bool prefetch_whole_file = file_size <= prefetch_size;
+  RecordWhetherOpenDidPrefetch(cache_type_, prefetch_whole_file);
 
-  if (file_size > GetSimpleCachePrefetchSize()) {
-    RecordWhetherOpenDidPrefetch(cache_type_, false);
-  } else {
-    RecordWhetherOpenDidPrefetch(cache_type_, true);
-    prefetch_buf = std::make_unique<char[]>(file_size);
-    if (file->Read(0, prefetch_buf.get(), file_size) != file_size)
+  std::unique_ptr<char[]> prefetch_buf;
+  PrefetchedRange file_0_prefetch;
+  int prefetch_length = std::min(file_size, prefetch_size);
+  if (prefetch_length > 0) {
+    int prefetch_offset = file_size - prefetch_length;
+    prefetch_buf = std::make_unique<char[]>(prefetch_length);
+    if (file->Read(prefetch_offset, prefetch_buf.get(), prefetch_length) !=
+        prefetch_length) {
       return net::ERR_FAILED;
-    file_0_prefetch.set(prefetch_buf.get(), file_size);
+    }
+    file_0_prefetch.offset = prefetch_offset;
+    file_0_prefetch.data.set(prefetch_buf.get(), prefetch_length);
   }
 
   // Read stream 0 footer first --- it has size/feature info required to figure
@@ -1356,9 +1364,9 @@ int SimpleSynchronousEntry::ReadAndValidateStream0AndMaybe1(
   if (rv != net::OK)
     return rv;
 
-  // If prefetch buffer is available, and we have sha256(key) (so we don't need
-  // to look at the header), extract out stream 1 info as well.
-  if (prefetch_buf && has_key_sha256) {
+  // If the whole file was prefetched, and we have sha256(key) (so we don't
+  // need to look at the header), extract out stream 1 info as well.
+  if (prefetch_whole_file && has_key_sha256) {
     SimpleFileEOF stream_1_eof;
     rv = GetEOFRecordData(
         file.get(), file_0_prefetch, /* file_index = */ 0,
@@ -1403,41 +1411,38 @@ int SimpleSynchronousEntry::ReadAndValidateStream0AndMaybe1(
 
 bool SimpleSynchronousEntry::ReadFromFileOrPrefetched(
     base::File* file,
-    base::StringPiece file_0_prefetch,
+    const PrefetchedRange& file_0_prefetch,
     int file_index,
     int offset,
     int size,
     char* dest) {
-  if (file_0_prefetch.empty() || file_index != 0) {
-    return file->Read(offset, dest, size) == size;
-  } else {
-    if (offset < 0 || size < 0)
-      return false;
-    if (size == 0)
-      return true;
-
-    base::CheckedNumeric<size_t> start(offset);
-    size_t start_numeric;
-    if (!start.AssignIfValid(&start_numeric) ||
-        start_numeric >= file_0_prefetch.size())
-      return false;
-
-    base::CheckedNumeric<size_t> end = start + size - 1;
-    size_t end_numeric;
-    if (!end.AssignIfValid(&end_numeric) ||
-        end_numeric >= file_0_prefetch.size())
-      return false;
-
-    memcpy(dest, file_0_prefetch.data() + offset, size);
+  if (offset < 0 || size < 0)
+    return false;
+  if (size == 0)
     return true;
+
+  if (!file_0_prefetch.data.empty() && file_index == 0) {
+    base::CheckedNumeric<int> start = offset;
+    start -= file_0_prefetch.offset;
+    base::CheckedNumeric<int> end = start + size;
+    int start_numeric;
+    int end_numeric;
+    if (start.AssignIfValid(&start_numeric) && start_numeric >= 0 &&
+        end.AssignIfValid(&end_numeric) &&
+        static_cast<size_t>(end_numeric) <= file_0_prefetch.data.size()) {
+      memcpy(dest, file_0_prefetch.data.data() + start_numeric, size);
+      return true;
+    }
   }
+  return file->Read(offset, dest, size) == size;
 }
 
-int SimpleSynchronousEntry::GetEOFRecordData(base::File* file,
-                                             base::StringPiece file_0_prefetch,
-                                             int file_index,
-                                             int file_offset,
-                                             SimpleFileEOF* eof_record) {
+int SimpleSynchronousEntry::GetEOFRecordData(
+    base::File* file,
+    const PrefetchedRange& file_0_prefetch,
+    int file_index,
+    int file_offset,
+    SimpleFileEOF* eof_record) {
   if (!ReadFromFileOrPrefetched(file, file_0_prefetch, file_index, file_offset,
                                 sizeof(SimpleFileEOF),
                                 reinterpret_cast<char*>(eof_record))) {
@@ -19,7 +19,7 @@
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
-#include "base/strings/string_piece_forward.h"
+#include "base/strings/string_piece.h"
 #include "base/time/time.h"
 #include "net/base/cache_type.h"
 #include "net/base/net_export.h"
@@ -38,8 +38,12 @@ namespace disk_cache {
 NET_EXPORT_PRIVATE extern const base::Feature kSimpleCachePrefetchExperiment;
 NET_EXPORT_PRIVATE extern const char kSimplePrefetchBytesParam[];
 
+// Files of small entries, most HTTP responses among them, are read whole when
+// the entry is opened, so that opening one takes a single read.
+NET_EXPORT_PRIVATE extern const int kDefaultSimpleCachePrefetchSize;
+
 // Returns how large a file would get prefetched on reading the entry.
-// If the experiment is disabled, returns 0.
+// If the experiment is disabled, returns kDefaultSimpleCachePrefetchSize.
 NET_EXPORT_PRIVATE int GetSimpleCachePrefetchSize();
 
 class SimpleSynchronousEntry;
@@ -329,20 +333,27 @@ class SimpleSynchronousEntry {
       SimpleEntryStat* out_entry_stat,
       SimpleStreamPrefetchData stream_prefetch_data[2]);
 
+  // A range of file 0 read in one go when opening the entry, starting at
+  // |offset|. Empty if nothing was prefetched.
+  struct PrefetchedRange {
+    int offset = 0;
+    base::StringPiece data;
+  };
+
   // Reads the EOF record located at |file_offset| in file |file_index|,
   // with |file_0_prefetch| potentially having prefetched file 0 content.
   // Puts the result into |*eof_record| and sanity-checks it.
   // Returns net status, and records any failures to UMA.
   int GetEOFRecordData(base::File* file,
-                       base::StringPiece file_0_prefetch,
+                       const PrefetchedRange& file_0_prefetch,
                        int file_index,
                        int file_offset,
                        SimpleFileEOF* eof_record);
 
-  // Reads either from |file_0_prefetch| or |file|.
-  // Range-checks all the in-memory reads.
+  // Reads from |file_0_prefetch| if it covers the requested range, or from
+  // |file| otherwise.
   bool ReadFromFileOrPrefetched(base::File* file,
-                                base::StringPiece file_0_prefetch,
+                                const PrefetchedRange& file_0_prefetch,
                                 int file_index,
                                 int offset,
                                 int size,
@@ -357,7 +368,7 @@ class SimpleSynchronousEntry {
   // and |*out_crc32| will get the checksum, which will be verified against
   // |eof_record|.
   int PreReadStreamPayload(base::File* file,
-                           base::StringPiece file_0_prefetch,
+                           const PrefetchedRange& file_0_prefetch,
                            int stream_index,
                            int extra_size,
                            const SimpleEntryStat& entry_stat,
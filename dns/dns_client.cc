@@ -30,6 +30,7 @@ class DnsClientImpl : public DnsClient {
                 const RandIntCallback& rand_int_callback)
       : address_sorter_(AddressSorter::CreateAddressSorter()),
         net_log_(net_log),
+        url_request_context_(nullptr),
         socket_factory_(socket_factory),
         rand_int_callback_(rand_int_callback) {}
 
@@ -44,7 +45,8 @@ class DnsClientImpl : public DnsClient {
               : DnsSocketPool::CreateNull(socket_factory_, rand_int_callback_));
       session_ = new DnsSession(config, std::move(socket_pool),
                                 rand_int_callback_, net_log_);
-      factory_ = DnsTransactionFactory::CreateFactory(session_.get());
+      factory_ = DnsTransactionFactory::CreateFactory(session_.get(),
+                                                      url_request_context_);
     }
   }
 
@@ -70,12 +72,21 @@ class DnsClientImpl : public DnsClient {
     session_->ApplyPersistentData(data);
   }
 
+  void SetRequestContext(URLRequestContext* url_request_context) override {
+    url_request_context_ = url_request_context;
+    // Update the factory in place: the transactions it has created point into
+    // it, so it must not be replaced while they run.
+    if (factory_)
+      factory_->SetRequestContext(url_request_context_);
+  }
+
  private:
   scoped_refptr<DnsSession> session_;
   std::unique_ptr<DnsTransactionFactory> factory_;
   std::unique_ptr<AddressSorter> address_sorter_;
 
   NetLog* net_log_;
+  URLRequestContext* url_request_context_;
 
   ClientSocketFactory* socket_factory_;
   const RandIntCallback rand_int_callback_;
@@ -18,6 +18,7 @@ class ClientSocketFactory;
 struct DnsConfig;
 class DnsTransactionFactory;
 class NetLog;
+class URLRequestContext;
 
 // Convenience wrapper which allows easy injection of DnsTransaction into
 // HostResolverImpl. Pointers returned by the Get* methods are only guaranteed
@@ -46,6 +47,10 @@ class NET_EXPORT DnsClient {
   // valid.
   virtual std::unique_ptr<const base::Value> GetPersistentData() const = 0;
 
+  // Sets the context used for DNS over HTTPS requests, which are only made
+  // when it is not null. It must outlive |this|, or be reset first.
+  virtual void SetRequestContext(URLRequestContext* url_request_context) = 0;
+
   // Creates default client.
   static std::unique_ptr<DnsClient> CreateClient(NetLog* net_log);
 
@@ -14,6 +14,16 @@
 
 namespace net {
 
+DnsConfig::DnsOverHttpsServerConfig::DnsOverHttpsServerConfig(
+    const GURL& server,
+    bool use_post)
+    : server(server), use_post(use_post) {}
+
+bool DnsConfig::DnsOverHttpsServerConfig::operator==(
+    const DnsOverHttpsServerConfig& other) const {
+  return server == other.server && use_post == other.use_post;
+}
+
 // Default values are taken from glibc resolv.h except timeout which is set to
 // |kDnsDefaultTimeoutMs|.
 DnsConfig::DnsConfig()
@@ -37,6 +47,7 @@ bool DnsConfig::Equals(const DnsConfig& d) const {
 
 bool DnsConfig::EqualsIgnoreHosts(const DnsConfig& d) const {
   return (nameservers == d.nameservers) &&
+         (dns_over_https_servers == d.dns_over_https_servers) &&
          (search == d.search) &&
          (unhandled_options == d.unhandled_options) &&
          (append_to_multi_label_name == d.append_to_multi_label_name) &&
@@ -50,6 +61,7 @@ bool DnsConfig::EqualsIgnoreHosts(const DnsConfig& d) const {
 
 void DnsConfig::CopyIgnoreHosts(const DnsConfig& d) {
   nameservers = d.nameservers;
+  dns_over_https_servers = d.dns_over_https_servers;
   search = d.search;
   unhandled_options = d.unhandled_options;
   append_to_multi_label_name = d.append_to_multi_label_name;
@@ -69,6 +81,15 @@ std::unique_ptr<base::Value> DnsConfig::ToValue() const {
     list->AppendString(nameservers[i].ToString());
   dict->Set("nameservers", std::move(list));
 
+  list = std::make_unique<base::ListValue>();
+  for (const DnsOverHttpsServerConfig& server : dns_over_https_servers) {
+    auto server_dict = std::make_unique<base::DictionaryValue>();
+    server_dict->SetString("server", server.server.spec());
+    server_dict->SetBoolean("use_post", server.use_post);
+    list->Append(std::move(server_dict));
+  }
+  dict->Set("dns_over_https_servers", std::move(list));
+
   list = std::make_unique<base::ListValue>();
   for (size_t i = 0; i < search.size(); ++i)
     list->AppendString(search[i]);
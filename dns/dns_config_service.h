@@ -20,6 +20,7 @@
 #include "net/base/ip_endpoint.h"  // win requires size of IPEndPoint
 #include "net/base/net_export.h"
 #include "net/dns/dns_hosts.h"
+#include "url/gurl.h"
 
 namespace base {
 class Value;
@@ -32,6 +33,17 @@ const int64_t kDnsDefaultTimeoutMs = 1000;
 
 // DnsConfig stores configuration of the system resolver.
 struct NET_EXPORT_PRIVATE DnsConfig {
+  // A DNS over HTTPS server (RFC 8484), queried with GET requests to
+  // |server|?dns=<query> or with POST requests to |server|.
+  struct NET_EXPORT_PRIVATE DnsOverHttpsServerConfig {
+    DnsOverHttpsServerConfig(const GURL& server, bool use_post);
+
+    bool operator==(const DnsOverHttpsServerConfig& other) const;
+
+    GURL server;
+    bool use_post;
+  };
+
   DnsConfig();
   DnsConfig(const DnsConfig& other);
   virtual ~DnsConfig();
@@ -52,6 +64,9 @@ struct NET_EXPORT_PRIVATE DnsConfig {
 
   // List of name server addresses.
   std::vector<IPEndPoint> nameservers;
+  // List of DNS over HTTPS servers. When not empty, and DnsTransactions have a
+  // URLRequestContext, these are used instead of |nameservers|.
+  std::vector<DnsOverHttpsServerConfig> dns_over_https_servers;
   // Suffix search list; used on first lookup when number of dots in given name
   // is less than |ndots|.
   std::vector<std::string> search;
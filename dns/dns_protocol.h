@@ -143,6 +143,11 @@ static const uint16_t kFlagResponse = 0x8000;
 static const uint16_t kFlagRD = 0x100;  // Recursion Desired - query flag.
 static const uint16_t kFlagTC = 0x200;  // Truncated - server flag.
 
+// EDNS option codes.
+//
+// https://www.iana.org/assignments/dns-parameters/dns-parameters.xhtml#dns-parameters-11
+static const uint16_t kEdnsPadding = 12;
+
 }  // namespace dns_protocol
 
 }  // namespace net
@@ -12,6 +12,7 @@
 #include "net/base/address_list.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/dns/dns_protocol.h"
 #include "net/dns/dns_query.h"
@@ -72,11 +73,8 @@ unsigned DnsRecordParser::ReadName(const void* const vpos,
       case dns_protocol::kLabelPointer: {
         if (p + sizeof(uint16_t) > end)
           return 0;
-        if (consumed == 0) {
+        if (consumed == 0)
           consumed = p - pos + sizeof(uint16_t);
-          if (!out)
-            return consumed;  // If name is not stored, that's all we need.
-        }
         seen += sizeof(uint16_t);
         // If seen the whole packet, then we must be in a loop.
         if (seen > length_)
@@ -136,6 +134,88 @@ bool DnsRecordParser::ReadRecord(DnsResourceRecord* out) {
   return false;
 }
 
+bool DnsRecordParser::ReadRecordView(DnsResourceRecordView* out) {
+  DCHECK(packet_);
+  size_t consumed = ReadName(cur_, NULL);
+  if (!consumed)
+    return false;
+  base::BigEndianReader reader(cur_ + consumed,
+                               packet_ + length_ - (cur_ + consumed));
+  uint16_t rdlen;
+  if (reader.ReadU16(&out->type) &&
+      reader.ReadU16(&out->klass) &&
+      reader.ReadU32(&out->ttl) &&
+      reader.ReadU16(&rdlen) &&
+      reader.ReadPiece(&out->rdata, rdlen)) {
+    out->name = cur_;
+    cur_ = reader.ptr();
+    return true;
+  }
+  return false;
+}
+
+bool DnsRecordParser::NamesEqual(const void* pos1, const void* pos2) const {
+  DCHECK(packet_);
+  const char* p1 = reinterpret_cast<const char*>(pos1);
+  const char* p2 = reinterpret_cast<const char*>(pos2);
+  unsigned seen1 = 0;
+  unsigned seen2 = 0;
+  for (;;) {
+    base::StringPiece label1;
+    base::StringPiece label2;
+    if (!ReadLabel(&p1, &seen1, &label1) || !ReadLabel(&p2, &seen2, &label2))
+      return false;
+    if (!base::EqualsCaseInsensitiveASCII(label1, label2))
+      return false;
+    if (label1.empty())
+      return true;
+  }
+}
+
+bool DnsRecordParser::ReadLabel(const char** pos,
+                                unsigned* seen,
+                                base::StringPiece* label) const {
+  const char* p = *pos;
+  const char* end = packet_ + length_;
+  for (;;) {
+    if (p < packet_ || p >= end)
+      return false;
+    switch (*p & dns_protocol::kLabelMask) {
+      case dns_protocol::kLabelPointer: {
+        if (p + sizeof(uint16_t) > end)
+          return false;
+        *seen += sizeof(uint16_t);
+        // If seen the whole packet, then we must be in a loop.
+        if (*seen > length_)
+          return false;
+        uint16_t offset;
+        base::ReadBigEndian<uint16_t>(p, &offset);
+        offset &= dns_protocol::kOffsetMask;
+        p = packet_ + offset;
+        break;
+      }
+      case dns_protocol::kLabelDirect: {
+        uint8_t label_len = *p;
+        ++p;
+        if (label_len == 0) {
+          *label = base::StringPiece();
+          *pos = p;
+          return true;
+        }
+        if (p + label_len >= end)
+          return false;  // Truncated or missing label.
+        *label = base::StringPiece(p, label_len);
+        *pos = p + label_len;
+        *seen += 1 + label_len;
+        return true;
+      }
+      default:
+        // unhandled label type
+        return false;
+    }
+  }
+}
+
 bool DnsRecordParser::SkipQuestion() {
   size_t consumed = ReadName(cur_, NULL);
   if (!consumed)
@@ -282,8 +362,8 @@ DnsResponse::Result DnsResponse::ParseToAddressList(
   // We err on the side of caution with the assumption that if we are too picky,
   // we can always fall back to the system getaddrinfo.
 
-  // Expected owner of record. No trailing dot.
-  std::string expected_name = GetDottedName();
+  // Expected owner of record, in the packet. Starts as the question name.
+  const char* expected_name = io_buffer_->data() + kHeaderSize;
 
   uint16_t expected_type = qtype();
   DCHECK(expected_type == dns_protocol::kTypeA ||
@@ -294,38 +374,40 @@ DnsResponse::Result DnsResponse::ParseToAddressList(
                              : IPAddress::kIPv4AddressSize;
 
   uint32_t ttl_sec = std::numeric_limits<uint32_t>::max();
-  IPAddressList ip_addresses;
   DnsRecordParser parser = Parser();
-  DnsResourceRecord record;
+  DnsResourceRecordView record;
   unsigned ancount = answer_count();
+  addr_list->clear();
+  addr_list->reserve(ancount);
   for (unsigned i = 0; i < ancount; ++i) {
-    if (!parser.ReadRecord(&record))
+    if (!parser.ReadRecordView(&record))
       return DNS_MALFORMED_RESPONSE;
 
     if (record.type == dns_protocol::kTypeCNAME) {
       // Following the CNAME chain, only if no addresses seen.
-      if (!ip_addresses.empty())
+      if (!addr_list->empty())
         return DNS_CNAME_AFTER_ADDRESS;
 
-      if (!base::EqualsCaseInsensitiveASCII(record.name, expected_name))
+      if (!parser.NamesEqual(record.name, expected_name))
         return DNS_NAME_MISMATCH;
 
-      if (record.rdata.size() !=
-          parser.ReadName(record.rdata.begin(), &expected_name))
+      if (record.rdata.size() != parser.ReadName(record.rdata.data(), NULL))
         return DNS_MALFORMED_CNAME;
+      expected_name = record.rdata.data();
 
       ttl_sec = std::min(ttl_sec, record.ttl);
     } else if (record.type == expected_type) {
       if (record.rdata.size() != expected_size)
         return DNS_SIZE_MISMATCH;
 
-      if (!base::EqualsCaseInsensitiveASCII(record.name, expected_name))
+      if (!parser.NamesEqual(record.name, expected_name))
         return DNS_NAME_MISMATCH;
 
       ttl_sec = std::min(ttl_sec, record.ttl);
-      ip_addresses.push_back(
+      addr_list->push_back(IPEndPoint(
           IPAddress(reinterpret_cast<const uint8_t*>(record.rdata.data()),
-                    record.rdata.length()));
+                    record.rdata.length()),
+          0));
     }
   }
 
@@ -333,8 +415,9 @@ DnsResponse::Result DnsResponse::ParseToAddressList(
 
   // getcanonname in eglibc returns the first owner name of an A or AAAA RR.
   // If the response passed all the checks so far, then |expected_name| is it.
-  *addr_list = AddressList::CreateFromIPAddressList(ip_addresses,
-                                                    expected_name);
+  std::string canonical_name;
+  parser.ReadName(expected_name, &canonical_name);
+  addr_list->set_canonical_name(canonical_name);
   *ttl = base::TimeDelta::FromSeconds(ttl_sec);
   return DNS_PARSE_OK;
 }
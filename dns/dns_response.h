@@ -39,6 +39,17 @@ struct NET_EXPORT_PRIVATE DnsResourceRecord {
   base::StringPiece rdata;  // points to the original response buffer
 };
 
+// Resource record like DnsResourceRecord, except that the owner name is left in
+// the packet rather than copied out, so that records are parsed without
+// allocations.
+struct NET_EXPORT_PRIVATE DnsResourceRecordView {
+  const char* name;  // possibly compressed, points to the response buffer
+  uint16_t type;
+  uint16_t klass;
+  uint32_t ttl;
+  base::StringPiece rdata;  // points to the original response buffer
+};
+
 // Iterator to walk over resource records of the DNS response packet.
 class NET_EXPORT_PRIVATE DnsRecordParser {
  public:
@@ -61,7 +72,8 @@ class NET_EXPORT_PRIVATE DnsRecordParser {
   // Parses a (possibly compressed) DNS name from the packet starting at
   // |pos|. Stores output (even partial) in |out| unless |out| is NULL. |out|
   // is stored in the dotted form, e.g., "example.com". Returns number of bytes
-  // consumed or 0 on failure.
+  // consumed or 0 on failure. The whole name is validated even if |out| is
+  // NULL.
   // This is exposed to allow parsing compressed names within RRDATA for TYPEs
   // such as NS, CNAME, PTR, MX, SOA.
   // See RFC 1035 section 4.1.4.
@@ -70,10 +82,27 @@ class NET_EXPORT_PRIVATE DnsRecordParser {
   // Parses the next resource record into |record|. Returns true if succeeded.
   bool ReadRecord(DnsResourceRecord* record);
 
+  // Like ReadRecord(), but does not copy the owner name. The name is still
+  // validated.
+  bool ReadRecordView(DnsResourceRecordView* record);
+
+  // Returns true if the (possibly compressed) names starting at |pos1| and
+  // |pos2| are equal, ignoring ASCII case. The names are compared in place.
+  // Returns false if either name is malformed.
+  bool NamesEqual(const void* pos1, const void* pos2) const;
+
   // Skip a question section, returns true if succeeded.
   bool SkipQuestion();
 
  private:
+  // Reads the label of a name at |*pos| into |label|, following compression
+  // pointers, and advances |*pos| past it. The root label is read as an empty
+  // |label|. |*seen| counts the bytes read from the name, to detect loops.
+  // Returns false if the name is malformed.
+  bool ReadLabel(const char** pos,
+                 unsigned* seen,
+                 base::StringPiece* label) const;
+
   const char* packet_;
   size_t length_;
   // Current offset within the packet.
@@ -150,7 +179,10 @@ class NET_EXPORT_PRIVATE DnsResponse {
   DnsRecordParser Parser() const;
 
   // Extracts an AddressList from this response. Returns SUCCESS if succeeded.
-  // Otherwise returns a detailed error number.
+  // Otherwise returns a detailed error number. |addr_list| is cleared and the
+  // addresses appended to it, so a reused list keeps its capacity. The records
+  // are parsed and their names compared in the response buffer, the only copy
+  // made is the canonical name.
   Result ParseToAddressList(AddressList* addr_list, base::TimeDelta* ttl) const;
 
  private:
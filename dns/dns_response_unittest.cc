@@ -95,6 +95,10 @@ TEST(DnsRecordParserTest, ReadNameFail) {
   EXPECT_EQ(0u, parser.ReadName(data + 0x0a, &out));
   EXPECT_EQ(0u, parser.ReadName(data + 0x0c, &out));
   EXPECT_EQ(0u, parser.ReadName(data + 0x0e, &out));
+
+  // Names are validated past their first pointer even when not stored.
+  EXPECT_EQ(0u, parser.ReadName(data + 0x04, NULL));
+  EXPECT_EQ(0u, parser.ReadName(data + 0x08, NULL));
 }
 
 TEST(DnsRecordParserTest, ReadRecord) {
@@ -146,6 +150,60 @@ TEST(DnsRecordParserTest, ReadRecord) {
   EXPECT_FALSE(parser.ReadRecord(&record));
 }
 
+TEST(DnsRecordParserTest, ReadRecordView) {
+  const uint8_t data[] = {
+      // Type A record.
+      0x03, 'f', 'o', 'o', 0x00,  // owner name
+      0x00, 0x01,                 // TYPE is A.
+      0x00, 0x01,                 // CLASS is IN.
+      0x00, 0x00, 0x01, 0x00,     // TTL is 0x00000100.
+      0x00, 0x04,                 // RDLENGTH is 4 bytes.
+      0x7f, 0x02, 0x04, 0x01,     // IP is 127.2.4.1
+      // Record with a pointer loop as owner name.
+      0xc0, 0x13,
+  };
+
+  DnsRecordParser parser(data, sizeof(data), 0);
+  DnsResourceRecordView record;
+  EXPECT_TRUE(parser.ReadRecordView(&record));
+  EXPECT_EQ(reinterpret_cast<const char*>(data), record.name);
+  EXPECT_EQ(dns_protocol::kTypeA, record.type);
+  EXPECT_EQ(dns_protocol::kClassIN, record.klass);
+  EXPECT_EQ(0x00000100u, record.ttl);
+  EXPECT_EQ(base::StringPiece("\x7f\x02\x04\x01"), record.rdata);
+
+  EXPECT_FALSE(parser.ReadRecordView(&record));
+  EXPECT_EQ(0x13u, parser.GetOffset());
+}
+
+TEST(DnsRecordParserTest, NamesEqual) {
+  const uint8_t data[] = {
+      // "foo.example.com"
+      0x03, 'f', 'o', 'o', 0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x03, 'c',
+      'o', 'm', 0x00,
+      // byte 0x11
+      // "FOO.Example.com", part label, part pointer
+      0x03, 'F', 'O', 'O', 0x07, 'E', 'x', 'a', 'm', 'p', 'l', 'e', 0xc0, 0x0c,
+      // byte 0x1f
+      // "bar.example.com", part label, part pointer
+      0x03, 'b', 'a', 'r', 0xc0, 0x04,
+      // byte 0x25
+      // pointer loop
+      0xc0, 0x25,
+  };
+
+  DnsRecordParser parser(data, sizeof(data), 0);
+  EXPECT_TRUE(parser.NamesEqual(data + 0x00, data + 0x00));
+  EXPECT_TRUE(parser.NamesEqual(data + 0x00, data + 0x11));
+  EXPECT_TRUE(parser.NamesEqual(data + 0x11, data + 0x00));
+  EXPECT_FALSE(parser.NamesEqual(data + 0x00, data + 0x1f));
+  EXPECT_FALSE(parser.NamesEqual(data + 0x04, data + 0x00));
+  EXPECT_FALSE(parser.NamesEqual(data + 0x25, data + 0x25));
+
+  EXPECT_EQ(0x6u, parser.ReadName(data + 0x1f, NULL));
+  EXPECT_EQ(0u, parser.ReadName(data + 0x25, NULL));
+}
+
 TEST(DnsResponseTest, InitParse) {
   // This includes \0 at the end.
   const char qname_data[] = "\x0A""codereview""\x08""chromium""\x03""org";
@@ -450,6 +508,35 @@ TEST(DnsResponseTest, ParseToAddressList) {
   }
 }
 
+TEST(DnsResponseTest, ParseToAddressListCompressedCNAME) {
+  const uint8_t response_data[] = {
+      // Header: 1 question, 2 answer RR
+      0x00, 0x00, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+      // Question: name = 'a.example', type = A (0x1)
+      0x01, 'a', 0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x00, 0x00, 0x01,
+      0x00, 0x01,
+      // Answer: name = 'A.EXAMPLE', type = CNAME, TTL = 0xFF,
+      // RDATA = 'b.example' compressed.
+      0x01, 'A', 0x07, 'E', 'X', 'A', 'M', 'P', 'L', 'E', 0x00, 0x00, 0x05,
+      0x00, 0x01, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x04, 0x01, 'b', 0xc0, 0x0e,
+      // Answer: name = 'B.example' compressed, type = A, TTL = 0x80,
+      // RDATA = 10.10.10.10
+      0x01, 'B', 0xc0, 0x0e, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x80,
+      0x00, 0x04, 0x0A, 0x0A, 0x0A, 0x0A,
+  };
+  const size_t kQuerySize = 12 + 15;
+
+  DnsResponse response(response_data, arraysize(response_data), kQuerySize);
+  AddressList addr_list;
+  addr_list.push_back(IPEndPoint(IPAddress(1, 2, 3, 4), 80));
+  base::TimeDelta ttl;
+  EXPECT_EQ(DnsResponse::DNS_PARSE_OK,
+            response.ParseToAddressList(&addr_list, &ttl));
+  VerifyAddressList({"10.10.10.10"}, addr_list);
+  EXPECT_EQ("b.example", addr_list.canonical_name());
+  EXPECT_EQ(base::TimeDelta::FromSeconds(0x80), ttl);
+}
+
 const uint8_t kResponseTruncatedRecord[] = {
     // Header: 1 question, 1 answer RR
     0x00, 0x00, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
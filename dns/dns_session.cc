@@ -94,10 +94,11 @@ DnsSession::SocketLease::SocketLease(
     std::unique_ptr<DatagramClientSocket> socket)
     : session_(session),
       server_index_(server_index),
-      socket_(std::move(socket)) {}
+      socket_(std::move(socket)),
+      reusable_(false) {}
 
 DnsSession::SocketLease::~SocketLease() {
-  session_->FreeSocket(server_index_, std::move(socket_));
+  session_->FreeSocket(server_index_, std::move(socket_), reusable_);
 }
 
 DnsSession::DnsSession(const DnsConfig& config,
@@ -303,12 +304,13 @@ std::unique_ptr<const base::Value> DnsSession::GetPersistentData() const {
 
 // Release a socket.
 void DnsSession::FreeSocket(unsigned server_index,
-                            std::unique_ptr<DatagramClientSocket> socket) {
+                            std::unique_ptr<DatagramClientSocket> socket,
+                            bool reusable) {
   DCHECK(socket.get());
 
   socket->NetLog().EndEvent(NetLogEventType::SOCKET_IN_USE);
 
-  socket_pool_->FreeSocket(server_index, std::move(socket));
+  socket_pool_->FreeSocket(server_index, std::move(socket), reusable);
 }
 
 base::TimeDelta DnsSession::NextTimeoutFromJacobson(unsigned server_index,
@@ -52,10 +52,15 @@ class NET_EXPORT_PRIVATE DnsSession
 
     DatagramClientSocket* socket() { return socket_.get(); }
 
+    // Set once the query sent on the socket is answered, so that the socket
+    // pool may reuse it.
+    void set_reusable(bool reusable) { reusable_ = reusable; }
+
    private:
     scoped_refptr<DnsSession> session_;
     unsigned server_index_;
     std::unique_ptr<DatagramClientSocket> socket_;
+    bool reusable_;
 
     DISALLOW_COPY_AND_ASSIGN(SocketLease);
   };
@@ -121,7 +126,8 @@ class NET_EXPORT_PRIVATE DnsSession
 
   // Release a socket.
   void FreeSocket(unsigned server_index,
-                  std::unique_ptr<DatagramClientSocket> socket);
+                  std::unique_ptr<DatagramClientSocket> socket,
+                  bool reusable);
 
   // Return the timeout using the TCP timeout method.
   base::TimeDelta NextTimeoutFromJacobson(unsigned server_index, int attempt);
@@ -105,7 +105,8 @@ class MockDnsSocketPool : public DnsSocketPool {
   }
 
   void FreeSocket(unsigned server_index,
-                  std::unique_ptr<DatagramClientSocket> socket) override {
+                  std::unique_ptr<DatagramClientSocket> socket,
+                  bool reusable) override {
     test_->OnSocketFreed(server_index);
   }
 
@@ -4,9 +4,17 @@
 
 #include "net/dns/dns_socket_pool.h"
 
+#include <algorithm>
+#include <map>
+
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/memory/weak_ptr.h"
 #include "base/rand_util.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
 #include "net/base/address_list.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
@@ -21,21 +29,36 @@ namespace {
 
 // When we initialize the SocketPool, we allocate kInitialPoolSize sockets.
 // When we allocate a socket, we ensure we have at least kAllocateMinSize
-// sockets to choose from.  Freed sockets are not retained.
+// sockets to choose from.  Beyond that, the pool is refilled in the background
+// up to the number of queries sent to the server in the last interval, bounded
+// by kMaxPoolSize.  Freed sockets which got their answer are retained, as long
+// as the pool is below that size, until they were used for
+// kMaxQueriesPerSocket queries.
 
 // On Windows, we can't request specific (random) ports, since that will
 // trigger firewall prompts, so request default ones, but keep a pile of
-// them.  Everywhere else, request fresh, random ports each time.
+// them.  Everywhere else, request random ports.
 #if defined(OS_WIN)
 const DatagramSocket::BindType kBindType = DatagramSocket::DEFAULT_BIND;
 const unsigned kInitialPoolSize = 256;
 const unsigned kAllocateMinSize = 256;
+const unsigned kMaxPoolSize = 256;
 #else
 const DatagramSocket::BindType kBindType = DatagramSocket::RANDOM_BIND;
 const unsigned kInitialPoolSize = 0;
 const unsigned kAllocateMinSize = 1;
+const unsigned kMaxPoolSize = 64;
 #endif
 
+// Number of queries a socket, and so its source port, is used for before it is
+// closed.  Bounds the number of queries an off-path attacker can target at once
+// by guessing a single port, while saving the bind of a new socket for most
+// queries.
+const unsigned kMaxQueriesPerSocket = 4;
+
+// Interval over which the query rate to each server is measured.
+const int64_t kQueryRateIntervalMs = 1000;
+
 } // namespace
 
 DnsSocketPool::DnsSocketPool(ClientSocketFactory* socket_factory,
@@ -111,7 +134,8 @@ class NullDnsSocketPool : public DnsSocketPool {
   }
 
   void FreeSocket(unsigned server_index,
-                  std::unique_ptr<DatagramClientSocket> socket) override {}
+                  std::unique_ptr<DatagramClientSocket> socket,
+                  bool reusable) override {}
 
  private:
   DISALLOW_COPY_AND_ASSIGN(NullDnsSocketPool);
@@ -129,7 +153,7 @@ class DefaultDnsSocketPool : public DnsSocketPool {
  public:
   DefaultDnsSocketPool(ClientSocketFactory* factory,
                        const RandIntCallback& rand_int_callback)
-      : DnsSocketPool(factory, rand_int_callback){};
+      : DnsSocketPool(factory, rand_int_callback), weak_factory_(this) {}
 
   ~DefaultDnsSocketPool() override;
 
@@ -140,14 +164,42 @@ class DefaultDnsSocketPool : public DnsSocketPool {
       unsigned server_index) override;
 
   void FreeSocket(unsigned server_index,
-                  std::unique_ptr<DatagramClientSocket> socket) override;
+                  std::unique_ptr<DatagramClientSocket> socket,
+                  bool reusable) override;
 
  private:
+  typedef std::vector<std::unique_ptr<DatagramClientSocket>> SocketVector;
+
+  struct ServerPool {
+    ServerPool();
+    ServerPool(ServerPool&& other);
+    ~ServerPool();
+
+    SocketVector sockets;
+    // Queries to the server since |interval_start|.
+    unsigned queries;
+    base::TimeTicks interval_start;
+    // Number of sockets to keep, from the queries of the last interval.
+    unsigned target_size;
+    bool refill_pending;
+  };
+
   void FillPool(unsigned server_index, unsigned size);
 
-  typedef std::vector<std::unique_ptr<DatagramClientSocket>> SocketVector;
+  // Counts an allocation in the query rate of |pool|, and updates its
+  // |target_size| once an interval has passed.
+  void UpdateQueryRate(ServerPool* pool);
+
+  // Posts a FillPool() up to the target size, if the pool is below it.
+  void ScheduleRefill(unsigned server_index);
+  void OnRefill(unsigned server_index);
+
+  std::vector<ServerPool> pools_;
+
+  // Number of queries each allocated or pooled socket was used for.
+  std::map<const DatagramClientSocket*, unsigned> socket_uses_;
 
-  std::vector<SocketVector> pools_;
+  base::WeakPtrFactory<DefaultDnsSocketPool> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(DefaultDnsSocketPool);
 };
@@ -176,10 +228,18 @@ void DefaultDnsSocketPool::Initialize(
 
 DefaultDnsSocketPool::~DefaultDnsSocketPool() = default;
 
+DefaultDnsSocketPool::ServerPool::ServerPool()
+    : queries(0), target_size(0), refill_pending(false) {}
+
+DefaultDnsSocketPool::ServerPool::ServerPool(ServerPool&& other) = default;
+
+DefaultDnsSocketPool::ServerPool::~ServerPool() = default;
+
 std::unique_ptr<DatagramClientSocket> DefaultDnsSocketPool::AllocateSocket(
     unsigned server_index) {
   DCHECK_LT(server_index, pools_.size());
-  SocketVector& pool = pools_[server_index];
+  UpdateQueryRate(&pools_[server_index]);
+  SocketVector& pool = pools_[server_index].sockets;
 
   FillPool(server_index, kAllocateMinSize);
   if (pool.size() == 0) {
@@ -198,17 +258,61 @@ std::unique_ptr<DatagramClientSocket> DefaultDnsSocketPool::AllocateSocket(
   pool[socket_index] = std::move(pool.back());
   pool.pop_back();
 
+  ++socket_uses_[socket.get()];
+  ScheduleRefill(server_index);
   return socket;
 }
 
 void DefaultDnsSocketPool::FreeSocket(
     unsigned server_index,
-    std::unique_ptr<DatagramClientSocket> socket) {
+    std::unique_ptr<DatagramClientSocket> socket,
+    bool reusable) {
   DCHECK_LT(server_index, pools_.size());
+  ServerPool& pool = pools_[server_index];
+
+  auto uses = socket_uses_.find(socket.get());
+  DCHECK(uses != socket_uses_.end());
+  if (reusable && uses->second < kMaxQueriesPerSocket &&
+      pool.sockets.size() < std::max(pool.target_size, kAllocateMinSize)) {
+    pool.sockets.push_back(std::move(socket));
+    return;
+  }
+  socket_uses_.erase(uses);
+}
+
+void DefaultDnsSocketPool::UpdateQueryRate(ServerPool* pool) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta interval =
+      base::TimeDelta::FromMilliseconds(kQueryRateIntervalMs);
+  if (now - pool->interval_start >= interval) {
+    // If the last interval had no queries, the pool is not needed anymore.
+    pool->target_size = now - pool->interval_start < interval * 2
+                            ? std::min(pool->queries, kMaxPoolSize)
+                            : 0;
+    pool->queries = 0;
+    pool->interval_start = now;
+  }
+  ++pool->queries;
+}
+
+void DefaultDnsSocketPool::ScheduleRefill(unsigned server_index) {
+  ServerPool& pool = pools_[server_index];
+  if (pool.refill_pending || pool.sockets.size() >= pool.target_size)
+    return;
+  pool.refill_pending = true;
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&DefaultDnsSocketPool::OnRefill,
+                            weak_factory_.GetWeakPtr(), server_index));
+}
+
+void DefaultDnsSocketPool::OnRefill(unsigned server_index) {
+  ServerPool& pool = pools_[server_index];
+  pool.refill_pending = false;
+  FillPool(server_index, pool.target_size);
 }
 
 void DefaultDnsSocketPool::FillPool(unsigned server_index, unsigned size) {
-  SocketVector& pool = pools_[server_index];
+  SocketVector& pool = pools_[server_index].sockets;
 
   for (unsigned pool_index = pool.size(); pool_index < size; ++pool_index) {
     std::unique_ptr<DatagramClientSocket> socket =
@@ -60,9 +60,12 @@ class NET_EXPORT_PRIVATE DnsSocketPool {
       unsigned server_index) = 0;
 
   // Frees a socket allocated by AllocateSocket.  |server_index| must be the
-  // same index passed to AllocateSocket.
+  // same index passed to AllocateSocket.  |reusable| is true if the socket
+  // received the answer to its query, so that no responses are pending on it
+  // and it may be allocated again.
   virtual void FreeSocket(unsigned server_index,
-                          std::unique_ptr<DatagramClientSocket> socket) = 0;
+                          std::unique_ptr<DatagramClientSocket> socket,
+                          bool reusable) = 0;
 
   // Creates a StreamSocket from the factory for a transaction over TCP. These
   // sockets are not pooled.
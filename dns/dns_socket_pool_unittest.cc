@@ -4,11 +4,20 @@
 
 #include "net/dns/dns_socket_pool.h"
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/rand_util.h"
+#include "net/base/ip_address.h"
+#include "net/base/ip_endpoint.h"
 #include "net/base/rand_callback.h"
+#include "net/dns/dns_protocol.h"
 #include "net/socket/client_socket_factory.h"
+#include "net/socket/datagram_client_socket.h"
+#include "net/socket/socket_test_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -104,5 +113,45 @@ TEST_F(DnsSocketPoolTest, NullCopiesCallback) {
   EXPECT_TRUE(dummy_.HasRefs());
 }
 
+#if !defined(OS_WIN)
+// Tests that the default pool reuses a socket whose query was answered for a
+// bounded number of queries, and closes the other sockets.
+TEST_F(DnsSocketPoolTest, DefaultReusesAnsweredSockets) {
+  base::MessageLoop message_loop;
+  MockClientSocketFactory factory;
+  StaticSocketDataProvider data[3];
+  for (StaticSocketDataProvider& provider : data)
+    factory.AddSocketDataProvider(&provider);
+
+  pool_ = DnsSocketPool::CreateDefault(&factory, base::Bind(&base::RandInt));
+  std::vector<IPEndPoint> nameservers = {
+      IPEndPoint(IPAddress(192, 168, 1, 1), dns_protocol::kDefaultPort)};
+  pool_->Initialize(&nameservers, nullptr);
+
+  std::unique_ptr<DatagramClientSocket> socket = pool_->AllocateSocket(0);
+  ASSERT_TRUE(socket);
+  DatagramClientSocket* first_socket = socket.get();
+  for (int i = 1; i < 4; ++i) {
+    pool_->FreeSocket(0, std::move(socket), true /* reusable */);
+    socket = pool_->AllocateSocket(0);
+    EXPECT_EQ(first_socket, socket.get());
+  }
+  EXPECT_EQ(1u, factory.udp_client_socket_ports().size());
+
+  // The socket was used for as many queries as allowed.
+  pool_->FreeSocket(0, std::move(socket), true /* reusable */);
+  socket = pool_->AllocateSocket(0);
+  ASSERT_TRUE(socket);
+  EXPECT_EQ(2u, factory.udp_client_socket_ports().size());
+
+  // A socket whose query was not answered is not reused.
+  pool_->FreeSocket(0, std::move(socket), false /* reusable */);
+  socket = pool_->AllocateSocket(0);
+  ASSERT_TRUE(socket);
+  EXPECT_EQ(3u, factory.udp_client_socket_ports().size());
+  pool_->FreeSocket(0, std::move(socket), false /* reusable */);
+}
+#endif  // !defined(OS_WIN)
+
 }  // namespace
 }  // namespace net
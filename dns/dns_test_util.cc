@@ -182,6 +182,8 @@ class MockTransactionFactory : public DnsTransactionFactory {
     NOTREACHED() << "Not implemented";
   }
 
+  void SetRequestContext(URLRequestContext* url_request_context) override {}
+
   void CompleteDelayedTransactions() {
     DelayedTransactionList old_delayed_transactions;
     old_delayed_transactions.swap(delayed_transactions_);
@@ -230,6 +232,9 @@ std::unique_ptr<const base::Value> MockDnsClient::GetPersistentData() const {
   return std::unique_ptr<const base::Value>();
 }
 
+void MockDnsClient::SetRequestContext(URLRequestContext* url_request_context) {
+}
+
 void MockDnsClient::CompleteDelayedTransactions() {
   factory_->CompleteDelayedTransactions();
 }
@@ -206,6 +206,7 @@ class MockDnsClient : public DnsClient {
   AddressSorter* GetAddressSorter() override;
   void ApplyPersistentData(const base::Value& data) override;
   std::unique_ptr<const base::Value> GetPersistentData() const override;
+  void SetRequestContext(URLRequestContext* url_request_context) override;
 
   // Completes all DnsTransactions that were delayed by a rule.
   void CompleteDelayedTransactions();
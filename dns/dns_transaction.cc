@@ -4,13 +4,17 @@
 
 #include "net/dns/dns_transaction.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "base/base64url.h"
 #include "base/big_endian.h"
 #include "base/bind.h"
+#include "base/callback_helpers.h"
 #include "base/containers/circular_deque.h"
 #include "base/location.h"
 #include "base/macros.h"
@@ -22,20 +26,27 @@
 #include "base/single_thread_task_runner.h"
 #include "base/stl_util.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "base/threading/thread_checker.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/timer/timer.h"
 #include "base/values.h"
 #include "net/base/completion_callback.h"
+#include "net/base/elements_upload_data_stream.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_address.h"
 #include "net/base/ip_endpoint.h"
+#include "net/base/load_flags.h"
 #include "net/base/net_errors.h"
+#include "net/base/upload_bytes_element_reader.h"
+#include "net/dns/dns_config_service.h"
 #include "net/dns/dns_protocol.h"
 #include "net/dns/dns_query.h"
 #include "net/dns/dns_response.h"
 #include "net/dns/dns_session.h"
 #include "net/dns/dns_util.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
 #include "net/log/net_log.h"
 #include "net/log/net_log_capture_mode.h"
 #include "net/log/net_log_event_type.h"
@@ -43,11 +54,27 @@
 #include "net/log/net_log_with_source.h"
 #include "net/socket/datagram_client_socket.h"
 #include "net/socket/stream_socket.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
+#include "net/url_request/redirect_info.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_context.h"
+#include "url/gurl.h"
 
 namespace net {
 
 namespace {
 
+const char kDnsMessageContentType[] = "application/dns-message";
+
+// DNS over HTTPS queries are padded to a multiple of this size, as recommended
+// by RFC 8467 section 4.1.
+const size_t kDnsOverHttpsPaddingBlockSize = 128;
+
+// Timeout for each DNS over HTTPS attempt. Its request may have to wait for a
+// connection and a TLS handshake first, which the DnsConfig timeout meant for
+// a single datagram does not account for.
+const int kDnsOverHttpsAttemptTimeoutMs = 5000;
+
 // Count labels in the fully-qualified name in DNS format.
 int CountLabels(const std::string& name) {
   size_t count = 0;
@@ -61,6 +88,65 @@ bool IsIPLiteral(const std::string& hostname) {
   return ip.AssignFromIPLiteral(hostname);
 }
 
+// Returns true if |hostname| is the host of one of the DNS over HTTPS
+// |servers|, which have to be resolved without them.
+bool IsDnsOverHttpsServerHost(
+    const std::string& hostname,
+    const std::vector<DnsConfig::DnsOverHttpsServerConfig>& servers) {
+  base::StringPiece name(hostname);
+  if (name.ends_with("."))
+    name.remove_suffix(1);
+  for (const DnsConfig::DnsOverHttpsServerConfig& server : servers) {
+    if (base::EqualsCaseInsensitiveASCII(server.server.host_piece(), name))
+      return true;
+  }
+  return false;
+}
+
+// Builds the query sent to a DNS over HTTPS server. Its ID is zero, so that
+// identical queries make identical requests (RFC 8484 section 4.1), and it is
+// padded, so that its size reveals little about |qname|.
+std::unique_ptr<DnsQuery> CreateDnsOverHttpsQuery(
+    const std::string& qname,
+    uint16_t qtype,
+    const OptRecordRdata* opt_rdata) {
+  OptRecordRdata padded_rdata;
+  if (opt_rdata) {
+    for (const OptRecordRdata::Opt& opt : opt_rdata->opts())
+      padded_rdata.AddOpt(opt);
+  }
+  size_t unpadded_size =
+      DnsQuery(0, qname, qtype, &padded_rdata).io_buffer()->size() +
+      OptRecordRdata::Opt::kHeaderSize;
+  size_t padding_size =
+      (kDnsOverHttpsPaddingBlockSize -
+       unpadded_size % kDnsOverHttpsPaddingBlockSize) %
+      kDnsOverHttpsPaddingBlockSize;
+  padded_rdata.AddOpt(OptRecordRdata::Opt(dns_protocol::kEdnsPadding,
+                                          std::string(padding_size, '\0')));
+  return std::make_unique<DnsQuery>(0, qname, qtype, &padded_rdata);
+}
+
+// Lowers the TTLs of the answers in |response| by |age|, the time the response
+// spent in HTTP caches, and to at most |max_ttl|, what remains of its HTTP
+// freshness lifetime (RFC 8484 section 5.1).
+void AdjustTTLsForHttpFreshness(DnsResponse* response,
+                                uint32_t age,
+                                uint32_t max_ttl) {
+  DnsRecordParser parser = response->Parser();
+  for (unsigned i = 0; i < response->answer_count(); ++i) {
+    DnsResourceRecord record;
+    if (!parser.ReadRecord(&record))
+      return;
+    uint32_t ttl = record.ttl > age ? record.ttl - age : 0;
+    ttl = std::min(ttl, max_ttl);
+    // The TTL is followed by the RDLENGTH and the RDATA.
+    size_t ttl_offset = record.rdata.data() - response->io_buffer()->data() -
+                        sizeof(uint16_t) - sizeof(uint32_t);
+    base::WriteBigEndian(response->io_buffer()->data() + ttl_offset, ttl);
+  }
+}
+
 std::unique_ptr<base::Value> NetLogStartCallback(
     const std::string* hostname,
     uint16_t qtype,
@@ -266,6 +352,8 @@ class DnsUDPAttempt : public DnsAttempt {
       next_state_ = STATE_READ_RESPONSE;
       return OK;
     }
+    // Unless stray responses arrived, nothing more is expected on the socket.
+    socket_lease_->set_reusable(!received_malformed_response_);
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_DNS_SERVER_REQUIRES_TCP;
     // TODO(szym): Extract TTL for NXDOMAIN results. http://crbug.com/115051
@@ -539,6 +627,224 @@ class DnsTCPAttempt : public DnsAttempt {
   DISALLOW_COPY_AND_ASSIGN(DnsTCPAttempt);
 };
 
+// Sends the query to a DNS over HTTPS server as an HTTP request. Requests to
+// the same server share its connection, which with HTTP/2 multiplexes all the
+// queries in flight.
+class DnsHTTPAttempt : public DnsAttempt, public URLRequest::Delegate {
+ public:
+  DnsHTTPAttempt(unsigned server_index,
+                 std::unique_ptr<DnsQuery> query,
+                 const DnsConfig::DnsOverHttpsServerConfig& server,
+                 URLRequestContext* url_request_context)
+      : DnsAttempt(server_index), query_(std::move(query)) {
+    net::NetworkTrafficAnnotationTag traffic_annotation =
+        net::DefineNetworkTrafficAnnotation("dns_over_https", R"(
+        semantics {
+          sender: "DNS over HTTPS"
+          description:
+            "Looks up the address of a host with a DNS over HTTPS server "
+            "rather than with the resolvers of the system."
+          trigger:
+            "A host name is resolved while DNS over HTTPS servers are "
+            "configured."
+          data: "The DNS query, which includes the host name."
+          destination: OTHER
+        }
+        policy {
+          cookies_allowed: NO
+          setting: "This feature cannot be disabled by settings."
+          policy_exception_justification: "Not implemented."
+        })");
+
+    base::StringPiece query_data(query_->io_buffer()->data(),
+                                 query_->io_buffer()->size());
+    GURL url = server.server;
+    if (!server.use_post) {
+      std::string encoded_query;
+      base::Base64UrlEncode(query_data,
+                            base::Base64UrlEncodePolicy::OMIT_PADDING,
+                            &encoded_query);
+      std::string url_query = url.query();
+      if (!url_query.empty())
+        url_query += "&";
+      url_query += "dns=" + encoded_query;
+      GURL::Replacements replacements;
+      replacements.SetQueryStr(url_query);
+      url = url.ReplaceComponents(replacements);
+    }
+
+    request_ = url_request_context->CreateRequest(url, HIGHEST, this,
+                                                  traffic_annotation);
+    request_->SetLoadFlags(LOAD_DISABLE_CACHE | LOAD_DO_NOT_SAVE_COOKIES |
+                           LOAD_DO_NOT_SEND_COOKIES |
+                           LOAD_DO_NOT_SEND_AUTH_DATA);
+    request_->SetExtraRequestHeaderByName(HttpRequestHeaders::kAccept,
+                                          kDnsMessageContentType, true);
+    if (server.use_post) {
+      request_->set_method("POST");
+      request_->SetExtraRequestHeaderByName(HttpRequestHeaders::kContentType,
+                                            kDnsMessageContentType, true);
+      std::vector<char> body(query_data.begin(), query_data.end());
+      request_->set_upload(ElementsUploadDataStream::CreateWithReader(
+          std::make_unique<UploadOwnedBytesElementReader>(&body), 0));
+    }
+  }
+
+  // DnsAttempt:
+  int Start(const CompletionCallback& callback) override {
+    callback_ = callback;
+    start_time_ = base::TimeTicks::Now();
+    set_result(ERR_IO_PENDING);
+    request_->Start();
+    return ERR_IO_PENDING;
+  }
+
+  const DnsQuery* GetQuery() const override { return query_.get(); }
+
+  const DnsResponse* GetResponse() const override {
+    const DnsResponse* resp = response_.get();
+    return (resp != NULL && resp->IsValid()) ? resp : NULL;
+  }
+
+  const NetLogWithSource& GetSocketNetLog() const override {
+    return request_->net_log();
+  }
+
+  // URLRequest::Delegate:
+  void OnReceivedRedirect(URLRequest* request,
+                          const RedirectInfo& redirect_info,
+                          bool* defer_redirect) override {
+    // RFC 8484 section 5.2 requires https.
+    if (!redirect_info.new_url.SchemeIsCryptographic())
+      Complete(ERR_UNSAFE_REDIRECT);
+  }
+
+  void OnResponseStarted(URLRequest* request, int net_error) override {
+    DCHECK_NE(ERR_IO_PENDING, net_error);
+    if (callback_.is_null())
+      return;
+    // The transaction takes ERR_NAME_NOT_RESOLVED for an answer to the query,
+    // not a failure to resolve the server.
+    if (net_error == ERR_NAME_NOT_RESOLVED)
+      net_error = ERR_DNS_SERVER_FAILED;
+    if (net_error != OK) {
+      Complete(net_error);
+      return;
+    }
+
+    std::string mime_type;
+    if (request->GetResponseCode() != 200 ||
+        !request->response_headers()->GetMimeType(&mime_type) ||
+        mime_type != kDnsMessageContentType) {
+      Complete(ERR_DNS_MALFORMED_RESPONSE);
+      return;
+    }
+
+    buffer_ = new GrowableIOBuffer();
+    buffer_->SetCapacity(dns_protocol::kMaxUDPSize);
+    ReadResponseBody();
+  }
+
+  void OnReadCompleted(URLRequest* request, int bytes_read) override {
+    if (callback_.is_null())
+      return;
+    if (OnBodyRead(bytes_read))
+      ReadResponseBody();
+  }
+
+ private:
+  void ReadResponseBody() {
+    int rv;
+    do {
+      if (buffer_->RemainingCapacity() == 0)
+        buffer_->SetCapacity(buffer_->capacity() * 2);
+      rv = request_->Read(buffer_.get(), buffer_->RemainingCapacity());
+    } while (rv != ERR_IO_PENDING && OnBodyRead(rv));
+  }
+
+  // Returns true if more of the body is to be read.
+  bool OnBodyRead(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv < 0) {
+      Complete(rv);
+      return false;
+    }
+    if (rv == 0) {
+      Complete(ParseResponse());
+      return false;
+    }
+    buffer_->set_offset(buffer_->offset() + rv);
+    // A DNS message cannot exceed 65535 bytes (RFC 8484 section 6).
+    if (buffer_->offset() > std::numeric_limits<uint16_t>::max()) {
+      Complete(ERR_DNS_MALFORMED_RESPONSE);
+      return false;
+    }
+    return true;
+  }
+
+  int ParseResponse() {
+    int size = buffer_->offset();
+    if (size == 0)
+      return ERR_DNS_MALFORMED_RESPONSE;
+    // Allocate more space so that DnsResponse::InitParse sanity check passes.
+    response_.reset(new DnsResponse(size + 1));
+    memcpy(response_->io_buffer()->data(), buffer_->StartOfBuffer(), size);
+    buffer_ = nullptr;
+    if (!response_->InitParse(size, *query_))
+      return ERR_DNS_MALFORMED_RESPONSE;
+    if (response_->rcode() == dns_protocol::kRcodeNXDOMAIN)
+      return ERR_NAME_NOT_RESOLVED;
+    if (response_->rcode() != dns_protocol::kRcodeNOERROR)
+      return ERR_DNS_SERVER_FAILED;
+
+    base::TimeDelta age;
+    base::TimeDelta max_age;
+    const HttpResponseHeaders* headers = request_->response_headers();
+    bool has_age = headers->GetAgeValue(&age);
+    if (!headers->GetMaxAgeValue(&max_age))
+      max_age = base::TimeDelta::Max();
+    if (has_age || !max_age.is_max()) {
+      uint32_t age_seconds =
+          static_cast<uint32_t>(std::max<int64_t>(age.InSeconds(), 0));
+      uint32_t max_ttl = std::numeric_limits<uint32_t>::max();
+      if (!max_age.is_max()) {
+        max_ttl = static_cast<uint32_t>(std::min<int64_t>(
+            std::max<int64_t>((max_age - age).InSeconds(), 0), max_ttl));
+      }
+      AdjustTTLsForHttpFreshness(response_.get(), age_seconds, max_ttl);
+    }
+    return OK;
+  }
+
+  void Complete(int rv) {
+    CompletionCallback callback = base::ResetAndReturn(&callback_);
+    set_result(rv);
+    if (rv == OK) {
+      UMA_HISTOGRAM_LONG_TIMES_100("AsyncDNS.HTTPAttemptSuccess",
+                                   base::TimeTicks::Now() - start_time_);
+    } else {
+      UMA_HISTOGRAM_LONG_TIMES_100("AsyncDNS.HTTPAttemptFail",
+                                   base::TimeTicks::Now() - start_time_);
+    }
+    // Stops further delegate calls, but keeps |request_| for its NetLog.
+    if (rv != OK)
+      request_->Cancel();
+    callback.Run(rv);
+  }
+
+  base::TimeTicks start_time_;
+
+  std::unique_ptr<DnsQuery> query_;
+  std::unique_ptr<URLRequest> request_;
+  scoped_refptr<GrowableIOBuffer> buffer_;
+
+  std::unique_ptr<DnsResponse> response_;
+
+  CompletionCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsHTTPAttempt);
+};
+
 // ----------------------------------------------------------------------------
 
 // Implements DnsTransaction. Configuration is supplied by DnsSession.
@@ -547,6 +853,9 @@ class DnsTCPAttempt : public DnsAttempt {
 // The first server to attempt on each query is given by
 // DnsSession::NextFirstServerIndex, and the order is round-robin afterwards.
 // Each server is attempted DnsConfig::attempts times.
+// If the DnsConfig lists DNS over HTTPS servers and the factory has a
+// URLRequestContext, DnsHTTPAttempts to them replace the DnsUDPAttempts,
+// starting with the first server on each query.
 class DnsTransactionImpl : public DnsTransaction,
                            public base::SupportsWeakPtr<DnsTransactionImpl> {
  public:
@@ -555,11 +864,19 @@ class DnsTransactionImpl : public DnsTransaction,
                      uint16_t qtype,
                      const DnsTransactionFactory::CallbackType& callback,
                      const NetLogWithSource& net_log,
-                     const OptRecordRdata* opt_rdata)
+                     const OptRecordRdata* opt_rdata,
+                     URLRequestContext* url_request_context)
       : session_(session),
         hostname_(hostname),
         qtype_(qtype),
         opt_rdata_(opt_rdata),
+        url_request_context_(url_request_context),
+        uses_dns_over_https_(
+            url_request_context &&
+            !session->config().dns_over_https_servers.empty() &&
+            !IsDnsOverHttpsServerHost(
+                hostname,
+                session->config().dns_over_https_servers)),
         callback_(callback),
         net_log_(net_log),
         qnames_initial_size_(0),
@@ -705,6 +1022,9 @@ class DnsTransactionImpl : public DnsTransaction,
   // Makes another attempt at the current name, |qnames_.front()|, using the
   // next nameserver.
   AttemptResult MakeAttempt() {
+    if (uses_dns_over_https_)
+      return MakeHTTPAttempt();
+
     unsigned attempt_number = attempts_.size();
 
     uint16_t id = session_->NextQueryId();
@@ -752,6 +1072,38 @@ class DnsTransactionImpl : public DnsTransaction,
     return AttemptResult(rv, attempt);
   }
 
+  // Like MakeAttempt(), but with the next DNS over HTTPS server.
+  AttemptResult MakeHTTPAttempt() {
+    unsigned attempt_number = attempts_.size();
+
+    const DnsConfig& config = session_->config();
+    unsigned server_index = (first_server_index_ + attempt_number) %
+                            config.dns_over_https_servers.size();
+
+    DnsHTTPAttempt* attempt = new DnsHTTPAttempt(
+        server_index,
+        CreateDnsOverHttpsQuery(qnames_.front(), qtype_, opt_rdata_),
+        config.dns_over_https_servers[server_index], url_request_context_);
+
+    attempts_.push_back(base::WrapUnique(attempt));
+    ++attempts_count_;
+
+    net_log_.AddEvent(
+        NetLogEventType::DNS_TRANSACTION_HTTPS_ATTEMPT,
+        attempt->GetSocketNetLog().source().ToEventParametersCallback());
+
+    int rv = attempt->Start(base::Bind(&DnsTransactionImpl::OnAttemptComplete,
+                                       base::Unretained(this),
+                                       attempt_number));
+    if (rv == ERR_IO_PENDING) {
+      timer_.Start(
+          FROM_HERE,
+          base::TimeDelta::FromMilliseconds(kDnsOverHttpsAttemptTimeoutMs),
+          this, &DnsTransactionImpl::OnTimeout);
+    }
+    return AttemptResult(rv, attempt);
+  }
+
   AttemptResult MakeTCPAttempt(const DnsAttempt* previous_attempt) {
     DCHECK(previous_attempt);
     DCHECK(!had_tcp_attempt_);
@@ -807,7 +1159,9 @@ class DnsTransactionImpl : public DnsTransaction,
     net_log_.BeginEvent(NetLogEventType::DNS_TRANSACTION_QUERY,
                         NetLog::StringCallback("qname", &dotted_qname));
 
-    first_server_index_ = session_->NextFirstServerIndex();
+    // Keep DNS over HTTPS queries on the connection to the first server.
+    first_server_index_ =
+        uses_dns_over_https_ ? 0 : session_->NextFirstServerIndex();
     RecordLostPacketsIfAny();
     attempts_.clear();
     had_tcp_attempt_ = false;
@@ -838,6 +1192,10 @@ class DnsTransactionImpl : public DnsTransaction,
 
   // Record packet loss for any incomplete attempts.
   void RecordLostPacketsIfAny() {
+    // The session only keeps statistics on DnsConfig::nameservers.
+    if (uses_dns_over_https_)
+      return;
+
     // Loop through attempts until we find first that is completed
     size_t first_completed = 0;
     for (first_completed = 0; first_completed < attempts_.size();
@@ -874,7 +1232,20 @@ class DnsTransactionImpl : public DnsTransaction,
     if (had_tcp_attempt_)
       return false;
     const DnsConfig& config = session_->config();
-    return attempts_.size() < config.attempts * config.nameservers.size();
+    size_t num_servers = uses_dns_over_https_
+                             ? config.dns_over_https_servers.size()
+                             : config.nameservers.size();
+    return attempts_.size() < config.attempts * num_servers;
+  }
+
+  void RecordServerSuccess(const DnsAttempt* attempt) {
+    if (!uses_dns_over_https_)
+      session_->RecordServerSuccess(attempt->server_index());
+  }
+
+  void RecordServerFailure(const DnsAttempt* attempt) {
+    if (!uses_dns_over_https_)
+      session_->RecordServerFailure(attempt->server_index());
   }
 
   // Resolves the result of a DnsAttempt until a terminal result is reached
@@ -885,14 +1256,14 @@ class DnsTransactionImpl : public DnsTransaction,
 
       switch (result.rv) {
         case OK:
-          session_->RecordServerSuccess(result.attempt->server_index());
+          RecordServerSuccess(result.attempt);
           net_log_.EndEventWithNetErrorCode(
               NetLogEventType::DNS_TRANSACTION_QUERY, result.rv);
           DCHECK(result.attempt);
           DCHECK(result.attempt->GetResponse());
           return result;
         case ERR_NAME_NOT_RESOLVED:
-          session_->RecordServerSuccess(result.attempt->server_index());
+          RecordServerSuccess(result.attempt);
           net_log_.EndEventWithNetErrorCode(
               NetLogEventType::DNS_TRANSACTION_QUERY, result.rv);
           // Try next suffix. Check that qnames_ isn't already empty first,
@@ -910,7 +1281,7 @@ class DnsTransactionImpl : public DnsTransaction,
         case ERR_CONNECTION_REFUSED:
         case ERR_DNS_TIMED_OUT:
           if (result.attempt)
-            session_->RecordServerFailure(result.attempt->server_index());
+            RecordServerFailure(result.attempt);
           if (MoreAttemptsAllowed()) {
             result = MakeAttempt();
           } else {
@@ -925,13 +1296,13 @@ class DnsTransactionImpl : public DnsTransaction,
           DCHECK(result.attempt);
           if (result.attempt != attempts_.back().get()) {
             // This attempt already timed out. Ignore it.
-            session_->RecordServerFailure(result.attempt->server_index());
+            RecordServerFailure(result.attempt);
             return AttemptResult(ERR_IO_PENDING, NULL);
           }
           if (MoreAttemptsAllowed()) {
             result = MakeAttempt();
           } else if (result.rv == ERR_DNS_MALFORMED_RESPONSE &&
-                     !had_tcp_attempt_) {
+                     !had_tcp_attempt_ && !uses_dns_over_https_) {
             // For UDP only, ignore the response and wait until the last attempt
             // times out.
             return AttemptResult(ERR_IO_PENDING, NULL);
@@ -958,6 +1329,8 @@ class DnsTransactionImpl : public DnsTransaction,
   std::string hostname_;
   uint16_t qtype_;
   const OptRecordRdata* opt_rdata_;
+  URLRequestContext* url_request_context_;
+  const bool uses_dns_over_https_;
   // Cleared in DoCallback.
   DnsTransactionFactory::CallbackType callback_;
 
@@ -989,7 +1362,9 @@ class DnsTransactionImpl : public DnsTransaction,
 // DnsTransactionImpl.
 class DnsTransactionFactoryImpl : public DnsTransactionFactory {
  public:
-  explicit DnsTransactionFactoryImpl(DnsSession* session) {
+  DnsTransactionFactoryImpl(DnsSession* session,
+                            URLRequestContext* url_request_context)
+      : url_request_context_(url_request_context) {
     session_ = session;
   }
 
@@ -999,7 +1374,8 @@ class DnsTransactionFactoryImpl : public DnsTransactionFactory {
       const CallbackType& callback,
       const NetLogWithSource& net_log) override {
     return std::unique_ptr<DnsTransaction>(new DnsTransactionImpl(
-        session_.get(), hostname, qtype, callback, net_log, opt_rdata_.get()));
+        session_.get(), hostname, qtype, callback, net_log, opt_rdata_.get(),
+        url_request_context_));
   }
 
   void AddEDNSOption(const OptRecordRdata::Opt& opt) override {
@@ -1009,8 +1385,13 @@ class DnsTransactionFactoryImpl : public DnsTransactionFactory {
     opt_rdata_->AddOpt(opt);
   }
 
+  void SetRequestContext(URLRequestContext* url_request_context) override {
+    url_request_context_ = url_request_context;
+  }
+
  private:
   scoped_refptr<DnsSession> session_;
+  URLRequestContext* url_request_context_;
   std::unique_ptr<OptRecordRdata> opt_rdata_;
 };
 
@@ -1018,9 +1399,10 @@ class DnsTransactionFactoryImpl : public DnsTransactionFactory {
 
 // static
 std::unique_ptr<DnsTransactionFactory> DnsTransactionFactory::CreateFactory(
-    DnsSession* session) {
+    DnsSession* session,
+    URLRequestContext* url_request_context) {
   return std::unique_ptr<DnsTransactionFactory>(
-      new DnsTransactionFactoryImpl(session));
+      new DnsTransactionFactoryImpl(session, url_request_context));
 }
 
 }  // namespace net
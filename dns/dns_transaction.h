@@ -20,11 +20,13 @@ namespace net {
 class DnsResponse;
 class DnsSession;
 class NetLogWithSource;
+class URLRequestContext;
 
 // DnsTransaction implements a stub DNS resolver as defined in RFC 1034.
 // The DnsTransaction takes care of retransmissions, name server fallback (or
 // round-robin), suffix search, and simple response validation ("does it match
-// the query") to fight poisoning.
+// the query") to fight poisoning. When the DnsConfig lists DNS over HTTPS
+// servers, queries are sent to them as HTTP requests (RFC 8484) instead.
 //
 // Destroying DnsTransaction cancels the underlying network effort.
 class NET_EXPORT_PRIVATE DnsTransaction {
@@ -73,10 +75,18 @@ class NET_EXPORT_PRIVATE DnsTransactionFactory {
   // transactions from this factory.
   virtual void AddEDNSOption(const OptRecordRdata::Opt& opt) = 0;
 
+  // Sets the context used for DNS over HTTPS requests by transactions created
+  // after this call. Transactions already started keep the previous context,
+  // which must outlive them.
+  virtual void SetRequestContext(URLRequestContext* url_request_context) = 0;
+
   // Creates a DnsTransactionFactory which creates DnsTransactionImpl using the
-  // |session|.
+  // |session|. DNS over HTTPS requests are made with |url_request_context|,
+  // which may be null if they are not to be made. It must outlive the factory
+  // and its transactions.
   static std::unique_ptr<DnsTransactionFactory> CreateFactory(
-      DnsSession* session) WARN_UNUSED_RESULT;
+      DnsSession* session,
+      URLRequestContext* url_request_context) WARN_UNUSED_RESULT;
 };
 
 }  // namespace net
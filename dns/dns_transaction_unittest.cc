@@ -7,16 +7,21 @@
 #include <stdint.h>
 
 #include <limits>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "base/base64url.h"
 #include "base/bind.h"
 #include "base/containers/circular_deque.h"
 #include "base/macros.h"
 #include "base/message_loop/message_loop.h"
 #include "base/rand_util.h"
 #include "base/run_loop.h"
+#include "base/strings/string_util.h"
 #include "base/sys_byteorder.h"
 #include "base/test/test_timeouts.h"
+#include "net/base/address_list.h"
 #include "net/base/ip_address.h"
 #include "net/dns/dns_protocol.h"
 #include "net/dns/dns_query.h"
@@ -27,8 +32,13 @@
 #include "net/log/net_log_with_source.h"
 #include "net/socket/socket_test_util.h"
 #include "net/test/gtest_util.h"
+#include "net/url_request/url_request_filter.h"
+#include "net/url_request/url_request_interceptor.h"
+#include "net/url_request/url_request_test_job.h"
+#include "net/url_request/url_request_test_util.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
 
 using net::test::IsOk;
 
@@ -333,6 +343,52 @@ class TransactionHelper {
   bool completed_;
 };
 
+const char kDnsOverHttpsHostname[] = "dns.example";
+const char kDnsOverHttpsServer[] = "https://dns.example/dns-query";
+
+// Answers every DNS over HTTPS request with |response|, sent with the
+// |extra_headers|, and keeps the method and URL of the requests.
+class DnsOverHttpsInterceptor : public URLRequestInterceptor {
+ public:
+  DnsOverHttpsInterceptor(
+      const std::string& extra_headers,
+      const uint8_t* response,
+      size_t response_length,
+      std::vector<std::pair<std::string, GURL>>* requests)
+      : extra_headers_(extra_headers),
+        response_(reinterpret_cast<const char*>(response), response_length),
+        requests_(requests) {}
+
+  URLRequestJob* MaybeInterceptRequest(
+      URLRequest* request,
+      NetworkDelegate* network_delegate) const override {
+    requests_->emplace_back(request->method(), request->url());
+    return new URLRequestTestJob(
+        request, network_delegate,
+        "HTTP/1.1 200 OK\n"
+        "Content-Type: application/dns-message\n" +
+            extra_headers_ + "\n",
+        response_, true);
+  }
+
+ private:
+  std::string extra_headers_;
+  std::string response_;
+  std::vector<std::pair<std::string, GURL>>* requests_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsOverHttpsInterceptor);
+};
+
+void SaveResponseTTL(base::TimeDelta* ttl,
+                     DnsTransaction* transaction,
+                     int rv,
+                     const DnsResponse* response) {
+  ASSERT_THAT(rv, IsOk());
+  AddressList addresses;
+  EXPECT_EQ(DnsResponse::DNS_PARSE_OK,
+            response->ParseToAddressList(&addresses, ttl));
+}
+
 class DnsTransactionTest : public testing::Test {
  public:
   DnsTransactionTest() = default;
@@ -355,7 +411,24 @@ class DnsTransactionTest : public testing::Test {
                                            base::Bind(base::RandInt)),
         base::Bind(&DnsTransactionTest::GetNextId, base::Unretained(this)),
         NULL /* NetLog */);
-    transaction_factory_ = DnsTransactionFactory::CreateFactory(session_.get());
+    transaction_factory_ = DnsTransactionFactory::CreateFactory(
+        session_.get(), request_context_.get());
+  }
+
+  // Adds kDnsOverHttpsServer to |config_|, which answers with |response| and
+  // |extra_headers|.
+  void ConfigureDnsOverHttps(bool use_post,
+                             const std::string& extra_headers,
+                             const uint8_t* response,
+                             size_t response_length) {
+    config_.dns_over_https_servers.emplace_back(GURL(kDnsOverHttpsServer),
+                                                use_post);
+    URLRequestFilter::GetInstance()->AddHostnameInterceptor(
+        "https", kDnsOverHttpsHostname,
+        std::make_unique<DnsOverHttpsInterceptor>(
+            extra_headers, response, response_length, &https_requests_));
+    request_context_ = std::make_unique<TestURLRequestContext>();
+    ConfigureFactory();
   }
 
   void AddSocketData(std::unique_ptr<DnsSocketData> data) {
@@ -459,6 +532,7 @@ class DnsTransactionTest : public testing::Test {
   }
 
   void TearDown() override {
+    URLRequestFilter::GetInstance()->ClearHandlers();
     // Check that all socket data was at least written to.
     for (size_t i = 0; i < socket_data_.size(); ++i) {
       EXPECT_TRUE(socket_data_[i]->GetProvider()->AllWriteDataConsumed()) << i;
@@ -482,7 +556,10 @@ class DnsTransactionTest : public testing::Test {
   base::circular_deque<int> transaction_ids_;
   std::unique_ptr<TestSocketFactory> socket_factory_;
   scoped_refptr<DnsSession> session_;
+  std::unique_ptr<TestURLRequestContext> request_context_;
   std::unique_ptr<DnsTransactionFactory> transaction_factory_;
+  // The method and URL of each DNS over HTTPS request.
+  std::vector<std::pair<std::string, GURL>> https_requests_;
 };
 
 TEST_F(DnsTransactionTest, Lookup) {
@@ -1103,6 +1180,72 @@ TEST_F(DnsTransactionTest, MismatchedThenOkThenTCP) {
   EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
 }
 
+TEST_F(DnsTransactionTest, HttpsGetLookup) {
+  ConfigureDnsOverHttps(false /* use_post */, std::string(),
+                        kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+
+  ASSERT_EQ(1u, https_requests_.size());
+  EXPECT_EQ("GET", https_requests_[0].first);
+  const GURL& url = https_requests_[0].second;
+  EXPECT_EQ("/dns-query", url.path());
+  ASSERT_TRUE(base::StartsWith(url.query(), "dns=",
+                               base::CompareCase::SENSITIVE));
+
+  // The query has ID zero and is padded.
+  std::string query;
+  ASSERT_TRUE(base::Base64UrlDecode(
+      url.query().substr(4), base::Base64UrlDecodePolicy::DISALLOW_PADDING,
+      &query));
+  EXPECT_EQ(0u, query.size() % 128);
+  EXPECT_EQ(std::string(2, '\0'), query.substr(0, 2));
+}
+
+TEST_F(DnsTransactionTest, HttpsPostLookup) {
+  ConfigureDnsOverHttps(true /* use_post */, std::string(),
+                        kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+
+  TransactionHelper helper0(kT0HostName, kT0Qtype, kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+
+  ASSERT_EQ(1u, https_requests_.size());
+  EXPECT_EQ("POST", https_requests_[0].first);
+  EXPECT_EQ(GURL(kDnsOverHttpsServer), https_requests_[0].second);
+}
+
+// Tests that the TTLs are lowered by the Age of the response, and to what
+// remains of its max-age.
+TEST_F(DnsTransactionTest, HttpsLookupAdjustsTTLs) {
+  ConfigureDnsOverHttps(false /* use_post */,
+                        "Age: 100\nCache-Control: max-age=120\n",
+                        kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+
+  base::TimeDelta ttl;
+  std::unique_ptr<DnsTransaction> transaction =
+      transaction_factory_->CreateTransaction(
+          kT0HostName, kT0Qtype, base::Bind(&SaveResponseTTL, &ttl),
+          NetLogWithSource());
+  transaction->Start();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(base::TimeDelta::FromSeconds(20), ttl);
+}
+
+// Tests that the host of the DNS over HTTPS server is resolved with the name
+// servers.
+TEST_F(DnsTransactionTest, HttpsServerHostUsesNameservers) {
+  ConfigureDnsOverHttps(false /* use_post */, std::string(),
+                        kT0ResponseDatagram, arraysize(kT0ResponseDatagram));
+  AddAsyncQueryAndRcode(kDnsOverHttpsHostname, dns_protocol::kTypeA,
+                        dns_protocol::kRcodeNXDOMAIN);
+
+  TransactionHelper helper0(kDnsOverHttpsHostname, dns_protocol::kTypeA,
+                            ERR_NAME_NOT_RESOLVED);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+  EXPECT_TRUE(https_requests_.empty());
+}
+
 TEST_F(DnsTransactionTest, InvalidQuery) {
   config_.timeout = TestTimeouts::tiny_timeout();
   ConfigureFactory();
@@ -79,6 +79,7 @@ enum HostCache::EraseReason : int {
   ERASE_EVICT = 0,
   ERASE_CLEAR = 1,
   ERASE_DESTRUCT = 2,
+  ERASE_MEMORY_PRESSURE = 3,
   MAX_ERASE_REASON
 };
 
@@ -232,7 +233,7 @@ void HostCache::Set(const Key& key,
     result_changed =
         entry.error() == OK &&
         (it->second.error() != entry.error() || delta != DELTA_IDENTICAL);
-    entries_.erase(it);
+    EraseEntry(it);
   } else {
     result_changed = true;
     if (size() == max_entries_)
@@ -249,12 +250,36 @@ void HostCache::Set(const Key& key,
 void HostCache::AddEntry(const Key& key, Entry&& entry) {
   DCHECK_GT(max_entries_, size());
   DCHECK_EQ(0u, entries_.count(key));
-  entries_.emplace(key, std::move(entry));
+  auto it = entries_.emplace(key, std::move(entry)).first;
+  GetExpirationIndex(it->second)
+      ->emplace(it->second.expires(), &it->first);
   DCHECK_GE(max_entries_, size());
 }
 
+void HostCache::EraseEntry(EntryMap::iterator it) {
+  size_t erased = GetExpirationIndex(it->second)
+                      ->erase(std::make_pair(it->second.expires(), &it->first));
+  DCHECK_EQ(1u, erased);
+  entries_.erase(it);
+}
+
+HostCache::ExpirationIndex* HostCache::GetExpirationIndex(const Entry& entry) {
+  DCHECK_LE(entry.network_changes(), network_changes_);
+  return entry.network_changes() == network_changes_
+             ? &current_network_expirations_
+             : &previous_network_expirations_;
+}
+
 void HostCache::OnNetworkChange() {
   ++network_changes_;
+  // All entries are stale now.
+  if (previous_network_expirations_.empty()) {
+    previous_network_expirations_.swap(current_network_expirations_);
+  } else {
+    previous_network_expirations_.insert(current_network_expirations_.begin(),
+                                         current_network_expirations_.end());
+    current_network_expirations_.clear();
+  }
 }
 
 void HostCache::set_persistence_delegate(PersistenceDelegate* delegate) {
@@ -265,18 +290,49 @@ void HostCache::set_persistence_delegate(PersistenceDelegate* delegate) {
 }
 
 void HostCache::clear() {
+  ClearWithReason(ERASE_CLEAR);
+}
+
+void HostCache::ClearForMemoryPressure() {
+  ClearWithReason(ERASE_MEMORY_PRESSURE);
+}
+
+void HostCache::ClearWithReason(EraseReason reason) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
-  RecordEraseAll(ERASE_CLEAR, base::TimeTicks::Now());
+  RecordEraseAll(reason, base::TimeTicks::Now());
 
   // Don't bother scheduling a write if there's nothing to clear.
   if (size() == 0)
     return;
 
   entries_.clear();
+  current_network_expirations_.clear();
+  previous_network_expirations_.clear();
   if (delegate_)
     delegate_->ScheduleWrite();
 }
 
+void HostCache::EvictStaleEntries(base::TimeTicks now) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  size_t old_size = size();
+
+  auto erase_first = [this, now](const ExpirationIndex& index) {
+    auto it = entries_.find(*index.begin()->second);
+    DCHECK(it != entries_.end());
+    RecordErase(ERASE_MEMORY_PRESSURE, now, it->second);
+    EraseEntry(it);
+  };
+  while (!previous_network_expirations_.empty())
+    erase_first(previous_network_expirations_);
+  while (!current_network_expirations_.empty() &&
+         current_network_expirations_.begin()->first <= now) {
+    erase_first(current_network_expirations_);
+  }
+
+  if (delegate_ && size() != old_size)
+    delegate_->ScheduleWrite();
+}
+
 void HostCache::ClearForHosts(
     const base::Callback<bool(const std::string&)>& host_filter) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
@@ -293,7 +349,7 @@ void HostCache::ClearForHosts(
 
     if (host_filter.Run(it->first.hostname)) {
       RecordErase(ERASE_CLEAR, now, it->second);
-      entries_.erase(it);
+      EraseEntry(it);
       changed = true;
     }
 
@@ -436,19 +492,28 @@ std::unique_ptr<HostCache> HostCache::CreateDefaultCache() {
 void HostCache::EvictOneEntry(base::TimeTicks now) {
   DCHECK_LT(0u, entries_.size());
 
-  auto oldest_it = entries_.begin();
-  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
-    if ((it->second.expires() < oldest_it->second.expires()) &&
-        (it->second.IsStale(now, network_changes_) ||
-         !oldest_it->second.IsStale(now, network_changes_))) {
-      oldest_it = it;
-    }
+  // Evict the stale entry which expires first, or if there is none, the entry
+  // which expires first. All entries from previous networks are stale, while
+  // those from the current network are stale once they expire.
+  auto current_it = current_network_expirations_.begin();
+  auto previous_it = previous_network_expirations_.begin();
+  const Key* oldest_key;
+  if (previous_it == previous_network_expirations_.end()) {
+    oldest_key = current_it->second;
+  } else if (current_it == current_network_expirations_.end() ||
+             current_it->first > now ||
+             ExpirationOrder()(*previous_it, *current_it)) {
+    oldest_key = previous_it->second;
+  } else {
+    oldest_key = current_it->second;
   }
+  auto oldest_it = entries_.find(*oldest_key);
+  DCHECK(oldest_it != entries_.end());
 
   if (!eviction_callback_.is_null())
     eviction_callback_.Run(oldest_it->first, oldest_it->second);
   RecordErase(ERASE_EVICT, now, oldest_it->second);
-  entries_.erase(oldest_it);
+  EraseEntry(oldest_it);
 }
 
 void HostCache::RecordSet(SetOutcome outcome,
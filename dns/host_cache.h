@@ -10,8 +10,10 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
+#include <utility>
 
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
@@ -104,6 +106,10 @@ class NET_EXPORT HostCache {
     // Public for the net-internals UI.
     int network_changes() const { return network_changes_; }
 
+    // Number of lookups that returned this entry, fresh or stale. Used by
+    // HostResolverImpl to find popular hosts.
+    int total_hits() const { return total_hits_; }
+
    private:
     friend class HostCache;
 
@@ -118,7 +124,6 @@ class NET_EXPORT HostCache {
           base::TimeTicks expires,
           int network_changes);
 
-    int total_hits() const { return total_hits_; }
     int stale_hits() const { return stale_hits_; }
 
     bool IsStale(base::TimeTicks now, int network_changes) const;
@@ -192,6 +197,14 @@ class NET_EXPORT HostCache {
   // Empties the cache.
   void clear();
 
+  // Empties the cache to free memory under memory pressure.
+  void ClearForMemoryPressure();
+
+  // Removes the entries which are stale at |now|: those which have expired,
+  // and those received on a previous network. Used to free memory under memory
+  // pressure.
+  void EvictStaleEntries(base::TimeTicks now);
+
   // Clears hosts matching |host_filter| from the cache.
   void ClearForHosts(
       const base::Callback<bool(const std::string&)>& host_filter);
@@ -227,6 +240,18 @@ class NET_EXPORT HostCache {
   enum LookupOutcome : int;
   enum EraseReason : int;
 
+  // Orders entries by expiration time, and then by key.
+  struct ExpirationOrder {
+    bool operator()(const std::pair<base::TimeTicks, const Key*>& a,
+                    const std::pair<base::TimeTicks, const Key*>& b) const {
+      return std::tie(a.first, *a.second) < std::tie(b.first, *b.second);
+    }
+  };
+
+  // The keys point into |entries_|.
+  using ExpirationIndex =
+      std::set<std::pair<base::TimeTicks, const Key*>, ExpirationOrder>;
+
   Entry* LookupInternal(const Key& key);
 
   void RecordSet(SetOutcome outcome,
@@ -246,12 +271,27 @@ class NET_EXPORT HostCache {
   bool caching_is_disabled() const { return max_entries_ == 0; }
 
   void EvictOneEntry(base::TimeTicks now);
+  // Empties the cache, recording |reason| for each erased entry.
+  void ClearWithReason(EraseReason reason);
   // Helper to insert an Entry into the cache.
   void AddEntry(const Key& key, Entry&& entry);
 
+  // Helper to remove an Entry from the cache.
+  void EraseEntry(EntryMap::iterator it);
+
+  // Returns the index which holds |entry|.
+  ExpirationIndex* GetExpirationIndex(const Entry& entry);
+
   // Map from hostname (presumably in lowercase canonicalized format) to
   // a resolved result entry.
   EntryMap entries_;
+
+  // |entries_| ordered by expiration time, so that EvictOneEntry() does not
+  // need to scan them. The entries received on the current network and those
+  // stale because of a network change are indexed separately.
+  ExpirationIndex current_network_expirations_;
+  ExpirationIndex previous_network_expirations_;
+
   size_t max_entries_;
   int network_changes_;
   EvictionCallback eviction_callback_;
@@ -28,6 +28,10 @@ HostCache::Key Key(const std::string& hostname) {
   return HostCache::Key(hostname, ADDRESS_FAMILY_UNSPECIFIED, 0);
 }
 
+bool HostnameIsHost7(const std::string& hostname) {
+  return hostname == "host7.com";
+}
+
 bool FoobarIndexIsOdd(const std::string& foobarx_com) {
   return (foobarx_com[6] - '0') % 2 == 1;
 }
@@ -323,6 +327,36 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+TEST(HostCacheTest, EvictStaleEntries) {
+  const base::TimeDelta kShortTTL = base::TimeDelta::FromSeconds(5);
+  const base::TimeDelta kLongTTL = base::TimeDelta::FromSeconds(20);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Set t=0.
+  base::TimeTicks now;
+
+  HostCache::Entry entry =
+      HostCache::Entry(OK, AddressList(), HostCache::Entry::SOURCE_UNKNOWN);
+
+  cache.Set(Key("previous.com"), entry, now, kLongTTL);
+  cache.OnNetworkChange();
+  cache.Set(Key("short.com"), entry, now, kShortTTL);
+  cache.Set(Key("long.com"), entry, now, kLongTTL);
+  EXPECT_EQ(3u, cache.size());
+
+  // At t=10s, the entry from the previous network and the expired entry are
+  // evicted.
+  now += base::TimeDelta::FromSeconds(10);
+  cache.EvictStaleEntries(now);
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_TRUE(cache.Lookup(Key("long.com"), now));
+
+  now += base::TimeDelta::FromSeconds(10);
+  cache.EvictStaleEntries(now);
+  EXPECT_EQ(0u, cache.size());
+}
+
 TEST(HostCacheTest, ClearForHosts) {
   const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
 
@@ -575,6 +609,59 @@ TEST(HostCacheTest, EvictStale) {
   EXPECT_FALSE(cache.LookupStale(key3, now, &stale));
 }
 
+// Tests that entries are evicted in order of expiration, after those made
+// stale by a network change, as entries are replaced and cleared.
+TEST(HostCacheTest, EvictInExpirationOrder) {
+  const size_t kMaxEntries = 10;
+  HostCache cache(kMaxEntries);
+
+  int evict_count = 0;
+  HostCache::Key evicted_key = Key("nothingevicted.com");
+  cache.set_eviction_callback(
+      base::Bind(&TestEvictionCallback, &evict_count, &evicted_key));
+
+  base::TimeTicks now;
+  HostCache::Entry entry =
+      HostCache::Entry(OK, AddressList(), HostCache::Entry::SOURCE_UNKNOWN);
+
+  // host0.com expires last, host9.com first.
+  for (size_t i = 0; i < kMaxEntries; ++i) {
+    cache.Set(Key(base::StringPrintf("host%" PRIuS ".com", i)), entry, now,
+              base::TimeDelta::FromSeconds(100 - i));
+  }
+  EXPECT_EQ(kMaxEntries, cache.size());
+
+  // Replacing host9.com moves it to the back of the eviction order.
+  cache.Set(Key("host9.com"), entry, now, base::TimeDelta::FromSeconds(200));
+  cache.Set(Key("new0.com"), entry, now, base::TimeDelta::FromSeconds(300));
+  EXPECT_EQ(1, evict_count);
+  EXPECT_EQ("host8.com", evicted_key.hostname);
+
+  // A cleared entry leaves no room to be evicted.
+  cache.ClearForHosts(base::Bind(&HostnameIsHost7));
+  EXPECT_EQ(kMaxEntries - 1, cache.size());
+  cache.Set(Key("new1.com"), entry, now, base::TimeDelta::FromSeconds(300));
+  EXPECT_EQ(1, evict_count);
+
+  // Entries from before a network change are evicted first, even if they
+  // expire after the newer ones.
+  cache.OnNetworkChange();
+  cache.Set(Key("new2.com"), entry, now, base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(2, evict_count);
+  EXPECT_EQ("host6.com", evicted_key.hostname);
+  cache.Set(Key("new3.com"), entry, now, base::TimeDelta::FromSeconds(1));
+  EXPECT_EQ(3, evict_count);
+  EXPECT_EQ("host5.com", evicted_key.hostname);
+
+  // An entry of the current network which has expired is evicted before those
+  // from the previous network which expire after it.
+  now += base::TimeDelta::FromSeconds(2);
+  cache.Set(Key("new4.com"), entry, now, base::TimeDelta::FromSeconds(10));
+  EXPECT_EQ(4, evict_count);
+  EXPECT_EQ("new2.com", evicted_key.hostname);
+  EXPECT_TRUE(cache.Lookup(Key("new4.com"), now));
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
@@ -112,6 +112,13 @@ HostResolver::~HostResolver() = default;
 void HostResolver::SetDnsClientEnabled(bool enabled) {
 }
 
+void HostResolver::SetRequestContext(URLRequestContext* request_context) {}
+
+void HostResolver::AddDnsOverHttpsServer(const std::string& spec,
+                                         bool use_post) {}
+
+void HostResolver::ClearDnsOverHttpsServers() {}
+
 HostCache* HostResolver::GetHostCache() {
   return nullptr;
 }
@@ -31,6 +31,7 @@ class HostResolverImpl;
 class HostResolverProc;
 class NetLog;
 class NetLogWithSource;
+class URLRequestContext;
 
 // This class represents the task of resolving hostnames (or IP address
 // literal) to an AddressList object.
@@ -183,6 +184,18 @@ class NET_EXPORT HostResolver {
   // Enable or disable the built-in asynchronous DnsClient.
   virtual void SetDnsClientEnabled(bool enabled);
 
+  // Sets the context the built-in asynchronous DnsClient makes DNS over HTTPS
+  // requests with. It must outlive |this|, or be reset to null first.
+  virtual void SetRequestContext(URLRequestContext* request_context);
+
+  // Adds a DNS over HTTPS server (RFC 8484), an https URL, which the built-in
+  // asynchronous DnsClient then queries instead of the system's name servers.
+  // Queries are sent as POST requests if |use_post|, as GET requests otherwise.
+  virtual void AddDnsOverHttpsServer(const std::string& spec, bool use_post);
+
+  // Removes the servers added by AddDnsOverHttpsServer().
+  virtual void ClearDnsOverHttpsServers();
+
   // Returns the HostResolverCache |this| uses, or NULL if there isn't one.
   // Used primarily to clear the cache and for getting debug information.
   virtual HostCache* GetHostCache();
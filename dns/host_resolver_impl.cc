@@ -20,6 +20,7 @@
 #endif  // !defined(OS_NACL)
 #endif  // defined(OS_POSIX)
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include <utility>
@@ -73,7 +74,9 @@
 #include "net/log/net_log_with_source.h"
 #include "net/socket/client_socket_factory.h"
 #include "net/socket/datagram_client_socket.h"
+#include "url/gurl.h"
 #include "url/url_canon_ip.h"
+#include "url/url_constants.h"
 
 #if defined(OS_WIN)
 #include "net/base/winsock_init.h"
@@ -104,6 +107,37 @@ const unsigned kNegativeCacheEntryTTLSeconds = 0;
 // Minimum TTL for successful resolutions with DnsTask.
 const unsigned kMinimumTTLSeconds = kCacheEntryTTLSeconds;
 
+// How long a DnsTask waits for the AAAA answer once the A answer arrived, as
+// the Resolution Delay of Happy Eyeballs v2 (RFC 8305). After that, requests
+// are completed with the IPv4 addresses alone.
+const int kResolutionDelayMs = 50;
+
+// Cache entries served at least this many times are refreshed shortly before
+// they expire.
+const int kMinHitsForRefresh = 3;
+
+// Popular entries are refreshed once less than this percentage of their
+// lifetime remains.
+const int kRefreshWindowPercent = 10;
+
+// Maximum number of refreshes and cache warm-ups pending or running at once.
+const size_t kMaxRefreshes = 4;
+
+// How long a request whose cache entry has expired waits for the refresh
+// before it is served the stale entry, the client response timer of RFC 8767.
+const int64_t kStaleClientTimeoutMs = 1800;
+
+// Entries that expired longer ago than this are not served stale.
+const int64_t kMaxStaleSeconds = 24 * 60 * 60;
+
+// Maximum number of popular hosts persisted to warm the cache at startup.
+const size_t kMaxPersistedHosts = 32;
+
+// Keys of the persisted popular hosts.
+const char kPersistedHostnameKey[] = "hostname";
+const char kPersistedAddressFamilyKey[] = "address_family";
+const char kPersistedFlagsKey[] = "flags";
+
 // Time between IPv6 probes, i.e. for how long results of each IPv6 probe are
 // cached.
 const int kIPv6ProbePeriodMs = 1000;
@@ -560,6 +594,22 @@ void MakeNotStale(HostCache::EntryStaleness* stale_info) {
   stale_info->stale_hits = 0;
 }
 
+// Returns whether a resolution which failed with |error| may be answered with
+// an expired cache entry. RFC 8767 only allows it when the name servers can't
+// be reached or fail to answer, not when they answer that the name doesn't
+// exist. The errors that say so depend on which task failed.
+bool CanServeStaleOnDnsTaskError(int error) {
+  return error == ERR_DNS_TIMED_OUT || error == ERR_DNS_SERVER_FAILED ||
+         error == ERR_INTERNET_DISCONNECTED;
+}
+
+// The system resolver reports NXDOMAIN as ERR_NAME_NOT_RESOLVED, and other
+// getaddrinfo() failures, such as EAI_AGAIN, as ERR_NAME_RESOLUTION_FAILED.
+bool CanServeStaleOnProcTaskError(int error) {
+  return error == ERR_NAME_RESOLUTION_FAILED ||
+         error == ERR_INTERNET_DISCONNECTED;
+}
+
 // Persist data every five minutes (potentially, cache and learned RTT).
 const int64_t kPersistDelaySec = 300;
 
@@ -611,21 +661,45 @@ class HostResolverImpl::RequestImpl : public HostResolver::Request {
 
   void OnJobCancelled(Job* job) {
     DCHECK_EQ(job_, job);
+    stale_timer_.Stop();
     job_ = nullptr;
     addresses_ = nullptr;
     callback_.Reset();
   }
 
-  // Prepare final AddressList and call completion callback.
-  void OnJobCompleted(Job* job, int error, const AddressList& addr_list) {
+  // Prepare final AddressList and call completion callback. |can_serve_stale|
+  // is true if |error| means that the name servers could not be reached or
+  // failed to answer.
+  void OnJobCompleted(Job* job,
+                      int error,
+                      const AddressList& addr_list,
+                      bool can_serve_stale) {
     DCHECK_EQ(job_, job);
-    if (error == OK)
+    stale_timer_.Stop();
+    if (error != OK && can_serve_stale && !stale_addresses_.empty()) {
+      // Serve the stale entry rather than the failure.
+      error = OK;
+      *addresses_ = EnsurePortOnAddressList(stale_addresses_, info_.port());
+    } else if (error == OK) {
       *addresses_ = EnsurePortOnAddressList(addr_list, info_.port());
+    }
     job_ = nullptr;
     addresses_ = nullptr;
     base::ResetAndReturn(&callback_).Run(error);
   }
 
+  // Completes the request with |stale_addresses| if the job does not complete
+  // within |timeout|, or fails because the name servers can't be reached or
+  // fail to answer.
+  void ServeStaleAfter(const AddressList& stale_addresses,
+                       base::TimeDelta timeout) {
+    DCHECK(job_);
+    stale_addresses_ = stale_addresses;
+    stale_timer_.Start(FROM_HERE, timeout,
+                       base::Bind(&RequestImpl::OnStaleTimeout,
+                                  base::Unretained(this)));
+  }
+
   Job* job() const {
     return job_;
   }
@@ -643,6 +717,19 @@ class HostResolverImpl::RequestImpl : public HostResolver::Request {
   base::TimeTicks request_time() const { return request_time_; }
 
  private:
+  void OnStaleTimeout() {
+    DCHECK(job_);
+    AddressList* addresses = addresses_;
+    CompletionCallback callback = callback_;
+    // Detaches from the job, which keeps running to refresh the cache.
+    job_->CancelRequest(this);
+    job_ = nullptr;
+    addresses_ = nullptr;
+    callback_.Reset();
+    *addresses = EnsurePortOnAddressList(stale_addresses_, info_.port());
+    callback.Run(OK);
+  }
+
   const NetLogWithSource source_net_log_;
 
   // The request info that started the request.
@@ -661,6 +748,10 @@ class HostResolverImpl::RequestImpl : public HostResolver::Request {
 
   const base::TimeTicks request_time_;
 
+  // The expired cache entry to serve if the job is slow or fails.
+  AddressList stale_addresses_;
+  base::OneShotTimer stale_timer_;
+
   DISALLOW_COPY_AND_ASSIGN(RequestImpl);
 };
 
@@ -996,6 +1087,7 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
         delegate_(delegate),
         net_log_(job_net_log),
         num_completed_transactions_(0),
+        completed_early_(false),
         task_start_time_(base::TimeTicks::Now()) {
     DCHECK(client);
     DCHECK(delegate_);
@@ -1009,6 +1101,16 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     return needs_two_transactions() && !transaction_aaaa_;
   }
 
+  // True if the delegate was given the IPv4 results while the AAAA
+  // transaction is still running. The delegate is notified again once it
+  // completes.
+  bool completed_early() const { return completed_early_; }
+
+  void set_delegate(Delegate* delegate) {
+    DCHECK(delegate);
+    delegate_ = delegate;
+  }
+
   void StartFirstTransaction() {
     DCHECK_EQ(0u, num_completed_transactions_);
     net_log_.BeginEvent(NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK);
@@ -1055,6 +1157,7 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
                              int net_error,
                              const DnsResponse* response) {
     DCHECK(transaction);
+    resolution_delay_timer_.Stop();
     base::TimeDelta duration = base::TimeTicks::Now() - start_time;
     if (net_error != OK) {
       UMA_HISTOGRAM_LONG_TIMES_100("AsyncDNS.TransactionFailure", duration);
@@ -1105,7 +1208,17 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     if (needs_two_transactions() && num_completed_transactions_ == 1) {
       // No need to repeat the suffix search.
       key_.hostname = transaction->GetHostname();
+      // Only wait a little for an AAAA transaction that is already running,
+      // one started just now could not answer within the delay.
+      bool wait_for_aaaa = transaction->GetType() == dns_protocol::kTypeA &&
+                           transaction_aaaa_ && !addr_list_.empty();
       delegate_->OnFirstDnsTransactionComplete();
+      if (wait_for_aaaa) {
+        resolution_delay_timer_.Start(
+            FROM_HERE, base::TimeDelta::FromMilliseconds(kResolutionDelayMs),
+            base::Bind(&DnsTask::OnResolutionDelayTimeout,
+                       base::Unretained(this)));
+      }
       return;
     }
 
@@ -1154,18 +1267,34 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
     OnSuccess(addr_list);
   }
 
+  // Completes the task with the IPv4 addresses, since the AAAA transaction
+  // did not answer within the resolution delay. The AAAA transaction keeps
+  // running, so that its answer still reaches the cache.
+  void OnResolutionDelayTimeout() {
+    DCHECK_EQ(1u, num_completed_transactions_);
+    DCHECK(!addr_list_.empty());
+    completed_early_ = true;
+    net_log_.EndEvent(NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK,
+                      addr_list_.CreateNetLogCallback());
+    delegate_->OnDnsTaskComplete(task_start_time_, OK, addr_list_, ttl_);
+  }
+
   void OnFailure(int net_error, DnsResponse::Result result) {
     DCHECK_NE(OK, net_error);
-    net_log_.EndEvent(
-        NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK,
-        base::Bind(&NetLogDnsTaskFailedCallback, net_error, result));
+    if (!completed_early_) {
+      net_log_.EndEvent(
+          NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK,
+          base::Bind(&NetLogDnsTaskFailedCallback, net_error, result));
+    }
     delegate_->OnDnsTaskComplete(task_start_time_, net_error, AddressList(),
                                  base::TimeDelta());
   }
 
   void OnSuccess(const AddressList& addr_list) {
-    net_log_.EndEvent(NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK,
-                      addr_list.CreateNetLogCallback());
+    if (!completed_early_) {
+      net_log_.EndEvent(NetLogEventType::HOST_RESOLVER_IMPL_DNS_TASK,
+                        addr_list.CreateNetLogCallback());
+    }
     delegate_->OnDnsTaskComplete(task_start_time_, OK, addr_list, ttl_);
   }
 
@@ -1181,6 +1310,10 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
 
   unsigned num_completed_transactions_;
 
+  // Runs OnResolutionDelayTimeout() while waiting for the AAAA answer.
+  base::OneShotTimer resolution_delay_timer_;
+  bool completed_early_;
+
   // These are updated as each transaction completes.
   base::TimeDelta ttl_;
   // IPv6 addresses must appear first in the list.
@@ -1193,6 +1326,51 @@ class HostResolverImpl::DnsTask : public base::SupportsWeakPtr<DnsTask> {
 
 //-----------------------------------------------------------------------------
 
+// Owns a DnsTask that completed its Job with the IPv4 addresses alone, and
+// caches the merged addresses once the AAAA transaction answers. Keeps the
+// Job's dispatcher slot until then, so the AAAA transaction still counts
+// against |max_concurrent_resolves|.
+class HostResolverImpl::LateDnsAnswer
+    : public HostResolverImpl::DnsTask::Delegate {
+ public:
+  LateDnsAnswer(HostResolverImpl* resolver,
+                const Key& key,
+                std::unique_ptr<DnsTask> dns_task)
+      : resolver_(resolver), key_(key), dns_task_(std::move(dns_task)) {
+    DCHECK(dns_task_->completed_early());
+    dns_task_->set_delegate(this);
+  }
+
+  ~LateDnsAnswer() override = default;
+
+  // HostResolverImpl::DnsTask::Delegate implementation:
+
+  void OnDnsTaskComplete(base::TimeTicks start_time,
+                         int net_error,
+                         const AddressList& addr_list,
+                         base::TimeDelta ttl) override {
+    // On failure, the IPv4 addresses cached by the Job are kept.
+    if (net_error == OK && !ContainsIcannNameCollisionIp(addr_list)) {
+      resolver_->CacheResult(
+          key_,
+          HostCache::Entry(OK, addr_list, HostCache::Entry::SOURCE_DNS, ttl),
+          std::max(ttl, base::TimeDelta::FromSeconds(kMinimumTTLSeconds)));
+    }
+    resolver_->OnLateDnsAnswerComplete(this);
+  }
+
+  void OnFirstDnsTransactionComplete() override { NOTREACHED(); }
+
+ private:
+  HostResolverImpl* const resolver_;
+  const Key key_;
+  std::unique_ptr<DnsTask> dns_task_;
+
+  DISALLOW_COPY_AND_ASSIGN(LateDnsAnswer);
+};
+
+//-----------------------------------------------------------------------------
+
 // Aggregates all Requests for the same Key. Dispatched via PriorityDispatch.
 class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
                               public HostResolverImpl::DnsTask::Delegate {
@@ -1212,6 +1390,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         had_dns_config_(false),
         num_occupied_job_slots_(0),
         dns_task_error_(OK),
+        can_serve_stale_on_error_(false),
         creation_time_(base::TimeTicks::Now()),
         priority_change_time_(creation_time_),
         net_log_(
@@ -1541,6 +1720,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
     if (net_error == OK)
       ttl = base::TimeDelta::FromSeconds(kCacheEntryTTLSeconds);
 
+    can_serve_stale_on_error_ = CanServeStaleOnProcTaskError(net_error);
+
     // Source unknown because the system resolver could have gotten it from a
     // hosts file, its own cache, a DNS lookup or somewhere else.
     // Don't store the |ttl| in cache since it's not obtained from the server.
@@ -1588,6 +1769,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
       StartProcTask();
     } else {
       UmaAsyncDnsResolveStatus(RESOLVE_STATUS_FAIL);
+      can_serve_stale_on_error_ = CanServeStaleOnDnsTaskError(net_error);
       CompleteRequestsWithError(net_error);
     }
   }
@@ -1736,10 +1918,15 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         proc_task_->Cancel();
         proc_task_ = nullptr;
       }
-      KillDnsTask();
+      if (dns_task_ && dns_task_->completed_early()) {
+        // The LateDnsAnswer takes over the slot.
+        resolver_->WaitForLateDnsAnswer(key_, std::move(dns_task_));
+      } else {
+        KillDnsTask();
 
-      // Signal dispatcher that a slot has opened.
-      resolver_->dispatcher_->OnJobFinished();
+        // Signal dispatcher that a slot has opened.
+        resolver_->dispatcher_->OnJobFinished();
+      }
     } else if (is_queued()) {
       resolver_->dispatcher_->Cancel(handle_);
       handle_.Reset();
@@ -1786,7 +1973,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
         RecordTotalTime(req->info().is_speculative(), false,
                         base::TimeTicks::Now() - req->request_time());
       }
-      req->OnJobCompleted(this, entry.error(), entry.addresses());
+      req->OnJobCompleted(this, entry.error(), entry.addresses(),
+                          can_serve_stale_on_error_);
 
       // Check if the resolver was destroyed as a result of running the
       // callback. If it was, we could continue, but we choose to bail.
@@ -1836,6 +2024,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
   // Result of DnsTask.
   int dns_task_error_;
 
+  // Whether the error the job completes with means that the name servers
+  // could not be reached, so that requests may be served an expired entry.
+  bool can_serve_stale_on_error_;
+
   const base::TimeTicks creation_time_;
   base::TimeTicks priority_change_time_;
   base::TimeTicks start_time_;
@@ -1876,6 +2068,10 @@ HostResolverImpl::ProcTaskParams::ProcTaskParams(const ProcTaskParams& other) =
 
 HostResolverImpl::ProcTaskParams::~ProcTaskParams() = default;
 
+HostResolverImpl::Refresh::Refresh() = default;
+
+HostResolverImpl::Refresh::~Refresh() = default;
+
 HostResolverImpl::~HostResolverImpl() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
   // Prevent the dispatcher from starting new jobs.
@@ -1883,6 +2079,7 @@ HostResolverImpl::~HostResolverImpl() {
   // It's now safe for Jobs to call KillDnsTask on destruction, because
   // OnJobComplete will not start any new jobs.
   jobs_.clear();
+  ClearLateDnsAnswers();
 
   NetworkChangeNotifier::RemoveIPAddressObserver(this);
   NetworkChangeNotifier::RemoveConnectionTypeObserver(this);
@@ -1916,6 +2113,9 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
     return rv;
   }
 
+  AddressList stale_addresses;
+  bool serve_stale = GetServableStaleEntry(key, info, &stale_addresses);
+
   // Next we need to attach our request to a "job". This job is responsible for
   // calling "getaddrinfo(hostname)" on a worker thread.
 
@@ -1946,6 +2146,17 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   auto req = std::make_unique<RequestImpl>(source_net_log, info, priority,
                                            callback, addresses, job);
   job->AddRequest(req.get());
+  if (serve_stale) {
+    // The refresh keeps |job| running to update the cache once the request is
+    // served the stale entry. It counts against the same budget as the other
+    // refreshes; without it, the job is cancelled if the request is served the
+    // stale entry before the job completes.
+    if (refreshes_.count(key) || refreshes_.size() < kMaxRefreshes)
+      StartRefresh(key, true /* bypass_cache */);
+    req->ServeStaleAfter(
+        stale_addresses,
+        base::TimeDelta::FromMilliseconds(kStaleClientTimeoutMs));
+  }
   *out_req = std::move(req);
 
   // Completion happens during Job::CompleteRequests().
@@ -1956,6 +2167,7 @@ HostResolverImpl::HostResolverImpl(const Options& options, NetLog* net_log)
     : max_queued_jobs_(0),
       proc_params_(NULL, options.max_retry_attempts),
       net_log_(net_log),
+      url_request_context_(nullptr),
       received_dns_config_(false),
       num_dns_failures_(0),
       assume_ipv6_failure_on_wifi_(false),
@@ -1992,6 +2204,9 @@ HostResolverImpl::HostResolverImpl(const Options& options, NetLog* net_log)
   EnsureDnsReloaderInit();
 #endif
 
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(base::Bind(
+      &HostResolverImpl::OnMemoryPressure, base::Unretained(this))));
+
   OnConnectionTypeChanged(NetworkChangeNotifier::GetConnectionType());
 
   {
@@ -2107,6 +2322,33 @@ void HostResolverImpl::SetDnsClientEnabled(bool enabled) {
 #endif
 }
 
+void HostResolverImpl::SetRequestContext(URLRequestContext* request_context) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  url_request_context_ = request_context;
+  if (dns_client_)
+    dns_client_->SetRequestContext(url_request_context_);
+}
+
+void HostResolverImpl::AddDnsOverHttpsServer(const std::string& spec,
+                                             bool use_post) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  GURL url(spec);
+  if (!url.SchemeIs(url::kHttpsScheme))
+    return;
+  dns_over_https_servers_.emplace_back(url, use_post);
+  if (dns_client_)
+    UpdateDNSConfig(true);
+}
+
+void HostResolverImpl::ClearDnsOverHttpsServers() {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (dns_over_https_servers_.empty())
+    return;
+  dns_over_https_servers_.clear();
+  if (dns_client_)
+    UpdateDNSConfig(true);
+}
+
 HostCache* HostResolverImpl::GetHostCache() {
   return cache_.get();
 }
@@ -2201,11 +2443,12 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
+  base::TimeTicks now = base::TimeTicks::Now();
   const HostCache::Entry* cache_entry;
   if (allow_stale)
-    cache_entry = cache_->LookupStale(key, base::TimeTicks::Now(), stale_info);
+    cache_entry = cache_->LookupStale(key, now, stale_info);
   else
-    cache_entry = cache_->Lookup(key, base::TimeTicks::Now());
+    cache_entry = cache_->Lookup(key, now);
   if (!cache_entry)
     return false;
 
@@ -2214,10 +2457,90 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
     if (cache_entry->has_ttl())
       RecordTTL(cache_entry->ttl());
     *addresses = EnsurePortOnAddressList(cache_entry->addresses(), info.port());
+
+    // Refresh popular entries before they expire, so that they keep being
+    // served from the cache. The lifetime of the entry is the one given to
+    // CacheResult() by the Job.
+    base::TimeDelta lifetime = std::max(
+        cache_entry->ttl(), base::TimeDelta::FromSeconds(kMinimumTTLSeconds));
+    if ((!allow_stale || !stale_info->is_stale()) &&
+        cache_entry->total_hits() >= kMinHitsForRefresh &&
+        cache_entry->expires() - now <
+            lifetime * kRefreshWindowPercent / 100) {
+      ScheduleRefresh(key, true /* bypass_cache */);
+    }
   }
   return true;
 }
 
+bool HostResolverImpl::GetServableStaleEntry(const Key& key,
+                                             const RequestInfo& info,
+                                             AddressList* addresses) {
+  if (!info.allow_cached_response() || !cache_.get())
+    return false;
+
+  HostCache::EntryStaleness stale_info;
+  const HostCache::Entry* cache_entry =
+      cache_->LookupStale(key, base::TimeTicks::Now(), &stale_info);
+  if (!cache_entry || cache_entry->error() != OK ||
+      stale_info.network_changes > 0 ||
+      stale_info.expired_by >
+          base::TimeDelta::FromSeconds(kMaxStaleSeconds)) {
+    return false;
+  }
+  *addresses = cache_entry->addresses();
+  return true;
+}
+
+void HostResolverImpl::ScheduleRefresh(const Key& key, bool bypass_cache) {
+  if (refreshes_.size() >= kMaxRefreshes || refreshes_.count(key) ||
+      jobs_.count(key)) {
+    return;
+  }
+  refreshes_[key] = std::make_unique<Refresh>();
+  // Posted, since this is reached from within Resolve().
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(&HostResolverImpl::StartRefresh,
+                            weak_ptr_factory_.GetWeakPtr(), key, bypass_cache));
+}
+
+void HostResolverImpl::StartRefresh(const Key& key, bool bypass_cache) {
+  std::unique_ptr<Refresh>& refresh = refreshes_[key];
+  if (!refresh)
+    refresh = std::make_unique<Refresh>();
+  else if (refresh->started)
+    return;
+  // Resolve() below starts a refresh of its own when it finds a stale entry for
+  // |key|. Mark this one started first, so that the nested call neither
+  // resolves |key| twice nor has its request overwritten.
+  refresh->started = true;
+
+  RequestInfo info(HostPortPair(key.hostname, 0));
+  info.set_address_family(key.address_family);
+  info.set_host_resolver_flags(key.host_resolver_flags);
+  info.set_allow_cached_response(!bypass_cache);
+  info.set_is_speculative(true);
+  int rv = Resolve(info, IDLE, &refresh->addresses,
+                   base::Bind(&HostResolverImpl::OnRefreshComplete,
+                              base::Unretained(this), key),
+                   &refresh->request,
+                   NetLogWithSource::Make(net_log_, NetLogSourceType::NONE));
+  if (rv != ERR_IO_PENDING)
+    OnRefreshComplete(key, rv);
+}
+
+void HostResolverImpl::OnRefreshComplete(const Key& key, int net_error) {
+  refreshes_.erase(key);
+  StartWarmups();
+}
+
+void HostResolverImpl::StartWarmups() {
+  while (!warmup_keys_.empty() && refreshes_.size() < kMaxRefreshes) {
+    ScheduleRefresh(warmup_keys_.back(), false /* bypass_cache */);
+    warmup_keys_.pop_back();
+  }
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -2312,6 +2635,34 @@ void HostResolverImpl::RemoveJob(Job* job) {
   }
 }
 
+void HostResolverImpl::WaitForLateDnsAnswer(const Key& key,
+                                            std::unique_ptr<DnsTask> dns_task) {
+  late_dns_answers_.insert(
+      std::make_unique<LateDnsAnswer>(this, key, std::move(dns_task)));
+}
+
+void HostResolverImpl::OnLateDnsAnswerComplete(LateDnsAnswer* late_dns_answer) {
+  for (auto it = late_dns_answers_.begin(); it != late_dns_answers_.end();
+       ++it) {
+    if (it->get() == late_dns_answer) {
+      late_dns_answers_.erase(it);
+      // Signal dispatcher that a slot has opened.
+      dispatcher_->OnJobFinished();
+      return;
+    }
+  }
+  NOTREACHED();
+}
+
+void HostResolverImpl::ClearLateDnsAnswers() {
+  // Give the slots back only once |late_dns_answers_| is settled, since the
+  // dispatcher may start new Jobs.
+  size_t num_slots = late_dns_answers_.size();
+  late_dns_answers_.clear();
+  for (size_t i = 0; i < num_slots; ++i)
+    dispatcher_->OnJobFinished();
+}
+
 HostResolverImpl::Key HostResolverImpl::GetEffectiveKeyForRequest(
     const RequestInfo& info,
     const IPAddress* ip_address,
@@ -2422,6 +2773,9 @@ void HostResolverImpl::AbortAllInProgressJobs() {
   dispatcher_->SetLimits(
       PrioritizedDispatcher::Limits(limits.reserved_slots.size(), 0));
 
+  // Late answers were resolved for the previous network.
+  ClearLateDnsAnswers();
+
   // Life check to bail once |this| is deleted.
   base::WeakPtr<HostResolverImpl> self = weak_ptr_factory_.GetWeakPtr();
 
@@ -2445,6 +2799,8 @@ void HostResolverImpl::AbortDnsTasks() {
 
   for (auto it = jobs_.begin(); it != jobs_.end(); ++it)
     it->second->AbortDnsTask();
+  // These DnsTasks use the previous DnsClient.
+  ClearLateDnsAnswers();
   dispatcher_->SetLimits(limits);
 }
 
@@ -2496,9 +2852,25 @@ void HostResolverImpl::OnDNSChanged() {
   UpdateDNSConfig(true);
 }
 
+void HostResolverImpl::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  if (!cache_)
+    return;
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      cache_->EvictStaleEntries(base::TimeTicks::Now());
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      cache_->ClearForMemoryPressure();
+      break;
+  }
+}
+
 void HostResolverImpl::UpdateDNSConfig(bool config_changed) {
   DnsConfig dns_config;
-  NetworkChangeNotifier::GetDnsConfig(&dns_config);
+  ReadDnsConfig(&dns_config);
 
   if (net_log_) {
     net_log_->AddGlobalEntry(NetLogEventType::DNS_CONFIG_CHANGED,
@@ -2545,6 +2917,11 @@ void HostResolverImpl::UpdateDNSConfig(bool config_changed) {
   }
 }
 
+void HostResolverImpl::ReadDnsConfig(DnsConfig* dns_config) const {
+  NetworkChangeNotifier::GetDnsConfig(dns_config);
+  dns_config->dns_over_https_servers = dns_over_https_servers_;
+}
+
 bool HostResolverImpl::HaveDnsConfig() const {
   // Use DnsClient only if it's fully configured and there is no override by
   // ScopedDefaultHostResolverProc.
@@ -2580,10 +2957,12 @@ void HostResolverImpl::SetDnsClient(std::unique_ptr<DnsClient> dns_client) {
   // DnsClient and config must be updated before aborting DnsTasks, since doing
   // so may start new jobs.
   dns_client_ = std::move(dns_client);
+  if (dns_client_)
+    dns_client_->SetRequestContext(url_request_context_);
   if (dns_client_ && !dns_client_->GetConfig() &&
       num_dns_failures_ < kMaximumDnsFailures) {
     DnsConfig dns_config;
-    NetworkChangeNotifier::GetDnsConfig(&dns_config);
+    ReadDnsConfig(&dns_config);
     dns_client_->SetConfig(dns_config);
     num_dns_failures_ = 0;
     if (dns_client_->GetConfig())
@@ -2604,10 +2983,65 @@ void HostResolverImpl::InitializePersistence(
 }
 
 void HostResolverImpl::ApplyPersistentData(
-    std::unique_ptr<const base::Value> data) {}
+    std::unique_ptr<const base::Value> data) {
+  const base::ListValue* hosts;
+  if (!cache_ || !data->GetAsList(&hosts))
+    return;
+
+  // Warm the cache with the popular hosts of the previous session, the most
+  // popular first.
+  warmup_keys_.clear();
+  for (const base::Value& host : *hosts) {
+    const base::DictionaryValue* host_dict;
+    std::string hostname;
+    int address_family;
+    int flags;
+    if (!host.GetAsDictionary(&host_dict) ||
+        !host_dict->GetString(kPersistedHostnameKey, &hostname) ||
+        !host_dict->GetInteger(kPersistedAddressFamilyKey, &address_family) ||
+        !host_dict->GetInteger(kPersistedFlagsKey, &flags) ||
+        address_family < 0 || address_family > ADDRESS_FAMILY_LAST) {
+      continue;
+    }
+    warmup_keys_.push_back(Key(hostname,
+                               static_cast<AddressFamily>(address_family),
+                               static_cast<HostResolverFlags>(flags)));
+    if (warmup_keys_.size() == kMaxPersistedHosts)
+      break;
+  }
+  std::reverse(warmup_keys_.begin(), warmup_keys_.end());
+  StartWarmups();
+}
 
 std::unique_ptr<const base::Value> HostResolverImpl::GetPersistentData() {
-  return std::unique_ptr<const base::Value>();
+  auto hosts = std::make_unique<base::ListValue>();
+  if (!cache_)
+    return std::move(hosts);
+
+  // Persists the most popular hosts, to warm the cache at the next startup.
+  std::vector<std::pair<int, const Key*>> popular_keys;
+  for (const auto& pair : cache_->entries()) {
+    const HostCache::Entry& entry = pair.second;
+    if (entry.error() == OK && entry.total_hits() >= kMinHitsForRefresh)
+      popular_keys.push_back(std::make_pair(entry.total_hits(), &pair.first));
+  }
+  size_t num_hosts = std::min(popular_keys.size(), kMaxPersistedHosts);
+  std::partial_sort(popular_keys.begin(), popular_keys.begin() + num_hosts,
+                    popular_keys.end(),
+                    [](const std::pair<int, const Key*>& a,
+                       const std::pair<int, const Key*>& b) {
+                      return a.first > b.first;
+                    });
+  for (size_t i = 0; i < num_hosts; ++i) {
+    const Key& key = *popular_keys[i].second;
+    auto host_dict = std::make_unique<base::DictionaryValue>();
+    host_dict->SetString(kPersistedHostnameKey, key.hostname);
+    host_dict->SetInteger(kPersistedAddressFamilyKey,
+                          static_cast<int>(key.address_family));
+    host_dict->SetInteger(kPersistedFlagsKey, key.host_resolver_flags);
+    hosts->Append(std::move(host_dict));
+  }
+  return std::move(hosts);
 }
 
 void HostResolverImpl::SchedulePersist() {
@@ -10,22 +10,27 @@
 
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
 #include "base/strings/string_piece.h"
 #include "base/threading/thread_checker.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
+#include "net/base/address_list.h"
 #include "net/base/net_export.h"
 #include "net/base/network_change_notifier.h"
+#include "net/dns/dns_config_service.h"
 #include "net/dns/host_cache.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/host_resolver_proc.h"
 
 namespace net {
 
-class AddressList;
 class DnsClient;
 class IPAddress;
 class NetLog;
@@ -142,6 +147,9 @@ class NET_EXPORT HostResolverImpl
                        AddressList* addresses,
                        const NetLogWithSource& source_net_log) override;
   void SetDnsClientEnabled(bool enabled) override;
+  void SetRequestContext(URLRequestContext* request_context) override;
+  void AddDnsOverHttpsServer(const std::string& spec, bool use_post) override;
+  void ClearDnsOverHttpsServers() override;
   HostCache* GetHostCache() override;
   std::unique_ptr<base::Value> GetDnsConfigAsValue() const override;
 
@@ -182,10 +190,25 @@ class NET_EXPORT HostResolverImpl
   class ProcTask;
   class LoopbackProbeJob;
   class DnsTask;
+  class LateDnsAnswer;
   class RequestImpl;
   using Key = HostCache::Key;
   using JobMap = std::map<Key, std::unique_ptr<Job>>;
 
+  // A resolution started by the resolver itself, rather than by a caller, to
+  // refresh or warm the cache entry of a popular host.
+  struct Refresh {
+    Refresh();
+    ~Refresh();
+
+    AddressList addresses;
+    // Set when the refresh is started, before |request| is.
+    bool started = false;
+    // Null until the refresh is started.
+    std::unique_ptr<Request> request;
+  };
+  using RefreshMap = std::map<Key, std::unique_ptr<Refresh>>;
+
   // Number of consecutive failures of DnsTask (with successful fallback to
   // ProcTask) before the DnsClient is disabled until the next DNS change.
   static const unsigned kMaximumDnsFailures;
@@ -239,6 +262,28 @@ class NET_EXPORT HostResolverImpl
                       bool allow_stale,
                       HostCache::EntryStaleness* stale_info);
 
+  // If the cache holds a successful entry for |key| that expired recently on
+  // the current network, returns true and fills |addresses| with it, so that
+  // it can be served while the entry is refreshed (RFC 8767).
+  bool GetServableStaleEntry(const Key& key,
+                             const RequestInfo& info,
+                             AddressList* addresses);
+
+  // Posts a refresh of the cache entry for |key| unless one is already pending,
+  // |key| is already being resolved, or the refresh budget is used up. If
+  // |bypass_cache| is false, the refresh is a no-op while the entry is fresh.
+  void ScheduleRefresh(const Key& key, bool bypass_cache);
+
+  // Resolves |key| on behalf of the cache, unless a refresh of it is already
+  // running.
+  void StartRefresh(const Key& key, bool bypass_cache);
+
+  // Called when the refresh of |key| completes with |net_error|.
+  void OnRefreshComplete(const Key& key, int net_error);
+
+  // Schedules refreshes of the hosts of |warmup_keys_| within the budget.
+  void StartWarmups();
+
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
   bool ServeFromHosts(const Key& key,
@@ -278,6 +323,17 @@ class NET_EXPORT HostResolverImpl
   // Removes |job| from |jobs_|, only if it exists, but does not delete it.
   void RemoveJob(Job* job);
 
+  // Keeps |dns_task|, which completed before its AAAA transaction answered,
+  // running until it does, and then caches the merged results for |key|.
+  void WaitForLateDnsAnswer(const Key& key, std::unique_ptr<DnsTask> dns_task);
+
+  // Called when |late_dns_answer| is done. Deletes it and releases its
+  // dispatcher slot.
+  void OnLateDnsAnswerComplete(LateDnsAnswer* late_dns_answer);
+
+  // Deletes all LateDnsAnswers and releases their dispatcher slots.
+  void ClearLateDnsAnswers();
+
   // Aborts all in progress jobs with ERR_NETWORK_CHANGED and notifies their
   // requests. Might start new jobs.
   void AbortAllInProgressJobs();
@@ -304,6 +360,15 @@ class NET_EXPORT HostResolverImpl
 
   void UpdateDNSConfig(bool config_changed);
 
+  // Evicts stale entries from |cache_| under moderate memory pressure, and
+  // clears it under critical memory pressure.
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  // Reads the system DnsConfig into |dns_config|, with the DNS over HTTPS
+  // servers added to it.
+  void ReadDnsConfig(DnsConfig* dns_config) const;
+
   // True if have a DnsClient with a valid DnsConfig.
   bool HaveDnsConfig() const;
 
@@ -327,9 +392,21 @@ class NET_EXPORT HostResolverImpl
   // Cache of host resolution results.
   std::unique_ptr<HostCache> cache_;
 
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
   // Map from HostCache::Key to a Job.
   JobMap jobs_;
 
+  // Refreshes of popular cache entries, pending or running.
+  RefreshMap refreshes_;
+
+  // Persisted popular hosts still to be resolved to warm the cache, the most
+  // popular last.
+  std::vector<Key> warmup_keys_;
+
+  // DnsTasks whose AAAA answer arrives after their Job completed.
+  std::set<std::unique_ptr<LateDnsAnswer>> late_dns_answers_;
+
   // Starts Jobs according to their priority and the configured limits.
   std::unique_ptr<PrioritizedDispatcher> dispatcher_;
 
@@ -344,6 +421,10 @@ class NET_EXPORT HostResolverImpl
   // If present, used by DnsTask and ServeFromHosts to resolve requests.
   std::unique_ptr<DnsClient> dns_client_;
 
+  // Passed to |dns_client_| for DNS over HTTPS.
+  URLRequestContext* url_request_context_;
+  std::vector<DnsConfig::DnsOverHttpsServerConfig> dns_over_https_servers_;
+
   // True if received valid config from |dns_config_service_|. Temporary, used
   // to measure performance of DnsConfigService: http://crbug.com/125599
   bool received_dns_config_;
@@ -12,6 +12,7 @@
 #include "base/bind_helpers.h"
 #include "base/location.h"
 #include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
@@ -21,10 +22,12 @@
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/test/histogram_tester.h"
 #include "base/test/test_timeouts.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/time.h"
+#include "base/values.h"
 #include "net/base/address_list.h"
 #include "net/base/ip_address.h"
 #include "net/base/mock_network_change_notifier.h"
@@ -132,6 +135,12 @@ class MockHostResolverProc : public HostResolverProc {
     AddRule(hostname, family, result);
   }
 
+  // Makes the resolutions of |hostname| fail with |error|.
+  void AddFailureForAllFamilies(const std::string& hostname, int error) {
+    base::AutoLock lock(lock_);
+    failures_[hostname] = error;
+  }
+
   void AddRuleForAllFamilies(const std::string& hostname,
                              const std::string& ip_list) {
     AddressList result;
@@ -160,6 +169,8 @@ class MockHostResolverProc : public HostResolverProc {
     DCHECK_GT(num_requests_waiting_, 0u);
     --num_slots_available_;
     --num_requests_waiting_;
+    if (failures_.count(hostname))
+      return failures_[hostname];
     if (rules_.empty()) {
       int rv = ParseAddressList("127.0.0.1", std::string(), addrlist);
       DCHECK_EQ(OK, rv);
@@ -192,6 +203,7 @@ class MockHostResolverProc : public HostResolverProc {
  private:
   mutable base::Lock lock_;
   std::map<ResolveKey, AddressList> rules_;
+  std::map<std::string, int> failures_;
   CaptureList capture_list_;
   unsigned num_requests_waiting_;
   unsigned num_slots_available_;
@@ -475,6 +487,8 @@ class TestHostResolverImpl : public HostResolverImpl {
 
 const uint16_t kLocalhostLookupPort = 80;
 
+void IgnorePersistedData(std::unique_ptr<const base::Value> data) {}
+
 bool HasEndpoint(const IPEndPoint& endpoint, const AddressList& addresses) {
   for (const auto& address : addresses) {
     if (endpoint == address)
@@ -636,6 +650,11 @@ class HostResolverImplTest : public testing::Test {
     resolver_->GetHostCache()->OnNetworkChange();
   }
 
+  std::unique_ptr<const base::Value> GetPersistentData() {
+    DCHECK(resolver_.get());
+    return resolver_->GetPersistentData();
+  }
+
   scoped_refptr<MockHostResolverProc> proc_;
   std::unique_ptr<HostResolverImpl> resolver_;
   std::vector<std::unique_ptr<Request>> requests_;
@@ -1508,6 +1527,198 @@ TEST_F(HostResolverImplTest, ResolveStaleFromCacheError) {
   EXPECT_TRUE(requests_[6]->staleness().is_stale());
 }
 
+// Tests that a request is served an entry which expired on the current network
+// when the resolution refreshing it fails to get an answer. The system
+// resolver reports such failures as ERR_NAME_RESOLUTION_FAILED.
+TEST_F(HostResolverImplTest, ServeStaleOnFailure) {
+  proc_->AddFailureForAllFamilies("just.testing", ERR_NAME_RESOLUTION_FAILED);
+  proc_->SignalMultiple(1u);
+
+  // Cache an entry which expired a minute ago.
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  resolver_->GetHostCache()->Set(
+      key,
+      HostCache::Entry(
+          OK, AddressList::CreateFromIPAddress(IPAddress(192, 168, 1, 42), 0),
+          HostCache::Entry::SOURCE_DNS),
+      base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+      base::TimeDelta::FromMinutes(1));
+
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  EXPECT_TRUE(requests_[0]->HasOneAddress("192.168.1.42", 80));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+}
+
+// Tests that memory pressure evicts stale entries from the cache when moderate,
+// and clears it when critical.
+TEST_F(HostResolverImplTest, MemoryPressure) {
+  // The value of HostCache::ERASE_MEMORY_PRESSURE.
+  const int kEraseMemoryPressure = 3;
+  base::HistogramTester histograms;
+
+  HostCache::Entry entry(
+      OK, AddressList::CreateFromIPAddress(IPAddress(192, 168, 1, 42), 0),
+      HostCache::Entry::SOURCE_DNS);
+  resolver_->GetHostCache()->Set(
+      HostCache::Key("expired.testing", ADDRESS_FAMILY_UNSPECIFIED, 0), entry,
+      base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+      base::TimeDelta::FromMinutes(1));
+  resolver_->GetHostCache()->Set(
+      HostCache::Key("valid.testing", ADDRESS_FAMILY_UNSPECIFIED, 0), entry,
+      base::TimeTicks::Now(), base::TimeDelta::FromMinutes(1));
+  ASSERT_EQ(2u, resolver_->GetHostCache()->size());
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE);
+  EXPECT_EQ(1u, resolver_->GetHostCache()->size());
+  histograms.ExpectUniqueSample("DNS.HostCache.Erase", kEraseMemoryPressure,
+                                1);
+
+  base::MemoryPressureListener::SimulatePressureNotification(
+      base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
+  EXPECT_EQ(0u, resolver_->GetHostCache()->size());
+  histograms.ExpectUniqueSample("DNS.HostCache.Erase", kEraseMemoryPressure,
+                                2);
+}
+
+// Tests that a request is served an expired entry when the system resolver
+// fails while offline.
+TEST_F(HostResolverImplTest, ServeStaleWhenOffline) {
+  // Destroy the resolver before the notifier is replaced; see NoIPv6OnWifi.
+  resolver_ = nullptr;
+  test::ScopedMockNetworkChangeNotifier notifier;
+  notifier.mock_network_change_notifier()->SetConnectionType(
+      NetworkChangeNotifier::CONNECTION_NONE);
+  CreateResolver();
+  proc_->AddRuleForAllFamilies("other.testing", "192.168.1.1");
+  proc_->SignalMultiple(1u);
+
+  // Cache an entry which expired a minute ago.
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  resolver_->GetHostCache()->Set(
+      key,
+      HostCache::Entry(
+          OK, AddressList::CreateFromIPAddress(IPAddress(192, 168, 1, 42), 0),
+          HostCache::Entry::SOURCE_DNS),
+      base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+      base::TimeDelta::FromMinutes(1));
+
+  // The lookup fails with ERR_NAME_NOT_RESOLVED, which ProcTask reports as
+  // ERR_INTERNET_DISCONNECTED while offline.
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  EXPECT_TRUE(requests_[0]->HasOneAddress("192.168.1.42", 80));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+  resolver_ = nullptr;
+}
+
+// Tests that an expired entry is not served when the name servers answer that
+// the name doesn't exist.
+TEST_F(HostResolverImplTest, NoStaleOnNameNotResolved) {
+  proc_->AddRuleForAllFamilies("other.testing", "192.168.1.1");
+  proc_->SignalMultiple(1u);
+
+  // Cache an entry which expired a minute ago.
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  resolver_->GetHostCache()->Set(
+      key,
+      HostCache::Entry(
+          OK, AddressList::CreateFromIPAddress(IPAddress(192, 168, 1, 42), 0),
+          HostCache::Entry::SOURCE_DNS),
+      base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+      base::TimeDelta::FromMinutes(1));
+
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsError(ERR_NAME_NOT_RESOLVED));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+}
+
+// Tests that the popular hosts of the cache are persisted, and resolved again
+// to warm the cache of the next resolver.
+TEST_F(HostResolverImplTest, WarmCacheWithPersistedPopularHosts) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  proc_->AddRuleForAllFamilies("unpopular.testing", "192.168.1.1");
+  proc_->SignalMultiple(2u);
+
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  EXPECT_THAT(CreateRequest("unpopular.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[1]->WaitForResult(), IsOk());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(CreateRequest("just.testing", 80)->ResolveFromCache(),
+                IsOk());
+  }
+
+  std::unique_ptr<const base::Value> data = GetPersistentData();
+  ASSERT_TRUE(data);
+  const base::ListValue* hosts;
+  ASSERT_TRUE(data->GetAsList(&hosts));
+  EXPECT_EQ(1u, hosts->GetSize());
+
+  CreateResolver();
+  resolver_->InitializePersistence(base::Bind(&IgnorePersistedData),
+                                   std::move(data));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(proc_->WaitFor(1u));
+  ASSERT_EQ(3u, proc_->GetCaptureList().size());
+  EXPECT_EQ("just.testing", proc_->GetCaptureList()[2].hostname);
+
+  // A request for the host attaches to the warm-up rather than starting
+  // another resolution.
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  proc_->SignalMultiple(1u);
+  EXPECT_THAT(requests_.back()->WaitForResult(), IsOk());
+  EXPECT_TRUE(requests_.back()->HasOneAddress("192.168.1.42", 80));
+  EXPECT_EQ(3u, proc_->GetCaptureList().size());
+}
+
+// Tests that a warm-up which finds an expired entry in the cache resolves the
+// host once, although serving the expired entry starts a refresh of its own.
+TEST_F(HostResolverImplTest, WarmUpRefreshesStaleEntry) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.43");
+  proc_->SignalMultiple(1u);
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_THAT(CreateRequest("just.testing", 80)->ResolveFromCache(),
+                IsOk());
+  }
+  std::unique_ptr<const base::Value> data = GetPersistentData();
+  ASSERT_TRUE(data);
+
+  CreateResolver();
+  HostCache::Key key("just.testing", ADDRESS_FAMILY_UNSPECIFIED, 0);
+  resolver_->GetHostCache()->Set(
+      key,
+      HostCache::Entry(
+          OK, AddressList::CreateFromIPAddress(IPAddress(192, 168, 1, 42), 0),
+          HostCache::Entry::SOURCE_DNS),
+      base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+      base::TimeDelta::FromMinutes(1));
+  resolver_->InitializePersistence(base::Bind(&IgnorePersistedData),
+                                   std::move(data));
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(proc_->WaitFor(1u));
+  ASSERT_EQ(2u, proc_->GetCaptureList().size());
+
+  // A request for the host attaches to the warm-up, and gets the fresh
+  // addresses once it completes.
+  EXPECT_THAT(CreateRequest("just.testing", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  proc_->SignalMultiple(1u);
+  EXPECT_THAT(requests_.back()->WaitForResult(), IsOk());
+  EXPECT_TRUE(requests_.back()->HasOneAddress("192.168.1.43", 80));
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+}
+
 // TODO(mgersh): add a test case for errors with positive TTL after
 // https://crbug.com/115051 is fixed.
 
@@ -2388,6 +2599,55 @@ TEST_F(HostResolverImplDnsTest, AAAACompletesFirst) {
   EXPECT_THAT(requests_[2]->result(), IsError(ERR_DNS_TIMED_OUT));
 }
 
+// Test that the IPv4 addresses are returned once the AAAA transaction has not
+// answered within the resolution delay, and that its late answer is cached.
+TEST_F(HostResolverImplDnsTest, AAAAAnswersAfterResolutionDelay) {
+  set_fallback_to_proctask(false);
+  ChangeDnsConfig(CreateValidDnsConfig());
+
+  EXPECT_THAT(CreateRequest("6slow_ok", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  EXPECT_TRUE(requests_[0]->HasOneAddress("127.0.0.1", 80));
+  // The AAAA transaction keeps its slot.
+  EXPECT_EQ(1u, num_running_dispatcher_jobs());
+
+  dns_client_->CompleteDelayedTransactions();
+  EXPECT_EQ(0u, num_running_dispatcher_jobs());
+  EXPECT_THAT(CreateRequest("6slow_ok", 80)->ResolveFromCache(), IsOk());
+  EXPECT_EQ(2u, requests_[1]->NumberOfAddresses());
+  EXPECT_TRUE(requests_[1]->HasAddress("127.0.0.1", 80));
+  EXPECT_TRUE(requests_[1]->HasAddress("::1", 80));
+}
+
+// Test that a late AAAA answer keeps other Jobs waiting for its slot.
+TEST_F(HostResolverImplDnsTest, AAAAAnswerAfterResolutionDelayKeepsSlot) {
+  CreateResolverWithLimitsAndParams(2u, DefaultParams(proc_.get()));
+  set_fallback_to_proctask(false);
+  ChangeDnsConfig(CreateValidDnsConfig());
+
+  EXPECT_THAT(CreateRequest("6slow_ok", 80)->Resolve(),
+              IsError(ERR_IO_PENDING));
+  EXPECT_THAT(requests_[0]->WaitForResult(), IsOk());
+  EXPECT_EQ(1u, num_running_dispatcher_jobs());
+
+  EXPECT_EQ(ERR_IO_PENDING, CreateRequest("4slow_ok", 80, MEDIUM,
+                                          ADDRESS_FAMILY_IPV4)->Resolve());
+  EXPECT_EQ(ERR_IO_PENDING,
+            CreateRequest("ok", 80, MEDIUM, ADDRESS_FAMILY_IPV4)->Resolve());
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(2u, num_running_dispatcher_jobs());
+  EXPECT_FALSE(requests_[1]->completed());
+  EXPECT_FALSE(requests_[2]->completed());
+
+  dns_client_->CompleteDelayedTransactions();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_THAT(requests_[1]->result(), IsOk());
+  EXPECT_TRUE(requests_[2]->completed());
+  EXPECT_THAT(requests_[2]->result(), IsOk());
+  EXPECT_EQ(0u, num_running_dispatcher_jobs());
+}
+
 // Test the case where only a single transaction slot is available.
 TEST_F(HostResolverImplDnsTest, SerialResolver) {
   CreateSerialResolver();
@@ -47,6 +47,19 @@ void MappedHostResolver::SetDnsClientEnabled(bool enabled) {
   impl_->SetDnsClientEnabled(enabled);
 }
 
+void MappedHostResolver::SetRequestContext(URLRequestContext* request_context) {
+  impl_->SetRequestContext(request_context);
+}
+
+void MappedHostResolver::AddDnsOverHttpsServer(const std::string& spec,
+                                               bool use_post) {
+  impl_->AddDnsOverHttpsServer(spec, use_post);
+}
+
+void MappedHostResolver::ClearDnsOverHttpsServers() {
+  impl_->ClearDnsOverHttpsServers();
+}
+
 HostCache* MappedHostResolver::GetHostCache() {
   return impl_->GetHostCache();
 }
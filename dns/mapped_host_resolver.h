@@ -55,6 +55,9 @@ class NET_EXPORT MappedHostResolver : public HostResolver {
                        AddressList* addresses,
                        const NetLogWithSource& net_log) override;
   void SetDnsClientEnabled(bool enabled) override;
+  void SetRequestContext(URLRequestContext* request_context) override;
+  void AddDnsOverHttpsServer(const std::string& spec, bool use_post) override;
+  void ClearDnsOverHttpsServers() override;
   HostCache* GetHostCache() override;
   std::unique_ptr<base::Value> GetDnsConfigAsValue() const override;
   void SetNoIPv6OnWifi(bool no_ipv6_on_wifi) override;
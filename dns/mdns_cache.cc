@@ -4,7 +4,6 @@
 
 #include "net/dns/mdns_cache.h"
 
-#include <algorithm>
 #include <tuple>
 #include <utility>
 
@@ -54,6 +53,12 @@ MDnsCache::MDnsCache() = default;
 
 MDnsCache::~MDnsCache() = default;
 
+base::Time MDnsCache::next_expiration() const {
+  if (expirations_.empty())
+    return base::Time();
+  return expirations_.begin()->first;
+}
+
 const RecordParsed* MDnsCache::LookupKey(const Key& key) {
   RecordMap::iterator found = mdns_cache_.find(key);
   if (found != mdns_cache_.end()) {
@@ -70,52 +75,37 @@ MDnsCache::UpdateType MDnsCache::UpdateDnsRecord(
   if (record->ttl() == 0 && mdns_cache_.find(cache_key) == mdns_cache_.end())
     return NoChange;
 
-  base::Time new_expiration = GetEffectiveExpiration(record.get());
-  if (next_expiration_ != base::Time())
-    new_expiration = std::min(new_expiration, next_expiration_);
-
   std::pair<RecordMap::iterator, bool> insert_result =
       mdns_cache_.insert(std::make_pair(cache_key, nullptr));
+  const Key* key = &insert_result.first->first;
   UpdateType type = NoChange;
   if (insert_result.second) {
     type = RecordAdded;
   } else {
-    if (record->ttl() != 0 &&
-        !record->IsEqual(insert_result.first->second.get(), true)) {
+    const RecordParsed* old_record = insert_result.first->second.get();
+    if (record->ttl() != 0 && !record->IsEqual(old_record, true))
       type = RecordChanged;
-    }
+    expirations_.erase(
+        std::make_pair(GetEffectiveExpiration(old_record), key));
   }
 
+  expirations_.insert(
+      std::make_pair(GetEffectiveExpiration(record.get()), key));
   insert_result.first->second = std::move(record);
-  next_expiration_ = new_expiration;
   return type;
 }
 
 void MDnsCache::CleanupRecords(
     base::Time now,
     const RecordRemovedCallback& record_removed_callback) {
-  base::Time next_expiration;
-
-  // We are guaranteed that |next_expiration_| will be at or before the next
-  // expiration. This allows clients to eagrely call CleanupRecords with
-  // impunity.
-  if (now < next_expiration_) return;
-
-  for (RecordMap::iterator i = mdns_cache_.begin();
-       i != mdns_cache_.end(); ) {
-    base::Time expiration = GetEffectiveExpiration(i->second.get());
-    if (now >= expiration) {
-      record_removed_callback.Run(i->second.get());
-      mdns_cache_.erase(i++);
-    } else {
-      if (next_expiration == base::Time() ||  expiration < next_expiration) {
-        next_expiration = expiration;
-      }
-      ++i;
-    }
+  // Only the records at the head of |expirations_| are visited, which allows
+  // clients to eagerly call CleanupRecords with impunity.
+  while (!expirations_.empty() && now >= expirations_.begin()->first) {
+    RecordMap::iterator found = mdns_cache_.find(*expirations_.begin()->second);
+    DCHECK(found != mdns_cache_.end());
+    record_removed_callback.Run(found->second.get());
+    EraseRecord(found);
   }
-
-  next_expiration_ = next_expiration;
 }
 
 void MDnsCache::FindDnsRecords(unsigned type,
@@ -148,13 +138,21 @@ std::unique_ptr<const RecordParsed> MDnsCache::RemoveRecord(
 
   if (found != mdns_cache_.end() && found->second.get() == record) {
     std::unique_ptr<const RecordParsed> result = std::move(found->second);
-    mdns_cache_.erase(key);
+    expirations_.erase(
+        std::make_pair(GetEffectiveExpiration(result.get()), &found->first));
+    mdns_cache_.erase(found);
     return result;
   }
 
   return std::unique_ptr<const RecordParsed>();
 }
 
+void MDnsCache::EraseRecord(RecordMap::iterator it) {
+  expirations_.erase(
+      std::make_pair(GetEffectiveExpiration(it->second.get()), &it->first));
+  mdns_cache_.erase(it);
+}
+
 // static
 std::string MDnsCache::GetOptionalFieldForRecord(const RecordParsed* record) {
   switch (record->type()) {
@@ -7,7 +7,9 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
@@ -83,10 +85,9 @@ class NET_EXPORT_PRIVATE MDnsCache {
   void CleanupRecords(base::Time now,
                       const RecordRemovedCallback& record_removed_callback);
 
-  // Returns a time less than or equal to the next time a record will expire.
-  // Is updated when CleanupRecords or UpdateDnsRecord are called. Returns
-  // base::Time when the cache is empty.
-  base::Time next_expiration() const { return next_expiration_; }
+  // Returns the next time a record will expire, or base::Time when the cache
+  // is empty.
+  base::Time next_expiration() const;
 
   // Remove a record from the cache.  Returns a scoped version of the pointer
   // passed in if it was removed, scoped null otherwise.
@@ -95,6 +96,21 @@ class NET_EXPORT_PRIVATE MDnsCache {
  private:
   typedef std::map<Key, std::unique_ptr<const RecordParsed>> RecordMap;
 
+  // Orders records by expiration time, and then by key.
+  struct ExpirationOrder {
+    bool operator()(const std::pair<base::Time, const Key*>& a,
+                    const std::pair<base::Time, const Key*>& b) const {
+      return a.first < b.first || (a.first == b.first && *a.second < *b.second);
+    }
+  };
+
+  // The keys point into |mdns_cache_|.
+  typedef std::set<std::pair<base::Time, const Key*>, ExpirationOrder>
+      ExpirationIndex;
+
+  // Removes the record at |it| from |mdns_cache_| and |expirations_|.
+  void EraseRecord(RecordMap::iterator it);
+
   // Get the effective expiration of a cache entry, based on its creation time
   // and TTL. Does adjustments so entries with a TTL of zero will have a
   // nonzero TTL, as explained in RFC 6762 Section 10.1.
@@ -105,9 +121,13 @@ class NET_EXPORT_PRIVATE MDnsCache {
   // for the same name.
   static std::string GetOptionalFieldForRecord(const RecordParsed* record);
 
+  // Records ordered by name, then type, then optional value, so that the
+  // records of one name are adjacent.
   RecordMap mdns_cache_;
 
-  base::Time next_expiration_;
+  // |mdns_cache_| ordered by effective expiration, so that CleanupRecords only
+  // visits the expired records.
+  ExpirationIndex expirations_;
 
   DISALLOW_COPY_AND_ASSIGN(MDnsCache);
 };
@@ -347,4 +347,35 @@ TEST_F(MDnsCacheTest, RemoveRecord) {
   EXPECT_EQ(0u, results.size());
 }
 
+// Test that removing the record which expires first moves the next expiration
+// to the remaining record, and that it is not reported by a later cleanup.
+TEST_F(MDnsCacheTest, RemoveRecordUpdatesExpiration) {
+  DnsRecordParser parser(kT1ResponseDatagram, sizeof(kT1ResponseDatagram),
+                         sizeof(dns_protocol::Header));
+  parser.SkipQuestion();
+
+  std::unique_ptr<const RecordParsed> record1;
+  std::unique_ptr<const RecordParsed> record2;
+
+  record1 = RecordParsed::CreateFrom(&parser, default_time_);
+  base::TimeDelta ttl1 = base::TimeDelta::FromSeconds(record1->ttl());
+
+  record2 = RecordParsed::CreateFrom(&parser, default_time_);
+  base::TimeDelta ttl2 = base::TimeDelta::FromSeconds(record2->ttl());
+  const RecordParsed* record_to_be_removed = record2.get();
+  ASSERT_LT(ttl2, ttl1);
+
+  EXPECT_EQ(MDnsCache::RecordAdded, cache_.UpdateDnsRecord(std::move(record1)));
+  EXPECT_EQ(MDnsCache::RecordAdded, cache_.UpdateDnsRecord(std::move(record2)));
+  EXPECT_EQ(default_time_ + ttl2, cache_.next_expiration());
+
+  EXPECT_TRUE(cache_.RemoveRecord(record_to_be_removed));
+  EXPECT_EQ(default_time_ + ttl1, cache_.next_expiration());
+
+  // |record_removal_| is strict, so any removal reported here fails the test.
+  cache_.CleanupRecords(default_time_ + ttl2, base::Bind(
+      &RecordRemovalMock::OnRecordRemoved, base::Unretained(&record_removal_)));
+  EXPECT_EQ(default_time_ + ttl1, cache_.next_expiration());
+}
+
 }  // namespace net
@@ -266,12 +266,18 @@ void MDnsClientImpl::Core::HandlePacket(DnsResponse* response,
     MDnsCache::Key update_key = MDnsCache::Key::CreateFor(record.get());
     MDnsCache::UpdateType update = cache_.UpdateDnsRecord(std::move(record));
 
-    // Cleanup time may have changed.
-    ScheduleCleanup(cache_.next_expiration());
-
     update_keys.insert(std::make_pair(update_key, update));
   }
 
+  // Cleanup time may have changed. It is rescheduled once for the whole
+  // packet.
+  ScheduleCleanup(cache_.next_expiration());
+
+  // The updates are delivered only after the whole packet is in the cache, so
+  // listeners see every record of the packet. |update_keys| is ordered by name
+  // and then type, so the updates for one listener key are adjacent and its
+  // observer list is looked up once.
+  ListenerMap::iterator listeners = listeners_.end();
   for (std::map<MDnsCache::Key, MDnsCache::UpdateType>::iterator i =
            update_keys.begin(); i != update_keys.end(); i++) {
     const RecordParsed* record = cache_.LookupKey(i->first);
@@ -282,10 +288,16 @@ void MDnsClientImpl::Core::HandlePacket(DnsResponse* response,
 #if defined(ENABLE_NSEC)
       NotifyNsecRecord(record);
 #endif
-    } else {
-      AlertListeners(i->second, ListenerKey(record->name(), record->type()),
-                     record);
+      continue;
     }
+
+    ListenerKey key(record->name(), record->type());
+    if (listeners == listeners_.end() || listeners->first != key)
+      listeners = listeners_.find(key);
+    if (listeners == listeners_.end())
+      continue;
+    for (auto& observer : *listeners->second)
+      observer.HandleRecordUpdate(i->second, record);
   }
 }
 
@@ -89,6 +89,7 @@ class SQLitePersistentCookieStore::Backend
       CookieCryptoDelegate* crypto_delegate)
       : path_(path),
         num_pending_(0),
+        num_priority_loads_queued_(0),
         initialized_(false),
         corruption_detected_(false),
         restore_old_session_cookies_(restore_old_session_cookies),
@@ -231,7 +232,8 @@ class SQLitePersistentCookieStore::Backend
   void DatabaseErrorCallback(int error, sql::Statement* stmt);
   void KillDatabase();
 
-  void PostBackgroundTask(const base::Location& origin, base::OnceClosure task);
+  // Returns false if |task| could not be posted.
+  bool PostBackgroundTask(const base::Location& origin, base::OnceClosure task);
   void PostClientTask(const base::Location& origin, base::OnceClosure task);
 
   // Shared code between the different load strategies to be used after all
@@ -246,7 +248,10 @@ class SQLitePersistentCookieStore::Backend
   typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
-  // Guard |cookies_|, |pending_|, |num_pending_|.
+  // The number of LoadCookiesForKey() requests posted to the background runner
+  // which haven't started yet.
+  int num_priority_loads_queued_;
+  // Guard |cookies_|, |pending_|, |num_pending_|, |num_priority_loads_queued_|.
   base::Lock lock_;
 
   // Temporary buffer for cookies loaded from DB. Accumulates cookies to reduce
@@ -492,10 +497,18 @@ void SQLitePersistentCookieStore::Backend::LoadCookiesForKey(
     num_priority_waiting_++;
     total_priority_requests_++;
   }
+  // Counted before posting, so that the task can't run before it is counted.
+  {
+    base::AutoLock locked(lock_);
+    num_priority_loads_queued_++;
+  }
 
-  PostBackgroundTask(
-      FROM_HERE, base::Bind(&Backend::LoadKeyAndNotifyInBackground, this, key,
-                            loaded_callback, base::Time::Now()));
+  if (!PostBackgroundTask(
+          FROM_HERE, base::Bind(&Backend::LoadKeyAndNotifyInBackground, this,
+                                key, loaded_callback, base::Time::Now()))) {
+    base::AutoLock locked(lock_);
+    num_priority_loads_queued_--;
+  }
 }
 
 void SQLitePersistentCookieStore::Backend::LoadAndNotifyInBackground(
@@ -528,6 +541,10 @@ void SQLitePersistentCookieStore::Backend::LoadKeyAndNotifyInBackground(
                              base::Time::Now() - posted_at,
                              base::TimeDelta::FromMilliseconds(1),
                              base::TimeDelta::FromMinutes(1), 50);
+  {
+    base::AutoLock locked(lock_);
+    num_priority_loads_queued_--;
+  }
 
   bool success = false;
   if (InitializeDatabase()) {
@@ -736,6 +753,20 @@ void SQLitePersistentCookieStore::Backend::ChainLoadCookies(
   DCHECK(background_task_runner_->RunsTasksInCurrentSequence());
   IncrementTimeDelta increment(&cookie_load_duration_);
 
+  // Requests are blocked on the keys of priority loads, while the remaining
+  // keys are only loaded ahead of need. So step aside for the priority loads
+  // already queued, which run before this task once it is posted again.
+  bool priority_load_queued;
+  {
+    base::AutoLock locked(lock_);
+    priority_load_queued = num_priority_loads_queued_ > 0;
+  }
+  if (db_ && priority_load_queued) {
+    PostBackgroundTask(FROM_HERE, base::Bind(&Backend::ChainLoadCookies, this,
+                                             loaded_callback));
+    return;
+  }
+
   bool load_success = true;
 
   if (!db_) {
@@ -1355,13 +1386,15 @@ void SQLitePersistentCookieStore::Backend::BackgroundDeleteAllInList(
     LOG(WARNING) << "Unable to delete cookies on shutdown.";
 }
 
-void SQLitePersistentCookieStore::Backend::PostBackgroundTask(
+bool SQLitePersistentCookieStore::Backend::PostBackgroundTask(
     const base::Location& origin,
     base::OnceClosure task) {
   if (!background_task_runner_->PostTask(origin, std::move(task))) {
     LOG(WARNING) << "Failed to post task from " << origin.ToString()
                  << " to background_task_runner_.";
+    return false;
   }
+  return true;
 }
 
 void SQLitePersistentCookieStore::Backend::PostClientTask(
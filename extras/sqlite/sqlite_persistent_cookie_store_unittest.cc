@@ -422,6 +422,76 @@ TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
   cookies_.clear();
 }
 
+// Test that the chain load steps aside, between two domain keys, for a priority
+// load queued behind it.
+TEST_F(SQLitePersistentCookieStoreTest, TestChainLoadYieldsToPriorityLoad) {
+  InitializeStore(false, false);
+  base::Time t = base::Time::Now();
+  AddCookie("A", "B", "www.aaa.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "www.bbb.com", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("A", "B", "foo.bar", "/", t);
+  DestroyStore();
+
+  // See TestLoadCookiesForKey for why |client_task_runner_| is not used.
+  store_ = new SQLitePersistentCookieStore(
+      temp_dir_.GetPath().Append(kCookieFilename),
+      base::ThreadTaskRunnerHandle::Get(), background_task_runner_, false,
+      nullptr);
+
+  base::WaitableEvent chain_load_posted(
+      base::WaitableEvent::ResetPolicy::AUTOMATIC,
+      base::WaitableEvent::InitialState::NOT_SIGNALED);
+  background_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                            base::Unretained(this)));
+  store_->Load(base::Bind(&SQLitePersistentCookieStoreTest::OnLoaded,
+                          base::Unretained(this)));
+  background_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&base::WaitableEvent::Signal,
+                            base::Unretained(&chain_load_posted)));
+  background_task_runner_->PostTask(
+      FROM_HERE, base::Bind(&SQLitePersistentCookieStoreTest::WaitOnDBEvent,
+                            base::Unretained(this)));
+
+  // Let the load initialize the store and load aaa.com, the first domain key.
+  // It posts the chain load of bbb.com after the second wait.
+  db_thread_event_.Signal();
+  chain_load_posted.Wait();
+
+  base::RunLoop run_loop;
+  store_->LoadCookiesForKey(
+      "foo.bar", base::Bind(&SQLitePersistentCookieStoreTest::OnKeyLoaded,
+                            base::Unretained(this), run_loop.QuitClosure()));
+
+  // Now the DB-thread queue contains:
+  // (active:)
+  // 1. Wait (on db_event)
+  // (pending:)
+  // 2. Chain-Load (bbb.com)
+  // 3. Priority Load (foo.bar)
+  db_thread_event_.Signal();
+
+  // The priority load gets the cookies loaded so far, which don't include
+  // bbb.com's as the chain load yielded.
+  run_loop.Run();
+  EXPECT_FALSE(loaded_event_.IsSignaled());
+  std::set<std::string> cookies_loaded;
+  for (const auto& cookie : cookies_)
+    cookies_loaded.insert(cookie->Domain());
+  cookies_.clear();
+  EXPECT_EQ(2u, cookies_loaded.size());
+  EXPECT_EQ(1u, cookies_loaded.count("www.aaa.com"));
+  EXPECT_EQ(1u, cookies_loaded.count("foo.bar"));
+
+  NetTestSuite::GetScopedTaskEnvironment()->RunUntilIdle();
+  EXPECT_TRUE(loaded_event_.IsSignaled());
+  ASSERT_EQ(1u, cookies_.size());
+  EXPECT_EQ("www.bbb.com", cookies_[0]->Domain());
+  cookies_.clear();
+}
+
 TEST_F(SQLitePersistentCookieStoreTest, TestBeforeFlushCallback) {
   InitializeStore(false, false);
 
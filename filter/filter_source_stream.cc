@@ -4,6 +4,8 @@
 
 #include "net/filter/filter_source_stream.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/logging.h"
@@ -22,7 +24,9 @@ const char kGZip[] = "gzip";
 const char kXGZip[] = "x-gzip";
 const char kBrotli[] = "br";
 
-const size_t kBufferSize = 32 * 1024;
+// The initial and the largest size of the reads from |upstream_|.
+const int kBufferSize = 32 * 1024;
+const int kMaxBufferSize = 128 * 1024;
 
 }  // namespace
 
@@ -31,6 +35,9 @@ FilterSourceStream::FilterSourceStream(SourceType type,
     : SourceStream(type),
       upstream_(std::move(upstream)),
       next_state_(STATE_NONE),
+      input_buffer_size_(0),
+      total_input_bytes_(0),
+      total_output_bytes_(0),
       output_buffer_size_(0),
       upstream_end_reached_(false) {
   DCHECK(upstream_);
@@ -48,6 +55,7 @@ int FilterSourceStream::Read(IOBuffer* read_buffer,
   // Allocate a BlockBuffer during first Read().
   if (!input_buffer_) {
     input_buffer_ = new IOBufferWithSize(kBufferSize);
+    input_buffer_size_ = kBufferSize;
     // This is first Read(), start with reading data from |upstream_|.
     next_state_ = STATE_READ_DATA;
   } else {
@@ -125,10 +133,23 @@ int FilterSourceStream::DoReadData() {
   DCHECK(drainable_input_buffer_ == nullptr ||
          0 == drainable_input_buffer_->BytesRemaining());
 
+  // Grow the input buffer when the caller's buffer could hold the output of a
+  // larger read, going by the ratio observed so far. For content which
+  // compresses poorly this saves round trips through upstream and FilterData().
+  if (total_output_bytes_ > 0 && input_buffer_size_ < kMaxBufferSize) {
+    int64_t wanted =
+        output_buffer_size_ * total_input_bytes_ / total_output_bytes_;
+    if (wanted > input_buffer_size_) {
+      input_buffer_size_ =
+          static_cast<int>(std::min<int64_t>(wanted, kMaxBufferSize));
+      input_buffer_ = new IOBufferWithSize(input_buffer_size_);
+    }
+  }
+
   next_state_ = STATE_READ_DATA_COMPLETE;
   // Use base::Unretained here is safe because |this| owns |upstream_|.
   int rv = upstream_->Read(
-      input_buffer_.get(), kBufferSize,
+      input_buffer_.get(), input_buffer_size_,
       base::Bind(&FilterSourceStream::OnIOComplete, base::Unretained(this)));
 
   return rv;
@@ -168,6 +189,9 @@ int FilterSourceStream::DoFilterData() {
 
   if (consumed_bytes > 0)
     drainable_input_buffer_->DidConsume(consumed_bytes);
+  total_input_bytes_ += consumed_bytes;
+  if (bytes_output > 0)
+    total_output_bytes_ += bytes_output;
 
   // Received data or encountered an error.
   if (bytes_output != 0)
@@ -5,6 +5,8 @@
 #ifndef NET_FILTER_FILTER_SOURCE_STREAM_H_
 #define NET_FILTER_FILTER_SOURCE_STREAM_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
@@ -101,6 +103,13 @@ class NET_EXPORT_PRIVATE FilterSourceStream : public SourceStream {
   // Buffer for reading data out of |upstream_| and then for use by |this|
   // before the filtered data is returned through Read().
   scoped_refptr<IOBuffer> input_buffer_;
+  int input_buffer_size_;
+
+  // The number of bytes consumed from, and output by, FilterData() so far.
+  // Their ratio sizes the reads from |upstream_|, so that a read fills about
+  // as much of the caller's buffer as it can hold.
+  int64_t total_input_bytes_;
+  int64_t total_output_bytes_;
 
   // Wrapper around |input_buffer_| that makes visible only the unread data.
   // Keep this as a member because subclass might not drain everything in a
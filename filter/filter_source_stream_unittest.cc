@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
@@ -211,6 +212,33 @@ class ErrorFilterSourceStream : public FilterSourceStream {
   DISALLOW_COPY_AND_ASSIGN(ErrorFilterSourceStream);
 };
 
+// A SourceStream that synchronously returns |total_bytes| bytes of 'a', and
+// records the size of the buffer given to every Read().
+class RecordingSourceStream : public SourceStream {
+ public:
+  explicit RecordingSourceStream(int total_bytes)
+      : SourceStream(SourceStream::TYPE_NONE), remaining_bytes_(total_bytes) {}
+
+  int Read(IOBuffer* dest_buffer,
+           int buffer_size,
+           const CompletionCallback& callback) override {
+    read_sizes_.push_back(buffer_size);
+    int bytes_read = std::min(buffer_size, remaining_bytes_);
+    memset(dest_buffer->data(), 'a', bytes_read);
+    remaining_bytes_ -= bytes_read;
+    return bytes_read;
+  }
+  std::string Description() const override { return ""; }
+
+  const std::vector<int>& read_sizes() const { return read_sizes_; }
+
+ private:
+  int remaining_bytes_;
+  std::vector<int> read_sizes_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingSourceStream);
+};
+
 }  // namespace
 
 class FilterSourceStreamTest
@@ -544,4 +572,33 @@ TEST_P(FilterSourceStreamTest, ThrottleSourceStream) {
   EXPECT_EQ(input, actual_output);
 }
 
+// Tests that reads from upstream grow to fill most of a large output buffer
+// once the ratio of output to input bytes is known, but never past 128KB.
+TEST(FilterSourceStreamReadSizeTest, ReadSizeFollowsOutputBuffer) {
+  const int kOutputBufferSize = 512 * 1024;
+  std::unique_ptr<RecordingSourceStream> source(
+      new RecordingSourceStream(kOutputBufferSize));
+  RecordingSourceStream* recording_stream = source.get();
+  PassThroughFilterSourceStream stream(std::move(source));
+  scoped_refptr<IOBufferWithSize> output_buffer =
+      new IOBufferWithSize(kOutputBufferSize);
+  TestCompletionCallback callback;
+  int total_bytes_read = 0;
+  while (true) {
+    int rv = stream.Read(output_buffer.get(), output_buffer->size(),
+                         callback.callback());
+    ASSERT_LE(OK, rv);
+    if (rv == OK)
+      break;
+    total_bytes_read += rv;
+  }
+  EXPECT_EQ(kOutputBufferSize, total_bytes_read);
+
+  const std::vector<int>& read_sizes = recording_stream->read_sizes();
+  ASSERT_LE(2u, read_sizes.size());
+  EXPECT_EQ(32 * 1024, read_sizes[0]);
+  for (size_t i = 1; i < read_sizes.size(); ++i)
+    EXPECT_EQ(128 * 1024, read_sizes[i]);
+}
+
 }  // namespace net
@@ -0,0 +1,318 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/filter/threaded_source_stream.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/callback_helpers.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "net/base/io_buffer.h"
+#include "net/base/io_buffer_chain.h"
+#include "net/base/net_errors.h"
+
+namespace net {
+
+namespace {
+
+// The size of the reads from |upstream_|.
+const int kChunkSize = 32 * 1024;
+
+// The number of chunks read from |upstream_| ahead of the decoder.
+const int kMaxPendingInputChunks = 4;
+
+}  // namespace
+
+// Owns the decoding streams, and feeds them with the chunks read from
+// |upstream_|. Created on the calling thread, then only used on the worker
+// sequence.
+class ThreadedSourceStream::Core {
+ public:
+  Core(const std::string& upstream_description,
+       scoped_refptr<base::SequencedTaskRunner> origin_task_runner);
+  ~Core();
+
+  // Builds |decoder_|. Returns false if |factory| fails.
+  bool Init(DecoderFactory factory);
+
+  SourceStream::SourceType decoder_type() const { return decoder_->type(); }
+  std::string decoder_description() const { return decoder_->Description(); }
+
+  void set_stream(base::WeakPtr<ThreadedSourceStream> stream) {
+    stream_ = stream;
+  }
+
+  // Adds the result of a read from |upstream_|: |buffer| holds |result| bytes
+  // of data if |result| is positive. Otherwise the end of |upstream_| has been
+  // reached, and |result| is what the decoder reads from then on.
+  void AddInput(scoped_refptr<IOBuffer> buffer, int result);
+
+  // Decodes up to |buffer_size| bytes into |dest_buffer|, and replies with the
+  // result to the calling thread.
+  void Read(scoped_refptr<IOBuffer> dest_buffer, int buffer_size);
+
+ private:
+  class InputStream;
+
+  // Serves the reads of the decoder from |input_|.
+  int ReadInput(IOBuffer* dest_buffer,
+                int buffer_size,
+                const CompletionCallback& callback);
+  // Copies data from |input_|. Returns ERR_IO_PENDING if there is none yet.
+  int CopyInput(IOBuffer* dest_buffer, int buffer_size);
+
+  void OnDecoderReadComplete(int result);
+
+  const std::string upstream_description_;
+  scoped_refptr<base::SequencedTaskRunner> origin_task_runner_;
+  base::WeakPtr<ThreadedSourceStream> stream_;
+
+  std::unique_ptr<SourceStream> decoder_;
+
+  // The chunks read from |upstream_|, which are kept as slices of the buffers
+  // they were read into.
+  IOBufferChain input_;
+  bool input_end_reached_;
+  int input_end_result_;
+
+  // The read of the decoder waiting for more input, if any.
+  scoped_refptr<IOBuffer> pending_input_buffer_;
+  int pending_input_buffer_size_;
+  CompletionCallback pending_input_callback_;
+
+  // The buffer of the Read() in progress.
+  scoped_refptr<IOBuffer> output_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(Core);
+};
+
+// The stand-in for |upstream_| which the decoding streams read from.
+class ThreadedSourceStream::Core::InputStream : public SourceStream {
+ public:
+  explicit InputStream(Core* core)
+      : SourceStream(SourceStream::TYPE_NONE), core_(core) {}
+  ~InputStream() override = default;
+
+  int Read(IOBuffer* dest_buffer,
+           int buffer_size,
+           const CompletionCallback& callback) override {
+    return core_->ReadInput(dest_buffer, buffer_size, callback);
+  }
+  std::string Description() const override {
+    return core_->upstream_description_;
+  }
+
+ private:
+  Core* const core_;
+
+  DISALLOW_COPY_AND_ASSIGN(InputStream);
+};
+
+ThreadedSourceStream::Core::Core(
+    const std::string& upstream_description,
+    scoped_refptr<base::SequencedTaskRunner> origin_task_runner)
+    : upstream_description_(upstream_description),
+      origin_task_runner_(std::move(origin_task_runner)),
+      input_end_reached_(false),
+      input_end_result_(OK),
+      pending_input_buffer_size_(0) {}
+
+ThreadedSourceStream::Core::~Core() = default;
+
+bool ThreadedSourceStream::Core::Init(DecoderFactory factory) {
+  decoder_ = std::move(factory).Run(std::make_unique<InputStream>(this));
+  return decoder_ != nullptr;
+}
+
+void ThreadedSourceStream::Core::AddInput(scoped_refptr<IOBuffer> buffer,
+                                          int result) {
+  DCHECK(!input_end_reached_);
+  if (result > 0) {
+    input_.Append(std::move(buffer), 0, result);
+  } else {
+    input_end_reached_ = true;
+    input_end_result_ = result;
+  }
+
+  if (pending_input_callback_.is_null())
+    return;
+  int rv = CopyInput(pending_input_buffer_.get(), pending_input_buffer_size_);
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  pending_input_buffer_ = nullptr;
+  pending_input_buffer_size_ = 0;
+  base::ResetAndReturn(&pending_input_callback_).Run(rv);
+}
+
+void ThreadedSourceStream::Core::Read(scoped_refptr<IOBuffer> dest_buffer,
+                                      int buffer_size) {
+  DCHECK(!output_buffer_);
+  output_buffer_ = std::move(dest_buffer);
+  // Using base::Unretained here is safe because |this| owns |decoder_|.
+  int rv = decoder_->Read(
+      output_buffer_.get(), buffer_size,
+      base::Bind(&Core::OnDecoderReadComplete, base::Unretained(this)));
+  if (rv != ERR_IO_PENDING)
+    OnDecoderReadComplete(rv);
+}
+
+int ThreadedSourceStream::Core::ReadInput(IOBuffer* dest_buffer,
+                                          int buffer_size,
+                                          const CompletionCallback& callback) {
+  DCHECK(pending_input_callback_.is_null());
+  int rv = CopyInput(dest_buffer, buffer_size);
+  if (rv != ERR_IO_PENDING)
+    return rv;
+  pending_input_buffer_ = dest_buffer;
+  pending_input_buffer_size_ = buffer_size;
+  pending_input_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
+int ThreadedSourceStream::Core::CopyInput(IOBuffer* dest_buffer,
+                                          int buffer_size) {
+  if (input_.empty())
+    return input_end_reached_ ? input_end_result_ : ERR_IO_PENDING;
+
+  // A read may span several chunks. Each chunk fully consumed frees a slot
+  // for reading ahead from |upstream_|.
+  size_t bytes_copied =
+      std::min(static_cast<size_t>(buffer_size), input_.size());
+  size_t num_chunks = input_.slices().size();
+  input_.CopyTo(dest_buffer->data(), bytes_copied);
+  input_.Consume(bytes_copied);
+  for (size_t i = input_.slices().size(); i < num_chunks; ++i) {
+    origin_task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(&ThreadedSourceStream::OnInputChunkConsumed, stream_));
+  }
+  return static_cast<int>(bytes_copied);
+}
+
+void ThreadedSourceStream::Core::OnDecoderReadComplete(int result) {
+  output_buffer_ = nullptr;
+  origin_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&ThreadedSourceStream::OnReadComplete, stream_, result));
+}
+
+// static
+std::unique_ptr<ThreadedSourceStream> ThreadedSourceStream::Create(
+    std::unique_ptr<SourceStream> upstream,
+    DecoderFactory factory,
+    scoped_refptr<base::SequencedTaskRunner> task_runner) {
+  auto core = std::make_unique<Core>(upstream->Description(),
+                                     base::SequencedTaskRunnerHandle::Get());
+  if (!core->Init(std::move(factory)))
+    return nullptr;
+  return base::WrapUnique(new ThreadedSourceStream(
+      std::move(upstream), std::move(core), std::move(task_runner)));
+}
+
+ThreadedSourceStream::ThreadedSourceStream(
+    std::unique_ptr<SourceStream> upstream,
+    std::unique_ptr<Core> core,
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : SourceStream(core->decoder_type()),
+      upstream_(std::move(upstream)),
+      core_(std::move(core)),
+      task_runner_(std::move(task_runner)),
+      description_(core_->decoder_description()),
+      pending_input_chunks_(0),
+      upstream_read_pending_(false),
+      upstream_end_reached_(false),
+      held_read_result_(ERR_IO_PENDING),
+      weak_factory_(this) {
+  core_->set_stream(weak_factory_.GetWeakPtr());
+}
+
+ThreadedSourceStream::~ThreadedSourceStream() {
+  // Tasks already posted to |core_| run before it is deleted.
+  task_runner_->DeleteSoon(FROM_HERE, core_.release());
+}
+
+int ThreadedSourceStream::Read(IOBuffer* dest_buffer,
+                               int buffer_size,
+                               const CompletionCallback& callback) {
+  DCHECK(read_callback_.is_null());
+  DCHECK_LT(0, buffer_size);
+
+  // Using base::Unretained here is safe because |core_| is deleted by a task
+  // posted after this one.
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&Core::Read, base::Unretained(core_.get()),
+                            base::WrapRefCounted(dest_buffer), buffer_size));
+  read_callback_ = callback;
+  ReadUpstream();
+  return ERR_IO_PENDING;
+}
+
+std::string ThreadedSourceStream::Description() const {
+  return description_;
+}
+
+void ThreadedSourceStream::ReadUpstream() {
+  while (!read_callback_.is_null() && !upstream_read_pending_ &&
+         !upstream_end_reached_ &&
+         pending_input_chunks_ < kMaxPendingInputChunks) {
+    upstream_read_buffer_ = base::MakeRefCounted<IOBuffer>(kChunkSize);
+    // Using base::Unretained here is safe because |this| owns |upstream_|.
+    int rv = upstream_->Read(
+        upstream_read_buffer_.get(), kChunkSize,
+        base::Bind(&ThreadedSourceStream::OnUpstreamReadComplete,
+                   base::Unretained(this)));
+    if (rv == ERR_IO_PENDING) {
+      upstream_read_pending_ = true;
+      return;
+    }
+    DidReadUpstream(rv);
+  }
+}
+
+void ThreadedSourceStream::OnUpstreamReadComplete(int result) {
+  DCHECK(upstream_read_pending_);
+  upstream_read_pending_ = false;
+  DidReadUpstream(result);
+  if (held_read_result_ != ERR_IO_PENDING) {
+    int rv = held_read_result_;
+    held_read_result_ = ERR_IO_PENDING;
+    base::ResetAndReturn(&read_callback_).Run(rv);
+    return;
+  }
+  ReadUpstream();
+}
+
+void ThreadedSourceStream::DidReadUpstream(int result) {
+  DCHECK_NE(ERR_IO_PENDING, result);
+  if (result > 0)
+    ++pending_input_chunks_;
+  else
+    upstream_end_reached_ = true;
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&Core::AddInput, base::Unretained(core_.get()),
+                            std::move(upstream_read_buffer_), result));
+}
+
+void ThreadedSourceStream::OnInputChunkConsumed() {
+  DCHECK_LT(0, pending_input_chunks_);
+  --pending_input_chunks_;
+  ReadUpstream();
+}
+
+void ThreadedSourceStream::OnReadComplete(int result) {
+  DCHECK(!read_callback_.is_null());
+  DCHECK_EQ(ERR_IO_PENDING, held_read_result_);
+  if (upstream_read_pending_) {
+    held_read_result_ = result;
+    return;
+  }
+  base::ResetAndReturn(&read_callback_).Run(result);
+}
+
+}  // namespace net
@@ -0,0 +1,107 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_FILTER_THREADED_SOURCE_STREAM_H_
+#define NET_FILTER_THREADED_SOURCE_STREAM_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/completion_callback.h"
+#include "net/base/net_export.h"
+#include "net/filter/source_stream.h"
+
+namespace base {
+class SequencedTaskRunner;
+}  // namespace base
+
+namespace net {
+
+class IOBuffer;
+
+// A SourceStream which decodes the data of another SourceStream on a worker
+// sequence, so that decoding a large response does not hold up the thread the
+// stream is used on.
+//
+// The decoding streams are built over a stand-in for |upstream|, which lives
+// on the worker sequence and is fed with the data read from |upstream| on the
+// calling thread. Reads from |upstream| run a few chunks ahead of the decoder,
+// and wait for it to catch up after that.
+//
+// |upstream| is only read while a Read() is pending, and a Read() does not
+// complete while a read from |upstream| is pending: a URLRequestJob's source
+// stream must only be read from within a URLRequest::Read().
+//
+// Read() always completes asynchronously.
+class NET_EXPORT_PRIVATE ThreadedSourceStream : public SourceStream {
+ public:
+  // Returns the streams which decode the data of the SourceStream it is given.
+  // Run once, by Create(). The streams returned are then only used on the
+  // worker sequence.
+  using DecoderFactory = base::OnceCallback<std::unique_ptr<SourceStream>(
+      std::unique_ptr<SourceStream> input)>;
+
+  // Returns a stream which decodes |upstream| on |task_runner| with the
+  // streams built by |factory|, or nullptr if |factory| returns nullptr.
+  static std::unique_ptr<ThreadedSourceStream> Create(
+      std::unique_ptr<SourceStream> upstream,
+      DecoderFactory factory,
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+
+  ~ThreadedSourceStream() override;
+
+  // SourceStream implementation.
+  int Read(IOBuffer* dest_buffer,
+           int buffer_size,
+           const CompletionCallback& callback) override;
+  std::string Description() const override;
+
+ private:
+  class Core;
+
+  ThreadedSourceStream(std::unique_ptr<SourceStream> upstream,
+                       std::unique_ptr<Core> core,
+                       scoped_refptr<base::SequencedTaskRunner> task_runner);
+
+  // Reads from |upstream_| while a Read() is pending, until enough chunks are
+  // waiting for the decoder, a read is pending, or the end of |upstream_| is
+  // reached.
+  void ReadUpstream();
+  void OnUpstreamReadComplete(int result);
+  // Hands the result of a read from |upstream_| to |core_|.
+  void DidReadUpstream(int result);
+
+  // Invoked by |core_| on the calling thread.
+  void OnInputChunkConsumed();
+  void OnReadComplete(int result);
+
+  std::unique_ptr<SourceStream> upstream_;
+  // Only used on |task_runner_|, and deleted there.
+  std::unique_ptr<Core> core_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  const std::string description_;
+
+  // The chunks read from |upstream_| which the decoder has not consumed yet.
+  int pending_input_chunks_;
+  scoped_refptr<IOBuffer> upstream_read_buffer_;
+  bool upstream_read_pending_;
+  bool upstream_end_reached_;
+
+  CompletionCallback read_callback_;
+  // The result of the pending Read(), held until the pending read from
+  // |upstream_| completes. ERR_IO_PENDING if there is none.
+  int held_read_result_;
+
+  base::WeakPtrFactory<ThreadedSourceStream> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadedSourceStream);
+};
+
+}  // namespace net
+
+#endif  // NET_FILTER_THREADED_SOURCE_STREAM_H_
@@ -0,0 +1,154 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/filter/threaded_source_stream.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/task_scheduler/post_task.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/filter/filter_source_stream_test_util.h"
+#include "net/filter/gzip_source_stream.h"
+#include "net/filter/mock_source_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kOutputBufferSize = 4096;
+
+std::unique_ptr<SourceStream> CreateGzipStream(
+    std::unique_ptr<SourceStream> input) {
+  return GzipSourceStream::Create(std::move(input), SourceStream::TYPE_GZIP);
+}
+
+class ThreadedSourceStreamTest
+    : public ::testing::TestWithParam<MockSourceStream::Mode> {
+ protected:
+  // Compresses |source_data_|, and returns a MockSourceStream which serves it
+  // in chunks of at most |chunk_size| bytes, in the mode under test.
+  std::unique_ptr<MockSourceStream> CreateSource(int chunk_size) {
+    // Data which barely compresses, so that it takes many chunks.
+    uint32_t state = 1;
+    for (int i = 0; i < 256 * 1024; i++) {
+      state = state * 1103515245 + 12345;
+      source_data_.push_back(static_cast<char>(state >> 24));
+    }
+
+    std::string encoded_data(source_data_.size() + 1024, '\0');
+    size_t encoded_data_len = encoded_data.size();
+    CompressGzip(source_data_.data(), source_data_.size(), &encoded_data[0],
+                 &encoded_data_len, true);
+    encoded_data.resize(encoded_data_len);
+
+    std::unique_ptr<MockSourceStream> source(new MockSourceStream());
+    source_ = source.get();
+    for (size_t offset = 0; offset < encoded_data.size();
+         offset += chunk_size) {
+      int len =
+          std::min(chunk_size, static_cast<int>(encoded_data.size() - offset));
+      source->AddReadResult(encoded_data.data() + offset, len, OK, GetParam());
+    }
+    source->AddReadResult(nullptr, 0, OK, GetParam());
+    return source;
+  }
+
+  // Reads |stream| to the end, completing the reads of |source_| as they
+  // are made.
+  int ReadStream(SourceStream* stream, std::string* output) {
+    scoped_refptr<IOBuffer> buffer =
+        base::MakeRefCounted<IOBuffer>(kOutputBufferSize);
+    while (true) {
+      TestCompletionCallback callback;
+      int rv = stream->Read(buffer.get(), kOutputBufferSize,
+                            callback.callback());
+      EXPECT_EQ(ERR_IO_PENDING, rv);
+      while (GetParam() == MockSourceStream::ASYNC &&
+             !callback.have_result()) {
+        if (source_->awaiting_completion())
+          source_->CompleteNextRead();
+        else
+          base::RunLoop().RunUntilIdle();
+      }
+      rv = callback.WaitForResult();
+      if (rv <= OK)
+        return rv;
+      output->append(buffer->data(), rv);
+    }
+  }
+
+  std::string source_data_;
+  MockSourceStream* source_ = nullptr;
+};
+
+INSTANTIATE_TEST_CASE_P(ThreadedSourceStreamTests,
+                        ThreadedSourceStreamTest,
+                        ::testing::Values(MockSourceStream::SYNC,
+                                          MockSourceStream::ASYNC));
+
+TEST_P(ThreadedSourceStreamTest, DecodesOnWorkerSequence) {
+  std::unique_ptr<ThreadedSourceStream> stream = ThreadedSourceStream::Create(
+      CreateSource(8 * 1024), base::BindOnce(&CreateGzipStream),
+      base::CreateSequencedTaskRunnerWithTraits({}));
+  ASSERT_TRUE(stream);
+  EXPECT_EQ(SourceStream::TYPE_GZIP, stream->type());
+  EXPECT_EQ("GZIP", stream->Description());
+
+  std::string output;
+  EXPECT_EQ(OK, ReadStream(stream.get(), &output));
+  EXPECT_EQ(source_data_, output);
+}
+
+TEST_P(ThreadedSourceStreamTest, UpstreamError) {
+  std::unique_ptr<MockSourceStream> source(new MockSourceStream());
+  source_ = source.get();
+  source->AddReadResult(nullptr, 0, ERR_CONNECTION_RESET, GetParam());
+  std::unique_ptr<ThreadedSourceStream> stream = ThreadedSourceStream::Create(
+      std::move(source), base::BindOnce(&CreateGzipStream),
+      base::CreateSequencedTaskRunnerWithTraits({}));
+  ASSERT_TRUE(stream);
+
+  std::string output;
+  EXPECT_EQ(ERR_CONNECTION_RESET, ReadStream(stream.get(), &output));
+  EXPECT_TRUE(output.empty());
+}
+
+// Tests that the stream can be destroyed while a read is in progress.
+TEST(ThreadedSourceStreamDestroyTest, DestroyDuringRead) {
+  const char kData[] = "Hello, world!";
+  char encoded_data[256];
+  size_t encoded_data_len = sizeof(encoded_data);
+  CompressGzip(kData, sizeof(kData) - 1, encoded_data, &encoded_data_len,
+               true);
+  std::unique_ptr<MockSourceStream> source(new MockSourceStream());
+  source->AddReadResult(encoded_data, encoded_data_len, OK,
+                        MockSourceStream::SYNC);
+  source->AddReadResult(nullptr, 0, OK, MockSourceStream::SYNC);
+  std::unique_ptr<ThreadedSourceStream> stream = ThreadedSourceStream::Create(
+      std::move(source), base::BindOnce(&CreateGzipStream),
+      base::CreateSequencedTaskRunnerWithTraits({}));
+  ASSERT_TRUE(stream);
+
+  scoped_refptr<IOBuffer> buffer =
+      base::MakeRefCounted<IOBuffer>(kOutputBufferSize);
+  TestCompletionCallback callback;
+  EXPECT_EQ(ERR_IO_PENDING, stream->Read(buffer.get(), kOutputBufferSize,
+                                         callback.callback()));
+  stream.reset();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(callback.have_result());
+}
+
+}  // namespace
+
+}  // namespace net
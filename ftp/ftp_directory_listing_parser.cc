@@ -5,6 +5,7 @@
 #include "net/ftp/ftp_directory_listing_parser.h"
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback.h"
 #include "base/i18n/encoding_detection.h"
 #include "base/i18n/icu_string_conversions.h"
@@ -47,21 +48,28 @@ int ParseListing(const base::string16& text,
                  FtpServerType* server_type) {
   std::vector<base::string16> lines = base::SplitStringUsingSubstr(
       text, newline_separator, base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+  // Most lines of a listing are entries.
+  entries->reserve(lines.size());
 
+  // The parsers only read |lines|, so bind it by reference; a large listing
+  // would otherwise be copied for every parser.
   struct {
     base::Callback<bool(void)> callback;
     FtpServerType server_type;
   } parsers[] = {
     {
-      base::Bind(&ParseFtpDirectoryListingLs, lines, current_time, entries),
+      base::Bind(&ParseFtpDirectoryListingLs, base::ConstRef(lines),
+                 current_time, entries),
       SERVER_LS
     },
     {
-      base::Bind(&ParseFtpDirectoryListingWindows, lines, entries),
+      base::Bind(&ParseFtpDirectoryListingWindows, base::ConstRef(lines),
+                 entries),
       SERVER_WINDOWS
     },
     {
-      base::Bind(&ParseFtpDirectoryListingVms, lines, entries),
+      base::Bind(&ParseFtpDirectoryListingVms, base::ConstRef(lines),
+                 entries),
       SERVER_VMS
     },
   };
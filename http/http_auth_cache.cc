@@ -88,7 +88,7 @@ HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
     ++entries_examined;
     if (it->origin() == origin && it->realm() == realm &&
         it->scheme() == scheme) {
-      it->last_use_time_ = base::TimeTicks::Now();
+      MarkUsed(it);
       RecordLookupPosition(entries_examined);
       return &(*it);
     }
@@ -102,7 +102,7 @@ HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
 // kept small because AddPath() only keeps the shallowest entry.
 HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
                                                   const std::string& path) {
-  HttpAuthCache::Entry* best_match = NULL;
+  EntryList::iterator best_match = entries_.end();
   size_t best_match_length = 0;
   int best_match_position = 0;
   CheckOriginIsValid(origin);
@@ -120,16 +120,17 @@ HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
     ++entries_examined;
     size_t len = 0;
     if (it->origin() == origin && it->HasEnclosingPath(parent_dir, &len) &&
-        (!best_match || len > best_match_length)) {
-      best_match = &(*it);
+        (best_match == entries_.end() || len > best_match_length)) {
+      best_match = it;
       best_match_length = len;
       best_match_position = entries_examined;
     }
   }
-  if (best_match)
-    best_match->last_use_time_ = base::TimeTicks::Now();
   RecordLookupByPathPosition(best_match_position);
-  return best_match;
+  if (best_match == entries_.end())
+    return NULL;
+  MarkUsed(best_match);
+  return &(*best_match);
 }
 
 HttpAuthCache::Entry* HttpAuthCache::Add(const GURL& origin,
@@ -265,7 +266,6 @@ bool HttpAuthCache::UpdateStaleChallenge(const GURL& origin,
   if (!entry)
     return false;
   entry->UpdateStaleChallenge(auth_challenge);
-  entry->last_use_time_ = base::TimeTicks::Now();
   return true;
 }
 
@@ -286,4 +286,9 @@ void HttpAuthCache::UpdateAllFrom(const HttpAuthCache& other) {
   }
 }
 
+void HttpAuthCache::MarkUsed(EntryList::iterator it) {
+  it->last_use_time_ = base::TimeTicks::Now();
+  entries_.splice(entries_.begin(), entries_, it);
+}
+
 }  // namespace net
@@ -110,7 +110,9 @@ class NET_EXPORT HttpAuthCache {
   // Prevent unbounded memory growth. These are safeguards for abuse; it is
   // not expected that the limits will be reached in ordinary usage.
   // This also defines the worst-case lookup times (which grow linearly
-  // with number of elements in the cache).
+  // with number of elements in the cache). Entries are kept in most recently
+  // used order, so that the entries in use are found first, and the least
+  // recently used one is evicted.
   enum { kMaxNumPathsPerRealmEntry = 10 };
   enum { kMaxNumRealmEntries = 10 };
 
@@ -118,7 +120,7 @@ class NET_EXPORT HttpAuthCache {
   ~HttpAuthCache();
 
   // Find the realm entry on server |origin| for realm |realm| and
-  // scheme |scheme|.
+  // scheme |scheme|. The lookup counts as a use of the entry.
   //   |origin| - the {scheme, host, port} of the server.
   //   |realm|  - case sensitive realm string.
   //   |scheme| - the authentication scheme (i.e. basic, negotiate).
@@ -134,6 +136,7 @@ class NET_EXPORT HttpAuthCache {
   //   |path|   - absolute path of the resource, or empty string in case of
   //              proxy auth (which does not use the concept of paths).
   //   returns  - the matched entry or NULL.
+  // The lookup counts as a use of the entry.
   Entry* LookupByPath(const GURL& origin, const std::string& path);
 
   // Add an entry on server |origin| for realm |handler->realm()| and
@@ -184,6 +187,11 @@ class NET_EXPORT HttpAuthCache {
 
  private:
   typedef std::list<Entry> EntryList;
+
+  // Marks |it| as used now, moving it to the front of |entries_|. Entry
+  // pointers remain valid.
+  void MarkUsed(EntryList::iterator it);
+
   EntryList entries_;
 };
 
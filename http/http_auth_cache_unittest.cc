@@ -621,6 +621,24 @@ TEST_F(HttpAuthCacheEvictionTest, RealmEntryEviction) {
     CheckRealmExistence(i + 3, true);
 }
 
+// Looking up an entry keeps it from being the next one evicted.
+TEST_F(HttpAuthCacheEvictionTest, RealmEntryEvictionIsLeastRecentlyUsed) {
+  for (int i = 0; i < kMaxRealms; ++i)
+    AddRealm(i);
+
+  CheckRealmExistence(0, true);
+  CheckPathExistence(1, 0, true);
+  AddRealm(kMaxRealms);
+  AddRealm(kMaxRealms + 1);
+
+  CheckRealmExistence(0, true);
+  CheckRealmExistence(1, true);
+  CheckRealmExistence(2, false);
+  CheckRealmExistence(3, false);
+  for (int i = 4; i < kMaxRealms + 2; ++i)
+    CheckRealmExistence(i, true);
+}
+
 // Add the maximum number of paths to a single realm entry. Each of these
 // paths should be retrievable. Next add 3 more paths -- since the cache is
 // full this causes FIFO eviction of the first three paths.
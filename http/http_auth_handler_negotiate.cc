@@ -7,9 +7,11 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "net/base/address_family.h"
 #include "net/base/net_errors.h"
@@ -355,10 +357,18 @@ int HttpAuthHandlerNegotiate::DoResolveCanonicalNameComplete(int rv) {
 int HttpAuthHandlerNegotiate::DoGenerateAuthToken() {
   next_state_ = STATE_GENERATE_AUTH_TOKEN_COMPLETE;
   AuthCredentials* credentials = has_credentials_ ? &credentials_ : NULL;
-  return auth_system_.GenerateAuthToken(
+  // GSSAPI and SSPI may block on requests to the KDC, on the network thread.
+  // Record how long that takes, to tell how often it stalls the thread.
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  int rv = auth_system_.GenerateAuthToken(
       credentials, spn_, channel_bindings_, auth_token_,
       base::Bind(&HttpAuthHandlerNegotiate::OnIOComplete,
                  base::Unretained(this)));
+  if (rv != ERR_IO_PENDING) {
+    UMA_HISTOGRAM_MEDIUM_TIMES("Net.HttpAuthNegotiate.GenerateAuthTokenTime",
+                               base::TimeTicks::Now() - start_time);
+  }
+  return rv;
 }
 
 int HttpAuthHandlerNegotiate::DoGenerateAuthTokenComplete(int rv) {
@@ -9,6 +9,7 @@
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/test/histogram_tester.h"
 #include "net/base/net_errors.h"
 #include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
@@ -315,6 +316,26 @@ TEST_F(HttpAuthHandlerNegotiateTest, CnameSync) {
 #endif
 }
 
+#if !defined(OS_ANDROID)
+// Tests that the time synchronous token generation blocks the thread is
+// recorded. On Android, tokens are always generated asynchronously.
+TEST_F(HttpAuthHandlerNegotiateTest, RecordsGenerateAuthTokenTime) {
+  base::HistogramTester histograms;
+  SetupMocks(AuthLibrary());
+  std::unique_ptr<HttpAuthHandlerNegotiate> auth_handler;
+  EXPECT_EQ(OK, CreateHandler(
+      false, false, true, "http://alias:500", &auth_handler));
+  ASSERT_TRUE(auth_handler.get() != NULL);
+  TestCompletionCallback callback;
+  HttpRequestInfo request_info;
+  std::string token;
+  EXPECT_EQ(OK, callback.GetResult(auth_handler->GenerateAuthToken(
+                    NULL, &request_info, callback.callback(), &token)));
+  histograms.ExpectTotalCount("Net.HttpAuthNegotiate.GenerateAuthTokenTime",
+                              1);
+}
+#endif  // !defined(OS_ANDROID)
+
 TEST_F(HttpAuthHandlerNegotiateTest, CnameAsync) {
   SetupMocks(AuthLibrary());
   std::unique_ptr<HttpAuthHandlerNegotiate> auth_handler;
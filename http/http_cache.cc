@@ -37,6 +37,7 @@
 #include "net/base/upload_data_stream.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/http_cache_lookup_manager.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_cache_transaction.h"
 #include "net/http/http_cache_writers.h"
 #include "net/http/http_network_layer.h"
@@ -54,6 +55,13 @@
 
 namespace net {
 
+namespace {
+
+// The size of the buffer a background revalidation reads the response into.
+const int kAsyncRevalidationBufferSize = 32 * 1024;
+
+}  // namespace
+
 HttpCache::DefaultBackend::DefaultBackend(CacheType type,
                                           BackendType backend_type,
                                           const base::FilePath& path,
@@ -302,6 +310,88 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
   SelfDestroy();
 }
 
+//-----------------------------------------------------------------------------
+
+// This class encapsulates a transaction that revalidates an entry, and reads
+// the response so that a new body is written to the cache.
+class HttpCache::AsyncRevalidation {
+ public:
+  AsyncRevalidation(HttpCache* cache,
+                    const std::string& key,
+                    const HttpRequestInfo& request)
+      : cache_(cache),
+        key_(key),
+        request_info_(request),
+        transaction_(new HttpCache::Transaction(IDLE, cache)),
+        weak_factory_(this) {
+    request_info_.load_flags |= LOAD_VALIDATE_CACHE;
+  }
+
+  ~AsyncRevalidation() = default;
+
+  // Starts the revalidation asynchronously, so that it is not started from
+  // within the transaction that served the stale response.
+  void StartSoon();
+
+ private:
+  void Start();
+  void OnStartComplete(int result);
+  void Read();
+  void OnReadComplete(int result);
+
+  HttpCache* const cache_;
+  const std::string key_;
+  HttpRequestInfo request_info_;
+  scoped_refptr<IOBuffer> buf_;
+
+  // |transaction_| to come after |request_info_| so that |request_info_| is not
+  // destroyed earlier.
+  std::unique_ptr<HttpCache::Transaction> transaction_;
+
+  base::WeakPtrFactory<AsyncRevalidation> weak_factory_;
+  DISALLOW_COPY_AND_ASSIGN(AsyncRevalidation);
+};
+
+void HttpCache::AsyncRevalidation::StartSoon() {
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&AsyncRevalidation::Start, weak_factory_.GetWeakPtr()));
+}
+
+void HttpCache::AsyncRevalidation::Start() {
+  int rv = transaction_->Start(
+      &request_info_,
+      base::Bind(&AsyncRevalidation::OnStartComplete, base::Unretained(this)),
+      NetLogWithSource());
+  if (rv != ERR_IO_PENDING)
+    OnStartComplete(rv);
+}
+
+void HttpCache::AsyncRevalidation::OnStartComplete(int result) {
+  if (result != OK)
+    return cache_->OnAsyncRevalidationComplete(key_);
+  buf_ = new IOBuffer(kAsyncRevalidationBufferSize);
+  Read();
+}
+
+void HttpCache::AsyncRevalidation::Read() {
+  int rv;
+  do {
+    rv = transaction_->Read(
+        buf_.get(), kAsyncRevalidationBufferSize,
+        base::Bind(&AsyncRevalidation::OnReadComplete, base::Unretained(this)));
+  } while (rv > 0);
+  if (rv != ERR_IO_PENDING)
+    OnReadComplete(rv);
+}
+
+void HttpCache::AsyncRevalidation::OnReadComplete(int result) {
+  if (result > 0)
+    return Read();
+  // Destroys |this|.
+  cache_->OnAsyncRevalidationComplete(key_);
+}
+
 //-----------------------------------------------------------------------------
 HttpCache::HttpCache(HttpNetworkSession* session,
                      std::unique_ptr<BackendFactory> backend_factory,
@@ -344,6 +434,8 @@ HttpCache::~HttpCache() {
   // could see an inconsistent object (half destroyed).
   weak_factory_.InvalidateWeakPtrs();
 
+  async_revalidations_.clear();
+
   // If we have any active entries remaining, then we need to deactivate them.
   // We may have some pending tasks to process queued transactions ,but since
   // those won't run (due to our destruction), we can simply ignore the
@@ -435,6 +527,28 @@ void HttpCache::WriteMetadata(const GURL& url,
   writer->Write(url, expected_response_time, buf, buf_len);
 }
 
+void HttpCache::StartAsyncRevalidation(const HttpRequestInfo& request) {
+  DCHECK(!request.upload_data_stream);
+  std::string key = GenerateCacheKey(&request);
+  if (async_revalidations_.count(key))
+    return;
+
+  auto revalidation = std::make_unique<AsyncRevalidation>(this, key, request);
+  revalidation->StartSoon();
+  async_revalidations_[key] = std::move(revalidation);
+}
+
+void HttpCache::OnAsyncRevalidationComplete(const std::string& key) {
+  // |key| belongs to the revalidation, so look it up before destroying that.
+  auto it = async_revalidations_.find(key);
+  DCHECK(it != async_revalidations_.end());
+  async_revalidations_.erase(it);
+}
+
+void HttpCache::EnableMemoryTier(size_t max_bytes) {
+  memory_tier_ = std::make_unique<HttpCacheMemoryTier>(max_bytes);
+}
+
 void HttpCache::CloseAllConnections() {
   HttpNetworkSession* session = GetSession();
   if (session)
@@ -583,6 +697,11 @@ std::string HttpCache::GenerateCacheKey(const HttpRequestInfo* request) {
   return url;
 }
 
+void HttpCache::InvalidateMemoryTier(const std::string& key) {
+  if (memory_tier_)
+    memory_tier_->Invalidate(key);
+}
+
 void HttpCache::DoomActiveEntry(const std::string& key) {
   auto it = active_entries_.find(key);
   if (it == active_entries_.end())
@@ -599,6 +718,7 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* trans) {
   // should not be impacted.  Dooming an entry only means that it will no
   // longer be returned by FindActiveEntry (and it will also be destroyed once
   // all consumers are finished with the entry).
+  InvalidateMemoryTier(key);
   auto it = active_entries_.find(key);
   if (it == active_entries_.end()) {
     DCHECK(trans);
@@ -622,6 +742,7 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* trans) {
 }
 
 int HttpCache::AsyncDoomEntry(const std::string& key, Transaction* trans) {
+  InvalidateMemoryTier(key);
   std::unique_ptr<WorkItem> item =
       std::make_unique<WorkItem>(WI_DOOM_ENTRY, trans, nullptr);
   PendingOp* pending_op = GetPendingOp(key);
@@ -678,9 +799,11 @@ HttpCache::ActiveEntry* HttpCache::FindActiveEntry(const std::string& key) {
 
 HttpCache::ActiveEntry* HttpCache::ActivateEntry(
     disk_cache::Entry* disk_entry) {
-  DCHECK(!FindActiveEntry(disk_entry->GetKey()));
   ActiveEntry* entry = new ActiveEntry(disk_entry);
-  active_entries_[disk_entry->GetKey()] = base::WrapUnique(entry);
+  bool inserted =
+      active_entries_.emplace(disk_entry->GetKey(), base::WrapUnique(entry))
+          .second;
+  DCHECK(inserted);
   return entry;
 }
 
@@ -713,12 +836,9 @@ void HttpCache::SlowDeactivateEntry(ActiveEntry* entry) {
 HttpCache::PendingOp* HttpCache::GetPendingOp(const std::string& key) {
   DCHECK(!FindActiveEntry(key));
 
-  auto it = pending_ops_.find(key);
-  if (it != pending_ops_.end())
-    return it->second;
-
-  PendingOp* operation = new PendingOp();
-  pending_ops_[key] = operation;
+  PendingOp*& operation = pending_ops_[key];
+  if (!operation)
+    operation = new PendingOp();
   return operation;
 }
 
@@ -778,6 +898,7 @@ int HttpCache::CreateEntry(const std::string& key, ActiveEntry** entry,
     return ERR_CACHE_RACE;
   }
 
+  InvalidateMemoryTier(key);
   std::unique_ptr<WorkItem> item =
       std::make_unique<WorkItem>(WI_CREATE_ENTRY, trans, entry);
   PendingOp* pending_op = GetPendingOp(key);
@@ -1070,27 +1191,30 @@ HttpCache::ParallelWritingPattern HttpCache::CanTransactionJoinExistingWriters(
   return PARALLEL_WRITING_JOIN;
 }
 
-void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
+bool HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
   ParallelWritingPattern writers_pattern;
   DCHECK(!entry->writers || entry->writers->CanAddWriters(&writers_pattern));
   DCHECK(!entry->done_headers_queue.empty());
 
-  Transaction* transaction = entry->done_headers_queue.front();
+  auto it = entry->done_headers_queue.begin();
+  Transaction* transaction = *it;
 
   ParallelWritingPattern parallel_writing_pattern =
       CanTransactionJoinExistingWriters(transaction);
   if (IsWritingInProgress(entry)) {
-    transaction->MaybeSetParallelWritingPatternForMetrics(
-        parallel_writing_pattern);
-    if (parallel_writing_pattern != PARALLEL_WRITING_JOIN) {
-      // TODO(shivanisha): Returning from here instead of checking the next
-      // transaction in the queue because the FIFO order is maintained
-      // throughout, until it becomes a reader or writer. May be at this point
-      // the ordering is not important but that would be optimizing a rare
-      // scenario where write mode transactions are insterspersed with read-only
-      // transactions.
-      return;
+    // Transactions which can not join the writers, for example range requests
+    // that wait for exclusive access, stay in the queue until the response is
+    // written, but do not hold up the transactions behind them which can.
+    for (; it != entry->done_headers_queue.end(); ++it) {
+      transaction = *it;
+      parallel_writing_pattern = CanTransactionJoinExistingWriters(transaction);
+      transaction->MaybeSetParallelWritingPatternForMetrics(
+          parallel_writing_pattern);
+      if (parallel_writing_pattern == PARALLEL_WRITING_JOIN)
+        break;
     }
+    if (it == entry->done_headers_queue.end())
+      return false;
     AddTransactionToWriters(entry, transaction, parallel_writing_pattern);
   } else {  // no writing in progress
     if (transaction->mode() & Transaction::WRITE) {
@@ -1116,8 +1240,9 @@ void HttpCache::ProcessDoneHeadersQueue(ActiveEntry* entry) {
   // readers or another transaction to start parallel validation.
   ProcessQueuedTransactions(entry);
 
-  entry->done_headers_queue.erase(entry->done_headers_queue.begin());
+  entry->done_headers_queue.erase(it);
   transaction->io_callback().Run(OK);
+  return true;
 }
 
 void HttpCache::AddTransactionToWriters(
@@ -1281,8 +1406,7 @@ void HttpCache::OnProcessQueuedTransactions(ActiveEntry* entry) {
               reason);
         }
       }
-    } else {
-      ProcessDoneHeadersQueue(entry);
+    } else if (ProcessDoneHeadersQueue(entry)) {
       return;
     }
   }
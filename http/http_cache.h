@@ -15,7 +15,6 @@
 #define NET_HTTP_HTTP_CACHE_H_
 
 #include <list>
-#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -49,6 +48,7 @@ class Entry;
 
 namespace net {
 
+class HttpCacheMemoryTier;
 class HttpNetworkSession;
 class HttpResponseInfo;
 class IOBuffer;
@@ -193,6 +193,11 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
                      IOBuffer* buf,
                      int buf_len);
 
+  // Keeps the response info and body of small, frequently read entries in
+  // memory, up to |max_bytes| in total, so that hits on them do not read from
+  // the disk cache.
+  void EnableMemoryTier(size_t max_bytes);
+
   // Get/Set the cache's mode.
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
@@ -264,6 +269,7 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
     kNumCacheEntryDataIndices
   };
 
+  class AsyncRevalidation;
   class MetadataWriter;
   class QuicServerInfoFactoryAdaptor;
   class Transaction;
@@ -351,7 +357,8 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   using ActiveEntriesMap =
       std::unordered_map<std::string, std::unique_ptr<ActiveEntry>>;
   using PendingOpsMap = std::unordered_map<std::string, PendingOp*>;
-  using ActiveEntriesSet = std::map<ActiveEntry*, std::unique_ptr<ActiveEntry>>;
+  using ActiveEntriesSet =
+      std::unordered_map<ActiveEntry*, std::unique_ptr<ActiveEntry>>;
   using PlaybackCacheMap = std::unordered_map<std::string, int>;
 
   // Methods ------------------------------------------------------------------
@@ -371,6 +378,21 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   // Generates the cache key for this request.
   std::string GenerateCacheKey(const HttpRequestInfo*);
 
+  // Returns the in-memory tier, or null if it is not enabled.
+  HttpCacheMemoryTier* memory_tier() { return memory_tier_.get(); }
+
+  // Drops the entry for |key| from the in-memory tier, if it is enabled.
+  void InvalidateMemoryTier(const std::string& key);
+
+  // Revalidates the entry for |request| in the background, after a stale
+  // response was served from it under "stale-while-revalidate". Does nothing
+  // if a revalidation of the same entry is already in progress.
+  void StartAsyncRevalidation(const HttpRequestInfo& request);
+
+  // Invoked by the revalidation of the entry selected by |key| when it is
+  // done. Destroys the revalidation.
+  void OnAsyncRevalidationComplete(const std::string& key);
+
   // Dooms the entry selected by |key|, if it is currently in the list of active
   // entries.
   void DoomActiveEntry(const std::string& key);
@@ -512,8 +534,9 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
   // Invoked when a transaction that has already completed the response headers
   // phase can resume reading/writing the response body. It will invoke the IO
   // callback of the transaction. This is a helper function for
-  // OnProcessQueuedTransactions.
-  void ProcessDoneHeadersQueue(ActiveEntry* entry);
+  // OnProcessQueuedTransactions.  Returns false, without invoking any callback,
+  // if writing is in progress and no transaction in the queue can join it.
+  bool ProcessDoneHeadersQueue(ActiveEntry* entry);
 
   // Adds a transaction to writers.
   void AddTransactionToWriters(ActiveEntry* entry,
@@ -594,6 +617,12 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory {
 
   std::unique_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  std::unique_ptr<HttpCacheMemoryTier> memory_tier_;
+
+  // The background revalidations in progress, indexed by cache key.
+  std::unordered_map<std::string, std::unique_ptr<AsyncRevalidation>>
+      async_revalidations_;
+
   // A clock that can be swapped out for testing.
   base::Clock* clock_;
 
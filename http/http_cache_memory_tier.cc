@@ -0,0 +1,169 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_memory_tier.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace net {
+
+namespace {
+
+// The number of rows of the count-min sketch.
+const size_t kSketchDepth = 4;
+
+// Counters saturate at this value, as with the 4 bit counters of TinyLFU.
+const uint8_t kMaxFrequency = 15;
+
+// The counters are halved after this many accesses per counter in a row.
+const size_t kAccessesPerCounterBeforeReset = 10;
+
+// Approximately the number of bytes per counter in a row of the sketch.
+const size_t kBytesPerCounter = 1024;
+
+const size_t kMinSketchWidth = 64;
+
+size_t ComputeSketchWidth(size_t max_bytes) {
+  // A power of two, so that indexes are computed with a mask.
+  size_t width = kMinSketchWidth;
+  while (width < max_bytes / kBytesPerCounter)
+    width *= 2;
+  return width;
+}
+
+}  // namespace
+
+HttpCacheMemoryTier::Entry::Entry() = default;
+
+HttpCacheMemoryTier::Entry::Entry(scoped_refptr<IOBufferWithSize> response_info,
+                                  scoped_refptr<IOBufferWithSize> body)
+    : response_info(std::move(response_info)), body(std::move(body)) {}
+
+HttpCacheMemoryTier::Entry::Entry(const Entry& other) = default;
+
+HttpCacheMemoryTier::Entry::~Entry() = default;
+
+size_t HttpCacheMemoryTier::Entry::size() const {
+  return response_info->size() + body->size();
+}
+
+HttpCacheMemoryTier::HttpCacheMemoryTier(size_t max_bytes)
+    : max_bytes_(max_bytes),
+      bytes_(0),
+      entries_(EntryMap::NO_AUTO_EVICT),
+      sketch_width_(ComputeSketchWidth(max_bytes)),
+      sketch_(kSketchDepth * sketch_width_, 0),
+      accesses_(0) {}
+
+HttpCacheMemoryTier::~HttpCacheMemoryTier() = default;
+
+void HttpCacheMemoryTier::RecordAccess(const std::string& key) {
+  size_t indexes[kSketchDepth];
+  GetCounterIndexes(key, indexes);
+  for (size_t i = 0; i < kSketchDepth; ++i) {
+    uint8_t& counter = sketch_[i * sketch_width_ + indexes[i]];
+    if (counter < kMaxFrequency)
+      ++counter;
+  }
+
+  if (++accesses_ < kAccessesPerCounterBeforeReset * sketch_width_)
+    return;
+  for (uint8_t& counter : sketch_)
+    counter /= 2;
+  accesses_ = 0;
+}
+
+bool HttpCacheMemoryTier::ShouldAdmit(const std::string& key,
+                                      size_t size) const {
+  if (size > max_entry_size())
+    return false;
+
+  size_t available = max_bytes_ - bytes_;
+  auto existing = entries_.Peek(key);
+  if (existing != entries_.end())
+    available += existing->second.size();
+  if (size <= available)
+    return true;
+
+  // Admit the entry only if it is more popular than every entry it would
+  // evict.
+  uint8_t frequency = Frequency(key);
+  for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+    if (it->first == key)
+      continue;
+    if (Frequency(it->first) >= frequency)
+      return false;
+    available += it->second.size();
+    if (size <= available)
+      return true;
+  }
+  NOTREACHED();
+  return false;
+}
+
+void HttpCacheMemoryTier::Put(const std::string& key,
+                              scoped_refptr<IOBufferWithSize> response_info,
+                              scoped_refptr<IOBufferWithSize> body) {
+  Entry entry(std::move(response_info), std::move(body));
+  if (!ShouldAdmit(key, entry.size())) {
+    Invalidate(key);
+    return;
+  }
+
+  Invalidate(key);
+  while (bytes_ + entry.size() > max_bytes_)
+    Erase(std::prev(entries_.end()));
+  bytes_ += entry.size();
+  entries_.Put(key, std::move(entry));
+}
+
+bool HttpCacheMemoryTier::Get(const std::string& key,
+                              scoped_refptr<IOBufferWithSize>* response_info,
+                              scoped_refptr<IOBufferWithSize>* body) {
+  auto it = entries_.Get(key);
+  if (it == entries_.end())
+    return false;
+  *response_info = it->second.response_info;
+  *body = it->second.body;
+  return true;
+}
+
+void HttpCacheMemoryTier::Invalidate(const std::string& key) {
+  auto it = entries_.Peek(key);
+  if (it != entries_.end())
+    Erase(it);
+}
+
+uint8_t HttpCacheMemoryTier::Frequency(const std::string& key) const {
+  size_t indexes[kSketchDepth];
+  GetCounterIndexes(key, indexes);
+  uint8_t frequency = kMaxFrequency;
+  for (size_t i = 0; i < kSketchDepth; ++i)
+    frequency = std::min(frequency, sketch_[i * sketch_width_ + indexes[i]]);
+  return frequency;
+}
+
+void HttpCacheMemoryTier::GetCounterIndexes(const std::string& key,
+                                            size_t* indexes) const {
+  // Derives the index of each row from two halves of one hash.
+  uint64_t hash = static_cast<uint64_t>(std::hash<std::string>()(key)) *
+                  UINT64_C(0x9E3779B97F4A7C15);
+  uint32_t h1 = static_cast<uint32_t>(hash);
+  uint32_t h2 = static_cast<uint32_t>(hash >> 32) | 1;
+  for (size_t i = 0; i < kSketchDepth; ++i)
+    indexes[i] = (h1 + i * h2) & (sketch_width_ - 1);
+}
+
+void HttpCacheMemoryTier::Erase(EntryMap::iterator it) {
+  DCHECK_GE(bytes_, it->second.size());
+  bytes_ -= it->second.size();
+  entries_.Erase(it);
+}
+
+}  // namespace net
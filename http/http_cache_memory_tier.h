@@ -0,0 +1,109 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
+#define NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// Keeps the serialized HttpResponseInfo and the body of small, frequently read
+// HttpCache entries in memory, so that hits on them are served without reading
+// from the disk cache entry. The tier is bounded by the number of bytes it
+// holds, and evicts the least recently used entries.
+//
+// Entries are admitted in the manner of TinyLFU: the access frequency of every
+// key is approximated by a count-min sketch, and a key which does not fit
+// without evictions is only admitted if it is accessed more often than the
+// entries which would make room for it. The counters are periodically halved,
+// so that the frequencies follow recent accesses.
+//
+// The tier does not observe the disk cache, its owner has to Invalidate() a
+// key whenever the corresponding entry is written to or doomed.
+class NET_EXPORT_PRIVATE HttpCacheMemoryTier {
+ public:
+  // |max_bytes| bounds the sum of the sizes of the response infos and bodies
+  // held. A single entry may use up to one eighth of it.
+  explicit HttpCacheMemoryTier(size_t max_bytes);
+  ~HttpCacheMemoryTier();
+
+  // Records a read of the entry for |key|. Invoked on every cache hit, whether
+  // it is served from this tier or not.
+  void RecordAccess(const std::string& key);
+
+  // Returns true if an entry for |key| with |size| bytes of response info and
+  // body would be admitted by Put().
+  bool ShouldAdmit(const std::string& key, size_t size) const;
+
+  // Stores |response_info| and |body| for |key|, replacing any previous entry,
+  // if ShouldAdmit() allows it. Evicts least recently used entries to make
+  // room.
+  void Put(const std::string& key,
+           scoped_refptr<IOBufferWithSize> response_info,
+           scoped_refptr<IOBufferWithSize> body);
+
+  // Returns true and sets |response_info| and |body| if there is an entry for
+  // |key|, which then becomes the most recently used.
+  bool Get(const std::string& key,
+           scoped_refptr<IOBufferWithSize>* response_info,
+           scoped_refptr<IOBufferWithSize>* body);
+
+  // Drops the entry for |key|, if any.
+  void Invalidate(const std::string& key);
+
+  size_t max_entry_size() const { return max_bytes_ / 8; }
+  size_t bytes() const { return bytes_; }
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    Entry();
+    Entry(scoped_refptr<IOBufferWithSize> response_info,
+          scoped_refptr<IOBufferWithSize> body);
+    Entry(const Entry& other);
+    ~Entry();
+
+    size_t size() const;
+
+    scoped_refptr<IOBufferWithSize> response_info;
+    scoped_refptr<IOBufferWithSize> body;
+  };
+
+  using EntryMap = base::MRUCache<std::string, Entry>;
+
+  // Returns the estimated number of accesses of |key|.
+  uint8_t Frequency(const std::string& key) const;
+
+  // Returns the index of the counter of |key| in each row of the sketch.
+  void GetCounterIndexes(const std::string& key, size_t* indexes) const;
+
+  void Erase(EntryMap::iterator it);
+
+  const size_t max_bytes_;
+  size_t bytes_;
+  EntryMap entries_;
+
+  // The count-min sketch, |kSketchDepth| rows of |sketch_width_| counters.
+  const size_t sketch_width_;
+  std::vector<uint8_t> sketch_;
+  // Accesses recorded since the counters were last halved.
+  size_t accesses_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheMemoryTier);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
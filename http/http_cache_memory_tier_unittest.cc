@@ -0,0 +1,92 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_memory_tier.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+scoped_refptr<IOBufferWithSize> MakeBuffer(size_t size) {
+  return base::MakeRefCounted<IOBufferWithSize>(size);
+}
+
+void RecordAccesses(HttpCacheMemoryTier* tier,
+                    const std::string& key,
+                    int count) {
+  for (int i = 0; i < count; ++i)
+    tier->RecordAccess(key);
+}
+
+TEST(HttpCacheMemoryTierTest, PutGetInvalidate) {
+  HttpCacheMemoryTier tier(8000);
+  tier.Put("a", MakeBuffer(100), MakeBuffer(200));
+  EXPECT_EQ(300u, tier.bytes());
+
+  scoped_refptr<IOBufferWithSize> response_info;
+  scoped_refptr<IOBufferWithSize> body;
+  ASSERT_TRUE(tier.Get("a", &response_info, &body));
+  EXPECT_EQ(100, response_info->size());
+  EXPECT_EQ(200, body->size());
+  EXPECT_FALSE(tier.Get("b", &response_info, &body));
+
+  // A new entry for the same key replaces the old one.
+  tier.Put("a", MakeBuffer(100), MakeBuffer(400));
+  EXPECT_EQ(1u, tier.size());
+  EXPECT_EQ(500u, tier.bytes());
+
+  tier.Invalidate("a");
+  EXPECT_FALSE(tier.Get("a", &response_info, &body));
+  EXPECT_EQ(0u, tier.bytes());
+}
+
+TEST(HttpCacheMemoryTierTest, RejectsLargeEntries) {
+  HttpCacheMemoryTier tier(8000);
+  EXPECT_EQ(1000u, tier.max_entry_size());
+  EXPECT_TRUE(tier.ShouldAdmit("a", 1000));
+  EXPECT_FALSE(tier.ShouldAdmit("a", 1001));
+
+  tier.Put("a", MakeBuffer(1), MakeBuffer(1000));
+  EXPECT_EQ(0u, tier.size());
+}
+
+// Tests that once the tier is full, an entry is only admitted if it is read
+// more often than the entries it would evict.
+TEST(HttpCacheMemoryTierTest, FrequencyBasedAdmission) {
+  HttpCacheMemoryTier tier(8000);
+  for (int i = 0; i < 8; ++i) {
+    std::string key = "old" + std::to_string(i);
+    RecordAccesses(&tier, key, 2);
+    tier.Put(key, MakeBuffer(500), MakeBuffer(500));
+  }
+  EXPECT_EQ(8000u, tier.bytes());
+
+  // A key read as often as the least recently used entry is not admitted.
+  RecordAccesses(&tier, "new", 2);
+  EXPECT_FALSE(tier.ShouldAdmit("new", 1000));
+  tier.Put("new", MakeBuffer(500), MakeBuffer(500));
+  EXPECT_EQ(8u, tier.size());
+
+  scoped_refptr<IOBufferWithSize> response_info;
+  scoped_refptr<IOBufferWithSize> body;
+  EXPECT_FALSE(tier.Get("new", &response_info, &body));
+
+  // A more popular key evicts the least recently used entry.
+  RecordAccesses(&tier, "new", 1);
+  EXPECT_TRUE(tier.ShouldAdmit("new", 1000));
+  tier.Put("new", MakeBuffer(500), MakeBuffer(500));
+  EXPECT_EQ(8u, tier.size());
+  EXPECT_EQ(8000u, tier.bytes());
+  EXPECT_TRUE(tier.Get("new", &response_info, &body));
+  EXPECT_FALSE(tier.Get("old0", &response_info, &body));
+  EXPECT_TRUE(tier.Get("old1", &response_info, &body));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -35,6 +35,7 @@
 #include "net/cert/cert_status_flags.h"
 #include "net/cert/x509_certificate.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_cache_writers.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_info.h"
@@ -42,6 +43,7 @@
 #include "net/log/net_log_event_type.h"
 #include "net/ssl/ssl_cert_request_info.h"
 #include "net/ssl/ssl_config_service.h"
+#include "net/ssl/ssl_info.h"
 
 using base::Time;
 using base::TimeDelta;
@@ -61,6 +63,60 @@ bool NonErrorResponse(int status_code) {
   return status_code_range == 2 || status_code_range == 3;
 }
 
+// A 304 that leaves the cached headers as they were does not need to be
+// written back if the entry was written this recently, since only how fresh
+// the entry is would change, by at most this much.
+const int kUpdatedResponseWriteWindowSecs = 60;
+
+// Returns the next header of |headers| which says more than when the response
+// was generated.
+bool EnumerateHeaderLinesIgnoringTimes(const HttpResponseHeaders& headers,
+                                       size_t* iter,
+                                       std::string* name,
+                                       std::string* value) {
+  while (headers.EnumerateHeaderLines(iter, name, value)) {
+    if (!base::LowerCaseEqualsASCII(*name, "date") &&
+        !base::LowerCaseEqualsASCII(*name, "age")) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if |a| and |b| have the same status line and headers, except
+// for the Date and Age headers.
+bool HeadersMatchIgnoringTimes(const HttpResponseHeaders& a,
+                               const HttpResponseHeaders& b) {
+  if (a.GetStatusLine() != b.GetStatusLine())
+    return false;
+
+  size_t iter_a = 0;
+  size_t iter_b = 0;
+  std::string name_a, value_a, name_b, value_b;
+  while (true) {
+    bool has_a = EnumerateHeaderLinesIgnoringTimes(a, &iter_a, &name_a,
+                                                   &value_a);
+    bool has_b = EnumerateHeaderLinesIgnoringTimes(b, &iter_b, &name_b,
+                                                   &value_b);
+    if (has_a != has_b)
+      return false;
+    if (!has_a)
+      return true;
+    if (!base::EqualsCaseInsensitiveASCII(name_a, name_b) ||
+        value_a != value_b) {
+      return false;
+    }
+  }
+}
+
+bool SameCertificates(const SSLInfo& a, const SSLInfo& b) {
+  if (a.cert_status != b.cert_status)
+    return false;
+  if (!a.cert || !b.cert)
+    return !a.cert && !b.cert;
+  return a.cert->Equals(b.cert.get());
+}
+
 void RecordNoStoreHeaderHistogram(int load_flags,
                                   const HttpResponseInfo* response) {
   if (load_flags & LOAD_MAIN_FRAME_DEPRECATED) {
@@ -167,6 +223,7 @@ HttpCache::Transaction::Transaction(RequestPriority priority, HttpCache* cache)
       cache_pending_(false),
       done_headers_create_new_entry_(false),
       vary_mismatch_(false),
+      async_revalidation_requested_(false),
       couldnt_conditionalize_request_(false),
       bypass_lock_for_test_(false),
       bypass_lock_after_headers_for_test_(false),
@@ -1418,6 +1475,26 @@ int HttpCache::Transaction::DoCacheReadResponse() {
   read_buf_ = new IOBuffer(io_buf_len_);
 
   net_log_.BeginEvent(NetLogEventType::HTTP_CACHE_READ_INFO);
+
+  HttpCacheMemoryTier* memory_tier = cache_->memory_tier();
+  if (memory_tier && !cache_->IsWritingInProgress(entry_)) {
+    memory_tier->RecordAccess(cache_key_);
+    scoped_refptr<IOBufferWithSize> response_info;
+    scoped_refptr<IOBufferWithSize> body;
+    // The sizes are checked in case the entry changed without going through
+    // this cache.
+    if (memory_tier->Get(cache_key_, &response_info, &body) &&
+        response_info->size() == io_buf_len_ &&
+        body->size() ==
+            entry_->disk_entry->GetDataSize(kResponseContentIndex)) {
+      memcpy(read_buf_->data(), response_info->data(), io_buf_len_);
+      memory_tier_body_ = std::move(body);
+      return io_buf_len_;
+    }
+    memory_tier_response_info_ = new IOBufferWithSize(io_buf_len_);
+    read_buf_ = memory_tier_response_info_;
+  }
+
   return entry_->disk_entry->ReadData(kResponseInfoIndex, 0, read_buf_.get(),
                                       io_buf_len_, io_callback_);
 }
@@ -1768,6 +1845,25 @@ int HttpCache::Transaction::DoSuccessfulSendRequest() {
 int HttpCache::Transaction::DoUpdateCachedResponse() {
   TRACE_EVENT0("io", "HttpCacheTransaction::DoUpdateCachedResponse");
   int rv = OK;
+
+  // Skip writing the updated response back to the entry if the 304 only
+  // changed its times, and the stored times are good enough: the entry is
+  // validated before every use anyway, or it was written moments ago.
+  bool skip_write =
+      !handling_206_ && !partial_ && !truncated_ &&
+      !new_response_->vary_data.is_valid() &&
+      !response_.vary_data.is_valid() &&
+      response_.unused_since_prefetch ==
+          new_response_->unused_since_prefetch &&
+      SameCertificates(response_.ssl_info, new_response_->ssl_info);
+  // Only keep a copy of the old headers when the write might be skipped.
+  scoped_refptr<HttpResponseHeaders> old_headers;
+  if (skip_write) {
+    old_headers = base::MakeRefCounted<HttpResponseHeaders>(
+        response_.headers->raw_headers());
+  }
+  base::Time old_response_time = response_.response_time;
+
   // Update the cached response based on the headers and properties of
   // new_response_.
   response_.headers->Update(*new_response_->headers.get());
@@ -1793,9 +1889,21 @@ int HttpCache::Transaction::DoUpdateCachedResponse() {
     }
     TransitionToState(STATE_UPDATE_CACHED_RESPONSE_COMPLETE);
   } else {
+    if (skip_write &&
+        HeadersMatchIgnoringTimes(*old_headers, *response_.headers)) {
+      HttpResponseHeaders::FreshnessLifetimes lifetimes =
+          response_.headers->GetFreshnessLifetimes(response_.response_time);
+      skip_write =
+          (lifetimes.freshness.is_zero() && lifetimes.staleness.is_zero()) ||
+          response_.response_time - old_response_time <
+              TimeDelta::FromSeconds(kUpdatedResponseWriteWindowSecs);
+    } else {
+      skip_write = false;
+    }
+
     // If we are already reading, we already updated the headers for this
     // request; doing it again will change Content-Length.
-    if (!reading_) {
+    if (!reading_ && !skip_write) {
       TransitionToState(STATE_CACHE_WRITE_UPDATED_RESPONSE);
       rv = OK;
     } else {
@@ -2211,6 +2319,20 @@ int HttpCache::Transaction::DoCacheReadData() {
                                io_callback_);
   }
 
+  if (memory_tier_body_) {
+    int rv = std::min(io_buf_len_, memory_tier_body_->size() - read_offset_);
+    memcpy(read_buf_->data(), memory_tier_body_->data() + read_offset_, rv);
+    return rv;
+  }
+
+  if (read_offset_ == 0 && memory_tier_response_info_ && !truncated_) {
+    int body_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
+    if (cache_->memory_tier()->ShouldAdmit(
+            cache_key_, memory_tier_response_info_->size() + body_size)) {
+      memory_tier_capture_ = new IOBufferWithSize(body_size);
+    }
+  }
+
   return entry_->disk_entry->ReadData(kResponseContentIndex, read_offset_,
                                       read_buf_.get(), io_buf_len_,
                                       io_callback_);
@@ -2236,8 +2358,23 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   }
 
   if (result > 0) {
+    if (memory_tier_capture_) {
+      if (read_offset_ + result <= memory_tier_capture_->size()) {
+        memcpy(memory_tier_capture_->data() + read_offset_, read_buf_->data(),
+               result);
+      } else {
+        memory_tier_capture_ = nullptr;
+      }
+    }
     read_offset_ += result;
   } else if (result == 0) {  // End of file.
+    if (memory_tier_capture_ && cache_->memory_tier() &&
+        read_offset_ == memory_tier_capture_->size()) {
+      cache_->memory_tier()->Put(cache_key_,
+                                 std::move(memory_tier_response_info_),
+                                 std::move(memory_tier_capture_));
+    }
+    memory_tier_capture_ = nullptr;
     DoneWithEntry(true);
   } else {
     return OnCacheReadError(result, false);
@@ -2452,6 +2589,8 @@ int HttpCache::Transaction::BeginCacheValidation() {
 
   if (skip_validation) {
     UpdateCacheEntryStatus(CacheEntryStatus::ENTRY_USED);
+    if (async_revalidation_requested_)
+      cache_->StartAsyncRevalidation(*request_);
     return SetupEntryForRead();
   } else {
     // Make the network request conditional, to see if we may reuse our cached
@@ -2628,14 +2767,25 @@ bool HttpCache::Transaction::RequiresValidation() {
   if (validation_required_by_headers) {
     HttpResponseHeaders::FreshnessLifetimes lifetimes =
         response_.headers->GetFreshnessLifetimes(response_.response_time);
+    TimeDelta age = response_.headers->GetCurrentAge(
+        response_.request_time, response_.response_time,
+        cache_->clock_->Now());
+
+    // Within its stale-while-revalidate window, the entry is served as is and
+    // the cache revalidates it in the background. This transaction does not
+    // validate it, so no validation cause is recorded.
+    if (mode_ == READ_WRITE && method_ == "GET" && !partial_ &&
+        age < lifetimes.freshness + lifetimes.staleness) {
+      async_revalidation_requested_ = true;
+      return false;
+    }
+
     if (lifetimes.freshness == base::TimeDelta()) {
       validation_cause_ = VALIDATION_CAUSE_ZERO_FRESHNESS;
     } else {
       validation_cause_ = VALIDATION_CAUSE_STALE;
       stale_entry_freshness_ = lifetimes.freshness;
-      stale_entry_age_ = response_.headers->GetCurrentAge(
-          response_.request_time, response_.response_time,
-          cache_->clock_->Now());
+      stale_entry_age_ = age;
     }
   }
 
@@ -2946,6 +3096,8 @@ int HttpCache::Transaction::WriteToEntry(int index, int offset,
   if (!entry_)
     return data_len;
 
+  cache_->InvalidateMemoryTier(cache_key_);
+
   int rv = 0;
   if (!partial_ || !data_len) {
     rv = entry_->disk_entry->WriteData(index, offset, data, data_len, callback,
@@ -2960,6 +3112,9 @@ int HttpCache::Transaction::WriteResponseInfoToEntry(bool truncated) {
   if (!entry_)
     return OK;
 
+  cache_->InvalidateMemoryTier(cache_key_);
+  memory_tier_capture_ = nullptr;
+
   if (net_log_.IsCapturing())
     net_log_.BeginEvent(NetLogEventType::HTTP_CACHE_WRITE_INFO);
 
@@ -599,6 +599,8 @@ class NET_EXPORT_PRIVATE HttpCache::Transaction : public HttpTransaction {
   bool done_headers_create_new_entry_;
 
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
+  // The stale entry is served and revalidated in the background.
+  bool async_revalidation_requested_;
   bool couldnt_conditionalize_request_;
   bool bypass_lock_for_test_;  // A test is exercising the cache lock.
   bool bypass_lock_after_headers_for_test_;  // A test is exercising the cache
@@ -609,6 +611,13 @@ class NET_EXPORT_PRIVATE HttpCache::Transaction : public HttpTransaction {
   int read_offset_;
   int effective_load_flags_;
   std::unique_ptr<PartialData> partial_;  // We are dealing with range requests.
+
+  // With the in-memory tier of the cache, the serialized response info read
+  // from the entry, the body the entry is being served from, and the body
+  // copied while the entry is read, to be admitted to the tier.
+  scoped_refptr<IOBufferWithSize> memory_tier_response_info_;
+  scoped_refptr<IOBufferWithSize> memory_tier_body_;
+  scoped_refptr<IOBufferWithSize> memory_tier_capture_;
   CompletionCallback io_callback_;
 
   // Error code to be returned from a subsequent Read call if shared writing
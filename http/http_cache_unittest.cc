@@ -795,6 +795,29 @@ TEST(HttpCache, ReleaseBuffer) {
   EXPECT_EQ(kBufferSize, cb.GetResult(rv));
 }
 
+// Tests that the in-memory tier serves hits on an entry without reading the
+// disk cache entry.
+TEST(HttpCache, SimpleGET_MemoryTier) {
+  MockHttpCache cache;
+  cache.http_cache()->EnableMemoryTier(1024 * 1024);
+
+  // Write to the cache, then read the entry from disk.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->open_count());
+
+  // Reads of the opened entry fail from now on, but the response is served
+  // from memory.
+  cache.disk_cache()->set_soft_failures(true);
+  HttpResponseInfo response_info;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), kSimpleGET_Transaction,
+                                     &response_info);
+  EXPECT_TRUE(response_info.was_cached);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+}
+
 TEST(HttpCache, SimpleGETWithDiskFailures) {
   MockHttpCache cache;
 
@@ -2960,6 +2983,64 @@ TEST(HttpCache, SimpleGET_ParallelWritingSuccess) {
       static_cast<int>(HttpCache::PARALLEL_WRITING_NOT_JOIN_READ_ONLY), 1);
 }
 
+// Tests that a transaction which can not join the writers does not keep the
+// transactions queued behind it from joining them.
+TEST(HttpCache, SimpleGET_ParallelWritingSkipsQueuedTransaction) {
+  base::HistogramTester histograms;
+  const std::string histogram_name = "HttpCache.ParallelWritingPattern";
+  MockHttpCache cache;
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.load_flags |= LOAD_ONLY_FROM_CACHE;
+  MockHttpRequest read_request(transaction);
+
+  const int kNumTransactions = 4;
+  std::vector<std::unique_ptr<Context>> context_list;
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(std::make_unique<Context>());
+    auto& c = context_list[i];
+
+    c->result = cache.CreateTransaction(&c->trans);
+    ASSERT_THAT(c->result, IsOk());
+
+    MockHttpRequest* this_request = &request;
+    if (i == 1)
+      this_request = &read_request;
+
+    c->result = c->trans->Start(this_request, c->callback.callback(),
+                                NetLogWithSource());
+  }
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // The read-only transaction waits for the response to be written, while the
+  // transactions behind it join the writer.
+  EXPECT_EQ(3, cache.GetCountWriterTransactions(kSimpleGET_Transaction.url));
+  EXPECT_EQ(1, cache.GetCountDoneHeadersQueue(kSimpleGET_Transaction.url));
+
+  for (int i = 0; i < kNumTransactions; i++) {
+    auto& c = context_list[i];
+    if (c->result == ERR_IO_PENDING)
+      c->result = c->callback.WaitForResult();
+    ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
+  }
+
+  histograms.ExpectBucketCount(
+      histogram_name, static_cast<int>(HttpCache::PARALLEL_WRITING_CREATE), 1);
+  histograms.ExpectBucketCount(
+      histogram_name, static_cast<int>(HttpCache::PARALLEL_WRITING_JOIN), 2);
+  histograms.ExpectBucketCount(
+      histogram_name,
+      static_cast<int>(HttpCache::PARALLEL_WRITING_NOT_JOIN_READ_ONLY), 1);
+}
+
 // Tests that network transaction's info is saved correctly when a writer
 // transaction that created the network transaction becomes a reader. Also
 // verifies that the network bytes are only attributed to the transaction that
@@ -4183,6 +4264,87 @@ TEST(HttpCache, GET_ValidateCache_VaryMatch) {
   RemoveMockTransaction(&transaction);
 }
 
+// Tests that a stale entry within its stale-while-revalidate window is served
+// without waiting for the network, and is revalidated in the background.
+TEST(HttpCache, GET_StaleWhileRevalidate) {
+  MockHttpCache cache;
+
+  // Write to the cache.
+  MockTransaction transaction(kTypicalGET_Transaction);
+  transaction.response_headers =
+      "Last-Modified: Wed, 28 Nov 2007 00:40:09 GMT\n"
+      "Etag: \"foopy\"\n"
+      "Cache-Control: max-age=0, stale-while-revalidate=86400\n";
+  AddMockTransaction(&transaction);
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  // Read the stale response from the cache.
+  RevalidationServer server;
+  transaction.handler = server.Handler;
+  HttpResponseInfo response_info;
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response_info);
+  EXPECT_TRUE(response_info.was_cached);
+
+  // The entry is revalidated once the transaction that read it is done.
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(server.EtagUsed());
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  // The 304 made the entry fresh.
+  RunTransactionTestWithResponseInfo(cache.http_cache(), transaction,
+                                     &response_info);
+  EXPECT_TRUE(response_info.was_cached);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  RemoveMockTransaction(&transaction);
+}
+
+// Tests that concurrent reads of a stale entry revalidate it only once.
+TEST(HttpCache, GET_StaleWhileRevalidateOnce) {
+  MockHttpCache cache;
+
+  MockTransaction transaction(kTypicalGET_Transaction);
+  transaction.response_headers =
+      "Last-Modified: Wed, 28 Nov 2007 00:40:09 GMT\n"
+      "Etag: \"foopy\"\n"
+      "Cache-Control: max-age=0, stale-while-revalidate=86400\n";
+  AddMockTransaction(&transaction);
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  RevalidationServer server;
+  transaction.handler = server.Handler;
+  MockHttpRequest request(transaction);
+
+  const int kNumTransactions = 2;
+  std::vector<std::unique_ptr<Context>> context_list;
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(std::make_unique<Context>());
+    auto& c = context_list[i];
+
+    c->result = cache.CreateTransaction(&c->trans);
+    ASSERT_THAT(c->result, IsOk());
+
+    c->result =
+        c->trans->Start(&request, c->callback.callback(), NetLogWithSource());
+  }
+
+  for (auto& c : context_list) {
+    if (c->result == ERR_IO_PENDING)
+      c->result = c->callback.WaitForResult();
+    ASSERT_THAT(c->result, IsOk());
+    EXPECT_TRUE(c->trans->GetResponseInfo()->was_cached);
+    ReadAndVerifyTransaction(c->trans.get(), transaction);
+  }
+  context_list.clear();
+
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(server.EtagUsed());
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  RemoveMockTransaction(&transaction);
+}
+
 // Tests revalidation after a vary mismatch if etag is present.
 TEST(HttpCache, GET_ValidateCache_VaryMismatch) {
   MockHttpCache cache;
@@ -4282,6 +4444,50 @@ TEST(HttpCache, GET_DontValidateCache_VaryMismatch) {
   RemoveMockTransaction(&transaction);
 }
 
+// Tests that a 304 which changes nothing but the times of an entry that is
+// validated on every use is not written back to the entry.
+TEST(HttpCache, GET_ValidateCache_UnchangedHeadersNotWritten) {
+  MockHttpCache cache;
+
+  // Write to the cache.
+  ScopedMockTransaction transaction(kTypicalGET_Transaction);
+  transaction.response_headers =
+      "Etag: \"foopy\"\n"
+      "Cache-Control: no-cache\n";
+  RunTransactionTest(cache.http_cache(), transaction);
+
+  disk_cache::Entry* entry;
+  HttpResponseInfo response;
+  bool truncated;
+  ASSERT_TRUE(cache.OpenBackendEntry(transaction.url, &entry));
+  EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  entry->Close();
+  base::Time response_time = response.response_time;
+
+  // Validate the entry, and receive the same headers.
+  transaction.status = "HTTP/1.1 304 Not Modified";
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+
+  ASSERT_TRUE(cache.OpenBackendEntry(transaction.url, &entry));
+  EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  entry->Close();
+  EXPECT_EQ(response_time, response.response_time);
+
+  // A new header is written to the entry.
+  transaction.response_headers =
+      "Etag: \"foopy\"\n"
+      "Cache-Control: no-cache\n"
+      "Foo: bar\n";
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
+
+  ASSERT_TRUE(cache.OpenBackendEntry(transaction.url, &entry));
+  EXPECT_TRUE(MockHttpCache::ReadResponseInfo(entry, &response, &truncated));
+  entry->Close();
+  EXPECT_TRUE(response.headers->HasHeaderValue("Foo", "bar"));
+}
+
 // Tests that a new vary header provided when revalidating an entry is saved.
 TEST(HttpCache, GET_ValidateCache_VaryMatch_UpdateVary) {
   MockHttpCache cache;
@@ -44,6 +44,8 @@
 
 #include "net/http/http_chunked_decoder.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/logging.h"
@@ -69,6 +71,9 @@ HttpChunkedDecoder::HttpChunkedDecoder()
 int HttpChunkedDecoder::FilterBuf(char* buf, int buf_len) {
   int result = 0;
 
+  // Chunk data is moved down over the chunk headers which preceded it, from
+  // |read_pos| to |buf| + |result|, so that each byte is moved at most once.
+  const char* read_pos = buf;
   while (buf_len > 0) {
     if (chunk_remaining_ > 0) {
       // Since |chunk_remaining_| is positive and |buf_len| an int, the minimum
@@ -76,28 +81,33 @@ int HttpChunkedDecoder::FilterBuf(char* buf, int buf_len) {
       int num = static_cast<int>(
           std::min(chunk_remaining_, static_cast<int64_t>(buf_len)));
 
+      if (read_pos != buf + result)
+        memmove(buf + result, read_pos, num);
+
       buf_len -= num;
       chunk_remaining_ -= num;
 
       result += num;
-      buf += num;
+      read_pos += num;
 
       // After each chunk's data there should be a CRLF.
       if (chunk_remaining_ == 0)
         chunk_terminator_remaining_ = true;
       continue;
     } else if (reached_eof_) {
+      // Callers expect the bytes after the final CRLF right after the data.
+      if (read_pos != buf + result)
+        memmove(buf + result, read_pos, buf_len);
       bytes_after_eof_ += buf_len;
       break;  // Done!
     }
 
-    int bytes_consumed = ScanForChunkRemaining(buf, buf_len);
+    int bytes_consumed = ScanForChunkRemaining(read_pos, buf_len);
     if (bytes_consumed < 0)
       return bytes_consumed; // Error
 
     buf_len -= bytes_consumed;
-    if (buf_len > 0)
-      memmove(buf, buf + bytes_consumed, buf_len);
+    read_pos += bytes_consumed;
   }
 
   return result;
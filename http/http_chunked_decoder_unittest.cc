@@ -369,6 +369,18 @@ TEST(HttpChunkedDecoderTest, BasicExtraData) {
   RunTest(inputs, arraysize(inputs), "hello", true, 11);
 }
 
+// The bytes after the final CRLF are moved to follow the decoded data, where
+// HttpStreamParser expects them.
+TEST(HttpChunkedDecoderTest, ExtraDataFollowsData) {
+  std::string input = "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\nextra";
+  HttpChunkedDecoder decoder;
+  int result = decoder.FilterBuf(&input[0], static_cast<int>(input.size()));
+  ASSERT_EQ(5, result);
+  EXPECT_TRUE(decoder.reached_eof());
+  ASSERT_EQ(5, decoder.bytes_after_eof());
+  EXPECT_EQ("abcdeextra", input.substr(0, result + decoder.bytes_after_eof()));
+}
+
 TEST(HttpChunkedDecoderTest, IncrementalExtraData) {
   const char* const inputs[] = {
     "5",
@@ -120,17 +120,20 @@ HttpNetworkSession::Params::Params()
           kMaxTimeForCryptoHandshakeSecs),
       quic_max_idle_time_before_crypto_handshake_seconds(
           kInitialIdleTimeoutSecs),
+      quic_max_preconnected_sessions(kMaxPreconnectedSessions),
       quic_connect_using_default_network(false),
       quic_migrate_sessions_on_network_change(false),
       quic_migrate_sessions_early(false),
       quic_migrate_sessions_on_network_change_v2(false),
       quic_migrate_sessions_early_v2(false),
+      quic_prevalidate_alternate_network(false),
       quic_allow_server_migration(false),
       quic_allow_remote_alt_svc(false),
       quic_disable_bidirectional_streams(false),
       quic_force_hol_blocking(false),
       quic_race_cert_verification(false),
       quic_estimate_initial_rtt(false),
+      quic_batch_packet_writes(false),
       enable_token_binding(false),
       http_09_on_non_default_ports_enabled(false) {
   quic_supported_versions.push_back(QUIC_VERSION_39);
@@ -201,14 +204,17 @@ HttpNetworkSession::HttpNetworkSession(const Params& params,
           params.quic_reduced_ping_timeout_seconds,
           params.quic_max_time_before_crypto_handshake_seconds,
           params.quic_max_idle_time_before_crypto_handshake_seconds,
+          params.quic_max_preconnected_sessions,
           params.quic_connect_using_default_network,
           params.quic_migrate_sessions_on_network_change,
           params.quic_migrate_sessions_early,
           params.quic_migrate_sessions_on_network_change_v2,
           params.quic_migrate_sessions_early_v2,
+          params.quic_prevalidate_alternate_network,
           params.quic_allow_server_migration,
           params.quic_race_cert_verification,
           params.quic_estimate_initial_rtt,
+          params.quic_batch_packet_writes,
           params.quic_connection_options,
           params.quic_client_connection_options,
           params.enable_token_binding),
@@ -225,7 +231,8 @@ HttpNetworkSession::HttpNetworkSession(const Params& params,
                          context.proxy_delegate),
       http_stream_factory_(new HttpStreamFactoryImpl(this, false)),
       http_stream_factory_for_websocket_(new HttpStreamFactoryImpl(this, true)),
-      network_stream_throttler_(new NetworkThrottleManagerImpl()),
+      network_stream_throttler_(
+          new NetworkThrottleManagerImpl(context.network_quality_provider)),
       params_(params),
       context_(context) {
   DCHECK(proxy_service_);
@@ -233,7 +240,10 @@ HttpNetworkSession::HttpNetworkSession(const Params& params,
   CHECK(http_server_properties_);
 
   const std::string ssl_session_cache_shard =
-      "http_network_session/" + base::IntToString(g_next_shard_id.GetNext());
+      params_.ssl_session_cache_shard.empty()
+          ? "http_network_session/" +
+                base::IntToString(g_next_shard_id.GetNext())
+          : "shared/" + params_.ssl_session_cache_shard;
   normal_socket_pool_manager_ = CreateSocketPoolManager(
       NORMAL_SOCKET_POOL, context, ssl_session_cache_shard);
   websocket_socket_pool_manager_ = CreateSocketPoolManager(
@@ -341,6 +351,8 @@ std::unique_ptr<base::Value> HttpNetworkSession::QuicInfoToValue() const {
                    params_.quic_idle_connection_timeout_seconds);
   dict->SetInteger("reduced_ping_timeout_seconds",
                    params_.quic_reduced_ping_timeout_seconds);
+  dict->SetInteger("max_preconnected_sessions",
+                   params_.quic_max_preconnected_sessions);
   dict->SetBoolean("mark_quic_broken_when_network_blackholes",
                    params_.mark_quic_broken_when_network_blackholes);
   dict->SetBoolean("retry_without_alt_svc_on_quic_errors",
@@ -359,9 +371,12 @@ std::unique_ptr<base::Value> HttpNetworkSession::QuicInfoToValue() const {
                    params_.quic_migrate_sessions_on_network_change_v2);
   dict->SetBoolean("migrate_sessions_early_v2",
                    params_.quic_migrate_sessions_early_v2);
+  dict->SetBoolean("prevalidate_alternate_network",
+                   params_.quic_prevalidate_alternate_network);
   dict->SetBoolean("allow_server_migration",
                    params_.quic_allow_server_migration);
   dict->SetBoolean("estimate_initial_rtt", params_.quic_estimate_initial_rtt);
+  dict->SetBoolean("batch_packet_writes", params_.quic_batch_packet_writes);
   dict->SetBoolean("force_hol_blocking", params_.quic_force_hol_blocking);
   dict->SetBoolean("server_push_cancellation",
                    params_.enable_server_push_cancellation);
@@ -380,6 +395,7 @@ void HttpNetworkSession::CloseIdleConnections() {
   normal_socket_pool_manager_->CloseIdleSockets();
   websocket_socket_pool_manager_->CloseIdleSockets();
   spdy_session_pool_.CloseCurrentIdleSessions();
+  quic_stream_factory_.CloseIdlePreconnectedSessions();
 }
 
 bool HttpNetworkSession::IsProtocolEnabled(NextProto protocol) const {
@@ -160,6 +160,9 @@ class NET_EXPORT HttpNetworkSession : public base::MemoryCoordinatorClient {
     int quic_max_time_before_crypto_handshake_seconds;
     // Maximum idle time before the crypto handshake has completed.
     int quic_max_idle_time_before_crypto_handshake_seconds;
+    // Maximum number of QUIC sessions started by a preconnect that are kept
+    // open while waiting for their first request.
+    int quic_max_preconnected_sessions;
     // If true, QUIC will attempt to explicitly use default network for sockets.
     bool quic_connect_using_default_network;
     // If true, active QUIC sessions may be migrated onto a new network when
@@ -175,6 +178,10 @@ class NET_EXPORT HttpNetworkSession : public base::MemoryCoordinatorClient {
     // If true, connection migration v2 may be used to migrate active QUIC
     // sessions to alternative network if current network connectivity is poor.
     bool quic_migrate_sessions_early_v2;
+    // If true, sessions using connection migration v2 on poor connectivity
+    // keep a validated path on an alternate network, and migrate to it
+    // without probing when the current path degrades.
+    bool quic_prevalidate_alternate_network;
     // If true, allows migration of QUIC connections to a server-specified
     // alternate server address.
     bool quic_allow_server_migration;
@@ -189,6 +196,9 @@ class NET_EXPORT HttpNetworkSession : public base::MemoryCoordinatorClient {
     bool quic_race_cert_verification;
     // If true, estimate the initial RTT for QUIC connections based on network.
     bool quic_estimate_initial_rtt;
+    // If true, QUIC sessions send the packets of each write loop in batches,
+    // with as few system calls as the socket allows.
+    bool quic_batch_packet_writes;
     // If non-empty, QUIC will only be spoken to hosts in this list.
     base::flat_set<std::string> quic_host_whitelist;
 
@@ -198,6 +208,14 @@ class NET_EXPORT HttpNetworkSession : public base::MemoryCoordinatorClient {
     // Enable HTTP/0.9 for HTTP/HTTPS on ports other than the default one for
     // each protocol.
     bool http_09_on_non_default_ports_enabled;
+
+    // If non-empty, TLS sessions are shared with every other
+    // HttpNetworkSession using the same value, so that connections made by one
+    // may resume sessions established by another. Otherwise, sessions are only
+    // resumed within this HttpNetworkSession. Sessions allow servers to link
+    // connections, so this must only be shared between sessions whose requests
+    // may be linked anyway.
+    std::string ssl_session_cache_shard;
   };
 
   // Structure with pointers to the dependencies of the HttpNetworkSession.
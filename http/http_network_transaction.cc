@@ -388,6 +388,8 @@ bool HttpNetworkTransaction::GetLoadTimingInfo(
   load_timing_info->proxy_resolve_start =
       proxy_info_.proxy_resolve_start_time();
   load_timing_info->proxy_resolve_end = proxy_info_.proxy_resolve_end_time();
+  load_timing_info->throttle_start = throttle_start_time_;
+  load_timing_info->throttle_end = throttle_end_time_;
   load_timing_info->send_start = send_start_time_;
   load_timing_info->send_end = send_end_time_;
   return true;
@@ -617,6 +619,9 @@ void HttpNetworkTransaction::OnThrottleUnblocked(
   DCHECK_EQ(STATE_THROTTLE_COMPLETE, next_state_);
 
   net_log_.EndEvent(NetLogEventType::HTTP_TRANSACTION_THROTTLED);
+  throttle_end_time_ = base::TimeTicks::Now();
+  UMA_HISTOGRAM_MEDIUM_TIMES("Net.HttpNetworkTransaction.ThrottledTime",
+                             throttle_end_time_ - throttle_start_time_);
 
   DoLoop(OK);
 }
@@ -822,6 +827,7 @@ int HttpNetworkTransaction::DoThrottle() {
 
   if (throttle_->IsBlocked()) {
     net_log_.BeginEvent(NetLogEventType::HTTP_TRANSACTION_THROTTLED);
+    throttle_start_time_ = base::TimeTicks::Now();
     return ERR_IO_PENDING;
   }
 
@@ -373,6 +373,11 @@ class NET_EXPORT_PRIVATE HttpNetworkTransaction
   base::TimeTicks send_start_time_;
   base::TimeTicks send_end_time_;
 
+  // When the transaction was blocked / unblocked by |throttle_|. Null if it
+  // was never blocked.
+  base::TimeTicks throttle_start_time_;
+  base::TimeTicks throttle_end_time_;
+
   // The next state in the state machine.
   State next_state_;
 
@@ -16888,6 +16888,11 @@ TEST_F(HttpNetworkTransactionTest, ThrottlingUnthrottled) {
   TestCompletionCallback callback;
   trans->Start(&request, callback.callback(), NetLogWithSource());
   EXPECT_EQ(OK, callback.WaitForResult());
+
+  LoadTimingInfo load_timing_info;
+  ASSERT_TRUE(trans->GetLoadTimingInfo(&load_timing_info));
+  EXPECT_TRUE(load_timing_info.throttle_start.is_null());
+  EXPECT_TRUE(load_timing_info.throttle_end.is_null());
 }
 
 // Confirm requests can be blocked by a throttler, and are resumed
@@ -16934,6 +16939,13 @@ TEST_F(HttpNetworkTransactionTest, ThrottlingBasic) {
   base::RunLoop().RunUntilIdle();
   ASSERT_TRUE(callback.have_result());
   EXPECT_EQ(OK, callback.WaitForResult());
+
+  // The time spent throttled is part of the load timing.
+  LoadTimingInfo load_timing_info;
+  ASSERT_TRUE(trans->GetLoadTimingInfo(&load_timing_info));
+  EXPECT_FALSE(load_timing_info.throttle_start.is_null());
+  EXPECT_LE(load_timing_info.throttle_start, load_timing_info.throttle_end);
+  EXPECT_LE(load_timing_info.throttle_end, load_timing_info.send_start);
 }
 
 // Destroy a request while it's throttled.
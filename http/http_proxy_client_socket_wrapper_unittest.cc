@@ -93,6 +93,7 @@ class HttpProxyClientSocketWrapperTest
         migrate_sessions_early_(false),
         migrate_sessions_on_network_change_v2_(false),
         migrate_sessions_early_v2_(false),
+        prevalidate_alternate_network_(false),
         allow_server_migration_(false),
         race_cert_verification_(false),
         estimate_initial_rtt_(false),
@@ -122,11 +123,14 @@ class HttpProxyClientSocketWrapperTest
         kMaxTimeForCryptoHandshakeSecs,
         /*max_idle_time_before_crypto_handshake_seconds=*/
         kInitialIdleTimeoutSecs,
+        /*max_preconnected_sessions=*/kMaxPreconnectedSessions,
         /*connect_using_default_network=*/true,
         migrate_sessions_on_network_change_, migrate_sessions_early_,
         migrate_sessions_on_network_change_v2_, migrate_sessions_early_v2_,
-        allow_server_migration_, race_cert_verification_, estimate_initial_rtt_,
-        connection_options_, client_connection_options_,
+        prevalidate_alternate_network_, allow_server_migration_,
+        race_cert_verification_, estimate_initial_rtt_,
+        /*batch_packet_writes=*/false, connection_options_,
+        client_connection_options_,
         /*enable_token_binding=*/false));
   }
 
@@ -219,6 +223,7 @@ class HttpProxyClientSocketWrapperTest
   bool migrate_sessions_early_;
   bool migrate_sessions_on_network_change_v2_;
   bool migrate_sessions_early_v2_;
+  bool prevalidate_alternate_network_;
   bool allow_server_migration_;
   bool race_cert_verification_;
   bool estimate_initial_rtt_;
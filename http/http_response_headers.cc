@@ -114,6 +114,48 @@ bool ShouldUpdateHeader(base::StringPiece name) {
   return true;
 }
 
+// The headers which the response handling path looks up most often. Their
+// first position is indexed, so that looking them up, and above all missing
+// them, does not scan all the headers.
+const char* const kIndexedHeaders[] = {
+    "age",
+    "alt-svc",
+    "cache-control",
+    "connection",
+    "content-disposition",
+    "content-encoding",
+    "content-length",
+    "content-range",
+    "content-type",
+    "date",
+    "etag",
+    "expires",
+    "keep-alive",
+    "last-modified",
+    "location",
+    "nel",
+    "pragma",
+    "proxy-authenticate",
+    "proxy-connection",
+    "set-cookie",
+    "strict-transport-security",
+    "transfer-encoding",
+    "vary",
+    "www-authenticate",
+};
+
+// Returns the index of |name| in kIndexedHeaders, or std::string::npos.
+size_t FindIndexedHeader(const base::StringPiece& name) {
+  for (size_t i = 0; i < arraysize(kIndexedHeaders); ++i) {
+    base::StringPiece indexed_header(kIndexedHeaders[i]);
+    if (indexed_header.size() == name.size() &&
+        base::EqualsCaseInsensitiveASCII(indexed_header, name)) {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
 void CheckDoesNotHaveEmbededNulls(const std::string& str) {
   // Care needs to be taken when adding values to the raw headers string to
   // make sure it does not contain embeded NULLs. Any embeded '\0' may be
@@ -163,6 +205,7 @@ HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
 
 HttpResponseHeaders::HttpResponseHeaders(base::PickleIterator* iter)
     : response_code_(-1) {
+  indexed_header_positions_.fill(std::string::npos);
   std::string raw_input;
   if (iter->ReadString(&raw_input))
     Parse(raw_input);
@@ -410,6 +453,10 @@ void HttpResponseHeaders::UpdateWithNewRange(const HttpByteRange& byte_range,
 }
 
 void HttpResponseHeaders::Parse(const std::string& raw_input) {
+  static_assert(arraysize(kIndexedHeaders) == kNumIndexedHeaders,
+                "kNumIndexedHeaders must match kIndexedHeaders");
+  DCHECK(parsed_.empty());
+  indexed_header_positions_.fill(std::string::npos);
   raw_headers_.reserve(raw_input.size());
 
   // ParseStatusLine adds a normalized status line to raw_headers_
@@ -703,6 +750,15 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const base::StringPiece& search) const {
+  size_t indexed_header = FindIndexedHeader(search);
+  if (indexed_header != std::string::npos) {
+    size_t first_position = indexed_header_positions_[indexed_header];
+    if (first_position == std::string::npos)
+      return std::string::npos;
+    if (from <= first_position)
+      return first_position;
+  }
+
   for (size_t i = from; i < parsed_.size(); ++i) {
     if (parsed_[i].is_continuation())
       continue;
@@ -761,6 +817,15 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
                                       std::string::const_iterator name_end,
                                       std::string::const_iterator value_begin,
                                       std::string::const_iterator value_end) {
+  if (name_begin != name_end) {
+    base::StringPiece name(&*name_begin, name_end - name_begin);
+    size_t indexed_header = FindIndexedHeader(name);
+    if (indexed_header != std::string::npos &&
+        indexed_header_positions_[indexed_header] == std::string::npos) {
+      indexed_header_positions_[indexed_header] = parsed_.size();
+    }
+  }
+
   ParsedHeader header;
   header.name_begin = name_begin;
   header.name_end = name_end;
@@ -957,6 +1022,12 @@ HttpResponseHeaders::GetFreshnessLifetimes(const Time& response_time) const {
     return lifetimes;
   }
 
+  // From RFC 5861 section 3, a stale response may be served while it is
+  // revalidated asynchronously, unless it must be revalidated before use.
+  bool has_staleness = !HasHeaderValue("cache-control", "must-revalidate") &&
+                       GetStaleWhileRevalidateValue(&lifetimes.staleness);
+  DCHECK(has_staleness || lifetimes.staleness.is_zero());
+
   // NOTE: "Cache-Control: max-age" overrides Expires, so we only check the
   // Expires header after checking for max-age in GetFreshnessLifetimes.  This
   // is important since "Expires: <date in the past>" means not fresh, but
@@ -1104,6 +1175,11 @@ bool HttpResponseHeaders::GetMaxAgeValue(TimeDelta* result) const {
   return GetCacheControlDirective("max-age", result);
 }
 
+bool HttpResponseHeaders::GetStaleWhileRevalidateValue(
+    TimeDelta* result) const {
+  return GetCacheControlDirective("stale-while-revalidate", result);
+}
+
 bool HttpResponseHeaders::GetAgeValue(TimeDelta* result) const {
   std::string value;
   if (!EnumerateHeader(nullptr, "Age", &value))
@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <array>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -50,6 +51,9 @@ class NET_EXPORT HttpResponseHeaders
   struct FreshnessLifetimes {
     // How long the resource will be fresh for.
     base::TimeDelta freshness;
+    // How long after becoming stale the resource may still be served while it
+    // is revalidated in the background, from "stale-while-revalidate".
+    base::TimeDelta staleness;
   };
 
   static const char kContentRange[];
@@ -231,6 +235,7 @@ class NET_EXPORT HttpResponseHeaders
   // value is not present, or is invalid, then false is returned.  Otherwise,
   // true is returned and the out param is assigned to the corresponding value.
   bool GetMaxAgeValue(base::TimeDelta* value) const;
+  bool GetStaleWhileRevalidateValue(base::TimeDelta* value) const;
   bool GetAgeValue(base::TimeDelta* value) const;
   bool GetDateValue(base::Time* value) const;
   bool GetLastModifiedValue(base::Time* value) const;
@@ -295,6 +300,10 @@ class NET_EXPORT HttpResponseHeaders
   struct ParsedHeader;
   typedef std::vector<ParsedHeader> HeaderList;
 
+  // The number of well-known headers whose first position in parsed_ is
+  // indexed.
+  static const size_t kNumIndexedHeaders = 24;
+
   ~HttpResponseHeaders();
 
   // Initializes from the given raw headers.
@@ -319,7 +328,8 @@ class NET_EXPORT HttpResponseHeaders
                        bool has_headers);
 
   // Find the header in our list (case-insensitive) starting with parsed_ at
-  // index |from|.  Returns string::npos if not found.
+  // index |from|.  Returns string::npos if not found.  Well-known headers
+  // start from their indexed position, and absent ones are not searched for.
   size_t FindHeader(size_t from, const base::StringPiece& name) const;
 
   // Search the Cache-Control header for a directive matching |directive|. If
@@ -373,6 +383,10 @@ class NET_EXPORT HttpResponseHeaders
   // header-value pairs within raw_headers_.
   HeaderList parsed_;
 
+  // The index in parsed_ of the first occurrence of each well-known header, or
+  // string::npos if it is absent.  Built along with parsed_.
+  std::array<size_t, kNumIndexedHeaders> indexed_header_positions_;
+
   // The raw_headers_ consists of the normalized status line (terminated with a
   // null byte) and then followed by the raw null-terminated headers from the
   // input that was passed to our constructor.  We preserve the input [*] to
@@ -510,6 +510,42 @@ TEST(HttpResponseHeadersTest, EnumerateHeader_Coalesced) {
   EXPECT_FALSE(parsed->EnumerateHeader(&iter, "cache-control", &value));
 }
 
+// Tests lookups of headers whose position is indexed, along with others.
+TEST(HttpResponseHeadersTest, EnumerateHeader_Indexed) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "X-Custom: a\n"
+      "Cache-Control: private\n"
+      "Content-Type: text/html\n"
+      "cache-control: no-store\n"
+      "X-Custom: b\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<HttpResponseHeaders> parsed(new HttpResponseHeaders(headers));
+
+  size_t iter = 0;
+  std::string value;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "CACHE-CONTROL", &value));
+  EXPECT_EQ("private", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "cache-control", &value));
+  EXPECT_EQ("no-store", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "cache-control", &value));
+
+  EXPECT_TRUE(parsed->GetNormalizedHeader("x-custom", &value));
+  EXPECT_EQ("a, b", value);
+  EXPECT_TRUE(parsed->HasHeader("Content-Type"));
+  EXPECT_FALSE(parsed->HasHeader("Location"));
+  EXPECT_FALSE(parsed->HasHeader("X-Other"));
+
+  // The index follows changes to the headers.
+  parsed->RemoveHeader("Cache-Control");
+  EXPECT_FALSE(parsed->HasHeader("cache-control"));
+  parsed->AddHeader("Location: /next");
+  EXPECT_TRUE(parsed->GetNormalizedHeader("location", &value));
+  EXPECT_EQ("/next", value);
+  EXPECT_TRUE(parsed->GetNormalizedHeader("content-type", &value));
+  EXPECT_EQ("text/html", value);
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_Challenge) {
   // Even though WWW-Authenticate has commas, it should not be treated as
   // coalesced values.
@@ -2085,6 +2121,28 @@ TEST_F(HttpResponseHeadersCacheControlTest, MaxAgeCaseInsensitive) {
   EXPECT_EQ(TimeDelta::FromSeconds(15), GetMaxAgeValue());
 }
 
+TEST_F(HttpResponseHeadersCacheControlTest, StaleWhileRevalidate) {
+  InitializeHeadersWithCacheControl("max-age=10, stale-while-revalidate=20");
+  TimeDelta value;
+  EXPECT_TRUE(headers()->GetStaleWhileRevalidateValue(&value));
+  EXPECT_EQ(TimeDelta::FromSeconds(20), value);
+
+  HttpResponseHeaders::FreshnessLifetimes lifetimes =
+      headers()->GetFreshnessLifetimes(base::Time());
+  EXPECT_EQ(TimeDelta::FromSeconds(10), lifetimes.freshness);
+  EXPECT_EQ(TimeDelta::FromSeconds(20), lifetimes.staleness);
+}
+
+TEST_F(HttpResponseHeadersCacheControlTest,
+       StaleWhileRevalidateIgnoredWithMustRevalidate) {
+  InitializeHeadersWithCacheControl(
+      "max-age=10, stale-while-revalidate=20, must-revalidate");
+  HttpResponseHeaders::FreshnessLifetimes lifetimes =
+      headers()->GetFreshnessLifetimes(base::Time());
+  EXPECT_EQ(TimeDelta::FromSeconds(10), lifetimes.freshness);
+  EXPECT_EQ(TimeDelta(), lifetimes.staleness);
+}
+
 struct MaxAgeTestData {
   const char* max_age_string;
   const int64_t expected_seconds;
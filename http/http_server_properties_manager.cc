@@ -171,8 +171,9 @@ void HttpServerPropertiesManager::SetHTTP11Required(
     const HostPortPair& server) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
 
+  // Whether a server requires HTTP/1.1 is not persisted, so there is no need
+  // to update the prefs.
   http_server_properties_impl_->SetHTTP11Required(server);
-  ScheduleUpdatePrefs(HTTP_11_REQUIRED);
 }
 
 void HttpServerPropertiesManager::MaybeForceHTTP11(const HostPortPair& server,
@@ -305,15 +306,18 @@ void HttpServerPropertiesManager::SetServerNetworkStats(
     const url::SchemeHostPort& server,
     ServerNetworkStats stats) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  ServerNetworkStats old_stats;
   const ServerNetworkStats* old_stats_ptr =
       http_server_properties_impl_->GetServerNetworkStats(server);
-  if (http_server_properties_impl_->GetServerNetworkStats(server))
-    old_stats = *old_stats_ptr;
+  const bool had_stats = old_stats_ptr != nullptr;
+  base::TimeDelta old_srtt;
+  if (had_stats)
+    old_srtt = old_stats_ptr->srtt;
   http_server_properties_impl_->SetServerNetworkStats(server, stats);
-  ServerNetworkStats new_stats =
-      *(http_server_properties_impl_->GetServerNetworkStats(server));
-  if (old_stats != new_stats)
+  // Only the smoothed RTT is persisted, so a change of the bandwidth estimate
+  // alone does not need to update the prefs.
+  base::TimeDelta new_srtt =
+      http_server_properties_impl_->GetServerNetworkStats(server)->srtt;
+  if (!had_stats || old_srtt != new_srtt)
     ScheduleUpdatePrefs(SET_SERVER_NETWORK_STATS);
 }
 
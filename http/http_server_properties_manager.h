@@ -146,7 +146,7 @@ class NET_EXPORT HttpServerPropertiesManager : public HttpServerProperties {
   // histograms.xml.
   enum Location {
     SUPPORTS_SPDY = 0,
-    HTTP_11_REQUIRED = 1,
+    // deprecated: HTTP_11_REQUIRED = 1,
     SET_ALTERNATIVE_SERVICES = 2,
     MARK_ALTERNATIVE_SERVICE_BROKEN = 3,
     MARK_ALTERNATIVE_SERVICE_RECENTLY_BROKEN = 4,
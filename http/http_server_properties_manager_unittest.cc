@@ -715,6 +715,13 @@ TEST_P(HttpServerPropertiesManagerTest, ServerNetworkStats) {
       http_server_props_manager_->GetServerNetworkStats(mail_server);
   EXPECT_EQ(10, stats2->srtt.ToInternalValue());
 
+  // The bandwidth estimate is not persisted, so changing it alone should not
+  // schedule a task either.
+  ServerNetworkStats stats3 = stats1;
+  stats3.bandwidth_estimate = QuicBandwidth::FromKBitsPerSecond(100);
+  http_server_props_manager_->SetServerNetworkStats(mail_server, stats3);
+  EXPECT_FALSE(test_task_runner_->HasPendingTask());
+
   http_server_props_manager_->ClearServerNetworkStats(mail_server);
 
   // Run the task.
@@ -4,6 +4,7 @@
 
 #include "net/http/http_stream_factory_impl.h"
 
+#include <algorithm>
 #include <tuple>
 #include <utility>
 
@@ -31,14 +32,33 @@
 
 namespace net {
 
+namespace {
+
+// The maximum number of origins for which the number of streams to preconnect
+// is remembered.
+const size_t kMaxPreconnectPredictions = 100;
+
+// The number of alternative service jobs in a row which must fail for the main
+// job to stop waiting for the alternative service job.
+const int kMaxConsecutiveAlternativeServiceJobFailures = 3;
+
+}  // namespace
+
 HttpStreamFactoryImpl::HttpStreamFactoryImpl(HttpNetworkSession* session,
                                              bool for_websockets)
     : session_(session),
       job_factory_(new JobFactory()),
+      preconnect_predictions_(kMaxPreconnectPredictions),
+      consecutive_alternative_service_job_failures_(0),
       for_websockets_(for_websockets),
-      last_logged_job_controller_count_(0) {}
+      last_logged_job_controller_count_(0) {
+  NetworkChangeNotifier::AddIPAddressObserver(this);
+  NetworkChangeNotifier::AddNetworkChangeObserver(this);
+}
 
 HttpStreamFactoryImpl::~HttpStreamFactoryImpl() {
+  NetworkChangeNotifier::RemoveNetworkChangeObserver(this);
+  NetworkChangeNotifier::RemoveIPAddressObserver(this);
   UMA_HISTOGRAM_COUNTS_1M("Net.JobControllerSet.CountOfJobControllerAtShutDown",
                           job_controller_set_.size());
 }
@@ -117,6 +137,7 @@ std::unique_ptr<HttpStreamRequest> HttpStreamFactoryImpl::RequestStreamInternal(
       enable_alternative_services, server_ssl_config, proxy_ssl_config);
   JobController* job_controller_raw_ptr = job_controller.get();
   job_controller_set_.insert(std::move(job_controller));
+  OnStreamRequestStarted(url::SchemeHostPort(request_info.url));
   return job_controller_raw_ptr->Start(delegate,
                                        websocket_handshake_stream_create_helper,
                                        net_log, stream_type, priority);
@@ -138,6 +159,13 @@ void HttpStreamFactoryImpl::PreconnectStreams(
 
   DCHECK(!for_websockets_);
 
+  // Open as many streams as the latest burst of requests to the origin needed
+  // at once. The number asked for only serves origins not seen before.
+  auto prediction =
+      preconnect_predictions_.Get(url::SchemeHostPort(request_info.url));
+  if (prediction != preconnect_predictions_.end())
+    num_streams = prediction->second;
+
   auto job_controller = std::make_unique<JobController>(
       this, nullptr, session_, job_factory_.get(), request_info,
       /* is_preconnect = */ true,
@@ -157,6 +185,10 @@ void HttpStreamFactoryImpl::OnJobControllerComplete(JobController* controller) {
   for (auto it = job_controller_set_.begin(); it != job_controller_set_.end();
        ++it) {
     if (it->get() == controller) {
+      if (!controller->is_preconnect()) {
+        OnStreamRequestFinished(
+            url::SchemeHostPort(controller->request_info().url));
+      }
       job_controller_set_.erase(it);
       return;
     }
@@ -164,6 +196,50 @@ void HttpStreamFactoryImpl::OnJobControllerComplete(JobController* controller) {
   NOTREACHED();
 }
 
+void HttpStreamFactoryImpl::OnAlternativeServiceJobFailed() {
+  if (consecutive_alternative_service_job_failures_ <
+      kMaxConsecutiveAlternativeServiceJobFailures) {
+    ++consecutive_alternative_service_job_failures_;
+  }
+}
+
+void HttpStreamFactoryImpl::OnAlternativeServiceJobSucceeded() {
+  consecutive_alternative_service_job_failures_ = 0;
+}
+
+bool HttpStreamFactoryImpl::AlternativeServiceJobsKeepFailing() const {
+  return consecutive_alternative_service_job_failures_ >=
+         kMaxConsecutiveAlternativeServiceJobFailures;
+}
+
+void HttpStreamFactoryImpl::OnIPAddressChanged() {
+  // Alternative services which were blocked may work on the new network.
+  consecutive_alternative_service_job_failures_ = 0;
+}
+
+void HttpStreamFactoryImpl::OnNetworkChanged(
+    NetworkChangeNotifier::ConnectionType type) {
+  consecutive_alternative_service_job_failures_ = 0;
+}
+
+void HttpStreamFactoryImpl::OnStreamRequestStarted(
+    const url::SchemeHostPort& origin) {
+  OriginRequestCount& count = pending_stream_requests_[origin];
+  ++count.pending;
+  count.peak = std::max(count.peak, count.pending);
+}
+
+void HttpStreamFactoryImpl::OnStreamRequestFinished(
+    const url::SchemeHostPort& origin) {
+  auto it = pending_stream_requests_.find(origin);
+  DCHECK(it != pending_stream_requests_.end());
+  DCHECK_GT(it->second.pending, 0);
+  if (--it->second.pending > 0)
+    return;
+  preconnect_predictions_.Put(origin, it->second.peak);
+  pending_stream_requests_.erase(it);
+}
+
 HttpStreamFactoryImpl::PreconnectingProxyServer::PreconnectingProxyServer(
     ProxyServer proxy_server,
     PrivacyMode privacy_mode)
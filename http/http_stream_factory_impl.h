@@ -11,11 +11,13 @@
 #include <memory>
 #include <set>
 
+#include "base/containers/mru_cache.h"
 #include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/net_export.h"
+#include "net/base/network_change_notifier.h"
 #include "net/base/privacy_mode.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_stream_factory.h"
@@ -23,6 +25,7 @@
 #include "net/proxy/proxy_server.h"
 #include "net/socket/ssl_client_socket.h"
 #include "net/spdy/chromium/spdy_session_key.h"
+#include "url/scheme_host_port.h"
 
 namespace net {
 
@@ -30,7 +33,10 @@ class HttpNetworkSession;
 class ProxyInfo;
 class NetLogWithSource;
 
-class NET_EXPORT_PRIVATE HttpStreamFactoryImpl : public HttpStreamFactory {
+class NET_EXPORT_PRIVATE HttpStreamFactoryImpl
+    : public HttpStreamFactory,
+      public NetworkChangeNotifier::IPAddressObserver,
+      public NetworkChangeNotifier::NetworkChangeObserver {
  public:
   class NET_EXPORT_PRIVATE Job;
   class NET_EXPORT_PRIVATE JobController;
@@ -79,6 +85,12 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl : public HttpStreamFactory {
   void DumpMemoryStats(base::trace_event::ProcessMemoryDump* pmd,
                        const std::string& parent_absolute_name) const override;
 
+  // NetworkChangeNotifier::IPAddressObserver implementation:
+  void OnIPAddressChanged() override;
+
+  // NetworkChangeNotifier::NetworkChangeObserver implementation:
+  void OnNetworkChanged(NetworkChangeNotifier::ConnectionType type) override;
+
   enum JobType {
     MAIN,
     ALTERNATIVE,
@@ -107,6 +119,14 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl : public HttpStreamFactory {
     const PrivacyMode privacy_mode;
   };
 
+  // |OriginRequestCount| holds the number of stream requests to an origin
+  // whose JobControllers have not completed yet.
+  struct OriginRequestCount {
+    int pending = 0;
+    // The largest value of |pending| since the origin had no requests.
+    int peak = 0;
+  };
+
   // Values must not be changed or reused.  Keep in sync with identically named
   // enum in histograms.xml.
   enum AlternativeServiceType {
@@ -142,6 +162,22 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl : public HttpStreamFactory {
   // from |job_controller_set_|.
   void OnJobControllerComplete(JobController* controller);
 
+  // Keep track of the number of concurrent stream requests to |origin|, to
+  // predict the number of streams a later preconnect to it should open.
+  void OnStreamRequestStarted(const url::SchemeHostPort& origin);
+  void OnStreamRequestFinished(const url::SchemeHostPort& origin);
+
+  // Keep track of whether alternative service jobs fail on the current
+  // network. Called when a job to an alternative service fails while the main
+  // job succeeds, and when a job to an alternative service succeeds.
+  void OnAlternativeServiceJobFailed();
+  void OnAlternativeServiceJobSucceeded();
+
+  // Returns true if the latest alternative service jobs have all failed, to
+  // different origins or not. The main job then starts along with the
+  // alternative service job rather than waiting for it.
+  bool AlternativeServiceJobsKeepFailing() const;
+
   // Returns true if a connection to the proxy server contained in |proxy_info|
   // that has privacy mode |privacy_mode| can be skipped by a job controlled by
   // |controller|.
@@ -178,6 +214,18 @@ class NET_EXPORT_PRIVATE HttpStreamFactoryImpl : public HttpStreamFactory {
   // preconnects should be skipped.
   std::set<PreconnectingProxyServer> preconnecting_proxy_servers_;
 
+  // Stream requests per origin for which a JobController is still working.
+  std::map<url::SchemeHostPort, OriginRequestCount> pending_stream_requests_;
+
+  // The peak number of concurrent stream requests of the latest burst of
+  // requests to each origin. A preconnect to one of these origins opens that
+  // many streams, regardless of the number asked for.
+  base::MRUCache<url::SchemeHostPort, int> preconnect_predictions_;
+
+  // The number of alternative service jobs which failed since the last one
+  // which succeeded, or since the network changed.
+  int consecutive_alternative_service_job_failures_;
+
   const bool for_websockets_;
 
   // The count of JobControllers that was most recently logged to histograms.
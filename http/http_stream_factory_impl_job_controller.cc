@@ -858,7 +858,9 @@ int HttpStreamFactoryImpl::JobController::DoCreateJobs() {
         origin_url, alternative_service_info_.protocol(), quic_version,
         enable_ip_based_pooling_, net_log_.net_log());
 
-    main_job_is_blocked_ = true;
+    // Don't hold up the main job for an alternative service which is likely
+    // unreachable from this network.
+    main_job_is_blocked_ = !factory_->AlternativeServiceJobsKeepFailing();
     alternative_job_->Start(request_->stream_type());
   } else {
     ProxyServer alternative_proxy_server;
@@ -943,6 +945,10 @@ void HttpStreamFactoryImpl::JobController::OnJobSucceeded(Job* job) {
 
   if (job->job_type() == MAIN && alternative_job_net_error_ != OK)
     ReportBrokenAlternativeService();
+  if (job->job_type() == ALTERNATIVE &&
+      alternative_service_info_.protocol() != kProtoUnknown) {
+    factory_->OnAlternativeServiceJobSucceeded();
+  }
 
   if (!bound_job_) {
     if (main_job_ && alternative_job_)
@@ -1011,6 +1017,7 @@ void HttpStreamFactoryImpl::JobController::ReportBrokenAlternativeService() {
       BROKEN_ALTERNATE_PROTOCOL_LOCATION_HTTP_STREAM_FACTORY_IMPL_JOB_ALT);
   session_->http_server_properties()->MarkAlternativeServiceBroken(
       alternative_service_info_.alternative_service());
+  factory_->OnAlternativeServiceJobFailed();
 }
 
 void HttpStreamFactoryImpl::JobController::MaybeNotifyFactoryOfCompletion() {
@@ -183,6 +183,8 @@ class HttpStreamFactoryImpl::JobController
 
   bool is_preconnect() const { return is_preconnect_; }
 
+  const HttpRequestInfo& request_info() const { return request_info_; }
+
   // Returns true if |this| has a pending request that is not completed.
   bool HasPendingRequest() const { return request_ != nullptr; }
 
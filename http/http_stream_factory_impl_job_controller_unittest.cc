@@ -1045,6 +1045,82 @@ TEST_F(HttpStreamFactoryImplJobControllerTest,
   EXPECT_TRUE(HttpStreamFactoryImplPeer::IsJobControllerDeleted(factory_));
 }
 
+// Tests that the main job is not blocked once several alternative service jobs
+// in a row have failed, and that an alternative service job succeeding makes
+// later main jobs wait for their alternative service jobs again.
+TEST_F(HttpStreamFactoryImplJobControllerTest,
+       MainJobNotBlockedWhenAltJobsKeepFailing) {
+  quic_data_ = std::make_unique<MockQuicData>();
+  quic_data_->AddWrite(client_maker_.MakeInitialSettingsPacket(1, nullptr));
+  quic_data_->AddRead(ASYNC, OK);
+  // The main job starts right away, but does not connect before the
+  // alternative job succeeds.
+  tcp_data_ = std::make_unique<SequencedSocketData>(nullptr, 0, nullptr, 0);
+  tcp_data_->set_connect_data(MockConnect(SYNCHRONOUS, ERR_IO_PENDING));
+
+  HttpRequestInfo request_info;
+  request_info.method = "GET";
+  request_info.url = GURL("https://www.google.com");
+
+  Initialize(request_info);
+
+  for (int i = 0; i < 3; ++i)
+    HttpStreamFactoryImplPeer::OnAlternativeServiceJobFailed(factory_);
+  EXPECT_TRUE(HttpStreamFactoryImplPeer::AlternativeServiceJobsKeepFailing(
+      factory_));
+
+  url::SchemeHostPort server(request_info.url);
+  AlternativeService alternative_service(kProtoQUIC, server.host(), 443);
+  SetAlternativeService(request_info, alternative_service);
+  request_ =
+      job_controller_->Start(&request_delegate_, nullptr, net_log_.bound(),
+                             HttpStreamRequest::HTTP_STREAM, DEFAULT_PRIORITY);
+  EXPECT_TRUE(job_controller_->main_job());
+  EXPECT_TRUE(job_controller_->alternative_job());
+  EXPECT_FALSE(JobControllerPeer::main_job_is_blocked(job_controller_));
+
+  EXPECT_CALL(request_delegate_, OnStreamReadyImpl(_, _, _));
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_FALSE(job_controller_->main_job());
+  EXPECT_FALSE(HttpStreamFactoryImplPeer::AlternativeServiceJobsKeepFailing(
+      factory_));
+
+  request_.reset();
+  VerifyBrokenAlternateProtocolMapping(request_info, false);
+  EXPECT_TRUE(HttpStreamFactoryImplPeer::IsJobControllerDeleted(factory_));
+}
+
+// Tests that a network change clears the alternative service job failures, so
+// that main jobs wait for their alternative service jobs again.
+TEST_F(HttpStreamFactoryImplJobControllerTest,
+       NetworkChangeResetsAltJobFailures) {
+  HttpRequestInfo request_info;
+  request_info.method = "GET";
+  request_info.url = GURL("https://www.google.com");
+
+  SkipCreatingJobController();
+  Initialize(request_info);
+
+  for (int i = 0; i < 3; ++i)
+    HttpStreamFactoryImplPeer::OnAlternativeServiceJobFailed(factory_);
+  EXPECT_TRUE(HttpStreamFactoryImplPeer::AlternativeServiceJobsKeepFailing(
+      factory_));
+
+  NetworkChangeNotifier::NotifyObserversOfIPAddressChangeForTests();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(HttpStreamFactoryImplPeer::AlternativeServiceJobsKeepFailing(
+      factory_));
+
+  for (int i = 0; i < 3; ++i)
+    HttpStreamFactoryImplPeer::OnAlternativeServiceJobFailed(factory_);
+  NetworkChangeNotifier::NotifyObserversOfNetworkChangeForTests(
+      NetworkChangeNotifier::CONNECTION_WIFI);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(HttpStreamFactoryImplPeer::AlternativeServiceJobsKeepFailing(
+      factory_));
+}
+
 TEST_F(HttpStreamFactoryImplJobControllerTest,
        SpdySessionKeyHasOriginHostPortPair) {
   session_deps_.enable_http2_alternative_service = true;
@@ -674,6 +674,51 @@ TEST_F(HttpStreamFactoryTest, PreconnectSetsMotivation) {
             transport_conn_pool->last_motivation());
 }
 
+// Verify that a preconnect opens as many streams as the latest burst of
+// requests to the origin needed at once.
+TEST_F(HttpStreamFactoryTest, PreconnectUsesPeakConcurrentRequests) {
+  SpdySessionDependencies session_deps(ProxyService::CreateDirect());
+  // Keep the requests pending on host resolution.
+  session_deps.host_resolver->set_synchronous_mode(false);
+  std::unique_ptr<HttpNetworkSession> session(
+      SpdySessionDependencies::SpdyCreateSession(&session_deps));
+  HttpNetworkSessionPeer peer(session.get());
+  MockHttpStreamFactoryImplForPreconnect* mock_factory =
+      new MockHttpStreamFactoryImplForPreconnect(session.get());
+  peer.SetHttpStreamFactory(std::unique_ptr<HttpStreamFactory>(mock_factory));
+
+  HttpRequestInfo request_info;
+  request_info.method = "GET";
+  request_info.url = GURL("http://www.google.com");
+
+  SSLConfig ssl_config;
+  StreamRequestWaiter waiter;
+  std::vector<std::unique_ptr<HttpStreamRequest>> requests;
+  for (int i = 0; i < 3; ++i) {
+    requests.push_back(mock_factory->RequestStream(
+        request_info, DEFAULT_PRIORITY, ssl_config, ssl_config, &waiter,
+        /* enable_ip_based_pooling = */ true,
+        /* enable_alternative_services = */ true, NetLogWithSource()));
+  }
+  // The burst ends when all of its requests are done.
+  requests.clear();
+
+  CapturePreconnectsTransportSocketPool* transport_conn_pool =
+      new CapturePreconnectsTransportSocketPool(
+          session_deps.host_resolver.get(), session_deps.cert_verifier.get(),
+          session_deps.transport_security_state.get(),
+          session_deps.cert_transparency_verifier.get(),
+          session_deps.ct_policy_enforcer.get());
+  auto mock_pool_manager = std::make_unique<MockClientSocketPoolManager>();
+  mock_pool_manager->SetTransportSocketPool(transport_conn_pool);
+  peer.SetClientSocketPoolManager(std::move(mock_pool_manager));
+
+  request_info.motivation = HttpRequestInfo::PRECONNECT_MOTIVATED;
+  mock_factory->PreconnectStreams(1, request_info);
+  mock_factory->WaitForPreconnects();
+  EXPECT_EQ(3, transport_conn_pool->last_num_streams());
+}
+
 TEST_F(HttpStreamFactoryTest, JobNotifiesProxy) {
   const char* kProxyString = "PROXY bad:99; PROXY maybe:80; DIRECT";
   SpdySessionDependencies session_deps(
@@ -39,6 +39,15 @@ class HttpStreamFactoryImplPeer {
       HttpStreamFactoryImpl* factory) {
     return factory->job_factory_.get();
   }
+
+  static void OnAlternativeServiceJobFailed(HttpStreamFactoryImpl* factory) {
+    factory->OnAlternativeServiceJobFailed();
+  }
+
+  static bool AlternativeServiceJobsKeepFailing(
+      HttpStreamFactoryImpl* factory) {
+    return factory->AlternativeServiceJobsKeepFailing();
+  }
 };
 
 // This delegate does nothing when called.
@@ -4,6 +4,7 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "base/bind.h"
@@ -194,6 +195,7 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
       read_buf_(read_buffer),
       read_buf_unused_offset_(0),
       response_header_start_offset_(-1),
+      response_header_searched_offset_(0),
       received_bytes_(0),
       sent_bytes_(0),
       response_(nullptr),
@@ -899,6 +901,7 @@ int HttpStreamParser::HandleReadHeaderResult(int result) {
         // response and reject it in the event that we're setting up a CONNECT
         // tunnel.
         response_header_start_offset_ = -1;
+        response_header_searched_offset_ = 0;
         response_body_length_ = -1;
         // Now waiting for the second set of headers to be read.
       } else {
@@ -931,9 +934,14 @@ int HttpStreamParser::FindAndParseResponseHeaders() {
   }
 
   if (response_header_start_offset_ >= 0) {
-    end_offset = HttpUtil::LocateEndOfHeaders(read_buf_->StartOfBuffer(),
-                                              read_buf_->offset(),
-                                              response_header_start_offset_);
+    // The end-of-headers marker is at most 3 bytes long, so one which ends in
+    // the new data starts no earlier than 2 bytes before it.
+    int search_offset = std::max(response_header_start_offset_,
+                                 response_header_searched_offset_ - 2);
+    end_offset = HttpUtil::LocateEndOfHeaders(
+        read_buf_->StartOfBuffer(), read_buf_->offset(), search_offset);
+    response_header_searched_offset_ =
+        end_offset == -1 ? read_buf_->offset() : 0;
   } else if (read_buf_->offset() >= 8) {
     // Enough data to decide that this is an HTTP/0.9 response.
     // 8 bytes = (4 bytes of junk) + "http".length()
@@ -225,6 +225,11 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
   // -1 if not found yet.
   int response_header_start_offset_;
 
+  // The amount of |read_buf_| already searched for the end of the headers
+  // without finding it, so that the search resumes from there as more data
+  // arrives.
+  int response_header_searched_offset_;
+
   // The amount of received data.  If connection is reused then intermediate
   // value may be bigger than final.
   int64_t received_bytes_;
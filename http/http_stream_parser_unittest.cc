@@ -1613,6 +1613,52 @@ TEST(HttpStreamParser, ReceivedBytesMultipleReads) {
   EXPECT_EQ(response_size, get_runner.parser()->received_bytes());
 }
 
+// Test that the end of the headers is found when its marker is split across
+// reads, at every offset and for every form of the marker.
+TEST(HttpStreamParser, EndOfHeadersSplitAcrossReads) {
+  const char* const kMarkers[] = {"\r\n\r\n", "\n\n", "\n\r\n", "\r\n\n"};
+  for (const char* marker : kMarkers) {
+    const std::string headers =
+        std::string("HTTP/1.1 200 OK\r\nContent-Length: 3") + marker;
+    const std::string body = "abc";
+    const size_t marker_start = headers.size() - std::string(marker).size();
+
+    // Two reads, split from just before the marker to just after it.
+    for (size_t split = marker_start; split <= headers.size(); ++split) {
+      SCOPED_TRACE(testing::Message() << "split: " << split);
+      const std::string first = headers.substr(0, split);
+      const std::string second = headers.substr(split) + body;
+      SimpleGetRunner get_runner;
+      get_runner.AddRead(first);
+      get_runner.AddRead(second);
+      get_runner.SetupParserAndSendRequest();
+      get_runner.ReadHeaders();
+      EXPECT_EQ(200, get_runner.response_info()->headers->response_code());
+      EXPECT_EQ(static_cast<int64_t>(headers.size()),
+                get_runner.parser()->received_bytes());
+      int read_lengths[] = {3, 0};
+      get_runner.ReadBody(body.size(), read_lengths);
+    }
+
+    // One read per byte of the marker, so the search resumes several times.
+    std::vector<std::string> reads;
+    reads.push_back(headers.substr(0, marker_start));
+    for (size_t i = marker_start; i < headers.size(); ++i)
+      reads.push_back(headers.substr(i, 1));
+    reads.push_back(body);
+    SimpleGetRunner get_runner;
+    for (const std::string& read : reads)
+      get_runner.AddRead(read);
+    get_runner.SetupParserAndSendRequest();
+    get_runner.ReadHeaders();
+    EXPECT_EQ(200, get_runner.response_info()->headers->response_code());
+    EXPECT_EQ(static_cast<int64_t>(headers.size()),
+              get_runner.parser()->received_bytes());
+    int read_lengths[] = {3, 0};
+    get_runner.ReadBody(body.size(), read_lengths);
+  }
+}
+
 // Test that "continue" HTTP header is counted as "received_bytes".
 TEST(HttpStreamParser, ReceivedBytesIncludesContinueHeader) {
   std::string status100 = "HTTP/1.1 100 OK\r\n\r\n";
@@ -7,6 +7,8 @@
 
 #include "net/http/http_util.h"
 
+#include <string.h>
+
 #include <algorithm>
 
 #include "base/logging.h"
@@ -596,25 +598,26 @@ static int LocateEndOfHeadersHelper(const char* buf,
                                     int buf_len,
                                     int i,
                                     bool accept_empty_header_list) {
-  char last_c = '\0';
-  bool was_lf = false;
-  if (accept_empty_header_list) {
-    // Normally two line breaks signal the end of a header list. An empty header
-    // list ends with a single line break at the start of the buffer.
-    last_c = '\n';
-    was_lf = true;
-  }
-
-  for (; i < buf_len; ++i) {
-    char c = buf[i];
-    if (c == '\n') {
-      if (was_lf)
-        return i + 1;
-      was_lf = true;
-    } else if (c != '\r' || last_c != '\n') {
-      was_lf = false;
+  const char* const start = buf + i;
+  const char* const end = buf + buf_len;
+  // Jumps from one LF to the next with memchr(), which is vectorized, and
+  // checks whether it is preceded by LF or LF CR.
+  for (const char* cur = start; cur < end;) {
+    const char* lf = static_cast<const char*>(memchr(cur, '\n', end - cur));
+    if (!lf)
+      return -1;
+    const char* line_start = lf;
+    if (line_start > start && line_start[-1] == '\r')
+      --line_start;
+    if (line_start > start) {
+      if (line_start[-1] == '\n')
+        return lf + 1 - buf;
+    } else if (accept_empty_header_list) {
+      // Normally two line breaks signal the end of a header list. An empty
+      // header list ends with a single line break at the start of the buffer.
+      return lf + 1 - buf;
     }
-    last_c = c;
+    cur = lf + 1;
   }
   return -1;
 }
@@ -304,6 +304,7 @@ TEST(HttpUtilTest, LocateEndOfHeaders) {
       {"foo\nbar\n\njunk", 9},
       {"foo\nbar\n\r\njunk", 10},
       {"foo\nbar\r\n\njunk", 10},
+      {"foo\n\r\r\nbar\n\n", 12},
   };
   for (size_t i = 0; i < arraysize(tests); ++i) {
     int input_len = static_cast<int>(strlen(tests[i].input));
@@ -328,6 +329,7 @@ TEST(HttpUtilTest, LocateEndOfAdditionalHeaders) {
       {"foo\nbar\n\njunk", 9},
       {"foo\nbar\n\r\njunk", 10},
       {"foo\nbar\r\n\njunk", 10},
+      {"foo\n\r\r\nbar\n\n", 12},
   };
   for (size_t i = 0; i < arraysize(tests); ++i) {
     int input_len = static_cast<int>(strlen(tests[i].input));
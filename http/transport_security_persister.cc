@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/base64.h"
 #include "base/bind.h"
@@ -91,6 +92,22 @@ const char kExpectCTObserved[] = "expect_ct_observed";
 const char kExpectCTEnforce[] = "expect_ct_enforce";
 const char kExpectCTReportUri[] = "expect_ct_report_uri";
 
+// How long to wait after the state is dirtied before writing it, so that
+// bursts of changes are coalesced into one write. This is the default commit
+// interval of ImportantFileWriter.
+constexpr base::TimeDelta kWriteDelay = base::TimeDelta::FromSeconds(10);
+
+// A copy of the dynamic state of a TransportSecurityState, keyed by hashed
+// host. Taking it is a plain copy of the state's maps, so it is cheap enough
+// to do on the network sequence; building and encoding the JSON from it is
+// left to the background sequence.
+struct StateSnapshot {
+  std::vector<std::pair<std::string, TransportSecurityState::STSState>> sts;
+  std::vector<std::pair<std::string, TransportSecurityState::PKPState>> pkp;
+  std::vector<std::pair<std::string, TransportSecurityState::ExpectCTState>>
+      expect_ct;
+};
+
 std::string LoadState(const base::FilePath& path) {
   std::string result;
   if (!base::ReadFileToString(path, &result)) {
@@ -125,15 +142,13 @@ void PopulateEntryWithDefaults(base::DictionaryValue* host) {
   host->SetDouble(kDynamicSPKIHashesExpiry, 0.0);
 }
 
-// Serializes STS data from |state| into |toplevel|. Any existing state in
+// Serializes STS data from |snapshot| into |toplevel|. Any existing state in
 // |toplevel| for each item is overwritten.
-void SerializeSTSData(TransportSecurityState* state,
+void SerializeSTSData(const StateSnapshot& snapshot,
                       base::DictionaryValue* toplevel) {
-  TransportSecurityState::STSStateIterator sts_iterator(*state);
-  for (; sts_iterator.HasNext(); sts_iterator.Advance()) {
-    const std::string& hostname = sts_iterator.hostname();
-    const TransportSecurityState::STSState& sts_state =
-        sts_iterator.domain_state();
+  for (const auto& item : snapshot.sts) {
+    const std::string& hostname = item.first;
+    const TransportSecurityState::STSState& sts_state = item.second;
 
     const std::string key = HashedDomainToExternalString(hostname);
     std::unique_ptr<base::DictionaryValue> serialized(
@@ -160,17 +175,15 @@ void SerializeSTSData(TransportSecurityState* state,
   }
 }
 
-// Serializes PKP data from |state| into |toplevel|. For each PKP item in
-// |state|, if |toplevel| already contains an item for that hostname, the item
-// is updated with the PKP data.
-void SerializePKPData(TransportSecurityState* state,
+// Serializes PKP data from |snapshot| into |toplevel|. For each PKP item in
+// |snapshot|, if |toplevel| already contains an item for that hostname, the
+// item is updated with the PKP data.
+void SerializePKPData(const StateSnapshot& snapshot,
                       base::DictionaryValue* toplevel) {
   base::Time now = base::Time::Now();
-  TransportSecurityState::PKPStateIterator pkp_iterator(*state);
-  for (; pkp_iterator.HasNext(); pkp_iterator.Advance()) {
-    const std::string& hostname = pkp_iterator.hostname();
-    const TransportSecurityState::PKPState& pkp_state =
-        pkp_iterator.domain_state();
+  for (const auto& item : snapshot.pkp) {
+    const std::string& hostname = item.first;
+    const TransportSecurityState::PKPState& pkp_state = item.second;
 
     // See if the current |hostname| already has STS state and, if so, update
     // that entry.
@@ -203,20 +216,16 @@ void SerializePKPData(TransportSecurityState* state,
   }
 }
 
-// Serializes Expect-CT data from |state| into |toplevel|. For each Expect-CT
-// item in |state|, if |toplevel| already contains an item for that hostname,
-// the item is updated to include a subdictionary with key
+// Serializes Expect-CT data from |snapshot| into |toplevel|. For each
+// Expect-CT item in |snapshot|, if |toplevel| already contains an item for that
+// hostname, the item is updated to include a subdictionary with key
 // |kExpectCTSubdictionary|; otherwise an item is created for that hostname with
 // a |kExpectCTSubdictionary| subdictionary.
-void SerializeExpectCTData(TransportSecurityState* state,
+void SerializeExpectCTData(const StateSnapshot& snapshot,
                            base::DictionaryValue* toplevel) {
-  if (!IsDynamicExpectCTEnabled())
-    return;
-  TransportSecurityState::ExpectCTStateIterator expect_ct_iterator(*state);
-  for (; expect_ct_iterator.HasNext(); expect_ct_iterator.Advance()) {
-    const std::string& hostname = expect_ct_iterator.hostname();
-    const TransportSecurityState::ExpectCTState& expect_ct_state =
-        expect_ct_iterator.domain_state();
+  for (const auto& item : snapshot.expect_ct) {
+    const std::string& hostname = item.first;
+    const TransportSecurityState::ExpectCTState& expect_ct_state = item.second;
 
     // See if the current |hostname| already has STS/PKP state and, if so,
     // update that entry.
@@ -244,6 +253,50 @@ void SerializeExpectCTData(TransportSecurityState* state,
   }
 }
 
+// Copies the dynamic state of |state| into a StateSnapshot. Expect-CT state is
+// only copied if dynamic Expect-CT is enabled.
+std::unique_ptr<StateSnapshot> TakeSnapshot(TransportSecurityState* state) {
+  auto snapshot = std::make_unique<StateSnapshot>();
+  TransportSecurityState::STSStateIterator sts_iterator(*state);
+  for (; sts_iterator.HasNext(); sts_iterator.Advance()) {
+    snapshot->sts.emplace_back(sts_iterator.hostname(),
+                               sts_iterator.domain_state());
+  }
+  TransportSecurityState::PKPStateIterator pkp_iterator(*state);
+  for (; pkp_iterator.HasNext(); pkp_iterator.Advance()) {
+    snapshot->pkp.emplace_back(pkp_iterator.hostname(),
+                               pkp_iterator.domain_state());
+  }
+  if (IsDynamicExpectCTEnabled()) {
+    TransportSecurityState::ExpectCTStateIterator expect_ct_iterator(*state);
+    for (; expect_ct_iterator.HasNext(); expect_ct_iterator.Advance()) {
+      snapshot->expect_ct.emplace_back(expect_ct_iterator.hostname(),
+                                       expect_ct_iterator.domain_state());
+    }
+  }
+  return snapshot;
+}
+
+// Encodes |snapshot| in the format described by
+// TransportSecurityPersister::SerializeData(). This is where the bulk of the
+// serialization cost is, so it can run on any sequence.
+std::unique_ptr<std::string> EncodeSnapshot(
+    std::unique_ptr<StateSnapshot> snapshot) {
+  base::DictionaryValue toplevel;
+
+  // TODO(davidben): Fix the serialization format by splitting the on-disk
+  // representation of the STS and PKP states. https://crbug.com/470295.
+  SerializeSTSData(*snapshot, &toplevel);
+  SerializePKPData(*snapshot, &toplevel);
+  SerializeExpectCTData(*snapshot, &toplevel);
+
+  // The file is not meant to be read by humans, and pretty printing makes it
+  // markedly bigger for large sets of hosts.
+  auto output = std::make_unique<std::string>();
+  base::JSONWriter::Write(toplevel, output.get());
+  return output;
+}
+
 // Populates |state| with the values in the |kExpectCTSubdictionary|
 // subdictionary in |parsed|. Returns false if |parsed| is malformed
 // (e.g. missing a required Expect-CT key) and true otherwise. Note that true
@@ -294,6 +347,7 @@ TransportSecurityPersister::TransportSecurityPersister(
       writer_(profile_path.AppendASCII("TransportSecurity"), background_runner),
       foreground_runner_(base::ThreadTaskRunnerHandle::Get()),
       background_runner_(background_runner),
+      encodes_in_flight_(0),
       weak_ptr_factory_(this) {
   transport_security_state_->SetDelegate(this);
 
@@ -307,8 +361,12 @@ TransportSecurityPersister::TransportSecurityPersister(
 TransportSecurityPersister::~TransportSecurityPersister() {
   DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
 
-  if (writer_.HasPendingWrite())
-    writer_.DoScheduledWrite();
+  // Pending writes and writes whose encoding has not come back yet would be
+  // lost, so write the current state synchronously instead.
+  if (write_timer_.IsRunning() || encodes_in_flight_ > 0) {
+    write_timer_.Stop();
+    writer_.WriteNow(EncodeSnapshot(TakeSnapshot(transport_security_state_)));
+  }
 
   transport_security_state_->SetDelegate(NULL);
 }
@@ -317,22 +375,16 @@ void TransportSecurityPersister::StateIsDirty(TransportSecurityState* state) {
   DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
   DCHECK_EQ(transport_security_state_, state);
 
-  writer_.ScheduleWrite(this);
+  if (!write_timer_.IsRunning()) {
+    write_timer_.Start(FROM_HERE, kWriteDelay, this,
+                       &TransportSecurityPersister::WriteState);
+  }
 }
 
 bool TransportSecurityPersister::SerializeData(std::string* output) {
   DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
 
-  base::DictionaryValue toplevel;
-
-  // TODO(davidben): Fix the serialization format by splitting the on-disk
-  // representation of the STS and PKP states. https://crbug.com/470295.
-  SerializeSTSData(transport_security_state_, &toplevel);
-  SerializePKPData(transport_security_state_, &toplevel);
-  SerializeExpectCTData(transport_security_state_, &toplevel);
-
-  base::JSONWriter::WriteWithOptions(
-      toplevel, base::JSONWriter::OPTIONS_PRETTY_PRINT, output);
+  *output = *EncodeSnapshot(TakeSnapshot(transport_security_state_));
   return true;
 }
 
@@ -488,6 +540,28 @@ bool TransportSecurityPersister::Deserialize(const std::string& serialized,
   return true;
 }
 
+void TransportSecurityPersister::WriteState() {
+  DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
+
+  // Encodings complete on |background_runner_| in the order they are posted,
+  // so the last state written is always the latest one.
+  ++encodes_in_flight_;
+  base::PostTaskAndReplyWithResult(
+      background_runner_.get(), FROM_HERE,
+      base::BindOnce(&EncodeSnapshot, TakeSnapshot(transport_security_state_)),
+      base::BindOnce(&TransportSecurityPersister::OnStateEncoded,
+                     weak_ptr_factory_.GetWeakPtr()));
+}
+
+void TransportSecurityPersister::OnStateEncoded(
+    std::unique_ptr<std::string> data) {
+  DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
+  DCHECK_GT(encodes_in_flight_, 0u);
+
+  --encodes_in_flight_;
+  writer_.WriteNow(std::move(data));
+}
+
 void TransportSecurityPersister::CompleteLoad(const std::string& state) {
   DCHECK(foreground_runner_->RunsTasksInCurrentSequence());
 
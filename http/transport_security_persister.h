@@ -33,6 +33,7 @@
 #ifndef NET_HTTP_TRANSPORT_SECURITY_PERSISTER_H_
 #define NET_HTTP_TRANSPORT_SECURITY_PERSISTER_H_
 
+#include <memory>
 #include <string>
 
 #include "base/files/file_path.h"
@@ -40,6 +41,7 @@
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "net/base/net_export.h"
 #include "net/http/transport_security_state.h"
 
@@ -64,7 +66,9 @@ class NET_EXPORT TransportSecurityPersister
       const scoped_refptr<base::SequencedTaskRunner>& background_runner);
   ~TransportSecurityPersister() override;
 
-  // Called by the TransportSecurityState when it changes its state.
+  // Called by the TransportSecurityState when it changes its state. The state
+  // is written after a delay, which coalesces bursts of changes; it is copied
+  // on the calling sequence but encoded on |background_runner_|.
   void StateIsDirty(TransportSecurityState*) override;
 
   // ImportantFileWriter::DataSerializer:
@@ -126,6 +130,11 @@ class NET_EXPORT TransportSecurityPersister
                           bool* dirty,
                           TransportSecurityState* state);
 
+  // Copies the state and posts its encoding to |background_runner_|.
+  void WriteState();
+  // Hands the encoded state |data| to |writer_|.
+  void OnStateEncoded(std::unique_ptr<std::string> data);
+
   void CompleteLoad(const std::string& state);
 
   TransportSecurityState* transport_security_state_;
@@ -136,6 +145,12 @@ class NET_EXPORT TransportSecurityPersister
   scoped_refptr<base::SequencedTaskRunner> foreground_runner_;
   scoped_refptr<base::SequencedTaskRunner> background_runner_;
 
+  // Runs while there is a write pending.
+  base::OneShotTimer write_timer_;
+  // The number of encodings posted to |background_runner_| that have not
+  // replied yet.
+  size_t encodes_in_flight_;
+
   base::WeakPtrFactory<TransportSecurityPersister> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(TransportSecurityPersister);
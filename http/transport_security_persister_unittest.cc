@@ -402,6 +402,29 @@ TEST_F(TransportSecurityPersisterTest, ExpectCTDisabled) {
       state_.GetDynamicExpectCTState(kTestDomain, &new_expect_ct_state));
 }
 
+// Tests that a write that is still pending when the persister is destroyed is
+// not lost, and that the written state is loaded by the next persister.
+TEST_F(TransportSecurityPersisterTest, PendingWriteOnDestruction) {
+  static const char kTestDomain[] = "example.test";
+  base::RunLoop().RunUntilIdle();
+
+  const base::Time expiry =
+      base::Time::Now() + base::TimeDelta::FromSeconds(1000);
+  state_.AddHSTS(kTestDomain, expiry, false /* include subdomains */);
+  persister_.reset();
+  base::RunLoop().RunUntilIdle();
+
+  TransportSecurityState new_state;
+  TransportSecurityPersister new_persister(
+      &new_state, temp_dir_.GetPath(), base::ThreadTaskRunnerHandle::Get());
+  base::RunLoop().RunUntilIdle();
+
+  TransportSecurityState::STSState sts_state;
+  EXPECT_TRUE(new_state.GetDynamicSTSState(kTestDomain, &sts_state));
+  EXPECT_EQ(TransportSecurityState::STSState::MODE_FORCE_HTTPS,
+            sts_state.upgrade_mode);
+}
+
 }  // namespace
 
 }  // namespace net
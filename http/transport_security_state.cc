@@ -10,6 +10,7 @@
 
 #include "base/base64.h"
 #include "base/build_time.h"
+#include "base/containers/mru_cache.h"
 #include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/metrics/histogram_functions.h"
@@ -58,6 +59,9 @@ const size_t kMaxReportCacheEntries = 50;
 const int kTimeToRememberReportsMins = 60;
 const size_t kReportCacheKeyLength = 16;
 
+// The number of hosts whose lookup in the preloaded data is remembered.
+const size_t kMaxPreloadCacheEntries = 64;
+
 // Override for CheckCTRequirements() for unit tests. Possible values:
 //  -1: Unless a delegate says otherwise, do not require CT.
 //   0: Use the default implementation (e.g. production)
@@ -739,6 +743,43 @@ bool SerializeExpectStapleReport(const HostPortPair& host_port_pair,
 
 }  // namespace
 
+// Remembers the results of the most recent lookups in the preloaded data, so
+// that looking up the same host again, e.g. for each subresource of a page,
+// does not decode the trie again.
+class TransportSecurityState::PreloadCache {
+ public:
+  PreloadCache() : source_(nullptr), results_(kMaxPreloadCacheEntries) {}
+
+  // Same as DecodeHSTSPreload().
+  bool Lookup(const std::string& hostname, PreloadResult* out) {
+    // The results are only valid for the source they were decoded from.
+    if (source_ != g_hsts_source) {
+      results_.Clear();
+      source_ = g_hsts_source;
+    }
+
+    auto it = results_.Get(hostname);
+    if (it == results_.end()) {
+      Entry entry;
+      entry.found = DecodeHSTSPreload(hostname, &entry.result);
+      it = results_.Put(hostname, entry);
+    }
+    *out = it->second.result;
+    return it->second.found;
+  }
+
+ private:
+  struct Entry {
+    bool found = false;
+    PreloadResult result;
+  };
+
+  const TransportSecurityStateSource* source_;
+  base::MRUCache<std::string, Entry> results_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadCache);
+};
+
 // static
 const base::Feature TransportSecurityState::kDynamicExpectCTFeature{
     "DynamicExpectCT", base::FEATURE_ENABLED_BY_DEFAULT};
@@ -754,7 +795,8 @@ TransportSecurityState::TransportSecurityState()
       enable_static_expect_staple_(true),
       enable_pkp_bypass_for_local_trust_anchors_(true),
       sent_hpkp_reports_cache_(kMaxReportCacheEntries),
-      sent_expect_ct_reports_cache_(kMaxReportCacheEntries) {
+      sent_expect_ct_reports_cache_(kMaxReportCacheEntries),
+      preload_cache_(std::make_unique<PreloadCache>()) {
 // Static pinning is only enabled for official builds to make sure that
 // others don't end up with pins that cannot be easily updated.
 #if !defined(GOOGLE_CHROME_BUILD) || defined(OS_ANDROID) || defined(OS_IOS)
@@ -1196,7 +1238,7 @@ bool TransportSecurityState::GetStaticExpectCTState(
     return false;
 
   PreloadResult result;
-  if (!DecodeHSTSPreload(host, &result))
+  if (!preload_cache_->Lookup(host, &result))
     return false;
 
   if (!enable_static_expect_ct_ || !result.expect_ct)
@@ -1245,7 +1287,7 @@ bool TransportSecurityState::GetStaticExpectStapleState(
     return false;
 
   PreloadResult result;
-  if (!DecodeHSTSPreload(host, &result))
+  if (!preload_cache_->Lookup(host, &result))
     return false;
 
   if (!enable_static_expect_staple_ || !result.expect_staple)
@@ -1597,7 +1639,7 @@ bool TransportSecurityState::GetStaticDomainState(const std::string& host,
     return false;
 
   PreloadResult result;
-  if (!DecodeHSTSPreload(host, &result))
+  if (!preload_cache_->Lookup(host, &result))
     return false;
 
   sts_state->domain = host.substr(result.hostname_offset);
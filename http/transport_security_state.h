@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "base/callback.h"
@@ -593,6 +594,8 @@ class NET_EXPORT TransportSecurityState {
                         std::less<base::TimeTicks>>
       ReportCache;
 
+  class PreloadCache;
+
   // IsBuildTimely returns true if the current build is new enough ensure that
   // built in security information (i.e. HSTS preloading and pinning
   // information) is timely.
@@ -714,6 +717,10 @@ class NET_EXPORT TransportSecurityState {
   ReportCache sent_hpkp_reports_cache_;
   ReportCache sent_expect_ct_reports_cache_;
 
+  // Results of the most recent lookups in the preloaded data. Looking up a
+  // host updates it, so it is used from const methods.
+  std::unique_ptr<PreloadCache> preload_cache_;
+
   THREAD_CHECKER(thread_checker_);
 
   DISALLOW_COPY_AND_ASSIGN(TransportSecurityState);
@@ -1766,6 +1766,29 @@ TEST_F(TransportSecurityStateTest, DecodePreloadedSingle) {
   EXPECT_FALSE(GetExpectStapleState(&state, "hsts.example.com", &staple_state));
 }
 
+// Tests that repeated lookups of a host in the preloaded data return the same
+// state, and that changing the preloaded data is reflected in later lookups.
+TEST_F(TransportSecurityStateTest, DecodePreloadedRepeatedLookups) {
+  SetTransportSecurityStateSourceForTesting(&test1::kHSTSSource);
+
+  TransportSecurityState state;
+  TransportSecurityState::STSState sts_state;
+  TransportSecurityState::PKPState pkp_state;
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(GetStaticDomainState(&state, "hsts.example.com", &sts_state,
+                                     &pkp_state));
+    EXPECT_TRUE(sts_state.include_subdomains);
+    EXPECT_FALSE(GetStaticDomainState(&state, "example.com", &sts_state,
+                                      &pkp_state));
+  }
+
+  // test2 has an entry for hsts.example.com without include_subdomains.
+  SetTransportSecurityStateSourceForTesting(&test2::kHSTSSource);
+  EXPECT_TRUE(
+      GetStaticDomainState(&state, "hsts.example.com", &sts_state, &pkp_state));
+  EXPECT_FALSE(sts_state.include_subdomains);
+}
+
 // More advanced test for the HSTS preload process where the trie (generated
 // from transport_security_state_static_unittest2.json) contains multiple
 // entries with a common prefix. Test that the lookup methods can find all
@@ -76,17 +76,47 @@ class HTTP2_EXPORT_PRIVATE DecodeBuffer {
     return *cursor_++;
   }
 
-  uint8_t DecodeUInt8();
-  uint16_t DecodeUInt16();
-  uint32_t DecodeUInt24();
+  uint8_t DecodeUInt8() { return static_cast<uint8_t>(DecodeChar()); }
+
+  uint16_t DecodeUInt16() {
+    DCHECK_LE(2u, Remaining());
+    const uint8_t b1 = DecodeUInt8();
+    const uint8_t b2 = DecodeUInt8();
+    // Note that chars are automatically promoted to ints during arithmetic,
+    // so the b1 << 8 doesn't end up as zero before being or-ed with b2.
+    // And the left-shift operator has higher precedence than the or operator.
+    return b1 << 8 | b2;
+  }
+
+  uint32_t DecodeUInt24() {
+    DCHECK_LE(3u, Remaining());
+    const uint8_t b1 = DecodeUInt8();
+    const uint8_t b2 = DecodeUInt8();
+    const uint8_t b3 = DecodeUInt8();
+    return b1 << 16 | b2 << 8 | b3;
+  }
 
   // For 31-bit unsigned integers, where the 32nd bit is reserved for future
   // use (i.e. the high-bit of the first byte of the encoding); examples:
   // the Stream Id in a frame header or the Window Size Increment in a
   // WINDOW_UPDATE frame.
-  uint32_t DecodeUInt31();
+  uint32_t DecodeUInt31() {
+    DCHECK_LE(4u, Remaining());
+    const uint8_t b1 = DecodeUInt8() & 0x7f;  // Mask out the high order bit.
+    const uint8_t b2 = DecodeUInt8();
+    const uint8_t b3 = DecodeUInt8();
+    const uint8_t b4 = DecodeUInt8();
+    return b1 << 24 | b2 << 16 | b3 << 8 | b4;
+  }
 
-  uint32_t DecodeUInt32();
+  uint32_t DecodeUInt32() {
+    DCHECK_LE(4u, Remaining());
+    const uint8_t b1 = DecodeUInt8();
+    const uint8_t b2 = DecodeUInt8();
+    const uint8_t b3 = DecodeUInt8();
+    const uint8_t b4 = DecodeUInt8();
+    return b1 << 24 | b2 << 16 | b3 << 8 | b4;
+  }
 
  protected:
 #ifndef NDEBUG
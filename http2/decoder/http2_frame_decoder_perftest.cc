@@ -0,0 +1,105 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http2/decoder/http2_frame_decoder.h"
+
+#include <algorithm>
+
+#include "base/test/perf_time_logger.h"
+#include "net/http2/decoder/decode_buffer.h"
+#include "net/http2/decoder/decode_status.h"
+#include "net/http2/decoder/http2_frame_decoder_listener.h"
+#include "net/http2/http2_constants.h"
+#include "net/http2/http2_structures.h"
+#include "net/http2/platform/api/http2_string.h"
+#include "net/http2/tools/http2_frame_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kIterations = 20000;
+
+// Frames of the kinds exchanged most often on a busy connection.
+Http2String BuildFrames() {
+  Http2String frames;
+
+  Http2FrameBuilder data(Http2FrameType::DATA, 0, 1);
+  data.Append(Http2String(1024, 'x'));
+  data.SetPayloadLength();
+  frames += data.buffer();
+
+  Http2FrameBuilder window_update(Http2FrameType::WINDOW_UPDATE, 0, 1);
+  window_update.Append(Http2WindowUpdateFields{1024});
+  window_update.SetPayloadLength();
+  frames += window_update.buffer();
+
+  Http2FrameBuilder priority(Http2FrameType::PRIORITY, 0, 3);
+  priority.Append(Http2PriorityFields(1, 16, false));
+  priority.SetPayloadLength();
+  frames += priority.buffer();
+
+  Http2FrameBuilder rst_stream(Http2FrameType::RST_STREAM, 0, 3);
+  rst_stream.Append(Http2RstStreamFields{Http2ErrorCode::CANCEL});
+  rst_stream.SetPayloadLength();
+  frames += rst_stream.buffer();
+
+  Http2FrameBuilder ping(Http2FrameType::PING, 0, 0);
+  ping.Append(Http2PingFields{{1, 2, 3, 4, 5, 6, 7, 8}});
+  ping.SetPayloadLength();
+  frames += ping.buffer();
+
+  Http2FrameBuilder settings(Http2FrameType::SETTINGS, 0, 0);
+  settings.Append(
+      Http2SettingFields(Http2SettingsParameter::INITIAL_WINDOW_SIZE, 65535));
+  settings.Append(
+      Http2SettingFields(Http2SettingsParameter::MAX_CONCURRENT_STREAMS, 100));
+  settings.SetPayloadLength();
+  frames += settings.buffer();
+
+  return frames;
+}
+
+class Http2FrameDecoderPerfTest : public ::testing::Test {
+ protected:
+  Http2FrameDecoderPerfTest() : frames_(BuildFrames()) {}
+
+  // Decodes |frames_| |kIterations| times, passing the decoder at most
+  // |max_slice_size| bytes at a time.
+  void Benchmark(const char* name, size_t max_slice_size) {
+    Http2FrameDecoderNoOpListener listener;
+    Http2FrameDecoder decoder(&listener);
+    base::PerfTimeLogger timer(name);
+    for (int i = 0; i < kIterations; ++i) {
+      size_t offset = 0;
+      while (offset < frames_.size()) {
+        size_t slice_size = std::min(max_slice_size, frames_.size() - offset);
+        DecodeBuffer db(frames_.data() + offset, slice_size);
+        while (db.HasData()) {
+          DecodeStatus status = decoder.DecodeFrame(&db);
+          ASSERT_NE(DecodeStatus::kDecodeError, status);
+        }
+        offset += slice_size;
+      }
+    }
+    timer.Done();
+  }
+
+  const Http2String frames_;
+};
+
+// Exercises the paths for frames which are entirely in the buffer.
+TEST_F(Http2FrameDecoderPerfTest, CompleteFrames) {
+  Benchmark("Http2FrameDecoder_complete_frames", frames_.size());
+}
+
+// Exercises the paths which resume decoding frames split across buffers.
+TEST_F(Http2FrameDecoderPerfTest, SplitFrames) {
+  Benchmark("Http2FrameDecoder_split_frames", 3);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "net/http2/decoder/decode_buffer.h"
+#include "net/http2/decoder/decode_http2_structures.h"
 #include "net/http2/decoder/http2_frame_decoder_listener.h"
 #include "net/http2/http2_constants.h"
 #include "net/http2/http2_structures.h"
@@ -21,6 +22,16 @@ DecodeStatus PriorityPayloadDecoder::StartDecodingPayload(
   DCHECK_LE(db->Remaining(), state->frame_header().payload_length);
   // PRIORITY frames have no flags.
   DCHECK_EQ(0, state->frame_header().flags);
+
+  // Special case for when the payload is the correct size and entirely in
+  // the buffer.
+  const Http2FrameHeader& frame_header = state->frame_header();
+  if (db->Remaining() == Http2PriorityFields::EncodedSize() &&
+      frame_header.payload_length == Http2PriorityFields::EncodedSize()) {
+    DoDecode(&priority_fields_, db);
+    state->listener()->OnPriorityFrame(frame_header, priority_fields_);
+    return DecodeStatus::kDecodeDone;
+  }
   state->InitializeRemainders();
   return HandleStatus(
       state, state->StartDecodingStructureInPayload(&priority_fields_, db));
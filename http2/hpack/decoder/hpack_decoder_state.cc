@@ -4,6 +4,8 @@
 
 #include "net/http2/hpack/decoder/hpack_decoder_state.h"
 
+#include <utility>
+
 #include "base/logging.h"
 #include "net/http2/hpack/hpack_string.h"
 #include "net/http2/http2_constants.h"
@@ -117,7 +119,9 @@ void HpackDecoderState::OnNameIndexAndLiteralValue(
     HpackString value(ExtractHpackString(value_buffer));
     listener_->OnHeader(entry_type, entry->name, value);
     if (entry_type == HpackEntryType::kIndexedLiteralHeader) {
-      decoder_tables_.Insert(entry->name, value);
+      // |entry| may be evicted by the insertion, so its name is copied into
+      // the argument before the table changes.
+      decoder_tables_.Insert(entry->name, std::move(value));
     }
   } else {
     ReportError("Invalid name index.");
@@ -142,7 +146,7 @@ void HpackDecoderState::OnLiteralNameAndValue(
   HpackString value(ExtractHpackString(value_buffer));
   listener_->OnHeader(entry_type, name, value);
   if (entry_type == HpackEntryType::kIndexedLiteralHeader) {
-    decoder_tables_.Insert(name, value);
+    decoder_tables_.Insert(std::move(name), std::move(value));
   }
 }
 
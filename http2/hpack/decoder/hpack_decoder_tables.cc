@@ -4,6 +4,8 @@
 
 #include "net/http2/hpack/decoder/hpack_decoder_tables.h"
 
+#include <utility>
+
 #include "base/logging.h"
 
 namespace net {
@@ -50,9 +52,9 @@ const HpackStringPair* HpackDecoderStaticTable::Lookup(size_t index) const {
 }
 
 HpackDecoderDynamicTable::HpackDecoderTableEntry::HpackDecoderTableEntry(
-    const HpackString& name,
-    const HpackString& value)
-    : HpackStringPair(name, value) {}
+    HpackString name,
+    HpackString value)
+    : HpackStringPair(std::move(name), std::move(value)) {}
 
 HpackDecoderDynamicTable::HpackDecoderDynamicTable()
     : insert_count_(kFirstDynamicTableIndex - 1), debug_listener_(nullptr) {}
@@ -67,12 +69,11 @@ void HpackDecoderDynamicTable::DynamicTableSizeUpdate(size_t size_limit) {
 
 // TODO(jamessynge): Check somewhere before here that names received from the
 // peer are valid (e.g. are lower-case, no whitespace, etc.).
-bool HpackDecoderDynamicTable::Insert(const HpackString& name,
-                                      const HpackString& value) {
-  HpackDecoderTableEntry entry(name, value);
+bool HpackDecoderDynamicTable::Insert(HpackString name, HpackString value) {
+  HpackDecoderTableEntry entry(std::move(name), std::move(value));
   size_t entry_size = entry.size();
-  DVLOG(2) << "InsertEntry of size=" << entry_size << "\n     name: " << name
-           << "\n    value: " << value;
+  DVLOG(2) << "InsertEntry of size=" << entry_size
+           << "\n     name: " << entry.name << "\n    value: " << entry.value;
   if (entry_size > size_limit_) {
     DVLOG(2) << "InsertEntry: entry larger than table, removing "
              << table_.size() << " entries, of total size " << current_size_
@@ -89,7 +90,7 @@ bool HpackDecoderDynamicTable::Insert(const HpackString& name,
   }
   size_t insert_limit = size_limit_ - entry_size;
   EnsureSizeNoMoreThan(insert_limit);
-  table_.push_front(entry);
+  table_.push_front(std::move(entry));
   current_size_ += entry_size;
   DVLOG(2) << "InsertEntry: current_size_=" << current_size_;
   DCHECK_GE(current_size_, entry_size);
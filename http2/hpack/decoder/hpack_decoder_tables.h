@@ -18,6 +18,7 @@
 
 #include <stddef.h>
 
+#include <utility>
 #include <vector>
 
 #include "base/containers/circular_deque.h"
@@ -105,8 +106,9 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderDynamicTable {
   void DynamicTableSizeUpdate(size_t size_limit);
 
   // Returns true if inserted, false if too large (at which point the
-  // dynamic table will be empty.)
-  bool Insert(const HpackString& name, const HpackString& value);
+  // dynamic table will be empty.) The strings are moved into the new entry,
+  // so callers done with them should std::move them in.
+  bool Insert(HpackString name, HpackString value);
 
   // If index is valid, returns a pointer to the entry, otherwise returns
   // nullptr.
@@ -118,7 +120,7 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderDynamicTable {
  private:
   friend class test::HpackDecoderTablesPeer;
   struct HpackDecoderTableEntry : public HpackStringPair {
-    HpackDecoderTableEntry(const HpackString& name, const HpackString& value);
+    HpackDecoderTableEntry(HpackString name, HpackString value);
     int64_t time_added;
   };
 
@@ -163,11 +165,9 @@ class HTTP2_EXPORT_PRIVATE HpackDecoderTables {
   }
 
   // Returns true if inserted, false if too large (at which point the
-  // dynamic table will be empty.)
-  // TODO(jamessynge): Add methods for moving the string(s) into the table,
-  // or for otherwise avoiding unnecessary copies.
-  bool Insert(const HpackString& name, const HpackString& value) {
-    return dynamic_table_.Insert(name, value);
+  // dynamic table will be empty.) The strings are moved into the new entry.
+  bool Insert(HpackString name, HpackString value) {
+    return dynamic_table_.Insert(std::move(name), std::move(value));
   }
 
   // If index is valid, returns a pointer to the entry, otherwise returns
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "base/logging.h"
@@ -259,6 +260,25 @@ TEST_F(HpackDecoderTablesTest, RandomDynamicTable) {
   }
 }
 
+// Confirm that Insert moves the strings into the table, rather than copying
+// them, by checking that the entry uses the inserted strings' buffers.
+TEST(HpackDecoderDynamicTableTest, InsertMovesStrings) {
+  // Long enough to not fit in the inline buffer of a short string.
+  HpackString name(Http2String(100, 'n'));
+  HpackString value(Http2String(200, 'v'));
+  const char* name_data = name.ToString().data();
+  const char* value_data = value.ToString().data();
+
+  HpackDecoderTables tables;
+  ASSERT_TRUE(tables.Insert(std::move(name), std::move(value)));
+  const HpackStringPair* entry = tables.Lookup(kFirstDynamicTableIndex);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(Http2String(100, 'n'), entry->name.ToString());
+  EXPECT_EQ(name_data, entry->name.ToString().data());
+  EXPECT_EQ(Http2String(200, 'v'), entry->value.ToString());
+  EXPECT_EQ(value_data, entry->value.ToString().data());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
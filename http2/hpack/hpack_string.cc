@@ -44,9 +44,8 @@ std::ostream& operator<<(std::ostream& out, const HpackString& v) {
   return out << v.ToString();
 }
 
-HpackStringPair::HpackStringPair(const HpackString& name,
-                                 const HpackString& value)
-    : name(name), value(value) {
+HpackStringPair::HpackStringPair(HpackString name, HpackString value)
+    : name(std::move(name)), value(std::move(value)) {
   DVLOG(3) << DebugString() << " ctor";
 }
 
@@ -55,6 +54,12 @@ HpackStringPair::HpackStringPair(Http2StringPiece name, Http2StringPiece value)
   DVLOG(3) << DebugString() << " ctor";
 }
 
+HpackStringPair::HpackStringPair(const HpackStringPair& other) = default;
+HpackStringPair::HpackStringPair(HpackStringPair&& other) = default;
+HpackStringPair& HpackStringPair::operator=(const HpackStringPair& other) =
+    default;
+HpackStringPair& HpackStringPair::operator=(HpackStringPair&& other) = default;
+
 HpackStringPair::~HpackStringPair() {
   DVLOG(3) << DebugString() << " dtor";
 }
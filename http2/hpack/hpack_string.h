@@ -31,6 +31,7 @@ class HTTP2_EXPORT_PRIVATE HpackString {
   HpackString(HpackString&& other) = default;
 
   HpackString& operator=(const HpackString& other) = default;
+  HpackString& operator=(HpackString&& other) = default;
 
   ~HpackString();
 
@@ -55,8 +56,14 @@ HTTP2_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& out,
                                               const HpackString& v);
 
 struct HTTP2_EXPORT_PRIVATE HpackStringPair {
-  HpackStringPair(const HpackString& name, const HpackString& value);
+  HpackStringPair(HpackString name, HpackString value);
   HpackStringPair(Http2StringPiece name, Http2StringPiece value);
+  HpackStringPair(const HpackStringPair& other);
+  // Declared so that the dynamic table can move entries without copying their
+  // strings; the user-declared destructor would otherwise suppress them.
+  HpackStringPair(HpackStringPair&& other);
+  HpackStringPair& operator=(const HpackStringPair& other);
+  HpackStringPair& operator=(HpackStringPair&& other);
   ~HpackStringPair();
 
   // Returns the size of a header entry with this name and value, per the RFC:
@@ -8,6 +8,7 @@
 #include <limits>
 
 #include "base/logging.h"
+#include "base/macros.h"
 
 // Terminology:
 //
@@ -345,6 +346,66 @@ struct ShortCodeInfo {
     {0x7a, 7},  // Match: 0b1111011, Symbol: z
 };
 
+// The number of leading bits of the bit buffer used to index the
+// MultiSymbolTable. Two of the shortest (5 bit) codes fit in 10 bits, and
+// most pairs of the 5, 6 and 7 bit codes fit in 12 bits; a third symbol would
+// need a table of at least 15 bits, which is too large to stay in the L1 cache.
+constexpr HuffmanAccumulatorBitCount kMultiSymbolTableBits = 12;
+constexpr size_t kMultiSymbolTableSize = 1 << kMultiSymbolTableBits;
+constexpr size_t kMaxSymbolsPerLookup = 2;
+
+// Decodes as many whole codes as fit in the leading kMultiSymbolTableBits of
+// the bit buffer with a single lookup. An entry with a |count| of zero means
+// that the first code is longer than kMultiSymbolTableBits, and must be
+// decoded with PrefixToInfo.
+struct MultiSymbolInfo {
+  uint8_t symbols[kMaxSymbolsPerLookup];
+  uint8_t count;   // Number of symbols decoded.
+  uint8_t length;  // Sum of the lengths of the codes of those symbols.
+};
+
+class MultiSymbolTable {
+ public:
+  MultiSymbolTable() {
+    for (size_t index = 0; index < kMultiSymbolTableSize; ++index) {
+      MultiSymbolInfo& info = entries_[index];
+      info.count = 0;
+      info.length = 0;
+      // The bits of |index|, left justified in a HuffmanCode, followed by
+      // zeros. The zeros never complete a code, as they are only examined for
+      // codes which don't fit in the bits of |index|, which are discarded.
+      HuffmanCode bits = static_cast<HuffmanCode>(index)
+                         << (kHuffmanCodeBitCount - kMultiSymbolTableBits);
+      while (info.count < kMaxSymbolsPerLookup) {
+        PrefixInfo prefix_info = PrefixToInfo(bits);
+        if (info.length + prefix_info.code_length > kMultiSymbolTableBits) {
+          break;
+        }
+        uint32_t canonical = prefix_info.DecodeToCanonical(bits);
+        DCHECK_LT(canonical, 256u);
+        info.symbols[info.count++] = kCanonicalToSymbol[canonical];
+        info.length += prefix_info.code_length;
+        bits <<= prefix_info.code_length;
+      }
+    }
+  }
+
+  const MultiSymbolInfo& Lookup(size_t index) const {
+    DCHECK_LT(index, kMultiSymbolTableSize);
+    return entries_[index];
+  }
+
+ private:
+  MultiSymbolInfo entries_[kMultiSymbolTableSize];
+
+  DISALLOW_COPY_AND_ASSIGN(MultiSymbolTable);
+};
+
+const MultiSymbolTable& GetMultiSymbolTable() {
+  static const MultiSymbolTable* const table = new MultiSymbolTable();
+  return *table;
+}
+
 }  // namespace
 
 HuffmanBitBuffer::HuffmanBitBuffer() {
@@ -415,7 +476,7 @@ HpackHuffmanDecoder::HpackHuffmanDecoder() = default;
 HpackHuffmanDecoder::~HpackHuffmanDecoder() = default;
 
 bool HpackHuffmanDecoder::Decode(Http2StringPiece input, Http2String* output) {
-  return DecodeShortCodesFirst(input, output);
+  return DecodeWithMultiSymbolTable(input, output);
 }
 
 // "Legacy" decoder, used until cl/129771019 submitted, which added
@@ -532,6 +593,89 @@ bool HpackHuffmanDecoder::DecodeShortCodesFirst(Http2StringPiece input,
   }
 }
 
+bool HpackHuffmanDecoder::DecodeWithMultiSymbolTable(Http2StringPiece input,
+                                                     Http2String* output) {
+  DVLOG(1) << "HpackHuffmanDecoder::DecodeWithMultiSymbolTable";
+  const MultiSymbolTable& table = GetMultiSymbolTable();
+
+  // Make room for the most symbols that the input could decode to, plus room
+  // for the unused symbol of a lookup that decodes fewer than the maximum, so
+  // that symbols can be stored without checking the capacity of |output|.
+  // |output| is trimmed to the symbols actually decoded before returning.
+  const size_t output_size = output->size();
+  output->resize(output_size +
+                 (bit_buffer_.count() + input.size() * 8) / kMinCodeBitCount +
+                 kMaxSymbolsPerLookup - 1);
+  char* const output_start = &(*output)[0];
+  char* out = output_start + output_size;
+
+  // Fill bit_buffer_ from input.
+  input.remove_prefix(bit_buffer_.AppendBytes(input));
+
+  bool result = true;
+  while (true) {
+    DVLOG(3) << "Enter Decode Loop, bit_buffer_: " << bit_buffer_;
+    if (bit_buffer_.count() >= kMultiSymbolTableBits) {
+      // Decode all of the codes in the high bits of the bit buffer at once.
+      const MultiSymbolInfo& info = table.Lookup(
+          bit_buffer_.value() >>
+          (kHuffmanAccumulatorBitCount - kMultiSymbolTableBits));
+      if (info.count > 0) {
+        out[0] = static_cast<char>(info.symbols[0]);
+        out[1] = static_cast<char>(info.symbols[1]);
+        out += info.count;
+        bit_buffer_.ConsumeBits(info.length);
+        continue;
+      }
+      // The code is longer than kMultiSymbolTableBits. Use PrefixToInfo, etc.
+      // to decode it.
+    } else {
+      // We may have (mostly) drained bit_buffer_. If we can top it up, try
+      // using the table decoder above.
+      size_t byte_count = bit_buffer_.AppendBytes(input);
+      if (byte_count > 0) {
+        input.remove_prefix(byte_count);
+        continue;
+      }
+    }
+
+    HuffmanCode code_prefix = bit_buffer_.value() >> kExtraAccumulatorBitCount;
+    DVLOG(3) << "code_prefix: " << HuffmanCodeBitSet(code_prefix);
+
+    PrefixInfo prefix_info = PrefixToInfo(code_prefix);
+    DVLOG(3) << "prefix_info: " << prefix_info;
+    DCHECK_LE(kMinCodeBitCount, prefix_info.code_length);
+    DCHECK_LE(prefix_info.code_length, kMaxCodeBitCount);
+
+    if (prefix_info.code_length <= bit_buffer_.count()) {
+      // We have enough bits for one code.
+      uint32_t canonical = prefix_info.DecodeToCanonical(code_prefix);
+      if (canonical < 256) {
+        // Valid code.
+        *out++ = kCanonicalToSymbol[canonical];
+        bit_buffer_.ConsumeBits(prefix_info.code_length);
+        continue;
+      }
+      // Encoder is not supposed to explicity encode the EOS symbol.
+      DLOG(ERROR) << "EOS explicitly encoded!\n " << bit_buffer_ << "\n "
+                  << prefix_info;
+      result = false;
+      break;
+    }
+    // bit_buffer_ doesn't have enough bits in it to decode the next symbol.
+    // Append to it as many bytes as are available AND fit.
+    size_t byte_count = bit_buffer_.AppendBytes(input);
+    if (byte_count == 0) {
+      DCHECK_EQ(input.size(), 0u);
+      break;
+    }
+    input.remove_prefix(byte_count);
+  }
+  DCHECK_LE(static_cast<size_t>(out - output_start), output->size());
+  output->resize(out - output_start);
+  return result;
+}
+
 Http2String HpackHuffmanDecoder::DebugString() const {
   return bit_buffer_.DebugString();
 }
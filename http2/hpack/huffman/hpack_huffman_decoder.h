@@ -133,6 +133,12 @@ class HTTP2_EXPORT_PRIVATE HpackHuffmanDecoder {
   // TODO(jamessynge): Be precise about that fraction.
   bool DecodeShortCodesFirst(Http2StringPiece input, Http2String* output);
 
+  // Based on DecodeShortCodesFirst, but looks up the leading 12 bits of the
+  // bit buffer in a table which yields all of the codes (up to two) that are
+  // complete within those bits, so that pairs of common symbols are decoded
+  // with a single lookup. This is the implementation used by Decode.
+  bool DecodeWithMultiSymbolTable(Http2StringPiece input, Http2String* output);
+
  private:
   HuffmanBitBuffer bit_buffer_;
 };
@@ -0,0 +1,111 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http2/hpack/huffman/hpack_huffman_decoder.h"
+
+#include <vector>
+
+#include "base/test/perf_time_logger.h"
+#include "net/http2/platform/api/http2_string.h"
+#include "net/spdy/core/hpack/hpack_constants.h"
+#include "net/spdy/core/hpack/hpack_huffman_table.h"
+#include "net/spdy/core/hpack/hpack_output_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kIterations = 20000;
+
+// Header values of the kinds that dominate the cost of Huffman coding.
+const char* const kHeaderValues[] = {
+    "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, "
+    "like Gecko) Chrome/64.0.3282.140 Safari/537.36",
+    "Mozilla/5.0 (Linux; Android 8.0.0; Pixel 2 Build/OPD3.170816.012) "
+    "AppleWebKit/537.36 (KHTML, like Gecko) Chrome/64.0.3282.137 Mobile "
+    "Safari/537.36",
+    "_ga=GA1.2.1234567890.1517410000; _gid=GA1.2.987654321.1518000000; "
+    "NID=123=aBcDeFgHiJkLmNoPqRsTuVwXyZ0123456789-_aBcDeFgHiJkLmNoPqRsTuVw; "
+    "SID=XyZ0123456789aBcDeFgHiJkLmNoPqRsTuVw.; session_id=3f9a1c2b7d",
+    "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1",
+    "text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,"
+    "image/apng,*/*;q=0.8",
+    "gzip, deflate, br",
+    "en-US,en;q=0.9",
+    "https://www.example.com/search?q=hpack+huffman&oq=hpack&sourceid=chrome",
+    "max-age=31536000; includeSubDomains; preload",
+    "Mon, 21 Oct 2013 20:13:21 GMT",
+};
+
+std::vector<Http2String> EncodeHeaderValues() {
+  std::vector<Http2String> encoded;
+  for (const char* value : kHeaderValues) {
+    HpackOutputStream output_stream;
+    ObtainHpackHuffmanTable().EncodeString(value, &output_stream);
+    Http2String result;
+    output_stream.TakeString(&result);
+    encoded.push_back(result);
+  }
+  return encoded;
+}
+
+class HpackHuffmanDecoderPerfTest : public ::testing::Test {
+ protected:
+  typedef bool (HpackHuffmanDecoder::*DecodeMethod)(Http2StringPiece,
+                                                    Http2String*);
+
+  HpackHuffmanDecoderPerfTest() : encoded_(EncodeHeaderValues()) {}
+
+  void Benchmark(const char* name, DecodeMethod decode) {
+    HpackHuffmanDecoder decoder;
+    Http2String output;
+    base::PerfTimeLogger timer(name);
+    for (int i = 0; i < kIterations; ++i) {
+      for (size_t j = 0; j < encoded_.size(); ++j) {
+        output.clear();
+        decoder.Reset();
+        ASSERT_TRUE((decoder.*decode)(encoded_[j], &output));
+        ASSERT_TRUE(decoder.InputProperlyTerminated());
+        ASSERT_EQ(kHeaderValues[j], output);
+      }
+    }
+    timer.Done();
+  }
+
+  const std::vector<Http2String> encoded_;
+};
+
+TEST_F(HpackHuffmanDecoderPerfTest, IfTreeAndStruct) {
+  Benchmark("Huffman_decode_if_tree",
+            &HpackHuffmanDecoder::DecodeWithIfTreeAndStruct);
+}
+
+TEST_F(HpackHuffmanDecoderPerfTest, ShortCodesFirst) {
+  Benchmark("Huffman_decode_short_codes_first",
+            &HpackHuffmanDecoder::DecodeShortCodesFirst);
+}
+
+TEST_F(HpackHuffmanDecoderPerfTest, MultiSymbolTable) {
+  Benchmark("Huffman_decode_multi_symbol",
+            &HpackHuffmanDecoder::DecodeWithMultiSymbolTable);
+}
+
+TEST_F(HpackHuffmanDecoderPerfTest, Encode) {
+  const HpackHuffmanTable& table = ObtainHpackHuffmanTable();
+  HpackOutputStream output_stream;
+  Http2String output;
+  base::PerfTimeLogger timer("Huffman_encode");
+  for (int i = 0; i < kIterations; ++i) {
+    for (const char* value : kHeaderValues) {
+      table.EncodeString(value, &output_stream);
+      output_stream.TakeString(&output);
+    }
+  }
+  timer.Done();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -13,6 +13,7 @@
 #include "net/http2/decoder/decode_status.h"
 #include "net/http2/platform/api/http2_string_utils.h"
 #include "net/http2/tools/failure.h"
+#include "net/http2/tools/http2_random.h"
 #include "net/http2/tools/random_decoder_test.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -143,7 +144,7 @@ TEST(HuffmanBitBufferTest, AppendBytesUnaligned) {
                                   << "\n expected: " << expected;
 }
 
-enum class DecoderChoice { IF_TREE, SHORT_CODE };
+enum class DecoderChoice { IF_TREE, SHORT_CODE, MULTI_SYMBOL };
 
 class HpackHuffmanDecoderTest
     : public RandomDecoderTest,
@@ -189,6 +190,8 @@ class HpackHuffmanDecoderTest
         return decoder_.DecodeWithIfTreeAndStruct(sp, &output_buffer_);
       case DecoderChoice::SHORT_CODE:
         return decoder_.DecodeShortCodesFirst(sp, &output_buffer_);
+      case DecoderChoice::MULTI_SYMBOL:
+        return decoder_.DecodeWithMultiSymbolTable(sp, &output_buffer_);
     }
 
     NOTREACHED();
@@ -203,7 +206,8 @@ class HpackHuffmanDecoderTest
 INSTANTIATE_TEST_CASE_P(AllDecoders,
                         HpackHuffmanDecoderTest,
                         ::testing::Values(DecoderChoice::IF_TREE,
-                                          DecoderChoice::SHORT_CODE));
+                                          DecoderChoice::SHORT_CODE,
+                                          DecoderChoice::MULTI_SYMBOL));
 
 TEST_P(HpackHuffmanDecoderTest, SpecRequestExamples) {
   HpackHuffmanDecoder decoder;
@@ -259,6 +263,53 @@ TEST_P(HpackHuffmanDecoderTest, SpecResponseExamples) {
   }
 }
 
+// Decodes random bytes, split at a random point, with each of the decoders,
+// and verifies that they agree on whether the input is valid, on the output,
+// and on whether it is properly terminated.
+TEST(HpackHuffmanDecoderFuzzTest, DecodersAgreeOnRandomInput) {
+  Http2Random random;
+  for (int i = 0; i < 10000; ++i) {
+    Http2String input = random.RandString(random.Rand8() % 64);
+    size_t split = input.empty() ? 0 : random.Rand8() % (input.size() + 1);
+    Http2StringPiece first(input.data(), split);
+    Http2StringPiece second(input.data() + split, input.size() - split);
+    Http2String hex = Http2HexEncode(input.data(), input.size());
+
+    HpackHuffmanDecoder if_tree_decoder;
+    Http2String if_tree_output;
+    bool if_tree_result =
+        if_tree_decoder.DecodeWithIfTreeAndStruct(first, &if_tree_output) &&
+        if_tree_decoder.DecodeWithIfTreeAndStruct(second, &if_tree_output);
+
+    HpackHuffmanDecoder short_code_decoder;
+    Http2String short_code_output;
+    bool short_code_result =
+        short_code_decoder.DecodeShortCodesFirst(first, &short_code_output) &&
+        short_code_decoder.DecodeShortCodesFirst(second, &short_code_output);
+
+    HpackHuffmanDecoder multi_symbol_decoder;
+    Http2String multi_symbol_output;
+    bool multi_symbol_result =
+        multi_symbol_decoder.DecodeWithMultiSymbolTable(
+            first, &multi_symbol_output) &&
+        multi_symbol_decoder.DecodeWithMultiSymbolTable(
+            second, &multi_symbol_output);
+
+    ASSERT_EQ(if_tree_result, short_code_result) << hex;
+    ASSERT_EQ(if_tree_result, multi_symbol_result) << hex;
+    if (if_tree_result) {
+      ASSERT_EQ(if_tree_output, short_code_output) << hex;
+      ASSERT_EQ(if_tree_output, multi_symbol_output) << hex;
+      ASSERT_EQ(if_tree_decoder.InputProperlyTerminated(),
+                short_code_decoder.InputProperlyTerminated())
+          << hex;
+      ASSERT_EQ(if_tree_decoder.InputProperlyTerminated(),
+                multi_symbol_decoder.InputProperlyTerminated())
+          << hex;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
@@ -100,7 +100,7 @@ void AppendToFileThenDelete(const base::FilePath& source_path,
 namespace net {
 
 // Used to store events to be written to file.
-using EventQueue = base::queue<std::unique_ptr<std::string>>;
+using EventQueue = base::queue<std::string>;
 
 // WriteQueue receives events from FileNetLogObserver on the main thread and
 // holds them in a queue until they are drained from the queue and written to
@@ -125,7 +125,7 @@ class FileNetLogObserver::WriteQueue
   // being written to file.
   //
   // Returns the number of events in the |queue_|.
-  size_t AddEntryToQueue(std::unique_ptr<std::string> event);
+  size_t AddEntryToQueue(std::string event);
 
   // Swaps |queue_| with |local_queue|. |local_queue| should be empty, so that
   // |queue_| is emptied. Resets |memory_| to 0.
@@ -354,10 +354,10 @@ void FileNetLogObserver::StopObserving(std::unique_ptr<base::Value> polled_data,
 }
 
 void FileNetLogObserver::OnAddEntry(const NetLogEntry& entry) {
-  std::unique_ptr<std::string> json(new std::string);
+  std::string json;
 
   // If |entry| cannot be converted to proper JSON, ignore it.
-  if (!base::JSONWriter::Write(*entry.ToValue(), json.get()))
+  if (!base::JSONWriter::Write(*entry.ToValue(), &json))
     return;
 
   size_t queue_size = write_queue_->AddEntryToQueue(std::move(json));
@@ -438,17 +438,15 @@ FileNetLogObserver::FileNetLogObserver(
 FileNetLogObserver::WriteQueue::WriteQueue(size_t memory_max)
     : memory_(0), memory_max_(memory_max) {}
 
-size_t FileNetLogObserver::WriteQueue::AddEntryToQueue(
-    std::unique_ptr<std::string> event) {
+size_t FileNetLogObserver::WriteQueue::AddEntryToQueue(std::string event) {
   base::AutoLock lock(lock_);
 
-  memory_ += event->size();
+  memory_ += event.size();
   queue_.push(std::move(event));
 
   while (memory_ > memory_max_ && !queue_.empty()) {
     // Delete oldest events in the queue.
-    DCHECK(queue_.front());
-    memory_ -= queue_.front()->size();
+    memory_ -= queue_.front().size();
     queue_.pop();
   }
 
@@ -541,7 +539,7 @@ void FileNetLogObserver::FileWriter::Flush(
     }
 
     size_t bytes_written =
-        WriteToFile(output_file, *local_file_queue.front(), ",\n");
+        WriteToFile(output_file, local_file_queue.front(), ",\n");
 
     wrote_event_bytes_ |= bytes_written > 0;
 
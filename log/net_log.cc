@@ -79,9 +79,32 @@ std::unique_ptr<base::Value> NetLogString16Callback(
   return std::move(event_params);
 }
 
+// Sets the bits of |words| to those of |bits|, 32 per word.
+template <size_t N>
+void StoreTypeBitmap(const std::bitset<N>& bits,
+                     base::subtle::Atomic32* words) {
+  for (size_t word = 0; word * 32 < N; ++word) {
+    uint32_t value = 0;
+    for (size_t bit = 0; bit < 32 && word * 32 + bit < N; ++bit) {
+      if (bits[word * 32 + bit])
+        value |= 1u << bit;
+    }
+    base::subtle::NoBarrier_Store(&words[word],
+                                  static_cast<base::subtle::Atomic32>(value));
+  }
+}
+
+bool TypeBitmapContains(const base::subtle::Atomic32* words, size_t index) {
+  uint32_t word =
+      static_cast<uint32_t>(base::subtle::NoBarrier_Load(&words[index / 32]));
+  return (word >> (index % 32)) & 1;
+}
+
 }  // namespace
 
 NetLog::ThreadSafeObserver::ThreadSafeObserver() : net_log_(NULL) {
+  source_types_.set();
+  event_types_.set();
 }
 
 NetLog::ThreadSafeObserver::~ThreadSafeObserver() {
@@ -105,7 +128,19 @@ void NetLog::ThreadSafeObserver::OnAddEntryData(
   OnAddEntry(NetLogEntry(&entry_data, capture_mode()));
 }
 
+bool NetLog::ThreadSafeObserver::WantsEntry(
+    NetLogEventType type,
+    NetLogSourceType source_type) const {
+  return source_types_[static_cast<size_t>(source_type)] &&
+         event_types_[static_cast<size_t>(type)];
+}
+
+const size_t NetLog::kNumSourceTypeWords;
+const size_t NetLog::kNumEventTypeWords;
+
 NetLog::NetLog() : last_id_(0), is_capturing_(0) {
+  StoreTypeBitmap(SourceTypeSet(), observed_source_types_);
+  StoreTypeBitmap(EventTypeSet(), observed_event_types_);
 }
 
 NetLog::~NetLog() = default;
@@ -130,6 +165,11 @@ bool NetLog::IsCapturing() const {
   return base::subtle::NoBarrier_Load(&is_capturing_) != 0;
 }
 
+bool NetLog::IsCapturingSourceType(NetLogSourceType source_type) const {
+  return TypeBitmapContains(observed_source_types_,
+                            static_cast<size_t>(source_type));
+}
+
 void NetLog::AddObserver(NetLog::ThreadSafeObserver* observer,
                          NetLogCaptureMode capture_mode) {
   base::AutoLock lock(lock_);
@@ -154,6 +194,18 @@ void NetLog::SetObserverCaptureMode(NetLog::ThreadSafeObserver* observer,
   observer->capture_mode_ = capture_mode;
 }
 
+void NetLog::SetObserverFilter(NetLog::ThreadSafeObserver* observer,
+                               const SourceTypeSet& source_types,
+                               const EventTypeSet& event_types) {
+  base::AutoLock lock(lock_);
+
+  DCHECK(HasObserver(observer));
+  DCHECK_EQ(this, observer->net_log_);
+  observer->source_types_ = source_types;
+  observer->event_types_ = event_types;
+  UpdateIsCapturing();
+}
+
 void NetLog::RemoveObserver(NetLog::ThreadSafeObserver* observer) {
   base::AutoLock lock(lock_);
 
@@ -165,12 +217,23 @@ void NetLog::RemoveObserver(NetLog::ThreadSafeObserver* observer) {
 
   observer->net_log_ = NULL;
   observer->capture_mode_ = NetLogCaptureMode();
+  observer->source_types_.set();
+  observer->event_types_.set();
   UpdateIsCapturing();
 }
 
 void NetLog::UpdateIsCapturing() {
   lock_.AssertAcquired();
   base::subtle::NoBarrier_Store(&is_capturing_, observers_.size() ? 1 : 0);
+
+  SourceTypeSet source_types;
+  EventTypeSet event_types;
+  for (const auto* observer : observers_) {
+    source_types |= observer->source_types_;
+    event_types |= observer->event_types_;
+  }
+  StoreTypeBitmap(source_types, observed_source_types_);
+  StoreTypeBitmap(event_types, observed_event_types_);
 }
 
 bool NetLog::HasObserver(ThreadSafeObserver* observer) {
@@ -287,13 +350,19 @@ void NetLog::AddEntry(NetLogEventType type,
                       const NetLogParametersCallback* parameters_callback) {
   if (!IsCapturing())
     return;
+  if (!IsCapturingSourceType(source.type) ||
+      !TypeBitmapContains(observed_event_types_, static_cast<size_t>(type))) {
+    return;
+  }
   NetLogEntryData entry_data(type, source, phase, base::TimeTicks::Now(),
                              parameters_callback);
 
-  // Notify all of the log observers.
+  // Notify all of the log observers which want the entry.
   base::AutoLock lock(lock_);
-  for (auto* observer : observers_)
-    observer->OnAddEntryData(entry_data);
+  for (auto* observer : observers_) {
+    if (observer->WantsEntry(type, source.type))
+      observer->OnAddEntryData(entry_data);
+  }
 }
 
 }  // namespace net
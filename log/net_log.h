@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <bitset>
 #include <string>
 #include <vector>
 
@@ -44,10 +45,20 @@ namespace net {
 // NetLog::ThreadSafeObserver functions may be called by an observer's
 // OnAddEntry() method.  Doing so will result in a deadlock.
 //
+// IsCapturing() and IsCapturingSourceType() do not acquire a lock, and neither
+// does adding an entry which no observer wants. Entries which are passed to
+// observers are passed with the lock held, so that OnAddEntry() is never called
+// concurrently.
+//
 // For a broader introduction see the design document:
 // https://sites.google.com/a/chromium.org/dev/developers/design-documents/network-stack/netlog
 class NET_EXPORT NetLog {
  public:
+  // Sets of source and event types, indexed by their enum values, which an
+  // observer wants to receive entries for.
+  using SourceTypeSet =
+      std::bitset<static_cast<size_t>(NetLogSourceType::COUNT)>;
+  using EventTypeSet = std::bitset<static_cast<size_t>(NetLogEventType::COUNT)>;
 
   // An observer that is notified of entries added to the NetLog. The
   // "ThreadSafe" prefix of the name emphasizes that this observer may be
@@ -97,9 +108,15 @@ class NET_EXPORT NetLog {
 
     void OnAddEntryData(const NetLogEntryData& entry_data);
 
-    // Both of these values are only modified by the NetLog.
+    // Returns true if entries of |type| from sources of |source_type| pass
+    // the filter set by NetLog::SetObserverFilter().
+    bool WantsEntry(NetLogEventType type, NetLogSourceType source_type) const;
+
+    // These values are only modified by the NetLog.
     NetLogCaptureMode capture_mode_;
     NetLog* net_log_;
+    SourceTypeSet source_types_;
+    EventTypeSet event_types_;
 
     DISALLOW_COPY_AND_ASSIGN(ThreadSafeObserver);
   };
@@ -142,6 +159,21 @@ class NET_EXPORT NetLog {
   void SetObserverCaptureMode(ThreadSafeObserver* observer,
                               NetLogCaptureMode capture_mode);
 
+  // Restricts the entries passed to |observer|, which must be watching |this|,
+  // to the entries of types in |event_types| from sources of types in
+  // |source_types|. Observers receive all entries until this is called, and
+  // again after they are removed. Entries no observer wants are dropped
+  // without a lock being acquired, and NetLogWithSources of source types no
+  // observer wants report that they are not capturing.
+  void SetObserverFilter(ThreadSafeObserver* observer,
+                         const SourceTypeSet& source_types,
+                         const EventTypeSet& event_types);
+
+  // Returns true if any observer wants entries from sources of |source_type|.
+  // Like IsCapturing(), this does not acquire a lock and may be briefly out of
+  // date while observers are being added, removed, or filtered.
+  bool IsCapturingSourceType(NetLogSourceType source_type) const;
+
   // Removes an observer.
   //
   // For thread safety reasons, it is recommended that this not be called in
@@ -205,8 +237,9 @@ class NET_EXPORT NetLog {
                 NetLogEventPhase phase,
                 const NetLogParametersCallback* parameters_callback);
 
-  // Called whenever an observer is added or removed, to update
-  // |has_observers_|. Must have acquired |lock_| prior to calling.
+  // Called whenever an observer is added, removed or filtered, to update
+  // |is_capturing_|, |observed_source_types_| and |observed_event_types_|.
+  // Must have acquired |lock_| prior to calling.
   void UpdateIsCapturing();
 
   // Returns true if |observer| is watching this NetLog. Must
@@ -224,6 +257,16 @@ class NET_EXPORT NetLog {
   // so it can be accessed without needing a lock.
   base::subtle::Atomic32 is_capturing_;
 
+  // Bitmaps of the source and event types which at least one observer wants,
+  // 32 types per word. Like |is_capturing_|, they are read without |lock_|, so
+  // that entries no observer wants are dropped before the lock is acquired.
+  static const size_t kNumSourceTypeWords =
+      (static_cast<size_t>(NetLogSourceType::COUNT) + 31) / 32;
+  static const size_t kNumEventTypeWords =
+      (static_cast<size_t>(NetLogEventType::COUNT) + 31) / 32;
+  base::subtle::Atomic32 observed_source_types_[kNumSourceTypeWords];
+  base::subtle::Atomic32 observed_event_types_[kNumEventTypeWords];
+
   // |observers_| is a list of observers, ordered by when they were added.
   // Pointers contained in |observers_| are non-owned, and must
   // remain valid.
@@ -2045,6 +2045,13 @@ EVENT_TYPE(QUIC_CONNECTION_CONNECTIVITY_PROBING_TRIGGERED)
 //  }
 EVENT_TYPE(QUIC_CONNECTION_CONNECTIVITY_PROBING_SUCCEEDED)
 
+// Records that QUIC connectivity probing validated the path to an alternate
+// network ahead of a migration.
+//  {
+//     "network": <ID of the network being probed>
+//  }
+EVENT_TYPE(QUIC_CONNECTION_ALTERNATE_NETWORK_PREVALIDATED)
+
 // Records that QUIC connectivity probing fails.
 //  {
 //     "network": <ID of the network being probed>
@@ -2092,6 +2099,13 @@ EVENT_TYPE(QUIC_CONNECTION_MIGRATION_ON_WRITE_ERROR)
 // degrading on the current network.
 EVENT_TYPE(QUIC_CONNECTION_MIGRATION_ON_PATH_DEGRADING)
 
+// Records that a QUIC connection migrates, without probing, to the path to an
+// alternate network which was validated ahead of time.
+//  {
+//     "network": <ID of the network migrated to>
+//  }
+EVENT_TYPE(QUIC_CONNECTION_MIGRATION_TO_PREVALIDATED_NETWORK)
+
 // Records that a QUIC connection migration attempt due to efforts to
 // migrate back to the default network.
 EVENT_TYPE(QUIC_CONNECTION_MIGRATION_ON_MIGRATE_BACK)
@@ -2445,6 +2459,17 @@ EVENT_TYPE(DNS_TRANSACTION_ATTEMPT)
 //   }
 EVENT_TYPE(DNS_TRANSACTION_TCP_ATTEMPT)
 
+// This event is created when DnsTransaction makes a DNS over HTTPS request to
+// a server.
+//
+// It has a single parameter:
+//
+//   {
+//     "source_dependency": <Source id of the URLRequest created for the
+//                           attempt>,
+//   }
+EVENT_TYPE(DNS_TRANSACTION_HTTPS_ATTEMPT)
+
 // This event is created when DnsTransaction receives a matching response.
 //
 // It has the following parameters:
@@ -15,6 +15,7 @@
 #include "net/base/net_errors.h"
 #include "net/log/net_log_event_type.h"
 #include "net/log/net_log_source_type.h"
+#include "net/log/net_log_with_source.h"
 #include "net/log/test_net_log.h"
 #include "net/log/test_net_log_entry.h"
 #include "net/log/test_net_log_util.h"
@@ -388,6 +389,53 @@ TEST(NetLogTest, NetLogTwoObservers) {
   EXPECT_EQ(1U, observer[1].GetNumValues());
 }
 
+// Test that observers only receive the entries which pass their filters, and
+// that entries no observer wants are dropped.
+TEST(NetLogTest, NetLogObserverFilter) {
+  NetLog net_log;
+  CountingObserver observer[2];
+  net_log.AddObserver(&observer[0], NetLogCaptureMode::Default());
+  net_log.AddObserver(&observer[1], NetLogCaptureMode::Default());
+
+  NetLogWithSource socket_log =
+      NetLogWithSource::Make(&net_log, NetLogSourceType::SOCKET);
+  NetLogWithSource request_log =
+      NetLogWithSource::Make(&net_log, NetLogSourceType::URL_REQUEST);
+
+  // The first observer only wants CANCELLED events from sockets.
+  NetLog::SourceTypeSet source_types;
+  source_types.set(static_cast<size_t>(NetLogSourceType::SOCKET));
+  NetLog::EventTypeSet event_types;
+  event_types.set(static_cast<size_t>(NetLogEventType::CANCELLED));
+  net_log.SetObserverFilter(&observer[0], source_types, event_types);
+
+  socket_log.AddEvent(NetLogEventType::CANCELLED);
+  socket_log.AddEvent(NetLogEventType::FAILED);
+  request_log.AddEvent(NetLogEventType::CANCELLED);
+  EXPECT_EQ(1, observer[0].count());
+  EXPECT_EQ(3, observer[1].count());
+  EXPECT_TRUE(request_log.IsCapturing());
+
+  // With both observers filtered, entries no observer wants are dropped, and
+  // sources no observer wants are not capturing.
+  net_log.SetObserverFilter(&observer[1], source_types, event_types);
+  socket_log.AddEvent(NetLogEventType::CANCELLED);
+  request_log.AddEvent(NetLogEventType::CANCELLED);
+  EXPECT_EQ(2, observer[0].count());
+  EXPECT_EQ(4, observer[1].count());
+  EXPECT_TRUE(net_log.IsCapturing());
+  EXPECT_TRUE(socket_log.IsCapturing());
+  EXPECT_FALSE(request_log.IsCapturing());
+
+  // Removing an observer clears its filter.
+  net_log.RemoveObserver(&observer[1]);
+  net_log.AddObserver(&observer[1], NetLogCaptureMode::Default());
+  request_log.AddEvent(NetLogEventType::CANCELLED);
+  EXPECT_EQ(2, observer[0].count());
+  EXPECT_EQ(5, observer[1].count());
+  EXPECT_TRUE(request_log.IsCapturing());
+}
+
 // Makes sure that adding and removing observers simultaneously on different
 // threads works.
 TEST(NetLogTest, NetLogAddRemoveObserverThreads) {
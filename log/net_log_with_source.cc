@@ -119,7 +119,8 @@ void NetLogWithSource::AddByteTransferEvent(NetLogEventType event_type,
 
 bool NetLogWithSource::IsCapturing() const {
   CrashIfInvalid();
-  return net_log_ && net_log_->IsCapturing();
+  return net_log_ && net_log_->IsCapturing() &&
+         net_log_->IsCapturingSourceType(source_.type);
 }
 
 // static
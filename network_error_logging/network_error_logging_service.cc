@@ -23,6 +23,7 @@
 #include "net/url_request/network_error_logging_delegate.h"
 #include "url/gurl.h"
 #include "url/origin.h"
+#include "url/url_constants.h"
 
 namespace features {
 
@@ -171,23 +172,28 @@ void NetworkErrorLoggingService::OnNetworkError(const ErrorDetails& details) {
   if (!reporting_service_)
     return;
 
+  // The checks are ordered from cheapest to most expensive, since most errors
+  // don't lead to a report.
+  std::string type_string;
+  if (!GetTypeFromNetError(details.type, &type_string))
+    return;
+
   url::Origin origin = url::Origin::Create(details.uri);
 
   // NEL is only available to secure origins, so ignore network errors from
   // insecure origins. (The check in OnHeader prevents insecure origins from
   // setting policies, but this check is needed to ensure that insecure origins
-  // can't match wildcard policies from secure origins.)
-  if (!origin.GetURL().SchemeIsCryptographic())
+  // can't match wildcard policies from secure origins.) This is what
+  // GURL::SchemeIsCryptographic() checks, without building the origin's URL.
+  if (origin.scheme() != url::kHttpsScheme &&
+      origin.scheme() != url::kWssScheme) {
     return;
+  }
 
   const OriginPolicy* policy = FindPolicyForOrigin(origin);
   if (!policy)
     return;
 
-  std::string type_string;
-  if (!GetTypeFromNetError(details.type, &type_string))
-    return;
-
   reporting_service_->QueueReport(details.uri, policy->report_to, kReportType,
                                   CreateReportBody(type_string, details));
 }
@@ -432,6 +432,11 @@ NetworkQualityEstimatorParams::NetworkQualityEstimatorParams(
           GetValueForVariationParam(params_,
                                     "hanging_request_min_duration_msec",
                                     3000))),
+      throughput_observation_during_transfer_interval_(
+          base::TimeDelta::FromMilliseconds(GetValueForVariationParam(
+              params_,
+              "throughput_observation_during_transfer_interval_msec",
+              -1))),
       add_default_platform_observations_(
           GetStringValueForVariationParamWithDefaultValue(
               params_,
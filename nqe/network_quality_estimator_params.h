@@ -209,6 +209,14 @@ class NET_EXPORT NetworkQualityEstimatorParams {
     return hanging_request_min_duration_;
   }
 
+  // If positive, a throughput observation may also be taken while requests are
+  // still receiving data, at most once per this interval, so that long
+  // transfers produce observations before they complete. Disabled if zero or
+  // negative.
+  base::TimeDelta throughput_observation_during_transfer_interval() const {
+    return throughput_observation_during_transfer_interval_;
+  }
+
   // Returns true if default values provided by the platform should be used for
   // estimation. Set to false only for testing.
   bool add_default_platform_observations() const {
@@ -254,6 +262,7 @@ class NET_EXPORT NetworkQualityEstimatorParams {
   const base::TimeDelta historical_time_threshold_;
   const int hanging_request_duration_http_rtt_multiplier_;
   const base::TimeDelta hanging_request_min_duration_;
+  const base::TimeDelta throughput_observation_during_transfer_interval_;
   const bool add_default_platform_observations_;
   const base::TimeDelta socket_watchers_min_notification_interval_;
 
@@ -62,7 +62,8 @@ base::Optional<int32_t> ObservationBuffer::GetPercentile(
     int percentile,
     size_t* observations_count) const {
   // Stores weighted observations in increasing order by value.
-  std::vector<WeightedObservation> weighted_observations;
+  std::vector<WeightedObservation>& weighted_observations =
+      weighted_observations_;
 
   // Total weight of all observations in |weighted_observations|.
   double total_weight = 0.0;
@@ -171,24 +172,42 @@ void ObservationBuffer::ComputeWeightedObservations(
   DCHECK_GE(Capacity(), Size());
 
   weighted_observations->clear();
+  weighted_observations->reserve(observations_.size());
   double total_weight_observations = 0.0;
   base::TimeTicks now = tick_clock_->NowTicks();
 
+  // The observations are sorted by time, so consecutive observations usually
+  // have the same age in seconds, and often the same signal strength. The
+  // last computed weights are reused in that case rather than calling pow()
+  // again.
+  bool has_time_weight = false;
+  int64_t time_weight_seconds = 0;
+  double time_weight = 1.0;
+  int32_t signal_strength_weight_diff = 0;
+  double signal_strength_weight_for_diff = 1.0;
+
   for (const auto& observation : observations_) {
     if (observation.timestamp() < begin_timestamp)
       continue;
 
     base::TimeDelta time_since_sample_taken = now - observation.timestamp();
-    double time_weight =
-        pow(weight_multiplier_per_second_, time_since_sample_taken.InSeconds());
+    if (!has_time_weight ||
+        time_since_sample_taken.InSeconds() != time_weight_seconds) {
+      has_time_weight = true;
+      time_weight_seconds = time_since_sample_taken.InSeconds();
+      time_weight = pow(weight_multiplier_per_second_, time_weight_seconds);
+    }
 
     double signal_strength_weight = 1.0;
     if (current_signal_strength && observation.signal_strength()) {
-      int32_t signal_strength_weight_diff =
-          std::abs(current_signal_strength.value() -
-                   observation.signal_strength().value());
-      signal_strength_weight =
-          pow(weight_multiplier_per_signal_level_, signal_strength_weight_diff);
+      int32_t diff = std::abs(current_signal_strength.value() -
+                              observation.signal_strength().value());
+      if (diff != signal_strength_weight_diff) {
+        signal_strength_weight_diff = diff;
+        signal_strength_weight_for_diff =
+            pow(weight_multiplier_per_signal_level_, diff);
+      }
+      signal_strength_weight = signal_strength_weight_for_diff;
     }
 
     double weight = time_weight * signal_strength_weight;
@@ -19,6 +19,7 @@
 #include "net/nqe/network_quality_estimator_util.h"
 #include "net/nqe/network_quality_observation.h"
 #include "net/nqe/network_quality_observation_source.h"
+#include "net/nqe/weighted_observation.h"
 
 namespace base {
 
@@ -34,8 +35,6 @@ namespace nqe {
 
 namespace internal {
 
-struct WeightedObservation;
-
 // Stores observations sorted by time and provides utility functions for
 // computing weighted and non-weighted summary statistics.
 class NET_EXPORT_PRIVATE ObservationBuffer {
@@ -106,7 +105,8 @@ class NET_EXPORT_PRIVATE ObservationBuffer {
   // considered. |current_signal_strength| is the current signal strength
   // when the observation was taken. This method also sets |total_weight| to
   // the total weight of all observations. Should be called only when there is
-  // at least one observation in the buffer.
+  // at least one observation in the buffer. Reuses the capacity of
+  // |weighted_observations|.
   void ComputeWeightedObservations(
       const base::TimeTicks& begin_timestamp,
       const base::Optional<int32_t>& current_signal_strength,
@@ -136,6 +136,10 @@ class NET_EXPORT_PRIVATE ObservationBuffer {
 
   base::TickClock* tick_clock_;
 
+  // Scratch space for GetPercentile(), kept so that its capacity is reused
+  // rather than allocated again on each call.
+  mutable std::vector<WeightedObservation> weighted_observations_;
+
   DISALLOW_COPY_AND_ASSIGN(ObservationBuffer);
 };
 
@@ -4,6 +4,8 @@
 
 #include "net/nqe/socket_watcher.h"
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
@@ -53,6 +55,35 @@ base::Optional<IPHash> CalculateIPHash(const AddressList& address_list) {
 
 }  // namespace
 
+class SocketWatcher::PendingRTTs : public base::RefCounted<PendingRTTs> {
+ public:
+  PendingRTTs() = default;
+
+  // Runs |callback| for each pending RTT, in the order in which they were
+  // added, and leaves none pending.
+  void Run(const OnUpdatedRTTAvailableCallback& callback,
+           SocketPerformanceWatcherFactory::Protocol protocol,
+           const base::Optional<IPHash>& host) {
+    std::vector<base::TimeDelta> rtts;
+    rtts.swap(rtts_);
+    for (const base::TimeDelta& rtt : rtts)
+      callback.Run(protocol, rtt, host);
+  }
+
+  void Add(const base::TimeDelta& rtt) { rtts_.push_back(rtt); }
+
+  bool empty() const { return rtts_.empty(); }
+
+ private:
+  friend class base::RefCounted<PendingRTTs>;
+
+  ~PendingRTTs() = default;
+
+  std::vector<base::TimeDelta> rtts_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingRTTs);
+};
+
 SocketWatcher::SocketWatcher(
     SocketPerformanceWatcherFactory::Protocol protocol,
     const AddressList& address_list,
@@ -118,9 +149,26 @@ void SocketWatcher::OnUpdatedRTTAvailable(const base::TimeDelta& rtt) {
   }
 
   last_rtt_notification_ = tick_clock_->NowTicks();
-  task_runner_->PostTask(
-      FROM_HERE,
-      base::Bind(updated_rtt_observation_callback_, protocol_, rtt, host_));
+
+  if (!task_runner_->RunsTasksInCurrentSequence()) {
+    task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(updated_rtt_observation_callback_, protocol_, rtt, host_));
+    return;
+  }
+
+  // A non-empty |pending_rtts_| means that a task which runs the callback on
+  // them has already been posted.
+  if (!pending_rtts_)
+    pending_rtts_ = base::MakeRefCounted<PendingRTTs>();
+  bool post_task = pending_rtts_->empty();
+  pending_rtts_->Add(rtt);
+  if (post_task) {
+    task_runner_->PostTask(
+        FROM_HERE, base::Bind(&PendingRTTs::Run, pending_rtts_,
+                              updated_rtt_observation_callback_, protocol_,
+                              host_));
+  }
 }
 
 void SocketWatcher::OnConnectionChanged() {
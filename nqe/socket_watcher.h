@@ -75,6 +75,8 @@ class NET_EXPORT_PRIVATE SocketWatcher : public SocketPerformanceWatcher {
   void OnConnectionChanged() override;
 
  private:
+  class PendingRTTs;
+
   // Transport layer protocol used by the socket that |this| is watching.
   const SocketPerformanceWatcherFactory::Protocol protocol_;
 
@@ -108,6 +110,12 @@ class NET_EXPORT_PRIVATE SocketWatcher : public SocketPerformanceWatcher {
   // A unique identifier for the remote host that this socket connects to.
   const base::Optional<IPHash> host_;
 
+  // RTT observations which wait for a task posted to |task_runner_| to pass
+  // them to |updated_rtt_observation_callback_|. Only used when |this| runs
+  // on |task_runner_|, so that observations which arrive before that task
+  // has run are added to it rather than each posting a task.
+  scoped_refptr<PendingRTTs> pending_rtts_;
+
   DISALLOW_COPY_AND_ASSIGN(SocketWatcher);
 };
 
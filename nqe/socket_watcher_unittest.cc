@@ -4,6 +4,8 @@
 
 #include "net/nqe/socket_watcher.h"
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/run_loop.h"
 #include "base/test/scoped_task_environment.h"
@@ -261,6 +263,48 @@ TEST_F(NetworkQualitySocketWatcherTest, RemoteHostIPHashComputedCorrectly) {
   }
 }
 
+void StoreRTT(std::vector<base::TimeDelta>* rtts,
+              SocketPerformanceWatcherFactory::Protocol protocol,
+              const base::TimeDelta& rtt,
+              const base::Optional<IPHash>& host) {
+  rtts->push_back(rtt);
+}
+
+// Verify that RTT observations which arrive before the posted task has run are
+// all notified, in order.
+TEST_F(NetworkQualitySocketWatcherTest, PendingNotificationsBatched) {
+  base::SimpleTestTickClock tick_clock;
+  tick_clock.SetNowTicks(base::TimeTicks::Now());
+
+  IPAddressList ip_list;
+  IPAddress ip_address;
+  ASSERT_TRUE(ip_address.AssignFromIPLiteral("157.0.0.1"));
+  ip_list.push_back(ip_address);
+  AddressList address_list =
+      AddressList::CreateFromIPAddressList(ip_list, "canonical.example.com");
+
+  std::vector<base::TimeDelta> rtts;
+  SocketWatcher socket_watcher(
+      SocketPerformanceWatcherFactory::PROTOCOL_TCP, address_list,
+      base::TimeDelta::FromMilliseconds(2000), false,
+      base::ThreadTaskRunnerHandle::Get(), base::Bind(&StoreRTT, &rtts),
+      base::Bind(ShouldNotifyRTTCallback), &tick_clock);
+
+  socket_watcher.OnUpdatedRTTAvailable(base::TimeDelta::FromMilliseconds(10));
+  socket_watcher.OnUpdatedRTTAvailable(base::TimeDelta::FromMilliseconds(20));
+  EXPECT_TRUE(rtts.empty());
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(2u, rtts.size());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(10), rtts[0]);
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(20), rtts[1]);
+
+  // Observations after the batch has been notified post another task.
+  socket_watcher.OnUpdatedRTTAvailable(base::TimeDelta::FromMilliseconds(30));
+  base::RunLoop().RunUntilIdle();
+  ASSERT_EQ(3u, rtts.size());
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(30), rtts[2]);
+}
+
 }  // namespace
 
 }  // namespace internal
@@ -4,6 +4,7 @@
 
 #include "net/nqe/throughput_analyzer.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "base/location.h"
@@ -166,6 +167,34 @@ void ThroughputAnalyzer::NotifyBytesRead(const URLRequest& request) {
 
   // Update the time when the bytes were received for |request|.
   requests_[&request] = tick_clock_->NowTicks();
+
+  MaybeGetThroughputObservationDuringTransfer();
+}
+
+void ThroughputAnalyzer::MaybeGetThroughputObservationDuringTransfer() {
+  DCHECK(thread_checker_.CalledOnValidThread());
+
+  const base::TimeDelta interval =
+      params_->throughput_observation_during_transfer_interval();
+  if (interval <= base::TimeDelta() || !IsCurrentlyTrackingThroughput())
+    return;
+
+  // Polling the number of bits received may be expensive, so it is done at
+  // most once per |interval|.
+  const base::TimeTicks now = tick_clock_->NowTicks();
+  if (now - std::max(window_start_time_,
+                     last_observation_during_transfer_attempt_) <
+      interval) {
+    return;
+  }
+  last_observation_during_transfer_attempt_ = now;
+
+  int32_t downstream_kbps = -1;
+  if (MaybeGetThroughputObservation(&downstream_kbps)) {
+    task_runner_->PostTask(
+        FROM_HERE,
+        base::Bind(throughput_observation_callback_, downstream_kbps));
+  }
 }
 
 void ThroughputAnalyzer::NotifyRequestCompleted(const URLRequest& request) {
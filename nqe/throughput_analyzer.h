@@ -146,6 +146,12 @@ class NET_EXPORT_PRIVATE ThroughputAnalyzer {
   // EndThroughputObservationWindow ends the throughput observation window.
   void EndThroughputObservationWindow();
 
+  // Takes a throughput observation from the current observation window while
+  // its requests are still in flight, if enabled by |params_| and at least
+  // the configured interval has passed since the window started or since the
+  // last attempt.
+  void MaybeGetThroughputObservationDuringTransfer();
+
   // Returns true if the |request| degrades the accuracy of the throughput
   // observation window. A local request or a request that spans a connection
   // change degrades the accuracy of the throughput computation.
@@ -192,6 +198,10 @@ class NET_EXPORT_PRIVATE ThroughputAnalyzer {
   // Last time when the check for hanging requests was run.
   base::TimeTicks last_hanging_request_check_;
 
+  // Last time when MaybeGetThroughputObservationDuringTransfer() tried to take
+  // an observation.
+  base::TimeTicks last_observation_during_transfer_attempt_;
+
   // If true, then |this| throughput analyzer stops tracking the throughput
   // observations until Chromium is restarted. This may happen if the throughput
   // analyzer has lost track of the requests that degrade throughput computation
@@ -537,6 +537,58 @@ TEST(ThroughputAnalyzerTest, TestRequestDeletedImmediately) {
   EXPECT_EQ(0u, throughput_analyzer.CountInFlightRequests());
 }
 
+// Tests that a throughput observation is taken while a request is still
+// receiving data only if enabled, and at most once per configured interval.
+TEST(ThroughputAnalyzerTest, TestThroughputObservationDuringTransfer) {
+  for (bool enabled : {false, true}) {
+    base::SimpleTestTickClock tick_clock;
+
+    TestNetworkQualityProvider network_quality_provider;
+    network_quality_provider.SetHttpRtt(base::TimeDelta::FromSeconds(1));
+    std::map<std::string, std::string> variation_params;
+    variation_params["throughput_min_requests_in_flight"] = "1";
+    if (enabled) {
+      variation_params["throughput_observation_during_transfer_interval_msec"] =
+          "1000";
+    }
+    NetworkQualityEstimatorParams params(variation_params);
+
+    TestThroughputAnalyzer throughput_analyzer(&network_quality_provider,
+                                               &params, &tick_clock);
+
+    TestDelegate test_delegate;
+    TestURLRequestContext context;
+    throughput_analyzer.AddIPAddressResolution(&context);
+
+    std::unique_ptr<URLRequest> request_not_local(context.CreateRequest(
+        GURL("http://example.com/echo.html"), DEFAULT_PRIORITY, &test_delegate,
+        TRAFFIC_ANNOTATION_FOR_TESTS));
+    request_not_local->Start();
+
+    base::RunLoop().Run();
+
+    throughput_analyzer.NotifyStartTransaction(*request_not_local);
+    EXPECT_TRUE(throughput_analyzer.IsCurrentlyTrackingThroughput());
+
+    // Not enough time has passed since the window started.
+    tick_clock.Advance(base::TimeDelta::FromMilliseconds(500));
+    throughput_analyzer.IncrementBitsReceived(100 * 1000 * 8);
+    throughput_analyzer.NotifyBytesRead(*request_not_local);
+    base::RunLoop().RunUntilIdle();
+    EXPECT_EQ(0, throughput_analyzer.throughput_observations_received());
+
+    tick_clock.Advance(base::TimeDelta::FromMilliseconds(600));
+    throughput_analyzer.IncrementBitsReceived(100 * 1000 * 8);
+    throughput_analyzer.NotifyBytesRead(*request_not_local);
+    base::RunLoop().RunUntilIdle();
+    EXPECT_EQ(enabled ? 1 : 0,
+              throughput_analyzer.throughput_observations_received());
+
+    // The request is still in flight, so tracking continues.
+    EXPECT_TRUE(throughput_analyzer.IsCurrentlyTrackingThroughput());
+  }
+}
+
 // Tests if the throughput observation is taken correctly when local and network
 // requests overlap.
 TEST(ThroughputAnalyzerTest, TestThroughputWithMultipleRequestsOverlap) {
@@ -4,6 +4,8 @@
 
 #include "net/proxy/proxy_bypass_rules.h"
 
+#include <utility>
+
 #include "base/strings/pattern.h"
 #include "base/strings/string_piece.h"
 #include "base/strings/string_tokenizer.h"
@@ -160,11 +162,27 @@ ProxyBypassRules& ProxyBypassRules::operator=(const ProxyBypassRules& rhs) {
 }
 
 bool ProxyBypassRules::Matches(const GURL& url) const {
-  for (RuleList::const_iterator it = rules_.begin(); it != rules_.end(); ++it) {
-    if ((*it)->Matches(url))
-      return true;
+  base::StringPiece host = url.host_piece();
+
+  auto exact_host_it = exact_host_rules_.find(host);
+  if (exact_host_it != exact_host_rules_.end() &&
+      MatchesAnyOf(exact_host_it->second, url)) {
+    return true;
   }
-  return false;
+
+  // Look up each suffix of |host| which starts with a dot.
+  if (!domain_suffix_rules_.empty()) {
+    for (size_t dot = host.find('.'); dot != base::StringPiece::npos;
+         dot = host.find('.', dot + 1)) {
+      auto domain_suffix_it = domain_suffix_rules_.find(host.substr(dot));
+      if (domain_suffix_it != domain_suffix_rules_.end() &&
+          MatchesAnyOf(domain_suffix_it->second, url)) {
+        return true;
+      }
+    }
+  }
+
+  return MatchesAnyOf(unindexed_rules_, url);
 }
 
 bool ProxyBypassRules::Equals(const ProxyBypassRules& other) const {
@@ -193,13 +211,25 @@ bool ProxyBypassRules::AddRuleForHostname(const std::string& optional_scheme,
   if (hostname_pattern.empty())
     return false;
 
+  // The rule lower-cases the pattern, so the index has to match that.
+  std::string pattern = base::ToLowerASCII(hostname_pattern);
+  const char kWildcardChars[] = "*?\\";
+  if (pattern.find_first_of(kWildcardChars) == std::string::npos) {
+    exact_host_rules_[pattern].push_back(rules_.size());
+  } else if (base::StartsWith(pattern, "*.", base::CompareCase::SENSITIVE) &&
+             pattern.find_first_of(kWildcardChars, 1) == std::string::npos) {
+    domain_suffix_rules_[pattern.substr(1)].push_back(rules_.size());
+  } else {
+    unindexed_rules_.push_back(rules_.size());
+  }
+
   rules_.push_back(std::make_unique<HostnamePatternRule>(
       optional_scheme, hostname_pattern, optional_port));
   return true;
 }
 
 void ProxyBypassRules::AddRuleToBypassLocal() {
-  rules_.push_back(std::make_unique<BypassLocalRule>());
+  AddUnindexedRule(std::make_unique<BypassLocalRule>());
 }
 
 bool ProxyBypassRules::AddRuleFromString(const std::string& raw) {
@@ -224,6 +254,9 @@ std::string ProxyBypassRules::ToString() const {
 
 void ProxyBypassRules::Clear() {
   rules_.clear();
+  exact_host_rules_.clear();
+  domain_suffix_rules_.clear();
+  unindexed_rules_.clear();
 }
 
 void ProxyBypassRules::AssignFrom(const ProxyBypassRules& other) {
@@ -234,6 +267,9 @@ void ProxyBypassRules::AssignFrom(const ProxyBypassRules& other) {
        it != other.rules_.end(); ++it) {
     rules_.push_back((*it)->Clone());
   }
+  exact_host_rules_ = other.exact_host_rules_;
+  domain_suffix_rules_ = other.domain_suffix_rules_;
+  unindexed_rules_ = other.unindexed_rules_;
 }
 
 void ProxyBypassRules::ParseFromStringInternal(
@@ -283,7 +319,7 @@ bool ProxyBypassRules::AddRuleFromStringInternal(
     if (!ParseCIDRBlock(raw, &ip_prefix, &prefix_length_in_bits))
       return false;
 
-    rules_.push_back(std::make_unique<BypassIPBlockRule>(
+    AddUnindexedRule(std::make_unique<BypassIPBlockRule>(
         raw, scheme, ip_prefix, prefix_length_in_bits));
 
     return true;
@@ -341,4 +377,18 @@ bool ProxyBypassRules::AddRuleFromStringInternalWithLogging(
   return AddRuleFromStringInternal(raw, use_hostname_suffix_matching);
 }
 
+void ProxyBypassRules::AddUnindexedRule(std::unique_ptr<Rule> rule) {
+  unindexed_rules_.push_back(rules_.size());
+  rules_.push_back(std::move(rule));
+}
+
+bool ProxyBypassRules::MatchesAnyOf(const std::vector<size_t>& rule_indices,
+                                    const GURL& url) const {
+  for (size_t rule_index : rule_indices) {
+    if (rules_[rule_index]->Matches(url))
+      return true;
+  }
+  return false;
+}
+
 }  // namespace net
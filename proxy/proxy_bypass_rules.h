@@ -5,6 +5,7 @@
 #ifndef NET_PROXY_PROXY_BYPASS_RULES_H_
 #define NET_PROXY_PROXY_BYPASS_RULES_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -173,7 +174,29 @@ class NET_EXPORT ProxyBypassRules {
   bool AddRuleFromStringInternalWithLogging(const std::string& raw,
                                             bool use_hostname_suffix_matching);
 
+  // Adds |rule| to |rules_| without indexing it, so that Matches() always
+  // runs it.
+  void AddUnindexedRule(std::unique_ptr<Rule> rule);
+
+  // Returns true if |url| matches any of the rules of |rules_| at
+  // |rule_indices|.
+  bool MatchesAnyOf(const std::vector<size_t>& rule_indices,
+                    const GURL& url) const;
+
+  typedef std::map<std::string, std::vector<size_t>, std::less<>> RuleIndexMap;
+
   RuleList rules_;
+
+  // Indices into |rules_|, so that Matches() only runs the rules which can
+  // match the host of the URL. Hostname patterns without wildcards are keyed
+  // by the hostname in |exact_host_rules_|, and patterns of the form
+  // "*.DOMAIN" without other wildcards are keyed by ".DOMAIN" in
+  // |domain_suffix_rules_|. All the other rules are in |unindexed_rules_|.
+  // Since a URL is bypassed if it matches any rule, the order in which the
+  // rules are run doesn't matter.
+  RuleIndexMap exact_host_rules_;
+  RuleIndexMap domain_suffix_rules_;
+  std::vector<size_t> unindexed_rules_;
 };
 
 }  // namespace net
@@ -221,6 +221,49 @@ TEST(ProxyBypassRulesTest, MultipleRules) {
   EXPECT_FALSE(rules.Matches(GURL("http://bar.foobar.com:33")));
 }
 
+// Tests a list which mixes the rules Matches() looks up by host with the ones
+// it runs for every URL, including after copying and clearing it.
+TEST(ProxyBypassRulesTest, ManyRules) {
+  ProxyBypassRules rules;
+  std::string raw;
+  for (int i = 0; i < 100; ++i)
+    raw += base::StringPrintf("host%d.example.com, .domain%d.com,", i, i);
+  raw += "https://secure.example.com, exact.example.com:99, "
+         "*.ports.com:88, a*c.wild.com, foo?.com, 10.0.0.0/8, <local>";
+  rules.ParseFromString(raw);
+  ASSERT_EQ(207u, rules.rules().size());
+
+  ProxyBypassRules copy(rules);
+  for (const ProxyBypassRules* r : {&rules, &copy}) {
+    EXPECT_TRUE(r->Matches(GURL("http://host42.example.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://x.host42.example.com")));
+    EXPECT_TRUE(r->Matches(GURL("http://a.b.domain7.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://domain7.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://a.domain7.com.net")));
+
+    EXPECT_TRUE(r->Matches(GURL("https://secure.example.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://secure.example.com")));
+    EXPECT_TRUE(r->Matches(GURL("http://exact.example.com:99")));
+    EXPECT_FALSE(r->Matches(GURL("http://exact.example.com")));
+    EXPECT_TRUE(r->Matches(GURL("http://www.ports.com:88")));
+    EXPECT_FALSE(r->Matches(GURL("http://www.ports.com")));
+
+    EXPECT_TRUE(r->Matches(GURL("http://abbc.wild.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://abbd.wild.com")));
+    EXPECT_TRUE(r->Matches(GURL("http://foo1.com")));
+    EXPECT_FALSE(r->Matches(GURL("http://foo12.com")));
+    EXPECT_TRUE(r->Matches(GURL("http://10.1.2.3")));
+    EXPECT_TRUE(r->Matches(GURL("http://localhost")));
+    EXPECT_FALSE(r->Matches(GURL("http://www.google.com")));
+  }
+
+  rules.Clear();
+  EXPECT_FALSE(rules.Matches(GURL("http://host42.example.com")));
+  EXPECT_FALSE(rules.Matches(GURL("http://a.b.domain7.com")));
+  EXPECT_FALSE(rules.Matches(GURL("http://localhost")));
+  EXPECT_TRUE(copy.Matches(GURL("http://host42.example.com")));
+}
+
 TEST(ProxyBypassRulesTest, BadInputs) {
   ProxyBypassRules rules;
   EXPECT_FALSE(rules.AddRuleFromString("://"));
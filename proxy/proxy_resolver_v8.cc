@@ -7,9 +7,11 @@
 #include <algorithm>
 #include <cstdio>
 #include <utility>
+#include <vector>
 
 #include "base/auto_reset.h"
 #include "base/compiler_specific.h"
+#include "base/containers/circular_deque.h"
 #include "base/debug/leak_annotations.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -418,6 +420,60 @@ class SharedIsolateFactory {
 base::LazyInstance<SharedIsolateFactory>::Leaky g_isolate_factory =
     LAZY_INSTANCE_INITIALIZER;
 
+// The V8 code caches of the most recently compiled PAC scripts. Since all
+// instances of ProxyResolverV8 share the same isolate, this lets each instance
+// for the same script, e.g. one per thread of a MultiThreadedProxyResolver,
+// skip compiling it from scratch.
+class SharedCodeCache {
+ public:
+  SharedCodeCache() = default;
+
+  // Returns the code cache for |script|, or an empty vector if there is none.
+  std::vector<uint8_t> Get(const ProxyResolverScriptData* script) {
+    base::AutoLock lock(lock_);
+    for (const Entry& entry : entries_) {
+      if (entry.script->Equals(script))
+        return entry.data;
+    }
+    return std::vector<uint8_t>();
+  }
+
+  void Set(const scoped_refptr<ProxyResolverScriptData>& script,
+           const uint8_t* data,
+           int length) {
+    base::AutoLock lock(lock_);
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->script->Equals(script.get())) {
+        entries_.erase(it);
+        break;
+      }
+    }
+    if (entries_.size() == kMaxEntries)
+      entries_.pop_back();
+    entries_.push_front(Entry());
+    entries_.front().script = script;
+    entries_.front().data.assign(data, data + length);
+  }
+
+ private:
+  struct Entry {
+    scoped_refptr<ProxyResolverScriptData> script;
+    std::vector<uint8_t> data;
+  };
+
+  // Usually there is a single PAC script in use at a time.
+  static const size_t kMaxEntries = 2;
+
+  base::Lock lock_;
+  // Most recently set first.
+  base::circular_deque<Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedCodeCache);
+};
+
+base::LazyInstance<SharedCodeCache>::Leaky g_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // ProxyResolverV8::Context ---------------------------------------------------
@@ -577,15 +633,15 @@ class ProxyResolverV8::Context {
             isolate_,
             PROXY_RESOLVER_SCRIPT
             PROXY_RESOLVER_SCRIPT_EX),
-        kPacUtilityResourceName);
+        kPacUtilityResourceName, nullptr);
     if (rv != OK) {
       NOTREACHED();
       return rv;
     }
 
     // Add the user's PAC code to the environment.
-    rv =
-        RunScript(ScriptDataToV8String(isolate_, pac_script), kPacResourceName);
+    rv = RunScript(ScriptDataToV8String(isolate_, pac_script), kPacResourceName,
+                   pac_script);
     if (rv != OK)
       return rv;
 
@@ -646,27 +702,57 @@ class ProxyResolverV8::Context {
     js_bindings()->OnError(line_number, error_message);
   }
 
-  // Compiles and runs |script| in the current V8 context.
+  // Compiles and runs |script| in the current V8 context. If |script_data| is
+  // not null, it is the source of |script|, and the compiled code is shared
+  // through |g_code_cache|.
   // Returns OK on success, otherwise an error code.
-  int RunScript(v8::Local<v8::String> script, const char* script_name) {
+  int RunScript(v8::Local<v8::String> script,
+                const char* script_name,
+                const scoped_refptr<ProxyResolverScriptData>& script_data) {
     v8::Local<v8::Context> context =
         v8::Local<v8::Context>::New(isolate_, v8_context_);
     v8::TryCatch try_catch(isolate_);
 
+    // |code_cache| must outlive |script_source|, which refers to it.
+    std::vector<uint8_t> code_cache;
+    if (script_data)
+      code_cache = g_code_cache.Get().Get(script_data.get());
+
     // Compile the script.
     v8::ScriptOrigin origin =
         v8::ScriptOrigin(ASCIILiteralToV8String(isolate_, script_name));
-    v8::ScriptCompiler::Source script_source(script, origin);
+    v8::ScriptCompiler::Source script_source(
+        script, origin,
+        code_cache.empty() ? nullptr
+                           : new v8::ScriptCompiler::CachedData(
+                                 code_cache.data(),
+                                 static_cast<int>(code_cache.size())));
     v8::Local<v8::Script> code;
     if (!v8::ScriptCompiler::Compile(
-             context, &script_source, v8::ScriptCompiler::kNoCompileOptions,
-             v8::ScriptCompiler::NoCacheReason::kNoCacheBecausePacScript)
+             context, &script_source,
+             code_cache.empty() ? v8::ScriptCompiler::kNoCompileOptions
+                                : v8::ScriptCompiler::kConsumeCodeCache,
+             code_cache.empty()
+                 ? v8::ScriptCompiler::NoCacheReason::kNoCacheBecausePacScript
+                 : v8::ScriptCompiler::NoCacheReason::kNoCacheNoReason)
              .ToLocal(&code)) {
       DCHECK(try_catch.HasCaught());
       HandleError(try_catch.Message());
       return ERR_PAC_SCRIPT_FAILED;
     }
 
+    // V8 rejects the code cache if it doesn't match the script or the V8
+    // flags, in which case it is replaced.
+    if (script_data &&
+        (code_cache.empty() || script_source.GetCachedData()->rejected)) {
+      std::unique_ptr<v8::ScriptCompiler::CachedData> new_code_cache(
+          v8::ScriptCompiler::CreateCodeCache(code->GetUnboundScript()));
+      if (new_code_cache) {
+        g_code_cache.Get().Set(script_data, new_code_cache->data,
+                               new_code_cache->length);
+      }
+    }
+
     // Execute.
     auto result = code->Run(context);
     if (result.IsEmpty()) {
@@ -279,6 +279,38 @@ TEST_F(ProxyResolverV8Test, SideEffects) {
   }
 }
 
+// Create several resolvers for the same script, which share its compiled code,
+// and for a different script of the same length, which must not.
+TEST_F(ProxyResolverV8Test, SameScriptInSeveralResolvers) {
+  const char kScript1[] =
+      "function FindProxyForURL(url, host) { return 'PROXY foo1:80'; }";
+  const char kScript2[] =
+      "function FindProxyForURL(url, host) { return 'PROXY foo2:80'; }";
+
+  std::unique_ptr<ProxyResolverV8> resolvers[3];
+  ASSERT_THAT(
+      ProxyResolverV8::Create(ProxyResolverScriptData::FromUTF8(kScript1),
+                              bindings(), &resolvers[0]),
+      IsOk());
+  ASSERT_THAT(
+      ProxyResolverV8::Create(ProxyResolverScriptData::FromUTF8(kScript1),
+                              bindings(), &resolvers[1]),
+      IsOk());
+  ASSERT_THAT(
+      ProxyResolverV8::Create(ProxyResolverScriptData::FromUTF8(kScript2),
+                              bindings(), &resolvers[2]),
+      IsOk());
+
+  const char* const kExpectedProxies[] = {"foo1:80", "foo1:80", "foo2:80"};
+  for (size_t i = 0; i < arraysize(resolvers); ++i) {
+    ProxyInfo proxy_info;
+    EXPECT_THAT(
+        resolvers[i]->GetProxyForURL(kQueryUrl, &proxy_info, bindings()),
+        IsOk());
+    EXPECT_EQ(kExpectedProxies[i], proxy_info.proxy_server().ToURI());
+  }
+}
+
 // Execute a PAC script which throws an exception in FindProxyForURL.
 TEST_F(ProxyResolverV8Test, UnhandledException) {
   ASSERT_THAT(CreateResolver("unhandled_exception.js"), IsOk());
@@ -12,6 +12,7 @@
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/sparse_histogram.h"
+#include "base/power_monitor/power_monitor.h"
 #include "base/single_thread_task_runner.h"
 #include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
@@ -75,6 +76,16 @@ const size_t kMinRetryTimeForDefaultNetworkSecs = 1;
 // network.
 const int kDefaultRTTMilliSecs = 300;
 
+// Interval at which the path to the alternate network is validated ahead of a
+// migration, which also keeps NAT bindings on it alive. Validation is less
+// frequent on battery power.
+const int kPrevalidationIntervalSecs = 30;
+const int kPrevalidationIntervalOnBatterySecs = 120;
+
+// Maximum number of connectivity probing packets sent to validate the path to
+// the alternate network over the lifetime of a session.
+const size_t kMaxPrevalidationPackets = 64;
+
 // The maximum size of uncompressed QUIC headers that will be allowed.
 const size_t kMaxUncompressedHeaderSize = 256 * 1024;
 
@@ -661,6 +672,7 @@ QuicChromiumClientSession::QuicChromiumClientSession(
     bool migrate_sessions_on_network_change,
     bool migrate_session_early_v2,
     bool migrate_sessions_on_network_change_v2,
+    bool prevalidate_alternate_network,
     int yield_after_packets,
     QuicTime::Delta yield_after_duration,
     int cert_verify_flags,
@@ -682,6 +694,7 @@ QuicChromiumClientSession::QuicChromiumClientSession(
       migrate_session_early_v2_(migrate_session_early_v2),
       migrate_session_on_network_change_v2_(
           migrate_sessions_on_network_change_v2),
+      prevalidate_alternate_network_(prevalidate_alternate_network),
       clock_(clock),
       yield_after_packets_(yield_after_packets),
       yield_after_duration_(yield_after_duration),
@@ -712,6 +725,10 @@ QuicChromiumClientSession::QuicChromiumClientSession(
       probing_manager_(this, task_runner_),
       retry_migrate_back_count_(0),
       migration_pending_(false),
+      prevalidating_network_(NetworkChangeNotifier::kInvalidNetworkHandle),
+      prevalidated_network_(NetworkChangeNotifier::kInvalidNetworkHandle),
+      prevalidated_path_expiry_(QuicTime::Zero()),
+      prevalidation_packets_sent_(0),
       weak_factory_(this) {
   default_network_ = socket->GetBoundNetwork();
   sockets_.push_back(std::move(socket));
@@ -1337,6 +1354,7 @@ void QuicChromiumClientSession::OnCryptoHandshakeEvent(
     }
 
     NotifyRequestsOfConfirmation(OK);
+    MaybePrevalidateAlternateNetwork();
   }
   QuicSpdySession::OnCryptoHandshakeEvent(event);
 }
@@ -1635,10 +1653,38 @@ void QuicChromiumClientSession::OnProbeNetworkSucceeded(
   DCHECK(writer);
   DCHECK(reader);
 
+  if (network == prevalidating_network_) {
+    // Keep the validated path, and keep reading from it, until the current
+    // path degrades.
+    prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+    net_log_.AddEvent(
+        NetLogEventType::QUIC_CONNECTION_ALTERNATE_NETWORK_PREVALIDATED,
+        NetLog::Int64Callback("network", network));
+    writer->set_delegate(this);
+    prevalidated_network_ = network;
+    prevalidated_self_address_ = self_address;
+    prevalidated_socket_ = std::move(socket);
+    prevalidated_writer_ = std::move(writer);
+    prevalidated_reader_ = std::move(reader);
+    prevalidated_path_expiry_ =
+        clock_->Now() + QuicTime::Delta::FromMicroseconds(
+                            2 * GetPrevalidationInterval().InMicroseconds());
+    return;
+  }
+
   net_log_.AddEvent(
       NetLogEventType::QUIC_CONNECTION_CONNECTIVITY_PROBING_SUCCEEDED,
       NetLog::Int64Callback("network", network));
+  MigrateToProbedSocket(network, self_address, std::move(socket),
+                        std::move(writer), std::move(reader));
+}
 
+void QuicChromiumClientSession::MigrateToProbedSocket(
+    NetworkChangeNotifier::NetworkHandle network,
+    const QuicSocketAddress& self_address,
+    std::unique_ptr<DatagramClientSocket> socket,
+    std::unique_ptr<QuicChromiumPacketWriter> writer,
+    std::unique_ptr<QuicChromiumPacketReader> reader) {
   // Set |this| to listen on socket write events on the packet writer
   // that was used for probing.
   writer->set_delegate(this);
@@ -1666,6 +1712,8 @@ void QuicChromiumClientSession::OnProbeNetworkSucceeded(
 
 void QuicChromiumClientSession::OnProbeNetworkFailed(
     NetworkChangeNotifier::NetworkHandle network) {
+  if (network == prevalidating_network_)
+    prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
   net_log_.AddEvent(
       NetLogEventType::QUIC_CONNECTION_CONNECTIVITY_PROBING_FAILED,
       NetLog::Int64Callback("network", network));
@@ -1680,6 +1728,8 @@ void QuicChromiumClientSession::OnProbeNetworkFailed(
 bool QuicChromiumClientSession::OnSendConnectivityProbingPacket(
     QuicChromiumPacketWriter* writer,
     const QuicSocketAddress& peer_address) {
+  if (prevalidating_network_ != NetworkChangeNotifier::kInvalidNetworkHandle)
+    ++prevalidation_packets_sent_;
   return connection()->SendConnectivityProbingPacket(writer, peer_address);
 }
 
@@ -1690,8 +1740,11 @@ void QuicChromiumClientSession::OnNetworkConnected(
       NetLogEventType::QUIC_CONNECTION_MIGRATION_ON_NETWORK_CONNECTED);
   // If migration_pending_ is false, there was no migration pending or
   // an earlier task completed migration.
-  if (!migration_pending_)
+  if (!migration_pending_) {
+    // |network| may be a better alternate network than the one validated.
+    MaybePrevalidateAlternateNetwork();
     return;
+  }
 
   // |migration_pending_| is true, there was no working network previously.
   // |network| is now the only possible candidate, migrate immediately.
@@ -1732,6 +1785,10 @@ void QuicChromiumClientSession::OnNetworkDisconnectedV2(
 
   // Stop probing the disconnected network if there is one.
   probing_manager_.CancelProbing(disconnected_network);
+  if (disconnected_network == prevalidated_network_ ||
+      disconnected_network == prevalidating_network_) {
+    ResetPrevalidatedPath();
+  }
 
   // Ignore the signal if the current active network is not affected.
   if (GetDefaultSocket()->GetBoundNetwork() != disconnected_network) {
@@ -1851,12 +1908,17 @@ void QuicChromiumClientSession::OnPathDegrading() {
           stream_factory_->FindAlternateNetwork(
               GetDefaultSocket()->GetBoundNetwork());
       if (alternate_network != NetworkChangeNotifier::kInvalidNetworkHandle) {
-        // Probe alternative network, we will migrate to the probed network
-        // and decide whether we want to migrate back to the default network
-        // on success.
-        StartProbeNetwork(alternate_network,
-                          connection()->peer_address().impl().socket_address(),
-                          migration_net_log);
+        // Use the path to the alternate network if it has been validated
+        // already. Otherwise probe alternative network, we will migrate to the
+        // probed network and decide whether we want to migrate back to the
+        // default network on success.
+        if (!MigrateToPrevalidatedNetwork(alternate_network,
+                                          migration_net_log)) {
+          StartProbeNetwork(
+              alternate_network,
+              connection()->peer_address().impl().socket_address(),
+              migration_net_log);
+        }
       } else {
         HistogramAndLogMigrationFailure(
             migration_net_log, MIGRATION_STATUS_DISABLED, connection_id(),
@@ -2041,6 +2103,16 @@ ProbingResult QuicChromiumClientSession::StartProbeNetwork(
     return ProbingResult::DISABLED_BY_NON_MIGRABLE_STREAM;
   }
 
+  // The session migrates on success of this probe, even if it was started to
+  // validate the path ahead of time.
+  prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  return ProbeNetwork(network, peer_address, migration_net_log);
+}
+
+ProbingResult QuicChromiumClientSession::ProbeNetwork(
+    NetworkChangeNotifier::NetworkHandle network,
+    IPEndPoint peer_address,
+    const NetLogWithSource& migration_net_log) {
   // Check if probing manager is probing the same path.
   if (probing_manager_.IsUnderProbing(
           network, QuicSocketAddress(QuicSocketAddressImpl(peer_address)))) {
@@ -2066,6 +2138,14 @@ ProbingResult QuicChromiumClientSession::StartProbeNetwork(
                                    yield_after_packets_, yield_after_duration_,
                                    net_log_));
 
+  probing_manager_.StartProbing(
+      network, QuicSocketAddress(QuicSocketAddressImpl(peer_address)),
+      std::move(probing_socket), std::move(probing_writer),
+      std::move(probing_reader), GetInitialProbingTimeout(), net_log_);
+  return ProbingResult::PENDING;
+}
+
+base::TimeDelta QuicChromiumClientSession::GetInitialProbingTimeout() const {
   int rtt_ms = connection()
                    ->sent_packet_manager()
                    .GetRttStats()
@@ -2073,14 +2153,117 @@ ProbingResult QuicChromiumClientSession::StartProbeNetwork(
                    .ToMilliseconds();
   if (rtt_ms == 0 || rtt_ms > kDefaultRTTMilliSecs)
     rtt_ms = kDefaultRTTMilliSecs;
-  int timeout_ms = rtt_ms * 2;
+  return base::TimeDelta::FromMilliseconds(rtt_ms * 2);
+}
 
-  probing_manager_.StartProbing(
-      network, QuicSocketAddress(QuicSocketAddressImpl(peer_address)),
-      std::move(probing_socket), std::move(probing_writer),
-      std::move(probing_reader), base::TimeDelta::FromMilliseconds(timeout_ms),
-      net_log_);
-  return ProbingResult::PENDING;
+base::TimeDelta QuicChromiumClientSession::GetPrevalidationInterval() const {
+  base::PowerMonitor* power_monitor = base::PowerMonitor::Get();
+  if (power_monitor && power_monitor->IsOnBatteryPower())
+    return base::TimeDelta::FromSeconds(kPrevalidationIntervalOnBatterySecs);
+  return base::TimeDelta::FromSeconds(kPrevalidationIntervalSecs);
+}
+
+void QuicChromiumClientSession::MaybePrevalidateAlternateNetwork() {
+  if (!prevalidate_alternate_network_ || !stream_factory_ ||
+      !connection()->connected()) {
+    return;
+  }
+
+  if (prevalidation_packets_sent_ >= kMaxPrevalidationPackets) {
+    // The budget is spent. A validated path is still used until it expires.
+    prevalidation_timer_.Stop();
+    return;
+  }
+  prevalidation_timer_.Start(
+      FROM_HERE, GetPrevalidationInterval(),
+      base::Bind(&QuicChromiumClientSession::MaybePrevalidateAlternateNetwork,
+                 weak_factory_.GetWeakPtr()));
+
+  // Only validate paths for sessions which would migrate.
+  if (!IsCryptoHandshakeConfirmed() || GetNumActiveStreams() == 0 ||
+      config()->DisableConnectionMigration() || HasNonMigratableStreams()) {
+    return;
+  }
+
+  const QuicSocketAddress& peer_address = connection()->peer_address();
+  if (prevalidating_network_ != NetworkChangeNotifier::kInvalidNetworkHandle &&
+      !probing_manager_.IsUnderProbing(prevalidating_network_, peer_address)) {
+    // The probe was cancelled.
+    prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  }
+
+  NetworkChangeNotifier::NetworkHandle alternate_network =
+      stream_factory_->FindAlternateNetwork(
+          GetDefaultSocket()->GetBoundNetwork());
+  if (alternate_network != prevalidated_network_ &&
+      alternate_network != prevalidating_network_) {
+    ResetPrevalidatedPath();
+  }
+  if (alternate_network == NetworkChangeNotifier::kInvalidNetworkHandle ||
+      prevalidating_network_ != NetworkChangeNotifier::kInvalidNetworkHandle) {
+    return;
+  }
+  // Don't interrupt a probe started for migration.
+  if (probing_manager_.IsProbing())
+    return;
+
+  prevalidating_network_ = alternate_network;
+  if (prevalidated_network_ == alternate_network) {
+    // Revalidate the path over the same socket, which keeps the bindings it
+    // has created alive.
+    prevalidated_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+    prevalidated_self_address_ = QuicSocketAddress();
+    probing_manager_.StartProbing(
+        alternate_network, peer_address, std::move(prevalidated_socket_),
+        std::move(prevalidated_writer_), std::move(prevalidated_reader_),
+        GetInitialProbingTimeout(), net_log_);
+    return;
+  }
+  if (ProbeNetwork(alternate_network, peer_address.impl().socket_address(),
+                   net_log_) != ProbingResult::PENDING) {
+    prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  }
+}
+
+bool QuicChromiumClientSession::MigrateToPrevalidatedNetwork(
+    NetworkChangeNotifier::NetworkHandle network,
+    const NetLogWithSource& migration_net_log) {
+  if (network != prevalidated_network_)
+    return false;
+
+  if (clock_->Now() >= prevalidated_path_expiry_) {
+    ResetPrevalidatedPath();
+    return false;
+  }
+
+  // Leave it to StartProbeNetwork() to handle sessions which cannot migrate.
+  if (GetNumActiveStreams() == 0 || config()->DisableConnectionMigration() ||
+      HasNonMigratableStreams()) {
+    return false;
+  }
+
+  migration_net_log.AddEvent(
+      NetLogEventType::QUIC_CONNECTION_MIGRATION_TO_PREVALIDATED_NETWORK,
+      NetLog::Int64Callback("network", network));
+  prevalidated_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  QuicSocketAddress self_address = prevalidated_self_address_;
+  prevalidated_self_address_ = QuicSocketAddress();
+  MigrateToProbedSocket(network, self_address, std::move(prevalidated_socket_),
+                        std::move(prevalidated_writer_),
+                        std::move(prevalidated_reader_));
+  return true;
+}
+
+void QuicChromiumClientSession::ResetPrevalidatedPath() {
+  if (prevalidating_network_ != NetworkChangeNotifier::kInvalidNetworkHandle) {
+    probing_manager_.CancelProbing(prevalidating_network_);
+    prevalidating_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  }
+  prevalidated_network_ = NetworkChangeNotifier::kInvalidNetworkHandle;
+  prevalidated_self_address_ = QuicSocketAddress();
+  prevalidated_reader_.reset();
+  prevalidated_writer_.reset();
+  prevalidated_socket_.reset();
 }
 
 void QuicChromiumClientSession::StartMigrateBackToDefaultNetworkTimer(
@@ -2297,6 +2480,13 @@ void QuicChromiumClientSession::OnReadError(
     int result,
     const DatagramClientSocket* socket) {
   DCHECK(socket != nullptr);
+  if (socket == prevalidated_socket_.get()) {
+    // The validated path is no longer usable. The reader is done with the
+    // socket once it reports the error.
+    DVLOG(1) << "Dropping validated path on read error: " << result;
+    ResetPrevalidatedPath();
+    return;
+  }
   if (socket != GetDefaultSocket()) {
     // Ignore read errors from old sockets that are no longer active.
     // TODO(jri): Maybe clean up old sockets on error.
@@ -2483,6 +2673,7 @@ bool QuicChromiumClientSession::MigrateToSocket(
   // Block the writer to prevent it being used until WriteToNewSocket
   // completes.
   writer->set_write_blocked(true);
+  writer->set_batch_mode(connection()->writer()->IsBatchMode());
   connection()->SetQuicPacketWriter(writer.release(), /*owns_writer=*/true);
 
   // Post task to write the pending packet or a PING packet to the new
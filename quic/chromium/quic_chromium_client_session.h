@@ -332,6 +332,7 @@ class NET_EXPORT_PRIVATE QuicChromiumClientSession
       bool migrate_session_on_network_change,
       bool migrate_sesion_early_v2,
       bool migrate_session_on_network_change_v2,
+      bool prevalidate_alternate_network,
       int yield_after_packets,
       QuicTime::Delta yield_after_duration,
       int cert_verify_flags,
@@ -632,6 +633,39 @@ class NET_EXPORT_PRIVATE QuicChromiumClientSession
                                   IPEndPoint peer_address,
                                   const NetLogWithSource& migration_net_log);
 
+  // Starts probing |network| to |peer_address|, without checking whether this
+  // session may migrate.
+  ProbingResult ProbeNetwork(NetworkChangeNotifier::NetworkHandle network,
+                             IPEndPoint peer_address,
+                             const NetLogWithSource& migration_net_log);
+
+  base::TimeDelta GetInitialProbingTimeout() const;
+
+  // Migrates to |socket| on |network|, which has been probed successfully.
+  void MigrateToProbedSocket(NetworkChangeNotifier::NetworkHandle network,
+                             const QuicSocketAddress& self_address,
+                             std::unique_ptr<DatagramClientSocket> socket,
+                             std::unique_ptr<QuicChromiumPacketWriter> writer,
+                             std::unique_ptr<QuicChromiumPacketReader> reader);
+
+  // Returns how often the path to the alternate network is validated.
+  base::TimeDelta GetPrevalidationInterval() const;
+
+  // Validates the path to the alternate network, if there is one, so that
+  // the session can migrate to it without probing when the current path
+  // degrades. Schedules the next validation, within the budget of probing
+  // packets.
+  void MaybePrevalidateAlternateNetwork();
+
+  // Migrates to the validated path to |network|, if there is one which has not
+  // expired. Returns false if there is none, or if the session cannot migrate.
+  bool MigrateToPrevalidatedNetwork(
+      NetworkChangeNotifier::NetworkHandle network,
+      const NetLogWithSource& migration_net_log);
+
+  // Discards the validated path, and stops validating one.
+  void ResetPrevalidatedPath();
+
   // Called when there is only one possible working network: |network|, If any
   // error encountered, this session will be cloed. When the migration succeeds:
   //  - If we are no longer on the default interface, migrate back to default
@@ -669,6 +703,7 @@ class NET_EXPORT_PRIVATE QuicChromiumClientSession
   bool migrate_session_on_network_change_;
   bool migrate_session_early_v2_;
   bool migrate_session_on_network_change_v2_;
+  bool prevalidate_alternate_network_;
   QuicClock* clock_;  // Unowned.
   int yield_after_packets_;
   QuicTime::Delta yield_after_duration_;
@@ -726,6 +761,20 @@ class NET_EXPORT_PRIVATE QuicChromiumClientSession
   // sockets_.size(). Then in MigrateSessionOnError, check to see if
   // the current sockets_.size() == the passed in value.
   bool migration_pending_;  // True while migration is underway.
+  // The alternate network which is being probed to validate the path to it
+  // ahead of a migration, or kInvalidNetworkHandle.
+  NetworkChangeNotifier::NetworkHandle prevalidating_network_;
+  // The path to the alternate network which has been validated, and which the
+  // session migrates to when the current path degrades. Its reader keeps
+  // reading.
+  NetworkChangeNotifier::NetworkHandle prevalidated_network_;
+  QuicSocketAddress prevalidated_self_address_;
+  std::unique_ptr<DatagramClientSocket> prevalidated_socket_;
+  std::unique_ptr<QuicChromiumPacketWriter> prevalidated_writer_;
+  std::unique_ptr<QuicChromiumPacketReader> prevalidated_reader_;
+  QuicTime prevalidated_path_expiry_;
+  size_t prevalidation_packets_sent_;
+  base::OneShotTimer prevalidation_timer_;
   base::WeakPtrFactory<QuicChromiumClientSession> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicChromiumClientSession);
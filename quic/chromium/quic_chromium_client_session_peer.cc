@@ -37,5 +37,12 @@ uint64_t QuicChromiumClientSessionPeer::GetPushedAndUnclaimedBytesCount(
     QuicChromiumClientSession* session) {
   return session->bytes_pushed_and_unclaimed_count_;
 }
+
+// static
+void QuicChromiumClientSessionPeer::SetPrevalidationPacketsSent(
+    QuicChromiumClientSession* session,
+    size_t packets_sent) {
+  session->prevalidation_packets_sent_ = packets_sent;
+}
 }  // namespace test
 }  // namespace net
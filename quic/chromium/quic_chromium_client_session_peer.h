@@ -32,6 +32,9 @@ class QuicChromiumClientSessionPeer {
   static uint64_t GetPushedAndUnclaimedBytesCount(
       QuicChromiumClientSession* session);
 
+  static void SetPrevalidationPacketsSent(QuicChromiumClientSession* session,
+                                          size_t packets_sent);
+
  private:
   DISALLOW_COPY_AND_ASSIGN(QuicChromiumClientSessionPeer);
 };
@@ -136,6 +136,7 @@ class QuicChromiumClientSessionTest
         /*migrate_session_on_network_change*/ false,
         /*migrate_session_early_v2*/ false,
         /*migrate_session_on_network_change_v2*/ false,
+        /*prevalidate_alternate_network*/ false,
         kQuicYieldAfterPacketsRead,
         QuicTime::Delta::FromMilliseconds(kQuicYieldAfterDurationMilliseconds),
         /*cert_verify_flags=*/0, DefaultQuicConfig(), &crypto_config_,
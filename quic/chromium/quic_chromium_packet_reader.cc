@@ -28,9 +28,13 @@ QuicChromiumPacketReader::QuicChromiumPacketReader(
       yield_after_packets_(yield_after_packets),
       yield_after_duration_(yield_after_duration),
       yield_after_(QuicTime::Infinite()),
-      read_buffer_(new IOBufferWithSize(static_cast<size_t>(kMaxPacketSize))),
       net_log_(net_log),
-      weak_factory_(this) {}
+      weak_factory_(this) {
+  for (int i = 0; i < kQuicMaxPacketsPerRead; ++i) {
+    read_buffers_.push_back(
+        new IOBufferWithSize(static_cast<size_t>(kMaxPacketSize)));
+  }
+}
 
 QuicChromiumPacketReader::~QuicChromiumPacketReader() {}
 
@@ -44,16 +48,18 @@ void QuicChromiumPacketReader::StartReading() {
 
     DCHECK(socket_);
     read_pending_ = true;
-    int rv = socket_->Read(read_buffer_.get(), read_buffer_->size(),
-                           base::Bind(&QuicChromiumPacketReader::OnReadComplete,
-                                      weak_factory_.GetWeakPtr()));
+    int rv = socket_->ReadMultiple(
+        read_buffers_, static_cast<int>(kMaxPacketSize), read_lengths_,
+        base::Bind(&QuicChromiumPacketReader::OnReadComplete,
+                   weak_factory_.GetWeakPtr()));
     UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.AsyncRead", rv == ERR_IO_PENDING);
     if (rv == ERR_IO_PENDING) {
       num_packets_read_ = 0;
       return;
     }
 
-    if (++num_packets_read_ > yield_after_packets_ ||
+    num_packets_read_ += rv > 0 ? rv : 1;
+    if (num_packets_read_ > yield_after_packets_ ||
         clock_->Now() > yield_after_) {
       num_packets_read_ = 0;
       // Data was read, process it.
@@ -71,8 +77,8 @@ void QuicChromiumPacketReader::StartReading() {
 }
 
 size_t QuicChromiumPacketReader::EstimateMemoryUsage() const {
-  // Return the size of |read_buffer_|.
-  return kMaxPacketSize;
+  // Return the size of |read_buffers_|.
+  return kQuicMaxPacketsPerRead * kMaxPacketSize;
 }
 
 bool QuicChromiumPacketReader::ProcessReadResult(int result) {
@@ -85,14 +91,28 @@ bool QuicChromiumPacketReader::ProcessReadResult(int result) {
     return false;
   }
 
-  QuicReceivedPacket packet(read_buffer_->data(), result, clock_->Now());
   IPEndPoint local_address;
   IPEndPoint peer_address;
   socket_->GetLocalAddress(&local_address);
   socket_->GetPeerAddress(&peer_address);
-  return visitor_->OnPacket(
-      packet, QuicSocketAddress(QuicSocketAddressImpl(local_address)),
-      QuicSocketAddress(QuicSocketAddressImpl(peer_address)));
+  const QuicSocketAddress quic_local_address =
+      QuicSocketAddress(QuicSocketAddressImpl(local_address));
+  const QuicSocketAddress quic_peer_address =
+      QuicSocketAddress(QuicSocketAddressImpl(peer_address));
+  for (int i = 0; i < result; ++i) {
+    if (read_lengths_[i] == 0) {
+      visitor_->OnReadError(ERR_CONNECTION_CLOSED, socket_);
+      return false;
+    }
+    char* data = read_buffers_[i]->data();
+    QuicReceivedPacket packet(data, read_lengths_[i], clock_->Now());
+    packet.set_mutable_data(data);
+    // The visitor may have closed the connection, in which case the rest of
+    // the batch is dropped.
+    if (!visitor_->OnPacket(packet, quic_local_address, quic_peer_address))
+      return false;
+  }
+  return true;
 }
 
 void QuicChromiumPacketReader::OnReadComplete(int result) {
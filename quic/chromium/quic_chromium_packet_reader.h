@@ -6,6 +6,8 @@
 #ifndef NET_QUIC_CHROMIUM_QUIC_CHROMIUM_PACKET_READER_H_
 #define NET_QUIC_CHROMIUM_QUIC_CHROMIUM_PACKET_READER_H_
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "net/base/io_buffer.h"
@@ -25,6 +27,10 @@ class QuicClock;
 const int kQuicYieldAfterPacketsRead = 32;
 const int kQuicYieldAfterDurationMilliseconds = 2;
 
+// The maximum number of packets QuicChromiumPacketReader reads from the socket
+// in one batch, and processes without returning to the message loop.
+const int kQuicMaxPacketsPerRead = 16;
+
 class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
  public:
   class NET_EXPORT_PRIVATE Visitor {
@@ -55,7 +61,8 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
  private:
   // A completion callback invoked when a read completes.
   void OnReadComplete(int result);
-  // Return true if reading should continue.
+  // Processes the packets read into the first |result| of |read_buffers_|,
+  // or the read error. Return true if reading should continue.
   bool ProcessReadResult(int result);
 
   DatagramClientSocket* socket_;
@@ -66,7 +73,9 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketReader {
   int yield_after_packets_;
   QuicTime::Delta yield_after_duration_;
   QuicTime yield_after_;
-  scoped_refptr<IOBufferWithSize> read_buffer_;
+  // Reused for every read.
+  std::vector<scoped_refptr<IOBuffer>> read_buffers_;
+  int read_lengths_[kQuicMaxPacketsPerRead];
   NetLogWithSource net_log_;
 
   base::WeakPtrFactory<QuicChromiumPacketReader> weak_factory_;
@@ -4,6 +4,7 @@
 
 #include "net/quic/chromium/quic_chromium_packet_writer.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/location.h"
@@ -13,6 +14,7 @@
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 #include "net/quic/chromium/quic_chromium_client_session.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
 
 namespace net {
 
@@ -27,6 +29,9 @@ enum NotReusableReason {
 
 const int kMaxRetries = 12;  // 2^12 = 4 seconds, which should be a LOT.
 
+// The maximum number of packets held in batch mode before they are sent.
+const size_t kMaxPacketsPerBatch = 32;
+
 void RecordNotReusableReason(NotReusableReason reason) {
   UMA_HISTOGRAM_ENUMERATION("Net.QuicSession.WritePacketNotReusable", reason,
                             NUM_NOT_REUSABLE_REASONS);
@@ -52,7 +57,8 @@ void QuicChromiumPacketWriter::ReusableIOBuffer::Set(const char* buffer,
   std::memcpy(data(), buffer, buf_len);
 }
 
-QuicChromiumPacketWriter::QuicChromiumPacketWriter() : weak_factory_(this) {}
+QuicChromiumPacketWriter::QuicChromiumPacketWriter()
+    : batch_mode_(false), weak_factory_(this) {}
 
 QuicChromiumPacketWriter::QuicChromiumPacketWriter(
     DatagramClientSocket* socket,
@@ -61,11 +67,15 @@ QuicChromiumPacketWriter::QuicChromiumPacketWriter(
       delegate_(nullptr),
       packet_(new ReusableIOBuffer(kMaxPacketSize)),
       write_blocked_(false),
+      batch_mode_(false),
       retry_count_(0),
       weak_factory_(this) {
   retry_timer_.SetTaskRunner(task_runner);
   write_callback_ = base::Bind(&QuicChromiumPacketWriter::OnWriteComplete,
                                weak_factory_.GetWeakPtr());
+  batch_write_callback_ =
+      base::Bind(&QuicChromiumPacketWriter::OnBatchWriteComplete,
+                 weak_factory_.GetWeakPtr());
 }
 
 QuicChromiumPacketWriter::~QuicChromiumPacketWriter() {}
@@ -95,6 +105,15 @@ WriteResult QuicChromiumPacketWriter::WritePacket(
     const QuicSocketAddress& peer_address,
     PerPacketOptions* /*options*/) {
   DCHECK(!IsWriteBlocked());
+  if (batch_mode_) {
+    AddToBatch(buffer, buf_len);
+    if (batch_.size() < kMaxPacketsPerBatch)
+      return WriteResult(WRITE_STATUS_OK, buf_len);
+    WriteResult result = Flush();
+    if (result.status == WRITE_STATUS_OK)
+      result.bytes_written = buf_len;
+    return result;
+  }
   SetPacket(buffer, buf_len);
   return WritePacketToSocketImpl();
 }
@@ -108,7 +127,19 @@ WriteResult QuicChromiumPacketWriter::WritePacketToSocket(
 WriteResult QuicChromiumPacketWriter::WritePacketToSocketImpl() {
   base::TimeTicks now = base::TimeTicks::Now();
   int rv = socket_->Write(packet_.get(), packet_->size(), write_callback_);
+  WriteResult result = ProcessWriteResult(rv);
+
+  base::TimeDelta delta = base::TimeTicks::Now() - now;
+  if (result.status == WRITE_STATUS_OK) {
+    UMA_HISTOGRAM_TIMES("Net.QuicSession.PacketWriteTime.Synchronous", delta);
+  } else if (result.status == WRITE_STATUS_BLOCKED) {
+    UMA_HISTOGRAM_TIMES("Net.QuicSession.PacketWriteTime.Asynchronous", delta);
+  }
+
+  return result;
+}
 
+WriteResult QuicChromiumPacketWriter::ProcessWriteResult(int rv) {
   if (MaybeRetryAfterWriteError(rv))
     return WriteResult(WRITE_STATUS_BLOCKED, ERR_IO_PENDING);
 
@@ -130,14 +161,66 @@ WriteResult QuicChromiumPacketWriter::WritePacketToSocketImpl() {
     }
   }
 
-  base::TimeDelta delta = base::TimeTicks::Now() - now;
-  if (status == WRITE_STATUS_OK) {
-    UMA_HISTOGRAM_TIMES("Net.QuicSession.PacketWriteTime.Synchronous", delta);
-  } else if (status == WRITE_STATUS_BLOCKED) {
-    UMA_HISTOGRAM_TIMES("Net.QuicSession.PacketWriteTime.Asynchronous", delta);
+  return WriteResult(status, rv);
+}
+
+void QuicChromiumPacketWriter::AddToBatch(const char* buffer, size_t buf_len) {
+  scoped_refptr<ReusableIOBuffer> packet;
+  if (!spare_buffers_.empty()) {
+    packet = std::move(spare_buffers_.back());
+    spare_buffers_.pop_back();
+  }
+  // The socket may still hold a reference to a buffer of a batch it sent.
+  if (!packet || !packet->HasOneRef() || packet->capacity() < buf_len) {
+    packet = new ReusableIOBuffer(
+        std::max(buf_len, static_cast<size_t>(kMaxPacketSize)));
+  }
+  packet->Set(buffer, buf_len);
+  batch_.push_back(std::move(packet));
+}
+
+int QuicChromiumPacketWriter::WriteBatchToSocket() {
+  while (!batch_.empty()) {
+    std::vector<scoped_refptr<IOBuffer>> bufs(batch_.begin(), batch_.end());
+    std::vector<int> lengths;
+    lengths.reserve(batch_.size());
+    for (const auto& packet : batch_)
+      lengths.push_back(packet->size());
+    int rv = socket_->WriteMultiple(bufs, lengths, batch_write_callback_,
+                                    NO_TRAFFIC_ANNOTATION_BUG_656607);
+    if (rv == ERR_IO_PENDING)
+      return rv;
+    if (rv < 0) {
+      // The failed packet goes through the same error handling as a single
+      // write. Loss recovery retransmits the data of the dropped packets.
+      packet_ = std::move(batch_.front());
+      batch_.clear();
+      return rv;
+    }
+    ReleaseSentPackets(rv);
   }
+  return OK;
+}
 
-  return WriteResult(status, rv);
+void QuicChromiumPacketWriter::ReleaseSentPackets(size_t count) {
+  DCHECK_LE(count, batch_.size());
+  for (size_t i = 0; i < count; ++i)
+    spare_buffers_.push_back(std::move(batch_[i]));
+  batch_.erase(batch_.begin(), batch_.begin() + count);
+}
+
+void QuicChromiumPacketWriter::OnBatchWriteComplete(int rv) {
+  DCHECK_NE(rv, ERR_IO_PENDING);
+  if (rv < 0) {
+    packet_ = std::move(batch_.front());
+    batch_.clear();
+  } else {
+    ReleaseSentPackets(rv);
+    rv = WriteBatchToSocket();
+    if (rv == ERR_IO_PENDING)
+      return;
+  }
+  OnWriteComplete(rv);
 }
 
 void QuicChromiumPacketWriter::RetryPacketAfterNoBuffers() {
@@ -211,4 +294,17 @@ QuicByteCount QuicChromiumPacketWriter::GetMaxPacketSize(
   return kMaxPacketSize;
 }
 
+bool QuicChromiumPacketWriter::IsBatchMode() const {
+  return batch_mode_;
+}
+
+WriteResult QuicChromiumPacketWriter::Flush() {
+  if (batch_.empty())
+    return WriteResult(WRITE_STATUS_OK, 0);
+  // A batch whose write is in flight is resumed by OnBatchWriteComplete().
+  if (write_blocked_)
+    return WriteResult(WRITE_STATUS_BLOCKED, ERR_IO_PENDING);
+  return ProcessWriteResult(WriteBatchToSocket());
+}
+
 }  // namespace net
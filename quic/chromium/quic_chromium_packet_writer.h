@@ -7,6 +7,8 @@
 
 #include <stddef.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/timer/timer.h"
@@ -74,6 +76,11 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
 
   void set_write_blocked(bool write_blocked) { write_blocked_ = write_blocked; }
 
+  // In batch mode, packets are held until Flush() or until a batch is full,
+  // and are then sent with a single DatagramClientSocket::WriteMultiple().
+  // Packets held when the writer is destroyed are dropped.
+  void set_batch_mode(bool batch_mode) { batch_mode_ = batch_mode; }
+
   // Writes |packet| to the socket and returns the error code from the write.
   WriteResult WritePacketToSocket(scoped_refptr<ReusableIOBuffer> packet);
 
@@ -88,6 +95,8 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
   void SetWritable() override;
   QuicByteCount GetMaxPacketSize(
       const QuicSocketAddress& peer_address) const override;
+  bool IsBatchMode() const override;
+  WriteResult Flush() override;
 
   void OnWriteComplete(int rv);
 
@@ -96,6 +105,17 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
   bool MaybeRetryAfterWriteError(int rv);
   void RetryPacketAfterNoBuffers();
   WriteResult WritePacketToSocketImpl();
+  // Handles the result of a socket write of |packet_|.
+  WriteResult ProcessWriteResult(int rv);
+  // Adds a copy of |buffer| to |batch_|.
+  void AddToBatch(const char* buffer, size_t buf_len);
+  // Writes |batch_| until it is empty, the socket blocks or a write fails.
+  // Returns OK, ERR_IO_PENDING, or the error of the failed write, in which
+  // case the failed packet is moved to |packet_| and the rest are dropped.
+  int WriteBatchToSocket();
+  // Moves the first |count| packets of |batch_| to |spare_buffers_|.
+  void ReleaseSentPackets(size_t count);
+  void OnBatchWriteComplete(int rv);
   DatagramClientSocket* socket_;  // Unowned.
   Delegate* delegate_;  // Unowned.
   // Reused for every packet write for the lifetime of the writer.  Is
@@ -105,11 +125,18 @@ class NET_EXPORT_PRIVATE QuicChromiumPacketWriter : public QuicPacketWriter {
   // Whether a write is currently in flight.
   bool write_blocked_;
 
+  bool batch_mode_;
+  // Packets held in batch mode, in the order they are to be sent.
+  std::vector<scoped_refptr<ReusableIOBuffer>> batch_;
+  // Buffers of sent batches, kept to be reused by later ones.
+  std::vector<scoped_refptr<ReusableIOBuffer>> spare_buffers_;
+
   int retry_count_;
   // Timer set when a packet should be retried after ENOBUFS.
   base::OneShotTimer retry_timer_;
 
   CompletionCallback write_callback_;
+  CompletionCallback batch_write_callback_;
   base::WeakPtrFactory<QuicChromiumPacketWriter> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicChromiumPacketWriter);
@@ -88,6 +88,11 @@ class NET_EXPORT_PRIVATE QuicConnectivityProbingManager
     return (network == network_ && peer_address == peer_address_);
   }
 
+  // Returns true if the manager is currently probing any network.
+  bool IsProbing() const {
+    return network_ != NetworkChangeNotifier::kInvalidNetworkHandle;
+  }
+
  private:
   // Cancels undergoing probing.
   void CancelProbingIfAny();
@@ -266,6 +266,7 @@ TEST_F(QuicConnectivityProbingManagerTest, RetryProbingWithExponentailBackoff) {
 TEST_F(QuicConnectivityProbingManagerTest, CancelProbing) {
   int initial_timeout_ms = 100;
 
+  EXPECT_FALSE(probing_manager_.IsProbing());
   EXPECT_CALL(session_, OnSendConnectivityProbingPacket(_, testPeerAddress))
       .WillOnce(Return(true));
   probing_manager_.StartProbing(
@@ -274,6 +275,7 @@ TEST_F(QuicConnectivityProbingManagerTest, CancelProbing) {
       base::TimeDelta::FromMilliseconds(initial_timeout_ms),
       bound_test_net_log_.bound());
   EXPECT_EQ(1u, test_task_runner_->GetPendingTaskCount());
+  EXPECT_TRUE(probing_manager_.IsProbing());
 
   // Fast forward initial_timeout_ms, timeout the first connectivity probing
   // packet, introduce another probing packet to sent out with timeout set to
@@ -296,6 +298,7 @@ TEST_F(QuicConnectivityProbingManagerTest, CancelProbing) {
   EXPECT_CALL(session_, OnSendConnectivityProbingPacket(_, _)).Times(0);
   EXPECT_CALL(session_, OnProbeNetworkFailed(_)).Times(0);
   probing_manager_.CancelProbing(testNetworkHandle);
+  EXPECT_FALSE(probing_manager_.IsProbing());
   test_task_runner_->RunUntilIdle();
 }
 
@@ -352,6 +352,10 @@ class QuicStreamFactory::Job {
     return stream_requests_;
   }
 
+  // Returns the session created by this job, or null if it has not created
+  // one or was pooled to an existing session.
+  QuicChromiumClientSession* session() const { return session_; }
+
  private:
   enum IoState {
     STATE_NONE,
@@ -666,14 +670,17 @@ QuicStreamFactory::QuicStreamFactory(
     int reduced_ping_timeout_seconds,
     int max_time_before_crypto_handshake_seconds,
     int max_idle_time_before_crypto_handshake_seconds,
+    int max_preconnected_sessions,
     bool connect_using_default_network,
     bool migrate_sessions_on_network_change,
     bool migrate_sessions_early,
     bool migrate_sessions_on_network_change_v2,
     bool migrate_sessions_early_v2,
+    bool prevalidate_alternate_network,
     bool allow_server_migration,
     bool race_cert_verification,
     bool estimate_initial_rtt,
+    bool batch_packet_writes,
     const QuicTagVector& connection_options,
     const QuicTagVector& client_connection_options,
     bool enable_token_binding)
@@ -702,6 +709,7 @@ QuicStreamFactory::QuicStreamFactory(
                                                   ct_policy_enforcer,
                                                   transport_security_state,
                                                   cert_transparency_verifier)),
+      max_preconnected_sessions_(max_preconnected_sessions),
       mark_quic_broken_when_network_blackholes_(
           mark_quic_broken_when_network_blackholes),
       store_server_configs_in_properties_(store_server_configs_in_properties),
@@ -720,6 +728,8 @@ QuicStreamFactory::QuicStreamFactory(
           NetworkChangeNotifier::AreNetworkHandlesSupported()),
       migrate_sessions_early_v2_(migrate_sessions_early_v2 &&
                                  migrate_sessions_on_network_change_v2_),
+      prevalidate_alternate_network_(prevalidate_alternate_network &&
+                                     migrate_sessions_early_v2_),
       migrate_sessions_on_network_change_(
           !migrate_sessions_on_network_change_v2_ &&
           migrate_sessions_on_network_change &&
@@ -728,6 +738,7 @@ QuicStreamFactory::QuicStreamFactory(
                               migrate_sessions_early &&
                               migrate_sessions_on_network_change_),
       allow_server_migration_(allow_server_migration),
+      batch_packet_writes_(batch_packet_writes),
       race_cert_verification_(race_cert_verification),
       estimate_initial_rtt(estimate_initial_rtt),
       need_to_check_persisted_supports_quic_(true),
@@ -922,6 +933,7 @@ int QuicStreamFactory::Create(const QuicServerId& server_id,
     SessionMap::iterator it = active_sessions_.find(server_id);
     if (it != active_sessions_.end()) {
       QuicChromiumClientSession* session = it->second;
+      preconnected_sessions_.erase(session);
       request->SetSession(session->CreateHandle());
       return OK;
     }
@@ -947,6 +959,7 @@ int QuicStreamFactory::Create(const QuicServerId& server_id,
       QuicChromiumClientSession* session = key_value.second;
       if (destination.Equals(all_sessions_[session].destination()) &&
           session->CanPool(server_id.host(), server_id.privacy_mode())) {
+        preconnected_sessions_.erase(session);
         request->SetSession(session->CreateHandle());
         return OK;
       }
@@ -986,6 +999,59 @@ int QuicStreamFactory::Create(const QuicServerId& server_id,
   return rv;
 }
 
+int QuicStreamFactory::Preconnect(const std::vector<QuicServerId>& server_ids,
+                                  QuicTransportVersion quic_version,
+                                  const NetLogWithSource& net_log) {
+  DCHECK_NE(quic_version, QUIC_VERSION_UNSUPPORTED);
+  if (!task_runner_)
+    task_runner_ = base::ThreadTaskRunnerHandle::Get().get();
+
+  int num_started = 0;
+  for (const QuicServerId& server_id : server_ids) {
+    if (preconnected_sessions_.size() + preconnect_jobs_.size() >=
+        static_cast<size_t>(std::max(max_preconnected_sessions_, 0))) {
+      break;
+    }
+    // Without a cached server config, the session could not send requests
+    // before a round trip to the server anyway.
+    if (HasActiveSession(server_id) || HasActiveJob(server_id) ||
+        WasQuicRecentlyBroken(server_id) || !HasCachedServerConfig(server_id)) {
+      continue;
+    }
+
+    ignore_result(
+        StartCertVerifyJob(server_id, /*cert_verify_flags=*/0, net_log));
+
+    QuicSessionKey key(server_id.host_port_pair(), server_id);
+    std::unique_ptr<Job> job = std::make_unique<Job>(
+        this, quic_version, host_resolver_, key,
+        /*was_alternative_service_recently_broken=*/false, IDLE,
+        /*cert_verify_flags=*/0, net_log);
+    int rv = job->Run(base::Bind(&QuicStreamFactory::OnJobComplete,
+                                 base::Unretained(this), job.get()));
+    if (rv == ERR_IO_PENDING) {
+      preconnect_jobs_.insert(server_id);
+      active_jobs_[server_id] = std::move(job);
+      ++num_started;
+    } else if (rv == OK && job->session()) {
+      preconnected_sessions_.insert(job->session());
+      ++num_started;
+    }
+  }
+  UMA_HISTOGRAM_COUNTS_100("Net.QuicSession.PreconnectSessionsStarted",
+                           num_started);
+  return num_started;
+}
+
+void QuicStreamFactory::CloseIdlePreconnectedSessions() {
+  while (!preconnected_sessions_.empty()) {
+    size_t initial_size = preconnected_sessions_.size();
+    (*preconnected_sessions_.begin())
+        ->CloseSessionOnError(ERR_ABORTED, QUIC_CONNECTION_CANCELLED);
+    DCHECK_NE(initial_size, preconnected_sessions_.size());
+  }
+}
+
 QuicStreamFactory::QuicSessionKey::QuicSessionKey(
     const HostPortPair& destination,
     const QuicServerId& server_id)
@@ -1031,6 +1097,7 @@ bool QuicStreamFactory::OnResolution(const QuicSessionKey& key,
 void QuicStreamFactory::OnJobComplete(Job* job, int rv) {
   auto iter = active_jobs_.find(job->key().server_id());
   DCHECK(iter != active_jobs_.end());
+  bool is_preconnect = preconnect_jobs_.erase(job->key().server_id()) > 0;
   if (rv == OK) {
     set_require_confirmation(false);
 
@@ -1038,6 +1105,13 @@ void QuicStreamFactory::OnJobComplete(Job* job, int rv) {
         active_sessions_.find(job->key().server_id());
     CHECK(session_it != active_sessions_.end());
     QuicChromiumClientSession* session = session_it->second;
+    if (!iter->second->stream_requests().empty()) {
+      preconnected_sessions_.erase(session);
+    } else if (is_preconnect && job->session()) {
+      // Only keep track of sessions the preconnect created itself, rather
+      // than pooled to.
+      preconnected_sessions_.insert(session);
+    }
     for (auto* request : iter->second->stream_requests()) {
       // Do not notify |request| yet.
       request->SetSession(session->CreateHandle());
@@ -1100,6 +1174,7 @@ void QuicStreamFactory::OnSessionGoingAway(QuicChromiumClientSession* session) {
     session_peer_ip_.erase(session);
   }
   session_aliases_.erase(session);
+  preconnected_sessions_.erase(session);
 }
 
 void QuicStreamFactory::OnSessionClosed(QuicChromiumClientSession* session) {
@@ -1401,6 +1476,7 @@ int QuicStreamFactory::CreateSession(const QuicSessionKey& key,
 
   QuicChromiumPacketWriter* writer =
       new QuicChromiumPacketWriter(socket.get(), task_runner_);
+  writer->set_batch_mode(batch_packet_writes_);
   QuicConnection* connection = new QuicConnection(
       connection_id, QuicSocketAddress(QuicSocketAddressImpl(addr)),
       helper_.get(), alarm_factory_.get(), writer, true /* owns_writer */,
@@ -1435,11 +1511,12 @@ int QuicStreamFactory::CreateSession(const QuicSessionKey& key,
       clock_, transport_security_state_, std::move(server_info), server_id,
       require_confirmation, migrate_sessions_early_,
       migrate_sessions_on_network_change_, migrate_sessions_early_v2_,
-      migrate_sessions_on_network_change_v2_, yield_after_packets_,
-      yield_after_duration_, cert_verify_flags, config, &crypto_config_,
-      network_connection_.connection_description(), dns_resolution_start_time,
-      dns_resolution_end_time, &push_promise_index_, push_delegate_,
-      task_runner_, std::move(socket_performance_watcher), net_log.net_log());
+      migrate_sessions_on_network_change_v2_, prevalidate_alternate_network_,
+      yield_after_packets_, yield_after_duration_, cert_verify_flags, config,
+      &crypto_config_, network_connection_.connection_description(),
+      dns_resolution_start_time, dns_resolution_end_time, &push_promise_index_,
+      push_delegate_, task_runner_, std::move(socket_performance_watcher),
+      net_log.net_log());
 
   all_sessions_[*session] = key;  // owning pointer
   writer->set_delegate(*session);
@@ -1530,6 +1607,17 @@ bool QuicStreamFactory::CryptoConfigCacheIsEmpty(
   return cached->IsEmpty();
 }
 
+bool QuicStreamFactory::HasCachedServerConfig(const QuicServerId& server_id) {
+  QuicCryptoClientConfig::CachedState* cached =
+      crypto_config_.LookupOrCreate(server_id);
+  if (cached->IsEmpty() && store_server_configs_in_properties_) {
+    PropertiesBasedQuicServerInfo server_info(server_id,
+                                              http_server_properties_);
+    LoadCachedStateFromServerInfo(&server_info, cached);
+  }
+  return !cached->IsEmpty();
+}
+
 QuicAsyncStatus QuicStreamFactory::StartCertVerifyJob(
     const QuicServerId& server_id,
     int cert_verify_flags,
@@ -1565,6 +1653,12 @@ void QuicStreamFactory::InitializeCachedStateInCryptoConfig(
   if (!cached->IsEmpty())
     return;
 
+  LoadCachedStateFromServerInfo(server_info.get(), cached);
+}
+
+void QuicStreamFactory::LoadCachedStateFromServerInfo(
+    QuicServerInfo* server_info,
+    QuicCryptoClientConfig::CachedState* cached) {
   if (!server_info || !server_info->Load())
     return;
 
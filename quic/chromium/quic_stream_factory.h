@@ -75,6 +75,10 @@ class QuicStreamFactoryPeer;
 // When a connection is idle for 30 seconds it will be closed.
 const int kIdleConnectionTimeoutSeconds = 30;
 
+// At most this many sessions started by QuicStreamFactory::Preconnect() are
+// kept waiting for their first request.
+const int kMaxPreconnectedSessions = 4;
+
 enum QuicConnectionMigrationStatus {
   MIGRATION_STATUS_NO_MIGRATABLE_STREAMS,
   MIGRATION_STATUS_ALREADY_MIGRATED,
@@ -206,14 +210,17 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
       int reduced_ping_timeout_seconds,
       int max_time_before_crypto_handshake_seconds,
       int max_idle_time_before_crypto_handshake_seconds,
+      int max_preconnected_sessions,
       bool connect_using_default_network,
       bool migrate_sessions_on_network_change,
       bool migrate_sessions_early,
       bool migrate_sessions_on_network_change_v2,
       bool migrate_sessions_early_v2,
+      bool prevalidate_alternate_network,
       bool allow_server_migration,
       bool race_cert_verification,
       bool estimate_initial_rtt,
+      bool batch_packet_writes,
       const QuicTagVector& connection_options,
       const QuicTagVector& client_connection_options,
       bool enable_token_binding);
@@ -239,6 +246,20 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
              const NetLogWithSource& net_log,
              QuicStreamRequest* request);
 
+  // Starts sessions to those of |server_ids| which have a cached server
+  // config, so that their first requests find a session which can send data
+  // without waiting for a handshake. Servers which already have a session or a
+  // job, or for which QUIC was recently broken, are skipped, and at most
+  // |max_preconnected_sessions| started sessions wait for their first request
+  // at any time. Returns the number of sessions started.
+  int Preconnect(const std::vector<QuicServerId>& server_ids,
+                 QuicTransportVersion quic_version,
+                 const NetLogWithSource& net_log);
+
+  // Closes the sessions started by Preconnect() which are still waiting for
+  // their first request.
+  void CloseIdlePreconnectedSessions();
+
   // Called when the handshake for |session| is confirmed. If QUIC is disabled
   // currently disabled, then it closes the connection and returns true.
   bool OnHandshakeConfirmed(QuicChromiumClientSession* session);
@@ -407,6 +428,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
 
   bool CryptoConfigCacheIsEmpty(const QuicServerId& server_id);
 
+  // Returns true if |crypto_config_| has a server config for |server_id|,
+  // after loading it from |http_server_properties_| if necessary.
+  bool HasCachedServerConfig(const QuicServerId& server_id);
+
   // Starts an asynchronous job for cert verification if
   // |race_cert_verification_| is enabled and if there are cached certs for the
   // given |server_id|.
@@ -423,6 +448,11 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
       const std::unique_ptr<QuicServerInfo>& server_info,
       QuicConnectionId* connection_id);
 
+  // Initializes |cached| with the information in |server_info|, if it loads.
+  void LoadCachedStateFromServerInfo(
+      QuicServerInfo* server_info,
+      QuicCryptoClientConfig::CachedState* cached);
+
   void ProcessGoingAwaySession(QuicChromiumClientSession* session,
                                const QuicServerId& server_id,
                                bool was_session_active);
@@ -472,6 +502,13 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
 
   JobMap active_jobs_;
 
+  // Ids of the servers in |active_jobs_| whose jobs were started by
+  // Preconnect().
+  std::set<QuicServerId> preconnect_jobs_;
+  // Sessions created by Preconnect() which have not been used by a request.
+  SessionSet preconnected_sessions_;
+  const int max_preconnected_sessions_;
+
   // Map of QuicServerId to owning CertVerifierJob.
   CertVerifierJobMap active_cert_verifier_jobs_;
 
@@ -506,6 +543,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // connection experiences poor connectivity.
   const bool migrate_sessions_early_v2_;
 
+  // Set if sessions which migrate early should validate a path on an
+  // alternate network before their current path degrades.
+  const bool prevalidate_alternate_network_;
+
   // Set if migration should be attempted on active sessions when primary
   // interface changes.
   const bool migrate_sessions_on_network_change_;
@@ -518,6 +559,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // server address.
   const bool allow_server_migration_;
 
+  // Set if sessions should send packets in batches with
+  // DatagramClientSocket::WriteMultiple().
+  const bool batch_packet_writes_;
+
   // Set if cert verification is to be raced with host resolution.
   bool race_cert_verification_;
 
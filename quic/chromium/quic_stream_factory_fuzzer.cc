@@ -141,10 +141,12 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
           mark_quic_broken_when_network_blackholes,
           kIdleConnectionTimeoutSeconds, kPingTimeoutSecs,
           kMaxTimeForCryptoHandshakeSecs, kInitialIdleTimeoutSecs,
-          connect_using_default_network, migrate_sessions_on_network_change,
-          migrate_sessions_early, migrate_sessions_on_network_change_v2,
-          migrate_sessions_early_v2, allow_server_migration,
-          race_cert_verification, estimate_initial_rtt, env->connection_options,
+          kMaxPreconnectedSessions, connect_using_default_network,
+          migrate_sessions_on_network_change, migrate_sessions_early,
+          migrate_sessions_on_network_change_v2, migrate_sessions_early_v2,
+          /*prevalidate_alternate_network=*/false, allow_server_migration,
+          race_cert_verification, estimate_initial_rtt,
+          /*batch_packet_writes=*/false, env->connection_options,
           env->client_connection_options, enable_token_binding);
 
   QuicStreamRequest request(factory.get());
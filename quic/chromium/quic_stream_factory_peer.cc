@@ -159,6 +159,11 @@ int QuicStreamFactoryPeer::GetNumPushStreamsCreated(
   return factory->num_push_streams_created_;
 }
 
+size_t QuicStreamFactoryPeer::GetNumPreconnectedSessions(
+    QuicStreamFactory* factory) {
+  return factory->preconnected_sessions_.size();
+}
+
 void QuicStreamFactoryPeer::SetAlarmFactory(
     QuicStreamFactory* factory,
     std::unique_ptr<QuicAlarmFactory> alarm_factory) {
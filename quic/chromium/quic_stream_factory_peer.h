@@ -86,6 +86,8 @@ class QuicStreamFactoryPeer {
 
   static int GetNumPushStreamsCreated(QuicStreamFactory* factory);
 
+  static size_t GetNumPreconnectedSessions(QuicStreamFactory* factory);
+
   static void SetAlarmFactory(QuicStreamFactory* factory,
                               std::unique_ptr<QuicAlarmFactory> alarm_factory);
 
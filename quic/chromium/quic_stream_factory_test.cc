@@ -27,6 +27,7 @@
 #include "net/quic/chromium/mock_crypto_client_stream_factory.h"
 #include "net/quic/chromium/mock_quic_data.h"
 #include "net/quic/chromium/properties_based_quic_server_info.h"
+#include "net/quic/chromium/quic_chromium_client_session_peer.h"
 #include "net/quic/chromium/quic_http_stream.h"
 #include "net/quic/chromium/quic_http_utils.h"
 #include "net/quic/chromium/quic_server_info.h"
@@ -228,13 +229,16 @@ class QuicStreamFactoryTestBase {
         max_time_before_crypto_handshake_seconds_(
             kMaxTimeForCryptoHandshakeSecs),
         max_idle_time_before_crypto_handshake_seconds_(kInitialIdleTimeoutSecs),
+        max_preconnected_sessions_(kMaxPreconnectedSessions),
         migrate_sessions_on_network_change_(false),
         migrate_sessions_early_(false),
         migrate_sessions_on_network_change_v2_(false),
         migrate_sessions_early_v2_(false),
+        prevalidate_alternate_network_(false),
         allow_server_migration_(false),
         race_cert_verification_(false),
-        estimate_initial_rtt_(false) {
+        estimate_initial_rtt_(false),
+        batch_packet_writes_(false) {
     clock_.AdvanceTime(QuicTime::Delta::FromSeconds(1));
   }
 
@@ -253,10 +257,12 @@ class QuicStreamFactoryTestBase {
         idle_connection_timeout_seconds_, reduced_ping_timeout_seconds_,
         max_time_before_crypto_handshake_seconds_,
         max_idle_time_before_crypto_handshake_seconds_,
+        max_preconnected_sessions_,
         /*connect_using_default_network*/ true,
         migrate_sessions_on_network_change_, migrate_sessions_early_,
         migrate_sessions_on_network_change_v2_, migrate_sessions_early_v2_,
-        allow_server_migration_, race_cert_verification_, estimate_initial_rtt_,
+        prevalidate_alternate_network_, allow_server_migration_,
+        race_cert_verification_, estimate_initial_rtt_, batch_packet_writes_,
         connection_options_, client_connection_options_,
         /*enable_token_binding*/ false));
   }
@@ -751,6 +757,16 @@ class QuicStreamFactoryTestBase {
       IoMode write_error_mode,
       bool disconnected);
 
+  // Helper method for tests of a validated path to the alternate network
+  // which may not be used.
+  enum PrevalidatedNetworkDiscardReason {
+    PREVALIDATED_NETWORK_EXPIRED,
+    PREVALIDATED_NETWORK_DISCONNECTED,
+    PREVALIDATED_NETWORK_READ_ERROR,
+  };
+  void TestPrevalidatedNetworkDiscarded(
+      PrevalidatedNetworkDiscardReason reason);
+
   QuicFlagSaver flags_;  // Save/restore all QUIC flag values.
   MockHostResolver host_resolver_;
   scoped_refptr<SSLConfigService> ssl_config_service_;
@@ -789,13 +805,16 @@ class QuicStreamFactoryTestBase {
   int reduced_ping_timeout_seconds_;
   int max_time_before_crypto_handshake_seconds_;
   int max_idle_time_before_crypto_handshake_seconds_;
+  int max_preconnected_sessions_;
   bool migrate_sessions_on_network_change_;
   bool migrate_sessions_early_;
   bool migrate_sessions_on_network_change_v2_;
   bool migrate_sessions_early_v2_;
+  bool prevalidate_alternate_network_;
   bool allow_server_migration_;
   bool race_cert_verification_;
   bool estimate_initial_rtt_;
+  bool batch_packet_writes_;
   QuicTagVector connection_options_;
   QuicTagVector client_connection_options_;
 };
@@ -857,6 +876,37 @@ TEST_P(QuicStreamFactoryTest, Create) {
   EXPECT_TRUE(socket_data.AllWriteDataConsumed());
 }
 
+// Tests that sessions send their packets through a batch mode writer when
+// batch_packet_writes is set.
+TEST_P(QuicStreamFactoryTest, BatchPacketWrites) {
+  batch_packet_writes_ = true;
+  Initialize();
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  MockQuicData socket_data;
+  socket_data.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data.AddWrite(ConstructInitialSettingsPacket());
+  socket_data.AddSocketDataToFactory(socket_factory_.get());
+
+  QuicStreamRequest request(factory_.get());
+  EXPECT_EQ(
+      ERR_IO_PENDING,
+      request.Request(host_port_pair_, version_, privacy_mode_,
+                      DEFAULT_PRIORITY, /*cert_verify_flags=*/0, url_, net_log_,
+                      &net_error_details_, callback_.callback()));
+
+  EXPECT_THAT(callback_.WaitForResult(), IsOk());
+  std::unique_ptr<HttpStream> stream = CreateStream(&request);
+  EXPECT_TRUE(stream.get());
+
+  QuicChromiumClientSession* session = GetActiveSession(host_port_pair_);
+  EXPECT_TRUE(session->connection()->writer()->IsBatchMode());
+
+  EXPECT_TRUE(socket_data.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data.AllWriteDataConsumed());
+}
+
 TEST_P(QuicStreamFactoryTest, CreateZeroRtt) {
   Initialize();
   factory_->set_require_confirmation(false);
@@ -885,6 +935,99 @@ TEST_P(QuicStreamFactoryTest, CreateZeroRtt) {
   EXPECT_TRUE(socket_data.AllWriteDataConsumed());
 }
 
+TEST_P(QuicStreamFactoryTest, Preconnect) {
+  Initialize();
+  factory_->set_require_confirmation(false);
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  MockQuicData socket_data;
+  socket_data.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data.AddSocketDataToFactory(socket_factory_.get());
+
+  crypto_client_stream_factory_.set_handshake_mode(
+      MockCryptoClientStream::ZERO_RTT);
+  host_resolver_.set_synchronous_mode(true);
+  host_resolver_.rules()->AddIPLiteralRule(host_port_pair_.host(),
+                                           "192.168.0.1", "");
+
+  // Nothing is started without a cached server config.
+  QuicServerId server_id(host_port_pair_, privacy_mode_);
+  EXPECT_EQ(0, factory_->Preconnect({server_id}, version_, net_log_));
+  EXPECT_FALSE(HasActiveSession(host_port_pair_));
+
+  QuicStreamFactoryPeer::CacheDummyServerConfig(factory_.get(), server_id);
+  EXPECT_EQ(1, factory_->Preconnect({server_id}, version_, net_log_));
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+  EXPECT_EQ(1u,
+            QuicStreamFactoryPeer::GetNumPreconnectedSessions(factory_.get()));
+  // A server which already has a session is skipped.
+  EXPECT_EQ(0, factory_->Preconnect({server_id}, version_, net_log_));
+
+  // The first request uses the preconnected session.
+  QuicStreamRequest request(factory_.get());
+  EXPECT_EQ(
+      OK, request.Request(host_port_pair_, version_, privacy_mode_,
+                          DEFAULT_PRIORITY, /*cert_verify_flags=*/0, url_,
+                          net_log_, &net_error_details_, callback_.callback()));
+  EXPECT_EQ(0u,
+            QuicStreamFactoryPeer::GetNumPreconnectedSessions(factory_.get()));
+  std::unique_ptr<HttpStream> stream = CreateStream(&request);
+  EXPECT_TRUE(stream.get());
+
+  // A used session is no longer closed as idle.
+  factory_->CloseIdlePreconnectedSessions();
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+
+  EXPECT_TRUE(socket_data.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data.AllWriteDataConsumed());
+}
+
+TEST_P(QuicStreamFactoryTest, PreconnectBudget) {
+  max_preconnected_sessions_ = 1;
+  Initialize();
+  factory_->set_require_confirmation(false);
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  MockQuicData socket_data1;
+  socket_data1.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data1.AddSocketDataToFactory(socket_factory_.get());
+  MockQuicData socket_data2;
+  socket_data2.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data2.AddSocketDataToFactory(socket_factory_.get());
+
+  crypto_client_stream_factory_.set_handshake_mode(
+      MockCryptoClientStream::ZERO_RTT);
+  HostPortPair server2(kServer2HostName, kDefaultServerPort);
+  host_resolver_.set_synchronous_mode(true);
+  host_resolver_.rules()->AddIPLiteralRule(host_port_pair_.host(),
+                                           "192.168.0.1", "");
+  host_resolver_.rules()->AddIPLiteralRule(server2.host(), "192.168.0.2", "");
+
+  QuicServerId server_id1(host_port_pair_, privacy_mode_);
+  QuicServerId server_id2(server2, privacy_mode_);
+  QuicStreamFactoryPeer::CacheDummyServerConfig(factory_.get(), server_id1);
+  QuicStreamFactoryPeer::CacheDummyServerConfig(factory_.get(), server_id2);
+
+  EXPECT_EQ(1, factory_->Preconnect({server_id1, server_id2}, version_,
+                                    net_log_));
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+  EXPECT_FALSE(HasActiveSession(server2));
+
+  // Draining the idle preconnected session frees the budget.
+  factory_->CloseIdlePreconnectedSessions();
+  EXPECT_FALSE(HasActiveSession(host_port_pair_));
+  EXPECT_EQ(0u,
+            QuicStreamFactoryPeer::GetNumPreconnectedSessions(factory_.get()));
+  EXPECT_EQ(1, factory_->Preconnect({server_id2}, version_, net_log_));
+  EXPECT_TRUE(HasActiveSession(server2));
+
+  EXPECT_TRUE(socket_data1.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data2.AllReadDataConsumed());
+}
+
 TEST_P(QuicStreamFactoryTest, DefaultInitialRtt) {
   Initialize();
   ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
@@ -3592,6 +3735,259 @@ TEST_P(QuicStreamFactoryTest, MigrateSessionEarlyConnectionMigrationDisabled) {
   EXPECT_TRUE(socket_data.AllWriteDataConsumed());
 }
 
+// Tests that a session validates the path to the alternate network while its
+// current path is fine, and migrates to it without probing once the current
+// path degrades.
+TEST_P(QuicStreamFactoryTest, MigrateSessionEarlyToPrevalidatedNetwork) {
+  prevalidate_alternate_network_ = true;
+  InitializeConnectionMigrationV2Test(
+      {kDefaultNetworkForTests, kNewNetworkForTests});
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  MockQuicData socket_data;
+  socket_data.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data.AddWrite(ConstructInitialSettingsPacket());
+  socket_data.AddSocketDataToFactory(socket_factory_.get());
+
+  // Create request and QuicHttpStream.
+  QuicStreamRequest request(factory_.get());
+  EXPECT_EQ(
+      ERR_IO_PENDING,
+      request.Request(host_port_pair_, version_, privacy_mode_,
+                      DEFAULT_PRIORITY, /*cert_verify_flags=*/0, url_, net_log_,
+                      &net_error_details_, callback_.callback()));
+  EXPECT_THAT(callback_.WaitForResult(), IsOk());
+  std::unique_ptr<HttpStream> stream = CreateStream(&request);
+  EXPECT_TRUE(stream.get());
+
+  // Cause QUIC stream to be created.
+  HttpRequestInfo request_info;
+  EXPECT_EQ(OK, stream->InitializeStream(&request_info, DEFAULT_PRIORITY,
+                                         net_log_, CompletionCallback()));
+
+  // Ensure that session is alive and active.
+  QuicChromiumClientSession* session = GetActiveSession(host_port_pair_);
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(factory_.get(), session));
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+
+  // The probe on the alternate network is answered, and the session keeps
+  // using the socket it was sent on after migrating.
+  MockQuicData socket_data1;
+  socket_data1.AddWrite(
+      client_maker_.MakeConnectivityProbingPacket(2, /*include_version=*/true));
+  socket_data1.AddRead(server_maker_.MakeConnectivityProbingPacket(
+      1, /*include_version=*/false));
+  socket_data1.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data1.AddWrite(
+      client_maker_.MakePingPacket(3, /*include_version=*/false));
+  socket_data1.AddWrite(client_maker_.MakeAckAndRstPacket(
+      4, false, GetNthClientInitiatedStreamId(0), QUIC_STREAM_CANCELLED, 1, 1,
+      1, true));
+  socket_data1.AddSocketDataToFactory(socket_factory_.get());
+
+  // Validate the path to the alternate network.
+  scoped_mock_network_change_notifier_->mock_network_change_notifier()
+      ->NotifyNetworkConnected(kNewNetworkForTests);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_EQ(kDefaultNetworkForTests,
+            session->GetDefaultSocket()->GetBoundNetwork());
+
+  // Trigger early connection migration, which uses the validated path right
+  // away.
+  session->OnPathDegrading();
+  EXPECT_EQ(kNewNetworkForTests,
+            session->GetDefaultSocket()->GetBoundNetwork());
+
+  // Run the message loop so that the PING is written to the new socket.
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(factory_.get(), session));
+  EXPECT_EQ(1u, session->GetNumActiveStreams());
+
+  stream.reset();
+
+  EXPECT_TRUE(socket_data.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data.AllWriteDataConsumed());
+  EXPECT_TRUE(socket_data1.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data1.AllWriteDataConsumed());
+}
+
+void QuicStreamFactoryTestBase::TestPrevalidatedNetworkDiscarded(
+    PrevalidatedNetworkDiscardReason reason) {
+  prevalidate_alternate_network_ = true;
+  InitializeConnectionMigrationV2Test(
+      {kDefaultNetworkForTests, kNewNetworkForTests});
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  // A validated path is used for two validation intervals.
+  const QuicTime::Delta time_to_expiry = QuicTime::Delta::FromSeconds(61);
+  MockQuicData socket_data;
+  socket_data.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data.AddWrite(ConstructInitialSettingsPacket());
+  socket_data.AddWrite(client_maker_.MakeAckAndRstPacket(
+      4, false, GetNthClientInitiatedStreamId(0), QUIC_STREAM_CANCELLED, 1, 1,
+      1, true, 0,
+      reason == PREVALIDATED_NETWORK_EXPIRED ? time_to_expiry
+                                             : QuicTime::Delta::Zero()));
+  socket_data.AddSocketDataToFactory(socket_factory_.get());
+
+  // Create request and QuicHttpStream.
+  QuicStreamRequest request(factory_.get());
+  EXPECT_EQ(
+      ERR_IO_PENDING,
+      request.Request(host_port_pair_, version_, privacy_mode_,
+                      DEFAULT_PRIORITY, /*cert_verify_flags=*/0, url_, net_log_,
+                      &net_error_details_, callback_.callback()));
+  EXPECT_THAT(callback_.WaitForResult(), IsOk());
+  std::unique_ptr<HttpStream> stream = CreateStream(&request);
+  EXPECT_TRUE(stream.get());
+
+  // Cause QUIC stream to be created.
+  HttpRequestInfo request_info;
+  EXPECT_EQ(OK, stream->InitializeStream(&request_info, DEFAULT_PRIORITY,
+                                         net_log_, CompletionCallback()));
+
+  // Ensure that session is alive and active.
+  QuicChromiumClientSession* session = GetActiveSession(host_port_pair_);
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(factory_.get(), session));
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+
+  MockQuicData socket_data1;
+  socket_data1.AddWrite(
+      client_maker_.MakeConnectivityProbingPacket(2, /*include_version=*/true));
+  socket_data1.AddRead(server_maker_.MakeConnectivityProbingPacket(
+      1, /*include_version=*/false));
+  if (reason == PREVALIDATED_NETWORK_READ_ERROR)
+    socket_data1.AddRead(ASYNC, ERR_ADDRESS_UNREACHABLE);
+  else
+    socket_data1.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data1.AddSocketDataToFactory(socket_factory_.get());
+
+  // Validate the path to the alternate network.
+  scoped_mock_network_change_notifier_->mock_network_change_notifier()
+      ->NotifyNetworkConnected(kNewNetworkForTests);
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(socket_data1.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data1.AllWriteDataConsumed());
+
+  switch (reason) {
+    case PREVALIDATED_NETWORK_EXPIRED:
+      clock_.AdvanceTime(time_to_expiry);
+      break;
+    case PREVALIDATED_NETWORK_DISCONNECTED:
+      scoped_mock_network_change_notifier_->mock_network_change_notifier()
+          ->NotifyNetworkDisconnected(kNewNetworkForTests);
+      break;
+    case PREVALIDATED_NETWORK_READ_ERROR:
+      break;
+  }
+
+  // The session neither has nor validates a path now, so it probes the
+  // alternate network on path degrading instead of migrating right away.
+  MockQuicData socket_data2;
+  socket_data2.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data2.AddWrite(client_maker_.MakeConnectivityProbingPacket(
+      3, /*include_version=*/false));
+  socket_data2.AddSocketDataToFactory(socket_factory_.get());
+
+  session->OnPathDegrading();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(kDefaultNetworkForTests,
+            session->GetDefaultSocket()->GetBoundNetwork());
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(factory_.get(), session));
+  EXPECT_EQ(1u, session->GetNumActiveStreams());
+
+  stream.reset();
+
+  EXPECT_TRUE(socket_data.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data.AllWriteDataConsumed());
+  EXPECT_TRUE(socket_data2.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data2.AllWriteDataConsumed());
+}
+
+TEST_P(QuicStreamFactoryTest, PrevalidatedNetworkExpires) {
+  TestPrevalidatedNetworkDiscarded(PREVALIDATED_NETWORK_EXPIRED);
+}
+
+TEST_P(QuicStreamFactoryTest, PrevalidatedNetworkDisconnected) {
+  TestPrevalidatedNetworkDiscarded(PREVALIDATED_NETWORK_DISCONNECTED);
+}
+
+TEST_P(QuicStreamFactoryTest, PrevalidatedNetworkReadError) {
+  TestPrevalidatedNetworkDiscarded(PREVALIDATED_NETWORK_READ_ERROR);
+}
+
+// Tests that a session stops validating the path to the alternate network once
+// it has spent its budget of probing packets.
+TEST_P(QuicStreamFactoryTest, PrevalidateAlternateNetworkBudgetSpent) {
+  prevalidate_alternate_network_ = true;
+  InitializeConnectionMigrationV2Test(
+      {kDefaultNetworkForTests, kNewNetworkForTests});
+  ProofVerifyDetailsChromium verify_details = DefaultProofVerifyDetails();
+  crypto_client_stream_factory_.AddProofVerifyDetails(&verify_details);
+
+  MockQuicData socket_data;
+  socket_data.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data.AddWrite(ConstructInitialSettingsPacket());
+  socket_data.AddWrite(client_maker_.MakeRstPacket(
+      3, true, GetNthClientInitiatedStreamId(0), QUIC_STREAM_CANCELLED));
+  socket_data.AddSocketDataToFactory(socket_factory_.get());
+
+  // Create request and QuicHttpStream.
+  QuicStreamRequest request(factory_.get());
+  EXPECT_EQ(
+      ERR_IO_PENDING,
+      request.Request(host_port_pair_, version_, privacy_mode_,
+                      DEFAULT_PRIORITY, /*cert_verify_flags=*/0, url_, net_log_,
+                      &net_error_details_, callback_.callback()));
+  EXPECT_THAT(callback_.WaitForResult(), IsOk());
+  std::unique_ptr<HttpStream> stream = CreateStream(&request);
+  EXPECT_TRUE(stream.get());
+
+  // Cause QUIC stream to be created.
+  HttpRequestInfo request_info;
+  EXPECT_EQ(OK, stream->InitializeStream(&request_info, DEFAULT_PRIORITY,
+                                         net_log_, CompletionCallback()));
+
+  // Ensure that session is alive and active.
+  QuicChromiumClientSession* session = GetActiveSession(host_port_pair_);
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(factory_.get(), session));
+  EXPECT_TRUE(HasActiveSession(host_port_pair_));
+
+  // Spend the budget of 64 probing packets.
+  QuicChromiumClientSessionPeer::SetPrevalidationPacketsSent(session, 64);
+
+  // No path is validated, since no socket is created on the alternate network.
+  scoped_mock_network_change_notifier_->mock_network_change_notifier()
+      ->NotifyNetworkConnected(kNewNetworkForTests);
+  base::RunLoop().RunUntilIdle();
+
+  // The probe on path degrading is not answered, so the session stays on the
+  // default network.
+  MockQuicData socket_data1;
+  socket_data1.AddRead(SYNCHRONOUS, ERR_IO_PENDING);
+  socket_data1.AddWrite(
+      client_maker_.MakeConnectivityProbingPacket(2, /*include_version=*/true));
+  socket_data1.AddSocketDataToFactory(socket_factory_.get());
+
+  session->OnPathDegrading();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(kDefaultNetworkForTests,
+            session->GetDefaultSocket()->GetBoundNetwork());
+  EXPECT_EQ(1u, session->GetNumActiveStreams());
+
+  stream.reset();
+
+  EXPECT_TRUE(socket_data.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data.AllWriteDataConsumed());
+  EXPECT_TRUE(socket_data1.AllReadDataConsumed());
+  EXPECT_TRUE(socket_data1.AllWriteDataConsumed());
+}
+
 void QuicStreamFactoryTestBase::TestMigrationOnWriteError(
     IoMode write_error_mode) {
   InitializeConnectionMigrationTest(
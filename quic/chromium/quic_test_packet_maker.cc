@@ -58,6 +58,30 @@ std::unique_ptr<QuicReceivedPacket> QuicTestPacketMaker::MakePingPacket(
       MakePacket(header, QuicFrame(ping)));
 }
 
+std::unique_ptr<QuicReceivedPacket>
+QuicTestPacketMaker::MakeConnectivityProbingPacket(QuicPacketNumber num,
+                                                   bool include_version) {
+  QuicPacketHeader header;
+  header.connection_id = connection_id_;
+  header.reset_flag = false;
+  header.version_flag = include_version;
+  header.packet_number_length = PACKET_1BYTE_PACKET_NUMBER;
+  header.packet_number = num;
+
+  QuicFramer framer(SupportedTransportVersions(version_), clock_->Now(),
+                    perspective_);
+  char buffer[kMaxPacketSize];
+  size_t length = framer.BuildConnectivityProbingPacket(header, buffer,
+                                                        kDefaultMaxPacketSize);
+  size_t encrypted_size = framer.EncryptInPlace(
+      ENCRYPTION_NONE, header.packet_number,
+      GetStartOfEncryptedData(framer.transport_version(), header), length,
+      kMaxPacketSize, buffer);
+  EXPECT_NE(0u, encrypted_size);
+  QuicReceivedPacket encrypted(buffer, encrypted_size, clock_->Now(), false);
+  return std::unique_ptr<QuicReceivedPacket>(encrypted.Clone());
+}
+
 std::unique_ptr<QuicReceivedPacket> QuicTestPacketMaker::MakeRstPacket(
     QuicPacketNumber num,
     bool include_version,
@@ -109,6 +133,23 @@ std::unique_ptr<QuicReceivedPacket> QuicTestPacketMaker::MakeAckAndRstPacket(
     QuicPacketNumber least_unacked,
     bool send_feedback,
     size_t bytes_written) {
+  return MakeAckAndRstPacket(num, include_version, stream_id, error_code,
+                             largest_received, smallest_received, least_unacked,
+                             send_feedback, bytes_written,
+                             QuicTime::Delta::Zero());
+}
+
+std::unique_ptr<QuicReceivedPacket> QuicTestPacketMaker::MakeAckAndRstPacket(
+    QuicPacketNumber num,
+    bool include_version,
+    QuicStreamId stream_id,
+    QuicRstStreamErrorCode error_code,
+    QuicPacketNumber largest_received,
+    QuicPacketNumber smallest_received,
+    QuicPacketNumber least_unacked,
+    bool send_feedback,
+    size_t bytes_written,
+    QuicTime::Delta ack_delay_time) {
   QuicPacketHeader header;
   header.connection_id = connection_id_;
   header.reset_flag = false;
@@ -117,7 +158,7 @@ std::unique_ptr<QuicReceivedPacket> QuicTestPacketMaker::MakeAckAndRstPacket(
   header.packet_number = num;
 
   QuicAckFrame ack(MakeAckFrame(largest_received));
-  ack.ack_delay_time = QuicTime::Delta::Zero();
+  ack.ack_delay_time = ack_delay_time;
   for (QuicPacketNumber i = smallest_received; i <= largest_received; ++i) {
     ack.received_packet_times.push_back(std::make_pair(i, clock_->Now()));
   }
@@ -37,6 +37,9 @@ class QuicTestPacketMaker {
   void set_hostname(const std::string& host);
   std::unique_ptr<QuicReceivedPacket> MakePingPacket(QuicPacketNumber num,
                                                      bool include_version);
+  std::unique_ptr<QuicReceivedPacket> MakeConnectivityProbingPacket(
+      QuicPacketNumber num,
+      bool include_version);
   std::unique_ptr<QuicReceivedPacket> MakeRstPacket(
       QuicPacketNumber num,
       bool include_version,
@@ -69,6 +72,17 @@ class QuicTestPacketMaker {
       QuicPacketNumber least_unacked,
       bool send_feedback,
       size_t bytes_written);
+  std::unique_ptr<QuicReceivedPacket> MakeAckAndRstPacket(
+      QuicPacketNumber num,
+      bool include_version,
+      QuicStreamId stream_id,
+      QuicRstStreamErrorCode error_code,
+      QuicPacketNumber largest_received,
+      QuicPacketNumber smallest_received,
+      QuicPacketNumber least_unacked,
+      bool send_feedback,
+      size_t bytes_written,
+      QuicTime::Delta ack_delay_time);
   std::unique_ptr<QuicReceivedPacket> MakeAckAndConnectionClosePacket(
       QuicPacketNumber num,
       bool include_version,
@@ -0,0 +1,743 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/congestion_control/bbr2_sender.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+#include "net/quic/core/congestion_control/rtt_stats.h"
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+namespace {
+// Constants based on TCP defaults.
+const QuicByteCount kMaxSegmentSize = kDefaultTCPMSS;
+// The minimum CWND to ensure delayed acks don't reduce bandwidth measurements.
+const QuicByteCount kMinimumCongestionWindow = 4 * kMaxSegmentSize;
+// Value of |inflight_lo_| and |inflight_hi_| when they do not bound anything.
+const QuicByteCount kUnboundedInflight =
+    std::numeric_limits<QuicByteCount>::max();
+
+// The gain used for the slow start, equal to 2/ln(2).
+const float kHighGain = 2.885f;
+// The gain used to drain the queue after the slow start.
+const float kDrainGain = 1.f / kHighGain;
+// The gains used in PROBE_BW.
+const float kProbeBwCongestionWindowGain = 2.f;
+const float kProbeDownPacingGain = 0.75f;
+const float kProbeUpPacingGain = 1.25f;
+
+// The fraction of the bytes in flight which may be lost in a round trip before
+// the amount in flight is considered too high.
+const float kLossThreshold = 0.02f;
+// The multiplicative decrease applied to the bounds on loss.
+const float kBeta = 0.7f;
+// The fraction of |inflight_hi_| used outside of probing, so that other flows
+// have room to grow.
+const float kInflightHeadroom = 0.85f;
+
+// The size of the bandwidth filter window, in PROBE_BW cycles.  The filter
+// holds the best sample of the current and of the previous cycle, so that the
+// estimate survives the round trips spent below the bounds between probes.
+const QuicRoundTripCount kBandwidthWindowCycles = 1;
+
+// The time after which the current min_rtt value expires.
+const QuicTime::Delta kMinRttExpiry = QuicTime::Delta::FromSeconds(5);
+// The minimum time the connection can spend in PROBE_RTT mode.
+const QuicTime::Delta kProbeRttTime = QuicTime::Delta::FromMilliseconds(200);
+// The fraction of the BDP kept in flight during PROBE_RTT.
+const float kProbeRttInflightGain = 0.5f;
+
+// If the bandwidth does not increase by the factor of |kStartupGrowthTarget|
+// within |kRoundTripsWithoutGrowthBeforeExitingStartup| rounds, the connection
+// will exit the STARTUP mode.
+const float kStartupGrowthTarget = 1.25;
+const QuicRoundTripCount kRoundTripsWithoutGrowthBeforeExitingStartup = 3;
+// STARTUP is also exited after a round trip with too much loss and at least
+// this many lost packets.
+const QuicPacketCount kStartupFullLossCount = 8;
+
+// PROBE_BW waits between kMinProbeWait and kMinProbeWait + kProbeWaitJitter
+// before probing again, but no more than kMaxRoundsBeforeProbe round trips so
+// that it probes at least as often as Reno would grow by the same amount.
+const QuicTime::Delta kMinProbeWait = QuicTime::Delta::FromSeconds(2);
+const int64_t kProbeWaitJitterUs = 1000 * 1000;
+const QuicRoundTripCount kMaxRoundsBeforeProbe = 63;
+
+}  // namespace
+
+Bbr2Sender::DebugState::DebugState(const Bbr2Sender& sender)
+    : mode(sender.mode_),
+      cycle_phase(sender.cycle_phase_),
+      max_bandwidth(sender.max_bandwidth_.GetBest()),
+      bandwidth_lo(sender.bandwidth_lo_),
+      round_trip_count(sender.round_trip_count_),
+      congestion_window(sender.GetCongestionWindow()),
+      inflight_hi(sender.inflight_hi_),
+      inflight_lo(sender.inflight_lo_),
+      is_at_full_bandwidth(sender.is_at_full_bandwidth_),
+      min_rtt(sender.min_rtt_),
+      min_rtt_timestamp(sender.min_rtt_timestamp_),
+      last_sample_is_app_limited(sender.last_sample_is_app_limited_) {}
+
+Bbr2Sender::DebugState::DebugState(const DebugState& state) = default;
+
+Bbr2Sender::Bbr2Sender(const RttStats* rtt_stats,
+                       const QuicUnackedPacketMap* unacked_packets,
+                       QuicPacketCount initial_tcp_congestion_window,
+                       QuicPacketCount max_tcp_congestion_window,
+                       QuicRandom* random)
+    : rtt_stats_(rtt_stats),
+      unacked_packets_(unacked_packets),
+      random_(random),
+      mode_(STARTUP),
+      cycle_phase_(PROBE_DOWN),
+      cycle_phase_start_(QuicTime::Zero()),
+      probe_wait_start_(QuicTime::Zero()),
+      probe_wait_start_round_(0),
+      probe_wait_(kMinProbeWait),
+      sampler_(new BandwidthSampler()),
+      round_trip_count_(0),
+      last_sent_packet_(0),
+      current_round_trip_end_(0),
+      round_bytes_acked_(0),
+      round_bytes_lost_(0),
+      round_loss_events_(0),
+      round_max_bandwidth_(QuicBandwidth::Zero()),
+      round_max_bytes_in_flight_(0),
+      round_has_losses_(false),
+      max_bandwidth_(kBandwidthWindowCycles, QuicBandwidth::Zero(), 0),
+      probe_bw_cycle_count_(0),
+      min_rtt_(QuicTime::Delta::Zero()),
+      min_rtt_timestamp_(QuicTime::Zero()),
+      bandwidth_lo_(QuicBandwidth::Infinite()),
+      inflight_lo_(kUnboundedInflight),
+      inflight_hi_(kUnboundedInflight),
+      probe_up_packets_(1),
+      congestion_window_(initial_tcp_congestion_window * kDefaultTCPMSS),
+      initial_congestion_window_(initial_tcp_congestion_window *
+                                 kDefaultTCPMSS),
+      max_congestion_window_(max_tcp_congestion_window * kDefaultTCPMSS),
+      pacing_rate_(QuicBandwidth::Zero()),
+      pacing_gain_(1),
+      congestion_window_gain_(1),
+      is_at_full_bandwidth_(false),
+      rounds_without_bandwidth_gain_(0),
+      bandwidth_at_last_round_(QuicBandwidth::Zero()),
+      startup_lossy_rounds_(0),
+      exiting_quiescence_(false),
+      exit_probe_rtt_at_(QuicTime::Zero()),
+      probe_rtt_round_passed_(false),
+      last_sample_is_app_limited_(false) {
+  EnterStartupMode();
+}
+
+Bbr2Sender::~Bbr2Sender() {}
+
+bool Bbr2Sender::InSlowStart() const {
+  return mode_ == STARTUP;
+}
+
+void Bbr2Sender::OnPacketSent(QuicTime sent_time,
+                              QuicByteCount bytes_in_flight,
+                              QuicPacketNumber packet_number,
+                              QuicByteCount bytes,
+                              HasRetransmittableData is_retransmittable) {
+  last_sent_packet_ = packet_number;
+  round_max_bytes_in_flight_ =
+      std::max(round_max_bytes_in_flight_, bytes_in_flight + bytes);
+
+  if (bytes_in_flight == 0 && sampler_->is_app_limited()) {
+    exiting_quiescence_ = true;
+  }
+
+  sampler_->OnPacketSent(sent_time, packet_number, bytes, bytes_in_flight,
+                         is_retransmittable);
+}
+
+bool Bbr2Sender::CanSend(QuicByteCount bytes_in_flight) {
+  return bytes_in_flight < GetCongestionWindow();
+}
+
+QuicBandwidth Bbr2Sender::PacingRate(QuicByteCount bytes_in_flight) const {
+  if (pacing_rate_.IsZero()) {
+    return kHighGain * QuicBandwidth::FromBytesAndTimeDelta(
+                           initial_congestion_window_, GetMinRtt());
+  }
+  return pacing_rate_;
+}
+
+QuicBandwidth Bbr2Sender::BandwidthEstimate() const {
+  return max_bandwidth_.GetBest();
+}
+
+QuicByteCount Bbr2Sender::GetCongestionWindow() const {
+  QuicByteCount congestion_window = congestion_window_;
+  if (mode_ == PROBE_RTT) {
+    congestion_window = std::min(congestion_window,
+                                 GetTargetInflight(kProbeRttInflightGain));
+  }
+  congestion_window = std::min(congestion_window, GetInflightHighBound());
+  congestion_window = std::min(congestion_window, inflight_lo_);
+  return std::max(congestion_window, kMinimumCongestionWindow);
+}
+
+QuicByteCount Bbr2Sender::GetSlowStartThreshold() const {
+  return 0;
+}
+
+bool Bbr2Sender::InRecovery() const {
+  return inflight_lo_ != kUnboundedInflight;
+}
+
+bool Bbr2Sender::IsProbingForMoreBandwidth() const {
+  return mode_ == STARTUP ||
+         (mode_ == PROBE_BW &&
+          (cycle_phase_ == PROBE_REFILL || cycle_phase_ == PROBE_UP));
+}
+
+void Bbr2Sender::SetFromConfig(const QuicConfig& config,
+                               Perspective perspective) {}
+
+void Bbr2Sender::AdjustNetworkParameters(QuicBandwidth bandwidth,
+                                         QuicTime::Delta rtt) {
+  if (!bandwidth.IsZero()) {
+    max_bandwidth_.Update(bandwidth, probe_bw_cycle_count_);
+  }
+  if (!rtt.IsZero() && (min_rtt_ > rtt || min_rtt_.IsZero())) {
+    min_rtt_ = rtt;
+  }
+}
+
+void Bbr2Sender::OnCongestionEvent(bool /*rtt_updated*/,
+                                   QuicByteCount prior_in_flight,
+                                   QuicTime event_time,
+                                   const AckedPacketVector& acked_packets,
+                                   const LostPacketVector& lost_packets) {
+  const QuicByteCount total_bytes_acked_before = sampler_->total_bytes_acked();
+
+  bool is_round_start = false;
+  bool min_rtt_expired = false;
+
+  if (!acked_packets.empty()) {
+    QuicPacketNumber last_acked_packet = acked_packets.rbegin()->packet_number;
+    is_round_start = UpdateRoundTripCounter(last_acked_packet);
+    min_rtt_expired = UpdateBandwidthAndMinRtt(event_time, acked_packets);
+  }
+
+  const QuicByteCount bytes_acked =
+      sampler_->total_bytes_acked() - total_bytes_acked_before;
+  round_bytes_acked_ += bytes_acked;
+  for (const LostPacket& packet : lost_packets) {
+    sampler_->OnPacketLost(packet.packet_number);
+    round_bytes_lost_ += packet.bytes_lost;
+  }
+  if (!lost_packets.empty()) {
+    round_has_losses_ = true;
+    round_loss_events_ += lost_packets.size();
+    if (IsInflightTooHigh(prior_in_flight)) {
+      HandleInflightTooHigh(event_time, prior_in_flight);
+    }
+  }
+
+  // Handle logic specific to PROBE_BW mode.
+  if (mode_ == PROBE_BW) {
+    UpdateCyclePhase(event_time, prior_in_flight, is_round_start);
+  }
+
+  // Handle logic specific to STARTUP and DRAIN modes.
+  if (is_round_start && !is_at_full_bandwidth_) {
+    CheckIfFullBandwidthReached();
+  }
+  MaybeExitStartupOrDrain(event_time);
+
+  // Handle logic specific to PROBE_RTT.
+  MaybeEnterOrExitProbeRtt(event_time, is_round_start, min_rtt_expired);
+
+  // After the model is updated, recalculate the pacing rate and congestion
+  // window.
+  CalculatePacingRate();
+  CalculateCongestionWindow(bytes_acked);
+
+  // Cleanup internal state.
+  sampler_->RemoveObsoletePackets(unacked_packets_->GetLeastUnacked());
+}
+
+CongestionControlType Bbr2Sender::GetCongestionControlType() const {
+  return kBBRv2;
+}
+
+QuicTime::Delta Bbr2Sender::GetMinRtt() const {
+  return !min_rtt_.IsZero()
+             ? min_rtt_
+             : QuicTime::Delta::FromMicroseconds(rtt_stats_->initial_rtt_us());
+}
+
+QuicBandwidth Bbr2Sender::BoundedBandwidth() const {
+  return std::min(max_bandwidth_.GetBest(), bandwidth_lo_);
+}
+
+QuicByteCount Bbr2Sender::GetTargetInflight(float gain) const {
+  QuicByteCount bdp = GetMinRtt() * BandwidthEstimate();
+  QuicByteCount target = gain * bdp;
+
+  // BDP estimate will be zero if no bandwidth samples are available yet.
+  if (target == 0) {
+    target = gain * initial_congestion_window_;
+  }
+
+  return std::max(target, kMinimumCongestionWindow);
+}
+
+QuicByteCount Bbr2Sender::GetInflightHighBound() const {
+  if (inflight_hi_ == kUnboundedInflight) {
+    return kUnboundedInflight;
+  }
+  if (mode_ == PROBE_BW &&
+      (cycle_phase_ == PROBE_DOWN || cycle_phase_ == PROBE_CRUISE)) {
+    return kInflightHeadroom * inflight_hi_;
+  }
+  return inflight_hi_;
+}
+
+void Bbr2Sender::EnterStartupMode() {
+  mode_ = STARTUP;
+  pacing_gain_ = kHighGain;
+  congestion_window_gain_ = kHighGain;
+}
+
+void Bbr2Sender::EnterProbeBandwidthMode(QuicTime now) {
+  mode_ = PROBE_BW;
+  congestion_window_gain_ = kProbeBwCongestionWindowGain;
+  EnterCyclePhase(PROBE_DOWN, now);
+}
+
+void Bbr2Sender::EnterCyclePhase(CyclePhase phase, QuicTime now) {
+  QUIC_DVLOG(2) << "Entering " << phase << " at " << now.ToDebuggingValue();
+  cycle_phase_ = phase;
+  cycle_phase_start_ = now;
+  switch (phase) {
+    case PROBE_DOWN:
+      pacing_gain_ = kProbeDownPacingGain;
+      // The wait for the next probe starts when the last one ends. Randomize
+      // it so that flows sharing a bottleneck do not probe in lockstep.
+      probe_wait_start_ = now;
+      probe_wait_start_round_ = round_trip_count_;
+      probe_wait_ =
+          kMinProbeWait + QuicTime::Delta::FromMicroseconds(
+                              random_->RandUint64() % kProbeWaitJitterUs);
+      break;
+    case PROBE_CRUISE:
+      pacing_gain_ = 1;
+      break;
+    case PROBE_REFILL:
+      pacing_gain_ = 1;
+      ++probe_bw_cycle_count_;
+      ResetLowerBounds();
+      break;
+    case PROBE_UP:
+      pacing_gain_ = kProbeUpPacingGain;
+      probe_up_packets_ = 1;
+      break;
+  }
+}
+
+bool Bbr2Sender::UpdateRoundTripCounter(QuicPacketNumber last_acked_packet) {
+  if (last_acked_packet <= current_round_trip_end_) {
+    return false;
+  }
+  OnRoundTripEnd();
+  round_trip_count_++;
+  current_round_trip_end_ = last_sent_packet_;
+  return true;
+}
+
+void Bbr2Sender::OnRoundTripEnd() {
+  if (mode_ == STARTUP) {
+    if (IsInflightTooHigh(round_max_bytes_in_flight_) &&
+        round_loss_events_ >= kStartupFullLossCount) {
+      ++startup_lossy_rounds_;
+      // What was delivered in the round trip is what the path holds, queue
+      // included.  Do not bring more than that into the next phase.
+      inflight_hi_ = std::max(GetTargetInflight(1), round_bytes_acked_);
+    } else {
+      startup_lossy_rounds_ = 0;
+    }
+  } else if (round_has_losses_ && !IsProbingForMoreBandwidth()) {
+    AdaptLowerBounds();
+  }
+
+  round_bytes_acked_ = 0;
+  round_bytes_lost_ = 0;
+  round_loss_events_ = 0;
+  round_max_bandwidth_ = QuicBandwidth::Zero();
+  round_max_bytes_in_flight_ = unacked_packets_->bytes_in_flight();
+  round_has_losses_ = false;
+}
+
+bool Bbr2Sender::UpdateBandwidthAndMinRtt(
+    QuicTime now,
+    const AckedPacketVector& acked_packets) {
+  QuicTime::Delta sample_min_rtt = QuicTime::Delta::Infinite();
+  for (const auto& packet : acked_packets) {
+    BandwidthSample bandwidth_sample =
+        sampler_->OnPacketAcknowledged(now, packet.packet_number);
+    last_sample_is_app_limited_ = bandwidth_sample.is_app_limited;
+    if (!bandwidth_sample.rtt.IsZero()) {
+      sample_min_rtt = std::min(sample_min_rtt, bandwidth_sample.rtt);
+    }
+
+    round_max_bandwidth_ =
+        std::max(round_max_bandwidth_, bandwidth_sample.bandwidth);
+    if (!bandwidth_sample.is_app_limited ||
+        bandwidth_sample.bandwidth > BandwidthEstimate()) {
+      max_bandwidth_.Update(bandwidth_sample.bandwidth,
+                            probe_bw_cycle_count_);
+    }
+  }
+
+  // If none of the RTT samples are valid, return immediately.
+  if (sample_min_rtt.IsInfinite()) {
+    return false;
+  }
+
+  // Do not expire min_rtt if none was ever available.
+  bool min_rtt_expired =
+      !min_rtt_.IsZero() && (now > (min_rtt_timestamp_ + kMinRttExpiry));
+
+  if (min_rtt_expired || sample_min_rtt < min_rtt_ || min_rtt_.IsZero()) {
+    QUIC_DVLOG(2) << "Min RTT updated, old value: " << min_rtt_
+                  << ", new value: " << sample_min_rtt
+                  << ", current time: " << now.ToDebuggingValue();
+    min_rtt_ = sample_min_rtt;
+    min_rtt_timestamp_ = now;
+  }
+
+  return min_rtt_expired;
+}
+
+bool Bbr2Sender::IsInflightTooHigh(QuicByteCount bytes_in_flight) const {
+  const QuicByteCount round_bytes =
+      std::max(bytes_in_flight, round_bytes_acked_ + round_bytes_lost_);
+  return round_bytes_lost_ > kLossThreshold * round_bytes;
+}
+
+void Bbr2Sender::HandleInflightTooHigh(QuicTime now,
+                                       QuicByteCount prior_in_flight) {
+  // STARTUP reacts to loss once the round trip is over, in OnRoundTripEnd().
+  if (!IsProbingForMoreBandwidth() || mode_ == STARTUP) {
+    return;
+  }
+  // The path could not hold what was in flight when the loss was detected, so
+  // stay below it, but not much below the estimated BDP.
+  inflight_hi_ = std::max<QuicByteCount>(prior_in_flight,
+                                         kBeta * GetTargetInflight(1));
+  QUIC_DVLOG(2) << "Too much loss while probing, inflight_hi: "
+                << inflight_hi_;
+  EnterCyclePhase(PROBE_DOWN, now);
+}
+
+void Bbr2Sender::AdaptLowerBounds() {
+  if (bandwidth_lo_ == QuicBandwidth::Infinite()) {
+    bandwidth_lo_ = max_bandwidth_.GetBest();
+  }
+  bandwidth_lo_ = std::max(round_max_bandwidth_, kBeta * bandwidth_lo_);
+
+  if (inflight_lo_ == kUnboundedInflight) {
+    inflight_lo_ = congestion_window_;
+  }
+  inflight_lo_ = std::max<QuicByteCount>(round_bytes_acked_,
+                                         kBeta * inflight_lo_);
+  QUIC_DVLOG(2) << "Loss outside of probing, bandwidth_lo: " << bandwidth_lo_
+                << ", inflight_lo: " << inflight_lo_;
+}
+
+void Bbr2Sender::ResetLowerBounds() {
+  bandwidth_lo_ = QuicBandwidth::Infinite();
+  inflight_lo_ = kUnboundedInflight;
+}
+
+void Bbr2Sender::ProbeInflightHighUpward(QuicByteCount prior_in_flight) {
+  if (inflight_hi_ == kUnboundedInflight ||
+      prior_in_flight + kMaxSegmentSize < inflight_hi_) {
+    return;
+  }
+  inflight_hi_ += probe_up_packets_ * kMaxSegmentSize;
+  probe_up_packets_ *= 2;
+}
+
+bool Bbr2Sender::IsTimeToProbe(QuicTime now) const {
+  return now - probe_wait_start_ >= probe_wait_ ||
+         round_trip_count_ - probe_wait_start_round_ >= kMaxRoundsBeforeProbe;
+}
+
+void Bbr2Sender::UpdateCyclePhase(QuicTime now,
+                                  QuicByteCount prior_in_flight,
+                                  bool is_round_start) {
+  switch (cycle_phase_) {
+    case PROBE_DOWN:
+      if (IsTimeToProbe(now)) {
+        EnterCyclePhase(PROBE_REFILL, now);
+        return;
+      }
+      // Cruise once the queue is drained and there is headroom below
+      // |inflight_hi_|.
+      if (prior_in_flight <=
+          std::min(GetTargetInflight(1), GetInflightHighBound())) {
+        EnterCyclePhase(PROBE_CRUISE, now);
+      }
+      return;
+    case PROBE_CRUISE:
+      if (IsTimeToProbe(now)) {
+        EnterCyclePhase(PROBE_REFILL, now);
+      }
+      return;
+    case PROBE_REFILL:
+      // Spend a round trip with the lower bounds lifted, so that the probe
+      // starts from a full pipe.
+      if (is_round_start) {
+        EnterCyclePhase(PROBE_UP, now);
+      }
+      return;
+    case PROBE_UP:
+      if (is_round_start) {
+        ProbeInflightHighUpward(prior_in_flight);
+      }
+      // A queue has built up if the sender keeps more than the probing gain
+      // times the BDP in flight for a whole min_rtt.
+      if (now - cycle_phase_start_ > GetMinRtt() &&
+          prior_in_flight > GetTargetInflight(kProbeUpPacingGain)) {
+        EnterCyclePhase(PROBE_DOWN, now);
+      }
+      return;
+  }
+}
+
+void Bbr2Sender::CheckIfFullBandwidthReached() {
+  if (startup_lossy_rounds_ > 0) {
+    is_at_full_bandwidth_ = true;
+    return;
+  }
+
+  if (last_sample_is_app_limited_) {
+    return;
+  }
+
+  QuicBandwidth target = bandwidth_at_last_round_ * kStartupGrowthTarget;
+  if (BandwidthEstimate() >= target) {
+    bandwidth_at_last_round_ = BandwidthEstimate();
+    rounds_without_bandwidth_gain_ = 0;
+    return;
+  }
+
+  rounds_without_bandwidth_gain_++;
+  if (rounds_without_bandwidth_gain_ >=
+      kRoundTripsWithoutGrowthBeforeExitingStartup) {
+    is_at_full_bandwidth_ = true;
+  }
+}
+
+void Bbr2Sender::MaybeExitStartupOrDrain(QuicTime now) {
+  if (mode_ == STARTUP && is_at_full_bandwidth_) {
+    mode_ = DRAIN;
+    pacing_gain_ = kDrainGain;
+    congestion_window_gain_ = kHighGain;
+  }
+  if (mode_ == DRAIN &&
+      unacked_packets_->bytes_in_flight() <= GetTargetInflight(1)) {
+    EnterProbeBandwidthMode(now);
+  }
+}
+
+void Bbr2Sender::MaybeEnterOrExitProbeRtt(QuicTime now,
+                                          bool is_round_start,
+                                          bool min_rtt_expired) {
+  if (min_rtt_expired && !exiting_quiescence_ && mode_ != PROBE_RTT) {
+    mode_ = PROBE_RTT;
+    pacing_gain_ = 1;
+    // Do not decide on the time to exit PROBE_RTT until the |bytes_in_flight|
+    // is at the target small value.
+    exit_probe_rtt_at_ = QuicTime::Zero();
+  }
+
+  if (mode_ == PROBE_RTT) {
+    sampler_->OnAppLimited();
+
+    if (exit_probe_rtt_at_ == QuicTime::Zero()) {
+      // If the window has reached the appropriate size, schedule exiting
+      // PROBE_RTT.  We allow an extra packet since QUIC checks CWND before
+      // sending a packet.
+      if (unacked_packets_->bytes_in_flight() <
+          GetCongestionWindow() + kMaxPacketSize) {
+        exit_probe_rtt_at_ = now + kProbeRttTime;
+        probe_rtt_round_passed_ = false;
+      }
+    } else {
+      if (is_round_start) {
+        probe_rtt_round_passed_ = true;
+      }
+      if (now >= exit_probe_rtt_at_ && probe_rtt_round_passed_) {
+        min_rtt_timestamp_ = now;
+        if (!is_at_full_bandwidth_) {
+          EnterStartupMode();
+        } else {
+          EnterProbeBandwidthMode(now);
+        }
+      }
+    }
+  }
+
+  exiting_quiescence_ = false;
+}
+
+void Bbr2Sender::CalculatePacingRate() {
+  const QuicBandwidth bandwidth = BoundedBandwidth();
+  if (bandwidth.IsZero()) {
+    return;
+  }
+
+  QuicBandwidth target_rate = pacing_gain_ * bandwidth;
+  if (is_at_full_bandwidth_) {
+    pacing_rate_ = target_rate;
+    return;
+  }
+
+  // Pace at the rate of initial_window / RTT as soon as RTT measurements are
+  // available.
+  if (pacing_rate_.IsZero() && !rtt_stats_->min_rtt().IsZero()) {
+    pacing_rate_ = QuicBandwidth::FromBytesAndTimeDelta(
+        initial_congestion_window_, rtt_stats_->min_rtt());
+    return;
+  }
+
+  // Do not decrease the pacing rate during the startup.
+  pacing_rate_ = std::max(pacing_rate_, target_rate);
+}
+
+void Bbr2Sender::CalculateCongestionWindow(QuicByteCount bytes_acked) {
+  if (mode_ == PROBE_RTT) {
+    return;
+  }
+
+  const QuicByteCount target_window =
+      GetTargetInflight(congestion_window_gain_);
+
+  // Grow the CWND towards |target_window| by only increasing it |bytes_acked|
+  // at a time.  The bounds are applied by GetCongestionWindow(), so that the
+  // window is back as soon as they are lifted.
+  if (is_at_full_bandwidth_) {
+    congestion_window_ =
+        std::min(target_window, congestion_window_ + bytes_acked);
+  } else if (congestion_window_ < target_window ||
+             sampler_->total_bytes_acked() < initial_congestion_window_) {
+    // If the connection is not yet out of startup phase, do not decrease the
+    // window.
+    congestion_window_ = congestion_window_ + bytes_acked;
+  }
+
+  // Enforce the limits on the congestion window.
+  congestion_window_ = std::max(congestion_window_, kMinimumCongestionWindow);
+  congestion_window_ = std::min(congestion_window_, max_congestion_window_);
+}
+
+std::string Bbr2Sender::GetDebugState() const {
+  std::ostringstream stream;
+  stream << ExportDebugState();
+  return stream.str();
+}
+
+void Bbr2Sender::OnApplicationLimited(QuicByteCount bytes_in_flight) {
+  if (bytes_in_flight >= GetCongestionWindow()) {
+    return;
+  }
+
+  sampler_->OnAppLimited();
+  QUIC_DVLOG(2) << "Becoming application limited. Last sent packet: "
+                << last_sent_packet_ << ", CWND: " << GetCongestionWindow();
+}
+
+uint8_t Bbr2Sender::GetTelemetryMode() const {
+  return mode_ << 4 | (mode_ == PROBE_BW ? cycle_phase_ : 0);
+}
+
+Bbr2Sender::DebugState Bbr2Sender::ExportDebugState() const {
+  return DebugState(*this);
+}
+
+static std::string ModeToString(Bbr2Sender::Mode mode) {
+  switch (mode) {
+    case Bbr2Sender::STARTUP:
+      return "STARTUP";
+    case Bbr2Sender::DRAIN:
+      return "DRAIN";
+    case Bbr2Sender::PROBE_BW:
+      return "PROBE_BW";
+    case Bbr2Sender::PROBE_RTT:
+      return "PROBE_RTT";
+  }
+  return "???";
+}
+
+static std::string CyclePhaseToString(Bbr2Sender::CyclePhase phase) {
+  switch (phase) {
+    case Bbr2Sender::PROBE_DOWN:
+      return "PROBE_DOWN";
+    case Bbr2Sender::PROBE_CRUISE:
+      return "PROBE_CRUISE";
+    case Bbr2Sender::PROBE_REFILL:
+      return "PROBE_REFILL";
+    case Bbr2Sender::PROBE_UP:
+      return "PROBE_UP";
+  }
+  return "???";
+}
+
+std::ostream& operator<<(std::ostream& os, const Bbr2Sender::Mode& mode) {
+  os << ModeToString(mode);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const Bbr2Sender::CyclePhase& phase) {
+  os << CyclePhaseToString(phase);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const Bbr2Sender::DebugState& state) {
+  os << "Mode: " << ModeToString(state.mode) << std::endl;
+  if (state.mode == Bbr2Sender::PROBE_BW) {
+    os << "Cycle phase: " << CyclePhaseToString(state.cycle_phase)
+       << std::endl;
+  }
+  os << "Maximum bandwidth: " << state.max_bandwidth << std::endl;
+  if (state.bandwidth_lo != QuicBandwidth::Infinite()) {
+    os << "Bandwidth lower bound: " << state.bandwidth_lo << std::endl;
+  }
+  os << "Round trip counter: " << state.round_trip_count << std::endl;
+  os << "Congestion window: " << state.congestion_window << " bytes"
+     << std::endl;
+  if (state.inflight_hi != kUnboundedInflight) {
+    os << "Inflight upper bound: " << state.inflight_hi << " bytes"
+       << std::endl;
+  }
+  if (state.inflight_lo != kUnboundedInflight) {
+    os << "Inflight lower bound: " << state.inflight_lo << " bytes"
+       << std::endl;
+  }
+
+  os << "Minimum RTT: " << state.min_rtt << std::endl;
+  os << "Minimum RTT timestamp: " << state.min_rtt_timestamp.ToDebuggingValue()
+     << std::endl;
+
+  os << "Last sample is app-limited: "
+     << (state.last_sample_is_app_limited ? "yes" : "no");
+
+  return os;
+}
+
+}  // namespace net
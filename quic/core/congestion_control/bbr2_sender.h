@@ -0,0 +1,280 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// BBRv2 style congestion control: the BBR model of the path, bounded by the
+// amount of data in flight at which loss was observed.
+
+#ifndef NET_QUIC_CORE_CONGESTION_CONTROL_BBR2_SENDER_H_
+#define NET_QUIC_CORE_CONGESTION_CONTROL_BBR2_SENDER_H_
+
+#include <cstdint>
+#include <ostream>
+
+#include "base/macros.h"
+#include "net/quic/core/congestion_control/bandwidth_sampler.h"
+#include "net/quic/core/congestion_control/bbr_sender.h"
+#include "net/quic/core/congestion_control/send_algorithm_interface.h"
+#include "net/quic/core/congestion_control/windowed_filter.h"
+#include "net/quic/core/crypto/quic_random.h"
+#include "net/quic/core/quic_bandwidth.h"
+#include "net/quic/core/quic_packets.h"
+#include "net/quic/core/quic_time.h"
+#include "net/quic/core/quic_unacked_packet_map.h"
+#include "net/quic/platform/api/quic_export.h"
+
+namespace net {
+
+class RttStats;
+
+// Bbr2Sender keeps BBR's estimate of the bottleneck bandwidth and minimum RTT,
+// but unlike BbrSender it does not ignore loss. Two sets of bounds are layered
+// on top of the model:
+//   - |inflight_hi| is the amount of data in flight at which the loss rate of
+//     a round trip went over kLossThreshold while probing. The sender stays
+//     below it, with some headroom, until it probes again.
+//   - |bandwidth_lo| and |inflight_lo| are reduced multiplicatively for every
+//     round trip with loss outside of probing, and reset when the next probe
+//     starts, so that the sender yields to competing flows and policers
+//     between probes.
+// Probing for bandwidth is loss aware: PROBE_UP grows |inflight_hi|
+// exponentially per round trip and stops as soon as the loss rate is too high
+// or a queue builds up.
+//
+// Like BBR, this relies on pacing. Do not use it when pacing is disabled.
+class QUIC_EXPORT_PRIVATE Bbr2Sender : public SendAlgorithmInterface {
+ public:
+  enum Mode {
+    STARTUP,
+    DRAIN,
+    PROBE_BW,
+    PROBE_RTT,
+  };
+
+  // Phases of the PROBE_BW cycle.
+  enum CyclePhase {
+    // Drain the queue created by PROBE_UP, and leave headroom below
+    // |inflight_hi|.
+    PROBE_DOWN,
+    // Send at the estimated bandwidth, within the bounds.
+    PROBE_CRUISE,
+    // Lift the lower bounds and fill the pipe for one round trip before
+    // probing.
+    PROBE_REFILL,
+    // Probe for more bandwidth, raising |inflight_hi| until loss or a queue.
+    PROBE_UP,
+  };
+
+  // Debug state can be exported in order to troubleshoot potential congestion
+  // control issues.
+  struct QUIC_EXPORT_PRIVATE DebugState {
+    explicit DebugState(const Bbr2Sender& sender);
+    DebugState(const DebugState& state);
+
+    Mode mode;
+    CyclePhase cycle_phase;
+    QuicBandwidth max_bandwidth;
+    QuicBandwidth bandwidth_lo;
+    QuicRoundTripCount round_trip_count;
+    QuicByteCount congestion_window;
+    QuicByteCount inflight_hi;
+    QuicByteCount inflight_lo;
+
+    bool is_at_full_bandwidth;
+    QuicTime::Delta min_rtt;
+    QuicTime min_rtt_timestamp;
+
+    bool last_sample_is_app_limited;
+  };
+
+  Bbr2Sender(const RttStats* rtt_stats,
+             const QuicUnackedPacketMap* unacked_packets,
+             QuicPacketCount initial_tcp_congestion_window,
+             QuicPacketCount max_tcp_congestion_window,
+             QuicRandom* random);
+  ~Bbr2Sender() override;
+
+  // Start implementation of SendAlgorithmInterface.
+  bool InSlowStart() const override;
+  bool InRecovery() const override;
+  bool IsProbingForMoreBandwidth() const override;
+
+  void SetFromConfig(const QuicConfig& config,
+                     Perspective perspective) override;
+
+  void AdjustNetworkParameters(QuicBandwidth bandwidth,
+                               QuicTime::Delta rtt) override;
+  void SetNumEmulatedConnections(int num_connections) override {}
+  void OnCongestionEvent(bool rtt_updated,
+                         QuicByteCount prior_in_flight,
+                         QuicTime event_time,
+                         const AckedPacketVector& acked_packets,
+                         const LostPacketVector& lost_packets) override;
+  void OnPacketSent(QuicTime sent_time,
+                    QuicByteCount bytes_in_flight,
+                    QuicPacketNumber packet_number,
+                    QuicByteCount bytes,
+                    HasRetransmittableData is_retransmittable) override;
+  void OnRetransmissionTimeout(bool packets_retransmitted) override {}
+  void OnConnectionMigration() override {}
+  bool CanSend(QuicByteCount bytes_in_flight) override;
+  QuicBandwidth PacingRate(QuicByteCount bytes_in_flight) const override;
+  QuicBandwidth BandwidthEstimate() const override;
+  QuicByteCount GetCongestionWindow() const override;
+  QuicByteCount GetSlowStartThreshold() const override;
+  CongestionControlType GetCongestionControlType() const override;
+  std::string GetDebugState() const override;
+  void OnApplicationLimited(QuicByteCount bytes_in_flight) override;
+  // Returns |mode_| in the high four bits and, in PROBE_BW, |cycle_phase_| in
+  // the low four bits.
+  uint8_t GetTelemetryMode() const override;
+  // End implementation of SendAlgorithmInterface.
+
+  DebugState ExportDebugState() const;
+
+ private:
+  typedef WindowedFilter<QuicBandwidth,
+                         MaxFilter<QuicBandwidth>,
+                         QuicRoundTripCount,
+                         QuicRoundTripCount>
+      MaxBandwidthFilter;
+
+  // Returns the current estimate of the RTT of the connection.  Outside of the
+  // edge cases, this is minimum RTT.
+  QuicTime::Delta GetMinRtt() const;
+  // Returns the bandwidth the sender paces at: the model bandwidth, bounded by
+  // |bandwidth_lo_|.
+  QuicBandwidth BoundedBandwidth() const;
+  // Returns |gain| times the estimated bandwidth-delay product.
+  QuicByteCount GetTargetInflight(float gain) const;
+  // Returns the bound |inflight_hi_| puts on the congestion window in the
+  // current phase.
+  QuicByteCount GetInflightHighBound() const;
+
+  void EnterStartupMode();
+  void EnterProbeBandwidthMode(QuicTime now);
+  void EnterCyclePhase(CyclePhase phase, QuicTime now);
+
+  // Updates the round-trip counter if a round-trip has passed.  Returns true if
+  // the counter has been advanced.
+  bool UpdateRoundTripCounter(QuicPacketNumber last_acked_packet);
+  // Updates the bandwidth and min_rtt estimates based on the samples for the
+  // received acknowledgements.  Returns true if min_rtt has expired.
+  bool UpdateBandwidthAndMinRtt(QuicTime now,
+                                const AckedPacketVector& acked_packets);
+  // Returns true if the bytes lost in the current round trip are more than
+  // kLossThreshold of |bytes_in_flight|, or of the bytes acked and lost in it
+  // if that is larger.
+  bool IsInflightTooHigh(QuicByteCount bytes_in_flight) const;
+  // Lowers |inflight_hi_| after too much loss while probing.
+  void HandleInflightTooHigh(QuicTime now, QuicByteCount prior_in_flight);
+  // Lowers |bandwidth_lo_| and |inflight_lo_| at the end of a round trip in
+  // which loss happened while not probing.
+  void AdaptLowerBounds();
+  void ResetLowerBounds();
+  // Raises |inflight_hi_| at the start of each PROBE_UP round trip in which
+  // the sender was limited by it, by a number of packets which doubles every
+  // round trip.
+  void ProbeInflightHighUpward(QuicByteCount prior_in_flight);
+  // Returns true once PROBE_DOWN or PROBE_CRUISE have lasted long enough.
+  bool IsTimeToProbe(QuicTime now) const;
+
+  void CheckIfFullBandwidthReached();
+  void MaybeExitStartupOrDrain(QuicTime now);
+  void UpdateCyclePhase(QuicTime now,
+                        QuicByteCount prior_in_flight,
+                        bool is_round_start);
+  // Closes the round trip which just ended: counts it towards exiting STARTUP
+  // on loss or adapts the lower bounds, then resets the round counters.
+  void OnRoundTripEnd();
+  void MaybeEnterOrExitProbeRtt(QuicTime now,
+                                bool is_round_start,
+                                bool min_rtt_expired);
+
+  void CalculatePacingRate();
+  void CalculateCongestionWindow(QuicByteCount bytes_acked);
+
+  const RttStats* rtt_stats_;
+  const QuicUnackedPacketMap* unacked_packets_;
+  QuicRandom* random_;
+
+  Mode mode_;
+  CyclePhase cycle_phase_;
+  // The time at which the current cycle phase started.
+  QuicTime cycle_phase_start_;
+  // The time and round trip at which the last probe ended, which is when the
+  // wait for the next one starts.
+  QuicTime probe_wait_start_;
+  QuicRoundTripCount probe_wait_start_round_;
+  // How long to wait in PROBE_CRUISE before the next probe.
+  QuicTime::Delta probe_wait_;
+
+  std::unique_ptr<BandwidthSamplerInterface> sampler_;
+
+  QuicRoundTripCount round_trip_count_;
+  QuicPacketNumber last_sent_packet_;
+  QuicPacketNumber current_round_trip_end_;
+
+  // Bytes acked and lost, loss events, and the largest bandwidth sample seen,
+  // in the current round trip.
+  QuicByteCount round_bytes_acked_;
+  QuicByteCount round_bytes_lost_;
+  QuicPacketCount round_loss_events_;
+  QuicBandwidth round_max_bandwidth_;
+  QuicByteCount round_max_bytes_in_flight_;
+  // Set if the current round trip saw loss.
+  bool round_has_losses_;
+
+  // Bandwidth filter indexed by |probe_bw_cycle_count_|, incremented every
+  // time a probe starts.
+  MaxBandwidthFilter max_bandwidth_;
+  QuicRoundTripCount probe_bw_cycle_count_;
+
+  QuicTime::Delta min_rtt_;
+  QuicTime min_rtt_timestamp_;
+
+  // Lower bounds, reduced on loss outside of probing. Unbounded when
+  // Infinite() and the max QuicByteCount respectively.
+  QuicBandwidth bandwidth_lo_;
+  QuicByteCount inflight_lo_;
+  // Upper bound learnt from loss while probing. Unbounded when it is the max
+  // QuicByteCount.
+  QuicByteCount inflight_hi_;
+  // Number of packets by which |inflight_hi_| grows in the next PROBE_UP
+  // round trip.
+  QuicPacketCount probe_up_packets_;
+
+  QuicByteCount congestion_window_;
+  QuicByteCount initial_congestion_window_;
+  QuicByteCount max_congestion_window_;
+  QuicBandwidth pacing_rate_;
+  float pacing_gain_;
+  float congestion_window_gain_;
+
+  bool is_at_full_bandwidth_;
+  QuicRoundTripCount rounds_without_bandwidth_gain_;
+  QuicBandwidth bandwidth_at_last_round_;
+  // Number of consecutive round trips in STARTUP with too much loss.
+  QuicRoundTripCount startup_lossy_rounds_;
+
+  bool exiting_quiescence_;
+  QuicTime exit_probe_rtt_at_;
+  bool probe_rtt_round_passed_;
+
+  bool last_sample_is_app_limited_;
+
+  DISALLOW_COPY_AND_ASSIGN(Bbr2Sender);
+};
+
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(std::ostream& os,
+                                             const Bbr2Sender::Mode& mode);
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(
+    std::ostream& os,
+    const Bbr2Sender::CyclePhase& phase);
+QUIC_EXPORT_PRIVATE std::ostream& operator<<(
+    std::ostream& os,
+    const Bbr2Sender::DebugState& state);
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_CONGESTION_CONTROL_BBR2_SENDER_H_
@@ -0,0 +1,345 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/congestion_control/bbr2_sender.h"
+
+#include <limits>
+#include <memory>
+
+#include "net/quic/core/congestion_control/rtt_stats.h"
+#include "net/quic/core/quic_packets.h"
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/quic/test_tools/quic_connection_peer.h"
+#include "net/quic/test_tools/quic_sent_packet_manager_peer.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+#include "net/quic/test_tools/simulator/quic_endpoint.h"
+#include "net/quic/test_tools/simulator/simulator.h"
+#include "net/quic/test_tools/simulator/switch.h"
+
+namespace net {
+namespace test {
+namespace {
+
+// Use the initial CWND of 10, as 32 is too much for the test network.
+const uint32_t kInitialCongestionWindowPackets = 10;
+const uint32_t kDefaultWindowTCP =
+    kInitialCongestionWindowPackets * kDefaultTCPMSS;
+
+// Same topology as in bbr_sender_test.cc:
+//
+//        BBRv2 sender
+//               |
+//               |  <-- local link (10 Mbps, 2 ms delay)
+//               |
+//        Network switch
+//               *  <-- the bottleneck queue in the direction
+//               |          of the receiver
+//               |
+//               |  <-- test link (4 Mbps, 30 ms delay)
+//               |
+//               |
+//           Receiver
+const QuicBandwidth kTestLinkBandwidth =
+    QuicBandwidth::FromKBitsPerSecond(4000);
+const QuicBandwidth kLocalLinkBandwidth =
+    QuicBandwidth::FromKBitsPerSecond(10000);
+const QuicTime::Delta kTestPropagationDelay =
+    QuicTime::Delta::FromMilliseconds(30);
+const QuicTime::Delta kLocalPropagationDelay =
+    QuicTime::Delta::FromMilliseconds(2);
+const QuicTime::Delta kTestTransferTime =
+    kTestLinkBandwidth.TransferTime(kMaxPacketSize) +
+    kLocalLinkBandwidth.TransferTime(kMaxPacketSize);
+const QuicTime::Delta kTestRtt =
+    (kTestPropagationDelay + kLocalPropagationDelay + kTestTransferTime) * 2;
+const QuicByteCount kTestBdp = kTestRtt * kTestLinkBandwidth;
+
+const QuicByteCount kUnboundedInflight =
+    std::numeric_limits<QuicByteCount>::max();
+
+class Bbr2SenderTest : public QuicTest {
+ protected:
+  Bbr2SenderTest()
+      : simulator_(),
+        bbr_sender_(&simulator_,
+                    "BBRv2 sender",
+                    "Receiver",
+                    Perspective::IS_CLIENT,
+                    /*connection_id=*/42),
+        competing_sender_(&simulator_,
+                          "Competing sender",
+                          "Competing receiver",
+                          Perspective::IS_CLIENT,
+                          /*connection_id=*/43),
+        receiver_(&simulator_,
+                  "Receiver",
+                  "BBRv2 sender",
+                  Perspective::IS_SERVER,
+                  /*connection_id=*/42),
+        competing_receiver_(&simulator_,
+                            "Competing receiver",
+                            "Competing sender",
+                            Perspective::IS_SERVER,
+                            /*connection_id=*/43),
+        receiver_multiplexer_("Receiver multiplexer",
+                              {&receiver_, &competing_receiver_}) {
+    rtt_stats_ = bbr_sender_.connection()->sent_packet_manager().GetRttStats();
+    sender_ = SetupBbr2Sender(&bbr_sender_);
+
+    clock_ = simulator_.GetClock();
+    simulator_.set_random_generator(&random_);
+
+    uint64_t seed = QuicRandom::GetInstance()->RandUint64();
+    random_.set_seed(seed);
+    QUIC_LOG(INFO) << "Bbr2SenderTest simulator set up.  Seed: " << seed;
+  }
+
+  simulator::Simulator simulator_;
+  simulator::QuicEndpoint bbr_sender_;
+  simulator::QuicEndpoint competing_sender_;
+  simulator::QuicEndpoint receiver_;
+  simulator::QuicEndpoint competing_receiver_;
+  simulator::QuicEndpointMultiplexer receiver_multiplexer_;
+  std::unique_ptr<simulator::Switch> switch_;
+  std::unique_ptr<simulator::SymmetricLink> bbr_sender_link_;
+  std::unique_ptr<simulator::SymmetricLink> competing_sender_link_;
+  std::unique_ptr<simulator::SymmetricLink> receiver_link_;
+
+  SimpleRandom random_;
+
+  // Owned by different components of the connection.
+  const QuicClock* clock_;
+  const RttStats* rtt_stats_;
+  Bbr2Sender* sender_;
+
+  // Enables BBRv2 on |endpoint| and returns the associated congestion
+  // controller.
+  Bbr2Sender* SetupBbr2Sender(simulator::QuicEndpoint* endpoint) {
+    const RttStats* rtt_stats =
+        endpoint->connection()->sent_packet_manager().GetRttStats();
+    // Ownership of the sender will be overtaken by the endpoint.
+    Bbr2Sender* sender = new Bbr2Sender(
+        rtt_stats,
+        QuicSentPacketManagerPeer::GetUnackedPacketMap(
+            QuicConnectionPeer::GetSentPacketManager(endpoint->connection())),
+        kInitialCongestionWindowPackets, kDefaultMaxCongestionWindowPackets,
+        &random_);
+    QuicConnectionPeer::SetSendAlgorithm(endpoint->connection(), sender);
+    return sender;
+  }
+
+  // Creates a network with a bottleneck between the receiver and the switch,
+  // with buffers of |buffer_size|.
+  void CreateSetup(QuicByteCount buffer_size) {
+    switch_.reset(
+        new simulator::Switch(&simulator_, "Switch", 8, buffer_size));
+    bbr_sender_link_.reset(new simulator::SymmetricLink(
+        &bbr_sender_, switch_->port(1), kLocalLinkBandwidth,
+        kLocalPropagationDelay));
+    receiver_link_.reset(new simulator::SymmetricLink(
+        &receiver_, switch_->port(2), kTestLinkBandwidth,
+        kTestPropagationDelay));
+  }
+
+  // The switch has the buffers twice as large as the bottleneck BDP, which
+  // should guarantee a lack of losses.
+  void CreateDefaultSetup() { CreateSetup(2 * kTestBdp); }
+
+  // Same as the default setup, except the buffer now is half of the BDP.
+  void CreateSmallBufferSetup() { CreateSetup(0.5 * kTestBdp); }
+
+  // Creates a BBRv2 vs BBRv2 setup sharing the bottleneck link.
+  void CreateBbr2VsBbr2Setup() {
+    SetupBbr2Sender(&competing_sender_);
+    switch_.reset(
+        new simulator::Switch(&simulator_, "Switch", 8, 2 * kTestBdp));
+
+    // Add a small offset to the competing link in order to avoid
+    // synchronization effects.
+    const QuicTime::Delta small_offset = QuicTime::Delta::FromMicroseconds(3);
+
+    bbr_sender_link_.reset(new simulator::SymmetricLink(
+        &bbr_sender_, switch_->port(1), kLocalLinkBandwidth,
+        kLocalPropagationDelay));
+    competing_sender_link_.reset(new simulator::SymmetricLink(
+        &competing_sender_, switch_->port(3), kLocalLinkBandwidth,
+        kLocalPropagationDelay + small_offset));
+    receiver_link_.reset(new simulator::SymmetricLink(
+        &receiver_multiplexer_, switch_->port(2), kTestLinkBandwidth,
+        kTestPropagationDelay));
+  }
+
+  void DoSimpleTransfer(QuicByteCount transfer_size, QuicTime::Delta deadline) {
+    bbr_sender_.AddBytesToTransfer(transfer_size);
+    bool simulator_result = simulator_.RunUntilOrTimeout(
+        [this]() { return bbr_sender_.bytes_to_transfer() == 0; }, deadline);
+    EXPECT_TRUE(simulator_result)
+        << "Simple transfer failed.  Bytes remaining: "
+        << bbr_sender_.bytes_to_transfer();
+    QUIC_LOG(INFO) << "Simple transfer state: " << sender_->ExportDebugState();
+  }
+
+  // Drive the simulator by sending enough data to enter PROBE_BW.
+  void DriveOutOfStartup() {
+    ASSERT_FALSE(sender_->ExportDebugState().is_at_full_bandwidth);
+    DoSimpleTransfer(1024 * 1024, QuicTime::Delta::FromSeconds(15));
+    EXPECT_EQ(Bbr2Sender::PROBE_BW, sender_->ExportDebugState().mode);
+    ExpectApproxEq(kTestLinkBandwidth,
+                   sender_->ExportDebugState().max_bandwidth, 0.01f);
+  }
+};
+
+// Test a simple long data transfer in the default setup.
+TEST_F(Bbr2SenderTest, SimpleTransfer) {
+  CreateDefaultSetup();
+
+  EXPECT_EQ(kDefaultWindowTCP, sender_->GetCongestionWindow());
+  EXPECT_TRUE(sender_->CanSend(0));
+  EXPECT_TRUE(sender_->InSlowStart());
+  EXPECT_FALSE(sender_->InRecovery());
+  EXPECT_EQ(kBBRv2, sender_->GetCongestionControlType());
+
+  // Verify that pacing rate is based on the initial RTT.
+  QuicBandwidth expected_pacing_rate = QuicBandwidth::FromBytesAndTimeDelta(
+      2.885 * kDefaultWindowTCP,
+      QuicTime::Delta::FromMicroseconds(rtt_stats_->initial_rtt_us()));
+  ExpectApproxEq(expected_pacing_rate.ToBitsPerSecond(),
+                 sender_->PacingRate(0).ToBitsPerSecond(), 0.01f);
+
+  DoSimpleTransfer(12 * 1024 * 1024, QuicTime::Delta::FromSeconds(30));
+  EXPECT_EQ(Bbr2Sender::PROBE_BW, sender_->ExportDebugState().mode);
+  ExpectApproxEq(kTestLinkBandwidth, sender_->ExportDebugState().max_bandwidth,
+                 0.01f);
+  EXPECT_EQ(0u, bbr_sender_.connection()->GetStats().packets_lost);
+  // Without loss, neither of the bounds is ever set.
+  EXPECT_EQ(kUnboundedInflight, sender_->ExportDebugState().inflight_hi);
+  EXPECT_EQ(kUnboundedInflight, sender_->ExportDebugState().inflight_lo);
+  EXPECT_FALSE(sender_->ExportDebugState().last_sample_is_app_limited);
+
+  ExpectApproxEq(kTestRtt, rtt_stats_->smoothed_rtt(), 0.2f);
+}
+
+// Test a simple transfer in a situation when the buffer is less than BDP. The
+// loss has to bound the amount in flight, which in turn keeps the loss rate
+// low.
+TEST_F(Bbr2SenderTest, SimpleTransferSmallBuffer) {
+  CreateSmallBufferSetup();
+
+  DoSimpleTransfer(12 * 1024 * 1024, QuicTime::Delta::FromSeconds(30));
+  EXPECT_EQ(Bbr2Sender::PROBE_BW, sender_->ExportDebugState().mode);
+  ExpectApproxEq(kTestLinkBandwidth, sender_->ExportDebugState().max_bandwidth,
+                 0.01f);
+
+  const QuicConnectionStats& stats = bbr_sender_.connection()->GetStats();
+  EXPECT_LT(0u, stats.packets_lost);
+  EXPECT_GE(0.05f * stats.packets_sent, stats.packets_lost);
+
+  // The path holds at most the BDP plus the buffer.
+  const QuicByteCount inflight_hi = sender_->ExportDebugState().inflight_hi;
+  EXPECT_NE(kUnboundedInflight, inflight_hi);
+  EXPECT_GE(2 * kTestBdp, inflight_hi);
+}
+
+// The connection must exit STARTUP in a lossy round trip, without waiting for
+// the bandwidth to stop growing.
+TEST_F(Bbr2SenderTest, StartupExitsOnLoss) {
+  CreateSetup(0.25 * kTestBdp);
+
+  bbr_sender_.AddBytesToTransfer(100 * 1024 * 1024);
+  bool simulator_result = simulator_.RunUntilOrTimeout(
+      [this]() {
+        return bbr_sender_.connection()->GetStats().packets_lost > 0;
+      },
+      QuicTime::Delta::FromSeconds(5));
+  ASSERT_TRUE(simulator_result);
+
+  simulator_result = simulator_.RunUntilOrTimeout(
+      [this]() { return sender_->ExportDebugState().is_at_full_bandwidth; },
+      10 * kTestRtt);
+  ASSERT_TRUE(simulator_result);
+  EXPECT_NE(kUnboundedInflight, sender_->ExportDebugState().inflight_hi);
+}
+
+// Verify that PROBE_BW goes through all of its phases.
+TEST_F(Bbr2SenderTest, ProbeBandwidthCycle) {
+  CreateDefaultSetup();
+  DriveOutOfStartup();
+
+  // We have no intention of ever finishing this transfer.
+  bbr_sender_.AddBytesToTransfer(100 * 1024 * 1024);
+
+  for (Bbr2Sender::CyclePhase phase :
+       {Bbr2Sender::PROBE_CRUISE, Bbr2Sender::PROBE_REFILL,
+        Bbr2Sender::PROBE_UP, Bbr2Sender::PROBE_DOWN}) {
+    bool simulator_result = simulator_.RunUntilOrTimeout(
+        [this, phase]() {
+          return sender_->ExportDebugState().cycle_phase == phase;
+        },
+        QuicTime::Delta::FromSeconds(5));
+    ASSERT_TRUE(simulator_result) << "Never entered " << phase;
+    EXPECT_EQ(phase == Bbr2Sender::PROBE_REFILL ||
+                  phase == Bbr2Sender::PROBE_UP,
+              sender_->IsProbingForMoreBandwidth());
+  }
+}
+
+// Verify that the connection enters and exits PROBE_RTT correctly.
+TEST_F(Bbr2SenderTest, ProbeRtt) {
+  CreateDefaultSetup();
+  DriveOutOfStartup();
+
+  // We have no intention of ever finishing this transfer.
+  bbr_sender_.AddBytesToTransfer(100 * 1024 * 1024);
+
+  // Wait until the connection enters PROBE_RTT.
+  const QuicTime::Delta timeout = QuicTime::Delta::FromSeconds(12);
+  bool simulator_result = simulator_.RunUntilOrTimeout(
+      [this]() {
+        return sender_->ExportDebugState().mode == Bbr2Sender::PROBE_RTT;
+      },
+      timeout);
+  ASSERT_TRUE(simulator_result);
+  ASSERT_EQ(Bbr2Sender::PROBE_RTT, sender_->ExportDebugState().mode);
+  EXPECT_GE(kTestBdp, sender_->GetCongestionWindow());
+
+  // Exit PROBE_RTT.
+  const QuicTime probe_rtt_start = clock_->Now();
+  const QuicTime::Delta time_to_exit_probe_rtt =
+      kTestRtt + QuicTime::Delta::FromMilliseconds(200);
+  simulator_.RunFor(1.5 * time_to_exit_probe_rtt);
+  EXPECT_EQ(Bbr2Sender::PROBE_BW, sender_->ExportDebugState().mode);
+  EXPECT_GE(sender_->ExportDebugState().min_rtt_timestamp, probe_rtt_start);
+}
+
+// Two BBRv2 flows sharing a bottleneck both make progress.
+TEST_F(Bbr2SenderTest, SimpleCompetition) {
+  const QuicByteCount transfer_size = 10 * 1024 * 1024;
+  const QuicTime::Delta transfer_time =
+      kTestLinkBandwidth.TransferTime(transfer_size);
+  CreateBbr2VsBbr2Setup();
+
+  // Transfer 10% of data in first transfer.
+  bbr_sender_.AddBytesToTransfer(transfer_size);
+  bool simulator_result = simulator_.RunUntilOrTimeout(
+      [this, transfer_size]() {
+        return receiver_.bytes_received() >= 0.1 * transfer_size;
+      },
+      transfer_time);
+  ASSERT_TRUE(simulator_result);
+
+  // Start the second transfer and wait until both finish.
+  competing_sender_.AddBytesToTransfer(transfer_size);
+  simulator_result = simulator_.RunUntilOrTimeout(
+      [this, transfer_size]() {
+        return receiver_.bytes_received() == transfer_size &&
+               competing_receiver_.bytes_received() == transfer_size;
+      },
+      3 * transfer_time);
+  ASSERT_TRUE(simulator_result);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
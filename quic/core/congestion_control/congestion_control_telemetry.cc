@@ -0,0 +1,110 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/congestion_control/congestion_control_telemetry.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "net/quic/core/congestion_control/rtt_stats.h"
+#include "net/quic/core/congestion_control/send_algorithm_interface.h"
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+namespace {
+
+uint32_t SaturatedUint32(QuicByteCount bytes) {
+  return static_cast<uint32_t>(std::min<QuicByteCount>(
+      bytes, std::numeric_limits<uint32_t>::max()));
+}
+
+}  // namespace
+
+CongestionControlTelemetry::Record::Record()
+    : time(QuicTime::Zero()),
+      pacing_rate(QuicBandwidth::Zero()),
+      bandwidth_estimate(QuicBandwidth::Zero()),
+      min_rtt(QuicTime::Delta::Zero()),
+      smoothed_rtt(QuicTime::Delta::Zero()),
+      congestion_window(0),
+      bytes_in_flight(0),
+      mode(0),
+      flags(0) {}
+
+CongestionControlTelemetry::CongestionControlTelemetry(
+    size_t capacity,
+    QuicTime::Delta sampling_interval)
+    : sampling_interval_(sampling_interval),
+      records_(std::max<size_t>(capacity, 1)),
+      first_(0),
+      size_(0),
+      dropped_(0),
+      last_record_time_(QuicTime::Zero()),
+      last_mode_(0),
+      last_flags_(0),
+      has_recorded_(false) {
+  DCHECK_LT(0u, capacity);
+}
+
+CongestionControlTelemetry::~CongestionControlTelemetry() {}
+
+void CongestionControlTelemetry::OnCongestionEvent(
+    QuicTime now,
+    const SendAlgorithmInterface& send_algorithm,
+    const RttStats& rtt_stats,
+    QuicByteCount bytes_in_flight) {
+  const uint8_t mode = send_algorithm.GetTelemetryMode();
+  uint8_t flags = 0;
+  if (send_algorithm.InSlowStart()) {
+    flags |= IN_SLOW_START;
+  }
+  if (send_algorithm.InRecovery()) {
+    flags |= IN_RECOVERY;
+  }
+
+  const bool mode_changed =
+      has_recorded_ && (mode != last_mode_ || flags != last_flags_);
+  if (has_recorded_ && !mode_changed &&
+      now - last_record_time_ < sampling_interval_) {
+    return;
+  }
+  has_recorded_ = true;
+  last_record_time_ = now;
+  last_mode_ = mode;
+  last_flags_ = flags;
+
+  size_t index = first_ + size_;
+  if (size_ == records_.size()) {
+    // Overwrite the oldest record.
+    first_ = (first_ + 1) % records_.size();
+    ++dropped_;
+  } else {
+    ++size_;
+  }
+  Record* record = &records_[index % records_.size()];
+  record->time = now;
+  record->pacing_rate = send_algorithm.PacingRate(bytes_in_flight);
+  record->bandwidth_estimate = send_algorithm.BandwidthEstimate();
+  record->min_rtt = rtt_stats.min_rtt();
+  record->smoothed_rtt = rtt_stats.smoothed_rtt();
+  record->congestion_window =
+      SaturatedUint32(send_algorithm.GetCongestionWindow());
+  record->bytes_in_flight = SaturatedUint32(bytes_in_flight);
+  record->mode = mode;
+  record->flags = flags | (mode_changed ? MODE_CHANGED : 0);
+}
+
+size_t CongestionControlTelemetry::Drain(std::vector<Record>* records) {
+  const size_t drained = size_;
+  records->reserve(records->size() + drained);
+  for (size_t i = 0; i < drained; ++i) {
+    records->push_back(records_[(first_ + i) % records_.size()]);
+  }
+  first_ = 0;
+  size_ = 0;
+  return drained;
+}
+
+}  // namespace net
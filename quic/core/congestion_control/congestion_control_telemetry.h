@@ -0,0 +1,106 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Low overhead recording of the state of the send algorithm of a connection,
+// for the embedder to export.
+
+#ifndef NET_QUIC_CORE_CONGESTION_CONTROL_CONGESTION_CONTROL_TELEMETRY_H_
+#define NET_QUIC_CORE_CONGESTION_CONTROL_CONGESTION_CONTROL_TELEMETRY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "base/macros.h"
+#include "net/quic/core/quic_bandwidth.h"
+#include "net/quic/core/quic_packets.h"
+#include "net/quic/core/quic_time.h"
+#include "net/quic/platform/api/quic_export.h"
+
+namespace net {
+
+class RttStats;
+class SendAlgorithmInterface;
+
+// CongestionControlTelemetry keeps the most recent samples of the state of a
+// send algorithm in a ring buffer allocated upfront.  A sample is taken at most
+// once per sampling interval, and whenever the mode of the algorithm changes.
+// When the buffer is full the oldest samples are overwritten, so an embedder
+// which does not drain it in time loses the oldest history rather than
+// stalling the connection.
+//
+// This class is not thread-safe, it is owned and used on the thread of the
+// connection.
+class QUIC_EXPORT_PRIVATE CongestionControlTelemetry {
+ public:
+  // Bits of Record::flags.
+  enum Flags : uint8_t {
+    IN_SLOW_START = 1 << 0,
+    IN_RECOVERY = 1 << 1,
+    // The record was taken because the mode or the flags above changed, rather
+    // than because the sampling interval has passed.
+    MODE_CHANGED = 1 << 2,
+  };
+
+  struct QUIC_EXPORT_PRIVATE Record {
+    Record();
+
+    QuicTime time;
+    QuicBandwidth pacing_rate;
+    QuicBandwidth bandwidth_estimate;
+    QuicTime::Delta min_rtt;
+    QuicTime::Delta smoothed_rtt;
+    // Truncated to 4GB, which is far above any congestion window in use.
+    uint32_t congestion_window;
+    uint32_t bytes_in_flight;
+    // Value of SendAlgorithmInterface::GetTelemetryMode().
+    uint8_t mode;
+    uint8_t flags;
+  };
+
+  // |capacity| is the number of records kept, and must be positive.
+  CongestionControlTelemetry(size_t capacity,
+                             QuicTime::Delta sampling_interval);
+  ~CongestionControlTelemetry();
+
+  // Called after every congestion event.  Records the state of
+  // |send_algorithm| and |rtt_stats| if the sampling interval has passed since
+  // the last record or if the mode of |send_algorithm| changed.
+  void OnCongestionEvent(QuicTime now,
+                         const SendAlgorithmInterface& send_algorithm,
+                         const RttStats& rtt_stats,
+                         QuicByteCount bytes_in_flight);
+
+  // Appends the records held, oldest first, to |records| and empties the
+  // buffer.  Returns the number of records appended.
+  size_t Drain(std::vector<Record>* records);
+
+  // Number of records currently held.
+  size_t size() const { return size_; }
+
+  size_t capacity() const { return records_.size(); }
+
+  // Number of records overwritten before they were drained.
+  uint64_t dropped() const { return dropped_; }
+
+ private:
+  const QuicTime::Delta sampling_interval_;
+
+  // Ring buffer of |size_| records starting at |first_|.
+  std::vector<Record> records_;
+  size_t first_;
+  size_t size_;
+  uint64_t dropped_;
+
+  // Time of the last record, and the mode and flags it carried.
+  QuicTime last_record_time_;
+  uint8_t last_mode_;
+  uint8_t last_flags_;
+  bool has_recorded_;
+
+  DISALLOW_COPY_AND_ASSIGN(CongestionControlTelemetry);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_CONGESTION_CONTROL_CONGESTION_CONTROL_TELEMETRY_H_
@@ -0,0 +1,132 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/congestion_control/congestion_control_telemetry.h"
+
+#include <vector>
+
+#include "net/quic/core/congestion_control/rtt_stats.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::_;
+
+namespace net {
+namespace test {
+namespace {
+
+const QuicTime::Delta kSamplingInterval =
+    QuicTime::Delta::FromMilliseconds(100);
+
+class CongestionControlTelemetryTest : public QuicTest {
+ protected:
+  CongestionControlTelemetryTest() : telemetry_(4, kSamplingInterval) {
+    clock_.AdvanceTime(QuicTime::Delta::FromSeconds(1));
+    rtt_stats_.UpdateRtt(QuicTime::Delta::FromMilliseconds(50),
+                         QuicTime::Delta::Zero(), clock_.Now());
+    ON_CALL(send_algorithm_, GetCongestionWindow())
+        .WillByDefault(Return(20 * kDefaultTCPMSS));
+    ON_CALL(send_algorithm_, PacingRate(_))
+        .WillByDefault(Return(QuicBandwidth::FromKBitsPerSecond(1000)));
+    ON_CALL(send_algorithm_, BandwidthEstimate())
+        .WillByDefault(Return(QuicBandwidth::FromKBitsPerSecond(800)));
+  }
+
+  void OnCongestionEvent() {
+    telemetry_.OnCongestionEvent(clock_.Now(), send_algorithm_, rtt_stats_,
+                                 10 * kDefaultTCPMSS);
+  }
+
+  std::vector<CongestionControlTelemetry::Record> Drain() {
+    std::vector<CongestionControlTelemetry::Record> records;
+    telemetry_.Drain(&records);
+    return records;
+  }
+
+  MockClock clock_;
+  RttStats rtt_stats_;
+  NiceMock<MockSendAlgorithm> send_algorithm_;
+  CongestionControlTelemetry telemetry_;
+};
+
+TEST_F(CongestionControlTelemetryTest, RecordsState) {
+  EXPECT_CALL(send_algorithm_, InSlowStart()).WillRepeatedly(Return(true));
+  EXPECT_CALL(send_algorithm_, GetTelemetryMode()).WillRepeatedly(Return(3));
+  OnCongestionEvent();
+
+  std::vector<CongestionControlTelemetry::Record> records = Drain();
+  ASSERT_EQ(1u, records.size());
+  const CongestionControlTelemetry::Record& record = records[0];
+  EXPECT_EQ(clock_.Now(), record.time);
+  EXPECT_EQ(20 * kDefaultTCPMSS, record.congestion_window);
+  EXPECT_EQ(10 * kDefaultTCPMSS, record.bytes_in_flight);
+  EXPECT_EQ(QuicBandwidth::FromKBitsPerSecond(1000), record.pacing_rate);
+  EXPECT_EQ(QuicBandwidth::FromKBitsPerSecond(800), record.bandwidth_estimate);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(50), record.min_rtt);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(50), record.smoothed_rtt);
+  EXPECT_EQ(3u, record.mode);
+  EXPECT_EQ(CongestionControlTelemetry::IN_SLOW_START, record.flags);
+  EXPECT_EQ(0u, telemetry_.size());
+}
+
+TEST_F(CongestionControlTelemetryTest, SamplesOncePerInterval) {
+  OnCongestionEvent();
+  clock_.AdvanceTime(kSamplingInterval * 0.5);
+  OnCongestionEvent();
+  EXPECT_EQ(1u, telemetry_.size());
+
+  clock_.AdvanceTime(kSamplingInterval * 0.5);
+  OnCongestionEvent();
+  EXPECT_EQ(2u, telemetry_.size());
+}
+
+TEST_F(CongestionControlTelemetryTest, RecordsModeChanges) {
+  OnCongestionEvent();
+
+  EXPECT_CALL(send_algorithm_, GetTelemetryMode()).WillRepeatedly(Return(1));
+  OnCongestionEvent();
+  EXPECT_CALL(send_algorithm_, InRecovery()).WillRepeatedly(Return(true));
+  OnCongestionEvent();
+  // No change.
+  OnCongestionEvent();
+
+  std::vector<CongestionControlTelemetry::Record> records = Drain();
+  ASSERT_EQ(3u, records.size());
+  EXPECT_EQ(0u, records[0].flags);
+  EXPECT_EQ(CongestionControlTelemetry::MODE_CHANGED, records[1].flags);
+  EXPECT_EQ(1u, records[1].mode);
+  EXPECT_EQ(CongestionControlTelemetry::MODE_CHANGED |
+                CongestionControlTelemetry::IN_RECOVERY,
+            records[2].flags);
+}
+
+TEST_F(CongestionControlTelemetryTest, OverwritesOldestRecords) {
+  for (int i = 0; i < 6; ++i) {
+    OnCongestionEvent();
+    clock_.AdvanceTime(kSamplingInterval);
+  }
+  EXPECT_EQ(4u, telemetry_.size());
+  EXPECT_EQ(2u, telemetry_.dropped());
+
+  std::vector<CongestionControlTelemetry::Record> records = Drain();
+  ASSERT_EQ(4u, records.size());
+  // The first two records were overwritten.
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(clock_.Now() - kSamplingInterval * static_cast<int>(4 - i),
+              records[i].time);
+  }
+
+  // The buffer is reused after draining.
+  OnCongestionEvent();
+  records = Drain();
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(clock_.Now(), records[0].time);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
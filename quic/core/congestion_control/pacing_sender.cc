@@ -4,6 +4,8 @@
 
 #include "net/quic/core/congestion_control/pacing_sender.h"
 
+#include "net/quic/core/quic_connection_stats.h"
+#include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
 
 namespace net {
@@ -17,6 +19,11 @@ static const QuicTime::Delta kAlarmGranularity =
 // is never larger than the current CWND in packets.
 static const uint32_t kInitialUnpacedBurst = 10;
 
+// Maximum number of packets released by a single wakeup when batch release is
+// enabled, including packets making up for a late wakeup.  Sized to fit in a
+// single GSO batch.
+static const QuicPacketCount kMaxBatchReleasePackets = 32;
+
 }  // namespace
 
 PacingSender::PacingSender()
@@ -26,7 +33,12 @@ PacingSender::PacingSender()
       last_delayed_packet_sent_time_(QuicTime::Zero()),
       ideal_next_packet_send_time_(QuicTime::Zero()),
       was_last_send_delayed_(false),
-      initial_burst_size_(kInitialUnpacedBurst) {}
+      initial_burst_size_(kInitialUnpacedBurst),
+      alarm_granularity_(kAlarmGranularity),
+      waiting_for_wakeup_(false),
+      wakeup_time_(QuicTime::Zero()),
+      bytes_sent_since_wakeup_(0),
+      stats_(nullptr) {}
 
 PacingSender::~PacingSender() {}
 
@@ -61,6 +73,17 @@ void PacingSender::OnPacketSent(
   if (has_retransmittable_data != HAS_RETRANSMITTABLE_DATA) {
     return;
   }
+  if (waiting_for_wakeup_) {
+    waiting_for_wakeup_ = false;
+    bytes_sent_since_wakeup_ = 0;
+    if (stats_ != nullptr && sent_time > wakeup_time_) {
+      const int64_t lateness_us = (sent_time - wakeup_time_).ToMicroseconds();
+      stats_->pacing_wakeup_lateness_us += lateness_us;
+      stats_->max_pacing_wakeup_lateness_us =
+          std::max(stats_->max_pacing_wakeup_lateness_us, lateness_us);
+    }
+  }
+  bytes_sent_since_wakeup_ += bytes;
   // If in recovery, the connection is not coming out of quiescence.
   if (bytes_in_flight == 0 && !sender_->InRecovery()) {
     // Add more burst tokens anytime the connection is leaving quiescence, but
@@ -92,14 +115,23 @@ void PacingSender::OnPacketSent(
         sent_time > last_delayed_packet_sent_time_ + delay;
     const bool making_up_for_lost_time =
         ideal_next_packet_send_time_ <= sent_time;
+    // With batch release, a single wakeup never makes up for more than a
+    // batch, the rest of the lost time is forgone.
+    const bool batch_exhausted =
+        FLAGS_quic_reloadable_flag_quic_pacing_batch_release &&
+        bytes_sent_since_wakeup_ >= kMaxBatchReleasePackets * kDefaultTCPMSS;
     // As long as we're making up time and not application limited,
     // continue to consider the packets delayed, allowing the packets to be
     // sent immediately.
-    if (making_up_for_lost_time && !application_limited) {
+    if (making_up_for_lost_time && !application_limited && !batch_exhausted) {
       last_delayed_packet_sent_time_ = sent_time;
     } else {
       was_last_send_delayed_ = false;
       last_delayed_packet_sent_time_ = QuicTime::Zero();
+      if (batch_exhausted) {
+        ideal_next_packet_send_time_ =
+            std::max(ideal_next_packet_send_time_, sent_time + delay);
+      }
     }
   } else {
     ideal_next_packet_send_time_ =
@@ -121,11 +153,18 @@ QuicTime::Delta PacingSender::TimeUntilSend(QuicTime now,
     return QuicTime::Delta::Zero();
   }
 
-  // If the next send time is within the alarm granularity, send immediately.
-  if (ideal_next_packet_send_time_ > now + kAlarmGranularity) {
+  // If the next send time is within the release window, send immediately.
+  if (ideal_next_packet_send_time_ > now + GetReleaseWindow(bytes_in_flight)) {
     QUIC_DVLOG(1) << "Delaying packet: "
                   << (ideal_next_packet_send_time_ - now).ToMicroseconds();
     was_last_send_delayed_ = true;
+    if (!waiting_for_wakeup_) {
+      waiting_for_wakeup_ = true;
+      if (stats_ != nullptr) {
+        ++stats_->pacing_wakeups;
+      }
+    }
+    wakeup_time_ = ideal_next_packet_send_time_;
     return ideal_next_packet_send_time_ - now;
   }
 
@@ -143,4 +182,18 @@ QuicBandwidth PacingSender::PacingRate(QuicByteCount bytes_in_flight) const {
   return sender_->PacingRate(bytes_in_flight);
 }
 
+QuicTime::Delta PacingSender::GetReleaseWindow(
+    QuicByteCount bytes_in_flight) const {
+  if (!FLAGS_quic_reloadable_flag_quic_pacing_batch_release) {
+    return alarm_granularity_;
+  }
+  // Release the bytes the pacing rate allows per alarm granularity, at least
+  // one packet and at most one batch.
+  const QuicBandwidth pacing_rate = PacingRate(bytes_in_flight);
+  const QuicByteCount budget =
+      std::min(std::max(pacing_rate * alarm_granularity_, kDefaultTCPMSS),
+               kMaxBatchReleasePackets * kDefaultTCPMSS);
+  return std::min(alarm_granularity_, pacing_rate.TransferTime(budget));
+}
+
 }  // namespace net
@@ -25,6 +25,8 @@
 
 namespace net {
 
+struct QuicConnectionStats;
+
 namespace test {
 class QuicSentPacketManagerPeer;
 }  // namespace test
@@ -45,6 +47,18 @@ class QUIC_EXPORT_PRIVATE PacingSender {
 
   QuicBandwidth max_pacing_rate() const { return max_pacing_rate_; }
 
+  // Sets the resolution of the alarm which wakes up the connection to send
+  // paced packets.  Packets due within this interval are released together.
+  void set_alarm_granularity(QuicTime::Delta alarm_granularity) {
+    alarm_granularity_ = alarm_granularity;
+  }
+
+  QuicTime::Delta alarm_granularity() const { return alarm_granularity_; }
+
+  // Sets the stats the pacing wakeups are recorded into. Does not take
+  // ownership of |stats|, which may be null.
+  void set_stats(QuicConnectionStats* stats) { stats_ = stats; }
+
   void OnCongestionEvent(bool rtt_updated,
                          QuicByteCount bytes_in_flight,
                          QuicTime event_time,
@@ -64,6 +78,12 @@ class QUIC_EXPORT_PRIVATE PacingSender {
  private:
   friend class test::QuicSentPacketManagerPeer;
 
+  // Returns how far ahead of their ideal send time packets are released by a
+  // single wakeup.  The window covers the bytes the pacing rate allows per
+  // alarm granularity, bounded so that a wakeup fills at most one batch of
+  // the packet writer.
+  QuicTime::Delta GetReleaseWindow(QuicByteCount bytes_in_flight) const;
+
   // Underlying sender. Not owned.
   SendAlgorithmInterface* sender_;
   // If not QuicBandidth::Zero, the maximum rate the PacingSender will use.
@@ -77,6 +97,17 @@ class QUIC_EXPORT_PRIVATE PacingSender {
   bool was_last_send_delayed_;  // True when the last send was delayed.
   uint32_t initial_burst_size_;
 
+  QuicTime::Delta alarm_granularity_;
+  // True when the last call to TimeUntilSend delayed the send and no packet
+  // has been sent since.
+  bool waiting_for_wakeup_;
+  // Time the connection was asked to wake up at when |waiting_for_wakeup_|.
+  QuicTime wakeup_time_;
+  // Bytes sent since the connection last woke up to send paced packets.
+  QuicByteCount bytes_sent_since_wakeup_;
+  // Not owned, may be null.
+  QuicConnectionStats* stats_;
+
   DISALLOW_COPY_AND_ASSIGN(PacingSender);
 };
 
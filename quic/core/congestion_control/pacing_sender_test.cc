@@ -6,7 +6,9 @@
 
 #include <memory>
 
+#include "net/quic/core/quic_connection_stats.h"
 #include "net/quic/core/quic_packets.h"
+#include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/test_tools/mock_clock.h"
@@ -348,5 +350,104 @@ TEST_F(PacingSenderTest, NoBurstInRecovery) {
   CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(2));
 }
 
+TEST_F(PacingSenderTest, AlarmGranularity) {
+  // Configure pacing rate of 1 packet per 1 ms, no initial burst.
+  InitPacingRate(0, QuicBandwidth::FromBytesAndTimeDelta(
+                        kMaxPacketSize, QuicTime::Delta::FromMilliseconds(1)));
+  pacing_sender_->set_alarm_granularity(QuicTime::Delta::FromMilliseconds(4));
+
+  UpdateRtt();
+
+  // Packets due within the 4ms granularity are sent immediately.
+  for (int i = 0; i < 5; ++i) {
+    CheckPacketIsSentImmediately();
+  }
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(5));
+
+  // Waking up on time releases the packet due now and the next 4ms worth of
+  // packets.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(5));
+  for (int i = 0; i < 5; ++i) {
+    CheckPacketIsSentImmediately();
+  }
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(5));
+}
+
+TEST_F(PacingSenderTest, WakeupStats) {
+  QuicConnectionStats stats;
+  InitPacingRate(0, QuicBandwidth::FromBytesAndTimeDelta(
+                        kMaxPacketSize, QuicTime::Delta::FromMilliseconds(1)));
+  pacing_sender_->set_stats(&stats);
+
+  UpdateRtt();
+
+  CheckPacketIsSentImmediately();
+  CheckPacketIsSentImmediately();
+  // Asking repeatedly for the same delay is a single wakeup.
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(2));
+  EXPECT_EQ(1u, stats.pacing_wakeups);
+
+  // Wake up on time.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(2));
+  CheckPacketIsSentImmediately();
+  CheckPacketIsSentImmediately();
+  EXPECT_EQ(0, stats.pacing_wakeup_lateness_us);
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(2));
+  EXPECT_EQ(2u, stats.pacing_wakeups);
+
+  // Wake up late.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(3));
+  CheckPacketIsSentImmediately();
+  EXPECT_EQ(1000, stats.pacing_wakeup_lateness_us);
+  EXPECT_EQ(1000, stats.max_pacing_wakeup_lateness_us);
+}
+
+TEST_F(PacingSenderTest, BatchReleaseBoundsMakeUp) {
+  FLAGS_quic_reloadable_flag_quic_pacing_batch_release = true;
+  // Configure pacing rate of 1 packet per 1 ms, no initial burst.
+  InitPacingRate(0, QuicBandwidth::FromBytesAndTimeDelta(
+                        kMaxPacketSize, QuicTime::Delta::FromMilliseconds(1)));
+
+  UpdateRtt();
+
+  CheckPacketIsSentImmediately();
+  CheckPacketIsSentImmediately();
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(2));
+
+  // Wake up really late.  Only a single batch is released, instead of the
+  // 100 packets which would make up for the lost time.
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(100));
+  const QuicPacketCount kBatchPackets =
+      (32 * kDefaultTCPMSS + kMaxPacketSize - 1) / kMaxPacketSize;
+  for (QuicPacketCount i = 0; i < kBatchPackets + 1; ++i) {
+    CheckPacketIsSentImmediately();
+  }
+  CheckPacketIsDelayed(QuicTime::Delta::FromMilliseconds(2));
+}
+
+TEST_F(PacingSenderTest, BatchReleaseBoundsWindowAtHighRate) {
+  FLAGS_quic_reloadable_flag_quic_pacing_batch_release = true;
+  // At 100 packets per ms, the 1ms granularity is more than a batch.
+  InitPacingRate(
+      0, QuicBandwidth::FromBytesAndTimeDelta(
+             100 * kMaxPacketSize, QuicTime::Delta::FromMilliseconds(1)));
+
+  UpdateRtt();
+
+  const QuicTime start = clock_.Now();
+  QuicPacketCount packets_sent = 0;
+  while (packets_sent < 100) {
+    EXPECT_CALL(*mock_sender_, CanSend(kBytesInFlight)).WillOnce(Return(true));
+    if (!pacing_sender_->TimeUntilSend(clock_.Now(), kBytesInFlight)
+             .IsZero()) {
+      break;
+    }
+    CheckPacketIsSentImmediately();
+    ++packets_sent;
+  }
+  EXPECT_EQ(start, clock_.Now());
+  EXPECT_GE(33u, packets_sent);
+}
+
 }  // namespace test
 }  // namespace net
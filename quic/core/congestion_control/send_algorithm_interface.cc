@@ -4,6 +4,7 @@
 
 #include "net/quic/core/congestion_control/send_algorithm_interface.h"
 
+#include "net/quic/core/congestion_control/bbr2_sender.h"
 #include "net/quic/core/congestion_control/bbr_sender.h"
 #include "net/quic/core/congestion_control/tcp_cubic_sender_bytes.h"
 #include "net/quic/core/quic_packets.h"
@@ -27,6 +28,13 @@ SendAlgorithmInterface* SendAlgorithmInterface::Create(
     QuicPacketCount initial_congestion_window) {
   QuicPacketCount max_congestion_window = kDefaultMaxCongestionWindowPackets;
   switch (congestion_control_type) {
+    case kBBRv2:
+      if (FLAGS_quic_reloadable_flag_quic_enable_bbr2) {
+        return new Bbr2Sender(rtt_stats, unacked_packets,
+                              initial_congestion_window, max_congestion_window,
+                              random);
+      }
+    // Fall back to BBR if BBRv2 is disabled.
     case kBBR:
       return new BbrSender(rtt_stats, unacked_packets,
                            initial_congestion_window, max_congestion_window,
@@ -50,4 +58,8 @@ SendAlgorithmInterface* SendAlgorithmInterface::Create(
   return nullptr;
 }
 
+uint8_t SendAlgorithmInterface::GetTelemetryMode() const {
+  return 0;
+}
+
 }  // namespace net
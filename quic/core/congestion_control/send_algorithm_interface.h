@@ -132,6 +132,11 @@ class QUIC_EXPORT_PRIVATE SendAlgorithmInterface {
   // such cases, it should use the internal state it uses for congestion control
   // for that.
   virtual void OnApplicationLimited(QuicByteCount bytes_in_flight) = 0;
+
+  // Returns an algorithm specific code for the state the algorithm is in, such
+  // as the BBR mode, which CongestionControlTelemetry records changes of.
+  // Slow start and recovery are recorded separately.  Returns 0 by default.
+  virtual uint8_t GetTelemetryMode() const;
 };
 
 }  // namespace net
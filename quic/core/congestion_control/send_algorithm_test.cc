@@ -113,6 +113,8 @@ const char* CongestionControlTypeToString(CongestionControlType cc_type) {
       return "BBR";
     case kPCC:
       return "PCC";
+    case kBBRv2:
+      return "BBRv2";
     default:
       QUIC_DLOG(FATAL) << "Unexpected CongestionControlType";
       return nullptr;
@@ -175,6 +175,18 @@ bool AeadBaseDecrypter::DecryptPacket(QuicTransportVersion /*version*/,
   return true;
 }
 
+bool AeadBaseDecrypter::DecryptPacketInPlace(QuicTransportVersion version,
+                                             QuicPacketNumber packet_number,
+                                             QuicStringPiece associated_data,
+                                             char* buffer,
+                                             size_t ciphertext_length,
+                                             size_t* output_length) {
+  // EVP_AEAD_CTX_open allows the output to start exactly at the input.
+  return DecryptPacket(version, packet_number, associated_data,
+                       QuicStringPiece(buffer, ciphertext_length), buffer,
+                       output_length, ciphertext_length);
+}
+
 QuicStringPiece AeadBaseDecrypter::GetKey() const {
   return QuicStringPiece(reinterpret_cast<const char*>(key_), key_size_);
 }
@@ -39,6 +39,12 @@ class QUIC_EXPORT_PRIVATE AeadBaseDecrypter : public QuicDecrypter {
                      char* output,
                      size_t* output_length,
                      size_t max_output_length) override;
+  bool DecryptPacketInPlace(QuicTransportVersion version,
+                            QuicPacketNumber packet_number,
+                            QuicStringPiece associated_data,
+                            char* buffer,
+                            size_t ciphertext_length,
+                            size_t* output_length) override;
   QuicStringPiece GetKey() const override;
   QuicStringPiece GetNoncePrefix() const override;
 
@@ -130,6 +130,56 @@ bool AeadBaseEncrypter::EncryptPacket(QuicTransportVersion /*version*/,
   // TODO(ianswett): Introduce a check to ensure that we don't encrypt with the
   // same packet number twice.
   QUIC_ALIGNED(4) char nonce_buffer[kMaxNonceSize];
+  FillNonce(packet_number, nonce_buffer);
+
+  if (!Encrypt(QuicStringPiece(nonce_buffer, nonce_size_), associated_data,
+               plaintext, reinterpret_cast<unsigned char*>(output))) {
+    return false;
+  }
+  *output_length = ciphertext_size;
+  return true;
+}
+
+bool AeadBaseEncrypter::EncryptPacketWithTrailingPlaintext(
+    QuicTransportVersion /*version*/,
+    QuicPacketNumber packet_number,
+    QuicStringPiece associated_data,
+    QuicStringPiece plaintext,
+    QuicStringPiece trailing_plaintext,
+    char* output,
+    size_t* output_length,
+    size_t max_output_length) {
+  size_t ciphertext_size =
+      GetCiphertextSize(plaintext.length() + trailing_plaintext.length());
+  if (max_output_length < ciphertext_size) {
+    return false;
+  }
+  QUIC_ALIGNED(4) char nonce_buffer[kMaxNonceSize];
+  FillNonce(packet_number, nonce_buffer);
+
+  // The ciphertext of |trailing_plaintext| is written in front of the tag, so
+  // the output is identical to encrypting the concatenated plaintext.
+  uint8_t* out = reinterpret_cast<uint8_t*>(output);
+  size_t out_tag_len;
+  if (!EVP_AEAD_CTX_seal_scatter(
+          ctx_.get(), out, out + plaintext.size(), &out_tag_len,
+          max_output_length - plaintext.size(),
+          reinterpret_cast<const uint8_t*>(nonce_buffer), nonce_size_,
+          reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size(),
+          reinterpret_cast<const uint8_t*>(trailing_plaintext.data()),
+          trailing_plaintext.size(),
+          reinterpret_cast<const uint8_t*>(associated_data.data()),
+          associated_data.size())) {
+    DLogOpenSslErrors();
+    return false;
+  }
+  DCHECK_EQ(ciphertext_size, plaintext.size() + out_tag_len);
+  *output_length = ciphertext_size;
+  return true;
+}
+
+void AeadBaseEncrypter::FillNonce(QuicPacketNumber packet_number,
+                                  char* nonce_buffer) const {
   memcpy(nonce_buffer, iv_, nonce_size_);
   size_t prefix_len = nonce_size_ - sizeof(packet_number);
   if (use_ietf_nonce_construction_) {
@@ -140,13 +190,6 @@ bool AeadBaseEncrypter::EncryptPacket(QuicTransportVersion /*version*/,
   } else {
     memcpy(nonce_buffer + prefix_len, &packet_number, sizeof(packet_number));
   }
-
-  if (!Encrypt(QuicStringPiece(nonce_buffer, nonce_size_), associated_data,
-               plaintext, reinterpret_cast<unsigned char*>(output))) {
-    return false;
-  }
-  *output_length = ciphertext_size;
-  return true;
 }
 
 size_t AeadBaseEncrypter::GetKeySize() const {
@@ -37,6 +37,15 @@ class QUIC_EXPORT_PRIVATE AeadBaseEncrypter : public QuicEncrypter {
                      char* output,
                      size_t* output_length,
                      size_t max_output_length) override;
+  // |output| must either start at |plaintext| or not overlap with it.
+  bool EncryptPacketWithTrailingPlaintext(QuicTransportVersion version,
+                                          QuicPacketNumber packet_number,
+                                          QuicStringPiece associated_data,
+                                          QuicStringPiece plaintext,
+                                          QuicStringPiece trailing_plaintext,
+                                          char* output,
+                                          size_t* output_length,
+                                          size_t max_output_length) override;
   size_t GetKeySize() const override;
   size_t GetNoncePrefixSize() const override;
   size_t GetMaxPlaintextSize(size_t ciphertext_size) const override;
@@ -59,6 +68,10 @@ class QUIC_EXPORT_PRIVATE AeadBaseEncrypter : public QuicEncrypter {
   enum : size_t { kMaxNonceSize = 12 };
 
  private:
+  // Writes the nonce for |packet_number| to |nonce_buffer|, which must hold at
+  // least kMaxNonceSize bytes.
+  void FillNonce(QuicPacketNumber packet_number, char* nonce_buffer) const;
+
   const EVP_AEAD* const aead_alg_;
   const size_t key_size_;
   const size_t auth_tag_size_;
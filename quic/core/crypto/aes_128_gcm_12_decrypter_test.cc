@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "net/quic/core/crypto/aes_128_gcm_12_encrypter.h"
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/platform/api/quic_text_utils.h"
@@ -282,5 +283,38 @@ TEST_F(Aes128Gcm12DecrypterTest, Decrypt) {
   }
 }
 
+TEST_F(Aes128Gcm12DecrypterTest, DecryptPacketInPlace) {
+  Aes128Gcm12Encrypter encrypter;
+  Aes128Gcm12Decrypter decrypter;
+  string key(16, 'k');
+  ASSERT_TRUE(encrypter.SetKey(key));
+  ASSERT_TRUE(decrypter.SetKey(key));
+  ASSERT_TRUE(encrypter.SetNoncePrefix("abcd"));
+  ASSERT_TRUE(decrypter.SetNoncePrefix("abcd"));
+
+  QuicPacketNumber packet_number = UINT64_C(0x123456789ABC);
+  string associated_data = "associated_data";
+  string plaintext = "plaintext";
+  char buffer[1024];
+  size_t len;
+  ASSERT_TRUE(encrypter.EncryptPacket(QuicVersionMax(), packet_number,
+                                      associated_data, plaintext, buffer, &len,
+                                      arraysize(buffer)));
+  size_t decrypted_len;
+  ASSERT_TRUE(decrypter.DecryptPacketInPlace(QuicVersionMax(), packet_number,
+                                             associated_data, buffer, len,
+                                             &decrypted_len));
+  EXPECT_EQ(plaintext, QuicStringPiece(buffer, decrypted_len));
+
+  // Tampered ciphertext fails to decrypt.
+  ASSERT_TRUE(encrypter.EncryptPacket(QuicVersionMax(), packet_number,
+                                      associated_data, plaintext, buffer, &len,
+                                      arraysize(buffer)));
+  buffer[0] ^= 0x80;
+  EXPECT_FALSE(decrypter.DecryptPacketInPlace(QuicVersionMax(), packet_number,
+                                              associated_data, buffer, len,
+                                              &decrypted_len));
+}
+
 }  // namespace test
 }  // namespace net
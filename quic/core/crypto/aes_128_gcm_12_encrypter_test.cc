@@ -223,6 +223,35 @@ TEST_F(Aes128Gcm12EncrypterTest, Encrypt) {
   }
 }
 
+TEST_F(Aes128Gcm12EncrypterTest, EncryptPacketWithTrailingPlaintext) {
+  Aes128Gcm12Encrypter encrypter;
+  ASSERT_TRUE(encrypter.SetKey(string(16, 'k')));
+  ASSERT_TRUE(encrypter.SetNoncePrefix("abcd"));
+
+  QuicPacketNumber packet_number = UINT64_C(0x123456789ABC);
+  string associated_data = "associated_data";
+  string plaintext = "plain";
+  string trailing_plaintext = "text";
+  char expected[1024];
+  size_t expected_len;
+  ASSERT_TRUE(encrypter.EncryptPacket(
+      QuicVersionMax(), packet_number, associated_data,
+      plaintext + trailing_plaintext, expected, &expected_len,
+      arraysize(expected)));
+
+  // Encrypting in place, with the trailing plaintext read from elsewhere,
+  // produces the same ciphertext.
+  char encrypted[1024];
+  memcpy(encrypted, plaintext.data(), plaintext.length());
+  size_t len;
+  ASSERT_TRUE(encrypter.EncryptPacketWithTrailingPlaintext(
+      QuicVersionMax(), packet_number, associated_data,
+      QuicStringPiece(encrypted, plaintext.length()), trailing_plaintext,
+      encrypted, &len, arraysize(encrypted)));
+  test::CompareCharArraysWithHexError("ciphertext", encrypted, len, expected,
+                                      expected_len);
+}
+
 TEST_F(Aes128Gcm12EncrypterTest, GetMaxPlaintextSize) {
   Aes128Gcm12Encrypter encrypter;
   EXPECT_EQ(1000u, encrypter.GetMaxPlaintextSize(1012));
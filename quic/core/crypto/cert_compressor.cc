@@ -5,9 +5,11 @@
 #include "net/quic/core/crypto/cert_compressor.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 #include "net/quic/core/quic_utils.h"
+#include "net/quic/platform/api/quic_mutex.h"
 #include "third_party/zlib/zlib.h"
 
 using std::string;
@@ -415,39 +417,109 @@ bool ParseEntries(QuicStringPiece* in_out,
   return true;
 }
 
-// ScopedZLib deals with the automatic destruction of a zlib context.
-class ScopedZLib {
+// ZLibStreamPool keeps a few idle zlib streams of each type around, already
+// reset, so that a handshake does not pay for allocating and initialising the
+// ~256 KB of deflate state, or the inflate window, every time. Reset streams
+// behave exactly like freshly initialised ones and only need to be primed with
+// their dictionary.
+//
+// deflateCopy() of a stream primed once per dictionary was also considered,
+// but it copies the whole deflate state and measured slower than resetting
+// and priming a pooled stream for dictionaries of the usual size.
+class ZLibStreamPool {
  public:
   enum Type {
     INFLATE,
     DEFLATE,
   };
 
-  explicit ScopedZLib(Type type) : z_(nullptr), type_(type) {}
-
-  void reset(z_stream* z) {
-    Clear();
-    z_ = z;
+  static ZLibStreamPool* GetInstance() {
+    static ZLibStreamPool* pool = new ZLibStreamPool();
+    return pool;
   }
 
-  ~ScopedZLib() { Clear(); }
+  // Returns an initialised stream of |type|, or nullptr on failure.
+  z_stream* Take(Type type) {
+    {
+      QuicWriterMutexLock lock(&mutex_);
+      std::vector<z_stream*>* idle = &idle_streams_[type];
+      if (!idle->empty()) {
+        z_stream* z = idle->back();
+        idle->pop_back();
+        return z;
+      }
+    }
 
- private:
-  void Clear() {
-    if (!z_) {
-      return;
+    std::unique_ptr<z_stream> z(new z_stream);
+    memset(z.get(), 0, sizeof(*z));
+    int rv = type == DEFLATE ? deflateInit(z.get(), Z_DEFAULT_COMPRESSION)
+                             : inflateInit(z.get());
+    DCHECK_EQ(Z_OK, rv);
+    if (rv != Z_OK) {
+      return nullptr;
     }
+    return z.release();
+  }
 
-    if (type_ == DEFLATE) {
-      deflateEnd(z_);
+  // Resets |z|, which was returned by Take(type), and keeps it for the next
+  // caller or destroys it if enough streams are idle already.
+  void Return(Type type, z_stream* z) {
+    int rv = type == DEFLATE ? deflateReset(z) : inflateReset(z);
+    if (rv == Z_OK) {
+      QuicWriterMutexLock lock(&mutex_);
+      std::vector<z_stream*>* idle = &idle_streams_[type];
+      if (idle->size() < kMaxIdleStreams) {
+        idle->push_back(z);
+        return;
+      }
+    }
+    if (type == DEFLATE) {
+      deflateEnd(z);
     } else {
-      inflateEnd(z_);
+      inflateEnd(z);
+    }
+    delete z;
+  }
+
+ private:
+  // Enough for a server handling handshakes on a few threads at once.
+  static const size_t kMaxIdleStreams = 8;
+
+  ZLibStreamPool() {}
+
+  QuicMutex mutex_;
+  std::vector<z_stream*> idle_streams_[2] GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(ZLibStreamPool);
+};
+
+// ScopedZLib deals with taking a zlib context from the pool and giving it
+// back.
+class ScopedZLib {
+ public:
+  typedef ZLibStreamPool::Type Type;
+
+  explicit ScopedZLib(Type type) : z_(nullptr), type_(type) {}
+
+  ~ScopedZLib() {
+    if (z_) {
+      ZLibStreamPool::GetInstance()->Return(type_, z_);
     }
-    z_ = nullptr;
   }
 
+  // Returns a stream which is ready to be primed with a dictionary and used,
+  // or nullptr on failure.
+  z_stream* Init() {
+    DCHECK(!z_);
+    z_ = ZLibStreamPool::GetInstance()->Take(type_);
+    return z_;
+  }
+
+ private:
   z_stream* z_;
   const Type type_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedZLib);
 };
 
 }  // anonymous namespace
@@ -469,28 +541,25 @@ string CertCompressor::CompressChain(const std::vector<string>& certs,
   }
 
   size_t compressed_size = 0;
-  z_stream z;
-  ScopedZLib scoped_z(ScopedZLib::DEFLATE);
+  z_stream* z = nullptr;
+  ScopedZLib scoped_z(ZLibStreamPool::DEFLATE);
 
   if (uncompressed_size > 0) {
-    memset(&z, 0, sizeof(z));
-    int rv = deflateInit(&z, Z_DEFAULT_COMPRESSION);
-    DCHECK_EQ(Z_OK, rv);
-    if (rv != Z_OK) {
+    z = scoped_z.Init();
+    if (!z) {
       return "";
     }
-    scoped_z.reset(&z);
 
     string zlib_dict = ZlibDictForEntries(entries, certs);
 
-    rv = deflateSetDictionary(
-        &z, reinterpret_cast<const uint8_t*>(&zlib_dict[0]), zlib_dict.size());
+    int rv = deflateSetDictionary(
+        z, reinterpret_cast<const uint8_t*>(&zlib_dict[0]), zlib_dict.size());
     DCHECK_EQ(Z_OK, rv);
     if (rv != Z_OK) {
       return "";
     }
 
-    compressed_size = deflateBound(&z, uncompressed_size);
+    compressed_size = deflateBound(z, uncompressed_size);
   }
 
   const size_t entries_size = CertEntriesSize(entries);
@@ -513,8 +582,8 @@ string CertCompressor::CompressChain(const std::vector<string>& certs,
 
   int rv;
 
-  z.next_out = j;
-  z.avail_out = compressed_size;
+  z->next_out = j;
+  z->avail_out = compressed_size;
 
   for (size_t i = 0; i < certs.size(); i++) {
     if (entries[i].type != CertEntry::COMPRESSED) {
@@ -522,34 +591,34 @@ string CertCompressor::CompressChain(const std::vector<string>& certs,
     }
 
     uint32_t length32 = certs[i].size();
-    z.next_in = reinterpret_cast<uint8_t*>(&length32);
-    z.avail_in = sizeof(length32);
-    rv = deflate(&z, Z_NO_FLUSH);
+    z->next_in = reinterpret_cast<uint8_t*>(&length32);
+    z->avail_in = sizeof(length32);
+    rv = deflate(z, Z_NO_FLUSH);
     DCHECK_EQ(Z_OK, rv);
-    DCHECK_EQ(0u, z.avail_in);
-    if (rv != Z_OK || z.avail_in) {
+    DCHECK_EQ(0u, z->avail_in);
+    if (rv != Z_OK || z->avail_in) {
       return "";
     }
 
-    z.next_in =
+    z->next_in =
         const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(certs[i].data()));
-    z.avail_in = certs[i].size();
-    rv = deflate(&z, Z_NO_FLUSH);
+    z->avail_in = certs[i].size();
+    rv = deflate(z, Z_NO_FLUSH);
     DCHECK_EQ(Z_OK, rv);
-    DCHECK_EQ(0u, z.avail_in);
-    if (rv != Z_OK || z.avail_in) {
+    DCHECK_EQ(0u, z->avail_in);
+    if (rv != Z_OK || z->avail_in) {
       return "";
     }
   }
 
-  z.avail_in = 0;
-  rv = deflate(&z, Z_FINISH);
+  z->avail_in = 0;
+  rv = deflate(z, Z_FINISH);
   DCHECK_EQ(Z_STREAM_END, rv);
   if (rv != Z_STREAM_END) {
     return "";
   }
 
-  result.resize(result.size() - z.avail_out);
+  result.resize(result.size() - z->avail_out);
   return result;
 }
 
@@ -581,32 +650,29 @@ bool CertCompressor::DecompressChain(QuicStringPiece in,
     }
 
     uncompressed_data.reset(new uint8_t[uncompressed_size]);
-    z_stream z;
-    ScopedZLib scoped_z(ScopedZLib::INFLATE);
-
-    memset(&z, 0, sizeof(z));
-    z.next_out = uncompressed_data.get();
-    z.avail_out = uncompressed_size;
-    z.next_in =
-        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(in.data()));
-    z.avail_in = in.size();
-
-    if (Z_OK != inflateInit(&z)) {
+    ScopedZLib scoped_z(ZLibStreamPool::INFLATE);
+    z_stream* z = scoped_z.Init();
+    if (!z) {
       return false;
     }
-    scoped_z.reset(&z);
 
-    int rv = inflate(&z, Z_FINISH);
+    z->next_out = uncompressed_data.get();
+    z->avail_out = uncompressed_size;
+    z->next_in =
+        const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(in.data()));
+    z->avail_in = in.size();
+
+    int rv = inflate(z, Z_FINISH);
     if (rv == Z_NEED_DICT) {
       string zlib_dict = ZlibDictForEntries(entries, *out_certs);
       const uint8_t* dict = reinterpret_cast<const uint8_t*>(zlib_dict.data());
-      if (Z_OK != inflateSetDictionary(&z, dict, zlib_dict.size())) {
+      if (Z_OK != inflateSetDictionary(z, dict, zlib_dict.size())) {
         return false;
       }
-      rv = inflate(&z, Z_FINISH);
+      rv = inflate(z, Z_FINISH);
     }
 
-    if (Z_STREAM_END != rv || z.avail_out > 0 || z.avail_in > 0) {
+    if (Z_STREAM_END != rv || z->avail_out > 0 || z->avail_in > 0) {
       return false;
     }
 
@@ -0,0 +1,82 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/crypto/cert_compressor.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/test/perf_time_logger.h"
+#include "net/quic/core/crypto/quic_random.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/quic/test_tools/crypto_test_utils.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kIterations = 20000;
+const uint64_t kSetHash = 42;
+
+class CertCompressorPerfTest : public QuicTest {
+ protected:
+  CertCompressorPerfTest() {
+    // A leaf and an intermediate which have to be compressed, and a root which
+    // the client has in a common set.
+    for (size_t size : {1500, 1100, 900}) {
+      std::string cert(size, 0);
+      // Half random bytes, like keys and signatures, and half repeated
+      // structure, like names and extensions.
+      QuicRandom::GetInstance()->RandBytes(&cert[0], size / 2);
+      for (size_t i = size / 2; i < size; ++i) {
+        cert[i] = "CN=www.example.com, O=Example"[i % 29];
+      }
+      chain_.push_back(cert);
+    }
+    common_sets_.reset(
+        crypto_test_utils::MockCommonCertSets(chain_.back(), kSetHash, 1));
+    common_set_hashes_ = std::string(reinterpret_cast<const char*>(&kSetHash),
+                                     sizeof(kSetHash));
+  }
+
+  std::vector<std::string> chain_;
+  std::unique_ptr<CommonCertSets> common_sets_;
+  std::string common_set_hashes_;
+};
+
+TEST_F(CertCompressorPerfTest, CompressChain) {
+  base::PerfTimeLogger timer("CertCompressor_compress_chain");
+  for (int i = 0; i < kIterations; ++i) {
+    if (CertCompressor::CompressChain(chain_, common_set_hashes_, "",
+                                      common_sets_.get())
+            .empty()) {
+      ADD_FAILURE() << "Failed to compress chain";
+      return;
+    }
+  }
+  timer.Done();
+}
+
+TEST_F(CertCompressorPerfTest, DecompressChain) {
+  const std::string compressed = CertCompressor::CompressChain(
+      chain_, common_set_hashes_, "", common_sets_.get());
+  std::vector<std::string> cached_certs;
+  std::vector<std::string> chain;
+
+  base::PerfTimeLogger timer("CertCompressor_decompress_chain");
+  for (int i = 0; i < kIterations; ++i) {
+    if (!CertCompressor::DecompressChain(compressed, cached_certs,
+                                         common_sets_.get(), &chain)) {
+      ADD_FAILURE() << "Failed to decompress chain";
+      return;
+    }
+  }
+  timer.Done();
+  EXPECT_EQ(chain_, chain);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
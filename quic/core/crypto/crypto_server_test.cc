@@ -8,11 +8,13 @@
 #include <ostream>
 #include <vector>
 
+#include "base/threading/simple_thread.h"
 #include "net/quic/core/crypto/cert_compressor.h"
 #include "net/quic/core/crypto/common_cert_set.h"
 #include "net/quic/core/crypto/crypto_handshake.h"
 #include "net/quic/core/crypto/crypto_server_config_protobuf.h"
 #include "net/quic/core/crypto/crypto_utils.h"
+#include "net/quic/core/crypto/crypto_worker_pool.h"
 #include "net/quic/core/crypto/proof_source.h"
 #include "net/quic/core/crypto/quic_crypto_server_config.h"
 #include "net/quic/core/crypto/quic_random.h"
@@ -20,6 +22,8 @@
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/platform/api/quic_endian.h"
 #include "net/quic/platform/api/quic_flags.h"
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_string_piece.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/platform/api/quic_text_utils.h"
@@ -52,6 +56,47 @@ class DummyProofVerifierCallback : public ProofVerifierCallback {
 
 const char kOldConfigId[] = "old-config-id";
 
+// A CryptoWorkerPool which queues tasks until the test runs them.
+class QueuedCryptoWorkerPool : public CryptoWorkerPool {
+ public:
+  QueuedCryptoWorkerPool() {}
+  ~QueuedCryptoWorkerPool() override {}
+
+  void PostTask(std::unique_ptr<Task> task) override {
+    tasks_.push_back(std::move(task));
+  }
+
+  // Runs and replies to the tasks posted so far.
+  void RunTasks() {
+    std::vector<std::unique_ptr<Task>> tasks;
+    tasks.swap(tasks_);
+    for (const auto& task : tasks) {
+      task->Run();
+      task->Reply();
+    }
+  }
+
+  size_t num_tasks() const { return tasks_.size(); }
+
+ private:
+  std::vector<std::unique_ptr<Task>> tasks_;
+};
+
+// Keeps the result of ValidateClientHello.
+class StoreValidateCallback : public ValidateClientHelloResultCallback {
+ public:
+  explicit StoreValidateCallback(QuicReferenceCountedPointer<Result>* result)
+      : result_(result) {}
+
+  void Run(QuicReferenceCountedPointer<Result> result,
+           std::unique_ptr<ProofSource::Details> /* details */) override {
+    *result_ = std::move(result);
+  }
+
+ private:
+  QuicReferenceCountedPointer<Result>* result_;
+};
+
 }  // namespace
 
 struct TestParams {
@@ -111,7 +156,7 @@ class CryptoServerTest : public QuicTestWithParam<TestParams> {
                 crypto_test_utils::ProofSourceForTesting()),
         peer_(&config_),
         compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
         params_(new QuicCryptoNegotiatedParameters),
         signed_config_(new QuicSignedServerConfig),
         chlo_packet_size_(kDefaultMaxPacketSize) {
@@ -900,6 +945,97 @@ TEST_P(CryptoServerTest, ValidXlct) {
   EXPECT_EQ(kSHLO, out_.tag());
 }
 
+TEST_P(CryptoServerTest, BatchedProofs) {
+  CryptoHandshakeMessage msg =
+      crypto_test_utils::CreateCHLO({{"PDMD", "X509"},
+                                     {"AEAD", "AESG"},
+                                     {"KEXS", "C255"},
+                                     {"SCID", scid_hex_},
+                                     {"#004b5453", srct_hex_},
+                                     {"PUBS", pub_hex_},
+                                     {"NONC", nonce_hex_},
+                                     {"VER\0", client_version_string_},
+                                     {"XLCT", XlctHexString()}},
+                                    kClientHelloMinimumSize);
+  config_.set_replay_protection(false);
+  config_.set_proof_batch_size(2);
+  QuicSocketAddress server_address;
+
+  // The proof of the first CHLO waits for a second one.
+  bool first_called = false;
+  config_.ValidateClientHello(
+      msg, client_address_.host(), server_address, supported_versions_.front(),
+      &clock_, signed_config_,
+      QuicMakeUnique<ValidateCallback>(this, true, "", &first_called));
+  EXPECT_FALSE(first_called);
+  EXPECT_EQ(1u, config_.NumPendingProofs());
+
+  bool second_called = false;
+  config_.ValidateClientHello(
+      msg, client_address_.host(), server_address, supported_versions_.front(),
+      &clock_, signed_config_,
+      QuicMakeUnique<ValidateCallback>(this, true, "", &second_called));
+  EXPECT_TRUE(first_called);
+  EXPECT_TRUE(second_called);
+  EXPECT_EQ(0u, config_.NumPendingProofs());
+  EXPECT_EQ(kSHLO, out_.tag());
+
+  // A partial batch goes out when flushed.
+  bool third_called = false;
+  config_.ValidateClientHello(
+      msg, client_address_.host(), server_address, supported_versions_.front(),
+      &clock_, signed_config_,
+      QuicMakeUnique<ValidateCallback>(this, true, "", &third_called));
+  EXPECT_FALSE(third_called);
+  config_.FlushPendingProofs();
+  EXPECT_TRUE(third_called);
+  EXPECT_EQ(0u, config_.NumPendingProofs());
+}
+
+TEST_P(CryptoServerTest, CryptoWorkerPool) {
+  CryptoHandshakeMessage msg =
+      crypto_test_utils::CreateCHLO({{"PDMD", "X509"},
+                                     {"AEAD", "AESG"},
+                                     {"KEXS", "C255"},
+                                     {"SCID", scid_hex_},
+                                     {"#004b5453", srct_hex_},
+                                     {"PUBS", pub_hex_},
+                                     {"NONC", nonce_hex_},
+                                     {"VER\0", client_version_string_},
+                                     {"XLCT", XlctHexString()}},
+                                    kClientHelloMinimumSize);
+  config_.set_replay_protection(false);
+  QueuedCryptoWorkerPool pool;
+  config_.set_crypto_worker_pool(&pool);
+  QuicSocketAddress server_address;
+
+  // The proof is computed by the pool.
+  QuicReferenceCountedPointer<ValidateCallback::Result> result;
+  config_.ValidateClientHello(
+      msg, client_address_.host(), server_address, supported_versions_.front(),
+      &clock_, signed_config_, QuicMakeUnique<StoreValidateCallback>(&result));
+  EXPECT_EQ(nullptr, result.get());
+  EXPECT_EQ(1u, pool.num_tasks());
+  pool.RunTasks();
+  ASSERT_NE(nullptr, result.get());
+
+  // So is the key agreement.
+  bool called = false;
+  config_.ProcessClientHello(
+      result, /*reject_only=*/false, /*connection_id=*/1, server_address,
+      client_address_, supported_versions_.front(), supported_versions_,
+      use_stateless_rejects_, rand_for_id_generation_.RandUint64(), &clock_,
+      rand_, &compressed_certs_cache_, params_, signed_config_,
+      /*total_framing_overhead=*/50, chlo_packet_size_,
+      QuicMakeUnique<ProcessCallback>(result, true, "", &called, &out_));
+  EXPECT_FALSE(called);
+  EXPECT_EQ(1u, pool.num_tasks());
+  pool.RunTasks();
+  EXPECT_TRUE(called);
+  EXPECT_EQ(kSHLO, out_.tag());
+  config_.set_crypto_worker_pool(nullptr);
+}
+
 TEST_P(CryptoServerTest, NonceInSHLO) {
   CryptoHandshakeMessage msg =
       crypto_test_utils::CreateCHLO({{"PDMD", "X509"},
@@ -1019,6 +1155,95 @@ TEST_F(CryptoServerConfigGenerationTest, SCIDIsHashOfServerConfig) {
   EXPECT_EQ(0, memcmp(digest, scid_str.c_str(), scid.size()));
 }
 
+// Runs ValidateClientHello() from several threads sharing one
+// QuicCryptoServerConfig, whose handshake path reads the configs from a
+// snapshot without taking a lock.
+class CryptoServerContentionTest : public QuicTest {
+ protected:
+  class CountingValidateCallback : public ValidateClientHelloResultCallback {
+   public:
+    explicit CountingValidateCallback(int* count) : count_(count) {}
+
+    void Run(QuicReferenceCountedPointer<Result> result,
+             std::unique_ptr<ProofSource::Details> /* details */) override {
+      ++*count_;
+    }
+
+   private:
+    int* count_;
+  };
+
+  class HandshakeDelegate : public base::DelegateSimpleThread::Delegate {
+   public:
+    HandshakeDelegate(const QuicCryptoServerConfig* config,
+                      const CryptoHandshakeMessage* client_hello,
+                      const QuicClock* clock,
+                      int iterations)
+        : config_(config),
+          client_hello_(client_hello),
+          clock_(clock),
+          iterations_(iterations),
+          validated_(0) {}
+
+    void Run() override {
+      const QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1234);
+      const QuicSocketAddress server_address(QuicIpAddress::Loopback4(), 443);
+      for (int i = 0; i < iterations_; ++i) {
+        config_->ValidateClientHello(
+            *client_hello_, client_address.host(), server_address,
+            QuicVersionMax(), clock_,
+            QuicReferenceCountedPointer<QuicSignedServerConfig>(
+                new QuicSignedServerConfig),
+            QuicMakeUnique<CountingValidateCallback>(&validated_));
+      }
+    }
+
+    int validated() const { return validated_; }
+
+   private:
+    const QuicCryptoServerConfig* config_;
+    const CryptoHandshakeMessage* client_hello_;
+    const QuicClock* clock_;
+    const int iterations_;
+    int validated_;
+  };
+};
+
+TEST_F(CryptoServerContentionTest, ConcurrentValidateClientHello) {
+  const int kNumThreads = 4;
+  const int kIterationsPerThread = 50;
+  MockClock clock;
+  clock.AdvanceTime(QuicTime::Delta::FromSeconds(1000));
+  QuicCryptoServerConfig config(QuicCryptoServerConfig::TESTING,
+                                QuicRandom::GetInstance(),
+                                crypto_test_utils::ProofSourceForTesting());
+  delete config.AddDefaultConfig(QuicRandom::GetInstance(), &clock,
+                                 QuicCryptoServerConfig::ConfigOptions());
+  const CryptoHandshakeMessage client_hello = crypto_test_utils::CreateCHLO(
+      {{"PDMD", "X509"}, {"AEAD", "AESG"}, {"KEXS", "C255"}},
+      kClientHelloMinimumSize);
+
+  std::vector<std::unique_ptr<HandshakeDelegate>> delegates;
+  std::vector<std::unique_ptr<base::DelegateSimpleThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    delegates.push_back(QuicMakeUnique<HandshakeDelegate>(
+        &config, &client_hello, &clock, kIterationsPerThread));
+    threads.push_back(QuicMakeUnique<base::DelegateSimpleThread>(
+        delegates.back().get(), "CryptoServerContentionTest"));
+  }
+  for (const auto& thread : threads) {
+    thread->Start();
+  }
+  for (const auto& thread : threads) {
+    thread->Join();
+  }
+
+  // Every validation completed, synchronously, on its own thread.
+  for (const auto& delegate : delegates) {
+    EXPECT_EQ(kIterationsPerThread, delegate->validated());
+  }
+}
+
 class CryptoServerTestNoConfig : public CryptoServerTest {
  public:
   void SetUp() override {
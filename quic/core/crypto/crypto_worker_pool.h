@@ -0,0 +1,46 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
+#define NET_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
+
+#include <memory>
+
+#include "net/quic/platform/api/quic_export.h"
+
+namespace net {
+
+// CryptoWorkerPool is an interface by which a QUIC server can run the CPU
+// heavy parts of handshakes, such as signing proofs and key agreement, on
+// other threads than the one processing packets.
+class QUIC_EXPORT_PRIVATE CryptoWorkerPool {
+ public:
+  // A unit of work handed to the pool.
+  class Task {
+   public:
+    Task() {}
+    virtual ~Task() {}
+
+    // Invoked on a worker thread.
+    virtual void Run() = 0;
+
+    // Invoked on the thread which posted the task, after Run() has returned.
+    virtual void Reply() = 0;
+
+   private:
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+  };
+
+  virtual ~CryptoWorkerPool() {}
+
+  // Runs |task| on a worker thread, then runs its Reply() on the thread
+  // calling PostTask.  Tasks which have not replied when the pool is
+  // destroyed are deleted without replying.
+  virtual void PostTask(std::unique_ptr<Task> task) = 0;
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_CRYPTO_CRYPTO_WORKER_POOL_H_
@@ -4,12 +4,57 @@
 
 #include "net/quic/core/crypto/proof_source.h"
 
+#include <functional>
+
 using std::string;
 
 namespace net {
 
-ProofSource::Chain::Chain(const std::vector<string>& certs) : certs(certs) {}
+namespace {
+
+uint64_t HashCerts(const std::vector<string>& certs) {
+  uint64_t hash = certs.size();
+  for (const string& cert : certs) {
+    // Based on Boost's hash_combine function.
+    hash ^= std::hash<string>()(cert) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+}  // namespace
+
+ProofSource::Chain::Chain(const std::vector<string>& certs)
+    : certs(certs), hash(HashCerts(certs)) {}
 
 ProofSource::Chain::~Chain() {}
 
+ProofSource::ProofRequest::ProofRequest(
+    const QuicSocketAddress& server_address,
+    const string& hostname,
+    const string& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    std::unique_ptr<Callback> callback)
+    : server_address(server_address),
+      hostname(hostname),
+      server_config(server_config),
+      transport_version(transport_version),
+      chlo_hash(chlo_hash.as_string()),
+      callback(std::move(callback)) {}
+
+ProofSource::ProofRequest::ProofRequest(ProofRequest&& other) = default;
+
+ProofSource::ProofRequest& ProofSource::ProofRequest::operator=(
+    ProofRequest&& other) = default;
+
+ProofSource::ProofRequest::~ProofRequest() {}
+
+void ProofSource::GetProofs(std::vector<ProofRequest> requests) {
+  for (ProofRequest& request : requests) {
+    GetProof(request.server_address, request.hostname, request.server_config,
+             request.transport_version, request.chlo_hash,
+             std::move(request.callback));
+  }
+}
+
 }  // namespace net
@@ -28,6 +28,9 @@ class QUIC_EXPORT_PRIVATE ProofSource {
     explicit Chain(const std::vector<std::string>& certs);
 
     const std::vector<std::string> certs;
+    // Hash of |certs|, computed once so that caches keyed on the chain do not
+    // have to hash the certificates on every lookup.
+    const uint64_t hash;
 
    protected:
     ~Chain() override;
@@ -93,6 +96,26 @@ class QUIC_EXPORT_PRIVATE ProofSource {
     SignatureCallback& operator=(const SignatureCallback&) = delete;
   };
 
+  // The arguments of a GetProof() call, as handed to GetProofs().
+  struct QUIC_EXPORT_PRIVATE ProofRequest {
+    ProofRequest(const QuicSocketAddress& server_address,
+                 const std::string& hostname,
+                 const std::string& server_config,
+                 QuicTransportVersion transport_version,
+                 QuicStringPiece chlo_hash,
+                 std::unique_ptr<Callback> callback);
+    ProofRequest(ProofRequest&& other);
+    ProofRequest& operator=(ProofRequest&& other);
+    ~ProofRequest();
+
+    QuicSocketAddress server_address;
+    std::string hostname;
+    std::string server_config;
+    QuicTransportVersion transport_version;
+    std::string chlo_hash;
+    std::unique_ptr<Callback> callback;
+  };
+
   virtual ~ProofSource() {}
 
   // GetProof finds a certificate chain for |hostname| (in leaf-first order),
@@ -120,6 +143,14 @@ class QUIC_EXPORT_PRIVATE ProofSource {
                         QuicStringPiece chlo_hash,
                         std::unique_ptr<Callback> callback) = 0;
 
+  // Computes the proofs of a batch of |requests|, and runs the callback of
+  // each one as GetProof() would. Implementations backed by signing hardware
+  // can override this to sign a whole batch in one go. The default
+  // implementation calls GetProof() for each request in turn.
+  //
+  // Callers should expect that the callbacks might be invoked synchronously.
+  virtual void GetProofs(std::vector<ProofRequest> requests);
+
   // Returns the certificate chain for |hostname| in leaf-first order.
   virtual QuicReferenceCountedPointer<Chain> GetCertChain(
       const QuicSocketAddress& server_address,
@@ -4,6 +4,15 @@
 
 #include "net/quic/core/crypto/quic_compressed_certs_cache.h"
 
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_mutex.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+
 using std::string;
 
 namespace net {
@@ -54,36 +63,121 @@ bool QuicCompressedCertsCache::CachedCerts::MatchesUncompressedCerts(
               *uncompressed_certs.client_common_set_hashes &&
           client_cached_cert_hashes_ ==
               *uncompressed_certs.client_cached_cert_hashes &&
-          chain_ == uncompressed_certs.chain);
+          (chain_ == uncompressed_certs.chain ||
+           (chain_->hash == uncompressed_certs.chain->hash &&
+            chain_->certs == uncompressed_certs.chain->certs)));
 }
 
 const string* QuicCompressedCertsCache::CachedCerts::compressed_cert() const {
   return &compressed_cert_;
 }
 
-QuicCompressedCertsCache::QuicCompressedCertsCache(int64_t max_num_certs)
-    : certs_cache_(max_num_certs) {}
+size_t QuicCompressedCertsCache::CachedCerts::bytes() const {
+  // The chain is shared with its ProofSource, so it is not accounted for.
+  return sizeof(*this) + client_common_set_hashes_.size() +
+         client_cached_cert_hashes_.size() + compressed_cert_.size();
+}
+
+// A shard of the cache: a map from key to entry, and the entries in most
+// recently used order.
+class QuicCompressedCertsCache::Shard {
+ public:
+  explicit Shard(size_t max_bytes) : max_bytes_(max_bytes), bytes_(0) {}
+
+  bool Lookup(uint64_t key,
+              const UncompressedCerts& uncompressed_certs,
+              string* compressed_cert) {
+    QuicWriterMutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end() ||
+        !it->second->second->MatchesUncompressedCerts(uncompressed_certs)) {
+      return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    *compressed_cert = *it->second->second->compressed_cert();
+    return true;
+  }
+
+  void Insert(uint64_t key, std::unique_ptr<CachedCerts> cached_certs) {
+    const size_t bytes = cached_certs->bytes();
+    if (bytes > max_bytes_) {
+      QUIC_DVLOG(1) << "Not caching compressed certs of " << bytes
+                    << " bytes, which is more than the shard capacity of "
+                    << max_bytes_;
+      return;
+    }
+    QuicWriterMutexLock lock(&mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      Erase(it);
+    }
+    entries_.emplace_front(key, std::move(cached_certs));
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+    while (bytes_ > max_bytes_) {
+      Erase(index_.find(entries_.back().first));
+    }
+  }
+
+  size_t bytes() const {
+    QuicReaderMutexLock lock(&mutex_);
+    return bytes_;
+  }
+
+  size_t size() const {
+    QuicReaderMutexLock lock(&mutex_);
+    return index_.size();
+  }
+
+ private:
+  using Entry = std::pair<uint64_t, std::unique_ptr<CachedCerts>>;
+  using Index = std::unordered_map<uint64_t, std::list<Entry>::iterator>;
+
+  void Erase(Index::iterator it) EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    bytes_ -= it->second->second->bytes();
+    entries_.erase(it->second);
+    index_.erase(it);
+  }
+
+  mutable QuicMutex mutex_;
+  const size_t max_bytes_;
+  std::list<Entry> entries_ GUARDED_BY(mutex_);
+  Index index_ GUARDED_BY(mutex_);
+  size_t bytes_ GUARDED_BY(mutex_);
+
+  DISALLOW_COPY_AND_ASSIGN(Shard);
+};
+
+QuicCompressedCertsCache::QuicCompressedCertsCache(size_t max_bytes)
+    : QuicCompressedCertsCache(max_bytes, kNumShards) {}
 
-QuicCompressedCertsCache::~QuicCompressedCertsCache() {
-  // Underlying cache must be cleared before destruction.
-  certs_cache_.Clear();
+QuicCompressedCertsCache::QuicCompressedCertsCache(size_t max_bytes,
+                                                   size_t num_shards)
+    : max_bytes_(max_bytes), hits_(0), misses_(0) {
+  DCHECK_LT(0u, num_shards);
+  for (size_t i = 0; i < num_shards; ++i) {
+    shards_.push_back(QuicMakeUnique<Shard>(max_bytes / num_shards));
+  }
 }
 
-const string* QuicCompressedCertsCache::GetCompressedCert(
+QuicCompressedCertsCache::~QuicCompressedCertsCache() {}
+
+bool QuicCompressedCertsCache::GetCompressedCert(
     const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
     const string& client_common_set_hashes,
-    const string& client_cached_cert_hashes) {
+    const string& client_cached_cert_hashes,
+    string* compressed_cert) {
   UncompressedCerts uncompressed_certs(chain, &client_common_set_hashes,
                                        &client_cached_cert_hashes);
 
   uint64_t key = ComputeUncompressedCertsHash(uncompressed_certs);
 
-  CachedCerts* cached_value = certs_cache_.Lookup(key);
-  if (cached_value != nullptr &&
-      cached_value->MatchesUncompressedCerts(uncompressed_certs)) {
-    return cached_value->compressed_cert();
+  if (GetShard(key)->Lookup(key, uncompressed_certs, compressed_cert)) {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
   }
-  return nullptr;
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
 }
 
 void QuicCompressedCertsCache::Insert(
@@ -96,20 +190,37 @@ void QuicCompressedCertsCache::Insert(
 
   uint64_t key = ComputeUncompressedCertsHash(uncompressed_certs);
 
-  // Insert one unit to the cache.
   std::unique_ptr<CachedCerts> cached_certs(
       new CachedCerts(uncompressed_certs, compressed_cert));
-  certs_cache_.Insert(key, std::move(cached_certs));
+  GetShard(key)->Insert(key, std::move(cached_certs));
 }
 
-size_t QuicCompressedCertsCache::MaxSize() {
-  return certs_cache_.MaxSize();
+size_t QuicCompressedCertsCache::MaxBytes() const {
+  return max_bytes_;
+}
+
+size_t QuicCompressedCertsCache::Bytes() const {
+  size_t bytes = 0;
+  for (const auto& shard : shards_) {
+    bytes += shard->bytes();
+  }
+  return bytes;
+}
+
+size_t QuicCompressedCertsCache::Size() const {
+  size_t size = 0;
+  for (const auto& shard : shards_) {
+    size += shard->size();
+  }
+  return size;
 }
 
-size_t QuicCompressedCertsCache::Size() {
-  return certs_cache_.Size();
+QuicCompressedCertsCache::Shard* QuicCompressedCertsCache::GetShard(
+    uint64_t key) const {
+  return shards_[key % shards_.size()].get();
 }
 
+// static
 uint64_t QuicCompressedCertsCache::ComputeUncompressedCertsHash(
     const UncompressedCerts& uncompressed_certs) {
   uint64_t hash =
@@ -118,8 +229,7 @@ uint64_t QuicCompressedCertsCache::ComputeUncompressedCertsHash(
       std::hash<string>()(*uncompressed_certs.client_cached_cert_hashes);
   hash_combine(&hash, h);
 
-  hash_combine(&hash,
-               reinterpret_cast<uint64_t>(uncompressed_certs.chain.get()));
+  hash_combine(&hash, uncompressed_certs.chain->hash);
   return hash;
 }
 
@@ -5,48 +5,71 @@
 #ifndef NET_QUIC_CORE_CRYPTO_QUIC_COMPRESSED_CERTS_CACHE_H_
 #define NET_QUIC_CORE_CRYPTO_QUIC_COMPRESSED_CERTS_CACHE_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "base/macros.h"
 #include "net/quic/core/crypto/proof_source.h"
 #include "net/quic/platform/api/quic_export.h"
-#include "net/quic/platform/api/quic_lru_cache.h"
 
 namespace net {
 
 // QuicCompressedCertsCache is a cache to track most recently compressed certs.
+// Entries are spread over a fixed number of shards by the hash of their key,
+// each with its own lock and LRU list, so that it may be shared by several
+// server threads without them contending on a single lock. The capacity is a
+// number of bytes, split evenly between the shards.
+//
+// This class is thread-safe.
 class QUIC_EXPORT_PRIVATE QuicCompressedCertsCache {
  public:
-  explicit QuicCompressedCertsCache(int64_t max_num_certs);
+  explicit QuicCompressedCertsCache(size_t max_bytes);
+  QuicCompressedCertsCache(size_t max_bytes, size_t num_shards);
   ~QuicCompressedCertsCache();
 
-  // Returns the pointer to the cached compressed cert if
+  // Copies the cached compressed cert to |compressed_cert| and returns true if
   // |chain, client_common_set_hashes, client_cached_cert_hashes| hits cache.
-  // Otherwise, return nullptr.
-  // Returned pointer might become invalid on the next call to Insert().
-  const std::string* GetCompressedCert(
+  // Otherwise, returns false. Chains holding the same certs are equivalent.
+  bool GetCompressedCert(
       const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
       const std::string& client_common_set_hashes,
-      const std::string& client_cached_cert_hashes);
+      const std::string& client_cached_cert_hashes,
+      std::string* compressed_cert);
 
   // Inserts the specified
   // |chain, client_common_set_hashes,
   //  client_cached_cert_hashes, compressed_cert| tuple to the cache.
-  // If the insertion causes the cache to become overfull, entries will
-  // be deleted in an LRU order to make room.
+  // If the insertion causes the shard of the entry to go over its share of the
+  // capacity, entries will be deleted from it in an LRU order to make room.
   void Insert(const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
               const std::string& client_common_set_hashes,
               const std::string& client_cached_cert_hashes,
               const std::string& compressed_cert);
 
-  // Returns max number of cache entries the cache can carry.
-  size_t MaxSize();
+  // Returns the max number of bytes the cache can hold.
+  size_t MaxBytes() const;
+
+  // Returns the number of bytes held by the cache entries.
+  size_t Bytes() const;
 
   // Returns current number of cache entries in the cache.
-  size_t Size();
+  size_t Size() const;
+
+  // Number of calls to GetCompressedCert() which did and did not hit cache.
+  uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
 
-  // Default size of the QuicCompressedCertsCache per server side investigation.
-  static const size_t kQuicCompressedCertsCacheSize = 225;
+  // Default capacity of the QuicCompressedCertsCache, which holds a couple of
+  // hundred typical compressed chains.
+  static const size_t kQuicCompressedCertsCacheMaxBytes = 1024 * 1024;
+
+  // Default number of shards.
+  static const size_t kNumShards = 16;
 
  private:
   // A wrapper of the tuple:
@@ -83,6 +106,9 @@ class QUIC_EXPORT_PRIVATE QuicCompressedCertsCache {
 
     const std::string* compressed_cert() const;
 
+    // Returns the number of bytes this entry accounts for in the cache.
+    size_t bytes() const;
+
    private:
     // Uncompressed certs data.
     QuicReferenceCountedPointer<ProofSource::Chain> chain_;
@@ -93,14 +119,25 @@ class QUIC_EXPORT_PRIVATE QuicCompressedCertsCache {
     const std::string compressed_cert_;
   };
 
+  class Shard;
+
   // Computes a uint64_t hash for |uncompressed_certs|.
-  uint64_t ComputeUncompressedCertsHash(
+  static uint64_t ComputeUncompressedCertsHash(
       const UncompressedCerts& uncompressed_certs);
 
+  Shard* GetShard(uint64_t key) const;
+
+  const size_t max_bytes_;
+  // Shards are picked by the key modulo the number of shards.
   // Key is a unit64_t hash for UncompressedCerts. Stored associated value is
   // CachedCerts which has both original uncompressed certs data and the
   // compressed representation of the certs.
-  QuicLRUCache<uint64_t, CachedCerts> certs_cache_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicCompressedCertsCache);
 };
 
 }  // namespace net
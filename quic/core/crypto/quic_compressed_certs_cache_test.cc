@@ -22,7 +22,8 @@ namespace {
 class QuicCompressedCertsCacheTest : public testing::Test {
  public:
   QuicCompressedCertsCacheTest()
-      : certs_cache_(QuicCompressedCertsCache::kQuicCompressedCertsCacheSize) {}
+      : certs_cache_(
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes) {}
 
  protected:
   QuicCompressedCertsCache certs_cache_;
@@ -38,10 +39,21 @@ TEST_F(QuicCompressedCertsCacheTest, CacheHit) {
 
   certs_cache_.Insert(chain, common_certs, cached_certs, compressed);
 
-  const string* cached_value =
-      certs_cache_.GetCompressedCert(chain, common_certs, cached_certs);
-  ASSERT_NE(nullptr, cached_value);
-  EXPECT_EQ(*cached_value, compressed);
+  string cached_value;
+  ASSERT_TRUE(certs_cache_.GetCompressedCert(chain, common_certs, cached_certs,
+                                             &cached_value));
+  EXPECT_EQ(cached_value, compressed);
+  EXPECT_EQ(1u, certs_cache_.hits());
+  EXPECT_EQ(0u, certs_cache_.misses());
+
+  // A different chain with equivalent certs compresses the same way.
+  QuicReferenceCountedPointer<ProofSource::Chain> chain2(
+      new ProofSource::Chain(certs));
+  EXPECT_EQ(chain->hash, chain2->hash);
+  ASSERT_TRUE(certs_cache_.GetCompressedCert(chain2, common_certs,
+                                             cached_certs, &cached_value));
+  EXPECT_EQ(cached_value, compressed);
+  EXPECT_EQ(2u, certs_cache_.hits());
 }
 
 TEST_F(QuicCompressedCertsCacheTest, CacheMiss) {
@@ -55,18 +67,19 @@ TEST_F(QuicCompressedCertsCacheTest, CacheMiss) {
 
   certs_cache_.Insert(chain, common_certs, cached_certs, compressed);
 
-  EXPECT_EQ(nullptr,
-            certs_cache_.GetCompressedCert(chain, "mismatched common certs",
-                                           cached_certs));
-  EXPECT_EQ(nullptr,
-            certs_cache_.GetCompressedCert(chain, common_certs,
-                                           "mismatched cached certs"));
+  string cached_value;
+  EXPECT_FALSE(certs_cache_.GetCompressedCert(
+      chain, "mismatched common certs", cached_certs, &cached_value));
+  EXPECT_FALSE(certs_cache_.GetCompressedCert(
+      chain, common_certs, "mismatched cached certs", &cached_value));
 
-  // A different chain though with equivalent certs should get a cache miss.
+  // A different chain with different certs should get a cache miss.
   QuicReferenceCountedPointer<ProofSource::Chain> chain2(
-      new ProofSource::Chain(certs));
-  EXPECT_EQ(nullptr,
-            certs_cache_.GetCompressedCert(chain2, common_certs, cached_certs));
+      new ProofSource::Chain({"leaf cert", "other intermediate cert"}));
+  EXPECT_FALSE(certs_cache_.GetCompressedCert(chain2, common_certs,
+                                              cached_certs, &cached_value));
+  EXPECT_EQ(0u, certs_cache_.hits());
+  EXPECT_EQ(3u, certs_cache_.misses());
 }
 
 TEST_F(QuicCompressedCertsCacheTest, CacheMissDueToEviction) {
@@ -75,24 +88,72 @@ TEST_F(QuicCompressedCertsCacheTest, CacheMissDueToEviction) {
   std::vector<string> certs = {"leaf cert", "intermediate cert", "root cert"};
   QuicReferenceCountedPointer<ProofSource::Chain> chain(
       new ProofSource::Chain(certs));
+  QuicCompressedCertsCache certs_cache(16 * 1024, /*num_shards=*/1);
 
   string common_certs = "common certs";
   string cached_certs = "cached certs";
   string compressed = "compressed cert";
-  certs_cache_.Insert(chain, common_certs, cached_certs, compressed);
+  certs_cache.Insert(chain, common_certs, cached_certs, compressed);
+
+  // Insert another 16 KB of certs to evict the first cached cert.
+  const string large_compressed(1024, 'a');
+  for (unsigned int i = 0; i < 16; i++) {
+    certs_cache.Insert(chain, QuicTextUtils::Uint64ToString(i), "",
+                       large_compressed);
+    EXPECT_GE(certs_cache.MaxBytes(), certs_cache.Bytes());
+  }
+  EXPECT_GT(16u, certs_cache.Size());
 
-  // Insert another kQuicCompressedCertsCacheSize certs to evict the first
-  // cached cert.
-  for (unsigned int i = 0;
-       i < QuicCompressedCertsCache::kQuicCompressedCertsCacheSize; i++) {
-    EXPECT_EQ(certs_cache_.Size(), i + 1);
+  string cached_value;
+  EXPECT_FALSE(certs_cache.GetCompressedCert(chain, common_certs, cached_certs,
+                                             &cached_value));
+  // The most recently inserted cert is still there.
+  EXPECT_TRUE(certs_cache.GetCompressedCert(chain, "15", "", &cached_value));
+}
+
+TEST_F(QuicCompressedCertsCacheTest, LookupRefreshesEntry) {
+  std::vector<string> certs = {"leaf cert", "intermediate cert", "root cert"};
+  QuicReferenceCountedPointer<ProofSource::Chain> chain(
+      new ProofSource::Chain(certs));
+  QuicCompressedCertsCache certs_cache(4 * 1024, /*num_shards=*/1);
+  const string compressed(1000, 'a');
+
+  certs_cache.Insert(chain, "0", "", compressed);
+  certs_cache.Insert(chain, "1", "", compressed);
+  certs_cache.Insert(chain, "2", "", compressed);
+  string cached_value;
+  ASSERT_TRUE(certs_cache.GetCompressedCert(chain, "0", "", &cached_value));
+
+  // Making room for the new entry evicts the least recently used one.
+  certs_cache.Insert(chain, "3", "", compressed);
+  EXPECT_TRUE(certs_cache.GetCompressedCert(chain, "0", "", &cached_value));
+  EXPECT_FALSE(certs_cache.GetCompressedCert(chain, "1", "", &cached_value));
+  EXPECT_TRUE(certs_cache.GetCompressedCert(chain, "3", "", &cached_value));
+}
+
+TEST_F(QuicCompressedCertsCacheTest, EntryLargerThanShardIsNotCached) {
+  std::vector<string> certs = {"leaf cert", "intermediate cert", "root cert"};
+  QuicReferenceCountedPointer<ProofSource::Chain> chain(
+      new ProofSource::Chain(certs));
+  QuicCompressedCertsCache certs_cache(4 * 1024, /*num_shards=*/4);
+
+  certs_cache.Insert(chain, "common certs", "", string(2 * 1024, 'a'));
+  EXPECT_EQ(0u, certs_cache.Size());
+  EXPECT_EQ(0u, certs_cache.Bytes());
+}
+
+TEST_F(QuicCompressedCertsCacheTest, BytesStayWithinCapacity) {
+  std::vector<string> certs = {"leaf cert", "intermediate cert", "root cert"};
+  QuicReferenceCountedPointer<ProofSource::Chain> chain(
+      new ProofSource::Chain(certs));
+  const string compressed(2000, 'a');
+  for (unsigned int i = 0; i < 1000; i++) {
     certs_cache_.Insert(chain, QuicTextUtils::Uint64ToString(i), "",
-                        QuicTextUtils::Uint64ToString(i));
+                        compressed);
   }
-  EXPECT_EQ(certs_cache_.MaxSize(), certs_cache_.Size());
-
-  EXPECT_EQ(nullptr,
-            certs_cache_.GetCompressedCert(chain, common_certs, cached_certs));
+  EXPECT_GE(certs_cache_.MaxBytes(), certs_cache_.Bytes());
+  EXPECT_LT(certs_cache_.MaxBytes() / 2, certs_cache_.Bytes());
+  EXPECT_GT(1000u, certs_cache_.Size());
 }
 
 }  // namespace
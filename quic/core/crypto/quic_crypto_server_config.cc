@@ -38,6 +38,7 @@
 #include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_hostname_utils.h"
 #include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_reference_counted.h"
 #include "net/quic/platform/api/quic_text_utils.h"
 #include "third_party/boringssl/src/include/openssl/sha.h"
@@ -157,7 +158,10 @@ QuicCryptoServerConfig::QuicCryptoServerConfig(
       configs_lock_(),
       primary_config_(nullptr),
       next_config_promotion_time_(QuicWallTime::Zero()),
+      config_snapshot_(std::make_shared<ConfigSnapshot>()),
       proof_source_(std::move(proof_source)),
+      proof_batch_size_(0),
+      crypto_worker_pool_(nullptr),
       source_address_token_future_secs_(3600),
       source_address_token_lifetime_secs_(86400),
       enable_serving_sct_(false),
@@ -420,9 +424,9 @@ void QuicCryptoServerConfig::SetSourceAddressTokenKeys(
 }
 
 void QuicCryptoServerConfig::GetConfigIds(std::vector<string>* scids) const {
-  QuicReaderMutexLock locked(&configs_lock_);
-  for (ConfigMap::const_iterator it = configs_.begin(); it != configs_.end();
-       ++it) {
+  std::shared_ptr<const ConfigSnapshot> snapshot = LoadConfigSnapshot();
+  for (ConfigMap::const_iterator it = snapshot->configs.begin();
+       it != snapshot->configs.end(); ++it) {
     scids->push_back(it->first);
   }
 }
@@ -444,32 +448,15 @@ void QuicCryptoServerConfig::ValidateClientHello(
   QuicStringPiece requested_scid;
   client_hello.GetStringPiece(kSCID, &requested_scid);
 
-  QuicReferenceCountedPointer<Config> requested_config;
-  QuicReferenceCountedPointer<Config> primary_config;
-  {
-    QuicReaderMutexLock locked(&configs_lock_);
-
-    if (!primary_config_.get()) {
-      result->error_code = QUIC_CRYPTO_INTERNAL_ERROR;
-      result->error_details = "No configurations loaded";
-    } else {
-      if (!next_config_promotion_time_.IsZero() &&
-          next_config_promotion_time_.IsAfter(now)) {
-        configs_lock_.ReaderUnlock();
-        configs_lock_.WriterLock();
-        SelectNewPrimaryConfig(now);
-        DCHECK(primary_config_.get());
-        DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
-                  primary_config_.get());
-        configs_lock_.WriterUnlock();
-        configs_lock_.ReaderLock();
-      }
-    }
-
-    requested_config = GetConfigWithScid(requested_scid);
-    primary_config = primary_config_;
-    signed_config->config = primary_config_;
+  std::shared_ptr<const ConfigSnapshot> snapshot = GetConfigSnapshot(now);
+  if (!snapshot->primary_config.get()) {
+    result->error_code = QUIC_CRYPTO_INTERNAL_ERROR;
+    result->error_details = "No configurations loaded";
   }
+  QuicReferenceCountedPointer<Config> requested_config =
+      snapshot->GetConfigWithScid(requested_scid);
+  QuicReferenceCountedPointer<Config> primary_config = snapshot->primary_config;
+  signed_config->config = snapshot->primary_config;
 
   if (result->error_code == QUIC_NO_ERROR) {
     // QUIC requires a new proof for each CHLO so clear any existing proof.
@@ -573,7 +560,7 @@ class QuicCryptoServerConfig::ProcessClientHelloCallback
       signed_config_->proof = proof;
     }
     config_->ProcessClientHelloAfterGetProof(
-        !ok, std::move(details), *validate_chlo_result_, reject_only_,
+        !ok, std::move(details), validate_chlo_result_, reject_only_,
         connection_id_, client_address_, version_, supported_versions_,
         use_stateless_rejects_, server_designated_connection_id_, clock_, rand_,
         compressed_certs_cache_, params_, signed_config_,
@@ -606,6 +593,161 @@ class QuicCryptoServerConfig::ProcessClientHelloCallback
   std::unique_ptr<ProcessClientHelloResultCallback> done_cb_;
 };
 
+class QuicCryptoServerConfig::KeyAgreementTask
+    : public CryptoWorkerPool::Task {
+ public:
+  KeyAgreementTask(
+      const QuicCryptoServerConfig* config,
+      QuicReferenceCountedPointer<ValidateClientHelloResultCallback::Result>
+          validate_chlo_result,
+      QuicConnectionId connection_id,
+      const QuicSocketAddress& client_address,
+      const QuicTransportVersionVector& supported_versions,
+      const QuicClock* clock,
+      QuicRandom* rand,
+      QuicReferenceCountedPointer<QuicCryptoNegotiatedParameters> params,
+      QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config,
+      const QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>&
+          requested_config,
+      std::unique_ptr<CryptoHandshakeMessage> out,
+      std::unique_ptr<DiversificationNonce> out_diversification_nonce,
+      std::unique_ptr<ProofSource::Details> proof_source_details,
+      std::unique_ptr<ProcessClientHelloResultCallback> done_cb)
+      : config_(config),
+        validate_chlo_result_(std::move(validate_chlo_result)),
+        connection_id_(connection_id),
+        client_address_(client_address),
+        supported_versions_(supported_versions),
+        clock_(clock),
+        rand_(rand),
+        params_(std::move(params)),
+        signed_config_(std::move(signed_config)),
+        requested_config_(requested_config),
+        out_(std::move(out)),
+        out_diversification_nonce_(std::move(out_diversification_nonce)),
+        proof_source_details_(std::move(proof_source_details)),
+        done_cb_(std::move(done_cb)),
+        error_(QUIC_CRYPTO_INTERNAL_ERROR) {}
+
+  void Run() override {
+    config_->ProcessClientHelloKeyAgreement(
+        *validate_chlo_result_, connection_id_, client_address_,
+        supported_versions_, clock_, rand_, params_, signed_config_,
+        requested_config_, std::move(out_),
+        std::move(out_diversification_nonce_), std::move(proof_source_details_),
+        QuicMakeUnique<ResultCallback>(this));
+  }
+
+  void Reply() override {
+    done_cb_->Run(error_, error_details_, std::move(out_),
+                  std::move(out_diversification_nonce_),
+                  std::move(proof_source_details_));
+  }
+
+ private:
+  // Keeps the result in the task until it replies.
+  class ResultCallback : public ProcessClientHelloResultCallback {
+   public:
+    explicit ResultCallback(KeyAgreementTask* task) : task_(task) {}
+
+    void Run(QuicErrorCode error,
+             const string& error_details,
+             std::unique_ptr<CryptoHandshakeMessage> message,
+             std::unique_ptr<DiversificationNonce> diversification_nonce,
+             std::unique_ptr<ProofSource::Details> details) override {
+      task_->error_ = error;
+      task_->error_details_ = error_details;
+      task_->out_ = std::move(message);
+      task_->out_diversification_nonce_ = std::move(diversification_nonce);
+      task_->proof_source_details_ = std::move(details);
+    }
+
+   private:
+    KeyAgreementTask* task_;
+  };
+
+  const QuicCryptoServerConfig* config_;
+  const QuicReferenceCountedPointer<ValidateClientHelloResultCallback::Result>
+      validate_chlo_result_;
+  const QuicConnectionId connection_id_;
+  const QuicSocketAddress client_address_;
+  const QuicTransportVersionVector supported_versions_;
+  const QuicClock* const clock_;
+  QuicRandom* const rand_;
+  QuicReferenceCountedPointer<QuicCryptoNegotiatedParameters> params_;
+  QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config_;
+  const QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>
+      requested_config_;
+  std::unique_ptr<CryptoHandshakeMessage> out_;
+  std::unique_ptr<DiversificationNonce> out_diversification_nonce_;
+  std::unique_ptr<ProofSource::Details> proof_source_details_;
+  std::unique_ptr<ProcessClientHelloResultCallback> done_cb_;
+  QuicErrorCode error_;
+  string error_details_;
+};
+
+class QuicCryptoServerConfig::GetProofsTask : public CryptoWorkerPool::Task {
+ public:
+  GetProofsTask(ProofSource* proof_source,
+                std::vector<ProofSource::ProofRequest> requests)
+      : proof_source_(proof_source),
+        requests_(std::move(requests)),
+        results_(requests_.size()) {
+    for (size_t i = 0; i < requests_.size(); ++i) {
+      callbacks_.push_back(std::move(requests_[i].callback));
+      requests_[i].callback = QuicMakeUnique<ResultCallback>(&results_[i]);
+    }
+  }
+
+  void Run() override { proof_source_->GetProofs(std::move(requests_)); }
+
+  void Reply() override {
+    for (size_t i = 0; i < callbacks_.size(); ++i) {
+      Result* result = &results_[i];
+      QUIC_BUG_IF(!result->done)
+          << "ProofSource did not complete a proof on the worker thread.";
+      callbacks_[i]->Run(result->done && result->ok, result->chain,
+                         result->proof, std::move(result->details));
+    }
+  }
+
+ private:
+  struct Result {
+    Result() : done(false), ok(false) {}
+
+    bool done;
+    bool ok;
+    QuicReferenceCountedPointer<ProofSource::Chain> chain;
+    QuicCryptoProof proof;
+    std::unique_ptr<ProofSource::Details> details;
+  };
+
+  class ResultCallback : public ProofSource::Callback {
+   public:
+    explicit ResultCallback(Result* result) : result_(result) {}
+
+    void Run(bool ok,
+             const QuicReferenceCountedPointer<ProofSource::Chain>& chain,
+             const QuicCryptoProof& proof,
+             std::unique_ptr<ProofSource::Details> details) override {
+      result_->done = true;
+      result_->ok = ok;
+      result_->chain = chain;
+      result_->proof = proof;
+      result_->details = std::move(details);
+    }
+
+   private:
+    Result* result_;
+  };
+
+  ProofSource* proof_source_;
+  std::vector<ProofSource::ProofRequest> requests_;
+  std::vector<Result> results_;
+  // The callbacks of |requests_|, run on the thread which posted the task.
+  std::vector<std::unique_ptr<ProofSource::Callback>> callbacks_;
+};
+
 void QuicCryptoServerConfig::ProcessClientHello(
     QuicReferenceCountedPointer<ValidateClientHelloResultCallback::Result>
         validate_chlo_result,
@@ -645,37 +787,16 @@ void QuicCryptoServerConfig::ProcessClientHello(
   client_hello.GetStringPiece(kSCID, &requested_scid);
   const QuicWallTime now(clock->WallNow());
 
-  QuicReferenceCountedPointer<Config> requested_config;
-  QuicReferenceCountedPointer<Config> primary_config;
-  bool no_primary_config = false;
-  {
-    QuicReaderMutexLock locked(&configs_lock_);
-
-    if (!primary_config_) {
-      no_primary_config = true;
-    } else {
-      if (!next_config_promotion_time_.IsZero() &&
-          next_config_promotion_time_.IsAfter(now)) {
-        configs_lock_.ReaderUnlock();
-        configs_lock_.WriterLock();
-        SelectNewPrimaryConfig(now);
-        DCHECK(primary_config_.get());
-        DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
-                  primary_config_.get());
-        configs_lock_.WriterUnlock();
-        configs_lock_.ReaderLock();
-      }
-
-      // Use the config that the client requested in order to do key-agreement.
-      // Otherwise give it a copy of |primary_config_| to use.
-      primary_config = signed_config->config;
-      requested_config = GetConfigWithScid(requested_scid);
-    }
-  }
-  if (no_primary_config) {
+  std::shared_ptr<const ConfigSnapshot> snapshot = GetConfigSnapshot(now);
+  if (!snapshot->primary_config) {
     helper.Fail(QUIC_CRYPTO_INTERNAL_ERROR, "No configurations loaded");
     return;
   }
+  // Use the config that the client requested in order to do key-agreement.
+  // Otherwise give it a copy of |primary_config_| to use.
+  QuicReferenceCountedPointer<Config> primary_config = signed_config->config;
+  QuicReferenceCountedPointer<Config> requested_config =
+      snapshot->GetConfigWithScid(requested_scid);
 
   if (validate_chlo_result->error_code != QUIC_NO_ERROR) {
     helper.Fail(validate_chlo_result->error_code,
@@ -702,9 +823,8 @@ void QuicCryptoServerConfig::ProcessClientHello(
             compressed_certs_cache, params, signed_config,
             total_framing_overhead, chlo_packet_size, requested_config,
             primary_config, std::move(done_cb)));
-    proof_source_->GetProof(server_address, info.sni.as_string(),
-                            primary_config->serialized, version, chlo_hash,
-                            std::move(cb));
+    GetProof(server_address, info.sni.as_string(), primary_config->serialized,
+             version, chlo_hash, std::move(cb));
     helper.DetachCallback();
     return;
   }
@@ -712,7 +832,7 @@ void QuicCryptoServerConfig::ProcessClientHello(
   helper.DetachCallback();
   ProcessClientHelloAfterGetProof(
       /* found_error = */ false, /* proof_source_details = */ nullptr,
-      *validate_chlo_result, reject_only, connection_id, client_address,
+      validate_chlo_result, reject_only, connection_id, client_address,
       version, supported_versions, use_stateless_rejects,
       server_designated_connection_id, clock, rand, compressed_certs_cache,
       params, signed_config, total_framing_overhead, chlo_packet_size,
@@ -722,7 +842,8 @@ void QuicCryptoServerConfig::ProcessClientHello(
 void QuicCryptoServerConfig::ProcessClientHelloAfterGetProof(
     bool found_error,
     std::unique_ptr<ProofSource::Details> proof_source_details,
-    const ValidateClientHelloResultCallback::Result& validate_chlo_result,
+    const QuicReferenceCountedPointer<
+        ValidateClientHelloResultCallback::Result>& validate_chlo_result,
     bool reject_only,
     QuicConnectionId connection_id,
     const QuicSocketAddress& client_address,
@@ -750,8 +871,8 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterGetProof(
   }
 
   const CryptoHandshakeMessage& client_hello =
-      validate_chlo_result.client_hello;
-  const ClientHelloInfo& info = validate_chlo_result.info;
+      validate_chlo_result->client_hello;
+  const ClientHelloInfo& info = validate_chlo_result->info;
   std::unique_ptr<DiversificationNonce> out_diversification_nonce(
       new DiversificationNonce);
 
@@ -764,7 +885,7 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterGetProof(
   std::unique_ptr<CryptoHandshakeMessage> out(new CryptoHandshakeMessage);
   if (!info.reject_reasons.empty() || !requested_config.get()) {
     BuildRejection(version, clock->WallNow(), *primary_config, client_hello,
-                   info, validate_chlo_result.cached_network_params,
+                   info, validate_chlo_result->cached_network_params,
                    use_stateless_rejects, server_designated_connection_id, rand,
                    compressed_certs_cache, params, *signed_config,
                    total_framing_overhead, chlo_packet_size, out.get());
@@ -782,6 +903,44 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterGetProof(
     return;
   }
 
+  if (crypto_worker_pool_ != nullptr && ephemeral_key_source_ == nullptr) {
+    helper.DetachCallback();
+    crypto_worker_pool_->PostTask(QuicMakeUnique<KeyAgreementTask>(
+        this, validate_chlo_result, connection_id, client_address,
+        supported_versions, clock, rand, params, signed_config,
+        requested_config, std::move(out), std::move(out_diversification_nonce),
+        std::move(proof_source_details), std::move(done_cb)));
+    return;
+  }
+
+  helper.DetachCallback();
+  ProcessClientHelloKeyAgreement(
+      *validate_chlo_result, connection_id, client_address, supported_versions,
+      clock, rand, params, signed_config, requested_config, std::move(out),
+      std::move(out_diversification_nonce), std::move(proof_source_details),
+      std::move(done_cb));
+}
+
+void QuicCryptoServerConfig::ProcessClientHelloKeyAgreement(
+    const ValidateClientHelloResultCallback::Result& validate_chlo_result,
+    QuicConnectionId connection_id,
+    const QuicSocketAddress& client_address,
+    const QuicTransportVersionVector& supported_versions,
+    const QuicClock* clock,
+    QuicRandom* rand,
+    QuicReferenceCountedPointer<QuicCryptoNegotiatedParameters> params,
+    QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config,
+    const QuicReferenceCountedPointer<Config>& requested_config,
+    std::unique_ptr<CryptoHandshakeMessage> out,
+    std::unique_ptr<DiversificationNonce> out_diversification_nonce,
+    std::unique_ptr<ProofSource::Details> proof_source_details,
+    std::unique_ptr<ProcessClientHelloResultCallback> done_cb) const {
+  ProcessClientHelloHelper helper(&done_cb);
+
+  const CryptoHandshakeMessage& client_hello =
+      validate_chlo_result.client_hello;
+  const ClientHelloInfo& info = validate_chlo_result.info;
+
   QuicTagVector their_aeads;
   QuicTagVector their_key_exchanges;
   if (client_hello.GetTaglist(kAEAD, &their_aeads) != QUIC_NO_ERROR ||
@@ -992,14 +1151,17 @@ void QuicCryptoServerConfig::ProcessClientHelloAfterGetProof(
                  std::move(proof_source_details));
 }
 
+QuicCryptoServerConfig::ConfigSnapshot::ConfigSnapshot()
+    : next_config_promotion_time(QuicWallTime::Zero()) {}
+
+QuicCryptoServerConfig::ConfigSnapshot::~ConfigSnapshot() {}
+
 QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>
-QuicCryptoServerConfig::GetConfigWithScid(
+QuicCryptoServerConfig::ConfigSnapshot::GetConfigWithScid(
     QuicStringPiece requested_scid) const {
-  configs_lock_.AssertReaderHeld();
-
   if (!requested_scid.empty()) {
-    ConfigMap::const_iterator it = configs_.find(requested_scid.as_string());
-    if (it != configs_.end()) {
+    ConfigMap::const_iterator it = configs.find(requested_scid.as_string());
+    if (it != configs.end()) {
       // We'll use the config that the client requested in order to do
       // key-agreement.
       return QuicReferenceCountedPointer<Config>(it->second);
@@ -1009,6 +1171,41 @@ QuicCryptoServerConfig::GetConfigWithScid(
   return QuicReferenceCountedPointer<Config>();
 }
 
+std::shared_ptr<const QuicCryptoServerConfig::ConfigSnapshot>
+QuicCryptoServerConfig::LoadConfigSnapshot() const {
+  return std::atomic_load(&config_snapshot_);
+}
+
+std::shared_ptr<const QuicCryptoServerConfig::ConfigSnapshot>
+QuicCryptoServerConfig::GetConfigSnapshot(const QuicWallTime now) const {
+  std::shared_ptr<const ConfigSnapshot> snapshot = LoadConfigSnapshot();
+  if (!snapshot->primary_config ||
+      snapshot->next_config_promotion_time.IsZero() ||
+      snapshot->next_config_promotion_time.IsAfter(now)) {
+    return snapshot;
+  }
+  QuicWriterMutexLock locked(&configs_lock_);
+  // Another thread may have promoted the config in the meantime.
+  if (!next_config_promotion_time_.IsZero() &&
+      !next_config_promotion_time_.IsAfter(now)) {
+    SelectNewPrimaryConfig(now);
+    DCHECK(primary_config_.get());
+    DCHECK_EQ(configs_.find(primary_config_->id)->second.get(),
+              primary_config_.get());
+  }
+  return LoadConfigSnapshot();
+}
+
+void QuicCryptoServerConfig::PublishConfigSnapshot() const {
+  std::shared_ptr<ConfigSnapshot> snapshot =
+      std::make_shared<ConfigSnapshot>();
+  snapshot->configs = configs_;
+  snapshot->primary_config = primary_config_;
+  snapshot->next_config_promotion_time = next_config_promotion_time_;
+  std::atomic_store(&config_snapshot_,
+                    std::shared_ptr<const ConfigSnapshot>(std::move(snapshot)));
+}
+
 // ConfigPrimaryTimeLessThan is a comparator that implements "less than" for
 // Config's based on their primary_time.
 // static
@@ -1045,6 +1242,7 @@ void QuicCryptoServerConfig::SelectNewPrimaryConfig(
     } else {
       QUIC_BUG << "No valid QUIC server config.";
     }
+    PublishConfigSnapshot();
     return;
   }
 
@@ -1085,6 +1283,7 @@ void QuicCryptoServerConfig::SelectNewPrimaryConfig(
                     << QuicTextUtils::HexEncode(reinterpret_cast<const char*>(
                                                     primary_config_->orbit),
                                                 kOrbitSize);
+    PublishConfigSnapshot();
     if (primary_config_changed_cb_.get() != nullptr) {
       primary_config_changed_cb_->Run(primary_config_->id);
     }
@@ -1106,6 +1305,7 @@ void QuicCryptoServerConfig::SelectNewPrimaryConfig(
                          kOrbitSize)
                   << " scid: " << QuicTextUtils::HexEncode(primary_config_->id);
   next_config_promotion_time_ = QuicWallTime::Zero();
+  PublishConfigSnapshot();
   if (primary_config_changed_cb_.get() != nullptr) {
     primary_config_changed_cb_->Run(primary_config_->id);
   }
@@ -1256,9 +1456,8 @@ void QuicCryptoServerConfig::EvaluateClientHello(
             *this, found_error, server_address.host(), version,
             requested_config, primary_config, signed_config, client_hello_state,
             std::move(done_cb)));
-    proof_source_->GetProof(server_address, info->sni.as_string(),
-                            serialized_config, version, chlo_hash,
-                            std::move(cb));
+    GetProof(server_address, info->sni.as_string(), serialized_config, version,
+             chlo_hash, std::move(cb));
     helper.DetachCallback();
     return;
   }
@@ -1336,11 +1535,12 @@ void QuicCryptoServerConfig::BuildServerConfigUpdateMessage(
   string source_address_token;
   const CommonCertSets* common_cert_sets;
   {
-    QuicReaderMutexLock locked(&configs_lock_);
-    serialized = primary_config_->serialized;
-    common_cert_sets = primary_config_->common_cert_sets;
+    const QuicReferenceCountedPointer<Config> primary_config =
+        LoadConfigSnapshot()->primary_config;
+    serialized = primary_config->serialized;
+    common_cert_sets = primary_config->common_cert_sets;
     source_address_token = NewSourceAddressToken(
-        *primary_config_, previous_source_address_tokens, client_ip, rand,
+        *primary_config, previous_source_address_tokens, client_ip, rand,
         clock->WallNow(), cached_network_params);
   }
 
@@ -1547,13 +1747,14 @@ string QuicCryptoServerConfig::CompressChain(
     const CommonCertSets* common_sets) {
   // Check whether the compressed certs is available in the cache.
   DCHECK(compressed_certs_cache);
-  const string* cached_value = compressed_certs_cache->GetCompressedCert(
-      chain, client_common_set_hashes, client_cached_cert_hashes);
-  if (cached_value) {
-    return *cached_value;
+  string compressed;
+  if (compressed_certs_cache->GetCompressedCert(
+          chain, client_common_set_hashes, client_cached_cert_hashes,
+          &compressed)) {
+    return compressed;
   }
 
-  const string compressed =
+  compressed =
       CertCompressor::CompressChain(chain->certs, client_common_set_hashes,
                                     client_common_set_hashes, common_sets);
 
@@ -1738,6 +1939,80 @@ void QuicCryptoServerConfig::set_enable_serving_sct(bool enable_serving_sct) {
   enable_serving_sct_ = enable_serving_sct;
 }
 
+void QuicCryptoServerConfig::set_proof_batch_size(size_t proof_batch_size) {
+  proof_batch_size_ = proof_batch_size;
+  if (proof_batch_size_ <= 1) {
+    FlushPendingProofs();
+  }
+}
+
+void QuicCryptoServerConfig::FlushPendingProofs() const {
+  std::vector<ProofSource::ProofRequest> requests;
+  {
+    QuicWriterMutexLock locked(&pending_proofs_lock_);
+    requests.swap(pending_proofs_);
+  }
+  if (!requests.empty()) {
+    GetProofs(std::move(requests));
+  }
+}
+
+void QuicCryptoServerConfig::set_crypto_worker_pool(
+    CryptoWorkerPool* crypto_worker_pool) {
+  crypto_worker_pool_ = crypto_worker_pool;
+}
+
+size_t QuicCryptoServerConfig::NumPendingProofs() const {
+  QuicReaderMutexLock locked(&pending_proofs_lock_);
+  return pending_proofs_.size();
+}
+
+void QuicCryptoServerConfig::GetProof(
+    const QuicSocketAddress& server_address,
+    const string& hostname,
+    const string& server_config,
+    QuicTransportVersion transport_version,
+    QuicStringPiece chlo_hash,
+    std::unique_ptr<ProofSource::Callback> callback) const {
+  if (proof_batch_size_ <= 1) {
+    if (crypto_worker_pool_ == nullptr) {
+      proof_source_->GetProof(server_address, hostname, server_config,
+                              transport_version, chlo_hash,
+                              std::move(callback));
+      return;
+    }
+    std::vector<ProofSource::ProofRequest> requests;
+    requests.emplace_back(server_address, hostname, server_config,
+                          transport_version, chlo_hash, std::move(callback));
+    GetProofs(std::move(requests));
+    return;
+  }
+  std::vector<ProofSource::ProofRequest> requests;
+  {
+    QuicWriterMutexLock locked(&pending_proofs_lock_);
+    pending_proofs_.emplace_back(server_address, hostname, server_config,
+                                 transport_version, chlo_hash,
+                                 std::move(callback));
+    if (pending_proofs_.size() < proof_batch_size_) {
+      return;
+    }
+    requests.swap(pending_proofs_);
+  }
+  // The callbacks may run synchronously and queue more proofs, so the batch
+  // is handed over without holding the lock.
+  GetProofs(std::move(requests));
+}
+
+void QuicCryptoServerConfig::GetProofs(
+    std::vector<ProofSource::ProofRequest> requests) const {
+  if (crypto_worker_pool_ == nullptr) {
+    proof_source_->GetProofs(std::move(requests));
+    return;
+  }
+  crypto_worker_pool_->PostTask(
+      QuicMakeUnique<GetProofsTask>(proof_source_.get(), std::move(requests)));
+}
+
 void QuicCryptoServerConfig::AcquirePrimaryConfigChangedCb(
     std::unique_ptr<PrimaryConfigChangedCallback> cb) {
   QuicWriterMutexLock locked(&configs_lock_);
@@ -1783,8 +2058,7 @@ string QuicCryptoServerConfig::NewSourceAddressToken(
 }
 
 int QuicCryptoServerConfig::NumberOfConfigs() const {
-  QuicReaderMutexLock locked(&configs_lock_);
-  return configs_.size();
+  return LoadConfigSnapshot()->configs.size();
 }
 
 HandshakeFailureReason QuicCryptoServerConfig::ParseSourceAddressToken(
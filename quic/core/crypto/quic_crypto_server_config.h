@@ -17,6 +17,7 @@
 #include "net/quic/core/crypto/crypto_handshake_message.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
 #include "net/quic/core/crypto/crypto_secret_boxer.h"
+#include "net/quic/core/crypto/crypto_worker_pool.h"
 #include "net/quic/core/crypto/proof_source.h"
 #include "net/quic/core/crypto/quic_compressed_certs_cache.h"
 #include "net/quic/core/crypto/quic_crypto_proof.h"
@@ -379,6 +380,31 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // (RFC6962) in server hello.
   void set_enable_serving_sct(bool enable_serving_sct);
 
+  // set_proof_batch_size makes the handshake path queue its GetProof calls and
+  // hand them to ProofSource::GetProofs() by batches of |proof_batch_size|.
+  // Values of 0 and 1 disable batching, which is the default. Servers batching
+  // proofs must call FlushPendingProofs() once they run out of packets to
+  // process, so that queued handshakes don't wait for a full batch.
+  void set_proof_batch_size(size_t proof_batch_size);
+
+  // Hands the queued GetProof calls to the ProofSource, however many there
+  // are. Does nothing if none are queued.
+  void FlushPendingProofs() const;
+
+  // Returns the number of GetProof calls waiting for a batch to fill up.
+  size_t NumPendingProofs() const;
+
+  // set_crypto_worker_pool makes the handshake path compute its proofs, and
+  // agree on the keys of accepted CHLOs, on the threads of |crypto_worker_pool|.
+  // The results are delivered through the asynchronous ValidateClientHello
+  // and ProcessClientHello callbacks on the thread which made the call. The
+  // pool is not owned and must stop its workers before this object is
+  // destroyed. When a pool is set, the ProofSource must be thread-safe and run
+  // its callbacks before GetProof returns, and the QuicRandom passed to
+  // ProcessClientHello must be thread-safe. Key agreement stays on the calling
+  // thread while an EphemeralKeySource is set.
+  void set_crypto_worker_pool(CryptoWorkerPool* crypto_worker_pool);
+
   // Set and take ownership of the callback to invoke on primary config changes.
   void AcquirePrimaryConfigChangedCb(
       std::unique_ptr<PrimaryConfigChangedCallback> cb);
@@ -463,10 +489,48 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   typedef std::map<ServerConfigID, QuicReferenceCountedPointer<Config>>
       ConfigMap;
 
-  // Get a ref to the config with a given server config id.
-  QuicReferenceCountedPointer<Config> GetConfigWithScid(
-      QuicStringPiece requested_scid) const
-      SHARED_LOCKS_REQUIRED(configs_lock_);
+  // An immutable copy of the configs, which the handshake path reads without
+  // taking |configs_lock_|. Changes to the configs publish a new one.
+  struct ConfigSnapshot {
+    ConfigSnapshot();
+    ~ConfigSnapshot();
+
+    // Get a ref to the config with a given server config id.
+    QuicReferenceCountedPointer<Config> GetConfigWithScid(
+        QuicStringPiece requested_scid) const;
+
+    ConfigMap configs;
+    QuicReferenceCountedPointer<Config> primary_config;
+    QuicWallTime next_config_promotion_time;
+  };
+
+  // Returns the current config snapshot.
+  std::shared_ptr<const ConfigSnapshot> LoadConfigSnapshot() const;
+
+  // Returns the current config snapshot, after promoting a new primary config
+  // if one is due at |now|.
+  std::shared_ptr<const ConfigSnapshot> GetConfigSnapshot(
+      QuicWallTime now) const;
+
+  // Publishes a snapshot of |configs_|, |primary_config_| and
+  // |next_config_promotion_time_|.
+  void PublishConfigSnapshot() const EXCLUSIVE_LOCKS_REQUIRED(configs_lock_);
+
+  // GetProof either forwards to |proof_source_|, or queues the call if proofs
+  // are batched.
+  void GetProof(const QuicSocketAddress& server_address,
+                const std::string& hostname,
+                const std::string& server_config,
+                QuicTransportVersion transport_version,
+                QuicStringPiece chlo_hash,
+                std::unique_ptr<ProofSource::Callback> callback) const;
+
+  // Task which runs ProofSource::GetProofs on |crypto_worker_pool_|.
+  class GetProofsTask;
+
+  // Hands |requests| to |proof_source_|, through |crypto_worker_pool_| if
+  // there is one.
+  void GetProofs(std::vector<ProofSource::ProofRequest> requests) const;
 
   // ConfigPrimaryTimeLessThan returns true if a->primary_time <
   // b->primary_time.
@@ -475,8 +539,9 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
       const QuicReferenceCountedPointer<Config>& b);
 
   // SelectNewPrimaryConfig reevaluates the primary config based on the
-  // "primary_time" deadlines contained in each.
-  void SelectNewPrimaryConfig(QuicWallTime now) const;
+  // "primary_time" deadlines contained in each, and publishes the result.
+  void SelectNewPrimaryConfig(QuicWallTime now) const
+      EXCLUSIVE_LOCKS_REQUIRED(configs_lock_);
 
   // EvaluateClientHello checks |client_hello| for gross errors and determines
   // whether it can be shown to be fresh (i.e. not a replay). The results are
@@ -523,7 +588,8 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   void ProcessClientHelloAfterGetProof(
       bool found_error,
       std::unique_ptr<ProofSource::Details> proof_source_details,
-      const ValidateClientHelloResultCallback::Result& validate_chlo_result,
+      const QuicReferenceCountedPointer<
+          ValidateClientHelloResultCallback::Result>& validate_chlo_result,
       bool reject_only,
       QuicConnectionId connection_id,
       const QuicSocketAddress& client_address,
@@ -542,6 +608,29 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
       const QuicReferenceCountedPointer<Config>& primary_config,
       std::unique_ptr<ProcessClientHelloResultCallback> done_cb) const;
 
+  // Task which runs ProcessClientHelloKeyAgreement on |crypto_worker_pool_|.
+  class KeyAgreementTask;
+  friend class KeyAgreementTask;
+
+  // Portion of ProcessClientHelloAfterGetProof which agrees on the keys of an
+  // accepted CHLO and builds the SHLO in |out|. |connection_id| is in network
+  // byte order. Only touches objects which are either thread-safe or not used
+  // by anyone else until |done_cb| runs.
+  void ProcessClientHelloKeyAgreement(
+      const ValidateClientHelloResultCallback::Result& validate_chlo_result,
+      QuicConnectionId connection_id,
+      const QuicSocketAddress& client_address,
+      const QuicTransportVersionVector& supported_versions,
+      const QuicClock* clock,
+      QuicRandom* rand,
+      QuicReferenceCountedPointer<QuicCryptoNegotiatedParameters> params,
+      QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config,
+      const QuicReferenceCountedPointer<Config>& requested_config,
+      std::unique_ptr<CryptoHandshakeMessage> out,
+      std::unique_ptr<DiversificationNonce> out_diversification_nonce,
+      std::unique_ptr<ProofSource::Details> proof_source_details,
+      std::unique_ptr<ProcessClientHelloResultCallback> done_cb) const;
+
   // BuildRejection sets |out| to be a REJ message in reply to |client_hello|.
   void BuildRejection(
       QuicTransportVersion version,
@@ -709,6 +798,8 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   //   1) configs_.empty() <-> primary_config_ == nullptr
   //   2) primary_config_ != nullptr -> primary_config_->is_primary
   //   3) ∀ c∈configs_, c->is_primary <-> c == primary_config_
+  // They are only used to build new config snapshots, so |configs_lock_| just
+  // serializes the changes to the configs.
   mutable QuicMutex configs_lock_;
   // configs_ contains all active server configs. It's expected that there are
   // about half-a-dozen configs active at any one time.
@@ -723,6 +814,10 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // Callback to invoke when the primary config changes.
   std::unique_ptr<PrimaryConfigChangedCallback> primary_config_changed_cb_
       GUARDED_BY(configs_lock_);
+  // The snapshot read by the handshake path. Only accessed through
+  // std::atomic_load() and std::atomic_store(), so that swapping in a new one
+  // never blocks readers.
+  mutable std::shared_ptr<const ConfigSnapshot> config_snapshot_;
 
   // Used to protect the source-address tokens that are given to clients.
   CryptoSecretBoxer source_address_token_boxer_;
@@ -740,10 +835,24 @@ class QUIC_EXPORT_PRIVATE QuicCryptoServerConfig {
   // signatures.
   std::unique_ptr<ProofSource> proof_source_;
 
+  // Size of the batches handed to ProofSource::GetProofs(), or 0 or 1 if
+  // GetProof calls are not batched.
+  size_t proof_batch_size_;
+  // GetProof calls queued until a batch fills up or FlushPendingProofs() is
+  // called. Callbacks of requests still queued when the config is destroyed
+  // are deleted without being run.
+  mutable QuicMutex pending_proofs_lock_;
+  mutable std::vector<ProofSource::ProofRequest> pending_proofs_
+      GUARDED_BY(pending_proofs_lock_);
+
   // ephemeral_key_source_ contains an object that caches ephemeral keys for a
   // short period of time.
   std::unique_ptr<EphemeralKeySource> ephemeral_key_source_;
 
+  // Runs proofs and key agreement off the calling thread, if not null. Not
+  // owned.
+  CryptoWorkerPool* crypto_worker_pool_;
+
   // These fields store configuration values. See the comments for their
   // respective setter functions.
   uint32_t source_address_token_future_secs_;
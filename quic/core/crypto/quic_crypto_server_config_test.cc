@@ -47,7 +47,7 @@ TEST_F(QuicCryptoServerConfigTest, ServerConfig) {
 
 TEST_F(QuicCryptoServerConfigTest, CompressCerts) {
   QuicCompressedCertsCache compressed_certs_cache(
-      QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
+      QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes);
 
   QuicRandom* rand = QuicRandom::GetInstance();
   QuicCryptoServerConfig server(QuicCryptoServerConfig::TESTING, rand,
@@ -66,7 +66,7 @@ TEST_F(QuicCryptoServerConfigTest, CompressCerts) {
 
 TEST_F(QuicCryptoServerConfigTest, CompressSameCertsTwice) {
   QuicCompressedCertsCache compressed_certs_cache(
-      QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
+      QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes);
 
   QuicRandom* rand = QuicRandom::GetInstance();
   QuicCryptoServerConfig server(QuicCryptoServerConfig::TESTING, rand,
@@ -95,7 +95,7 @@ TEST_F(QuicCryptoServerConfigTest, CompressDifferentCerts) {
   // This test compresses a set of similar but not identical certs. Cache if
   // used should return cache miss and add all the compressed certs.
   QuicCompressedCertsCache compressed_certs_cache(
-      QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
+      QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes);
 
   QuicRandom* rand = QuicRandom::GetInstance();
   QuicCryptoServerConfig server(QuicCryptoServerConfig::TESTING, rand,
@@ -112,12 +112,23 @@ TEST_F(QuicCryptoServerConfigTest, CompressDifferentCerts) {
       &compressed_certs_cache, chain, common_certs, cached_certs, nullptr);
   EXPECT_EQ(compressed_certs_cache.Size(), 1u);
 
-  // Compress a similar certs which only differs in the chain.
+  // A different chain object holding the same certs uses the same entry.
   QuicReferenceCountedPointer<ProofSource::Chain> chain2(
       new ProofSource::Chain(certs));
 
   string compressed2 = QuicCryptoServerConfigPeer::CompressChain(
       &compressed_certs_cache, chain2, common_certs, cached_certs, nullptr);
+  EXPECT_EQ(compressed, compressed2);
+  EXPECT_EQ(compressed_certs_cache.Size(), 1u);
+  EXPECT_EQ(compressed_certs_cache.hits(), 1u);
+
+  // Compress a similar certs which only differs in the chain.
+  std::vector<string> certs2 = {"testcert2"};
+  QuicReferenceCountedPointer<ProofSource::Chain> chain3(
+      new ProofSource::Chain(certs2));
+
+  string compressed3 = QuicCryptoServerConfigPeer::CompressChain(
+      &compressed_certs_cache, chain3, common_certs, cached_certs, nullptr);
   EXPECT_EQ(compressed_certs_cache.Size(), 2u);
 
   // Compress a similar certs which only differs in common certs field.
@@ -126,10 +137,11 @@ TEST_F(QuicCryptoServerConfigTest, CompressDifferentCerts) {
       crypto_test_utils::MockCommonCertSets(certs[0], set_hash, 1));
   QuicStringPiece different_common_certs(
       reinterpret_cast<const char*>(&set_hash), sizeof(set_hash));
-  string compressed3 = QuicCryptoServerConfigPeer::CompressChain(
+  string compressed4 = QuicCryptoServerConfigPeer::CompressChain(
       &compressed_certs_cache, chain, different_common_certs.as_string(),
       cached_certs, common_sets.get());
   EXPECT_EQ(compressed_certs_cache.Size(), 3u);
+  EXPECT_EQ(compressed_certs_cache.misses(), 3u);
 }
 
 class SourceAddressTokenTest : public QuicTest {
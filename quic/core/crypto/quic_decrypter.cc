@@ -4,11 +4,14 @@
 
 #include "net/quic/core/crypto/quic_decrypter.h"
 
+#include <cstring>
+
 #include "crypto/hkdf.h"
 #include "net/quic/core/crypto/aes_128_gcm_12_decrypter.h"
 #include "net/quic/core/crypto/chacha20_poly1305_decrypter.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
 #include "net/quic/core/crypto/null_decrypter.h"
+#include "net/quic/platform/api/quic_aligned.h"
 #include "net/quic/platform/api/quic_logging.h"
 
 using std::string;
@@ -28,6 +31,25 @@ QuicDecrypter* QuicDecrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicDecrypter::DecryptPacketInPlace(QuicTransportVersion version,
+                                         QuicPacketNumber packet_number,
+                                         QuicStringPiece associated_data,
+                                         char* buffer,
+                                         size_t ciphertext_length,
+                                         size_t* output_length) {
+  if (ciphertext_length > kMaxPacketSize) {
+    return false;
+  }
+  QUIC_CACHELINE_ALIGNED char plaintext[kMaxPacketSize];
+  if (!DecryptPacket(version, packet_number, associated_data,
+                     QuicStringPiece(buffer, ciphertext_length), plaintext,
+                     output_length, kMaxPacketSize)) {
+    return false;
+  }
+  memcpy(buffer, plaintext, *output_length);
+  return true;
+}
+
 // static
 void QuicDecrypter::DiversifyPreliminaryKey(QuicStringPiece preliminary_key,
                                             QuicStringPiece nonce_prefix,
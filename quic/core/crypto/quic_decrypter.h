@@ -102,6 +102,18 @@ class QUIC_EXPORT_PRIVATE QuicDecrypter {
                              size_t* output_length,
                              size_t max_output_length) = 0;
 
+  // Same as DecryptPacket(), except that the |ciphertext_length| bytes of
+  // ciphertext at |buffer| are replaced by the plaintext, and |output_length|
+  // is set to its length. The contents of |buffer| are undefined on failure,
+  // so the caller must not need the ciphertext afterwards. The default
+  // implementation decrypts into a scratch buffer and copies the result back.
+  virtual bool DecryptPacketInPlace(QuicTransportVersion version,
+                                    QuicPacketNumber packet_number,
+                                    QuicStringPiece associated_data,
+                                    char* buffer,
+                                    size_t ciphertext_length,
+                                    size_t* output_length);
+
   // The ID of the cipher. Return 0x03000000 ORed with the 'cryptographic suite
   // selector'.
   virtual uint32_t cipher_id() const = 0;
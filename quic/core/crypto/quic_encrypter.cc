@@ -4,6 +4,8 @@
 
 #include "net/quic/core/crypto/quic_encrypter.h"
 
+#include <cstring>
+
 #include "net/quic/core/crypto/aes_128_gcm_12_encrypter.h"
 #include "net/quic/core/crypto/chacha20_poly1305_encrypter.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
@@ -25,4 +27,26 @@ QuicEncrypter* QuicEncrypter::Create(QuicTag algorithm) {
   }
 }
 
+bool QuicEncrypter::EncryptPacketWithTrailingPlaintext(
+    QuicTransportVersion version,
+    QuicPacketNumber packet_number,
+    QuicStringPiece associated_data,
+    QuicStringPiece plaintext,
+    QuicStringPiece trailing_plaintext,
+    char* output,
+    size_t* output_length,
+    size_t max_output_length) {
+  const size_t plaintext_length =
+      plaintext.length() + trailing_plaintext.length();
+  if (max_output_length < plaintext_length) {
+    return false;
+  }
+  memmove(output, plaintext.data(), plaintext.length());
+  memcpy(output + plaintext.length(), trailing_plaintext.data(),
+         trailing_plaintext.length());
+  return EncryptPacket(version, packet_number, associated_data,
+                       QuicStringPiece(output, plaintext_length), output,
+                       output_length, max_output_length);
+}
+
 }  // namespace net
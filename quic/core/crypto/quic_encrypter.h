@@ -84,6 +84,21 @@ class QUIC_EXPORT_PRIVATE QuicEncrypter {
                              size_t* output_length,
                              size_t max_output_length) = 0;
 
+  // Same as EncryptPacket(), except that the plaintext is |plaintext|
+  // followed by |trailing_plaintext|, which may live in a separate buffer.
+  // |output| must not overlap with |trailing_plaintext|. The default
+  // implementation copies both pieces into |output| and encrypts them there;
+  // subclasses may read |trailing_plaintext| from where it lies instead.
+  virtual bool EncryptPacketWithTrailingPlaintext(
+      QuicTransportVersion version,
+      QuicPacketNumber packet_number,
+      QuicStringPiece associated_data,
+      QuicStringPiece plaintext,
+      QuicStringPiece trailing_plaintext,
+      char* output,
+      size_t* output_length,
+      size_t max_output_length);
+
   // GetKeySize() and GetNoncePrefixSize() tell the HKDF class how many bytes
   // of key material needs to be derived from the master secret.
   // NOTE: the sizes returned by GetKeySize() and GetNoncePrefixSize() are
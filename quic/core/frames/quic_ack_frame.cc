@@ -143,44 +143,40 @@ void PacketNumberQueue::Add(QuicPacketNumber packet_number) {
       return;
     }
 
-    int i = packet_number_deque_.size() - 1;
-    // Iterating through the queue backwards
-    // to find a proper place for the packet
-    while (i >= 0) {
-      Interval<QuicPacketNumber> packet_interval = packet_number_deque_[i];
-      DCHECK(packet_interval.min() < packet_interval.max());
-      // Check if the packet is contained in an interval already
-      if (packet_interval.Contains(packet_number)) {
-        return;
-      }
-
-      // Check if the packet can extend an interval.
-      if (packet_interval.max() == packet_number) {
-        packet_number_deque_[i].SetMax(packet_number + 1);
-        return;
-      }
-      // Check if the packet can extend an interval
-      // and merge two intervals if needed.
-      // There is no need to merge an interval in the previous
-      // if statement, as all merges will happen here.
-      if (packet_interval.min() == packet_number + 1) {
-        packet_number_deque_[i].SetMin(packet_number);
-        if (i > 0 && packet_number == packet_number_deque_[i - 1].max()) {
-          packet_number_deque_[i - 1].SetMax(packet_interval.max());
-          packet_number_deque_.erase(packet_number_deque_.begin() + i);
-        }
-        return;
-      }
-
-      // Check if we need to make a new interval for the packet
-      if (packet_interval.max() < packet_number + 1) {
-        packet_number_deque_.insert(
-            packet_number_deque_.begin() + i + 1,
-            Interval<QuicPacketNumber>(packet_number, packet_number + 1));
-        return;
+    // Binary search for the first interval which ends at or after
+    // |packet_number|. One exists, since the last interval ends after it.
+    auto it = std::lower_bound(
+        packet_number_deque_.begin(), packet_number_deque_.end(),
+        packet_number, [](const Interval<QuicPacketNumber>& interval,
+                          QuicPacketNumber packet_number) {
+          return interval.max() < packet_number;
+        });
+    DCHECK(it != packet_number_deque_.end());
+    // Check if the packet is contained in an interval already
+    if (it->Contains(packet_number)) {
+      return;
+    }
+    // Check if the packet can extend an interval
+    // and merge two intervals if needed.
+    if (it->max() == packet_number) {
+      it->SetMax(packet_number + 1);
+      auto next = it + 1;
+      if (next != packet_number_deque_.end() &&
+          next->min() == packet_number + 1) {
+        it->SetMax(next->max());
+        packet_number_deque_.erase(next);
       }
-      i--;
+      return;
+    }
+    // The previous interval ends before |packet_number|, so extending this
+    // one downwards never requires a merge.
+    if (it->min() == packet_number + 1) {
+      it->SetMin(packet_number);
+      return;
     }
+    // Make a new interval for the packet.
+    packet_number_deque_.insert(
+        it, Interval<QuicPacketNumber>(packet_number, packet_number + 1));
   } else {
     packet_number_intervals_.Add(packet_number, packet_number + 1);
   }
@@ -278,12 +274,15 @@ bool PacketNumberQueue::Contains(QuicPacketNumber packet_number) const {
         packet_number_deque_.back().max() <= packet_number) {
       return false;
     }
-    for (Interval<QuicPacketNumber> interval : packet_number_deque_) {
-      if (interval.Contains(packet_number)) {
-        return true;
-      }
-    }
-    return false;
+    // The intervals are disjoint and sorted, so binary search for the first
+    // one which ends after |packet_number|.
+    auto it = std::upper_bound(
+        packet_number_deque_.begin(), packet_number_deque_.end(),
+        packet_number, [](QuicPacketNumber packet_number,
+                          const Interval<QuicPacketNumber>& interval) {
+          return packet_number < interval.max();
+        });
+    return it != packet_number_deque_.end() && it->Contains(packet_number);
   } else {
     return packet_number_intervals_.Contains(packet_number);
   }
@@ -550,6 +550,36 @@ TEST_F(PacketNumberQueueTest, Contains) {
   EXPECT_FALSE(queue2.Contains(101));
 }
 
+// Tests that adding packets out of order into interior gaps yields the same
+// intervals as QuicIntervalSet.
+TEST_F(PacketNumberQueueTest, AddOutOfOrder) {
+  PacketNumberQueue queue;
+  QuicIntervalSet<QuicPacketNumber> expected;
+  // Visits every packet number in [1, 1000) in a scrambled order, leaving out
+  // multiples of 7 so that gaps remain.
+  for (QuicPacketNumber i = 1; i < 1000; ++i) {
+    const QuicPacketNumber packet_number = i * 37 % 1000;
+    if (packet_number == 0 || packet_number % 7 == 0) {
+      continue;
+    }
+    queue.Add(packet_number);
+    expected.Add(packet_number, packet_number + 1);
+    // Adding a packet twice must not change anything.
+    queue.Add(packet_number);
+  }
+
+  const std::vector<Interval<QuicPacketNumber>> actual_intervals(
+      queue.begin(), queue.end());
+  const std::vector<Interval<QuicPacketNumber>> expected_intervals(
+      expected.begin(), expected.end());
+  EXPECT_EQ(expected_intervals, actual_intervals);
+  for (QuicPacketNumber packet_number = 0; packet_number < 1001;
+       ++packet_number) {
+    EXPECT_EQ(expected.Contains(packet_number), queue.Contains(packet_number))
+        << packet_number;
+  }
+}
+
 // Tests that a queue contains the expected data after calls to RemoveUpTo().
 TEST_F(PacketNumberQueueTest, Removal) {
   PacketNumberQueue queue;
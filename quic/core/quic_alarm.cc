@@ -7,7 +7,11 @@
 namespace net {
 
 QuicAlarm::QuicAlarm(QuicArenaScopedPtr<Delegate> delegate)
-    : delegate_(std::move(delegate)), deadline_(QuicTime::Zero()) {}
+    : delegate_(std::move(delegate)),
+      deadline_(QuicTime::Zero()),
+      defer_updates_(false),
+      scheduled_deadline_(QuicTime::Zero()),
+      num_deferred_updates_(0) {}
 
 QuicAlarm::~QuicAlarm() {}
 
@@ -15,6 +19,10 @@ void QuicAlarm::Set(QuicTime new_deadline) {
   DCHECK(!IsSet());
   DCHECK(new_deadline.IsInitialized());
   deadline_ = new_deadline;
+  if (defer_updates_) {
+    ++num_deferred_updates_;
+    return;
+  }
   SetImpl();
 }
 
@@ -24,6 +32,10 @@ void QuicAlarm::Cancel() {
     return;
   }
   deadline_ = QuicTime::Zero();
+  if (defer_updates_) {
+    ++num_deferred_updates_;
+    return;
+  }
   CancelImpl();
 }
 
@@ -38,6 +50,10 @@ void QuicAlarm::Update(QuicTime new_deadline, QuicTime::Delta granularity) {
   }
   const bool was_set = IsSet();
   deadline_ = new_deadline;
+  if (defer_updates_) {
+    ++num_deferred_updates_;
+    return;
+  }
   if (was_set) {
     UpdateImpl();
   } else {
@@ -55,9 +71,38 @@ void QuicAlarm::Fire() {
   }
 
   deadline_ = QuicTime::Zero();
+  if (defer_updates_) {
+    // Whatever the platform had scheduled has now run.
+    scheduled_deadline_ = QuicTime::Zero();
+  }
   delegate_->OnAlarm();
 }
 
+void QuicAlarm::DeferUpdates() {
+  DCHECK(!defer_updates_);
+  defer_updates_ = true;
+  scheduled_deadline_ = deadline_;
+  num_deferred_updates_ = 0;
+}
+
+size_t QuicAlarm::FlushDeferredUpdates() {
+  DCHECK(defer_updates_);
+  defer_updates_ = false;
+  size_t saved = num_deferred_updates_;
+  num_deferred_updates_ = 0;
+  if (deadline_ == scheduled_deadline_) {
+    return saved;
+  }
+  if (!IsSet()) {
+    CancelImpl();
+  } else if (scheduled_deadline_.IsInitialized()) {
+    UpdateImpl();
+  } else {
+    SetImpl();
+  }
+  return saved > 0 ? saved - 1 : 0;
+}
+
 void QuicAlarm::UpdateImpl() {
   // CancelImpl and SetImpl take the new deadline by way of the deadline_
   // member, so save and restore deadline_ before canceling.
@@ -5,6 +5,8 @@
 #ifndef NET_QUIC_CORE_QUIC_ALARM_H_
 #define NET_QUIC_CORE_QUIC_ALARM_H_
 
+#include <stddef.h>
+
 #include "base/macros.h"
 #include "net/quic/core/quic_arena_scoped_ptr.h"
 #include "net/quic/core/quic_time.h"
@@ -51,6 +53,16 @@ class QUIC_EXPORT_PRIVATE QuicAlarm {
 
   QuicTime deadline() const { return deadline_; }
 
+  // Defers the platform-specific scheduling done by Set(), Cancel() and
+  // Update() until FlushDeferredUpdates(), which only applies the final
+  // deadline. IsSet() and deadline() keep reflecting every call in between.
+  void DeferUpdates();
+
+  // Schedules or cancels the alarm according to its current deadline, if that
+  // differs from the one it was scheduled for when DeferUpdates() was called.
+  // Returns the number of platform-specific scheduling calls which were saved.
+  size_t FlushDeferredUpdates();
+
  protected:
   // Subclasses implement this method to perform the platform-specific
   // scheduling of the alarm.  Is called from Set() or Fire(), after the
@@ -79,6 +91,14 @@ class QUIC_EXPORT_PRIVATE QuicAlarm {
   QuicArenaScopedPtr<Delegate> delegate_;
   QuicTime deadline_;
 
+  // True between DeferUpdates() and FlushDeferredUpdates().
+  bool defer_updates_;
+  // While deferring updates, the deadline the platform-specific
+  // implementation last scheduled the alarm for.
+  QuicTime scheduled_deadline_;
+  // Number of scheduling calls deferred since DeferUpdates().
+  size_t num_deferred_updates_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicAlarm);
 };
 
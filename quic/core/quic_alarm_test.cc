@@ -151,6 +151,45 @@ TEST_F(QuicAlarmTest, FireAndResetViaSet) {
   EXPECT_EQ(deadline2_, alarm_.deadline());
 }
 
+TEST_F(QuicAlarmTest, DeferUpdates) {
+  alarm_.DeferUpdates();
+  alarm_.Set(deadline_);
+  alarm_.Update(deadline2_, QuicTime::Delta::Zero());
+  EXPECT_TRUE(alarm_.IsSet());
+  EXPECT_EQ(deadline2_, alarm_.deadline());
+
+  // Only the final deadline gets scheduled.
+  EXPECT_EQ(1u, alarm_.FlushDeferredUpdates());
+  EXPECT_TRUE(alarm_.scheduled());
+  EXPECT_EQ(deadline2_, alarm_.deadline());
+
+  // Updates are no longer deferred.
+  alarm_.Cancel();
+  EXPECT_FALSE(alarm_.scheduled());
+}
+
+TEST_F(QuicAlarmTest, DeferredUpdatesBackToScheduledDeadline) {
+  alarm_.Set(deadline_);
+  alarm_.DeferUpdates();
+  alarm_.Cancel();
+  alarm_.Set(deadline2_);
+  alarm_.Update(deadline_, QuicTime::Delta::Zero());
+  EXPECT_EQ(3u, alarm_.FlushDeferredUpdates());
+  EXPECT_TRUE(alarm_.scheduled());
+  EXPECT_EQ(deadline_, alarm_.deadline());
+}
+
+TEST_F(QuicAlarmTest, DeferredCancel) {
+  alarm_.Set(deadline_);
+  alarm_.DeferUpdates();
+  alarm_.Update(deadline2_, QuicTime::Delta::Zero());
+  alarm_.Cancel();
+  EXPECT_TRUE(alarm_.scheduled());
+  EXPECT_EQ(1u, alarm_.FlushDeferredUpdates());
+  EXPECT_FALSE(alarm_.IsSet());
+  EXPECT_FALSE(alarm_.scheduled());
+}
+
 TEST_F(QuicAlarmTest, FireDestroysAlarm) {
   DestructiveDelegate* delegate(new DestructiveDelegate);
   DestructiveAlarm* alarm = new DestructiveAlarm(delegate);
@@ -0,0 +1,186 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_bucketed_write_scheduler.h"
+
+#include "base/bits.h"
+#include "net/quic/platform/api/quic_bug_tracker.h"
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+QuicBucketedWriteScheduler::QuicBucketedWriteScheduler()
+    : ready_priorities_(0), num_ready_streams_(0) {}
+
+QuicBucketedWriteScheduler::~QuicBucketedWriteScheduler() {}
+
+void QuicBucketedWriteScheduler::RegisterStream(QuicStreamId stream_id,
+                                                SpdyPriority priority) {
+  DCHECK_LE(priority, kV3LowestPriority);
+  StreamInfo info = {stream_id, priority, false, nullptr, nullptr};
+  const bool inserted =
+      stream_infos_.insert(std::make_pair(stream_id, info)).second;
+  QUIC_BUG_IF(!inserted) << "Stream " << stream_id << " already registered";
+}
+
+void QuicBucketedWriteScheduler::UnregisterStream(QuicStreamId stream_id) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return;
+  }
+  if (it->second.ready) {
+    Unlink(&it->second);
+  }
+  stream_infos_.erase(it);
+}
+
+bool QuicBucketedWriteScheduler::StreamRegistered(
+    QuicStreamId stream_id) const {
+  return stream_infos_.find(stream_id) != stream_infos_.end();
+}
+
+void QuicBucketedWriteScheduler::UpdateStreamPriority(
+    QuicStreamId stream_id,
+    SpdyPriority new_priority) {
+  DCHECK_LE(new_priority, kV3LowestPriority);
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_DVLOG(1) << "Stream " << stream_id << " not registered";
+    return;
+  }
+  StreamInfo* info = &it->second;
+  if (info->priority == new_priority) {
+    return;
+  }
+  if (!info->ready) {
+    info->priority = new_priority;
+    return;
+  }
+  Unlink(info);
+  info->priority = new_priority;
+  Link(info, /*add_to_front=*/false);
+}
+
+SpdyPriority QuicBucketedWriteScheduler::GetStreamPriority(
+    QuicStreamId stream_id) const {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_DVLOG(1) << "Stream " << stream_id << " not registered";
+    return kV3LowestPriority;
+  }
+  return it->second.priority;
+}
+
+void QuicBucketedWriteScheduler::MarkStreamReady(QuicStreamId stream_id,
+                                                 bool add_to_front) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return;
+  }
+  if (it->second.ready) {
+    return;
+  }
+  Link(&it->second, add_to_front);
+}
+
+void QuicBucketedWriteScheduler::MarkStreamNotReady(QuicStreamId stream_id) {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return;
+  }
+  if (!it->second.ready) {
+    return;
+  }
+  Unlink(&it->second);
+}
+
+bool QuicBucketedWriteScheduler::IsStreamReady(QuicStreamId stream_id) const {
+  auto it = stream_infos_.find(stream_id);
+  return it != stream_infos_.end() && it->second.ready;
+}
+
+QuicStreamId QuicBucketedWriteScheduler::PopNextReadyStream(
+    SpdyPriority* priority) {
+  if (ready_priorities_ == 0) {
+    QUIC_BUG << "No ready streams available";
+    *priority = kV3LowestPriority;
+    return 0;
+  }
+  // The highest priority is the lowest value.
+  const SpdyPriority highest =
+      static_cast<SpdyPriority>(base::bits::CountTrailingZeroBits(
+          ready_priorities_));
+  StreamInfo* info = ready_lists_[highest].head;
+  Unlink(info);
+  *priority = highest;
+  return info->stream_id;
+}
+
+bool QuicBucketedWriteScheduler::ShouldYield(QuicStreamId stream_id) const {
+  auto it = stream_infos_.find(stream_id);
+  if (it == stream_infos_.end()) {
+    QUIC_BUG << "Stream " << stream_id << " not registered";
+    return false;
+  }
+  const StreamInfo& info = it->second;
+  // If there's a higher priority stream, this stream should yield.
+  if ((ready_priorities_ & ((1u << info.priority) - 1)) != 0) {
+    return true;
+  }
+  // If this priority level is empty, or this stream is the next up, there's
+  // no need to yield.
+  const StreamInfo* head = ready_lists_[info.priority].head;
+  return head != nullptr && head != &info;
+}
+
+void QuicBucketedWriteScheduler::Link(StreamInfo* info, bool add_to_front) {
+  DCHECK(!info->ready);
+  ReadyList* list = &ready_lists_[info->priority];
+  if (list->head == nullptr) {
+    info->previous = nullptr;
+    info->next = nullptr;
+    list->head = info;
+    list->tail = info;
+    ready_priorities_ |= 1u << info->priority;
+  } else if (add_to_front) {
+    info->previous = nullptr;
+    info->next = list->head;
+    list->head->previous = info;
+    list->head = info;
+  } else {
+    info->previous = list->tail;
+    info->next = nullptr;
+    list->tail->next = info;
+    list->tail = info;
+  }
+  info->ready = true;
+  ++num_ready_streams_;
+}
+
+void QuicBucketedWriteScheduler::Unlink(StreamInfo* info) {
+  DCHECK(info->ready);
+  ReadyList* list = &ready_lists_[info->priority];
+  if (info->previous == nullptr) {
+    list->head = info->next;
+  } else {
+    info->previous->next = info->next;
+  }
+  if (info->next == nullptr) {
+    list->tail = info->previous;
+  } else {
+    info->next->previous = info->previous;
+  }
+  if (list->head == nullptr) {
+    ready_priorities_ &= ~(1u << info->priority);
+  }
+  info->previous = nullptr;
+  info->next = nullptr;
+  info->ready = false;
+  --num_ready_streams_;
+}
+
+}  // namespace net
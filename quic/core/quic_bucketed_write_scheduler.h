@@ -0,0 +1,105 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_QUIC_CORE_QUIC_BUCKETED_WRITE_SCHEDULER_H_
+#define NET_QUIC_CORE_QUIC_BUCKETED_WRITE_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "base/macros.h"
+#include "net/quic/core/quic_packets.h"
+#include "net/quic/platform/api/quic_containers.h"
+#include "net/quic/platform/api/quic_export.h"
+#include "net/spdy/core/spdy_protocol.h"
+
+namespace net {
+
+// Schedules the writes of QUIC streams using SPDY priorities, with the same
+// ordering as PriorityWriteScheduler: streams of a higher priority are written
+// first, and streams of the same priority in the order they became ready.
+//
+// Ready streams are kept in one intrusive doubly linked list per priority, and
+// a bitmap records which of these lists are non-empty.  Marking a stream ready,
+// popping the next stream, changing the priority of a stream, removing it and
+// ShouldYield are all O(1), independently of the number of ready streams.
+class QUIC_EXPORT_PRIVATE QuicBucketedWriteScheduler {
+ public:
+  QuicBucketedWriteScheduler();
+  ~QuicBucketedWriteScheduler();
+
+  // Registers |stream_id| with |priority|.  The stream is not ready.
+  void RegisterStream(QuicStreamId stream_id, SpdyPriority priority);
+
+  // Unregisters |stream_id|, removing it from the ready streams.
+  void UnregisterStream(QuicStreamId stream_id);
+
+  bool StreamRegistered(QuicStreamId stream_id) const;
+
+  // Changes the priority of |stream_id|.  If it is ready, it moves to the back
+  // of the streams ready at |new_priority|.
+  void UpdateStreamPriority(QuicStreamId stream_id, SpdyPriority new_priority);
+
+  // Returns the priority of |stream_id|, or the lowest priority if it is not
+  // registered.
+  SpdyPriority GetStreamPriority(QuicStreamId stream_id) const;
+
+  // Marks |stream_id| ready to write, at the front of the streams of its
+  // priority if |add_to_front| and at the back otherwise.  Does nothing if the
+  // stream is already ready.
+  void MarkStreamReady(QuicStreamId stream_id, bool add_to_front);
+
+  // Removes |stream_id| from the ready streams, if it is ready.
+  void MarkStreamNotReady(QuicStreamId stream_id);
+
+  // Returns true if |stream_id| is ready to write.
+  bool IsStreamReady(QuicStreamId stream_id) const;
+
+  // Pops the next stream to write, and sets |priority| to its priority.  There
+  // must be at least one ready stream.
+  QuicStreamId PopNextReadyStream(SpdyPriority* priority);
+
+  // Returns true if a stream of a higher priority is ready, or if another
+  // stream of the same priority is ahead of |stream_id|.
+  bool ShouldYield(QuicStreamId stream_id) const;
+
+  bool HasReadyStreams() const { return num_ready_streams_ > 0; }
+
+  size_t NumReadyStreams() const { return num_ready_streams_; }
+
+ private:
+  struct StreamInfo {
+    QuicStreamId stream_id;
+    SpdyPriority priority;
+    bool ready;
+    // Neighbours in the ready list of |priority|, when |ready|.
+    StreamInfo* previous;
+    StreamInfo* next;
+  };
+
+  // Ready streams of a single priority.
+  struct ReadyList {
+    StreamInfo* head = nullptr;
+    StreamInfo* tail = nullptr;
+  };
+
+  // The elements of an unordered map are not moved on rehashing, which keeps
+  // the links of the ready lists valid.
+  typedef QuicUnorderedMap<QuicStreamId, StreamInfo> StreamInfoMap;
+
+  void Link(StreamInfo* info, bool add_to_front);
+  void Unlink(StreamInfo* info);
+
+  StreamInfoMap stream_infos_;
+  ReadyList ready_lists_[kV3LowestPriority + 1];
+  // Bit p is set iff ready_lists_[p] is not empty.
+  uint32_t ready_priorities_;
+  size_t num_ready_streams_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBucketedWriteScheduler);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_QUIC_BUCKETED_WRITE_SCHEDULER_H_
@@ -0,0 +1,169 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_bucketed_write_scheduler.h"
+
+#include "net/quic/platform/api/quic_test.h"
+#include "net/spdy/core/priority_write_scheduler.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class QuicBucketedWriteSchedulerTest : public QuicTest {
+ protected:
+  QuicStreamId PopNextReadyStream() {
+    SpdyPriority priority;
+    const QuicStreamId id = scheduler_.PopNextReadyStream(&priority);
+    EXPECT_EQ(scheduler_.GetStreamPriority(id), priority);
+    return id;
+  }
+
+  QuicBucketedWriteScheduler scheduler_;
+};
+
+TEST_F(QuicBucketedWriteSchedulerTest, PriorityOrder) {
+  scheduler_.RegisterStream(5, kV3LowestPriority);
+  scheduler_.RegisterStream(7, 3);
+  scheduler_.RegisterStream(9, kV3HighestPriority);
+  scheduler_.RegisterStream(11, 3);
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+
+  scheduler_.MarkStreamReady(5, false);
+  scheduler_.MarkStreamReady(7, false);
+  scheduler_.MarkStreamReady(9, false);
+  scheduler_.MarkStreamReady(11, false);
+  // Marking a ready stream ready again does nothing.
+  scheduler_.MarkStreamReady(7, true);
+  EXPECT_EQ(4u, scheduler_.NumReadyStreams());
+
+  EXPECT_EQ(9u, PopNextReadyStream());
+  EXPECT_EQ(7u, PopNextReadyStream());
+  EXPECT_EQ(11u, PopNextReadyStream());
+  EXPECT_EQ(5u, PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+  EXPECT_FALSE(scheduler_.IsStreamReady(5));
+}
+
+TEST_F(QuicBucketedWriteSchedulerTest, AddToFront) {
+  scheduler_.RegisterStream(5, 3);
+  scheduler_.RegisterStream(7, 3);
+  scheduler_.RegisterStream(9, 3);
+
+  scheduler_.MarkStreamReady(5, false);
+  scheduler_.MarkStreamReady(7, true);
+  scheduler_.MarkStreamReady(9, false);
+  EXPECT_EQ(7u, PopNextReadyStream());
+  EXPECT_EQ(5u, PopNextReadyStream());
+  EXPECT_EQ(9u, PopNextReadyStream());
+}
+
+TEST_F(QuicBucketedWriteSchedulerTest, ShouldYield) {
+  scheduler_.RegisterStream(5, 3);
+  scheduler_.RegisterStream(7, 3);
+  scheduler_.RegisterStream(9, 1);
+
+  // Nothing is ready.
+  EXPECT_FALSE(scheduler_.ShouldYield(5));
+  // A stream doesn't yield to itself.
+  scheduler_.MarkStreamReady(5, false);
+  EXPECT_FALSE(scheduler_.ShouldYield(5));
+  // Streams yield to the stream ahead of them at the same priority.
+  scheduler_.MarkStreamReady(7, false);
+  EXPECT_FALSE(scheduler_.ShouldYield(5));
+  EXPECT_TRUE(scheduler_.ShouldYield(7));
+  // Streams yield to a higher priority stream, but not to a lower one.
+  scheduler_.MarkStreamNotReady(5);
+  scheduler_.MarkStreamNotReady(7);
+  scheduler_.MarkStreamReady(9, false);
+  EXPECT_TRUE(scheduler_.ShouldYield(5));
+  EXPECT_FALSE(scheduler_.ShouldYield(9));
+  scheduler_.MarkStreamNotReady(9);
+  scheduler_.MarkStreamReady(5, false);
+  EXPECT_FALSE(scheduler_.ShouldYield(9));
+}
+
+TEST_F(QuicBucketedWriteSchedulerTest, UpdateStreamPriority) {
+  scheduler_.RegisterStream(5, 3);
+  scheduler_.RegisterStream(7, 3);
+  scheduler_.RegisterStream(9, 3);
+  scheduler_.MarkStreamReady(5, false);
+  scheduler_.MarkStreamReady(7, false);
+
+  // A ready stream moves to the back of its new priority.
+  scheduler_.UpdateStreamPriority(5, 3);
+  scheduler_.UpdateStreamPriority(7, 1);
+  EXPECT_EQ(1u, scheduler_.GetStreamPriority(7));
+  // A stream which is not ready only changes priority.
+  scheduler_.UpdateStreamPriority(9, 1);
+  EXPECT_FALSE(scheduler_.IsStreamReady(9));
+  scheduler_.MarkStreamReady(9, false);
+  EXPECT_EQ(3u, scheduler_.NumReadyStreams());
+
+  EXPECT_EQ(7u, PopNextReadyStream());
+  EXPECT_EQ(9u, PopNextReadyStream());
+  EXPECT_EQ(5u, PopNextReadyStream());
+}
+
+TEST_F(QuicBucketedWriteSchedulerTest, UnregisterStream) {
+  scheduler_.RegisterStream(5, 3);
+  scheduler_.RegisterStream(7, 3);
+  scheduler_.RegisterStream(9, 3);
+  scheduler_.MarkStreamReady(5, false);
+  scheduler_.MarkStreamReady(7, false);
+  scheduler_.MarkStreamReady(9, false);
+
+  scheduler_.UnregisterStream(7);
+  EXPECT_FALSE(scheduler_.StreamRegistered(7));
+  EXPECT_EQ(2u, scheduler_.NumReadyStreams());
+  scheduler_.UnregisterStream(5);
+  EXPECT_FALSE(scheduler_.ShouldYield(9));
+  EXPECT_EQ(9u, PopNextReadyStream());
+  EXPECT_FALSE(scheduler_.HasReadyStreams());
+}
+
+// Verifies that the scheduler makes the same decisions as
+// PriorityWriteScheduler under a random sequence of operations.
+TEST_F(QuicBucketedWriteSchedulerTest, MatchesPriorityWriteScheduler) {
+  const QuicStreamId kNumStreams = 50;
+  PriorityWriteScheduler<QuicStreamId> reference;
+  uint64_t seed = 1;
+  for (QuicStreamId id = 1; id <= kNumStreams; ++id) {
+    const SpdyPriority priority = id % (kV3LowestPriority + 1);
+    scheduler_.RegisterStream(id, priority);
+    reference.RegisterStream(id, SpdyStreamPrecedence(priority));
+  }
+
+  for (int i = 0; i < 10000; ++i) {
+    // Linear congruential generator, keeping the sequence deterministic.
+    seed = seed * UINT64_C(6364136223846793005) +
+           UINT64_C(1442695040888963407);
+    const uint64_t value = seed >> 32;
+    const QuicStreamId id = 1 + (value >> 8) % kNumStreams;
+    switch (value % 4) {
+      case 0:
+      case 1:
+        scheduler_.MarkStreamReady(id, (value >> 4) % 2 == 0);
+        reference.MarkStreamReady(id, (value >> 4) % 2 == 0);
+        break;
+      case 2: {
+        const SpdyPriority priority = (value >> 4) % (kV3LowestPriority + 1);
+        scheduler_.UpdateStreamPriority(id, priority);
+        reference.UpdateStreamPrecedence(id, SpdyStreamPrecedence(priority));
+        break;
+      }
+      case 3:
+        if (reference.HasReadyStreams()) {
+          EXPECT_EQ(reference.PopNextReadyStream(), PopNextReadyStream());
+        }
+        break;
+    }
+    ASSERT_EQ(reference.NumReadyStreams(), scheduler_.NumReadyStreams());
+    EXPECT_EQ(reference.ShouldYield(id), scheduler_.ShouldYield(id));
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
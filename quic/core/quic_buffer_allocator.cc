@@ -8,4 +8,8 @@ namespace net {
 
 QuicBufferAllocator::~QuicBufferAllocator() = default;
 
+bool QuicBufferAllocator::IsPooled() const {
+  return false;
+}
+
 }  // namespace net
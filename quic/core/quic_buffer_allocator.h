@@ -30,6 +30,12 @@ class QUIC_EXPORT_PRIVATE QuicBufferAllocator {
   // Marks the allocator as being idle. Serves as a hint to notify the allocator
   // that it should release any resources it's still holding on to.
   virtual void MarkAllocatorIdle() {}
+
+  // Returns true if buffers returned by New() come from a
+  // QuicPooledBufferAllocator, and so may be released with
+  // QuicPooledBufferAllocator::Release() even after this allocator has been
+  // destroyed.
+  virtual bool IsPooled() const;
 };
 
 }  // namespace net
@@ -4,21 +4,33 @@
 
 #include "net/quic/core/quic_buffered_packet_store.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_flags.h"
+#include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_map_util.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 
 namespace net {
 
 typedef QuicBufferedPacketStore::BufferedPacket BufferedPacket;
 typedef QuicBufferedPacketStore::BufferedPacketList BufferedPacketList;
 typedef QuicBufferedPacketStore::EnqueuePacketResult EnqueuePacketResult;
+typedef QuicBufferedPacketStore::PacketArenaBlock PacketArenaBlock;
 
 // Max number of connections this store can keep track.
 static const size_t kDefaultMaxConnectionsInStore = 100;
 // Up to half of the capacity can be used for storing non-CHLO packets.
 static const size_t kMaxConnectionsWithoutCHLO =
     kDefaultMaxConnectionsInStore / 2;
+// Max number of bytes of packets this store keeps, when limited.
+static const QuicByteCount kDefaultMaxBufferedBytes = 1024 * 1024;
+// A single client IP can use up to this fraction of the bytes of the store.
+static const QuicByteCount kMaxShareOfBufferedBytesPerClientIp = 8;
+// Size of the arena blocks packets are copied into.
+static const size_t kPacketArenaBlockSize = 4 * kMaxPacketSize;
 
 namespace {
 
@@ -40,6 +52,20 @@ class ConnectionExpireAlarm : public QuicAlarm::Delegate {
 
 }  // namespace
 
+PacketArenaBlock::PacketArenaBlock(size_t capacity)
+    : buffer_(new char[capacity]), capacity_(capacity), used_(0) {}
+
+PacketArenaBlock::~PacketArenaBlock() {}
+
+char* PacketArenaBlock::Allocate(size_t length) {
+  if (length > capacity_ - used_) {
+    return nullptr;
+  }
+  char* allocated = buffer_.get() + used_;
+  used_ += length;
+  return allocated;
+}
+
 BufferedPacket::BufferedPacket(std::unique_ptr<QuicReceivedPacket> packet,
                                QuicSocketAddress server_address,
                                QuicSocketAddress client_address)
@@ -71,7 +97,9 @@ QuicBufferedPacketStore::QuicBufferedPacketStore(
       visitor_(visitor),
       clock_(clock),
       expiration_alarm_(
-          alarm_factory->CreateAlarm(new ConnectionExpireAlarm(this))) {}
+          alarm_factory->CreateAlarm(new ConnectionExpireAlarm(this))),
+      buffered_bytes_(0),
+      max_buffered_bytes_(kDefaultMaxBufferedBytes) {}
 
 QuicBufferedPacketStore::~QuicBufferedPacketStore() {}
 
@@ -89,6 +117,12 @@ EnqueuePacketResult QuicBufferedPacketStore::EnqueuePacket(
   QUIC_BUG_IF(!is_chlo && !alpn.empty())
       << "Shouldn't have an ALPN defined for a non-CHLO packet.";
 
+  if (FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes &&
+      !HasRoomForPacket(connection_id, packet.length(), client_address.host(),
+                        is_chlo)) {
+    return TOO_MANY_BYTES;
+  }
+
   if (!QuicContainsKey(undecryptable_packets_, connection_id) &&
       ShouldBufferPacket(is_chlo)) {
     // Drop the packet if the upper limit of undecryptable packets has been
@@ -122,8 +156,14 @@ EnqueuePacketResult QuicBufferedPacketStore::EnqueuePacket(
     queue.creation_time = clock_->ApproximateNow();
   }
 
-  BufferedPacket new_entry(std::unique_ptr<QuicReceivedPacket>(packet.Clone()),
+  BufferedPacket new_entry =
+      FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes
+          ? CopyPacket(packet, server_address, client_address)
+          : BufferedPacket(std::unique_ptr<QuicReceivedPacket>(packet.Clone()),
                            server_address, client_address);
+  buffered_bytes_ += packet.length();
+  buffered_bytes_per_client_ip_[client_address.host().ToPackedString()] +=
+      packet.length();
   if (is_chlo) {
     // Add CHLO to the beginning of buffered packets so that it can be delivered
     // first later.
@@ -154,12 +194,17 @@ BufferedPacketList QuicBufferedPacketStore::DeliverPackets(
   if (it != undecryptable_packets_.end()) {
     packets_to_deliver = std::move(it->second);
     undecryptable_packets_.erase(connection_id);
+    OnPacketsRemoved(packets_to_deliver);
   }
   return packets_to_deliver;
 }
 
 void QuicBufferedPacketStore::DiscardPackets(QuicConnectionId connection_id) {
-  undecryptable_packets_.erase(connection_id);
+  auto it = undecryptable_packets_.find(connection_id);
+  if (it != undecryptable_packets_.end()) {
+    OnPacketsRemoved(it->second);
+    undecryptable_packets_.erase(it);
+  }
   connections_with_chlo_.erase(connection_id);
 }
 
@@ -171,6 +216,7 @@ void QuicBufferedPacketStore::OnExpirationTimeout() {
       break;
     }
     QuicConnectionId connection_id = entry.first;
+    OnPacketsRemoved(entry.second);
     visitor_->OnExpiredPackets(connection_id, std::move(entry.second));
     undecryptable_packets_.pop_front();
     connections_with_chlo_.erase(connection_id);
@@ -202,6 +248,83 @@ bool QuicBufferedPacketStore::ShouldBufferPacket(bool is_chlo) {
   return is_store_full || reach_non_chlo_limit;
 }
 
+bool QuicBufferedPacketStore::HasRoomForPacket(QuicConnectionId connection_id,
+                                               QuicByteCount bytes,
+                                               const QuicIpAddress& client_ip,
+                                               bool is_chlo) {
+  auto it = buffered_bytes_per_client_ip_.find(client_ip.ToPackedString());
+  const QuicByteCount client_ip_bytes =
+      it == buffered_bytes_per_client_ip_.end() ? 0 : it->second;
+  if (client_ip_bytes + bytes >
+      max_buffered_bytes_ / kMaxShareOfBufferedBytesPerClientIp) {
+    return false;
+  }
+  if (is_chlo) {
+    // A CHLO can open a connection, unlike packets buffered on connections
+    // which haven't received one, so it takes precedence over them.
+    while (buffered_bytes_ + bytes > max_buffered_bytes_ &&
+           EvictConnectionWithoutChlo(connection_id)) {
+    }
+  }
+  return buffered_bytes_ + bytes <= max_buffered_bytes_;
+}
+
+bool QuicBufferedPacketStore::EvictConnectionWithoutChlo(
+    QuicConnectionId connection_id) {
+  for (const auto& entry : undecryptable_packets_) {
+    if (entry.first != connection_id &&
+        !QuicContainsKey(connections_with_chlo_, entry.first)) {
+      QUIC_DLOG(INFO) << "Evicting packets buffered on connection "
+                      << entry.first << " to buffer a CHLO";
+      DiscardPackets(entry.first);
+      return true;
+    }
+  }
+  return false;
+}
+
+BufferedPacket QuicBufferedPacketStore::CopyPacket(
+    const QuicReceivedPacket& packet,
+    QuicSocketAddress server_address,
+    QuicSocketAddress client_address) {
+  char* buffer =
+      arena_block_ ? arena_block_->Allocate(packet.length()) : nullptr;
+  if (buffer == nullptr) {
+    arena_block_ = QuicReferenceCountedPointer<PacketArenaBlock>(
+        new PacketArenaBlock(std::max(kPacketArenaBlockSize, packet.length())));
+    buffer = arena_block_->Allocate(packet.length());
+  }
+  memcpy(buffer, packet.data(), packet.length());
+  BufferedPacket buffered_packet(
+      QuicMakeUnique<QuicReceivedPacket>(buffer, packet.length(),
+                                         packet.receipt_time(),
+                                         /*owns_buffer=*/false, packet.ttl(),
+                                         packet.ttl() >= 0),
+      server_address, client_address);
+  buffered_packet.arena_block = arena_block_;
+  return buffered_packet;
+}
+
+void QuicBufferedPacketStore::OnPacketsRemoved(
+    const BufferedPacketList& packets) {
+  for (const BufferedPacket& packet : packets.buffered_packets) {
+    const QuicByteCount bytes = packet.packet->length();
+    DCHECK_LE(bytes, buffered_bytes_);
+    buffered_bytes_ -= bytes;
+    auto it = buffered_bytes_per_client_ip_.find(
+        packet.client_address.host().ToPackedString());
+    DCHECK(it != buffered_bytes_per_client_ip_.end());
+    if (it == buffered_bytes_per_client_ip_.end()) {
+      continue;
+    }
+    DCHECK_LE(bytes, it->second);
+    it->second -= bytes;
+    if (it->second == 0) {
+      buffered_bytes_per_client_ip_.erase(it);
+    }
+  }
+}
+
 BufferedPacketList QuicBufferedPacketStore::DeliverPacketsForNextConnection(
     QuicConnectionId* connection_id) {
   if (connections_with_chlo_.empty()) {
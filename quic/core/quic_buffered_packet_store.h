@@ -6,6 +6,8 @@
 #define NET_QUIC_CORE_QUIC_BUFFERED_PACKET_STORE_H_
 
 #include <list>
+#include <memory>
+#include <string>
 
 #include "net/quic/core/quic_alarm.h"
 #include "net/quic/core/quic_alarm_factory.h"
@@ -14,6 +16,7 @@
 #include "net/quic/platform/api/quic_clock.h"
 #include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_export.h"
+#include "net/quic/platform/api/quic_reference_counted.h"
 #include "net/quic/platform/api/quic_socket_address.h"
 
 namespace net {
@@ -31,12 +34,41 @@ class QuicBufferedPacketStorePeer;
 // of connections: connections with CHLO buffered and those without CHLO. The
 // latter has its own upper limit along with the max number of connections this
 // store can hold. The former pool can grow till this store is full.
+//
+// When enabled, packets are copied into arena blocks shared by consecutively
+// buffered packets. The bytes buffered are also bounded, both in total and per
+// client IP, and a CHLO which doesn't fit evicts the oldest connections without
+// CHLO.
 class QUIC_EXPORT_PRIVATE QuicBufferedPacketStore {
  public:
   enum EnqueuePacketResult {
     SUCCESS = 0,
     TOO_MANY_PACKETS,  // Too many packets stored up for a certain connection.
-    TOO_MANY_CONNECTIONS  // Too many connections stored up in the store.
+    TOO_MANY_CONNECTIONS,  // Too many connections stored up in the store.
+    // Too many bytes stored up in the store, or from the client IP.
+    TOO_MANY_BYTES
+  };
+
+  // A block of memory holding the data of buffered packets. It is freed once
+  // all the packets stored in it are gone.
+  class QUIC_EXPORT_PRIVATE PacketArenaBlock : public QuicReferenceCounted {
+   public:
+    explicit PacketArenaBlock(size_t capacity);
+
+    PacketArenaBlock(const PacketArenaBlock&) = delete;
+    PacketArenaBlock& operator=(const PacketArenaBlock&) = delete;
+
+    // Returns |length| bytes of the block, or nullptr if there is not enough
+    // room left.
+    char* Allocate(size_t length);
+
+   protected:
+    ~PacketArenaBlock() override;
+
+   private:
+    std::unique_ptr<char[]> buffer_;
+    const size_t capacity_;
+    size_t used_;
   };
 
   // A packets with client/server address.
@@ -53,6 +85,8 @@ class QUIC_EXPORT_PRIVATE QuicBufferedPacketStore {
     std::unique_ptr<QuicReceivedPacket> packet;
     QuicSocketAddress server_address;
     QuicSocketAddress client_address;
+    // The block holding the data of |packet|, if it doesn't own its data.
+    QuicReferenceCountedPointer<PacketArenaBlock> arena_block;
   };
 
   // A queue of BufferedPackets for a connection.
@@ -132,6 +166,17 @@ class QUIC_EXPORT_PRIVATE QuicBufferedPacketStore {
   // Is there any CHLO buffered in the store?
   bool HasChlosBuffered() const;
 
+  // Returns the number of connections whose CHLO is buffered.
+  size_t NumChlosBuffered() const { return connections_with_chlo_.size(); }
+
+  // Sets the max number of bytes of packets the store buffers.
+  void set_max_buffered_bytes(QuicByteCount max_buffered_bytes) {
+    max_buffered_bytes_ = max_buffered_bytes;
+  }
+
+  // Number of bytes of packets currently buffered.
+  QuicByteCount buffered_bytes() const { return buffered_bytes_; }
+
  private:
   friend class test::QuicBufferedPacketStorePeer;
 
@@ -142,6 +187,26 @@ class QUIC_EXPORT_PRIVATE QuicBufferedPacketStore {
   // limit. The limit for non-CHLO packet and CHLO packet is different.
   bool ShouldBufferPacket(bool is_chlo);
 
+  // Returns true if |bytes| from |client_ip| fit in the memory budget of the
+  // store. For a CHLO, evicts connections without CHLO other than
+  // |connection_id| to make room.
+  bool HasRoomForPacket(QuicConnectionId connection_id,
+                        QuicByteCount bytes,
+                        const QuicIpAddress& client_ip,
+                        bool is_chlo);
+
+  // Discards the oldest connection without CHLO other than |connection_id|.
+  // Returns false if there is none.
+  bool EvictConnectionWithoutChlo(QuicConnectionId connection_id);
+
+  // Copies |packet| into the current arena block.
+  BufferedPacket CopyPacket(const QuicReceivedPacket& packet,
+                            QuicSocketAddress server_address,
+                            QuicSocketAddress client_address);
+
+  // Updates the byte counts for |packets| leaving the store.
+  void OnPacketsRemoved(const BufferedPacketList& packets);
+
   // A map to store packet queues with creation time for each connection.
   BufferedPacketMap undecryptable_packets_;
 
@@ -159,6 +224,14 @@ class QUIC_EXPORT_PRIVATE QuicBufferedPacketStore {
   // Keeps track of connection with CHLO buffered up already and the order they
   // arrive.
   QuicLinkedHashMap<QuicConnectionId, bool> connections_with_chlo_;
+
+  // Bytes of packets buffered, in total and per packed client IP.
+  QuicByteCount buffered_bytes_;
+  QuicUnorderedMap<std::string, QuicByteCount> buffered_bytes_per_client_ip_;
+  QuicByteCount max_buffered_bytes_;
+
+  // The block newly buffered packets are copied into.
+  QuicReferenceCountedPointer<PacketArenaBlock> arena_block_;
 };
 
 }  // namespace net
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "net/quic/platform/api/quic_flags.h"
+#include "net/quic/platform/api/quic_str_cat.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/test_tools/mock_clock.h"
 #include "net/quic/test_tools/quic_buffered_packet_store_peer.h"
@@ -420,6 +421,121 @@ TEST_F(QuicBufferedPacketStoreTest, DiscardPacketsEmpty) {
   EXPECT_FALSE(store_.HasChlosBuffered());
 }
 
+TEST_F(QuicBufferedPacketStoreTest, BufferedBytes) {
+  FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes = true;
+  const QuicByteCount kPacketLength = packet_content_.size();
+  store_.EnqueuePacket(/*connection_id=*/1, packet_, server_address_,
+                       client_address_, false, "");
+  store_.EnqueuePacket(/*connection_id=*/1, packet_, server_address_,
+                       client_address_, true, "");
+  store_.EnqueuePacket(/*connection_id=*/2, packet_, server_address_,
+                       client_address_, false, "");
+  store_.EnqueuePacket(/*connection_id=*/3, packet_, server_address_,
+                       client_address_, false, "");
+  EXPECT_EQ(4 * kPacketLength, store_.buffered_bytes());
+
+  QuicConnectionId delivered_conn_id;
+  BufferedPacketList packets =
+      store_.DeliverPacketsForNextConnection(&delivered_conn_id);
+  EXPECT_EQ(2 * kPacketLength, store_.buffered_bytes());
+  store_.DiscardPackets(/*connection_id=*/2);
+  EXPECT_EQ(kPacketLength, store_.buffered_bytes());
+
+  // The packets share an arena block, which outlives the store entries.
+  store_.EnqueuePacket(/*connection_id=*/4, packet_, server_address_,
+                       client_address_, false, "");
+  EXPECT_EQ(packets.buffered_packets.front().arena_block,
+            packets.buffered_packets.back().arena_block);
+  for (const BufferedPacket& packet : packets.buffered_packets) {
+    EXPECT_EQ(packet_content_, packet.packet->AsStringPiece());
+    EXPECT_EQ(packet_time_, packet.packet->receipt_time());
+  }
+
+  clock_.AdvanceTime(
+      QuicBufferedPacketStorePeer::expiration_alarm(&store_)->deadline() -
+      clock_.ApproximateNow());
+  alarm_factory_.FireAlarm(
+      QuicBufferedPacketStorePeer::expiration_alarm(&store_));
+  EXPECT_EQ(0u, store_.buffered_bytes());
+}
+
+TEST_F(QuicBufferedPacketStoreTest, NoArenaWhenNotLimited) {
+  FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes = false;
+  store_.EnqueuePacket(/*connection_id=*/1, packet_, server_address_,
+                       client_address_, false, "");
+  store_.EnqueuePacket(/*connection_id=*/1, packet_, server_address_,
+                       client_address_, true, "");
+
+  QuicConnectionId delivered_conn_id;
+  BufferedPacketList packets =
+      store_.DeliverPacketsForNextConnection(&delivered_conn_id);
+  ASSERT_EQ(2u, packets.buffered_packets.size());
+  for (const BufferedPacket& packet : packets.buffered_packets) {
+    EXPECT_EQ(nullptr, packet.arena_block.get());
+    EXPECT_EQ(packet_content_, packet.packet->AsStringPiece());
+  }
+}
+
+TEST_F(QuicBufferedPacketStoreTest, TooManyBytes) {
+  FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes = true;
+  const QuicByteCount kPacketLength = packet_content_.size();
+  // Each client IP can buffer up to 2 packets.
+  store_.set_max_buffered_bytes(16 * kPacketLength);
+
+  QuicSocketAddress another_client_address(QuicIpAddress::Loopback4(), 255);
+  EXPECT_EQ(EnqueuePacketResult::SUCCESS,
+            store_.EnqueuePacket(/*connection_id=*/1, packet_, server_address_,
+                                 client_address_, false, ""));
+  EXPECT_EQ(EnqueuePacketResult::SUCCESS,
+            store_.EnqueuePacket(/*connection_id=*/2, packet_, server_address_,
+                                 client_address_, false, ""));
+  EXPECT_EQ(EnqueuePacketResult::TOO_MANY_BYTES,
+            store_.EnqueuePacket(/*connection_id=*/3, packet_, server_address_,
+                                 client_address_, true, ""));
+  EXPECT_FALSE(store_.HasBufferedPackets(/*connection_id=*/3));
+  // Other client IPs are not affected.
+  EXPECT_EQ(EnqueuePacketResult::SUCCESS,
+            store_.EnqueuePacket(/*connection_id=*/3, packet_, server_address_,
+                                 another_client_address, true, ""));
+
+  // Delivering packets makes room for the client IP again.
+  store_.DeliverPackets(/*connection_id=*/1);
+  EXPECT_EQ(EnqueuePacketResult::SUCCESS,
+            store_.EnqueuePacket(/*connection_id=*/4, packet_, server_address_,
+                                 client_address_, false, ""));
+}
+
+TEST_F(QuicBufferedPacketStoreTest, ChloEvictsConnectionsWithoutChlo) {
+  FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes = true;
+  const QuicByteCount kPacketLength = packet_content_.size();
+  // The store holds 24 packets, from different client IPs.
+  store_.set_max_buffered_bytes(24 * kPacketLength);
+  for (int i = 1; i <= 24; ++i) {
+    QuicIpAddress client_ip;
+    ASSERT_TRUE(client_ip.FromString(QuicStrCat("10.0.0.", i)));
+    store_.EnqueuePacket(/*connection_id=*/i, packet_, server_address_,
+                         QuicSocketAddress(client_ip, 443), i == 2, "");
+  }
+  EXPECT_EQ(24 * kPacketLength, store_.buffered_bytes());
+
+  // Packets on connections without CHLO are dropped once the store is full.
+  QuicIpAddress client_ip;
+  ASSERT_TRUE(client_ip.FromString("10.0.1.1"));
+  EXPECT_EQ(EnqueuePacketResult::TOO_MANY_BYTES,
+            store_.EnqueuePacket(/*connection_id=*/25, packet_,
+                                 server_address_,
+                                 QuicSocketAddress(client_ip, 443), false, ""));
+  // But a CHLO evicts the oldest connection without CHLO.
+  EXPECT_EQ(EnqueuePacketResult::SUCCESS,
+            store_.EnqueuePacket(/*connection_id=*/25, packet_,
+                                 server_address_,
+                                 QuicSocketAddress(client_ip, 443), true, ""));
+  EXPECT_FALSE(store_.HasBufferedPackets(/*connection_id=*/1));
+  EXPECT_TRUE(store_.HasBufferedPackets(/*connection_id=*/2));
+  EXPECT_TRUE(store_.HasBufferedPackets(/*connection_id=*/3));
+  EXPECT_EQ(24 * kPacketLength, store_.buffered_bytes());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
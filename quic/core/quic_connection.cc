@@ -63,6 +63,9 @@ const QuicPacketCount kDefaultRetransmittablePacketsBeforeAck = 2;
 const QuicPacketCount kMinReceivedBeforeAckDecimation = 100;
 // Wait for up to 10 retransmittable packets before sending an ack.
 const QuicPacketCount kMaxRetransmittablePacketsBeforeAck = 10;
+// Upper bound on the number of retransmittable packets to wait for before
+// sending an ack when adapting ack decimation to the receive rate.
+const QuicPacketCount kMaxAdaptiveRetransmittablePacketsBeforeAck = 64;
 // One quarter RTT delay when doing ack decimation.
 const float kAckDecimationDelay = 0.25;
 // One eighth RTT delay when doing ack decimation.
@@ -222,8 +225,12 @@ QuicConnection::QuicConnection(
       ack_mode_(TCP_ACKING),
       ack_decimation_delay_(kAckDecimationDelay),
       unlimited_ack_decimation_(false),
+      adaptive_ack_decimation_(false),
+      max_retransmittable_packets_before_ack_(
+          kMaxRetransmittablePacketsBeforeAck),
       delay_setting_retransmission_alarm_(false),
       pending_retransmission_alarm_(false),
+      batching_alarm_updates_(false),
       defer_send_in_response_to_packets_(false),
       ping_timeout_(QuicTime::Delta::FromSeconds(kPingTimeoutSecs)),
       arena_(),
@@ -266,6 +273,8 @@ QuicConnection::QuicConnection(
       can_truncate_connection_ids_(perspective == Perspective::IS_SERVER),
       mtu_discovery_target_(0),
       mtu_probe_count_(0),
+      last_mtu_probe_size_(0),
+      smallest_failed_mtu_probe_size_(0),
       packets_between_mtu_probes_(kPacketsBetweenMtuProbesBase),
       next_mtu_probe_at_(kPacketsBetweenMtuProbesBase),
       largest_received_packet_size_(0),
@@ -304,7 +313,7 @@ void QuicConnection::ClearQueuedPackets() {
        it != queued_packets_.end(); ++it) {
     // Delete the buffer before calling ClearSerializedPacket, which sets
     // encrypted_buffer to nullptr.
-    delete[] it->encrypted_buffer;
+    helper_->GetStreamSendBufferAllocator()->Delete(it->encrypted_buffer);
     ClearSerializedPacket(&(*it));
   }
   queued_packets_.clear();
@@ -358,6 +367,9 @@ void QuicConnection::SetFromConfig(const QuicConfig& config) {
   if (config.HasClientSentConnectionOption(kAKDU, perspective_)) {
     unlimited_ack_decimation_ = true;
   }
+  if (config.HasClientSentConnectionOption(kAKDA, perspective_)) {
+    adaptive_ack_decimation_ = true;
+  }
   if (config.HasClientSentConnectionOption(k5RTO, perspective_)) {
     close_connection_after_five_rtos_ = true;
   }
@@ -1075,16 +1087,29 @@ void QuicConnection::MaybeQueueAck(bool was_missing) {
                       last_ack_had_missing_packets_)) {
     ack_queued_ = true;
   }
+  // Reordering or loss means the peer needs feedback sooner.
+  if (was_missing) {
+    max_retransmittable_packets_before_ack_ =
+        kMaxRetransmittablePacketsBeforeAck;
+  }
 
   if (should_last_packet_instigate_acks_ && !ack_queued_) {
     ++num_retransmittable_packets_received_since_last_ack_sent_;
     if (ack_mode_ != TCP_ACKING &&
         last_header_.packet_number > kMinReceivedBeforeAckDecimation) {
-      // Ack up to 10 packets at once unless ack decimation is unlimited.
+      // Ack up to 10 packets at once unless ack decimation is unlimited or
+      // adaptive.
       if (!unlimited_ack_decimation_ &&
           num_retransmittable_packets_received_since_last_ack_sent_ >=
-              kMaxRetransmittablePacketsBeforeAck) {
+              max_retransmittable_packets_before_ack_) {
         ack_queued_ = true;
+        // The packets arrived faster than the ack delay, so wait for more
+        // of them before the next ack.
+        if (adaptive_ack_decimation_) {
+          max_retransmittable_packets_before_ack_ =
+              std::min(2 * max_retransmittable_packets_before_ack_,
+                       kMaxAdaptiveRetransmittablePacketsBeforeAck);
+        }
       } else if (!ack_alarm_->IsSet()) {
         // Wait for the minimum of the ack decimation delay or the delayed ack
         // time before sending an ack.
@@ -1105,6 +1130,8 @@ void QuicConnection::MaybeQueueAck(bool was_missing) {
 
     // If there are new missing packets to report, send an ack immediately.
     if (received_packet_manager_.HasNewMissingPackets()) {
+      max_retransmittable_packets_before_ack_ =
+          kMaxRetransmittablePacketsBeforeAck;
       if (ack_mode_ == ACK_DECIMATION_WITH_REORDERING) {
         // Wait the minimum of an eighth min_rtt and the existing ack time.
         QuicTime ack_time =
@@ -1200,6 +1227,7 @@ QuicConsumedData QuicConnection::SendStreamData(QuicStreamId id,
   // which decrypter will be used on an ack packet following a handshake
   // packet (a handshake packet from client to server could result in a REJ or a
   // SHLO from the server, leading to two different decrypters at the server.)
+  ScopedAlarmUpdateBatcher alarm_batcher(this);
   ScopedRetransmissionScheduler alarm_delayer(this);
   ScopedPacketFlusher flusher(this, SEND_ACK_IF_PENDING);
   return packet_generator_.ConsumeData(id, write_length, offset, state);
@@ -1241,7 +1269,8 @@ void QuicConnection::SendRstStream(QuicStreamId id,
       ++packet_iterator;
       continue;
     }
-    delete[] packet_iterator->encrypted_buffer;
+    helper_->GetStreamSendBufferAllocator()->Delete(
+        packet_iterator->encrypted_buffer);
     ClearSerializedPacket(&(*packet_iterator));
     packet_iterator = queued_packets_.erase(packet_iterator);
   }
@@ -1325,6 +1354,7 @@ void QuicConnection::ProcessUdpPacket(const QuicSocketAddress& self_address,
   QUIC_DVLOG(1) << ENDPOINT << "time of last received packet: "
                 << time_of_last_received_packet_.ToDebuggingValue();
 
+  ScopedAlarmUpdateBatcher alarm_batcher(this);
   ScopedRetransmissionScheduler alarm_delayer(this);
   if (!framer_.ProcessPacket(packet)) {
     // If we are unable to decrypt this packet, it might be
@@ -1373,6 +1403,7 @@ void QuicConnection::OnCanWrite() {
   // we had queued and we're still not blocked, let the visitor know it can
   // write more.
   if (!CanWrite(HAS_RETRANSMITTABLE_DATA)) {
+    FlushPacketWriter();
     return;
   }
 
@@ -1391,6 +1422,7 @@ void QuicConnection::OnCanWrite() {
     // other connections and events have had a chance to use the thread.
     resume_writes_alarm_->Set(clock_->ApproximateNow());
   }
+  FlushPacketWriter();
 }
 
 void QuicConnection::WriteIfNotBlocked() {
@@ -1532,7 +1564,8 @@ void QuicConnection::WriteQueuedPackets() {
   QueuedPacketList::iterator packet_iterator = queued_packets_.begin();
   while (packet_iterator != queued_packets_.end() &&
          WritePacket(&(*packet_iterator))) {
-    delete[] packet_iterator->encrypted_buffer;
+    helper_->GetStreamSendBufferAllocator()->Delete(
+        packet_iterator->encrypted_buffer);
     ClearSerializedPacket(&(*packet_iterator));
     packet_iterator = queued_packets_.erase(packet_iterator);
   }
@@ -1775,6 +1808,13 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
       sent_packet_manager_.GetLeastUnacked(),
       sent_packet_manager_.EstimateMaxPacketsInFlight(max_packet_length()));
 
+  // Termination packets must not linger in a batch mode writer, since the
+  // connection may be torn down before the end of the write loop.  The
+  // connection is closing anyway, so the result of the flush is ignored.
+  if (is_termination_packet && writer_->IsBatchMode()) {
+    writer_->Flush();
+  }
+
   stats_.bytes_sent += result.bytes_written;
   ++stats_.packets_sent;
   if (packet->transmission_type != NOT_RETRANSMISSION) {
@@ -1785,6 +1825,20 @@ bool QuicConnection::WritePacket(SerializedPacket* packet) {
   return true;
 }
 
+void QuicConnection::FlushPacketWriter() {
+  if (!writer_->IsBatchMode()) {
+    return;
+  }
+  WriteResult result = writer_->Flush();
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    visitor_->OnWriteBlocked();
+    return;
+  }
+  if (result.status == WRITE_STATUS_ERROR) {
+    OnWriteError(result.error_code);
+  }
+}
+
 bool QuicConnection::ShouldDiscardPacket(const SerializedPacket& packet) {
   if (!connected_) {
     QUIC_DLOG(INFO) << ENDPOINT
@@ -1856,6 +1910,10 @@ void QuicConnection::OnSerializedPacket(SerializedPacket* serialized_packet) {
   SendOrQueuePacket(serialized_packet);
 }
 
+char* QuicConnection::GetPacketBuffer() {
+  return writer_->GetNextWriteLocation(self_address().host(), peer_address());
+}
+
 void QuicConnection::OnUnrecoverableError(QuicErrorCode error,
                                           const string& error_details,
                                           ConnectionCloseSource source) {
@@ -1909,7 +1967,8 @@ void QuicConnection::SendOrQueuePacket(SerializedPacket* packet) {
   // it's written in sequence number order.
   if (!queued_packets_.empty() || !WritePacket(packet)) {
     // Take ownership of the underlying encrypted packet.
-    packet->encrypted_buffer = CopyBuffer(*packet);
+    packet->encrypted_buffer =
+        CopyBuffer(*packet, helper_->GetStreamSendBufferAllocator());
     queued_packets_.push_back(*packet);
     packet->retransmittable_frames.clear();
   }
@@ -1935,6 +1994,15 @@ void QuicConnection::SendPing() {
 }
 
 void QuicConnection::SendAck() {
+  // Fewer than half as many packets as the limit arrived since the last ack,
+  // so the rate dropped: move the limit back toward the default.
+  if (adaptive_ack_decimation_ &&
+      num_retransmittable_packets_received_since_last_ack_sent_ <
+          max_retransmittable_packets_before_ack_ / 2) {
+    max_retransmittable_packets_before_ack_ =
+        std::max(max_retransmittable_packets_before_ack_ / 2,
+                 kMaxRetransmittablePacketsBeforeAck);
+  }
   ack_alarm_->Cancel();
   ack_queued_ = false;
   stop_waiting_count_ = 0;
@@ -2389,6 +2457,7 @@ QuicConnection::ScopedPacketFlusher::~ScopedPacketFlusher() {
 
   if (flush_on_delete_) {
     connection_->packet_generator_.Flush();
+    connection_->FlushPacketWriter();
 
     // Once all transmissions are done, check if there is any outstanding data
     // to send and notify the congestion controller if not.
@@ -2433,6 +2502,31 @@ QuicConnection::ScopedRetransmissionScheduler::
   }
 }
 
+QuicConnection::ScopedAlarmUpdateBatcher::ScopedAlarmUpdateBatcher(
+    QuicConnection* connection)
+    : connection_(connection),
+      batching_(FLAGS_quic_reloadable_flag_quic_batch_alarm_updates &&
+                !connection_->batching_alarm_updates_) {
+  if (!batching_) {
+    return;
+  }
+  connection_->batching_alarm_updates_ = true;
+  connection_->ack_alarm_->DeferUpdates();
+  connection_->retransmission_alarm_->DeferUpdates();
+  connection_->send_alarm_->DeferUpdates();
+}
+
+QuicConnection::ScopedAlarmUpdateBatcher::~ScopedAlarmUpdateBatcher() {
+  if (!batching_) {
+    return;
+  }
+  connection_->batching_alarm_updates_ = false;
+  connection_->stats_.alarm_updates_coalesced +=
+      connection_->ack_alarm_->FlushDeferredUpdates() +
+      connection_->retransmission_alarm_->FlushDeferredUpdates() +
+      connection_->send_alarm_->FlushDeferredUpdates();
+}
+
 HasRetransmittableData QuicConnection::IsRetransmittable(
     const SerializedPacket& packet) {
   // Retransmitted packets retransmittable frames are owned by the unacked
@@ -2538,6 +2632,24 @@ void QuicConnection::DiscoverMtu() {
     return;
   }
 
+  // The previous probe was lost if the MTU did not grow to its size. Search
+  // between the current MTU, which is known to work, and the failed size.
+  if (last_mtu_probe_size_ > max_packet_length() &&
+      (smallest_failed_mtu_probe_size_ == 0 ||
+       last_mtu_probe_size_ < smallest_failed_mtu_probe_size_)) {
+    smallest_failed_mtu_probe_size_ = last_mtu_probe_size_;
+  }
+  QuicByteCount probe_size = mtu_discovery_target_;
+  if (smallest_failed_mtu_probe_size_ > max_packet_length()) {
+    probe_size = max_packet_length() +
+                 (smallest_failed_mtu_probe_size_ - max_packet_length()) / 2;
+  }
+  if (probe_size <= max_packet_length()) {
+    // There is nothing left to search.
+    mtu_discovery_target_ = 0;
+    return;
+  }
+
   // Calculate the packet number of the next probe *before* sending the current
   // one.  Otherwise, when SendMtuDiscoveryPacket() is called,
   // MaybeSetMtuAlarm() will not realize that the probe has been just sent, and
@@ -2547,8 +2659,10 @@ void QuicConnection::DiscoverMtu() {
                        packets_between_mtu_probes_ + 1;
   ++mtu_probe_count_;
 
-  QUIC_DVLOG(2) << "Sending a path MTU discovery packet #" << mtu_probe_count_;
-  SendMtuDiscoveryPacket(mtu_discovery_target_);
+  QUIC_DVLOG(2) << "Sending a path MTU discovery packet #" << mtu_probe_count_
+                << " of size " << probe_size;
+  last_mtu_probe_size_ = probe_size;
+  SendMtuDiscoveryPacket(probe_size);
 
   DCHECK(!mtu_discovery_alarm_->IsSet());
 }
@@ -482,6 +482,7 @@ class QUIC_EXPORT_PRIVATE QuicConnection
 
   // QuicPacketCreator::DelegateInterface
   void OnSerializedPacket(SerializedPacket* packet) override;
+  char* GetPacketBuffer() override;
 
   // QuicSentPacketManager::NetworkChangeVisitor
   void OnCongestionChange() override;
@@ -663,6 +664,22 @@ class QUIC_EXPORT_PRIVATE QuicConnection
     const bool already_delayed_;
   };
 
+  // Coalesces the updates of the ack, send and retransmission alarms made
+  // within its scope, so that each of them is scheduled at most once, for its
+  // final deadline, when the scope is exited. When nested, only the outermost
+  // batcher has an effect.
+  class QUIC_EXPORT_PRIVATE ScopedAlarmUpdateBatcher {
+   public:
+    explicit ScopedAlarmUpdateBatcher(QuicConnection* connection);
+    ~ScopedAlarmUpdateBatcher();
+
+   private:
+    QuicConnection* connection_;
+    // True if this batcher is deferring the alarm updates, false if batching
+    // is disabled or an outer batcher is already deferring them.
+    const bool batching_;
+  };
+
   QuicPacketWriter* writer() { return writer_; }
   const QuicPacketWriter* writer() const { return writer_; }
 
@@ -679,8 +696,10 @@ class QUIC_EXPORT_PRIVATE QuicConnection
       QuicPacketWriter* probing_writer,
       const QuicSocketAddress& peer_address);
 
-  // Sends an MTU discovery packet of size |mtu_discovery_target_| and updates
-  // the MTU discovery alarm.
+  // Sends an MTU discovery packet and updates the MTU discovery alarm. The
+  // first probe is of size |mtu_discovery_target_|. If a probe is not
+  // acknowledged by the time of the next one, the next one is of the size
+  // halfway between max_packet_length() and the smallest failed size.
   void DiscoverMtu();
 
   // Sets the stream notifer on the SentPacketManager.
@@ -811,6 +830,10 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // writer is write blocked.
   bool WritePacket(SerializedPacket* packet);
 
+  // Sends any packets held by a batch mode writer.  Called at the end of each
+  // write loop.  Does nothing if the writer is not in batch mode.
+  void FlushPacketWriter();
+
   // Make sure an ack we got from our peer is sane.
   // Returns nullptr for valid acks or an error string if it was invalid.
   const char* ValidateAckFrame(const QuicAckFrame& incoming_ack);
@@ -1015,6 +1038,14 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // When true, removes ack decimation's max number of packets(10) before
   // sending an ack.
   bool unlimited_ack_decimation_;
+  // When true, doubles ack decimation's max number of packets before sending
+  // an ack each time that many arrive within the ack delay, halves it when
+  // fewer than half that many arrive before an ack, and resets it when
+  // packets are missing.
+  bool adaptive_ack_decimation_;
+  // The number of retransmittable packets to receive before sending an ack
+  // when doing ack decimation.
+  QuicPacketCount max_retransmittable_packets_before_ack_;
 
   // Indicates the retransmit alarm is going to be set by the
   // ScopedRetransmitAlarmDelayer
@@ -1022,6 +1053,9 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // Indicates the retransmission alarm needs to be set.
   bool pending_retransmission_alarm_;
 
+  // True while a ScopedAlarmUpdateBatcher defers the alarm updates.
+  bool batching_alarm_updates_;
+
   // If true, defer sending data in response to received packets to the
   // SendAlarm.
   bool defer_send_in_response_to_packets_;
@@ -1121,6 +1155,14 @@ class QUIC_EXPORT_PRIVATE QuicConnection
   // The number of MTU probes already sent.
   size_t mtu_probe_count_;
 
+  // The size of the last MTU probe sent, or 0 if none has been sent.
+  QuicByteCount last_mtu_probe_size_;
+
+  // The smallest MTU probe size which was not acknowledged, or 0 if every
+  // probe so far has been. Later probes search between max_packet_length()
+  // and this size.
+  QuicByteCount smallest_failed_mtu_probe_size_;
+
   // The number of packets between MTU probes.
   QuicPacketCount packets_between_mtu_probes_;
 
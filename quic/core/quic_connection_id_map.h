@@ -0,0 +1,413 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_QUIC_CORE_QUIC_CONNECTION_ID_MAP_H_
+#define NET_QUIC_CORE_QUIC_CONNECTION_ID_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "base/bits.h"
+#include "base/macros.h"
+#include "base/sys_byteorder.h"
+#include "net/quic/core/crypto/quic_random.h"
+#include "net/quic/core/quic_types.h"
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_optional.h"
+
+namespace net {
+
+// A map keyed by QuicConnectionId, for the maps the dispatcher and the time
+// wait list probe for every received packet.
+//
+// The entries are stored contiguously, in insertion order, and they are
+// indexed by a flat open-addressing table.  Each slot of the table has a
+// control byte, which holds 7 bits of the hash of the key of the slot, and the
+// control bytes of a group of 8 slots are compared to the hash of the key
+// looked up all at once, with a few 64-bit operations.  A lookup thus usually
+// reads the cache line of a single group and that of the matching entry,
+// where a node-based map chases a pointer for every node of the bucket and
+// allocates every entry separately.
+//
+// The hash is keyed with a random seed, so that peers can't choose connection
+// IDs which collide in the table.
+//
+// Iterating the map visits entries in insertion order, as QuicLinkedHashMap
+// does.  Erasing an entry doesn't invalidate the iterators to other entries,
+// but inserting one may invalidate all of them.
+template <typename Value>
+class QuicConnectionIdMap {
+ private:
+  template <typename MapType, typename EntryType>
+  class Iterator;
+
+ public:
+  typedef QuicConnectionId key_type;
+  typedef Value mapped_type;
+  typedef std::pair<const QuicConnectionId, Value> value_type;
+  typedef Iterator<QuicConnectionIdMap, value_type> iterator;
+  typedef Iterator<const QuicConnectionIdMap, const value_type> const_iterator;
+
+  QuicConnectionIdMap()
+      : QuicConnectionIdMap(QuicRandom::GetInstance()->RandUint64()) {}
+
+  explicit QuicConnectionIdMap(uint64_t seed)
+      : seed_(seed),
+        size_(0),
+        num_tombstones_(0),
+        first_entry_(0),
+        capacity_(0) {}
+
+  ~QuicConnectionIdMap() {}
+
+  iterator begin() { return iterator(this, first_entry_); }
+  iterator end() { return iterator(this, entries_.size()); }
+  const_iterator begin() const { return const_iterator(this, first_entry_); }
+  const_iterator end() const { return const_iterator(this, entries_.size()); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  iterator find(QuicConnectionId connection_id) {
+    return iterator(this, FindEntry(connection_id));
+  }
+
+  const_iterator find(QuicConnectionId connection_id) const {
+    return const_iterator(this, FindEntry(connection_id));
+  }
+
+  size_t count(QuicConnectionId connection_id) const {
+    return FindEntry(connection_id) == entries_.size() ? 0 : 1;
+  }
+
+  // Inserts |value| at the end of the map, unless its key is already present.
+  std::pair<iterator, bool> insert(value_type&& value) {
+    size_t entry = FindEntry(value.first);
+    if (entry != entries_.size()) {
+      return std::make_pair(iterator(this, entry), false);
+    }
+    return std::make_pair(iterator(this, Insert(std::move(value))), true);
+  }
+
+  std::pair<iterator, bool> emplace(value_type&& value) {
+    return insert(std::move(value));
+  }
+
+  void erase(iterator it) {
+    DCHECK(it != end());
+    Erase(it.index_);
+  }
+
+  size_t erase(QuicConnectionId connection_id) {
+    size_t entry = FindEntry(connection_id);
+    if (entry == entries_.size()) {
+      return 0;
+    }
+    Erase(entry);
+    return 1;
+  }
+
+  void clear() {
+    entries_.clear();
+    for (Group& group : groups_) {
+      memset(group.control, kEmpty, sizeof(group.control));
+    }
+    size_ = 0;
+    num_tombstones_ = 0;
+    first_entry_ = 0;
+  }
+
+ private:
+  // Iterates the live entries of a map in insertion order.
+  template <typename MapType, typename EntryType>
+  class Iterator {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef EntryType value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef EntryType* pointer;
+    typedef EntryType& reference;
+
+    Iterator() : map_(nullptr), index_(0) {}
+
+    // Allows converting an iterator to a const_iterator.
+    template <typename OtherMapType, typename OtherEntryType>
+    Iterator(const Iterator<OtherMapType, OtherEntryType>& other)
+        : map_(other.map_), index_(other.index_) {}
+
+    EntryType& operator*() const { return *map_->entries_[index_]; }
+    EntryType* operator->() const { return &*map_->entries_[index_]; }
+
+    Iterator& operator++() {
+      index_ = map_->NextEntry(index_ + 1);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    template <typename OtherMapType, typename OtherEntryType>
+    bool operator==(const Iterator<OtherMapType, OtherEntryType>& other) const {
+      return index_ == other.index_;
+    }
+
+    template <typename OtherMapType, typename OtherEntryType>
+    bool operator!=(const Iterator<OtherMapType, OtherEntryType>& other) const {
+      return index_ != other.index_;
+    }
+
+   private:
+    friend class QuicConnectionIdMap;
+    template <typename OtherMapType, typename OtherEntryType>
+    friend class Iterator;
+
+    Iterator(MapType* map, size_t index)
+        : map_(map), index_(map->NextEntry(index)) {}
+
+    MapType* map_;
+    // Index of the entry in |map_->entries_|.
+    size_t index_;
+  };
+
+  // Bit masks of the lowest and highest bit of each control byte of a group.
+  static const uint64_t kLowBits = UINT64_C(0x0101010101010101);
+  static const uint64_t kHighBits = UINT64_C(0x8080808080808080);
+  // Number of slots whose control bytes are matched at once.
+  static const size_t kGroupSize = 8;
+
+  // Control bytes of slots which are not full.  The control byte of a full
+  // slot is 7 bits of the hash of its key, so its high bit is clear.
+  static const uint8_t kEmpty = 0x80;
+  static const uint8_t kTombstone = 0xfe;
+
+  // The control bytes of a group of slots, and the indices of their entries
+  // in |entries_|, which share a cache line for most groups.
+  struct Group {
+    uint8_t control[kGroupSize];
+    uint32_t entries[kGroupSize];
+  };
+
+  // Returns the mix of |connection_id| and |seed_|.  This is the finalizer of
+  // MurmurHash3, which spreads every bit of its input to all the bits of the
+  // hash.
+  uint64_t Hash(QuicConnectionId connection_id) const {
+    uint64_t hash = connection_id ^ seed_;
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= UINT64_C(0xc4ceb9fe1a85ec53);
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  // Returns the control bytes of the group starting at |slot|, with the byte
+  // of |slot| as the lowest byte.
+  uint64_t LoadGroup(size_t slot) const {
+    uint64_t group;
+    memcpy(&group, groups_[slot / kGroupSize].control, sizeof(group));
+    return base::ByteSwapToLE64(group);
+  }
+
+  uint8_t& control(size_t slot) {
+    return groups_[slot / kGroupSize].control[slot % kGroupSize];
+  }
+
+  // Returns the index in |entries_| of the entry of |slot|.
+  uint32_t& slot_entry(size_t slot) {
+    return groups_[slot / kGroupSize].entries[slot % kGroupSize];
+  }
+  uint32_t slot_entry(size_t slot) const {
+    return groups_[slot / kGroupSize].entries[slot % kGroupSize];
+  }
+
+  // Returns the high bit of each byte of |group| equal to |tag|.  This may
+  // also match a full slot whose byte differs from |tag| in its lowest bit
+  // only when the previous byte does match, which the comparison of the keys
+  // rules out.
+  static uint64_t MatchTag(uint64_t group, uint8_t tag) {
+    const uint64_t x = group ^ (kLowBits * tag);
+    return (x - kLowBits) & ~x & kHighBits;
+  }
+
+  static uint64_t MatchEmpty(uint64_t group) {
+    return group & (~group << 6) & kHighBits;
+  }
+
+  static uint64_t MatchEmptyOrTombstone(uint64_t group) {
+    return group & ~(group << 7) & kHighBits;
+  }
+
+  // Returns the index in its group of the slot of the lowest bit of |match|.
+  static size_t LowestMatch(uint64_t match) {
+    return base::bits::CountTrailingZeroBits(match) / 8;
+  }
+
+  // Returns the index of the entry of |connection_id|, or entries_.size() if
+  // it is not present.
+  size_t FindEntry(QuicConnectionId connection_id) const {
+    size_t slot;
+    return FindSlot(connection_id, &slot) ? slot_entry(slot) : entries_.size();
+  }
+
+  // Sets |slot| to the slot of |connection_id|, and returns true, if it is
+  // present.
+  bool FindSlot(QuicConnectionId connection_id, size_t* slot) const {
+    if (capacity_ == 0) {
+      return false;
+    }
+    const uint64_t hash = Hash(connection_id);
+    const uint8_t tag = hash & 0x7f;
+    const size_t mask = capacity_ - 1;
+    size_t group_start = (hash >> 7) & mask & ~(kGroupSize - 1);
+    // Probes the groups quadratically, which visits all of them as the number
+    // of groups is a power of 2.
+    for (size_t probe = kGroupSize;; probe += kGroupSize) {
+      const uint64_t group = LoadGroup(group_start);
+      for (uint64_t match = MatchTag(group, tag); match != 0;
+           match &= match - 1) {
+        const size_t candidate = group_start + LowestMatch(match);
+        if (entries_[slot_entry(candidate)]->first == connection_id) {
+          *slot = candidate;
+          return true;
+        }
+      }
+      if (MatchEmpty(group) != 0) {
+        return false;
+      }
+      group_start = (group_start + probe) & mask;
+    }
+  }
+
+  // Returns the first slot for the key of |hash| which is not full.
+  size_t FindFreeSlot(uint64_t hash) const {
+    const size_t mask = capacity_ - 1;
+    size_t group_start = (hash >> 7) & mask & ~(kGroupSize - 1);
+    for (size_t probe = kGroupSize;; probe += kGroupSize) {
+      const uint64_t match = MatchEmptyOrTombstone(LoadGroup(group_start));
+      if (match != 0) {
+        return group_start + LowestMatch(match);
+      }
+      group_start = (group_start + probe) & mask;
+    }
+  }
+
+  // Returns the first live entry at or after |index|.
+  size_t NextEntry(size_t index) const {
+    while (index < entries_.size() && !entries_[index]) {
+      ++index;
+    }
+    return index;
+  }
+
+  // Indexes the entry at |index| in the table.
+  void InsertSlot(size_t index) {
+    const uint64_t hash = Hash(entries_[index]->first);
+    const size_t slot = FindFreeSlot(hash);
+    if (control(slot) == kTombstone) {
+      --num_tombstones_;
+    }
+    control(slot) = hash & 0x7f;
+    slot_entry(slot) = index;
+  }
+
+  // Appends |value|, whose key is not present, and returns its index.
+  size_t Insert(value_type&& value) {
+    // Keeps the table at most 7/8 full, counting tombstones, which lookups
+    // have to probe past.
+    if ((size_ + num_tombstones_ + 1) * 8 > capacity_ * 7) {
+      Rehash((size_ + 1) * 16 > capacity_ * 7
+                 ? std::max(2 * capacity_, 2 * kGroupSize)
+                 : capacity_);
+    } else if (entries_.size() > 2 * size_ && entries_.size() >= kGroupSize) {
+      // Most entries were erased, compacts them.
+      Rehash(capacity_);
+    }
+    entries_.emplace_back();
+    entries_.back().emplace(std::move(value));
+    InsertSlot(entries_.size() - 1);
+    ++size_;
+    return entries_.size() - 1;
+  }
+
+  void Erase(size_t index) {
+    size_t slot;
+    const bool found = FindSlot(entries_[index]->first, &slot);
+    DCHECK(found);
+    // A slot can be reused right away if lookups stop at its group anyway.
+    const size_t group_start = slot & ~(kGroupSize - 1);
+    if (MatchEmpty(LoadGroup(group_start)) != 0) {
+      control(slot) = kEmpty;
+    } else {
+      control(slot) = kTombstone;
+      ++num_tombstones_;
+    }
+    entries_[index].reset();
+    --size_;
+    if (index == first_entry_) {
+      first_entry_ = NextEntry(index);
+    }
+  }
+
+  // Compacts the entries and indexes them in a table of |capacity| slots.
+  void Rehash(size_t capacity) {
+    DCHECK_EQ(0u, capacity & (capacity - 1));
+    std::vector<QuicOptional<value_type>> entries;
+    entries.reserve(capacity * 7 / 8);
+    for (QuicOptional<value_type>& entry : entries_) {
+      if (entry) {
+        entries.emplace_back(std::move(entry));
+      }
+    }
+    entries_.swap(entries);
+    capacity_ = capacity;
+    groups_.resize(capacity_ / kGroupSize);
+    for (Group& group : groups_) {
+      memset(group.control, kEmpty, sizeof(group.control));
+    }
+    num_tombstones_ = 0;
+    first_entry_ = 0;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      InsertSlot(i);
+    }
+  }
+
+  const uint64_t seed_;
+  // Number of live entries.
+  size_t size_;
+  // Number of slots whose entry was erased and which lookups probe past.
+  size_t num_tombstones_;
+  // Index of the first live entry, or entries_.size().
+  size_t first_entry_;
+  // Entries in insertion order.  Erased entries are empty until the next
+  // rehash compacts them.
+  std::vector<QuicOptional<value_type>> entries_;
+  // Number of slots of the table, a power of 2 and a multiple of kGroupSize.
+  size_t capacity_;
+  std::vector<Group> groups_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicConnectionIdMap);
+};
+
+template <typename Value>
+const uint64_t QuicConnectionIdMap<Value>::kLowBits;
+template <typename Value>
+const uint64_t QuicConnectionIdMap<Value>::kHighBits;
+template <typename Value>
+const size_t QuicConnectionIdMap<Value>::kGroupSize;
+template <typename Value>
+const uint8_t QuicConnectionIdMap<Value>::kEmpty;
+template <typename Value>
+const uint8_t QuicConnectionIdMap<Value>::kTombstone;
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_QUIC_CONNECTION_ID_MAP_H_
@@ -0,0 +1,75 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Compares the lookups of QuicConnectionIdMap, which backs the session map of
+// QuicDispatcher and the time wait list, with those of QuicUnorderedMap.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/test/perf_time_logger.h"
+#include "net/quic/core/quic_connection_id_map.h"
+#include "net/quic/platform/api/quic_containers.h"
+#include "net/quic/platform/api/quic_str_cat.h"
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kLookups = 10000000;
+
+// Looks up random connection IDs in a map of |num_connections| connections,
+// nine times out of ten a connection which is present.
+template <typename Map>
+void Benchmark(const std::string& name, size_t num_connections) {
+  QuicRandom* random = QuicRandom::GetInstance();
+  std::vector<QuicConnectionId> connection_ids;
+  Map map;
+  for (size_t i = 0; i < num_connections; ++i) {
+    connection_ids.push_back(random->RandUint64());
+    map.insert(std::make_pair(connection_ids.back(), std::unique_ptr<int>()));
+  }
+  // Enough lookups for consecutive ones to miss the cache.
+  std::vector<QuicConnectionId> lookups;
+  for (int i = 0; i < 1 << 20; ++i) {
+    lookups.push_back(i % 10 == 0 ? random->RandUint64()
+                                  : connection_ids[random->RandUint64() %
+                                                   num_connections]);
+  }
+
+  size_t found = 0;
+  base::PerfTimeLogger timer(
+      QuicStrCat(name, "_", num_connections, "_connections").c_str());
+  for (int i = 0; i < kLookups; ++i) {
+    const QuicConnectionId connection_id = lookups[i % lookups.size()];
+    if (map.find(connection_id) != map.end()) {
+      ++found;
+    }
+  }
+  timer.Done();
+  // Keeps the loop from being optimized away.
+  EXPECT_LE(found, static_cast<size_t>(kLookups));
+}
+
+class QuicConnectionIdMapPerfTest : public QuicTest {};
+
+TEST_F(QuicConnectionIdMapPerfTest, UnorderedMap) {
+  for (size_t num_connections : {1000, 100000, 1000000}) {
+    Benchmark<QuicUnorderedMap<QuicConnectionId, std::unique_ptr<int>>>(
+        "QuicUnorderedMap", num_connections);
+  }
+}
+
+TEST_F(QuicConnectionIdMapPerfTest, ConnectionIdMap) {
+  for (size_t num_connections : {1000, 100000, 1000000}) {
+    Benchmark<QuicConnectionIdMap<std::unique_ptr<int>>>(
+        "QuicConnectionIdMap", num_connections);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
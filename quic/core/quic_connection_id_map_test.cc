@@ -0,0 +1,165 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_connection_id_map.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class QuicConnectionIdMapTest : public QuicTest {
+ protected:
+  QuicConnectionIdMapTest() : map_(/*seed=*/42) {}
+
+  std::vector<QuicConnectionId> Keys() const {
+    std::vector<QuicConnectionId> keys;
+    for (const auto& entry : map_) {
+      keys.push_back(entry.first);
+    }
+    return keys;
+  }
+
+  QuicConnectionIdMap<int> map_;
+};
+
+TEST_F(QuicConnectionIdMapTest, InsertFindErase) {
+  EXPECT_TRUE(map_.empty());
+  EXPECT_EQ(map_.end(), map_.find(1));
+
+  EXPECT_TRUE(map_.insert(std::make_pair(1, 10)).second);
+  EXPECT_TRUE(map_.insert(std::make_pair(2, 20)).second);
+  auto result = map_.insert(std::make_pair(1, 30));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(10, result.first->second);
+  EXPECT_EQ(2u, map_.size());
+
+  auto it = map_.find(2);
+  ASSERT_NE(map_.end(), it);
+  EXPECT_EQ(2u, it->first);
+  it->second = 25;
+  EXPECT_EQ(25, map_.find(2)->second);
+  EXPECT_EQ(1u, map_.count(1));
+
+  map_.erase(map_.find(1));
+  EXPECT_EQ(map_.end(), map_.find(1));
+  EXPECT_EQ(0u, map_.erase(1));
+  EXPECT_EQ(1u, map_.erase(2));
+  EXPECT_TRUE(map_.empty());
+  EXPECT_EQ(map_.begin(), map_.end());
+}
+
+TEST_F(QuicConnectionIdMapTest, InsertionOrder) {
+  for (QuicConnectionId id : {5, 3, 9, 1}) {
+    map_.insert(std::make_pair(id, 0));
+  }
+  EXPECT_EQ(std::vector<QuicConnectionId>({5, 3, 9, 1}), Keys());
+
+  // Erasing the oldest entry makes the next one the first, and a reinserted
+  // entry goes to the back.
+  map_.erase(map_.begin());
+  EXPECT_EQ(3u, map_.begin()->first);
+  map_.erase(9);
+  map_.insert(std::make_pair(9, 0));
+  EXPECT_EQ(std::vector<QuicConnectionId>({3, 1, 9}), Keys());
+}
+
+TEST_F(QuicConnectionIdMapTest, EraseKeepsOtherIterators) {
+  for (QuicConnectionId id = 1; id <= 4; ++id) {
+    map_.insert(std::make_pair(id, static_cast<int>(id)));
+  }
+  auto it = map_.find(3);
+  map_.erase(2);
+  map_.erase(map_.begin());
+  EXPECT_EQ(3u, it->first);
+  ++it;
+  EXPECT_EQ(4u, it->first);
+}
+
+TEST_F(QuicConnectionIdMapTest, MoveOnlyValues) {
+  QuicConnectionIdMap<std::unique_ptr<int>> map;
+  for (int i = 0; i < 100; ++i) {
+    map.insert(std::make_pair(i, QuicMakeUnique<int>(i)));
+  }
+  for (int i = 0; i < 100; i += 2) {
+    map.erase(i);
+  }
+  // Grows and compacts the entries.
+  for (int i = 100; i < 200; ++i) {
+    map.insert(std::make_pair(i, QuicMakeUnique<int>(i)));
+  }
+  ASSERT_EQ(150u, map.size());
+  for (int i = 1; i < 200; i += 2) {
+    ASSERT_NE(map.end(), map.find(i));
+    EXPECT_EQ(i, *map.find(i)->second);
+  }
+}
+
+TEST_F(QuicConnectionIdMapTest, Clear) {
+  for (QuicConnectionId id = 1; id <= 20; ++id) {
+    map_.insert(std::make_pair(id, 0));
+  }
+  map_.clear();
+  EXPECT_TRUE(map_.empty());
+  EXPECT_EQ(map_.end(), map_.find(1));
+  map_.insert(std::make_pair(1, 0));
+  EXPECT_EQ(std::vector<QuicConnectionId>({1}), Keys());
+}
+
+// Verifies that the map has the same contents and order as a reference under
+// a random sequence of operations, with enough entries to grow the table and
+// enough erasures to fill it with tombstones.
+TEST_F(QuicConnectionIdMapTest, RandomOperations) {
+  // Keys in insertion order, and the values of the keys.
+  std::vector<QuicConnectionId> order;
+  std::map<QuicConnectionId, int> reference;
+  uint64_t seed = 1;
+  for (int i = 0; i < 50000; ++i) {
+    // Linear congruential generator, keeping the sequence deterministic.
+    seed = seed * UINT64_C(6364136223846793005) +
+           UINT64_C(1442695040888963407);
+    const uint64_t value = seed >> 32;
+    // Few distinct keys make insertions of present keys and erasures common.
+    const QuicConnectionId id = (value >> 4) % 2000 * UINT64_C(0x100000001);
+    switch (value % 3) {
+      case 0:
+      case 1: {
+        const bool inserted = map_.insert(std::make_pair(id, i)).second;
+        EXPECT_EQ(reference.insert(std::make_pair(id, i)).second, inserted);
+        if (inserted) {
+          order.push_back(id);
+        }
+        break;
+      }
+      case 2: {
+        EXPECT_EQ(reference.erase(id), map_.erase(id));
+        auto it = std::find(order.begin(), order.end(), id);
+        if (it != order.end()) {
+          order.erase(it);
+        }
+        break;
+      }
+    }
+    ASSERT_EQ(reference.size(), map_.size());
+    auto it = map_.find(id);
+    if (reference.count(id) == 0) {
+      EXPECT_EQ(map_.end(), it);
+    } else {
+      ASSERT_NE(map_.end(), it);
+      EXPECT_EQ(reference[id], it->second);
+    }
+  }
+  EXPECT_EQ(order, Keys());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -39,7 +39,11 @@ QuicConnectionStats::QuicConnectionStats()
       tcp_loss_events(0),
       connection_creation_time(QuicTime::Zero()),
       blocked_frames_received(0),
-      blocked_frames_sent(0) {}
+      blocked_frames_sent(0),
+      alarm_updates_coalesced(0),
+      pacing_wakeups(0),
+      pacing_wakeup_lateness_us(0),
+      max_pacing_wakeup_lateness_us(0) {}
 
 QuicConnectionStats::QuicConnectionStats(const QuicConnectionStats& other) =
     default;
@@ -81,7 +85,12 @@ std::ostream& operator<<(std::ostream& os, const QuicConnectionStats& s) {
   os << " connection_creation_time: "
      << s.connection_creation_time.ToDebuggingValue();
   os << " blocked_frames_received: " << s.blocked_frames_received;
-  os << " blocked_frames_sent: " << s.blocked_frames_sent << " }";
+  os << " blocked_frames_sent: " << s.blocked_frames_sent;
+  os << " alarm_updates_coalesced: " << s.alarm_updates_coalesced;
+  os << " pacing_wakeups: " << s.pacing_wakeups;
+  os << " pacing_wakeup_lateness_us: " << s.pacing_wakeup_lateness_us;
+  os << " max_pacing_wakeup_lateness_us: " << s.max_pacing_wakeup_lateness_us
+     << " }";
 
   return os;
 }
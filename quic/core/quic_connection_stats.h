@@ -89,6 +89,16 @@ struct QUIC_EXPORT_PRIVATE QuicConnectionStats {
 
   uint64_t blocked_frames_received;
   uint64_t blocked_frames_sent;
+
+  // Number of alarm scheduling calls saved by coalescing alarm updates.
+  uint64_t alarm_updates_coalesced;
+
+  // Number of times the pacing sender delayed a packet until a wakeup.
+  uint64_t pacing_wakeups;
+  // Total and maximum time by which paced packets were sent after the wakeup
+  // they were scheduled for, measuring the accuracy of the pacing alarm.
+  int64_t pacing_wakeup_lateness_us;
+  int64_t max_pacing_wakeup_lateness_us;
 };
 
 }  // namespace net
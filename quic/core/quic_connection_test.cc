@@ -293,7 +293,9 @@ class TestPacketWriter : public QuicPacketWriter {
         packets_write_attempts_(0),
         clock_(clock),
         write_pause_time_delta_(QuicTime::Delta::Zero()),
-        max_packet_size_(kMaxPacketSize) {}
+        max_packet_size_(kMaxPacketSize),
+        batch_mode_(false),
+        flush_count_(0) {}
 
   // QuicPacketWriter interface
   WriteResult WritePacket(const char* buffer,
@@ -360,6 +362,17 @@ class TestPacketWriter : public QuicPacketWriter {
     return max_packet_size_;
   }
 
+  bool IsBatchMode() const override { return batch_mode_; }
+
+  WriteResult Flush() override {
+    ++flush_count_;
+    return WriteResult(WRITE_STATUS_OK, 0);
+  }
+
+  void set_batch_mode(bool batch_mode) { batch_mode_ = batch_mode; }
+
+  int flush_count() const { return flush_count_; }
+
   void BlockOnNextWrite() { block_on_next_write_ = true; }
 
   void SimulateNextPacketTooLarge() { next_packet_too_large_ = true; }
@@ -474,6 +487,8 @@ class TestPacketWriter : public QuicPacketWriter {
   // time.
   QuicTime::Delta write_pause_time_delta_;
   QuicByteCount max_packet_size_;
+  bool batch_mode_;
+  int flush_count_;
 
   DISALLOW_COPY_AND_ASSIGN(TestPacketWriter);
 };
@@ -2318,6 +2333,30 @@ TEST_P(QuicConnectionTest, OnCanWrite) {
   EXPECT_EQ(kClientDataStreamId2, writer_->stream_frames()[1]->stream_id);
 }
 
+TEST_P(QuicConnectionTest, FlushBatchWriterAfterWriteLoop) {
+  writer_->set_batch_mode(true);
+  connection_.SendStreamDataWithString(kClientDataStreamId1, "foo", 0, NO_FIN);
+  EXPECT_EQ(1u, writer_->packets_write_attempts());
+  EXPECT_EQ(1, writer_->flush_count());
+
+  EXPECT_CALL(visitor_, OnCanWrite())
+      .WillOnce(DoAll(IgnoreResult(InvokeWithoutArgs(
+                          &connection_, &TestConnection::SendStreamData3)),
+                      IgnoreResult(InvokeWithoutArgs(
+                          &connection_, &TestConnection::SendStreamData5))));
+  EXPECT_CALL(visitor_, WillingAndAbleToWrite()).WillRepeatedly(Return(false));
+  connection_.OnCanWrite();
+  // Both streams are bundled into one packet.  The writer is flushed when the
+  // outermost flusher goes away and when OnCanWrite finishes, not per packet.
+  EXPECT_EQ(2u, writer_->packets_write_attempts());
+  EXPECT_EQ(3, writer_->flush_count());
+}
+
+TEST_P(QuicConnectionTest, NoFlushWithoutBatchMode) {
+  connection_.SendStreamDataWithString(kClientDataStreamId1, "foo", 0, NO_FIN);
+  EXPECT_EQ(0, writer_->flush_count());
+}
+
 TEST_P(QuicConnectionTest, RetransmitOnNack) {
   QuicPacketNumber last_packet;
   QuicByteCount second_packet_size;
@@ -3456,6 +3495,54 @@ TEST_P(QuicConnectionTest, MtuDiscoveryFailed) {
   EXPECT_EQ(kMtuDiscoveryAttempts, connection_.mtu_probe_count());
 }
 
+// Tests that a probe which is not acknowledged is followed by a probe halfway
+// between the current MTU and the failed size.
+TEST_P(QuicConnectionTest, MtuDiscoveryBinarySearch) {
+  EXPECT_TRUE(connection_.connected());
+
+  connection_.EnablePathMtuDiscovery(send_algorithm_);
+  const QuicByteCount initial_mtu = connection_.max_packet_length();
+
+  // Send enough packets so that the next one triggers path MTU discovery.
+  QuicStreamOffset offset = 0;
+  for (QuicPacketCount i = 0; i < kPacketsBetweenMtuProbesBase; i++) {
+    SendStreamDataToPeer(3, ".", offset++, NO_FIN, nullptr);
+  }
+  ASSERT_TRUE(connection_.GetMtuDiscoveryAlarm()->IsSet());
+  QuicByteCount probe_size;
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _))
+      .WillOnce(SaveArg<3>(&probe_size));
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+  EXPECT_EQ(kMtuDiscoveryTargetPacketSizeHigh, probe_size);
+  const QuicPacketNumber lost_probe = creator_->packet_number();
+
+  // Acknowledge everything but the probe.
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_, OnCongestionEvent(_, _, _, _, _))
+      .Times(AnyNumber());
+  QuicAckFrame ack = InitAckFrame(lost_probe - 1);
+  ProcessAckPacket(&ack);
+  EXPECT_EQ(initial_mtu, connection_.max_packet_length());
+
+  // Send packets until the next probe is due.
+  while (!connection_.GetMtuDiscoveryAlarm()->IsSet()) {
+    SendStreamDataToPeer(3, ".", offset++, NO_FIN, nullptr);
+  }
+  EXPECT_CALL(*send_algorithm_, OnPacketSent(_, _, _, _, _))
+      .WillOnce(SaveArg<3>(&probe_size));
+  connection_.GetMtuDiscoveryAlarm()->Fire();
+  EXPECT_EQ(
+      initial_mtu + (kMtuDiscoveryTargetPacketSizeHigh - initial_mtu) / 2,
+      probe_size);
+
+  // Acknowledging the smaller probe raises the MTU to its size.
+  ack.packets.AddRange(lost_probe + 1, creator_->packet_number() + 1);
+  ack.deprecated_largest_observed = creator_->packet_number();
+  ProcessAckPacket(&ack);
+  EXPECT_EQ(probe_size, connection_.max_packet_length());
+  EXPECT_EQ(2u, connection_.mtu_probe_count());
+}
+
 // Tests whether MTU discovery works when the writer has a limit on how large a
 // packet can be.
 TEST_P(QuicConnectionTest, MtuDiscoveryWriterLimited) {
@@ -4275,6 +4362,88 @@ TEST_P(QuicConnectionTest, SendDelayedAckDecimationUnlimitedAggregation) {
   EXPECT_EQ(ack_time, connection_.GetAckAlarm()->deadline());
 }
 
+TEST_P(QuicConnectionTest, SendDelayedAckDecimationAdaptiveAggregation) {
+  EXPECT_CALL(visitor_, OnAckNeedsRetransmittableFrame()).Times(AnyNumber());
+  EXPECT_CALL(*send_algorithm_, SetFromConfig(_, _));
+  QuicConfig config;
+  QuicTagVector connection_options;
+  connection_options.push_back(kACKD);
+  // The number of packets received before sending an ack adapts to the rate.
+  connection_options.push_back(kAKDA);
+  config.SetConnectionOptionsToSend(connection_options);
+  connection_.SetFromConfig(config);
+
+  const size_t kMinRttMs = 40;
+  RttStats* rtt_stats = const_cast<RttStats*>(manager_->GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(kMinRttMs),
+                       QuicTime::Delta::Zero(), QuicTime::Zero());
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+  const uint8_t tag = 0x07;
+  connection_.SetDecrypter(ENCRYPTION_INITIAL, new StrictTaggingDecrypter(tag));
+  peer_framer_.SetEncrypter(ENCRYPTION_INITIAL, new TaggingEncrypter(tag));
+  // Process a packet from the non-crypto stream.
+  frame1_.stream_id = 3;
+
+  // Process all the initial packets in order so there aren't missing packets.
+  QuicPacketNumber kFirstDecimatedPacket = 101;
+  for (unsigned int i = 0; i < kFirstDecimatedPacket - 1; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(1 + i, !kHasStopWaiting, ENCRYPTION_INITIAL);
+  }
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+
+  // The 10th decimated packet causes an ack to be sent.
+  QuicPacketNumber packet_number = kFirstDecimatedPacket;
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                             ENCRYPTION_INITIAL);
+  }
+  EXPECT_FALSE(writer_->ack_frames().empty());
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+  uint32_t packets_written = writer_->packets_write_attempts();
+
+  // Since those arrived within the ack delay, the next ack waits for 20.
+  for (int i = 0; i < 19; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                             ENCRYPTION_INITIAL);
+    EXPECT_TRUE(connection_.GetAckAlarm()->IsSet());
+  }
+  EXPECT_EQ(packets_written, writer_->packets_write_attempts());
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+  ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                           ENCRYPTION_INITIAL);
+  EXPECT_EQ(packets_written + 1, writer_->packets_write_attempts());
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+
+  // The limit is now 40. Only 5 packets arrive before the ack delay expires,
+  // so the limit goes back down to 20.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                             ENCRYPTION_INITIAL);
+  }
+  EXPECT_TRUE(connection_.GetAckAlarm()->IsSet());
+  connection_.GetAckAlarm()->Fire();
+  EXPECT_EQ(packets_written + 2, writer_->packets_write_attempts());
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+
+  for (int i = 0; i < 19; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                             ENCRYPTION_INITIAL);
+    EXPECT_TRUE(connection_.GetAckAlarm()->IsSet());
+  }
+  EXPECT_EQ(packets_written + 2, writer_->packets_write_attempts());
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+  ProcessDataPacketAtLevel(packet_number++, !kHasStopWaiting,
+                           ENCRYPTION_INITIAL);
+  EXPECT_EQ(packets_written + 3, writer_->packets_write_attempts());
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+}
+
 TEST_P(QuicConnectionTest, SendDelayedAckDecimationEighthRtt) {
   EXPECT_CALL(visitor_, OnAckNeedsRetransmittableFrame()).Times(AnyNumber());
   QuicConnectionPeer::SetAckMode(&connection_, QuicConnection::ACK_DECIMATION);
@@ -4397,6 +4566,42 @@ TEST_P(QuicConnectionTest, SendDelayedAckDecimationWithReordering) {
   EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
 }
 
+TEST_P(QuicConnectionTest, BatchAlarmUpdates) {
+  FLAGS_quic_reloadable_flag_quic_batch_alarm_updates = true;
+  EXPECT_CALL(visitor_, OnAckNeedsRetransmittableFrame()).Times(AnyNumber());
+  QuicConnectionPeer::SetAckMode(
+      &connection_, QuicConnection::ACK_DECIMATION_WITH_REORDERING);
+
+  const size_t kMinRttMs = 40;
+  RttStats* rtt_stats = const_cast<RttStats*>(manager_->GetRttStats());
+  rtt_stats->UpdateRtt(QuicTime::Delta::FromMilliseconds(kMinRttMs),
+                       QuicTime::Delta::Zero(), QuicTime::Zero());
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  const uint8_t tag = 0x07;
+  connection_.SetDecrypter(ENCRYPTION_INITIAL, new StrictTaggingDecrypter(tag));
+  peer_framer_.SetEncrypter(ENCRYPTION_INITIAL, new TaggingEncrypter(tag));
+  frame1_.stream_id = 3;
+
+  QuicPacketNumber kFirstDecimatedPacket = 101;
+  for (unsigned int i = 0; i < kFirstDecimatedPacket - 1; ++i) {
+    EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+    ProcessDataPacketAtLevel(1 + i, !kHasStopWaiting, ENCRYPTION_INITIAL);
+  }
+  EXPECT_FALSE(connection_.GetAckAlarm()->IsSet());
+  const uint64_t coalesced = connection_.GetStats().alarm_updates_coalesced;
+
+  // A packet arriving out of order sets the ack alarm for the decimation
+  // delay and then moves it to one eighth min_rtt, which only gets scheduled
+  // once.
+  EXPECT_CALL(visitor_, OnStreamFrame(_)).Times(1);
+  ProcessDataPacketAtLevel(kFirstDecimatedPacket + 1, !kHasStopWaiting,
+                           ENCRYPTION_INITIAL);
+  EXPECT_TRUE(connection_.GetAckAlarm()->IsSet());
+  EXPECT_EQ(clock_.ApproximateNow() + QuicTime::Delta::FromMilliseconds(5),
+            connection_.GetAckAlarm()->deadline());
+  EXPECT_EQ(coalesced + 1, connection_.GetStats().alarm_updates_coalesced);
+}
+
 TEST_P(QuicConnectionTest, SendDelayedAckDecimationWithLargeReordering) {
   EXPECT_CALL(visitor_, OnAckNeedsRetransmittableFrame()).Times(AnyNumber());
   QuicConnectionPeer::SetAckMode(
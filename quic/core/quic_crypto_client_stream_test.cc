@@ -360,7 +360,7 @@ class QuicCryptoClientStreamStatelessTest : public QuicTest {
                               QuicRandom::GetInstance(),
                               crypto_test_utils::ProofSourceForTesting()),
         server_compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
         server_id_(kServerHostname, kServerPort, PRIVACY_MODE_DISABLED) {
     TestQuicSpdyClientSession* client_session = nullptr;
     CreateClientSessionForTest(server_id_,
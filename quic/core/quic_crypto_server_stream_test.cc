@@ -68,7 +68,7 @@ class QuicCryptoServerStreamTest : public QuicTestWithParam<bool> {
                               QuicRandom::GetInstance(),
                               std::move(proof_source)),
         server_compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
         server_id_(kServerHostname, kServerPort, PRIVACY_MODE_DISABLED),
         client_crypto_config_(crypto_test_utils::ProofVerifierForTesting()) {
     FLAGS_quic_reloadable_flag_enable_quic_stateless_reject_support = false;
@@ -103,6 +103,11 @@ QUIC_FLAG(bool, FLAGS_quic_enable_version_42, false)
 // provided data or asks upper layer for more data.
 QUIC_FLAG(uint32_t, FLAGS_quic_buffered_data_threshold, 8192u)
 
+// If non-zero, streams of a QUIC session which still have buffered data do not
+// accept more once the session's streams have more than this many bytes
+// buffered in total.
+QUIC_FLAG(uint32_t, FLAGS_quic_session_buffered_data_limit, 0u)
+
 // Max size of data slice in bytes for QUIC stream send buffer.
 QUIC_FLAG(uint32_t, FLAGS_quic_send_buffer_max_data_slice_size, 4096u)
 
@@ -207,3 +212,78 @@ QUIC_FLAG(bool,
 
 // If true, use deframer from net/quic/http instead of net/http2.
 QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_enable_hq_deframer, false)
+
+// If true, QuicServer sends packets through a UDP GSO batch writer when the
+// kernel supports UDP_SEGMENT.
+QUIC_FLAG(bool, FLAGS_quic_server_use_gso_batch_writer, false)
+
+// If true, QuicServer queues the packets of all connections during an event
+// loop iteration and sends them with sendmmsg, unless the GSO batch writer is
+// in use.
+QUIC_FLAG(bool, FLAGS_quic_server_use_sendmmsg_batch_writer, false)
+
+// If true, QuicServer enables UDP_GRO on its socket and splits coalesced
+// datagrams on receipt.
+QUIC_FLAG(bool, FLAGS_quic_server_enable_udp_gro, false)
+
+// If true, QuicPacketCreator encrypts stream data straight from the stream
+// send buffer instead of copying it into the packet first.
+QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_zero_copy_stream_frames, false)
+
+// If true, QuicFramer decrypts forward secure packets in the receive buffer
+// instead of into a separate scratch buffer.
+QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_decrypt_packets_in_place, false)
+
+// If true, QuicStreamSequencer lets the stream read an in-order stream frame
+// in place when nothing else is buffered, and only copies what the stream
+// leaves unread.
+QUIC_FLAG(bool,
+          FLAGS_quic_reloadable_flag_quic_reference_in_order_stream_data,
+          false)
+
+// If true, QuicEpollAlarmFactory keeps alarms in a timing wheel driven by a
+// single EpollServer alarm.
+QUIC_FLAG(bool, FLAGS_quic_epoll_alarm_timing_wheel, false)
+
+// If true, QuicConnection coalesces the updates of its ack, send and
+// retransmission alarms while processing a packet or writing stream data.
+QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_batch_alarm_updates, false)
+
+// Number of handshake proofs QuicServer hands to its ProofSource at once. 0
+// disables batching.
+QUIC_FLAG(uint32_t, FLAGS_quic_server_proof_batch_size, 0u)
+
+// Number of threads on which QuicServer runs handshake proofs and key
+// agreement. 0 keeps them on the event loop.
+QUIC_FLAG(uint32_t, FLAGS_quic_server_crypto_worker_threads, 0u)
+
+// If true, enable experiment for testing BBRv2 style congestion control.
+QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_enable_bbr2, false)
+
+// If true, PacingSender bounds the packets released by a single wakeup to the
+// bytes allowed per alarm granularity and to one batch of the packet writer.
+QUIC_FLAG(bool, FLAGS_quic_reloadable_flag_quic_pacing_batch_release, false)
+
+// If true, QuicBufferedPacketStore bounds the bytes of packets it buffers, in
+// total and per client IP, and copies them into shared arena blocks.
+QUIC_FLAG(bool,
+          FLAGS_quic_reloadable_flag_quic_limit_buffered_packet_bytes,
+          false)
+
+// If true, QuicTimeWaitListManager limits the responses it sends to each
+// client IP with a token bucket.
+QUIC_FLAG(bool,
+          FLAGS_quic_reloadable_flag_quic_rate_limit_time_wait_responses,
+          false)
+
+// If true, QuicDispatcher rejects or drops new connections while its event
+// loop lags or too many handshakes are pending.
+QUIC_FLAG(bool,
+          FLAGS_quic_reloadable_flag_quic_shed_load_when_overloaded,
+          false)
+
+// If true, QuicSimpleServerStream sends cached responses with their
+// pre-encoded headers, and mapped bodies without copying them.
+QUIC_FLAG(bool,
+          FLAGS_quic_reloadable_flag_quic_send_pre_encoded_responses,
+          false)
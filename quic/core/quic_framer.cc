@@ -155,6 +155,62 @@ QuicPacketNumberLength ReadAckPacketNumberLength(QuicTransportVersion version,
   }
 }
 
+// Classifies every value of the frame type byte, so that frame parsing can
+// dispatch on a single lookup instead of testing the special frame type masks
+// one after the other. Values which don't denote a known frame type map to
+// NUM_FRAME_TYPES.
+class FrameTypeTable {
+ public:
+  explicit FrameTypeTable(bool pre_version_41) {
+    for (size_t i = 0; i < arraysize(frame_types_); ++i) {
+      frame_types_[i] = Classify(static_cast<uint8_t>(i), pre_version_41);
+    }
+  }
+
+  QuicFrameType Lookup(uint8_t frame_type) const {
+    return static_cast<QuicFrameType>(frame_types_[frame_type]);
+  }
+
+ private:
+  static QuicFrameType Classify(uint8_t frame_type, bool pre_version_41) {
+    if (frame_type & kQuicFrameTypeSpecialMask) {
+      if (pre_version_41) {
+        if (frame_type & kQuicFrameTypeStreamMask_Pre40) {
+          return STREAM_FRAME;
+        }
+        if (frame_type & kQuicFrameTypeAckMask_Pre40) {
+          return ACK_FRAME;
+        }
+      } else {
+        if ((frame_type & kQuicFrameTypeStreamMask) ==
+            kQuicFrameTypeStreamMask) {
+          return STREAM_FRAME;
+        }
+        if ((frame_type & kQuicFrameTypeSpecialMask) == kQuicFrameTypeAckMask) {
+          return ACK_FRAME;
+        }
+      }
+      return NUM_FRAME_TYPES;
+    }
+    if (frame_type > PING_FRAME) {
+      return NUM_FRAME_TYPES;
+    }
+    return static_cast<QuicFrameType>(frame_type);
+  }
+
+  uint8_t frame_types_[256];
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTypeTable);
+};
+
+const FrameTypeTable& GetFrameTypeTable(QuicTransportVersion version) {
+  static const FrameTypeTable* const pre_version_41_table =
+      new FrameTypeTable(/*pre_version_41=*/true);
+  static const FrameTypeTable* const table =
+      new FrameTypeTable(/*pre_version_41=*/false);
+  return version < QUIC_VERSION_41 ? *pre_version_41_table : *table;
+}
+
 }  // namespace
 
 QuicFramer::QuicFramer(const QuicTransportVersionVector& supported_versions,
@@ -663,8 +719,16 @@ bool QuicFramer::ProcessDataPacket(QuicDataReader* encrypted_reader,
   }
 
   size_t decrypted_length = 0;
-  if (!DecryptPayload(encrypted_reader, *header, packet, decrypted_buffer,
-                      buffer_length, &decrypted_length)) {
+  bool decrypted;
+  if (CanDecryptInPlace(packet)) {
+    decrypted = DecryptPayloadInPlace(encrypted_reader, *header, packet,
+                                      &decrypted_buffer, &decrypted_length);
+  } else {
+    decrypted = DecryptPayload(encrypted_reader, *header, packet,
+                               decrypted_buffer, buffer_length,
+                               &decrypted_length);
+  }
+  if (!decrypted) {
     set_detailed_error("Unable to decrypt payload.");
     return RaiseError(QUIC_DECRYPTION_FAILURE);
   }
@@ -864,6 +928,35 @@ bool QuicFramer::ProcessPublicHeader(QuicDataReader* reader,
     return false;
   }
 
+  // Once a connection is established its packets carry neither version nor
+  // reset flags, and their public flags rarely change. Reuse the decoding of
+  // the last such flags byte and read the remaining fields in one pass.
+  if (cached_public_header_.valid &&
+      public_flags == cached_public_header_.public_flags) {
+    header->reset_flag = false;
+    header->version_flag = false;
+    header->connection_id_length = cached_public_header_.connection_id_length;
+    header->packet_number_length = cached_public_header_.packet_number_length;
+    if (header->connection_id_length == PACKET_8BYTE_CONNECTION_ID) {
+      if (!reader->ReadConnectionId(&header->connection_id)) {
+        set_detailed_error("Unable to read ConnectionId.");
+        return false;
+      }
+    } else {
+      header->connection_id = last_serialized_connection_id_;
+    }
+    header->nonce = nullptr;
+    if (cached_public_header_.has_nonce) {
+      if (!reader->ReadBytes(reinterpret_cast<uint8_t*>(last_nonce_.data()),
+                             last_nonce_.size())) {
+        set_detailed_error("Unable to read nonce.");
+        return false;
+      }
+      header->nonce = &last_nonce_;
+    }
+    return true;
+  }
+
   header->reset_flag = (public_flags & PACKET_PUBLIC_FLAGS_RST) != 0;
   header->version_flag = (public_flags & PACKET_PUBLIC_FLAGS_VERSION) != 0;
 
@@ -942,6 +1035,14 @@ bool QuicFramer::ProcessPublicHeader(QuicDataReader* reader,
     header->nonce = nullptr;
   }
 
+  if (!header->reset_flag && !header->version_flag) {
+    cached_public_header_.valid = true;
+    cached_public_header_.public_flags = public_flags;
+    cached_public_header_.connection_id_length = header->connection_id_length;
+    cached_public_header_.packet_number_length = header->packet_number_length;
+    cached_public_header_.has_nonce = header->nonce != nullptr;
+  }
+
   return true;
 }
 
@@ -1058,6 +1159,7 @@ bool QuicFramer::ProcessFrameData(QuicDataReader* reader,
     set_detailed_error("Packet has no frames.");
     return RaiseError(QUIC_MISSING_PAYLOAD);
   }
+  const FrameTypeTable& frame_types = GetFrameTypeTable(transport_version_);
   while (!reader->IsDoneReading()) {
     uint8_t frame_type;
     if (!reader->ReadBytes(&frame_type, 1)) {
@@ -1065,13 +1167,8 @@ bool QuicFramer::ProcessFrameData(QuicDataReader* reader,
       return RaiseError(QUIC_INVALID_FRAME_DATA);
     }
 
-    if (frame_type & kQuicFrameTypeSpecialMask) {
-      // Stream Frame
-      if ((transport_version_ < QUIC_VERSION_41 &&
-           (frame_type & kQuicFrameTypeStreamMask_Pre40)) ||
-          (transport_version_ >= QUIC_VERSION_41 &&
-           ((frame_type & kQuicFrameTypeStreamMask) ==
-            kQuicFrameTypeStreamMask))) {
+    switch (frame_types.Lookup(frame_type)) {
+      case STREAM_FRAME: {
         QuicStreamFrame frame;
         if (!ProcessStreamFrame(reader, frame_type, &frame)) {
           return RaiseError(QUIC_INVALID_STREAM_DATA);
@@ -1085,12 +1182,7 @@ bool QuicFramer::ProcessFrameData(QuicDataReader* reader,
         continue;
       }
 
-      // Ack Frame
-      if ((transport_version_ < QUIC_VERSION_41 &&
-           (frame_type & kQuicFrameTypeAckMask_Pre40)) ||
-          (transport_version_ >= QUIC_VERSION_41 &&
-           ((frame_type & kQuicFrameTypeSpecialMask) ==
-            kQuicFrameTypeAckMask))) {
+      case ACK_FRAME: {
         QuicAckFrame frame;
         if (!ProcessAckFrame(reader, frame_type, &frame)) {
           return RaiseError(QUIC_INVALID_ACK_DATA);
@@ -1104,15 +1196,6 @@ bool QuicFramer::ProcessFrameData(QuicDataReader* reader,
         continue;
       }
 
-      // This was a special frame type that did not match any
-      // of the known ones. Error.
-      set_detailed_error("Illegal frame type.");
-      QUIC_DLOG(WARNING) << ENDPOINT << "Illegal frame type: "
-                         << static_cast<int>(frame_type);
-      return RaiseError(QUIC_INVALID_FRAME_DATA);
-    }
-
-    switch (frame_type) {
       case PADDING_FRAME: {
         QuicPaddingFrame frame;
         ProcessPaddingFrame(reader, &frame);
@@ -1721,6 +1804,29 @@ size_t QuicFramer::EncryptInPlace(EncryptionLevel level,
   return ad_len + output_length;
 }
 
+size_t QuicFramer::EncryptInPlaceWithTrailingData(
+    EncryptionLevel level,
+    QuicPacketNumber packet_number,
+    size_t ad_len,
+    size_t total_len,
+    QuicStringPiece trailing_data,
+    size_t buffer_len,
+    char* buffer) {
+  size_t output_length = 0;
+  if (!encrypter_[level]->EncryptPacketWithTrailingPlaintext(
+          transport_version_, packet_number,
+          QuicStringPiece(buffer, ad_len),  // Associated data
+          QuicStringPiece(buffer + ad_len, total_len - ad_len),  // Plaintext
+          trailing_data,
+          buffer + ad_len,  // Destination buffer
+          &output_length, buffer_len - ad_len)) {
+    RaiseError(QUIC_ENCRYPTION_FAILURE);
+    return 0;
+  }
+
+  return ad_len + output_length;
+}
+
 size_t QuicFramer::EncryptPayload(EncryptionLevel level,
                                   QuicPacketNumber packet_number,
                                   const QuicPacket& packet,
@@ -1830,6 +1936,38 @@ bool QuicFramer::DecryptPayload(QuicDataReader* encrypted_reader,
   return true;
 }
 
+bool QuicFramer::CanDecryptInPlace(const QuicEncryptedPacket& packet) const {
+  return FLAGS_quic_reloadable_flag_quic_decrypt_packets_in_place &&
+         packet.mutable_data() != nullptr && decrypter_ != nullptr &&
+         decrypter_level_ == ENCRYPTION_FORWARD_SECURE &&
+         alternative_decrypter_ == nullptr;
+}
+
+bool QuicFramer::DecryptPayloadInPlace(QuicDataReader* encrypted_reader,
+                                       const QuicPacketHeader& header,
+                                       const QuicEncryptedPacket& packet,
+                                       char** decrypted_data,
+                                       size_t* decrypted_length) {
+  QuicStringPiece encrypted = encrypted_reader->ReadRemainingPayload();
+  QuicStringPiece associated_data = GetAssociatedDataFromEncryptedPacket(
+      transport_version_, packet, header.connection_id_length,
+      header.version_flag, header.nonce != nullptr,
+      header.packet_number_length);
+  char* ciphertext = packet.mutable_data() + (encrypted.data() - packet.data());
+  if (!decrypter_->DecryptPacketInPlace(transport_version_,
+                                        header.packet_number, associated_data,
+                                        ciphertext, encrypted.length(),
+                                        decrypted_length)) {
+    QUIC_DVLOG(1) << ENDPOINT
+                  << "DecryptPacketInPlace failed for packet_number:"
+                  << header.packet_number;
+    return false;
+  }
+  visitor_->OnDecryptedPacket(decrypter_level_);
+  *decrypted_data = ciphertext;
+  return true;
+}
+
 size_t QuicFramer::GetAckFrameTimeStampSize(const QuicAckFrame& ack) {
   if (ack.received_packet_times.empty()) {
     return 0;
@@ -2037,23 +2175,9 @@ bool QuicFramer::AppendAckBlock(uint8_t gap,
 bool QuicFramer::AppendStreamFrame(const QuicStreamFrame& frame,
                                    bool no_stream_frame_length,
                                    QuicDataWriter* writer) {
-  if (!AppendStreamId(GetStreamIdSize(frame.stream_id), frame.stream_id,
-                      writer)) {
-    QUIC_BUG << "Writing stream id size failed.";
+  if (!AppendStreamFrameHeader(frame, no_stream_frame_length, writer)) {
     return false;
   }
-  if (!AppendStreamOffset(GetStreamOffsetSize(transport_version_, frame.offset),
-                          frame.offset, writer)) {
-    QUIC_BUG << "Writing offset size failed.";
-    return false;
-  }
-  if (!no_stream_frame_length) {
-    if ((frame.data_length > std::numeric_limits<uint16_t>::max()) ||
-        !writer->WriteUInt16(static_cast<uint16_t>(frame.data_length))) {
-      QUIC_BUG << "Writing stream frame length failed";
-      return false;
-    }
-  }
 
   if (data_producer_ != nullptr) {
     DCHECK_EQ(nullptr, frame.data_buffer);
@@ -2075,6 +2199,29 @@ bool QuicFramer::AppendStreamFrame(const QuicStreamFrame& frame,
   return true;
 }
 
+bool QuicFramer::AppendStreamFrameHeader(const QuicStreamFrame& frame,
+                                         bool no_stream_frame_length,
+                                         QuicDataWriter* writer) {
+  if (!AppendStreamId(GetStreamIdSize(frame.stream_id), frame.stream_id,
+                      writer)) {
+    QUIC_BUG << "Writing stream id size failed.";
+    return false;
+  }
+  if (!AppendStreamOffset(GetStreamOffsetSize(transport_version_, frame.offset),
+                          frame.offset, writer)) {
+    QUIC_BUG << "Writing offset size failed.";
+    return false;
+  }
+  if (!no_stream_frame_length) {
+    if ((frame.data_length > std::numeric_limits<uint16_t>::max()) ||
+        !writer->WriteUInt16(static_cast<uint16_t>(frame.data_length))) {
+      QUIC_BUG << "Writing stream frame length failed";
+      return false;
+    }
+  }
+  return true;
+}
+
 void QuicFramer::set_version(const QuicTransportVersion version) {
   DCHECK(IsSupportedVersion(version)) << QuicVersionToString(version);
   transport_version_ = version;
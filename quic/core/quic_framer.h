@@ -274,6 +274,10 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   bool AppendStreamFrame(const QuicStreamFrame& frame,
                          bool last_frame_in_packet,
                          QuicDataWriter* writer);
+  // Appends the fields of |frame| which precede its data.
+  bool AppendStreamFrameHeader(const QuicStreamFrame& frame,
+                               bool last_frame_in_packet,
+                               QuicDataWriter* writer);
 
   // SetDecrypter sets the primary decrypter, replacing any that already exists,
   // and takes ownership. If an alternative decrypter is in place then the
@@ -309,6 +313,17 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
                         size_t buffer_len,
                         char* buffer);
 
+  // Same as EncryptInPlace(), except that the plaintext in |buffer| is
+  // followed by |trailing_data|, which is encrypted into |buffer| straight from
+  // where it lies. |total_len| does not include |trailing_data|.
+  size_t EncryptInPlaceWithTrailingData(EncryptionLevel level,
+                                        QuicPacketNumber packet_number,
+                                        size_t ad_len,
+                                        size_t total_len,
+                                        QuicStringPiece trailing_data,
+                                        size_t buffer_len,
+                                        char* buffer);
+
   // Returns the length of the data encrypted into |buffer| if |buffer_len| is
   // long enough, and otherwise 0.
   size_t EncryptPayload(EncryptionLevel level,
@@ -340,7 +355,10 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   // Returns byte order to read/write integers and floating numbers.
   Endianness endianness() const;
 
-  void set_validate_flags(bool value) { validate_flags_ = value; }
+  void set_validate_flags(bool value) {
+    validate_flags_ = value;
+    cached_public_header_.valid = false;
+  }
 
   Perspective perspective() const { return perspective_; }
 
@@ -350,6 +368,8 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
     data_producer_ = data_producer;
   }
 
+  QuicStreamFrameDataProducer* data_producer() const { return data_producer_; }
+
  private:
   friend class test::QuicFramerPeer;
 
@@ -368,6 +388,16 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
     size_t num_ack_blocks;
   };
 
+  // Decoding of the public flags of the last packet which carried neither
+  // version nor reset flags.
+  struct CachedPublicHeader {
+    bool valid = false;
+    uint8_t public_flags = 0;
+    QuicConnectionIdLength connection_id_length = PACKET_8BYTE_CONNECTION_ID;
+    QuicPacketNumberLength packet_number_length = PACKET_6BYTE_PACKET_NUMBER;
+    bool has_nonce = false;
+  };
+
   bool ProcessDataPacket(QuicDataReader* reader,
                          QuicPacketHeader* header,
                          const QuicEncryptedPacket& packet,
@@ -424,6 +454,20 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
                       size_t buffer_length,
                       size_t* decrypted_length);
 
+  // Returns true if the payload of |packet| can be decrypted where it lies.
+  // That requires a writable packet and a single, forward secure decrypter,
+  // since trial decryption and queueing of undecryptable packets both need the
+  // ciphertext to survive a failed attempt.
+  bool CanDecryptInPlace(const QuicEncryptedPacket& packet) const;
+
+  // Decrypts the payload of |packet| in place and sets |decrypted_data| to the
+  // plaintext.
+  bool DecryptPayloadInPlace(QuicDataReader* encrypted_reader,
+                             const QuicPacketHeader& header,
+                             const QuicEncryptedPacket& packet,
+                             char** decrypted_data,
+                             size_t* decrypted_length);
+
   // Returns the full packet number from the truncated
   // wire format version and the last seen packet number.
   QuicPacketNumber CalculatePacketNumberFromWire(
@@ -546,6 +590,9 @@ class QUIC_EXPORT_PRIVATE QuicFramer {
   QuicTime::Delta last_timestamp_;
   // The diversification nonce from the last received packet.
   DiversificationNonce last_nonce_;
+  // Lets ProcessPublicHeader skip decoding and validating the public flags of
+  // the common short header packet.
+  CachedPublicHeader cached_public_header_;
 
   // If not null, framer asks data_producer_ to write stream frame data. Not
   // owned. TODO(fayang): Consider add data producer to framer's constructor.
@@ -0,0 +1,104 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_framer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/test/perf_time_logger.h"
+#include "net/quic/core/quic_packets.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/quic/test_tools/quic_test_utils.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kIterations = 1000000;
+const QuicConnectionId kConnectionId = UINT64_C(0xFEDCBA9876543210);
+const QuicPacketNumber kPacketNumber = UINT64_C(0x123456789ABC);
+
+class QuicFramerPerfTest : public QuicTest {
+ protected:
+  // Serializes a forward secure data packet from a client which carries
+  // |num_stream_frames| stream frames of |frame_size| bytes each, followed by
+  // a PING frame.
+  std::unique_ptr<QuicEncryptedPacket> BuildPacket(
+      QuicTransportVersion version,
+      size_t num_stream_frames,
+      size_t frame_size) {
+    QuicFramer framer(QuicTransportVersionVector{version}, QuicTime::Zero(),
+                      Perspective::IS_CLIENT);
+    QuicPacketHeader header;
+    header.connection_id = kConnectionId;
+    header.packet_number = kPacketNumber;
+
+    const std::string data(frame_size, 'a');
+    std::vector<QuicStreamFrame> stream_frames;
+    for (size_t i = 0; i < num_stream_frames; ++i) {
+      const QuicStreamId stream_id = kHeadersStreamId + 2 * (i + 1);
+      stream_frames.push_back(
+          QuicStreamFrame(stream_id, false, 0, QuicStringPiece(data)));
+    }
+    QuicFrames frames;
+    for (QuicStreamFrame& frame : stream_frames) {
+      frames.push_back(QuicFrame(&frame));
+    }
+    frames.push_back(QuicFrame(QuicPingFrame()));
+
+    std::unique_ptr<QuicPacket> packet(
+        BuildUnsizedDataPacket(&framer, header, frames));
+    EXPECT_TRUE(packet != nullptr);
+    char* buffer = new char[kMaxPacketSize];
+    size_t length = framer.EncryptPayload(ENCRYPTION_NONE, kPacketNumber,
+                                          *packet, buffer, kMaxPacketSize);
+    EXPECT_NE(0u, length);
+    return QuicMakeUnique<QuicEncryptedPacket>(buffer, length, true);
+  }
+
+  void Benchmark(const char* name,
+                 QuicTransportVersion version,
+                 size_t num_stream_frames,
+                 size_t frame_size) {
+    std::unique_ptr<QuicEncryptedPacket> packet =
+        BuildPacket(version, num_stream_frames, frame_size);
+    QuicFramer framer(QuicTransportVersionVector{version}, QuicTime::Zero(),
+                      Perspective::IS_SERVER);
+    NoOpFramerVisitor visitor;
+    framer.set_visitor(&visitor);
+
+    base::PerfTimeLogger timer(name);
+    for (int i = 0; i < kIterations; ++i) {
+      if (!framer.ProcessPacket(*packet)) {
+        ADD_FAILURE() << "Failed to process packet: "
+                      << framer.detailed_error();
+        return;
+      }
+    }
+    timer.Done();
+  }
+};
+
+TEST_F(QuicFramerPerfTest, ProcessSmallFrames) {
+  Benchmark("QuicFramer_process_small_frames", QuicVersionMax(),
+            /*num_stream_frames=*/20, /*frame_size=*/40);
+}
+
+TEST_F(QuicFramerPerfTest, ProcessFullStreamFrame) {
+  Benchmark("QuicFramer_process_full_stream_frame", QuicVersionMax(),
+            /*num_stream_frames=*/1, /*frame_size=*/1200);
+}
+
+TEST_F(QuicFramerPerfTest, ProcessSmallFramesPreVersion41) {
+  Benchmark("QuicFramer_process_small_frames_pre_v41", QUIC_VERSION_39,
+            /*num_stream_frames=*/20, /*frame_size=*/40);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -110,10 +110,21 @@ class TestDecrypter : public QuicDecrypter {
     packet_number_ = packet_number;
     associated_data_ = associated_data.as_string();
     ciphertext_ = ciphertext.as_string();
-    memcpy(output, ciphertext.data(), ciphertext.length());
+    memmove(output, ciphertext.data(), ciphertext.length());
     *output_length = ciphertext.length();
     return true;
   }
+  bool DecryptPacketInPlace(QuicTransportVersion version,
+                            QuicPacketNumber packet_number,
+                            QuicStringPiece associated_data,
+                            char* buffer,
+                            size_t ciphertext_length,
+                            size_t* output_length) override {
+    in_place_buffer_ = buffer;
+    return DecryptPacket(version, packet_number, associated_data,
+                         QuicStringPiece(buffer, ciphertext_length), buffer,
+                         output_length, ciphertext_length);
+  }
   QuicStringPiece GetKey() const override { return QuicStringPiece(); }
   QuicStringPiece GetNoncePrefix() const override { return QuicStringPiece(); }
   // Use a distinct value starting with 0xFFFFFF, which is never used by TLS.
@@ -122,6 +133,8 @@ class TestDecrypter : public QuicDecrypter {
   QuicPacketNumber packet_number_;
   string associated_data_;
   string ciphertext_;
+  // Set to the buffer passed to DecryptPacketInPlace().
+  char* in_place_buffer_ = nullptr;
 };
 
 class TestQuicVisitor : public QuicFramerVisitorInterface {
@@ -3064,6 +3077,155 @@ TEST_P(QuicFramerTest, PingFrame) {
   // No need to check the PING frame boundaries because it has no payload.
 }
 
+TEST_P(QuicFramerTest, DecryptPacketInPlace) {
+  FLAGS_quic_reloadable_flag_quic_decrypt_packets_in_place = true;
+  decrypter_ = new test::TestDecrypter();
+  framer_.SetDecrypter(ENCRYPTION_FORWARD_SECURE, decrypter_);
+
+  // clang-format off
+  unsigned char packet[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+     // packet number
+     0xBC, 0x9A, 0x78, 0x56,
+     0x34, 0x12,
+
+     // frame type (ping frame)
+     0x07,
+    };
+
+  unsigned char packet39[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+     // packet number
+     0x12, 0x34, 0x56, 0x78,
+     0x9A, 0xBC,
+
+     // frame type (ping frame)
+     0x07,
+    };
+  // clang-format on
+
+  char* buffer = AsChars(framer_.transport_version() <= QUIC_VERSION_38
+                             ? packet
+                             : packet39);
+  // Without a writable buffer the payload is decrypted into scratch space.
+  QuicEncryptedPacket read_only(buffer, arraysize(packet), false);
+  EXPECT_TRUE(framer_.ProcessPacket(read_only));
+  EXPECT_EQ(nullptr, decrypter_->in_place_buffer_);
+  EXPECT_EQ(1u, visitor_.ping_frames_.size());
+
+  QuicEncryptedPacket encrypted(buffer, arraysize(packet), false);
+  encrypted.set_mutable_data(buffer);
+  EXPECT_TRUE(framer_.ProcessPacket(encrypted));
+  EXPECT_EQ(QUIC_NO_ERROR, framer_.error());
+  // The payload follows the 15 byte public header.
+  EXPECT_EQ(buffer + 15, decrypter_->in_place_buffer_);
+  EXPECT_EQ(2u, visitor_.ping_frames_.size());
+}
+
+TEST_P(QuicFramerTest, RepeatedPublicFlags) {
+  // clang-format off
+  unsigned char packet[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+     // packet number
+     0xBC, 0x9A, 0x78, 0x56,
+     0x34, 0x12,
+
+     // frame type (ping frame)
+     0x07,
+    };
+
+  unsigned char packet39[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10,
+     // packet number
+     0x12, 0x34, 0x56, 0x78,
+     0x9A, 0xBC,
+
+     // frame type (ping frame)
+     0x07,
+    };
+
+  unsigned char second_packet[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+     // packet number
+     0xBD, 0x9A, 0x78, 0x56,
+     0x34, 0x12,
+
+     // frame type (padding frame)
+     0x00,
+     0x00, 0x00,
+    };
+
+  unsigned char second_packet39[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // connection_id
+     0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE,
+     // packet number
+     0x12, 0x34, 0x56, 0x78,
+     0x9A, 0xBD,
+
+     // frame type (padding frame)
+     0x00,
+     0x00, 0x00,
+    };
+
+  unsigned char truncated_packet[] = {
+     // public flags (8 byte connection_id)
+     0x38,
+     // truncated connection_id
+     0xFE, 0xDC, 0xBA, 0x98,
+    };
+  // clang-format on
+
+  const bool pre_39 = framer_.transport_version() <= QUIC_VERSION_38;
+  QuicEncryptedPacket encrypted(AsChars(pre_39 ? packet : packet39),
+                                arraysize(packet), false);
+  EXPECT_TRUE(framer_.ProcessPacket(encrypted));
+  ASSERT_TRUE(visitor_.header_.get());
+  EXPECT_EQ(kConnectionId, visitor_.header_->connection_id);
+  EXPECT_EQ(kPacketNumber, visitor_.header_->packet_number);
+  EXPECT_EQ(1u, visitor_.ping_frames_.size());
+
+  // The second packet reuses the decoded public flags of the first one, but
+  // the fields which follow them are read from the packet itself.
+  QuicEncryptedPacket second(
+      AsChars(pre_39 ? second_packet : second_packet39),
+      arraysize(second_packet), false);
+  EXPECT_TRUE(framer_.ProcessPacket(second));
+  EXPECT_EQ(QUIC_NO_ERROR, framer_.error());
+  EXPECT_FALSE(visitor_.header_->reset_flag);
+  EXPECT_FALSE(visitor_.header_->version_flag);
+  EXPECT_EQ(UINT64_C(0x1032547698BADCFE), visitor_.header_->connection_id);
+  EXPECT_EQ(PACKET_8BYTE_CONNECTION_ID,
+            visitor_.header_->connection_id_length);
+  EXPECT_EQ(PACKET_6BYTE_PACKET_NUMBER,
+            visitor_.header_->packet_number_length);
+  EXPECT_EQ(kPacketNumber + 1, visitor_.header_->packet_number);
+  EXPECT_EQ(nullptr, visitor_.header_->nonce);
+  EXPECT_EQ(1u, visitor_.padding_frames_.size());
+
+  QuicEncryptedPacket truncated(AsChars(truncated_packet),
+                                arraysize(truncated_packet), false);
+  EXPECT_FALSE(framer_.ProcessPacket(truncated));
+  EXPECT_EQ(QUIC_INVALID_PACKET_HEADER, framer_.error());
+  EXPECT_EQ("Unable to read ConnectionId.", framer_.detailed_error());
+}
+
 TEST_P(QuicFramerTest, PublicResetPacketV33) {
   // clang-format off
   PacketFragments packet = {
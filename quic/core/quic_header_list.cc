@@ -41,6 +41,12 @@ void QuicHeaderList::OnHeader(QuicStringPiece name, QuicStringPiece value) {
     current_header_list_size_ += name.size();
     current_header_list_size_ += value.size();
     current_header_list_size_ += kPerHeaderOverhead;
+    if (current_header_list_size_ > max_header_list_size_) {
+      // The list will be cleared by OnHeaderBlockEnd(), so release the
+      // headers buffered so far rather than copying this one.
+      header_list_.clear();
+      return;
+    }
     header_list_.emplace_back(string(name), string(value));
   }
 }
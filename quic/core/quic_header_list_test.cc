@@ -30,6 +30,8 @@ TEST_F(QuicHeaderListTest, TooLarge) {
   string value(1 << 18, '1');
   // Send a header that exceeds max_header_list_size.
   headers.OnHeader(key, value);
+  // Headers are dropped as soon as the limit is exceeded.
+  EXPECT_TRUE(headers.empty());
   // Send a second header exceeding max_header_list_size.
   headers.OnHeader(key + "2", value);
   // We should not allocate more memory after exceeding max_header_list_size.
@@ -10,6 +10,7 @@
 #include "base/macros.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
 #include "net/quic/core/quic_data_writer.h"
+#include "net/quic/core/quic_stream_frame_data_producer.h"
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/platform/api/quic_aligned.h"
 #include "net/quic/platform/api/quic_bug_tracker.h"
@@ -256,7 +257,11 @@ void QuicPacketCreator::Flush() {
     return;
   }
 
-  QUIC_CACHELINE_ALIGNED char serialized_packet_buffer[kMaxPacketSize];
+  QUIC_CACHELINE_ALIGNED char stack_buffer[kMaxPacketSize];
+  char* serialized_packet_buffer = delegate_->GetPacketBuffer();
+  if (serialized_packet_buffer == nullptr) {
+    serialized_packet_buffer = stack_buffer;
+  }
   SerializePacket(serialized_packet_buffer, kMaxPacketSize);
   OnSerializedPacket();
 }
@@ -301,8 +306,12 @@ void QuicPacketCreator::CreateAndSerializeStreamFrame(
   // Write out the packet header
   QuicPacketHeader header;
   FillPacketHeader(&header);
-  QUIC_CACHELINE_ALIGNED char encrypted_buffer[kMaxPacketSize];
-  QuicDataWriter writer(arraysize(encrypted_buffer), encrypted_buffer,
+  QUIC_CACHELINE_ALIGNED char stack_buffer[kMaxPacketSize];
+  char* encrypted_buffer = delegate_->GetPacketBuffer();
+  if (encrypted_buffer == nullptr) {
+    encrypted_buffer = stack_buffer;
+  }
+  QuicDataWriter writer(kMaxPacketSize, encrypted_buffer,
                         framer_->endianness());
   if (!framer_->AppendPacketHeader(header, &writer)) {
     QUIC_BUG << "AppendPacketHeader failed";
@@ -334,16 +343,38 @@ void QuicPacketCreator::CreateAndSerializeStreamFrame(
     QUIC_BUG << "AppendTypeByte failed";
     return;
   }
-  if (!framer_->AppendStreamFrame(*frame, /* no stream frame length */ true,
-                                  &writer)) {
+
+  // If the stream data is retained in a single buffer, let the encrypter read
+  // it from there rather than copying it into the packet first.
+  QuicStringPiece stream_data;
+  const bool zero_copy =
+      FLAGS_quic_reloadable_flag_quic_zero_copy_stream_frames &&
+      bytes_consumed > 0 && framer_->data_producer() != nullptr &&
+      framer_->data_producer()->GetStreamDataView(id, stream_offset,
+                                                  bytes_consumed, &stream_data);
+  if (zero_copy) {
+    if (!framer_->AppendStreamFrameHeader(
+            *frame, /* no stream frame length */ true, &writer)) {
+      QUIC_BUG << "AppendStreamFrameHeader failed";
+      return;
+    }
+  } else if (!framer_->AppendStreamFrame(
+                 *frame, /* no stream frame length */ true, &writer)) {
     QUIC_BUG << "AppendStreamFrame failed";
     return;
   }
 
-  size_t encrypted_length = framer_->EncryptInPlace(
-      packet_.encryption_level, packet_.packet_number,
-      GetStartOfEncryptedData(framer_->transport_version(), header),
-      writer.length(), arraysize(encrypted_buffer), encrypted_buffer);
+  const size_t ad_len =
+      GetStartOfEncryptedData(framer_->transport_version(), header);
+  size_t encrypted_length =
+      zero_copy ? framer_->EncryptInPlaceWithTrailingData(
+                      packet_.encryption_level, packet_.packet_number, ad_len,
+                      writer.length(), stream_data, kMaxPacketSize,
+                      encrypted_buffer)
+                : framer_->EncryptInPlace(packet_.encryption_level,
+                                          packet_.packet_number, ad_len,
+                                          writer.length(), kMaxPacketSize,
+                                          encrypted_buffer);
   if (encrypted_length == 0) {
     QUIC_BUG << "Failed to encrypt packet number " << header.packet_number;
     return;
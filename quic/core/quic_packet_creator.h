@@ -37,6 +37,12 @@ class QUIC_EXPORT_PRIVATE QuicPacketCreator {
     // of |serialized_packet|, but takes ownership of any frames it removes
     // from |packet.retransmittable_frames|.
     virtual void OnSerializedPacket(SerializedPacket* serialized_packet) = 0;
+
+    // Returns a buffer of at least kMaxPacketSize bytes into which the next
+    // packet should be serialized, or nullptr to serialize it into a
+    // temporary buffer.  The buffer must stay valid until OnSerializedPacket
+    // returns.
+    virtual char* GetPacketBuffer() { return nullptr; }
   };
 
   // Interface which gets callbacks from the QuicPacketCreator at interesting
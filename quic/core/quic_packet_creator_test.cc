@@ -904,6 +904,43 @@ TEST_P(QuicPacketCreatorTest, SerializeAndSendStreamFrame) {
   EXPECT_FALSE(creator_.HasPendingFrames());
 }
 
+TEST_P(QuicPacketCreatorTest, SerializeStreamFrameWithoutCopy) {
+  FLAGS_quic_reloadable_flag_quic_zero_copy_stream_frames = true;
+  if (!GetParam().version_serialization) {
+    creator_.StopSendingVersion();
+  }
+
+  MakeIOVector("test", &iov_);
+  producer_.SaveStreamData(kHeadersStreamId, &iov_, 1u, 0u, 0u, iov_.iov_len);
+  EXPECT_CALL(delegate_, OnSerializedPacket(_))
+      .WillOnce(Invoke(this, &QuicPacketCreatorTest::SaveSerializedPacket));
+  size_t num_bytes_consumed;
+  creator_.CreateAndSerializeStreamFrame(kHeadersStreamId, iov_.iov_len, 0, 0,
+                                         true, &num_bytes_consumed);
+  EXPECT_EQ(4u, num_bytes_consumed);
+  ASSERT_TRUE(serialized_packet_.encrypted_buffer);
+
+  // The stream data encrypted from the send buffer decrypts to the original.
+  QuicStreamFrame received_frame;
+  {
+    InSequence s;
+    EXPECT_CALL(framer_visitor_, OnPacket());
+    EXPECT_CALL(framer_visitor_, OnUnauthenticatedPublicHeader(_));
+    EXPECT_CALL(framer_visitor_, OnUnauthenticatedHeader(_));
+    EXPECT_CALL(framer_visitor_, OnDecryptedPacket(_));
+    EXPECT_CALL(framer_visitor_, OnPacketHeader(_));
+    EXPECT_CALL(framer_visitor_, OnStreamFrame(_))
+        .WillOnce(DoAll(SaveArg<0>(&received_frame), Return(true)));
+    EXPECT_CALL(framer_visitor_, OnPacketComplete());
+  }
+  ProcessPacket(serialized_packet_);
+  EXPECT_EQ(kHeadersStreamId, received_frame.stream_id);
+  EXPECT_TRUE(received_frame.fin);
+  EXPECT_EQ("test", QuicStringPiece(received_frame.data_buffer,
+                                    received_frame.data_length));
+  DeleteSerializedPacket();
+}
+
 TEST_P(QuicPacketCreatorTest, AddUnencryptedStreamDataClosesConnection) {
   creator_.set_encryption_level(ENCRYPTION_NONE);
   EXPECT_CALL(delegate_, OnUnrecoverableError(_, _, _));
@@ -8,13 +8,12 @@
 #include <cstddef>
 
 #include "net/quic/core/quic_packets.h"
+#include "net/quic/core/quic_types.h"
 #include "net/quic/platform/api/quic_export.h"
 #include "net/quic/platform/api/quic_socket_address.h"
 
 namespace net {
 
-struct WriteResult;
-
 class QUIC_EXPORT_PRIVATE PerPacketOptions {
  public:
   PerPacketOptions() = default;
@@ -66,6 +65,27 @@ class QUIC_EXPORT_PRIVATE QuicPacketWriter {
   // size of a valid QUIC packet.
   virtual QuicByteCount GetMaxPacketSize(
       const QuicSocketAddress& peer_address) const = 0;
+
+  // Returns true if this writer may hold packets passed to WritePacket and
+  // send them later, in a single batch, when Flush is called.  A batch mode
+  // writer reports WRITE_STATUS_OK for packets it has accepted but not yet
+  // sent.
+  virtual bool IsBatchMode() const { return false; }
+
+  // Sends all packets held by a batch mode writer.  Called by the owner of
+  // the writer at the end of each write loop.  Writers which do not batch
+  // have nothing to flush and return WRITE_STATUS_OK.
+  virtual WriteResult Flush() { return WriteResult(WRITE_STATUS_OK, 0); }
+
+  // Returns a buffer of at least kMaxPacketSize bytes into which the next
+  // packet to |peer_address| may be serialized, so that a batch mode writer
+  // can hold it without copying.  The buffer is only valid until the next call
+  // to WritePacket or Flush.  Returns nullptr if the writer has no such
+  // buffer, in which case WritePacket copies the packet if it needs to.
+  virtual char* GetNextWriteLocation(const QuicIpAddress& self_address,
+                                     const QuicSocketAddress& peer_address) {
+    return nullptr;
+  }
 };
 
 }  // namespace net
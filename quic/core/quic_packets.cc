@@ -4,9 +4,11 @@
 
 #include "net/quic/core/quic_packets.h"
 
+#include "net/quic/core/quic_buffer_allocator.h"
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/core/quic_versions.h"
 #include "net/quic/platform/api/quic_flags.h"
+#include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_str_cat.h"
 #include "net/quic/platform/api/quic_text_utils.h"
@@ -125,12 +127,12 @@ QuicPacket::QuicPacket(char* buffer,
       packet_number_length_(packet_number_length) {}
 
 QuicEncryptedPacket::QuicEncryptedPacket(const char* buffer, size_t length)
-    : QuicData(buffer, length) {}
+    : QuicData(buffer, length), mutable_data_(nullptr) {}
 
 QuicEncryptedPacket::QuicEncryptedPacket(const char* buffer,
                                          size_t length,
                                          bool owns_buffer)
-    : QuicData(buffer, length, owns_buffer) {}
+    : QuicData(buffer, length, owns_buffer), mutable_data_(nullptr) {}
 
 std::unique_ptr<QuicEncryptedPacket> QuicEncryptedPacket::Clone() const {
   char* buffer = new char[this->length()];
@@ -138,6 +140,11 @@ std::unique_ptr<QuicEncryptedPacket> QuicEncryptedPacket::Clone() const {
   return QuicMakeUnique<QuicEncryptedPacket>(buffer, this->length(), true);
 }
 
+void QuicEncryptedPacket::set_mutable_data(char* buffer) {
+  DCHECK_EQ(data(), buffer);
+  mutable_data_ = buffer;
+}
+
 std::ostream& operator<<(std::ostream& os, const QuicEncryptedPacket& s) {
   os << s.length() << "-byte data";
   return os;
@@ -252,4 +259,11 @@ char* CopyBuffer(const SerializedPacket& packet) {
   return dst_buffer;
 }
 
+char* CopyBuffer(const SerializedPacket& packet,
+                 QuicBufferAllocator* allocator) {
+  char* dst_buffer = allocator->New(packet.encrypted_length);
+  memcpy(dst_buffer, packet.encrypted_buffer, packet.encrypted_length);
+  return dst_buffer;
+}
+
 }  // namespace net
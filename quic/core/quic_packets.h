@@ -30,6 +30,7 @@
 
 namespace net {
 
+class QuicBufferAllocator;
 class QuicPacket;
 struct QuicPacketHeader;
 
@@ -155,6 +156,13 @@ class QUIC_EXPORT_PRIVATE QuicEncryptedPacket : public QuicData {
   // Clones the packet into a new packet which owns the buffer.
   std::unique_ptr<QuicEncryptedPacket> Clone() const;
 
+  // Allows the packet data to be modified while the packet is processed, for
+  // instance by decrypting it in place. |buffer| must point at data(). Clones
+  // do not inherit this.
+  void set_mutable_data(char* buffer);
+  // Returns the buffer passed to set_mutable_data(), or nullptr.
+  char* mutable_data() const { return mutable_data_; }
+
   // By default, gtest prints the raw bytes of an object. The bool data
   // member (in the base class QuicData) causes this object to have padding
   // bytes, which causes the default gtest object printer to read
@@ -164,6 +172,8 @@ class QUIC_EXPORT_PRIVATE QuicEncryptedPacket : public QuicData {
       const QuicEncryptedPacket& s);
 
  private:
+  char* mutable_data_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicEncryptedPacket);
 };
 
@@ -247,6 +257,11 @@ QUIC_EXPORT_PRIVATE void ClearSerializedPacket(
 // |packet.encrypted_buffer|.
 QUIC_EXPORT_PRIVATE char* CopyBuffer(const SerializedPacket& packet);
 
+// Same as above, but takes the buffer from |allocator|. The caller must
+// release it with |allocator|->Delete().
+QUIC_EXPORT_PRIVATE char* CopyBuffer(const SerializedPacket& packet,
+                                     QuicBufferAllocator* allocator);
+
 }  // namespace net
 
 #endif  // NET_QUIC_CORE_QUIC_PACKETS_H_
@@ -0,0 +1,206 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
+
+#include <vector>
+
+#include "net/quic/core/quic_constants.h"
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+namespace {
+
+// Space reserved in front of every buffer for the pool's bookkeeping. Keeps
+// the data that follows suitably aligned for any type.
+const size_t kHeaderSize = 16;
+
+}  // namespace
+
+const size_t QuicPooledBufferAllocator::kSizeClasses[] = {
+    kMaxPacketSize, 4 * 1024, 8 * 1024, 16 * 1024, 64 * 1024};
+const size_t QuicPooledBufferAllocator::kNumSizeClasses =
+    arraysize(QuicPooledBufferAllocator::kSizeClasses);
+const size_t QuicPooledBufferAllocator::kMaxIdleBytesPerSizeClass = 1 << 20;
+
+// Holds the free lists and the statistics. The pool stays alive as long as
+// either the allocator or one of its buffers does.
+class QuicPooledBufferAllocator::Pool {
+ public:
+  explicit Pool(size_t max_idle_bytes_per_size_class)
+      : free_lists_(kNumSizeClasses),
+        max_idle_bytes_per_size_class_(max_idle_bytes_per_size_class),
+        outstanding_(0),
+        orphaned_(false) {}
+
+  char* New(size_t size) {
+    ++stats_.allocations;
+    ++outstanding_;
+    const size_t size_class = SizeClassFor(size);
+    if (size_class == kNumSizeClasses) {
+      return Allocate(size);
+    }
+    std::vector<char*>* free_list = &free_lists_[size_class];
+    if (free_list->empty()) {
+      return Allocate(kSizeClasses[size_class]);
+    }
+    ++stats_.pool_hits;
+    char* buffer = free_list->back();
+    free_list->pop_back();
+    stats_.bytes_idle -= kSizeClasses[size_class];
+    return buffer;
+  }
+
+  // Returns |buffer| to the pool which allocated it.
+  static void Delete(char* buffer) {
+    BufferHeader* header = GetHeader(buffer);
+    header->pool->Release(buffer, header->capacity);
+  }
+
+  void ReleaseIdleBuffers() {
+    for (std::vector<char*>& free_list : free_lists_) {
+      for (char* buffer : free_list) {
+        Free(buffer, GetHeader(buffer)->capacity);
+      }
+      free_list.clear();
+    }
+    stats_.bytes_idle = 0;
+  }
+
+  // Called when the allocator owning this pool goes away.
+  void Orphan() {
+    orphaned_ = true;
+    ReleaseIdleBuffers();
+    if (outstanding_ == 0) {
+      delete this;
+    }
+  }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Stored in front of every buffer handed out by the pool.
+  struct BufferHeader {
+    Pool* pool;
+    // Usable size of the buffer, which is the size class for pooled buffers.
+    size_t capacity;
+  };
+  static_assert(sizeof(BufferHeader) <= kHeaderSize, "BufferHeader too large");
+
+  ~Pool() { DCHECK_EQ(0u, stats_.bytes_resident); }
+
+  static BufferHeader* GetHeader(char* buffer) {
+    return reinterpret_cast<BufferHeader*>(buffer - kHeaderSize);
+  }
+
+  // Returns the index of the smallest size class that fits |size|, or
+  // kNumSizeClasses if there is none.
+  static size_t SizeClassFor(size_t size) {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      if (size <= kSizeClasses[i]) {
+        return i;
+      }
+    }
+    return kNumSizeClasses;
+  }
+
+  char* Allocate(size_t capacity) {
+    char* block = new char[kHeaderSize + capacity];
+    BufferHeader* header = reinterpret_cast<BufferHeader*>(block);
+    header->pool = this;
+    header->capacity = capacity;
+    stats_.bytes_resident += capacity;
+    return block + kHeaderSize;
+  }
+
+  void Free(char* buffer, size_t capacity) {
+    stats_.bytes_resident -= capacity;
+    delete[](buffer - kHeaderSize);
+  }
+
+  void Release(char* buffer, size_t capacity) {
+    DCHECK_LT(0u, outstanding_);
+    --outstanding_;
+    const size_t size_class = SizeClassFor(capacity);
+    if (!orphaned_ && size_class < kNumSizeClasses &&
+        kSizeClasses[size_class] == capacity &&
+        (free_lists_[size_class].size() + 1) * capacity <=
+            max_idle_bytes_per_size_class_) {
+      free_lists_[size_class].push_back(buffer);
+      stats_.bytes_idle += capacity;
+      return;
+    }
+    Free(buffer, capacity);
+    if (orphaned_ && outstanding_ == 0) {
+      delete this;
+    }
+  }
+
+  std::vector<std::vector<char*>> free_lists_;
+  const size_t max_idle_bytes_per_size_class_;
+  // Number of buffers handed out and not yet deleted.
+  size_t outstanding_;
+  // True once the owning allocator has been destroyed.
+  bool orphaned_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(Pool);
+};
+
+double QuicPooledBufferAllocator::Stats::HitRate() const {
+  if (allocations == 0) {
+    return 0;
+  }
+  return static_cast<double>(pool_hits) / allocations;
+}
+
+QuicPooledBufferAllocator::QuicPooledBufferAllocator()
+    : QuicPooledBufferAllocator(kMaxIdleBytesPerSizeClass) {}
+
+QuicPooledBufferAllocator::QuicPooledBufferAllocator(
+    size_t max_idle_bytes_per_size_class)
+    : pool_(new Pool(max_idle_bytes_per_size_class)) {}
+
+QuicPooledBufferAllocator::~QuicPooledBufferAllocator() {
+  pool_->Orphan();
+}
+
+char* QuicPooledBufferAllocator::New(size_t size) {
+  return pool_->New(size);
+}
+
+char* QuicPooledBufferAllocator::New(size_t size, bool flag_enable) {
+  if (flag_enable) {
+    return New(size);
+  }
+  return new char[size];
+}
+
+void QuicPooledBufferAllocator::Delete(char* buffer) {
+  Release(buffer);
+}
+
+// static
+void QuicPooledBufferAllocator::Release(char* buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  Pool::Delete(buffer);
+}
+
+void QuicPooledBufferAllocator::MarkAllocatorIdle() {
+  pool_->ReleaseIdleBuffers();
+}
+
+bool QuicPooledBufferAllocator::IsPooled() const {
+  return true;
+}
+
+const QuicPooledBufferAllocator::Stats& QuicPooledBufferAllocator::stats()
+    const {
+  return pool_->stats();
+}
+
+}  // namespace net
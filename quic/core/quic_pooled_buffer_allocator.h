@@ -0,0 +1,87 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_QUIC_CORE_QUIC_POOLED_BUFFER_ALLOCATOR_H_
+#define NET_QUIC_CORE_QUIC_POOLED_BUFFER_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "net/quic/core/quic_buffer_allocator.h"
+#include "net/quic/platform/api/quic_export.h"
+
+namespace net {
+
+// A QuicBufferAllocator which recycles buffers through free lists of a few
+// fixed size classes, so that stream data slices and queued packets on the
+// send path do not go back to the heap for every allocation. Requests larger
+// than the largest size class are served directly from the heap.
+//
+// The allocator is not thread-safe. It is meant to be owned by a per-thread
+// object such as a connection helper, which makes its free lists effectively
+// thread-local. Buffers may outlive the allocator; they are then returned to
+// the heap when deleted.
+class QUIC_EXPORT_PRIVATE QuicPooledBufferAllocator
+    : public QuicBufferAllocator {
+ public:
+  struct QUIC_EXPORT_PRIVATE Stats {
+    // Returns the fraction of allocations served from a free list.
+    double HitRate() const;
+
+    // Number of buffers handed out by New().
+    uint64_t allocations = 0;
+    // Number of allocations served from a free list.
+    uint64_t pool_hits = 0;
+    // Bytes owned by the allocator, including buffers which are in use and
+    // buffers sitting on free lists.
+    uint64_t bytes_resident = 0;
+    // Bytes sitting on free lists.
+    uint64_t bytes_idle = 0;
+  };
+
+  // Sizes of the buffers kept on free lists, in increasing order. The first
+  // class holds a full packet.
+  static const size_t kSizeClasses[];
+  static const size_t kNumSizeClasses;
+
+  // Maximum number of idle bytes retained on the free list of each size
+  // class. Buffers released beyond that go back to the heap.
+  static const size_t kMaxIdleBytesPerSizeClass;
+
+  QuicPooledBufferAllocator();
+  // Retains at most |max_idle_bytes_per_size_class| idle bytes on the free
+  // list of each size class.
+  explicit QuicPooledBufferAllocator(size_t max_idle_bytes_per_size_class);
+  ~QuicPooledBufferAllocator() override;
+
+  // Releases |buffer|, which must have been returned by New() of some
+  // QuicPooledBufferAllocator, to the pool it came from. Unlike Delete(), this
+  // may be called after the allocator itself has been destroyed.
+  static void Release(char* buffer);
+
+  // QuicBufferAllocator implementation.
+  char* New(size_t size) override;
+  // Buffers returned with |flag_enable| false come straight from operator
+  // new[] and must be released with delete[] rather than Delete().
+  char* New(size_t size, bool flag_enable) override;
+  void Delete(char* buffer) override;
+  // Releases all buffers on the free lists back to the heap.
+  void MarkAllocatorIdle() override;
+  bool IsPooled() const override;
+
+  const Stats& stats() const;
+
+ private:
+  class Pool;
+
+  // Owned by this allocator and by the buffers it handed out.
+  Pool* pool_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicPooledBufferAllocator);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CORE_QUIC_POOLED_BUFFER_ALLOCATOR_H_
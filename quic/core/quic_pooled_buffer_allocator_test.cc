@@ -0,0 +1,125 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "net/quic/core/quic_constants.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class QuicPooledBufferAllocatorTest : public QuicTest {
+ protected:
+  QuicPooledBufferAllocator allocator_;
+};
+
+TEST_F(QuicPooledBufferAllocatorTest, DeleteNull) {
+  allocator_.Delete(nullptr);
+  EXPECT_EQ(0u, allocator_.stats().allocations);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, ReusesReleasedBuffer) {
+  char* buffer = allocator_.New(kMaxPacketSize);
+  memset(buffer, 0xaa, kMaxPacketSize);
+  EXPECT_EQ(1u, allocator_.stats().allocations);
+  EXPECT_EQ(0u, allocator_.stats().pool_hits);
+  EXPECT_EQ(kMaxPacketSize, allocator_.stats().bytes_resident);
+  EXPECT_EQ(0u, allocator_.stats().bytes_idle);
+
+  allocator_.Delete(buffer);
+  EXPECT_EQ(kMaxPacketSize, allocator_.stats().bytes_resident);
+  EXPECT_EQ(kMaxPacketSize, allocator_.stats().bytes_idle);
+
+  // A smaller request from the same size class gets the same buffer back.
+  char* reused = allocator_.New(100);
+  EXPECT_EQ(buffer, reused);
+  EXPECT_EQ(2u, allocator_.stats().allocations);
+  EXPECT_EQ(1u, allocator_.stats().pool_hits);
+  EXPECT_EQ(0.5, allocator_.stats().HitRate());
+  EXPECT_EQ(0u, allocator_.stats().bytes_idle);
+  allocator_.Delete(reused);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, SizeClasses) {
+  char* small = allocator_.New(1);
+  char* medium = allocator_.New(kMaxPacketSize + 1);
+  EXPECT_EQ(kMaxPacketSize + 4 * 1024, allocator_.stats().bytes_resident);
+  allocator_.Delete(small);
+  allocator_.Delete(medium);
+
+  // Each request is served from the free list of its own size class.
+  EXPECT_EQ(medium, allocator_.New(4 * 1024));
+  EXPECT_EQ(small, allocator_.New(kMaxPacketSize));
+  EXPECT_EQ(2u, allocator_.stats().pool_hits);
+  allocator_.Delete(small);
+  allocator_.Delete(medium);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, OversizedBuffersAreNotPooled) {
+  const size_t size = 64 * 1024 + 1;
+  char* buffer = allocator_.New(size);
+  memset(buffer, 0xaa, size);
+  EXPECT_EQ(size, allocator_.stats().bytes_resident);
+  allocator_.Delete(buffer);
+  EXPECT_EQ(0u, allocator_.stats().bytes_resident);
+  EXPECT_EQ(0u, allocator_.stats().bytes_idle);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, IdleBytesAreCapped) {
+  const size_t size = 64 * 1024;
+  const size_t count =
+      QuicPooledBufferAllocator::kMaxIdleBytesPerSizeClass / size + 4;
+  std::vector<char*> buffers;
+  for (size_t i = 0; i < count; ++i) {
+    buffers.push_back(allocator_.New(size));
+  }
+  for (char* buffer : buffers) {
+    allocator_.Delete(buffer);
+  }
+  EXPECT_EQ(QuicPooledBufferAllocator::kMaxIdleBytesPerSizeClass,
+            allocator_.stats().bytes_idle);
+  EXPECT_EQ(allocator_.stats().bytes_idle, allocator_.stats().bytes_resident);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, CustomIdleBytesCap) {
+  QuicPooledBufferAllocator allocator(8 * 1024);
+  char* first = allocator.New(8 * 1024);
+  char* second = allocator.New(8 * 1024);
+  allocator.Delete(first);
+  QuicPooledBufferAllocator::Release(second);
+  EXPECT_EQ(8 * 1024u, allocator.stats().bytes_idle);
+  EXPECT_EQ(8 * 1024u, allocator.stats().bytes_resident);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, MarkAllocatorIdleReleasesFreeLists) {
+  allocator_.Delete(allocator_.New(10));
+  allocator_.Delete(allocator_.New(10000));
+  EXPECT_LT(0u, allocator_.stats().bytes_idle);
+
+  allocator_.MarkAllocatorIdle();
+  EXPECT_EQ(0u, allocator_.stats().bytes_idle);
+  EXPECT_EQ(0u, allocator_.stats().bytes_resident);
+}
+
+TEST_F(QuicPooledBufferAllocatorTest, BufferOutlivesAllocator) {
+  auto allocator = QuicMakeUnique<QuicPooledBufferAllocator>();
+  char* buffer = allocator->New(kMaxPacketSize);
+  allocator->Delete(allocator->New(kMaxPacketSize));
+  allocator.reset();
+  memset(buffer, 0xaa, kMaxPacketSize);
+  // Deleting through another allocator releases the buffer to its own pool.
+  allocator_.Delete(buffer);
+  EXPECT_EQ(0u, allocator_.stats().bytes_resident);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -85,6 +85,7 @@ QuicSentPacketManager::QuicSentPacketManager(
       largest_mtu_acked_(0),
       handshake_confirmed_(false),
       largest_packet_peer_knows_is_acked_(0) {
+  pacing_sender_.set_stats(stats);
   SetSendAlgorithm(congestion_control_type);
 }
 
@@ -119,6 +120,10 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
              config.HasClientRequestedIndependentOption(kTPCC, perspective_)) {
     SetSendAlgorithm(kPCC);
   }
+  if (FLAGS_quic_reloadable_flag_quic_enable_bbr2 &&
+      config.HasClientRequestedIndependentOption(kB2ON, perspective_)) {
+    SetSendAlgorithm(kBBRv2);
+  }
 
   using_pacing_ = !FLAGS_quic_disable_pacing_for_perf_tests;
 
@@ -193,6 +198,11 @@ QuicBandwidth QuicSentPacketManager::MaxPacingRate() const {
   return pacing_sender_.max_pacing_rate();
 }
 
+void QuicSentPacketManager::SetPacingAlarmGranularity(
+    QuicTime::Delta alarm_granularity) {
+  pacing_sender_.set_alarm_granularity(alarm_granularity);
+}
+
 void QuicSentPacketManager::SetHandshakeConfirmed() {
   handshake_confirmed_ = true;
 }
@@ -274,6 +284,11 @@ void QuicSentPacketManager::MaybeInvokeCongestionEvent(
   }
   packets_acked_.clear();
   packets_lost_.clear();
+  if (congestion_control_telemetry_ != nullptr) {
+    congestion_control_telemetry_->OnCongestionEvent(
+        event_time, *send_algorithm_, rtt_stats_,
+        unacked_packets_.bytes_in_flight());
+  }
   if (network_change_visitor_ != nullptr) {
     network_change_visitor_->OnCongestionChange();
   }
@@ -284,6 +299,10 @@ void QuicSentPacketManager::HandleAckForSentPackets(
   // Go through the packets we have not received an ack for and see if this
   // incoming_ack shows they've been seen by the peer.
   QuicTime::Delta ack_delay_time = ack_frame.ack_delay_time;
+  // Both the unacked packets and the acked intervals are sorted, so walk them
+  // in lockstep rather than looking up every packet in the ack frame.
+  PacketNumberQueue::const_iterator acked_interval = ack_frame.packets.begin();
+  const PacketNumberQueue::const_iterator acked_end = ack_frame.packets.end();
   QuicPacketNumber packet_number = unacked_packets_.GetLeastUnacked();
   for (QuicUnackedPacketMap::iterator it = unacked_packets_.begin();
        it != unacked_packets_.end(); ++it, ++packet_number) {
@@ -294,7 +313,12 @@ void QuicSentPacketManager::HandleAckForSentPackets(
     if (it->is_unackable) {
       continue;
     }
-    if (!ack_frame.packets.Contains(packet_number)) {
+    while (acked_interval != acked_end &&
+           (*acked_interval).max() <= packet_number) {
+      ++acked_interval;
+    }
+    if (acked_interval == acked_end ||
+        !(*acked_interval).Contains(packet_number)) {
       // Packet is still missing.
       continue;
     }
@@ -949,6 +973,13 @@ const SendAlgorithmInterface* QuicSentPacketManager::GetSendAlgorithm() const {
   return send_algorithm_.get();
 }
 
+void QuicSentPacketManager::EnableCongestionControlTelemetry(
+    size_t capacity,
+    QuicTime::Delta sampling_interval) {
+  congestion_control_telemetry_.reset(
+      new CongestionControlTelemetry(capacity, sampling_interval));
+}
+
 void QuicSentPacketManager::SetStreamNotifier(
     StreamNotifierInterface* stream_notifier) {
   unacked_packets_.SetStreamNotifier(stream_notifier);
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "net/quic/core/congestion_control/congestion_control_telemetry.h"
 #include "net/quic/core/congestion_control/general_loss_algorithm.h"
 #include "net/quic/core/congestion_control/loss_detection_interface.h"
 #include "net/quic/core/congestion_control/pacing_sender.h"
@@ -107,6 +108,9 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   QuicBandwidth MaxPacingRate() const;
 
+  // Sets the resolution of the alarm used to send paced packets.
+  void SetPacingAlarmGranularity(QuicTime::Delta alarm_granularity);
+
   void SetHandshakeConfirmed();
 
   // Processes the incoming ack.
@@ -229,6 +233,18 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
 
   const SendAlgorithmInterface* GetSendAlgorithm() const;
 
+  // Starts recording the state of the send algorithm after congestion events,
+  // at most once per |sampling_interval| and on every mode change, in a buffer
+  // of |capacity| records which the embedder drains through
+  // congestion_control_telemetry().
+  void EnableCongestionControlTelemetry(size_t capacity,
+                                        QuicTime::Delta sampling_interval);
+
+  // Returns nullptr unless EnableCongestionControlTelemetry() was called.
+  CongestionControlTelemetry* congestion_control_telemetry() {
+    return congestion_control_telemetry_.get();
+  }
+
   void SetStreamNotifier(StreamNotifierInterface* stream_notifier);
 
   QuicPacketNumber largest_packet_peer_knows_is_acked() const {
@@ -417,6 +433,9 @@ class QUIC_EXPORT_PRIVATE QuicSentPacketManager {
   // The largest acked value that was sent in an ack, which has then been acked.
   QuicPacketNumber largest_packet_peer_knows_is_acked_;
 
+  // Records the state of |send_algorithm_| if enabled.
+  std::unique_ptr<CongestionControlTelemetry> congestion_control_telemetry_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicSentPacketManager);
 };
 
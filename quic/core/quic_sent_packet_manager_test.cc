@@ -931,7 +931,7 @@ TEST_F(QuicSentPacketManagerTest, NewRetransmissionTimeout) {
   EXPECT_CALL(*send_algorithm_, PacingRate(_))
       .WillRepeatedly(Return(QuicBandwidth::Zero()));
   EXPECT_CALL(*send_algorithm_, GetCongestionWindow())
-      .WillOnce(Return(10 * kDefaultTCPMSS));
+      .WillRepeatedly(Return(10 * kDefaultTCPMSS));
   manager_.SetFromConfig(client_config);
   EXPECT_TRUE(QuicSentPacketManagerPeer::GetUseNewRto(&manager_));
 
@@ -1621,6 +1621,32 @@ TEST_F(QuicSentPacketManagerTest, PathMtuIncreased) {
   manager_.OnIncomingAck(ack_frame, clock_.Now());
 }
 
+TEST_F(QuicSentPacketManagerTest, CongestionControlTelemetry) {
+  EXPECT_EQ(nullptr, manager_.congestion_control_telemetry());
+  manager_.EnableCongestionControlTelemetry(
+      10, QuicTime::Delta::FromMilliseconds(100));
+  ASSERT_NE(nullptr, manager_.congestion_control_telemetry());
+
+  SendDataPacket(1);
+  clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(20));
+  ExpectAck(1);
+  EXPECT_CALL(*send_algorithm_, GetTelemetryMode()).WillRepeatedly(Return(2));
+  EXPECT_CALL(*send_algorithm_, PacingRate(_))
+      .WillRepeatedly(Return(QuicBandwidth::FromKBitsPerSecond(500)));
+  EXPECT_CALL(*send_algorithm_, GetCongestionWindow())
+      .WillRepeatedly(Return(10 * kDefaultTCPMSS));
+  manager_.OnIncomingAck(InitAckFrame(1), clock_.Now());
+
+  std::vector<CongestionControlTelemetry::Record> records;
+  ASSERT_EQ(1u, manager_.congestion_control_telemetry()->Drain(&records));
+  EXPECT_EQ(clock_.Now(), records[0].time);
+  EXPECT_EQ(2u, records[0].mode);
+  EXPECT_EQ(QuicBandwidth::FromKBitsPerSecond(500), records[0].pacing_rate);
+  EXPECT_EQ(10 * kDefaultTCPMSS, records[0].congestion_window);
+  EXPECT_EQ(0u, records[0].bytes_in_flight);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(20), records[0].min_rtt);
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
@@ -127,7 +127,7 @@ class QuicServerSessionBaseTest
                        QuicRandom::GetInstance(),
                        std::move(proof_source)),
         compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize) {
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes) {
     config_.SetMaxStreamsPerConnection(kMaxStreamsForTest, kMaxStreamsForTest);
     config_.SetMaxIncomingDynamicStreamsToSend(kMaxStreamsForTest);
     QuicConfigPeer::SetReceivedMaxIncomingDynamicStreams(&config_,
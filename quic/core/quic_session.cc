@@ -26,6 +26,10 @@ namespace {
 // TODO(fayang): use a real stateless reset token instead of a hard code one.
 const uint128 kStatelessResetToken = 1010101;
 
+// Idle bytes kept for reuse per size class of the stream sequencer buffer
+// allocator. Small, as a busy server holds many mostly idle sessions.
+const size_t kMaxIdleSequencerBufferBytes = 64 * 1024;
+
 }  // namespace
 
 #define ENDPOINT \
@@ -36,6 +40,7 @@ QuicSession::QuicSession(QuicConnection* connection,
                          const QuicConfig& config)
     : connection_(connection),
       visitor_(owner),
+      stream_sequencer_buffer_allocator_(kMaxIdleSequencerBufferBytes),
       config_(config),
       max_open_outgoing_streams_(kDefaultMaxStreamsPerConnection),
       max_open_incoming_streams_(config_.GetMaxIncomingDynamicStreamsToSend()),
@@ -56,7 +61,10 @@ QuicSession::QuicSession(QuicConnection* connection,
       currently_writing_stream_id_(0),
       can_use_slices_(FLAGS_quic_reloadable_flag_quic_use_mem_slices),
       allow_multiple_acks_for_data_(
-          FLAGS_quic_reloadable_flag_quic_allow_multiple_acks_for_data2) {
+          FLAGS_quic_reloadable_flag_quic_allow_multiple_acks_for_data2),
+      buffered_stream_data_bytes_(0),
+      buffered_stream_data_limit_(
+          GetQuicFlag(FLAGS_quic_session_buffered_data_limit)) {
   if (allow_multiple_acks_for_data_) {
     QUIC_FLAG_COUNT(quic_reloadable_flag_quic_allow_multiple_acks_for_data2);
   }
@@ -432,6 +440,9 @@ void QuicSession::CloseStreamInner(QuicStreamId stream_id, bool locally_reset) {
     closed_streams_.push_back(std::move(it->second));
   }
 
+  // A closed stream never sends the data it still has buffered.
+  RemoveBufferedStreamDataBytes(stream->BufferedDataBytes());
+
   // If we haven't received a FIN or RST for this stream, we need to keep track
   // of the how many bytes the stream's flow controller believes it has
   // received, for accurate connection level flow control accounting.
@@ -445,11 +456,9 @@ void QuicSession::CloseStreamInner(QuicStreamId stream_id, bool locally_reset) {
     --num_dynamic_incoming_streams_;
   }
 
-  if (draining_streams_.find(stream_id) != draining_streams_.end() &&
-      IsIncomingStream(stream_id)) {
+  if (draining_streams_.erase(stream_id) > 0 && IsIncomingStream(stream_id)) {
     --num_draining_incoming_streams_;
   }
-  draining_streams_.erase(stream_id);
 
   stream->OnClose();
   // Decrease the number of streams being emulated when a new one is opened.
@@ -459,8 +468,7 @@ void QuicSession::CloseStreamInner(QuicStreamId stream_id, bool locally_reset) {
 void QuicSession::OnFinalByteOffsetReceived(
     QuicStreamId stream_id,
     QuicStreamOffset final_byte_offset) {
-  std::map<QuicStreamId, QuicStreamOffset>::iterator it =
-      locally_closed_streams_highest_offset_.find(stream_id);
+  auto it = locally_closed_streams_highest_offset_.find(stream_id);
   if (it == locally_closed_streams_highest_offset_.end()) {
     return;
   }
@@ -756,6 +764,20 @@ bool QuicSession::MaybeIncreaseLargestPeerStreamId(
   return true;
 }
 
+void QuicSession::AddBufferedStreamDataBytes(QuicByteCount bytes) {
+  buffered_stream_data_bytes_ += bytes;
+}
+
+void QuicSession::RemoveBufferedStreamDataBytes(QuicByteCount bytes) {
+  DCHECK_GE(buffered_stream_data_bytes_, bytes);
+  buffered_stream_data_bytes_ -= bytes;
+}
+
+bool QuicSession::IsBufferedStreamDataOverLimit() const {
+  return buffered_stream_data_limit_ != 0 &&
+         buffered_stream_data_bytes_ > buffered_stream_data_limit_;
+}
+
 bool QuicSession::ShouldYield(QuicStreamId stream_id) {
   if (stream_id == currently_writing_stream_id_) {
     return false;
@@ -1009,6 +1031,17 @@ bool QuicSession::WriteStreamData(QuicStreamId id,
   return stream->WriteStreamData(offset, data_length, writer);
 }
 
+bool QuicSession::GetStreamDataView(QuicStreamId id,
+                                    QuicStreamOffset offset,
+                                    QuicByteCount data_length,
+                                    QuicStringPiece* data) {
+  QuicStream* stream = GetStream(id);
+  if (stream == nullptr) {
+    return false;
+  }
+  return stream->GetStreamDataView(offset, data_length, data);
+}
+
 uint128 QuicSession::GetStatelessResetToken() const {
   return kStatelessResetToken;
 }
@@ -20,6 +20,7 @@
 #include "net/quic/core/quic_crypto_stream.h"
 #include "net/quic/core/quic_packet_creator.h"
 #include "net/quic/core/quic_packets.h"
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
 #include "net/quic/core/quic_stream.h"
 #include "net/quic/core/quic_stream_frame_data_producer.h"
 #include "net/quic/core/quic_write_blocked_list.h"
@@ -121,6 +122,10 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
                        QuicStreamOffset offset,
                        QuicByteCount data_length,
                        QuicDataWriter* writer) override;
+  bool GetStreamDataView(QuicStreamId id,
+                         QuicStreamOffset offset,
+                         QuicByteCount data_length,
+                         QuicStringPiece* data) override;
 
   // StreamNotifierInterface methods:
   void OnStreamFrameAcked(const QuicStreamFrame& frame,
@@ -247,6 +252,12 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
 
   QuicFlowController* flow_controller() { return &flow_controller_; }
 
+  // Returns the allocator the sequencer buffers of this session's streams
+  // draw their blocks from.
+  QuicPooledBufferAllocator* stream_sequencer_buffer_allocator() {
+    return &stream_sequencer_buffer_allocator_;
+  }
+
   // Returns true if connection is flow controller blocked.
   bool IsConnectionFlowControlBlocked() const;
 
@@ -277,6 +288,20 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
 
   bool can_use_slices() const { return can_use_slices_; }
 
+  // Called by streams when they buffer |bytes| of data, and when they send or
+  // discard |bytes| of buffered data.
+  void AddBufferedStreamDataBytes(QuicByteCount bytes);
+  void RemoveBufferedStreamDataBytes(QuicByteCount bytes);
+
+  // The number of bytes of data which streams have buffered but not yet sent.
+  QuicByteCount buffered_stream_data_bytes() const {
+    return buffered_stream_data_bytes_;
+  }
+
+  // Returns true if buffered_stream_data_bytes() is above the session's limit,
+  // in which case streams which still have buffered data do not accept more.
+  bool IsBufferedStreamDataOverLimit() const;
+
   bool allow_multiple_acks_for_data() const {
     return allow_multiple_acks_for_data_;
   }
@@ -426,7 +451,7 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
 
   // Keep track of highest received byte offset of locally closed streams, while
   // waiting for a definitive final highest offset from the peer.
-  std::map<QuicStreamId, QuicStreamOffset>
+  QuicUnorderedMap<QuicStreamId, QuicStreamOffset>
       locally_closed_streams_highest_offset_;
 
   QuicConnection* connection_;
@@ -434,6 +459,10 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // May be null.
   Visitor* visitor_;
 
+  // Shared by the stream sequencers of this session, so that blocks freed by
+  // one stream are reused by the next.
+  QuicPooledBufferAllocator stream_sequencer_buffer_allocator_;
+
   ClosedStreams closed_streams_;
 
   // Streams which are closed, but need to be kept alive. Currently, the only
@@ -499,6 +528,12 @@ class QUIC_EXPORT_PRIVATE QuicSession : public QuicConnectionVisitorInterface,
   // Latched value of quic_reloadable_flag_quic_allow_multiple_acks_for_data2.
   const bool allow_multiple_acks_for_data_;
 
+  // Total bytes of data buffered but not yet sent by the open streams.
+  QuicByteCount buffered_stream_data_bytes_;
+
+  // Latched value of FLAGS_quic_session_buffered_data_limit. 0 means no limit.
+  const QuicByteCount buffered_stream_data_limit_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicSession);
 };
 
@@ -1111,6 +1111,51 @@ TEST_P(QuicSessionTestServer, ConnectionFlowControlAccountingFinAndLocalReset) {
             session_.flow_controller()->bytes_consumed());
 }
 
+TEST_P(QuicSessionTestServer, BufferedStreamDataBytesOnDoubleClose) {
+  // Buffer data on a stream which is flow control blocked.
+  TestStream* stream = session_.CreateOutgoingDynamicStream();
+  QuicFlowControllerPeer::SetSendWindowOffset(stream->flow_controller(), 0);
+  EXPECT_CALL(*connection_, SendBlocked(stream->id()));
+  stream->WriteOrBufferData("not empty", false, nullptr);
+  EXPECT_EQ(9u, session_.buffered_stream_data_bytes());
+
+  // Closing the stream drops its buffered data from the session's count.
+  CloseStream(stream->id());
+  EXPECT_EQ(0u, session_.buffered_stream_data_bytes());
+
+  // Closing it again must not subtract the same bytes a second time.
+  session_.CloseStream(stream->id());
+  EXPECT_EQ(0u, session_.buffered_stream_data_bytes());
+}
+
+TEST_P(QuicSessionTestServer, BufferedStreamDataBytesOnResetThenClose) {
+  TestStream* stream1 = session_.CreateOutgoingDynamicStream();
+  TestStream* stream2 = session_.CreateOutgoingDynamicStream();
+  QuicFlowControllerPeer::SetSendWindowOffset(stream1->flow_controller(), 0);
+  QuicFlowControllerPeer::SetSendWindowOffset(stream2->flow_controller(), 0);
+  EXPECT_CALL(*connection_, SendBlocked(stream1->id()));
+  EXPECT_CALL(*connection_, SendBlocked(stream2->id()));
+  stream1->WriteOrBufferData("not empty", false, nullptr);
+  stream2->WriteOrBufferData("not empty", false, nullptr);
+  EXPECT_EQ(18u, session_.buffered_stream_data_bytes());
+
+  // Reset the first stream locally, then close it.
+  EXPECT_CALL(*connection_, SendRstStream(stream1->id(), _, _));
+  stream1->Reset(QUIC_STREAM_CANCELLED);
+  EXPECT_EQ(9u, session_.buffered_stream_data_bytes());
+  session_.CloseStream(stream1->id());
+  EXPECT_EQ(9u, session_.buffered_stream_data_bytes());
+
+  // The peer resets the second stream, then it is closed locally.
+  QuicRstStreamFrame rst_frame(kInvalidControlFrameId, stream2->id(),
+                               QUIC_STREAM_CANCELLED, 0);
+  EXPECT_CALL(*connection_, SendRstStream(stream2->id(), _, _));
+  session_.OnRstStream(rst_frame);
+  EXPECT_EQ(0u, session_.buffered_stream_data_bytes());
+  session_.CloseStream(stream2->id());
+  EXPECT_EQ(0u, session_.buffered_stream_data_bytes());
+}
+
 TEST_P(QuicSessionTestServer, ConnectionFlowControlAccountingFinAfterRst) {
   // Test that when we RST the stream (and tear down stream state), and then
   // receive a FIN from the peer, we correctly adjust our connection level flow
@@ -147,6 +147,9 @@ class QuicSpdySession::SpdyFramerVisitor
               QUIC_INVALID_HEADERS_STREAM_DATA);
         }
         break;
+      case SETTINGS_ENABLE_CONNECT_PROTOCOL:
+        // Ignored, as it was while it was an unknown setting.
+        break;
       // TODO(fayang): Need to support SETTINGS_MAX_HEADER_LIST_SIZE when
       // clients are actually sending it.
       case SETTINGS_MAX_HEADER_LIST_SIZE:
@@ -425,6 +428,27 @@ size_t QuicSpdySession::WriteHeadersImpl(
   return frame.size();
 }
 
+size_t QuicSpdySession::WriteEncodedHeaders(
+    QuicStreamId id,
+    const string& encoded_headers,
+    bool fin,
+    SpdyPriority priority,
+    QuicReferenceCountedPointer<QuicAckListenerInterface>
+        ack_notifier_delegate) {
+  SpdyHeadersIR headers_frame(id);
+  headers_frame.set_fin(fin);
+  if (perspective() == Perspective::IS_CLIENT) {
+    headers_frame.set_has_priority(true);
+    headers_frame.set_weight(Spdy3PriorityToHttp2Weight(priority));
+  }
+  SpdySerializedFrame frame(spdy_framer_.SerializeHeadersWithEncoding(
+      headers_frame, encoded_headers));
+  headers_stream_->WriteOrBufferData(
+      QuicStringPiece(frame.data(), frame.size()), false,
+      std::move(ack_notifier_delegate));
+  return frame.size();
+}
+
 size_t QuicSpdySession::WritePushPromise(QuicStreamId original_stream_id,
                                          QuicStreamId promised_stream_id,
                                          SpdyHeaderBlock headers) {
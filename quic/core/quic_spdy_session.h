@@ -92,6 +92,15 @@ class QUIC_EXPORT_PRIVATE QuicSpdySession : public QuicSession {
       SpdyPriority priority,
       QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
 
+  // Same as WriteHeaders, but with |encoded_headers| already HPACK encoded
+  // without reference to the dynamic table, so that they are sent as is.
+  virtual size_t WriteEncodedHeaders(
+      QuicStreamId id,
+      const std::string& encoded_headers,
+      bool fin,
+      SpdyPriority priority,
+      QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
+
   // Write |headers| for |promised_stream_id| on |original_stream_id| in a
   // PUSH_PROMISE frame to peer.
   // Return the size, in bytes, of the resulting PUSH_PROMISE frame.
@@ -59,6 +59,19 @@ size_t QuicSpdyStream::WriteHeaders(
   return bytes_written;
 }
 
+size_t QuicSpdyStream::WriteEncodedHeaders(
+    const string& encoded_headers,
+    bool fin,
+    QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener) {
+  size_t bytes_written = spdy_session_->WriteEncodedHeaders(
+      id(), encoded_headers, fin, priority_, std::move(ack_listener));
+  if (fin) {
+    set_fin_sent(true);
+    CloseWriteSide();
+  }
+  return bytes_written;
+}
+
 void QuicSpdyStream::WriteOrBufferBody(
     const string& data,
     bool fin,
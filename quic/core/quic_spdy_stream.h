@@ -104,6 +104,13 @@ class QUIC_EXPORT_PRIVATE QuicSpdyStream : public QuicStream {
       bool fin,
       QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
 
+  // Writes |encoded_headers|, an HPACK block which does not refer to the
+  // dynamic table, to the dedicated headers stream.
+  size_t WriteEncodedHeaders(
+      const std::string& encoded_headers,
+      bool fin,
+      QuicReferenceCountedPointer<QuicAckListenerInterface> ack_listener);
+
   // Sends |data| to the peer, or buffers if it can't be sent immediately.
   void WriteOrBufferBody(
       const std::string& data,
@@ -74,6 +74,7 @@ QuicStream::QuicStream(QuicStreamId id, QuicSession* session)
       buffered_data_threshold_(GetQuicFlag(FLAGS_quic_buffered_data_threshold)),
       remove_on_stream_frame_discarded_(
           FLAGS_quic_reloadable_flag_quic_remove_on_stream_frame_discarded) {
+  sequencer_.set_block_allocator(session->stream_sequencer_buffer_allocator());
   SetFromConfig();
 }
 
@@ -222,6 +223,7 @@ void QuicStream::WriteOrBufferData(
     struct iovec iov(MakeIovec(data));
     QuicStreamOffset offset = send_buffer_.stream_offset();
     send_buffer_.SaveStreamData(&iov, 1, 0, data.length());
+    session_->AddBufferedStreamDataBytes(data.length());
     OnDataBuffered(offset, data.length(), ack_listener);
   }
   if (!had_buffered_data && (HasBufferedData() || fin_buffered_)) {
@@ -292,6 +294,7 @@ QuicConsumedData QuicStream::WritevData(const struct iovec* iov,
     if (consumed_data.bytes_consumed > 0) {
       QuicStreamOffset offset = send_buffer_.stream_offset();
       send_buffer_.SaveStreamData(iov, iov_count, 0, write_length);
+      session_->AddBufferedStreamDataBytes(write_length);
       OnDataBuffered(offset, write_length, nullptr);
     }
   }
@@ -334,6 +337,7 @@ QuicConsumedData QuicStream::WriteMemSlices(QuicMemSliceSpan span, bool fin) {
       QuicStreamOffset offset = send_buffer_.stream_offset();
       consumed_data.bytes_consumed =
           span.SaveMemSlicesInSendBuffer(&send_buffer_);
+      session_->AddBufferedStreamDataBytes(consumed_data.bytes_consumed);
       OnDataBuffered(offset, consumed_data.bytes_consumed, nullptr);
     }
   }
@@ -572,6 +576,13 @@ bool QuicStream::WriteStreamData(QuicStreamOffset offset,
   return send_buffer_.WriteStreamData(offset, data_length, writer);
 }
 
+bool QuicStream::GetStreamDataView(QuicStreamOffset offset,
+                                   QuicByteCount data_length,
+                                   QuicStringPiece* data) const {
+  DCHECK_LT(0u, data_length);
+  return send_buffer_.GetStreamDataView(offset, data_length, data);
+}
+
 void QuicStream::WriteBufferedData() {
   DCHECK(!write_side_closed_ && (HasBufferedData() || fin_buffered_));
 
@@ -615,6 +626,7 @@ void QuicStream::WriteBufferedData() {
       WritevDataInner(write_length, stream_bytes_written(), fin);
 
   send_buffer_.OnStreamDataConsumed(consumed_data.bytes_consumed);
+  session_->RemoveBufferedStreamDataBytes(consumed_data.bytes_consumed);
 
   AddBytesSent(consumed_data.bytes_consumed);
   QUIC_DVLOG(1) << ENDPOINT << "stream " << id_ << " sends "
@@ -657,7 +669,13 @@ uint64_t QuicStream::BufferedDataBytes() const {
 }
 
 bool QuicStream::CanWriteNewData() const {
-  return BufferedDataBytes() < buffered_data_threshold_;
+  if (BufferedDataBytes() >= buffered_data_threshold_) {
+    return false;
+  }
+  // While the session is over its limit, streams with data still to send wait
+  // for it to drain. They are woken by OnCanWrite() once it has, so only
+  // streams which are already waiting to write are held back.
+  return !HasBufferedData() || !session_->IsBufferedStreamDataOverLimit();
 }
 
 uint64_t QuicStream::stream_bytes_written() const {
@@ -198,6 +198,12 @@ class QUIC_EXPORT_PRIVATE QuicStream {
                        QuicByteCount data_length,
                        QuicDataWriter* writer);
 
+  // Sets |data| to point at |data_length| of data starts at |offset| in send
+  // buffer if it is contiguous. Returns false otherwise.
+  bool GetStreamDataView(QuicStreamOffset offset,
+                         QuicByteCount data_length,
+                         QuicStringPiece* data) const;
+
   // Called when data [offset, offset + data_length) is acked. |fin_acked|
   // indicates whether the fin is acked.
   virtual void OnStreamFrameAcked(QuicStreamOffset offset,
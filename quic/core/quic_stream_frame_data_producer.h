@@ -6,12 +6,13 @@
 #define NET_QUIC_CORE_QUIC_STREAM_FRAME_DATA_PRODUCER_H_
 
 #include "net/quic/core/quic_types.h"
+#include "net/quic/platform/api/quic_string_piece.h"
 
 namespace net {
 
 class QuicDataWriter;
 
-// Pure virtual class to retrieve stream data.
+// Interface to retrieve stream data.
 class QUIC_EXPORT_PRIVATE QuicStreamFrameDataProducer {
  public:
   virtual ~QuicStreamFrameDataProducer() {}
@@ -24,6 +25,17 @@ class QUIC_EXPORT_PRIVATE QuicStreamFrameDataProducer {
                                QuicStreamOffset offset,
                                QuicByteCount data_length,
                                QuicDataWriter* writer) = 0;
+
+  // Sets |data| to point at |data_length| data with |offset| of stream |id|
+  // where it is retained, so that it can be encrypted into a packet without
+  // being copied first. Returns false if the data does not lie in a single
+  // contiguous buffer, in which case WriteStreamData() must be used instead.
+  virtual bool GetStreamDataView(QuicStreamId id,
+                                 QuicStreamOffset offset,
+                                 QuicByteCount data_length,
+                                 QuicStringPiece* data) {
+    return false;
+  }
 };
 
 }  // namespace net
@@ -93,6 +93,26 @@ bool QuicStreamSendBuffer::WriteStreamData(QuicStreamOffset offset,
   return data_length == 0;
 }
 
+bool QuicStreamSendBuffer::GetStreamDataView(QuicStreamOffset offset,
+                                             QuicByteCount data_length,
+                                             QuicStringPiece* data) const {
+  for (const BufferedSlice& slice : buffered_slices_) {
+    if (offset < slice.offset) {
+      break;
+    }
+    if (offset >= slice.offset + slice.slice.length()) {
+      continue;
+    }
+    QuicByteCount slice_offset = offset - slice.offset;
+    if (data_length > slice.slice.length() - slice_offset) {
+      return false;
+    }
+    *data = QuicStringPiece(slice.slice.data() + slice_offset, data_length);
+    return true;
+  }
+  return false;
+}
+
 bool QuicStreamSendBuffer::OnStreamDataAcked(
     QuicStreamOffset offset,
     QuicByteCount data_length,
@@ -9,6 +9,7 @@
 #include "net/quic/core/frames/quic_stream_frame.h"
 #include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_mem_slice.h"
+#include "net/quic/platform/api/quic_string_piece.h"
 
 namespace net {
 
@@ -71,6 +72,12 @@ class QUIC_EXPORT_PRIVATE QuicStreamSendBuffer {
                        QuicByteCount data_length,
                        QuicDataWriter* writer);
 
+  // Sets |data| to point at |data_length| of data starts at |offset| if it lies
+  // within a single data slice. Returns false otherwise.
+  bool GetStreamDataView(QuicStreamOffset offset,
+                         QuicByteCount data_length,
+                         QuicStringPiece* data) const;
+
   // Called when data [offset, offset + data_length) is acked or removed as
   // stream is canceled. Removes fully acked data slice from send buffer. Set
   // |newly_acked_length|. Returns false if trying to ack unsent data.
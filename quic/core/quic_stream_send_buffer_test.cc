@@ -93,6 +93,22 @@ TEST_F(QuicStreamSendBufferTest, CopyDataToBuffer) {
   EXPECT_FALSE(send_buffer_.WriteStreamData(0, 4000, &writer3));
 }
 
+TEST_F(QuicStreamSendBufferTest, GetStreamDataView) {
+  QuicStringPiece data;
+  ASSERT_TRUE(send_buffer_.GetStreamDataView(0, 1024, &data));
+  EXPECT_EQ(string(1024, 'a'), data);
+  ASSERT_TRUE(send_buffer_.GetStreamDataView(1536, 512, &data));
+  EXPECT_EQ(string(256, 'b') + string(256, 'c'), data);
+  ASSERT_TRUE(send_buffer_.GetStreamDataView(3000, 72, &data));
+  EXPECT_EQ(string(72, 'c'), data);
+
+  // Data spanning more than one slice has no contiguous view.
+  EXPECT_FALSE(send_buffer_.GetStreamDataView(1000, 100, &data));
+  // Data beyond the end of the buffer.
+  EXPECT_FALSE(send_buffer_.GetStreamDataView(3800, 100, &data));
+  EXPECT_FALSE(send_buffer_.GetStreamDataView(4000, 1, &data));
+}
+
 TEST_F(QuicStreamSendBufferTest, RemoveStreamFrame) {
   QuicByteCount newly_acked_length;
   EXPECT_TRUE(send_buffer_.OnStreamDataAcked(1024, 1024, &newly_acked_length));
@@ -15,6 +15,7 @@
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_clock.h"
+#include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_str_cat.h"
 #include "net/quic/platform/api/quic_string_piece.h"
@@ -47,11 +48,26 @@ void QuicStreamSequencer::OnStreamFrame(const QuicStreamFrame& frame) {
       return;
     }
   }
+  // When the frame is the next data to read and nothing else is buffered, the
+  // stream reads it straight out of the packet and only what is left unread
+  // gets copied into the buffer.
+  const bool reference_data =
+      FLAGS_quic_reloadable_flag_quic_reference_in_order_stream_data &&
+      !blocked_ && !ignore_read_data_ &&
+      byte_offset == buffered_frames_.BytesConsumed() &&
+      buffered_frames_.Empty();
   size_t bytes_written;
   string error_details;
-  QuicErrorCode result = buffered_frames_.OnStreamData(
-      byte_offset, QuicStringPiece(frame.data_buffer, frame.data_length),
-      clock_->ApproximateNow(), &bytes_written, &error_details);
+  QuicErrorCode result;
+  if (reference_data) {
+    result = buffered_frames_.OnInOrderStreamData(
+        QuicStringPiece(frame.data_buffer, frame.data_length),
+        clock_->ApproximateNow(), &bytes_written, &error_details);
+  } else {
+    result = buffered_frames_.OnStreamData(
+        byte_offset, QuicStringPiece(frame.data_buffer, frame.data_length),
+        clock_->ApproximateNow(), &bytes_written, &error_details);
+  }
   if (result != QUIC_NO_ERROR) {
     string details = QuicStrCat(
         "Stream ", stream_->id(), ": ", QuicErrorCodeToString(result), ": ",
@@ -69,6 +85,16 @@ void QuicStreamSequencer::OnStreamFrame(const QuicStreamFrame& frame) {
     return;
   }
 
+  if (reference_data) {
+    stream_->OnDataAvailable();
+    if (!buffered_frames_.DetachStreamData(&error_details)) {
+      stream_->CloseConnectionWithDetails(
+          QUIC_STREAM_SEQUENCER_INVALID_STATE,
+          QuicStrCat("Stream ", stream_->id(), ": ", error_details));
+    }
+    return;
+  }
+
   if (blocked_) {
     return;
   }
@@ -167,6 +193,11 @@ void QuicStreamSequencer::MarkConsumed(size_t num_bytes_consumed) {
   stream_->AddBytesConsumed(num_bytes_consumed);
 }
 
+void QuicStreamSequencer::set_block_allocator(
+    QuicPooledBufferAllocator* block_allocator) {
+  buffered_frames_.set_block_allocator(block_allocator);
+}
+
 void QuicStreamSequencer::SetBlockedUntilFlush() {
   blocked_ = true;
 }
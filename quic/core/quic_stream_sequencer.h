@@ -20,6 +20,7 @@ class QuicStreamSequencerPeer;
 }  // namespace test
 
 class QuicClock;
+class QuicPooledBufferAllocator;
 class QuicStream;
 
 // Buffers frames until we have something which can be passed
@@ -33,7 +34,8 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
   // ProcessData will be immediately called on the stream until all buffered
   // data is processed or the stream fails to consume data.  Any unconsumed
   // data will be buffered. If the frame is not the next in line, it will be
-  // buffered.
+  // buffered. If nothing else is buffered, the stream may read the frame's
+  // data in place, without it being copied into the buffer first.
   void OnStreamFrame(const QuicStreamFrame& frame);
 
   // Once data is buffered, it's up to the stream to read it when the stream
@@ -84,6 +86,10 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencer {
   // Free the memory of underlying buffer when no bytes remain in it.
   void ReleaseBufferIfEmpty();
 
+  // Makes the underlying buffer allocate its blocks from |block_allocator|.
+  // Must be called before any data arrives.
+  void set_block_allocator(QuicPooledBufferAllocator* block_allocator);
+
   // Number of bytes in the buffer right now.
   size_t NumBytesBuffered() const;
 
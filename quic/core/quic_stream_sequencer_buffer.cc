@@ -4,8 +4,12 @@
 
 #include "net/quic/core/quic_stream_sequencer_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "base/format_macros.h"
 #include "net/quic/core/quic_constants.h"
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_flag_utils.h"
 #include "net/quic/platform/api/quic_flags.h"
@@ -52,6 +56,10 @@ QuicStreamSequencerBuffer::QuicStreamSequencerBuffer(size_t max_capacity_bytes)
       blocks_count_(CalculateBlockCount(max_capacity_bytes)),
       total_bytes_read_(0),
       blocks_(nullptr),
+      blocks_size_(0),
+      first_block_capacity_(0),
+      block_allocator_(nullptr),
+      referenced_data_offset_(0),
       destruction_indicator_(123456) {
   CHECK_GT(blocks_count_, 1u)
       << "blocks_count_ = " << blocks_count_
@@ -64,14 +72,22 @@ QuicStreamSequencerBuffer::~QuicStreamSequencerBuffer() {
   destruction_indicator_ = 654321;
 }
 
+void QuicStreamSequencerBuffer::set_block_allocator(
+    QuicPooledBufferAllocator* block_allocator) {
+  DCHECK_EQ(0u, num_bytes_buffered_);
+  DCHECK(referenced_data_.empty());
+  block_allocator_ = block_allocator;
+}
+
 void QuicStreamSequencerBuffer::Clear() {
   if (blocks_ != nullptr) {
-    for (size_t i = 0; i < blocks_count_; ++i) {
+    for (size_t i = 0; i < blocks_size_; ++i) {
       if (blocks_[i] != nullptr) {
         RetireBlock(i);
       }
     }
   }
+  referenced_data_ = QuicStringPiece();
   num_bytes_buffered_ = 0;
   // Reset gaps_ so that buffer is in a state as if all data before
   // total_bytes_read_ has been consumed, and those after total_bytes_read_
@@ -86,12 +102,86 @@ bool QuicStreamSequencerBuffer::RetireBlock(size_t idx) {
     QUIC_BUG << "Try to retire block twice";
     return false;
   }
-  delete blocks_[idx];
+  DeleteBlock(blocks_[idx]);
   blocks_[idx] = nullptr;
+  if (idx == 0) {
+    first_block_capacity_ = 0;
+    for (char* block : superseded_first_blocks_) {
+      DeleteBlock(block);
+    }
+    superseded_first_blocks_.clear();
+  }
   QUIC_DVLOG(1) << "Retired block with index: " << idx;
   return true;
 }
 
+char* QuicStreamSequencerBuffer::NewBlock(size_t capacity) {
+  if (block_allocator_ != nullptr) {
+    return block_allocator_->New(capacity);
+  }
+  return new char[capacity];
+}
+
+void QuicStreamSequencerBuffer::DeleteBlock(char* block) {
+  if (block_allocator_ != nullptr) {
+    QuicPooledBufferAllocator::Release(block);
+    return;
+  }
+  delete[] block;
+}
+
+bool QuicStreamSequencerBuffer::ReserveBlock(size_t index,
+                                             size_t min_capacity) {
+  if (index >= blocks_count_) {
+    return false;
+  }
+  if (index >= blocks_size_) {
+    // Grow the index geometrically so that a bulk transfer only reallocates it
+    // a logarithmic number of times.
+    const size_t new_size =
+        std::min(blocks_count_, std::max(index + 1, 2 * blocks_size_));
+    std::unique_ptr<char* []> blocks(new char*[new_size]());
+    if (blocks_ != nullptr) {
+      std::copy(blocks_.get(), blocks_.get() + blocks_size_, blocks.get());
+    }
+    blocks_ = std::move(blocks);
+    blocks_size_ = new_size;
+  }
+
+  const size_t block_capacity = GetBlockCapacity(index);
+  if (index != 0) {
+    if (blocks_[index] == nullptr) {
+      blocks_[index] = NewBlock(block_capacity);
+    }
+    return true;
+  }
+
+  // The first block starts small and grows with the data written into it, so
+  // that short requests do not pay for a full block.
+  if (blocks_[0] != nullptr && first_block_capacity_ >= min_capacity) {
+    return true;
+  }
+  size_t capacity = kMinBlockSizeBytes;
+  while (capacity < min_capacity) {
+    capacity *= 4;
+  }
+  capacity = std::min(capacity, block_capacity);
+  char* block = NewBlock(capacity);
+  if (blocks_[0] != nullptr) {
+    memcpy(block, blocks_[0], first_block_capacity_);
+    if (ReadableBytes() > 0) {
+      // A reader may hold pointers from GetReadableRegions() into the old
+      // block. Its data stays the same, so keep it until block 0 is retired.
+      superseded_first_blocks_.push_back(blocks_[0]);
+    } else {
+      DeleteBlock(blocks_[0]);
+    }
+  }
+  blocks_[0] = block;
+  first_block_capacity_ = capacity;
+  return true;
+}
+
 QuicErrorCode QuicStreamSequencerBuffer::OnStreamData(
     QuicStreamOffset starting_offset,
     QuicStringPiece data,
@@ -181,6 +271,41 @@ QuicErrorCode QuicStreamSequencerBuffer::OnStreamData(
   return QUIC_NO_ERROR;
 }
 
+QuicErrorCode QuicStreamSequencerBuffer::OnInOrderStreamData(
+    QuicStringPiece data,
+    QuicTime timestamp,
+    size_t* const bytes_buffered,
+    std::string* error_details) {
+  CHECK_EQ(destruction_indicator_, 123456) << "This object has been destructed";
+  if (!Empty() || !referenced_data_.empty() || data.empty() ||
+      data.data() == nullptr || data.size() > max_buffer_capacity_bytes_) {
+    return OnStreamData(total_bytes_read_, data, timestamp, bytes_buffered,
+                        error_details);
+  }
+
+  referenced_data_ = data;
+  referenced_data_offset_ = total_bytes_read_;
+  UpdateGapList(gaps_.begin(), total_bytes_read_, data.size());
+  frame_arrival_time_map_.insert(
+      std::make_pair(total_bytes_read_, FrameInfo(data.size(), timestamp)));
+  num_bytes_buffered_ += data.size();
+  *bytes_buffered = data.size();
+  return QUIC_NO_ERROR;
+}
+
+bool QuicStreamSequencerBuffer::DetachStreamData(string* error_details) {
+  if (referenced_data_.empty()) {
+    return true;
+  }
+  QuicStringPiece unread = UnreadReferencedData();
+  referenced_data_ = QuicStringPiece();
+  // The gaps, the frame arrival map and num_bytes_buffered_ already account
+  // for these bytes.
+  size_t bytes_copied;
+  return CopyStreamData(total_bytes_read_, unread, &bytes_copied,
+                        error_details);
+}
+
 bool QuicStreamSequencerBuffer::CopyStreamData(QuicStreamOffset offset,
                                                QuicStringPiece data,
                                                size_t* bytes_copy,
@@ -208,14 +333,9 @@ bool QuicStreamSequencerBuffer::CopyStreamData(QuicStreamOffset offset,
       bytes_avail = total_bytes_read_ + max_buffer_capacity_bytes_ - offset;
     }
 
-    if (blocks_ == nullptr) {
-      blocks_.reset(new BufferBlock*[blocks_count_]());
-      for (size_t i = 0; i < blocks_count_; ++i) {
-        blocks_[i] = nullptr;
-      }
-    }
-
-    if (write_block_num >= blocks_count_) {
+    const size_t bytes_to_copy =
+        std::min<size_t>(bytes_avail, source_remaining);
+    if (!ReserveBlock(write_block_num, write_block_offset + bytes_to_copy)) {
       *error_details = QuicStrCat(
           "QuicStreamSequencerBuffer error: OnStreamData() exceed array bounds."
           "write offset = ",
@@ -223,20 +343,8 @@ bool QuicStreamSequencerBuffer::CopyStreamData(QuicStreamOffset offset,
           " blocks_count_ = ", blocks_count_);
       return false;
     }
-    if (blocks_ == nullptr) {
-      *error_details =
-          "QuicStreamSequencerBuffer error: OnStreamData() blocks_ is null";
-      return false;
-    }
-    if (blocks_[write_block_num] == nullptr) {
-      // TODO(danzh): Investigate if using a freelist would improve performance.
-      // Same as RetireBlock().
-      blocks_[write_block_num] = new BufferBlock();
-    }
 
-    const size_t bytes_to_copy =
-        std::min<size_t>(bytes_avail, source_remaining);
-    char* dest = blocks_[write_block_num]->buffer + write_block_offset;
+    char* dest = blocks_[write_block_num] + write_block_offset;
     QUIC_DVLOG(1) << "Write at offset: " << offset
                   << " length: " << bytes_to_copy;
 
@@ -296,6 +404,22 @@ QuicErrorCode QuicStreamSequencerBuffer::Readv(const iovec* dest_iov,
   CHECK_EQ(destruction_indicator_, 123456) << "This object has been destructed";
 
   *bytes_read = 0;
+  if (!referenced_data_.empty()) {
+    QuicStringPiece unread = UnreadReferencedData();
+    for (size_t i = 0; i < dest_count && *bytes_read < unread.size(); ++i) {
+      const size_t bytes_to_copy =
+          std::min<size_t>(dest_iov[i].iov_len, unread.size() - *bytes_read);
+      memcpy(dest_iov[i].iov_base, unread.data() + *bytes_read, bytes_to_copy);
+      *bytes_read += bytes_to_copy;
+    }
+    num_bytes_buffered_ -= *bytes_read;
+    total_bytes_read_ += *bytes_read;
+    if (*bytes_read > 0) {
+      UpdateFrameArrivalMap(total_bytes_read_);
+    }
+    return QUIC_NO_ERROR;
+  }
+
   for (size_t i = 0; i < dest_count && ReadableBytes() > 0; ++i) {
     char* dest = reinterpret_cast<char*>(dest_iov[i].iov_base);
     CHECK_NE(dest, nullptr);
@@ -320,8 +444,7 @@ QuicErrorCode QuicStreamSequencerBuffer::Readv(const iovec* dest_iov,
             " total_bytes_read_ = ", total_bytes_read_);
         return QUIC_STREAM_SEQUENCER_INVALID_STATE;
       }
-      memcpy(dest, blocks_[block_idx]->buffer + start_offset_in_block,
-             bytes_to_copy);
+      memcpy(dest, blocks_[block_idx] + start_offset_in_block, bytes_to_copy);
       dest += bytes_to_copy;
       dest_remaining -= bytes_to_copy;
       num_bytes_buffered_ -= bytes_to_copy;
@@ -365,6 +488,13 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
     return 0;
   }
 
+  if (!referenced_data_.empty()) {
+    QuicStringPiece unread = UnreadReferencedData();
+    iov[0].iov_base = const_cast<char*>(unread.data());
+    iov[0].iov_len = unread.size();
+    return 1;
+  }
+
   size_t start_block_idx = NextBlockToRead();
   QuicStreamOffset readable_offset_end = gaps_.front().begin_offset - 1;
   DCHECK_GE(readable_offset_end + 1, total_bytes_read_);
@@ -373,14 +503,14 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
 
   // If readable region is within one block, deal with it seperately.
   if (start_block_idx == end_block_idx && ReadOffset() <= end_block_offset) {
-    iov[0].iov_base = blocks_[start_block_idx]->buffer + ReadOffset();
+    iov[0].iov_base = blocks_[start_block_idx] + ReadOffset();
     iov[0].iov_len = ReadableBytes();
     QUIC_DVLOG(1) << "Got only a single block with index: " << start_block_idx;
     return 1;
   }
 
   // Get first block
-  iov[0].iov_base = blocks_[start_block_idx]->buffer + ReadOffset();
+  iov[0].iov_base = blocks_[start_block_idx] + ReadOffset();
   iov[0].iov_len = GetBlockCapacity(start_block_idx) - ReadOffset();
   QUIC_DVLOG(1) << "Got first block " << start_block_idx << " with len "
                 << iov[0].iov_len;
@@ -393,8 +523,8 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
   int iov_used = 1;
   size_t block_idx = (start_block_idx + iov_used) % blocks_count_;
   while (block_idx != end_block_idx && iov_used < iov_count) {
-    DCHECK_NE(static_cast<BufferBlock*>(nullptr), blocks_[block_idx]);
-    iov[iov_used].iov_base = blocks_[block_idx]->buffer;
+    DCHECK(blocks_[block_idx] != nullptr);
+    iov[iov_used].iov_base = blocks_[block_idx];
     iov[iov_used].iov_len = GetBlockCapacity(block_idx);
     QUIC_DVLOG(1) << "Got block with index: " << block_idx;
     ++iov_used;
@@ -403,8 +533,8 @@ int QuicStreamSequencerBuffer::GetReadableRegions(struct iovec* iov,
 
   // Deal with last block if |iov| can hold more.
   if (iov_used < iov_count) {
-    DCHECK_NE(static_cast<BufferBlock*>(nullptr), blocks_[block_idx]);
-    iov[iov_used].iov_base = blocks_[end_block_idx]->buffer;
+    DCHECK(blocks_[block_idx] != nullptr);
+    iov[iov_used].iov_base = blocks_[end_block_idx];
     iov[iov_used].iov_len = end_block_offset + 1;
     QUIC_DVLOG(1) << "Got last block with index: " << end_block_idx;
     ++iov_used;
@@ -422,8 +552,17 @@ bool QuicStreamSequencerBuffer::GetReadableRegion(iovec* iov,
     return false;
   }
 
+  if (!referenced_data_.empty()) {
+    // All the referenced data arrived in a single frame.
+    QuicStringPiece unread = UnreadReferencedData();
+    iov->iov_base = const_cast<char*>(unread.data());
+    iov->iov_len = unread.size();
+    *timestamp = frame_arrival_time_map_.begin()->second.timestamp;
+    return true;
+  }
+
   size_t start_block_idx = NextBlockToRead();
-  iov->iov_base = blocks_[start_block_idx]->buffer + ReadOffset();
+  iov->iov_base = blocks_[start_block_idx] + ReadOffset();
   size_t readable_bytes_in_block = std::min<size_t>(
       GetBlockCapacity(start_block_idx) - ReadOffset(), ReadableBytes());
   size_t region_len = 0;
@@ -459,6 +598,14 @@ bool QuicStreamSequencerBuffer::MarkConsumed(size_t bytes_used) {
   if (bytes_used > ReadableBytes()) {
     return false;
   }
+  if (!referenced_data_.empty()) {
+    total_bytes_read_ += bytes_used;
+    num_bytes_buffered_ -= bytes_used;
+    if (bytes_used > 0) {
+      UpdateFrameArrivalMap(total_bytes_read_);
+    }
+    return true;
+  }
   size_t bytes_to_consume = bytes_used;
   while (bytes_to_consume > 0) {
     size_t block_idx = NextBlockToRead();
@@ -491,12 +638,17 @@ size_t QuicStreamSequencerBuffer::FlushBufferedFrames() {
 void QuicStreamSequencerBuffer::ReleaseWholeBuffer() {
   Clear();
   blocks_.reset(nullptr);
+  blocks_size_ = 0;
 }
 
 size_t QuicStreamSequencerBuffer::ReadableBytes() const {
   return gaps_.front().begin_offset - total_bytes_read_;
 }
 
+QuicStringPiece QuicStreamSequencerBuffer::UnreadReferencedData() const {
+  return referenced_data_.substr(total_bytes_read_ - referenced_data_offset_);
+}
+
 bool QuicStreamSequencerBuffer::HasBytesToRead() const {
   return ReadableBytes() > 0;
 }
@@ -23,7 +23,17 @@
 // contains all written data that has not been read.
 // It promises stability of the underlying memory addresses in the readable
 // region, so pointers into it can be maintained, and the offset of a pointer
-// from the start of the read region can be calculated.
+// from the start of the read region can be calculated. Pointers into data
+// passed to OnInOrderStreamData() are the exception: they only stay valid
+// until DetachStreamData() is called.
+//
+// To keep mostly idle streams cheap, both the block index and the first block
+// of the stream are sized by the data actually received: the index grows
+// towards the full capacity as later blocks are written, and the first block
+// starts at kMinBlockSizeBytes and grows up to kBlockSizeBytes. When the first
+// block grows while it holds readable data, the old allocation is kept until
+// the block is retired, so that pointers into it stay valid. Blocks can be
+// drawn from a QuicPooledBufferAllocator shared by the streams of a session.
 //
 // Expected Use:
 //  QuicStreamSequencerBuffer buffer(2.5 * 8 * 1024);
@@ -63,6 +73,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "net/quic/core/quic_packets.h"
@@ -71,6 +82,8 @@
 
 namespace net {
 
+class QuicPooledBufferAllocator;
+
 namespace test {
 class QuicStreamSequencerBufferPeer;
 }  // namespace test
@@ -99,14 +112,20 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // which could be up to 1.5 KB.
   static const size_t kBlockSizeBytes = 8 * 1024;  // 8KB
 
-  // The basic storage block used by this buffer.
-  struct BufferBlock {
-    char buffer[kBlockSizeBytes];
-  };
+  // Size of the first block of a stream when it is allocated for a short
+  // frame. It grows by a factor of 4 up to kBlockSizeBytes as more data
+  // arrives.
+  static const size_t kMinBlockSizeBytes = 1024;
 
   explicit QuicStreamSequencerBuffer(size_t max_capacity_bytes);
   ~QuicStreamSequencerBuffer();
 
+  // Makes this buffer allocate its blocks from |block_allocator| rather than
+  // from the heap. Must be called before any data is buffered. Blocks are
+  // released with QuicPooledBufferAllocator::Release(), so |block_allocator|
+  // may be destroyed before this buffer.
+  void set_block_allocator(QuicPooledBufferAllocator* block_allocator);
+
   // Free the space used to buffer data.
   void Clear();
 
@@ -123,6 +142,20 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
                              size_t* bytes_buffered,
                              std::string* error_details);
 
+  // Called to make |data|, which must start at BytesConsumed(), readable
+  // without copying it. Only possible while the buffer is Empty(); otherwise
+  // |data| is buffered as by OnStreamData(). The memory behind |data| must
+  // stay valid until DetachStreamData() is called.
+  QuicErrorCode OnInOrderStreamData(QuicStringPiece data,
+                                    QuicTime timestamp,
+                                    size_t* bytes_buffered,
+                                    std::string* error_details);
+
+  // Stops referencing the data passed to OnInOrderStreamData(), copying the
+  // part which has not been consumed yet into the buffer. Returns false and
+  // sets |error_details| if the copy fails.
+  bool DetachStreamData(std::string* error_details);
+
   // Reads from this buffer into given iovec array, up to number of iov_len
   // iovec objects and returns the number of bytes read.
   QuicErrorCode Readv(const struct iovec* dest_iov,
@@ -177,6 +210,15 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
                       size_t* bytes_copy,
                       std::string* error_details);
 
+  // Makes sure blocks_ can hold the block at |index| and that the block is
+  // allocated with room for at least |min_capacity| bytes, preserving any data
+  // already in it. Returns false if |index| is out of bounds.
+  bool ReserveBlock(size_t index, size_t min_capacity);
+
+  // Allocates or releases the memory of a block.
+  char* NewBlock(size_t capacity);
+  void DeleteBlock(char* block);
+
   // Dispose the given buffer block.
   // After calling this method, blocks_[index] is set to nullptr
   // in order to indicate that no memory set is allocated for that block.
@@ -217,6 +259,10 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // Returns number of bytes available to be read out.
   size_t ReadableBytes() const;
 
+  // Returns the part of the data passed to OnInOrderStreamData() which has not
+  // been read yet. Only meaningful while |referenced_data_| is not empty.
+  QuicStringPiece UnreadReferencedData() const;
+
   // Called after Readv() and MarkConsumed() to keep frame_arrival_time_map_
   // up to date.
   // |offset| is the byte next read should start from. All frames before it
@@ -244,7 +290,28 @@ class QUIC_EXPORT_PRIVATE QuicStreamSequencerBuffer {
   // An ordered, variable-length list of blocks, with the length limited
   // such that the number of blocks never exceeds blocks_count_.
   // Each list entry can hold up to kBlockSizeBytes bytes.
-  std::unique_ptr<BufferBlock* []> blocks_;
+  std::unique_ptr<char* []> blocks_;
+
+  // Number of entries in blocks_. Grows on demand up to blocks_count_.
+  size_t blocks_size_;
+
+  // Number of bytes allocated for blocks_[0], which may be less than
+  // GetBlockCapacity(0) for the first block of a stream.
+  size_t first_block_capacity_;
+
+  // Earlier allocations of blocks_[0] which held readable data when the block
+  // grew. Readers may still point into them, so they are only released when
+  // blocks_[0] is retired.
+  std::vector<char*> superseded_first_blocks_;
+
+  // Allocator of the blocks, owned by the session. Null if blocks come from
+  // the heap.
+  QuicPooledBufferAllocator* block_allocator_;
+
+  // Data passed to OnInOrderStreamData() which is readable but not owned by
+  // this buffer, and the stream offset it starts at.
+  QuicStringPiece referenced_data_;
+  QuicStreamOffset referenced_data_offset_;
 
   // Number of bytes in buffer.
   size_t num_bytes_buffered_;
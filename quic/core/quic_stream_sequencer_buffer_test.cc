@@ -11,8 +11,10 @@
 #include <utility>
 
 #include "base/macros.h"
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
 #include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_str_cat.h"
+#include "net/quic/platform/api/quic_string_piece.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/test_tools/mock_clock.h"
 #include "net/quic/test_tools/quic_stream_sequencer_buffer_peer.h"
@@ -51,7 +53,6 @@ const size_t kMaxNumGapsAllowed = 2 * kMaxPacketGap;
 
 static const size_t kBlockSizeBytes =
     QuicStreamSequencerBuffer::kBlockSizeBytes;
-typedef QuicStreamSequencerBuffer::BufferBlock BufferBlock;
 typedef QuicStreamSequencerBuffer::Gap Gap;
 typedef QuicStreamSequencerBuffer::FrameInfo FrameInfo;
 
@@ -127,9 +128,9 @@ TEST_F(QuicStreamSequencerBufferTest, OnStreamDataWithinBlock) {
   QuicTime t = clock_.ApproximateNow();
   EXPECT_EQ(QUIC_NO_ERROR,
             buffer_->OnStreamData(800, source, t, &written, &error_details_));
-  BufferBlock* block_ptr = helper_->GetBlock(0);
+  char* block_ptr = helper_->GetBlock(0);
   for (size_t i = 0; i < source.size(); ++i) {
-    ASSERT_EQ('a', block_ptr->buffer[helper_->GetInBlockOffset(800) + i]);
+    ASSERT_EQ('a', block_ptr[helper_->GetInBlockOffset(800) + i]);
   }
   EXPECT_EQ(2, helper_->GapSize());
   std::list<Gap> gaps = helper_->GetGaps();
@@ -513,6 +514,142 @@ TEST_F(QuicStreamSequencerBufferTest, ReleaseWholeBuffer) {
   EXPECT_FALSE(helper_->IsBufferAllocated());
 }
 
+TEST_F(QuicStreamSequencerBufferTest, FirstBlockGrowsWithData) {
+  ResetMaxCapacityBytes(16 * 1024 * 1024);
+  size_t written;
+  string source(100, 'a');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(0, source, clock_.ApproximateNow(), &written,
+                                  &error_details_));
+  EXPECT_EQ(1u, helper_->block_index_size());
+  EXPECT_EQ(QuicStreamSequencerBuffer::kMinBlockSizeBytes,
+            helper_->first_block_capacity());
+
+  // Growing the first block keeps the data already in it.
+  string source2(1900, 'b');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(100, source2, clock_.ApproximateNow(),
+                                  &written, &error_details_));
+  EXPECT_EQ(4 * 1024u, helper_->first_block_capacity());
+
+  // A later block grows the index, but only as far as needed.
+  string source3(kBlockSizeBytes, 'c');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(2 * kBlockSizeBytes, source3,
+                                  clock_.ApproximateNow(), &written,
+                                  &error_details_));
+  EXPECT_EQ(3u, helper_->block_index_size());
+  EXPECT_LT(helper_->block_index_size(), helper_->block_count());
+
+  string source4(2 * kBlockSizeBytes - 2000, 'd');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(2000, source4, clock_.ApproximateNow(),
+                                  &written, &error_details_));
+  EXPECT_EQ(kBlockSizeBytes, helper_->first_block_capacity());
+
+  string expected = source + source2 + source4 + source3;
+  string dest(expected.size(), '\0');
+  EXPECT_EQ(expected.size(), helper_->Read(&dest[0], dest.size()));
+  EXPECT_EQ(expected, dest);
+  EXPECT_TRUE(helper_->CheckBufferInvariants());
+}
+
+// Tests that growing the first block does not move readable data that a
+// reader may still point into.
+TEST_F(QuicStreamSequencerBufferTest, FirstBlockGrowthKeepsReadableRegions) {
+  size_t written;
+  string source(100, 'a');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(0, source, clock_.ApproximateNow(), &written,
+                                  &error_details_));
+  iovec iov;
+  EXPECT_EQ(1, buffer_->GetReadableRegions(&iov, 1));
+  EXPECT_EQ(100u, iov.iov_len);
+
+  string source2(1900, 'b');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(100, source2, clock_.ApproximateNow(),
+                                  &written, &error_details_));
+  EXPECT_EQ(4 * 1024u, helper_->first_block_capacity());
+  EXPECT_EQ(source,
+            QuicStringPiece(static_cast<char*>(iov.iov_base), iov.iov_len));
+
+  // Consuming through the regions obtained before the growth reads the same
+  // bytes as the grown block holds.
+  EXPECT_TRUE(buffer_->MarkConsumed(iov.iov_len));
+  EXPECT_EQ(1, buffer_->GetReadableRegions(&iov, 1));
+  EXPECT_EQ(source2,
+            QuicStringPiece(static_cast<char*>(iov.iov_base), iov.iov_len));
+  EXPECT_TRUE(buffer_->MarkConsumed(iov.iov_len));
+  EXPECT_TRUE(helper_->CheckBufferInvariants());
+}
+
+TEST_F(QuicStreamSequencerBufferTest, BlocksComeFromAllocator) {
+  QuicPooledBufferAllocator allocator;
+  buffer_->set_block_allocator(&allocator);
+  size_t written;
+  string source(kBlockSizeBytes + 100, 'a');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(0, source, clock_.ApproximateNow(), &written,
+                                  &error_details_));
+  EXPECT_EQ(2u, allocator.stats().allocations);
+  EXPECT_EQ(0u, allocator.stats().bytes_idle);
+
+  // Reading everything retires both blocks, which go back to the allocator.
+  string dest(source.size(), '\0');
+  EXPECT_EQ(source.size(), helper_->Read(&dest[0], dest.size()));
+  EXPECT_EQ(allocator.stats().bytes_resident, allocator.stats().bytes_idle);
+  EXPECT_TRUE(helper_->IsBlockArrayEmpty());
+}
+
+TEST_F(QuicStreamSequencerBufferTest, InOrderStreamDataIsReferenced) {
+  string source(1000, 'a');
+  size_t written;
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnInOrderStreamData(source, clock_.ApproximateNow(),
+                                         &written, &error_details_));
+  EXPECT_EQ(source.size(), written);
+  EXPECT_EQ(source.size(), buffer_->BytesBuffered());
+  EXPECT_FALSE(helper_->IsBufferAllocated());
+
+  iovec iov;
+  EXPECT_EQ(1, buffer_->GetReadableRegions(&iov, 1));
+  EXPECT_EQ(source.data(), iov.iov_base);
+  EXPECT_EQ(source.size(), iov.iov_len);
+  EXPECT_TRUE(buffer_->MarkConsumed(400));
+
+  // Only the unread part is copied when the data is detached.
+  EXPECT_TRUE(buffer_->DetachStreamData(&error_details_));
+  EXPECT_TRUE(helper_->IsBufferAllocated());
+  EXPECT_EQ(600u, helper_->ReadableBytes());
+  source[500] = 'b';
+  string dest(600, '\0');
+  EXPECT_EQ(600u, helper_->Read(&dest[0], dest.size()));
+  EXPECT_EQ(string(600, 'a'), dest);
+  EXPECT_EQ(1000u, buffer_->BytesConsumed());
+  EXPECT_TRUE(helper_->CheckBufferInvariants());
+}
+
+TEST_F(QuicStreamSequencerBufferTest, InOrderStreamDataCopiedWhenNotEmpty) {
+  string source(100, 'b');
+  size_t written;
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnStreamData(1000, source, clock_.ApproximateNow(),
+                                  &written, &error_details_));
+  string source2(1000, 'a');
+  EXPECT_EQ(QUIC_NO_ERROR,
+            buffer_->OnInOrderStreamData(source2, clock_.ApproximateNow(),
+                                         &written, &error_details_));
+  EXPECT_EQ(source2.size(), written);
+
+  iovec iov;
+  EXPECT_EQ(1, buffer_->GetReadableRegions(&iov, 1));
+  EXPECT_NE(source2.data(), iov.iov_base);
+  EXPECT_EQ(1100u, iov.iov_len);
+  EXPECT_TRUE(buffer_->DetachStreamData(&error_details_));
+  EXPECT_EQ(1100u, helper_->ReadableBytes());
+}
+
 TEST_F(QuicStreamSequencerBufferTest, GetReadableRegionsBlockedByGap) {
   // Write into [1, 1024).
   string source(1023, 'a');
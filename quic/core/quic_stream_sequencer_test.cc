@@ -662,6 +662,30 @@ TEST_F(QuicStreamSequencerTest, OutOfOrderTimestamps) {
   EXPECT_EQ(0u, sequencer_->NumBytesBuffered());
 }
 
+TEST_F(QuicStreamSequencerTest, InOrderFrameReadInPlace) {
+  FLAGS_quic_reloadable_flag_quic_reference_in_order_stream_data = true;
+  string data("abcdef");
+  QuicStreamFrame frame(1, false, 0, QuicStringPiece(data));
+  // The stream sees the frame's own memory and leaves part of it unread.
+  EXPECT_CALL(stream_, OnDataAvailable()).WillOnce(testing::Invoke([&]() {
+    iovec iov;
+    ASSERT_EQ(1, sequencer_->GetReadableRegions(&iov, 1));
+    EXPECT_EQ(data.data(), iov.iov_base);
+    sequencer_->MarkConsumed(2);
+  }));
+  sequencer_->OnStreamFrame(frame);
+
+  // The rest has been copied, so it survives the frame.
+  data = "xxxxxx";
+  EXPECT_EQ(4u, sequencer_->NumBytesBuffered());
+  EXPECT_TRUE(VerifyReadableRegion({"cdef"}));
+  EXPECT_EQ(2u, stream_.flow_controller()->bytes_consumed());
+
+  // With data buffered, the next frame is copied as before.
+  OnFrame(6, "ghi");
+  EXPECT_TRUE(VerifyReadableRegion({"cdefghi"}));
+}
+
 TEST_F(QuicStreamSequencerTest, OnStreamFrameWithNullSource) {
   // Pass in a frame with data pointing to null address, expect to close
   // connection with error.
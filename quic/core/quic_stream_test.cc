@@ -841,6 +841,34 @@ TEST_F(QuicStreamTest, WriteBufferedData) {
   EXPECT_FALSE(stream_->CanWriteNewData());
 }
 
+TEST_F(QuicStreamTest, SessionBufferedDataLimit) {
+  SetQuicFlag(&FLAGS_quic_session_buffered_data_limit, 1000);
+  // Do not stream level flow control block this stream.
+  set_initial_flow_control_window_bytes(500000);
+
+  Initialize(kShouldProcessData);
+  string data(600, 'a');
+
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillRepeatedly(Return(QuicConsumedData(0, false)));
+  stream_->WriteOrBufferData(data, false, nullptr);
+  EXPECT_EQ(data.length(), session_->buffered_stream_data_bytes());
+  EXPECT_TRUE(stream_->CanWriteNewData());
+
+  // The stream is below its own threshold, but the session is over its limit.
+  stream_->WriteOrBufferData(data, false, nullptr);
+  EXPECT_EQ(2 * data.length(), session_->buffered_stream_data_bytes());
+  EXPECT_FALSE(stream_->CanWriteNewData());
+
+  // Sending the buffered data brings the session back under its limit.
+  EXPECT_CALL(*session_, WritevData(_, _, _, _, _))
+      .WillOnce(Invoke(MockQuicSession::ConsumeAllData));
+  EXPECT_CALL(*stream_, OnCanWriteNewData()).Times(1);
+  stream_->OnCanWrite();
+  EXPECT_EQ(0u, session_->buffered_stream_data_bytes());
+  EXPECT_TRUE(stream_->CanWriteNewData());
+}
+
 TEST_F(QuicStreamTest, WriteMemSlices) {
   // Set buffered data low water mark to be 100.
   SetQuicFlag(&FLAGS_quic_buffered_data_threshold, 100);
@@ -210,7 +210,7 @@ enum QuicPacketPrivateFlags {
 // QUIC. Note that this is separate from the congestion feedback type -
 // some congestion control algorithms may use the same feedback type
 // (Reno and Cubic are the classic example for that).
-enum CongestionControlType { kCubicBytes, kRenoBytes, kBBR, kPCC };
+enum CongestionControlType { kCubicBytes, kRenoBytes, kBBR, kPCC, kBBRv2 };
 
 enum LossDetectionType {
   kNack,          // Used to mimic TCP's loss detection.
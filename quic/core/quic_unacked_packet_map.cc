@@ -10,6 +10,37 @@
 
 namespace net {
 
+namespace {
+
+// Returns the size of the heap allocated part of |frame|, if any.
+size_t EstimateFrameMemoryUsage(const QuicFrame& frame) {
+  switch (frame.type) {
+    case STREAM_FRAME:
+      return sizeof(QuicStreamFrame);
+    case ACK_FRAME:
+      return sizeof(QuicAckFrame);
+    case STOP_WAITING_FRAME:
+      return sizeof(QuicStopWaitingFrame);
+    case RST_STREAM_FRAME:
+      return sizeof(QuicRstStreamFrame);
+    case CONNECTION_CLOSE_FRAME:
+      return sizeof(QuicConnectionCloseFrame) +
+             frame.connection_close_frame->error_details.capacity();
+    case GOAWAY_FRAME:
+      return sizeof(QuicGoAwayFrame) +
+             frame.goaway_frame->reason_phrase.capacity();
+    case WINDOW_UPDATE_FRAME:
+      return sizeof(QuicWindowUpdateFrame);
+    case BLOCKED_FRAME:
+      return sizeof(QuicBlockedFrame);
+    default:
+      // Other frames are stored inline.
+      return 0;
+  }
+}
+
+}  // namespace
+
 QuicUnackedPacketMap::QuicUnackedPacketMap()
     : largest_sent_packet_(0),
       largest_sent_retransmittable_packet_(0),
@@ -17,7 +48,8 @@ QuicUnackedPacketMap::QuicUnackedPacketMap()
       least_unacked_(1),
       bytes_in_flight_(0),
       pending_crypto_packet_count_(0),
-      stream_notifier_(nullptr) {}
+      stream_notifier_(nullptr),
+      notifying_stream_frames_acked_(false) {}
 
 QuicUnackedPacketMap::~QuicUnackedPacketMap() {
   for (QuicTransmissionInfo& transmission_info : unacked_packets_) {
@@ -33,6 +65,10 @@ void QuicUnackedPacketMap::AddSentPacket(SerializedPacket* packet,
   QuicPacketNumber packet_number = packet->packet_number;
   QuicPacketLength bytes_sent = packet->encrypted_length;
   QUIC_BUG_IF(largest_sent_packet_ >= packet_number) << packet_number;
+  // Adding a packet may move the entries, while the ack being processed holds
+  // pointers and iterators into them.
+  QUIC_BUG_IF(notifying_stream_frames_acked_)
+      << "Packet " << packet_number << " sent from an ack notification";
   DCHECK_GE(packet_number, least_unacked_ + unacked_packets_.size());
   while (least_unacked_ + unacked_packets_.size() < packet_number) {
     unacked_packets_.push_back(QuicTransmissionInfo());
@@ -100,7 +136,7 @@ void QuicUnackedPacketMap::TransferRetransmissionInfo(
   DCHECK_NE(NOT_RETRANSMISSION, transmission_type);
 
   QuicTransmissionInfo* transmission_info =
-      &unacked_packets_.at(old_packet_number - least_unacked_);
+      &unacked_packets_[old_packet_number - least_unacked_];
   QuicFrames* frames = &transmission_info->retransmittable_frames;
   if (stream_notifier_ != nullptr) {
     for (const QuicFrame& frame : *frames) {
@@ -344,11 +380,24 @@ void QuicUnackedPacketMap::NotifyStreamFramesAcked(
     return;
   }
 
+  notifying_stream_frames_acked_ = true;
   for (const QuicFrame& frame : info.retransmittable_frames) {
     if (frame.type == STREAM_FRAME) {
       stream_notifier_->OnStreamFrameAcked(*frame.stream_frame, ack_delay);
     }
   }
+  notifying_stream_frames_acked_ = false;
+}
+
+size_t QuicUnackedPacketMap::EstimateMemoryUsage() const {
+  size_t usage = unacked_packets_.capacity() * sizeof(QuicTransmissionInfo);
+  for (const QuicTransmissionInfo& info : unacked_packets_) {
+    usage += info.retransmittable_frames.capacity() * sizeof(QuicFrame);
+    for (const QuicFrame& frame : info.retransmittable_frames) {
+      usage += EstimateFrameMemoryUsage(frame);
+    }
+  }
+  return usage;
 }
 
 }  // namespace net
@@ -6,12 +6,12 @@
 #define NET_QUIC_CORE_QUIC_UNACKED_PACKET_MAP_H_
 
 #include <cstddef>
-#include <deque>
 
 #include "base/macros.h"
 #include "net/quic/core/quic_packets.h"
 #include "net/quic/core/quic_transmission_info.h"
 #include "net/quic/core/stream_notifier_interface.h"
+#include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_export.h"
 
 namespace net {
@@ -42,7 +42,8 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   // Returns true if the packet |packet_number| is unacked.
   bool IsUnacked(QuicPacketNumber packet_number) const;
 
-  // Notifies stream_notifier that stream frames have been acked.
+  // Notifies stream_notifier that stream frames have been acked. The notifier
+  // must not send packets, see UnackedPacketMap.
   void NotifyStreamFramesAcked(const QuicTransmissionInfo& info,
                                QuicTime::Delta ack_delay);
 
@@ -87,9 +88,11 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   // been acked by the peer.  If there are no unacked packets, returns 0.
   QuicPacketNumber GetLeastUnacked() const;
 
-  // This can not be a QuicDeque since pointers into this are
-  // assumed to be stable.
-  typedef std::deque<QuicTransmissionInfo> UnackedPacketMap;
+  // A flat ring buffer keeps the entries walked on every ack and loss
+  // detection pass contiguous. Pointers and iterators into it are invalidated
+  // by AddSentPacket() and RemoveObsoletePackets(). Acks are processed through
+  // such pointers, so no packet may be sent from OnStreamFrameAcked().
+  typedef QuicDeque<QuicTransmissionInfo> UnackedPacketMap;
 
   typedef UnackedPacketMap::const_iterator const_iterator;
   typedef UnackedPacketMap::iterator iterator;
@@ -143,6 +146,10 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
 
   void SetStreamNotifier(StreamNotifierInterface* stream_notifier);
 
+  // Returns the estimated number of bytes of heap memory used by the map,
+  // including the frames saved for retransmission.
+  size_t EstimateMemoryUsage() const;
+
  private:
   // Called when a packet is retransmitted with a new packet number.
   // |old_packet_number| will remain unacked, but will have no
@@ -194,6 +201,8 @@ class QUIC_EXPORT_PRIVATE QuicUnackedPacketMap {
   // Receives notifications of stream frames being retransmitted or
   // acknowledged.
   StreamNotifierInterface* stream_notifier_;
+  // Set while |stream_notifier_| is told about acked stream frames.
+  bool notifying_stream_frames_acked_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicUnackedPacketMap);
 };
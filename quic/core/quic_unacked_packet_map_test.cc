@@ -7,6 +7,7 @@
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 
+using testing::Invoke;
 using testing::_;
 
 namespace net {
@@ -397,6 +398,48 @@ TEST_F(QuicUnackedPacketMapTest, SendWithGap) {
   EXPECT_EQ(5u, unacked_packets_.largest_sent_packet());
 }
 
+TEST_F(QuicUnackedPacketMapTest, EstimateMemoryUsage) {
+  const size_t empty_usage = unacked_packets_.EstimateMemoryUsage();
+  const size_t kNumPackets = 100;
+  for (QuicPacketNumber i = 1; i <= kNumPackets; ++i) {
+    SerializedPacket packet(CreateRetransmittablePacket(i));
+    unacked_packets_.AddSentPacket(&packet, 0, NOT_RETRANSMISSION, now_, true);
+  }
+  // Every packet holds its transmission info and one stream frame.
+  const size_t full_usage = unacked_packets_.EstimateMemoryUsage();
+  EXPECT_LE(empty_usage + kNumPackets * (sizeof(QuicTransmissionInfo) +
+                                         sizeof(QuicFrame) +
+                                         sizeof(QuicStreamFrame)),
+            full_usage);
+
+  // Acking all packets releases their frames.
+  for (QuicPacketNumber i = 1; i <= kNumPackets; ++i) {
+    unacked_packets_.RemoveFromInFlight(i);
+    unacked_packets_.RemoveRetransmittability(i);
+  }
+  unacked_packets_.IncreaseLargestObserved(kNumPackets);
+  unacked_packets_.RemoveObsoletePackets();
+  EXPECT_FALSE(unacked_packets_.HasUnackedPackets());
+  EXPECT_GT(full_usage, unacked_packets_.EstimateMemoryUsage());
+}
+
+TEST_F(QuicUnackedPacketMapTest, SendFromAckNotification) {
+  SerializedPacket packet1(CreateRetransmittablePacket(1));
+  unacked_packets_.AddSentPacket(&packet1, 0, NOT_RETRANSMISSION, now_, true);
+
+  // Sending moves the entries, one of which is being acked.
+  EXPECT_CALL(notifier_, OnStreamFrameAcked(_, _))
+      .WillOnce(Invoke([this](const QuicStreamFrame&, QuicTime::Delta) {
+        SerializedPacket packet2(CreateRetransmittablePacket(2));
+        unacked_packets_.AddSentPacket(&packet2, 0, NOT_RETRANSMISSION, now_,
+                                       true);
+      }));
+  EXPECT_QUIC_BUG(
+      unacked_packets_.NotifyStreamFramesAcked(
+          unacked_packets_.GetTransmissionInfo(1), QuicTime::Delta::Zero()),
+      "Packet 2 sent from an ack notification");
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
@@ -4,6 +4,8 @@
 
 #include "net/quic/core/quic_write_blocked_list.h"
 
+#include <cstring>
+
 namespace net {
 
 QuicWriteBlockedList::QuicWriteBlockedList()
@@ -9,9 +9,9 @@
 #include <cstdint>
 
 #include "base/macros.h"
+#include "net/quic/core/quic_bucketed_write_scheduler.h"
 #include "net/quic/core/quic_packets.h"
 #include "net/quic/platform/api/quic_export.h"
-#include "net/spdy/core/priority_write_scheduler.h"
 
 namespace net {
 
@@ -19,9 +19,6 @@ namespace net {
 // priority.  QUIC stream priority order is:
 // Crypto stream > Headers stream > Data streams by requested priority.
 class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
- private:
-  typedef PriorityWriteScheduler<QuicStreamId> QuicPriorityWriteScheduler;
-
  public:
   QuicWriteBlockedList();
   ~QuicWriteBlockedList();
@@ -76,11 +73,9 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
       return kHeadersStreamId;
     }
 
-    const auto id_and_precedence =
-        priority_write_scheduler_.PopNextReadyStreamAndPrecedence();
-    const QuicStreamId id = std::get<0>(id_and_precedence);
-    const SpdyPriority priority =
-        std::get<1>(id_and_precedence).spdy3_priority();
+    SpdyPriority priority;
+    const QuicStreamId id =
+        priority_write_scheduler_.PopNextReadyStream(&priority);
 
     if (!priority_write_scheduler_.HasReadyStreams()) {
       // If no streams are blocked, don't bother latching.  This stream will be
@@ -98,8 +93,7 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
   }
 
   void RegisterStream(QuicStreamId stream_id, SpdyPriority priority) {
-    priority_write_scheduler_.RegisterStream(stream_id,
-                                             SpdyStreamPrecedence(priority));
+    priority_write_scheduler_.RegisterStream(stream_id, priority);
   }
 
   void UnregisterStream(QuicStreamId stream_id) {
@@ -107,8 +101,7 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
   }
 
   void UpdateStreamPriority(QuicStreamId stream_id, SpdyPriority new_priority) {
-    priority_write_scheduler_.UpdateStreamPrecedence(
-        stream_id, SpdyStreamPrecedence(new_priority));
+    priority_write_scheduler_.UpdateStreamPriority(stream_id, new_priority);
   }
 
   void UpdateBytesForStream(QuicStreamId stream_id, size_t bytes) {
@@ -146,7 +139,7 @@ class QUIC_EXPORT_PRIVATE QuicWriteBlockedList {
   bool headers_stream_blocked() const { return headers_stream_blocked_; }
 
  private:
-  QuicPriorityWriteScheduler priority_write_scheduler_;
+  QuicBucketedWriteScheduler priority_write_scheduler_;
 
   // If performing batch writes, this will be the stream ID of the stream doing
   // batch writes for this priority level.  We will allow this stream to write
@@ -0,0 +1,123 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Compares QuicBucketedWriteScheduler, which backs QuicWriteBlockedList, with
+// the PriorityWriteScheduler it replaces.
+
+#include <string>
+
+#include "base/test/perf_time_logger.h"
+#include "net/quic/core/quic_bucketed_write_scheduler.h"
+#include "net/quic/platform/api/quic_str_cat.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/spdy/core/priority_write_scheduler.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int kOperations = 1000000;
+// Priority of HTTP requests without an explicit priority.
+const SpdyPriority kRequestPriority = 3;
+
+class PriorityWriteSchedulerAdapter {
+ public:
+  void RegisterStream(QuicStreamId id, SpdyPriority priority) {
+    scheduler_.RegisterStream(id, SpdyStreamPrecedence(priority));
+  }
+  void UpdateStreamPriority(QuicStreamId id, SpdyPriority priority) {
+    scheduler_.UpdateStreamPrecedence(id, SpdyStreamPrecedence(priority));
+  }
+  void MarkStreamReady(QuicStreamId id) {
+    scheduler_.MarkStreamReady(id, false);
+  }
+  QuicStreamId PopNextReadyStream() { return scheduler_.PopNextReadyStream(); }
+  bool ShouldYield(QuicStreamId id) const {
+    return scheduler_.ShouldYield(id);
+  }
+
+ private:
+  PriorityWriteScheduler<QuicStreamId> scheduler_;
+};
+
+class BucketedWriteSchedulerAdapter {
+ public:
+  void RegisterStream(QuicStreamId id, SpdyPriority priority) {
+    scheduler_.RegisterStream(id, priority);
+  }
+  void UpdateStreamPriority(QuicStreamId id, SpdyPriority priority) {
+    scheduler_.UpdateStreamPriority(id, priority);
+  }
+  void MarkStreamReady(QuicStreamId id) {
+    scheduler_.MarkStreamReady(id, false);
+  }
+  QuicStreamId PopNextReadyStream() {
+    SpdyPriority priority;
+    return scheduler_.PopNextReadyStream(&priority);
+  }
+  bool ShouldYield(QuicStreamId id) const {
+    return scheduler_.ShouldYield(id);
+  }
+
+ private:
+  QuicBucketedWriteScheduler scheduler_;
+};
+
+// All |num_streams| streams are ready to write, most of them at the default
+// priority as with HTTP requests.  Each operation pops the next stream, checks
+// whether it should yield, and marks it ready again, and every fourth
+// operation moves another stream to a different priority.
+template <typename Scheduler>
+void Benchmark(const std::string& name, QuicStreamId num_streams) {
+  Scheduler scheduler;
+  const QuicStreamId kFirstStreamId = 5;
+  for (QuicStreamId i = 0; i < num_streams; ++i) {
+    scheduler.RegisterStream(kFirstStreamId + 2 * i,
+                             i % 4 == 0 ? i % (kV3LowestPriority + 1)
+                                        : kRequestPriority);
+    scheduler.MarkStreamReady(kFirstStreamId + 2 * i);
+  }
+
+  size_t yields = 0;
+  base::PerfTimeLogger timer(
+      QuicStrCat(name, "_", num_streams, "_streams").c_str());
+  for (int i = 0; i < kOperations; ++i) {
+    const QuicStreamId id = scheduler.PopNextReadyStream();
+    if (scheduler.ShouldYield(id)) {
+      ++yields;
+    }
+    scheduler.MarkStreamReady(id);
+    if (i % 4 == 0) {
+      // Alternates the priority of each stream on every pass over them.
+      const int update = i / 4;
+      const QuicStreamId update_id =
+          kFirstStreamId + 2 * ((update * 7) % num_streams);
+      scheduler.UpdateStreamPriority(
+          update_id, kRequestPriority + update / num_streams % 2);
+    }
+  }
+  timer.Done();
+  // Keeps the loop from being optimized away.
+  EXPECT_LE(yields, static_cast<size_t>(kOperations));
+}
+
+class QuicWriteBlockedListPerfTest : public QuicTest {};
+
+TEST_F(QuicWriteBlockedListPerfTest, PriorityWriteScheduler) {
+  for (QuicStreamId num_streams : {10, 100, 1000}) {
+    Benchmark<PriorityWriteSchedulerAdapter>("PriorityWriteScheduler",
+                                             num_streams);
+  }
+}
+
+TEST_F(QuicWriteBlockedListPerfTest, BucketedWriteScheduler) {
+  for (QuicStreamId num_streams : {10, 100, 1000}) {
+    Benchmark<BucketedWriteSchedulerAdapter>("QuicBucketedWriteScheduler",
+                                             num_streams);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
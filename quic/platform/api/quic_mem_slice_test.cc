@@ -4,7 +4,12 @@
 
 #include "net/quic/platform/api/quic_mem_slice.h"
 
+#include <cstring>
+#include <memory>
+
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
 #include "net/quic/core/quic_simple_buffer_allocator.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_test.h"
 
 namespace net {
@@ -45,6 +50,26 @@ TEST_F(QuicMemSliceTest, MoveAssign) {
   EXPECT_TRUE(slice_.empty());
 }
 
+TEST_F(QuicMemSliceTest, OutlivesPooledAllocator) {
+  auto allocator = QuicMakeUnique<QuicPooledBufferAllocator>();
+  QuicMemSlice slice(allocator.get(), 1024);
+  EXPECT_EQ(1u, allocator->stats().allocations);
+  allocator.reset();
+
+  // The slice's buffer is still usable, and goes back to the heap when the
+  // slice is destroyed.
+  memset(const_cast<char*>(slice.data()), 0xaa, slice.length());
+  EXPECT_EQ(1024u, slice.length());
+}
+
+TEST_F(QuicMemSliceTest, OutlivesSimpleAllocator) {
+  auto allocator = QuicMakeUnique<SimpleBufferAllocator>();
+  QuicMemSlice slice(allocator.get(), 1024);
+  allocator.reset();
+  memset(const_cast<char*>(slice.data()), 0xaa, slice.length());
+  EXPECT_EQ(1024u, slice.length());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
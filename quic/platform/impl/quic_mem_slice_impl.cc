@@ -4,15 +4,45 @@
 
 #include "net/quic/platform/impl/quic_mem_slice_impl.h"
 
-#include "net/quic/core/quic_buffer_allocator.h"
+#include "base/logging.h"
+#include "net/quic/core/quic_pooled_buffer_allocator.h"
 
 namespace net {
 
+namespace {
+
+// An IOBuffer whose memory comes from, and goes back to, the pool of a
+// QuicPooledBufferAllocator. The buffer keeps its pool alive, so it does not
+// reference the allocator and may outlive it.
+class QuicPooledIOBuffer : public IOBuffer {
+ public:
+  QuicPooledIOBuffer(QuicBufferAllocator* allocator, size_t length)
+      : IOBuffer(allocator->New(length)) {
+    DCHECK(allocator->IsPooled());
+  }
+
+ private:
+  ~QuicPooledIOBuffer() override {
+    QuicPooledBufferAllocator::Release(data_);
+    // Keep IOBuffer from freeing the memory itself.
+    data_ = nullptr;
+  }
+};
+
+}  // namespace
+
 QuicMemSliceImpl::QuicMemSliceImpl() = default;
 
-QuicMemSliceImpl::QuicMemSliceImpl(QuicBufferAllocator* /*allocator*/,
+QuicMemSliceImpl::QuicMemSliceImpl(QuicBufferAllocator* allocator,
                                    size_t length) {
-  io_buffer_ = new IOBuffer(length);
+  // Memory from other allocators would have to go back through the
+  // allocator, which may be destroyed before the last reference to the
+  // buffer, so it comes from the heap instead.
+  if (allocator != nullptr && allocator->IsPooled()) {
+    io_buffer_ = new QuicPooledIOBuffer(allocator, length);
+  } else {
+    io_buffer_ = new IOBuffer(length);
+  }
   length_ = length;
 }
 
@@ -19,7 +19,9 @@ class QUIC_EXPORT_PRIVATE QuicMemSliceImpl {
   // Constructs an empty QuicMemSliceImpl.
   QuicMemSliceImpl();
   // Constructs a QuicMemSliceImp by let |allocator| allocate a data buffer of
-  // |length|.
+  // |length|. Only pooled allocators are used, as their buffers go back to the
+  // pool once the last reference goes away, even if |allocator| itself has
+  // been destroyed by then. Other allocators fall back to the heap.
   QuicMemSliceImpl(QuicBufferAllocator* allocator, size_t length);
 
   QuicMemSliceImpl(scoped_refptr<IOBuffer> io_buffer, size_t length);
@@ -235,7 +235,7 @@ void QuartcSession::StartCryptoHandshake() {
     crypto_stream->CryptoConnect();
   } else {
     quic_compressed_certs_cache_.reset(new QuicCompressedCertsCache(
-        QuicCompressedCertsCache::kQuicCompressedCertsCacheSize));
+        QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes));
     bool use_stateless_rejects_if_peer_supported = false;
     QuicCryptoServerStream* crypto_stream = new QuicCryptoServerStream(
         quic_crypto_server_config_.get(), quic_compressed_certs_cache_.get(),
@@ -272,6 +272,12 @@ QuartcStreamInterface* QuartcSession::CreateOutgoingStream(
   return CreateOutgoingDynamicStream();
 }
 
+void QuartcSession::BundleWrites(const std::function<void()>& writes) {
+  QuicConnection::ScopedPacketFlusher flusher(
+      connection_.get(), QuicConnection::SEND_ACK_IF_QUEUED);
+  writes();
+}
+
 void QuartcSession::SetDelegate(
     QuartcSessionInterface::Delegate* session_delegate) {
   if (session_delegate_) {
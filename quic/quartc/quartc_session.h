@@ -78,6 +78,8 @@ class QUIC_EXPORT_PRIVATE QuartcSession
 
   QuartcSessionStats GetStats() override;
 
+  void BundleWrites(const std::function<void()>& writes) override;
+
   void SetDelegate(QuartcSessionInterface::Delegate* session_delegate) override;
 
   void OnTransportCanWrite() override;
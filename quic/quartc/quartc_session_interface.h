@@ -7,6 +7,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <functional>
 #include <string>
 
 #include "net/quic/core/quic_bandwidth.h"
@@ -89,6 +90,12 @@ class QUIC_EXPORT_PRIVATE QuartcSessionInterface {
   // Gets stats associated with this Quartc session.
   virtual QuartcSessionStats GetStats() = 0;
 
+  // Runs |writes|, bundling the writes it makes on a best-effort basis, so
+  // that small writes to any stream share packets. Data is sent whenever
+  // enough of it has accumulated to fill a packet, and the rest is sent
+  // before BundleWrites() returns.
+  virtual void BundleWrites(const std::function<void()>& writes) = 0;
+
   // Send and receive packets, like a virtual UDP socket. For example, this
   // could be implemented by WebRTC's IceTransport.
   class PacketTransport {
@@ -304,11 +304,15 @@ class FakeTransport : public QuartcSessionInterface::PacketTransport {
 
   int Write(const char* buffer, size_t buf_len) override {
     DCHECK(channel_);
+    ++packets_written_;
     return channel_->SendPacket(buffer, buf_len);
   }
 
+  int packets_written() const { return packets_written_; }
+
  private:
   FakeTransportChannel* channel_;
+  int packets_written_ = 0;
 };
 
 class FakeQuartcSessionDelegate : public QuartcSessionInterface::Delegate {
@@ -650,6 +654,34 @@ TEST_F(QuartcSessionTest, CancelQuartcStream) {
   EXPECT_TRUE(client_peer_->IsClosedStream(id));
 }
 
+TEST_F(QuartcSessionTest, BundleWrites) {
+  CreateClientAndServerSessions();
+  StartHandshake();
+  ASSERT_TRUE(client_peer_->IsCryptoHandshakeConfirmed());
+  ASSERT_TRUE(server_peer_->IsCryptoHandshakeConfirmed());
+
+  QuartcStreamInterface* first =
+      client_peer_->CreateOutgoingStream(kDefaultStreamParam);
+  QuartcStreamInterface* second =
+      client_peer_->CreateOutgoingStream(kDefaultStreamParam);
+  ASSERT_NE(nullptr, first);
+  ASSERT_NE(nullptr, second);
+  first->SetDelegate(client_peer_->stream_delegate());
+  second->SetDelegate(client_peer_->stream_delegate());
+
+  const int packets_written = client_transport_->packets_written();
+  client_peer_->BundleWrites([this, first, second, packets_written]() {
+    first->Write("first", 5, kDefaultWriteParam);
+    second->Write("second", 6, kDefaultWriteParam);
+    EXPECT_EQ(packets_written, client_transport_->packets_written());
+  });
+
+  // Both writes fit in a single packet, sent once the batch is done.
+  EXPECT_EQ(packets_written + 1, client_transport_->packets_written());
+  RunTasks();
+  EXPECT_TRUE(server_peer_->has_data());
+}
+
 TEST_F(QuartcSessionTest, GetStats) {
   CreateClientAndServerSessions();
   StartHandshake();
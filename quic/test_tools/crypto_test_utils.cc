@@ -394,7 +394,7 @@ int HandshakeWithFakeServer(QuicConfig* server_quic_config,
                                        QuicRandom::GetInstance(),
                                        ProofSourceForTesting());
   QuicCompressedCertsCache compressed_certs_cache(
-      QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
+      QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes);
   SetupCryptoServerConfigForTest(server_conn->clock(),
                                  server_conn->random_generator(),
                                  &crypto_config, options);
@@ -121,7 +121,7 @@ TEST(CryptoTestUtilsTest, TestGenerateFullCHLO) {
   QuicReferenceCountedPointer<QuicSignedServerConfig> signed_config(
       new QuicSignedServerConfig);
   QuicCompressedCertsCache compressed_certs_cache(
-      QuicCompressedCertsCache::kQuicCompressedCertsCacheSize);
+      QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes);
   CryptoHandshakeMessage full_chlo;
 
   QuicCryptoServerConfig::ConfigOptions old_config_options;
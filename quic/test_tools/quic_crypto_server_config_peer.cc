@@ -22,12 +22,10 @@ QuicCryptoServerConfigPeer::GetPrimaryConfig() {
 
 QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>
 QuicCryptoServerConfigPeer::GetConfig(string config_id) {
-  QuicReaderMutexLock locked(&server_config_->configs_lock_);
   if (config_id == "<primary>") {
-    return QuicReferenceCountedPointer<QuicCryptoServerConfig::Config>(
-        server_config_->primary_config_);
+    return GetPrimaryConfig();
   } else {
-    return server_config_->GetConfigWithScid(config_id);
+    return server_config_->LoadConfigSnapshot()->GetConfigWithScid(config_id);
   }
 }
 
@@ -109,6 +107,13 @@ void QuicCryptoServerConfigPeer::CheckConfigs(
                        << " in configs:\n"
                        << ConfigsDebug();
   }
+
+  // The handshake path must see the same configs.
+  std::shared_ptr<const QuicCryptoServerConfig::ConfigSnapshot> snapshot =
+      server_config_->LoadConfigSnapshot();
+  EXPECT_EQ(server_config_->configs_, snapshot->configs);
+  EXPECT_EQ(server_config_->primary_config_.get(),
+            snapshot->primary_config.get());
 }
 
 // ConfigsDebug returns a string that contains debugging information about
@@ -38,6 +38,8 @@ void QuicFramerPeer::SetLargestPacketNumber(QuicFramer* framer,
 void QuicFramerPeer::SetPerspective(QuicFramer* framer,
                                     Perspective perspective) {
   framer->perspective_ = perspective;
+  // Whether a nonce is read depends on the perspective.
+  framer->cached_public_header_.valid = false;
 }
 
 // static
@@ -53,7 +53,7 @@ QuicStream* QuicSessionPeer::GetOrCreateDynamicStream(QuicSession* session,
 }
 
 // static
-std::map<QuicStreamId, QuicStreamOffset>&
+QuicUnorderedMap<QuicStreamId, QuicStreamOffset>&
 QuicSessionPeer::GetLocallyClosedStreamsHighestOffset(QuicSession* session) {
   return session->locally_closed_streams_highest_offset_;
 }
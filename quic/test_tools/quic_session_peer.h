@@ -6,7 +6,6 @@
 #define NET_QUIC_TEST_TOOLS_QUIC_SESSION_PEER_H_
 
 #include <cstdint>
-#include <map>
 #include <memory>
 
 #include "base/macros.h"
@@ -35,7 +34,7 @@ class QuicSessionPeer {
   static QuicWriteBlockedList* GetWriteBlockedStreams(QuicSession* session);
   static QuicStream* GetOrCreateDynamicStream(QuicSession* session,
                                               QuicStreamId stream_id);
-  static std::map<QuicStreamId, QuicStreamOffset>&
+  static QuicUnorderedMap<QuicStreamId, QuicStreamOffset>&
   GetLocallyClosedStreamsHighestOffset(QuicSession* session);
   static QuicSession::StaticStreamMap& static_streams(QuicSession* session);
   static QuicSession::DynamicStreamMap& dynamic_streams(QuicSession* session);
@@ -9,7 +9,6 @@
 #include "net/quic/platform/api/quic_test.h"
 #include "net/test/gtest_util.h"
 
-typedef net::QuicStreamSequencerBuffer::BufferBlock BufferBlock;
 typedef net::QuicStreamSequencerBuffer::FrameInfo FrameInfo;
 typedef net::QuicStreamSequencerBuffer::Gap Gap;
 
@@ -47,7 +46,7 @@ bool QuicStreamSequencerBufferPeer::IsBlockArrayEmpty() {
     return true;
   }
 
-  size_t count = buffer_->blocks_count_;
+  size_t count = buffer_->blocks_size_;
   for (size_t i = 0; i < count; i++) {
     if (buffer_->blocks_[i] != nullptr) {
       return false;
@@ -101,7 +100,7 @@ size_t QuicStreamSequencerBufferPeer::GetInBlockOffset(
   return buffer_->GetInBlockOffset(offset);
 }
 
-BufferBlock* QuicStreamSequencerBufferPeer::GetBlock(size_t index) {
+char* QuicStreamSequencerBufferPeer::GetBlock(size_t index) {
   return buffer_->blocks_[index];
 }
 
@@ -142,5 +141,13 @@ bool QuicStreamSequencerBufferPeer::IsBufferAllocated() {
 size_t QuicStreamSequencerBufferPeer::block_count() {
   return buffer_->blocks_count_;
 }
+
+size_t QuicStreamSequencerBufferPeer::block_index_size() {
+  return buffer_->blocks_size_;
+}
+
+size_t QuicStreamSequencerBufferPeer::first_block_capacity() {
+  return buffer_->first_block_capacity_;
+}
 }  // namespace test
 }  // namespace net
@@ -32,7 +32,7 @@ class QuicStreamSequencerBufferPeer {
 
   size_t GetInBlockOffset(QuicStreamOffset offset);
 
-  QuicStreamSequencerBuffer::BufferBlock* GetBlock(size_t index);
+  char* GetBlock(size_t index);
 
   int GapSize();
 
@@ -53,6 +53,12 @@ class QuicStreamSequencerBufferPeer {
 
   size_t block_count();
 
+  // Number of entries currently allocated in the block index.
+  size_t block_index_size();
+
+  // Number of bytes allocated for the block at index 0.
+  size_t first_block_capacity();
+
  private:
   QuicStreamSequencerBuffer* buffer_;
   DISALLOW_COPY_AND_ASSIGN(QuicStreamSequencerBufferPeer);
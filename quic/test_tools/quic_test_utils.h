@@ -780,6 +780,7 @@ class MockSendAlgorithm : public SendAlgorithmInterface {
   MOCK_CONST_METHOD0(GetCongestionControlType, CongestionControlType());
   MOCK_METHOD2(AdjustNetworkParameters, void(QuicBandwidth, QuicTime::Delta));
   MOCK_METHOD1(OnApplicationLimited, void(QuicByteCount));
+  MOCK_CONST_METHOD0(GetTelemetryMode, uint8_t());
 
  private:
   DISALLOW_COPY_AND_ASSIGN(MockSendAlgorithm);
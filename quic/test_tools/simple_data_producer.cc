@@ -39,6 +39,16 @@ bool SimpleDataProducer::WriteStreamData(QuicStreamId id,
   return send_buffer_map_[id]->WriteStreamData(offset, data_length, writer);
 }
 
+bool SimpleDataProducer::GetStreamDataView(QuicStreamId id,
+                                           QuicStreamOffset offset,
+                                           QuicByteCount data_length,
+                                           QuicStringPiece* data) {
+  if (!QuicContainsKey(send_buffer_map_, id)) {
+    return false;
+  }
+  return send_buffer_map_[id]->GetStreamDataView(offset, data_length, data);
+}
+
 void SimpleDataProducer::OnStreamFrameAcked(
     const QuicStreamFrame& frame,
     QuicTime::Delta /*ack_delay_time*/) {
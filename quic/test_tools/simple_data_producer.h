@@ -35,6 +35,10 @@ class SimpleDataProducer : public QuicStreamFrameDataProducer,
                        QuicStreamOffset offset,
                        QuicByteCount data_length,
                        QuicDataWriter* writer) override;
+  bool GetStreamDataView(QuicStreamId id,
+                         QuicStreamOffset offset,
+                         QuicByteCount data_length,
+                         QuicStringPiece* data) override;
 
   // StreamNotifierInterface methods:
   void OnStreamFrameAcked(const QuicStreamFrame& frame,
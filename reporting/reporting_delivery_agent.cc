@@ -70,7 +70,9 @@ class ReportingDeliveryAgentImpl : public ReportingDeliveryAgent,
 
   // ReportingObserver implementation:
   void OnCacheUpdated() override {
-    if (CacheHasReports())
+    // A running timer is left alone, so that reports queued meanwhile are
+    // sent in its batch, rather than postponing it on every update.
+    if (!timer_->IsRunning() && CacheHasReports())
       StartTimer();
   }
 
@@ -119,7 +121,7 @@ class ReportingDeliveryAgentImpl : public ReportingDeliveryAgent,
       url::Origin origin = url::Origin::Create(report->url);
       if (!delegate()->CanSendReport(origin))
         continue;
-      OriginGroup origin_group(url::Origin::Create(report->url), report->group);
+      OriginGroup origin_group(std::move(origin), report->group);
       origin_group_reports[origin_group].push_back(report);
     }
 
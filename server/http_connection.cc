@@ -115,7 +115,13 @@ bool HttpConnection::QueuedWriteIOBuffer::Append(const std::string& data) {
     return false;
   }
 
-  pending_data_.push(std::make_unique<std::string>(data));
+  // Pipelined responses are coalesced into the last pending data, so that they
+  // are written together. The first pending data is not appended to, since it
+  // may be in the middle of being written.
+  if (pending_data_.size() > 1)
+    pending_data_.back()->append(data);
+  else
+    pending_data_.push(std::make_unique<std::string>(data));
   total_size_ += data.size();
 
   // If new data is the first pending data, updates data_.
@@ -81,7 +81,8 @@ class HttpConnection {
 
     // Appends new pending data and returns true if total size doesn't exceed
     // the limit, |total_size_limit_|.  It would change data() if new data is
-    // the first pending data.
+    // the first pending data.  Data appended after the one being written is
+    // merged, so that it is written at once.
     bool Append(const std::string& data);
 
     // Consumes data and changes data() accordingly.  It cannot be more than
@@ -287,6 +287,29 @@ TEST(HttpConnectionTest, QueuedWriteIOBuffer_Append_DidConsume) {
   EXPECT_EQ(0, buffer->total_size());
 }
 
+TEST(HttpConnectionTest, QueuedWriteIOBuffer_Append_Coalesces) {
+  scoped_refptr<HttpConnection::QueuedWriteIOBuffer> buffer(
+      new HttpConnection::QueuedWriteIOBuffer());
+  const std::string kData("first");
+  const std::string kData2("second");
+  const std::string kData3("third");
+  EXPECT_TRUE(buffer->Append(kData));
+  EXPECT_TRUE(buffer->Append(kData2));
+  EXPECT_TRUE(buffer->Append(kData3));
+  EXPECT_EQ(static_cast<int>(kData.size() + kData2.size() + kData3.size()),
+            buffer->total_size());
+  // The first data is still written alone.
+  EXPECT_EQ(kData, base::StringPiece(buffer->data(), buffer->GetSizeToWrite()));
+
+  // Data appended after it is written at once.
+  buffer->DidConsume(kData.size());
+  EXPECT_EQ(kData2 + kData3,
+            base::StringPiece(buffer->data(), buffer->GetSizeToWrite()));
+  buffer->DidConsume(kData2.size() + kData3.size());
+  EXPECT_TRUE(buffer->IsEmpty());
+  EXPECT_EQ(0, buffer->total_size());
+}
+
 TEST(HttpConnectionTest, QueuedWriteIOBuffer_TotalSizeLimit) {
   scoped_refptr<HttpConnection::QueuedWriteIOBuffer> buffer(
       new HttpConnection::QueuedWriteIOBuffer());
@@ -443,9 +443,18 @@ bool HttpServer::ParseHeaders(const char* data,
         case ST_URL:
         case ST_PROTO:
         case ST_VALUE:
-        case ST_NAME:
-          buffer.append(&ch, 1);
+        case ST_NAME: {
+          // Appends the whole run of characters which keep the state at once,
+          // rather than one character at a time.
+          size_t run_end = pos;
+          while (run_end < data_len &&
+                 parser_state[state][charToInput(data[run_end])] == state) {
+            ++run_end;
+          }
+          buffer.append(data + pos - 1, run_end - pos + 1);
+          pos = run_end;
           break;
+        }
         case ST_DONE:
           // We got CR to get this far, also need the LF
           return (input == INPUT_LF);
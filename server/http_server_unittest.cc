@@ -703,6 +703,25 @@ TEST_F(HttpServerTest, MultipleRequestsOnSameConnection) {
                              base::CompareCase::SENSITIVE));
 }
 
+TEST_F(HttpServerTest, PipelinedRequests) {
+  MockStreamSocket* socket = new MockStreamSocket();
+  HandleAcceptResult(base::WrapUnique<StreamSocket>(socket));
+  std::string request_text =
+      "GET /test HTTP/1.1\r\n"
+      "Content-Length: 4\r\n\r\nbody"
+      "GET /test2 HTTP/1.1\r\n"
+      "SomeHeader: 1\r\n\r\n"
+      "GET /test3 HTTP/1.1\r\n\r\n";
+  socket->DidRead(request_text.c_str(), request_text.length());
+  ASSERT_EQ(3u, requests_.size());
+  EXPECT_EQ("/test", GetRequest(0).path);
+  EXPECT_EQ("body", GetRequest(0).data);
+  EXPECT_EQ("/test2", GetRequest(1).path);
+  EXPECT_EQ("1", GetRequest(1).GetHeaderValue("someheader"));
+  EXPECT_EQ("/test3", GetRequest(2).path);
+  EXPECT_EQ(GetConnectionId(0), GetConnectionId(2));
+}
+
 class CloseOnConnectHttpServerTest : public HttpServerTest {
  public:
   void OnConnect(int connection_id) override {
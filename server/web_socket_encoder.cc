@@ -4,6 +4,7 @@
 
 #include "net/server/web_socket_encoder.h"
 
+#include <algorithm>
 #include <limits>
 #include <utility>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "net/websockets/websocket_deflate_parameters.h"
 #include "net/websockets/websocket_extension.h"
 #include "net/websockets/websocket_extension_parser.h"
+#include "net/websockets/websocket_frame.h"
 
 namespace net {
 
@@ -49,6 +51,19 @@ const size_t kTwoBytePayloadLengthField = 126;
 const size_t kEightBytePayloadLengthField = 127;
 const size_t kMaskingKeyWidthInBytes = 4;
 
+// Masks or unmasks the |size| bytes of payload at |data| in place, with the
+// key in the first kMaskingKeyWidthInBytes bytes of |mask_bytes|.
+void MaskPayload(const char* mask_bytes, char* data, size_t size) {
+  WebSocketMaskingKey masking_key;
+  std::copy(mask_bytes, mask_bytes + kMaskingKeyWidthInBytes, masking_key.key);
+  const size_t kMaxChunkSize = std::numeric_limits<int>::max();
+  for (size_t offset = 0; offset < size; offset += kMaxChunkSize) {
+    MaskWebSocketFramePayload(
+        masking_key, offset, data + offset,
+        static_cast<int>(std::min(kMaxChunkSize, size - offset)));
+  }
+}
+
 WebSocket::ParseResult DecodeFrameHybi17(const base::StringPiece& frame,
                                          bool client_frame,
                                          int* bytes_consumed,
@@ -126,11 +141,9 @@ WebSocket::ParseResult DecodeFrameHybi17(const base::StringPiece& frame,
     return WebSocket::FRAME_INCOMPLETE;
 
   if (masked) {
-    output->resize(payload_length);
-    const char* masking_key = p;
-    char* payload = const_cast<char*>(p + kMaskingKeyWidthInBytes);
-    for (size_t i = 0; i < payload_length; ++i)  // Unmask the payload.
-      (*output)[i] = payload[i] ^ masking_key[i % kMaskingKeyWidthInBytes];
+    const char* payload = p + kMaskingKeyWidthInBytes;
+    output->assign(payload, payload + payload_length);
+    MaskPayload(p, &(*output)[0], payload_length);  // Unmask the payload.
   } else {
     output->assign(p, p + payload_length);
   }
@@ -175,8 +188,9 @@ void EncodeFrameHybi17(const std::string& message,
   if (masking_key != 0) {
     const char* mask_bytes = reinterpret_cast<char*>(&masking_key);
     frame.insert(frame.end(), mask_bytes, mask_bytes + 4);
-    for (size_t i = 0; i < data_length; ++i)  // Mask the payload.
-      frame.push_back(data[i] ^ mask_bytes[i % kMaskingKeyWidthInBytes]);
+    size_t payload_offset = frame.size();
+    frame.insert(frame.end(), data, data + data_length);
+    MaskPayload(mask_bytes, frame.data() + payload_offset, data_length);
   } else {
     frame.insert(frame.end(), data, data + data_length);
   }
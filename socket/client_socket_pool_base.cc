@@ -175,6 +175,7 @@ ClientSocketPoolBaseHelper::ClientSocketPoolBaseHelper(
     base::TimeDelta used_idle_socket_timeout,
     ConnectJobFactory* connect_job_factory)
     : idle_socket_count_(0),
+      groups_with_pending_requests_(0),
       connecting_socket_count_(0),
       handed_out_socket_count_(0),
       max_sockets_(max_sockets),
@@ -240,6 +241,8 @@ bool ClientSocketPoolBaseHelper::IsStalled() const {
   // stalled.
   if ((handed_out_socket_count_ + connecting_socket_count_) < max_sockets_)
     return false;
+  if (groups_with_pending_requests_ == 0)
+    return false;
   // So in order to be stalled, |this| must be using at least |max_sockets_| AND
   // |this| must have a request that is actually stalled on the global socket
   // limit.  To find such a request, look for a group that has more requests
@@ -793,11 +796,9 @@ void ClientSocketPoolBaseHelper::CleanupIdleSocketsInGroup(
 
 ClientSocketPoolBaseHelper::Group* ClientSocketPoolBaseHelper::GetOrCreateGroup(
     const std::string& group_name) {
-  GroupMap::iterator it = group_map_.find(group_name);
-  if (it != group_map_.end())
-    return it->second;
-  Group* group = new Group;
-  group_map_[group_name] = group;
+  Group*& group = group_map_[group_name];
+  if (!group)
+    group = new Group(&groups_with_pending_requests_);
   return group;
 }
 
@@ -906,6 +907,9 @@ bool ClientSocketPoolBaseHelper::FindTopStalledGroup(
     Group** group,
     std::string* group_name) const {
   CHECK((group && group_name) || (!group && !group_name));
+  if (groups_with_pending_requests_ == 0)
+    return false;
+
   Group* top_group = NULL;
   const std::string* top_group_name = NULL;
   bool has_stalled_group = false;
@@ -1229,13 +1233,16 @@ void ClientSocketPoolBaseHelper::TryToCloseSocketsInLayeredPools() {
   }
 }
 
-ClientSocketPoolBaseHelper::Group::Group()
+ClientSocketPoolBaseHelper::Group::Group(int* groups_with_pending_requests)
     : unassigned_job_count_(0),
       pending_requests_(NUM_PRIORITIES),
+      groups_with_pending_requests_(groups_with_pending_requests),
       active_socket_count_(0) {}
 
 ClientSocketPoolBaseHelper::Group::~Group() {
   DCHECK_EQ(0u, unassigned_job_count_);
+  if (!pending_requests_.empty())
+    --*groups_with_pending_requests_;
 }
 
 void ClientSocketPoolBaseHelper::Group::StartBackupJobTimer(
@@ -1370,6 +1377,8 @@ void ClientSocketPoolBaseHelper::Group::InsertPendingRequest(
     std::unique_ptr<Request> request) {
   // This value must be cached before we release |request|.
   RequestPriority priority = request->priority();
+  if (pending_requests_.empty())
+    ++*groups_with_pending_requests_;
   if (request->respect_limits() == ClientSocketPool::RespectLimits::DISABLED) {
     // Put requests with RespectLimits::DISABLED (which should have
     // priority == MAXIMUM_PRIORITY) ahead of other requests with
@@ -1438,8 +1447,10 @@ ClientSocketPoolBaseHelper::Group::RemovePendingRequest(
   std::unique_ptr<Request> request(pointer.value());
   pending_requests_.Erase(pointer);
   // If there are no more requests, kill the backup timer.
-  if (pending_requests_.empty())
+  if (pending_requests_.empty()) {
+    --*groups_with_pending_requests_;
     backup_job_timer_.Stop();
+  }
   request->CrashIfInvalid();
   return request;
 }
@@ -403,7 +403,9 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
    public:
     using JobList = std::list<std::unique_ptr<ConnectJob>>;
 
-    Group();
+    // |groups_with_pending_requests| is the pool's count of groups that have
+    // pending requests, which the group keeps up to date.
+    explicit Group(int* groups_with_pending_requests);
     ~Group();
 
     bool IsEmpty() const {
@@ -523,6 +525,7 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     std::list<IdleSocket> idle_sockets_;
     JobList jobs_;
     RequestQueue pending_requests_;
+    int* const groups_with_pending_requests_;
     int active_socket_count_;  // number of active sockets used by clients
     // A timer for when to start the backup job.
     base::OneShotTimer backup_job_timer_;
@@ -648,6 +651,10 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   // The total number of idle sockets in the system.
   int idle_socket_count_;
 
+  // Number of groups with pending requests. When there are none, no group can
+  // be stalled, and socket releases need not look through all the groups.
+  int groups_with_pending_requests_;
+
   // Number of connecting sockets across all groups.
   int connecting_socket_count_;
 
@@ -1318,6 +1318,63 @@ TEST_F(ClientSocketPoolBaseTest, CancelPendingSocketAtSocketLimit) {
   EXPECT_EQ(1, pool_->IdleSocketCount());
 }
 
+// Tests that the pool tracks which groups have pending requests as they are
+// queued, canceled and served, so that it is stalled only while one has.
+TEST_F(ClientSocketPoolBaseTest, StalledWhileGroupsHavePendingRequests) {
+  CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
+  connect_job_factory_->set_job_type(TestConnectJob::kMockJob);
+
+  ClientSocketHandle handles[kDefaultMaxSockets];
+  for (int i = 0; i < kDefaultMaxSockets; ++i) {
+    TestCompletionCallback callback;
+    EXPECT_EQ(OK, handles[i].Init(base::IntToString(i), params_,
+                                  DEFAULT_PRIORITY,
+                                  ClientSocketPool::RespectLimits::ENABLED,
+                                  callback.callback(), pool_.get(),
+                                  NetLogWithSource()));
+  }
+  EXPECT_FALSE(pool_->IsStalled());
+
+  ClientSocketHandle foo_handles[2];
+  TestCompletionCallback foo_callbacks[2];
+  for (size_t i = 0; i < arraysize(foo_handles); ++i) {
+    EXPECT_EQ(ERR_IO_PENDING,
+              foo_handles[i].Init("foo", params_, DEFAULT_PRIORITY,
+                                  ClientSocketPool::RespectLimits::ENABLED,
+                                  foo_callbacks[i].callback(), pool_.get(),
+                                  NetLogWithSource()));
+  }
+  ClientSocketHandle bar_handle;
+  TestCompletionCallback bar_callback;
+  EXPECT_EQ(ERR_IO_PENDING,
+            bar_handle.Init("bar", params_, DEFAULT_PRIORITY,
+                            ClientSocketPool::RespectLimits::ENABLED,
+                            bar_callback.callback(), pool_.get(),
+                            NetLogWithSource()));
+  EXPECT_TRUE(pool_->IsStalled());
+
+  // Canceling one of the requests of a group leaves it with a pending request.
+  foo_handles[0].Reset();
+  EXPECT_TRUE(pool_->IsStalled());
+  bar_handle.Reset();
+  EXPECT_TRUE(pool_->IsStalled());
+
+  // Releasing a socket serves the last pending request.
+  handles[0].Reset();
+  EXPECT_THAT(foo_callbacks[1].WaitForResult(), IsOk());
+  EXPECT_FALSE(pool_->IsStalled());
+
+  // And the count starts over when a group has a pending request again.
+  EXPECT_EQ(ERR_IO_PENDING,
+            bar_handle.Init("bar", params_, DEFAULT_PRIORITY,
+                            ClientSocketPool::RespectLimits::ENABLED,
+                            bar_callback.callback(), pool_.get(),
+                            NetLogWithSource()));
+  EXPECT_TRUE(pool_->IsStalled());
+  bar_handle.Reset();
+  EXPECT_FALSE(pool_->IsStalled());
+}
+
 TEST_F(ClientSocketPoolBaseTest, WaitForStalledSocketAtSocketLimit) {
   CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
   connect_job_factory_->set_job_type(TestConnectJob::kMockJob);
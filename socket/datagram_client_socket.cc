@@ -0,0 +1,70 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/socket/datagram_client_socket.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+
+namespace net {
+
+namespace {
+
+// Turns the result of a Write() into the result of a WriteMultiple() of one
+// datagram.
+int ToWriteMultipleResult(int rv) {
+  return rv < 0 ? rv : 1;
+}
+
+void OnWriteComplete(const CompletionCallback& callback, int rv) {
+  callback.Run(ToWriteMultipleResult(rv));
+}
+
+// Turns the result of a Read() into the result of a ReadMultiple() of one
+// datagram.
+int ToReadMultipleResult(int rv, int* lengths) {
+  if (rv < 0)
+    return rv;
+  lengths[0] = rv;
+  return 1;
+}
+
+void OnReadComplete(int* lengths,
+                    const CompletionCallback& callback,
+                    int rv) {
+  callback.Run(ToReadMultipleResult(rv, lengths));
+}
+
+}  // namespace
+
+int DatagramClientSocket::ReadMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    int buf_len,
+    int* lengths,
+    const CompletionCallback& callback) {
+  DCHECK(!bufs.empty());
+  int rv = Read(bufs[0].get(), buf_len,
+                base::Bind(&OnReadComplete, lengths, callback));
+  if (rv == ERR_IO_PENDING)
+    return rv;
+  return ToReadMultipleResult(rv, lengths);
+}
+
+int DatagramClientSocket::WriteMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    const std::vector<int>& lengths,
+    const CompletionCallback& callback,
+    const NetworkTrafficAnnotationTag& traffic_annotation) {
+  DCHECK(!bufs.empty());
+  DCHECK_EQ(bufs.size(), lengths.size());
+  int rv = Write(bufs[0].get(), lengths[0],
+                 base::Bind(&OnWriteComplete, callback), traffic_annotation);
+  if (rv == ERR_IO_PENDING)
+    return rv;
+  return ToWriteMultipleResult(rv);
+}
+
+}  // namespace net
@@ -5,6 +5,10 @@
 #ifndef NET_SOCKET_DATAGRAM_CLIENT_SOCKET_H_
 #define NET_SOCKET_DATAGRAM_CLIENT_SOCKET_H_
 
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "net/base/completion_callback.h"
 #include "net/base/net_export.h"
 #include "net/base/network_change_notifier.h"
 #include "net/socket/datagram_socket.h"
@@ -12,6 +16,7 @@
 
 namespace net {
 
+class IOBuffer;
 class IPEndPoint;
 
 class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
@@ -41,6 +46,31 @@ class NET_EXPORT_PRIVATE DatagramClientSocket : public DatagramSocket,
   // ConnectUsingNetwork() or ConnectUsingDefaultNetwork().
   virtual NetworkChangeNotifier::NetworkHandle GetBoundNetwork() const = 0;
 
+  // Reads up to |bufs.size()| datagrams, each into the next of |bufs|, which
+  // hold |buf_len| bytes each, and stores the length of each datagram in
+  // |lengths|, which must have room for |bufs.size()| entries. Returns the
+  // number of datagrams read, which is at least one, or a net error code.
+  // If ERR_IO_PENDING is returned, |callback| is run with the same once a
+  // datagram is available, and the caller must keep |bufs| and |lengths|
+  // alive until then. Like Read(), only one read may be outstanding.
+  // The default implementation reads a single datagram with Read().
+  virtual int ReadMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                           int buf_len,
+                           int* lengths,
+                           const CompletionCallback& callback);
+
+  // Writes each of |bufs|, the sizes of which are in |lengths|, as a
+  // datagram, in order. Returns the number of datagrams written, which is at
+  // least one, or a net error code. If ERR_IO_PENDING is returned, |callback|
+  // is run with the same once the socket is writable and the caller must keep
+  // |bufs| alive until then. Like Write(), only one write may be outstanding.
+  // The default implementation writes only the first datagram, with Write().
+  virtual int WriteMultiple(
+      const std::vector<scoped_refptr<IOBuffer>>& bufs,
+      const std::vector<int>& lengths,
+      const CompletionCallback& callback,
+      const NetworkTrafficAnnotationTag& traffic_annotation);
+
 };
 
 }  // namespace net
@@ -81,4 +81,14 @@ int SetSocketSendBufferSize(SocketDescriptor fd, int32_t size) {
   return net_error;
 }
 
+int SetTCPNotSentLowWaterMark(SocketDescriptor fd, int32_t bytes) {
+#if defined(OS_POSIX) && defined(TCP_NOTSENT_LOWAT)
+  int rv = setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &bytes,
+                      sizeof(bytes));
+  return rv == -1 ? MapSystemError(errno) : OK;
+#else
+  return ERR_NOT_IMPLEMENTED;
+#endif
+}
+
 }  // namespace net
@@ -57,6 +57,12 @@ int SetSocketReceiveBufferSize(SocketDescriptor fd, int32_t size);
 // returns a net error code, on success returns OK.
 int SetSocketSendBufferSize(SocketDescriptor fd, int32_t size);
 
+// SetTCPNotSentLowWaterMark() sets the TCP_NOTSENT_LOWAT socket option, which
+// limits the unsent data buffered by the kernel to about |bytes|. On error
+// returns a net error code, ERR_NOT_IMPLEMENTED if the option is not
+// supported, and on success returns OK.
+int SetTCPNotSentLowWaterMark(SocketDescriptor fd, int32_t bytes);
+
 }  // namespace net
 
 #endif  // NET_SOCKET_SOCKET_OPTIONS_H_
@@ -76,6 +76,17 @@ const int kNoPendingResult = 1;
 // Default size of the internal BoringSSL buffers.
 const int kDefaultOpenSSLBufferSize = 17 * 1024;
 
+// Number of sessions kept per server in the process-wide session cache. TLS
+// 1.3 tickets are single-use, so this bounds how many parallel connections to
+// a server can resume.
+const size_t kMaxSessionsPerEntry = 4;
+
+SSLClientSessionCache::Config CreateSessionCacheConfig() {
+  SSLClientSessionCache::Config config;
+  config.max_sessions_per_entry = kMaxSessionsPerEntry;
+  return config;
+}
+
 // TLS extension number use for Token Binding.
 const unsigned int kTbExtNum = 24;
 
@@ -232,7 +243,7 @@ class SSLClientSocketImpl::SSLContext {
  private:
   friend struct base::DefaultSingletonTraits<SSLContext>;
 
-  SSLContext() : session_cache_(SSLClientSessionCache::Config()) {
+  SSLContext() : session_cache_(CreateSessionCacheConfig()) {
     crypto::EnsureOpenSSLInit();
     ssl_socket_data_index_ = SSL_get_ex_new_index(0, 0, 0, 0, 0);
     DCHECK_NE(ssl_socket_data_index_, -1);
@@ -648,6 +659,10 @@ bool SSLClientSocketImpl::WasEverUsed() const {
   return was_ever_used_;
 }
 
+void SSLClientSocketImpl::SetNotSentLowWaterMarkIfSupported(int32_t bytes) {
+  transport_->socket()->SetNotSentLowWaterMarkIfSupported(bytes);
+}
+
 bool SSLClientSocketImpl::WasAlpnNegotiated() const {
   return negotiated_protocol_ != kProtoUnknown;
 }
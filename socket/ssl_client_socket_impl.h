@@ -109,6 +109,7 @@ class SSLClientSocketImpl : public SSLClientSocket,
   void SetSubresourceSpeculation() override;
   void SetOmniboxSpeculation() override;
   bool WasEverUsed() const override;
+  void SetNotSentLowWaterMarkIfSupported(int32_t bytes) override;
   bool WasAlpnNegotiated() const override;
   NextProto GetNegotiatedProtocol() const override;
   bool GetSSLInfo(SSLInfo* ssl_info) override;
@@ -104,6 +104,13 @@ class NET_EXPORT_PRIVATE StreamSocket : public Socket {
   // Enables use of TCP FastOpen for the underlying transport socket.
   virtual void EnableTCPFastOpenIfSupported() {}
 
+  // Asks the underlying transport socket to hold at most about |bytes| of
+  // written data that has not been sent yet, see TCP_NOTSENT_LOWAT, so that
+  // data written later is not queued behind a large backlog in the kernel.
+  // Writes then complete once the backlog drains below |bytes|. Does nothing
+  // where this is not supported.
+  virtual void SetNotSentLowWaterMarkIfSupported(int32_t bytes) {}
+
   // Returns true if ALPN was negotiated during the connection of this socket.
   virtual bool WasAlpnNegotiated() const = 0;
 
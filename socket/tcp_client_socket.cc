@@ -271,6 +271,11 @@ void TCPClientSocket::EnableTCPFastOpenIfSupported() {
   socket_->EnableTCPFastOpenIfSupported();
 }
 
+void TCPClientSocket::SetNotSentLowWaterMarkIfSupported(int32_t bytes) {
+  if (socket_->IsValid())
+    socket_->SetNotSentLowWaterMark(bytes);
+}
+
 bool TCPClientSocket::WasAlpnNegotiated() const {
   return false;
 }
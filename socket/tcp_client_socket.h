@@ -59,6 +59,7 @@ class NET_EXPORT TCPClientSocket : public StreamSocket {
   void SetOmniboxSpeculation() override;
   bool WasEverUsed() const override;
   void EnableTCPFastOpenIfSupported() override;
+  void SetNotSentLowWaterMarkIfSupported(int32_t bytes) override;
   bool WasAlpnNegotiated() const override;
   NextProto GetNegotiatedProtocol() const override;
   bool GetSSLInfo(SSLInfo* ssl_info) override;
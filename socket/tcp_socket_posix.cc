@@ -22,6 +22,7 @@
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "net/base/address_list.h"
+#include "net/base/backoff_entry.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
@@ -54,8 +55,34 @@ namespace net {
 
 namespace {
 
-// True if TCP FastOpen connect-with-write has failed at least once.
-bool g_tcp_fastopen_has_failed = false;
+// TCP FastOpen is not used for a while after a connect-with-write failed.
+// The delay doubles on every failure after TCP FastOpen was re-enabled, since
+// a middlebox that blackholes SYN+Data packets usually keeps doing so.
+const BackoffEntry::Policy kTCPFastOpenBackoffPolicy = {
+    // Number of initial errors to ignore.
+    0,
+    // Initial delay: five minutes.
+    5 * 60 * 1000,
+    // Factor by which the delay is multiplied on every failure.
+    2,
+    // Fuzzing percentage.
+    0,
+    // Maximum delay: one day.
+    24 * 60 * 60 * 1000,
+    // Never discard the entry.
+    -1,
+    // Use the initial delay from the first failure on.
+    false,
+};
+
+// Tracks TCP FastOpen failures across all sockets. Created on first use.
+BackoffEntry* g_tcp_fastopen_backoff = nullptr;
+
+BackoffEntry* GetTCPFastOpenBackoff() {
+  if (!g_tcp_fastopen_backoff)
+    g_tcp_fastopen_backoff = new BackoffEntry(&kTCPFastOpenBackoffPolicy);
+  return g_tcp_fastopen_backoff;
+}
 
 // SetTCPKeepAlive sets SO_KEEPALIVE.
 bool SetTCPKeepAlive(int fd, bool enable, int delay) {
@@ -466,6 +493,12 @@ bool TCPSocketPosix::SetNoDelay(bool no_delay) {
   return SetTCPNoDelay(socket_->socket_fd(), no_delay) == OK;
 }
 
+bool TCPSocketPosix::SetNotSentLowWaterMark(int32_t bytes) {
+  DCHECK(socket_);
+
+  return SetTCPNotSentLowWaterMark(socket_->socket_fd(), bytes) == OK;
+}
+
 void TCPSocketPosix::Close() {
   socket_.reset();
 
@@ -485,11 +518,11 @@ void TCPSocketPosix::EnableTCPFastOpenIfSupported() {
   if (!IsTCPFastOpenSupported())
     return;
 
-  // Do not enable TCP FastOpen if it had previously failed.
-  // This check conservatively avoids middleboxes that may blackhole
-  // TCP FastOpen SYN+Data packets; on such a failure, subsequent sockets
-  // should not use TCP FastOpen.
-  if (!g_tcp_fastopen_has_failed)
+  // Do not enable TCP FastOpen if it had recently failed.
+  // This check avoids middleboxes that may blackhole TCP FastOpen SYN+Data
+  // packets; on such a failure, subsequent sockets should not use TCP
+  // FastOpen until the retry delay has passed.
+  if (!TCPFastOpenHasFailed())
     use_tcp_fastopen_ = true;
   else
     tcp_fastopen_status_ = TCP_FASTOPEN_PREVIOUSLY_FAILED;
@@ -522,6 +555,27 @@ void TCPSocketPosix::EndLoggingMultipleConnectAttempts(int net_error) {
   }
 }
 
+// static
+bool TCPSocketPosix::TCPFastOpenHasFailed() {
+  return GetTCPFastOpenBackoff()->ShouldRejectRequest();
+}
+
+// static
+void TCPSocketPosix::RecordTCPFastOpenFailure() {
+  // Sockets which attempted TCP FastOpen before it was turned off may still
+  // fail, only the first of those failures extends the delay.
+  if (!TCPFastOpenHasFailed())
+    GetTCPFastOpenBackoff()->InformOfRequest(false);
+}
+
+// static
+void TCPSocketPosix::ResetTCPFastOpenBackoffForTesting(
+    base::TickClock* tick_clock) {
+  delete g_tcp_fastopen_backoff;
+  g_tcp_fastopen_backoff =
+      new BackoffEntry(&kTCPFastOpenBackoffPolicy, tick_clock);
+}
+
 SocketDescriptor TCPSocketPosix::ReleaseSocketDescriptorForTesting() {
   SocketDescriptor socket_descriptor = socket_->ReleaseConnectedSocket();
   socket_.reset();
@@ -666,12 +720,11 @@ void TCPSocketPosix::HandleReadCompletedHelper(int rv) {
     // subsequent connections. TCP FastOpen status is recorded in both cases.
     // TODO (jri): This currently results in conservative behavior, where TCP
     // FastOpen is turned off on _any_ error. Implement optimizations,
-    // such as turning off TCP FastOpen on more specific errors, and
-    // re-attempting TCP FastOpen after a certain amount of time has passed.
+    // such as turning off TCP FastOpen on more specific errors.
     if (rv >= 0)
       tcp_fastopen_connected_ = true;
     else
-      g_tcp_fastopen_has_failed = true;
+      RecordTCPFastOpenFailure();
     UpdateTCPFastOpenStatusAfterRead();
   }
 
@@ -696,10 +749,9 @@ int TCPSocketPosix::HandleWriteCompleted(IOBuffer* buf, int rv) {
       // TCP FastOpen for all subsequent connections.
       // TODO (jri): This currently results in conservative behavior, where TCP
       // FastOpen is turned off on _any_ error. Implement optimizations,
-      // such as turning off TCP FastOpen on more specific errors, and
-      // re-attempting TCP FastOpen after a certain amount of time has passed.
+      // such as turning off TCP FastOpen on more specific errors.
       tcp_fastopen_status_ = TCP_FASTOPEN_ERROR;
-      g_tcp_fastopen_has_failed = true;
+      RecordTCPFastOpenFailure();
     }
     net_log_.AddEvent(NetLogEventType::SOCKET_WRITE_ERROR,
                       CreateNetLogSocketErrorCallback(rv, errno));
@@ -769,7 +821,7 @@ int TCPSocketPosix::TcpFastOpenWrite(IOBuffer* buf,
     // occurrences of EOPNOTSUPP and EPIPE, and (ii) afterwards, consider
     // turning off TCP FastOpen on more specific errors.
     tcp_fastopen_status_ = TCP_FASTOPEN_ERROR;
-    g_tcp_fastopen_has_failed = true;
+    RecordTCPFastOpenFailure();
     return rv;
   }
 
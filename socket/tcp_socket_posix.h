@@ -11,6 +11,7 @@
 
 #include "base/callback.h"
 #include "base/compiler_specific.h"
+#include "base/gtest_prod_util.h"
 #include "base/macros.h"
 #include "net/base/address_family.h"
 #include "net/base/completion_callback.h"
@@ -21,6 +22,7 @@
 #include "net/traffic_annotation/network_traffic_annotation.h"
 
 namespace base {
+class TickClock;
 class TimeDelta;
 }
 
@@ -116,6 +118,7 @@ class NET_EXPORT TCPSocketPosix {
   int SetSendBufferSize(int32_t size);
   bool SetKeepAlive(bool enable, int delay);
   bool SetNoDelay(bool no_delay);
+  bool SetNotSentLowWaterMark(int32_t bytes);
 
   // Gets the estimated RTT. Returns false if the RTT is
   // unavailable. May also return false when estimated RTT is 0.
@@ -154,7 +157,14 @@ class NET_EXPORT TCPSocketPosix {
   // write, or accept operations should be pending.
   SocketDescriptor ReleaseSocketDescriptorForTesting();
 
+  // Forgets the past TCP FastOpen failures of all sockets, and times the delay
+  // before TCP FastOpen is retried with |tick_clock|. Does not take ownership
+  // of |tick_clock|, which may be nullptr to use the default clock.
+  static void ResetTCPFastOpenBackoffForTesting(base::TickClock* tick_clock);
+
  private:
+  FRIEND_TEST_ALL_PREFIXES(TCPSocketPosixTest, TCPFastOpenBackoff);
+
   // States that using a socket with TCP FastOpen can lead to.
   enum TCPFastOpenStatus {
     TCP_FASTOPEN_STATUS_UNKNOWN,
@@ -212,7 +222,7 @@ class NET_EXPORT TCPSocketPosix {
     TCP_FASTOPEN_SLOW_CONNECT_READ_FAILED,
 
     // We didn't try FastOpen because it had failed in the past
-    // (g_tcp_fastopen_has_failed was true.)
+    // (and the retry delay had not passed yet.)
     // NOTE: This status is currently registered before a connect/write call
     // is attempted, and may capture some cases where the status is registered
     // but no connect is subsequently attempted.
@@ -250,6 +260,13 @@ class NET_EXPORT TCPSocketPosix {
                       const CompletionCallback& callback,
                       int rv);
   int HandleWriteCompleted(IOBuffer* buf, int rv);
+
+  // True if a TCP FastOpen connect-with-write failed recently, and TCP
+  // FastOpen should not be used yet.
+  static bool TCPFastOpenHasFailed();
+  // Turns TCP FastOpen off for all sockets until the retry delay has passed.
+  static void RecordTCPFastOpenFailure();
+
   int TcpFastOpenWrite(IOBuffer* buf,
                        int buf_len,
                        const CompletionCallback& callback);
@@ -12,7 +12,9 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/test/simple_test_tick_clock.h"
 #include "base/time/time.h"
+#include "build/build_config.h"
 #include "net/base/address_list.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
@@ -28,6 +30,15 @@
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
+#if defined(OS_POSIX)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
+
 using net::test::IsError;
 using net::test::IsOk;
 
@@ -416,6 +427,26 @@ TEST_F(TCPSocketTest, ReadWrite) {
   ASSERT_EQ(message, received_message);
 }
 
+// Tests that the limit on unsent data buffered by the kernel is set where
+// TCP_NOTSENT_LOWAT is supported.
+TEST_F(TCPSocketTest, SetNotSentLowWaterMark) {
+  const int32_t kLowWaterMark = 32 * 1024;
+  ASSERT_THAT(socket_.Open(ADDRESS_FAMILY_IPV4), IsOk());
+#if defined(OS_POSIX) && defined(TCP_NOTSENT_LOWAT)
+  ASSERT_TRUE(socket_.SetNotSentLowWaterMark(kLowWaterMark));
+
+  SocketDescriptor fd = socket_.ReleaseSocketDescriptorForTesting();
+  int32_t bytes = 0;
+  socklen_t bytes_len = sizeof(bytes);
+  EXPECT_EQ(0,
+            getsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &bytes, &bytes_len));
+  EXPECT_EQ(kLowWaterMark, bytes);
+  EXPECT_EQ(0, IGNORE_EINTR(close(fd)));
+#else
+  EXPECT_FALSE(socket_.SetNotSentLowWaterMark(kLowWaterMark));
+#endif
+}
+
 // These tests require kernel support for tcp_info struct, and so they are
 // enabled only on certain platforms.
 #if defined(TCP_INFO) || defined(OS_LINUX)
@@ -433,4 +464,42 @@ TEST_F(TCPSocketTest, SPWNoAdvance) {
 #endif  // defined(TCP_INFO) || defined(OS_LINUX)
 
 }  // namespace
+
+#if defined(OS_POSIX)
+// Tests that TCP FastOpen is turned off after a failure only until a retry
+// delay has passed, which doubles on every later failure.
+TEST(TCPSocketPosixTest, TCPFastOpenBackoff) {
+  base::SimpleTestTickClock clock;
+  clock.Advance(base::TimeDelta::FromDays(1));
+  TCPSocketPosix::ResetTCPFastOpenBackoffForTesting(&clock);
+  EXPECT_FALSE(TCPSocketPosix::TCPFastOpenHasFailed());
+
+  TCPSocketPosix::RecordTCPFastOpenFailure();
+  EXPECT_TRUE(TCPSocketPosix::TCPFastOpenHasFailed());
+
+  // Failures of sockets which attempted TCP FastOpen before it was turned off
+  // do not extend the delay.
+  clock.Advance(base::TimeDelta::FromMinutes(4));
+  TCPSocketPosix::RecordTCPFastOpenFailure();
+  EXPECT_TRUE(TCPSocketPosix::TCPFastOpenHasFailed());
+  clock.Advance(base::TimeDelta::FromMinutes(1));
+  EXPECT_FALSE(TCPSocketPosix::TCPFastOpenHasFailed());
+
+  TCPSocketPosix::RecordTCPFastOpenFailure();
+  clock.Advance(base::TimeDelta::FromMinutes(5));
+  EXPECT_TRUE(TCPSocketPosix::TCPFastOpenHasFailed());
+  clock.Advance(base::TimeDelta::FromMinutes(5));
+  EXPECT_FALSE(TCPSocketPosix::TCPFastOpenHasFailed());
+
+  // The delay is at most a day.
+  for (int i = 0; i < 16; ++i) {
+    TCPSocketPosix::RecordTCPFastOpenFailure();
+    clock.Advance(base::TimeDelta::FromDays(1));
+    EXPECT_FALSE(TCPSocketPosix::TCPFastOpenHasFailed());
+  }
+
+  TCPSocketPosix::ResetTCPFastOpenBackoffForTesting(nullptr);
+}
+#endif  // defined(OS_POSIX)
+
 }  // namespace net
@@ -647,6 +647,10 @@ bool TCPSocketWin::SetNoDelay(bool no_delay) {
   return SetTCPNoDelay(socket_, no_delay) == OK;
 }
 
+bool TCPSocketWin::SetNotSentLowWaterMark(int32_t bytes) {
+  return SetTCPNotSentLowWaterMark(socket_, bytes) == OK;
+}
+
 void TCPSocketWin::Close() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
 
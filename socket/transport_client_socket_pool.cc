@@ -72,11 +72,13 @@ TransportSocketParams::~TransportSocketParams() = default;
 // See comment #12 at http://crbug.com/23364 for specifics.
 const int TransportConnectJob::kTimeoutInSeconds = 240;  // 4 minutes.
 
-// TODO(willchan): Base this off RTT instead of statically setting it. Note we
-// choose a timeout that is different from the backup connect job timer so they
-// don't synchronize.
+// Used until IPv6 connects have been timed, and as an upper bound after. Note
+// we choose a timeout that is different from the backup connect job timer so
+// they don't synchronize.
 const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
 
+const int TransportConnectJob::kMinIPv6FallbackTimerInMs = 100;
+
 TransportConnectJob::TransportConnectJob(
     const std::string& group_name,
     RequestPriority priority,
@@ -86,6 +88,7 @@ TransportConnectJob::TransportConnectJob(
     ClientSocketFactory* client_socket_factory,
     SocketPerformanceWatcherFactory* socket_performance_watcher_factory,
     HostResolver* host_resolver,
+    base::TimeDelta* ipv6_connect_duration,
     Delegate* delegate,
     NetLog* net_log)
     : ConnectJob(
@@ -98,6 +101,7 @@ TransportConnectJob::TransportConnectJob(
                                  NetLogSourceType::TRANSPORT_CONNECT_JOB)),
       params_(params),
       resolver_(host_resolver),
+      ipv6_connect_duration_(ipv6_connect_duration),
       client_socket_factory_(client_socket_factory),
       next_state_(STATE_NONE),
       socket_performance_watcher_factory_(socket_performance_watcher_factory),
@@ -148,6 +152,18 @@ void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   }
 }
 
+// static
+base::TimeDelta TransportConnectJob::GetIPv6FallbackDelay(
+    base::TimeDelta ipv6_connect_duration) {
+  base::TimeDelta max_delay =
+      base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs);
+  if (ipv6_connect_duration.is_zero())
+    return max_delay;
+  return std::max(
+      base::TimeDelta::FromMilliseconds(kMinIPv6FallbackTimerInMs),
+      std::min(max_delay, 2 * ipv6_connect_duration));
+}
+
 // static
 void TransportConnectJob::HistogramDuration(
     const LoadTimingInfo::ConnectTiming& connect_timing,
@@ -310,9 +326,9 @@ int TransportConnectJob::DoTransportConnect() {
   int rv = transport_socket_->Connect(
       base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
   if (rv == ERR_IO_PENDING && try_ipv6_connect_with_ipv4_fallback) {
-    fallback_timer_.Start(
-        FROM_HERE, base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
+    fallback_timer_.Start(FROM_HERE,
+                          GetIPv6FallbackDelay(*ipv6_connect_duration_), this,
+                          &TransportConnectJob::DoIPv6FallbackTransportConnect);
   }
   return rv;
 }
@@ -338,6 +354,8 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
     else
       race_result = RACE_IPV6_WINS;
     HistogramDuration(connect_timing_, race_result);
+    if (!is_ipv4)
+      RecordIPv6ConnectDuration();
 
     SetSocket(std::move(transport_socket_));
   } else {
@@ -447,6 +465,17 @@ void TransportConnectJob::CopyConnectionAttemptsFromSockets() {
   }
 }
 
+void TransportConnectJob::RecordIPv6ConnectDuration() {
+  base::TimeDelta duration =
+      base::TimeTicks::Now() - connect_timing_.connect_start;
+  // An exponentially weighted moving average, with a weight of 1/8 for the
+  // new sample as for TCP's smoothed RTT.
+  if (ipv6_connect_duration_->is_zero())
+    *ipv6_connect_duration_ = duration;
+  else
+    *ipv6_connect_duration_ = (*ipv6_connect_duration_ * 7 + duration) / 8;
+}
+
 std::unique_ptr<ConnectJob>
 TransportClientSocketPool::TransportConnectJobFactory::NewConnectJob(
     const std::string& group_name,
@@ -455,7 +484,8 @@ TransportClientSocketPool::TransportConnectJobFactory::NewConnectJob(
   return std::unique_ptr<ConnectJob>(new TransportConnectJob(
       group_name, request.priority(), request.respect_limits(),
       request.params(), ConnectionTimeout(), client_socket_factory_,
-      socket_performance_watcher_factory_, host_resolver_, delegate, net_log_));
+      socket_performance_watcher_factory_, host_resolver_,
+      &ipv6_connect_duration_, delegate, net_log_));
 }
 
 base::TimeDelta
@@ -79,6 +79,8 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
 // fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
 // a headstart) and return the one that completes first to the socket pool.
+// Once IPv6 connects have succeeded in the pool, the fallback timer is based
+// on how long they took instead (see GetIPv6FallbackDelay()).
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   // For recording the connection time in the appropriate bucket.
@@ -99,6 +101,13 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // IPv4 addresses after this many milliseconds. (This is "Happy Eyeballs".)
   static const int kIPv6FallbackTimerInMs;
 
+  // Bounds of the fallback delay when it is derived from IPv6 connect times,
+  // per the Connection Attempt Delay of RFC 8305.
+  static const int kMinIPv6FallbackTimerInMs;
+
+  // |ipv6_connect_duration| is the pool's smoothed duration of successful IPv6
+  // connects, or zero if there were none yet. The job updates it when its IPv6
+  // connect succeeds.
   TransportConnectJob(
       const std::string& group_name,
       RequestPriority priority,
@@ -108,6 +117,7 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
       ClientSocketFactory* client_socket_factory,
       SocketPerformanceWatcherFactory* socket_performance_watcher_factory,
       HostResolver* host_resolver,
+      base::TimeDelta* ipv6_connect_duration,
       Delegate* delegate,
       NetLog* net_log);
   ~TransportConnectJob() override;
@@ -120,6 +130,13 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
+  // Returns how long to wait for an IPv6 connect before also trying IPv4,
+  // given the smoothed duration of successful IPv6 connects: twice that
+  // duration, within [kMinIPv6FallbackTimerInMs, kIPv6FallbackTimerInMs], or
+  // kIPv6FallbackTimerInMs without any.
+  static base::TimeDelta GetIPv6FallbackDelay(
+      base::TimeDelta ipv6_connect_duration);
+
   // Record the histograms Net.DNS_Resolution_And_TCP_Connection_Latency2 and
   // Net.TCP_Connection_Latency and return the connect duration.
   static void HistogramDuration(
@@ -154,8 +171,13 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
 
   void CopyConnectionAttemptsFromSockets();
 
+  // Folds the duration of the IPv6 connect which just succeeded into
+  // |*ipv6_connect_duration_|.
+  void RecordIPv6ConnectDuration();
+
   scoped_refptr<TransportSocketParams> params_;
   HostResolver* resolver_;
+  base::TimeDelta* const ipv6_connect_duration_;
   std::unique_ptr<HostResolver::Request> request_;
   ClientSocketFactory* const client_socket_factory_;
 
@@ -276,6 +298,8 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
     SocketPerformanceWatcherFactory* socket_performance_watcher_factory_;
     HostResolver* const host_resolver_;
     NetLog* net_log_;
+    // Updated by the jobs, hence mutable despite NewConnectJob() being const.
+    mutable base::TimeDelta ipv6_connect_duration_;
 
     DISALLOW_COPY_AND_ASSIGN(TransportConnectJobFactory);
   };
@@ -178,6 +178,25 @@ TEST(TransportConnectJobTest, MakeAddrListStartWithIPv4) {
   EXPECT_EQ(ADDRESS_FAMILY_IPV6, addrlist[3].GetFamily());
 }
 
+TEST(TransportConnectJobTest, GetIPv6FallbackDelay) {
+  const base::TimeDelta kMaxDelay = base::TimeDelta::FromMilliseconds(
+      TransportConnectJob::kIPv6FallbackTimerInMs);
+  const base::TimeDelta kMinDelay = base::TimeDelta::FromMilliseconds(
+      TransportConnectJob::kMinIPv6FallbackTimerInMs);
+
+  // Without a successful IPv6 connect, use the default delay.
+  EXPECT_EQ(kMaxDelay,
+            TransportConnectJob::GetIPv6FallbackDelay(base::TimeDelta()));
+
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(140),
+            TransportConnectJob::GetIPv6FallbackDelay(
+                base::TimeDelta::FromMilliseconds(70)));
+  EXPECT_EQ(kMinDelay, TransportConnectJob::GetIPv6FallbackDelay(
+                           base::TimeDelta::FromMilliseconds(1)));
+  EXPECT_EQ(kMaxDelay, TransportConnectJob::GetIPv6FallbackDelay(
+                           base::TimeDelta::FromSeconds(1)));
+}
+
 TEST_F(TransportClientSocketPoolTest, Basic) {
   TestCompletionCallback callback;
   ClientSocketHandle handle;
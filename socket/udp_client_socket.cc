@@ -4,6 +4,7 @@
 
 #include "net/socket/udp_client_socket.h"
 
+#include "build/build_config.h"
 #include "net/base/net_errors.h"
 #include "net/traffic_annotation/network_traffic_annotation.h"
 
@@ -82,6 +83,19 @@ int UDPClientSocket::Read(IOBuffer* buf,
   return socket_.Read(buf, buf_len, callback);
 }
 
+int UDPClientSocket::ReadMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    int buf_len,
+    int* lengths,
+    const CompletionCallback& callback) {
+#if defined(OS_POSIX)
+  return socket_.ReadMultiple(bufs, buf_len, lengths, callback);
+#else
+  // Windows has no way to receive several datagrams in one call.
+  return DatagramClientSocket::ReadMultiple(bufs, buf_len, lengths, callback);
+#endif
+}
+
 int UDPClientSocket::Write(
     IOBuffer* buf,
     int buf_len,
@@ -90,6 +104,20 @@ int UDPClientSocket::Write(
   return socket_.Write(buf, buf_len, callback, traffic_annotation);
 }
 
+int UDPClientSocket::WriteMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    const std::vector<int>& lengths,
+    const CompletionCallback& callback,
+    const NetworkTrafficAnnotationTag& traffic_annotation) {
+#if defined(OS_POSIX)
+  return socket_.WriteMultiple(bufs, lengths, callback, traffic_annotation);
+#else
+  // Windows has no way to send several datagrams in one call.
+  return DatagramClientSocket::WriteMultiple(bufs, lengths, callback,
+                                             traffic_annotation);
+#endif
+}
+
 void UDPClientSocket::Close() {
   socket_.Close();
 }
@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "base/macros.h"
 #include "net/base/net_export.h"
 #include "net/base/rand_callback.h"
@@ -37,12 +39,21 @@ class NET_EXPORT_PRIVATE UDPClientSocket : public DatagramClientSocket {
   int Read(IOBuffer* buf,
            int buf_len,
            const CompletionCallback& callback) override;
+  int ReadMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                   int buf_len,
+                   int* lengths,
+                   const CompletionCallback& callback) override;
   // TODO(crbug.com/656607): Remove default value.
   int Write(IOBuffer* buf,
             int buf_len,
             const CompletionCallback& callback,
             const NetworkTrafficAnnotationTag& traffic_annotation =
                 NO_TRAFFIC_ANNOTATION_BUG_656607) override;
+  int WriteMultiple(
+      const std::vector<scoped_refptr<IOBuffer>>& bufs,
+      const std::vector<int>& lengths,
+      const CompletionCallback& callback,
+      const NetworkTrafficAnnotationTag& traffic_annotation) override;
   void Close() override;
   int GetPeerAddress(IPEndPoint* address) const override;
   int GetLocalAddress(IPEndPoint* address) const override;
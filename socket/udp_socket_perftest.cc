@@ -2,10 +2,14 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/test/perf_time_logger.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
@@ -17,8 +21,10 @@
 #include "net/socket/udp_socket.h"
 #include "net/test/gtest_util.h"
 #include "net/test/net_test_suite.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
 #include "testing/platform_test.h"
 
 using net::test::IsOk;
@@ -44,13 +50,33 @@ class UDPSocketPerfTest : public PlatformTest {
                             int num_of_packets,
                             base::Closure done_callback);
 
+  void DoneWriteBatchesToSocket(UDPClientSocket* socket,
+                                int num_of_packets,
+                                base::Closure done_callback,
+                                int result) {
+    ASSERT_GT(result, 0);
+    WriteBatchesToSocket(socket, num_of_packets - result, done_callback);
+  }
+
+  // Send |num_of_packets| to |socket| with WriteMultiple(), in batches of
+  // |batch_buffers_.size()|. Invoke |done_callback| when done.
+  void WriteBatchesToSocket(UDPClientSocket* socket,
+                            int num_of_packets,
+                            base::Closure done_callback);
+
   // Use non-blocking IO if |use_nonblocking_io| is true. This variable only
   // has effect on Windows.
   void WriteBenchmark(bool use_nonblocking_io);
 
+  // Sends packets with WriteMultiple() in batches of |batch_size| and logs
+  // the rate in packets per second.
+  void WriteMultipleBenchmark(int batch_size);
+
  protected:
   static const int kPacketSize = 1024;
   scoped_refptr<IOBufferWithSize> buffer_;
+  std::vector<scoped_refptr<IOBuffer>> batch_buffers_;
+  std::vector<int> batch_lengths_;
   base::WeakPtrFactory<UDPSocketPerfTest> weak_factory_;
 };
 
@@ -86,6 +112,30 @@ void UDPSocketPerfTest::WritePacketsToSocket(UDPClientSocket* socket,
   }
 }
 
+void UDPSocketPerfTest::WriteBatchesToSocket(UDPClientSocket* socket,
+                                             int num_of_packets,
+                                             base::Closure done_callback) {
+  while (num_of_packets > 0) {
+    size_t batch_size =
+        std::min(batch_buffers_.size(), static_cast<size_t>(num_of_packets));
+    std::vector<scoped_refptr<IOBuffer>> bufs(
+        batch_buffers_.begin(), batch_buffers_.begin() + batch_size);
+    std::vector<int> lengths(batch_lengths_.begin(),
+                             batch_lengths_.begin() + batch_size);
+    int rv = socket->WriteMultiple(
+        bufs, lengths,
+        base::Bind(&UDPSocketPerfTest::DoneWriteBatchesToSocket,
+                   weak_factory_.GetWeakPtr(), socket, num_of_packets,
+                   done_callback),
+        TRAFFIC_ANNOTATION_FOR_TESTS);
+    if (rv == ERR_IO_PENDING)
+      return;
+    ASSERT_GT(rv, 0);
+    num_of_packets -= rv;
+  }
+  done_callback.Run();
+}
+
 void UDPSocketPerfTest::WriteBenchmark(bool use_nonblocking_io) {
   base::MessageLoopForIO message_loop;
   const uint16_t kPort = 9999;
@@ -122,6 +172,46 @@ void UDPSocketPerfTest::WriteBenchmark(bool use_nonblocking_io) {
   LOG(INFO) << "Write speed: " << packets / 1024 / elapsed << " MB/s";
 }
 
+void UDPSocketPerfTest::WriteMultipleBenchmark(int batch_size) {
+  base::MessageLoopForIO message_loop;
+  const uint16_t kPort = 9999;
+
+  IPEndPoint bind_address;
+  CreateUDPAddress("127.0.0.1", kPort, &bind_address);
+  std::unique_ptr<UDPServerSocket> server(
+      new UDPServerSocket(nullptr, NetLogSource()));
+  int rv = server->Listen(bind_address);
+  ASSERT_THAT(rv, IsOk());
+
+  IPEndPoint server_address;
+  CreateUDPAddress("127.0.0.1", kPort, &server_address);
+  std::unique_ptr<UDPClientSocket> client(
+      new UDPClientSocket(DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+                          nullptr, NetLogSource()));
+  rv = client->Connect(server_address);
+  EXPECT_THAT(rv, IsOk());
+
+  batch_buffers_.clear();
+  batch_lengths_.clear();
+  for (int i = 0; i < batch_size; ++i) {
+    scoped_refptr<IOBufferWithSize> buffer(new IOBufferWithSize(kPacketSize));
+    memset(buffer->data(), 'G', kPacketSize);
+    batch_buffers_.push_back(buffer);
+    batch_lengths_.push_back(kPacketSize);
+  }
+
+  base::RunLoop run_loop;
+  base::TimeTicks start_ticks = base::TimeTicks::Now();
+  int packets = 100000;
+  WriteBatchesToSocket(client.get(), packets, run_loop.QuitClosure());
+  run_loop.Run();
+
+  double elapsed = (base::TimeTicks::Now() - start_ticks).InSecondsF();
+  perf_test::PrintResult("UDP_socket_write_multiple", "",
+                         "batch_" + base::IntToString(batch_size),
+                         packets / elapsed, "packets/s", true);
+}
+
 TEST_F(UDPSocketPerfTest, Write) {
   base::PerfTimeLogger timer("UDP_socket_write");
   WriteBenchmark(false);
@@ -132,6 +222,14 @@ TEST_F(UDPSocketPerfTest, WriteNonBlocking) {
   WriteBenchmark(true);
 }
 
+TEST_F(UDPSocketPerfTest, WriteMultiple) {
+  for (int batch_size : {1, 8, 32}) {
+    base::PerfTimeLogger timer(
+        ("UDP_socket_write_multiple_" + base::IntToString(batch_size)).c_str());
+    WriteMultipleBenchmark(batch_size);
+  }
+}
+
 }  // namespace
 
 }  // namespace net
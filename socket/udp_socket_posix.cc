@@ -9,9 +9,12 @@
 #include <net/if.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 
+#include <algorithm>
+
 #include "base/callback.h"
 #include "base/debug/alias.h"
 #include "base/files/file_util.h"
@@ -70,6 +73,14 @@ const int kActivityMonitorMinimumSamplesForThroughputEstimate = 2;
 const base::TimeDelta kActivityMonitorMsThreshold =
     base::TimeDelta::FromMilliseconds(100);
 
+#if defined(OS_LINUX)
+// The maximum number of datagrams received by one recvmmsg() call.
+const size_t kMaxDatagramsPerRead = 32;
+
+// The maximum number of datagrams sent by one sendmmsg() call.
+const size_t kMaxDatagramsPerWrite = 32;
+#endif  // defined(OS_LINUX)
+
 #if defined(OS_MACOSX) || defined(OS_FUCHSIA)
 
 // When enabling multicast using setsockopt(IP_MULTICAST_IF) MacOS and Fuchsia
@@ -204,6 +215,7 @@ UDPSocketPosix::UDPSocketPosix(DatagramSocket::BindType bind_type,
       write_watcher_(this),
       read_buf_len_(0),
       recv_from_address_(NULL),
+      read_lengths_(NULL),
       write_buf_len_(0),
       net_log_(NetLogWithSource::Make(net_log, NetLogSourceType::UDP_SOCKET)),
       bound_network_(NetworkChangeNotifier::kInvalidNetworkHandle) {
@@ -211,6 +223,9 @@ UDPSocketPosix::UDPSocketPosix(DatagramSocket::BindType bind_type,
                       source.ToEventParametersCallback());
   if (bind_type == DatagramSocket::RANDOM_BIND)
     DCHECK(!rand_int_cb.is_null());
+#if !defined(OS_LINUX)
+  pending_read_error_ = OK;
+#endif
 }
 
 UDPSocketPosix::~UDPSocketPosix() {
@@ -305,10 +320,17 @@ void UDPSocketPosix::Close() {
   read_buf_len_ = 0;
   read_callback_.Reset();
   recv_from_address_ = NULL;
+  read_bufs_.clear();
+  read_lengths_ = NULL;
+#if !defined(OS_LINUX)
+  pending_read_error_ = OK;
+#endif
   write_buf_ = NULL;
   write_buf_len_ = 0;
   write_callback_.Reset();
   send_to_address_.reset();
+  write_bufs_.clear();
+  write_lengths_.clear();
 
   bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
   DCHECK(ok);
@@ -409,6 +431,40 @@ int UDPSocketPosix::RecvFrom(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketPosix::ReadMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    int buf_len,
+    int* lengths,
+    const CompletionCallback& callback) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+  CHECK(read_callback_.is_null());
+  DCHECK(read_bufs_.empty());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!bufs.empty());
+  DCHECK(lengths);
+  DCHECK_GT(buf_len, 0);
+
+  int nread = InternalRecvMultiple(bufs, buf_len, lengths);
+  if (nread != ERR_IO_PENDING)
+    return nread;
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, base::MessageLoopForIO::WATCH_READ,
+          &read_socket_watcher_, &read_watcher_)) {
+    PLOG(ERROR) << "WatchFileDescriptor failed on read";
+    int result = MapSystemError(errno);
+    LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+
+  read_bufs_ = bufs;
+  read_buf_len_ = buf_len;
+  read_lengths_ = lengths;
+  read_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketPosix::Write(
     IOBuffer* buf,
     int buf_len,
@@ -457,6 +513,38 @@ int UDPSocketPosix::SendToOrWrite(IOBuffer* buf,
   return ERR_IO_PENDING;
 }
 
+int UDPSocketPosix::WriteMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    const std::vector<int>& lengths,
+    const CompletionCallback& callback,
+    const NetworkTrafficAnnotationTag& traffic_annotation) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_NE(kInvalidSocket, socket_);
+  CHECK(write_callback_.is_null());
+  DCHECK(write_bufs_.empty());
+  DCHECK(!callback.is_null());  // Synchronous operation not supported
+  DCHECK(!bufs.empty());
+  DCHECK_EQ(bufs.size(), lengths.size());
+
+  int result = InternalSendMultiple(bufs, lengths);
+  if (result != ERR_IO_PENDING)
+    return result;
+
+  if (!base::MessageLoopForIO::current()->WatchFileDescriptor(
+          socket_, true, base::MessageLoopForIO::WATCH_WRITE,
+          &write_socket_watcher_, &write_watcher_)) {
+    DVLOG(1) << "WatchFileDescriptor failed on write, errno " << errno;
+    int net_error = MapSystemError(errno);
+    LogWrite(net_error, NULL, NULL);
+    return net_error;
+  }
+
+  write_bufs_ = bufs;
+  write_lengths_ = lengths;
+  write_callback_ = callback;
+  return ERR_IO_PENDING;
+}
+
 int UDPSocketPosix::Connect(const IPEndPoint& address) {
   DCHECK_NE(socket_, kInvalidSocket);
   net_log_.BeginEvent(NetLogEventType::UDP_CONNECT,
@@ -700,11 +788,16 @@ void UDPSocketPosix::DoWriteCallback(int rv) {
 
 void UDPSocketPosix::DidCompleteRead() {
   int result =
-      InternalRecvFrom(read_buf_.get(), read_buf_len_, recv_from_address_);
+      read_bufs_.empty()
+          ? InternalRecvFrom(read_buf_.get(), read_buf_len_,
+                             recv_from_address_)
+          : InternalRecvMultiple(read_bufs_, read_buf_len_, read_lengths_);
   if (result != ERR_IO_PENDING) {
     read_buf_ = NULL;
     read_buf_len_ = 0;
     recv_from_address_ = NULL;
+    read_bufs_.clear();
+    read_lengths_ = NULL;
     bool ok = read_socket_watcher_.StopWatchingFileDescriptor();
     DCHECK(ok);
     DoReadCallback(result);
@@ -736,13 +829,17 @@ void UDPSocketPosix::LogRead(int result,
 }
 
 void UDPSocketPosix::DidCompleteWrite() {
-  int result =
-      InternalSendTo(write_buf_.get(), write_buf_len_, send_to_address_.get());
+  int result = write_bufs_.empty()
+                   ? InternalSendTo(write_buf_.get(), write_buf_len_,
+                                    send_to_address_.get())
+                   : InternalSendMultiple(write_bufs_, write_lengths_);
 
   if (result != ERR_IO_PENDING) {
     write_buf_ = NULL;
     write_buf_len_ = 0;
     send_to_address_.reset();
+    write_bufs_.clear();
+    write_lengths_.clear();
     write_socket_watcher_.StopWatchingFileDescriptor();
     DoWriteCallback(result);
   }
@@ -801,6 +898,69 @@ int UDPSocketPosix::InternalRecvFrom(IOBuffer* buf,
   return result;
 }
 
+int UDPSocketPosix::InternalRecvMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    int buf_len,
+    int* lengths) {
+#if defined(OS_LINUX)
+  const size_t count = std::min(bufs.size(), kMaxDatagramsPerRead);
+  struct iovec iovs[kMaxDatagramsPerRead];
+  struct mmsghdr msgs[kMaxDatagramsPerRead];
+  SockaddrStorage storages[kMaxDatagramsPerRead];
+  memset(msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = bufs[i]->data();
+    iovs[i].iov_len = buf_len;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = storages[i].addr;
+    msgs[i].msg_hdr.msg_namelen = storages[i].addr_len;
+  }
+
+  int num_received = HANDLE_EINTR(recvmmsg(socket_, msgs, count, 0, NULL));
+  if (num_received < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogRead(result, NULL, 0, NULL);
+    return result;
+  }
+  for (int i = 0; i < num_received; ++i) {
+    if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+      LogRead(ERR_MSG_TOO_BIG, NULL, 0, NULL);
+      return ERR_MSG_TOO_BIG;
+    }
+  }
+  for (int i = 0; i < num_received; ++i) {
+    lengths[i] = msgs[i].msg_len;
+    storages[i].addr_len = msgs[i].msg_hdr.msg_namelen;
+    LogRead(lengths[i], bufs[i]->data(), storages[i].addr_len,
+            storages[i].addr);
+  }
+  return num_received;
+#else
+  // Without recvmmsg(), drain the socket one datagram at a time. An error
+  // after the first datagram ends the batch, and is returned by the next call.
+  if (pending_read_error_ != OK) {
+    int result = pending_read_error_;
+    pending_read_error_ = OK;
+    return result;
+  }
+  size_t num_received = 0;
+  for (; num_received < bufs.size(); ++num_received) {
+    int result = InternalRecvFrom(bufs[num_received].get(), buf_len, NULL);
+    if (result < 0) {
+      if (num_received == 0)
+        return result;
+      if (result != ERR_IO_PENDING)
+        pending_read_error_ = result;
+      break;
+    }
+    lengths[num_received] = result;
+  }
+  return static_cast<int>(num_received);
+#endif  // defined(OS_LINUX)
+}
+
 int UDPSocketPosix::InternalSendTo(IOBuffer* buf,
                                    int buf_len,
                                    const IPEndPoint* address) {
@@ -830,6 +990,47 @@ int UDPSocketPosix::InternalSendTo(IOBuffer* buf,
   return result;
 }
 
+int UDPSocketPosix::InternalSendMultiple(
+    const std::vector<scoped_refptr<IOBuffer>>& bufs,
+    const std::vector<int>& lengths) {
+#if defined(OS_LINUX)
+  const size_t count = std::min(bufs.size(), kMaxDatagramsPerWrite);
+  struct iovec iovs[kMaxDatagramsPerWrite];
+  struct mmsghdr msgs[kMaxDatagramsPerWrite];
+  memset(msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; ++i) {
+    iovs[i].iov_base = bufs[i]->data();
+    iovs[i].iov_len = lengths[i];
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int num_sent = HANDLE_EINTR(sendmmsg(socket_, msgs, count, 0));
+  if (num_sent < 0) {
+    int result = MapSystemError(errno);
+    if (result != ERR_IO_PENDING)
+      LogWrite(result, NULL, NULL);
+    return result;
+  }
+  for (int i = 0; i < num_sent; ++i)
+    LogWrite(msgs[i].msg_len, bufs[i]->data(), NULL);
+  return num_sent;
+#else
+  // Without sendmmsg(), send one datagram at a time until the socket would
+  // block. An error after the first datagram ends the batch.
+  size_t num_sent = 0;
+  for (; num_sent < bufs.size(); ++num_sent) {
+    int result = InternalSendTo(bufs[num_sent].get(), lengths[num_sent], NULL);
+    if (result < 0) {
+      if (num_sent == 0)
+        return result;
+      break;
+    }
+  }
+  return static_cast<int>(num_sent);
+#endif  // defined(OS_LINUX)
+}
+
 int UDPSocketPosix::SetMulticastOptions() {
   if (!(socket_options_ & SOCKET_OPTION_MULTICAST_LOOP)) {
     int rv;
@@ -8,12 +8,14 @@
 #include <stdint.h>
 
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
 #include "base/threading/thread_checker.h"
 #include "base/timer/timer.h"
+#include "build/build_config.h"
 #include "net/base/address_family.h"
 #include "net/base/completion_callback.h"
 #include "net/base/io_buffer.h"
@@ -124,6 +126,17 @@ class NET_EXPORT UDPSocketPosix {
   // has been connected.
   int Read(IOBuffer* buf, int buf_len, const CompletionCallback& callback);
 
+  // Reads up to |bufs.size()| datagrams in one system call where the platform
+  // supports it. See DatagramClientSocket::ReadMultiple(). As with Read(),
+  // a datagram which does not fit in |buf_len| bytes fails the read with
+  // ERR_MSG_TOO_BIG, and so do the datagrams received along with it.
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int ReadMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                   int buf_len,
+                   int* lengths,
+                   const CompletionCallback& callback);
+
   // Writes to the socket.
   // Only usable from the client-side of a UDP socket, after the socket
   // has been connected.
@@ -134,6 +147,15 @@ class NET_EXPORT UDPSocketPosix {
             const NetworkTrafficAnnotationTag& traffic_annotation =
                 NO_TRAFFIC_ANNOTATION_BUG_656607);
 
+  // Writes up to |bufs.size()| datagrams in one system call where the
+  // platform supports it. See DatagramClientSocket::WriteMultiple().
+  // Only usable from the client-side of a UDP socket, after the socket
+  // has been connected.
+  int WriteMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                    const std::vector<int>& lengths,
+                    const CompletionCallback& callback,
+                    const NetworkTrafficAnnotationTag& traffic_annotation);
+
   // Reads from a socket and receive sender address information.
   // |buf| is the buffer to read data into.
   // |buf_len| is the maximum amount of data to read.
@@ -306,7 +328,12 @@ class NET_EXPORT UDPSocketPosix {
 
   int InternalConnect(const IPEndPoint& address);
   int InternalRecvFrom(IOBuffer* buf, int buf_len, IPEndPoint* address);
+  int InternalRecvMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                           int buf_len,
+                           int* lengths);
   int InternalSendTo(IOBuffer* buf, int buf_len, const IPEndPoint* address);
+  int InternalSendMultiple(const std::vector<scoped_refptr<IOBuffer>>& bufs,
+                           const std::vector<int>& lengths);
 
   // Applies |socket_options_| to |socket_|. Should be called before
   // Bind().
@@ -356,11 +383,27 @@ class NET_EXPORT UDPSocketPosix {
   int read_buf_len_;
   IPEndPoint* recv_from_address_;
 
+  // The buffers used by InternalRecvMultiple() to retry ReadMultiple()
+  // requests. |read_bufs_| is empty unless a ReadMultiple() is pending.
+  std::vector<scoped_refptr<IOBuffer>> read_bufs_;
+  int* read_lengths_;
+
+#if !defined(OS_LINUX)
+  // An error hit by InternalRecvMultiple() after it had received datagrams,
+  // returned by the next call. recvmmsg() keeps such errors the same way.
+  int pending_read_error_;
+#endif
+
   // The buffer used by InternalWrite() to retry Write requests
   scoped_refptr<IOBuffer> write_buf_;
   int write_buf_len_;
   std::unique_ptr<IPEndPoint> send_to_address_;
 
+  // The datagrams used by InternalSendMultiple() to retry WriteMultiple()
+  // requests. |write_bufs_| is empty unless a WriteMultiple() is pending.
+  std::vector<scoped_refptr<IOBuffer>> write_bufs_;
+  std::vector<int> write_lengths_;
+
   // External callback; called when read is complete.
   CompletionCallback read_callback_;
 
@@ -28,6 +28,7 @@
 #include "net/socket/udp_server_socket.h"
 #include "net/test/gtest_util.h"
 #include "net/test/net_test_suite.h"
+#include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
@@ -286,6 +287,129 @@ TEST_F(UDPSocketTest, PartialRecv) {
   EXPECT_EQ(second_packet, received);
 }
 
+TEST_F(UDPSocketTest, ReadMultiple) {
+  UDPServerSocket server_socket(nullptr, NetLogSource());
+  ASSERT_THAT(server_socket.Listen(IPEndPoint(IPAddress::IPv4Localhost(), 0)),
+              IsOk());
+  IPEndPoint server_address;
+  ASSERT_THAT(server_socket.GetLocalAddress(&server_address), IsOk());
+
+  UDPClientSocket client_socket(DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+                                nullptr, NetLogSource());
+  ASSERT_THAT(client_socket.Connect(server_address), IsOk());
+  ASSERT_EQ(5, WriteSocket(&client_socket, "hello"));
+  ASSERT_EQ("hello", RecvFromSocket(&server_socket));
+
+  const std::string kPackets[] = {"first", "second packet", "third"};
+  for (const std::string& packet : kPackets) {
+    ASSERT_EQ(static_cast<int>(packet.size()),
+              SendToSocket(&server_socket, packet));
+  }
+
+  std::vector<scoped_refptr<IOBuffer>> buffers;
+  for (int i = 0; i < 4; ++i)
+    buffers.push_back(new IOBuffer(kMaxRead));
+  int lengths[4];
+  size_t num_read = 0;
+  while (num_read < arraysize(kPackets)) {
+    TestCompletionCallback callback;
+    int rv = callback.GetResult(client_socket.ReadMultiple(
+        buffers, kMaxRead, lengths, callback.callback()));
+    ASSERT_GT(rv, 0);
+    ASSERT_LE(num_read + rv, arraysize(kPackets));
+#if defined(OS_LINUX)
+    // All the queued datagrams are read at once.
+    EXPECT_EQ(arraysize(kPackets), static_cast<size_t>(rv));
+#endif
+    for (int i = 0; i < rv; ++i, ++num_read) {
+      EXPECT_EQ(kPackets[num_read],
+                std::string(buffers[i]->data(), lengths[i]));
+    }
+  }
+
+  // Nothing is left, so the next read completes asynchronously.
+  TestCompletionCallback callback;
+  int rv = client_socket.ReadMultiple(buffers, kMaxRead, lengths,
+                                      callback.callback());
+  ASSERT_THAT(rv, IsError(ERR_IO_PENDING));
+  ASSERT_EQ(4, SendToSocket(&server_socket, "last"));
+  EXPECT_EQ(1, callback.WaitForResult());
+  EXPECT_EQ("last", std::string(buffers[0]->data(), lengths[0]));
+}
+
+// Tests that an error hit after some datagrams were read is not dropped.
+TEST_F(UDPSocketTest, ReadMultipleKeepsError) {
+  UDPServerSocket server_socket(nullptr, NetLogSource());
+  ASSERT_THAT(server_socket.Listen(IPEndPoint(IPAddress::IPv4Localhost(), 0)),
+              IsOk());
+  IPEndPoint server_address;
+  ASSERT_THAT(server_socket.GetLocalAddress(&server_address), IsOk());
+
+  UDPClientSocket client_socket(DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+                                nullptr, NetLogSource());
+  ASSERT_THAT(client_socket.Connect(server_address), IsOk());
+  ASSERT_EQ(5, WriteSocket(&client_socket, "hello"));
+  ASSERT_EQ("hello", RecvFromSocket(&server_socket));
+
+  // The second datagram does not fit in the read buffers.
+  const std::string kTooBig(2 * kMaxRead, 'x');
+  ASSERT_EQ(5, SendToSocket(&server_socket, "first"));
+  ASSERT_EQ(static_cast<int>(kTooBig.size()),
+            SendToSocket(&server_socket, kTooBig));
+
+  std::vector<scoped_refptr<IOBuffer>> buffers;
+  for (int i = 0; i < 2; ++i)
+    buffers.push_back(new IOBuffer(kMaxRead));
+  int lengths[2];
+  TestCompletionCallback callback;
+  int rv = callback.GetResult(client_socket.ReadMultiple(
+      buffers, kMaxRead, lengths, callback.callback()));
+#if defined(OS_LINUX)
+  // recvmmsg() reads both datagrams, and the batch fails.
+  EXPECT_THAT(rv, IsError(ERR_MSG_TOO_BIG));
+#else
+  // The datagram read before the error is returned first, then the error.
+  ASSERT_EQ(1, rv);
+  EXPECT_EQ("first", std::string(buffers[0]->data(), lengths[0]));
+  rv = callback.GetResult(client_socket.ReadMultiple(
+      buffers, kMaxRead, lengths, callback.callback()));
+  EXPECT_THAT(rv, IsError(ERR_MSG_TOO_BIG));
+#endif
+}
+
+TEST_F(UDPSocketTest, WriteMultiple) {
+  UDPServerSocket server_socket(nullptr, NetLogSource());
+  ASSERT_THAT(server_socket.Listen(IPEndPoint(IPAddress::IPv4Localhost(), 0)),
+              IsOk());
+  IPEndPoint server_address;
+  ASSERT_THAT(server_socket.GetLocalAddress(&server_address), IsOk());
+
+  UDPClientSocket client_socket(DatagramSocket::DEFAULT_BIND, RandIntCallback(),
+                                nullptr, NetLogSource());
+  ASSERT_THAT(client_socket.Connect(server_address), IsOk());
+
+  const std::string kPackets[] = {"first", "second packet", "third"};
+  std::vector<scoped_refptr<IOBuffer>> buffers;
+  std::vector<int> lengths;
+  for (const std::string& packet : kPackets) {
+    buffers.push_back(base::MakeRefCounted<StringIOBuffer>(packet));
+    lengths.push_back(packet.size());
+  }
+
+  TestCompletionCallback callback;
+  int rv = callback.GetResult(client_socket.WriteMultiple(
+      buffers, lengths, callback.callback(), TRAFFIC_ANNOTATION_FOR_TESTS));
+#if defined(OS_POSIX)
+  // Local datagram sockets do not block, so all the datagrams are sent.
+  EXPECT_EQ(static_cast<int>(arraysize(kPackets)), rv);
+#else
+  EXPECT_EQ(1, rv);
+#endif
+  ASSERT_GT(rv, 0);
+  for (int i = 0; i < rv; ++i)
+    EXPECT_EQ(kPackets[i], RecvFromSocket(&server_socket));
+}
+
 #if defined(OS_MACOSX) || defined(OS_ANDROID) || defined(OS_FUCHSIA)
 // - MacOS: requires root permissions on OSX 10.7+.
 // - Android: devices attached to testbots don't have default network, so
@@ -34,8 +34,20 @@ std::unique_ptr<base::Value> ElideNetLogHeaderCallback(
   return std::move(dict);
 }
 
-bool ContainsUppercaseAscii(SpdyStringPiece str) {
-  return std::any_of(str.begin(), str.end(), base::IsAsciiUpper<char>);
+enum class HeaderNameCheck { VALID, INVALID_CHARACTER, UPPER_CASE };
+
+// Checks that |name| is a token without upper case characters, in a single
+// pass. Invalid characters take precedence over upper case ones.
+HeaderNameCheck CheckHeaderName(SpdyStringPiece name) {
+  if (name.empty())
+    return HeaderNameCheck::INVALID_CHARACTER;
+  bool has_upper_case = false;
+  for (const char c : name) {
+    if (!HttpUtil::IsTokenChar(c))
+      return HeaderNameCheck::INVALID_CHARACTER;
+    has_upper_case |= base::IsAsciiUpper(c);
+  }
+  return has_upper_case ? HeaderNameCheck::UPPER_CASE : HeaderNameCheck::VALID;
 }
 
 }  // namespace
@@ -83,18 +95,19 @@ bool HeaderCoalescer::AddHeader(SpdyStringPiece key, SpdyStringPiece value) {
     regular_header_seen_ = true;
   }
 
-  if (!HttpUtil::IsValidHeaderName(key_name)) {
-    net_log_.AddEvent(NetLogEventType::HTTP2_SESSION_RECV_INVALID_HEADER,
-                      base::Bind(&ElideNetLogHeaderCallback, key, value,
-                                 "Invalid character in header name."));
-    return false;
-  }
-
-  if (ContainsUppercaseAscii(key_name)) {
-    net_log_.AddEvent(NetLogEventType::HTTP2_SESSION_RECV_INVALID_HEADER,
-                      base::Bind(&ElideNetLogHeaderCallback, key, value,
-                                 "Upper case characters in header name."));
-    return false;
+  switch (CheckHeaderName(key_name)) {
+    case HeaderNameCheck::VALID:
+      break;
+    case HeaderNameCheck::INVALID_CHARACTER:
+      net_log_.AddEvent(NetLogEventType::HTTP2_SESSION_RECV_INVALID_HEADER,
+                        base::Bind(&ElideNetLogHeaderCallback, key, value,
+                                   "Invalid character in header name."));
+      return false;
+    case HeaderNameCheck::UPPER_CASE:
+      net_log_.AddEvent(NetLogEventType::HTTP2_SESSION_RECV_INVALID_HEADER,
+                        base::Bind(&ElideNetLogHeaderCallback, key, value,
+                                   "Upper case characters in header name."));
+      return false;
   }
 
   // 32 byte overhead according to RFC 7540 Section 6.5.2.
@@ -114,6 +114,13 @@ TEST_F(HeaderCoalescerTest, HeaderNameHasUppercase) {
               "Upper case characters in header name.");
 }
 
+TEST_F(HeaderCoalescerTest, HeaderNameHasUppercaseAndInvalidCharacter) {
+  SpdyStringPiece header_name("Foo\x1");
+  header_coalescer_.OnHeader(header_name, "bar");
+  EXPECT_TRUE(header_coalescer_.error_seen());
+  ExpectEntry("Foo%01", "bar", "Invalid character in header name.");
+}
+
 // RFC 7230 Section 3.2. Valid header name is defined as:
 // field-name     = token
 // token          = 1*tchar
@@ -8,10 +8,20 @@
 
 namespace net {
 
-Http2PushPromiseIndex::Http2PushPromiseIndex() = default;
+namespace {
+
+// Default limit on the body bytes buffered by all unclaimed pushed streams.
+const size_t kDefaultUnclaimedPushedBytesLimit = 4 * 1024 * 1024;
+
+}  // namespace
+
+Http2PushPromiseIndex::Http2PushPromiseIndex()
+    : unclaimed_pushed_bytes_(0),
+      unclaimed_pushed_bytes_limit_(kDefaultUnclaimedPushedBytesLimit) {}
 
 Http2PushPromiseIndex::~Http2PushPromiseIndex() {
   DCHECK(unclaimed_pushed_streams_.empty());
+  DCHECK(pushed_bytes_.empty());
 }
 
 void Http2PushPromiseIndex::FindSession(const SpdySessionKey& key,
@@ -67,4 +77,51 @@ void Http2PushPromiseIndex::UnregisterUnclaimedPushedStream(
       << "Only a previously registered entry can be unregistered.";
 }
 
+void Http2PushPromiseIndex::TrackUnclaimedPushedStream(
+    Delegate* delegate,
+    SpdyStreamId stream_id) {
+  DCHECK(delegate);
+
+  auto it = pushed_bytes_lru_.insert(pushed_bytes_lru_.end(),
+                                     PushedBytes{delegate, stream_id, 0});
+  bool inserted =
+      pushed_bytes_.insert(std::make_pair(PushedBytesKey(delegate, stream_id),
+                                          it)).second;
+  DCHECK(inserted);
+}
+
+void Http2PushPromiseIndex::UntrackUnclaimedPushedStream(
+    Delegate* delegate,
+    SpdyStreamId stream_id) {
+  auto it = pushed_bytes_.find(PushedBytesKey(delegate, stream_id));
+  if (it == pushed_bytes_.end())
+    return;
+
+  unclaimed_pushed_bytes_ -= it->second->bytes;
+  pushed_bytes_lru_.erase(it->second);
+  pushed_bytes_.erase(it);
+}
+
+void Http2PushPromiseIndex::OnUnclaimedPushedStreamData(Delegate* delegate,
+                                                        SpdyStreamId stream_id,
+                                                        size_t bytes) {
+  auto it = pushed_bytes_.find(PushedBytesKey(delegate, stream_id));
+  if (it == pushed_bytes_.end())
+    return;
+
+  it->second->bytes += bytes;
+  unclaimed_pushed_bytes_ += bytes;
+  pushed_bytes_lru_.splice(pushed_bytes_lru_.end(), pushed_bytes_lru_,
+                           it->second);
+
+  while (unclaimed_pushed_bytes_ > unclaimed_pushed_bytes_limit_) {
+    DCHECK(!pushed_bytes_lru_.empty());
+    PushedBytes evicted = pushed_bytes_lru_.front();
+    pushed_bytes_lru_.pop_front();
+    pushed_bytes_.erase(PushedBytesKey(evicted.delegate, evicted.stream_id));
+    unclaimed_pushed_bytes_ -= evicted.bytes;
+    evicted.delegate->EvictUnclaimedPushedStream(evicted.stream_id);
+  }
+}
+
 }  // namespace net
@@ -5,7 +5,12 @@
 #ifndef NET_SPDY_CHROMIUM_HTTP2_PUSH_PROMISE_INDEX_H_
 #define NET_SPDY_CHROMIUM_HTTP2_PUSH_PROMISE_INDEX_H_
 
+#include <stddef.h>
+
+#include <list>
+#include <map>
 #include <set>
+#include <utility>
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
@@ -42,6 +47,11 @@ const SpdyStreamId kNoPushedStreamFound = 0;
 // regardless of scheme, to avoid redundant bookkeeping and complicated
 // interactions between SpdySession::UnclaimedPushedStreamContainer and
 // Http2PushPromiseIndex.  https://crbug.com/791054.
+//
+// This class also bounds the memory used by unclaimed pushed streams of every
+// scheme across all connections: once the body bytes they have buffered exceed
+// a limit, the ones that received data least recently are cancelled until the
+// rest fit.
 class NET_EXPORT Http2PushPromiseIndex {
  public:
   // Interface for validating pushed streams, signaling when a pushed stream is
@@ -61,6 +71,12 @@ class NET_EXPORT Http2PushPromiseIndex {
     // Generate weak pointer.
     virtual base::WeakPtr<SpdySession> GetWeakPtrToSession() = 0;
 
+    // Called when unclaimed pushed stream |stream_id| is to be cancelled to
+    // bring the bytes buffered by unclaimed pushed streams under the limit.
+    // The stream is no longer tracked by then.  Must not call back into the
+    // Http2PushPromiseIndex synchronously.
+    virtual void EvictUnclaimedPushedStream(SpdyStreamId stream_id) = 0;
+
    private:
     DISALLOW_COPY_AND_ASSIGN(Delegate);
   };
@@ -88,6 +104,27 @@ class NET_EXPORT Http2PushPromiseIndex {
                                        SpdyStreamId stream_id,
                                        Delegate* delegate);
 
+  // Starts and stops tracking the body bytes buffered by the unclaimed pushed
+  // stream |stream_id| of |delegate|, which may have any scheme.  Stopping is
+  // a no-op if the stream has been evicted.
+  void TrackUnclaimedPushedStream(Delegate* delegate, SpdyStreamId stream_id);
+  void UntrackUnclaimedPushedStream(Delegate* delegate,
+                                    SpdyStreamId stream_id);
+
+  // Called when the tracked unclaimed pushed stream |stream_id| of |delegate|
+  // buffers |bytes| more of body.  Evicts streams as necessary.  A no-op if
+  // the stream is not tracked.
+  void OnUnclaimedPushedStreamData(Delegate* delegate,
+                                   SpdyStreamId stream_id,
+                                   size_t bytes);
+
+  // Returns the body bytes buffered by all tracked unclaimed pushed streams.
+  size_t unclaimed_pushed_bytes() const { return unclaimed_pushed_bytes_; }
+
+  void set_unclaimed_pushed_bytes_limit(size_t limit) {
+    unclaimed_pushed_bytes_limit_ = limit;
+  }
+
  private:
   friend test::Http2PushPromiseIndexPeer;
 
@@ -135,6 +172,23 @@ class NET_EXPORT Http2PushPromiseIndex {
   // possible that multiple Delegates have pushed streams for the same GURL.
   std::set<UnclaimedPushedStream, CompareByUrl> unclaimed_pushed_streams_;
 
+  // The body bytes buffered by a tracked unclaimed pushed stream.
+  struct PushedBytes {
+    Delegate* delegate;
+    SpdyStreamId stream_id;
+    size_t bytes;
+  };
+  using PushedBytesList = std::list<PushedBytes>;
+  using PushedBytesKey = std::pair<Delegate*, SpdyStreamId>;
+
+  // The tracked streams, least recently receiving data first, and an index
+  // into them.
+  PushedBytesList pushed_bytes_lru_;
+  std::map<PushedBytesKey, PushedBytesList::iterator> pushed_bytes_;
+
+  size_t unclaimed_pushed_bytes_;
+  size_t unclaimed_pushed_bytes_limit_;
+
   DISALLOW_COPY_AND_ASSIGN(Http2PushPromiseIndex);
 };
 
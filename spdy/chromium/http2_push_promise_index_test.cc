@@ -40,6 +40,8 @@ class TestDelegate : public Http2PushPromiseIndex::Delegate {
 
   base::WeakPtr<SpdySession> GetWeakPtrToSession() override { return nullptr; }
 
+  void EvictUnclaimedPushedStream(SpdyStreamId stream_id) override {}
+
  private:
   SpdySessionKey key_;
 };
@@ -53,6 +55,7 @@ class MockDelegate : public Http2PushPromiseIndex::Delegate {
   MOCK_CONST_METHOD1(ValidatePushedStream, bool(const SpdySessionKey& key));
   MOCK_METHOD2(OnPushedStreamClaimed,
                void(const GURL& url, SpdyStreamId stream_id));
+  MOCK_METHOD1(EvictUnclaimedPushedStream, void(SpdyStreamId stream_id));
 
   base::WeakPtr<SpdySession> GetWeakPtrToSession() override { return nullptr; }
 };
@@ -305,6 +308,57 @@ TEST_F(Http2PushPromiseIndexTest, MismatchDoesNotCallOnPushedStreamClaimed) {
   index_.UnregisterUnclaimedPushedStream(url1_, 2, &delegate);
 };
 
+// Test that bytes buffered by tracked streams are summed across delegates, and
+// released when a stream is untracked.  Data for untracked streams is ignored.
+TEST_F(Http2PushPromiseIndexTest, UnclaimedPushedBytes) {
+  MockDelegate delegate1;
+  MockDelegate delegate2;
+  EXPECT_CALL(delegate1, EvictUnclaimedPushedStream(_)).Times(0);
+  EXPECT_CALL(delegate2, EvictUnclaimedPushedStream(_)).Times(0);
+
+  index_.TrackUnclaimedPushedStream(&delegate1, 2);
+  index_.TrackUnclaimedPushedStream(&delegate2, 2);
+  index_.OnUnclaimedPushedStreamData(&delegate1, 2, 100);
+  index_.OnUnclaimedPushedStreamData(&delegate2, 2, 50);
+  index_.OnUnclaimedPushedStreamData(&delegate2, 4, 25);
+  EXPECT_EQ(150u, index_.unclaimed_pushed_bytes());
+
+  index_.UntrackUnclaimedPushedStream(&delegate1, 2);
+  EXPECT_EQ(50u, index_.unclaimed_pushed_bytes());
+  index_.UntrackUnclaimedPushedStream(&delegate2, 2);
+  EXPECT_EQ(0u, index_.unclaimed_pushed_bytes());
+}
+
+// Test that exceeding the limit evicts the streams that received data least
+// recently, and only as many as needed.
+TEST_F(Http2PushPromiseIndexTest, EvictLeastRecentlyUsed) {
+  MockDelegate delegate1;
+  MockDelegate delegate2;
+  index_.set_unclaimed_pushed_bytes_limit(100);
+
+  index_.TrackUnclaimedPushedStream(&delegate1, 2);
+  index_.TrackUnclaimedPushedStream(&delegate1, 4);
+  index_.TrackUnclaimedPushedStream(&delegate2, 2);
+  index_.OnUnclaimedPushedStreamData(&delegate1, 2, 40);
+  index_.OnUnclaimedPushedStreamData(&delegate1, 4, 40);
+  // Stream 2 of |delegate1| is now the most recently used.
+  index_.OnUnclaimedPushedStreamData(&delegate1, 2, 10);
+
+  EXPECT_CALL(delegate1, EvictUnclaimedPushedStream(4)).Times(1);
+  index_.OnUnclaimedPushedStreamData(&delegate2, 2, 30);
+  EXPECT_EQ(80u, index_.unclaimed_pushed_bytes());
+
+  // Untracking an evicted stream is a no-op.
+  index_.UntrackUnclaimedPushedStream(&delegate1, 4);
+  EXPECT_EQ(80u, index_.unclaimed_pushed_bytes());
+
+  // A single stream over the limit evicts itself.
+  EXPECT_CALL(delegate1, EvictUnclaimedPushedStream(2)).Times(1);
+  EXPECT_CALL(delegate2, EvictUnclaimedPushedStream(2)).Times(1);
+  index_.OnUnclaimedPushedStreamData(&delegate2, 2, 200);
+  EXPECT_EQ(0u, index_.unclaimed_pushed_bytes());
+}
+
 // Test that an entry is equivalent to itself.
 TEST(Http2PushPromiseIndexCompareByUrlTest, Reflexivity) {
   // Test with two entries: with and without a pushed stream.
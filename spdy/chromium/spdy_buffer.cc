@@ -38,14 +38,16 @@ std::unique_ptr<SpdySerializedFrame> MakeSpdySerializedFrame(const char* data,
 }  // namespace
 
 // This class is an IOBuffer implementation that simply holds a
-// reference to a SharedFrame object and a fixed offset. Used by
-// SpdyBuffer::GetIOBufferForRemainingData().
+// reference to a SharedFrame object (and to the buffer it points into, if
+// any) and a fixed offset. Used by SpdyBuffer::GetIOBufferForRemainingData().
 class SpdyBuffer::SharedFrameIOBuffer : public IOBuffer {
  public:
   SharedFrameIOBuffer(const scoped_refptr<SharedFrame>& shared_frame,
+                      const scoped_refptr<IOBuffer>& backing_buffer,
                       size_t offset)
       : IOBuffer(shared_frame->data->data() + offset),
-        shared_frame_(shared_frame) {}
+        shared_frame_(shared_frame),
+        backing_buffer_(backing_buffer) {}
 
  private:
   ~SharedFrameIOBuffer() override {
@@ -54,6 +56,7 @@ class SpdyBuffer::SharedFrameIOBuffer : public IOBuffer {
   }
 
   const scoped_refptr<SharedFrame> shared_frame_;
+  const scoped_refptr<IOBuffer> backing_buffer_;
 
   DISALLOW_COPY_AND_ASSIGN(SharedFrameIOBuffer);
 };
@@ -71,6 +74,20 @@ SpdyBuffer::SpdyBuffer(const char* data, size_t size) :
   shared_frame_->data = MakeSpdySerializedFrame(data, size);
 }
 
+SpdyBuffer::SpdyBuffer(scoped_refptr<IOBuffer> buffer,
+                       const char* data,
+                       size_t size)
+    : shared_frame_(new SharedFrame()),
+      backing_buffer_(std::move(buffer)),
+      offset_(0) {
+  DCHECK(backing_buffer_);
+  DCHECK_GE(data, backing_buffer_->data());
+  CHECK_GT(size, 0u);
+  CHECK_LE(size, kMaxSpdyFrameSize);
+  shared_frame_->data = std::make_unique<SpdySerializedFrame>(
+      const_cast<char*>(data), size, false /* owns_buffer */);
+}
+
 SpdyBuffer::~SpdyBuffer() {
   if (GetRemainingSize() > 0)
     ConsumeHelper(GetRemainingSize(), DISCARD);
@@ -93,11 +110,15 @@ void SpdyBuffer::Consume(size_t consume_size) {
 }
 
 IOBuffer* SpdyBuffer::GetIOBufferForRemainingData() {
-  return new SharedFrameIOBuffer(shared_frame_, offset_);
+  return new SharedFrameIOBuffer(shared_frame_, backing_buffer_, offset_);
 }
 
 size_t SpdyBuffer::EstimateMemoryUsage() const {
   // TODO(xunjieli): Estimate |consume_callbacks_|. https://crbug.com/669108.
+  // A slice does not own its data; count the bytes it refers to, since they
+  // are kept alive on its behalf.
+  if (backing_buffer_)
+    return sizeof(SpdySerializedFrame) + shared_frame_->data->size();
   return SpdyEstimateMemoryUsage(shared_frame_->data);
 }
 
@@ -53,6 +53,12 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   // non-NULL and |size| must be non-zero.
   SpdyBuffer(const char* data, size_t size);
 
+  // Construct with a slice of |buffer| without copying it. |data| must point
+  // into |buffer|, and |size| must be non-zero. |buffer| is kept alive, and
+  // must not be written to, until this object and any IOBuffer returned by
+  // GetIOBufferForRemainingData() are destroyed.
+  SpdyBuffer(scoped_refptr<IOBuffer> buffer, const char* data, size_t size);
+
   // If there are bytes remaining in the buffer, triggers a call to
   // any consume callbacks with a DISCARD source.
   ~SpdyBuffer();
@@ -97,6 +103,8 @@ class NET_EXPORT_PRIVATE SpdyBuffer {
   class SharedFrameIOBuffer;
 
   const scoped_refptr<SharedFrame> shared_frame_;
+  // The buffer |shared_frame_| points into, if it does not own its data.
+  const scoped_refptr<IOBuffer> backing_buffer_;
   std::vector<ConsumeCallback> consume_callbacks_;
   size_t offset_;
 
@@ -52,6 +52,36 @@ TEST_F(SpdyBufferTest, DataConstructor) {
   EXPECT_EQ(SpdyString(kData, kDataSize), BufferToString(buffer));
 }
 
+// Construct a SpdyBuffer from a slice of an IOBuffer and make sure it
+// points into the IOBuffer rather than making a copy.
+TEST_F(SpdyBufferTest, IOBufferSliceConstructor) {
+  scoped_refptr<IOBuffer> io_buffer(new IOBuffer(kDataSize + 2));
+  std::memcpy(io_buffer->data() + 2, kData, kDataSize);
+  SpdyBuffer buffer(io_buffer, io_buffer->data() + 2, kDataSize);
+
+  EXPECT_EQ(io_buffer->data() + 2, buffer.GetRemainingData());
+  EXPECT_EQ(kDataSize, buffer.GetRemainingSize());
+  EXPECT_EQ(SpdyString(kData, kDataSize), BufferToString(buffer));
+}
+
+// Make sure a slice keeps its IOBuffer alive, and releases it once the
+// slice and any IOBuffer returned by GetIOBufferForRemainingData() are gone.
+TEST_F(SpdyBufferTest, IOBufferSliceHoldsReference) {
+  scoped_refptr<IOBuffer> io_buffer(new IOBuffer(kDataSize));
+  auto first = std::make_unique<SpdyBuffer>(io_buffer, io_buffer->data(), 5);
+  auto second = std::make_unique<SpdyBuffer>(io_buffer, io_buffer->data() + 5,
+                                             kDataSize - 5);
+  EXPECT_FALSE(io_buffer->HasOneRef());
+
+  scoped_refptr<IOBuffer> remaining = second->GetIOBufferForRemainingData();
+  first.reset();
+  second.reset();
+  EXPECT_FALSE(io_buffer->HasOneRef());
+
+  remaining = nullptr;
+  EXPECT_TRUE(io_buffer->HasOneRef());
+}
+
 void IncrementBy(size_t* x,
                  SpdyBuffer::ConsumeSource expected_consume_source,
                  size_t delta,
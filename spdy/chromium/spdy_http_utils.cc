@@ -46,9 +46,9 @@ bool SpdyHeadersToHttpResponse(const SpdyHeaderBlock& headers,
   SpdyHeaderBlock::const_iterator it = headers.find(kHttp2StatusHeader);
   if (it == headers.end())
     return false;
-  SpdyString status = it->second.as_string();
+  SpdyStringPiece status = it->second;
   SpdyString raw_headers("HTTP/1.1 ");
-  raw_headers.append(status);
+  raw_headers.append(status.data(), status.size());
   raw_headers.push_back('\0');
   for (it = headers.begin(); it != headers.end(); ++it) {
     // For each value, if the server sends a NUL-separated
@@ -59,22 +59,21 @@ bool SpdyHeadersToHttpResponse(const SpdyHeaderBlock& headers,
     // becomes
     //    Set-Cookie: foo\0
     //    Set-Cookie: bar\0
-    SpdyString value = it->second.as_string();
+    // The name and the values are appended straight from the block, without
+    // copying them into intermediate strings.
+    SpdyStringPiece name = it->first;
+    if (!name.empty() && name[0] == ':')
+      name.remove_prefix(1);
+    SpdyStringPiece value = it->second;
     size_t start = 0;
     size_t end = 0;
     do {
       end = value.find('\0', start);
-      SpdyString tval;
-      if (end != value.npos)
-        tval = value.substr(start, (end - start));
-      else
-        tval = value.substr(start);
-      if (it->first[0] == ':')
-        raw_headers.append(it->first.as_string().substr(1));
-      else
-        raw_headers.append(it->first.as_string());
+      SpdyStringPiece tval =
+          value.substr(start, end == value.npos ? end : end - start);
+      raw_headers.append(name.data(), name.size());
       raw_headers.push_back(':');
-      raw_headers.append(tval);
+      raw_headers.append(tval.data(), tval.size());
       raw_headers.push_back('\0');
       start = end + 1;
     } while (end != value.npos);
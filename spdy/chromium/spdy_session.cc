@@ -27,6 +27,7 @@
 #include "base/values.h"
 #include "crypto/ec_private_key.h"
 #include "crypto/ec_signature_creator.h"
+#include "net/base/pooled_io_buffer.h"
 #include "net/base/proxy_delegate.h"
 #include "net/cert/asn1_util.h"
 #include "net/cert/cert_verify_result.h"
@@ -63,6 +64,22 @@ namespace net {
 namespace {
 
 const int kReadBufferSize = 8 * 1024;
+// DATA payloads at least this large refer to the read buffer instead of being
+// copied out of it.  Smaller ones are copied, so that a few bytes left unread
+// by a stream do not keep the whole read buffer alive.
+const size_t kMinZeroCopyDataSize = kReadBufferSize / 8;
+// Frames are taken off the write queue until they add up to at least this
+// many bytes, the most a single TLS record carries, and are then written with
+// a single socket write.
+const size_t kMaxCoalescedWriteSize = 16 * 1024;
+// The kernel holds at most about this many bytes, two coalesced writes, that
+// were written to the socket but not sent yet. Frames stay in the prioritized
+// write queue instead, so that a stream with a higher priority is not sent
+// after megabytes of queued DATA.
+const int32_t kNotSentLowWaterMark = 32 * 1024;
+// The session receive window does not grow past this size by autotuning, which
+// bounds the memory the server can make a session buffer for slow readers.
+const int32_t kMaxAutoTunedRecvWindowSize = 64 * 1024 * 1024;
 const int kDefaultConnectionAtRiskOfLossSeconds = 10;
 const int kHungIntervalSeconds = 10;
 
@@ -146,6 +163,8 @@ bool IsSpdySettingAtDefaultInitialValue(SpdySettingsIds setting_id,
     case SETTINGS_MAX_HEADER_LIST_SIZE:
       // There is no initial limit on the size of the header list.
       return false;
+    case SETTINGS_ENABLE_CONNECT_PROTOCOL:
+      return value == 0;
     default:
       // Undefined parameters have no initial value.
       return false;
@@ -752,8 +771,6 @@ SpdySession::SpdySession(
       num_active_pushed_streams_(0u),
       bytes_pushed_count_(0u),
       bytes_pushed_and_unclaimed_count_(0u),
-      in_flight_write_frame_type_(SpdyFrameType::DATA),
-      in_flight_write_frame_size_(0),
       availability_state_(STATE_AVAILABLE),
       read_state_(READ_STATE_DO_READ),
       write_state_(WRITE_STATE_IDLE),
@@ -769,6 +786,7 @@ SpdySession::SpdySession(
       pings_in_flight_(0),
       next_ping_id_(1),
       last_read_time_(time_func()),
+      initial_settings_write_pending_(false),
       last_compressed_frame_len_(0),
       check_ping_status_pending_(false),
       session_send_window_size_(0),
@@ -786,6 +804,7 @@ SpdySession::SpdySession(
       enable_ping_based_connection_checking_(
           enable_ping_based_connection_checking),
       support_ietf_format_quic_altsvc_(support_ietf_format_quic_altsvc),
+      support_websocket_(false),
       connection_at_risk_of_loss_time_(
           base::TimeDelta::FromSeconds(kDefaultConnectionAtRiskOfLossSeconds)),
       hung_interval_(base::TimeDelta::FromSeconds(kHungIntervalSeconds)),
@@ -879,6 +898,8 @@ void SpdySession::InitializeWithSocket(
   DCHECK(connection->socket());
 
   connection_ = std::move(connection);
+  connection_->socket()->SetNotSentLowWaterMarkIfSupported(
+      kNotSentLowWaterMark);
 
   session_send_window_size_ = kDefaultInitialWindowSize;
   session_recv_window_size_ = kDefaultInitialWindowSize;
@@ -1357,6 +1378,15 @@ base::WeakPtr<SpdySession> SpdySession::GetWeakPtrToSession() {
   return GetWeakPtr();
 }
 
+void SpdySession::EvictUnclaimedPushedStream(SpdyStreamId stream_id) {
+  // This may be called while another session, or this one, is processing a
+  // frame, so do not reset the stream synchronously.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::Bind(&SpdySession::CancelPushedStreamIfUnclaimed, GetWeakPtr(),
+                 stream_id, ERR_INSUFFICIENT_RESOURCES));
+}
+
 size_t SpdySession::DumpMemoryStats(StreamSocket::SocketMemoryStats* stats,
                                     bool* is_session_active) const {
   // TODO(xunjieli): Include |pending_create_stream_queues_| when WeakPtr is
@@ -1374,7 +1404,8 @@ size_t SpdySession::DumpMemoryStats(StreamSocket::SocketMemoryStats* stats,
          SpdyEstimateMemoryUsage(unclaimed_pushed_streams_) +
          SpdyEstimateMemoryUsage(created_streams_) +
          SpdyEstimateMemoryUsage(write_queue_) +
-         SpdyEstimateMemoryUsage(in_flight_write_) +
+         SpdyEstimateMemoryUsage(in_flight_writes_) +
+         (coalesced_write_ ? coalesced_write_->size() : 0) +
          SpdyEstimateMemoryUsage(buffered_spdy_framer_) +
          SpdyEstimateMemoryUsage(initial_settings_) +
          SpdyEstimateMemoryUsage(stream_send_unstall_queue_) +
@@ -1403,11 +1434,11 @@ bool SpdySession::UnclaimedPushedStreamContainer::erase(
   if (it == streams_.end() || it->second != stream_id)
     return false;
 
+  Http2PushPromiseIndex* index = spdy_session_->pool_->push_promise_index();
   // Only allow cross-origin push for secure resources.
-  if (it->first.SchemeIsCryptographic()) {
-    spdy_session_->pool_->push_promise_index()->UnregisterUnclaimedPushedStream(
-        it->first, stream_id, spdy_session_);
-  }
+  if (it->first.SchemeIsCryptographic())
+    index->UnregisterUnclaimedPushedStream(it->first, stream_id, spdy_session_);
+  index->UntrackUnclaimedPushedStream(spdy_session_, stream_id);
   streams_.erase(it);
   return true;
 }
@@ -1421,11 +1452,11 @@ bool SpdySession::UnclaimedPushedStreamContainer::insert(
     // Only one pushed stream is allowed for each URL.
     return false;
   }
+  Http2PushPromiseIndex* index = spdy_session_->pool_->push_promise_index();
   // Only allow cross-origin push for https resources.
-  if (url.SchemeIsCryptographic()) {
-    spdy_session_->pool_->push_promise_index()->RegisterUnclaimedPushedStream(
-        url, stream_id, spdy_session_);
-  }
+  if (url.SchemeIsCryptographic())
+    index->RegisterUnclaimedPushedStream(url, stream_id, spdy_session_);
+  index->TrackUnclaimedPushedStream(spdy_session_, stream_id);
   return true;
 }
 
@@ -1434,6 +1465,25 @@ size_t SpdySession::UnclaimedPushedStreamContainer::EstimateMemoryUsage()
   return SpdyEstimateMemoryUsage(streams_);
 }
 
+SpdySession::InFlightWrite::InFlightWrite(
+    std::unique_ptr<SpdyBuffer> buffer,
+    SpdyFrameType frame_type,
+    const base::WeakPtr<SpdyStream>& stream)
+    : buffer(std::move(buffer)),
+      frame_type(frame_type),
+      frame_size(this->buffer->GetRemainingSize()),
+      stream(stream) {}
+
+SpdySession::InFlightWrite::~InFlightWrite() = default;
+
+SpdySession::InFlightWrite::InFlightWrite(InFlightWrite&& other) = default;
+SpdySession::InFlightWrite& SpdySession::InFlightWrite::operator=(
+    InFlightWrite&& other) = default;
+
+size_t SpdySession::InFlightWrite::EstimateMemoryUsage() const {
+  return SpdyEstimateMemoryUsage(buffer);
+}
+
 // {,Try}CreateStream() can be called with |in_io_loop_| set if a stream is
 // being created in response to another being closed due to received data.
 
@@ -1691,7 +1741,7 @@ void SpdySession::TryCreatePushStream(SpdyStreamId stream_id,
   base::ThreadTaskRunnerHandle::Get()->PostDelayedTask(
       FROM_HERE,
       base::Bind(&SpdySession::CancelPushedStreamIfUnclaimed, GetWeakPtr(),
-                 stream_id),
+                 stream_id, ERR_TIMED_OUT),
       base::TimeDelta::FromSeconds(kPushedStreamLifetimeSeconds));
 
   auto stream = std::make_unique<SpdyStream>(
@@ -1902,7 +1952,7 @@ int SpdySession::DoRead() {
   CHECK(connection_->socket());
   read_state_ = READ_STATE_DO_READ_COMPLETE;
   int rv = ERR_READ_IF_READY_NOT_IMPLEMENTED;
-  read_buffer_ = new IOBuffer(kReadBufferSize);
+  read_buffer_ = new PooledIOBuffer(kReadBufferSize);
   if (base::FeatureList::IsEnabled(Socket::kReadIfReadyExperiment)) {
     rv = connection_->socket()->ReadIfReady(
         read_buffer_.get(), kReadBufferSize,
@@ -1973,7 +2023,7 @@ void SpdySession::PumpWriteLoop(WriteState expected_write_state, int result) {
 
   DoWriteLoop(expected_write_state, result);
 
-  if (availability_state_ == STATE_DRAINING && !in_flight_write_ &&
+  if (availability_state_ == STATE_DRAINING && in_flight_writes_.empty() &&
       write_queue_.IsEmpty()) {
     pool_->RemoveUnavailableSession(GetWeakPtr());  // Destroys |this|.
     return;
@@ -1982,7 +2032,7 @@ void SpdySession::PumpWriteLoop(WriteState expected_write_state, int result) {
 
 void SpdySession::MaybePostWriteLoop() {
   if (write_state_ == WRITE_STATE_IDLE) {
-    CHECK(!in_flight_write_);
+    CHECK(in_flight_writes_.empty());
     write_state_ = WRITE_STATE_DO_WRITE;
     base::ThreadTaskRunnerHandle::Get()->PostTask(
         FROM_HERE,
@@ -2033,48 +2083,69 @@ int SpdySession::DoWrite() {
   CHECK(in_io_loop_);
 
   DCHECK(buffered_spdy_framer_);
-  if (in_flight_write_) {
-    DCHECK_GT(in_flight_write_->GetRemainingSize(), 0u);
+  if (!in_flight_writes_.empty()) {
+    DCHECK_GT(in_flight_writes_.front().buffer->GetRemainingSize(), 0u);
   } else {
-    // Grab the next frame to send.
-    SpdyFrameType frame_type = SpdyFrameType::DATA;
-    std::unique_ptr<SpdyBufferProducer> producer;
-    base::WeakPtr<SpdyStream> stream;
-    if (!write_queue_.Dequeue(&frame_type, &producer, &stream)) {
+    // Grab the next frames to send, until they fill a TLS record.
+    size_t write_size = 0;
+    while (write_size < kMaxCoalescedWriteSize) {
+      SpdyFrameType frame_type = SpdyFrameType::DATA;
+      std::unique_ptr<SpdyBufferProducer> producer;
+      base::WeakPtr<SpdyStream> stream;
+      if (!write_queue_.Dequeue(&frame_type, &producer, &stream))
+        break;
+
+      if (stream.get())
+        CHECK(!stream->IsClosed());
+
+      // Activate the stream only when sending the HEADERS frame to
+      // guarantee monotonically-increasing stream IDs.
+      bool stream_ids_exhausted = false;
+      if (frame_type == SpdyFrameType::HEADERS) {
+        CHECK(stream.get());
+        CHECK_EQ(stream->stream_id(), 0u);
+        std::unique_ptr<SpdyStream> owned_stream =
+            ActivateCreatedStream(stream.get());
+        InsertActivatedStream(std::move(owned_stream));
+
+        if (stream_hi_water_mark_ > kLastStreamId) {
+          CHECK_EQ(stream->stream_id(), kLastStreamId);
+          // We've exhausted the stream ID space, and no new streams may be
+          // created after this one.
+          MakeUnavailable();
+          StartGoingAway(kLastStreamId, ERR_ABORTED);
+          stream_ids_exhausted = true;
+        }
+      }
+
+      std::unique_ptr<SpdyBuffer> buffer = producer->ProduceBuffer();
+      if (!buffer) {
+        NOTREACHED();
+        return ERR_UNEXPECTED;
+      }
+      DCHECK_GE(buffer->GetRemainingSize(), kFrameMinimumSize);
+      write_size += buffer->GetRemainingSize();
+      in_flight_writes_.emplace_back(std::move(buffer), frame_type, stream);
+
+      if (stream_ids_exhausted)
+        break;
+    }
+
+    if (in_flight_writes_.empty()) {
       write_state_ = WRITE_STATE_IDLE;
       return ERR_IO_PENDING;
     }
 
-    if (stream.get())
-      CHECK(!stream->IsClosed());
-
-    // Activate the stream only when sending the HEADERS frame to
-    // guarantee monotonically-increasing stream IDs.
-    if (frame_type == SpdyFrameType::HEADERS) {
-      CHECK(stream.get());
-      CHECK_EQ(stream->stream_id(), 0u);
-      std::unique_ptr<SpdyStream> owned_stream =
-          ActivateCreatedStream(stream.get());
-      InsertActivatedStream(std::move(owned_stream));
-
-      if (stream_hi_water_mark_ > kLastStreamId) {
-        CHECK_EQ(stream->stream_id(), kLastStreamId);
-        // We've exhausted the stream ID space, and no new streams may be
-        // created after this one.
-        MakeUnavailable();
-        StartGoingAway(kLastStreamId, ERR_ABORTED);
+    if (in_flight_writes_.size() > 1) {
+      scoped_refptr<IOBuffer> buffer(new IOBuffer(write_size));
+      char* data = buffer->data();
+      for (const InFlightWrite& write : in_flight_writes_) {
+        memcpy(data, write.buffer->GetRemainingData(),
+               write.buffer->GetRemainingSize());
+        data += write.buffer->GetRemainingSize();
       }
+      coalesced_write_ = new DrainableIOBuffer(buffer.get(), write_size);
     }
-
-    in_flight_write_ = producer->ProduceBuffer();
-    if (!in_flight_write_) {
-      NOTREACHED();
-      return ERR_UNEXPECTED;
-    }
-    in_flight_write_frame_type_ = frame_type;
-    in_flight_write_frame_size_ = in_flight_write_->GetRemainingSize();
-    DCHECK_GE(in_flight_write_frame_size_, kFrameMinimumSize);
-    in_flight_write_stream_ = stream;
   }
 
   write_state_ = WRITE_STATE_DO_WRITE_COMPLETE;
@@ -2082,10 +2153,18 @@ int SpdySession::DoWrite() {
   // Explicitly store in a scoped_refptr<IOBuffer> to avoid problems
   // with Socket implementations that don't store their IOBuffer
   // argument in a scoped_refptr<IOBuffer> (see crbug.com/232345).
-  scoped_refptr<IOBuffer> write_io_buffer =
-      in_flight_write_->GetIOBufferForRemainingData();
+  scoped_refptr<IOBuffer> write_io_buffer;
+  int write_io_buffer_size;
+  if (coalesced_write_) {
+    write_io_buffer = coalesced_write_;
+    write_io_buffer_size = coalesced_write_->BytesRemaining();
+  } else {
+    SpdyBuffer* buffer = in_flight_writes_.front().buffer.get();
+    write_io_buffer = buffer->GetIOBufferForRemainingData();
+    write_io_buffer_size = buffer->GetRemainingSize();
+  }
   return connection_->socket()->Write(
-      write_io_buffer.get(), in_flight_write_->GetRemainingSize(),
+      write_io_buffer.get(), write_io_buffer_size,
       base::Bind(&SpdySession::PumpWriteLoop, weak_factory_.GetWeakPtr(),
                  WRITE_STATE_DO_WRITE_COMPLETE));
 }
@@ -2093,45 +2172,63 @@ int SpdySession::DoWrite() {
 int SpdySession::DoWriteComplete(int result) {
   CHECK(in_io_loop_);
   DCHECK_NE(result, ERR_IO_PENDING);
-  DCHECK_GT(in_flight_write_->GetRemainingSize(), 0u);
+  DCHECK(!in_flight_writes_.empty());
 
   if (result < 0) {
     DCHECK_NE(result, ERR_IO_PENDING);
-    in_flight_write_.reset();
-    in_flight_write_frame_type_ = SpdyFrameType::DATA;
-    in_flight_write_frame_size_ = 0;
-    in_flight_write_stream_.reset();
+    in_flight_writes_.clear();
+    coalesced_write_ = nullptr;
     write_state_ = WRITE_STATE_DO_WRITE;
     DoDrainSession(static_cast<Error>(result), "Write error");
     return OK;
   }
 
-  // It should not be possible to have written more bytes than our
-  // in_flight_write_.
-  DCHECK_LE(static_cast<size_t>(result), in_flight_write_->GetRemainingSize());
-
-  if (result > 0) {
-    in_flight_write_->Consume(static_cast<size_t>(result));
-    if (in_flight_write_stream_.get())
-      in_flight_write_stream_->AddRawSentBytes(static_cast<size_t>(result));
+  // It should not be possible to have written more bytes than we
+  // passed to the socket.
+  if (coalesced_write_) {
+    DCHECK_LE(result, coalesced_write_->BytesRemaining());
+    coalesced_write_->DidConsume(result);
+  } else {
+    DCHECK_LE(static_cast<size_t>(result),
+              in_flight_writes_.front().buffer->GetRemainingSize());
+  }
+
+  // Hand the written bytes out to the frames they belong to, in order.
+  size_t bytes_left = static_cast<size_t>(result);
+  while (bytes_left > 0) {
+    DCHECK(!in_flight_writes_.empty());
+    InFlightWrite& write = in_flight_writes_.front();
+    size_t consume_size =
+        std::min(bytes_left, write.buffer->GetRemainingSize());
+    write.buffer->Consume(consume_size);
+    bytes_left -= consume_size;
+    if (write.stream.get())
+      write.stream->AddRawSentBytes(consume_size);
 
     // We only notify the stream when we've fully written the pending frame.
-    if (in_flight_write_->GetRemainingSize() == 0) {
-      // It is possible that the stream was cancelled while we were
-      // writing to the socket.
-      if (in_flight_write_stream_.get()) {
-        DCHECK_GT(in_flight_write_frame_size_, 0u);
-        in_flight_write_stream_->OnFrameWriteComplete(
-            in_flight_write_frame_type_, in_flight_write_frame_size_);
-      }
+    if (write.buffer->GetRemainingSize() > 0)
+      break;
+
+    // It is possible that the stream was cancelled while we were
+    // writing to the socket.
+    if (write.stream.get()) {
+      DCHECK_GT(write.frame_size, 0u);
+      write.stream->OnFrameWriteComplete(write.frame_type, write.frame_size);
+    }
 
-      // Cleanup the write which just completed.
-      in_flight_write_.reset();
-      in_flight_write_frame_type_ = SpdyFrameType::DATA;
-      in_flight_write_frame_size_ = 0;
-      in_flight_write_stream_.reset();
+    // The initial SETTINGS frame is the first SETTINGS frame written. Time
+    // its round trip from here, so that it does not include queueing delay.
+    if (write.frame_type == SpdyFrameType::SETTINGS &&
+        initial_settings_write_pending_) {
+      initial_settings_write_pending_ = false;
+      settings_sent_time_ = time_func_();
     }
+
+    // Cleanup the write which just completed.
+    in_flight_writes_.pop_front();
   }
+  if (in_flight_writes_.empty())
+    coalesced_write_ = nullptr;
 
   write_state_ = WRITE_STATE_DO_WRITE;
   return OK;
@@ -2209,6 +2306,7 @@ void SpdySession::SendInitialData() {
       /* owns_buffer = */ true);
   EnqueueSessionWrite(HIGHEST, SpdyFrameType::SETTINGS,
                       std::move(initial_frame));
+  initial_settings_write_pending_ = true;
 }
 
 void SpdySession::HandleSetting(uint32_t id, uint32_t value) {
@@ -2236,6 +2334,12 @@ void SpdySession::HandleSetting(uint32_t id, uint32_t value) {
           NetLog::IntCallback("delta_window_size", delta_window_size));
       break;
     }
+    case SETTINGS_ENABLE_CONNECT_PROTOCOL:
+      // See RFC 8441, Section 3: the value may not go back to 0 once it has
+      // been 1.
+      if (value == 1)
+        support_websocket_ = true;
+      break;
   }
 }
 
@@ -2411,12 +2515,12 @@ void SpdySession::InsertActivatedStream(std::unique_ptr<SpdyStream> stream) {
 }
 
 void SpdySession::DeleteStream(std::unique_ptr<SpdyStream> stream, int status) {
-  if (in_flight_write_stream_.get() == stream.get()) {
-    // If we're deleting the stream for the in-flight write, we still
-    // need to let the write complete, so we clear
-    // |in_flight_write_stream_| and let the write finish on its own
-    // without notifying |in_flight_write_stream_|.
-    in_flight_write_stream_.reset();
+  for (InFlightWrite& write : in_flight_writes_) {
+    // If we're deleting the stream for an in-flight write, we still
+    // need to let the write complete, so we clear its stream and let
+    // the write finish on its own without notifying the stream.
+    if (write.stream.get() == stream.get())
+      write.stream.reset();
   }
 
   write_queue_.RemovePendingWritesForStream(stream->GetWeakPtr());
@@ -2595,7 +2699,8 @@ void SpdySession::CompleteStreamRequest(
   }
 }
 
-void SpdySession::CancelPushedStreamIfUnclaimed(SpdyStreamId stream_id) {
+void SpdySession::CancelPushedStreamIfUnclaimed(SpdyStreamId stream_id,
+                                                Error error) {
   ActiveStreamMap::iterator active_it = active_streams_.find(stream_id);
   if (active_it == active_streams_.end())
     return;
@@ -2609,7 +2714,7 @@ void SpdySession::CancelPushedStreamIfUnclaimed(SpdyStreamId stream_id) {
     return;
   }
 
-  LogAbandonedActiveStream(active_it, ERR_TIMED_OUT);
+  LogAbandonedActiveStream(active_it, error);
   // CloseActiveStreamIterator() will remove the stream from
   // |unclaimed_pushed_streams_|.
   ResetStreamIterator(active_it, ERROR_CODE_REFUSED_STREAM,
@@ -2669,7 +2774,9 @@ void SpdySession::OnPing(SpdyPingId unique_id, bool is_ack) {
     return;
 
   // Record RTT in histogram when there are no more pings in flight.
-  RecordPingRTTHistogram(time_func_() - last_ping_sent_time_);
+  base::TimeDelta rtt = time_func_() - last_ping_sent_time_;
+  RecordPingRTTHistogram(rtt);
+  RecordRtt(rtt);
 }
 
 void SpdySession::OnRstStream(SpdyStreamId stream_id,
@@ -2781,7 +2888,16 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   if (data) {
     DCHECK_GT(len, 0u);
     CHECK_LE(len, static_cast<size_t>(kReadBufferSize));
-    buffer = std::make_unique<SpdyBuffer>(data, len);
+    // The decoder hands DATA payloads straight out of the input passed to
+    // ProcessInput(), which is |read_buffer_| while DoReadComplete() runs.
+    // Each new read gets a fresh buffer, so slices of it stay valid.
+    const char* read_data = read_buffer_ ? read_buffer_->data() : nullptr;
+    if (len >= kMinZeroCopyDataSize && read_data && data >= read_data &&
+        data + len <= read_data + kReadBufferSize) {
+      buffer = std::make_unique<SpdyBuffer>(read_buffer_, data, len);
+    } else {
+      buffer = std::make_unique<SpdyBuffer>(data, len);
+    }
 
     DecreaseRecvWindowSize(static_cast<int32_t>(len));
     buffer->AddConsumeCallback(base::Bind(&SpdySession::OnReadBufferConsumed,
@@ -2799,6 +2915,13 @@ void SpdySession::OnStreamFrameData(SpdyStreamId stream_id,
   SpdyStream* stream = it->second;
   CHECK_EQ(stream->stream_id(), stream_id);
 
+  // Hold unclaimed pushed bodies to the limit shared by all sessions.
+  if (buffer && stream->type() == SPDY_PUSH_STREAM &&
+      unclaimed_pushed_streams_.FindStream(stream->url()) == stream_id) {
+    pool_->push_promise_index()->OnUnclaimedPushedStreamData(this, stream_id,
+                                                             len);
+  }
+
   stream->AddRawReceivedBytes(len);
   stream->OnDataReceived(std::move(buffer));
 }
@@ -2858,6 +2981,12 @@ void SpdySession::OnSettingsAck() {
 
   if (net_log_.IsCapturing())
     net_log_.AddEvent(NetLogEventType::HTTP2_SESSION_RECV_SETTINGS_ACK);
+
+  // Only the initial SETTINGS frame is sent, so this acknowledges it.
+  if (!settings_sent_time_.is_null()) {
+    RecordRtt(time_func_() - settings_sent_time_);
+    settings_sent_time_ = base::TimeTicks();
+  }
 }
 
 void SpdySession::OnSetting(SpdySettingsIds id, uint32_t value) {
@@ -3178,12 +3307,55 @@ void SpdySession::IncreaseRecvWindowSize(int32_t delta_window_size) {
 
   session_unacked_recv_window_bytes_ += delta_window_size;
   if (session_unacked_recv_window_bytes_ > session_max_recv_window_size_ / 2) {
+    int32_t max_recv_window_size = AutoTuneRecvWindowSize(
+        session_max_recv_window_size_, kMaxAutoTunedRecvWindowSize,
+        &last_session_window_update_time_);
+    if (max_recv_window_size > session_max_recv_window_size_) {
+      // Announce the extra space in this WINDOW_UPDATE.
+      int32_t growth = max_recv_window_size - session_max_recv_window_size_;
+      session_max_recv_window_size_ = max_recv_window_size;
+      session_recv_window_size_ += growth;
+      session_unacked_recv_window_bytes_ += growth;
+    }
     SendWindowUpdateFrame(kSessionFlowControlStreamId,
                           session_unacked_recv_window_bytes_, HIGHEST);
     session_unacked_recv_window_bytes_ = 0;
   }
 }
 
+int32_t SpdySession::AutoTuneStreamRecvWindowSize(
+    int32_t max_recv_window_size,
+    base::TimeTicks* last_update_time) {
+  return AutoTuneRecvWindowSize(max_recv_window_size,
+                                std::max(max_recv_window_size,
+                                         session_max_recv_window_size_),
+                                last_update_time);
+}
+
+int32_t SpdySession::AutoTuneRecvWindowSize(int32_t window_size,
+                                            int32_t limit,
+                                            base::TimeTicks* last_update_time) {
+  base::TimeTicks now = time_func_();
+  base::TimeTicks previous_update_time = *last_update_time;
+  *last_update_time = now;
+  if (previous_update_time.is_null() || min_rtt_.is_zero() ||
+      window_size >= limit) {
+    return window_size;
+  }
+
+  // A window used up in less than two round trips is too small to keep the
+  // connection busy.
+  if (now - previous_update_time >= 2 * min_rtt_)
+    return window_size;
+
+  return window_size > limit / 2 ? limit : 2 * window_size;
+}
+
+void SpdySession::RecordRtt(base::TimeDelta rtt) {
+  if (min_rtt_.is_zero() || rtt < min_rtt_)
+    min_rtt_ = rtt;
+}
+
 void SpdySession::DecreaseRecvWindowSize(int32_t delta_window_size) {
   CHECK(in_io_loop_);
   DCHECK_GE(delta_window_size, 1);
@@ -383,6 +383,15 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   void SendStreamWindowUpdate(SpdyStreamId stream_id,
                               uint32_t delta_window_size);
 
+  // Called by a stream about to send a WINDOW_UPDATE frame, which it last sent
+  // at |*last_update_time|, for a receive window of |max_recv_window_size|.
+  // Returns the size the window should be restored to: twice as much, up to
+  // this session's receive window, if the window is used up within two round
+  // trips, which means it limits throughput, and |max_recv_window_size|
+  // otherwise.  Sets |*last_update_time| to now.
+  int32_t AutoTuneStreamRecvWindowSize(int32_t max_recv_window_size,
+                                       base::TimeTicks* last_update_time);
+
   // Accessors for the session's availability state.
   bool IsAvailable() const { return availability_state_ == STATE_AVAILABLE; }
   bool IsGoingAway() const { return availability_state_ == STATE_GOING_AWAY; }
@@ -451,6 +460,10 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // session flow control.
   bool IsSendStalled() const { return session_send_window_size_ == 0; }
 
+  // Returns true if the server has enabled the extended CONNECT method, by
+  // sending SETTINGS_ENABLE_CONNECT_PROTOCOL with a value of 1.
+  bool support_websocket() const { return support_websocket_; }
+
   const NetLogWithSource& net_log() const { return net_log_; }
 
   int GetPeerAddress(IPEndPoint* address) const;
@@ -481,6 +494,7 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   bool ValidatePushedStream(const SpdySessionKey& key) const override;
   void OnPushedStreamClaimed(const GURL& url, SpdyStreamId stream_id) override;
   base::WeakPtr<SpdySession> GetWeakPtrToSession() override;
+  void EvictUnclaimedPushedStream(SpdyStreamId stream_id) override;
 
   // Dumps memory allocation stats to |stats|. Sets |*is_session_active| to
   // indicate whether session is active.
@@ -570,6 +584,31 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
     DISALLOW_COPY_AND_ASSIGN(UnclaimedPushedStreamContainer);
   };
 
+  // A frame that has been taken off |write_queue_| and not yet completely
+  // written to the socket.
+  struct InFlightWrite {
+    InFlightWrite(std::unique_ptr<SpdyBuffer> buffer,
+                  SpdyFrameType frame_type,
+                  const base::WeakPtr<SpdyStream>& stream);
+    ~InFlightWrite();
+    InFlightWrite(InFlightWrite&& other);
+    InFlightWrite& operator=(InFlightWrite&& other);
+
+    size_t EstimateMemoryUsage() const;
+
+    // The unwritten part of the frame.
+    std::unique_ptr<SpdyBuffer> buffer;
+    SpdyFrameType frame_type;
+    // The size of the whole frame.
+    size_t frame_size;
+    // The stream to notify when the frame has been written to the socket
+    // completely.
+    base::WeakPtr<SpdyStream> stream;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(InFlightWrite);
+  };
+
   // Called by SpdyStreamRequest to start a request to create a
   // stream. If OK is returned, then |stream| will be filled in with a
   // valid stream. If ERR_IO_PENDING is returned, then
@@ -775,8 +814,8 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // Cancel pushed stream with |stream_id|, if still unclaimed.  Identifying a
   // pushed stream by GURL instead of stream ID could result in incorrect
   // behavior if a pushed stream was claimed but later another stream was pushed
-  // for the same GURL.
-  void CancelPushedStreamIfUnclaimed(SpdyStreamId stream_id);
+  // for the same GURL.  |error| is logged as the reason.
+  void CancelPushedStreamIfUnclaimed(SpdyStreamId stream_id, Error error);
 
   // BufferedSpdyFramerVisitorInterface:
   void OnError(Http2DecoderAdapter::SpdyFramerError spdy_framer_error) override;
@@ -878,6 +917,17 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // If session flow control is turned off, this must not be called.
   void DecreaseRecvWindowSize(int32_t delta_window_size);
 
+  // Returns the size a receive window of |window_size|, whose previous
+  // WINDOW_UPDATE was sent at |*last_update_time|, should be restored to by
+  // the next WINDOW_UPDATE.  The window is doubled, up to |limit|, if it is
+  // used up within two round trips.  Sets |*last_update_time| to now.
+  int32_t AutoTuneRecvWindowSize(int32_t window_size,
+                                 int32_t limit,
+                                 base::TimeTicks* last_update_time);
+
+  // Updates |min_rtt_| with a round trip time of |rtt|.
+  void RecordRtt(base::TimeDelta rtt);
+
   // Queue a send-stalled stream for possibly resuming once we're not
   // send-stalled anymore.
   void QueueSendStalledStream(const SpdyStream& stream);
@@ -966,17 +1016,13 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // The write queue.
   SpdyWriteQueue write_queue_;
 
-  // Data for the frame we are currently sending.
-
-  // The buffer we're currently writing.
-  std::unique_ptr<SpdyBuffer> in_flight_write_;
-  // The type of the frame in |in_flight_write_|.
-  SpdyFrameType in_flight_write_frame_type_;
-  // The size of the frame in |in_flight_write_|.
-  size_t in_flight_write_frame_size_;
-  // The stream to notify when |in_flight_write_| has been written to
-  // the socket completely.
-  base::WeakPtr<SpdyStream> in_flight_write_stream_;
+  // The frames we're currently writing, in the order they go out.  Small
+  // frames are taken off |write_queue_| together, so that they are passed to
+  // the socket, and end up in a TLS record, together.
+  base::circular_deque<InFlightWrite> in_flight_writes_;
+  // When |in_flight_writes_| holds more than one frame, a copy of their
+  // unwritten bytes, which is what gets written to the socket.
+  scoped_refptr<DrainableIOBuffer> coalesced_write_;
 
   // Spdy Frame state.
   std::unique_ptr<BufferedSpdyFramer> buffered_spdy_framer_;
@@ -1020,6 +1066,18 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // This is the last time we had read activity in the session.
   base::TimeTicks last_read_time_;
 
+  // True while the initial SETTINGS frame is queued or being written.
+  bool initial_settings_write_pending_;
+
+  // The time the initial SETTINGS frame was written to the socket, until it is
+  // acknowledged.
+  base::TimeTicks settings_sent_time_;
+
+  // The smallest round trip time measured from a SETTINGS or PING frame to its
+  // acknowledgement.  Zero until measured, in which case receive windows are
+  // not autotuned.
+  base::TimeDelta min_rtt_;
+
   // This is the length of the last compressed frame.
   size_t last_compressed_frame_len_;
 
@@ -1031,9 +1089,13 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
 
   // Maximum receive window size.  Each time a WINDOW_UPDATE is sent, it
   // restores the receive window size to this value.  Zero unless session flow
-  // control is turned on.
+  // control is turned on.  Grows if the window limits throughput, up to
+  // kMaxAutoTunedRecvWindowSize.
   int32_t session_max_recv_window_size_;
 
+  // The last time a session WINDOW_UPDATE was sent.
+  base::TimeTicks last_session_window_update_time_;
+
   // Sum of |session_unacked_recv_window_bytes_| and current receive window
   // size.  Zero unless session flow control is turned on.
   // TODO(bnc): Rename or change semantics so that |window_size_| is actual
@@ -1076,6 +1138,10 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // If true, alt-svc headers advertising QUIC in IETF format will be supported.
   bool support_ietf_format_quic_altsvc_;
 
+  // Set when the server sends SETTINGS_ENABLE_CONNECT_PROTOCOL = 1. See RFC
+  // 8441.
+  bool support_websocket_;
+
   // |connection_at_risk_of_loss_time_| is an optimization to avoid sending
   // wasteful preface pings (when we just got some data).
   //
@@ -5,16 +5,20 @@
 #include "net/spdy/chromium/spdy_session_pool.h"
 
 #include <utility>
+#include <vector>
 
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/stl_util.h"
+#include "base/strings/string_util.h"
 #include "base/trace_event/memory_allocator_dump.h"
 #include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_event.h"
 #include "base/values.h"
 #include "net/base/address_list.h"
+#include "net/base/ip_address.h"
 #include "net/base/trace_constants.h"
+#include "net/cert/x509_certificate.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_server_properties.h"
 #include "net/log/net_log_event_type.h"
@@ -28,6 +32,7 @@
 #include "net/spdy/core/hpack/hpack_static_table.h"
 #include "net/spdy/platform/api/spdy_estimate_memory_usage.h"
 #include "net/spdy/platform/api/spdy_string_utils.h"
+#include "net/ssl/ssl_info.h"
 
 namespace net {
 
@@ -41,8 +46,23 @@ enum SpdySessionGetTypes {
   SPDY_SESSION_GET_MAX        = 4
 };
 
+// Returns |name| lowercased and without a trailing dot.
+SpdyString NormalizeDnsName(base::StringPiece name) {
+  if (name.ends_with("."))
+    name.remove_suffix(1);
+  return base::ToLowerASCII(name);
+}
+
 }  // namespace
 
+SpdySessionPool::IPAlias::IPAlias(const SpdySessionKey& key,
+                                  std::set<SpdyString> dns_names)
+    : key(key), dns_names(std::move(dns_names)) {}
+
+SpdySessionPool::IPAlias::IPAlias(const IPAlias& other) = default;
+
+SpdySessionPool::IPAlias::~IPAlias() = default;
+
 SpdySessionPool::SpdySessionPool(
     HostResolver* resolver,
     SSLConfigService* ssl_config_service,
@@ -123,11 +143,8 @@ base::WeakPtr<SpdySession> SpdySessionPool::CreateAvailableSessionFromSocket(
   // potentially be pooled with this one. Because GetPeerAddress()
   // reports the proxy's address instead of the origin server, check
   // to see if this is a direct connection.
-  if (key.proxy_server().is_direct()) {
-    IPEndPoint address;
-    if (available_session->GetPeerAddress(&address) == OK)
-      aliases_[address] = key;
-  }
+  if (key.proxy_server().is_direct())
+    AddAlias(key, available_session);
 
   return available_session;
 }
@@ -181,48 +198,50 @@ base::WeakPtr<SpdySession> SpdySessionPool::FindAvailableSession(
   for (AddressList::const_iterator address_it = addresses.begin();
        address_it != addresses.end();
        ++address_it) {
-    AliasMap::const_iterator alias_it = aliases_.find(*address_it);
-    if (alias_it == aliases_.end())
-      continue;
-
-    // We found an alias.
-    const SpdySessionKey& alias_key = alias_it->second;
-
-    // We can reuse this session only if the proxy and privacy
-    // settings match.
-    if (!(alias_key.proxy_server() == key.proxy_server()) ||
-        !(alias_key.privacy_mode() == key.privacy_mode()))
-      continue;
+    auto range = aliases_.equal_range(*address_it);
+    for (auto alias_it = range.first; alias_it != range.second; ++alias_it) {
+      // We found an alias.
+      const SpdySessionKey& alias_key = alias_it->second.key;
+
+      // We can reuse this session only if the proxy and privacy
+      // settings match.
+      if (!(alias_key.proxy_server() == key.proxy_server()) ||
+          !(alias_key.privacy_mode() == key.privacy_mode()))
+        continue;
+
+      AvailableSessionMap::iterator available_session_it =
+          LookupAvailableSessionByKey(alias_key);
+      if (available_session_it == available_sessions_.end()) {
+        NOTREACHED();  // Aliases only refer to available sessions.
+        continue;
+      }
 
-    AvailableSessionMap::iterator available_session_it =
-        LookupAvailableSessionByKey(alias_key);
-    if (available_session_it == available_sessions_.end()) {
-      NOTREACHED();  // It shouldn't be in the aliases table if we can't get it!
-      continue;
-    }
+      const base::WeakPtr<SpdySession>& available_session =
+          available_session_it->second;
+      DCHECK(base::ContainsKey(sessions_, available_session.get()));
+      // If the session is a secure one, we need to verify that the server is
+      // authenticated to serve traffic for |host_port_proxy_pair| too.  The
+      // names in the certificate rule most sessions out without that.
+      if (!AliasMayServeHost(alias_it->second, key.host_port_pair().host()) ||
+          !available_session->VerifyDomainAuthentication(
+              key.host_port_pair().host())) {
+        UMA_HISTOGRAM_ENUMERATION("Net.SpdyIPPoolDomainMatch", 0, 2);
+        continue;
+      }
 
-    const base::WeakPtr<SpdySession>& available_session =
-        available_session_it->second;
-    DCHECK(base::ContainsKey(sessions_, available_session.get()));
-    // If the session is a secure one, we need to verify that the
-    // server is authenticated to serve traffic for |host_port_proxy_pair| too.
-    if (!available_session->VerifyDomainAuthentication(
-            key.host_port_pair().host())) {
-      UMA_HISTOGRAM_ENUMERATION("Net.SpdyIPPoolDomainMatch", 0, 2);
-      continue;
+      UMA_HISTOGRAM_ENUMERATION("Net.SpdyIPPoolDomainMatch", 1, 2);
+      UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
+                                FOUND_EXISTING_FROM_IP_POOL,
+                                SPDY_SESSION_GET_MAX);
+      net_log.AddEvent(
+          NetLogEventType::
+              HTTP2_SESSION_POOL_FOUND_EXISTING_SESSION_FROM_IP_POOL,
+          available_session->net_log().source().ToEventParametersCallback());
+      // Add this session to the map so that we can find it next time.
+      MapKeyToAvailableSession(key, available_session);
+      available_session->AddPooledAlias(key);
+      return available_session;
     }
-
-    UMA_HISTOGRAM_ENUMERATION("Net.SpdyIPPoolDomainMatch", 1, 2);
-    UMA_HISTOGRAM_ENUMERATION("Net.SpdySessionGet",
-                              FOUND_EXISTING_FROM_IP_POOL,
-                              SPDY_SESSION_GET_MAX);
-    net_log.AddEvent(
-        NetLogEventType::HTTP2_SESSION_POOL_FOUND_EXISTING_SESSION_FROM_IP_POOL,
-        available_session->net_log().source().ToEventParametersCallback());
-    // Add this session to the map so that we can find it next time.
-    MapKeyToAvailableSession(key, available_session);
-    available_session->AddPooledAlias(key);
-    return available_session;
   }
 
   return base::WeakPtr<SpdySession>();
@@ -495,17 +514,69 @@ void SpdySessionPool::UnmapKey(const SpdySessionKey& key) {
 }
 
 void SpdySessionPool::RemoveAliases(const SpdySessionKey& key) {
-  // Walk the aliases map, find references to this pair.
-  // TODO(mbelshe):  Figure out if this is too expensive.
-  for (AliasMap::iterator it = aliases_.begin(); it != aliases_.end(); ) {
-    if (it->second == key) {
-      AliasMap::iterator old_it = it;
-      ++it;
-      aliases_.erase(old_it);
-    } else {
-      ++it;
+  auto address_it = alias_addresses_.find(key);
+  if (address_it == alias_addresses_.end())
+    return;
+
+  auto range = aliases_.equal_range(address_it->second);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.key == key) {
+      aliases_.erase(it);
+      break;
+    }
+  }
+  alias_addresses_.erase(address_it);
+}
+
+// static
+bool SpdySessionPool::AliasMayServeHost(const IPAlias& alias,
+                                        const SpdyString& host) {
+  if (alias.dns_names.empty())
+    return true;
+
+  // IP addresses are matched against a different part of the certificate.
+  IPAddress ip_address;
+  if (ip_address.AssignFromIPLiteral(host))
+    return true;
+
+  SpdyString name = NormalizeDnsName(host);
+  if (base::ContainsKey(alias.dns_names, name))
+    return true;
+
+  // A wildcard matches a single leading label.
+  size_t dot = name.find('.');
+  return dot != SpdyString::npos && dot > 0 &&
+         base::ContainsKey(alias.dns_names, "*" + name.substr(dot));
+}
+
+void SpdySessionPool::AddAlias(const SpdySessionKey& key,
+                               const base::WeakPtr<SpdySession>& session) {
+  IPEndPoint address;
+  if (session->GetPeerAddress(&address) != OK)
+    return;
+
+  std::set<SpdyString> dns_names;
+  SSLInfo ssl_info;
+  std::vector<std::string> san_dns_names;
+  if (session->GetSSLInfo(&ssl_info) && ssl_info.cert &&
+      ssl_info.cert->GetSubjectAltName(&san_dns_names, nullptr)) {
+    for (const std::string& san_dns_name : san_dns_names) {
+      SpdyString name = NormalizeDnsName(san_dns_name);
+      // Only exact names and "*." wildcards are indexed.  Leave anything else
+      // to certificate verification.
+      bool is_wildcard =
+          base::StartsWith(name, "*.", base::CompareCase::SENSITIVE);
+      if (name.find('*', is_wildcard ? 1 : 0) != SpdyString::npos) {
+        dns_names.clear();
+        break;
+      }
+      dns_names.insert(name);
     }
   }
+
+  RemoveAliases(key);
+  aliases_.insert(std::make_pair(address, IPAlias(key, std::move(dns_names))));
+  alias_addresses_[key] = address;
 }
 
 SpdySessionPool::WeakSessionList SpdySessionPool::GetCurrentSessions() const {
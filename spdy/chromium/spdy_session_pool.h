@@ -200,7 +200,30 @@ class NET_EXPORT SpdySessionPool
   typedef std::vector<base::WeakPtr<SpdySession> > WeakSessionList;
   typedef std::map<SpdySessionKey, base::WeakPtr<SpdySession> >
       AvailableSessionMap;
-  typedef std::map<IPEndPoint, SpdySessionKey> AliasMap;
+  // A session reachable at an IP address, as indexed for IP based pooling.
+  struct IPAlias {
+    IPAlias(const SpdySessionKey& key, std::set<SpdyString> dns_names);
+    IPAlias(const IPAlias& other);
+    ~IPAlias();
+
+    SpdySessionKey key;
+    // The lowercase DNS names, possibly wildcards such as "*.example.com",
+    // in the subjectAltName of the session's certificate.  Used to skip
+    // sessions which can not serve a host without verifying their certificate.
+    // Empty if the session accepts any host, or its certificate can only be
+    // matched by verifying it.
+    std::set<SpdyString> dns_names;
+  };
+  typedef std::multimap<IPEndPoint, IPAlias> AliasMap;
+
+  // Returns false if |alias| can not serve |host| according to the DNS names
+  // of its certificate.  A true return must be confirmed by
+  // SpdySession::VerifyDomainAuthentication().
+  static bool AliasMayServeHost(const IPAlias& alias, const SpdyString& host);
+
+  // Adds |session|, which has just been created with |key|, to |aliases_|.
+  void AddAlias(const SpdySessionKey& key,
+                const base::WeakPtr<SpdySession>& session);
 
   // Returns true iff |session| is in |available_sessions_|.
   bool IsSessionAvailable(const base::WeakPtr<SpdySession>& session) const;
@@ -246,8 +269,11 @@ class NET_EXPORT SpdySessionPool
   // more than once in this map if it has aliases.
   AvailableSessionMap available_sessions_;
 
-  // A map of IPEndPoint aliases for sessions.
+  // A map of IPEndPoint aliases for sessions.  Several sessions, for example
+  // with different certificates, may share an IPEndPoint.
   AliasMap aliases_;
+  // The IPEndPoint each key in |aliases_| is mapped from.
+  std::map<SpdySessionKey, IPEndPoint> alias_addresses_;
 
   // The index of all unclaimed pushed streams of all SpdySessions in this pool.
   Http2PushPromiseIndex push_promise_index_;
@@ -681,6 +681,77 @@ TEST_F(SpdySessionPoolTest, IPPoolingDisabled) {
   EXPECT_NE(session0.get(), session1.get());
 }
 
+// Sessions sharing an IP address should all remain candidates for IP pooling,
+// and a wildcard in a certificate should match a single label.
+TEST_F(SpdySessionPoolTest, IPPoolingWithSharedAddressAndWildcard) {
+  const int kTestPort = 443;
+  struct TestHosts {
+    SpdyString name;
+    SpdySessionKey key;
+    AddressList addresses;
+    std::unique_ptr<HostResolver::Request> request;
+  } test_hosts[] = {
+      {"www.example.org"},
+      {"mail.example.com"},
+      {"docs.example.org"},
+      {"a.docs.example.org"},
+  };
+
+  // Populate the HostResolver cache.
+  session_deps_.host_resolver->set_synchronous_mode(true);
+  for (size_t i = 0; i < arraysize(test_hosts); i++) {
+    session_deps_.host_resolver->rules()->AddIPLiteralRule(
+        test_hosts[i].name, "192.168.0.1", SpdyString());
+
+    HostResolver::RequestInfo info(HostPortPair(test_hosts[i].name, kTestPort));
+    session_deps_.host_resolver->Resolve(
+        info, DEFAULT_PRIORITY, &test_hosts[i].addresses, CompletionCallback(),
+        &test_hosts[i].request, NetLogWithSource());
+
+    test_hosts[i].key =
+        SpdySessionKey(HostPortPair(test_hosts[i].name, kTestPort),
+                       ProxyServer::Direct(), PRIVACY_MODE_DISABLED);
+  }
+
+  MockRead reads[] = {MockRead(SYNCHRONOUS, ERR_IO_PENDING)};
+  StaticSocketDataProvider data(reads, arraysize(reads), nullptr, 0);
+  data.set_connect_data(MockConnect(SYNCHRONOUS, OK));
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+  SSLSocketDataProvider ssl(SYNCHRONOUS, OK);
+  ssl.ssl_info.cert =
+      ImportCertFromFile(GetTestCertsDirectory(), "wildcard.pem");
+  ASSERT_TRUE(ssl.ssl_info.cert);
+  session_deps_.socket_factory->AddSSLSocketDataProvider(&ssl);
+
+  MockRead reads1[] = {MockRead(SYNCHRONOUS, ERR_IO_PENDING)};
+  StaticSocketDataProvider data1(reads1, arraysize(reads1), nullptr, 0);
+  data1.set_connect_data(MockConnect(SYNCHRONOUS, OK));
+  session_deps_.socket_factory->AddSocketDataProvider(&data1);
+  AddSSLSocketData();
+
+  CreateNetworkSession();
+
+  // Open a session for *.example.org, then one at the same address for
+  // mail.example.com, which the first one can not serve.
+  base::WeakPtr<SpdySession> session0 = CreateSpdySession(
+      http_session_.get(), test_hosts[0].key, NetLogWithSource());
+  base::WeakPtr<SpdySession> session1 = CreateSpdySession(
+      http_session_.get(), test_hosts[1].key, NetLogWithSource());
+  EXPECT_NE(session0.get(), session1.get());
+
+  // The first session is still found through the shared address.
+  base::WeakPtr<SpdySession> session2 =
+      spdy_session_pool_->FindAvailableSession(
+          test_hosts[2].key, /* enable_ip_based_pooling = */ true,
+          NetLogWithSource());
+  EXPECT_EQ(session0.get(), session2.get());
+
+  // The wildcard does not match two labels.
+  EXPECT_FALSE(spdy_session_pool_->FindAvailableSession(
+      test_hosts[3].key, /* enable_ip_based_pooling = */ true,
+      NetLogWithSource()));
+}
+
 // Construct a Pool with SpdySessions in various availability states. Simulate
 // an IP address change. Ensure sessions gracefully shut down. Regression test
 // for crbug.com/379469.
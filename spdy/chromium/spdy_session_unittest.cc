@@ -296,6 +296,14 @@ class SpdySessionTest : public PlatformTest {
     return session_->session_unacked_recv_window_bytes_;
   }
 
+  int32_t session_max_recv_window_size() {
+    return session_->session_max_recv_window_size_;
+  }
+
+  base::TimeDelta min_rtt() { return session_->min_rtt_; }
+
+  void set_min_rtt(base::TimeDelta min_rtt) { session_->min_rtt_ = min_rtt; }
+
   int32_t stream_initial_send_window_size() {
     return session_->stream_initial_send_window_size_;
   }
@@ -1132,6 +1140,62 @@ TEST_F(SpdySessionTest, PingAndWriteLoop) {
   EXPECT_FALSE(session_);
 }
 
+// Frames queued together should go out in a single socket write, and each
+// stream should still be told when its own frame has been written.
+TEST_F(SpdySessionTest, CoalesceQueuedFrames) {
+  SpdySerializedFrame req1(
+      spdy_util_.ConstructSpdyGet(nullptr, 0, 1, LOWEST, true));
+  SpdySerializedFrame req2(
+      spdy_util_.ConstructSpdyGet(nullptr, 0, 3, LOWEST, true));
+  SpdySerializedFrame both = CombineFrames({&req1, &req2});
+  MockWrite writes[] = {
+      CreateMockWrite(both, 0),
+  };
+
+  MockRead reads[] = {
+      MockRead(ASYNC, ERR_IO_PENDING, 1), MockRead(ASYNC, 0, 2)  // EOF
+  };
+
+  session_deps_.host_resolver->set_synchronous_mode(true);
+
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+
+  AddSSLSocketData();
+
+  CreateNetworkSession();
+  CreateSpdySession();
+
+  base::WeakPtr<SpdyStream> spdy_stream1 =
+      CreateStreamSynchronously(SPDY_REQUEST_RESPONSE_STREAM, session_,
+                                test_url_, LOWEST, NetLogWithSource());
+  test::StreamDelegateDoNothing delegate1(spdy_stream1);
+  spdy_stream1->SetDelegate(&delegate1);
+
+  base::WeakPtr<SpdyStream> spdy_stream2 =
+      CreateStreamSynchronously(SPDY_REQUEST_RESPONSE_STREAM, session_,
+                                test_url_, LOWEST, NetLogWithSource());
+  test::StreamDelegateDoNothing delegate2(spdy_stream2);
+  spdy_stream2->SetDelegate(&delegate2);
+
+  SpdyHeaderBlock headers1(spdy_util_.ConstructGetHeaderBlock(kDefaultUrl));
+  spdy_stream1->SendRequestHeaders(std::move(headers1), NO_MORE_DATA_TO_SEND);
+  SpdyHeaderBlock headers2(spdy_util_.ConstructGetHeaderBlock(kDefaultUrl));
+  spdy_stream2->SendRequestHeaders(std::move(headers2), NO_MORE_DATA_TO_SEND);
+
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+  EXPECT_EQ(1u, spdy_stream1->stream_id());
+  EXPECT_EQ(3u, spdy_stream2->stream_id());
+  EXPECT_TRUE(delegate1.send_headers_completed());
+  EXPECT_TRUE(delegate2.send_headers_completed());
+
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(session_);
+}
+
 TEST_F(SpdySessionTest, StreamIdSpaceExhausted) {
   const SpdyStreamId kLastStreamId = 0x7fffffff;
   session_deps_.host_resolver->set_synchronous_mode(true);
@@ -1961,6 +2025,42 @@ TEST_F(SpdySessionTest, OnSettings) {
   EXPECT_TRUE(data.AllReadDataConsumed());
 }
 
+TEST_F(SpdySessionTest, EnableConnectProtocol) {
+  session_deps_.host_resolver->set_synchronous_mode(true);
+
+  SettingsMap new_settings;
+  new_settings[SETTINGS_ENABLE_CONNECT_PROTOCOL] = 1;
+  SpdySerializedFrame settings_frame(
+      spdy_util_.ConstructSpdySettings(new_settings));
+  MockRead reads[] = {
+      CreateMockRead(settings_frame, 0), MockRead(ASYNC, ERR_IO_PENDING, 2),
+      MockRead(ASYNC, 0, 3),
+  };
+
+  SpdySerializedFrame settings_ack(spdy_util_.ConstructSpdySettingsAck());
+  MockWrite writes[] = {CreateMockWrite(settings_ack, 1)};
+
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+
+  AddSSLSocketData();
+
+  CreateNetworkSession();
+  CreateSpdySession();
+  EXPECT_FALSE(session_->support_websocket());
+
+  base::RunLoop().RunUntilIdle();
+  ASSERT_TRUE(session_);
+  EXPECT_TRUE(session_->support_websocket());
+
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(session_);
+
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+  EXPECT_TRUE(data.AllReadDataConsumed());
+}
+
 // Create one more stream than maximum number of concurrent streams,
 // so that one of them is pending.  Cancel one stream, which should trigger the
 // creation of the pending stream.  Then cancel that one immediately as well,
@@ -3857,6 +3957,61 @@ TEST_F(SpdySessionTest, AdjustRecvWindowSize) {
   EXPECT_FALSE(session_);
 }
 
+// The session receive window should double when WINDOW_UPDATE frames are sent
+// less than two round trips apart, and stay put otherwise.
+TEST_F(SpdySessionTest, AutoTuneRecvWindowSize) {
+  session_deps_.host_resolver->set_synchronous_mode(true);
+  session_deps_.time_func = TheNearFuture;
+  g_time_delta = base::TimeDelta();
+
+  const int32_t initial_window_size = kDefaultInitialWindowSize;
+
+  MockRead reads[] = {
+      MockRead(ASYNC, ERR_IO_PENDING, 3), MockRead(ASYNC, 0, 4)  // EOF
+  };
+  SpdySerializedFrame window_update1(spdy_util_.ConstructSpdyWindowUpdate(
+      kSessionFlowControlStreamId, initial_window_size));
+  SpdySerializedFrame window_update2(spdy_util_.ConstructSpdyWindowUpdate(
+      kSessionFlowControlStreamId, 2 * initial_window_size));
+  MockWrite writes[] = {
+      CreateMockWrite(window_update1, 0), CreateMockWrite(window_update2, 1),
+      CreateMockWrite(window_update2, 2),
+  };
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+
+  AddSSLSocketData();
+
+  CreateNetworkSession();
+  CreateSpdySession();
+  set_min_rtt(base::TimeDelta::FromMilliseconds(100));
+
+  // The first WINDOW_UPDATE has nothing to be compared with.
+  IncreaseRecvWindowSize(initial_window_size);
+  EXPECT_EQ(initial_window_size, session_max_recv_window_size());
+  base::RunLoop().RunUntilIdle();
+
+  // The window is used up within a round trip, and doubles.
+  g_time_delta += base::TimeDelta::FromMilliseconds(50);
+  IncreaseRecvWindowSize(initial_window_size);
+  EXPECT_EQ(2 * initial_window_size, session_max_recv_window_size());
+  EXPECT_EQ(4 * initial_window_size, session_recv_window_size());
+  EXPECT_EQ(0, session_unacked_recv_window_bytes());
+  base::RunLoop().RunUntilIdle();
+
+  // The window lasts for more than two round trips, and stays put.
+  g_time_delta += base::TimeDelta::FromSeconds(1);
+  IncreaseRecvWindowSize(2 * initial_window_size);
+  EXPECT_EQ(2 * initial_window_size, session_max_recv_window_size());
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+  EXPECT_TRUE(session_);
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(session_);
+}
+
 // SpdySession::{Increase,Decrease}SendWindowSize should properly
 // adjust the session send window size when the "enable_spdy_31" flag
 // is set.
@@ -5728,6 +5883,61 @@ class SendInitialSettingsOnNewSpdySessionTest : public SpdySessionTest {
   }
 };
 
+// The round trip of the initial SETTINGS frame is timed from when it is written
+// to the socket, not from when it is queued.
+TEST_F(SendInitialSettingsOnNewSpdySessionTest, RttExcludesWriteDelay) {
+  session_deps_.host_resolver->set_synchronous_mode(true);
+  session_deps_.time_func = TheNearFuture;
+  g_time_delta = base::TimeDelta();
+
+  SettingsMap expected_settings;
+  expected_settings[SETTINGS_HEADER_TABLE_SIZE] = kSpdyMaxHeaderTableSize;
+  expected_settings[SETTINGS_MAX_CONCURRENT_STREAMS] =
+      kSpdyMaxConcurrentPushedStreams;
+  SpdySerializedFrame preface(const_cast<char*>(kHttp2ConnectionHeaderPrefix),
+                              kHttp2ConnectionHeaderPrefixSize,
+                              /* owns_buffer = */ false);
+  SpdySerializedFrame settings_frame(
+      spdy_util_.ConstructSpdySettings(expected_settings));
+  SpdySerializedFrame combined_frame =
+      CombineFrames({&preface, &settings_frame});
+  SpdySerializedFrame settings_ack(spdy_util_.ConstructSpdySettingsAck());
+
+  // The SETTINGS frame can only be written once the first read resumes.
+  MockRead reads[] = {
+      MockRead(ASYNC, ERR_IO_PENDING, 0), MockRead(ASYNC, ERR_IO_PENDING, 2),
+      CreateMockRead(settings_ack, 3), MockRead(ASYNC, ERR_IO_PENDING, 4),
+      MockRead(ASYNC, 0, 5)  // EOF
+  };
+  MockWrite writes[] = {CreateMockWrite(combined_frame, 1)};
+  SequencedSocketData data(reads, arraysize(reads), writes, arraysize(writes));
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+  AddSSLSocketData();
+
+  CreateNetworkSession();
+  SpdySessionPoolPeer pool_peer(spdy_session_pool_);
+  pool_peer.SetEnableSendingInitialData(true);
+  CreateSpdySession();
+  base::RunLoop().RunUntilIdle();
+
+  // The SETTINGS frame waits a long time to be written.
+  g_time_delta += base::TimeDelta::FromSeconds(10);
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(data.AllWriteDataConsumed());
+
+  g_time_delta += base::TimeDelta::FromMilliseconds(20);
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_GE(min_rtt(), base::TimeDelta::FromMilliseconds(20));
+  EXPECT_LT(min_rtt(), base::TimeDelta::FromSeconds(10));
+
+  EXPECT_TRUE(session_);
+  data.Resume();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_FALSE(session_);
+}
+
 // Setting values when Params::http2_settings is empty.  Note that
 // SETTINGS_INITIAL_WINDOW_SIZE is sent in production, because it is set to a
 // non-default value, but it is not sent in tests, because the protocol default
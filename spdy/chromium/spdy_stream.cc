@@ -315,6 +315,15 @@ void SpdyStream::IncreaseRecvWindowSize(int32_t delta_window_size) {
 
   unacked_recv_window_bytes_ += delta_window_size;
   if (unacked_recv_window_bytes_ > max_recv_window_size_ / 2) {
+    int32_t max_recv_window_size = session_->AutoTuneStreamRecvWindowSize(
+        max_recv_window_size_, &last_window_update_time_);
+    if (max_recv_window_size > max_recv_window_size_) {
+      // Announce the extra space in this WINDOW_UPDATE.
+      int32_t growth = max_recv_window_size - max_recv_window_size_;
+      max_recv_window_size_ = max_recv_window_size;
+      recv_window_size_ += growth;
+      unacked_recv_window_bytes_ += growth;
+    }
     session_->SendStreamWindowUpdate(
         stream_id_, static_cast<uint32_t>(unacked_recv_window_bytes_));
     unacked_recv_window_bytes_ = 0;
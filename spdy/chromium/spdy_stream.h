@@ -451,9 +451,13 @@ class NET_EXPORT_PRIVATE SpdyStream {
   int32_t send_window_size_;
 
   // Maximum receive window size.  Each time a WINDOW_UPDATE is sent, it
-  // restores the receive window size to this value.
+  // restores the receive window size to this value.  Grows if the window
+  // limits throughput, see SpdySession::AutoTuneStreamRecvWindowSize().
   int32_t max_recv_window_size_;
 
+  // The last time a WINDOW_UPDATE was sent.
+  base::TimeTicks last_window_update_time_;
+
   // Sum of |session_unacked_recv_window_bytes_| and current receive window
   // size.
   // TODO(bnc): Rename or change semantics so that |window_size_| is actual
@@ -85,6 +85,18 @@ HpackEncoder::HpackEncoder(const HpackHuffmanTable& table)
 
 HpackEncoder::~HpackEncoder() = default;
 
+HpackEncoder::MemoizedHeader::MemoizedHeader()
+    : has_entry(false), is_static(false), insertion_index(0) {}
+
+HpackEncoder::MemoizedHeader::MemoizedHeader(const MemoizedHeader& other) =
+    default;
+
+HpackEncoder::MemoizedHeader::~MemoizedHeader() = default;
+
+size_t HpackEncoder::MemoizedHeader::EstimateMemoryUsage() const {
+  return SpdyEstimateMemoryUsage(name) + SpdyEstimateMemoryUsage(value);
+}
+
 void HpackEncoder::EncodeHeaderSet(const Representations& representations,
                                    SpdyString* output) {
   RepresentationIterator iter(representations);
@@ -133,31 +145,66 @@ void HpackEncoder::ApplyHeaderTableSizeSetting(size_t size_setting) {
 size_t HpackEncoder::EstimateMemoryUsage() const {
   // |huffman_table_| is a singleton. It's accounted for in spdy_session_pool.cc
   return SpdyEstimateMemoryUsage(header_table_) +
-         SpdyEstimateMemoryUsage(output_stream_);
+         SpdyEstimateMemoryUsage(output_stream_) +
+         SpdyEstimateMemoryUsage(memoized_headers_);
 }
 
 void HpackEncoder::EncodeRepresentations(RepresentationIterator* iter,
                                          SpdyString* output) {
   MaybeEmitTableSize();
-  while (iter->HasNext()) {
-    const auto header = iter->Next();
-    listener_(header.first, header.second);
-    if (enable_compression_) {
-      const HpackEntry* entry =
-          header_table_.GetByNameAndValue(header.first, header.second);
+  for (size_t position = 0; iter->HasNext(); ++position) {
+    EncodeRepresentation(iter->Next(), position);
+  }
+
+  output_stream_.TakeString(output);
+}
+
+void HpackEncoder::EncodeRepresentation(const Representation& header,
+                                        size_t position) {
+  listener_(header.first, header.second);
+  if (!enable_compression_) {
+    EmitNonIndexedLiteral(header);
+    return;
+  }
+  if (position < memoized_headers_.size()) {
+    const MemoizedHeader& memoized = memoized_headers_[position];
+    if (memoized.has_entry && memoized.name == header.first &&
+        memoized.value == header.second) {
+      const HpackEntry* entry = header_table_.GetByInsertionIndex(
+          memoized.is_static, memoized.insertion_index);
       if (entry != nullptr) {
         EmitIndex(entry);
-      } else if (should_index_(header.first, header.second)) {
-        EmitIndexedLiteral(header);
-      } else {
-        EmitNonIndexedLiteral(header);
+        return;
       }
-    } else {
-      EmitNonIndexedLiteral(header);
     }
   }
+  const HpackEntry* entry =
+      header_table_.GetByNameAndValue(header.first, header.second);
+  if (entry != nullptr) {
+    EmitIndex(entry);
+  } else if (should_index_(header.first, header.second)) {
+    entry = EmitIndexedLiteral(header);
+  } else {
+    EmitNonIndexedLiteral(header);
+  }
+  MemoizeHeader(header, position, entry);
+}
 
-  output_stream_.TakeString(output);
+void HpackEncoder::MemoizeHeader(const Representation& header,
+                                 size_t position,
+                                 const HpackEntry* entry) {
+  if (position >= memoized_headers_.size()) {
+    memoized_headers_.resize(position + 1);
+  }
+  MemoizedHeader& memoized = memoized_headers_[position];
+  memoized.has_entry = entry != nullptr;
+  if (entry == nullptr) {
+    return;
+  }
+  memoized.name.assign(header.first.data(), header.first.size());
+  memoized.value.assign(header.second.data(), header.second.size());
+  memoized.is_static = entry->IsStatic();
+  memoized.insertion_index = entry->InsertionIndex();
 }
 
 void HpackEncoder::EmitIndex(const HpackEntry* entry) {
@@ -166,12 +213,14 @@ void HpackEncoder::EmitIndex(const HpackEntry* entry) {
   output_stream_.AppendUint32(header_table_.IndexOf(entry));
 }
 
-void HpackEncoder::EmitIndexedLiteral(const Representation& representation) {
+const HpackEntry* HpackEncoder::EmitIndexedLiteral(
+    const Representation& representation) {
   DVLOG(2) << "Emitting indexed literal: (" << representation.first << ", "
            << representation.second << ")";
   output_stream_.AppendPrefix(kLiteralIncrementalIndexOpcode);
   EmitLiteral(representation);
-  header_table_.TryAddEntry(representation.first, representation.second);
+  return header_table_.TryAddEntry(representation.first,
+                                   representation.second);
 }
 
 void HpackEncoder::EmitNonIndexedLiteral(const Representation& representation) {
@@ -303,12 +352,14 @@ class HpackEncoder::Encoderator : public ProgressiveEncoder {
   std::unique_ptr<RepresentationIterator> header_it_;
   Representations pseudo_headers_;
   Representations regular_headers_;
+  // Position within the header block of the next header to encode.
+  size_t position_;
   bool has_next_;
 };
 
 HpackEncoder::Encoderator::Encoderator(const SpdyHeaderBlock& header_set,
                                        HpackEncoder* encoder)
-    : encoder_(encoder), has_next_(true) {
+    : encoder_(encoder), position_(0), has_next_(true) {
   // Separate header set into pseudo-headers and regular headers.
   const bool use_compression = encoder_->enable_compression_;
   bool found_cookie = false;
@@ -337,26 +388,11 @@ void HpackEncoder::Encoderator::Next(size_t max_encoded_bytes,
                                      SpdyString* output) {
   SPDY_BUG_IF(!has_next_)
       << "Encoderator::Next called with nothing left to encode.";
-  const bool use_compression = encoder_->enable_compression_;
 
   // Encode up to max_encoded_bytes of headers.
   while (header_it_->HasNext() &&
          encoder_->output_stream_.size() <= max_encoded_bytes) {
-    const Representation header = header_it_->Next();
-    encoder_->listener_(header.first, header.second);
-    if (use_compression) {
-      const HpackEntry* entry = encoder_->header_table_.GetByNameAndValue(
-          header.first, header.second);
-      if (entry != nullptr) {
-        encoder_->EmitIndex(entry);
-      } else if (encoder_->should_index_(header.first, header.second)) {
-        encoder_->EmitIndexedLiteral(header);
-      } else {
-        encoder_->EmitNonIndexedLiteral(header);
-      }
-    } else {
-      encoder_->EmitNonIndexedLiteral(header);
-    }
+    encoder_->EncodeRepresentation(header_it_->Next(), position_++);
   }
 
   has_next_ = encoder_->output_stream_.size() > max_encoded_bytes;
@@ -108,14 +108,44 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
   class RepresentationIterator;
   class Encoderator;
 
+  // How the header at some position of the previous header block was
+  // encoded. If the header at that position of the next block is the same, and
+  // its entry is still in |header_table_|, the entry is emitted as an index
+  // without looking the header up by name and value.
+  struct MemoizedHeader {
+    MemoizedHeader();
+    MemoizedHeader(const MemoizedHeader& other);
+    ~MemoizedHeader();
+
+    size_t EstimateMemoryUsage() const;
+
+    SpdyString name;
+    SpdyString value;
+    // Whether the header was found in, or added to, |header_table_|. If so,
+    // |is_static| and |insertion_index| identify its entry.
+    bool has_entry;
+    bool is_static;
+    size_t insertion_index;
+  };
+
   // Encodes a sequence of header name-value pairs as a single header block.
   void EncodeRepresentations(RepresentationIterator* iter, SpdyString* output);
 
+  // Encodes |header|, which is at |position| within its header block.
+  void EncodeRepresentation(const Representation& header, size_t position);
+
+  // Remembers that |header| at |position| was encoded using |entry|, which is
+  // NULL if it was emitted as a non-indexed literal.
+  void MemoizeHeader(const Representation& header,
+                     size_t position,
+                     const HpackEntry* entry);
+
   // Emits a static/dynamic indexed representation (Section 7.1).
   void EmitIndex(const HpackEntry* entry);
 
-  // Emits a literal representation (Section 7.2).
-  void EmitIndexedLiteral(const Representation& representation);
+  // Emits a literal representation (Section 7.2). EmitIndexedLiteral returns
+  // the entry added to the dynamic table, or NULL if it didn't fit.
+  const HpackEntry* EmitIndexedLiteral(const Representation& representation);
   void EmitNonIndexedLiteral(const Representation& representation);
   void EmitLiteral(const Representation& representation);
 
@@ -140,6 +170,7 @@ class SPDY_EXPORT_PRIVATE HpackEncoder {
 
   HpackHeaderTable header_table_;
   HpackOutputStream output_stream_;
+  std::vector<MemoizedHeader> memoized_headers_;
 
   const HpackHuffmanTable& huffman_table_;
   size_t min_table_size_setting_received_;
@@ -294,6 +294,49 @@ TEST_P(HpackEncoderTest, EmitThanEvict) {
   CompareWithExpectedEncoding(headers);
 }
 
+TEST_P(HpackEncoderTest, RepeatedHeaderSet) {
+  SpdyHeaderBlock headers;
+  headers[":method"] = "GET";
+  headers["key2"] = "value2";
+  headers["cookie"] = "a=bb; c=dd";
+
+  // The second and third blocks are encoded from the memo of the first, and
+  // must match an encoding made by looking each header up.
+  for (int i = 0; i < 3; ++i) {
+    ExpectIndex(2);
+    ExpectIndex(IndexOf(key_2_));
+    ExpectIndex(IndexOf(cookie_a_));
+    ExpectIndex(IndexOf(cookie_c_));
+    CompareWithExpectedEncoding(headers);
+  }
+}
+
+TEST_P(HpackEncoderTest, RepeatedHeaderSetWithEvictedEntry) {
+  {
+    SpdyHeaderBlock headers;
+    headers[key_1_->name()] = key_1_->value();
+    ExpectIndex(IndexOf(key_1_));
+    CompareWithExpectedEncoding(headers);
+  }
+  {
+    // "key3" evicts |key_1_|, whose index was memoized by the first block.
+    SpdyHeaderBlock headers;
+    headers[key_1_->name()] = key_1_->value();
+    headers["key3"] = "value3";
+    ExpectIndex(IndexOf(key_1_));
+    ExpectIndexedLiteral("key3", "value3");
+    CompareWithExpectedEncoding(headers);
+  }
+  {
+    // "key1" is no longer in the table, so it is emitted as a literal, rather
+    // than as the index of the evicted entry.
+    SpdyHeaderBlock headers;
+    headers["key1"] = "value1";
+    ExpectIndexedLiteral("key1", "value1");
+    CompareWithExpectedEncoding(headers);
+  }
+}
+
 TEST_P(HpackEncoderTest, CookieHeaderIsCrumbled) {
   ExpectIndex(IndexOf(cookie_a_));
   ExpectIndex(IndexOf(cookie_c_));
@@ -102,6 +102,28 @@ const HpackEntry* HpackHeaderTable::GetByNameAndValue(SpdyStringPiece name,
   return nullptr;
 }
 
+const HpackEntry* HpackHeaderTable::GetByInsertionIndex(
+    bool is_static,
+    size_t insertion_index) {
+  if (is_static) {
+    DCHECK_LT(insertion_index, static_entries_.size());
+    return &static_entries_[insertion_index];
+  }
+  // Entries are evicted oldest first, so |dynamic_entries_| holds the most
+  // recent insertions, with the newest at the front.
+  if (insertion_index >= total_insertions_ ||
+      total_insertions_ - insertion_index > dynamic_entries_.size()) {
+    return nullptr;
+  }
+  const HpackEntry* result =
+      &dynamic_entries_[total_insertions_ - 1 - insertion_index];
+  DCHECK_EQ(insertion_index, result->InsertionIndex());
+  if (debug_visitor_ != nullptr) {
+    debug_visitor_->OnUseEntry(*result);
+  }
+  return result;
+}
+
 size_t HpackHeaderTable::IndexOf(const HpackEntry* entry) const {
   if (entry->IsLookup()) {
     return 0;
@@ -95,6 +95,12 @@ class SPDY_EXPORT_PRIVATE HpackHeaderTable {
   const HpackEntry* GetByNameAndValue(SpdyStringPiece name,
                                       SpdyStringPiece value);
 
+  // Returns the entry having |insertion_index| among the static entries if
+  // |is_static|, or else among the dynamic entries, or NULL if that dynamic
+  // entry has been evicted. Lets a caller which remembers an entry's
+  // insertion index find it again without hashing its name and value.
+  const HpackEntry* GetByInsertionIndex(bool is_static, size_t insertion_index);
+
   // Returns the index of an entry within this header table.
   size_t IndexOf(const HpackEntry* entry) const;
 
@@ -256,6 +256,32 @@ TEST_F(HpackHeaderTableTest, EntryIndexing) {
             table_.GetByNameAndValue(first_static_entry->name(), "Value Four"));
 }
 
+TEST_F(HpackHeaderTableTest, GetByInsertionIndex) {
+  const HpackEntry* static_entry = table_.GetByIndex(2);
+  EXPECT_EQ(static_entry, table_.GetByInsertionIndex(
+                              true, static_entry->InsertionIndex()));
+
+  // Nothing has been inserted yet.
+  EXPECT_EQ(nullptr, table_.GetByInsertionIndex(false, 0));
+
+  const HpackEntry* entry1 = table_.TryAddEntry("key-1", "Value One");
+  const HpackEntry* entry2 = table_.TryAddEntry("key-2", "Value Two");
+  EXPECT_EQ(entry1,
+            table_.GetByInsertionIndex(false, entry1->InsertionIndex()));
+  EXPECT_EQ(entry2,
+            table_.GetByInsertionIndex(false, entry2->InsertionIndex()));
+  EXPECT_EQ(nullptr,
+            table_.GetByInsertionIndex(false, entry2->InsertionIndex() + 1));
+
+  // Once evicted, an entry is no longer found, while newer ones still are.
+  size_t evicted_insertion_index = entry1->InsertionIndex();
+  peer_.Evict(1);
+  EXPECT_EQ(nullptr,
+            table_.GetByInsertionIndex(false, evicted_insertion_index));
+  EXPECT_EQ(entry2,
+            table_.GetByInsertionIndex(false, entry2->InsertionIndex()));
+}
+
 TEST_F(HpackHeaderTableTest, SetSizes) {
   SpdyString key = "key", value = "value";
   const HpackEntry* entry1 = table_.TryAddEntry(key, value);
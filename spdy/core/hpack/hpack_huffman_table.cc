@@ -98,7 +98,12 @@ bool HpackHuffmanTable::IsInitialized() const {
 
 void HpackHuffmanTable::EncodeString(SpdyStringPiece in,
                                      HpackOutputStream* out) const {
-  size_t bit_remnant = 0;
+  // Codes are accumulated in the low-order bits of |bits|, and written out a
+  // whole byte at a time rather than in up to four pieces per code. Fewer than
+  // eight bits are pending before each code is added, and codes are at most 30
+  // bits long, so |bits| never holds more than 37 pending bits.
+  uint64_t bits = 0;
+  size_t bit_count = 0;
   for (size_t i = 0; i != in.size(); i++) {
     uint16_t symbol_id = static_cast<uint8_t>(in[i]);
     CHECK_GT(code_by_id_.size(), symbol_id);
@@ -107,25 +112,18 @@ void HpackHuffmanTable::EncodeString(SpdyStringPiece in,
     unsigned length = length_by_id_[symbol_id];
     uint32_t code = code_by_id_[symbol_id] >> (32 - length);
 
-    bit_remnant = (bit_remnant + length) % 8;
-
-    if (length > 24) {
-      out->AppendBits(static_cast<uint8_t>(code >> 24), length - 24);
-      length = 24;
-    }
-    if (length > 16) {
-      out->AppendBits(static_cast<uint8_t>(code >> 16), length - 16);
-      length = 16;
-    }
-    if (length > 8) {
-      out->AppendBits(static_cast<uint8_t>(code >> 8), length - 8);
-      length = 8;
+    bits = (bits << length) | code;
+    bit_count += length;
+    while (bit_count >= 8) {
+      bit_count -= 8;
+      out->AppendBits(static_cast<uint8_t>(bits >> bit_count), 8);
     }
-    out->AppendBits(static_cast<uint8_t>(code), length);
   }
-  if (bit_remnant != 0) {
+  if (bit_count != 0) {
     // Pad current byte as required.
-    out->AppendBits(pad_bits_ >> bit_remnant, 8 - bit_remnant);
+    uint8_t last_byte = static_cast<uint8_t>(bits << (8 - bit_count));
+    out->AppendBits(static_cast<uint8_t>(last_byte | (pad_bits_ >> bit_count)),
+                    8);
   }
 }
 
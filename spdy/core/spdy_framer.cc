@@ -560,12 +560,13 @@ SpdySerializedFrame SpdyFramer::SerializeGoAway(
   return builder.take();
 }
 
-void SpdyFramer::SerializeHeadersBuilderHelper(const SpdyHeadersIR& headers,
-                                               uint8_t* flags,
-                                               size_t* size,
-                                               SpdyString* hpack_encoding,
-                                               int* weight,
-                                               size_t* length_field) {
+void SpdyFramer::SerializeHeadersBuilderHelper(
+    const SpdyHeadersIR& headers,
+    const SpdyString& hpack_encoding,
+    uint8_t* flags,
+    size_t* size,
+    int* weight,
+    size_t* length_field) {
   if (headers.fin()) {
     *flags = *flags | CONTROL_FLAG_FIN;
   }
@@ -590,8 +591,7 @@ void SpdyFramer::SerializeHeadersBuilderHelper(const SpdyHeadersIR& headers,
     *size = *size + 5;
   }
 
-  GetHpackEncoder()->EncodeHeaderSet(headers.header_block(), hpack_encoding);
-  *size = *size + hpack_encoding->size();
+  *size = *size + hpack_encoding.size();
   if (*size > kMaxControlFrameSendSize) {
     *size = *size + GetNumberRequiredContinuationFrames(*size) *
                         kContinuationFrameMinimumSize;
@@ -606,7 +606,7 @@ void SpdyFramer::SerializeHeadersBuilderHelper(const SpdyHeadersIR& headers,
     *length_field = *length_field + 1;  // Weight field.
   }
   *length_field = *length_field + headers.padding_payload_len();
-  *length_field = *length_field + hpack_encoding->size();
+  *length_field = *length_field + hpack_encoding.size();
   // If the HEADERS frame with payload would exceed the max frame size, then
   // WritePayloadWithContinuation() will serialize CONTINUATION frames as
   // necessary.
@@ -615,15 +615,22 @@ void SpdyFramer::SerializeHeadersBuilderHelper(const SpdyHeadersIR& headers,
 }
 
 SpdySerializedFrame SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers) {
+  SpdyString hpack_encoding;
+  GetHpackEncoder()->EncodeHeaderSet(headers.header_block(), &hpack_encoding);
+  return SerializeHeadersWithEncoding(headers, hpack_encoding);
+}
+
+SpdySerializedFrame SpdyFramer::SerializeHeadersWithEncoding(
+    const SpdyHeadersIR& headers,
+    const SpdyString& hpack_encoding) {
   uint8_t flags = 0;
   // The size of this frame, including padding (if there is any) and
   // variable-length header block.
   size_t size = 0;
-  SpdyString hpack_encoding;
   int weight = 0;
   size_t length_field = 0;
-  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding,
-                                &weight, &length_field);
+  SerializeHeadersBuilderHelper(headers, hpack_encoding, &flags, &size, &weight,
+                                &length_field);
 
   SpdyFrameBuilder builder(size);
   builder.BeginNewFrame(SpdyFrameType::HEADERS, flags, headers.stream_id(),
@@ -1062,10 +1069,11 @@ bool SpdyFramer::SerializeHeaders(const SpdyHeadersIR& headers,
   // variable-length header block.
   size_t size = 0;
   SpdyString hpack_encoding;
+  GetHpackEncoder()->EncodeHeaderSet(headers.header_block(), &hpack_encoding);
   int weight = 0;
   size_t length_field = 0;
-  SerializeHeadersBuilderHelper(headers, &flags, &size, &hpack_encoding,
-                                &weight, &length_field);
+  SerializeHeadersBuilderHelper(headers, hpack_encoding, &flags, &size, &weight,
+                                &length_field);
 
   bool ok = true;
   SpdyFrameBuilder builder(size, output);
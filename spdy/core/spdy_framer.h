@@ -120,6 +120,14 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
   // for sending headers.
   SpdySerializedFrame SerializeHeaders(const SpdyHeadersIR& headers);
 
+  // Serializes a HEADERS frame with |hpack_encoding| as its header block, in
+  // place of the header block of |headers|. |hpack_encoding| must not refer to
+  // the dynamic table, so that one encoding can be sent on any connection; see
+  // HpackEncoder::SetIndexingPolicy().
+  SpdySerializedFrame SerializeHeadersWithEncoding(
+      const SpdyHeadersIR& headers,
+      const SpdyString& hpack_encoding);
+
   // Serializes a PUSH_PROMISE frame. The PUSH_PROMISE frame is used
   // to inform the client that it will be receiving an additional stream
   // in response to the original request. The frame includes synthesized
@@ -372,9 +380,9 @@ class SPDY_EXPORT_PRIVATE SpdyFramer {
   static size_t GetNumberRequiredContinuationFrames(size_t size);
 
   void SerializeHeadersBuilderHelper(const SpdyHeadersIR& headers,
+                                     const SpdyString& hpack_encoding,
                                      uint8_t* flags,
                                      size_t* size,
-                                     SpdyString* hpack_encoding,
                                      int* weight,
                                      size_t* length_field);
   void SerializePushPromiseBuilderHelper(const SpdyPushPromiseIR& push_promise,
@@ -19,6 +19,7 @@
 #include "net/quic/platform/api/quic_flags.h"
 #include "net/spdy/core/array_output_buffer.h"
 #include "net/spdy/core/hpack/hpack_constants.h"
+#include "net/spdy/core/hpack/hpack_encoder.h"
 #include "net/spdy/core/mock_spdy_framer_visitor.h"
 #include "net/spdy/core/spdy_bitmasks.h"
 #include "net/spdy/core/spdy_frame_builder.h"
@@ -2742,6 +2743,35 @@ TEST_P(SpdyFramerTest, ReadCompressedHeadersHeaderBlockWithHalfClose) {
   EXPECT_EQ(headers_ir.header_block(), visitor.headers_);
 }
 
+TEST_P(SpdyFramerTest, ReadHeadersWithEncoding) {
+  SpdyHeaderBlock header_block;
+  header_block["alpha"] = "beta";
+  header_block["gamma"] = "delta";
+  HpackEncoder encoder(ObtainHpackHuffmanTable());
+  encoder.SetIndexingPolicy(
+      [](SpdyStringPiece /*name*/, SpdyStringPiece /*value*/) {
+        return false;
+      });
+  SpdyString encoding;
+  encoder.EncodeHeaderSet(header_block, &encoding);
+
+  // The same encoding can be sent repeatedly to one decoder.
+  TestSpdyVisitor visitor(SpdyFramer::ENABLE_COMPRESSION);
+  for (SpdyStreamId stream_id : {1, 3}) {
+    SpdyHeadersIR headers_ir(stream_id);
+    headers_ir.set_fin(true);
+    SpdySerializedFrame control_frame(
+        framer_.SerializeHeadersWithEncoding(headers_ir, encoding));
+    visitor.SimulateInFramer(
+        reinterpret_cast<unsigned char*>(control_frame.data()),
+        control_frame.size());
+    EXPECT_EQ(header_block, visitor.headers_);
+  }
+  EXPECT_EQ(2, visitor.headers_frame_count_);
+  EXPECT_EQ(2, visitor.end_of_stream_count_);
+  EXPECT_EQ(0, visitor.error_count_);
+}
+
 TEST_P(SpdyFramerTest, TooLargeHeadersFrameUsesContinuation) {
   SpdyFramer framer(SpdyFramer::DISABLE_COMPRESSION);
   SpdyHeadersIR headers(/* stream_id = */ 1);
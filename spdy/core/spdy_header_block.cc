@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <unordered_set>
 #include <utility>
 
 #include "base/logging.h"
@@ -15,6 +16,7 @@
 #include "net/base/arena.h"
 #include "net/http/http_log_util.h"
 #include "net/log/net_log_capture_mode.h"
+#include "net/spdy/core/hpack/hpack_constants.h"
 #include "net/spdy/platform/api/spdy_estimate_memory_usage.h"
 #include "net/spdy/platform/api/spdy_ptr_util.h"
 #include "net/spdy/platform/api/spdy_string_utils.h"
@@ -22,13 +24,17 @@
 namespace net {
 namespace {
 
-// By default, linked_hash_map's internal map allocates space for 100 map
-// buckets on construction, which is larger than necessary.  Standard library
-// unordered map implementations use a list of prime numbers to set the bucket
-// count for a particular capacity.  |kInitialMapBuckets| is chosen to reduce
-// memory usage for small header blocks, at the cost of having to rehash for
-// large header blocks.
-const size_t kInitialMapBuckets = 11;
+// Blocks with up to this many entries are searched linearly, which is
+// cheaper than hashing the key for the handful of headers most blocks hold.
+// Larger blocks are searched through |index_|.
+const size_t kMaxLinearSearchEntries = 16;
+
+// Space for this many entries is reserved when the first one is added, so that
+// typical blocks are built without reallocating |entries_|.
+const size_t kInitialEntriesCapacity = 8;
+
+// The longest name in the HPACK static table, "access-control-allow-origin".
+const size_t kMaxStaticNameLength = 27;
 
 // SpdyHeaderBlock::Storage allocates blocks of this size by default.
 const size_t kDefaultStorageBlockSize = 2048;
@@ -45,8 +51,36 @@ SpdyStringPiece SeparatorForKey(SpdyStringPiece key) {
   }
 }
 
+typedef std::unordered_set<SpdyStringPiece, base::StringPieceHash> NameSet;
+
+// The names of the HPACK static table entries. They refer to string literals,
+// so they outlive every SpdyHeaderBlock.
+const NameSet* CreateStaticNames() {
+  NameSet* names = new NameSet;
+  for (const HpackStaticEntry& entry : HpackStaticTableVector()) {
+    names->insert(SpdyStringPiece(entry.name, entry.name_len));
+  }
+  return names;
+}
+
+// Returns the copy of |key| held by the HPACK static table, or an empty
+// SpdyStringPiece if |key| is not the name of a static entry.
+SpdyStringPiece InternedKey(SpdyStringPiece key) {
+  if (key.empty() || key.size() > kMaxStaticNameLength) {
+    return SpdyStringPiece();
+  }
+  static const NameSet* const static_names = CreateStaticNames();
+  auto it = static_names->find(key);
+  if (it == static_names->end()) {
+    return SpdyStringPiece();
+  }
+  return *it;
+}
+
 }  // namespace
 
+const size_t SpdyHeaderBlock::kNotFound = static_cast<size_t>(-1);
+
 // This class provides a backing store for SpdyStringPieces. It previously used
 // custom allocation logic, but now uses an UnsafeArena instead. It has the
 // property that SpdyStringPieces that refer to data in Storage are never
@@ -106,7 +140,7 @@ class SpdyHeaderBlock::Storage {
 SpdyHeaderBlock::HeaderValue::HeaderValue(Storage* storage,
                                           SpdyStringPiece key,
                                           SpdyStringPiece initial_value)
-    : storage_(storage), fragments_({initial_value}), pair_({key, {}}) {}
+    : storage_(storage), pair_({key, initial_value}) {}
 
 SpdyHeaderBlock::HeaderValue::HeaderValue(HeaderValue&& other)
     : storage_(other.storage_),
@@ -124,17 +158,18 @@ SpdyHeaderBlock::HeaderValue& SpdyHeaderBlock::HeaderValue::operator=(
 SpdyHeaderBlock::HeaderValue::~HeaderValue() = default;
 
 SpdyStringPiece SpdyHeaderBlock::HeaderValue::ConsolidatedValue() const {
-  if (fragments_.empty()) {
-    return SpdyStringPiece();
-  }
-  if (fragments_.size() > 1) {
-    fragments_ = {
-        storage_->WriteFragments(fragments_, SeparatorForKey(pair_.first))};
+  if (!fragments_.empty()) {
+    pair_.second =
+        storage_->WriteFragments(fragments_, SeparatorForKey(pair_.first));
+    fragments_.clear();
   }
-  return fragments_[0];
+  return pair_.second;
 }
 
 void SpdyHeaderBlock::HeaderValue::Append(SpdyStringPiece fragment) {
+  if (fragments_.empty()) {
+    fragments_.push_back(pair_.second);
+  }
   fragments_.push_back(fragment);
 }
 
@@ -144,26 +179,19 @@ SpdyHeaderBlock::HeaderValue::as_pair() const {
   return pair_;
 }
 
-SpdyHeaderBlock::iterator::iterator(MapType::const_iterator it) : it_(it) {}
+SpdyHeaderBlock::iterator::iterator(EntryList::const_iterator it) : it_(it) {}
 
 SpdyHeaderBlock::iterator::iterator(const iterator& other) = default;
 
 SpdyHeaderBlock::iterator::~iterator() = default;
 
-SpdyHeaderBlock::ValueProxy::ValueProxy(
-    SpdyHeaderBlock::MapType* block,
-    SpdyHeaderBlock::Storage* storage,
-    SpdyHeaderBlock::MapType::iterator lookup_result,
-    const SpdyStringPiece key)
-    : block_(block),
-      storage_(storage),
-      lookup_result_(lookup_result),
-      key_(key),
-      valid_(true) {}
+SpdyHeaderBlock::ValueProxy::ValueProxy(SpdyHeaderBlock* block,
+                                        size_t lookup_result,
+                                        const SpdyStringPiece key)
+    : block_(block), lookup_result_(lookup_result), key_(key), valid_(true) {}
 
 SpdyHeaderBlock::ValueProxy::ValueProxy(ValueProxy&& other)
     : block_(other.block_),
-      storage_(other.storage_),
       lookup_result_(other.lookup_result_),
       key_(other.key_),
       valid_(true) {
@@ -173,7 +201,6 @@ SpdyHeaderBlock::ValueProxy::ValueProxy(ValueProxy&& other)
 SpdyHeaderBlock::ValueProxy& SpdyHeaderBlock::ValueProxy::operator=(
     SpdyHeaderBlock::ValueProxy&& other) {
   block_ = other.block_;
-  storage_ = other.storage_;
   lookup_result_ = other.lookup_result_;
   key_ = other.key_;
   valid_ = true;
@@ -182,54 +209,60 @@ SpdyHeaderBlock::ValueProxy& SpdyHeaderBlock::ValueProxy::operator=(
 }
 
 SpdyHeaderBlock::ValueProxy::~ValueProxy() {
-  // If the ValueProxy is destroyed while lookup_result_ == block_->end(),
-  // the assignment operator was never used, and the block's Storage can
-  // reclaim the memory used by the key. This makes lookup-only access to
-  // SpdyHeaderBlock through operator[] memory-neutral.
-  if (valid_ && lookup_result_ == block_->end()) {
-    storage_->Rewind(key_);
+  // If the ValueProxy is destroyed while lookup_result_ == kNotFound, the
+  // assignment operator was never used, and the block's Storage can reclaim
+  // the memory used by the key. This makes lookup-only access to
+  // SpdyHeaderBlock through operator[] memory-neutral. Rewinding is a no-op
+  // for a key held by the HPACK static table, which may not have needed any
+  // Storage.
+  if (valid_ && lookup_result_ == kNotFound && block_->storage_ != nullptr) {
+    block_->storage_->Rewind(key_);
   }
 }
 
 SpdyHeaderBlock::ValueProxy& SpdyHeaderBlock::ValueProxy::operator=(
     const SpdyStringPiece value) {
-  if (lookup_result_ == block_->end()) {
+  if (lookup_result_ == kNotFound) {
+    DCHECK_EQ(kNotFound, block_->FindIndex(key_));
     DVLOG(1) << "Inserting: (" << key_ << ", " << value << ")";
-    lookup_result_ =
-        block_
-            ->emplace(std::make_pair(
-                key_, HeaderValue(storage_, key_, storage_->Write(value))))
-            .first;
+    lookup_result_ = block_->size();
+    block_->AddEntry(key_, value);
   } else {
+    DCHECK_LT(lookup_result_, block_->size());
+    DCHECK_EQ(key_, block_->entries_[lookup_result_].key());
     DVLOG(1) << "Updating key: " << key_ << " with value: " << value;
-    lookup_result_->second =
-        HeaderValue(storage_, key_, storage_->Write(value));
+    Storage* storage = block_->GetStorage();
+    block_->entries_[lookup_result_] =
+        HeaderValue(storage, key_, storage->Write(value));
   }
   return *this;
 }
 
 SpdyString SpdyHeaderBlock::ValueProxy::as_string() const {
-  if (lookup_result_ == block_->end()) {
+  if (lookup_result_ == kNotFound) {
     return "";
   } else {
-    return SpdyString(lookup_result_->second.value());
+    DCHECK_LT(lookup_result_, block_->size());
+    return SpdyString(block_->entries_[lookup_result_].value());
   }
 }
 
-SpdyHeaderBlock::SpdyHeaderBlock() : block_(kInitialMapBuckets) {}
+SpdyHeaderBlock::SpdyHeaderBlock() = default;
 
 SpdyHeaderBlock::SpdyHeaderBlock(SpdyHeaderBlock&& other) = default;
 
 SpdyHeaderBlock::~SpdyHeaderBlock() = default;
 
 SpdyHeaderBlock& SpdyHeaderBlock::operator=(SpdyHeaderBlock&& other) {
-  block_.swap(other.block_);
+  entries_.swap(other.entries_);
+  index_.swap(other.index_);
   storage_.swap(other.storage_);
   return *this;
 }
 
 SpdyHeaderBlock SpdyHeaderBlock::Clone() const {
   SpdyHeaderBlock copy;
+  copy.entries_.reserve(entries_.size());
   for (const auto& p : *this) {
     copy.AppendHeader(p.first, p.second);
   }
@@ -257,23 +290,37 @@ SpdyString SpdyHeaderBlock::DebugString() const {
   return output;
 }
 
+void SpdyHeaderBlock::erase(SpdyStringPiece key) {
+  size_t index = FindIndex(key);
+  if (index == kNotFound) {
+    return;
+  }
+  entries_.erase(entries_.begin() + index);
+  // Positions after |index| have shifted.
+  index_.reset();
+  if (entries_.size() > kMaxLinearSearchEntries) {
+    RebuildIndex();
+  }
+}
+
 void SpdyHeaderBlock::clear() {
-  block_.clear();
+  entries_.clear();
+  index_.reset();
   storage_.reset();
 }
 
 void SpdyHeaderBlock::insert(const SpdyHeaderBlock::value_type& value) {
   // TODO(birenroy): Write new value in place of old value, if it fits.
-  auto iter = block_.find(value.first);
-  if (iter == block_.end()) {
+  size_t index = FindIndex(value.first);
+  if (index == kNotFound) {
     DVLOG(1) << "Inserting: (" << value.first << ", " << value.second << ")";
     AppendHeader(value.first, value.second);
   } else {
-    DVLOG(1) << "Updating key: " << iter->first
+    HeaderValue& entry = entries_[index];
+    DVLOG(1) << "Updating key: " << entry.key()
              << " with value: " << value.second;
     auto* storage = GetStorage();
-    iter->second =
-        HeaderValue(storage, iter->first, storage->Write(value.second));
+    entry = HeaderValue(storage, entry.key(), storage->Write(value.second));
   }
 }
 
@@ -281,44 +328,92 @@ SpdyHeaderBlock::ValueProxy SpdyHeaderBlock::operator[](
     const SpdyStringPiece key) {
   DVLOG(2) << "Operator[] saw key: " << key;
   SpdyStringPiece out_key;
-  auto iter = block_.find(key);
-  if (iter == block_.end()) {
+  size_t index = FindIndex(key);
+  if (index == kNotFound) {
     // We write the key first, to assure that the ValueProxy has a
     // reference to a valid SpdyStringPiece in its operator=.
-    out_key = GetStorage()->Write(key);
+    out_key = WriteKey(key);
     DVLOG(2) << "Key written as: " << std::hex
              << static_cast<const void*>(key.data()) << ", " << std::dec
              << key.size();
   } else {
-    out_key = iter->first;
+    out_key = entries_[index].key();
   }
-  return ValueProxy(&block_, GetStorage(), iter, out_key);
+  return ValueProxy(this, index, out_key);
 }
 
 void SpdyHeaderBlock::AppendValueOrAddHeader(const SpdyStringPiece key,
                                              const SpdyStringPiece value) {
-  auto iter = block_.find(key);
-  if (iter == block_.end()) {
+  size_t index = FindIndex(key);
+  if (index == kNotFound) {
     DVLOG(1) << "Inserting: (" << key << ", " << value << ")";
     AppendHeader(key, value);
     return;
   }
-  DVLOG(1) << "Updating key: " << iter->first << "; appending value: " << value;
-  iter->second.Append(GetStorage()->Write(value));
+  HeaderValue& entry = entries_[index];
+  DVLOG(1) << "Updating key: " << entry.key() << "; appending value: " << value;
+  entry.Append(GetStorage()->Write(value));
 }
 
 size_t SpdyHeaderBlock::EstimateMemoryUsage() const {
-  // TODO(xunjieli): https://crbug.com/669108. Also include |block_| when EMU()
-  // supports linked_hash_map.
-  return SpdyEstimateMemoryUsage(storage_);
+  // TODO(xunjieli): https://crbug.com/669108. Also include |entries_| when
+  // EMU() supports HeaderValue.
+  return SpdyEstimateMemoryUsage(storage_) + SpdyEstimateMemoryUsage(index_);
+}
+
+size_t SpdyHeaderBlock::FindIndex(SpdyStringPiece key) const {
+  if (index_ != nullptr) {
+    auto it = index_->find(key);
+    return it == index_->end() ? kNotFound : it->second;
+  }
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].key() == key) {
+      return i;
+    }
+  }
+  return kNotFound;
+}
+
+SpdyHeaderBlock::const_iterator SpdyHeaderBlock::IteratorAt(
+    size_t index) const {
+  if (index == kNotFound) {
+    return end();
+  }
+  return const_iterator(entries_.begin() + index);
+}
+
+SpdyStringPiece SpdyHeaderBlock::WriteKey(SpdyStringPiece key) {
+  SpdyStringPiece interned_key = InternedKey(key);
+  if (!interned_key.empty()) {
+    return interned_key;
+  }
+  return GetStorage()->Write(key);
 }
 
 void SpdyHeaderBlock::AppendHeader(const SpdyStringPiece key,
                                    const SpdyStringPiece value) {
+  AddEntry(WriteKey(key), value);
+}
+
+void SpdyHeaderBlock::AddEntry(SpdyStringPiece backed_key,
+                               SpdyStringPiece value) {
   auto* storage = GetStorage();
-  auto backed_key = storage->Write(key);
-  block_.emplace(std::make_pair(
-      backed_key, HeaderValue(storage, backed_key, storage->Write(value))));
+  if (entries_.empty()) {
+    entries_.reserve(kInitialEntriesCapacity);
+  }
+  entries_.emplace_back(storage, backed_key, storage->Write(value));
+  if (index_ != nullptr) {
+    index_->emplace(backed_key, entries_.size() - 1);
+  } else if (entries_.size() > kMaxLinearSearchEntries) {
+    RebuildIndex();
+  }
+}
+
+void SpdyHeaderBlock::RebuildIndex() {
+  index_ = SpdyMakeUnique<NameIndex>(entries_.size());
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    index_->emplace(entries_[i].key(), i);
+  }
 }
 
 SpdyHeaderBlock::Storage* SpdyHeaderBlock::GetStorage() {
@@ -7,14 +7,13 @@
 
 #include <stddef.h>
 
-#include <list>
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "base/macros.h"
-#include "net/base/linked_hash_map.h"
+#include "base/strings/string_piece.h"
 #include "net/log/net_log.h"
 #include "net/spdy/platform/api/spdy_export.h"
 #include "net/spdy/platform/api/spdy_string.h"
@@ -36,11 +35,20 @@ class ValueProxyPeer;
 // This class provides a key-value map that can be used to store SPDY header
 // names and values. This data structure preserves insertion order.
 //
-// Under the hood, this data structure uses large, contiguous blocks of memory
-// to store names and values. Lookups may be performed with SpdyStringPiece
-// keys, and values are returned as SpdyStringPieces (via ValueProxy, below).
-// Value SpdyStringPieces are valid as long as the SpdyHeaderBlock exists;
-// allocated memory is never freed until SpdyHeaderBlock's destruction.
+// Under the hood, this data structure keeps its headers in a vector, and uses
+// large, contiguous blocks of memory to store names and values. Names of
+// entries in the HPACK static table are not copied, but refer to that table.
+// Small blocks are searched linearly, and larger ones through an index of
+// names. Lookups may be performed with SpdyStringPiece keys, and values are
+// returned as SpdyStringPieces (via ValueProxy, below). Value SpdyStringPieces
+// are valid as long as the SpdyHeaderBlock exists; allocated memory is never
+// freed until SpdyHeaderBlock's destruction.
+//
+// Adding an entry may reallocate the vector, so insert(),
+// AppendValueOrAddHeader() and assigning through a ValueProxy invalidate all
+// iterators, and the pairs they refer to, unless the key was already present.
+// erase() and clear() invalidate all iterators. Value SpdyStringPieces are not
+// affected by any of these.
 //
 // This implementation does not make much of an effort to minimize wasted space.
 // It's expected that keys are rarely deleted from a SpdyHeaderBlock.
@@ -48,8 +56,8 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
  private:
   class Storage;
 
-  // Stores a list of value fragments that can be joined later with a
-  // key-dependent separator.
+  // Stores a value, or a list of value fragments that can be joined later with
+  // a key-dependent separator. A value of a single fragment needs no list.
   class SPDY_EXPORT_PRIVATE HeaderValue {
    public:
     HeaderValue(Storage* storage,
@@ -69,6 +77,7 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     // Consumes at most |fragment.size()| bytes of memory.
     void Append(SpdyStringPiece fragment);
 
+    SpdyStringPiece key() const { return pair_.first; }
     SpdyStringPiece value() const { return as_pair().second; }
     const std::pair<SpdyStringPiece, SpdyStringPiece>& as_pair() const;
 
@@ -78,19 +87,22 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     SpdyStringPiece ConsolidatedValue() const;
 
     mutable Storage* storage_;
+    // Empty unless fragments have been appended since the value was last
+    // consolidated.
     mutable std::vector<SpdyStringPiece> fragments_;
     // The first element is the key; the second is the consolidated value.
     mutable std::pair<SpdyStringPiece, SpdyStringPiece> pair_;
   };
 
-  typedef linked_hash_map<SpdyStringPiece, HeaderValue, base::StringPieceHash>
-      MapType;
+  typedef std::vector<HeaderValue> EntryList;
+  typedef std::unordered_map<SpdyStringPiece, size_t, base::StringPieceHash>
+      NameIndex;
 
  public:
   typedef std::pair<SpdyStringPiece, SpdyStringPiece> value_type;
 
   // Provides iteration over a sequence of std::pair<SpdyStringPiece,
-  // SpdyStringPiece>, even though the underlying MapType::value_type is
+  // SpdyStringPiece>, even though the underlying EntryList::value_type is
   // different. Dereferencing the iterator will result in memory allocation for
   // multi-value headers.
   class SPDY_EXPORT_PRIVATE iterator {
@@ -101,19 +113,19 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     typedef value_type& reference;
     typedef value_type* pointer;
     typedef std::forward_iterator_tag iterator_category;
-    typedef MapType::iterator::difference_type difference_type;
+    typedef EntryList::iterator::difference_type difference_type;
 
     // In practice, this iterator only offers access to const value_type.
     typedef const value_type& const_reference;
     typedef const value_type* const_pointer;
 
-    explicit iterator(MapType::const_iterator it);
+    explicit iterator(EntryList::const_iterator it);
     iterator(const iterator& other);
     ~iterator();
 
     // This will result in memory allocation if the value consists of multiple
     // fragments.
-    const_reference operator*() const { return it_->second.as_pair(); }
+    const_reference operator*() const { return it_->as_pair(); }
 
     const_pointer operator->() const { return &(this->operator*()); }
     bool operator==(const iterator& it) const { return it_ == it.it_; }
@@ -131,7 +143,7 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     }
 
    private:
-    MapType::const_iterator it_;
+    EntryList::const_iterator it_;
   };
   typedef iterator const_iterator;
 
@@ -153,19 +165,19 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
   // keys and values.
   SpdyString DebugString() const;
 
-  iterator begin() { return iterator(block_.begin()); }
-  iterator end() { return iterator(block_.end()); }
-  const_iterator begin() const { return const_iterator(block_.begin()); }
-  const_iterator end() const { return const_iterator(block_.end()); }
-  bool empty() const { return block_.empty(); }
-  size_t size() const { return block_.size(); }
-  iterator find(SpdyStringPiece key) { return iterator(block_.find(key)); }
+  iterator begin() { return iterator(entries_.begin()); }
+  iterator end() { return iterator(entries_.end()); }
+  const_iterator begin() const { return const_iterator(entries_.begin()); }
+  const_iterator end() const { return const_iterator(entries_.end()); }
+  bool empty() const { return entries_.empty(); }
+  size_t size() const { return entries_.size(); }
+  iterator find(SpdyStringPiece key) { return IteratorAt(FindIndex(key)); }
   const_iterator find(SpdyStringPiece key) const {
-    return const_iterator(block_.find(key));
+    return IteratorAt(FindIndex(key));
   }
-  void erase(SpdyStringPiece key) { block_.erase(key); }
+  void erase(SpdyStringPiece key);
 
-  // Clears both our MapType member and the memory used to hold headers.
+  // Clears both our EntryList member and the memory used to hold headers.
   void clear();
 
   // The next few methods copy data into our backing storage.
@@ -187,6 +199,11 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
   // This object provides automatic conversions that allow SpdyHeaderBlock to be
   // nearly a drop-in replacement for linked_hash_map<SpdyString, SpdyString>.
   // It reads data from or writes data to a SpdyHeaderBlock::Storage.
+  //
+  // A ValueProxy refers to its entry by position. It stays valid while entries
+  // are added to or updated in the block, but erase() and clear() invalidate
+  // it. A ValueProxy for a missing key must not be assigned once that key has
+  // been added to the block by other means.
   class SPDY_EXPORT_PRIVATE ValueProxy {
    public:
     ~ValueProxy();
@@ -208,14 +225,13 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
     friend class SpdyHeaderBlock;
     friend class test::ValueProxyPeer;
 
-    ValueProxy(SpdyHeaderBlock::MapType* block,
-               SpdyHeaderBlock::Storage* storage,
-               SpdyHeaderBlock::MapType::iterator lookup_result,
+    ValueProxy(SpdyHeaderBlock* block,
+               size_t lookup_result,
                const SpdyStringPiece key);
 
-    SpdyHeaderBlock::MapType* block_;
-    SpdyHeaderBlock::Storage* storage_;
-    SpdyHeaderBlock::MapType::iterator lookup_result_;
+    SpdyHeaderBlock* block_;
+    // The position of |key_| within |block_|, or kNotFound.
+    size_t lookup_result_;
     SpdyStringPiece key_;
     bool valid_;
   };
@@ -226,13 +242,31 @@ class SPDY_EXPORT_PRIVATE SpdyHeaderBlock {
  private:
   friend class test::SpdyHeaderBlockPeer;
 
+  // Returned by FindIndex() for a key which is not in the block.
+  static const size_t kNotFound;
+
+  // Returns the position of the entry for |key|, or kNotFound.
+  size_t FindIndex(SpdyStringPiece key) const;
+  const_iterator IteratorAt(size_t index) const;
+
+  // Returns |key| backed by the HPACK static table if it is one of its names,
+  // or else by |*storage_|.
+  SpdyStringPiece WriteKey(SpdyStringPiece key);
+
   void AppendHeader(const SpdyStringPiece key, const SpdyStringPiece value);
+  // Adds an entry, whose key must already be backed by WriteKey().
+  void AddEntry(SpdyStringPiece backed_key, SpdyStringPiece value);
+  void RebuildIndex();
   Storage* GetStorage();
   size_t bytes_allocated() const;
 
-  // SpdyStringPieces held by |block_| point to memory owned by |*storage_|.
-  // |storage_| might be nullptr as long as |block_| is empty.
-  MapType block_;
+  // SpdyStringPieces held by |entries_| point to memory owned by |*storage_|,
+  // or to the HPACK static table. |storage_| might be nullptr as long as
+  // |entries_| is empty.
+  EntryList entries_;
+  // Maps keys to their positions in |entries_|. Only built once the block has
+  // more entries than are worth searching linearly.
+  std::unique_ptr<NameIndex> index_;
   std::unique_ptr<Storage> storage_;
 };
 
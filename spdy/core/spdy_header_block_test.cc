@@ -10,6 +10,7 @@
 #include "base/values.h"
 #include "net/log/net_log_capture_mode.h"
 #include "net/spdy/core/spdy_test_utils.h"
+#include "net/spdy/platform/api/spdy_string_utils.h"
 #include "testing/gmock/include/gmock/gmock.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -180,6 +181,103 @@ TEST(SpdyHeaderBlockTest, AppendHeaders) {
   EXPECT_EQ("singleton", block["h4"]);
 }
 
+// This test verifies that names of HPACK static table entries are shared by
+// all blocks, rather than copied into each.
+TEST(SpdyHeaderBlockTest, StaticNamesAreInterned) {
+  SpdyHeaderBlock block1;
+  block1[":method"] = "GET";
+  block1["user-agent"] = "foo";
+  block1["x-custom"] = "bar";
+
+  SpdyHeaderBlock block2 = block1.Clone();
+  EXPECT_EQ(block1, block2);
+  EXPECT_EQ(block1.find(":method")->first.data(),
+            block2.find(":method")->first.data());
+  EXPECT_EQ(block1.find("user-agent")->first.data(),
+            block2.find("user-agent")->first.data());
+  EXPECT_NE(block1.find("x-custom")->first.data(),
+            block2.find("x-custom")->first.data());
+
+  // Interned names can be looked up, replaced, appended to and erased like
+  // any other.
+  block2.AppendValueOrAddHeader("user-agent", "baz");
+  EXPECT_EQ(Pair("user-agent", SpdyString("foo\0baz", 7)),
+            *block2.find("user-agent"));
+  block2.erase(":method");
+  EXPECT_THAT(block2, ElementsAre(Pair("user-agent", SpdyString("foo\0baz", 7)),
+                                  Pair("x-custom", "bar")));
+}
+
+// This test verifies that blocks too large to be searched linearly preserve
+// insertion order and lookups, including across erasures.
+TEST(SpdyHeaderBlockTest, LargeBlock) {
+  const int kNumHeaders = 40;
+  SpdyHeaderBlock block;
+  for (int i = 0; i < kNumHeaders; ++i) {
+    block[SpdyStrCat("key", i)] = SpdyStrCat("value", i);
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumHeaders), block.size());
+
+  // Erase every other header, from the front.
+  for (int i = 0; i < kNumHeaders; i += 2) {
+    block.erase(SpdyStrCat("key", i));
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumHeaders / 2), block.size());
+
+  int i = 1;
+  for (const auto& header : block) {
+    EXPECT_EQ(Pair(SpdyStrCat("key", i), SpdyStrCat("value", i)), header);
+    i += 2;
+  }
+  for (i = 0; i < kNumHeaders; ++i) {
+    SpdyString key = SpdyStrCat("key", i);
+    if (i % 2 == 0) {
+      EXPECT_TRUE(block.find(key) == block.end()) << key;
+    } else {
+      EXPECT_EQ(Pair(key, SpdyStrCat("value", i)), *block.find(key));
+    }
+  }
+
+  block.AppendValueOrAddHeader("key1", "more");
+  EXPECT_EQ(SpdyString("value1\0more", 11), block["key1"]);
+  block["key0"] = "again";
+  EXPECT_EQ(kNumHeaders / 2 + 1u, block.size());
+  EXPECT_EQ("again", block["key0"]);
+}
+
+// This test pins the invalidation rules documented in the header: ValueProxy
+// objects and values survive the block growing, and entries can be found
+// again after an erase.
+TEST(SpdyHeaderBlockTest, ValueProxySurvivesInsertions) {
+  const int kNumHeaders = 40;
+  SpdyHeaderBlock block;
+  block["foo"] = "bar";
+  auto proxy = block["foo"];
+  auto absent_proxy = block["absent"];
+  SpdyStringPiece value = block.find("foo")->second;
+
+  // Grow the block past linear search, reallocating its entries.
+  for (int i = 0; i < kNumHeaders; ++i) {
+    block[SpdyStrCat("key", i)] = SpdyStrCat("value", i);
+  }
+  EXPECT_EQ("bar", value);
+  EXPECT_EQ("bar", proxy.as_string());
+
+  proxy = "baz";
+  absent_proxy = "present";
+  EXPECT_EQ(kNumHeaders + 2u, block.size());
+  EXPECT_EQ("baz", block["foo"]);
+  EXPECT_EQ("present", block["absent"]);
+  EXPECT_EQ("bar", value);
+
+  // Erasing invalidates iterators, but lookups still work.
+  value = block.find("foo")->second;
+  block.erase("key0");
+  EXPECT_EQ(Pair("foo", "baz"), *block.find("foo"));
+  EXPECT_EQ(Pair("absent", "present"), *block.find("absent"));
+  EXPECT_EQ("baz", value);
+}
+
 TEST(JoinTest, JoinEmpty) {
   std::vector<SpdyStringPiece> empty;
   SpdyStringPiece separator = ", ";
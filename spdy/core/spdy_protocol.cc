@@ -133,6 +133,9 @@ bool ParseSettingsId(uint16_t wire_setting_id, SpdySettingsIds* setting_id) {
   if (wire_setting_id < SETTINGS_MIN || wire_setting_id > SETTINGS_MAX) {
     return false;
   }
+  // 0x7 is not assigned.
+  if (wire_setting_id == 0x7)
+    return false;
 
   *setting_id = static_cast<SpdySettingsIds>(wire_setting_id);
   return true;
@@ -158,6 +161,9 @@ bool SettingsIdToString(SpdySettingsIds id, const char** settings_id_string) {
     case SETTINGS_MAX_HEADER_LIST_SIZE:
       *settings_id_string = "SETTINGS_MAX_HEADER_LIST_SIZE";
       return true;
+    case SETTINGS_ENABLE_CONNECT_PROTOCOL:
+      *settings_id_string = "SETTINGS_ENABLE_CONNECT_PROTOCOL";
+      return true;
   }
 
   *settings_id_string = "SETTINGS_UNKNOWN";
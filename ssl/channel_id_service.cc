@@ -22,6 +22,7 @@
 #include "base/rand_util.h"
 #include "base/single_thread_task_runner.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "base/task_scheduler/post_task.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "crypto/ec_private_key.h"
@@ -62,6 +63,10 @@ enum GetChannelIDResult {
   TYPE_MISMATCH = 9,
   // Couldn't start a worker to generate a cert.
   WORKER_FAILURE = 10,
+  // Synchronously created a channel ID with a key from the pool.
+  SYNC_SUCCESS_FROM_POOL = 11,
+  // Asynchronously created a channel ID with a key from the pool.
+  ASYNC_SUCCESS_FROM_POOL = 12,
   GET_CHANNEL_ID_RESULT_MAX
 };
 
@@ -94,6 +99,11 @@ std::unique_ptr<ChannelIDStore::ChannelID> GenerateChannelID(
   return result;
 }
 
+// Generates a key for the pool. Runs on a worker thread.
+std::unique_ptr<crypto::ECPrivateKey> GeneratePooledKey() {
+  return crypto::ECPrivateKey::Create();
+}
+
 }  // namespace
 
 // ChannelIDServiceWorker takes care of the blocking process of performing key
@@ -161,8 +171,10 @@ class ChannelIDServiceJob {
     requests_.push_back(request);
   }
 
-  void HandleResult(int error, std::unique_ptr<crypto::ECPrivateKey> key) {
-    PostAll(error, std::move(key));
+  void HandleResult(int error,
+                    std::unique_ptr<crypto::ECPrivateKey> key,
+                    bool key_from_pool) {
+    PostAll(error, std::move(key), key_from_pool);
   }
 
   bool CreateIfMissing() const { return create_if_missing_; }
@@ -174,7 +186,9 @@ class ChannelIDServiceJob {
   }
 
  private:
-  void PostAll(int error, std::unique_ptr<crypto::ECPrivateKey> key) {
+  void PostAll(int error,
+               std::unique_ptr<crypto::ECPrivateKey> key,
+               bool key_from_pool) {
     std::vector<ChannelIDService::Request*> requests;
     requests_.swap(requests);
 
@@ -183,7 +197,7 @@ class ChannelIDServiceJob {
       std::unique_ptr<crypto::ECPrivateKey> key_copy;
       if (key)
         key_copy = key->Copy();
-      (*i)->Post(error, std::move(key_copy));
+      (*i)->Post(error, std::move(key_copy), key_from_pool);
     }
   }
 
@@ -222,10 +236,12 @@ void ChannelIDService::Request::RequestStarted(
 
 void ChannelIDService::Request::Post(
     int error,
-    std::unique_ptr<crypto::ECPrivateKey> key) {
+    std::unique_ptr<crypto::ECPrivateKey> key,
+    bool key_from_pool) {
   switch (error) {
     case OK: {
-      RecordGetChannelIDResult(ASYNC_SUCCESS);
+      RecordGetChannelIDResult(key_from_pool ? ASYNC_SUCCESS_FROM_POOL
+                                             : ASYNC_SUCCESS);
       break;
     }
     case ERR_KEY_GENERATION_FAILED:
@@ -254,16 +270,27 @@ void ChannelIDService::Request::Post(
 ChannelIDService::ChannelIDService(ChannelIDStore* channel_id_store)
     : channel_id_store_(channel_id_store),
       id_(g_next_id.GetNext()),
+      key_pool_size_(0),
+      pooled_keys_pending_(0),
       requests_(0),
       key_store_hits_(0),
       inflight_joins_(0),
       workers_created_(0),
+      pooled_keys_used_(0),
       weak_ptr_factory_(this) {}
 
 ChannelIDService::~ChannelIDService() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
 }
 
+void ChannelIDService::SetKeyPoolSize(size_t size) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  key_pool_size_ = size;
+  if (key_pool_.size() > size)
+    key_pool_.resize(size);
+  FillKeyPool();
+}
+
 // static
 std::string ChannelIDService::GetDomainForHost(const std::string& host) {
   std::string domain =
@@ -304,7 +331,15 @@ int ChannelIDService::GetOrCreateChannelID(
 
   int err = LookupChannelID(domain, key, create_if_missing, callback, out_req);
   if (err == ERR_FILE_NOT_FOUND) {
-    // Sync lookup did not find a valid channel ID.  Start generating a new one.
+    // Sync lookup did not find a valid channel ID. Use a spare key if there is
+    // one, otherwise start generating a new one.
+    std::unique_ptr<crypto::ECPrivateKey> pooled_key = TakeKeyFromPool(domain);
+    if (pooled_key) {
+      RecordGetChannelIDResult(SYNC_SUCCESS_FROM_POOL);
+      *key = std::move(pooled_key);
+      return OK;
+    }
+
     workers_created_++;
     ChannelIDServiceWorker* worker = new ChannelIDServiceWorker(
         domain,
@@ -370,18 +405,24 @@ void ChannelIDService::GotChannelID(int err,
     // Async DB lookup found a valid channel ID.
     key_store_hits_++;
     // ChannelIDService::Request::Post will do the histograms and stuff.
-    HandleResult(OK, server_identifier, std::move(key));
+    HandleResult(OK, server_identifier, std::move(key), false);
     return;
   }
   // Async lookup failed or the channel ID was missing. Return the error
   // directly, unless the channel ID was missing and a request asked to create
   // one.
   if (err != ERR_FILE_NOT_FOUND || !j->second->CreateIfMissing()) {
-    HandleResult(err, server_identifier, std::move(key));
+    HandleResult(err, server_identifier, std::move(key), false);
+    return;
+  }
+  // At least one request asked to create a channel ID => use a spare key or
+  // start generating a new one.
+  std::unique_ptr<crypto::ECPrivateKey> pooled_key =
+      TakeKeyFromPool(server_identifier);
+  if (pooled_key) {
+    HandleResult(OK, server_identifier, std::move(pooled_key), true);
     return;
   }
-  // At least one request asked to create a channel ID => start generating a new
-  // one.
   workers_created_++;
   ChannelIDServiceWorker* worker = new ChannelIDServiceWorker(
       server_identifier,
@@ -405,12 +446,13 @@ void ChannelIDService::GeneratedChannelID(
     key = channel_id->key()->Copy();
     channel_id_store_->SetChannelID(std::move(channel_id));
   }
-  HandleResult(error, server_identifier, std::move(key));
+  HandleResult(error, server_identifier, std::move(key), false);
 }
 
 void ChannelIDService::HandleResult(int error,
                                     const std::string& server_identifier,
-                                    std::unique_ptr<crypto::ECPrivateKey> key) {
+                                    std::unique_ptr<crypto::ECPrivateKey> key,
+                                    bool key_from_pool) {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
 
   auto j = inflight_.find(server_identifier);
@@ -421,7 +463,7 @@ void ChannelIDService::HandleResult(int error,
   std::unique_ptr<ChannelIDServiceJob> job = std::move(j->second);
   inflight_.erase(j);
 
-  job->HandleResult(error, std::move(key));
+  job->HandleResult(error, std::move(key), key_from_pool);
 }
 
 bool ChannelIDService::JoinToInFlightRequest(
@@ -478,6 +520,49 @@ int ChannelIDService::LookupChannelID(
   return err;
 }
 
+void ChannelIDService::FillKeyPool() {
+  while (key_pool_.size() + pooled_keys_pending_ < key_pool_size_) {
+    pooled_keys_pending_++;
+    auto reply = base::Bind(&ChannelIDService::PooledKeyGenerated,
+                            weak_ptr_factory_.GetWeakPtr());
+    if (task_runner_) {
+      base::PostTaskAndReplyWithResult(task_runner_.get(), FROM_HERE,
+                                       base::Bind(&GeneratePooledKey), reply);
+    } else {
+      base::PostTaskWithTraitsAndReplyWithResult(
+          FROM_HERE,
+          {base::MayBlock(), base::TaskPriority::BACKGROUND,
+           base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+          base::Bind(&GeneratePooledKey), reply);
+    }
+  }
+}
+
+void ChannelIDService::PooledKeyGenerated(
+    std::unique_ptr<crypto::ECPrivateKey> key) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  DCHECK_GT(pooled_keys_pending_, 0u);
+  pooled_keys_pending_--;
+  // Failed generations are not retried here, so as not to spin if key
+  // generation keeps failing. The next use of the pool tries again.
+  if (key && key_pool_.size() < key_pool_size_)
+    key_pool_.push_back(std::move(key));
+}
+
+std::unique_ptr<crypto::ECPrivateKey> ChannelIDService::TakeKeyFromPool(
+    const std::string& domain) {
+  if (key_pool_.empty())
+    return nullptr;
+
+  std::unique_ptr<crypto::ECPrivateKey> key = std::move(key_pool_.back());
+  key_pool_.pop_back();
+  pooled_keys_used_++;
+  channel_id_store_->SetChannelID(std::make_unique<ChannelIDStore::ChannelID>(
+      domain, base::Time::Now(), key->Copy()));
+  FillKeyPool();
+  return key;
+}
+
 int ChannelIDService::channel_id_count() {
   return channel_id_store_->GetChannelIDCount();
 }
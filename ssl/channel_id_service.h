@@ -53,7 +53,10 @@ class NET_EXPORT ChannelIDService {
                         std::unique_ptr<crypto::ECPrivateKey>* key,
                         ChannelIDServiceJob* job);
 
-    void Post(int error, std::unique_ptr<crypto::ECPrivateKey> key);
+    // |key_from_pool| is true if |key| was taken from the key pool.
+    void Post(int error,
+              std::unique_ptr<crypto::ECPrivateKey> key,
+              bool key_from_pool);
 
     ChannelIDService* service_;
     CompletionCallback callback_;
@@ -66,6 +69,11 @@ class NET_EXPORT ChannelIDService {
 
   ~ChannelIDService();
 
+  // Keeps up to |size| spare keys, generated at background priority, so that
+  // GetOrCreateChannelID() can create the channel ID of a new domain without
+  // waiting for key generation. 0, the default, disables the pool.
+  void SetKeyPoolSize(size_t size);
+
   // Sets the TaskRunner to use for asynchronous operations.
   void set_task_runner_for_testing(
       scoped_refptr<base::TaskRunner> task_runner) {
@@ -127,6 +135,8 @@ class NET_EXPORT ChannelIDService {
   uint64_t key_store_hits() const { return key_store_hits_; }
   uint64_t inflight_joins() const { return inflight_joins_; }
   uint64_t workers_created() const { return workers_created_; }
+  uint64_t pooled_keys_used() const { return pooled_keys_used_; }
+  size_t key_pool_count() const { return key_pool_.size(); }
 
  private:
   void GotChannelID(int err,
@@ -138,7 +148,17 @@ class NET_EXPORT ChannelIDService {
       std::unique_ptr<ChannelIDStore::ChannelID> channel_id);
   void HandleResult(int error,
                     const std::string& server_identifier,
-                    std::unique_ptr<crypto::ECPrivateKey> key);
+                    std::unique_ptr<crypto::ECPrivateKey> key,
+                    bool key_from_pool);
+
+  // Starts generating keys until the pool will be full.
+  void FillKeyPool();
+  void PooledKeyGenerated(std::unique_ptr<crypto::ECPrivateKey> key);
+
+  // If the pool has a key, stores it as the channel ID of |domain| and
+  // returns it. Otherwise returns null.
+  std::unique_ptr<crypto::ECPrivateKey> TakeKeyFromPool(
+      const std::string& domain);
 
   // Searches for an in-flight request for the same domain. If found,
   // attaches to the request and returns true. Returns false if no in-flight
@@ -167,10 +187,16 @@ class NET_EXPORT ChannelIDService {
   // place.
   std::map<std::string, std::unique_ptr<ChannelIDServiceJob>> inflight_;
 
+  // Spare keys, and how many more are being generated for the pool.
+  std::vector<std::unique_ptr<crypto::ECPrivateKey>> key_pool_;
+  size_t key_pool_size_;
+  size_t pooled_keys_pending_;
+
   uint64_t requests_;
   uint64_t key_store_hits_;
   uint64_t inflight_joins_;
   uint64_t workers_created_;
+  uint64_t pooled_keys_used_;
 
   THREAD_CHECKER(thread_checker_);
 
@@ -15,6 +15,7 @@
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/task_runner.h"
+#include "base/test/histogram_tester.h"
 #include "base/test/null_task_runner.h"
 #include "base/test/scoped_task_environment.h"
 #include "base/threading/thread_task_runner_handle.h"
@@ -428,6 +429,53 @@ TEST_F(ChannelIDServiceTest, SimultaneousCreation) {
   EXPECT_EQ(3, service_->channel_id_count());
 }
 
+// Tests that channel IDs for new domains are created synchronously with keys
+// from the pool, and that the pool is refilled.
+TEST_F(ChannelIDServiceTest, KeyPool) {
+  base::HistogramTester histograms;
+  service_->SetKeyPoolSize(2);
+  NetTestSuite::GetScopedTaskEnvironment()->RunUntilIdle();
+  EXPECT_EQ(2u, service_->key_pool_count());
+
+  std::string host1("encrypted.google.com");
+  std::unique_ptr<crypto::ECPrivateKey> key1;
+  ChannelIDService::Request request;
+  int error = service_->GetOrCreateChannelID(host1, &key1,
+                                             base::Bind(&FailTest), &request);
+  EXPECT_THAT(error, IsOk());
+  EXPECT_FALSE(request.is_active());
+  ASSERT_TRUE(key1);
+  EXPECT_EQ(1, service_->channel_id_count());
+  EXPECT_EQ(1u, service_->key_pool_count());
+
+  // The pooled key was stored as the channel ID of the domain.
+  std::unique_ptr<crypto::ECPrivateKey> key2;
+  error = service_->GetChannelID(host1, &key2, base::Bind(&FailTest), &request);
+  EXPECT_THAT(error, IsOk());
+  EXPECT_TRUE(KeysEqual(key1.get(), key2.get()));
+
+  std::string host2("foo.com");
+  std::unique_ptr<crypto::ECPrivateKey> key3;
+  error = service_->GetOrCreateChannelID(host2, &key3, base::Bind(&FailTest),
+                                         &request);
+  EXPECT_THAT(error, IsOk());
+  EXPECT_FALSE(KeysEqual(key1.get(), key3.get()));
+  EXPECT_EQ(0u, service_->key_pool_count());
+
+  EXPECT_EQ(0u, service_->workers_created());
+  EXPECT_EQ(2u, service_->pooled_keys_used());
+  // Both pool hits are recorded as SYNC_SUCCESS_FROM_POOL.
+  histograms.ExpectBucketCount("DomainBoundCerts.GetDomainBoundCertResult", 11,
+                               2);
+
+  NetTestSuite::GetScopedTaskEnvironment()->RunUntilIdle();
+  EXPECT_EQ(2u, service_->key_pool_count());
+
+  // Shrinking the pool drops spare keys.
+  service_->SetKeyPoolSize(1);
+  EXPECT_EQ(1u, service_->key_pool_count());
+}
+
 TEST_F(ChannelIDServiceTest, AsyncStoreGetOrCreateNoChannelIDsInStore) {
   MockChannelIDStoreWithAsyncGet* mock_store =
       new MockChannelIDStoreWithAsyncGet();
@@ -457,6 +505,40 @@ TEST_F(ChannelIDServiceTest, AsyncStoreGetOrCreateNoChannelIDsInStore) {
   EXPECT_FALSE(request.is_active());
 }
 
+// Tests that a key from the pool completes the requests for a domain that an
+// asynchronous store lookup did not find.
+TEST_F(ChannelIDServiceTest, AsyncStoreGetOrCreateFromKeyPool) {
+  MockChannelIDStoreWithAsyncGet* mock_store =
+      new MockChannelIDStoreWithAsyncGet();
+  service_ =
+      std::unique_ptr<ChannelIDService>(new ChannelIDService(mock_store));
+  service_->SetKeyPoolSize(1);
+  NetTestSuite::GetScopedTaskEnvironment()->RunUntilIdle();
+  EXPECT_EQ(1u, service_->key_pool_count());
+
+  base::HistogramTester histograms;
+  std::string host("encrypted.google.com");
+  TestCompletionCallback callback;
+  ChannelIDService::Request request;
+  std::unique_ptr<crypto::ECPrivateKey> key;
+  int error =
+      service_->GetOrCreateChannelID(host, &key, callback.callback(), &request);
+  EXPECT_THAT(error, IsError(ERR_IO_PENDING));
+  EXPECT_TRUE(request.is_active());
+
+  mock_store->CallGetChannelIDCallbackWithResult(ERR_FILE_NOT_FOUND, nullptr);
+
+  error = callback.WaitForResult();
+  EXPECT_THAT(error, IsOk());
+  EXPECT_TRUE(key);
+  EXPECT_EQ(1, service_->channel_id_count());
+  EXPECT_EQ(0u, service_->workers_created());
+  EXPECT_EQ(1u, service_->pooled_keys_used());
+  // The pool hit is recorded as ASYNC_SUCCESS_FROM_POOL.
+  histograms.ExpectUniqueSample("DomainBoundCerts.GetDomainBoundCertResult", 12,
+                                1);
+}
+
 TEST_F(ChannelIDServiceTest, AsyncStoreGetNoChannelIDsInStore) {
   MockChannelIDStoreWithAsyncGet* mock_store =
       new MockChannelIDStoreWithAsyncGet();
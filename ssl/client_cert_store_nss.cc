@@ -97,6 +97,7 @@ void ClientCertStoreNSS::FilterCertsOnWorkerThread(
   auto keep_iter = identities->begin();
 
   base::Time now = base::Time::Now();
+  CertsByNameCache certs_by_name;
 
   for (auto examine_iter = identities->begin();
        examine_iter != identities->end(); ++examine_iter) {
@@ -111,7 +112,7 @@ void ClientCertStoreNSS::FilterCertsOnWorkerThread(
 
     ScopedCERTCertificateList nss_intermediates;
     if (!MatchClientCertificateIssuers(cert, request.cert_authorities,
-                                       &nss_intermediates)) {
+                                       &certs_by_name, &nss_intermediates)) {
       continue;
     }
 
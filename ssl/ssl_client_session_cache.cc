@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "base/containers/flat_set.h"
+#include "base/logging.h"
 #include "base/memory/memory_coordinator_client_registry.h"
 #include "base/strings/stringprintf.h"
 #include "base/time/clock.h"
@@ -78,7 +79,8 @@ void SSLClientSessionCache::Insert(const std::string& cache_key,
   auto iter = cache_.Get(cache_key);
   if (iter == cache_.end())
     iter = cache_.Put(cache_key, Entry());
-  iter->second.Push(bssl::UniquePtr<SSL_SESSION>(session));
+  iter->second.Push(bssl::UniquePtr<SSL_SESSION>(session),
+                    config_.max_sessions_per_entry);
 }
 
 void SSLClientSessionCache::Flush() {
@@ -161,37 +163,43 @@ SSLClientSessionCache::Entry::Entry() = default;
 SSLClientSessionCache::Entry::Entry(Entry&&) = default;
 SSLClientSessionCache::Entry::~Entry() = default;
 
-void SSLClientSessionCache::Entry::Push(bssl::UniquePtr<SSL_SESSION> session) {
-  if (sessions[0] != nullptr &&
-      SSL_SESSION_should_be_single_use(sessions[0].get())) {
-    sessions[1] = std::move(sessions[0]);
+void SSLClientSessionCache::Entry::Push(bssl::UniquePtr<SSL_SESSION> session,
+                                        size_t max_sessions) {
+  DCHECK_LT(0u, max_sessions);
+  if (!sessions.empty() &&
+      !SSL_SESSION_should_be_single_use(sessions.front().get())) {
+    sessions.pop_front();
   }
-  sessions[0] = std::move(session);
+  sessions.push_front(std::move(session));
+  while (sessions.size() > max_sessions)
+    sessions.pop_back();
 }
 
 bssl::UniquePtr<SSL_SESSION> SSLClientSessionCache::Entry::Pop() {
-  if (sessions[0] == nullptr)
+  if (sessions.empty())
     return nullptr;
-  SSL_SESSION* session = sessions[0].get();
+  SSL_SESSION* session = sessions.front().get();
   SSL_SESSION_up_ref(session);
-  if (SSL_SESSION_should_be_single_use(session)) {
-    sessions[0] = std::move(sessions[1]);
-    sessions[1] = nullptr;
-  }
+  if (SSL_SESSION_should_be_single_use(session))
+    sessions.pop_front();
   return bssl::UniquePtr<SSL_SESSION>(session);
 }
 
 bool SSLClientSessionCache::Entry::ExpireSessions(time_t now) {
-  if (sessions[0] == nullptr)
+  if (sessions.empty())
     return true;
 
-  if (SSLClientSessionCache::IsExpired(sessions[0].get(), now)) {
+  if (SSLClientSessionCache::IsExpired(sessions.front().get(), now)) {
     return true;
   }
 
-  if (sessions[1] != nullptr &&
-      SSLClientSessionCache::IsExpired(sessions[1].get(), now)) {
-    sessions[1] = nullptr;
+  auto iter = sessions.begin() + 1;
+  while (iter != sessions.end()) {
+    if (SSLClientSessionCache::IsExpired(iter->get(), now)) {
+      iter = sessions.erase(iter);
+    } else {
+      ++iter;
+    }
   }
 
   return false;
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "base/bind.h"
+#include "base/containers/circular_deque.h"
 #include "base/containers/mru_cache.h"
 #include "base/macros.h"
 #include "base/memory/memory_coordinator_client.h"
@@ -38,6 +39,10 @@ class NET_EXPORT SSLClientSessionCache : public base::MemoryCoordinatorClient {
     size_t max_entries = 1024;
     // The number of calls to Lookup before a new check for expired sessions.
     size_t expiration_check_count = 256;
+    // The maximum number of sessions kept for each key. Single-use TLS 1.3
+    // tickets are consumed by each resumption, so keeping several of them lets
+    // concurrent connections to the same server all resume.
+    size_t max_sessions_per_entry = 2;
   };
 
   explicit SSLClientSessionCache(const Config& config);
@@ -76,9 +81,9 @@ class NET_EXPORT SSLClientSessionCache : public base::MemoryCoordinatorClient {
     Entry(Entry&&);
     ~Entry();
 
-    // Adds a new session onto this entry, dropping the oldest one if two are
-    // already stored.
-    void Push(bssl::UniquePtr<SSL_SESSION> session);
+    // Adds a new session onto this entry, dropping the oldest one if
+    // |max_sessions| are already stored.
+    void Push(bssl::UniquePtr<SSL_SESSION> session, size_t max_sessions);
 
     // Retrieves the latest session from the entry, removing it if its
     // single-use.
@@ -88,7 +93,9 @@ class NET_EXPORT SSLClientSessionCache : public base::MemoryCoordinatorClient {
     // deleted.
     bool ExpireSessions(time_t now);
 
-    bssl::UniquePtr<SSL_SESSION> sessions[2] = {nullptr};
+    // The sessions, most recent first. Only single-use sessions are kept
+    // behind the first one, since a reusable session makes them unnecessary.
+    base::circular_deque<bssl::UniquePtr<SSL_SESSION>> sessions;
   };
 
   // base::MemoryCoordinatorClient implementation:
@@ -231,6 +231,39 @@ TEST_F(SSLClientSessionCacheTest, MixedUse) {
   EXPECT_EQ(2u, session_reuse->references);
 }
 
+// Test that the number of single-use sessions kept per key is configurable.
+TEST_F(SSLClientSessionCacheTest, MaxSessionsPerEntry) {
+  SSLClientSessionCache::Config config;
+  config.max_sessions_per_entry = 3;
+  SSLClientSessionCache cache(config);
+
+  bssl::UniquePtr<SSL_SESSION> sessions[4];
+  for (auto& session : sessions) {
+    session = NewSSLSession(TLS1_3_VERSION);
+    cache.Insert("key1", session.get());
+  }
+  EXPECT_EQ(1u, cache.size());
+
+  // The oldest session was dropped.
+  EXPECT_EQ(1u, sessions[0]->references);
+  EXPECT_EQ(sessions[3].get(), cache.Lookup("key1").get());
+  EXPECT_EQ(sessions[2].get(), cache.Lookup("key1").get());
+  EXPECT_EQ(sessions[1].get(), cache.Lookup("key1").get());
+  EXPECT_EQ(nullptr, cache.Lookup("key1").get());
+  EXPECT_EQ(0u, cache.size());
+
+  // A reusable session only replaces a reusable session.
+  bssl::UniquePtr<SSL_SESSION> session_reuse1 = NewSSLSession(TLS1_2_VERSION);
+  bssl::UniquePtr<SSL_SESSION> session_reuse2 = NewSSLSession(TLS1_2_VERSION);
+  cache.Insert("key1", sessions[0].get());
+  cache.Insert("key1", session_reuse1.get());
+  cache.Insert("key1", session_reuse2.get());
+  EXPECT_EQ(2u, sessions[0]->references);
+  EXPECT_EQ(1u, session_reuse1->references);
+  EXPECT_EQ(session_reuse2.get(), cache.Lookup("key1").get());
+  EXPECT_EQ(session_reuse2.get(), cache.Lookup("key1").get());
+}
+
 // Test that a session may be inserted at two different keys. This should never
 // be necessary, but the API doesn't prohibit it.
 TEST_F(SSLClientSessionCacheTest, DoubleInsert) {
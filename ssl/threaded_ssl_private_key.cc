@@ -10,7 +10,7 @@
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
-#include "base/task_runner_util.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread_task_runner_handle.h"
 
 namespace net {
@@ -19,41 +19,108 @@ namespace {
 
 void DoCallback(const base::WeakPtr<ThreadedSSLPrivateKey>& key,
                 const ThreadedSSLPrivateKey::SignCallback& callback,
-                std::vector<uint8_t>* signature,
-                Error error) {
+                Error error,
+                const std::vector<uint8_t>& signature) {
   if (!key)
     return;
-  callback.Run(error, *signature);
+  callback.Run(error, signature);
 }
 
 }  // anonymous namespace
 
+ThreadedSSLPrivateKey::SigningOperation::SigningOperation()
+    : algorithm(0), error(OK) {}
+
+ThreadedSSLPrivateKey::SigningOperation::SigningOperation(
+    uint16_t algorithm,
+    base::span<const uint8_t> input)
+    : algorithm(algorithm), input(input.begin(), input.end()), error(OK) {}
+
+ThreadedSSLPrivateKey::SigningOperation::SigningOperation(
+    SigningOperation&& other) = default;
+
+ThreadedSSLPrivateKey::SigningOperation::~SigningOperation() = default;
+
+void ThreadedSSLPrivateKey::Delegate::SignBatch(
+    std::vector<SigningOperation>* operations) {
+  for (SigningOperation& operation : *operations) {
+    operation.error =
+        Sign(operation.algorithm, operation.input, &operation.signature);
+  }
+}
+
 class ThreadedSSLPrivateKey::Core
     : public base::RefCountedThreadSafe<ThreadedSSLPrivateKey::Core> {
  public:
-  Core(std::unique_ptr<ThreadedSSLPrivateKey::Delegate> delegate)
-      : delegate_(std::move(delegate)) {}
+  Core(std::unique_ptr<ThreadedSSLPrivateKey::Delegate> delegate,
+       scoped_refptr<base::SingleThreadTaskRunner> task_runner)
+      : delegate_(std::move(delegate)),
+        task_runner_(std::move(task_runner)),
+        sign_task_posted_(false) {}
 
   ThreadedSSLPrivateKey::Delegate* delegate() { return delegate_.get(); }
 
-  Error Sign(uint16_t algorithm,
-             base::span<const uint8_t> input,
-             std::vector<uint8_t>* signature) {
-    return delegate_->Sign(algorithm, input, signature);
+  // Queues an operation and runs |callback| on the current thread once it
+  // completes.
+  void Sign(uint16_t algorithm,
+            base::span<const uint8_t> input,
+            const SignCallback& callback) {
+    bool post_task;
+    {
+      base::AutoLock lock(lock_);
+      pending_operations_.emplace_back(algorithm, input);
+      pending_callbacks_.push_back(
+          std::make_pair(base::ThreadTaskRunnerHandle::Get(), callback));
+      post_task = !sign_task_posted_;
+      sign_task_posted_ = true;
+    }
+    if (post_task) {
+      task_runner_->PostTask(FROM_HERE,
+                             base::Bind(&Core::SignPendingOperations, this));
+    }
   }
 
  private:
   friend class base::RefCountedThreadSafe<Core>;
   ~Core() = default;
 
+  using PendingCallback =
+      std::pair<scoped_refptr<base::SingleThreadTaskRunner>, SignCallback>;
+
+  // Runs on |task_runner_| and signs every operation queued so far. Operations
+  // queued while the delegate is busy are signed by the next task.
+  void SignPendingOperations() {
+    std::vector<SigningOperation> operations;
+    std::vector<PendingCallback> callbacks;
+    {
+      base::AutoLock lock(lock_);
+      operations.swap(pending_operations_);
+      callbacks.swap(pending_callbacks_);
+      sign_task_posted_ = false;
+    }
+
+    delegate_->SignBatch(&operations);
+
+    for (size_t i = 0; i < operations.size(); i++) {
+      callbacks[i].first->PostTask(
+          FROM_HERE, base::Bind(callbacks[i].second, operations[i].error,
+                                std::move(operations[i].signature)));
+    }
+  }
+
   std::unique_ptr<ThreadedSSLPrivateKey::Delegate> delegate_;
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+
+  base::Lock lock_;
+  std::vector<SigningOperation> pending_operations_;
+  std::vector<PendingCallback> pending_callbacks_;
+  bool sign_task_posted_;
 };
 
 ThreadedSSLPrivateKey::ThreadedSSLPrivateKey(
     std::unique_ptr<ThreadedSSLPrivateKey::Delegate> delegate,
     scoped_refptr<base::SingleThreadTaskRunner> task_runner)
-    : core_(new Core(std::move(delegate))),
-      task_runner_(std::move(task_runner)),
+    : core_(new Core(std::move(delegate), std::move(task_runner))),
       weak_factory_(this) {}
 
 std::vector<uint16_t> ThreadedSSLPrivateKey::GetAlgorithmPreferences() {
@@ -63,14 +130,8 @@ std::vector<uint16_t> ThreadedSSLPrivateKey::GetAlgorithmPreferences() {
 void ThreadedSSLPrivateKey::Sign(uint16_t algorithm,
                                  base::span<const uint8_t> input,
                                  const SSLPrivateKey::SignCallback& callback) {
-  std::vector<uint8_t>* signature = new std::vector<uint8_t>;
-  base::PostTaskAndReplyWithResult(
-      task_runner_.get(), FROM_HERE,
-      base::Bind(&ThreadedSSLPrivateKey::Core::Sign, core_, algorithm,
-                 std::vector<uint8_t>(input.begin(), input.end()),
-                 base::Unretained(signature)),
-      base::Bind(&DoCallback, weak_factory_.GetWeakPtr(), callback,
-                 base::Owned(signature)));
+  core_->Sign(algorithm, input,
+              base::Bind(&DoCallback, weak_factory_.GetWeakPtr(), callback));
 }
 
 ThreadedSSLPrivateKey::~ThreadedSSLPrivateKey() = default;
@@ -24,9 +24,28 @@ class SingleThreadTaskRunner;
 namespace net {
 
 // An SSLPrivateKey implementation which offloads key operations to a background
-// task runner.
+// task runner. Operations requested while the task runner is busy are queued
+// and handed to the Delegate together, so that backends able to sign several
+// inputs at once may do so.
 class ThreadedSSLPrivateKey : public SSLPrivateKey {
  public:
+  // A signing operation, as passed to Delegate::SignBatch().
+  struct SigningOperation {
+    SigningOperation();
+    SigningOperation(uint16_t algorithm, base::span<const uint8_t> input);
+    SigningOperation(SigningOperation&& other);
+    ~SigningOperation();
+
+    uint16_t algorithm;
+    std::vector<uint8_t> input;
+    // Set by the Delegate.
+    Error error;
+    std::vector<uint8_t> signature;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(SigningOperation);
+  };
+
   // Interface for consumers to implement to perform the actual signing
   // operation.
   class Delegate {
@@ -49,6 +68,13 @@ class ThreadedSSLPrivateKey : public SSLPrivateKey {
                        base::span<const uint8_t> input,
                        std::vector<uint8_t>* signature) = 0;
 
+    // Performs every operation in |operations|, setting their |error| and
+    // |signature|. It will only be called on the task runner passed to the
+    // owning ThreadedSSLPrivateKey. The default implementation calls Sign() on
+    // each operation in turn; delegates which can submit several operations
+    // to the underlying key at once should override it.
+    virtual void SignBatch(std::vector<SigningOperation>* operations);
+
    private:
     DISALLOW_COPY_AND_ASSIGN(Delegate);
   };
@@ -68,7 +94,6 @@ class ThreadedSSLPrivateKey : public SSLPrivateKey {
   class Core;
 
   scoped_refptr<Core> core_;
-  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
   base::WeakPtrFactory<ThreadedSSLPrivateKey> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadedSSLPrivateKey);
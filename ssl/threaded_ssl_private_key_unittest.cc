@@ -0,0 +1,110 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/ssl/threaded_ssl_private_key.h"
+
+#include <memory>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/run_loop.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/boringssl/src/include/openssl/ssl.h"
+
+namespace net {
+
+namespace {
+
+// A delegate which "signs" by copying the input, and records the size of each
+// batch it is given.
+class FakeBatchingDelegate : public ThreadedSSLPrivateKey::Delegate {
+ public:
+  explicit FakeBatchingDelegate(std::vector<size_t>* batch_sizes)
+      : batch_sizes_(batch_sizes) {}
+  ~FakeBatchingDelegate() override = default;
+
+  std::vector<uint16_t> GetAlgorithmPreferences() override {
+    return {SSL_SIGN_RSA_PKCS1_SHA256};
+  }
+
+  Error Sign(uint16_t algorithm,
+             base::span<const uint8_t> input,
+             std::vector<uint8_t>* signature) override {
+    if (input.empty())
+      return ERR_SSL_CLIENT_AUTH_SIGNATURE_FAILED;
+    signature->assign(input.begin(), input.end());
+    return OK;
+  }
+
+  void SignBatch(std::vector<ThreadedSSLPrivateKey::SigningOperation>*
+                     operations) override {
+    batch_sizes_->push_back(operations->size());
+    ThreadedSSLPrivateKey::Delegate::SignBatch(operations);
+  }
+
+ private:
+  std::vector<size_t>* batch_sizes_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeBatchingDelegate);
+};
+
+void SaveResult(Error* out_error,
+                std::vector<uint8_t>* out_signature,
+                Error error,
+                const std::vector<uint8_t>& signature) {
+  *out_error = error;
+  *out_signature = signature;
+}
+
+// Tests that operations requested while the task runner is busy are signed in
+// one batch, and that each callback gets its own result.
+TEST(ThreadedSSLPrivateKeyTest, BatchesPendingOperations) {
+  base::Thread thread("ThreadedSSLPrivateKeyTest");
+  ASSERT_TRUE(thread.Start());
+
+  // |batch_sizes| is only written on |thread|, and read once it has stopped.
+  std::vector<size_t> batch_sizes;
+  auto key = base::MakeRefCounted<ThreadedSSLPrivateKey>(
+      std::make_unique<FakeBatchingDelegate>(&batch_sizes),
+      thread.task_runner());
+
+  // Keep the task runner busy while the operations are requested.
+  base::WaitableEvent unblock(base::WaitableEvent::ResetPolicy::MANUAL,
+                              base::WaitableEvent::InitialState::NOT_SIGNALED);
+  thread.task_runner()->PostTask(
+      FROM_HERE, base::Bind(&base::WaitableEvent::Wait,
+                            base::Unretained(&unblock)));
+
+  const std::vector<uint8_t> input1 = {1, 2, 3};
+  const std::vector<uint8_t> input2 = {4, 5};
+  const std::vector<uint8_t> empty_input;
+  Error errors[3] = {ERR_IO_PENDING, ERR_IO_PENDING, ERR_IO_PENDING};
+  std::vector<uint8_t> signatures[3];
+  key->Sign(SSL_SIGN_RSA_PKCS1_SHA256, input1,
+            base::Bind(&SaveResult, &errors[0], &signatures[0]));
+  key->Sign(SSL_SIGN_RSA_PKCS1_SHA256, input2,
+            base::Bind(&SaveResult, &errors[1], &signatures[1]));
+  key->Sign(SSL_SIGN_RSA_PKCS1_SHA256, empty_input,
+            base::Bind(&SaveResult, &errors[2], &signatures[2]));
+
+  // Stopping the thread runs the signing task, which posts the results back.
+  unblock.Signal();
+  thread.Stop();
+  base::RunLoop().RunUntilIdle();
+
+  EXPECT_EQ(OK, errors[0]);
+  EXPECT_EQ(input1, signatures[0]);
+  EXPECT_EQ(OK, errors[1]);
+  EXPECT_EQ(input2, signatures[1]);
+  EXPECT_EQ(ERR_SSL_CLIENT_AUTH_SIGNATURE_FAILED, errors[2]);
+
+  ASSERT_EQ(1u, batch_sizes.size());
+  EXPECT_EQ(3u, batch_sizes[0]);
+}
+
+}  // namespace
+
+}  // namespace net
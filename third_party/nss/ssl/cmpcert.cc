@@ -14,6 +14,7 @@
 #include "net/cert/internal/parse_certificate.h"
 #include "net/cert/x509_certificate.h"
 #include "net/cert/x509_util.h"
+#include "net/cert/x509_util_nss.h"
 #include "net/der/parser.h"
 #include "third_party/boringssl/src/include/openssl/pool.h"
 
@@ -53,11 +54,38 @@ bool GetIssuerAndSubject(X509Certificate* cert,
   return true;
 }
 
+// Returns the certificate with subject |name|, from |certs_by_name| if it was
+// looked up before and from the NSS database otherwise. |certs_by_name| may be
+// null.
+ScopedCERTCertificate FindCertByName(const der::Input& name,
+                                     CertsByNameCache* certs_by_name) {
+  SECItem name_item;
+  name_item.len = name.Length();
+  name_item.data = const_cast<unsigned char*>(name.UnsafeData());
+  if (!certs_by_name) {
+    return ScopedCERTCertificate(
+        CERT_FindCertByName(CERT_GetDefaultCertDB(), &name_item));
+  }
+
+  auto it = certs_by_name->find(name.AsString());
+  if (it == certs_by_name->end()) {
+    it = certs_by_name
+             ->emplace(name.AsString(),
+                       ScopedCERTCertificate(CERT_FindCertByName(
+                           CERT_GetDefaultCertDB(), &name_item)))
+             .first;
+  }
+  if (!it->second)
+    return nullptr;
+  return x509_util::DupCERTCertificate(it->second.get());
+}
+
 }  // namespace
 
 bool MatchClientCertificateIssuers(
     X509Certificate* cert,
     const std::vector<std::string>& cert_authorities,
+    CertsByNameCache* certs_by_name,
     ScopedCERTCertificateList* intermediates) {
   // Bound how many iterations to try.
   static const int kMaxDepth = 20;
@@ -87,11 +115,7 @@ bool MatchClientCertificateIssuers(
       return false;
 
     // Look the parent up in the database and keep searching.
-    SECItem issuer_item;
-    issuer_item.len = issuer.Length();
-    issuer_item.data = const_cast<unsigned char*>(issuer.UnsafeData());
-    ScopedCERTCertificate nextcert(
-        CERT_FindCertByName(CERT_GetDefaultCertDB(), &issuer_item));
+    ScopedCERTCertificate nextcert = FindCertByName(issuer, certs_by_name);
     if (!nextcert)
       return false;
 
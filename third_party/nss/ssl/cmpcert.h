@@ -10,6 +10,7 @@
 
 #include <cert.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -19,12 +20,24 @@ namespace net {
 
 class X509Certificate;
 
+// The results of looking certificates up by DER-encoded subject name in the
+// NSS database. Null if there is no such certificate.
+using CertsByNameCache = std::map<std::string, ScopedCERTCertificate>;
+
 // Checks if |cert| matches |cert_authorities|. If so, it sets |*intermediates|
 // to a list of intermediates to send and returns true. Otherwise, it returns
 // false.
+//
+// The issuers of |cert| are looked up in |certs_by_name| before the NSS
+// database, and the results of database lookups are added to it. Client
+// certificates usually share a few issuers, so callers matching several
+// certificates against one request should pass the same cache for all of them.
+// |certs_by_name| may be null, in which case every issuer is looked up in the
+// NSS database.
 bool MatchClientCertificateIssuers(
     X509Certificate* cert,
     const std::vector<std::string>& cert_authorities,
+    CertsByNameCache* certs_by_name,
     ScopedCERTCertificateList* intermediates);
 
 }  // namespace net
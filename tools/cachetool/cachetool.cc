@@ -25,6 +25,7 @@
 #include "net/http/http_cache.h"
 #include "net/http/http_response_headers.h"
 #include "net/http/http_util.h"
+#include "net/tools/cachetool/simple_cache_scan.h"
 
 using disk_cache::Backend;
 using disk_cache::Entry;
@@ -65,6 +66,11 @@ void PrintHelp() {
   std::cout << "  list_keys: List all keys in the cache." << std::endl;
   std::cout << "  list_dups: List all resources with duplicate bodies in the "
             << "cache." << std::endl;
+  std::cout << "  scan <csv|json> [response_info]: List all entries of a "
+            << "simple cache, with their sizes and last use times, without "
+            << "opening it as a cache backend. With response_info, also list "
+            << "their HTTP response codes and whether they are fresh."
+            << std::endl;
   std::cout << "  update_raw_headers <key>: Update stdin as the key's raw "
             << "response headers." << std::endl;
   std::cout << "  stop: Verify that the cache can be opened and return, "
@@ -653,6 +659,20 @@ int main(int argc, char* argv[]) {
   base::FilePath cache_path(args[0]);
   std::string cache_backend_type(args[1]);
 
+  // scan reads the files of the cache directly, so that it neither waits for
+  // nor modifies a cache which may be in use.
+  if (args[2] == "scan") {
+    if (cache_backend_type != "simple" || args.size() < 4U ||
+        args.size() > 5U || (args[3] != "csv" && args[3] != "json") ||
+        (args.size() == 5U && args[4] != "response_info")) {
+      PrintHelp();
+      return 1;
+    }
+    ScanOutputFormat format =
+        args[3] == "csv" ? ScanOutputFormat::CSV : ScanOutputFormat::JSON;
+    return !ScanSimpleCache(cache_path, format, args.size() == 5U);
+  }
+
   net::BackendType backend_type;
   if (cache_backend_type == "simple") {
     backend_type = net::CACHE_BACKEND_SIMPLE;
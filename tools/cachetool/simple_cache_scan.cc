@@ -0,0 +1,342 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/cachetool/simple_cache_scan.h"
+
+#include <stdint.h>
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/format_macros.h"
+#include "base/json/string_escape.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/run_loop.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/time/time.h"
+#include "net/base/hash_value.h"
+#include "net/disk_cache/simple/simple_entry_format.h"
+#include "net/disk_cache/simple/simple_file_tracker.h"
+#include "net/disk_cache/simple/simple_index.h"
+#include "net/disk_cache/simple/simple_index_file.h"
+#include "net/disk_cache/simple/simple_util.h"
+#include "net/http/http_cache.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+
+namespace {
+
+// The number of entry files read concurrently. The TaskScheduler bounds the
+// number of threads doing so; this only bounds the number of pending tasks.
+const size_t kMaxReadsInFlight = 64;
+
+// Entries are counted in buckets of sizes [2^i, 2^(i+1)) bytes.
+const int kSizeHistogramBuckets = 32;
+
+enum class Freshness { UNKNOWN, FRESH, STALE };
+
+// What is read from the stream 0 file of an entry.
+struct ScannedEntry {
+  bool readable = false;
+  std::string key;
+  int64_t file_size = 0;
+  int response_code = 0;
+  Freshness freshness = Freshness::UNKNOWN;
+};
+
+const char* FreshnessToString(Freshness freshness) {
+  switch (freshness) {
+    case Freshness::UNKNOWN:
+      return "unknown";
+    case Freshness::FRESH:
+      return "fresh";
+    case Freshness::STALE:
+      return "stale";
+  }
+  NOTREACHED();
+  return "";
+}
+
+// Reads the response info stored in stream 0, at the end of |file|, into
+// |entry|. See simple_entry_format.h for the layout of the file.
+void ReadResponseInfo(base::File* file,
+                      int64_t key_end,
+                      base::Time now,
+                      ScannedEntry* entry) {
+  disk_cache::SimpleFileEOF eof;
+  int64_t eof_offset = entry->file_size - static_cast<int64_t>(sizeof(eof));
+  if (eof_offset < key_end ||
+      file->Read(eof_offset, reinterpret_cast<char*>(&eof), sizeof(eof)) !=
+          static_cast<int>(sizeof(eof)) ||
+      eof.final_magic_number != disk_cache::kSimpleFinalMagicNumber) {
+    return;
+  }
+
+  int64_t stream_0_offset = eof_offset - eof.stream_size;
+  if (eof.flags & disk_cache::SimpleFileEOF::FLAG_HAS_KEY_SHA256)
+    stream_0_offset -= static_cast<int64_t>(sizeof(net::SHA256HashValue));
+  if (stream_0_offset < key_end || eof.stream_size == 0)
+    return;
+
+  std::vector<char> stream_0(eof.stream_size);
+  if (file->Read(stream_0_offset, stream_0.data(), stream_0.size()) !=
+      static_cast<int>(stream_0.size())) {
+    return;
+  }
+
+  net::HttpResponseInfo response_info;
+  bool truncated = false;
+  if (!net::HttpCache::ParseResponseInfo(stream_0.data(), stream_0.size(),
+                                         &response_info, &truncated) ||
+      !response_info.headers) {
+    return;
+  }
+  entry->response_code = response_info.headers->response_code();
+  entry->freshness =
+      response_info.headers->RequiresValidation(response_info.request_time,
+                                                response_info.response_time,
+                                                now)
+          ? Freshness::STALE
+          : Freshness::FRESH;
+}
+
+// Reads the header and key, and maybe the response info, of the entry with
+// |entry_hash|. Runs on a worker thread.
+ScannedEntry ReadEntry(const base::FilePath& cache_path,
+                       uint64_t entry_hash,
+                       bool read_response_info,
+                       base::Time now) {
+  ScannedEntry entry;
+  base::File file(
+      cache_path.AppendASCII(
+          disk_cache::simple_util::GetFilenameFromEntryFileKeyAndFileIndex(
+              disk_cache::SimpleFileTracker::EntryFileKey(entry_hash), 0)),
+      base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return entry;
+  entry.file_size = file.GetLength();
+
+  disk_cache::SimpleFileHeader header;
+  const int64_t header_size = sizeof(header);
+  if (file.Read(0, reinterpret_cast<char*>(&header), header_size) !=
+          header_size ||
+      header.initial_magic_number != disk_cache::kSimpleInitialMagicNumber ||
+      header.key_length > entry.file_size - header_size) {
+    return entry;
+  }
+
+  entry.key.resize(header.key_length);
+  if (header.key_length > 0 &&
+      file.Read(header_size, &entry.key[0], header.key_length) !=
+          static_cast<int>(header.key_length)) {
+    return entry;
+  }
+  entry.readable = true;
+
+  if (read_response_info)
+    ReadResponseInfo(&file, header_size + header.key_length, now, &entry);
+  return entry;
+}
+
+std::string QuoteCSV(const std::string& value) {
+  std::string quoted;
+  base::ReplaceChars(value, "\"", "\"\"", &quoted);
+  return "\"" + quoted + "\"";
+}
+
+class SimpleCacheScanner {
+ public:
+  SimpleCacheScanner(const base::FilePath& cache_path,
+                     ScanOutputFormat format,
+                     bool read_response_info,
+                     const disk_cache::SimpleIndex::EntrySet& entries)
+      : cache_path_(cache_path),
+        format_(format),
+        read_response_info_(read_response_info),
+        now_(base::Time::Now()),
+        next_entry_(0),
+        reads_in_flight_(0),
+        unreadable_(0),
+        fresh_(0),
+        stale_(0),
+        total_bytes_(0),
+        size_histogram_(kSizeHistogramBuckets) {
+    entries_.reserve(entries.size());
+    for (const auto& entry : entries)
+      entries_.push_back(entry);
+  }
+
+  void Run() {
+    if (format_ == ScanOutputFormat::CSV) {
+      std::cout << "hash,key,file_size,entry_size,last_used";
+      if (read_response_info_)
+        std::cout << ",response_code,freshness";
+      std::cout << "\n";
+    }
+
+    base::RunLoop run_loop;
+    quit_closure_ = run_loop.QuitClosure();
+    while (reads_in_flight_ < kMaxReadsInFlight) {
+      if (!StartNextRead())
+        break;
+    }
+    if (reads_in_flight_ > 0)
+      run_loop.Run();
+    PrintSummary();
+  }
+
+ private:
+  // Starts reading the next entry, if there is one left.
+  bool StartNextRead() {
+    if (next_entry_ == entries_.size())
+      return false;
+    size_t index = next_entry_++;
+    ++reads_in_flight_;
+    base::PostTaskWithTraitsAndReplyWithResult(
+        FROM_HERE,
+        {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+         base::TaskShutdownBehavior::CONTINUE_ON_SHUTDOWN},
+        base::BindOnce(&ReadEntry, cache_path_, entries_[index].first,
+                       read_response_info_, now_),
+        base::BindOnce(&SimpleCacheScanner::OnEntryRead,
+                       base::Unretained(this), index));
+    return true;
+  }
+
+  void OnEntryRead(size_t index, ScannedEntry entry) {
+    --reads_in_flight_;
+    StartNextRead();
+
+    const uint64_t entry_hash = entries_[index].first;
+    const disk_cache::EntryMetadata& metadata = entries_[index].second;
+    if (!entry.readable)
+      ++unreadable_;
+    if (entry.freshness == Freshness::FRESH)
+      ++fresh_;
+    if (entry.freshness == Freshness::STALE)
+      ++stale_;
+    total_bytes_ += metadata.GetEntrySize();
+    int bucket = 0;
+    while (bucket < kSizeHistogramBuckets - 1 &&
+           (2u << bucket) <= metadata.GetEntrySize()) {
+      ++bucket;
+    }
+    ++size_histogram_[bucket];
+
+    PrintEntry(entry_hash, metadata, entry);
+    if (reads_in_flight_ == 0)
+      std::move(quit_closure_).Run();
+  }
+
+  void PrintEntry(uint64_t entry_hash,
+                  const disk_cache::EntryMetadata& metadata,
+                  const ScannedEntry& entry) {
+    std::string hash =
+        disk_cache::simple_util::ConvertEntryHashKeyToHexString(entry_hash);
+    int64_t last_used =
+        static_cast<int64_t>(metadata.GetLastUsedTime().ToDoubleT());
+
+    if (format_ == ScanOutputFormat::CSV) {
+      std::cout << hash << "," << QuoteCSV(entry.key) << ","
+                << entry.file_size << "," << metadata.GetEntrySize() << ","
+                << last_used;
+      if (read_response_info_) {
+        std::cout << "," << entry.response_code << ","
+                  << FreshnessToString(entry.freshness);
+      }
+      std::cout << "\n";
+      return;
+    }
+
+    std::string line = base::StringPrintf(
+        "{\"hash\":\"%s\",\"key\":", hash.c_str());
+    base::EscapeJSONString(entry.key, true /* put_in_quotes */, &line);
+    base::StringAppendF(&line,
+                        ",\"readable\":%s,\"file_size\":%" PRId64
+                        ",\"entry_size\":%u,\"last_used\":%" PRId64,
+                        entry.readable ? "true" : "false", entry.file_size,
+                        metadata.GetEntrySize(), last_used);
+    if (read_response_info_) {
+      base::StringAppendF(&line, ",\"response_code\":%d,\"freshness\":\"%s\"",
+                          entry.response_code,
+                          FreshnessToString(entry.freshness));
+    }
+    std::cout << line << "}\n";
+  }
+
+  void PrintSummary() const {
+    std::cerr << "Entries: " << entries_.size() << " (" << unreadable_
+              << " unreadable)\n";
+    std::cerr << "Total size: " << total_bytes_ << " bytes\n";
+    if (read_response_info_ && fresh_ + stale_ > 0) {
+      std::cerr << base::StringPrintf(
+        "Fresh: %" PRIuS ", stale: %" PRIuS " (%.1f%% stale)\n", fresh_,
+        stale_, 100.0 * stale_ / (fresh_ + stale_));
+    }
+    std::cerr << "Entry sizes:\n";
+    for (int i = 0; i < kSizeHistogramBuckets; ++i) {
+      if (size_histogram_[i] == 0)
+        continue;
+      std::cerr << base::StringPrintf("  [%" PRIu64 ", %" PRIu64 "): %" PRIuS
+                                      "\n",
+                                      i == 0 ? 0 : UINT64_C(1) << i,
+                                      UINT64_C(2) << i, size_histogram_[i]);
+    }
+  }
+
+  const base::FilePath cache_path_;
+  const ScanOutputFormat format_;
+  const bool read_response_info_;
+  const base::Time now_;
+
+  std::vector<std::pair<uint64_t, disk_cache::EntryMetadata>> entries_;
+  size_t next_entry_;
+  size_t reads_in_flight_;
+  base::OnceClosure quit_closure_;
+
+  size_t unreadable_;
+  size_t fresh_;
+  size_t stale_;
+  uint64_t total_bytes_;
+  std::vector<size_t> size_histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimpleCacheScanner);
+};
+
+}  // namespace
+
+bool ScanSimpleCache(const base::FilePath& cache_path,
+                     ScanOutputFormat format,
+                     bool read_response_info) {
+  // SimpleIndexFile::LoadIndexEntries() would delete an index it can't use,
+  // so load the entries without modifying the cache instead.
+  disk_cache::SimpleIndexLoadResult load_result;
+  base::RunLoop run_loop;
+  base::PostTaskWithTraitsAndReply(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::BindOnce(&disk_cache::SimpleIndexFile::SyncLoadIndexEntriesReadOnly,
+                     cache_path, base::Unretained(&load_result)),
+      run_loop.QuitClosure());
+  run_loop.Run();
+  if (!load_result.did_load) {
+    std::cerr << "Couldn't load the index of " << cache_path.value()
+              << std::endl;
+    return false;
+  }
+
+  SimpleCacheScanner(cache_path, format, read_response_info,
+                     load_result.entries)
+      .Run();
+  return true;
+}
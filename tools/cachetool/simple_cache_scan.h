@@ -0,0 +1,29 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_CACHETOOL_SIMPLE_CACHE_SCAN_H_
+#define NET_TOOLS_CACHETOOL_SIMPLE_CACHE_SCAN_H_
+
+namespace base {
+class FilePath;
+}
+
+enum class ScanOutputFormat { CSV, JSON };
+
+// Lists the entries of the simple cache in |cache_path| without creating a
+// backend, so without modifying the cache or waiting for it to be indexed:
+// the entries are taken from the index file, or from a traversal of the cache
+// directory if the index is missing or corrupt, and the key of each of them is
+// read from the header of its file by parallel tasks. If
+// |read_response_info|, the HTTP response info is read as well, to report
+// the response code and whether the entry is still fresh.
+//
+// A line per entry is printed to stdout in |format| as soon as it is read,
+// and a summary is printed to stderr. Returns false if the scan could not
+// start.
+bool ScanSimpleCache(const base::FilePath& cache_path,
+                     ScanOutputFormat format,
+                     bool read_response_info);
+
+#endif  // NET_TOOLS_CACHETOOL_SIMPLE_CACHE_SCAN_H_
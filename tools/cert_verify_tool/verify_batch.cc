@@ -0,0 +1,239 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/cert_verify_tool/verify_batch.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "net/base/net_errors.h"
+#include "net/cert/cert_verifier.h"
+#include "net/cert/cert_verify_proc.h"
+#include "net/cert/cert_verify_result.h"
+#include "net/cert/x509_certificate.h"
+#include "net/tools/cert_verify_tool/cert_verify_tool_util.h"
+
+namespace {
+
+// A chain to verify, as listed in the batch file.
+struct BatchEntry {
+  base::FilePath chain_path;
+  std::string hostname;
+  scoped_refptr<net::X509Certificate> chain;
+};
+
+// The outcome of verifying one BatchEntry with one verifier.
+struct BatchResult {
+  int error = net::OK;
+  base::TimeDelta latency;
+};
+
+bool ReadBatch(const base::FilePath& batch_path,
+               const std::vector<CertInput>& extra_intermediate_der_certs,
+               std::vector<BatchEntry>* entries) {
+  std::string contents;
+  if (!base::ReadFileToString(batch_path, &contents)) {
+    std::cerr << "ERROR: ReadFileToString " << batch_path.value() << "\n";
+    return false;
+  }
+
+  for (base::StringPiece line :
+       base::SplitStringPiece(contents, "\n", base::TRIM_WHITESPACE,
+                              base::SPLIT_WANT_NONEMPTY)) {
+    if (line.starts_with("#"))
+      continue;
+    std::vector<std::string> fields = base::SplitString(
+        line, " \t", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+    if (fields.size() != 2) {
+      std::cerr << "ERROR: batch lines must be \"<chain> <hostname>\": "
+                << line << "\n";
+      return false;
+    }
+
+    BatchEntry entry;
+    entry.chain_path = batch_path.DirName().AppendASCII(fields[0]);
+    entry.hostname = fields[1];
+
+    CertInput target_der_cert;
+    std::vector<CertInput> intermediate_der_certs;
+    if (!ReadChainFromFile(entry.chain_path, &target_der_cert,
+                           &intermediate_der_certs) ||
+        target_der_cert.der_cert.empty()) {
+      std::cerr << "ERROR: Couldn't read certificate chain "
+                << entry.chain_path.value() << "\n";
+      return false;
+    }
+
+    std::vector<base::StringPiece> der_cert_chain;
+    der_cert_chain.push_back(target_der_cert.der_cert);
+    for (const auto& cert : intermediate_der_certs)
+      der_cert_chain.push_back(cert.der_cert);
+    for (const auto& cert : extra_intermediate_der_certs)
+      der_cert_chain.push_back(cert.der_cert);
+    entry.chain = net::X509Certificate::CreateFromDERCertChain(der_cert_chain);
+    if (!entry.chain) {
+      PrintCertError("ERROR: X509Certificate::CreateFromDERCertChain failed:",
+                     target_der_cert);
+      return false;
+    }
+
+    entries->push_back(std::move(entry));
+  }
+
+  if (entries->empty()) {
+    std::cerr << "ERROR: no chains in " << batch_path.value() << "\n";
+    return false;
+  }
+  return true;
+}
+
+// Verifies every |stride|th chain of |entries| with |proc|, starting with
+// |first|, and stores the outcomes at the same indices of |results|.
+void VerifyEntries(net::CertVerifyProc* proc,
+                   const net::CertificateList* additional_trust_anchors,
+                   const std::vector<BatchEntry>* entries,
+                   size_t first,
+                   size_t stride,
+                   std::vector<BatchResult>* results) {
+  // Use the same flags as VerifyUsingCertVerifyProc().
+  const int flags = net::CertVerifier::VERIFY_EV_CERT |
+                    net::CertVerifier::VERIFY_CERT_IO_ENABLED;
+
+  for (size_t i = first; i < entries->size(); i += stride) {
+    const BatchEntry& entry = (*entries)[i];
+    net::CertVerifyResult verify_result;
+    base::TimeTicks start = base::TimeTicks::Now();
+    (*results)[i].error = proc->Verify(
+        entry.chain.get(), entry.hostname, std::string() /* ocsp_response */,
+        flags, nullptr /* crl_set */, *additional_trust_anchors,
+        &verify_result);
+    (*results)[i].latency = base::TimeTicks::Now() - start;
+  }
+}
+
+// Returns the |percentile|th percentile of |sorted_latencies|, which must not
+// be empty.
+base::TimeDelta Percentile(const std::vector<base::TimeDelta>& sorted_latencies,
+                           size_t percentile) {
+  return sorted_latencies[(sorted_latencies.size() - 1) * percentile / 100];
+}
+
+void PrintStats(const std::vector<BatchResult>& results,
+                base::TimeDelta elapsed) {
+  std::vector<base::TimeDelta> latencies;
+  size_t num_verified = 0;
+  for (const BatchResult& result : results) {
+    latencies.push_back(result.latency);
+    if (result.error == net::OK)
+      ++num_verified;
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << " " << results.size() << " chains (" << num_verified
+            << " verified) in " << elapsed.InMillisecondsF() << " ms: "
+            << results.size() / elapsed.InSecondsF() << " chains/s\n";
+  std::cout << " latency ms: p50 "
+            << Percentile(latencies, 50).InMillisecondsF() << ", p90 "
+            << Percentile(latencies, 90).InMillisecondsF() << ", p99 "
+            << Percentile(latencies, 99).InMillisecondsF() << ", max "
+            << latencies.back().InMillisecondsF() << "\n";
+}
+
+}  // namespace
+
+BatchVerifier::BatchVerifier(const std::string& name,
+                             scoped_refptr<net::CertVerifyProc> proc)
+    : name(name), proc(std::move(proc)) {}
+
+BatchVerifier::BatchVerifier(const BatchVerifier& other) = default;
+
+BatchVerifier::~BatchVerifier() = default;
+
+bool VerifyBatch(const base::FilePath& batch_path,
+                 const std::vector<BatchVerifier>& verifiers,
+                 const std::vector<CertInput>& intermediate_der_certs,
+                 const std::vector<CertInput>& root_der_certs,
+                 int num_threads) {
+  DCHECK_GT(num_threads, 0);
+
+  std::vector<BatchEntry> entries;
+  if (!ReadBatch(batch_path, intermediate_der_certs, &entries))
+    return false;
+
+  net::CertificateList x509_additional_trust_anchors;
+  for (const auto& cert : root_der_certs) {
+    scoped_refptr<net::X509Certificate> x509_root =
+        net::X509Certificate::CreateFromBytes(cert.der_cert.data(),
+                                              cert.der_cert.size());
+    if (!x509_root)
+      PrintCertError("ERROR: X509Certificate::CreateFromBytes failed:", cert);
+    else
+      x509_additional_trust_anchors.push_back(x509_root);
+  }
+
+  // |results[i][j]| is the outcome of verifying |entries[j]| with
+  // |verifiers[i]|.
+  std::vector<std::vector<BatchResult>> results(verifiers.size());
+  for (size_t i = 0; i < verifiers.size(); ++i) {
+    results[i].resize(entries.size());
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    std::vector<std::unique_ptr<base::Thread>> threads;
+    for (int t = 0; t < num_threads; ++t) {
+      threads.push_back(std::make_unique<base::Thread>(
+          "VerifyBatch" + base::IntToString(t)));
+      CHECK(threads.back()->Start());
+      threads.back()->task_runner()->PostTask(
+          FROM_HERE,
+          base::BindOnce(&VerifyEntries,
+                         base::Unretained(verifiers[i].proc.get()),
+                         &x509_additional_trust_anchors, &entries, t,
+                         num_threads, &results[i]));
+    }
+    // Stop() runs the posted tasks to completion.
+    for (auto& thread : threads)
+      thread->Stop();
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    if (i != 0)
+      std::cout << "\n";
+    std::cout << verifiers[i].name << " on " << num_threads << " threads:\n";
+    PrintStats(results[i], elapsed);
+  }
+
+  size_t num_disagreements = 0;
+  for (size_t j = 0; j < entries.size(); ++j) {
+    bool disagree = false;
+    for (size_t i = 1; i < verifiers.size(); ++i)
+      disagree |= results[i][j].error != results[0][j].error;
+    if (!disagree)
+      continue;
+
+    if (num_disagreements++ == 0)
+      std::cout << "\nDisagreements:\n";
+    std::cout << " " << entries[j].chain_path.value() << " "
+              << entries[j].hostname << ":";
+    for (size_t i = 0; i < verifiers.size(); ++i) {
+      std::cout << " " << verifiers[i].name << "="
+                << net::ErrorToShortString(results[i][j].error);
+    }
+    std::cout << "\n";
+  }
+  if (verifiers.size() > 1 && num_disagreements == 0)
+    std::cout << "\nNo disagreements.\n";
+
+  return true;
+}
@@ -0,0 +1,50 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_CERT_VERIFY_TOOL_VERIFY_BATCH_H_
+#define NET_TOOLS_CERT_VERIFY_TOOL_VERIFY_BATCH_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace net {
+class CertVerifyProc;
+}
+
+struct CertInput;
+
+// A CertVerifyProc to run a batch with, and the name to report it under.
+struct BatchVerifier {
+  BatchVerifier(const std::string& name,
+                scoped_refptr<net::CertVerifyProc> proc);
+  BatchVerifier(const BatchVerifier& other);
+  ~BatchVerifier();
+
+  std::string name;
+  scoped_refptr<net::CertVerifyProc> proc;
+};
+
+// Verifies every chain listed in |batch_path| with each of |verifiers| in
+// turn, spreading the chains over |num_threads| threads. Each line of the
+// file names a chain file, relative to the directory of |batch_path|, and
+// the hostname to verify it for, separated by whitespace. Empty lines and
+// lines starting with '#' are ignored. |intermediate_der_certs| are added to
+// every chain.
+//
+// Prints the throughput and latency percentiles of each verifier, followed
+// by the chains on which the verifiers' results differ. Returns false if the
+// batch could not be read.
+bool VerifyBatch(const base::FilePath& batch_path,
+                 const std::vector<BatchVerifier>& verifiers,
+                 const std::vector<CertInput>& intermediate_der_certs,
+                 const std::vector<CertInput>& root_der_certs,
+                 int num_threads);
+
+#endif  // NET_TOOLS_CERT_VERIFY_TOOL_VERIFY_BATCH_H_
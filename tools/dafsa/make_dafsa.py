@@ -438,8 +438,10 @@ def words_to_cxx(words):
   return to_cxx(encode(dafsa))
 
 
-def parse_gperf(infile):
-  """Parses gperf file and extract strings and return code"""
+def parse_gperf(infile, reverse=False):
+  """Parses gperf file and extract strings and return code. If |reverse| is
+  true, the strings are reversed so that the DAFSA can be used to look up
+  suffixes by reading keys backwards."""
   lines = [line.strip() for line in infile]
   # Extract strings after the first '%%' and before the second '%%'.
   begin = lines.index('%%') + 1
@@ -453,15 +455,18 @@ def parse_gperf(infile):
     if not line.endswith(('0', '1', '2', '3', '4', '5', '6', '7')):
       raise InputError('Expected value to be in the range of 0-7, found "%s"' %
                        line[-1])
+  if reverse:
+    return [line[-4::-1] + line[-1] for line in lines]
   return [line[:-3] + line[-1] for line in lines]
 
 
 def main():
-  if len(sys.argv) != 3:
-    print('usage: %s infile outfile' % sys.argv[0])
+  reverse = len(sys.argv) == 4 and sys.argv[1] == '--reverse'
+  if len(sys.argv) != 3 and not reverse:
+    print('usage: %s [--reverse] infile outfile' % sys.argv[0])
     return 1
-  with open(sys.argv[1], 'r') as infile, open(sys.argv[2], 'w') as outfile:
-    outfile.write(words_to_cxx(parse_gperf(infile)))
+  with open(sys.argv[-2], 'r') as infile, open(sys.argv[-1], 'w') as outfile:
+    outfile.write(words_to_cxx(parse_gperf(infile, reverse)))
   return 0
 
 
@@ -70,6 +70,12 @@ class ParseGperfTest(unittest.TestCase):
     words = [ 'apa1', 'bepa.com2' ]
     self.assertEqual(make_dafsa.parse_gperf(infile), words)
 
+  def testReversedWords(self):
+    """Tests that keys can be reversed, keeping the return value last."""
+    infile = [ '%%', 'apa, 1', 'bepa.com, 2', '%%' ]
+    words = [ 'apa1', 'moc.apeb2' ]
+    self.assertEqual(make_dafsa.parse_gperf(infile, True), words)
+
 
 class ToDafsaTest(unittest.TestCase):
   def testEmptyInput(self):
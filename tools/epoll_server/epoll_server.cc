@@ -82,6 +82,7 @@ class ReadPipeCallback : public EpollCallbackInterface {
 EpollServer::EpollServer()
   : epoll_fd_(epoll_create(1024)),
     timeout_in_us_(0),
+    busy_poll_period_us_(0),
     recorded_now_in_us_(0),
     ready_list_size_(0),
     wake_cb_(new ReadPipeCallback),
@@ -631,11 +632,32 @@ void EpollServer::WaitForEventsAndCallHandleEvents(int64_t timeout_in_us,
       timeout_in_us = 1000;
     }
   }
-  const int timeout_in_ms = timeout_in_us / 1000;
-  int nfds = epoll_wait_impl(epoll_fd_,
-                             events,
-                             events_size,
-                             timeout_in_ms);
+  int timeout_in_ms = timeout_in_us / 1000;
+  int nfds = 0;
+  bool spun_for_whole_timeout = false;
+  if (timeout_in_ms != 0 && busy_poll_period_us_ > 0) {
+    // Spin on non-blocking polls before sleeping, for at most the timeout.
+    int64_t spin_period_in_us = busy_poll_period_us_;
+    if (timeout_in_us > 0)
+      spin_period_in_us = std::min(spin_period_in_us, timeout_in_us);
+    const int64_t spin_start_in_us = NowInUsec();
+    int64_t spun_in_us = 0;
+    do {
+      nfds = epoll_wait_impl(epoll_fd_, events, events_size, 0);
+      spun_in_us = NowInUsec() - spin_start_in_us;
+    } while (nfds == 0 && spun_in_us < spin_period_in_us);
+    if (timeout_in_us > 0) {
+      timeout_in_ms = (timeout_in_us - std::min(spun_in_us, timeout_in_us)) /
+                      1000;
+      spun_for_whole_timeout = timeout_in_ms == 0;
+    }
+  }
+  if (nfds == 0 && !spun_for_whole_timeout) {
+    nfds = epoll_wait_impl(epoll_fd_,
+                           events,
+                           events_size,
+                           timeout_in_ms);
+  }
   VLOG(3) << "nfds=" << nfds;
 
 #ifdef EPOLL_SERVER_EVENT_TRACING
@@ -163,7 +163,12 @@ class EpollServer {
   //   cb - an instance of a subclass of EpollCallbackInterface
   //   event_mask - a combination of (EPOLLOUT, EPOLLIN.. etc) indicating
   //                the events for which the callback would like to be
-  //                called.
+  //                called. EPOLLET makes the registration edge-triggered,
+  //                in which case the callback must drain 'fd' each time it
+  //                is called. EPOLLEXCLUSIVE may be used for a listening fd
+  //                shared by several EpollServers, but the kernel rejects
+  //                changing its mask, so the Start/Stop and Modify calls must
+  //                not be used on such an fd.
   virtual void RegisterFD(int fd, CB* cb, int event_mask);
 
   ////////////////////////////////////////
@@ -473,6 +478,24 @@ class EpollServer {
   //   Accessor for the current value of timeout_in_us.
   int timeout_in_us() const { return timeout_in_us_; }
 
+  ////////////////////////////////////////
+
+  // Summary:
+  //   Sets the amount of time for which WaitForEventsAndExecuteCallbacks()
+  //   polls for events without blocking before it goes to sleep in
+  //   epoll_wait(). Spinning trades CPU time for lower wakeup latency, since
+  //   events which arrive while spinning skip the scheduler wakeup. The spin
+  //   never lasts longer than the timeout. Zero, the default, disables it.
+  //   The period is measured with NowInUsec(), so it must not be used with a
+  //   clock which does not advance.
+  //  Args:
+  //    busy_poll_period_us - the maximum time to spin, in microseconds.
+  void set_busy_poll_period_us(int64_t busy_poll_period_us) {
+    busy_poll_period_us_ = busy_poll_period_us;
+  }
+
+  int64_t busy_poll_period_us() const { return busy_poll_period_us_; }
+
   // Summary:
   // Returns true when the EpollServer() is being destroyed.
   bool in_shutdown() const { return in_shutdown_; }
@@ -677,6 +700,10 @@ class EpollServer {
   // If this is zero, never wait for an event.
   int64_t timeout_in_us_;
 
+  // The amount of time in microseconds for which to poll without blocking
+  // before sleeping in epoll_wait. Zero means never spin.
+  int64_t busy_poll_period_us_;
+
   // This is nonzero only after the invocation of epoll_wait_impl within
   // WaitForEventsAndCallHandleEvents and before the function
   // WaitForEventsAndExecuteCallbacks returns.  At all other times, this is
@@ -0,0 +1,125 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/epoll_server/epoll_server.h"
+
+#include <unistd.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "net/tools/quic/test_tools/mock_epoll_server.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+// Each non-blocking epoll_wait() takes this long on the fake clock.
+const int64_t kPollTimeUs = 1000;
+
+// Records the timeout of each epoll_wait() call. Calls report an event on
+// |fd| once |events_after_calls| calls found none.
+class PollRecordingEpollServer : public FakeTimeEpollServer {
+ public:
+  PollRecordingEpollServer() : fd_(-1), events_after_calls_(-1) {}
+
+  void set_event(int fd, int events_after_calls) {
+    fd_ = fd;
+    events_after_calls_ = events_after_calls;
+  }
+
+  const std::vector<int>& timeouts_in_ms() const { return timeouts_in_ms_; }
+
+ protected:
+  int epoll_wait_impl(int epfd,
+                      struct epoll_event* events,
+                      int max_events,
+                      int timeout_in_ms) override {
+    timeouts_in_ms_.push_back(timeout_in_ms);
+    AdvanceBy(timeout_in_ms == 0 ? kPollTimeUs : timeout_in_ms * 1000);
+    if (events_after_calls_ < 0 ||
+        static_cast<int>(timeouts_in_ms_.size()) <= events_after_calls_) {
+      return 0;
+    }
+    events[0].events = EPOLLIN;
+    events[0].data.fd = fd_;
+    events_after_calls_ = -1;
+    return 1;
+  }
+
+ private:
+  int fd_;
+  int events_after_calls_;
+  std::vector<int> timeouts_in_ms_;
+
+  DISALLOW_COPY_AND_ASSIGN(PollRecordingEpollServer);
+};
+
+class CountingCallback : public EpollCallbackInterface {
+ public:
+  CountingCallback() : num_events_(0) {}
+
+  int num_events() const { return num_events_; }
+
+  void OnRegistration(EpollServer* eps, int fd, int event_mask) override {}
+  void OnModification(int fd, int event_mask) override {}
+  void OnEvent(int fd, EpollEvent* event) override { ++num_events_; }
+  void OnUnregistration(int fd, bool replaced) override {}
+  void OnShutdown(EpollServer* eps, int fd) override {}
+
+ private:
+  int num_events_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingCallback);
+};
+
+TEST(EpollServerTest, NoBusyPollByDefault) {
+  PollRecordingEpollServer epoll_server;
+  epoll_server.set_timeout_in_us(10000);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(std::vector<int>({10}), epoll_server.timeouts_in_ms());
+}
+
+// Tests that the time spent spinning is subtracted from the blocking wait.
+TEST(EpollServerTest, BusyPollBeforeBlocking) {
+  PollRecordingEpollServer epoll_server;
+  epoll_server.set_timeout_in_us(10000);
+  epoll_server.set_busy_poll_period_us(3 * kPollTimeUs);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(std::vector<int>({0, 0, 0, 7}), epoll_server.timeouts_in_ms());
+}
+
+// Tests that spinning never lasts longer than the timeout, and that no
+// blocking wait follows a spin which used up the whole timeout.
+TEST(EpollServerTest, BusyPollBoundedByTimeout) {
+  PollRecordingEpollServer epoll_server;
+  epoll_server.set_timeout_in_us(3 * kPollTimeUs);
+  epoll_server.set_busy_poll_period_us(10 * kPollTimeUs);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(std::vector<int>({0, 0, 0}), epoll_server.timeouts_in_ms());
+}
+
+// Tests that events found while spinning are handled without blocking.
+TEST(EpollServerTest, BusyPollFindsEvents) {
+  int pipe_fds[2];
+  ASSERT_EQ(0, pipe(pipe_fds));
+  CountingCallback callback;
+  PollRecordingEpollServer epoll_server;
+  epoll_server.RegisterFD(pipe_fds[0], &callback, EPOLLIN);
+  epoll_server.set_event(pipe_fds[0], 1);
+  epoll_server.set_timeout_in_us(10000);
+  epoll_server.set_busy_poll_period_us(3 * kPollTimeUs);
+  epoll_server.WaitForEventsAndExecuteCallbacks();
+  EXPECT_EQ(std::vector<int>({0, 0}), epoll_server.timeouts_in_ms());
+  EXPECT_EQ(1, callback.num_events());
+
+  epoll_server.UnregisterFD(pipe_fds[0]);
+  close(pipe_fds[0]);
+  close(pipe_fds[1]);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
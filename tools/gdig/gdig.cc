@@ -4,16 +4,20 @@
 
 #include <stdio.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "base/at_exit.h"
+#include "base/auto_reset.h"
 #include "base/bind.h"
 #include "base/cancelable_callback.h"
 #include "base/command_line.h"
 #include "base/files/file_util.h"
 #include "base/location.h"
+#include "base/macros.h"
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
 #include "base/single_thread_task_runner.h"
@@ -36,6 +40,8 @@
 #include "net/dns/host_resolver_impl.h"
 #include "net/log/net_log.h"
 #include "net/log/net_log_capture_mode.h"
+#include "net/log/net_log_entry.h"
+#include "net/log/net_log_event_type.h"
 #include "net/log/net_log_source_type.h"
 #include "net/log/net_log_with_source.h"
 #include "net/tools/gdig/file_net_log.h"
@@ -190,6 +196,83 @@ bool LoadReplayLog(const base::FilePath& file_path, ReplayLog* replay_log) {
   return !bad_parse;
 }
 
+// Loads a list of domain names, one per line, and fills |replay_log| with
+// |repeat| passes over them. If |qps| is positive, the resolutions are
+// scheduled |qps| per second regardless of how long they take, so that the
+// load doesn't depend on the latency being measured; otherwise they run
+// closed-loop, see GDig::ReplayNextEntry().
+bool LoadHostsFile(const base::FilePath& file_path,
+                   int qps,
+                   int repeat,
+                   ReplayLog* replay_log) {
+  std::string contents;
+  if (!base::ReadFileToString(file_path, &contents)) {
+    fprintf(stderr, "Unable to open hosts file %s\n",
+            file_path.MaybeAsASCII().c_str());
+    return false;
+  }
+
+  std::vector<std::string> names = base::SplitString(
+      contents, "\r\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (names.empty()) {
+    fprintf(stderr, "No domain names in hosts file %s\n",
+            file_path.MaybeAsASCII().c_str());
+    return false;
+  }
+
+  for (int pass = 0; pass < repeat; ++pass) {
+    for (const std::string& name : names) {
+      ReplayLogEntry entry;
+      if (qps > 0) {
+        entry.start_time = base::TimeDelta::FromMicroseconds(
+            replay_log->size() * base::Time::kMicrosecondsPerSecond / qps);
+      }
+      entry.domain_name = name;
+      replay_log->push_back(entry);
+    }
+  }
+  return true;
+}
+
+// Counts the DnsTransaction events, to tell how often the async resolver had
+// to retry a query, whether on the same or a fallback server, or to fall back
+// to TCP.
+class DnsTransactionCounter : public NetLog::ThreadSafeObserver {
+ public:
+  DnsTransactionCounter() : queries_(0), udp_attempts_(0), tcp_attempts_(0) {}
+  ~DnsTransactionCounter() override {}
+
+  // NetLog::ThreadSafeObserver implementation. OnAddEntry() is never called
+  // concurrently, and the counters are only read once resolution is done.
+  void OnAddEntry(const NetLogEntry& entry) override {
+    switch (entry.type()) {
+      case NetLogEventType::DNS_TRANSACTION_QUERY:
+        if (entry.phase() == NetLogEventPhase::BEGIN)
+          ++queries_;
+        break;
+      case NetLogEventType::DNS_TRANSACTION_ATTEMPT:
+        ++udp_attempts_;
+        break;
+      case NetLogEventType::DNS_TRANSACTION_TCP_ATTEMPT:
+        ++tcp_attempts_;
+        break;
+      default:
+        break;
+    }
+  }
+
+  int queries() const { return queries_; }
+  int udp_attempts() const { return udp_attempts_; }
+  int tcp_attempts() const { return tcp_attempts_; }
+
+ private:
+  int queries_;
+  int udp_attempts_;
+  int tcp_attempts_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTransactionCounter);
+};
+
 class GDig {
  public:
   GDig();
@@ -216,6 +299,11 @@ class GDig {
                          base::TimeDelta time_since_start, int val);
   void OnTimeout();
   void ReplayNextEntry();
+  void PrintBenchmarkStats();
+
+  // Whether the next resolution is started when one completes, rather than
+  // at the start time of its entry.
+  bool IsClosedLoop() const { return benchmark_ && target_qps_ == 0; }
 
   base::TimeDelta config_timeout_;
   bool print_config_;
@@ -223,18 +311,31 @@ class GDig {
   net::IPEndPoint nameserver_;
   base::TimeDelta timeout_;
   int parallellism_;
+  bool use_system_resolver_;
   ReplayLog replay_log_;
   unsigned replay_log_index_;
   base::Time start_time_;
   int active_resolves_;
+  // Set while ReplayNextEntry() runs, so that resolutions completing
+  // synchronously don't call it again.
+  bool replaying_;
   Result result_;
 
+  // Set when resolving a --hosts_file, to print statistics at the end.
+  bool benchmark_;
+  int target_qps_;
+  std::vector<base::TimeDelta> resolve_times_;
+  int synchronous_resolves_;
+  int failed_resolves_;
+
   base::CancelableClosure timeout_closure_;
   std::unique_ptr<DnsConfigService> dns_config_service_;
   std::unique_ptr<FileNetLogObserver> log_observer_;
+  std::unique_ptr<DnsTransactionCounter> transaction_counter_;
   std::unique_ptr<NetLog> log_;
   std::unique_ptr<HostResolver> resolver_;
-  std::unique_ptr<HostResolver::Request> request_;
+  // The pending requests, indexed like |replay_log_|.
+  std::vector<std::unique_ptr<HostResolver::Request>> requests_;
 
 #if defined(OS_MACOSX)
   // Without this there will be a mem leak on osx.
@@ -250,13 +351,21 @@ GDig::GDig()
       print_config_(false),
       print_hosts_(false),
       parallellism_(6),
+      use_system_resolver_(false),
       replay_log_index_(0u),
-      active_resolves_(0) {
+      active_resolves_(0),
+      replaying_(false),
+      benchmark_(false),
+      target_qps_(0),
+      synchronous_resolves_(0),
+      failed_resolves_(0) {
 }
 
 GDig::~GDig() {
-  if (log_)
+  if (log_observer_)
     log_->RemoveObserver(log_observer_.get());
+  if (transaction_counter_)
+    log_->RemoveObserver(transaction_counter_.get());
 }
 
 GDig::Result GDig::Main(int argc, const char* argv[]) {
@@ -268,7 +377,9 @@ GDig::Result GDig::Main(int argc, const char* argv[]) {
               " [--timeout=<milliseconds>]"
               " [--config_timeout=<seconds>]"
               " [--j=<parallel resolves>]"
+              " [--resolver=<async|system>]"
               " [--replay_file=<path>]"
+              " [--hosts_file=<path> [--qps=<n>] [--repeat=<n>]]"
               " [domain_name]\n",
               argv[0]);
       return RESULT_WRONG_USAGE;
@@ -353,6 +464,16 @@ bool GDig::ParseCommandLine(int argc, const char* argv[]) {
     }
   }
 
+  if (parsed_command_line.HasSwitch("resolver")) {
+    std::string resolver = parsed_command_line.GetSwitchValueASCII("resolver");
+    if (resolver == "system") {
+      use_system_resolver_ = true;
+    } else if (resolver != "async") {
+      fprintf(stderr, "Invalid resolver parameter\n");
+      return false;
+    }
+  }
+
   if (parsed_command_line.HasSwitch("replay_file")) {
     base::FilePath replay_path =
         parsed_command_line.GetSwitchValuePath("replay_file");
@@ -360,6 +481,39 @@ bool GDig::ParseCommandLine(int argc, const char* argv[]) {
       return false;
   }
 
+  if (parsed_command_line.HasSwitch("hosts_file")) {
+    if (!replay_log_.empty()) {
+      fprintf(stderr, "Only one of replay_file and hosts_file can be used\n");
+      return false;
+    }
+    int repeat = 1;
+    if (parsed_command_line.HasSwitch("qps") &&
+        (!base::StringToInt(parsed_command_line.GetSwitchValueASCII("qps"),
+                            &target_qps_) ||
+         target_qps_ <= 0)) {
+      fprintf(stderr, "Invalid qps parameter\n");
+      return false;
+    }
+    if (parsed_command_line.HasSwitch("repeat") &&
+        (!base::StringToInt(parsed_command_line.GetSwitchValueASCII("repeat"),
+                            &repeat) ||
+         repeat <= 0)) {
+      fprintf(stderr, "Invalid repeat parameter\n");
+      return false;
+    }
+    if (!LoadHostsFile(parsed_command_line.GetSwitchValuePath("hosts_file"),
+                       target_qps_, repeat, &replay_log_)) {
+      return false;
+    }
+    benchmark_ = true;
+
+    if (!log_)
+      log_.reset(new NetLog);
+    transaction_counter_.reset(new DnsTransactionCounter);
+    log_->AddObserver(transaction_counter_.get(),
+                      NetLogCaptureMode::Default());
+  }
+
   if (parsed_command_line.HasSwitch("j")) {
     int parallellism = 0;
     bool parsed = base::StringToInt(
@@ -432,26 +586,45 @@ void GDig::OnDnsConfig(const DnsConfig& dns_config_const) {
     return;
   }
 
-  std::unique_ptr<DnsClient> dns_client(DnsClient::CreateClient(NULL));
-  dns_client->SetConfig(dns_config);
   HostResolver::Options options;
   options.max_concurrent_resolves = parallellism_;
   options.max_retry_attempts = 1u;
   std::unique_ptr<HostResolverImpl> resolver(
       new HostResolverImpl(options, log_.get()));
-  resolver->SetDnsClient(std::move(dns_client));
+  if (!use_system_resolver_) {
+    std::unique_ptr<DnsClient> dns_client(DnsClient::CreateClient(NULL));
+    dns_client->SetConfig(dns_config);
+    resolver->SetDnsClient(std::move(dns_client));
+  }
+  // With --qps, resolutions are started whether or not the earlier ones have
+  // completed. Let them all queue rather than fail once the resolver falls
+  // more than max_queued_jobs behind.
+  if (benchmark_ && !IsClosedLoop())
+    resolver->SetMaxQueuedJobs(replay_log_.size());
   resolver_ = std::move(resolver);
 
+  requests_.resize(replay_log_.size());
+  resolve_times_.reserve(replay_log_.size());
   start_time_ = base::Time::Now();
 
   ReplayNextEntry();
 }
 
+// Without --qps, a --hosts_file is resolved closed-loop: at most --j
+// resolutions are outstanding, and the next one starts when one completes.
+// This keeps the resolver's job queue, which holds max_queued_jobs entries,
+// from overflowing, and lets the later --repeat passes over a list longer
+// than --j be served from the host cache instead of joining jobs still in
+// flight.
 void GDig::ReplayNextEntry() {
   DCHECK_LT(replay_log_index_, replay_log_.size());
+  DCHECK(!replaying_);
+  base::AutoReset<bool> replaying(&replaying_, true);
 
   base::TimeDelta time_since_start = base::Time::Now() - start_time_;
   while (replay_log_index_ < replay_log_.size()) {
+    if (IsClosedLoop() && active_resolves_ >= parallellism_)
+      return;
     const ReplayLogEntry& entry = replay_log_[replay_log_index_];
     if (time_since_start < entry.start_time) {
       // Delay call to next time and return.
@@ -472,10 +645,13 @@ void GDig::ReplayNextEntry() {
     ++active_resolves_;
     ++replay_log_index_;
     int ret = resolver_->Resolve(
-        info, DEFAULT_PRIORITY, addrlist, callback, &request_,
+        info, DEFAULT_PRIORITY, addrlist, callback, &requests_[current_index],
         NetLogWithSource::Make(log_.get(), net::NetLogSourceType::NONE));
-    if (ret != ERR_IO_PENDING)
+    if (ret != ERR_IO_PENDING) {
+      // E.g. served from the host cache, the hosts file or an IP literal.
+      ++synchronous_resolves_;
       callback.Run(ret);
+    }
   }
 }
 
@@ -487,8 +663,12 @@ void GDig::OnResolveComplete(unsigned entry_index,
   DCHECK(address_list);
   DCHECK_LT(entry_index, replay_log_.size());
   --active_resolves_;
+  requests_[entry_index].reset();
   base::TimeDelta resolve_end_time = base::Time::Now() - start_time_;
   base::TimeDelta resolve_time = resolve_end_time - resolve_start_time;
+  resolve_times_.push_back(resolve_time);
+  if (val != OK)
+    ++failed_resolves_;
   printf("%u %d %d %s %d ",
          entry_index,
          static_cast<int>(resolve_end_time.InMilliseconds()),
@@ -505,8 +685,46 @@ void GDig::OnResolveComplete(unsigned entry_index,
     }
   }
   printf("\n");
-  if (active_resolves_ == 0 && replay_log_index_ >= replay_log_.size())
+  if (IsClosedLoop() && !replaying_ &&
+      replay_log_index_ < replay_log_.size()) {
+    ReplayNextEntry();
+  }
+  if (active_resolves_ == 0 && replay_log_index_ >= replay_log_.size()) {
+    if (benchmark_)
+      PrintBenchmarkStats();
     Finish(RESULT_OK);
+  }
+}
+
+void GDig::PrintBenchmarkStats() {
+  base::TimeDelta elapsed = base::Time::Now() - start_time_;
+  size_t count = resolve_times_.size();
+  printf("# Benchmark\n");
+  printf("resolves %u in %d ms: %.1f/s", static_cast<unsigned>(count),
+         static_cast<int>(elapsed.InMilliseconds()),
+         count / std::max(elapsed.InSecondsF(), 0.001));
+  if (target_qps_ > 0)
+    printf(" (target %d/s)", target_qps_);
+  printf("\n");
+  printf("synchronous %d (%.1f%%), failed %d\n", synchronous_resolves_,
+         100.0 * synchronous_resolves_ / count, failed_resolves_);
+
+  std::sort(resolve_times_.begin(), resolve_times_.end());
+  auto percentile = [this, count](size_t p) {
+    return static_cast<int>(
+        resolve_times_[(count - 1) * p / 100].InMilliseconds());
+  };
+  printf("latency ms p50 %d p90 %d p99 %d max %d\n", percentile(50),
+         percentile(90), percentile(99),
+         static_cast<int>(resolve_times_.back().InMilliseconds()));
+
+  if (!use_system_resolver_) {
+    int queries = transaction_counter_->queries();
+    printf("dns queries %d, udp attempts %d (%.2f per query), tcp %d\n",
+           queries, transaction_counter_->udp_attempts(),
+           queries ? 1.0 * transaction_counter_->udp_attempts() / queries : 0,
+           transaction_counter_->tcp_attempts());
+  }
 }
 
 void GDig::OnTimeout() {
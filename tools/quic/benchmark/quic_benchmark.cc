@@ -0,0 +1,454 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/benchmark/quic_benchmark.h"
+
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include "base/strings/string_number_conversions.h"
+#include "net/quic/core/crypto/quic_crypto_server_config.h"
+#include "net/quic/core/quic_config.h"
+#include "net/quic/core/quic_server_id.h"
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_socket_address.h"
+#include "net/quic/platform/api/quic_test_loopback.h"
+#include "net/quic/test_tools/crypto_test_utils.h"
+#include "net/tools/epoll_server/epoll_server.h"
+#include "net/tools/quic/quic_epoll_alarm_factory.h"
+#include "net/tools/quic/quic_epoll_connection_helper.h"
+#include "net/tools/quic/quic_dispatcher.h"
+#include "net/tools/quic/quic_http_response_cache.h"
+#include "net/tools/quic/quic_server.h"
+#include "net/tools/quic/quic_spdy_client_stream.h"
+#include "net/tools/quic/test_tools/packet_dropping_test_writer.h"
+#include "net/tools/quic/test_tools/quic_dispatcher_peer.h"
+#include "net/tools/quic/test_tools/quic_server_peer.h"
+#include "net/tools/quic/test_tools/quic_test_client.h"
+#include "net/tools/quic/test_tools/server_thread.h"
+
+namespace net {
+
+using test::PacketDroppingTestWriter;
+
+namespace {
+
+const char kHost[] = "test.example.com";
+const char kPath[] = "/benchmark";
+
+// How long the client event loop waits for events before checking whether
+// the run is done.
+const int64_t kEventLoopTimeoutUs = 10 * 1000;
+
+class ServerDelegate : public PacketDroppingTestWriter::Delegate {
+ public:
+  explicit ServerDelegate(QuicDispatcher* dispatcher)
+      : dispatcher_(dispatcher) {}
+  ~ServerDelegate() override = default;
+  void OnCanWrite() override { dispatcher_->OnCanWrite(); }
+
+ private:
+  QuicDispatcher* dispatcher_;
+};
+
+class ClientDelegate : public PacketDroppingTestWriter::Delegate {
+ public:
+  explicit ClientDelegate(QuicClient* client) : client_(client) {}
+  ~ClientDelegate() override = default;
+  void OnCanWrite() override {
+    EpollEvent event(EPOLLOUT);
+    client_->epoll_network_helper()->OnEvent(client_->GetLatestFD(), &event);
+  }
+
+ private:
+  QuicClient* client_;
+};
+
+bool IsImpaired(const QuicBenchmark::Options& options) {
+  return options.packet_loss_percentage > 0 || !options.packet_delay.IsZero() ||
+         !options.bandwidth.IsZero();
+}
+
+// Applies the impairments in |options| to |writer|, which must have been
+// initialized.
+void ConfigureWriter(const QuicBenchmark::Options& options,
+                     uint64_t seed,
+                     PacketDroppingTestWriter* writer) {
+  writer->set_seed(seed);
+  writer->set_fake_packet_loss_percentage(options.packet_loss_percentage);
+  if (!options.packet_delay.IsZero()) {
+    writer->set_fake_packet_delay(options.packet_delay);
+    writer->set_fake_reorder_percentage(options.packet_reorder_percentage);
+  }
+  if (!options.bandwidth.IsZero()) {
+    writer->set_max_bandwidth_and_buffer_size(options.bandwidth,
+                                              options.buffer_size);
+  }
+}
+
+base::TimeDelta GetCpuTime() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    QUIC_LOG(ERROR) << "getrusage() failed, errno: " << errno;
+    return base::TimeDelta();
+  }
+  return base::TimeDelta::FromSeconds(usage.ru_utime.tv_sec +
+                                      usage.ru_stime.tv_sec) +
+         base::TimeDelta::FromMicroseconds(usage.ru_utime.tv_usec +
+                                           usage.ru_stime.tv_usec);
+}
+
+// One benchmark connection, which keeps up to
+// |Options::max_streams_per_client| requests in flight until it has sent its
+// share of them.
+class BenchmarkClient {
+ public:
+  BenchmarkClient(const QuicSocketAddress& server_address,
+                  const QuicBenchmark::Options& options,
+                  size_t num_requests,
+                  uint64_t seed,
+                  EpollServer* epoll_server,
+                  QuicConnectionHelperInterface* helper,
+                  QuicAlarmFactory* alarm_factory,
+                  QuicBenchmark::Results* results)
+      : options_(options), requests_to_send_(num_requests), results_(results) {
+    client_ = QuicMakeUnique<test::MockableQuicClient>(
+        server_address,
+        QuicServerId(kHost, server_address.port(), PRIVACY_MODE_DISABLED),
+        QuicConfig(), QuicTransportVersionVector{options.version},
+        epoll_server, test::crypto_test_utils::ProofVerifierForTesting());
+    client_->set_store_response(false);
+    client_->set_response_listener(QuicMakeUnique<Listener>(this));
+    if (IsImpaired(options)) {
+      PacketDroppingTestWriter* writer = new PacketDroppingTestWriter();
+      writer->Initialize(helper, alarm_factory,
+                         new ClientDelegate(client_.get()));
+      ConfigureWriter(options, seed, writer);
+      // Owned by |client_| once it connects.
+      client_->UseWriter(writer);
+    }
+  }
+
+  ~BenchmarkClient() {
+    if (client_->connected()) {
+      client_->Disconnect();
+    }
+  }
+
+  bool StartConnect() {
+    if (!client_->Initialize()) {
+      return false;
+    }
+    client_->StartConnect();
+    return true;
+  }
+
+  // Returns true while the handshake has neither been confirmed nor failed.
+  bool Connecting() {
+    return client_->connected() &&
+           !client_->session()->IsCryptoHandshakeConfirmed();
+  }
+
+  bool HandshakeConfirmed() {
+    return client_->connected() &&
+           client_->session()->IsCryptoHandshakeConfirmed();
+  }
+
+  // Returns true once all requests have been answered, or the connection has
+  // closed.
+  bool Done() {
+    return !client_->connected() ||
+           (requests_to_send_ == 0 && send_times_.empty());
+  }
+
+  // Sends requests until the limit of requests in flight is reached.
+  void SendRequests() {
+    while (requests_to_send_ > 0 &&
+           send_times_.size() < options_.max_streams_per_client) {
+      QuicSpdyClientStream* stream = client_->CreateClientStream();
+      if (stream == nullptr) {
+        return;
+      }
+      SpdyHeaderBlock headers;
+      headers[":method"] = "GET";
+      headers[":scheme"] = "https";
+      headers[":authority"] = kHost;
+      headers[":path"] = kPath;
+      send_times_[stream->id()] = base::TimeTicks::Now();
+      --requests_to_send_;
+      stream->SendRequest(std::move(headers), "", true);
+    }
+  }
+
+ private:
+  class Listener : public QuicSpdyClientBase::ResponseListener {
+   public:
+    explicit Listener(BenchmarkClient* client) : client_(client) {}
+    ~Listener() override = default;
+
+    void OnCompleteResponse(QuicStreamId id,
+                            const SpdyHeaderBlock& response_headers,
+                            const std::string& response_body) override {
+      client_->OnCompleteResponse(id, response_headers, response_body);
+    }
+
+   private:
+    BenchmarkClient* client_;
+  };
+
+  void OnCompleteResponse(QuicStreamId id,
+                          const SpdyHeaderBlock& response_headers,
+                          const std::string& response_body) {
+    auto it = send_times_.find(id);
+    if (it == send_times_.end()) {
+      return;
+    }
+    base::TimeDelta latency = base::TimeTicks::Now() - it->second;
+    send_times_.erase(it);
+
+    auto status = response_headers.find(":status");
+    if (status == response_headers.end() || status->second != "200" ||
+        response_body.size() != options_.response_size) {
+      return;
+    }
+    ++results_->requests_completed;
+    results_->body_bytes_received += response_body.size();
+    results_->latencies.push_back(latency);
+  }
+
+  const QuicBenchmark::Options& options_;
+  std::unique_ptr<test::MockableQuicClient> client_;
+  size_t requests_to_send_;
+  // Send times of the requests in flight.
+  std::map<QuicStreamId, base::TimeTicks> send_times_;
+  QuicBenchmark::Results* results_;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkClient);
+};
+
+}  // namespace
+
+QuicBenchmark::Options::Options()
+    : num_clients(1),
+      num_requests(100),
+      max_streams_per_client(1),
+      response_size(10 * 1024),
+      packet_loss_percentage(0),
+      packet_delay(QuicTime::Delta::Zero()),
+      packet_reorder_percentage(0),
+      bandwidth(QuicBandwidth::Zero()),
+      buffer_size(0),
+      seed(1),
+      version(AllSupportedTransportVersions().front()),
+      timeout(QuicTime::Delta::FromSeconds(60)) {}
+
+QuicBenchmark::Options::Options(const Options& other) = default;
+
+QuicBenchmark::Options::~Options() {}
+
+QuicBenchmark::Results::Results()
+    : handshakes_completed(0),
+      handshakes_failed(0),
+      requests_completed(0),
+      requests_failed(0),
+      body_bytes_received(0) {}
+
+QuicBenchmark::Results::Results(const Results& other) = default;
+
+QuicBenchmark::Results::~Results() {}
+
+// static
+base::TimeDelta QuicBenchmark::Results::Percentile(
+    const std::vector<base::TimeDelta>& latencies,
+    double percentile) {
+  if (latencies.empty()) {
+    return base::TimeDelta();
+  }
+  // Nearest rank, with some slack so that rounding errors in |percentile|
+  // don't move it up a rank.
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile * latencies.size() / 100 - 1e-6));
+  return latencies[std::min(std::max<size_t>(rank, 1), latencies.size()) - 1];
+}
+
+double QuicBenchmark::Results::handshakes_per_second() const {
+  if (handshake_time.is_zero()) {
+    return 0;
+  }
+  return handshakes_completed / handshake_time.InSecondsF();
+}
+
+double QuicBenchmark::Results::requests_per_second() const {
+  if (request_time.is_zero()) {
+    return 0;
+  }
+  return requests_completed / request_time.InSecondsF();
+}
+
+double QuicBenchmark::Results::goodput_bps() const {
+  if (request_time.is_zero()) {
+    return 0;
+  }
+  return body_bytes_received * 8 / request_time.InSecondsF();
+}
+
+double QuicBenchmark::Results::cpu_ns_per_byte() const {
+  if (body_bytes_received == 0) {
+    return 0;
+  }
+  return cpu_time.InSecondsF() * 1e9 / body_bytes_received;
+}
+
+std::unique_ptr<base::DictionaryValue> QuicBenchmark::Results::ToValue()
+    const {
+  auto options_value = QuicMakeUnique<base::DictionaryValue>();
+  options_value->SetInteger("clients", options.num_clients);
+  options_value->SetInteger("requests", options.num_requests);
+  options_value->SetInteger("streams_per_client",
+                            options.max_streams_per_client);
+  options_value->SetInteger("response_size", options.response_size);
+  options_value->SetInteger("loss_percent", options.packet_loss_percentage);
+  options_value->SetDouble("delay_ms",
+                           options.packet_delay.ToMicroseconds() / 1000.0);
+  options_value->SetInteger("reorder_percent",
+                            options.packet_reorder_percentage);
+  options_value->SetDouble("bandwidth_kbps",
+                           options.bandwidth.ToKBitsPerSecond());
+  options_value->SetDouble("buffer_size", options.buffer_size);
+  options_value->SetString("seed", base::NumberToString(options.seed));
+  options_value->SetString("version", QuicVersionToString(options.version));
+
+  auto value = QuicMakeUnique<base::DictionaryValue>();
+  value->Set("options", std::move(options_value));
+  value->SetInteger("handshakes_completed", handshakes_completed);
+  value->SetInteger("handshakes_failed", handshakes_failed);
+  value->SetDouble("handshakes_per_second", handshakes_per_second());
+  value->SetInteger("requests_completed", requests_completed);
+  value->SetInteger("requests_failed", requests_failed);
+  value->SetDouble("requests_per_second", requests_per_second());
+  value->SetDouble("goodput_bps", goodput_bps());
+  value->SetDouble("latency_p50_ms",
+                   Percentile(latencies, 50).InMillisecondsF());
+  value->SetDouble("latency_p99_ms",
+                   Percentile(latencies, 99).InMillisecondsF());
+  value->SetDouble("latency_p999_ms",
+                   Percentile(latencies, 99.9).InMillisecondsF());
+  value->SetDouble("cpu_ns_per_byte", cpu_ns_per_byte());
+  return value;
+}
+
+QuicBenchmark::QuicBenchmark(const Options& options) : options_(options) {
+  DCHECK_GT(options_.num_clients, 0u);
+  DCHECK_GT(options_.max_streams_per_client, 0u);
+}
+
+QuicBenchmark::~QuicBenchmark() {}
+
+QuicBenchmark::Results QuicBenchmark::Run() {
+  Results results;
+  results.options = options_;
+
+  QuicHttpResponseCache response_cache;
+  response_cache.AddSimpleResponse(kHost, kPath, 200,
+                                   std::string(options_.response_size, 'a'));
+
+  test::ServerThread server_thread(
+      new QuicServer(test::crypto_test_utils::ProofSourceForTesting(),
+                     QuicConfig(), QuicCryptoServerConfig::ConfigOptions(),
+                     QuicTransportVersionVector{options_.version},
+                     &response_cache),
+      QuicSocketAddress(TestLoopback(), 0));
+  server_thread.Initialize();
+  if (IsImpaired(options_)) {
+    QuicDispatcher* dispatcher =
+        test::QuicServerPeer::GetDispatcher(server_thread.server());
+    PacketDroppingTestWriter* writer = new PacketDroppingTestWriter();
+    test::QuicDispatcherPeer::UseWriter(dispatcher, writer);
+    writer->Initialize(test::QuicDispatcherPeer::GetHelper(dispatcher),
+                       test::QuicDispatcherPeer::GetAlarmFactory(dispatcher),
+                       new ServerDelegate(dispatcher));
+    ConfigureWriter(options_, options_.seed, writer);
+  }
+  server_thread.Start();
+  QuicSocketAddress server_address(TestLoopback(), server_thread.GetPort());
+
+  EpollServer epoll_server;
+  epoll_server.set_timeout_in_us(kEventLoopTimeoutUs);
+  QuicEpollConnectionHelper helper(&epoll_server, QuicAllocator::SIMPLE);
+  QuicEpollAlarmFactory alarm_factory(&epoll_server);
+  // Destroyed before the helper and alarm factory their writers use.
+  std::vector<std::unique_ptr<BenchmarkClient>> clients;
+  for (size_t i = 0; i < options_.num_clients; ++i) {
+    size_t num_requests = options_.num_requests / options_.num_clients +
+                          (i < options_.num_requests % options_.num_clients);
+    clients.push_back(QuicMakeUnique<BenchmarkClient>(
+        server_address, options_, num_requests, options_.seed + i + 1,
+        &epoll_server, &helper, &alarm_factory, &results));
+  }
+
+  const base::TimeTicks deadline =
+      base::TimeTicks::Now() +
+      base::TimeDelta::FromMicroseconds(options_.timeout.ToMicroseconds());
+
+  // Connect all clients at once, and time until the last handshake finishes.
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (const auto& client : clients) {
+    if (!client->StartConnect()) {
+      QUIC_LOG(ERROR) << "Failed to initialize client.";
+    }
+  }
+  auto connecting = [&clients]() {
+    for (const auto& client : clients) {
+      if (client->Connecting()) {
+        return true;
+      }
+    }
+    return false;
+  };
+  while (connecting() && base::TimeTicks::Now() < deadline) {
+    epoll_server.WaitForEventsAndExecuteCallbacks();
+  }
+  results.handshake_time = base::TimeTicks::Now() - start;
+  for (const auto& client : clients) {
+    if (client->HandshakeConfirmed()) {
+      ++results.handshakes_completed;
+    } else {
+      ++results.handshakes_failed;
+    }
+  }
+
+  // Send the requests.  They are only sent from here, and not as responses
+  // complete, so that none is sent from within a stream's OnClose.
+  base::TimeDelta cpu_start = GetCpuTime();
+  start = base::TimeTicks::Now();
+  while (base::TimeTicks::Now() < deadline) {
+    bool done = true;
+    for (const auto& client : clients) {
+      client->SendRequests();
+      done = done && client->Done();
+    }
+    if (done) {
+      break;
+    }
+    epoll_server.WaitForEventsAndExecuteCallbacks();
+  }
+  results.request_time = base::TimeTicks::Now() - start;
+  results.cpu_time = GetCpuTime() - cpu_start;
+  results.requests_failed = options_.num_requests - results.requests_completed;
+  std::sort(results.latencies.begin(), results.latencies.end());
+
+  clients.clear();
+  server_thread.Quit();
+  server_thread.Join();
+  return results;
+}
+
+}  // namespace net
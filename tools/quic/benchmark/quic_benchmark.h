@@ -0,0 +1,112 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A benchmark which runs an in-process QuicServer and many concurrent
+// QuicClients over loopback, optionally through simulated packet loss, delay,
+// reordering and a bandwidth limit, and measures handshake rate, request rate,
+// goodput, request latency and CPU cost.  The impairments are seeded, so that
+// runs with the same options see the same network.
+
+#ifndef NET_TOOLS_QUIC_BENCHMARK_QUIC_BENCHMARK_H_
+#define NET_TOOLS_QUIC_BENCHMARK_QUIC_BENCHMARK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "net/quic/core/quic_bandwidth.h"
+#include "net/quic/core/quic_time.h"
+#include "net/quic/core/quic_types.h"
+#include "net/quic/core/quic_versions.h"
+
+namespace net {
+
+class QuicBenchmark {
+ public:
+  struct Options {
+    Options();
+    Options(const Options& other);
+    ~Options();
+
+    // The number of clients, each on its own connection.
+    size_t num_clients;
+    // The total number of requests, spread evenly over the clients.
+    size_t num_requests;
+    // The number of requests each client keeps in flight.
+    size_t max_streams_per_client;
+    // The size of each response body, in bytes.
+    size_t response_size;
+
+    // Impairments applied to packets in both directions.
+    int32_t packet_loss_percentage;
+    QuicTime::Delta packet_delay;
+    // Requires a non-zero |packet_delay|.
+    int32_t packet_reorder_percentage;
+    // Unlimited when zero.
+    QuicBandwidth bandwidth;
+    QuicByteCount buffer_size;
+    // Seeds the impairments of the server and of each client.
+    uint64_t seed;
+
+    QuicTransportVersion version;
+    // The run gives up after this long, and reports what completed by then.
+    QuicTime::Delta timeout;
+  };
+
+  struct Results {
+    Results();
+    Results(const Results& other);
+    ~Results();
+
+    // Returns the |percentile| (in [0, 100]) of |latencies|, which must be
+    // sorted.  Returns zero if they are empty.
+    static base::TimeDelta Percentile(
+        const std::vector<base::TimeDelta>& latencies,
+        double percentile);
+
+    double handshakes_per_second() const;
+    double requests_per_second() const;
+    // Response body bits per second.
+    double goodput_bps() const;
+    // CPU time of the whole process, per response body byte.
+    double cpu_ns_per_byte() const;
+
+    // Returns the options and results in a form suitable for writing as JSON.
+    std::unique_ptr<base::DictionaryValue> ToValue() const;
+
+    Options options;
+    size_t handshakes_completed;
+    size_t handshakes_failed;
+    base::TimeDelta handshake_time;
+    size_t requests_completed;
+    size_t requests_failed;
+    uint64_t body_bytes_received;
+    base::TimeDelta request_time;
+    // Sorted.
+    std::vector<base::TimeDelta> latencies;
+    base::TimeDelta cpu_time;
+  };
+
+  explicit QuicBenchmark(const Options& options);
+  ~QuicBenchmark();
+
+  // Starts the server, connects all clients, then sends the requests.  The
+  // handshakes and the requests are timed separately.
+  Results Run();
+
+ private:
+  const Options options_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBenchmark);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_BENCHMARK_QUIC_BENCHMARK_H_
@@ -0,0 +1,164 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A binary wrapper for QuicBenchmark.  Runs a QUIC server and clients in
+// process, and writes the results as JSON to stdout, or to --output.
+//
+// Some usage examples:
+//
+// Many connections with one request in flight each:
+//   epoll_quic_benchmark --clients=100 --requests=10000
+//
+// Few connections multiplexing large responses:
+//   epoll_quic_benchmark --clients=4 --streams=16 --response_size=1048576
+//
+// A lossy, long, narrow path:
+//   epoll_quic_benchmark --loss=2 --delay_ms=50 --bandwidth_kbps=10000
+//                        --buffer_size=100000 --seed=7
+
+#include <iostream>
+#include <string>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "net/tools/quic/benchmark/quic_benchmark.h"
+
+namespace {
+
+// Parses the switch |name| into |value| if it is present.  Returns false if
+// it is present but not a number.
+bool ParseSizeSwitch(const base::CommandLine& line,
+                     const char* name,
+                     size_t* value) {
+  if (!line.HasSwitch(name)) {
+    return true;
+  }
+  if (!base::StringToSizeT(line.GetSwitchValueASCII(name), value)) {
+    std::cerr << "--" << name << " must be a non-negative integer\n";
+    return false;
+  }
+  return true;
+}
+
+bool ParseIntSwitch(const base::CommandLine& line,
+                    const char* name,
+                    int* value) {
+  if (!line.HasSwitch(name)) {
+    return true;
+  }
+  if (!base::StringToInt(line.GetSwitchValueASCII(name), value) ||
+      *value < 0) {
+    std::cerr << "--" << name << " must be a non-negative integer\n";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  base::AtExitManager exit_manager;
+
+  base::CommandLine::Init(argc, argv);
+  base::CommandLine* line = base::CommandLine::ForCurrentProcess();
+
+  logging::LoggingSettings settings;
+  settings.logging_dest = logging::LOG_TO_SYSTEM_DEBUG_LOG;
+  CHECK(logging::InitLogging(settings));
+
+  if (line->HasSwitch("h") || line->HasSwitch("help")) {
+    const char* help_str =
+        "Usage: epoll_quic_benchmark [options]\n"
+        "\n"
+        "Options:\n"
+        "-h, --help                  show this help message and exit\n"
+        "--clients=<n>               number of concurrent connections\n"
+        "--requests=<n>              total number of requests\n"
+        "--streams=<n>               requests in flight per connection\n"
+        "--response_size=<bytes>     size of each response body\n"
+        "--loss=<percent>            packets dropped in each direction\n"
+        "--delay_ms=<ms>             delay added to each packet\n"
+        "--reorder=<percent>         packets sent ahead of the delayed ones,"
+        " requires --delay_ms\n"
+        "--bandwidth_kbps=<kbps>     bandwidth of each direction\n"
+        "--buffer_size=<bytes>       bottleneck buffer, with --bandwidth_kbps\n"
+        "--seed=<n>                  seed of the simulated impairments\n"
+        "--quic-version=<version>    QUIC version to speak\n"
+        "--timeout_s=<s>             give up on the run after this long\n"
+        "--output=<file>             write the JSON results to this file\n";
+    std::cout << help_str;
+    exit(0);
+  }
+
+  net::QuicBenchmark::Options options;
+  int loss = options.packet_loss_percentage;
+  int delay_ms = 0;
+  int reorder = options.packet_reorder_percentage;
+  int bandwidth_kbps = 0;
+  size_t buffer_size = 0;
+  int timeout_s = options.timeout.ToSeconds();
+  if (!ParseSizeSwitch(*line, "clients", &options.num_clients) ||
+      !ParseSizeSwitch(*line, "requests", &options.num_requests) ||
+      !ParseSizeSwitch(*line, "streams", &options.max_streams_per_client) ||
+      !ParseSizeSwitch(*line, "response_size", &options.response_size) ||
+      !ParseIntSwitch(*line, "loss", &loss) ||
+      !ParseIntSwitch(*line, "delay_ms", &delay_ms) ||
+      !ParseIntSwitch(*line, "reorder", &reorder) ||
+      !ParseIntSwitch(*line, "bandwidth_kbps", &bandwidth_kbps) ||
+      !ParseSizeSwitch(*line, "buffer_size", &buffer_size) ||
+      !ParseIntSwitch(*line, "timeout_s", &timeout_s)) {
+    return 1;
+  }
+  if (options.num_clients == 0 || options.max_streams_per_client == 0) {
+    std::cerr << "--clients and --streams must be positive\n";
+    return 1;
+  }
+  if (reorder > 0 && delay_ms == 0) {
+    std::cerr << "--reorder requires --delay_ms\n";
+    return 1;
+  }
+  options.packet_loss_percentage = loss;
+  options.packet_delay = net::QuicTime::Delta::FromMilliseconds(delay_ms);
+  options.packet_reorder_percentage = reorder;
+  options.bandwidth = net::QuicBandwidth::FromKBitsPerSecond(bandwidth_kbps);
+  options.buffer_size = buffer_size;
+  options.timeout = net::QuicTime::Delta::FromSeconds(timeout_s);
+  if (line->HasSwitch("seed") &&
+      !base::StringToUint64(line->GetSwitchValueASCII("seed"),
+                            &options.seed)) {
+    std::cerr << "--seed must be a non-negative integer\n";
+    return 1;
+  }
+  if (line->HasSwitch("quic-version")) {
+    int quic_version;
+    if (!base::StringToInt(line->GetSwitchValueASCII("quic-version"),
+                           &quic_version)) {
+      std::cerr << "--quic-version must be an integer\n";
+      return 1;
+    }
+    options.version = static_cast<net::QuicTransportVersion>(quic_version);
+  }
+
+  net::QuicBenchmark benchmark(options);
+  net::QuicBenchmark::Results results = benchmark.Run();
+
+  std::string json;
+  base::JSONWriter::WriteWithOptions(
+      *results.ToValue(), base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  if (line->HasSwitch("output")) {
+    base::FilePath path = line->GetSwitchValuePath("output");
+    if (base::WriteFile(path, json.data(), json.size()) !=
+        static_cast<int>(json.size())) {
+      std::cerr << "Failed to write " << path.value() << "\n";
+      return 1;
+    }
+  } else {
+    std::cout << json;
+  }
+  return results.requests_failed == 0 ? 0 : 1;
+}
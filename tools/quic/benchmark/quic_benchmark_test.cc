@@ -0,0 +1,79 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/benchmark/quic_benchmark.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+using Results = QuicBenchmark::Results;
+
+class QuicBenchmarkTest : public QuicTest {};
+
+TEST_F(QuicBenchmarkTest, Percentile) {
+  EXPECT_TRUE(Results::Percentile({}, 50).is_zero());
+
+  std::vector<base::TimeDelta> latencies;
+  for (int i = 1; i <= 1000; ++i) {
+    latencies.push_back(base::TimeDelta::FromMilliseconds(i));
+  }
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(1),
+            Results::Percentile(latencies, 0));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(500),
+            Results::Percentile(latencies, 50));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(990),
+            Results::Percentile(latencies, 99));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(999),
+            Results::Percentile(latencies, 99.9));
+  EXPECT_EQ(base::TimeDelta::FromMilliseconds(1000),
+            Results::Percentile(latencies, 100));
+}
+
+TEST_F(QuicBenchmarkTest, Loopback) {
+  QuicBenchmark::Options options;
+  options.num_clients = 2;
+  options.num_requests = 10;
+  options.max_streams_per_client = 3;
+  options.response_size = 4096;
+  Results results = QuicBenchmark(options).Run();
+
+  EXPECT_EQ(2u, results.handshakes_completed);
+  EXPECT_EQ(0u, results.handshakes_failed);
+  EXPECT_EQ(10u, results.requests_completed);
+  EXPECT_EQ(0u, results.requests_failed);
+  EXPECT_EQ(10u * 4096, results.body_bytes_received);
+  ASSERT_EQ(10u, results.latencies.size());
+  EXPECT_TRUE(std::is_sorted(results.latencies.begin(),
+                             results.latencies.end()));
+  EXPECT_LT(0, results.requests_per_second());
+  EXPECT_LT(0, results.goodput_bps());
+}
+
+TEST_F(QuicBenchmarkTest, Impaired) {
+  QuicBenchmark::Options options;
+  options.num_clients = 2;
+  options.num_requests = 10;
+  options.response_size = 20 * 1024;
+  options.packet_loss_percentage = 5;
+  options.packet_delay = QuicTime::Delta::FromMilliseconds(5);
+  options.packet_reorder_percentage = 10;
+  options.seed = 42;
+  Results results = QuicBenchmark(options).Run();
+
+  EXPECT_EQ(2u, results.handshakes_completed);
+  EXPECT_EQ(10u, results.requests_completed);
+  // Every request waits for at least a round trip of simulated delay.
+  EXPECT_LE(base::TimeDelta::FromMilliseconds(10),
+            Results::Percentile(results.latencies, 0));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
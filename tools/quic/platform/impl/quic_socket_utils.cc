@@ -5,6 +5,7 @@
 #include "net/tools/quic/platform/impl/quic_socket_utils.h"
 
 #include <errno.h>
+#include <linux/filter.h>
 #include <linux/net_tstamp.h>
 #include <netinet/in.h>
 #include <string.h>
@@ -23,6 +24,26 @@
 #define SO_RXQ_OVFL 40
 #endif
 
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
 using std::string;
 
 namespace net {
@@ -93,6 +114,22 @@ bool QuicSocketUtils::GetTtlFromMsghdr(struct msghdr* hdr, int* ttl) {
   return false;
 }
 
+// static
+bool QuicSocketUtils::GetGroSegmentSizeFromMsghdr(struct msghdr* hdr,
+                                                  int* segment_size) {
+  if (hdr->msg_controllen > 0) {
+    struct cmsghdr* cmsg;
+    for (cmsg = CMSG_FIRSTHDR(hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(hdr, cmsg)) {
+      if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+        *segment_size = *(reinterpret_cast<int*>(CMSG_DATA(cmsg)));
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 // static
 int QuicSocketUtils::SetGetAddressInfo(int fd, int address_family) {
   int get_local_ip = 1;
@@ -112,6 +149,40 @@ int QuicSocketUtils::SetGetSoftwareReceiveTimestamp(int fd) {
                     sizeof(timestamping));
 }
 
+// static
+bool QuicSocketUtils::EnableUdpGro(int fd) {
+  int enable = 1;
+  return setsockopt(fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+}
+
+// static
+bool QuicSocketUtils::SetReusePort(int fd) {
+  int reuse_port = 1;
+  return setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuse_port,
+                    sizeof(reuse_port)) == 0;
+}
+
+// static
+bool QuicSocketUtils::AttachConnectionIdSteeringProgram(int fd,
+                                                        size_t num_sockets) {
+  DCHECK_GT(num_sockets, 0u);
+  // Reuseport programs see the UDP payload.  The public header is one byte of
+  // flags followed by the 8 byte connection ID, so bytes 5 to 8 hold its low
+  // 32 bits.  A failed load (a short packet) returns 0.
+  sock_filter code[] = {
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 5),
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, static_cast<uint32_t>(num_sockets)),
+      BPF_STMT(BPF_RET | BPF_A, 0),
+  };
+  sock_fprog program = {static_cast<unsigned short>(arraysize(code)), code};
+  if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program,
+                 sizeof(program)) != 0) {
+    LOG(ERROR) << "Failed to attach reuseport program: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
 // static
 bool QuicSocketUtils::SetSendBufferSize(int fd, size_t size) {
   if (setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) != 0) {
@@ -272,6 +343,102 @@ WriteResult QuicSocketUtils::WritePacket(
                      errno);
 }
 
+// static
+WriteResult QuicSocketUtils::WritePacketsWithGso(
+    int fd,
+    const char* buffer,
+    size_t buf_len,
+    size_t segment_size,
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  DCHECK_GT(segment_size, 0u);
+  if (buf_len <= segment_size) {
+    // A single segment does not need segmentation offload.
+    return WritePacket(fd, buffer, buf_len, self_address, peer_address);
+  }
+
+  sockaddr_storage raw_address = peer_address.generic_address();
+  iovec iov = {const_cast<char*>(buffer), buf_len};
+
+  msghdr hdr;
+  hdr.msg_name = &raw_address;
+  hdr.msg_namelen = raw_address.ss_family == AF_INET ? sizeof(sockaddr_in)
+                                                     : sizeof(sockaddr_in6);
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  hdr.msg_flags = 0;
+
+  const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
+  const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
+  const int kSpaceForIp =
+      (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
+  const int kSpaceForSegment = CMSG_SPACE(sizeof(uint16_t));
+  char cbuf[kSpaceForIp + kSpaceForSegment];
+  memset(cbuf, 0, sizeof(cbuf));
+  hdr.msg_control = cbuf;
+  hdr.msg_controllen = sizeof(cbuf);
+
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  size_t controllen = 0;
+  if (self_address.IsInitialized()) {
+    controllen += CMSG_SPACE(SetIpInfoInCmsg(self_address, cmsg));
+    cmsg = CMSG_NXTHDR(&hdr, cmsg);
+  }
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t gso_size = static_cast<uint16_t>(segment_size);
+  memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+  controllen += kSpaceForSegment;
+  hdr.msg_controllen = controllen;
+
+  int rc;
+  do {
+    rc = sendmsg(fd, &hdr, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc >= 0) {
+    return WriteResult(WRITE_STATUS_OK, rc);
+  }
+  return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK)
+                         ? WRITE_STATUS_BLOCKED
+                         : WRITE_STATUS_ERROR,
+                     errno);
+}
+
+// static
+WriteResult QuicSocketUtils::WriteMultiplePackets(int fd,
+                                                  struct mmsghdr* messages,
+                                                  size_t count,
+                                                  int* num_packets_sent) {
+  *num_packets_sent = 0;
+  int rc;
+  do {
+    rc = sendmmsg(fd, messages, count, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc > 0) {
+    int bytes_written = 0;
+    for (int i = 0; i < rc; ++i) {
+      bytes_written += messages[i].msg_len;
+    }
+    *num_packets_sent = rc;
+    return WriteResult(WRITE_STATUS_OK, bytes_written);
+  }
+  if (rc == 0) {
+    return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+  }
+  return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK)
+                         ? WRITE_STATUS_BLOCKED
+                         : WRITE_STATUS_ERROR,
+                     errno);
+}
+
+// static
+bool QuicSocketUtils::IsUdpGsoSupported(int fd) {
+  int gso_size = 0;
+  socklen_t optlen = sizeof(gso_size);
+  return getsockopt(fd, SOL_UDP, UDP_SEGMENT, &gso_size, &optlen) == 0;
+}
+
 // static
 int QuicSocketUtils::CreateUDPSocket(const QuicSocketAddress& address,
                                      bool* overflow_supported) {
@@ -49,6 +49,10 @@ class QuicSocketUtils {
                  CMSG_LEN(sizeof(int)) +
                  CMSG_LEN(sizeof(int)));
 
+  // Space for the control messages of a UDP_GRO read, which carry the segment
+  // size, a single int, in addition to everything in kSpaceForCmsg.
+  static const int kSpaceForGroCmsg = kSpaceForCmsg + CMSG_SPACE(sizeof(int));
+
   // Fills in |address| if |hdr| contains IP_PKTINFO or IPV6_PKTINFO. Fills in
   // |timestamp| if |hdr| contains |SO_TIMESTAMPING|. |address| and |timestamp|
   // must not be null.
@@ -65,6 +69,12 @@ class QuicSocketUtils {
   // value and return true. Otherwise it will return false.
   static bool GetTtlFromMsghdr(struct msghdr* hdr, int* ttl);
 
+  // If the msghdr contains a UDP_GRO entry, this will set segment_size to the
+  // size of each coalesced datagram and return true. Otherwise it will return
+  // false.
+  static bool GetGroSegmentSizeFromMsghdr(struct msghdr* hdr,
+                                          int* segment_size);
+
   // Sets either IP_PKTINFO or IPV6_PKTINFO on the socket, based on
   // address_family.  Returns the return code from setsockopt.
   static int SetGetAddressInfo(int fd, int address_family);
@@ -73,6 +83,21 @@ class QuicSocketUtils {
   // Returns the return code from setsockopt.
   static int SetGetSoftwareReceiveTimestamp(int fd);
 
+  // Sets UDP_GRO on the socket so that the kernel may coalesce consecutive
+  // datagrams from the same flow into one read.  Returns false if the kernel
+  // does not support it.
+  static bool EnableUdpGro(int fd);
+
+  // Sets SO_REUSEPORT on the socket and returns false if it fails.
+  static bool SetReusePort(int fd);
+
+  // Attaches a classic BPF program to the SO_REUSEPORT group of |fd| which
+  // selects the socket for each packet from the low 32 bits of the 8 byte
+  // connection ID in the public header, modulo |num_sockets|.  Packets too
+  // short to carry a connection ID go to the first socket.  Returns false if
+  // the kernel rejects the program.
+  static bool AttachConnectionIdSteeringProgram(int fd, size_t num_sockets);
+
   // Sets the send buffer size to |size| and returns false if it fails.
   static bool SetSendBufferSize(int fd, size_t size);
 
@@ -111,6 +136,31 @@ class QuicSocketUtils {
                                  const QuicIpAddress& self_address,
                                  const QuicSocketAddress& peer_address);
 
+  // Writes |buf_len| bytes of consecutive packets, each |segment_size| bytes
+  // long except possibly the last, in a single sendmsg call using UDP generic
+  // segmentation offload.  Returns the same results as WritePacket, with
+  // bytes_written covering all of the segments.
+  static WriteResult WritePacketsWithGso(int fd,
+                                         const char* buffer,
+                                         size_t buf_len,
+                                         size_t segment_size,
+                                         const QuicIpAddress& self_address,
+                                         const QuicSocketAddress& peer_address);
+
+  // Writes the |count| messages in |messages| with a single sendmmsg call.  If
+  // any message is written, sets the result's status to WRITE_STATUS_OK,
+  // bytes_written to the total number of bytes written and
+  // |num_packets_sent| to the number of messages written, which may be less
+  // than |count|.  Otherwise sets |num_packets_sent| to 0 and returns the same
+  // errors as WritePacket.
+  static WriteResult WriteMultiplePackets(int fd,
+                                          struct mmsghdr* messages,
+                                          size_t count,
+                                          int* num_packets_sent);
+
+  // Returns true if the kernel accepts UDP_SEGMENT on |fd|.
+  static bool IsUdpGsoSupported(int fd);
+
   // A helper for WritePacket which fills in the cmsg with the supplied self
   // address.
   // Returns the length of the packet info structure used.
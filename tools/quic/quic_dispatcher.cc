@@ -9,11 +9,13 @@
 #include "base/macros.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
 #include "net/quic/core/crypto/quic_random.h"
+#include "net/quic/core/quic_data_reader.h"
 #include "net/quic/core/quic_utils.h"
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_flag_utils.h"
 #include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_prefetch.h"
 #include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_stack_trace.h"
 #include "net/quic/platform/api/quic_string_piece.h"
@@ -248,7 +250,7 @@ QuicDispatcher::QuicDispatcher(
     : config_(config),
       crypto_config_(crypto_config),
       compressed_certs_cache_(
-          QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+          QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
       helper_(std::move(helper)),
       session_helper_(std::move(session_helper)),
       alarm_factory_(std::move(alarm_factory)),
@@ -283,6 +285,7 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& server_address,
   current_server_address_ = server_address;
   current_client_address_ = client_address;
   current_packet_ = &packet;
+  PrefetchSession(packet);
   // ProcessPacket will cause the packet to be dispatched in
   // OnUnauthenticatedPublicHeader, or sent to the time wait list manager
   // in OnUnauthenticatedHeader.
@@ -291,6 +294,26 @@ void QuicDispatcher::ProcessPacket(const QuicSocketAddress& server_address,
   //                and log somehow.  Maybe expose as a varz.
 }
 
+void QuicDispatcher::PrefetchSession(const QuicReceivedPacket& packet) const {
+  // Read the connection ID the way QuicFramer::ProcessPublicHeader() does, so
+  // that its byte order matches the one the lookup in
+  // OnUnauthenticatedPublicHeader() uses, whatever the version.
+  QuicDataReader reader(packet.data(), packet.length(), framer_.endianness());
+  uint8_t public_flags;
+  if (!reader.ReadBytes(&public_flags, 1) ||
+      (public_flags & PACKET_PUBLIC_FLAGS_8BYTE_CONNECTION_ID) !=
+          PACKET_PUBLIC_FLAGS_8BYTE_CONNECTION_ID) {
+    return;
+  }
+  QuicConnectionId connection_id;
+  if (!reader.ReadConnectionId(&connection_id))
+    return;
+  SessionMap::const_iterator it = session_map_.find(connection_id);
+  if (it != session_map_.end()) {
+    QuicPrefetchT0(it->second.get());
+  }
+}
+
 bool QuicDispatcher::OnUnauthenticatedPublicHeader(
     const QuicPacketHeader& header) {
   current_connection_id_ = header.connection_id;
@@ -392,6 +415,11 @@ bool QuicDispatcher::OnUnauthenticatedHeader(const QuicPacketHeader& header) {
 
   // Packet's connection ID is unknown.  Apply the validity checks.
   QuicPacketFate fate = ValidityChecks(header);
+  if (fate == kFateProcess &&
+      FLAGS_quic_reloadable_flag_quic_shed_load_when_overloaded &&
+      MaybeShedLoad(connection_id)) {
+    return false;
+  }
   if (fate == kFateProcess) {
     // Execute stateless rejection logic to determine the packet fate, then
     // invoke ProcessUnauthenticatedHeaderFate.
@@ -405,6 +433,34 @@ bool QuicDispatcher::OnUnauthenticatedHeader(const QuicPacketHeader& header) {
   return false;
 }
 
+bool QuicDispatcher::MaybeShedLoad(QuicConnectionId connection_id) {
+  // CHLOs waiting for a session and those whose proofs are being computed.
+  const size_t pending_handshakes = buffered_packets_.NumChlosBuffered() +
+                                    temporarily_buffered_connections_.size();
+  switch (overload_controller_.OnNewConnection(pending_handshakes)) {
+    case QuicOverloadController::ACCEPT:
+      return false;
+    case QuicOverloadController::REJECT: {
+      // Closing the connection costs a single packet, which the time wait list
+      // manager repeats for any retransmission of the CHLO, and lets the
+      // client fail fast instead of timing out.
+      StatelessConnectionTerminator terminator(connection_id, &framer_, helper(),
+                                               time_wait_list_manager_.get());
+      terminator.CloseConnection(QUIC_TOO_MANY_SESSIONS_ON_SERVER,
+                                 "Server overloaded.");
+      OnConnectionClosedStatelessly(QUIC_TOO_MANY_SESSIONS_ON_SERVER);
+      time_wait_list_manager_->ProcessPacket(
+          current_server_address_, current_client_address_, connection_id);
+      buffered_packets_.DiscardPackets(connection_id);
+      return true;
+    }
+    case QuicOverloadController::DROP:
+      buffered_packets_.DiscardPackets(connection_id);
+      return true;
+  }
+  return false;
+}
+
 void QuicDispatcher::ProcessUnauthenticatedHeaderFate(
     QuicPacketFate fate,
     QuicConnectionId connection_id) {
@@ -529,6 +585,10 @@ void QuicDispatcher::OnCanWrite() {
   // The socket is now writable.
   writer_->SetWritable();
 
+  // Packets held by a batch mode writer were written before anything in the
+  // blocked list, so send them first.
+  FlushWriter();
+
   // Give all the blocked writers one chance to write, until we're blocked again
   // or there's no work left.
   while (!write_blocked_list_.empty() && !writer_->IsWriteBlocked()) {
@@ -537,10 +597,23 @@ void QuicDispatcher::OnCanWrite() {
     write_blocked_list_.erase(write_blocked_list_.begin());
     blocked_writer->OnBlockedWriterCanWrite();
   }
+  FlushWriter();
 }
 
 bool QuicDispatcher::HasPendingWrites() const {
-  return !write_blocked_list_.empty();
+  return !write_blocked_list_.empty() ||
+         (writer_->IsBatchMode() && writer_->IsWriteBlocked());
+}
+
+void QuicDispatcher::FlushWriter() {
+  if (!writer_->IsBatchMode() || writer_->IsWriteBlocked()) {
+    return;
+  }
+  WriteResult result = writer_->Flush();
+  if (result.status == WRITE_STATUS_ERROR) {
+    QUIC_DLOG(WARNING) << "Batch writer flush failed with error "
+                       << result.error_code;
+  }
 }
 
 void QuicDispatcher::Shutdown() {
@@ -17,6 +17,7 @@
 #include "net/quic/core/quic_blocked_writer_interface.h"
 #include "net/quic/core/quic_buffered_packet_store.h"
 #include "net/quic/core/quic_connection.h"
+#include "net/quic/core/quic_connection_id_map.h"
 #include "net/quic/core/quic_crypto_server_stream.h"
 #include "net/quic/core/quic_packets.h"
 #include "net/quic/core/quic_session.h"
@@ -24,6 +25,7 @@
 #include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_socket_address.h"
 
+#include "net/tools/quic/quic_overload_controller.h"
 #include "net/tools/quic/quic_process_packet_interface.h"
 #include "net/tools/quic/quic_time_wait_list_manager.h"
 #include "net/tools/quic/stateless_rejector.h"
@@ -65,9 +67,14 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // Called when the socket becomes writable to allow queued writes to happen.
   virtual void OnCanWrite();
 
-  // Returns true if there's anything in the blocked writer list.
+  // Returns true if there's anything in the blocked writer list, or if a
+  // batch mode writer is holding packets it could not send.
   virtual bool HasPendingWrites() const;
 
+  // Sends all packets held by a batch mode writer.  Called once at the end of
+  // each event loop iteration, after all connections have written.
+  void FlushWriter();
+
   // Sends ConnectionClose frames to all connected clients.
   void Shutdown();
 
@@ -93,8 +100,7 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // time-wait list.
   void OnConnectionAddedToTimeWaitList(QuicConnectionId connection_id) override;
 
-  using SessionMap =
-      QuicUnorderedMap<QuicConnectionId, std::unique_ptr<QuicSession>>;
+  using SessionMap = QuicConnectionIdMap<std::unique_ptr<QuicSession>>;
 
   const SessionMap& session_map() const { return session_map_; }
 
@@ -157,6 +163,12 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // Return true if there is CHLO buffered.
   virtual bool HasChlosBuffered() const;
 
+  // Decides whether new connections are turned away because the server is
+  // overloaded.  The owner of the event loop reports its lag to it.
+  QuicOverloadController* overload_controller() {
+    return &overload_controller_;
+  }
+
  protected:
   virtual QuicSession* CreateQuicSession(
       QuicConnectionId connection_id,
@@ -302,6 +314,11 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
 
   bool HandlePacketForTimeWait(const QuicPacketHeader& header);
 
+  // Looks up the session of |packet| by the connection ID in its public
+  // header, if any, and prefetches the session while the framer parses the
+  // packet.
+  void PrefetchSession(const QuicReceivedPacket& packet) const;
+
   // Attempts to reject the connection statelessly, if stateless rejects are
   // possible and if the current packet contains a CHLO message.  Determines a
   // fate which describes what subsequent processing should be performed on the
@@ -309,6 +326,11 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   void MaybeRejectStatelessly(QuicConnectionId connection_id,
                               QuicTransportVersion version);
 
+  // Rejects or drops the current packet, which is for a new connection, if
+  // the overload controller says so.  Returns true if the packet has been
+  // handled.
+  bool MaybeShedLoad(QuicConnectionId connection_id);
+
   // Deliver |packets| to |session| for further processing.
   void DeliverPacketsToSession(
       const std::list<QuicBufferedPacketStore::BufferedPacket>& packets,
@@ -405,6 +427,8 @@ class QuicDispatcher : public QuicTimeWaitListManager::Visitor,
   // True if this dispatcher is not draining.
   bool accept_new_connections_;
 
+  QuicOverloadController overload_controller_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicDispatcher);
 };
 
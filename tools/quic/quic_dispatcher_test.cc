@@ -45,6 +45,7 @@ using testing::CreateFunctor;
 using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
+using testing::NotNull;
 using testing::Return;
 using testing::WithoutArgs;
 using testing::_;
@@ -551,6 +552,35 @@ TEST_F(QuicDispatcherTest, TooBigSeqNoPacketToTimeWaitListManager) {
                     QuicDispatcher::kMaxReasonableInitialPacketNumber + 1);
 }
 
+TEST_F(QuicDispatcherTest, ShedLoadWhenOverloaded) {
+  FLAGS_quic_reloadable_flag_quic_shed_load_when_overloaded = true;
+  CreateTimeWaitListManager();
+  QuicSocketAddress client_address(QuicIpAddress::Loopback4(), 1);
+  QuicOverloadController* controller = dispatcher_->overload_controller();
+  EXPECT_CALL(*dispatcher_, CreateQuicSession(_, _, _)).Times(0);
+
+  // An event loop lagging past the reject threshold closes new connections.
+  for (int i = 0; i < 20; ++i) {
+    controller->OnEventLoopIteration(QuicTime::Delta::FromMilliseconds(100));
+  }
+  EXPECT_CALL(*time_wait_list_manager_,
+              AddConnectionIdToTimeWait(1, _, false, NotNull()));
+  EXPECT_CALL(*time_wait_list_manager_, ProcessPacket(_, _, 1));
+  ProcessPacket(client_address, 1, true, SerializeCHLO());
+  EXPECT_EQ(1u, controller->stats().connections_rejected);
+
+  // Past the drop threshold, new connections get no reply.
+  for (int i = 0; i < 20; ++i) {
+    controller->OnEventLoopIteration(QuicTime::Delta::FromMilliseconds(400));
+  }
+  EXPECT_CALL(*time_wait_list_manager_, AddConnectionIdToTimeWait(2, _, _, _))
+      .Times(0);
+  EXPECT_CALL(*time_wait_list_manager_, ProcessPacket(_, _, 2)).Times(0);
+  ProcessPacket(client_address, 2, true, SerializeCHLO());
+  EXPECT_EQ(1u, controller->stats().connections_dropped);
+  EXPECT_EQ(1u, controller->stats().overload_episodes);
+}
+
 TEST_F(QuicDispatcherTest, SupportedTransportVersionsChangeInFlight) {
   static_assert(arraysize(kSupportedTransportVersions) == 7u,
                 "Supported versions out of sync");
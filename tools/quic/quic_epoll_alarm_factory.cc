@@ -4,12 +4,90 @@
 
 #include "net/tools/quic/quic_epoll_alarm_factory.h"
 
+#include <algorithm>
+
+#include "net/quic/platform/api/quic_flags.h"
 #include "net/tools/epoll_server/epoll_server.h"
+#include "net/tools/quic/quic_timing_wheel.h"
 
 namespace net {
 
 namespace {
 
+// Alarms are rarely set with a finer granularity than 1 ms, so that makes a
+// tick with little relinking and no loss of precision, as the wheel keeps
+// exact deadlines.
+const int64_t kTimingWheelTickUs = 1000;
+
+}  // namespace
+
+// Drives a QuicTimingWheel off a single EpollServer alarm. It is shared by
+// the factory and the alarms created from it, as either may go first.
+class QuicEpollTimingWheel : public base::RefCounted<QuicEpollTimingWheel>,
+                             public EpollAlarm {
+ public:
+  explicit QuicEpollTimingWheel(EpollServer* epoll_server)
+      : epoll_server_(epoll_server),
+        wheel_(kTimingWheelTickUs),
+        registered_us_(0),
+        advancing_(false) {}
+
+  void Schedule(QuicTimingWheel::Timer* timer, int64_t deadline_us) {
+    if (!advancing_ && wheel_.size() == 0) {
+      wheel_.Advance(epoll_server_->ApproximateNowInUsec());
+    }
+    wheel_.Schedule(timer, deadline_us);
+    // While advancing, OnAlarm() picks the next wake-up once it is done.
+    if (advancing_ || (registered() && registered_us_ <= deadline_us)) {
+      return;
+    }
+    UnregisterIfRegistered();
+    registered_us_ = deadline_us;
+    epoll_server_->RegisterAlarm(deadline_us, this);
+  }
+
+  // A wake-up left behind by a cancelled timer is harmless, so the EpollServer
+  // alarm is only dropped once the wheel is empty.
+  void Cancel(QuicTimingWheel::Timer* timer) {
+    wheel_.Cancel(timer);
+    if (!advancing_ && wheel_.size() == 0) {
+      UnregisterIfRegistered();
+    }
+  }
+
+  // EpollAlarm implementation.
+  int64_t OnAlarm() override {
+    EpollAlarm::OnAlarm();
+    advancing_ = true;
+    wheel_.Advance(epoll_server_->ApproximateNowInUsec());
+    advancing_ = false;
+    const int64_t next_us = wheel_.NextWakeUpUs();
+    if (next_us < 0) {
+      return 0;
+    }
+    // The EpollServer re-registers the alarm for any positive time, and defers
+    // times that have already passed to its next iteration.
+    registered_us_ = std::max<int64_t>(next_us, 1);
+    return registered_us_;
+  }
+
+ private:
+  friend class base::RefCounted<QuicEpollTimingWheel>;
+
+  ~QuicEpollTimingWheel() override { DCHECK_EQ(0u, wheel_.size()); }
+
+  EpollServer* epoll_server_;
+  QuicTimingWheel wheel_;
+  // Time the EpollServer alarm is registered for, if registered().
+  int64_t registered_us_;
+  // True while the wheel is expiring timers.
+  bool advancing_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicEpollTimingWheel);
+};
+
+namespace {
+
 class QuicEpollAlarm : public QuicAlarm {
  public:
   QuicEpollAlarm(EpollServer* epoll_server,
@@ -50,14 +128,57 @@ class QuicEpollAlarm : public QuicAlarm {
   EpollAlarmImpl epoll_alarm_impl_;
 };
 
+class QuicEpollWheelAlarm : public QuicAlarm, public QuicTimingWheel::Timer {
+ public:
+  QuicEpollWheelAlarm(scoped_refptr<QuicEpollTimingWheel> timing_wheel,
+                      QuicArenaScopedPtr<Delegate> delegate)
+      : QuicAlarm(std::move(delegate)),
+        timing_wheel_(std::move(timing_wheel)) {}
+
+  ~QuicEpollWheelAlarm() override { timing_wheel_->Cancel(this); }
+
+  // QuicTimingWheel::Timer implementation.
+  void OnExpired() override { Fire(); }
+
+ protected:
+  void SetImpl() override {
+    DCHECK(deadline().IsInitialized());
+    timing_wheel_->Schedule(this,
+                            (deadline() - QuicTime::Zero()).ToMicroseconds());
+  }
+
+  void CancelImpl() override {
+    DCHECK(!deadline().IsInitialized());
+    timing_wheel_->Cancel(this);
+  }
+
+  // Rescheduling is a single operation on the wheel, with no need to cancel
+  // first.
+  void UpdateImpl() override { SetImpl(); }
+
+ private:
+  scoped_refptr<QuicEpollTimingWheel> timing_wheel_;
+};
+
 }  // namespace
 
 QuicEpollAlarmFactory::QuicEpollAlarmFactory(EpollServer* epoll_server)
-    : epoll_server_(epoll_server) {}
+    : QuicEpollAlarmFactory(epoll_server,
+                            FLAGS_quic_epoll_alarm_timing_wheel) {}
+
+QuicEpollAlarmFactory::QuicEpollAlarmFactory(EpollServer* epoll_server,
+                                             bool use_timing_wheel)
+    : epoll_server_(epoll_server),
+      timing_wheel_(use_timing_wheel ? new QuicEpollTimingWheel(epoll_server)
+                                     : nullptr) {}
 
 QuicEpollAlarmFactory::~QuicEpollAlarmFactory() = default;
 
 QuicAlarm* QuicEpollAlarmFactory::CreateAlarm(QuicAlarm::Delegate* delegate) {
+  if (timing_wheel_ != nullptr) {
+    return new QuicEpollWheelAlarm(
+        timing_wheel_, QuicArenaScopedPtr<QuicAlarm::Delegate>(delegate));
+  }
   return new QuicEpollAlarm(epoll_server_,
                             QuicArenaScopedPtr<QuicAlarm::Delegate>(delegate));
 }
@@ -65,6 +186,14 @@ QuicAlarm* QuicEpollAlarmFactory::CreateAlarm(QuicAlarm::Delegate* delegate) {
 QuicArenaScopedPtr<QuicAlarm> QuicEpollAlarmFactory::CreateAlarm(
     QuicArenaScopedPtr<QuicAlarm::Delegate> delegate,
     QuicConnectionArena* arena) {
+  if (timing_wheel_ != nullptr) {
+    if (arena != nullptr) {
+      return arena->New<QuicEpollWheelAlarm>(timing_wheel_,
+                                             std::move(delegate));
+    }
+    return QuicArenaScopedPtr<QuicAlarm>(
+        new QuicEpollWheelAlarm(timing_wheel_, std::move(delegate)));
+  }
   if (arena != nullptr) {
     return arena->New<QuicEpollAlarm>(epoll_server_, std::move(delegate));
   } else {
@@ -5,17 +5,27 @@
 #ifndef NET_TOOLS_QUIC_QUIC_EPOLL_ALARM_FACTORY_H_
 #define NET_TOOLS_QUIC_QUIC_EPOLL_ALARM_FACTORY_H_
 
+#include "base/memory/ref_counted.h"
 #include "net/quic/core/quic_alarm.h"
 #include "net/quic/core/quic_alarm_factory.h"
 
 namespace net {
 
 class EpollServer;
+class QuicEpollTimingWheel;
 
 // Creates alarms that use the supplied EpollServer for timing and firing.
+//
+// With |use_timing_wheel|, alarms are kept in a QuicTimingWheel instead of
+// being registered with the EpollServer one by one, so that setting, updating
+// and cancelling them is constant time. The wheel itself registers a single
+// EpollServer alarm for its earliest wake-up, which only moves when an alarm
+// is set to go off before it.
 class QuicEpollAlarmFactory : public QuicAlarmFactory {
  public:
+  // Uses a timing wheel if FLAGS_quic_epoll_alarm_timing_wheel is set.
   explicit QuicEpollAlarmFactory(EpollServer* epoll_server);
+  QuicEpollAlarmFactory(EpollServer* epoll_server, bool use_timing_wheel);
   ~QuicEpollAlarmFactory() override;
 
   // QuicAlarmFactory interface.
@@ -26,6 +36,8 @@ class QuicEpollAlarmFactory : public QuicAlarmFactory {
 
  private:
   EpollServer* epoll_server_;  // Not owned.
+  // Shared with the alarms created from it. Null if not using a timing wheel.
+  scoped_refptr<QuicEpollTimingWheel> timing_wheel_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicEpollAlarmFactory);
 };
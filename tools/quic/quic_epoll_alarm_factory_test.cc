@@ -4,6 +4,8 @@
 
 #include "net/tools/quic/quic_epoll_alarm_factory.h"
 
+#include <tuple>
+
 #include "net/quic/platform/api/quic_test.h"
 #include "net/tools/quic/platform/impl/quic_epoll_clock.h"
 #include "net/tools/quic/test_tools/mock_epoll_server.h"
@@ -24,14 +26,17 @@ class TestDelegate : public QuicAlarm::Delegate {
   bool fired_;
 };
 
-// The boolean parameter denotes whether or not to use an arena.
-class QuicEpollAlarmFactoryTest : public QuicTestWithParam<bool> {
+// The first boolean parameter denotes whether or not to use an arena, the
+// second whether or not to use a timing wheel.
+class QuicEpollAlarmFactoryTest
+    : public QuicTestWithParam<std::tuple<bool, bool>> {
  protected:
   QuicEpollAlarmFactoryTest()
-      : clock_(&epoll_server_), alarm_factory_(&epoll_server_) {}
+      : clock_(&epoll_server_),
+        alarm_factory_(&epoll_server_, std::get<1>(GetParam())) {}
 
   QuicConnectionArena* GetArenaParam() {
-    return GetParam() ? &arena_ : nullptr;
+    return std::get<0>(GetParam()) ? &arena_ : nullptr;
   }
 
   const QuicEpollClock clock_;
@@ -40,9 +45,10 @@ class QuicEpollAlarmFactoryTest : public QuicTestWithParam<bool> {
   QuicConnectionArena arena_;
 };
 
-INSTANTIATE_TEST_CASE_P(UseArena,
+INSTANTIATE_TEST_CASE_P(UseArenaAndTimingWheel,
                         QuicEpollAlarmFactoryTest,
-                        ::testing::ValuesIn({true, false}));
+                        ::testing::Combine(::testing::Bool(),
+                                           ::testing::Bool()));
 
 TEST_P(QuicEpollAlarmFactoryTest, CreateAlarm) {
   QuicArenaScopedPtr<TestDelegate> delegate =
@@ -135,6 +141,36 @@ TEST_P(QuicEpollAlarmFactoryTest, CreateAlarmAndUpdate) {
   EXPECT_FALSE(alarm->IsSet());
 }
 
+TEST_P(QuicEpollAlarmFactoryTest, MultipleAlarms) {
+  QuicArenaScopedPtr<TestDelegate> early_delegate(new TestDelegate());
+  TestDelegate* unowned_early_delegate = early_delegate.get();
+  QuicArenaScopedPtr<TestDelegate> late_delegate(new TestDelegate());
+  TestDelegate* unowned_late_delegate = late_delegate.get();
+  QuicArenaScopedPtr<QuicAlarm> early_alarm(
+      alarm_factory_.CreateAlarm(std::move(early_delegate), GetArenaParam()));
+  QuicArenaScopedPtr<QuicAlarm> late_alarm(
+      alarm_factory_.CreateAlarm(std::move(late_delegate), GetArenaParam()));
+
+  QuicTime start = clock_.Now();
+  QuicTime::Delta early_delta = QuicTime::Delta::FromMilliseconds(2);
+  QuicTime::Delta late_delta = QuicTime::Delta::FromMilliseconds(70);
+  late_alarm->Set(start + late_delta);
+  early_alarm->Set(start + early_delta);
+  // The timing wheel registers a single alarm for both.
+  EXPECT_EQ(std::get<1>(GetParam()) ? 1u : 2u, epoll_server_.NumberOfAlarms());
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(early_delta.ToMicroseconds());
+  EXPECT_TRUE(unowned_early_delegate->fired());
+  EXPECT_FALSE(unowned_late_delegate->fired());
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(
+      (late_delta - early_delta).ToMicroseconds() - 1);
+  EXPECT_FALSE(unowned_late_delegate->fired());
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(1);
+  EXPECT_EQ(start + late_delta, clock_.Now());
+  EXPECT_TRUE(unowned_late_delegate->fired());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
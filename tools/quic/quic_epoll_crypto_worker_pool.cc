@@ -0,0 +1,136 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_epoll_crypto_worker_pool.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <utility>
+
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+
+namespace net {
+
+QuicEpollCryptoWorkerPool::Worker::Worker(QuicEpollCryptoWorkerPool* pool)
+    : SimpleThread("quic_crypto_worker"), pool_(pool) {}
+
+QuicEpollCryptoWorkerPool::Worker::~Worker() = default;
+
+void QuicEpollCryptoWorkerPool::Worker::Run() {
+  pool_->RunTasks();
+}
+
+QuicEpollCryptoWorkerPool::QuicEpollCryptoWorkerPool(size_t num_threads,
+                                                     EpollServer* epoll_server)
+    : epoll_server_(epoll_server),
+      read_fd_(-1),
+      write_fd_(-1),
+      tasks_available_(&lock_),
+      stopped_(false),
+      num_pending_tasks_(0) {
+  DCHECK_GT(num_threads, 0u);
+  int pipe_fds[2];
+  if (pipe2(pipe_fds, O_NONBLOCK | O_CLOEXEC) < 0) {
+    QUIC_LOG(FATAL) << "pipe2() failed, errno: " << errno;
+  }
+  read_fd_ = pipe_fds[0];
+  write_fd_ = pipe_fds[1];
+  epoll_server_->RegisterFD(read_fd_, this, EPOLLIN);
+
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.push_back(QuicMakeUnique<Worker>(this));
+    workers_.back()->Start();
+  }
+}
+
+QuicEpollCryptoWorkerPool::~QuicEpollCryptoWorkerPool() {
+  Stop();
+  if (epoll_server_ != nullptr) {
+    epoll_server_->UnregisterFD(read_fd_);
+  }
+  close(read_fd_);
+  close(write_fd_);
+}
+
+void QuicEpollCryptoWorkerPool::Stop() {
+  {
+    base::AutoLock locked(lock_);
+    stopped_ = true;
+  }
+  tasks_available_.Broadcast();
+  for (const auto& worker : workers_) {
+    worker->Join();
+  }
+  workers_.clear();
+}
+
+void QuicEpollCryptoWorkerPool::PostTask(std::unique_ptr<Task> task) {
+  ++num_pending_tasks_;
+  {
+    base::AutoLock locked(lock_);
+    queued_tasks_.push_back(std::move(task));
+  }
+  tasks_available_.Signal();
+}
+
+void QuicEpollCryptoWorkerPool::OnEvent(int fd, EpollEvent* event) {
+  DCHECK_EQ(read_fd_, fd);
+  // Empty the pipe before taking the finished tasks, so that a task finishing
+  // in between writes another byte.
+  char buffer[64];
+  while (read(read_fd_, buffer, sizeof(buffer)) > 0) {
+  }
+
+  std::vector<std::unique_ptr<Task>> finished_tasks;
+  {
+    base::AutoLock locked(lock_);
+    finished_tasks.swap(finished_tasks_);
+  }
+  for (const auto& task : finished_tasks) {
+    --num_pending_tasks_;
+    task->Reply();
+  }
+}
+
+void QuicEpollCryptoWorkerPool::OnShutdown(EpollServer* eps, int fd) {
+  epoll_server_ = nullptr;
+}
+
+void QuicEpollCryptoWorkerPool::RunTasks() {
+  while (true) {
+    std::unique_ptr<Task> task;
+    {
+      base::AutoLock locked(lock_);
+      while (!stopped_ && queued_tasks_.empty()) {
+        tasks_available_.Wait();
+      }
+      if (stopped_) {
+        return;
+      }
+      task = std::move(queued_tasks_.front());
+      queued_tasks_.pop_front();
+    }
+
+    task->Run();
+
+    bool wake_up;
+    {
+      base::AutoLock locked(lock_);
+      wake_up = finished_tasks_.empty();
+      finished_tasks_.push_back(std::move(task));
+    }
+    if (wake_up) {
+      char data = 0;
+      if (write(write_fd_, &data, 1) != 1) {
+        QUIC_LOG(ERROR) << "Failed to wake up the event loop, errno: "
+                        << errno;
+      }
+    }
+  }
+}
+
+}  // namespace net
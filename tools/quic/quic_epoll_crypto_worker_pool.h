@@ -0,0 +1,95 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_EPOLL_CRYPTO_WORKER_POOL_H_
+#define NET_TOOLS_QUIC_QUIC_EPOLL_CRYPTO_WORKER_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/containers/circular_deque.h"
+#include "base/macros.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/simple_thread.h"
+#include "net/quic/core/crypto/crypto_worker_pool.h"
+#include "net/tools/epoll_server/epoll_server.h"
+
+namespace net {
+
+// A CryptoWorkerPool which runs tasks on a fixed number of threads, and their
+// replies on the thread of an EpollServer.  Workers hand finished tasks back
+// through a pipe registered with the EpollServer, so that the event loop wakes
+// up to reply without polling.
+//
+// Apart from Run() being called on the workers, this class must only be used
+// on the thread of the EpollServer.
+class QuicEpollCryptoWorkerPool : public CryptoWorkerPool,
+                                  public EpollCallbackInterface {
+ public:
+  QuicEpollCryptoWorkerPool(size_t num_threads, EpollServer* epoll_server);
+  ~QuicEpollCryptoWorkerPool() override;
+
+  // Waits for the tasks being run to finish, and stops the workers.  Tasks
+  // which have not replied by then never do, and are kept until the pool is
+  // destroyed.  Owners must call this before destroying anything that the
+  // tasks use.  Called by the destructor.
+  void Stop();
+
+  // Returns the number of tasks which have been posted and have not replied.
+  size_t num_pending_tasks() const { return num_pending_tasks_; }
+
+  // CryptoWorkerPool interface.
+  void PostTask(std::unique_ptr<Task> task) override;
+
+  // EpollCallbackInterface interface.
+  void OnRegistration(EpollServer* eps, int fd, int event_mask) override {}
+  void OnModification(int fd, int event_mask) override {}
+  void OnEvent(int fd, EpollEvent* event) override;
+  void OnUnregistration(int fd, bool replaced) override {}
+  void OnShutdown(EpollServer* eps, int fd) override;
+
+ private:
+  class Worker : public base::SimpleThread {
+   public:
+    explicit Worker(QuicEpollCryptoWorkerPool* pool);
+    ~Worker() override;
+
+    // base::SimpleThread
+    void Run() override;
+
+   private:
+    QuicEpollCryptoWorkerPool* pool_;
+
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+  };
+
+  // Runs tasks on a worker thread until the pool is stopped.
+  void RunTasks();
+
+  EpollServer* epoll_server_;
+  // Ends of the pipe which tells the event loop that tasks have finished.
+  int read_fd_;
+  int write_fd_;
+
+  base::Lock lock_;
+  // Signalled when a task is posted or the pool is stopped.
+  base::ConditionVariable tasks_available_;
+  base::circular_deque<std::unique_ptr<Task>> queued_tasks_;
+  // Tasks which have run and wait for the event loop to reply.  A byte is
+  // written to the pipe whenever this goes from empty to non-empty.
+  std::vector<std::unique_ptr<Task>> finished_tasks_;
+  bool stopped_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  size_t num_pending_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicEpollCryptoWorkerPool);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_EPOLL_CRYPTO_WORKER_POOL_H_
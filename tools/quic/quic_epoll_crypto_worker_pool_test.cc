@@ -0,0 +1,95 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_epoll_crypto_worker_pool.h"
+
+#include "base/threading/platform_thread.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class TestTask : public CryptoWorkerPool::Task {
+ public:
+  struct Result {
+    Result() : ran_on_loop(false), replied_on_loop(false), replied(false) {}
+
+    bool ran_on_loop;
+    bool replied_on_loop;
+    bool replied;
+  };
+
+  TestTask(base::PlatformThreadId loop_thread, Result* result)
+      : loop_thread_(loop_thread), result_(result) {}
+
+  void Run() override {
+    result_->ran_on_loop = base::PlatformThread::CurrentId() == loop_thread_;
+  }
+
+  void Reply() override {
+    result_->replied_on_loop =
+        base::PlatformThread::CurrentId() == loop_thread_;
+    result_->replied = true;
+  }
+
+ private:
+  const base::PlatformThreadId loop_thread_;
+  Result* result_;
+};
+
+class QuicEpollCryptoWorkerPoolTest : public QuicTest {
+ protected:
+  QuicEpollCryptoWorkerPoolTest()
+      : loop_thread_(base::PlatformThread::CurrentId()) {
+    // Don't let a missed wake up hang the test.
+    epoll_server_.set_timeout_in_us(10 * 1000);
+  }
+
+  EpollServer epoll_server_;
+  const base::PlatformThreadId loop_thread_;
+};
+
+TEST_F(QuicEpollCryptoWorkerPoolTest, RunsOnWorkersAndRepliesOnLoop) {
+  QuicEpollCryptoWorkerPool pool(4, &epoll_server_);
+  const size_t kNumTasks = 100;
+  TestTask::Result results[kNumTasks];
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    pool.PostTask(QuicMakeUnique<TestTask>(loop_thread_, &results[i]));
+  }
+  EXPECT_EQ(kNumTasks, pool.num_pending_tasks());
+  // Replies never run outside of the event loop.
+  for (const TestTask::Result& result : results) {
+    EXPECT_FALSE(result.replied);
+  }
+
+  for (int i = 0; i < 1000 && pool.num_pending_tasks() > 0; ++i) {
+    epoll_server_.WaitForEventsAndExecuteCallbacks();
+  }
+  EXPECT_EQ(0u, pool.num_pending_tasks());
+  for (const TestTask::Result& result : results) {
+    EXPECT_FALSE(result.ran_on_loop);
+    EXPECT_TRUE(result.replied);
+    EXPECT_TRUE(result.replied_on_loop);
+  }
+}
+
+TEST_F(QuicEpollCryptoWorkerPoolTest, StoppedPoolDoesNotReply) {
+  TestTask::Result result;
+  {
+    QuicEpollCryptoWorkerPool pool(1, &epoll_server_);
+    pool.PostTask(QuicMakeUnique<TestTask>(loop_thread_, &result));
+    pool.Stop();
+    // The task may or may not have run, but it is not handed back.
+    epoll_server_.WaitForEventsAndExecuteCallbacks();
+    EXPECT_FALSE(result.replied);
+    EXPECT_EQ(1u, pool.num_pending_tasks());
+  }
+  EXPECT_FALSE(result.replied);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -0,0 +1,130 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_gso_batch_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/tools/quic/platform/impl/quic_socket_utils.h"
+
+namespace net {
+
+// static
+const size_t QuicGsoBatchWriter::kMaxGsoSegments;
+const size_t QuicGsoBatchWriter::kMaxGsoBatchSize;
+
+QuicGsoBatchWriter::QuicGsoBatchWriter(int fd)
+    : QuicDefaultPacketWriter(fd),
+      buffer_len_(0),
+      segment_size_(0),
+      num_segments_(0) {}
+
+QuicGsoBatchWriter::~QuicGsoBatchWriter() = default;
+
+WriteResult QuicGsoBatchWriter::WritePacket(
+    const char* buffer,
+    size_t buf_len,
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address,
+    PerPacketOptions* options) {
+  DCHECK(!IsWriteBlocked());
+  DCHECK(nullptr == options)
+      << "QuicGsoBatchWriter does not accept any options.";
+  DCHECK_LE(buf_len, kMaxGsoBatchSize);
+
+  if (!CanBatch(buf_len, self_address, peer_address)) {
+    WriteResult result = Flush();
+    if (result.status != WRITE_STATUS_OK) {
+      // The packet was not accepted, so the caller must retry it.
+      return result;
+    }
+  }
+
+  if (num_segments_ == 0) {
+    segment_size_ = buf_len;
+    self_address_ = self_address;
+    peer_address_ = peer_address;
+  }
+  memcpy(buffer_ + buffer_len_, buffer, buf_len);
+  buffer_len_ += buf_len;
+  ++num_segments_;
+
+  if (IsBatchFull()) {
+    WriteResult result = Flush();
+    if (result.status == WRITE_STATUS_ERROR) {
+      return result;
+    }
+    // If the flush was blocked the packet stays in the batch and is sent by
+    // the next Flush once the socket becomes writable.
+  }
+  return WriteResult(WRITE_STATUS_OK, buf_len);
+}
+
+bool QuicGsoBatchWriter::IsBatchMode() const {
+  return true;
+}
+
+WriteResult QuicGsoBatchWriter::Flush() {
+  if (num_segments_ == 0) {
+    return WriteResult(WRITE_STATUS_OK, 0);
+  }
+  if (IsWriteBlocked()) {
+    return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+  }
+
+  WriteResult result = WriteBatch(buffer_, buffer_len_, segment_size_,
+                                  self_address_, peer_address_);
+  if (result.status == WRITE_STATUS_BLOCKED) {
+    set_write_blocked(true);
+    return result;
+  }
+  if (result.status == WRITE_STATUS_ERROR) {
+    QUIC_DLOG(WARNING) << "Dropping batch of " << num_segments_
+                       << " packets due to write error " << result.error_code;
+  }
+  ResetBatch();
+  return result;
+}
+
+WriteResult QuicGsoBatchWriter::WriteBatch(
+    const char* buffer,
+    size_t buf_len,
+    size_t segment_size,
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  return QuicSocketUtils::WritePacketsWithGso(
+      fd(), buffer, buf_len, segment_size, self_address, peer_address);
+}
+
+bool QuicGsoBatchWriter::CanBatch(size_t buf_len,
+                                  const QuicIpAddress& self_address,
+                                  const QuicSocketAddress& peer_address) const {
+  if (num_segments_ == 0) {
+    return true;
+  }
+  // A packet shorter than |segment_size_| closes the batch, so every packet
+  // already in the batch is exactly |segment_size_| bytes long.
+  return self_address == self_address_ && peer_address == peer_address_ &&
+         buf_len <= segment_size_ &&
+         buffer_len_ + buf_len <= kMaxGsoBatchSize &&
+         num_segments_ < kMaxGsoSegments;
+}
+
+bool QuicGsoBatchWriter::IsBatchFull() const {
+  return num_segments_ >= kMaxGsoSegments ||
+         buffer_len_ + segment_size_ > kMaxGsoBatchSize ||
+         buffer_len_ != num_segments_ * segment_size_;
+}
+
+void QuicGsoBatchWriter::ResetBatch() {
+  buffer_len_ = 0;
+  segment_size_ = 0;
+  num_segments_ = 0;
+  self_address_ = QuicIpAddress();
+  peer_address_ = QuicSocketAddress();
+}
+
+}  // namespace net
@@ -0,0 +1,81 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_GSO_BATCH_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_GSO_BATCH_WRITER_H_
+
+#include <stddef.h>
+
+#include "base/macros.h"
+#include "net/quic/platform/api/quic_export.h"
+#include "net/quic/platform/api/quic_ip_address.h"
+#include "net/quic/platform/api/quic_socket_address.h"
+#include "net/tools/quic/quic_default_packet_writer.h"
+
+namespace net {
+
+// A batch mode packet writer which collects consecutive packets to the same
+// peer into one buffer and sends them with a single sendmsg carrying
+// UDP_SEGMENT, letting the kernel (or NIC) split them into datagrams.
+//
+// All packets in a batch must have the same size, except the last one which
+// may be shorter.  A batch is sent when a packet cannot join it, when it is
+// full, or when Flush is called at the end of the connection's write loop.
+class QUIC_EXPORT_PRIVATE QuicGsoBatchWriter : public QuicDefaultPacketWriter {
+ public:
+  // The kernel limits a GSO send to 64 segments and to the maximum size of an
+  // IP datagram.
+  static const size_t kMaxGsoSegments = 64;
+  static const size_t kMaxGsoBatchSize = 65535 - 8 - 40;
+
+  explicit QuicGsoBatchWriter(int fd);
+  ~QuicGsoBatchWriter() override;
+
+  // QuicPacketWriter
+  WriteResult WritePacket(const char* buffer,
+                          size_t buf_len,
+                          const QuicIpAddress& self_address,
+                          const QuicSocketAddress& peer_address,
+                          PerPacketOptions* options) override;
+  bool IsBatchMode() const override;
+  WriteResult Flush() override;
+
+  size_t buffered_packets() const { return num_segments_; }
+  size_t buffered_bytes() const { return buffer_len_; }
+
+ protected:
+  // Sends |buf_len| bytes of packets of |segment_size| bytes each in one
+  // system call.  Virtual for testing.
+  virtual WriteResult WriteBatch(const char* buffer,
+                                 size_t buf_len,
+                                 size_t segment_size,
+                                 const QuicIpAddress& self_address,
+                                 const QuicSocketAddress& peer_address);
+
+ private:
+  // Returns true if a packet of |buf_len| bytes from |self_address| to
+  // |peer_address| can be appended to the current batch.
+  bool CanBatch(size_t buf_len,
+                const QuicIpAddress& self_address,
+                const QuicSocketAddress& peer_address) const;
+
+  // Returns true if no further packet can be appended to the current batch.
+  bool IsBatchFull() const;
+
+  void ResetBatch();
+
+  char buffer_[kMaxGsoBatchSize];
+  size_t buffer_len_;
+  // The size of every segment in the batch except possibly the last one.
+  size_t segment_size_;
+  size_t num_segments_;
+  QuicIpAddress self_address_;
+  QuicSocketAddress peer_address_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicGsoBatchWriter);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_GSO_BATCH_WRITER_H_
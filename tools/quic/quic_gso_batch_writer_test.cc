@@ -0,0 +1,170 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_gso_batch_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <vector>
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+struct BatchedWrite {
+  size_t buf_len;
+  size_t segment_size;
+  QuicSocketAddress peer_address;
+};
+
+// Records batches instead of sending them.
+class TestGsoBatchWriter : public QuicGsoBatchWriter {
+ public:
+  TestGsoBatchWriter()
+      : QuicGsoBatchWriter(-1), next_status_(WRITE_STATUS_OK) {}
+
+  const std::vector<BatchedWrite>& writes() const { return writes_; }
+  void set_next_status(WriteStatus status) { next_status_ = status; }
+
+ protected:
+  WriteResult WriteBatch(const char* buffer,
+                         size_t buf_len,
+                         size_t segment_size,
+                         const QuicIpAddress& self_address,
+                         const QuicSocketAddress& peer_address) override {
+    if (next_status_ == WRITE_STATUS_BLOCKED) {
+      return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+    }
+    if (next_status_ == WRITE_STATUS_ERROR) {
+      return WriteResult(WRITE_STATUS_ERROR, EPERM);
+    }
+    writes_.push_back({buf_len, segment_size, peer_address});
+    return WriteResult(WRITE_STATUS_OK, buf_len);
+  }
+
+ private:
+  WriteStatus next_status_;
+  std::vector<BatchedWrite> writes_;
+};
+
+class QuicGsoBatchWriterTest : public QuicTest {
+ protected:
+  QuicGsoBatchWriterTest()
+      : self_address_(QuicIpAddress::Loopback4()),
+        peer_address_(QuicIpAddress::Loopback4(), 443),
+        other_peer_address_(QuicIpAddress::Loopback4(), 444) {
+    memset(packet_, 'a', sizeof(packet_));
+  }
+
+  WriteResult Write(size_t length, const QuicSocketAddress& peer_address) {
+    return writer_.WritePacket(packet_, length, self_address_, peer_address,
+                               nullptr);
+  }
+
+  TestGsoBatchWriter writer_;
+  QuicIpAddress self_address_;
+  QuicSocketAddress peer_address_;
+  QuicSocketAddress other_peer_address_;
+  char packet_[kMaxPacketSize];
+};
+
+TEST_F(QuicGsoBatchWriterTest, BuffersUntilFlush) {
+  EXPECT_TRUE(writer_.IsBatchMode());
+  for (int i = 0; i < 3; ++i) {
+    WriteResult result = Write(1000, peer_address_);
+    EXPECT_EQ(WRITE_STATUS_OK, result.status);
+    EXPECT_EQ(1000, result.bytes_written);
+  }
+  EXPECT_TRUE(writer_.writes().empty());
+  EXPECT_EQ(3u, writer_.buffered_packets());
+
+  WriteResult result = writer_.Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(3000u, writer_.writes()[0].buf_len);
+  EXPECT_EQ(1000u, writer_.writes()[0].segment_size);
+  EXPECT_EQ(0u, writer_.buffered_packets());
+}
+
+TEST_F(QuicGsoBatchWriterTest, EmptyFlush) {
+  EXPECT_EQ(WRITE_STATUS_OK, writer_.Flush().status);
+  EXPECT_TRUE(writer_.writes().empty());
+}
+
+TEST_F(QuicGsoBatchWriterTest, ShortPacketEndsBatch) {
+  Write(1000, peer_address_);
+  Write(1000, peer_address_);
+  Write(500, peer_address_);
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(2500u, writer_.writes()[0].buf_len);
+  EXPECT_EQ(1000u, writer_.writes()[0].segment_size);
+  EXPECT_EQ(0u, writer_.buffered_packets());
+}
+
+TEST_F(QuicGsoBatchWriterTest, LargerPacketStartsNewBatch) {
+  Write(1000, peer_address_);
+  Write(1200, peer_address_);
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(1000u, writer_.writes()[0].buf_len);
+  EXPECT_EQ(1u, writer_.buffered_packets());
+  EXPECT_EQ(1200u, writer_.buffered_bytes());
+}
+
+TEST_F(QuicGsoBatchWriterTest, DifferentPeerStartsNewBatch) {
+  Write(1000, peer_address_);
+  Write(1000, other_peer_address_);
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(peer_address_, writer_.writes()[0].peer_address);
+  writer_.Flush();
+  ASSERT_EQ(2u, writer_.writes().size());
+  EXPECT_EQ(other_peer_address_, writer_.writes()[1].peer_address);
+}
+
+TEST_F(QuicGsoBatchWriterTest, FullBatchIsSent) {
+  for (size_t i = 0; i < QuicGsoBatchWriter::kMaxGsoSegments; ++i) {
+    Write(100, peer_address_);
+  }
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(100u * QuicGsoBatchWriter::kMaxGsoSegments,
+            writer_.writes()[0].buf_len);
+}
+
+TEST_F(QuicGsoBatchWriterTest, BlockedFlushKeepsBatch) {
+  Write(1000, peer_address_);
+  writer_.set_next_status(WRITE_STATUS_BLOCKED);
+  EXPECT_EQ(WRITE_STATUS_BLOCKED, writer_.Flush().status);
+  EXPECT_TRUE(writer_.IsWriteBlocked());
+  EXPECT_FALSE(writer_.IsWriteBlockedDataBuffered());
+  EXPECT_EQ(1u, writer_.buffered_packets());
+
+  writer_.set_next_status(WRITE_STATUS_OK);
+  writer_.SetWritable();
+  EXPECT_EQ(WRITE_STATUS_OK, writer_.Flush().status);
+  ASSERT_EQ(1u, writer_.writes().size());
+  EXPECT_EQ(1000u, writer_.writes()[0].buf_len);
+}
+
+TEST_F(QuicGsoBatchWriterTest, BlockedPacketIsNotAccepted) {
+  Write(1000, peer_address_);
+  writer_.set_next_status(WRITE_STATUS_BLOCKED);
+  // A packet to a different peer forces a flush, which blocks.
+  EXPECT_EQ(WRITE_STATUS_BLOCKED, Write(1000, other_peer_address_).status);
+  EXPECT_EQ(1u, writer_.buffered_packets());
+}
+
+TEST_F(QuicGsoBatchWriterTest, ErrorDropsBatch) {
+  Write(1000, peer_address_);
+  writer_.set_next_status(WRITE_STATUS_ERROR);
+  WriteResult result = writer_.Flush();
+  EXPECT_EQ(WRITE_STATUS_ERROR, result.status);
+  EXPECT_EQ(EPERM, result.error_code);
+  EXPECT_EQ(0u, writer_.buffered_packets());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
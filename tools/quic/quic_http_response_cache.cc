@@ -8,6 +8,7 @@
 
 #include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "net/http/http_util.h"
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_logging.h"
@@ -15,6 +16,8 @@
 #include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/quic/platform/api/quic_text_utils.h"
 #include "net/spdy/chromium/spdy_http_utils.h"
+#include "net/spdy/core/hpack/hpack_constants.h"
+#include "net/spdy/core/hpack/hpack_encoder.h"
 
 using base::FilePath;
 using base::IntToString;
@@ -22,6 +25,25 @@ using std::string;
 
 namespace net {
 
+namespace {
+
+// An IOBuffer pointing into a file mapping, which it keeps alive.
+class MappedFileIOBuffer : public WrappedIOBuffer {
+ public:
+  MappedFileIOBuffer(std::unique_ptr<base::MemoryMappedFile> mapped_file,
+                     size_t offset)
+      : WrappedIOBuffer(reinterpret_cast<const char*>(mapped_file->data()) +
+                        offset),
+        mapped_file_(std::move(mapped_file)) {}
+
+ private:
+  ~MappedFileIOBuffer() override {}
+
+  const std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+};
+
+}  // namespace
+
 QuicHttpResponseCache::ServerPushInfo::ServerPushInfo(QuicUrl request_url,
                                                       SpdyHeaderBlock headers,
                                                       SpdyPriority priority,
@@ -39,10 +61,38 @@ QuicHttpResponseCache::ServerPushInfo::ServerPushInfo(
       body(other.body) {}
 
 QuicHttpResponseCache::Response::Response()
-    : response_type_(REGULAR_RESPONSE) {}
+    : response_type_(REGULAR_RESPONSE), body_buffer_length_(0) {}
 
 QuicHttpResponseCache::Response::~Response() = default;
 
+const QuicStringPiece QuicHttpResponseCache::Response::body() const {
+  if (body_buffer_ != nullptr) {
+    return QuicStringPiece(body_buffer_->data(), body_buffer_length_);
+  }
+  return QuicStringPiece(body_);
+}
+
+void QuicHttpResponseCache::Response::set_headers(SpdyHeaderBlock headers) {
+  headers_ = std::move(headers);
+  // Nothing is ever inserted into the dynamic table, so the encoding only
+  // refers to the static table and literals.
+  HpackEncoder encoder(ObtainHpackHuffmanTable());
+  encoder.SetIndexingPolicy(
+      [](SpdyStringPiece /*name*/, SpdyStringPiece /*value*/) {
+        return false;
+      });
+  encoded_headers_.clear();
+  encoder.EncodeHeaderSet(headers_, &encoded_headers_);
+}
+
+void QuicHttpResponseCache::Response::set_mapped_body(
+    scoped_refptr<IOBuffer> buffer,
+    size_t length) {
+  body_.clear();
+  body_buffer_ = std::move(buffer);
+  body_buffer_length_ = length;
+}
+
 QuicHttpResponseCache::ResourceFile::ResourceFile(
     const base::FilePath& file_name)
     : file_name_(file_name), file_name_string_(file_name.AsUTF8Unsafe()) {}
@@ -51,22 +101,42 @@ QuicHttpResponseCache::ResourceFile::~ResourceFile() = default;
 
 void QuicHttpResponseCache::ResourceFile::Read() {
   base::ReadFileToString(FilePath(file_name_), &file_contents_);
+  ParseContents(file_contents_);
+}
 
+void QuicHttpResponseCache::ResourceFile::Map() {
+  auto mapped_file = QuicMakeUnique<base::MemoryMappedFile>();
+  if (!mapped_file->Initialize(file_name_)) {
+    // Empty files cannot be mapped.
+    Read();
+    return;
+  }
+  QuicStringPiece contents(reinterpret_cast<const char*>(mapped_file->data()),
+                           mapped_file->length());
+  if (!ParseContents(contents)) {
+    return;
+  }
+  size_t body_offset = body_.data() - contents.data();
+  body_buffer_ = new MappedFileIOBuffer(std::move(mapped_file), body_offset);
+}
+
+bool QuicHttpResponseCache::ResourceFile::ParseContents(
+    QuicStringPiece contents) {
   // First read the headers.
   size_t start = 0;
-  while (start < file_contents_.length()) {
-    size_t pos = file_contents_.find("\n", start);
+  while (start < contents.length()) {
+    size_t pos = contents.find("\n", start);
     if (pos == string::npos) {
       QUIC_LOG(DFATAL) << "Headers invalid or empty, ignoring: "
                        << file_name_.value();
-      return;
+      return false;
     }
     size_t len = pos - start;
     // Support both dos and unix line endings for convenience.
-    if (file_contents_[pos - 1] == '\r') {
+    if (contents[pos - 1] == '\r') {
       len -= 1;
     }
-    QuicStringPiece line(file_contents_.data() + start, len);
+    QuicStringPiece line(contents.data() + start, len);
     start = pos + 1;
     // Headers end with an empty line.
     if (line.empty()) {
@@ -78,7 +148,7 @@ void QuicHttpResponseCache::ResourceFile::Read() {
       if (pos == string::npos) {
         QUIC_LOG(DFATAL) << "Headers invalid or empty, ignoring: "
                          << file_name_.value();
-        return;
+        return false;
       }
       spdy_headers_[":status"] = line.substr(pos + 1, 3);
       continue;
@@ -88,7 +158,7 @@ void QuicHttpResponseCache::ResourceFile::Read() {
     if (pos == string::npos) {
       QUIC_LOG(DFATAL) << "Headers invalid or empty, ignoring: "
                        << file_name_.value();
-      return;
+      return false;
     }
     spdy_headers_.AppendValueOrAddHeader(
         QuicTextUtils::ToLower(line.substr(0, pos)), line.substr(pos + 2));
@@ -123,8 +193,8 @@ void QuicHttpResponseCache::ResourceFile::Read() {
     }
   }
 
-  body_ = QuicStringPiece(file_contents_.data() + start,
-                          file_contents_.size() - start);
+  body_ = QuicStringPiece(contents.data() + start, contents.size() - start);
+  return true;
 }
 
 void QuicHttpResponseCache::ResourceFile::SetHostPathFromBase(
@@ -207,7 +277,7 @@ void QuicHttpResponseCache::AddResponse(QuicStringPiece host,
                                         SpdyHeaderBlock response_headers,
                                         QuicStringPiece response_body) {
   AddResponseImpl(host, path, REGULAR_RESPONSE, std::move(response_headers),
-                  response_body, SpdyHeaderBlock());
+                  response_body, nullptr, SpdyHeaderBlock());
 }
 
 void QuicHttpResponseCache::AddResponse(QuicStringPiece host,
@@ -216,14 +286,14 @@ void QuicHttpResponseCache::AddResponse(QuicStringPiece host,
                                         QuicStringPiece response_body,
                                         SpdyHeaderBlock response_trailers) {
   AddResponseImpl(host, path, REGULAR_RESPONSE, std::move(response_headers),
-                  response_body, std::move(response_trailers));
+                  response_body, nullptr, std::move(response_trailers));
 }
 
 void QuicHttpResponseCache::AddSpecialResponse(
     QuicStringPiece host,
     QuicStringPiece path,
     SpecialResponseType response_type) {
-  AddResponseImpl(host, path, response_type, SpdyHeaderBlock(), "",
+  AddResponseImpl(host, path, response_type, SpdyHeaderBlock(), "", nullptr,
                   SpdyHeaderBlock());
 }
 
@@ -231,6 +301,15 @@ QuicHttpResponseCache::QuicHttpResponseCache() = default;
 
 void QuicHttpResponseCache::InitializeFromDirectory(
     const string& cache_directory) {
+  LoadDirectory(cache_directory, /*map_files=*/false);
+}
+
+void QuicHttpResponseCache::MapFromDirectory(const string& cache_directory) {
+  LoadDirectory(cache_directory, /*map_files=*/true);
+}
+
+void QuicHttpResponseCache::LoadDirectory(const string& cache_directory,
+                                          bool map_files) {
   if (cache_directory.empty()) {
     QUIC_BUG << "cache_directory must not be empty.";
     return;
@@ -258,10 +337,16 @@ void QuicHttpResponseCache::InitializeFromDirectory(
     }
 
     resource_file->SetHostPathFromBase(base);
-    resource_file->Read();
+    if (map_files) {
+      resource_file->Map();
+    } else {
+      resource_file->Read();
+    }
 
-    AddResponse(resource_file->host(), resource_file->path(),
-                resource_file->spdy_headers().Clone(), resource_file->body());
+    AddResponseImpl(resource_file->host(), resource_file->path(),
+                    REGULAR_RESPONSE, resource_file->spdy_headers().Clone(),
+                    resource_file->body(), resource_file->body_buffer(),
+                    SpdyHeaderBlock());
 
     resource_files.push_back(std::move(resource_file));
   }
@@ -305,12 +390,14 @@ QuicHttpResponseCache::~QuicHttpResponseCache() {
   }
 }
 
-void QuicHttpResponseCache::AddResponseImpl(QuicStringPiece host,
-                                            QuicStringPiece path,
-                                            SpecialResponseType response_type,
-                                            SpdyHeaderBlock response_headers,
-                                            QuicStringPiece response_body,
-                                            SpdyHeaderBlock response_trailers) {
+void QuicHttpResponseCache::AddResponseImpl(
+    QuicStringPiece host,
+    QuicStringPiece path,
+    SpecialResponseType response_type,
+    SpdyHeaderBlock response_headers,
+    QuicStringPiece response_body,
+    scoped_refptr<IOBuffer> response_body_buffer,
+    SpdyHeaderBlock response_trailers) {
   QuicWriterMutexLock lock(&response_mutex_);
 
   DCHECK(!host.empty()) << "Host must be populated, e.g. \"www.google.com\"";
@@ -322,7 +409,13 @@ void QuicHttpResponseCache::AddResponseImpl(QuicStringPiece host,
   auto new_response = QuicMakeUnique<Response>();
   new_response->set_response_type(response_type);
   new_response->set_headers(std::move(response_headers));
-  new_response->set_body(response_body);
+  if (response_body_buffer != nullptr) {
+    DCHECK(response_body_buffer->data() == response_body.data());
+    new_response->set_mapped_body(std::move(response_body_buffer),
+                                  response_body.size());
+  } else {
+    new_response->set_body(response_body);
+  }
   new_response->set_trailers(std::move(response_trailers));
   QUIC_DVLOG(1) << "Add response with key " << key;
   responses_[key] = std::move(new_response);
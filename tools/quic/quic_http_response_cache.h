@@ -13,6 +13,8 @@
 
 #include "base/files/file_path.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/io_buffer.h"
 #include "net/quic/core/spdy_utils.h"
 #include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_mutex.h"
@@ -25,6 +27,8 @@ namespace net {
 // In-memory cache for HTTP responses.
 // Reads from disk cache generated by:
 // `wget -p --save_headers <url>`
+// The files can also be mapped rather than read, in which case the bodies are
+// served straight from the mappings.
 class QuicHttpResponseCache {
  public:
   // A ServerPushInfo contains path of the push request and everything needed in
@@ -55,25 +59,37 @@ class QuicHttpResponseCache {
 
     SpecialResponseType response_type() const { return response_type_; }
     const SpdyHeaderBlock& headers() const { return headers_; }
+    // HPACK encoding of |headers()| which does not use the dynamic table, so
+    // that it can be sent on any connection as is.
+    const std::string& encoded_headers() const { return encoded_headers_; }
     const SpdyHeaderBlock& trailers() const { return trailers_; }
-    const QuicStringPiece body() const { return QuicStringPiece(body_); }
+    const QuicStringPiece body() const;
+    // Buffer holding |body()|, if it is mapped from a file.  Lets the body be
+    // sent without copying it.
+    const scoped_refptr<IOBuffer>& body_buffer() const { return body_buffer_; }
 
     void set_response_type(SpecialResponseType response_type) {
       response_type_ = response_type;
     }
-    void set_headers(SpdyHeaderBlock headers) { headers_ = std::move(headers); }
+    void set_headers(SpdyHeaderBlock headers);
     void set_trailers(SpdyHeaderBlock trailers) {
       trailers_ = std::move(trailers);
     }
     void set_body(QuicStringPiece body) {
+      body_buffer_ = nullptr;
       body_.assign(body.data(), body.size());
     }
+    // Makes the first |length| bytes of |buffer| the body, without copying.
+    void set_mapped_body(scoped_refptr<IOBuffer> buffer, size_t length);
 
    private:
     SpecialResponseType response_type_;
     SpdyHeaderBlock headers_;
+    std::string encoded_headers_;
     SpdyHeaderBlock trailers_;
     std::string body_;
+    scoped_refptr<IOBuffer> body_buffer_;
+    size_t body_buffer_length_;
 
     DISALLOW_COPY_AND_ASSIGN(Response);
   };
@@ -89,6 +105,9 @@ class QuicHttpResponseCache {
 
     void Read();
 
+    // Like Read(), but maps the file and leaves the body in |body_buffer()|.
+    void Map();
+
     // |base| is |file_name_| with |cache_directory| prefix stripped.
     void SetHostPathFromBase(QuicStringPiece base);
 
@@ -104,9 +123,15 @@ class QuicHttpResponseCache {
 
     QuicStringPiece body() { return body_; }
 
+    // The mapping |body()| points into, if the file was mapped.
+    const scoped_refptr<IOBuffer>& body_buffer() { return body_buffer_; }
+
     const std::vector<QuicStringPiece>& push_urls() { return push_urls_; }
 
    protected:
+    // Parses the headers and body out of |contents|, which must outlive this
+    // object.  Returns false if the headers are invalid.
+    bool ParseContents(QuicStringPiece contents);
     void HandleXOriginalUrl();
     void HandlePushUrls(const std::vector<QuicStringPiece>& push_urls);
     QuicStringPiece RemoveScheme(QuicStringPiece url);
@@ -116,6 +141,7 @@ class QuicHttpResponseCache {
     const std::string file_name_string_;
     std::string file_contents_;
     QuicStringPiece body_;
+    scoped_refptr<IOBuffer> body_buffer_;
     SpdyHeaderBlock spdy_headers_;
     QuicStringPiece x_original_url_;
     std::vector<QuicStringPiece> push_urls_;
@@ -178,6 +204,10 @@ class QuicHttpResponseCache {
   // |cache_cirectory| can be generated using `wget -p --save-headers <url>`.
   void InitializeFromDirectory(const std::string& cache_directory);
 
+  // Same as InitializeFromDirectory(), but maps the files instead of reading
+  // them.  The mappings are kept for the lifetime of the cache.
+  void MapFromDirectory(const std::string& cache_directory);
+
   // Find all the server push resources associated with |request_url|.
   std::list<ServerPushInfo> GetServerPushResources(std::string request_url);
 
@@ -187,8 +217,11 @@ class QuicHttpResponseCache {
                        SpecialResponseType response_type,
                        SpdyHeaderBlock response_headers,
                        QuicStringPiece response_body,
+                       scoped_refptr<IOBuffer> response_body_buffer,
                        SpdyHeaderBlock response_trailers);
 
+  void LoadDirectory(const std::string& cache_directory, bool map_files);
+
   std::string GetKey(QuicStringPiece host, QuicStringPiece path) const;
 
   // Add some server push urls with given responses for specified
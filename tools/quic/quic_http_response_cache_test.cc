@@ -10,6 +10,7 @@
 #include "net/quic/platform/api/quic_str_cat.h"
 #include "net/quic/platform/api/quic_test.h"
 #include "net/quic/platform/api/quic_text_utils.h"
+#include "net/spdy/core/hpack/hpack_decoder_adapter.h"
 
 using std::string;
 
@@ -100,6 +101,43 @@ TEST_F(QuicHttpResponseCacheTest, ReadsCacheDir) {
   EXPECT_LT(0U, response->body().length());
 }
 
+TEST_F(QuicHttpResponseCacheTest, MapsCacheDir) {
+  QuicHttpResponseCache read_cache;
+  read_cache.InitializeFromDirectory(CacheDirectory());
+  cache_.MapFromDirectory(CacheDirectory());
+  for (const char* path : {"/index.html", "/site_map.html"}) {
+    const Response* read_response =
+        read_cache.GetResponse("test.example.com", path);
+    const Response* response = cache_.GetResponse("test.example.com", path);
+    ASSERT_TRUE(read_response);
+    ASSERT_TRUE(response);
+    EXPECT_EQ(read_response->headers(), response->headers());
+    EXPECT_EQ(read_response->body(), response->body());
+    // The body is served from the mapping.
+    EXPECT_FALSE(read_response->body_buffer());
+    ASSERT_TRUE(response->body_buffer());
+    EXPECT_EQ(response->body_buffer()->data(), response->body().data());
+  }
+}
+
+TEST_F(QuicHttpResponseCacheTest, EncodesHeaders) {
+  cache_.AddSimpleResponse("www.google.com", "/", 200, "hello");
+  const Response* response = cache_.GetResponse("www.google.com", "/");
+  ASSERT_TRUE(response);
+
+  // The encoding does not depend on the state of the decoder.
+  for (int i = 0; i < 2; ++i) {
+    HpackDecoderAdapter decoder;
+    for (int j = 0; j <= i; ++j) {
+      ASSERT_TRUE(decoder.HandleControlFrameHeadersData(
+          response->encoded_headers().data(),
+          response->encoded_headers().size()));
+      ASSERT_TRUE(decoder.HandleControlFrameHeadersComplete(nullptr));
+    }
+    EXPECT_EQ(response->headers(), decoder.decoded_block());
+  }
+}
+
 TEST_F(QuicHttpResponseCacheTest, ReadsCacheDirWithServerPushResource) {
   cache_.InitializeFromDirectory(CacheDirectory() + "_with_push");
   std::list<ServerPushInfo> resources =
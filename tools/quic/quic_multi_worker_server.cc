@@ -0,0 +1,118 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_multi_worker_server.h"
+
+#include <utility>
+
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
+
+namespace net {
+
+namespace {
+
+std::unique_ptr<QuicServerConfigProtobuf> CopyServerConfig(
+    const QuicServerConfigProtobuf& config) {
+  auto copy = QuicMakeUnique<QuicServerConfigProtobuf>();
+  copy->set_config(config.config());
+  for (size_t i = 0; i < config.key_size(); ++i) {
+    QuicServerConfigProtobuf::PrivateKey* key = copy->add_key();
+    key->set_tag(config.key(i).tag());
+    key->set_private_key(config.key(i).private_key());
+  }
+  if (config.has_primary_time()) {
+    copy->set_primary_time(config.primary_time());
+  }
+  if (config.has_priority()) {
+    copy->set_priority(config.priority());
+  }
+  if (config.has_source_address_token_secret_override()) {
+    copy->set_source_address_token_secret_override(
+        config.source_address_token_secret_override());
+  }
+  return copy;
+}
+
+}  // namespace
+
+QuicMultiWorkerServer::Worker::Worker(std::unique_ptr<QuicServer> server)
+    : SimpleThread("quic_server_worker"), server_(std::move(server)) {}
+
+QuicMultiWorkerServer::Worker::~Worker() = default;
+
+void QuicMultiWorkerServer::Worker::Quit() {
+  quit_.Set();
+}
+
+void QuicMultiWorkerServer::Worker::Run() {
+  while (!quit_.IsSet()) {
+    server_->WaitForEvents();
+  }
+  server_->Shutdown();
+}
+
+QuicMultiWorkerServer::QuicMultiWorkerServer(size_t num_workers,
+                                             ServerFactory server_factory)
+    : num_workers_(num_workers),
+      server_factory_(std::move(server_factory)),
+      steer_by_connection_id_(false),
+      port_(0) {
+  DCHECK_GT(num_workers_, 0u);
+}
+
+QuicMultiWorkerServer::~QuicMultiWorkerServer() {
+  Stop();
+}
+
+bool QuicMultiWorkerServer::Start(const QuicSocketAddress& address) {
+  DCHECK(workers_.empty());
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::unique_ptr<QuicServerConfigProtobuf> server_config;
+  QuicSocketAddress bind_address = address;
+
+  for (size_t i = 0; i < num_workers_; ++i) {
+    std::unique_ptr<QuicServer> server = server_factory_();
+    server->set_reuse_port(true);
+    if (server_config == nullptr) {
+      server_config = server->GenerateServerConfig();
+    }
+    std::vector<std::unique_ptr<QuicServerConfigProtobuf>> configs;
+    configs.push_back(CopyServerConfig(*server_config));
+    if (!server->SetServerConfigs(configs)) {
+      QUIC_LOG(ERROR) << "Failed to install the shared server config.";
+      return false;
+    }
+    if (!server->CreateUDPSocketAndListen(bind_address)) {
+      return false;
+    }
+    // Later workers join the port picked by the first one.
+    bind_address = QuicSocketAddress(address.host(), server->port());
+    workers.push_back(QuicMakeUnique<Worker>(std::move(server)));
+  }
+
+  if (steer_by_connection_id_ &&
+      !workers[0]->server()->AttachConnectionIdSteering(num_workers_)) {
+    return false;
+  }
+
+  port_ = bind_address.port();
+  workers_ = std::move(workers);
+  for (const auto& worker : workers_) {
+    worker->Start();
+  }
+  return true;
+}
+
+void QuicMultiWorkerServer::Stop() {
+  for (const auto& worker : workers_) {
+    worker->Quit();
+  }
+  for (const auto& worker : workers_) {
+    worker->Join();
+  }
+  workers_.clear();
+}
+
+}  // namespace net
@@ -0,0 +1,92 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Runs several QuicServers on one address, each on its own thread.
+
+#ifndef NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
+#define NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/synchronization/atomic_flag.h"
+#include "base/threading/simple_thread.h"
+#include "net/quic/platform/api/quic_socket_address.h"
+#include "net/tools/quic/quic_server.h"
+
+namespace net {
+
+// Shards a QUIC server across cores.  Each worker is a QuicServer with its own
+// epoll loop, dispatcher and SO_REUSEPORT socket, running on its own thread.
+//
+// When connection ID steering is enabled, the kernel routes every packet to
+// the worker chosen by its connection ID rather than by its 4-tuple, so a
+// connection stays on one worker across client migrations.  Each worker's
+// QuicTimeWaitListManager then sees every packet for the connections it
+// closed, so time-wait state does not need to be shared between threads.
+// The workers share one server config, so a client's cached config, source
+// address token and 0-RTT handshake are accepted by any worker.
+class QuicMultiWorkerServer {
+ public:
+  // Creates the QuicServer for one worker.  Called once per worker, on the
+  // thread calling Start.
+  typedef std::function<std::unique_ptr<QuicServer>()> ServerFactory;
+
+  QuicMultiWorkerServer(size_t num_workers, ServerFactory server_factory);
+  ~QuicMultiWorkerServer();
+
+  void set_steer_by_connection_id(bool steer_by_connection_id) {
+    steer_by_connection_id_ = steer_by_connection_id;
+  }
+
+  // Creates the workers, binds their sockets to |address| and starts their
+  // threads.  Returns false if any socket could not be set up, in which case
+  // no worker is started.
+  bool Start(const QuicSocketAddress& address);
+
+  // Shuts down every worker and joins its thread.
+  void Stop();
+
+  size_t num_workers() const { return num_workers_; }
+
+  // The port all workers listen on.  Only valid after Start.
+  int port() const { return port_; }
+
+ private:
+  class Worker : public base::SimpleThread {
+   public:
+    explicit Worker(std::unique_ptr<QuicServer> server);
+    ~Worker() override;
+
+    // Makes the event loop exit after its current iteration.
+    void Quit();
+
+    QuicServer* server() { return server_.get(); }
+
+    // base::SimpleThread
+    void Run() override;
+
+   private:
+    std::unique_ptr<QuicServer> server_;
+    base::AtomicFlag quit_;
+
+    DISALLOW_COPY_AND_ASSIGN(Worker);
+  };
+
+  const size_t num_workers_;
+  ServerFactory server_factory_;
+  bool steer_by_connection_id_;
+  int port_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicMultiWorkerServer);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
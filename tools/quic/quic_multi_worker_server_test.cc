@@ -0,0 +1,44 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_multi_worker_server.h"
+
+#include "net/quic/platform/api/quic_ptr_util.h"
+#include "net/quic/platform/api/quic_socket_address.h"
+#include "net/quic/platform/api/quic_test.h"
+#include "net/quic/test_tools/crypto_test_utils.h"
+#include "net/tools/quic/quic_http_response_cache.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class QuicMultiWorkerServerTest : public QuicTest {
+ protected:
+  QuicMultiWorkerServer::ServerFactory ServerFactory() {
+    return [this]() {
+      return QuicMakeUnique<QuicServer>(
+          crypto_test_utils::ProofSourceForTesting(), &response_cache_);
+    };
+  }
+
+  QuicHttpResponseCache response_cache_;
+};
+
+TEST_F(QuicMultiWorkerServerTest, WorkersShareOnePort) {
+  QuicMultiWorkerServer server(3, ServerFactory());
+  ASSERT_TRUE(server.Start(QuicSocketAddress(QuicIpAddress::Loopback4(), 0)));
+  EXPECT_EQ(3u, server.num_workers());
+  EXPECT_NE(0, server.port());
+  server.Stop();
+}
+
+TEST_F(QuicMultiWorkerServerTest, StopWithoutStart) {
+  QuicMultiWorkerServer server(2, ServerFactory());
+  server.Stop();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -0,0 +1,108 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_overload_controller.h"
+
+#include <initializer_list>
+
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+namespace {
+
+// Weight of a new sample in the smoothed lag.  Under overload every iteration
+// is slow, so the average crosses a threshold within a few iterations.
+const float kLagAlpha = 0.25f;
+const float kOneMinusLagAlpha = 1 - kLagAlpha;
+
+}  // namespace
+
+QuicOverloadController::Stats::Stats()
+    : connections_rejected(0),
+      connections_dropped(0),
+      overload_episodes(0),
+      max_lag(QuicTime::Delta::Zero()) {}
+
+QuicOverloadController::QuicOverloadController()
+    : reject_lag_(QuicTime::Delta::FromMilliseconds(kDefaultRejectLagMs)),
+      reject_pending_handshakes_(kDefaultRejectPendingHandshakes),
+      drop_lag_(QuicTime::Delta::FromMilliseconds(kDefaultDropLagMs)),
+      drop_pending_handshakes_(kDefaultDropPendingHandshakes),
+      smoothed_lag_(QuicTime::Delta::Zero()),
+      action_(ACCEPT) {}
+
+QuicOverloadController::~QuicOverloadController() {}
+
+void QuicOverloadController::SetRejectThresholds(QuicTime::Delta lag,
+                                                 size_t pending_handshakes) {
+  DCHECK(lag <= drop_lag_);
+  DCHECK_LE(pending_handshakes, drop_pending_handshakes_);
+  reject_lag_ = lag;
+  reject_pending_handshakes_ = pending_handshakes;
+}
+
+void QuicOverloadController::SetDropThresholds(QuicTime::Delta lag,
+                                               size_t pending_handshakes) {
+  DCHECK(reject_lag_ <= lag);
+  DCHECK_LE(reject_pending_handshakes_, pending_handshakes);
+  drop_lag_ = lag;
+  drop_pending_handshakes_ = pending_handshakes;
+}
+
+void QuicOverloadController::OnEventLoopIteration(QuicTime::Delta lag) {
+  if (lag > stats_.max_lag) {
+    stats_.max_lag = lag;
+  }
+  smoothed_lag_ = kOneMinusLagAlpha * smoothed_lag_ + kLagAlpha * lag;
+}
+
+QuicOverloadController::Action QuicOverloadController::OnNewConnection(
+    size_t pending_handshakes) {
+  // The levels up to the current one are kept until the load is well below
+  // them.
+  Action action = ACCEPT;
+  for (Action level : {REJECT, DROP}) {
+    if (Exceeds(level, pending_handshakes, level <= action_ ? 2 : 1)) {
+      action = level;
+    }
+  }
+  if (action_ == ACCEPT && action != ACCEPT) {
+    ++stats_.overload_episodes;
+    QUIC_LOG(WARNING) << "Server overloaded, shedding new connections. "
+                      << "Smoothed event loop lag: " << smoothed_lag_
+                      << ", pending handshakes: " << pending_handshakes;
+  }
+  action_ = action;
+
+  switch (action_) {
+    case ACCEPT:
+      break;
+    case REJECT:
+      ++stats_.connections_rejected;
+      break;
+    case DROP:
+      ++stats_.connections_dropped;
+      break;
+  }
+  return action_;
+}
+
+bool QuicOverloadController::Exceeds(Action action,
+                                     size_t pending_handshakes,
+                                     int divisor) const {
+  switch (action) {
+    case ACCEPT:
+      return true;
+    case REJECT:
+      return smoothed_lag_ * divisor >= reject_lag_ ||
+             pending_handshakes * divisor >= reject_pending_handshakes_;
+    case DROP:
+      return smoothed_lag_ * divisor >= drop_lag_ ||
+             pending_handshakes * divisor >= drop_pending_handshakes_;
+  }
+  return false;
+}
+
+}  // namespace net
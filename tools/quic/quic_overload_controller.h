@@ -0,0 +1,94 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_OVERLOAD_CONTROLLER_H_
+#define NET_TOOLS_QUIC_QUIC_OVERLOAD_CONTROLLER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "net/quic/core/quic_time.h"
+
+namespace net {
+
+// Decides whether a server has room for new connections from two signals: the
+// lag of its event loop, which is how long an iteration spends handling events
+// and alarms before it polls again, and the number of handshakes waiting for
+// crypto work.  Once either signal crosses a threshold the dispatcher turns
+// new connections away, first by closing them statelessly and then, past a
+// second threshold, by dropping their packets, so that the sessions it already
+// has keep being served.  A level is left only once both signals have fallen
+// below half of its thresholds, so that shedding load does not flap.
+//
+// This class is thread-unsafe.
+class QuicOverloadController {
+ public:
+  // What to do with a new connection, in increasing order of severity.
+  enum Action {
+    ACCEPT,
+    // Close the connection without creating a session.
+    REJECT,
+    // Drop the packet without replying.
+    DROP,
+  };
+
+  struct Stats {
+    Stats();
+
+    uint64_t connections_rejected;
+    uint64_t connections_dropped;
+    // Number of times the controller started shedding load.
+    uint64_t overload_episodes;
+    QuicTime::Delta max_lag;
+  };
+
+  static const int64_t kDefaultRejectLagMs = 50;
+  static const size_t kDefaultRejectPendingHandshakes = 1000;
+  static const int64_t kDefaultDropLagMs = 200;
+  static const size_t kDefaultDropPendingHandshakes = 4000;
+
+  QuicOverloadController();
+  ~QuicOverloadController();
+
+  // Sets the lag and the number of pending handshakes at which new
+  // connections are rejected, or dropped.  Rejecting must not start after
+  // dropping does.
+  void SetRejectThresholds(QuicTime::Delta lag, size_t pending_handshakes);
+  void SetDropThresholds(QuicTime::Delta lag, size_t pending_handshakes);
+
+  // Records the lag of one iteration of the event loop.
+  void OnEventLoopIteration(QuicTime::Delta lag);
+
+  // Returns what to do with a new connection while |pending_handshakes|
+  // handshakes are waiting for crypto work, and counts the decision.
+  Action OnNewConnection(size_t pending_handshakes);
+
+  QuicTime::Delta smoothed_lag() const { return smoothed_lag_; }
+
+  Action action() const { return action_; }
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Returns true if the signals are at least the thresholds of |action|
+  // divided by |divisor|.
+  bool Exceeds(Action action, size_t pending_handshakes, int divisor) const;
+
+  QuicTime::Delta reject_lag_;
+  size_t reject_pending_handshakes_;
+  QuicTime::Delta drop_lag_;
+  size_t drop_pending_handshakes_;
+
+  // Moving average of the lag, which lets a single slow iteration pass.
+  QuicTime::Delta smoothed_lag_;
+  Action action_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicOverloadController);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_OVERLOAD_CONTROLLER_H_
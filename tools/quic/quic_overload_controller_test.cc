@@ -0,0 +1,86 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_overload_controller.h"
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class QuicOverloadControllerTest : public QuicTest {
+ protected:
+  QuicOverloadControllerTest() {
+    controller_.SetRejectThresholds(QuicTime::Delta::FromMilliseconds(40), 100);
+    controller_.SetDropThresholds(QuicTime::Delta::FromMilliseconds(80), 200);
+  }
+
+  // Runs enough iterations with a lag of |lag_ms| for the smoothed lag to
+  // settle within a millisecond of it.
+  void RunEventLoop(int64_t lag_ms) {
+    for (int i = 0; i < 20; ++i) {
+      controller_.OnEventLoopIteration(
+          QuicTime::Delta::FromMilliseconds(lag_ms));
+    }
+  }
+
+  QuicOverloadController controller_;
+};
+
+TEST_F(QuicOverloadControllerTest, AcceptsWhenIdle) {
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(0));
+  RunEventLoop(10);
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(99));
+  EXPECT_EQ(0u, controller_.stats().overload_episodes);
+  EXPECT_EQ(0u, controller_.stats().connections_rejected);
+}
+
+TEST_F(QuicOverloadControllerTest, SingleSlowIterationIsSmoothed) {
+  controller_.OnEventLoopIteration(QuicTime::Delta::FromMilliseconds(100));
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(100),
+            controller_.stats().max_lag);
+  EXPECT_EQ(QuicTime::Delta::FromMilliseconds(25), controller_.smoothed_lag());
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(0));
+}
+
+TEST_F(QuicOverloadControllerTest, ShedsOnLag) {
+  RunEventLoop(50);
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(0));
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(0));
+  RunEventLoop(100);
+  EXPECT_EQ(QuicOverloadController::DROP, controller_.OnNewConnection(0));
+
+  EXPECT_EQ(1u, controller_.stats().overload_episodes);
+  EXPECT_EQ(2u, controller_.stats().connections_rejected);
+  EXPECT_EQ(1u, controller_.stats().connections_dropped);
+}
+
+TEST_F(QuicOverloadControllerTest, ShedsOnPendingHandshakes) {
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(100));
+  EXPECT_EQ(QuicOverloadController::DROP, controller_.OnNewConnection(200));
+  EXPECT_EQ(1u, controller_.stats().overload_episodes);
+}
+
+TEST_F(QuicOverloadControllerTest, Hysteresis) {
+  EXPECT_EQ(QuicOverloadController::DROP, controller_.OnNewConnection(200));
+  // Below the drop threshold, but not below half of it.
+  EXPECT_EQ(QuicOverloadController::DROP, controller_.OnNewConnection(150));
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(99));
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(50));
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(49));
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(99));
+
+  RunEventLoop(50);
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(0));
+  RunEventLoop(25);
+  EXPECT_EQ(QuicOverloadController::REJECT, controller_.OnNewConnection(0));
+  RunEventLoop(10);
+  EXPECT_EQ(QuicOverloadController::ACCEPT, controller_.OnNewConnection(0));
+  EXPECT_EQ(2u, controller_.stats().overload_episodes);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -10,6 +10,9 @@
 #include <features.h>
 #endif
 #include <string.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 
 #include "net/quic/platform/api/quic_bug_tracker.h"
 #include "net/quic/platform/api/quic_flags.h"
@@ -25,6 +28,12 @@
 
 namespace net {
 
+namespace {
+
+// The largest buffer the kernel can coalesce datagrams into.
+const size_t kMaxGroBufferSize = 65535;
+
+}  // namespace
 
 QuicPacketReader::QuicPacketReader() {
   Initialize();
@@ -62,6 +71,10 @@ bool QuicPacketReader::ReadAndDispatchPackets(
     const QuicClock& clock,
     ProcessPacketInterface* processor,
     QuicPacketCount* packets_dropped) {
+  if (gro_enabled()) {
+    return ReadAndDispatchCoalescedPackets(fd, port, clock, processor,
+                                           packets_dropped);
+  }
 #if MMSG_MORE
   return ReadAndDispatchManyPackets(fd, port, clock, processor,
                                     packets_dropped);
@@ -130,9 +143,10 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
     int ttl = 0;
     bool has_ttl =
         QuicSocketUtils::GetTtlFromMsghdr(&mmsg_hdr_[i].msg_hdr, &ttl);
-    QuicReceivedPacket packet(reinterpret_cast<char*>(packets_[i].iov.iov_base),
-                              mmsg_hdr_[i].msg_len, timestamp, false, ttl,
-                              has_ttl);
+    char* buffer = reinterpret_cast<char*>(packets_[i].iov.iov_base);
+    QuicReceivedPacket packet(buffer, mmsg_hdr_[i].msg_len, timestamp, false,
+                              ttl, has_ttl);
+    packet.set_mutable_data(buffer);
     QuicSocketAddress server_address(server_ip, port);
     processor->ProcessPacket(server_address, client_address, packet);
   }
@@ -150,6 +164,112 @@ bool QuicPacketReader::ReadAndDispatchManyPackets(
 #endif
 }
 
+bool QuicPacketReader::EnableGro(int fd) {
+  if (!QuicSocketUtils::EnableUdpGro(fd)) {
+    QUIC_DLOG(INFO) << "UDP_GRO is not supported, reading single datagrams.";
+    return false;
+  }
+  gro_buffer_.reset(new char[kMaxGroBufferSize]);
+  return true;
+}
+
+// static
+void QuicPacketReader::DispatchCoalescedPackets(
+    char* buffer,
+    size_t length,
+    size_t segment_size,
+    QuicTime timestamp,
+    int ttl,
+    bool has_ttl,
+    const QuicSocketAddress& server_address,
+    const QuicSocketAddress& client_address,
+    ProcessPacketInterface* processor) {
+  DCHECK_GT(segment_size, 0u);
+  for (size_t offset = 0; offset < length; offset += segment_size) {
+    size_t packet_length = std::min(segment_size, length - offset);
+    QuicReceivedPacket packet(buffer + offset, packet_length, timestamp, false,
+                              ttl, has_ttl);
+    packet.set_mutable_data(buffer + offset);
+    processor->ProcessPacket(server_address, client_address, packet);
+  }
+}
+
+bool QuicPacketReader::ReadAndDispatchCoalescedPackets(
+    int fd,
+    int port,
+    const QuicClock& clock,
+    ProcessPacketInterface* processor,
+    QuicPacketCount* packets_dropped) {
+  char cbuf[QuicSocketUtils::kSpaceForGroCmsg];
+  memset(cbuf, 0, arraysize(cbuf));
+
+  iovec iov = {gro_buffer_.get(), kMaxGroBufferSize};
+  sockaddr_storage raw_address;
+  msghdr hdr;
+  hdr.msg_name = &raw_address;
+  hdr.msg_namelen = sizeof(sockaddr_storage);
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  hdr.msg_flags = 0;
+  hdr.msg_control = cbuf;
+  hdr.msg_controllen = arraysize(cbuf);
+
+  int bytes_read = recvmsg(fd, &hdr, 0);
+  if (bytes_read < 0) {
+    if (errno != EAGAIN) {
+      QUIC_LOG(ERROR) << "Error reading " << strerror(errno);
+    }
+    return false;
+  }
+  if (bytes_read == 0) {
+    return true;
+  }
+
+  if (hdr.msg_controllen >= arraysize(cbuf)) {
+    QUIC_BUG << "Incorrectly set control length: " << hdr.msg_controllen
+             << ", expected " << arraysize(cbuf);
+    return false;
+  }
+
+  if (packets_dropped != nullptr) {
+    QuicSocketUtils::GetOverflowFromMsghdr(&hdr, packets_dropped);
+  }
+
+  QuicIpAddress server_ip;
+  QuicWallTime walltimestamp = QuicWallTime::Zero();
+  QuicSocketUtils::GetAddressAndTimestampFromMsghdr(&hdr, &server_ip,
+                                                    &walltimestamp);
+  if (!server_ip.IsInitialized()) {
+    QUIC_BUG << "Unable to get server address.";
+    return false;
+  }
+  // This isn't particularly desirable, but not all platforms support socket
+  // timestamping.
+  if (walltimestamp.IsZero()) {
+    walltimestamp = clock.WallNow();
+  }
+  QuicTime timestamp = clock.ConvertWallTimeToQuicTime(walltimestamp);
+
+  int ttl = 0;
+  bool has_ttl = QuicSocketUtils::GetTtlFromMsghdr(&hdr, &ttl);
+
+  // Without a UDP_GRO control message the read holds a single datagram.
+  int segment_size = bytes_read;
+  if (!QuicSocketUtils::GetGroSegmentSizeFromMsghdr(&hdr, &segment_size) ||
+      segment_size <= 0) {
+    segment_size = bytes_read;
+  }
+
+  DispatchCoalescedPackets(gro_buffer_.get(), bytes_read, segment_size,
+                           timestamp, ttl, has_ttl,
+                           QuicSocketAddress(server_ip, port),
+                           QuicSocketAddress(raw_address), processor);
+
+  // The socket read was successful, so return true even if packet dispatch
+  // failed.
+  return true;
+}
+
 /* static */
 bool QuicPacketReader::ReadAndDispatchSinglePacket(
     int fd,
@@ -181,6 +301,7 @@ bool QuicPacketReader::ReadAndDispatchSinglePacket(
   QuicTime timestamp = clock.ConvertWallTimeToQuicTime(walltimestamp);
 
   QuicReceivedPacket packet(buf, bytes_read, timestamp, false);
+  packet.set_mutable_data(buf);
   QuicSocketAddress server_address(server_ip, port);
   processor->ProcessPacket(server_address, client_address, packet);
 
@@ -12,6 +12,8 @@
 // regardless of how the below transitive header include set may change.
 #include <sys/socket.h>
 
+#include <memory>
+
 #include "base/macros.h"
 #include "net/quic/core/quic_packets.h"
 #include "net/quic/platform/api/quic_clock.h"
@@ -47,6 +49,28 @@ class QuicPacketReader {
                                       ProcessPacketInterface* processor,
                                       QuicPacketCount* packets_dropped);
 
+  // Enables UDP_GRO on |fd|, after which ReadAndDispatchPackets receives
+  // kernel-coalesced datagrams in one large buffer and splits them.  Returns
+  // false, leaving the reader on its regular path, if the kernel does not
+  // support GRO.
+  bool EnableGro(int fd);
+
+  bool gro_enabled() const { return gro_buffer_ != nullptr; }
+
+  // Splits |length| bytes of coalesced datagrams in |buffer|, each
+  // |segment_size| bytes long except possibly the last, into packets which
+  // reference |buffer| and passes them to |processor|. The packets may be
+  // modified in place while they are processed.
+  static void DispatchCoalescedPackets(char* buffer,
+                                       size_t length,
+                                       size_t segment_size,
+                                       QuicTime timestamp,
+                                       int ttl,
+                                       bool has_ttl,
+                                       const QuicSocketAddress& server_address,
+                                       const QuicSocketAddress& client_address,
+                                       ProcessPacketInterface* processor);
+
  private:
   // Initialize the internal state of the reader.
   void Initialize();
@@ -58,6 +82,14 @@ class QuicPacketReader {
                                   ProcessPacketInterface* processor,
                                   QuicPacketCount* packets_dropped);
 
+  // Reads one buffer of coalesced datagrams using recvmsg on a socket with
+  // UDP_GRO enabled, and dispatches each datagram.
+  bool ReadAndDispatchCoalescedPackets(int fd,
+                                       int port,
+                                       const QuicClock& clock,
+                                       ProcessPacketInterface* processor,
+                                       QuicPacketCount* packets_dropped);
+
   // Reads and dispatches a single packet using recvmsg.
   static bool ReadAndDispatchSinglePacket(int fd,
                                           int port,
@@ -87,6 +119,10 @@ class QuicPacketReader {
   mmsghdr mmsg_hdr_[kNumPacketsPerReadMmsgCall];
 #endif
 
+  // The buffer coalesced datagrams are read into.  Only allocated once GRO is
+  // enabled.
+  std::unique_ptr<char[]> gro_buffer_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicPacketReader);
 };
 
@@ -0,0 +1,80 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_packet_reader.h"
+
+#include <string>
+#include <vector>
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+class RecordingPacketProcessor : public ProcessPacketInterface {
+ public:
+  void ProcessPacket(const QuicSocketAddress& server_address,
+                     const QuicSocketAddress& client_address,
+                     const QuicReceivedPacket& packet) override {
+    packets_.push_back(std::string(packet.data(), packet.length()));
+    data_.push_back(packet.data());
+    EXPECT_EQ(packet.data(), packet.mutable_data());
+    EXPECT_EQ(17, packet.ttl());
+  }
+
+  const std::vector<std::string>& packets() const { return packets_; }
+  const std::vector<const char*>& data() const { return data_; }
+
+ private:
+  std::vector<std::string> packets_;
+  std::vector<const char*> data_;
+};
+
+class QuicPacketReaderTest : public QuicTest {
+ protected:
+  void Dispatch(std::string buffer, size_t segment_size) {
+    Dispatch(&buffer, segment_size);
+  }
+
+  void Dispatch(std::string* buffer, size_t segment_size) {
+    QuicPacketReader::DispatchCoalescedPackets(
+        &(*buffer)[0], buffer->length(), segment_size, QuicTime::Zero(),
+        /*ttl=*/17, /*has_ttl=*/true,
+        QuicSocketAddress(QuicIpAddress::Loopback4(), 443),
+        QuicSocketAddress(QuicIpAddress::Loopback4(), 1234), &processor_);
+  }
+
+  RecordingPacketProcessor processor_;
+};
+
+TEST_F(QuicPacketReaderTest, GroDisabledByDefault) {
+  QuicPacketReader reader;
+  EXPECT_FALSE(reader.gro_enabled());
+}
+
+TEST_F(QuicPacketReaderTest, SplitsEvenSegments) {
+  std::string buffer = "aaaabbbbcccc";
+  Dispatch(&buffer, 4);
+  EXPECT_EQ(std::vector<std::string>({"aaaa", "bbbb", "cccc"}),
+            processor_.packets());
+  // Packets reference the read buffer instead of copies of it.
+  ASSERT_EQ(3u, processor_.data().size());
+  EXPECT_EQ(buffer.data() + 4, processor_.data()[1]);
+}
+
+TEST_F(QuicPacketReaderTest, ShortLastSegment) {
+  Dispatch("aaaabbbbcc", 4);
+  EXPECT_EQ(std::vector<std::string>({"aaaa", "bbbb", "cc"}),
+            processor_.packets());
+}
+
+TEST_F(QuicPacketReaderTest, SingleDatagram) {
+  Dispatch("abc", 3);
+  EXPECT_EQ(std::vector<std::string>({"abc"}), processor_.packets());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
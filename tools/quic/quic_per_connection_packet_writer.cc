@@ -39,4 +39,20 @@ QuicByteCount QuicPerConnectionPacketWriter::GetMaxPacketSize(
   return shared_writer_->GetMaxPacketSize(peer_address);
 }
 
+bool QuicPerConnectionPacketWriter::IsBatchMode() const {
+  return shared_writer_->IsBatchMode();
+}
+
+WriteResult QuicPerConnectionPacketWriter::Flush() {
+  // The shared writer is flushed by the dispatcher once per event loop
+  // iteration, so that packets from many connections go out together.
+  return WriteResult(WRITE_STATUS_OK, 0);
+}
+
+char* QuicPerConnectionPacketWriter::GetNextWriteLocation(
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  return shared_writer_->GetNextWriteLocation(self_address, peer_address);
+}
+
 }  // namespace net
@@ -21,7 +21,8 @@ class QuicPerConnectionPacketWriter : public QuicPacketWriter {
   ~QuicPerConnectionPacketWriter() override;
 
   // Default implementation of the QuicPacketWriter interface: Passes everything
-  // to |shared_writer_|.
+  // to |shared_writer_|, except Flush, which is left to the dispatcher so that
+  // a batch mode shared writer can collect packets from many connections.
   WriteResult WritePacket(const char* buffer,
                           size_t buf_len,
                           const QuicIpAddress& self_address,
@@ -32,6 +33,10 @@ class QuicPerConnectionPacketWriter : public QuicPacketWriter {
   void SetWritable() override;
   QuicByteCount GetMaxPacketSize(
       const QuicSocketAddress& peer_address) const override;
+  bool IsBatchMode() const override;
+  WriteResult Flush() override;
+  char* GetNextWriteLocation(const QuicIpAddress& self_address,
+                             const QuicSocketAddress& peer_address) override;
 
  private:
   QuicPacketWriter* shared_writer_;  // Not owned.
@@ -0,0 +1,166 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_sendmmsg_batch_writer.h"
+
+#include <errno.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include "net/quic/core/quic_constants.h"
+#include "net/quic/platform/api/quic_logging.h"
+#include "net/tools/quic/platform/impl/quic_socket_utils.h"
+
+namespace net {
+
+namespace {
+
+const size_t kSpaceForIp = CMSG_SPACE(sizeof(in6_pktinfo));
+
+}  // namespace
+
+// static
+const size_t QuicSendmmsgBatchWriter::kMaxBatchPackets;
+
+QuicSendmmsgBatchWriter::QuicSendmmsgBatchWriter(int fd)
+    : QuicDefaultPacketWriter(fd),
+      buffer_pool_(new char[kMaxBatchPackets * kMaxPacketSize]),
+      num_packets_(0),
+      first_unsent_(0) {}
+
+QuicSendmmsgBatchWriter::~QuicSendmmsgBatchWriter() = default;
+
+WriteResult QuicSendmmsgBatchWriter::WritePacket(
+    const char* buffer,
+    size_t buf_len,
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address,
+    PerPacketOptions* options) {
+  DCHECK(!IsWriteBlocked());
+  DCHECK(nullptr == options)
+      << "QuicSendmmsgBatchWriter does not accept any options.";
+  DCHECK_LE(buf_len, kMaxPacketSize);
+
+  if (num_packets_ == kMaxBatchPackets) {
+    WriteResult result = Flush();
+    if (result.status != WRITE_STATUS_OK) {
+      // The packet was not accepted, so the caller must retry it.
+      return result;
+    }
+  }
+
+  char* slot = BufferAt(num_packets_);
+  if (buffer != slot) {
+    memcpy(slot, buffer, buf_len);
+  }
+  BufferedPacket& packet = packets_[num_packets_++];
+  packet.buffer = slot;
+  packet.length = buf_len;
+  packet.self_address = self_address;
+  packet.peer_address = peer_address;
+
+  if (num_packets_ == kMaxBatchPackets) {
+    WriteResult result = Flush();
+    if (result.status == WRITE_STATUS_ERROR) {
+      return result;
+    }
+  }
+  return WriteResult(WRITE_STATUS_OK, buf_len);
+}
+
+bool QuicSendmmsgBatchWriter::IsBatchMode() const {
+  return true;
+}
+
+WriteResult QuicSendmmsgBatchWriter::Flush() {
+  if (buffered_packets() == 0) {
+    return WriteResult(WRITE_STATUS_OK, 0);
+  }
+  if (IsWriteBlocked()) {
+    return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+  }
+
+  int bytes_written = 0;
+  while (first_unsent_ < num_packets_) {
+    int num_packets_sent = 0;
+    WriteResult result =
+        WriteBatch(packets_ + first_unsent_, num_packets_ - first_unsent_,
+                   &num_packets_sent);
+    if (result.status == WRITE_STATUS_BLOCKED) {
+      set_write_blocked(true);
+      return result;
+    }
+    if (result.status == WRITE_STATUS_ERROR) {
+      QUIC_DLOG(WARNING) << "Dropping " << buffered_packets()
+                         << " packets due to write error "
+                         << result.error_code;
+      num_packets_ = 0;
+      first_unsent_ = 0;
+      return result;
+    }
+    DCHECK_GT(num_packets_sent, 0);
+    first_unsent_ += num_packets_sent;
+    bytes_written += result.bytes_written;
+  }
+  num_packets_ = 0;
+  first_unsent_ = 0;
+  return WriteResult(WRITE_STATUS_OK, bytes_written);
+}
+
+char* QuicSendmmsgBatchWriter::GetNextWriteLocation(
+    const QuicIpAddress& self_address,
+    const QuicSocketAddress& peer_address) {
+  if (num_packets_ == kMaxBatchPackets) {
+    return nullptr;
+  }
+  return BufferAt(num_packets_);
+}
+
+WriteResult QuicSendmmsgBatchWriter::WriteBatch(const BufferedPacket* packets,
+                                                size_t count,
+                                                int* num_packets_sent) {
+  mmsghdr messages[kMaxBatchPackets];
+  iovec iovs[kMaxBatchPackets];
+  sockaddr_storage raw_addresses[kMaxBatchPackets];
+  char cbufs[kMaxBatchPackets][kSpaceForIp];
+  DCHECK_LE(count, kMaxBatchPackets);
+
+  for (size_t i = 0; i < count; ++i) {
+    raw_addresses[i] = packets[i].peer_address.generic_address();
+    iovs[i].iov_base = const_cast<char*>(packets[i].buffer);
+    iovs[i].iov_len = packets[i].length;
+
+    msghdr* hdr = &messages[i].msg_hdr;
+    hdr->msg_name = &raw_addresses[i];
+    hdr->msg_namelen = raw_addresses[i].ss_family == AF_INET
+                           ? sizeof(sockaddr_in)
+                           : sizeof(sockaddr_in6);
+    hdr->msg_iov = &iovs[i];
+    hdr->msg_iovlen = 1;
+    hdr->msg_flags = 0;
+    if (!packets[i].self_address.IsInitialized()) {
+      hdr->msg_control = nullptr;
+      hdr->msg_controllen = 0;
+    } else {
+      hdr->msg_control = cbufs[i];
+      hdr->msg_controllen = kSpaceForIp;
+      cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+      QuicSocketUtils::SetIpInfoInCmsg(packets[i].self_address, cmsg);
+      hdr->msg_controllen = cmsg->cmsg_len;
+    }
+    messages[i].msg_len = 0;
+  }
+
+  return QuicSocketUtils::WriteMultiplePackets(fd(), messages, count,
+                                               num_packets_sent);
+}
+
+char* QuicSendmmsgBatchWriter::BufferAt(size_t index) const {
+  DCHECK_LT(index, kMaxBatchPackets);
+  return buffer_pool_.get() + index * kMaxPacketSize;
+}
+
+}  // namespace net
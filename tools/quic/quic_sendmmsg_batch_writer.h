@@ -0,0 +1,83 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_SENDMMSG_BATCH_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_SENDMMSG_BATCH_WRITER_H_
+
+#include <stddef.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "net/quic/platform/api/quic_export.h"
+#include "net/quic/platform/api/quic_ip_address.h"
+#include "net/quic/platform/api/quic_socket_address.h"
+#include "net/tools/quic/quic_default_packet_writer.h"
+
+namespace net {
+
+// A batch mode packet writer which queues packets to any number of peers and
+// sends them with a single sendmmsg call.  It is meant to be shared by all the
+// connections of a QuicDispatcher, which flushes it once per event loop
+// iteration.
+//
+// Packets are held in a pool of kMaxPacketSize buffers allocated once per
+// writer.  GetNextWriteLocation hands out the next free buffer so that
+// connections serialize packets directly into the pool, in which case
+// WritePacket does not copy them.
+class QUIC_EXPORT_PRIVATE QuicSendmmsgBatchWriter
+    : public QuicDefaultPacketWriter {
+ public:
+  // The maximum number of packets held before the writer flushes itself.
+  static const size_t kMaxBatchPackets = 32;
+
+  explicit QuicSendmmsgBatchWriter(int fd);
+  ~QuicSendmmsgBatchWriter() override;
+
+  // QuicPacketWriter
+  WriteResult WritePacket(const char* buffer,
+                          size_t buf_len,
+                          const QuicIpAddress& self_address,
+                          const QuicSocketAddress& peer_address,
+                          PerPacketOptions* options) override;
+  bool IsBatchMode() const override;
+  WriteResult Flush() override;
+  char* GetNextWriteLocation(const QuicIpAddress& self_address,
+                             const QuicSocketAddress& peer_address) override;
+
+  // Returns the number of packets written but not yet sent.
+  size_t buffered_packets() const { return num_packets_ - first_unsent_; }
+
+ protected:
+  struct BufferedPacket {
+    const char* buffer;
+    size_t length;
+    QuicIpAddress self_address;
+    QuicSocketAddress peer_address;
+  };
+
+  // Sends up to |count| packets in one system call and sets
+  // |num_packets_sent| to the number actually sent.  Virtual for testing.
+  virtual WriteResult WriteBatch(const BufferedPacket* packets,
+                                 size_t count,
+                                 int* num_packets_sent);
+
+ private:
+  char* BufferAt(size_t index) const;
+
+  // Storage for kMaxBatchPackets packets.
+  std::unique_ptr<char[]> buffer_pool_;
+  BufferedPacket packets_[kMaxBatchPackets];
+  // The number of packets in |packets_|.
+  size_t num_packets_;
+  // The index of the first packet which has not been sent.  Only non-zero
+  // after a partial or blocked send.
+  size_t first_unsent_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicSendmmsgBatchWriter);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_SENDMMSG_BATCH_WRITER_H_
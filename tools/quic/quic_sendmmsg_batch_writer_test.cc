@@ -0,0 +1,149 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_sendmmsg_batch_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+// Records the packets of each batch instead of sending them.
+class TestSendmmsgBatchWriter : public QuicSendmmsgBatchWriter {
+ public:
+  TestSendmmsgBatchWriter()
+      : QuicSendmmsgBatchWriter(-1),
+        max_packets_per_call_(kMaxBatchPackets),
+        blocked_(false) {}
+
+  // The packets sent by each call to WriteBatch.
+  const std::vector<std::vector<std::string>>& batches() const {
+    return batches_;
+  }
+  void set_max_packets_per_call(size_t max) { max_packets_per_call_ = max; }
+  void set_blocked(bool blocked) { blocked_ = blocked; }
+
+ protected:
+  WriteResult WriteBatch(const BufferedPacket* packets,
+                         size_t count,
+                         int* num_packets_sent) override {
+    if (blocked_) {
+      *num_packets_sent = 0;
+      return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+    }
+    std::vector<std::string> batch;
+    int bytes_written = 0;
+    for (size_t i = 0; i < count && i < max_packets_per_call_; ++i) {
+      batch.push_back(std::string(packets[i].buffer, packets[i].length));
+      bytes_written += packets[i].length;
+    }
+    *num_packets_sent = batch.size();
+    batches_.push_back(batch);
+    return WriteResult(WRITE_STATUS_OK, bytes_written);
+  }
+
+ private:
+  size_t max_packets_per_call_;
+  bool blocked_;
+  std::vector<std::vector<std::string>> batches_;
+};
+
+class QuicSendmmsgBatchWriterTest : public QuicTest {
+ protected:
+  QuicSendmmsgBatchWriterTest()
+      : self_address_(QuicIpAddress::Loopback4()),
+        peer_address_(QuicIpAddress::Loopback4(), 443),
+        other_peer_address_(QuicIpAddress::Loopback4(), 444) {}
+
+  WriteResult Write(const std::string& packet,
+                    const QuicSocketAddress& peer_address) {
+    return writer_.WritePacket(packet.data(), packet.length(), self_address_,
+                               peer_address, nullptr);
+  }
+
+  TestSendmmsgBatchWriter writer_;
+  QuicIpAddress self_address_;
+  QuicSocketAddress peer_address_;
+  QuicSocketAddress other_peer_address_;
+};
+
+TEST_F(QuicSendmmsgBatchWriterTest, QueuesPacketsToManyPeers) {
+  EXPECT_TRUE(writer_.IsBatchMode());
+  EXPECT_EQ(WRITE_STATUS_OK, Write("a", peer_address_).status);
+  EXPECT_EQ(WRITE_STATUS_OK, Write("bb", other_peer_address_).status);
+  EXPECT_EQ(WRITE_STATUS_OK, Write("ccc", peer_address_).status);
+  EXPECT_TRUE(writer_.batches().empty());
+  EXPECT_EQ(3u, writer_.buffered_packets());
+
+  WriteResult result = writer_.Flush();
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(6, result.bytes_written);
+  ASSERT_EQ(1u, writer_.batches().size());
+  EXPECT_EQ(std::vector<std::string>({"a", "bb", "ccc"}),
+            writer_.batches()[0]);
+  EXPECT_EQ(0u, writer_.buffered_packets());
+}
+
+TEST_F(QuicSendmmsgBatchWriterTest, FlushesWhenFull) {
+  for (size_t i = 0; i < QuicSendmmsgBatchWriter::kMaxBatchPackets; ++i) {
+    Write("x", peer_address_);
+  }
+  ASSERT_EQ(1u, writer_.batches().size());
+  EXPECT_EQ(QuicSendmmsgBatchWriter::kMaxBatchPackets,
+            writer_.batches()[0].size());
+  EXPECT_EQ(0u, writer_.buffered_packets());
+}
+
+TEST_F(QuicSendmmsgBatchWriterTest, PartialSendIsRetried) {
+  writer_.set_max_packets_per_call(2);
+  Write("a", peer_address_);
+  Write("b", peer_address_);
+  Write("c", peer_address_);
+  EXPECT_EQ(WRITE_STATUS_OK, writer_.Flush().status);
+  ASSERT_EQ(2u, writer_.batches().size());
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), writer_.batches()[0]);
+  EXPECT_EQ(std::vector<std::string>({"c"}), writer_.batches()[1]);
+}
+
+TEST_F(QuicSendmmsgBatchWriterTest, BlockedFlushKeepsPackets) {
+  Write("a", peer_address_);
+  writer_.set_blocked(true);
+  EXPECT_EQ(WRITE_STATUS_BLOCKED, writer_.Flush().status);
+  EXPECT_TRUE(writer_.IsWriteBlocked());
+  EXPECT_EQ(1u, writer_.buffered_packets());
+
+  writer_.set_blocked(false);
+  writer_.SetWritable();
+  Write("b", peer_address_);
+  EXPECT_EQ(WRITE_STATUS_OK, writer_.Flush().status);
+  ASSERT_EQ(1u, writer_.batches().size());
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), writer_.batches()[0]);
+}
+
+TEST_F(QuicSendmmsgBatchWriterTest, WriteLocationAvoidsCopy) {
+  char* location = writer_.GetNextWriteLocation(self_address_, peer_address_);
+  ASSERT_NE(nullptr, location);
+  memcpy(location, "hello", 5);
+  EXPECT_EQ(WRITE_STATUS_OK,
+            writer_
+                .WritePacket(location, 5, self_address_, peer_address_, nullptr)
+                .status);
+  // The next location is a different buffer.
+  EXPECT_NE(location,
+            writer_.GetNextWriteLocation(self_address_, peer_address_));
+  writer_.Flush();
+  ASSERT_EQ(1u, writer_.batches().size());
+  EXPECT_EQ(std::vector<std::string>({"hello"}), writer_.batches()[0]);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
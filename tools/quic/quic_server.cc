@@ -21,13 +21,16 @@
 #include "net/quic/platform/api/quic_clock.h"
 #include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/tools/quic/platform/impl/quic_epoll_clock.h"
 #include "net/tools/quic/platform/impl/quic_socket_utils.h"
 #include "net/tools/quic/quic_dispatcher.h"
 #include "net/tools/quic/quic_epoll_alarm_factory.h"
 #include "net/tools/quic/quic_epoll_connection_helper.h"
+#include "net/tools/quic/quic_gso_batch_writer.h"
 #include "net/tools/quic/quic_http_response_cache.h"
 #include "net/tools/quic/quic_packet_reader.h"
+#include "net/tools/quic/quic_sendmmsg_batch_writer.h"
 #include "net/tools/quic/quic_simple_crypto_server_stream_helper.h"
 #include "net/tools/quic/quic_simple_dispatcher.h"
 
@@ -69,6 +72,7 @@ QuicServer::QuicServer(
       fd_(-1),
       packets_dropped_(0),
       overflow_supported_(false),
+      reuse_port_(false),
       silent_close_(false),
       config_(config),
       crypto_config_(kSourceAddressTokenSecret,
@@ -107,9 +111,19 @@ void QuicServer::Initialize() {
 
   std::unique_ptr<CryptoHandshakeMessage> scfg(crypto_config_.AddDefaultConfig(
       QuicRandom::GetInstance(), &clock, crypto_config_options_));
+  crypto_config_.set_proof_batch_size(FLAGS_quic_server_proof_batch_size);
+  if (FLAGS_quic_server_crypto_worker_threads > 0) {
+    crypto_worker_pool_ = QuicMakeUnique<QuicEpollCryptoWorkerPool>(
+        FLAGS_quic_server_crypto_worker_threads, &epoll_server_);
+    crypto_config_.set_crypto_worker_pool(crypto_worker_pool_.get());
+  }
 }
 
-QuicServer::~QuicServer() = default;
+QuicServer::~QuicServer() {
+  if (crypto_worker_pool_ != nullptr) {
+    crypto_worker_pool_->Stop();
+  }
+}
 
 bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
   fd_ = QuicSocketUtils::CreateUDPSocket(address, &overflow_supported_);
@@ -118,6 +132,11 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
     return false;
   }
 
+  if (reuse_port_ && !QuicSocketUtils::SetReusePort(fd_)) {
+    QUIC_LOG(ERROR) << "Failed to set SO_REUSEPORT: " << strerror(errno);
+    return false;
+  }
+
   sockaddr_storage addr = address.generic_address();
   int rc = bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
   if (rc < 0) {
@@ -135,6 +154,10 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
     port_ = address.port();
   }
 
+  if (FLAGS_quic_server_enable_udp_gro) {
+    packet_reader_->EnableGro(fd_);
+  }
+
   epoll_server_.RegisterFD(fd_, this, kEpollFlags);
   dispatcher_.reset(CreateQuicDispatcher());
   dispatcher_->InitializeWithWriter(CreateWriter(fd_));
@@ -142,7 +165,32 @@ bool QuicServer::CreateUDPSocketAndListen(const QuicSocketAddress& address) {
   return true;
 }
 
+bool QuicServer::AttachConnectionIdSteering(size_t num_sockets) {
+  DCHECK(reuse_port_);
+  DCHECK_GE(fd_, 0);
+  return QuicSocketUtils::AttachConnectionIdSteeringProgram(fd_, num_sockets);
+}
+
+std::unique_ptr<QuicServerConfigProtobuf> QuicServer::GenerateServerConfig() {
+  QuicEpollClock clock(&epoll_server_);
+  return QuicCryptoServerConfig::GenerateConfig(
+      QuicRandom::GetInstance(), &clock, crypto_config_options_);
+}
+
+bool QuicServer::SetServerConfigs(
+    const std::vector<std::unique_ptr<QuicServerConfigProtobuf>>& protobufs) {
+  QuicEpollClock clock(&epoll_server_);
+  return crypto_config_.SetConfigs(protobufs, clock.WallNow());
+}
+
 QuicDefaultPacketWriter* QuicServer::CreateWriter(int fd) {
+  if (FLAGS_quic_server_use_gso_batch_writer &&
+      QuicSocketUtils::IsUdpGsoSupported(fd)) {
+    return new QuicGsoBatchWriter(fd);
+  }
+  if (FLAGS_quic_server_use_sendmmsg_batch_writer) {
+    return new QuicSendmmsgBatchWriter(fd);
+  }
   return new QuicDefaultPacketWriter(fd);
 }
 
@@ -161,6 +209,14 @@ QuicDispatcher* QuicServer::CreateQuicDispatcher() {
 
 void QuicServer::WaitForEvents() {
   epoll_server_.WaitForEventsAndExecuteCallbacks();
+  // The epoll server records the time when epoll_wait returns, so this is how
+  // long the iteration spent on events and alarms before polling again.
+  dispatcher_->overload_controller()->OnEventLoopIteration(
+      QuicTime::Delta::FromMicroseconds(epoll_server_.NowInUsec() -
+                                        epoll_server_.ApproximateNowInUsec()));
+  // Send everything the connections wrote during this iteration, including
+  // packets written from alarms.
+  dispatcher_->FlushWriter();
 }
 
 void QuicServer::Shutdown() {
@@ -189,6 +245,8 @@ void QuicServer::OnEvent(int fd, EpollEvent* event) {
           fd_, port_, QuicEpollClock(&epoll_server_), dispatcher_.get(),
           overflow_supported_ ? &packets_dropped_ : nullptr);
     }
+    // Don't leave the handshakes of this read waiting for a full batch.
+    crypto_config_.FlushPendingProofs();
 
     if (dispatcher_->HasChlosBuffered()) {
       // Register EPOLLIN event to consume buffered CHLO(s).
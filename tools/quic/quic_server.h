@@ -12,9 +12,11 @@
 #define NET_TOOLS_QUIC_QUIC_SERVER_H_
 
 #include <memory>
+#include <vector>
 
 #include "base/macros.h"
 #include "net/quic/chromium/quic_chromium_connection_helper.h"
+#include "net/quic/core/crypto/crypto_server_config_protobuf.h"
 #include "net/quic/core/crypto/quic_crypto_server_config.h"
 #include "net/quic/core/quic_config.h"
 #include "net/quic/core/quic_framer.h"
@@ -22,6 +24,7 @@
 #include "net/quic/platform/api/quic_socket_address.h"
 #include "net/tools/epoll_server/epoll_server.h"
 #include "net/tools/quic/quic_default_packet_writer.h"
+#include "net/tools/quic/quic_epoll_crypto_worker_pool.h"
 #include "net/tools/quic/quic_http_response_cache.h"
 
 namespace net {
@@ -72,6 +75,27 @@ class QuicServer : public EpollCallbackInterface {
 
   int port() { return port_; }
 
+  // If true, SO_REUSEPORT is set on the socket before it is bound, so that
+  // several servers can listen on the same address.  Must be called before
+  // CreateUDPSocketAndListen.
+  void set_reuse_port(bool reuse_port) { reuse_port_ = reuse_port; }
+
+  // Attaches a program to the SO_REUSEPORT group of the listening socket
+  // which sends each packet to socket number (connection ID % |num_sockets|)
+  // in the order the sockets were bound, so that all packets of a connection
+  // reach the same server even if the client migrates.  Returns false if the
+  // kernel rejects the program.
+  bool AttachConnectionIdSteering(size_t num_sockets);
+
+  // Generates a server config suitable for SetServerConfigs using this
+  // server's crypto config options.
+  std::unique_ptr<QuicServerConfigProtobuf> GenerateServerConfig();
+
+  // Replaces the server configs of this server, so that servers sharing a
+  // port can accept each other's source address tokens and 0-RTT handshakes.
+  bool SetServerConfigs(
+      const std::vector<std::unique_ptr<QuicServerConfigProtobuf>>& protobufs);
+
  protected:
   virtual QuicDefaultPacketWriter* CreateWriter(int fd);
 
@@ -95,6 +119,9 @@ class QuicServer : public EpollCallbackInterface {
   // Initialize the internal state of the server.
   void Initialize();
 
+  // Runs handshake crypto off the event loop, if not null.  Declared before
+  // |dispatcher_| so that the tasks outlive the sessions waiting for them.
+  std::unique_ptr<QuicEpollCryptoWorkerPool> crypto_worker_pool_;
   // Accepts data from the framer and demuxes clients to sessions.
   std::unique_ptr<QuicDispatcher> dispatcher_;
   // Frames incoming packets and hands them to the dispatcher.
@@ -115,6 +142,9 @@ class QuicServer : public EpollCallbackInterface {
   // because the socket would otherwise overflow.
   bool overflow_supported_;
 
+  // If true, set SO_REUSEPORT on the listening socket.
+  bool reuse_port_;
+
   // If true, do not call Shutdown on the dispatcher.  Connections will close
   // without sending a final connection close.
   bool silent_close_;
@@ -16,13 +16,23 @@
 #include "base/task_scheduler/task_scheduler.h"
 #include "net/quic/chromium/crypto/proof_source_chromium.h"
 #include "net/quic/core/quic_packets.h"
+#include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_socket_address.h"
+#include "net/quic/platform/api/quic_ptr_util.h"
 #include "net/tools/quic/quic_http_response_cache.h"
+#include "net/tools/quic/quic_multi_worker_server.h"
 #include "net/tools/quic/quic_server.h"
 
 // The port the quic server will listen on.
 int32_t FLAGS_port = 6121;
 
+// The number of server threads sharing the port.
+int32_t FLAGS_num_workers = 1;
+
+// How long each server thread polls for packets before it blocks, in
+// microseconds.
+int32_t FLAGS_busy_poll_us = 0;
+
 std::unique_ptr<net::ProofSource> CreateProofSource(
     const base::FilePath& cert_path,
     const base::FilePath& key_path) {
@@ -53,16 +63,29 @@ int main(int argc, char* argv[]) {
         "--port=<port>               specify the port to listen on\n"
         "--quic_response_cache_dir  directory containing response data\n"
         "                            to load\n"
+        "--map_response_cache        map the response data instead of\n"
+        "                            reading it, and send it without copying\n"
         "--certificate_file=<file>   path to the certificate chain\n"
-        "--key_file=<file>           path to the pkcs8 private key\n";
+        "--key_file=<file>           path to the pkcs8 private key\n"
+        "--num_workers=<n>           run n server threads on the port, with\n"
+        "                            packets steered by connection ID\n"
+        "--busy_poll_us=<us>         poll for packets for up to us\n"
+        "                            microseconds before blocking, trading\n"
+        "                            CPU time for lower latency\n";
     std::cout << help_str;
     exit(0);
   }
 
   net::QuicHttpResponseCache response_cache;
   if (line->HasSwitch("quic_response_cache_dir")) {
-    response_cache.InitializeFromDirectory(
-        line->GetSwitchValueASCII("quic_response_cache_dir"));
+    if (line->HasSwitch("map_response_cache")) {
+      response_cache.MapFromDirectory(
+          line->GetSwitchValueASCII("quic_response_cache_dir"));
+      FLAGS_quic_reloadable_flag_quic_send_pre_encoded_responses = true;
+    } else {
+      response_cache.InitializeFromDirectory(
+          line->GetSwitchValueASCII("quic_response_cache_dir"));
+    }
   }
 
   if (line->HasSwitch("port")) {
@@ -72,6 +95,24 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  if (line->HasSwitch("num_workers")) {
+    if (!base::StringToInt(line->GetSwitchValueASCII("num_workers"),
+                           &FLAGS_num_workers) ||
+        FLAGS_num_workers < 1) {
+      LOG(ERROR) << "--num_workers must be a positive integer\n";
+      return 1;
+    }
+  }
+
+  if (line->HasSwitch("busy_poll_us")) {
+    if (!base::StringToInt(line->GetSwitchValueASCII("busy_poll_us"),
+                           &FLAGS_busy_poll_us) ||
+        FLAGS_busy_poll_us < 0) {
+      LOG(ERROR) << "--busy_poll_us must be a non-negative integer\n";
+      return 1;
+    }
+  }
+
   if (!line->HasSwitch("certificate_file")) {
     LOG(ERROR) << "missing --certificate_file";
     return 1;
@@ -83,11 +124,31 @@ int main(int argc, char* argv[]) {
   }
 
   net::QuicConfig config;
+  if (FLAGS_num_workers > 1) {
+    net::QuicMultiWorkerServer server(FLAGS_num_workers, [&]() {
+      auto worker = net::QuicMakeUnique<net::QuicServer>(
+          CreateProofSource(line->GetSwitchValuePath("certificate_file"),
+                            line->GetSwitchValuePath("key_file")),
+          config, net::QuicCryptoServerConfig::ConfigOptions(),
+          net::AllSupportedTransportVersions(), &response_cache);
+      worker->epoll_server()->set_busy_poll_period_us(FLAGS_busy_poll_us);
+      return worker;
+    });
+    server.set_steer_by_connection_id(true);
+    if (!server.Start(
+            net::QuicSocketAddress(net::QuicIpAddress::Any6(), FLAGS_port))) {
+      return 1;
+    }
+    base::RunLoop().Run();
+    return 0;
+  }
+
   net::QuicServer server(
       CreateProofSource(line->GetSwitchValuePath("certificate_file"),
                         line->GetSwitchValuePath("key_file")),
       config, net::QuicCryptoServerConfig::ConfigOptions(),
       net::AllSupportedTransportVersions(), &response_cache);
+  server.epoll_server()->set_busy_poll_period_us(FLAGS_busy_poll_us);
 
   int rc = server.CreateUDPSocketAndListen(
       net::QuicSocketAddress(net::QuicIpAddress::Any6(), FLAGS_port));
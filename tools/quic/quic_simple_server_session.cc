@@ -4,7 +4,9 @@
 
 #include "net/tools/quic/quic_simple_server_session.h"
 
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "net/quic/core/proto/cached_network_parameters.pb.h"
 #include "net/quic/core/quic_connection.h"
@@ -75,14 +77,30 @@ void QuicSimpleServerSession::PromisePushResources(
     return;
   }
 
-  for (QuicHttpResponseCache::ServerPushInfo resource : resources) {
+  // Promised streams are opened in stream id order, so promising in priority
+  // order decides which resources get the open stream slots first. The sort is
+  // stable to keep the configured order among resources of equal priority.
+  std::vector<const QuicHttpResponseCache::ServerPushInfo*> ordered_resources;
+  ordered_resources.reserve(resources.size());
+  for (const QuicHttpResponseCache::ServerPushInfo& resource : resources) {
+    ordered_resources.push_back(&resource);
+  }
+  std::stable_sort(ordered_resources.begin(), ordered_resources.end(),
+                   [](const QuicHttpResponseCache::ServerPushInfo* a,
+                      const QuicHttpResponseCache::ServerPushInfo* b) {
+                     // Lower SpdyPriority values are more important.
+                     return a->priority < b->priority;
+                   });
+
+  for (const QuicHttpResponseCache::ServerPushInfo* resource :
+       ordered_resources) {
     SpdyHeaderBlock headers = SynthesizePushRequestHeaders(
-        request_url, resource, original_request_headers);
+        request_url, *resource, original_request_headers);
     highest_promised_stream_id_ += 2;
     SendPushPromise(original_stream_id, highest_promised_stream_id_,
                     headers.Clone());
     promised_streams_.push_back(PromisedStreamInfo(
-        std::move(headers), highest_promised_stream_id_, resource.priority));
+        std::move(headers), highest_promised_stream_id_, resource->priority));
   }
 
   // Procese promised push request as many as possible.
@@ -73,7 +73,9 @@ class QuicSimpleServerSession : public QuicServerSessionBase {
   // Send out PUSH_PROMISE for all |resources| promised stream id in each frame
   // will increase by 2 for each item in |resources|.
   // And enqueue HEADERS block in those PUSH_PROMISED for sending push response
-  // later.
+  // later. |resources| are promised in priority order, highest first, so that
+  // the most important ones are sent first when the number of open streams is
+  // limited.
   virtual void PromisePushResources(
       const std::string& request_url,
       const std::list<QuicHttpResponseCache::ServerPushInfo>& resources,
@@ -186,7 +186,7 @@ class QuicSimpleServerSessionTest
                        QuicRandom::GetInstance(),
                        crypto_test_utils::ProofSourceForTesting()),
         compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize) {
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes) {
     config_.SetMaxStreamsPerConnection(kMaxStreamsForTest, kMaxStreamsForTest);
     config_.SetMaxIncomingDynamicStreamsToSend(kMaxStreamsForTest);
     QuicConfigPeer::SetReceivedMaxIncomingDynamicStreams(&config_,
@@ -533,6 +533,43 @@ TEST_P(QuicSimpleServerSessionServerPushTest, TestPromisePushResources) {
   EXPECT_EQ(kMaxStreamsForTest, session_->GetNumOpenOutgoingStreams());
 }
 
+TEST_P(QuicSimpleServerSessionServerPushTest,
+       PromisePushResourcesInPriorityOrder) {
+  // Tests that resources are promised, and so pushed, highest priority first
+  // rather than in the order they are listed.
+  config_.SetMaxStreamsPerConnection(kMaxStreamsForTest, kMaxStreamsForTest);
+
+  string request_url = "mail.google.com/";
+  SpdyHeaderBlock request_headers;
+  string resource_host = "www.google.com";
+  string body(2 * kStreamFlowControlWindowSize, 'a');
+  const SpdyPriority priorities[] = {kV3LowestPriority, kV3HighestPriority};
+  std::list<QuicHttpResponseCache::ServerPushInfo> push_resources;
+  for (size_t i = 0; i < arraysize(priorities); ++i) {
+    string path = "/server_push_src" + QuicTextUtils::Uint64ToString(i);
+    response_cache_.AddSimpleResponse(resource_host, path, 200, body);
+    push_resources.push_back(QuicHttpResponseCache::ServerPushInfo(
+        QuicUrl("http://" + resource_host + path), SpdyHeaderBlock(),
+        priorities[i], body));
+  }
+
+  // The highest priority resource, listed last, gets the first stream.
+  for (size_t i = 0; i < arraysize(priorities); ++i) {
+    QuicStreamId stream_id = GetNthServerInitiatedId(i);
+    EXPECT_CALL(*session_, WritePushPromiseMock(GetNthClientInitiatedId(0),
+                                                stream_id, _));
+    EXPECT_CALL(*session_,
+                WriteHeadersMock(stream_id, _, false,
+                                 priorities[arraysize(priorities) - 1 - i], _));
+    EXPECT_CALL(*connection_, SendStreamData(stream_id, _, 0, NO_FIN))
+        .WillOnce(
+            Return(QuicConsumedData(kStreamFlowControlWindowSize, false)));
+    EXPECT_CALL(*connection_, SendBlocked(stream_id));
+  }
+  session_->PromisePushResources(request_url, push_resources,
+                                 GetNthClientInitiatedId(0), request_headers);
+}
+
 TEST_P(QuicSimpleServerSessionServerPushTest,
        HandlePromisedPushRequestsAfterStreamDraining) {
   // Tests that after promised stream queued up, when an opened stream is marked
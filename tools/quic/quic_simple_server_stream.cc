@@ -13,6 +13,7 @@
 #include "net/quic/platform/api/quic_flags.h"
 #include "net/quic/platform/api/quic_logging.h"
 #include "net/quic/platform/api/quic_map_util.h"
+#include "net/quic/platform/api/quic_mem_slice_span.h"
 #include "net/quic/platform/api/quic_text_utils.h"
 #include "net/spdy/core/spdy_protocol.h"
 #include "net/tools/quic/quic_http_response_cache.h"
@@ -198,6 +199,11 @@ void QuicSimpleServerStream::SendResponse() {
   }
 
   QUIC_DVLOG(1) << "Stream " << id() << " sending response.";
+  if (FLAGS_quic_reloadable_flag_quic_send_pre_encoded_responses &&
+      !response->encoded_headers().empty()) {
+    SendCachedResponse(*response);
+    return;
+  }
   SendHeadersAndBodyAndTrailers(response->headers().Clone(), response->body(),
                                 response->trailers().Clone());
 }
@@ -259,6 +265,41 @@ void QuicSimpleServerStream::SendHeadersAndBodyAndTrailers(
   WriteTrailers(std::move(response_trailers), nullptr);
 }
 
+void QuicSimpleServerStream::SendCachedResponse(
+    const QuicHttpResponseCache::Response& response) {
+  QuicStringPiece body = response.body();
+  bool send_fin = (body.empty() && response.trailers().empty());
+  QUIC_DLOG(INFO) << "Stream " << id()
+                  << " writing pre-encoded headers (fin = " << send_fin
+                  << ") : " << response.headers().DebugString();
+  WriteEncodedHeaders(response.encoded_headers(), send_fin, nullptr);
+  if (send_fin) {
+    return;
+  }
+
+  send_fin = response.trailers().empty();
+  QUIC_DLOG(INFO) << "Stream " << id() << " writing body (fin = " << send_fin
+                  << ") with size: " << body.size();
+  if (response.body_buffer() != nullptr && !body.empty() &&
+      session()->can_use_slices()) {
+    // The send buffer takes a reference to the mapping rather than a copy.
+    scoped_refptr<IOBuffer> buffer = response.body_buffer();
+    int length = body.size();
+    QuicConsumedData consumed = WriteMemSlices(
+        QuicMemSliceSpan(QuicMemSliceSpanImpl(&buffer, &length, 1)), send_fin);
+    DCHECK_EQ(body.size(), consumed.bytes_consumed);
+  } else if (!body.empty() || send_fin) {
+    WriteOrBufferData(body, send_fin, nullptr);
+  }
+  if (send_fin) {
+    return;
+  }
+
+  QUIC_DLOG(INFO) << "Stream " << id() << " writing trailers (fin = true): "
+                  << response.trailers().DebugString();
+  WriteTrailers(response.trailers().Clone(), nullptr);
+}
+
 const char* const QuicSimpleServerStream::kErrorResponseBody = "bad";
 const char* const QuicSimpleServerStream::kNotFoundResponseBody =
     "file not found";
@@ -69,6 +69,9 @@ class QuicSimpleServerStream : public QuicSpdyServerStreamBase {
   void SendHeadersAndBodyAndTrailers(SpdyHeaderBlock response_headers,
                                      QuicStringPiece body,
                                      SpdyHeaderBlock response_trailers);
+  // Sends |response| with its pre-encoded headers and, if it is mapped, its
+  // body without copying it.
+  void SendCachedResponse(const QuicHttpResponseCache::Response& response);
 
   SpdyHeaderBlock* request_headers() { return &request_headers_; }
 
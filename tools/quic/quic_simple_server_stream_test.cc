@@ -135,6 +135,14 @@ class MockQuicSimpleServerSession : public QuicSimpleServerSession {
              SpdyPriority priority,
              const QuicReferenceCountedPointer<QuicAckListenerInterface>&
                  ack_listener));
+  MOCK_METHOD5(
+      WriteEncodedHeaders,
+      size_t(QuicStreamId id,
+             const string& encoded_headers,
+             bool fin,
+             SpdyPriority priority,
+             QuicReferenceCountedPointer<QuicAckListenerInterface>
+                 ack_listener));
   MOCK_METHOD3(SendRstStream,
                void(QuicStreamId stream_id,
                     QuicRstStreamErrorCode error,
@@ -178,7 +186,7 @@ class QuicSimpleServerStreamTest
             QuicRandom::GetInstance(),
             crypto_test_utils::ProofSourceForTesting())),
         compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
         session_(connection_,
                  &session_owner_,
                  &session_helper_,
@@ -412,6 +420,37 @@ TEST_P(QuicSimpleServerStreamTest, SendResponseWithValidHeaders) {
   EXPECT_TRUE(stream_->write_side_closed());
 }
 
+TEST_P(QuicSimpleServerStreamTest, SendResponseWithEncodedHeaders) {
+  FLAGS_quic_reloadable_flag_quic_send_pre_encoded_responses = true;
+  SpdyHeaderBlock* request_headers = stream_->mutable_headers();
+  (*request_headers)[":path"] = "/bar";
+  (*request_headers)[":authority"] = "www.google.com";
+  (*request_headers)[":version"] = "HTTP/1.1";
+  (*request_headers)[":method"] = "GET";
+
+  response_headers_[":version"] = "HTTP/1.1";
+  response_headers_[":status"] = "200";
+  response_headers_["content-length"] = "5";
+  string body = "Yummm";
+  response_cache_.AddResponse("www.google.com", "/bar",
+                              std::move(response_headers_), body);
+  const QuicHttpResponseCache::Response* response =
+      response_cache_.GetResponse("www.google.com", "/bar");
+  stream_->set_fin_received(true);
+
+  InSequence s;
+  EXPECT_CALL(session_, WriteEncodedHeaders(stream_->id(),
+                                            response->encoded_headers(), false,
+                                            _, _));
+  EXPECT_CALL(session_, WritevData(_, _, _, _, _))
+      .Times(1)
+      .WillOnce(Return(QuicConsumedData(body.length(), true)));
+
+  QuicSimpleServerStreamPeer::SendResponse(stream_);
+  EXPECT_FALSE(QuicStreamPeer::read_side_closed(stream_));
+  EXPECT_TRUE(stream_->write_side_closed());
+}
+
 TEST_P(QuicSimpleServerStreamTest, SendReponseWithPushResources) {
   // Tests that if a reponse has push resources to be send, SendResponse() will
   // call PromisePushResources() to handle these resources.
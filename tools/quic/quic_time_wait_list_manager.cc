@@ -6,7 +6,9 @@
 
 #include <errno.h>
 
+#include <algorithm>
 #include <memory>
+#include <string>
 
 #include "base/macros.h"
 #include "net/quic/core/crypto/crypto_protocol.h"
@@ -44,40 +46,27 @@ class ConnectionIdCleanUpAlarm : public QuicAlarm::Delegate {
   DISALLOW_COPY_AND_ASSIGN(ConnectionIdCleanUpAlarm);
 };
 
-// This class stores pending public reset packets to be sent to clients.
-// server_address - server address on which a packet what was received for
-//                  a connection_id in time wait state.
-// client_address - address of the client that sent that packet. Needed to send
-//                  the public reset packet back to the client.
-// packet - the pending public reset packet that is to be sent to the client.
-//          created instance takes the ownership of this packet.
-class QuicTimeWaitListManager::QueuedPacket {
- public:
-  QueuedPacket(const QuicSocketAddress& server_address,
-               const QuicSocketAddress& client_address,
-               std::unique_ptr<QuicEncryptedPacket> packet)
-      : server_address_(server_address),
-        client_address_(client_address),
-        packet_(std::move(packet)) {}
+namespace {
 
-  const QuicSocketAddress& server_address() const { return server_address_; }
-  const QuicSocketAddress& client_address() const { return client_address_; }
-  QuicEncryptedPacket* packet() { return packet_.get(); }
+// Max number of packets queued while the writer is blocked.  Packets beyond
+// it are dropped, as they would be by a full socket buffer.
+const size_t kMaxPendingPackets = 1000;
 
- private:
-  const QuicSocketAddress server_address_;
-  const QuicSocketAddress client_address_;
-  std::unique_ptr<QuicEncryptedPacket> packet_;
+// Parameters of the token buckets limiting the responses sent to a client IP.
+const double kResponseBurstPerClientIp = 32;
+const double kResponsesPerSecondPerClientIp = 16;
+// Max number of client IPs whose token buckets are kept.
+const int64_t kMaxTrackedClientIps = 4096;
 
-  DISALLOW_COPY_AND_ASSIGN(QueuedPacket);
-};
+}  // namespace
 
 QuicTimeWaitListManager::QuicTimeWaitListManager(
     QuicPacketWriter* writer,
     Visitor* visitor,
     QuicConnectionHelperInterface* helper,
     QuicAlarmFactory* alarm_factory)
-    : time_wait_period_(
+    : response_token_buckets_(kMaxTrackedClientIps),
+      time_wait_period_(
           QuicTime::Delta::FromSeconds(FLAGS_quic_time_wait_list_seconds)),
       connection_id_clean_up_alarm_(
           alarm_factory->CreateAlarm(new ConnectionIdCleanUpAlarm(this))),
@@ -89,6 +78,7 @@ QuicTimeWaitListManager::QuicTimeWaitListManager(
 
 QuicTimeWaitListManager::~QuicTimeWaitListManager() {
   connection_id_clean_up_alarm_->Cancel();
+  response_token_buckets_.Clear();
 }
 
 void QuicTimeWaitListManager::AddConnectionIdToTimeWait(
@@ -136,8 +126,9 @@ QuicTransportVersion QuicTimeWaitListManager::GetQuicVersionFromConnectionId(
 
 void QuicTimeWaitListManager::OnBlockedWriterCanWrite() {
   while (!pending_packets_queue_.empty()) {
-    QueuedPacket* queued_packet = pending_packets_queue_.front().get();
-    if (!WriteToWire(queued_packet)) {
+    const QueuedPacket& queued_packet = pending_packets_queue_.front();
+    if (!WriteToWire(queued_packet.server_address, queued_packet.client_address,
+                     *queued_packet.packet)) {
       return;
     }
     pending_packets_queue_.pop_front();
@@ -162,6 +153,14 @@ void QuicTimeWaitListManager::ProcessPacket(
     return;
   }
 
+  if (FLAGS_quic_reloadable_flag_quic_rate_limit_time_wait_responses &&
+      !TakeResponseToken(client_address.host())) {
+    QUIC_DVLOG(1) << "Not responding to " << client_address.ToString()
+                  << " for connection " << connection_id
+                  << ", which was sent too many responses.";
+    return;
+  }
+
   if (!connection_data->termination_packets.empty()) {
     if (connection_data->connection_rejected_statelessly) {
       QUIC_DVLOG(3)
@@ -169,8 +168,7 @@ void QuicTimeWaitListManager::ProcessPacket(
           << "for connection " << connection_id;
     }
     for (const auto& packet : connection_data->termination_packets) {
-      SendOrQueuePacket(QuicMakeUnique<QueuedPacket>(
-          server_address, client_address, packet->Clone()));
+      SendOrQueuePacket(server_address, client_address, *packet);
     }
     return;
   }
@@ -183,10 +181,9 @@ void QuicTimeWaitListManager::SendVersionNegotiationPacket(
     const QuicTransportVersionVector& supported_versions,
     const QuicSocketAddress& server_address,
     const QuicSocketAddress& client_address) {
-  SendOrQueuePacket(
-      QuicMakeUnique<QueuedPacket>(server_address, client_address,
-                                   QuicFramer::BuildVersionNegotiationPacket(
-                                       connection_id, supported_versions)));
+  SendOrQueuePacket(server_address, client_address,
+                    *QuicFramer::BuildVersionNegotiationPacket(
+                        connection_id, supported_versions));
 }
 
 // Returns true if the number of packets received for this connection_id is a
@@ -205,9 +202,47 @@ void QuicTimeWaitListManager::SendPublicReset(
   // TODO(satyamshekhar): generate a valid nonce for this connection_id.
   packet.nonce_proof = 1010101;
   packet.client_address = client_address;
-  // Takes ownership of the packet.
-  SendOrQueuePacket(QuicMakeUnique<QueuedPacket>(server_address, client_address,
-                                                 BuildPublicReset(packet)));
+
+  ConnectionIdMap::iterator it = connection_id_map_.find(connection_id);
+  if (it == connection_id_map_.end()) {
+    SendOrQueuePacket(server_address, client_address,
+                      *BuildPublicReset(packet));
+    return;
+  }
+
+  // The reset is built once per connection and client address, and sent again
+  // as is.
+  ConnectionIdData* connection_data = &it->second;
+  if (connection_data->public_reset == nullptr ||
+      !(connection_data->public_reset_client_address == client_address)) {
+    connection_data->public_reset = BuildPublicReset(packet);
+    connection_data->public_reset_client_address = client_address;
+  }
+  SendOrQueuePacket(server_address, client_address,
+                    *connection_data->public_reset);
+}
+
+bool QuicTimeWaitListManager::TakeResponseToken(
+    const QuicIpAddress& client_ip) {
+  const QuicTime now = clock_->ApproximateNow();
+  const std::string key = client_ip.ToPackedString();
+  ResponseTokenBucket* bucket = response_token_buckets_.Lookup(key);
+  if (bucket == nullptr) {
+    response_token_buckets_.Insert(
+        key, QuicMakeUnique<ResponseTokenBucket>(kResponseBurstPerClientIp - 1,
+                                                 now));
+    return true;
+  }
+  bucket->tokens = std::min(
+      kResponseBurstPerClientIp,
+      bucket->tokens + (now - bucket->last_update).ToMicroseconds() *
+                           kResponsesPerSecondPerClientIp / kNumMicrosPerSecond);
+  bucket->last_update = now;
+  if (bucket->tokens < 1) {
+    return false;
+  }
+  bucket->tokens -= 1;
+  return true;
 }
 
 std::unique_ptr<QuicEncryptedPacket> QuicTimeWaitListManager::BuildPublicReset(
@@ -215,26 +250,34 @@ std::unique_ptr<QuicEncryptedPacket> QuicTimeWaitListManager::BuildPublicReset(
   return QuicFramer::BuildPublicResetPacket(packet);
 }
 
-// Either sends the packet and deletes it or makes pending queue the
-// owner of the packet.
+// Writes the packet as is, and only copies it if it has to be queued.
 void QuicTimeWaitListManager::SendOrQueuePacket(
-    std::unique_ptr<QueuedPacket> packet) {
-  if (WriteToWire(packet.get())) {
-    // Allow the packet to be deleted upon leaving this function.
+    const QuicSocketAddress& server_address,
+    const QuicSocketAddress& client_address,
+    const QuicEncryptedPacket& packet) {
+  if (WriteToWire(server_address, client_address, packet)) {
+    return;
+  }
+  if (pending_packets_queue_.size() >= kMaxPendingPackets) {
+    QUIC_DLOG(INFO) << "Dropping packet to " << client_address.ToString()
+                    << ", too many packets are pending.";
     return;
   }
-  pending_packets_queue_.push_back(std::move(packet));
+  pending_packets_queue_.emplace_back(server_address, client_address,
+                                      packet.Clone());
 }
 
-bool QuicTimeWaitListManager::WriteToWire(QueuedPacket* queued_packet) {
+bool QuicTimeWaitListManager::WriteToWire(
+    const QuicSocketAddress& server_address,
+    const QuicSocketAddress& client_address,
+    const QuicEncryptedPacket& packet) {
   if (writer_->IsWriteBlocked()) {
     visitor_->OnWriteBlocked(this);
     return false;
   }
-  WriteResult result = writer_->WritePacket(
-      queued_packet->packet()->data(), queued_packet->packet()->length(),
-      queued_packet->server_address().host(), queued_packet->client_address(),
-      nullptr);
+  WriteResult result =
+      writer_->WritePacket(packet.data(), packet.length(),
+                           server_address.host(), client_address, nullptr);
   if (result.status == WRITE_STATUS_BLOCKED) {
     // If blocked and unbuffered, return false to retry sending.
     DCHECK(writer_->IsWriteBlocked());
@@ -243,7 +286,7 @@ bool QuicTimeWaitListManager::WriteToWire(QueuedPacket* queued_packet) {
   } else if (result.status == WRITE_STATUS_ERROR) {
     QUIC_LOG_FIRST_N(WARNING, 1)
         << "Received unknown error while sending reset packet to "
-        << queued_packet->client_address().ToString() << ": "
+        << client_address.ToString() << ": "
         << strerror(result.error_code);
   }
   return true;
@@ -321,4 +364,26 @@ QuicTimeWaitListManager::ConnectionIdData::ConnectionIdData(
 
 QuicTimeWaitListManager::ConnectionIdData::~ConnectionIdData() = default;
 
+QuicTimeWaitListManager::QueuedPacket::QueuedPacket(
+    const QuicSocketAddress& server_address,
+    const QuicSocketAddress& client_address,
+    std::unique_ptr<QuicEncryptedPacket> packet)
+    : server_address(server_address),
+      client_address(client_address),
+      packet(std::move(packet)) {}
+
+QuicTimeWaitListManager::QueuedPacket::QueuedPacket(QueuedPacket&& other) =
+    default;
+
+QuicTimeWaitListManager::QueuedPacket&
+QuicTimeWaitListManager::QueuedPacket::operator=(QueuedPacket&& other) =
+    default;
+
+QuicTimeWaitListManager::QueuedPacket::~QueuedPacket() = default;
+
+QuicTimeWaitListManager::ResponseTokenBucket::ResponseTokenBucket(
+    double tokens,
+    QuicTime last_update)
+    : tokens(tokens), last_update(last_update) {}
+
 }  // namespace net
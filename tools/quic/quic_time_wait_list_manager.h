@@ -12,16 +12,19 @@
 #include <stddef.h>
 
 #include <memory>
+#include <string>
 
 #include "base/macros.h"
 #include "net/quic/core/quic_blocked_writer_interface.h"
 #include "net/quic/core/quic_connection.h"
+#include "net/quic/core/quic_connection_id_map.h"
 #include "net/quic/core/quic_framer.h"
 #include "net/quic/core/quic_packet_writer.h"
 #include "net/quic/core/quic_packets.h"
 #include "net/quic/core/quic_session.h"
 #include "net/quic/platform/api/quic_containers.h"
 #include "net/quic/platform/api/quic_flags.h"
+#include "net/quic/platform/api/quic_lru_cache.h"
 
 namespace net {
 
@@ -120,6 +123,8 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
       const QuicPublicResetPacket& packet);
 
   // Creates a public reset packet and sends it or queues it to be sent later.
+  // The reset of a connection in time wait is serialized once per client
+  // address, and sent again as is.
   virtual void SendPublicReset(const QuicSocketAddress& server_address,
                                const QuicSocketAddress& client_address,
                                QuicConnectionId connection_id);
@@ -128,22 +133,53 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
   friend class test::QuicDispatcherPeer;
   friend class test::QuicTimeWaitListManagerPeer;
 
-  // Internal structure to store pending public reset packets.
-  class QueuedPacket;
+  // A packet which couldn't be written because the writer was blocked, and
+  // which is sent once it is writable again.
+  struct QueuedPacket {
+    QueuedPacket(const QuicSocketAddress& server_address,
+                 const QuicSocketAddress& client_address,
+                 std::unique_ptr<QuicEncryptedPacket> packet);
+    QueuedPacket(QueuedPacket&& other);
+    QueuedPacket& operator=(QueuedPacket&& other);
+    ~QueuedPacket();
+
+    QuicSocketAddress server_address;
+    QuicSocketAddress client_address;
+    std::unique_ptr<QuicEncryptedPacket> packet;
+  };
+
+  // Limits the responses sent to a single client IP.  Holds up to
+  // kResponseBurstPerClientIp tokens, and gains kResponsesPerSecondPerClientIp
+  // tokens per second.
+  struct ResponseTokenBucket {
+    ResponseTokenBucket(double tokens, QuicTime last_update);
+
+    double tokens;
+    QuicTime last_update;
+  };
+
+  struct ConnectionIdData;
 
   // Decides if a packet should be sent for this connection_id based on the
   // number of received packets.
   bool ShouldSendResponse(int received_packet_count);
 
-  // Either sends the packet and deletes it or makes pending_packets_queue_ the
-  // owner of the packet.
-  void SendOrQueuePacket(std::unique_ptr<QueuedPacket> packet);
+  // Returns true, and takes a token of the bucket of |client_ip|, if a
+  // response may be sent to it.
+  bool TakeResponseToken(const QuicIpAddress& client_ip);
+
+  // Either sends |packet| or queues a copy of it in pending_packets_queue_.
+  void SendOrQueuePacket(const QuicSocketAddress& server_address,
+                         const QuicSocketAddress& client_address,
+                         const QuicEncryptedPacket& packet);
 
   // Sends the packet out. Returns true if the packet was successfully consumed.
   // If the writer got blocked and did not buffer the packet, we'll need to keep
   // the packet and retry sending. In case of all other errors we drop the
   // packet.
-  bool WriteToWire(QueuedPacket* packet);
+  bool WriteToWire(const QuicSocketAddress& server_address,
+                   const QuicSocketAddress& client_address,
+                   const QuicEncryptedPacket& packet);
 
   // Register the alarm server to wake up at appropriate time.
   void SetConnectionIdCleanUpAlarm();
@@ -177,15 +213,26 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
     // These packets may contain CONNECTION_CLOSE frames, or SREJ messages.
     std::vector<std::unique_ptr<QuicEncryptedPacket>> termination_packets;
     bool connection_rejected_statelessly;
+    // The last public reset sent for this connection, and the client address
+    // it was sent to, which the reset includes.
+    std::unique_ptr<QuicEncryptedPacket> public_reset;
+    QuicSocketAddress public_reset_client_address;
   };
 
-  // QuicLinkedHashMap allows lookup by ConnectionId and traversal in add order.
-  typedef QuicLinkedHashMap<QuicConnectionId, ConnectionIdData> ConnectionIdMap;
+  // QuicConnectionIdMap allows lookup by ConnectionId and traversal in add
+  // order.
+  typedef QuicConnectionIdMap<ConnectionIdData> ConnectionIdMap;
   ConnectionIdMap connection_id_map_;
 
   // Pending public reset packets that need to be sent out to the client
-  // when we are given a chance to write by the dispatcher.
-  QuicDeque<std::unique_ptr<QueuedPacket>> pending_packets_queue_;
+  // when we are given a chance to write by the dispatcher, in a ring of at most
+  // kMaxPendingPackets packets.
+  QuicDeque<QueuedPacket> pending_packets_queue_;
+
+  // Token buckets of the client IPs responses were recently sent to, by packed
+  // IP.  Only used if quic_reloadable_flag_quic_rate_limit_time_wait_responses
+  // is true.
+  QuicLRUCache<std::string, ResponseTokenBucket> response_token_buckets_;
 
   // Time period for which connection_ids should remain in time wait state.
   const QuicTime::Delta time_wait_period_;
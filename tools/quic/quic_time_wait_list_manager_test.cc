@@ -67,6 +67,33 @@ class MockFakeTimeEpollServer : public FakeTimeEpollServer {
                void(int64_t timeout_in_us, EpollAlarmCallbackInterface* alarm));
 };
 
+// Counts the public resets sent and built through the virtual hooks.
+class CountingTimeWaitListManager : public QuicTimeWaitListManager {
+ public:
+  using QuicTimeWaitListManager::QuicTimeWaitListManager;
+
+  void SendPublicReset(const QuicSocketAddress& server_address,
+                       const QuicSocketAddress& client_address,
+                       QuicConnectionId connection_id) override {
+    ++num_sent_public_resets_;
+    QuicTimeWaitListManager::SendPublicReset(server_address, client_address,
+                                             connection_id);
+  }
+
+  std::unique_ptr<QuicEncryptedPacket> BuildPublicReset(
+      const QuicPublicResetPacket& packet) override {
+    ++num_built_public_resets_;
+    return QuicTimeWaitListManager::BuildPublicReset(packet);
+  }
+
+  int num_sent_public_resets() const { return num_sent_public_resets_; }
+  int num_built_public_resets() const { return num_built_public_resets_; }
+
+ private:
+  int num_sent_public_resets_ = 0;
+  int num_built_public_resets_ = 0;
+};
+
 class QuicTimeWaitListManagerTest : public QuicTest {
  protected:
   QuicTimeWaitListManagerTest()
@@ -140,8 +167,9 @@ class QuicTimeWaitListManagerTest : public QuicTest {
 class ValidatePublicResetPacketPredicate
     : public MatcherInterface<const std::tr1::tuple<const char*, int>> {
  public:
-  explicit ValidatePublicResetPacketPredicate(QuicConnectionId connection_id)
-      : connection_id_(connection_id) {}
+  ValidatePublicResetPacketPredicate(QuicConnectionId connection_id,
+                                     const QuicSocketAddress& client_address)
+      : connection_id_(connection_id), client_address_(client_address) {}
 
   bool MatchAndExplain(
       const std::tr1::tuple<const char*, int> packet_buffer,
@@ -155,8 +183,8 @@ class ValidatePublicResetPacketPredicate
     framer.ProcessPacket(encrypted);
     QuicPublicResetPacket packet = visitor.public_reset_packet();
     return connection_id_ == packet.connection_id &&
-           net::test::TestPeerIPAddress() == packet.client_address.host() &&
-           kTestPort == packet.client_address.port();
+           client_address_.host() == packet.client_address.host() &&
+           client_address_.port() == packet.client_address.port();
   }
 
   void DescribeTo(::std::ostream* os) const override {}
@@ -165,11 +193,20 @@ class ValidatePublicResetPacketPredicate
 
  private:
   QuicConnectionId connection_id_;
+  QuicSocketAddress client_address_;
 };
 
+Matcher<const std::tr1::tuple<const char*, int>> PublicResetPacketEq(
+    QuicConnectionId connection_id,
+    const QuicSocketAddress& client_address) {
+  return MakeMatcher(
+      new ValidatePublicResetPacketPredicate(connection_id, client_address));
+}
+
 Matcher<const std::tr1::tuple<const char*, int>> PublicResetPacketEq(
     QuicConnectionId connection_id) {
-  return MakeMatcher(new ValidatePublicResetPacketPredicate(connection_id));
+  return PublicResetPacketEq(
+      connection_id, QuicSocketAddress(TestPeerIPAddress(), kTestPort));
 }
 
 TEST_F(QuicTimeWaitListManagerTest, CheckConnectionIdInTimeWait) {
@@ -272,6 +309,120 @@ TEST_F(QuicTimeWaitListManagerTest, SendPublicResetWithExponentialBackOff) {
   }
 }
 
+TEST_F(QuicTimeWaitListManagerTest, SendPublicResetToNewClientAddress) {
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
+  AddConnectionId(connection_id_);
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, server_address_.host(), client_address_, _))
+      .With(Args<0, 1>(PublicResetPacketEq(connection_id_)))
+      .WillOnce(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  ProcessPacket(connection_id_);
+
+  // The reset sent to the first address isn't reused for another one.
+  const QuicSocketAddress other_client_address(TestPeerIPAddress(),
+                                               kTestPort + 1);
+  EXPECT_CALL(writer_, WritePacket(_, _, server_address_.host(),
+                                   other_client_address, _))
+      .With(Args<0, 1>(
+          PublicResetPacketEq(connection_id_, other_client_address)))
+      .WillOnce(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  time_wait_list_manager_.ProcessPacket(server_address_, other_client_address,
+                                        connection_id_);
+}
+
+TEST_F(QuicTimeWaitListManagerTest, RateLimitResponsesPerClientIp) {
+  FLAGS_quic_reloadable_flag_quic_rate_limit_time_wait_responses = true;
+  epoll_server_.set_now_in_usec(0);
+  const QuicConnectionId kNumConnections = 40;
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(_))
+      .Times(kNumConnections);
+  for (QuicConnectionId connection_id = 1; connection_id <= kNumConnections;
+       ++connection_id) {
+    AddConnectionId(connection_id);
+  }
+
+  // The client gets a burst of 32 responses.
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, server_address_.host(), client_address_, _))
+      .Times(32)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  for (QuicConnectionId connection_id = 1; connection_id <= 36;
+       ++connection_id) {
+    ProcessPacket(connection_id);
+  }
+
+  // Other clients have their own bucket.
+  const QuicSocketAddress other_client_address(QuicIpAddress::Loopback4(),
+                                               kTestPort);
+  EXPECT_CALL(writer_, WritePacket(_, _, server_address_.host(),
+                                   other_client_address, _))
+      .WillOnce(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  time_wait_list_manager_.ProcessPacket(server_address_, other_client_address,
+                                        37);
+
+  // The bucket refills by 16 responses per second.
+  epoll_server_.set_now_in_usec(kNumMicrosPerSecond / 8);
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, server_address_.host(), client_address_, _))
+      .Times(2)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  for (QuicConnectionId connection_id = 38; connection_id <= kNumConnections;
+       ++connection_id) {
+    ProcessPacket(connection_id);
+  }
+}
+
+TEST_F(QuicTimeWaitListManagerTest, RateLimitedClientGetsCachedPublicReset) {
+  FLAGS_quic_reloadable_flag_quic_rate_limit_time_wait_responses = true;
+  epoll_server_.set_now_in_usec(0);
+  CountingTimeWaitListManager time_wait_list_manager(&writer_, &visitor_,
+                                                     &helper_, &alarm_factory_);
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
+  time_wait_list_manager.AddConnectionIdToTimeWait(
+      connection_id_, QuicVersionMax(),
+      /*connection_rejected_statelessly=*/false, nullptr);
+
+  // Packets 1, 2, 4 and 8 get a response, all through SendPublicReset() and
+  // from the one reset built for this client.
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, server_address_.host(), client_address_, _))
+      .With(Args<0, 1>(PublicResetPacketEq(connection_id_)))
+      .Times(4)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  for (int i = 0; i < 8; ++i) {
+    time_wait_list_manager.ProcessPacket(server_address_, client_address_,
+                                         connection_id_);
+  }
+  EXPECT_EQ(4, time_wait_list_manager.num_sent_public_resets());
+  EXPECT_EQ(1, time_wait_list_manager.num_built_public_resets());
+}
+
+TEST_F(QuicTimeWaitListManagerTest, BoundPendingPackets) {
+  const QuicConnectionId kNumConnections = 1001;
+  EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(_))
+      .Times(kNumConnections);
+  for (QuicConnectionId connection_id = 1; connection_id <= kNumConnections;
+       ++connection_id) {
+    AddConnectionId(connection_id);
+  }
+
+  writer_is_blocked_ = true;
+  EXPECT_CALL(visitor_, OnWriteBlocked(&time_wait_list_manager_))
+      .Times(kNumConnections);
+  for (QuicConnectionId connection_id = 1; connection_id <= kNumConnections;
+       ++connection_id) {
+    ProcessPacket(connection_id);
+  }
+
+  // Only the first 1000 resets were queued.
+  writer_is_blocked_ = false;
+  EXPECT_CALL(writer_,
+              WritePacket(_, _, server_address_.host(), client_address_, _))
+      .Times(1000)
+      .WillRepeatedly(Return(WriteResult(WRITE_STATUS_OK, 0)));
+  time_wait_list_manager_.OnBlockedWriterCanWrite();
+}
+
 TEST_F(QuicTimeWaitListManagerTest, NoPublicResetForStatelessConnections) {
   EXPECT_CALL(visitor_, OnConnectionAddedToTimeWaitList(connection_id_));
   AddStatelessConnectionId(connection_id_);
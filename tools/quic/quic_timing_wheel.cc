@@ -0,0 +1,213 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_timing_wheel.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "net/quic/platform/api/quic_logging.h"
+
+namespace net {
+
+QuicTimingWheel::Timer::Timer()
+    : deadline_us_(0), prev_(nullptr), next_(nullptr), slot_(nullptr) {}
+
+QuicTimingWheel::Timer::~Timer() {
+  DCHECK(!IsScheduled()) << "Timer destroyed while scheduled";
+}
+
+QuicTimingWheel::QuicTimingWheel(int64_t tick_us)
+    : tick_us_(tick_us), current_tick_(0), expired_(nullptr), num_timers_(0) {
+  DCHECK_LT(0, tick_us_);
+  std::fill(slots_, slots_ + kNumSlots, nullptr);
+  std::fill(level_sizes_, level_sizes_ + kNumLevels, 0);
+}
+
+QuicTimingWheel::~QuicTimingWheel() {
+  DCHECK_EQ(0u, num_timers_);
+}
+
+void QuicTimingWheel::Schedule(Timer* timer, int64_t deadline_us) {
+  if (timer->IsScheduled()) {
+    if (timer->slot_ != &expired_ &&
+        TickOf(deadline_us) == TickOf(timer->deadline_us_)) {
+      timer->deadline_us_ = deadline_us;
+      return;
+    }
+    Unlink(timer);
+  }
+  timer->deadline_us_ = deadline_us;
+  Insert(timer);
+}
+
+void QuicTimingWheel::Cancel(Timer* timer) {
+  if (timer->IsScheduled()) {
+    Unlink(timer);
+  }
+}
+
+void QuicTimingWheel::Advance(int64_t now_us) {
+  const int64_t target_tick = TickOf(now_us);
+  for (;;) {
+    ExpireCurrentSlot(now_us);
+    if (current_tick_ >= target_tick) {
+      return;
+    }
+    if (num_timers_ == 0) {
+      current_tick_ = target_tick;
+      return;
+    }
+    // No slot can have timers before the next boundary of the lowest level
+    // in use, so jump straight to it.
+    size_t lowest_level = 0;
+    while (level_sizes_[lowest_level] == 0) {
+      ++lowest_level;
+    }
+    const int64_t skip_mask = (int64_t{1} << (kSlotBits * lowest_level)) - 1;
+    current_tick_ = std::min(target_tick - 1, current_tick_ | skip_mask);
+    ++current_tick_;
+    Cascade();
+  }
+}
+
+int64_t QuicTimingWheel::NextWakeUpUs() const {
+  if (num_timers_ == 0) {
+    return -1;
+  }
+  if (level_sizes_[0] > 0) {
+    // Level 0 holds the ticks [current_tick_, current_tick_ + kSlotsPerLevel),
+    // so its first non-empty slot holds the earliest deadlines.
+    for (size_t i = 0; i < kSlotsPerLevel; ++i) {
+      const Timer* timer = slots_[(current_tick_ + i) & kSlotMask];
+      if (timer == nullptr) {
+        continue;
+      }
+      int64_t earliest = timer->deadline_us_;
+      for (; timer != nullptr; timer = timer->next_) {
+        earliest = std::min(earliest, timer->deadline_us_);
+      }
+      return earliest;
+    }
+  }
+  // Otherwise the next thing to do is moving timers down from a higher level.
+  int64_t next_tick = std::numeric_limits<int64_t>::max();
+  for (size_t level = 1; level < kNumLevels; ++level) {
+    if (level_sizes_[level] == 0) {
+      continue;
+    }
+    const size_t shift = kSlotBits * level;
+    const int64_t first = (current_tick_ >> shift) + 1;
+    const int64_t last = first + static_cast<int64_t>(kSlotMask);
+    for (int64_t index = first; index <= last; ++index) {
+      if (slots_[level * kSlotsPerLevel + (index & kSlotMask)] != nullptr) {
+        next_tick = std::min(next_tick, index << shift);
+        break;
+      }
+    }
+  }
+  return next_tick * tick_us_;
+}
+
+int64_t QuicTimingWheel::TickOf(int64_t time_us) const {
+  return time_us / tick_us_;
+}
+
+void QuicTimingWheel::Insert(Timer* timer) {
+  const int64_t tick = std::max(TickOf(timer->deadline_us_), current_tick_);
+  int64_t delta = tick - current_tick_;
+  const int64_t max_delta = (int64_t{1} << (kSlotBits * kNumLevels)) - 1;
+  if (delta > max_delta) {
+    delta = max_delta;
+  }
+  size_t level = 0;
+  while (level + 1 < kNumLevels &&
+         delta >= (int64_t{1} << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  const int64_t slot_tick = current_tick_ + delta;
+  const size_t slot = (slot_tick >> (kSlotBits * level)) & kSlotMask;
+  Link(timer, &slots_[level * kSlotsPerLevel + slot]);
+}
+
+void QuicTimingWheel::Link(Timer* timer, Timer** slot) {
+  DCHECK(!timer->IsScheduled());
+  timer->prev_ = nullptr;
+  timer->next_ = *slot;
+  if (*slot != nullptr) {
+    (*slot)->prev_ = timer;
+  }
+  *slot = timer;
+  timer->slot_ = slot;
+  const size_t level = LevelOf(slot);
+  if (level < kNumLevels) {
+    ++level_sizes_[level];
+  }
+  ++num_timers_;
+}
+
+void QuicTimingWheel::Unlink(Timer* timer) {
+  DCHECK(timer->IsScheduled());
+  if (timer->prev_ != nullptr) {
+    timer->prev_->next_ = timer->next_;
+  } else {
+    *timer->slot_ = timer->next_;
+  }
+  if (timer->next_ != nullptr) {
+    timer->next_->prev_ = timer->prev_;
+  }
+  const size_t level = LevelOf(timer->slot_);
+  if (level < kNumLevels) {
+    --level_sizes_[level];
+  }
+  --num_timers_;
+  timer->prev_ = nullptr;
+  timer->next_ = nullptr;
+  timer->slot_ = nullptr;
+}
+
+size_t QuicTimingWheel::LevelOf(Timer** slot) const {
+  if (slot == &expired_) {
+    return kNumLevels;
+  }
+  return static_cast<size_t>(slot - slots_) / kSlotsPerLevel;
+}
+
+void QuicTimingWheel::ExpireCurrentSlot(int64_t now_us) {
+  Timer* timer = slots_[current_tick_ & kSlotMask];
+  while (timer != nullptr) {
+    Timer* next = timer->next_;
+    if (timer->deadline_us_ <= now_us) {
+      Unlink(timer);
+      Link(timer, &expired_);
+    }
+    timer = next;
+  }
+  // OnExpired() may schedule or cancel any timer, including the ones still
+  // waiting on |expired_|.
+  while (expired_ != nullptr) {
+    timer = expired_;
+    Unlink(timer);
+    timer->OnExpired();
+  }
+}
+
+void QuicTimingWheel::Cascade() {
+  for (size_t level = 1; level < kNumLevels; ++level) {
+    const size_t shift = kSlotBits * level;
+    if ((current_tick_ & ((int64_t{1} << shift) - 1)) != 0) {
+      return;
+    }
+    const size_t slot = (current_tick_ >> shift) & kSlotMask;
+    Timer* timer = slots_[level * kSlotsPerLevel + slot];
+    while (timer != nullptr) {
+      Timer* next = timer->next_;
+      Unlink(timer);
+      Insert(timer);
+      timer = next;
+    }
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,122 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_TIMING_WHEEL_H_
+#define NET_TOOLS_QUIC_QUIC_TIMING_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+
+namespace net {
+
+// A hierarchical timing wheel, which schedules and cancels timers in constant
+// time. Timers are hashed by tick into kNumLevels levels of kSlotsPerLevel
+// slots each, where a slot of level n spans kSlotsPerLevel^n ticks. A timer
+// moves down a level whenever the wheel enters the slot of the level above
+// that holds it. Deadlines keep their full precision: the tick only decides
+// which slot a timer lives in, and a timer expires once the time passed to
+// Advance() reaches its deadline.
+//
+// Timers further out than the span of the wheel (about 4.6 hours with 1 ms
+// ticks) are parked in the top level and rehashed when it comes round.
+//
+// This class is thread-unsafe.
+class QuicTimingWheel {
+ public:
+  class Timer {
+   public:
+    Timer();
+    virtual ~Timer();
+
+    // Called by Advance() once the deadline has been reached. The timer is no
+    // longer scheduled and may be scheduled again.
+    virtual void OnExpired() = 0;
+
+    bool IsScheduled() const { return slot_ != nullptr; }
+
+    int64_t deadline_us() const { return deadline_us_; }
+
+   private:
+    friend class QuicTimingWheel;
+
+    int64_t deadline_us_;
+    Timer* prev_;
+    Timer* next_;
+    // Head of the list this timer is linked into, or null if unscheduled.
+    Timer** slot_;
+
+    DISALLOW_COPY_AND_ASSIGN(Timer);
+  };
+
+  static const size_t kSlotBits = 6;
+  static const size_t kSlotsPerLevel = 1 << kSlotBits;
+  static const size_t kNumLevels = 4;
+
+  explicit QuicTimingWheel(int64_t tick_us);
+  ~QuicTimingWheel();
+
+  // Schedules |timer| to expire at |deadline_us|, rescheduling it if it is
+  // already scheduled. Moving a timer within its tick does not touch the
+  // wheel at all. Deadlines before the time passed to the last Advance() are
+  // due on the next one.
+  void Schedule(Timer* timer, int64_t deadline_us);
+
+  // Cancels |timer| if it is scheduled.
+  void Cancel(Timer* timer);
+
+  // Moves the wheel to |now_us| and expires every timer whose deadline is not
+  // after it. Timers scheduled from OnExpired() for a time that has already
+  // passed expire on the next call. Advancing an empty wheel is constant time,
+  // so owners should advance it to the current time before scheduling the
+  // first timer after an idle period.
+  void Advance(int64_t now_us);
+
+  // Returns the earliest time at which Advance() has work to do, either
+  // expiring timers or moving them down a level, or -1 if no timer is
+  // scheduled.
+  int64_t NextWakeUpUs() const;
+
+  size_t size() const { return num_timers_; }
+
+ private:
+  static const size_t kSlotMask = kSlotsPerLevel - 1;
+  static const size_t kNumSlots = kNumLevels * kSlotsPerLevel;
+
+  int64_t TickOf(int64_t time_us) const;
+
+  // Links |timer| into the slot matching its deadline.
+  void Insert(Timer* timer);
+
+  void Link(Timer* timer, Timer** slot);
+  void Unlink(Timer* timer);
+
+  // Returns the level of |slot|, or kNumLevels for |expired_|.
+  size_t LevelOf(Timer** slot) const;
+
+  // Expires the timers of the current level 0 slot which are due at |now_us|.
+  void ExpireCurrentSlot(int64_t now_us);
+
+  // Moves timers down from the levels whose slot boundary the wheel has just
+  // crossed.
+  void Cascade();
+
+  const int64_t tick_us_;
+  // Tick the wheel is at. All timers in level 0 are due at or after it, except
+  // for those in the slot of the current tick itself, which may be overdue.
+  int64_t current_tick_;
+
+  Timer* slots_[kNumSlots];
+  // Timers being expired by ExpireCurrentSlot().
+  Timer* expired_;
+  size_t level_sizes_[kNumLevels];
+  size_t num_timers_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicTimingWheel);
+};
+
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_TIMING_WHEEL_H_
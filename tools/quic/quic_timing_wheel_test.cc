@@ -0,0 +1,173 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_timing_wheel.h"
+
+#include <vector>
+
+#include "net/quic/platform/api/quic_test.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const int64_t kTickUs = 1000;
+
+class TestTimer : public QuicTimingWheel::Timer {
+ public:
+  TestTimer(int id, std::vector<int>* expired) : id_(id), expired_(expired) {}
+
+  void OnExpired() override { expired_->push_back(id_); }
+
+ private:
+  const int id_;
+  std::vector<int>* expired_;
+};
+
+class QuicTimingWheelTest : public QuicTest {
+ protected:
+  QuicTimingWheelTest() : wheel_(kTickUs) {}
+
+  QuicTimingWheel wheel_;
+  std::vector<int> expired_;
+};
+
+TEST_F(QuicTimingWheelTest, ExpiresAtDeadline) {
+  TestTimer timer(1, &expired_);
+  wheel_.Schedule(&timer, 2500);
+  EXPECT_TRUE(timer.IsScheduled());
+  EXPECT_EQ(1u, wheel_.size());
+  EXPECT_EQ(2500, wheel_.NextWakeUpUs());
+
+  // Reaching the tick of the deadline is not enough.
+  wheel_.Advance(2499);
+  EXPECT_TRUE(expired_.empty());
+
+  wheel_.Advance(2500);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+  EXPECT_FALSE(timer.IsScheduled());
+  EXPECT_EQ(0u, wheel_.size());
+  EXPECT_EQ(-1, wheel_.NextWakeUpUs());
+}
+
+TEST_F(QuicTimingWheelTest, ExpiresInDeadlineOrderAcrossSlots) {
+  TestTimer first(1, &expired_);
+  TestTimer second(2, &expired_);
+  TestTimer third(3, &expired_);
+  wheel_.Schedule(&third, 30 * kTickUs);
+  wheel_.Schedule(&first, 10 * kTickUs);
+  wheel_.Schedule(&second, 20 * kTickUs);
+
+  wheel_.Advance(25 * kTickUs);
+  EXPECT_EQ(std::vector<int>({1, 2}), expired_);
+  EXPECT_EQ(30 * kTickUs, wheel_.NextWakeUpUs());
+  wheel_.Advance(30 * kTickUs);
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), expired_);
+}
+
+TEST_F(QuicTimingWheelTest, Cancel) {
+  TestTimer timer(1, &expired_);
+  wheel_.Schedule(&timer, 5 * kTickUs);
+  wheel_.Cancel(&timer);
+  EXPECT_FALSE(timer.IsScheduled());
+  EXPECT_EQ(0u, wheel_.size());
+  // Cancelling an unscheduled timer is a no-op.
+  wheel_.Cancel(&timer);
+
+  wheel_.Advance(10 * kTickUs);
+  EXPECT_TRUE(expired_.empty());
+}
+
+TEST_F(QuicTimingWheelTest, Reschedule) {
+  TestTimer timer(1, &expired_);
+  wheel_.Schedule(&timer, 5 * kTickUs);
+  // Within the same tick only the deadline changes.
+  wheel_.Schedule(&timer, 5 * kTickUs + 500);
+  EXPECT_EQ(5 * kTickUs + 500, timer.deadline_us());
+  EXPECT_EQ(1u, wheel_.size());
+  wheel_.Schedule(&timer, 8 * kTickUs);
+  EXPECT_EQ(1u, wheel_.size());
+
+  wheel_.Advance(6 * kTickUs);
+  EXPECT_TRUE(expired_.empty());
+  wheel_.Advance(8 * kTickUs);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+}
+
+TEST_F(QuicTimingWheelTest, OverdueDeadlineExpiresOnNextAdvance) {
+  wheel_.Advance(10 * kTickUs);
+  TestTimer timer(1, &expired_);
+  wheel_.Schedule(&timer, 3 * kTickUs);
+  EXPECT_EQ(3 * kTickUs, wheel_.NextWakeUpUs());
+  wheel_.Advance(10 * kTickUs);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+}
+
+TEST_F(QuicTimingWheelTest, FarTimersCascade) {
+  const size_t slots = QuicTimingWheel::kSlotsPerLevel;
+  const int64_t level1_us = 3 * slots * kTickUs + 7 * kTickUs + 1;
+  const int64_t level2_us = 5 * slots * slots * kTickUs + 11;
+  TestTimer near_timer(1, &expired_);
+  TestTimer far_timer(2, &expired_);
+  wheel_.Schedule(&far_timer, level2_us);
+  wheel_.Schedule(&near_timer, level1_us);
+
+  // The first wake-up moves |near_timer| down a level.
+  EXPECT_EQ(static_cast<int64_t>(3 * slots * kTickUs), wheel_.NextWakeUpUs());
+  wheel_.Advance(level1_us - 1);
+  EXPECT_TRUE(expired_.empty());
+  EXPECT_EQ(level1_us, wheel_.NextWakeUpUs());
+  wheel_.Advance(level1_us);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+
+  wheel_.Advance(level2_us - 1);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+  EXPECT_EQ(level2_us, wheel_.NextWakeUpUs());
+  wheel_.Advance(level2_us);
+  EXPECT_EQ(std::vector<int>({1, 2}), expired_);
+}
+
+TEST_F(QuicTimingWheelTest, BeyondSpanOfWheel) {
+  const int64_t span_us = int64_t{1} << (QuicTimingWheel::kSlotBits *
+                                          QuicTimingWheel::kNumLevels);
+  const int64_t deadline_us = 3 * span_us * kTickUs + 42;
+  TestTimer timer(1, &expired_);
+  wheel_.Schedule(&timer, deadline_us);
+  wheel_.Advance(deadline_us - 1);
+  EXPECT_TRUE(expired_.empty());
+  EXPECT_TRUE(timer.IsScheduled());
+  wheel_.Advance(deadline_us);
+  EXPECT_EQ(std::vector<int>({1}), expired_);
+}
+
+class RearmingTimer : public QuicTimingWheel::Timer {
+ public:
+  RearmingTimer(QuicTimingWheel* wheel, int64_t period_us)
+      : wheel_(wheel), period_us_(period_us), expirations_(0) {}
+
+  void OnExpired() override {
+    ++expirations_;
+    wheel_->Schedule(this, deadline_us() + period_us_);
+  }
+
+  int expirations() const { return expirations_; }
+
+ private:
+  QuicTimingWheel* wheel_;
+  const int64_t period_us_;
+  int expirations_;
+};
+
+TEST_F(QuicTimingWheelTest, ScheduleFromOnExpired) {
+  RearmingTimer timer(&wheel_, 2 * kTickUs);
+  wheel_.Schedule(&timer, 2 * kTickUs);
+  wheel_.Advance(9 * kTickUs);
+  EXPECT_EQ(4, timer.expirations());
+  EXPECT_EQ(10 * kTickUs, wheel_.NextWakeUpUs());
+  wheel_.Cancel(&timer);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -83,7 +83,7 @@ class StatelessRejectorTest : public QuicTestWithParam<TestParams> {
                 crypto_test_utils::ProofSourceForTesting()),
         config_peer_(&config_),
         compressed_certs_cache_(
-            QuicCompressedCertsCache::kQuicCompressedCertsCacheSize),
+            QuicCompressedCertsCache::kQuicCompressedCertsCacheMaxBytes),
         rejector_(QuicMakeUnique<StatelessRejector>(
             GetParam().version,
             AllSupportedTransportVersions(),
@@ -0,0 +1,488 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/stress_cache/cache_workload.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/path_service.h"
+#include "base/rand_util.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_scheduler/task_scheduler.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/time/time.h"
+#include "net/base/cache_type.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace {
+
+const char kUsage[] =
+    "Usage: stress_cache --perf [--backend=simple|blockfile|memory]\n"
+    "           [--cache-dir=<path>] [--max-cache-mb=<n>]\n"
+    "           [--distribution=zipf|scan|churn] [--zipf-exponent=<s>]\n"
+    "           [--keys=<n>] [--ops=<n>] [--concurrency=<n>]\n"
+    "           [--read-percent=<n>] [--min-size=<bytes>]\n"
+    "           [--max-size=<bytes>] [--size-distribution=uniform|log]\n"
+    "\n"
+    "Drives a new cache of the given backend with --ops operations, keeping\n"
+    "--concurrency of them in flight. Each operation picks a key from the\n"
+    "--distribution over --keys keys; --read-percent of them open the entry\n"
+    "and read it back, the rest create or overwrite it with a body drawn\n"
+    "from the --size-distribution between --min-size and --max-size.\n"
+    "\n"
+    " zipf  Key k is picked with a probability proportional to\n"
+    "       1 / (k + 1)^s, which models the popularity of web resources.\n"
+    " scan  Keys are picked in order, wrapping around. This is the worst\n"
+    "       case for an LRU cache smaller than the working set.\n"
+    " churn Keys are picked uniformly from a window of --keys keys which\n"
+    "       moves forward by one key per operation, so the working set is\n"
+    "       continuously replaced.\n";
+
+enum class KeyDistribution { ZIPF, SCAN, CHURN };
+enum class SizeDistribution { UNIFORM, LOG_UNIFORM };
+
+struct WorkloadOptions {
+  net::CacheType cache_type = net::DISK_CACHE;
+  net::BackendType backend_type = net::CACHE_BACKEND_SIMPLE;
+  base::FilePath cache_dir;
+  int max_cache_bytes = 256 * 1024 * 1024;
+  KeyDistribution key_distribution = KeyDistribution::ZIPF;
+  double zipf_exponent = 0.9;
+  int num_keys = 10000;
+  int num_ops = 100000;
+  int concurrency = 16;
+  int read_percent = 80;
+  int min_size = 1024;
+  int max_size = 64 * 1024;
+  SizeDistribution size_distribution = SizeDistribution::LOG_UNIFORM;
+};
+
+// Reads the integer switch |name| into |value|, leaving it alone if the
+// switch is absent. Returns false if the value is not at least |min_value|.
+bool GetIntSwitch(const base::CommandLine& command_line,
+                  const char* name,
+                  int min_value,
+                  int* value) {
+  if (!command_line.HasSwitch(name))
+    return true;
+  if (!base::StringToInt(command_line.GetSwitchValueASCII(name), value) ||
+      *value < min_value) {
+    fprintf(stderr, "Invalid --%s\n", name);
+    return false;
+  }
+  return true;
+}
+
+bool ParseOptions(const base::CommandLine& command_line,
+                  WorkloadOptions* options) {
+  std::string backend = command_line.GetSwitchValueASCII("backend");
+  if (backend == "blockfile") {
+    options->backend_type = net::CACHE_BACKEND_BLOCKFILE;
+  } else if (backend == "memory") {
+    options->cache_type = net::MEMORY_CACHE;
+    options->backend_type = net::CACHE_BACKEND_DEFAULT;
+  } else if (!backend.empty() && backend != "simple") {
+    fprintf(stderr, "Unknown --backend %s\n", backend.c_str());
+    return false;
+  }
+
+  options->cache_dir = command_line.GetSwitchValuePath("cache-dir");
+  if (options->cache_dir.empty()) {
+    PathService::Get(base::DIR_TEMP, &options->cache_dir);
+    options->cache_dir = options->cache_dir.AppendASCII("cache_test_perf");
+  }
+
+  int max_cache_mb = options->max_cache_bytes / (1024 * 1024);
+  if (!GetIntSwitch(command_line, "max-cache-mb", 1, &max_cache_mb) ||
+      max_cache_mb > 2047) {
+    return false;
+  }
+  options->max_cache_bytes = max_cache_mb * 1024 * 1024;
+
+  std::string distribution = command_line.GetSwitchValueASCII("distribution");
+  if (distribution == "scan") {
+    options->key_distribution = KeyDistribution::SCAN;
+  } else if (distribution == "churn") {
+    options->key_distribution = KeyDistribution::CHURN;
+  } else if (!distribution.empty() && distribution != "zipf") {
+    fprintf(stderr, "Unknown --distribution %s\n", distribution.c_str());
+    return false;
+  }
+
+  if (command_line.HasSwitch("zipf-exponent") &&
+      (!base::StringToDouble(
+           command_line.GetSwitchValueASCII("zipf-exponent"),
+           &options->zipf_exponent) ||
+       options->zipf_exponent < 0)) {
+    fprintf(stderr, "Invalid --zipf-exponent\n");
+    return false;
+  }
+
+  std::string size_distribution =
+      command_line.GetSwitchValueASCII("size-distribution");
+  if (size_distribution == "uniform") {
+    options->size_distribution = SizeDistribution::UNIFORM;
+  } else if (!size_distribution.empty() && size_distribution != "log") {
+    fprintf(stderr, "Unknown --size-distribution %s\n",
+            size_distribution.c_str());
+    return false;
+  }
+
+  if (!GetIntSwitch(command_line, "keys", 1, &options->num_keys) ||
+      !GetIntSwitch(command_line, "ops", 1, &options->num_ops) ||
+      !GetIntSwitch(command_line, "concurrency", 1, &options->concurrency) ||
+      !GetIntSwitch(command_line, "read-percent", 0, &options->read_percent) ||
+      !GetIntSwitch(command_line, "min-size", 1, &options->min_size) ||
+      !GetIntSwitch(command_line, "max-size", 1, &options->max_size)) {
+    return false;
+  }
+  if (options->read_percent > 100 || options->min_size > options->max_size) {
+    fprintf(stderr, "Invalid --read-percent or --min-size/--max-size\n");
+    return false;
+  }
+  return true;
+}
+
+// Keeps WorkloadOptions::concurrency operations in flight against |backend|
+// until WorkloadOptions::num_ops have been started, then quits the current
+// RunLoop once they have all completed.
+class Workload {
+ public:
+  Workload(const WorkloadOptions& options, disk_cache::Backend* backend);
+  ~Workload();
+
+  // Runs the workload to completion and prints the statistics.
+  void Run();
+
+ private:
+  // One in-flight operation at a time. Each slot owns its entry handle and
+  // read buffer, so slots only share the backend and the |write_buffer_|.
+  class Slot {
+   public:
+    explicit Slot(Workload* workload);
+    ~Slot();
+
+    void Start();
+
+   private:
+    void OnOpenForReadDone(int result);
+    void OnReadDone(int result);
+    void OnCreateDone(int size, int result);
+    void OnOpenForWriteDone(int size, int result);
+    void DoWrite(int size);
+    void OnWriteDone(int result);
+    void Finish(bool hit, int result);
+
+    Workload* const workload_;
+    std::string key_;
+    bool is_read_;
+    base::TimeTicks start_time_;
+    disk_cache::Entry* entry_;
+    scoped_refptr<net::IOBufferWithSize> read_buffer_;
+
+    DISALLOW_COPY_AND_ASSIGN(Slot);
+  };
+
+  std::string PickKey();
+  int PickSize();
+
+  // Called by a Slot when its operation completes. Starts the next operation
+  // on it from a new task, so that synchronous completions don't recurse.
+  void OnOperationDone(Slot* slot,
+                       bool is_read,
+                       bool hit,
+                       bool error,
+                       base::TimeDelta latency);
+
+  void PrintStats(base::TimeDelta elapsed) const;
+
+  const WorkloadOptions options_;
+  disk_cache::Backend* const backend_;
+  scoped_refptr<net::IOBuffer> write_buffer_;
+
+  // The cumulative distribution of the Zipf ranks.
+  std::vector<double> zipf_cdf_;
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  int ops_started_;
+  int ops_in_flight_;
+  int hits_;
+  int errors_;
+  std::vector<base::TimeDelta> read_latencies_;
+  std::vector<base::TimeDelta> write_latencies_;
+  base::OnceClosure quit_closure_;
+
+  DISALLOW_COPY_AND_ASSIGN(Workload);
+};
+
+Workload::Slot::Slot(Workload* workload)
+    : workload_(workload),
+      is_read_(false),
+      entry_(nullptr),
+      read_buffer_(base::MakeRefCounted<net::IOBufferWithSize>(
+          workload->options_.max_size)) {}
+
+Workload::Slot::~Slot() {
+  DCHECK(!entry_);
+}
+
+void Workload::Slot::Start() {
+  key_ = workload_->PickKey();
+  is_read_ = base::RandInt(0, 99) < workload_->options_.read_percent;
+  start_time_ = base::TimeTicks::Now();
+
+  if (is_read_) {
+    int rv = workload_->backend_->OpenEntry(
+        key_, &entry_,
+        base::Bind(&Slot::OnOpenForReadDone, base::Unretained(this)));
+    if (rv != net::ERR_IO_PENDING)
+      OnOpenForReadDone(rv);
+    return;
+  }
+
+  int size = workload_->PickSize();
+  int rv = workload_->backend_->CreateEntry(
+      key_, &entry_,
+      base::Bind(&Slot::OnCreateDone, base::Unretained(this), size));
+  if (rv != net::ERR_IO_PENDING)
+    OnCreateDone(size, rv);
+}
+
+void Workload::Slot::OnOpenForReadDone(int result) {
+  if (result != net::OK)
+    return Finish(false, net::OK);  // A miss.
+
+  int size = std::min(entry_->GetDataSize(1), read_buffer_->size());
+  int rv = entry_->ReadData(
+      1, 0, read_buffer_.get(), size,
+      base::Bind(&Slot::OnReadDone, base::Unretained(this)));
+  if (rv != net::ERR_IO_PENDING)
+    OnReadDone(rv);
+}
+
+void Workload::Slot::OnReadDone(int result) {
+  Finish(true, result < 0 ? result : net::OK);
+}
+
+void Workload::Slot::OnCreateDone(int size, int result) {
+  if (result == net::OK)
+    return DoWrite(size);
+
+  // The entry already exists, so overwrite it.
+  int rv = workload_->backend_->OpenEntry(
+      key_, &entry_,
+      base::Bind(&Slot::OnOpenForWriteDone, base::Unretained(this), size));
+  if (rv != net::ERR_IO_PENDING)
+    OnOpenForWriteDone(size, rv);
+}
+
+void Workload::Slot::OnOpenForWriteDone(int size, int result) {
+  if (result != net::OK)
+    return Finish(false, result);
+  DoWrite(size);
+}
+
+void Workload::Slot::DoWrite(int size) {
+  int rv = entry_->WriteData(
+      1, 0, workload_->write_buffer_.get(), size,
+      base::Bind(&Slot::OnWriteDone, base::Unretained(this)),
+      true /* truncate */);
+  if (rv != net::ERR_IO_PENDING)
+    OnWriteDone(rv);
+}
+
+void Workload::Slot::OnWriteDone(int result) {
+  Finish(false, result < 0 ? result : net::OK);
+}
+
+void Workload::Slot::Finish(bool hit, int result) {
+  if (entry_) {
+    entry_->Close();
+    entry_ = nullptr;
+  }
+  workload_->OnOperationDone(this, is_read_, hit, result != net::OK,
+                             base::TimeTicks::Now() - start_time_);
+}
+
+Workload::Workload(const WorkloadOptions& options,
+                   disk_cache::Backend* backend)
+    : options_(options),
+      backend_(backend),
+      write_buffer_(base::MakeRefCounted<net::IOBuffer>(options.max_size)),
+      ops_started_(0),
+      ops_in_flight_(0),
+      hits_(0),
+      errors_(0) {
+  memset(write_buffer_->data(), 'w', options_.max_size);
+
+  if (options_.key_distribution == KeyDistribution::ZIPF) {
+    zipf_cdf_.resize(options_.num_keys);
+    double sum = 0;
+    for (int i = 0; i < options_.num_keys; ++i) {
+      sum += 1 / pow(static_cast<double>(i + 1), options_.zipf_exponent);
+      zipf_cdf_[i] = sum;
+    }
+    for (double& p : zipf_cdf_)
+      p /= sum;
+  }
+
+  for (int i = 0; i < options_.concurrency; ++i)
+    slots_.push_back(std::make_unique<Slot>(this));
+}
+
+Workload::~Workload() = default;
+
+void Workload::Run() {
+  read_latencies_.reserve(options_.num_ops);
+  write_latencies_.reserve(options_.num_ops);
+
+  base::RunLoop run_loop;
+  quit_closure_ = run_loop.QuitClosure();
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (const auto& slot : slots_) {
+    if (ops_started_ == options_.num_ops)
+      break;
+    ++ops_started_;
+    ++ops_in_flight_;
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&Slot::Start, base::Unretained(slot.get())));
+  }
+  run_loop.Run();
+  PrintStats(base::TimeTicks::Now() - start);
+}
+
+std::string Workload::PickKey() {
+  int key = 0;
+  switch (options_.key_distribution) {
+    case KeyDistribution::ZIPF:
+      key = std::upper_bound(zipf_cdf_.begin(), zipf_cdf_.end() - 1,
+                             base::RandDouble()) -
+            zipf_cdf_.begin();
+      break;
+    case KeyDistribution::SCAN:
+      key = ops_started_ % options_.num_keys;
+      break;
+    case KeyDistribution::CHURN:
+      key = ops_started_ + base::RandInt(0, options_.num_keys - 1);
+      break;
+  }
+  return base::StringPrintf("https://perf.test/%d", key);
+}
+
+int Workload::PickSize() {
+  if (options_.size_distribution == SizeDistribution::UNIFORM)
+    return base::RandInt(options_.min_size, options_.max_size);
+
+  // Log-uniform: as many entries between 1 KB and 2 KB as between 32 KB and
+  // 64 KB, which is closer to real response sizes than a uniform spread.
+  double log_min = log(options_.min_size);
+  double log_max = log(options_.max_size);
+  int size = static_cast<int>(
+      exp(log_min + base::RandDouble() * (log_max - log_min)));
+  return std::max(options_.min_size, std::min(size, options_.max_size));
+}
+
+void Workload::OnOperationDone(Slot* slot,
+                               bool is_read,
+                               bool hit,
+                               bool error,
+                               base::TimeDelta latency) {
+  (is_read ? read_latencies_ : write_latencies_).push_back(latency);
+  if (hit)
+    ++hits_;
+  if (error)
+    ++errors_;
+
+  if (ops_started_ < options_.num_ops) {
+    ++ops_started_;
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&Slot::Start, base::Unretained(slot)));
+    return;
+  }
+  if (--ops_in_flight_ == 0)
+    std::move(quit_closure_).Run();
+}
+
+// Prints the count and latency percentiles of |latencies|, sorting them.
+void PrintLatencies(const char* name, std::vector<base::TimeDelta>* latencies) {
+  if (latencies->empty())
+    return;
+  std::sort(latencies->begin(), latencies->end());
+  auto percentile = [latencies](size_t p) {
+    return (*latencies)[(latencies->size() - 1) * p / 100].InMillisecondsF();
+  };
+  printf("%-6s %8zu ops, latency ms: p50 %.3f, p90 %.3f, p99 %.3f, max %.3f\n",
+         name, latencies->size(), percentile(50), percentile(90),
+         percentile(99), latencies->back().InMillisecondsF());
+}
+
+void Workload::PrintStats(base::TimeDelta elapsed) const {
+  std::vector<base::TimeDelta> reads = read_latencies_;
+  std::vector<base::TimeDelta> writes = write_latencies_;
+  size_t num_ops = reads.size() + writes.size();
+
+  printf("%zu ops in %.1f ms: %.0f ops/s, %d entries in the cache\n", num_ops,
+         elapsed.InMillisecondsF(), num_ops / elapsed.InSecondsF(),
+         backend_->GetEntryCount());
+  printf("read hit rate %.1f%%, %d errors\n",
+         reads.empty() ? 0.0 : 100.0 * hits_ / reads.size(), errors_);
+  PrintLatencies("reads", &reads);
+  PrintLatencies("writes", &writes);
+}
+
+}  // namespace
+
+int RunCacheWorkload(const base::CommandLine& command_line) {
+  WorkloadOptions options;
+  if (command_line.HasSwitch("help") || !ParseOptions(command_line, &options)) {
+    fprintf(stderr, "%s", kUsage);
+    return 1;
+  }
+
+  // The simple backend and the cache utilities post to the TaskScheduler.
+  base::TaskScheduler::CreateAndStartWithDefaultParams("stress_cache");
+
+  // Every run starts from an empty cache, so that runs are comparable.
+  if (options.cache_type == net::DISK_CACHE) {
+    base::DeleteFile(options.cache_dir, true /* recursive */);
+  } else {
+    options.cache_dir.clear();
+  }
+
+  std::unique_ptr<disk_cache::Backend> backend;
+  net::TestCompletionCallback cb;
+  int rv = disk_cache::CreateCacheBackend(
+      options.cache_type, options.backend_type, options.cache_dir,
+      options.max_cache_bytes, true /* force */, nullptr /* net_log */,
+      &backend, cb.callback());
+  if (cb.GetResult(rv) != net::OK) {
+    printf("Unable to initialize cache.\n");
+    return 1;
+  }
+
+  Workload(options, backend.get()).Run();
+
+  backend.reset();
+  disk_cache::FlushCacheThreadForTesting();
+  return 0;
+}
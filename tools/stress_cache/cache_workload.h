@@ -0,0 +1,18 @@
+// Copyright 2018 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_STRESS_CACHE_CACHE_WORKLOAD_H_
+#define NET_TOOLS_STRESS_CACHE_CACHE_WORKLOAD_H_
+
+namespace base {
+class CommandLine;
+}
+
+// Runs the performance workload described by the switches of |command_line|
+// against a freshly created disk cache backend, prints ops/s and latency
+// percentiles and returns the process exit code. See kUsage in
+// cache_workload.cc for the switches.
+int RunCacheWorkload(const base::CommandLine& command_line);
+
+#endif  // NET_TOOLS_STRESS_CACHE_CACHE_WORKLOAD_H_
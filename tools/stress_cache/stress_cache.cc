@@ -14,6 +14,9 @@
 // To test that the disk cache doesn't generate critical errors with regular
 // application level crashes, edit stress_support.h.
 
+// With --perf, the application instead measures the throughput and latency of
+// a disk cache backend under a synthetic workload; see cache_workload.h.
+
 #include <string>
 #include <vector>
 
@@ -45,6 +48,7 @@
 #include "net/disk_cache/blockfile/trace.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/tools/stress_cache/cache_workload.h"
 
 #if defined(OS_WIN)
 #include "base/logging_win.h"
@@ -413,6 +417,14 @@ const GUID kStressCacheTraceProviderName = {
 int main(int argc, const char* argv[]) {
   // Setup an AtExitManager so Singleton objects will be destructed.
   base::AtExitManager at_exit_manager;
+  base::CommandLine::Init(argc, argv);
+
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch("perf")) {
+    base::MessageLoopForIO message_loop;
+    return RunCacheWorkload(command_line);
+  }
 
   if (argc < 2)
     return MasterCode();
@@ -424,7 +436,6 @@ int main(int argc, const char* argv[]) {
 #if defined(OS_WIN)
   logging::LogEventProvider::Initialize(kStressCacheTraceProviderName);
 #else
-  base::CommandLine::Init(argc, argv);
   logging::LoggingSettings settings;
   settings.logging_dest = logging::LOG_TO_SYSTEM_DEBUG_LOG;
   logging::InitLogging(settings);
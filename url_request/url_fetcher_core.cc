@@ -5,6 +5,8 @@
 #include "net/url_request/url_fetcher_core.h"
 
 #include <stdint.h>
+
+#include <algorithm>
 #include <utility>
 
 #include "base/bind.h"
@@ -32,7 +34,10 @@
 
 namespace {
 
-const int kBufferSize = 4096;
+// The size of the first read buffer. Each read which fills the buffer doubles
+// it, up to kMaxBufferSize, so that large downloads take fewer reads.
+const int kInitialBufferSize = 4096;
+const int kMaxBufferSize = 64 * 1024;
 const int kUploadProgressTimerInterval = 100;
 bool g_ignore_certificate_requests = false;
 
@@ -81,6 +86,7 @@ URLFetcherCore::URLFetcherCore(
       delegate_task_runner_(base::SequencedTaskRunnerHandle::Get()),
       load_flags_(LOAD_NORMAL),
       response_code_(URLFetcher::RESPONSE_CODE_INVALID),
+      buffer_size_(kInitialBufferSize),
       url_request_data_key_(NULL),
       was_fetched_via_proxy_(false),
       was_cached_(false),
@@ -433,7 +439,7 @@ void URLFetcherCore::OnResponseStarted(URLRequest* request, int net_error) {
 
   DCHECK(!buffer_);
   if (request_type_ != URLFetcher::HEAD)
-    buffer_ = new IOBuffer(kBufferSize);
+    buffer_ = new IOBuffer(buffer_size_);
   ReadResponse();
 }
 
@@ -472,7 +478,8 @@ void URLFetcherCore::OnReadCompleted(URLRequest* request,
       // Write failed or waiting for write completion.
       return;
     }
-    bytes_read = request_->Read(buffer_.get(), kBufferSize);
+    MaybeGrowBuffer(bytes_read);
+    bytes_read = request_->Read(buffer_.get(), buffer_size_);
   }
 
   // See comments re: HEAD requests in ReadResponse().
@@ -885,6 +892,7 @@ void URLFetcherCore::DidWriteBuffer(scoped_refptr<DrainableIOBuffer> data,
   // Finished writing buffer_. Read some more, unless the request has been
   // cancelled and deleted.
   DCHECK_EQ(0, data->BytesRemaining());
+  MaybeGrowBuffer(data->size());
   if (request_.get())
     ReadResponse();
 }
@@ -896,11 +904,19 @@ void URLFetcherCore::ReadResponse() {
   // about is the response code and headers, which we already have).
   int bytes_read = 0;
   if (request_type_ != URLFetcher::HEAD)
-    bytes_read = request_->Read(buffer_.get(), kBufferSize);
+    bytes_read = request_->Read(buffer_.get(), buffer_size_);
 
   OnReadCompleted(request_.get(), bytes_read);
 }
 
+void URLFetcherCore::MaybeGrowBuffer(int bytes_read) {
+  if (bytes_read < buffer_size_ || buffer_size_ >= kMaxBufferSize)
+    return;
+  buffer_size_ = std::min(buffer_size_ * 2, kMaxBufferSize);
+  // The previous buffer has been fully written, so it is not reused.
+  buffer_ = new IOBuffer(buffer_size_);
+}
+
 void URLFetcherCore::InformDelegateUploadProgress() {
   DCHECK(network_task_runner_->BelongsToCurrentThread());
   if (request_.get()) {
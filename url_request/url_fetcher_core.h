@@ -219,6 +219,10 @@ class URLFetcherCore : public base::RefCountedThreadSafe<URLFetcherCore>,
   // Read response bytes from the request.
   void ReadResponse();
 
+  // Replaces |buffer_| with a larger one if a read of |bytes_read| bytes
+  // filled it.
+  void MaybeGrowBuffer(int bytes_read);
+
   // Notify Delegate about the progress of upload/download.
   void InformDelegateUploadProgress();
   void InformDelegateUploadProgressInDelegateSequence(int64_t current,
@@ -249,6 +253,7 @@ class URLFetcherCore : public base::RefCountedThreadSafe<URLFetcherCore>,
   int response_code_;                // HTTP status code for the request
   scoped_refptr<IOBuffer> buffer_;
                                      // Read buffer
+  int buffer_size_;                  // Size of |buffer_|
   scoped_refptr<URLRequestContextGetter> request_context_getter_;
                                      // Cookie/cache info for the request
   base::Optional<url::Origin> initiator_;  // The request's initiator
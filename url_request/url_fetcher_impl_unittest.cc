@@ -11,6 +11,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/files/file_path.h"
@@ -43,9 +44,12 @@
 #include "net/test/embedded_test_server/embedded_test_server.h"
 #include "net/test/gtest_util.h"
 #include "net/test/net_test_suite.h"
+#include "net/test/url_request/url_request_mock_data_job.h"
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "net/url_request/url_fetcher_delegate.h"
+#include "net/url_request/url_fetcher_response_writer.h"
 #include "net/url_request/url_request_context_getter.h"
+#include "net/url_request/url_request_filter.h"
 #include "net/url_request/url_request_test_util.h"
 #include "net/url_request/url_request_throttler_manager.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -1048,6 +1052,87 @@ TEST_F(URLFetcherTest, DownloadProgress) {
   EXPECT_EQ(file_contents, data);
 }
 
+// Records the data and the size of each write. Writes complete asynchronously
+// if |async| is true, and the data is only copied when they complete.
+class RecordingResponseWriter : public URLFetcherResponseWriter {
+ public:
+  explicit RecordingResponseWriter(bool async) : async_(async) {}
+  ~RecordingResponseWriter() override = default;
+
+  const std::string& data() const { return data_; }
+  const std::vector<int>& write_sizes() const { return write_sizes_; }
+
+  // URLFetcherResponseWriter:
+  int Initialize(const CompletionCallback& callback) override { return OK; }
+
+  int Write(IOBuffer* buffer,
+            int num_bytes,
+            const CompletionCallback& callback) override {
+    write_sizes_.push_back(num_bytes);
+    if (!async_) {
+      data_.append(buffer->data(), num_bytes);
+      return num_bytes;
+    }
+    base::ThreadTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::Bind(&RecordingResponseWriter::CompleteWrite,
+                              base::Unretained(this),
+                              base::WrapRefCounted(buffer), num_bytes,
+                              callback));
+    return ERR_IO_PENDING;
+  }
+
+  int Finish(int net_error, const CompletionCallback& callback) override {
+    return OK;
+  }
+
+ private:
+  void CompleteWrite(scoped_refptr<IOBuffer> buffer,
+                     int num_bytes,
+                     const CompletionCallback& callback) {
+    data_.append(buffer->data(), num_bytes);
+    callback.Run(num_bytes);
+  }
+
+  const bool async_;
+  std::string data_;
+  std::vector<int> write_sizes_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingResponseWriter);
+};
+
+// Tests that the read buffer doubles, up to 64KB, every time a read fills it,
+// whether the response writer completes synchronously or not.
+TEST_F(URLFetcherTest, ReadBufferGrows) {
+  URLRequestMockDataJob::AddUrlHandler();
+  // The response is 256KB, and the mock job fills every read buffer.
+  const std::string kData = "0123456789abcdef";
+  const int kRepeatCount = 16 * 1024;
+  const std::vector<int> kExpectedWriteSizes = {
+      4 * 1024,  8 * 1024,  16 * 1024, 32 * 1024,
+      64 * 1024, 64 * 1024, 64 * 1024, 4 * 1024};
+
+  for (bool async : {false, true}) {
+    SCOPED_TRACE(async);
+    WaitingURLFetcherDelegate delegate;
+    delegate.CreateFetcher(
+        URLRequestMockDataJob::GetMockHttpUrl(kData, kRepeatCount),
+        URLFetcher::GET, CreateSameThreadContextGetter());
+    RecordingResponseWriter* writer = new RecordingResponseWriter(async);
+    delegate.fetcher()->SaveResponseWithWriter(
+        std::unique_ptr<URLFetcherResponseWriter>(writer));
+    delegate.StartFetcherAndWait();
+
+    EXPECT_TRUE(delegate.fetcher()->GetStatus().is_success());
+    EXPECT_EQ(kExpectedWriteSizes, writer->write_sizes());
+    std::string expected_data;
+    for (int i = 0; i < kRepeatCount; ++i)
+      expected_data += kData;
+    EXPECT_EQ(expected_data, writer->data());
+  }
+
+  URLRequestFilter::GetInstance()->ClearHandlers();
+}
+
 class CancelOnUploadProgressDelegate : public WaitingURLFetcherDelegate {
  public:
   CancelOnUploadProgressDelegate() = default;
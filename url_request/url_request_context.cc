@@ -90,6 +90,7 @@ void URLRequestContext::CopyFrom(const URLRequestContext* other) {
   set_network_error_logging_delegate(other->network_error_logging_delegate_);
 #endif  // BUILDFLAG(ENABLE_REPORTING)
   set_enable_brotli(other->enable_brotli_);
+  set_content_decoding_task_runner(other->content_decoding_task_runner_);
   set_check_cleartext_permitted(other->check_cleartext_permitted_);
 }
 
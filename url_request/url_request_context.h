@@ -11,10 +11,12 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
 #include "base/threading/thread_checker.h"
 #include "base/trace_event/memory_dump_provider.h"
 #include "net/base/net_export.h"
@@ -267,6 +269,19 @@ class NET_EXPORT URLRequestContext
 
   bool enable_brotli() const { return enable_brotli_; }
 
+  // Sets the task runner on which the Content-Encoding of large responses is
+  // decoded, rather than on the network thread. Null by default, in which case
+  // all responses are decoded on the network thread.
+  void set_content_decoding_task_runner(
+      scoped_refptr<base::SequencedTaskRunner> content_decoding_task_runner) {
+    content_decoding_task_runner_ = std::move(content_decoding_task_runner);
+  }
+
+  const scoped_refptr<base::SequencedTaskRunner>&
+  content_decoding_task_runner() const {
+    return content_decoding_task_runner_;
+  }
+
   // Sets the |check_cleartext_permitted| flag, which controls whether to check
   // system policy before allowing a cleartext http or ws request.
   void set_check_cleartext_permitted(bool check_cleartext_permitted) {
@@ -332,6 +347,7 @@ class NET_EXPORT URLRequestContext
 
   // Enables Brotli Content-Encoding support.
   bool enable_brotli_;
+  scoped_refptr<base::SequencedTaskRunner> content_decoding_task_runner_;
   // Enables checking system policy before allowing a cleartext http or ws
   // request. Only used on Android.
   bool check_cleartext_permitted_;
@@ -196,6 +196,7 @@ URLRequestContextBuilder::HttpCacheParams::~HttpCacheParams() = default;
 
 URLRequestContextBuilder::URLRequestContextBuilder()
     : enable_brotli_(false),
+      channel_id_key_pool_size_(0),
       network_quality_estimator_(nullptr),
       shared_http_user_agent_settings_(nullptr),
       data_enabled_(false),
@@ -455,6 +456,8 @@ std::unique_ptr<URLRequestContext> URLRequestContextBuilder::Build() {
     storage->set_cookie_store(std::move(cookie_store));
     storage->set_channel_id_service(std::move(channel_id_service));
   }
+  if (channel_id_key_pool_size_ && context->channel_id_service())
+    context->channel_id_service()->SetKeyPoolSize(channel_id_key_pool_size_);
 
   storage->set_transport_security_state(
       std::make_unique<TransportSecurityState>());
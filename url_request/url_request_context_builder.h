@@ -128,6 +128,12 @@ class NET_EXPORT URLRequestContextBuilder {
   // Sets whether Brotli compression is enabled.  Disabled by default;
   void set_enable_brotli(bool enable_brotli) { enable_brotli_ = enable_brotli; }
 
+  // Sets the number of spare channel ID keys the ChannelIDService keeps. See
+  // ChannelIDService::SetKeyPoolSize(). 0, the default, disables the pool.
+  void set_channel_id_key_pool_size(size_t size) {
+    channel_id_key_pool_size_ = size;
+  }
+
   // Unlike most other setters, the builder does not take ownership of the
   // NetworkQualityEstimator.
   void set_network_quality_estimator(
@@ -358,6 +364,7 @@ class NET_EXPORT URLRequestContextBuilder {
  private:
   std::string name_;
   bool enable_brotli_;
+  size_t channel_id_key_pool_size_;
   NetworkQualityEstimator* network_quality_estimator_;
 
   std::string accept_language_;
@@ -11,8 +11,10 @@
 #include "net/http/http_auth_handler.h"
 #include "net/http/http_auth_handler_factory.h"
 #include "net/log/net_log_with_source.h"
+#include "net/ssl/channel_id_service.h"
 #include "net/ssl/ssl_info.h"
 #include "net/test/embedded_test_server/embedded_test_server.h"
+#include "net/test/net_test_suite.h"
 #include "net/traffic_annotation/network_traffic_annotation_test_helper.h"
 #include "net/url_request/url_request.h"
 #include "net/url_request/url_request_test_util.h"
@@ -140,6 +142,14 @@ TEST_F(URLRequestContextBuilderTest, CustomHttpAuthHandlerFactory) {
                 NetLogWithSource(), &handler));
 }
 
+TEST_F(URLRequestContextBuilderTest, ChannelIDKeyPoolSize) {
+  builder_.set_channel_id_key_pool_size(2);
+  std::unique_ptr<URLRequestContext> context(builder_.Build());
+  ASSERT_TRUE(context->channel_id_service());
+  NetTestSuite::GetScopedTaskEnvironment()->RunUntilIdle();
+  EXPECT_EQ(2u, context->channel_id_service()->key_pool_count());
+}
+
 }  // namespace
 
 }  // namespace net
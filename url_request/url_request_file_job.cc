@@ -19,6 +19,10 @@
 
 #include "net/url_request/url_request_file_job.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/files/file_util.h"
@@ -46,6 +50,15 @@
 
 namespace net {
 
+namespace {
+
+// The largest read of the file. Reads of the caller are served from the data
+// read ahead, so bigger reads mean fewer trips to |file_task_runner_| when the
+// caller reads in small chunks.
+const int kReadAheadBufferSize = 256 * 1024;
+
+}  // namespace
+
 URLRequestFileJob::FileMetaInfo::FileMetaInfo()
     : file_size(0),
       mime_type_result(false),
@@ -64,6 +77,11 @@ URLRequestFileJob::URLRequestFileJob(
       file_task_runner_(file_task_runner),
       remaining_bytes_(0),
       range_parse_result_(OK),
+      read_ahead_in_progress_(false),
+      read_ahead_offset_(0),
+      read_ahead_size_(0),
+      read_ahead_error_(ERR_IO_PENDING),
+      pending_read_buf_length_(0),
       weak_ptr_factory_(this) {}
 
 void URLRequestFileJob::Start() {
@@ -96,15 +114,16 @@ int URLRequestFileJob::ReadRawData(IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
-  int rv = stream_->Read(
-      dest, dest_size,
-      base::Bind(&URLRequestFileJob::DidRead, weak_ptr_factory_.GetWeakPtr(),
-                 base::WrapRefCounted(dest)));
-  if (rv >= 0) {
-    remaining_bytes_ -= rv;
-    DCHECK_GE(remaining_bytes_, 0);
+  MaybeStartReadAhead();
+  if (!HasReadAheadResult()) {
+    pending_read_buf_ = dest;
+    pending_read_buf_length_ = dest_size;
+    return ERR_IO_PENDING;
   }
 
+  int rv = ConsumeReadAhead(dest, dest_size);
+  MaybeStartReadAhead();
+  OnReadComplete(dest, rv);
   return rv;
 }
 
@@ -295,16 +314,74 @@ void URLRequestFileJob::DidSeek(int64_t result) {
   NotifyHeadersComplete();
 }
 
-void URLRequestFileJob::DidRead(scoped_refptr<IOBuffer> buf, int result) {
-  if (result >= 0) {
-    remaining_bytes_ -= result;
-    DCHECK_GE(remaining_bytes_, 0);
+void URLRequestFileJob::MaybeStartReadAhead() {
+  if (read_ahead_in_progress_ || HasReadAheadResult() || remaining_bytes_ == 0)
+    return;
+
+  int length = static_cast<int>(std::min(
+      remaining_bytes_, static_cast<int64_t>(kReadAheadBufferSize)));
+  if (!read_ahead_buffer_ || read_ahead_buffer_->size() < length)
+    read_ahead_buffer_ = base::MakeRefCounted<IOBufferWithSize>(length);
+
+  read_ahead_in_progress_ = true;
+  int result = stream_->Read(
+      read_ahead_buffer_.get(), length,
+      base::Bind(&URLRequestFileJob::OnReadAheadComplete,
+                 weak_ptr_factory_.GetWeakPtr()));
+  if (result != ERR_IO_PENDING) {
+    read_ahead_in_progress_ = false;
+    SetReadAheadResult(result);
   }
+}
+
+void URLRequestFileJob::OnReadAheadComplete(int result) {
+  DCHECK(read_ahead_in_progress_);
 
+  read_ahead_in_progress_ = false;
+  SetReadAheadResult(result);
+  if (!pending_read_buf_)
+    return;
+
+  scoped_refptr<IOBuffer> buf = std::move(pending_read_buf_);
+  result = ConsumeReadAhead(buf.get(), pending_read_buf_length_);
+  // Start the next read before handing the data over, since the caller may
+  // read again right away.
+  MaybeStartReadAhead();
   OnReadComplete(buf.get(), result);
-  buf = NULL;
+  buf = nullptr;
 
   ReadRawDataComplete(result);
 }
 
+void URLRequestFileJob::SetReadAheadResult(int result) {
+  DCHECK(!HasReadAheadResult());
+
+  if (result <= 0) {
+    read_ahead_error_ = result;
+    return;
+  }
+  read_ahead_offset_ = 0;
+  read_ahead_size_ = result;
+}
+
+bool URLRequestFileJob::HasReadAheadResult() const {
+  return read_ahead_error_ != ERR_IO_PENDING ||
+         read_ahead_offset_ < read_ahead_size_;
+}
+
+int URLRequestFileJob::ConsumeReadAhead(IOBuffer* buf, int buf_size) {
+  if (read_ahead_offset_ == read_ahead_size_) {
+    int result = read_ahead_error_;
+    read_ahead_error_ = ERR_IO_PENDING;
+    return result;
+  }
+
+  int result = std::min(buf_size, read_ahead_size_ - read_ahead_offset_);
+  memcpy(buf->data(), read_ahead_buffer_->data() + read_ahead_offset_, result);
+  read_ahead_offset_ += result;
+  remaining_bytes_ -= result;
+  DCHECK_GE(remaining_bytes_, 0);
+  return result;
+}
+
 }  // namespace net
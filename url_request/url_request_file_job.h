@@ -28,6 +28,7 @@ class TaskRunner;
 namespace net {
 
 class FileStream;
+class IOBufferWithSize;
 
 // A request job that handles reading file URLs
 class NET_EXPORT URLRequestFileJob : public URLRequestJob {
@@ -112,8 +113,18 @@ class NET_EXPORT URLRequestFileJob : public URLRequestJob {
   // on a background thread.
   void DidSeek(int64_t result);
 
-  // Callback after data is asynchronously read from the file into |buf|.
-  void DidRead(scoped_refptr<IOBuffer> buf, int result);
+  // The file is read in chunks of up to kReadAheadBufferSize bytes into
+  // |read_ahead_buffer_|, and ReadRawData() copies the data from there. Once
+  // a chunk has been copied out, the next one is read while the caller
+  // consumes the data, so that callers which read in small chunks neither
+  // wait on the file for every read nor cause a task per read.
+  void MaybeStartReadAhead();
+  void OnReadAheadComplete(int result);
+  void SetReadAheadResult(int result);
+  bool HasReadAheadResult() const;
+  // Returns the result of the read-ahead, copying up to |buf_size| of the
+  // bytes which were read ahead to |buf|.
+  int ConsumeReadAhead(IOBuffer* buf, int buf_size);
 
   std::unique_ptr<FileStream> stream_;
   FileMetaInfo meta_info_;
@@ -125,6 +136,19 @@ class NET_EXPORT URLRequestFileJob : public URLRequestJob {
 
   Error range_parse_result_;
 
+  scoped_refptr<IOBufferWithSize> read_ahead_buffer_;
+  bool read_ahead_in_progress_;
+  // The bytes of |read_ahead_buffer_| from |read_ahead_offset_| up to
+  // |read_ahead_size_| were read ahead and not returned by ReadRawData() yet.
+  int read_ahead_offset_;
+  int read_ahead_size_;
+  // The end-of-file or error result of the last read-ahead, returned once the
+  // data read ahead has been consumed, or ERR_IO_PENDING if there is none.
+  int read_ahead_error_;
+  // The buffer of a ReadRawData() which waits for a read-ahead to complete.
+  scoped_refptr<IOBuffer> pending_read_buf_;
+  int pending_read_buf_length_;
+
   base::WeakPtrFactory<URLRequestFileJob> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestFileJob);
@@ -343,6 +343,14 @@ TEST_F(URLRequestFileJobEventsTest, Range) {
   RunSuccessfulRequestWithString(MakeContentOfSize(size), &range);
 }
 
+TEST_F(URLRequestFileJobEventsTest, RangeInBigFile) {
+  // Use a range which starts and ends in the middle of the chunks the file is
+  // read in, and spans several of them.
+  int size = 3 * 1024 * 1024;
+  Range range(300001, (1200 * 1024) + 7);
+  RunSuccessfulRequestWithString(MakeContentOfSize(size), &range);
+}
+
 TEST_F(URLRequestFileJobEventsTest, DecodeSvgzFile) {
   std::string expected_content("Hello, World!");
   unsigned char gzip_data[] = {
@@ -18,6 +18,7 @@
 #include "base/metrics/histogram_functions.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/rand_util.h"
+#include "base/sequenced_task_runner.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -42,6 +43,7 @@
 #include "net/filter/filter_source_stream.h"
 #include "net/filter/gzip_source_stream.h"
 #include "net/filter/source_stream.h"
+#include "net/filter/threaded_source_stream.h"
 #include "net/http/http_content_disposition.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_headers.h"
@@ -246,6 +248,47 @@ void LogCookieAgeForNonSecureRequest(const net::CookieList& cookie_list,
   }
 }
 
+// Responses with a Content-Length of at least this many bytes are decoded on
+// the URLRequestContext's content decoding task runner, if it has one.
+const int64_t kMinOffThreadDecodingContentLength = 1024 * 1024;
+
+// Wraps |upstream| in the streams which decode |types|, the last of which is
+// applied first. Returns nullptr if one of the streams cannot be created.
+std::unique_ptr<net::SourceStream> CreateDecodingStreams(
+    const std::vector<net::SourceStream::SourceType>& types,
+    std::unique_ptr<net::SourceStream> upstream) {
+  for (std::vector<net::SourceStream::SourceType>::const_reverse_iterator
+           r_iter = types.rbegin();
+       r_iter != types.rend(); ++r_iter) {
+    std::unique_ptr<net::FilterSourceStream> downstream;
+    net::SourceStream::SourceType type = *r_iter;
+    switch (type) {
+      case net::SourceStream::TYPE_BROTLI:
+        downstream = net::CreateBrotliSourceStream(std::move(upstream));
+        break;
+      case net::SourceStream::TYPE_GZIP:
+      case net::SourceStream::TYPE_DEFLATE:
+        downstream = net::GzipSourceStream::Create(std::move(upstream), type);
+        break;
+      case net::SourceStream::TYPE_GZIP_FALLBACK_DEPRECATED:
+      case net::SourceStream::TYPE_SDCH_DEPRECATED:
+      case net::SourceStream::TYPE_SDCH_POSSIBLE_DEPRECATED:
+      case net::SourceStream::TYPE_NONE:
+      case net::SourceStream::TYPE_INVALID:
+      case net::SourceStream::TYPE_REJECTED:
+      case net::SourceStream::TYPE_UNKNOWN:
+      case net::SourceStream::TYPE_MAX:
+        NOTREACHED();
+        return nullptr;
+    }
+    if (downstream == nullptr)
+      return nullptr;
+    upstream = std::move(downstream);
+  }
+
+  return upstream;
+}
+
 }  // namespace
 
 namespace net {
@@ -1114,36 +1157,18 @@ std::unique_ptr<SourceStream> URLRequestHttpJob::SetUpSourceStream() {
     }
   }
 
-  for (std::vector<SourceStream::SourceType>::reverse_iterator r_iter =
-           types.rbegin();
-       r_iter != types.rend(); ++r_iter) {
-    std::unique_ptr<FilterSourceStream> downstream;
-    SourceStream::SourceType type = *r_iter;
-    switch (type) {
-      case SourceStream::TYPE_BROTLI:
-        downstream = CreateBrotliSourceStream(std::move(upstream));
-        break;
-      case SourceStream::TYPE_GZIP:
-      case SourceStream::TYPE_DEFLATE:
-        downstream = GzipSourceStream::Create(std::move(upstream), type);
-        break;
-      case SourceStream::TYPE_GZIP_FALLBACK_DEPRECATED:
-      case SourceStream::TYPE_SDCH_DEPRECATED:
-      case SourceStream::TYPE_SDCH_POSSIBLE_DEPRECATED:
-      case SourceStream::TYPE_NONE:
-      case SourceStream::TYPE_INVALID:
-      case SourceStream::TYPE_REJECTED:
-      case SourceStream::TYPE_UNKNOWN:
-      case SourceStream::TYPE_MAX:
-        NOTREACHED();
-        return nullptr;
-    }
-    if (downstream == nullptr)
-      return nullptr;
-    upstream = std::move(downstream);
+  // Decoding a large response on the network thread would hold up every
+  // other request, so hand it to a worker sequence when possible.
+  const scoped_refptr<base::SequencedTaskRunner>& decoding_task_runner =
+      request()->context()->content_decoding_task_runner();
+  if (decoding_task_runner && !types.empty() &&
+      headers->GetContentLength() >= kMinOffThreadDecodingContentLength) {
+    return ThreadedSourceStream::Create(
+        std::move(upstream), base::BindOnce(&CreateDecodingStreams, types),
+        decoding_task_runner);
   }
 
-  return upstream;
+  return CreateDecodingStreams(types, std::move(upstream));
 }
 
 bool URLRequestHttpJob::CopyFragmentOnRedirect(const GURL& location) const {
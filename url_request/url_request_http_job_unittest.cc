@@ -6,23 +6,29 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/format_macros.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/run_loop.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/task_scheduler/post_task.h"
 #include "base/test/histogram_tester.h"
 #include "net/base/auth.h"
 #include "net/base/request_priority.h"
 #include "net/cert/ct_policy_status.h"
 #include "net/cookies/cookie_store_test_helpers.h"
+#include "net/filter/filter_source_stream_test_util.h"
 #include "net/http/http_transaction_factory.h"
 #include "net/http/http_transaction_test_util.h"
 #include "net/log/net_log_event_type.h"
@@ -1261,6 +1267,62 @@ TEST_F(URLRequestHttpJobWithMockSocketsTest,
   histograms.ExpectTotalCount(kCTRequiredHistogramName, 0);
 }
 
+// Tests that a large response decoded on a worker sequence is read from the
+// socket only while the URLRequest has a read pending. The socket reads
+// complete asynchronously, so a read of the job completing outside of a
+// URLRequest::Read() would fail the checks of URLRequestJob.
+TEST_F(URLRequestHttpJobWithMockSocketsTest, TestOffThreadContentDecoding) {
+  context_->set_content_decoding_task_runner(
+      base::CreateSequencedTaskRunnerWithTraits({}));
+
+  // Data which barely compresses, so that the response is above the threshold
+  // for decoding it off the network thread.
+  std::string body;
+  uint32_t state = 1;
+  for (int i = 0; i < 1100 * 1024; i++) {
+    state = state * 1103515245 + 12345;
+    body.push_back(static_cast<char>(state >> 24));
+  }
+  std::string encoded_body(body.size() + 1024, '\0');
+  size_t encoded_body_len = encoded_body.size();
+  CompressGzip(body.data(), body.size(), &encoded_body[0], &encoded_body_len,
+               true);
+  encoded_body.resize(encoded_body_len);
+
+  std::string response_headers = base::StringPrintf(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Encoding: gzip\r\n"
+      "Content-Length: %" PRIuS "\r\n\r\n",
+      encoded_body.size());
+  std::vector<MockRead> reads;
+  reads.push_back(MockRead(ASYNC, response_headers.data(),
+                           static_cast<int>(response_headers.size())));
+  const size_t kReadSize = 16 * 1024;
+  for (size_t offset = 0; offset < encoded_body.size(); offset += kReadSize) {
+    reads.push_back(MockRead(
+        ASYNC, encoded_body.data() + offset,
+        static_cast<int>(std::min(kReadSize, encoded_body.size() - offset))));
+  }
+  MockWrite writes[] = {MockWrite(kSimpleGetMockWrite)};
+  StaticSocketDataProvider socket_data(reads.data(), reads.size(), writes,
+                                       arraysize(writes));
+  socket_factory_.AddSocketDataProvider(&socket_data);
+
+  TestDelegate delegate;
+  std::unique_ptr<URLRequest> request =
+      context_->CreateRequest(GURL("http://www.example.com"), DEFAULT_PRIORITY,
+                              &delegate, TRAFFIC_ANNOTATION_FOR_TESTS);
+  request->Start();
+  base::RunLoop().Run();
+
+  EXPECT_THAT(delegate.request_status(), IsOk());
+  EXPECT_EQ(body, delegate.data_received());
+  EXPECT_EQ(static_cast<int64_t>(encoded_body.size()),
+            request->received_response_content_length());
+  EXPECT_EQ(CountReadBytes(reads.data(), reads.size()),
+            request->GetTotalReceivedBytes());
+}
+
 TEST_F(URLRequestHttpJobTest, TestCancelWhileReadingCookies) {
   DelayedCookieMonster cookie_monster;
   TestURLRequestContext context(true);
@@ -4,6 +4,12 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
 #include "base/callback.h"
 #include "base/files/file_path.h"
 #include "base/macros.h"
@@ -11,7 +17,10 @@
 #include "base/message_loop/message_loop.h"
 #include "base/run_loop.h"
 #include "base/single_thread_task_runner.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "base/trace_event/memory_dump_manager.h"
 #include "base/trace_event/memory_dump_manager_test_utils.h"
@@ -20,12 +29,14 @@
 #include "base/trace_event/trace_config.h"
 #include "base/trace_event/trace_event_argument.h"
 #include "net/base/load_timing_info.h"
+#include "net/base/net_errors.h"
 #include "net/cert/mock_cert_verifier.h"
 #include "net/dns/mapped_host_resolver.h"
 #include "net/dns/mock_host_resolver.h"
 #include "net/http/http_status_code.h"
 #include "net/quic/chromium/crypto/proof_source_chromium.h"
 #include "net/quic/test_tools/crypto_test_utils.h"
+#include "net/spdy/core/spdy_header_block.h"
 #include "net/test/cert_test_util.h"
 #include "net/test/embedded_test_server/embedded_test_server.h"
 #include "net/test/embedded_test_server/http_response.h"
@@ -60,6 +71,14 @@ const char kHelloPath[] = "/hello.txt";
 const char kHelloAltSvcResponse[] = "Hello from QUIC Server";
 const char kHelloOriginResponse[] = "Hello from TCP Server";
 const int kHelloStatus = 200;
+// Used to measure throughput. Each server fills it with its own character.
+const char kLargePath[] = "/large.bin";
+const size_t kLargeBodySize = 1024 * 1024;
+const char kLargeAltSvcFill = 'q';
+const char kLargeOriginFill = 't';
+// Used to measure the cache-hit path. Same bodies as for |kHelloPath|.
+const char kCacheablePath[] = "/cacheable.txt";
+const char kCacheControl[] = "max-age=3600";
 
 std::unique_ptr<test_server::HttpResponse> HandleRequest(
     const test_server::HttpRequest& request) {
@@ -70,24 +89,35 @@ std::unique_ptr<test_server::HttpResponse> HandleRequest(
                      "quic=\"%s:%d\"; v=\"%u\"", kAltSvcHost, kAltSvcPort,
                      HttpNetworkSession::Params().quic_supported_versions[0]));
   http_response->set_code(HTTP_OK);
+  if (request.relative_url == kLargePath) {
+    http_response->set_content(std::string(kLargeBodySize, kLargeOriginFill));
+    http_response->set_content_type("application/octet-stream");
+    return std::move(http_response);
+  }
+  if (request.relative_url == kCacheablePath)
+    http_response->AddCustomHeader("Cache-Control", kCacheControl);
   http_response->set_content(kHelloOriginResponse);
   http_response->set_content_type("text/plain");
   return std::move(http_response);
 }
 
 void PrintPerfTest(const std::string& name,
-                   int value,
+                   double value,
                    const std::string& unit) {
   const ::testing::TestInfo* test_info =
       ::testing::UnitTest::GetInstance()->current_test_info();
   perf_test::PrintResult(test_info->test_case_name(),
                          std::string(".") + test_info->name(), name,
-                         static_cast<double>(value), unit, true);
+                         value, unit, true);
 }
 
 class URLRequestQuicPerfTest : public ::testing::Test {
  protected:
-  URLRequestQuicPerfTest() : message_loop_(new base::MessageLoopForIO()) {
+  // If |enable_quic| is false, all requests are sent to the HTTP/1.1 server,
+  // ignoring its Alt-Svc headers.
+  explicit URLRequestQuicPerfTest(bool enable_quic = true)
+      : message_loop_(new base::MessageLoopForIO()),
+        quic_server_thread_("QuicServerThread") {
     memory_dump_manager_ =
         base::trace_event::MemoryDumpManager::CreateInstanceForTesting();
     base::trace_event::InitializeMemoryDumpManagerForInProcessTesting(
@@ -110,7 +140,7 @@ class URLRequestQuicPerfTest : public ::testing::Test {
     network_session_context.cert_verifier = &cert_verifier_;
     std::unique_ptr<HttpNetworkSession::Params> params(
         new HttpNetworkSession::Params);
-    params->enable_quic = true;
+    params->enable_quic = enable_quic;
     params->enable_user_alternate_protocol_ports = true;
     params->quic_allow_remote_alt_svc = true;
     context_->set_host_resolver(host_resolver_.get());
@@ -120,8 +150,13 @@ class URLRequestQuicPerfTest : public ::testing::Test {
   }
 
   void TearDown() override {
-    if (quic_server_) {
-      quic_server_->Shutdown();
+    if (quic_server_thread_.IsRunning()) {
+      quic_server_thread_.task_runner()->PostTask(
+          FROM_HERE,
+          base::Bind(&URLRequestQuicPerfTest::ShutdownQuicServerOnServerThread,
+                     base::Unretained(this)));
+      // Runs the shutdown before the thread stops.
+      quic_server_thread_.Stop();
       // If possible, deliver the conncetion close packet to the client before
       // destruct the TestURLRequestContext.
       base::RunLoop().RunUntilIdle();
@@ -142,15 +177,31 @@ class URLRequestQuicPerfTest : public ::testing::Test {
 
  private:
   void StartQuicServer() {
-    net::QuicConfig config;
     response_cache_.AddSimpleResponse(kOriginHost, kHelloPath, kHelloStatus,
                                       kHelloAltSvcResponse);
-    quic_server_.reset(new QuicSimpleServer(
-        test::crypto_test_utils::ProofSourceForTesting(), config,
-        net::QuicCryptoServerConfig::ConfigOptions(),
-        AllSupportedTransportVersions(), &response_cache_));
-    int rv = quic_server_->Listen(
-        net::IPEndPoint(net::IPAddress::IPv4AllZeros(), kAltSvcPort));
+    response_cache_.AddSimpleResponse(
+        kOriginHost, kLargePath, kHelloStatus,
+        std::string(kLargeBodySize, kLargeAltSvcFill));
+    SpdyHeaderBlock cacheable_headers;
+    cacheable_headers[":status"] = base::IntToString(kHelloStatus);
+    cacheable_headers["cache-control"] = kCacheControl;
+    response_cache_.AddResponse(kOriginHost, kCacheablePath,
+                                std::move(cacheable_headers),
+                                kHelloAltSvcResponse);
+
+    // The QUIC server runs on a thread of its own, like the EmbeddedTestServer,
+    // so that the CPU time of the test thread is that of the client only.
+    ASSERT_TRUE(quic_server_thread_.StartWithOptions(
+        base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+    base::WaitableEvent server_started(
+        base::WaitableEvent::ResetPolicy::MANUAL,
+        base::WaitableEvent::InitialState::NOT_SIGNALED);
+    int rv = ERR_FAILED;
+    quic_server_thread_.task_runner()->PostTask(
+        FROM_HERE,
+        base::Bind(&URLRequestQuicPerfTest::StartQuicServerOnServerThread,
+                   base::Unretained(this), &rv, &server_started));
+    server_started.Wait();
     ASSERT_GE(rv, 0) << "Quic server fails to start";
 
     CertVerifyResult verify_result;
@@ -160,6 +211,23 @@ class URLRequestQuicPerfTest : public ::testing::Test {
                                     verify_result, OK);
   }
 
+  void StartQuicServerOnServerThread(int* rv,
+                                     base::WaitableEvent* server_started) {
+    net::QuicConfig config;
+    quic_server_.reset(new QuicSimpleServer(
+        test::crypto_test_utils::ProofSourceForTesting(), config,
+        net::QuicCryptoServerConfig::ConfigOptions(),
+        AllSupportedTransportVersions(), &response_cache_));
+    *rv = quic_server_->Listen(
+        net::IPEndPoint(net::IPAddress::IPv4AllZeros(), kAltSvcPort));
+    server_started->Signal();
+  }
+
+  void ShutdownQuicServerOnServerThread() {
+    quic_server_->Shutdown();
+    quic_server_.reset();
+  }
+
   void StartTcpServer() {
     tcp_server_ = std::make_unique<EmbeddedTestServer>(
         net::EmbeddedTestServer::TYPE_HTTPS);
@@ -175,8 +243,10 @@ class URLRequestQuicPerfTest : public ::testing::Test {
   std::unique_ptr<base::trace_event::MemoryDumpManager> memory_dump_manager_;
   std::unique_ptr<MappedHostResolver> host_resolver_;
   std::unique_ptr<EmbeddedTestServer> tcp_server_;
-  std::unique_ptr<QuicSimpleServer> quic_server_;
   std::unique_ptr<base::MessageLoop> message_loop_;
+  // Created, used and destroyed on |quic_server_thread_|.
+  std::unique_ptr<QuicSimpleServer> quic_server_;
+  base::Thread quic_server_thread_;
   std::unique_ptr<TestURLRequestContext> context_;
   QuicHttpResponseCache response_cache_;
   MockCertVerifier cert_verifier_;
@@ -272,4 +342,128 @@ TEST_F(URLRequestQuicPerfTest, TestGetRequest) {
   base::trace_event::MemoryDumpManager::GetInstance()->TeardownForTracing();
 }
 
+enum class Protocol { HTTP1, QUIC };
+
+// Compares the cost of the same workloads over HTTP/1.1 with TLS and over
+// QUIC, both served in-process. CPU time is that of the test thread, which
+// runs the client only: each server has a thread of its own.
+class URLRequestProtocolPerfTest
+    : public URLRequestQuicPerfTest,
+      public ::testing::WithParamInterface<Protocol> {
+ protected:
+  URLRequestProtocolPerfTest()
+      : URLRequestQuicPerfTest(GetParam() == Protocol::QUIC) {}
+
+  // Returns the body that the server under test sends for |path|.
+  std::string ExpectedBody(const std::string& path) const {
+    bool quic = GetParam() == Protocol::QUIC;
+    if (path == kLargePath) {
+      return std::string(kLargeBodySize,
+                         quic ? kLargeAltSvcFill : kLargeOriginFill);
+    }
+    return quic ? kHelloAltSvcResponse : kHelloOriginResponse;
+  }
+
+  // Fetches |path| until the server under test answers, so that the
+  // connection is set up, and for QUIC the Alt-Svc is learned, before
+  // anything is measured. For |kCacheablePath|, this also fills the cache.
+  void WarmUp(const char* path) {
+    GURL url(base::StringPrintf("https://%s%s", kOriginHost, path));
+    for (int i = 0; i < 10; ++i) {
+      TestDelegate delegate;
+      std::unique_ptr<URLRequest> request =
+          CreateRequest(url, DEFAULT_PRIORITY, &delegate);
+      request->Start();
+      base::RunLoop().Run();
+      if (delegate.data_received() == ExpectedBody(path))
+        return;
+    }
+    FAIL() << "The server under test never answered";
+  }
+
+  // Fetches |path| |count| times, keeping |concurrency| requests in flight,
+  // and reports the wall time and CPU time per request, and the CPU time per
+  // MB received. If |expect_cached|, the responses must come from the cache.
+  void RunRequests(const char* path,
+                   int count,
+                   int concurrency,
+                   bool expect_cached) {
+    GURL url(base::StringPrintf("https://%s%s", kOriginHost, path));
+    const std::string expected_body = ExpectedBody(path);
+    int64_t bytes_received = 0;
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    base::ThreadTicks start_cpu = base::ThreadTicks::IsSupported()
+                                      ? base::ThreadTicks::Now()
+                                      : base::ThreadTicks();
+    for (int done = 0; done < count; done += concurrency) {
+      std::vector<std::unique_ptr<TestDelegate>> delegates;
+      std::vector<std::unique_ptr<URLRequest>> requests;
+      for (int i = 0; i < concurrency && done + i < count; ++i) {
+        delegates.push_back(std::make_unique<TestDelegate>());
+        requests.push_back(
+            CreateRequest(url, DEFAULT_PRIORITY, delegates.back().get()));
+        requests.back()->Start();
+      }
+      // Each completion quits the RunLoop once idle, so there may be several
+      // completions per Run().
+      while (std::any_of(delegates.begin(), delegates.end(),
+                         [](const std::unique_ptr<TestDelegate>& delegate) {
+                           return !delegate->response_completed();
+                         })) {
+        base::RunLoop().Run();
+      }
+      for (size_t i = 0; i < requests.size(); ++i) {
+        ASSERT_TRUE(requests[i]->status().is_success());
+        ASSERT_EQ(expected_body, delegates[i]->data_received());
+        EXPECT_EQ(expect_cached, requests[i]->was_cached());
+        bytes_received += delegates[i]->bytes_received();
+      }
+    }
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    std::string prefix = GetParam() == Protocol::QUIC ? "quic_" : "http1_";
+    PrintPerfTest(prefix + "time_per_request",
+                  elapsed.InMillisecondsF() / count, "ms");
+    if (base::ThreadTicks::IsSupported()) {
+      base::TimeDelta cpu = base::ThreadTicks::Now() - start_cpu;
+      PrintPerfTest(prefix + "cpu_per_request", cpu.InMillisecondsF() / count,
+                    "ms");
+      PrintPerfTest(prefix + "cpu_per_mb",
+                    cpu.InMillisecondsF() * 1024 * 1024 / bytes_received,
+                    "ms");
+    }
+  }
+};
+
+INSTANTIATE_TEST_CASE_P(Protocols,
+                        URLRequestProtocolPerfTest,
+                        ::testing::Values(Protocol::HTTP1, Protocol::QUIC));
+
+// Many small requests, one at a time: per-request overhead.
+TEST_P(URLRequestProtocolPerfTest, SmallRequests) {
+  ASSERT_NO_FATAL_FAILURE(WarmUp(kHelloPath));
+  RunRequests(kHelloPath, 1000, 1, false /* expect_cached */);
+}
+
+// Small requests with several in flight: for QUIC, concurrent streams on one
+// connection; for HTTP/1.1, one connection per request.
+TEST_P(URLRequestProtocolPerfTest, ConcurrentRequests) {
+  ASSERT_NO_FATAL_FAILURE(WarmUp(kHelloPath));
+  RunRequests(kHelloPath, 1000, 6, false /* expect_cached */);
+}
+
+// Large bodies: throughput and CPU per MB.
+TEST_P(URLRequestProtocolPerfTest, LargeBody) {
+  ASSERT_NO_FATAL_FAILURE(WarmUp(kHelloPath));
+  RunRequests(kLargePath, 50, 1, false /* expect_cached */);
+}
+
+// Responses served from the HTTP cache after a first fetch over the network.
+TEST_P(URLRequestProtocolPerfTest, CacheHits) {
+  ASSERT_NO_FATAL_FAILURE(WarmUp(kHelloPath));
+  ASSERT_NO_FATAL_FAILURE(WarmUp(kCacheablePath));
+  RunRequests(kCacheablePath, 1000, 1, true /* expect_cached */);
+}
+
 }  // namespace net
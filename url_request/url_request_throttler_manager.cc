@@ -4,6 +4,8 @@
 
 #include "net/url_request/url_request_throttler_manager.h"
 
+#include <vector>
+
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "net/base/url_util.h"
@@ -14,10 +16,10 @@
 namespace net {
 
 const unsigned int URLRequestThrottlerManager::kMaximumNumberOfEntries = 1500;
-const unsigned int URLRequestThrottlerManager::kRequestsBetweenCollecting = 200;
+const size_t URLRequestThrottlerManager::kBucketsCollectedPerRequest = 8;
 
 URLRequestThrottlerManager::URLRequestThrottlerManager()
-    : requests_since_last_gc_(0),
+    : next_bucket_to_collect_(0),
       enable_thread_checks_(false),
       logged_for_localhost_disabled_(false),
       registered_from_thread_(base::kInvalidThreadId) {
@@ -103,9 +105,6 @@ void URLRequestThrottlerManager::OverrideEntryForTests(
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
 
-  // Periodically garbage collect old entries.
-  GarbageCollectEntriesIfNecessary();
-
   url_entries_[url_id] = entry;
 }
 
@@ -151,19 +150,24 @@ std::string URLRequestThrottlerManager::GetIdFromUrl(const GURL& url) const {
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntriesIfNecessary() {
-  requests_since_last_gc_++;
-  if (requests_since_last_gc_ < kRequestsBetweenCollecting)
-    return;
-  requests_since_last_gc_ = 0;
+  size_t bucket_count = url_entries_.bucket_count();
+  for (size_t i = 0; i < kBucketsCollectedPerRequest; ++i) {
+    if (next_bucket_to_collect_ >= bucket_count)
+      next_bucket_to_collect_ = 0;
+    GarbageCollectBucket(next_bucket_to_collect_++);
+  }
 
-  GarbageCollectEntries();
+  // In case something broke we want to make sure not to grow indefinitely.
+  while (url_entries_.size() > kMaximumNumberOfEntries) {
+    url_entries_.erase(url_entries_.begin());
+  }
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntries() {
   UrlEntryMap::iterator i = url_entries_.begin();
   while (i != url_entries_.end()) {
     if ((i->second)->IsEntryOutdated()) {
-      url_entries_.erase(i++);
+      i = url_entries_.erase(i);
     } else {
       ++i;
     }
@@ -175,13 +179,26 @@ void URLRequestThrottlerManager::GarbageCollectEntries() {
   }
 }
 
+void URLRequestThrottlerManager::GarbageCollectBucket(size_t bucket) {
+  // Entries can't be erased through the iterators of a bucket, so the
+  // outdated ones are looked up again.
+  std::vector<std::string> outdated_url_ids;
+  for (auto i = url_entries_.cbegin(bucket); i != url_entries_.cend(bucket);
+       ++i) {
+    if (i->second->IsEntryOutdated())
+      outdated_url_ids.push_back(i->first);
+  }
+  for (const std::string& url_id : outdated_url_ids)
+    url_entries_.erase(url_id);
+}
+
 void URLRequestThrottlerManager::OnNetworkChange() {
   // Remove all entries.  Any entries that in-flight requests have a reference
   // to will live until those requests end, and these entries may be
   // inconsistent with new entries for the same URLs, but since what we
   // want is a clean slate for the new connection type, this is OK.
   url_entries_.clear();
-  requests_since_last_gc_ = 0;
+  next_bucket_to_collect_ = 0;
 }
 
 }  // namespace net
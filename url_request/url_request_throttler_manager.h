@@ -5,9 +5,11 @@
 #ifndef NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 #define NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 
-#include <map>
+#include <stddef.h>
+
 #include <set>
 #include <string>
+#include <unordered_map>
 
 #include "base/macros.h"
 #include "base/memory/ref_counted.h"
@@ -29,7 +31,7 @@ class NetLogWithSource;
 //
 // URLRequestThrottlerManager maintains a map of URL IDs to URL request
 // throttler entries. It creates URL request throttler entries when new URLs
-// are registered, and does garbage collection from time to time in order to
+// are registered, and does garbage collection a bit at a time in order to
 // clean out outdated entries. URL ID consists of lowercased scheme, host, port
 // and path. All URLs converted to the same ID will share the same entry.
 class NET_EXPORT URLRequestThrottlerManager
@@ -47,7 +49,8 @@ class NET_EXPORT URLRequestThrottlerManager
       const GURL& url);
 
   // Registers a new entry in this service and overrides the existing entry (if
-  // any) for the URL. The service will hold a reference to the entry.
+  // any) for the URL. The service will hold a reference to the entry. Unlike
+  // RegisterRequestUrl(), this does not garbage collect other entries.
   // It is only used by unit tests.
   void OverrideEntryForTests(const GURL& url, URLRequestThrottlerEntry* entry);
 
@@ -85,9 +88,9 @@ class NET_EXPORT URLRequestThrottlerManager
   // transformation.
   std::string GetIdFromUrl(const GURL& url) const;
 
-  // Method that ensures the map gets cleaned from time to time. The period at
-  // which garbage collecting happens is adjustable with the
-  // kRequestBetweenCollecting constant.
+  // Method that ensures the map gets cleaned over time. Each call collects the
+  // outdated entries of the next kBucketsCollectedPerRequest buckets of the
+  // map, so that requests never pay for a scan of the whole map.
   void GarbageCollectEntriesIfNecessary();
 
   // Method that does the actual work of garbage collecting.
@@ -108,21 +111,26 @@ class NET_EXPORT URLRequestThrottlerManager
  private:
   // From each URL we generate an ID composed of the scheme, host, port and path
   // that allows us to uniquely map an entry to it.
-  typedef std::map<std::string, scoped_refptr<URLRequestThrottlerEntry> >
+  typedef std::unordered_map<std::string,
+                             scoped_refptr<URLRequestThrottlerEntry>>
       UrlEntryMap;
 
   // Maximum number of entries that we are willing to collect in our map.
   static const unsigned int kMaximumNumberOfEntries;
-  // Number of requests that will be made between garbage collection.
-  static const unsigned int kRequestsBetweenCollecting;
+  // Number of buckets of the map garbage collected on each request.
+  static const size_t kBucketsCollectedPerRequest;
+
+  // Removes the entries of bucket |bucket| of |url_entries_| which are
+  // outdated.
+  void GarbageCollectBucket(size_t bucket);
 
   // Map that contains a list of URL ID and their matching
   // URLRequestThrottlerEntry.
   UrlEntryMap url_entries_;
 
-  // This keeps track of how many requests have been made. Used with
-  // GarbageCollectEntries.
-  unsigned int requests_since_last_gc_;
+  // The bucket of |url_entries_| which the next request starts garbage
+  // collecting from. Wraps around when the map is rehashed.
+  size_t next_bucket_to_collect_;
 
   // Valid after construction.
   GURL::Replacements url_id_replacements_;
@@ -400,6 +400,21 @@ TEST_F(URLRequestThrottlerManagerTest, AreEntriesBeingCollected) {
   EXPECT_EQ(3, manager.GetNumberOfEntries());
 }
 
+TEST_F(URLRequestThrottlerManagerTest, AreEntriesCollectedIncrementally) {
+  MockURLRequestThrottlerManager manager;
+
+  for (int i = 0; i < 100; ++i)
+    manager.CreateEntry(false);
+  manager.CreateEntry(true);
+  manager.CreateEntry(true);
+  EXPECT_EQ(102, manager.GetNumberOfEntries());
+
+  // Requests collect the outdated entries without a full garbage collection.
+  for (int i = 0; i < 100; ++i)
+    manager.RegisterRequestUrl(GURL("http://www.example.com/"));
+  EXPECT_EQ(101, manager.GetNumberOfEntries());
+}
+
 TEST_F(URLRequestThrottlerManagerTest, IsHostBeingRegistered) {
   MockURLRequestThrottlerManager manager;
 
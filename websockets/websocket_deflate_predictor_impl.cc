@@ -4,20 +4,62 @@
 
 #include "net/websockets/websocket_deflate_predictor_impl.h"
 
+#include "net/websockets/websocket_frame.h"
+
 namespace net {
 
 typedef WebSocketDeflatePredictor::Result Result;
 
+WebSocketDeflatePredictorImpl::WebSocketDeflatePredictorImpl()
+    : input_bytes_(0),
+      written_bytes_(0),
+      message_compressed_(false),
+      in_written_message_(false),
+      poorly_compressed_messages_(0),
+      messages_to_skip_(0) {}
+
+WebSocketDeflatePredictorImpl::~WebSocketDeflatePredictorImpl() = default;
+
 Result WebSocketDeflatePredictorImpl::Predict(
     const std::vector<std::unique_ptr<WebSocketFrame>>& frames,
     size_t frame_index) {
+  if (messages_to_skip_ > 0) {
+    --messages_to_skip_;
+    return DO_NOT_DEFLATE;
+  }
   return DEFLATE;
 }
 
 void WebSocketDeflatePredictorImpl::RecordInputDataFrame(
-    const WebSocketFrame* frame) {}
+    const WebSocketFrame* frame) {
+  input_bytes_ += frame->header.payload_length;
+}
 
 void WebSocketDeflatePredictorImpl::RecordWrittenDataFrame(
-    const WebSocketFrame* frame) {}
+    const WebSocketFrame* frame) {
+  if (!in_written_message_) {
+    in_written_message_ = true;
+    message_compressed_ = frame->header.reserved1;
+  }
+  written_bytes_ += frame->header.payload_length;
+  if (!frame->header.final)
+    return;
+
+  // Every input frame of a message is recorded before its last written frame.
+  if (message_compressed_) {
+    // Compression which saves less than a tenth is hardly worth its cost.
+    if (written_bytes_ * 10 >= input_bytes_ * 9) {
+      if (++poorly_compressed_messages_ >= kMaxPoorlyCompressedMessages) {
+        poorly_compressed_messages_ = 0;
+        messages_to_skip_ = kSkippedMessages;
+      }
+    } else {
+      poorly_compressed_messages_ = 0;
+    }
+  }
+  input_bytes_ = 0;
+  written_bytes_ = 0;
+  in_written_message_ = false;
+}
 
 }  // namespace net
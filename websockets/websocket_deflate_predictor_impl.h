@@ -6,10 +6,12 @@
 #define NET_WEBSOCKETS_WEBSOCKET_DEFLATE_PREDICTOR_IMPL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <memory>
 #include <vector>
 
+#include "base/macros.h"
 #include "net/base/net_export.h"
 #include "net/websockets/websocket_deflate_predictor.h"
 
@@ -17,15 +19,37 @@ namespace net {
 
 struct WebSocketFrame;
 
+// Deflates every message, unless several messages in a row barely shrank.
+// Then the next few messages are sent uncompressed, which is always allowed
+// whatever the context takeover mode, before compression is tried again.
 class NET_EXPORT_PRIVATE WebSocketDeflatePredictorImpl
     : public WebSocketDeflatePredictor {
  public:
-  ~WebSocketDeflatePredictorImpl() override {}
+  // The number of poorly compressed messages in a row after which compression
+  // is skipped, and the number of messages it is skipped for.
+  static const int kMaxPoorlyCompressedMessages = 3;
+  static const int kSkippedMessages = 16;
+
+  WebSocketDeflatePredictorImpl();
+  ~WebSocketDeflatePredictorImpl() override;
 
   Result Predict(const std::vector<std::unique_ptr<WebSocketFrame>>& frames,
                  size_t frame_index) override;
   void RecordInputDataFrame(const WebSocketFrame* frame) override;
   void RecordWrittenDataFrame(const WebSocketFrame* frame) override;
+
+ private:
+  // The payload bytes of the message being written, before and after
+  // compression, and whether it is compressed.
+  uint64_t input_bytes_;
+  uint64_t written_bytes_;
+  bool message_compressed_;
+  bool in_written_message_;
+
+  int poorly_compressed_messages_;
+  int messages_to_skip_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebSocketDeflatePredictorImpl);
 };
 
 }  // namespace net
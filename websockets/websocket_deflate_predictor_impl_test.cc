@@ -4,6 +4,8 @@
 
 #include "net/websockets/websocket_deflate_predictor_impl.h"
 
+#include <stdint.h>
+
 #include <vector>
 
 #include "net/websockets/websocket_frame.h"
@@ -25,6 +27,52 @@ TEST(WebSocketDeflatePredictorImpl, Predict) {
   EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, result);
 }
 
+// Records a one-frame message of |input_size| bytes, which was written with
+// |written_size| bytes.
+void RecordMessage(WebSocketDeflatePredictorImpl* predictor,
+                   uint64_t input_size,
+                   uint64_t written_size,
+                   bool compressed) {
+  WebSocketFrame input(WebSocketFrameHeader::kOpCodeBinary);
+  input.header.final = true;
+  input.header.payload_length = input_size;
+  predictor->RecordInputDataFrame(&input);
+
+  WebSocketFrame written(WebSocketFrameHeader::kOpCodeBinary);
+  written.header.final = true;
+  written.header.reserved1 = compressed;
+  written.header.payload_length = written_size;
+  predictor->RecordWrittenDataFrame(&written);
+}
+
+TEST(WebSocketDeflatePredictorImpl, SkipsIncompressibleMessages) {
+  WebSocketDeflatePredictorImpl predictor;
+  std::vector<std::unique_ptr<WebSocketFrame>> frames;
+  frames.push_back(
+      std::make_unique<WebSocketFrame>(WebSocketFrameHeader::kOpCodeBinary));
+
+  // Messages which compress well keep being deflated.
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+    RecordMessage(&predictor, 1000, 100, true);
+  }
+
+  for (int i = 0;
+       i < WebSocketDeflatePredictorImpl::kMaxPoorlyCompressedMessages; ++i) {
+    ASSERT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+    RecordMessage(&predictor, 1000, 995, true);
+  }
+
+  for (int i = 0; i < WebSocketDeflatePredictorImpl::kSkippedMessages; ++i) {
+    ASSERT_EQ(WebSocketDeflatePredictor::DO_NOT_DEFLATE,
+              predictor.Predict(frames, 0));
+    RecordMessage(&predictor, 1000, 1000, false);
+  }
+
+  // Compression is tried again.
+  EXPECT_EQ(WebSocketDeflatePredictor::DEFLATE, predictor.Predict(frames, 0));
+}
+
 }  // namespace
 
 }  // namespace net
@@ -4,31 +4,102 @@
 
 #include "net/websockets/websocket_deflater.h"
 
+#include <stdlib.h>
 #include <string.h>
 #include <algorithm>
+#include <map>
 #include <vector>
 
 #include "base/containers/circular_deque.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
 #include "net/base/io_buffer.h"
 #include "third_party/zlib/zlib.h"
 
 namespace net {
 
+namespace {
+
+// The largest number of bytes kept by WorkspacePool. A deflate stream with the
+// default parameters uses about 256KB.
+const size_t kMaxPooledWorkspaceBytes = 1024 * 1024;
+
+// Each block starts with its size, padded to keep the memory handed to zlib
+// suitably aligned.
+const size_t kBlockHeaderSize = 16;
+
+// A process-wide free list of the memory zlib allocates for deflate streams.
+// Streams which do not take over their context are released after every
+// message, and the next message of any connection reuses their memory.
+class WorkspacePool {
+ public:
+  WorkspacePool() : pooled_bytes_(0) {}
+
+  void* Allocate(size_t size) {
+    {
+      base::AutoLock lock(lock_);
+      auto it = free_blocks_.find(size);
+      if (it != free_blocks_.end() && !it->second.empty()) {
+        char* block = it->second.back();
+        it->second.pop_back();
+        pooled_bytes_ -= size;
+        return block + kBlockHeaderSize;
+      }
+    }
+    char* block = static_cast<char*>(malloc(kBlockHeaderSize + size));
+    if (!block)
+      return nullptr;
+    memcpy(block, &size, sizeof(size));
+    return block + kBlockHeaderSize;
+  }
+
+  void Free(void* address) {
+    char* block = static_cast<char*>(address) - kBlockHeaderSize;
+    size_t size;
+    memcpy(&size, block, sizeof(size));
+    {
+      base::AutoLock lock(lock_);
+      if (pooled_bytes_ + size <= kMaxPooledWorkspaceBytes) {
+        free_blocks_[size].push_back(block);
+        pooled_bytes_ += size;
+        return;
+      }
+    }
+    free(block);
+  }
+
+ private:
+  base::Lock lock_;
+  // Free blocks, by the size zlib asked for.
+  std::map<size_t, std::vector<char*>> free_blocks_;
+  size_t pooled_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkspacePool);
+};
+
+base::LazyInstance<WorkspacePool>::Leaky g_workspace_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+voidpf AllocateWorkspace(voidpf opaque, uInt items, uInt size) {
+  return g_workspace_pool.Get().Allocate(static_cast<size_t>(items) * size);
+}
+
+void FreeWorkspace(voidpf opaque, voidpf address) {
+  g_workspace_pool.Get().Free(address);
+}
+
+}  // namespace
+
 WebSocketDeflater::WebSocketDeflater(ContextTakeOverMode mode)
-    : mode_(mode), are_bytes_added_(false) {}
+    : mode_(mode), window_bits_(0), are_bytes_added_(false) {}
 
 WebSocketDeflater::~WebSocketDeflater() {
-  if (stream_) {
-    deflateEnd(stream_.get());
-    stream_.reset(NULL);
-  }
+  ReleaseStream();
 }
 
 bool WebSocketDeflater::Initialize(int window_bits) {
-  DCHECK(!stream_);
-  stream_.reset(new z_stream);
-
+  DCHECK(!window_bits_);
   DCHECK_LE(8, window_bits);
   DCHECK_GE(15, window_bits);
 
@@ -51,20 +122,10 @@ bool WebSocketDeflater::Initialize(int window_bits) {
   // specific to any particular inflate implementation.
   //
   // See https://crbug.com/691074
-  window_bits = -std::max(window_bits, 9);
+  window_bits_ = -std::max(window_bits, 9);
 
-  memset(stream_.get(), 0, sizeof(*stream_));
-  int result = deflateInit2(stream_.get(),
-                            Z_DEFAULT_COMPRESSION,
-                            Z_DEFLATED,
-                            window_bits,
-                            8,  // default mem level
-                            Z_DEFAULT_STRATEGY);
-  if (result != Z_OK) {
-    deflateEnd(stream_.get());
-    stream_.reset();
-    return false;
-  }
+  // The stream itself is created by the first AddBytes(), so that connections
+  // which never send a message do not hold the memory of a deflate context.
   const size_t kFixedBufferSize = 4096;
   fixed_buffer_.resize(kFixedBufferSize);
   return true;
@@ -73,6 +134,8 @@ bool WebSocketDeflater::Initialize(int window_bits) {
 bool WebSocketDeflater::AddBytes(const char* data, size_t size) {
   if (!size)
     return true;
+  if (!stream_ && !InitializeStream())
+    return false;
 
   are_bytes_added_ = true;
   stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
@@ -129,9 +192,38 @@ scoped_refptr<IOBufferWithSize> WebSocketDeflater::GetOutput(size_t size) {
   return result;
 }
 
+bool WebSocketDeflater::InitializeStream() {
+  DCHECK(window_bits_);
+  DCHECK(!stream_);
+  stream_.reset(new z_stream);
+  memset(stream_.get(), 0, sizeof(*stream_));
+  stream_->zalloc = AllocateWorkspace;
+  stream_->zfree = FreeWorkspace;
+  int result = deflateInit2(stream_.get(),
+                            Z_DEFAULT_COMPRESSION,
+                            Z_DEFLATED,
+                            window_bits_,
+                            8,  // default mem level
+                            Z_DEFAULT_STRATEGY);
+  if (result != Z_OK) {
+    ReleaseStream();
+    return false;
+  }
+  return true;
+}
+
+void WebSocketDeflater::ReleaseStream() {
+  if (stream_) {
+    deflateEnd(stream_.get());
+    stream_.reset();
+  }
+}
+
 void WebSocketDeflater::ResetContext() {
+  // Without context takeover nothing is kept between messages, so return the
+  // memory of the stream to the pool rather than resetting it.
   if (mode_ == DO_NOT_TAKE_OVER_CONTEXT)
-    deflateReset(stream_.get());
+    ReleaseStream();
   are_bytes_added_ = false;
 }
 
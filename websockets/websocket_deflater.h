@@ -38,6 +38,8 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
   // This function must be called exactly once before calling any of
   // following methods.
   // |window_bits| must be between 8 and 15 (both inclusive).
+  // The zlib stream is only allocated once bytes are added. In
+  // DO_NOT_TAKE_OVER_CONTEXT mode it is released again after each Finish().
   bool Initialize(int window_bits);
 
   // Adds bytes to |stream_|.
@@ -62,11 +64,15 @@ class NET_EXPORT_PRIVATE WebSocketDeflater {
   size_t CurrentOutputSize() const { return buffer_.size(); }
 
  private:
+  bool InitializeStream();
+  void ReleaseStream();
   void ResetContext();
   int Deflate(int flush);
 
   std::unique_ptr<z_stream_s> stream_;
   ContextTakeOverMode mode_;
+  // The window bits given to deflateInit2(), or 0 before Initialize().
+  int window_bits_;
   base::circular_deque<char> buffer_;
   std::vector<char> fixed_buffer_;
   // true if bytes were added after last Finish().
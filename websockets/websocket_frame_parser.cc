@@ -29,13 +29,17 @@ const uint64_t kMaxPayloadLengthWithoutExtendedLengthField = 125;
 const uint64_t kPayloadLengthWithTwoByteExtendedLengthField = 126;
 const uint64_t kPayloadLengthWithEightByteExtendedLengthField = 127;
 
+const size_t kMaximumFrameHeaderSize =
+    net::WebSocketFrameHeader::kBaseHeaderSize +
+    net::WebSocketFrameHeader::kMaximumExtendedLengthSize +
+    net::WebSocketFrameHeader::kMaskingKeyLength;
+
 }  // namespace.
 
 namespace net {
 
 WebSocketFrameParser::WebSocketFrameParser()
-    : current_read_pos_(0),
-      frame_offset_(0),
+    : frame_offset_(0),
       websocket_error_(kWebSocketNormalClosure) {
   std::fill(masking_key_.key,
             masking_key_.key + WebSocketFrameHeader::kMaskingKeyLength,
@@ -53,61 +57,77 @@ bool WebSocketFrameParser::Decode(
   if (!length)
     return true;
 
-  // TODO(yutak): Remove copy.
-  buffer_.insert(buffer_.end(), data, data + length);
-
-  while (current_read_pos_ < buffer_.size()) {
+  // Frames are parsed straight from |data|. Only an incomplete frame header
+  // at its end is copied, to be completed by the next round of Decode().
+  const char* current = data;
+  const char* const end = data + length;
+  while (current != end) {
     bool first_chunk = false;
     if (!current_frame_header_.get()) {
-      DecodeFrameHeader();
+      const size_t remaining = end - current;
+      size_t consumed = buffer_.empty()
+                            ? DecodeFrameHeader(current, remaining)
+                            : DecodeCarriedOverFrameHeader(current, remaining);
       if (websocket_error_ != kWebSocketNormalClosure)
         return false;
-      // If frame header is incomplete, then carry over the remaining
-      // data to the next round of Decode().
-      if (!current_frame_header_.get())
+      if (!current_frame_header_.get()) {
+        if (buffer_.empty())
+          buffer_.assign(current, end);
         break;
+      }
+      current += consumed;
       first_chunk = true;
     }
 
     std::unique_ptr<WebSocketFrameChunk> frame_chunk =
-        DecodeFramePayload(first_chunk);
+        DecodeFramePayload(first_chunk, &current, end);
     DCHECK(frame_chunk.get());
     frame_chunks->push_back(std::move(frame_chunk));
 
     if (current_frame_header_.get()) {
-      DCHECK(current_read_pos_ == buffer_.size());
+      DCHECK(current == end);
       break;
     }
   }
 
-  // Drain unnecessary data. TODO(yutak): Remove copy. (but how?)
-  buffer_.erase(buffer_.begin(), buffer_.begin() + current_read_pos_);
-  current_read_pos_ = 0;
-
   // Sanity check: the size of carried-over data should not exceed
   // the maximum possible length of a frame header.
-  static const size_t kMaximumFrameHeaderSize =
-      WebSocketFrameHeader::kBaseHeaderSize +
-      WebSocketFrameHeader::kMaximumExtendedLengthSize +
-      WebSocketFrameHeader::kMaskingKeyLength;
   DCHECK_LT(buffer_.size(), kMaximumFrameHeaderSize);
 
   return true;
 }
 
-void WebSocketFrameParser::DecodeFrameHeader() {
+size_t WebSocketFrameParser::DecodeCarriedOverFrameHeader(const char* data,
+                                                          size_t length) {
+  DCHECK(!buffer_.empty());
+  const size_t carried_over_size = buffer_.size();
+  // The header is complete within kMaximumFrameHeaderSize bytes, so there is
+  // no need to copy any more than that.
+  const size_t copied_size =
+      std::min(length, kMaximumFrameHeaderSize - carried_over_size);
+  buffer_.insert(buffer_.end(), data, data + copied_size);
+  size_t header_size = DecodeFrameHeader(buffer_.data(), buffer_.size());
+  if (!current_frame_header_.get())
+    return 0;
+  DCHECK_GT(header_size, carried_over_size);
+  buffer_.clear();
+  return header_size - carried_over_size;
+}
+
+size_t WebSocketFrameParser::DecodeFrameHeader(const char* data,
+                                               size_t length) {
   typedef WebSocketFrameHeader::OpCode OpCode;
   static const int kMaskingKeyLength = WebSocketFrameHeader::kMaskingKeyLength;
 
   DCHECK(!current_frame_header_.get());
 
-  const char* start = &buffer_.front() + current_read_pos_;
+  const char* start = data;
   const char* current = start;
-  const char* end = &buffer_.front() + buffer_.size();
+  const char* end = data + length;
 
   // Header needs 2 bytes at minimum.
   if (end - current < 2)
-    return;
+    return 0;
 
   uint8_t first_byte = *current++;
   uint8_t second_byte = *current++;
@@ -122,7 +142,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   uint64_t payload_length = second_byte & kPayloadLengthMask;
   if (payload_length == kPayloadLengthWithTwoByteExtendedLengthField) {
     if (end - current < 2)
-      return;
+      return 0;
     uint16_t payload_length_16;
     base::ReadBigEndian(current, &payload_length_16);
     current += 2;
@@ -131,7 +151,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
       websocket_error_ = kWebSocketErrorProtocolError;
   } else if (payload_length == kPayloadLengthWithEightByteExtendedLengthField) {
     if (end - current < 8)
-      return;
+      return 0;
     base::ReadBigEndian(current, &payload_length);
     current += 8;
     if (payload_length <= UINT16_MAX ||
@@ -143,15 +163,14 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   }
   if (websocket_error_ != kWebSocketNormalClosure) {
     buffer_.clear();
-    current_read_pos_ = 0;
     current_frame_header_.reset();
     frame_offset_ = 0;
-    return;
+    return 0;
   }
 
   if (masked) {
     if (end - current < kMaskingKeyLength)
-      return;
+      return 0;
     std::copy(current, current + kMaskingKeyLength, masking_key_.key);
     current += kMaskingKeyLength;
   } else {
@@ -165,16 +184,18 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   current_frame_header_->reserved3 = reserved3;
   current_frame_header_->masked = masked;
   current_frame_header_->payload_length = payload_length;
-  current_read_pos_ += current - start;
   DCHECK_EQ(0u, frame_offset_);
+  return current - start;
 }
 
 std::unique_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
-    bool first_chunk) {
+    bool first_chunk,
+    const char** data,
+    const char* end) {
   // The cast here is safe because |payload_length| is already checked to be
   // less than std::numeric_limits<int>::max() when the header is parsed.
   int next_size = static_cast<int>(
-      std::min(static_cast<uint64_t>(buffer_.size() - current_read_pos_),
+      std::min(static_cast<uint64_t>(end - *data),
                current_frame_header_->payload_length - frame_offset_));
 
   std::unique_ptr<WebSocketFrameChunk> frame_chunk(new WebSocketFrameChunk);
@@ -185,7 +206,7 @@ std::unique_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
   if (next_size) {
     frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
     char* io_data = frame_chunk->data->data();
-    memcpy(io_data, &buffer_.front() + current_read_pos_, next_size);
+    memcpy(io_data, *data, next_size);
     if (current_frame_header_->masked) {
       // The masking function is its own inverse, so we use the same function to
       // unmask as to mask.
@@ -193,7 +214,7 @@ std::unique_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
           masking_key_, frame_offset_, io_data, next_size);
     }
 
-    current_read_pos_ += next_size;
+    *data += next_size;
     frame_offset_ += next_size;
   }
 
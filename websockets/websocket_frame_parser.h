@@ -49,28 +49,35 @@ class NET_EXPORT WebSocketFrameParser {
   WebSocketError websocket_error() const { return websocket_error_; }
 
  private:
-  // Tries to decode a frame header from |current_read_pos_|.
-  // If successful, this function updates |current_read_pos_|,
-  // |current_frame_header_|, and |masking_key_| (if available).
-  // This function may set |failed_| to true if it observes a corrupt frame.
-  // If there is not enough data in the remaining buffer to parse a frame
-  // header, this function returns without doing anything.
-  void DecodeFrameHeader();
-
-  // Decodes frame payload and creates a WebSocketFrameChunk object.
-  // This function updates |current_read_pos_| and |frame_offset_| after
-  // parsing. This function returns a frame object even if no payload data is
-  // available at this moment, so the receiver could make use of frame header
-  // information. If the end of frame is reached, this function clears
-  // |current_frame_header_|, |frame_offset_| and |masking_key_|.
-  std::unique_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk);
-
-  // Internal buffer to store the data to parse.
+  // Tries to decode a frame header from the |length| bytes at |data|.
+  // If successful, this function updates |current_frame_header_| and
+  // |masking_key_| (if available), and returns the size of the header.
+  // This function may set |websocket_error_| if it observes a corrupt frame.
+  // If there is not enough data to parse a frame header, this function returns
+  // 0 without doing anything.
+  size_t DecodeFrameHeader(const char* data, size_t length);
+
+  // Like DecodeFrameHeader(), but for a header which starts with the bytes
+  // carried over in |buffer_| and continues at |data|. Returns the number of
+  // bytes of |data| in the header. If the header is still incomplete, all of
+  // |data| is appended to |buffer_|.
+  size_t DecodeCarriedOverFrameHeader(const char* data, size_t length);
+
+  // Decodes frame payload from |*data| up to |end| and creates a
+  // WebSocketFrameChunk object. This function advances |*data| and updates
+  // |frame_offset_| after parsing. This function returns a frame object even
+  // if no payload data is available at this moment, so the receiver could make
+  // use of frame header information. If the end of frame is reached, this
+  // function clears |current_frame_header_|, |frame_offset_| and
+  // |masking_key_|.
+  std::unique_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk,
+                                                          const char** data,
+                                                          const char* end);
+
+  // The start of a frame header which was incomplete at the end of the data
+  // given to the last Decode().
   std::vector<char> buffer_;
 
-  // Position in |buffer_| where the next round of parsing starts.
-  size_t current_read_pos_;
-
   // Frame header and masking key of the current frame.
   // |masking_key_| is filled with zeros if the current frame is not masked.
   std::unique_ptr<WebSocketFrameHeader> current_frame_header_;
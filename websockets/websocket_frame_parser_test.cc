@@ -414,6 +414,35 @@ TEST(WebSocketFrameParserTest, DecodePartialHeader) {
   }
 }
 
+// Tests that the data which completes a carried-over frame header is parsed
+// along with the frames following it.
+TEST(WebSocketFrameParserTest, DecodeHeaderSplitBeforeFrames) {
+  std::vector<char> input(kMaskedHelloFrame,
+                          kMaskedHelloFrame + kMaskedHelloFrameLength);
+  input.insert(input.end(), kHelloFrame, kHelloFrame + kHelloFrameLength);
+
+  for (size_t split = 1; split < 6; ++split) {
+    WebSocketFrameParser parser;
+    std::vector<std::unique_ptr<WebSocketFrameChunk>> frames;
+    EXPECT_TRUE(parser.Decode(input.data(), split, &frames));
+    EXPECT_EQ(0u, frames.size());
+    EXPECT_TRUE(
+        parser.Decode(input.data() + split, input.size() - split, &frames));
+    ASSERT_EQ(2u, frames.size());
+
+    for (const auto& frame : frames) {
+      EXPECT_TRUE(frame->final_chunk);
+      ASSERT_TRUE(frame->header);
+      ASSERT_TRUE(frame->data.get());
+      ASSERT_EQ(static_cast<int>(kHelloLength), frame->data->size());
+      EXPECT_TRUE(std::equal(kHello, kHello + kHelloLength,
+                             frame->data->data()));
+    }
+    EXPECT_TRUE(frames[0]->header->masked);
+    EXPECT_FALSE(frames[1]->header->masked);
+  }
+}
+
 TEST(WebSocketFrameParserTest, InvalidLengthEncoding) {
   struct TestCase {
     const char* frame_header;
@@ -32,23 +32,35 @@ class ShrinkableIOBufferWithSize : public IOBufferWithSize {
 }  // namespace
 
 WebSocketInflater::WebSocketInflater()
-    : input_queue_(kDefaultInputIOBufferCapacity),
+    : window_bits_(0),
+      input_queue_(kDefaultInputIOBufferCapacity),
       output_buffer_(kDefaultBufferCapacity) {}
 
 WebSocketInflater::WebSocketInflater(size_t input_queue_capacity,
                                      size_t output_buffer_capacity)
-    : input_queue_(input_queue_capacity),
+    : window_bits_(0),
+      input_queue_(input_queue_capacity),
       output_buffer_(output_buffer_capacity) {
   DCHECK_GT(input_queue_capacity, 0u);
   DCHECK_GT(output_buffer_capacity, 0u);
 }
 
 bool WebSocketInflater::Initialize(int window_bits) {
+  DCHECK(!window_bits_);
   DCHECK_LE(8, window_bits);
   DCHECK_GE(15, window_bits);
+  // The stream itself is created by the first AddBytes(), so that connections
+  // which never receive a compressed message do not hold its memory.
+  window_bits_ = window_bits;
+  return true;
+}
+
+bool WebSocketInflater::InitializeStream() {
+  DCHECK(window_bits_);
+  DCHECK(!stream_);
   stream_.reset(new z_stream);
   memset(stream_.get(), 0, sizeof(*stream_));
-  int result = inflateInit2(stream_.get(), -window_bits);
+  int result = inflateInit2(stream_.get(), -window_bits_);
   if (result != Z_OK) {
     inflateEnd(stream_.get());
     stream_.reset();
@@ -67,6 +79,8 @@ WebSocketInflater::~WebSocketInflater() {
 bool WebSocketInflater::AddBytes(const char* data, size_t size) {
   if (!size)
     return true;
+  if (!stream_ && !InitializeStream())
+    return false;
 
   if (!input_queue_.IsEmpty()) {
     // choked
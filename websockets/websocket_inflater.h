@@ -34,7 +34,8 @@ class NET_EXPORT_PRIVATE WebSocketInflater {
   // Returns true if there is no error.
   // |window_bits| must be between 8 and 15 (both inclusive).
   // This function must be called exactly once before calling any of the
-  // following functions.
+  // following functions. The zlib stream is only allocated once bytes are
+  // added.
   bool Initialize(int window_bits);
 
   // Adds bytes to |stream_|.
@@ -116,11 +117,14 @@ class NET_EXPORT_PRIVATE WebSocketInflater {
     base::circular_deque<scoped_refptr<IOBufferWithSize>> buffers_;
   };
 
+  bool InitializeStream();
   int InflateWithFlush(const char* next_in, size_t avail_in);
   int Inflate(const char* next_in, size_t avail_in, int flush);
   int InflateChokedInput();
 
   std::unique_ptr<z_stream_s> stream_;
+  // The window bits given to Initialize(), or 0 before it is called.
+  int window_bits_;
   InputQueue input_queue_;
   OutputBuffer output_buffer_;
 